@@ -26,6 +26,7 @@
  */
 #include "talk/app/webrtc/datachannel.h"
 
+#include <algorithm>
 #include <string>
 
 #include "talk/app/webrtc/mediastreamprovider.h"
@@ -37,52 +38,73 @@ namespace webrtc {
 
 static size_t kMaxQueuedReceivedDataBytes = 16 * 1024 * 1024;
 static size_t kMaxQueuedSendDataBytes = 16 * 1024 * 1024;
+static size_t kMinPacketQueueSize = 16;
+// How much of the queued data is handed to the provider at once.
+static size_t kMaxSendBatchSize = 64;
+static size_t kMaxSendBatchBytes = 256 * 1024;
 
 enum {
   MSG_CHANNELREADY,
 };
 
-DataChannel::PacketQueue::PacketQueue() : byte_count_(0) {}
+DataChannel::PacketQueue::PacketQueue()
+    : head_(0), size_(0), byte_count_(0) {}
 
 DataChannel::PacketQueue::~PacketQueue() {
   Clear();
 }
 
 bool DataChannel::PacketQueue::Empty() const {
-  return packets_.empty();
+  return size_ == 0;
 }
 
 DataBuffer* DataChannel::PacketQueue::Front() {
-  return packets_.front();
+  return packets_[head_];
+}
+
+DataBuffer* DataChannel::PacketQueue::At(size_t index) {
+  ASSERT(index < size_);
+  return packets_[(head_ + index) % packets_.size()];
 }
 
 void DataChannel::PacketQueue::Pop() {
-  if (packets_.empty()) {
+  if (size_ == 0) {
     return;
   }
 
-  byte_count_ -= packets_.front()->size();
-  packets_.pop_front();
+  byte_count_ -= packets_[head_]->size();
+  head_ = (head_ + 1) % packets_.size();
+  --size_;
 }
 
 void DataChannel::PacketQueue::Push(DataBuffer* packet) {
+  if (size_ == packets_.size()) {
+    std::vector<DataBuffer*> packets(std::max<size_t>(kMinPacketQueueSize,
+                                                      2 * packets_.size()));
+    for (size_t i = 0; i < size_; ++i) {
+      packets[i] = At(i);
+    }
+    packets_.swap(packets);
+    head_ = 0;
+  }
   byte_count_ += packet->size();
-  packets_.push_back(packet);
+  packets_[(head_ + size_) % packets_.size()] = packet;
+  ++size_;
 }
 
 void DataChannel::PacketQueue::Clear() {
-  while (!packets_.empty()) {
-    delete packets_.front();
-    packets_.pop_front();
+  while (size_ > 0) {
+    DataBuffer* packet = Front();
+    Pop();
+    delete packet;
   }
   byte_count_ = 0;
 }
 
 void DataChannel::PacketQueue::Swap(PacketQueue* other) {
-  size_t other_byte_count = other->byte_count_;
-  other->byte_count_ = byte_count_;
-  byte_count_ = other_byte_count;
-
+  std::swap(head_, other->head_);
+  std::swap(size_, other->size_);
+  std::swap(byte_count_, other->byte_count_);
   other->packets_.swap(packets_);
 }
 
@@ -114,7 +136,8 @@ DataChannel::DataChannel(
       send_ssrc_set_(false),
       receive_ssrc_set_(false),
       send_ssrc_(0),
-      receive_ssrc_(0) {
+      receive_ssrc_(0),
+      buffered_amount_low_threshold_(0) {
 }
 
 bool DataChannel::Init(const InternalDataChannelInit& config) {
@@ -182,6 +205,10 @@ uint64 DataChannel::buffered_amount() const {
   return queued_send_data_.byte_count();
 }
 
+void DataChannel::SetBufferedAmountLowThreshold(uint64 threshold) {
+  buffered_amount_low_threshold_ = threshold;
+}
+
 void DataChannel::Close() {
   if (state_ == kClosed)
     return;
@@ -461,35 +488,74 @@ void DataChannel::DeliverQueuedReceivedData() {
 void DataChannel::SendQueuedDataMessages() {
   ASSERT(was_ever_writable_ && state_ == kOpen);
 
-  PacketQueue packet_buffer;
-  packet_buffer.Swap(&queued_send_data_);
+  const uint64 start_buffered_amount = buffered_amount();
+  std::vector<cricket::SendDataParams> params;
+  std::vector<const rtc::Buffer*> payloads;
+  while (!queued_send_data_.Empty()) {
+    // The queued buffers are handed over in batches as they are, and only
+    // taken off the queue once sent.
+    params.clear();
+    payloads.clear();
+    size_t batch_bytes = 0;
+    for (size_t i = 0; i < queued_send_data_.size() &&
+                       i < kMaxSendBatchSize &&
+                       batch_bytes < kMaxSendBatchBytes;
+         ++i) {
+      const DataBuffer* buffer = queued_send_data_.At(i);
+      params.resize(params.size() + 1);
+      InitSendDataParams(*buffer, &params.back());
+      payloads.push_back(&buffer->data);
+      batch_bytes += buffer->size();
+    }
+
+    cricket::SendDataResult send_result = cricket::SDR_SUCCESS;
+    const size_t sent =
+        provider_->SendDataBatch(params, payloads, &send_result);
+    for (size_t i = 0; i < sent; ++i) {
+      DataBuffer* buffer = queued_send_data_.Front();
+      queued_send_data_.Pop();
+      delete buffer;
+    }
+    if (sent < params.size()) {
+      if (send_result != cricket::SDR_BLOCK) {
+        LOG(LS_ERROR) << "Closing the DataChannel due to a failure to send "
+                      << "queued data, send_result = " << send_result;
+        Close();
+      }
+      break;
+    }
+  }
 
-  while (!packet_buffer.Empty()) {
-    rtc::scoped_ptr<DataBuffer> buffer(packet_buffer.Front());
-    SendDataMessage(*buffer);
-    packet_buffer.Pop();
+  if (observer_ && start_buffered_amount > buffered_amount_low_threshold_ &&
+      buffered_amount() <= buffered_amount_low_threshold_) {
+    observer_->OnBufferedAmountLow();
   }
 }
 
-bool DataChannel::SendDataMessage(const DataBuffer& buffer) {
-  cricket::SendDataParams send_params;
-
+void DataChannel::InitSendDataParams(const DataBuffer& buffer,
+                                     cricket::SendDataParams* send_params) {
   if (data_channel_type_ == cricket::DCT_SCTP) {
-    send_params.ordered = config_.ordered;
+    send_params->ordered = config_.ordered;
     // Send as ordered if it is waiting for the OPEN_ACK message.
     if (waiting_for_open_ack_ && !config_.ordered) {
-      send_params.ordered = true;
+      send_params->ordered = true;
       LOG(LS_VERBOSE) << "Sending data as ordered for unordered DataChannel "
                       << "because the OPEN_ACK message has not been received.";
     }
 
-    send_params.max_rtx_count = config_.maxRetransmits;
-    send_params.max_rtx_ms = config_.maxRetransmitTime;
-    send_params.ssrc = config_.id;
+    send_params->max_rtx_count = config_.maxRetransmits;
+    send_params->max_rtx_ms = config_.maxRetransmitTime;
+    send_params->ssrc = config_.id;
   } else {
-    send_params.ssrc = send_ssrc_;
+    send_params->ssrc = send_ssrc_;
   }
-  send_params.type = buffer.binary ? cricket::DMT_BINARY : cricket::DMT_TEXT;
+  send_params->type =
+      buffer.binary ? cricket::DMT_BINARY : cricket::DMT_TEXT;
+}
+
+bool DataChannel::SendDataMessage(const DataBuffer& buffer) {
+  cricket::SendDataParams send_params;
+  InitSendDataParams(buffer, &send_params);
 
   cricket::SendDataResult send_result = cricket::SDR_SUCCESS;
   bool success = provider_->SendData(send_params, buffer.data, &send_result);
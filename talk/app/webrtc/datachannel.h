@@ -29,7 +29,7 @@
 #define TALK_APP_WEBRTC_DATACHANNEL_H_
 
 #include <string>
-#include <deque>
+#include <vector>
 
 #include "talk/app/webrtc/datachannelinterface.h"
 #include "talk/app/webrtc/proxy.h"
@@ -49,6 +49,13 @@ class DataChannelProviderInterface {
   virtual bool SendData(const cricket::SendDataParams& params,
                         const rtc::Buffer& payload,
                         cricket::SendDataResult* result) = 0;
+  // Sends the payloads in order in one go, up to the first one which fails.
+  // Returns how many were sent, with the result of the failed one in
+  // |result|.
+  virtual size_t SendDataBatch(
+      const std::vector<cricket::SendDataParams>& params,
+      const std::vector<const rtc::Buffer*>& payloads,
+      cricket::SendDataResult* result) = 0;
   // Connects to the transport signals.
   virtual bool ConnectDataChannel(DataChannel* data_channel) = 0;
   // Disconnects from the transport signals.
@@ -124,6 +131,10 @@ class DataChannel : public DataChannelInterface,
   virtual bool negotiated() const { return config_.negotiated; }
   virtual int id() const { return config_.id; }
   virtual uint64 buffered_amount() const;
+  virtual uint64 buffered_amount_low_threshold() const {
+    return buffered_amount_low_threshold_;
+  }
+  virtual void SetBufferedAmountLowThreshold(uint64 threshold);
   virtual void Close();
   virtual DataState state() const { return state_; }
   virtual bool Send(const DataBuffer& buffer);
@@ -177,7 +188,8 @@ class DataChannel : public DataChannelInterface,
 
  private:
   // A packet queue which tracks the total queued bytes. Queued packets are
-  // owned by this class.
+  // owned by this class. The packets are kept in a ring which doubles when
+  // it is full, so that queueing does not allocate once it has grown.
   class PacketQueue {
    public:
     PacketQueue();
@@ -189,8 +201,15 @@ class DataChannel : public DataChannelInterface,
 
     bool Empty() const;
 
+    size_t size() const {
+      return size_;
+    }
+
     DataBuffer* Front();
 
+    // Returns the packet |index| places behind the front one.
+    DataBuffer* At(size_t index);
+
     void Pop();
 
     void Push(DataBuffer* packet);
@@ -200,7 +219,9 @@ class DataChannel : public DataChannelInterface,
     void Swap(PacketQueue* other);
 
    private:
-    std::deque<DataBuffer*> packets_;
+    std::vector<DataBuffer*> packets_;
+    size_t head_;
+    size_t size_;
     size_t byte_count_;
   };
 
@@ -213,6 +234,8 @@ class DataChannel : public DataChannelInterface,
   void DeliverQueuedReceivedData();
 
   void SendQueuedDataMessages();
+  void InitSendDataParams(const DataBuffer& buffer,
+                          cricket::SendDataParams* send_params);
   bool SendDataMessage(const DataBuffer& buffer);
   bool QueueSendDataMessage(const DataBuffer& buffer);
 
@@ -238,6 +261,7 @@ class DataChannel : public DataChannelInterface,
   PacketQueue queued_control_data_;
   PacketQueue queued_received_data_;
   PacketQueue queued_send_data_;
+  uint64 buffered_amount_low_threshold_;
 };
 
 class DataChannelFactory {
@@ -264,6 +288,8 @@ BEGIN_PROXY_MAP(DataChannel)
   PROXY_CONSTMETHOD0(int, id)
   PROXY_CONSTMETHOD0(DataState, state)
   PROXY_CONSTMETHOD0(uint64, buffered_amount)
+  PROXY_CONSTMETHOD0(uint64, buffered_amount_low_threshold)
+  PROXY_METHOD1(void, SetBufferedAmountLowThreshold, uint64)
   PROXY_METHOD0(void, Close)
   PROXY_METHOD1(bool, Send, const DataBuffer&)
 END_PROXY()
@@ -35,7 +35,9 @@ using webrtc::DataChannel;
 class FakeDataChannelObserver : public webrtc::DataChannelObserver {
  public:
   FakeDataChannelObserver()
-      : messages_received_(0), on_state_change_count_(0) {}
+      : messages_received_(0),
+        on_state_change_count_(0),
+        on_buffered_amount_low_count_(0) {}
 
   void OnStateChange() {
     ++on_state_change_count_;
@@ -45,6 +47,10 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     ++messages_received_;
   }
 
+  void OnBufferedAmountLow() {
+    ++on_buffered_amount_low_count_;
+  }
+
   size_t messages_received() const {
     return messages_received_;
   }
@@ -57,9 +63,14 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     return on_state_change_count_;
   }
 
+  size_t on_buffered_amount_low_count() const {
+    return on_buffered_amount_low_count_;
+  }
+
  private:
   size_t messages_received_;
   size_t on_state_change_count_;
+  size_t on_buffered_amount_low_count_;
 };
 
 class SctpDataChannelTest : public testing::Test {
@@ -162,6 +173,31 @@ TEST_F(SctpDataChannelTest, QueuedDataSentWhenUnblocked) {
   EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
 }
 
+// Tests that the queued data are handed to the provider in one batch when the
+// channel is unblocked, and that the observer is told once the buffered amount
+// drops to the threshold.
+TEST_F(SctpDataChannelTest, QueuedDataSentInBatchWhenUnblocked) {
+  AddObserver();
+  SetChannelReady();
+  webrtc::DataBuffer buffer("abcd");
+  webrtc_data_channel_->SetBufferedAmountLowThreshold(buffer.size());
+  provider_.set_send_blocked(true);
+
+  const int number_of_packets = 20;
+  for (int i = 0; i < number_of_packets; ++i) {
+    EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  }
+  EXPECT_EQ(buffer.size() * number_of_packets,
+            webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(0U, observer_->on_buffered_amount_low_count());
+
+  provider_.set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(1, provider_.send_batch_count());
+  EXPECT_EQ(1U, observer_->on_buffered_amount_low_count());
+  EXPECT_EQ(webrtc::DataChannelInterface::kOpen, webrtc_data_channel_->state());
+}
+
 // Tests that the queued control message is sent when channel is ready.
 TEST_F(SctpDataChannelTest, OpenMessageSent) {
   // Initially the id is unassigned.
@@ -90,6 +90,9 @@ class DataChannelObserver {
   virtual void OnStateChange() = 0;
   //  A data buffer was successfully received.
   virtual void OnMessage(const DataBuffer& buffer) = 0;
+  // The buffered_amount has fallen to the buffered_amount_low_threshold or
+  // below while the queued data was sent.
+  virtual void OnBufferedAmountLow() {}
 
  protected:
   virtual ~DataChannelObserver() {}
@@ -128,6 +131,10 @@ class DataChannelInterface : public rtc::RefCountInterface {
   // (UTF-8 text and binary data) that have been queued using SendBuffer but
   // have not yet been transmitted to the network.
   virtual uint64 buffered_amount() const = 0;
+  // The buffered_amount at which OnBufferedAmountLow() is fired once more
+  // data was queued, 0 by default.
+  virtual uint64 buffered_amount_low_threshold() const = 0;
+  virtual void SetBufferedAmountLowThreshold(uint64 threshold) = 0;
   virtual void Close() = 0;
   // Sends |data| to the remote peer.
   virtual bool Send(const DataBuffer& buffer) = 0;
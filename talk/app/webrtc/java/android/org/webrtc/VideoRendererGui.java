@@ -147,19 +147,22 @@ public class VideoRendererGui implements GLSurfaceView.Renderer {
    * on a screen. New video frames are sent to display using renderFrame()
    * call.
    */
-  private static class YuvImageRenderer implements VideoRenderer.Callbacks {
+  private static class YuvImageRenderer
+      implements VideoRenderer.RetainingCallbacks {
     private GLSurfaceView surface;
     private int program;
     private FloatBuffer textureVertices;
     private int[] yuvTextures = { -1, -1, -1 };
 
     // Render frame queue - accessed by two threads. renderFrame() call does
-    // an offer (writing I420Frame to render) and early-returns (recording
-    // a dropped frame) if that queue is full. draw() call does a peek(),
-    // copies frame to texture and then removes it from a queue using poll().
+    // an offer (queueing the retained incoming I420Frame) and early-returns
+    // (recording a dropped frame) if that queue is full. draw() call does a
+    // peek(), copies frame to texture and then removes it from a queue using
+    // poll() and releases it.
     LinkedBlockingQueue<I420Frame> frameToRenderQueue;
-    // Local copy of incoming video frame.
-    private I420Frame frameToRender;
+    // Frame size set by setSize(), -1 until it is called.
+    private int frameWidth = -1;
+    private int frameHeight = -1;
     // Flag if renderFrame() was ever called
     boolean seenFrame;
     // Total number of video frames received in renderFrame() call.
@@ -173,8 +176,7 @@ public class VideoRendererGui implements GLSurfaceView.Renderer {
     private long startTimeNs = -1;
     // Time in ns spent in draw() function.
     private long drawTimeNs;
-    // Time in ns spent in renderFrame() function - including copying frame
-    // data to rendering planes
+    // Time in ns spent in renderFrame() function.
     private long copyTimeNs;
 
     // Texture Coordinates mapping the entire texture.
@@ -239,11 +241,12 @@ public class VideoRendererGui implements GLSurfaceView.Renderer {
           startTimeNs = now;
         }
         for (int i = 0; i < 3; ++i) {
-          int w = (i == 0) ? frameToRender.width : frameToRender.width / 2;
-          int h = (i == 0) ? frameToRender.height : frameToRender.height / 2;
           GLES20.glActiveTexture(GLES20.GL_TEXTURE0 + i);
           GLES20.glBindTexture(GLES20.GL_TEXTURE_2D, yuvTextures[i]);
           if (frameFromQueue != null) {
+            int w = (i == 0) ? frameFromQueue.width : frameFromQueue.width / 2;
+            int h = (i == 0) ?
+                frameFromQueue.height : frameFromQueue.height / 2;
             GLES20.glTexImage2D(GLES20.GL_TEXTURE_2D, 0, GLES20.GL_LUMINANCE,
                 w, h, 0, GLES20.GL_LUMINANCE, GLES20.GL_UNSIGNED_BYTE,
                 frameFromQueue.yuvPlanes[i]);
@@ -251,6 +254,8 @@ public class VideoRendererGui implements GLSurfaceView.Renderer {
         }
         if (frameFromQueue != null) {
           frameToRenderQueue.poll();
+          // The planes have been uploaded to the textures.
+          VideoRenderer.renderFrameDone(frameFromQueue);
         }
       }
       int posLocation = GLES20.glGetAttribLocation(program, "in_pos");
@@ -295,15 +300,17 @@ public class VideoRendererGui implements GLSurfaceView.Renderer {
     @Override
     public void setSize(final int width, final int height) {
       Log.v(TAG, "YuvImageRenderer.setSize: " + width + " x " + height);
-      int[] strides = { width, width / 2, width / 2  };
-      // Frame re-allocation need to be synchronized with copying
-      // frame to textures in draw() function to avoid re-allocating
-      // the frame while it is being copied.
+      // Size change need to be synchronized with copying frame to textures
+      // in draw() function to avoid releasing the frame while it is being
+      // copied.
       synchronized (frameToRenderQueue) {
         // Clear rendering queue
-        frameToRenderQueue.poll();
-        // Re-allocate / allocate the frame
-        frameToRender = new I420Frame(width, height, strides, null);
+        I420Frame frame = frameToRenderQueue.poll();
+        if (frame != null) {
+          VideoRenderer.renderFrameDone(frame);
+        }
+        frameWidth = width;
+        frameHeight = height;
       }
     }
 
@@ -317,16 +324,18 @@ public class VideoRendererGui implements GLSurfaceView.Renderer {
           frame.yuvStrides[2] == frame.width / 2)) {
         Log.e(TAG, "Incorrect strides " + frame.yuvStrides[0] + ", " +
             frame.yuvStrides[1] + ", " + frame.yuvStrides[2]);
+        VideoRenderer.renderFrameDone(frame);
         return;
       }
       // Skip rendering of this frame if setSize() was not called.
-      if (frameToRender == null) {
+      if (frameWidth < 0) {
         framesDropped++;
+        VideoRenderer.renderFrameDone(frame);
         return;
       }
       // Check incoming frame dimensions
-      if (frame.width != frameToRender.width ||
-          frame.height != frameToRender.height) {
+      if (frame.width != frameWidth || frame.height != frameHeight) {
+        VideoRenderer.renderFrameDone(frame);
         throw new RuntimeException("Wrong frame size " +
             frame.width + " x " + frame.height);
       }
@@ -334,11 +343,11 @@ public class VideoRendererGui implements GLSurfaceView.Renderer {
       if (frameToRenderQueue.size() > 0) {
         // Skip rendering of this frame if previous frame was not rendered yet.
         framesDropped++;
+        VideoRenderer.renderFrameDone(frame);
         return;
       }
-      frameToRender.copyFrom(frame);
       copyTimeNs += (System.nanoTime() - now);
-      frameToRenderQueue.offer(frameToRender);
+      frameToRenderQueue.offer(frame);
       seenFrame = true;
       surface.requestRender();
     }
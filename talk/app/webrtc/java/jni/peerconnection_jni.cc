@@ -285,6 +285,7 @@ class ClassReferenceHolder {
     LoadClass(jni, "org/webrtc/StatsReport");
     LoadClass(jni, "org/webrtc/StatsReport$Value");
     LoadClass(jni, "org/webrtc/VideoRenderer$I420Frame");
+    LoadClass(jni, "org/webrtc/VideoRenderer$RetainingCallbacks");
     LoadClass(jni, "org/webrtc/VideoTrack");
   }
 
@@ -1081,8 +1082,11 @@ class JavaVideoRendererWrapper : public VideoRendererInterface {
         j_frame_class_(jni,
                        FindClass(jni, "org/webrtc/VideoRenderer$I420Frame")),
         j_frame_ctor_id_(GetMethodID(
-            jni, *j_frame_class_, "<init>", "(II[I[Ljava/nio/ByteBuffer;)V")),
-        j_byte_buffer_class_(jni, FindClass(jni, "java/nio/ByteBuffer")) {
+            jni, *j_frame_class_, "<init>", "(II[I[Ljava/nio/ByteBuffer;J)V")),
+        j_byte_buffer_class_(jni, FindClass(jni, "java/nio/ByteBuffer")),
+        retain_frames_(jni->IsInstanceOf(
+            j_callbacks,
+            FindClass(jni, "org/webrtc/VideoRenderer$RetainingCallbacks"))) {
     CHECK_EXCEPTION(jni, "");
   }
 
@@ -1096,14 +1100,27 @@ class JavaVideoRendererWrapper : public VideoRendererInterface {
 
   virtual void RenderFrame(const cricket::VideoFrame* frame) OVERRIDE {
     ScopedLocalRefFrame local_ref_frame(jni());
-    jobject j_frame = CricketToJavaFrame(frame);
+    // A RetainingCallbacks may hold on to the frame after renderFrame()
+    // returns, so hand it a copy that shares the buffer of |frame| and lives
+    // until VideoRenderer.renderFrameDone().
+    scoped_ptr<cricket::VideoFrame> retained_frame;
+    if (retain_frames_) {
+      retained_frame.reset(frame->Copy());
+      if (!retained_frame)
+        return;
+      frame = retained_frame.get();
+    }
+    jobject j_frame = CricketToJavaFrame(frame, retained_frame.get());
     jni()->CallVoidMethod(*j_callbacks_, j_render_frame_id_, j_frame);
     CHECK_EXCEPTION(jni(), "");
+    retained_frame.release();
   }
 
  private:
-  // Return a VideoRenderer.I420Frame referring to the data in |frame|.
-  jobject CricketToJavaFrame(const cricket::VideoFrame* frame) {
+  // Return a VideoRenderer.I420Frame referring to the data in |frame|.  The
+  // Java frame owns |retained_frame|, if non-NULL.
+  jobject CricketToJavaFrame(const cricket::VideoFrame* frame,
+                             cricket::VideoFrame* retained_frame) {
     jintArray strides = jni()->NewIntArray(3);
     jint* strides_array = jni()->GetIntArrayElements(strides, NULL);
     strides_array[0] = frame->GetYPitch();
@@ -1123,7 +1140,8 @@ class JavaVideoRendererWrapper : public VideoRendererInterface {
     jni()->SetObjectArrayElement(planes, 2, v_buffer);
     return jni()->NewObject(
         *j_frame_class_, j_frame_ctor_id_,
-        frame->GetWidth(), frame->GetHeight(), strides, planes);
+        frame->GetWidth(), frame->GetHeight(), strides, planes,
+        jlongFromPointer(retained_frame));
   }
 
   JNIEnv* jni() {
@@ -1136,6 +1154,7 @@ class JavaVideoRendererWrapper : public VideoRendererInterface {
   ScopedGlobalRef<jclass> j_frame_class_;
   jmethodID j_frame_ctor_id_;
   ScopedGlobalRef<jclass> j_byte_buffer_class_;
+  const bool retain_frames_;
 };
 
 #ifdef ANDROID
@@ -2316,13 +2335,27 @@ JOW(void, DataChannel_close)(JNIEnv* jni, jobject j_dc) {
 }
 
 JOW(jboolean, DataChannel_sendNative)(JNIEnv* jni, jobject j_dc,
-                                      jbyteArray data, jboolean binary) {
-  jbyte* bytes = jni->GetByteArrayElements(data, NULL);
-  bool ret = ExtractNativeDC(jni, j_dc)->Send(DataBuffer(
-      rtc::Buffer(bytes, jni->GetArrayLength(data)),
-      binary));
-  jni->ReleaseByteArrayElements(data, bytes, JNI_ABORT);
-  return ret;
+                                      jbyteArray data, jint offset,
+                                      jint length, jboolean binary) {
+  // Copy straight out of the Java heap into the buffer that is sent, without
+  // pinning or copying the whole array first.
+  DataBuffer buffer(rtc::Buffer(), binary);
+  buffer.data.SetLength(length);
+  jni->GetByteArrayRegion(data, offset, length,
+                          reinterpret_cast<jbyte*>(buffer.data.data()));
+  CHECK_EXCEPTION(jni, "error during GetByteArrayRegion");
+  return ExtractNativeDC(jni, j_dc)->Send(buffer);
+}
+
+JOW(jboolean, DataChannel_sendDirectNative)(JNIEnv* jni, jobject j_dc,
+                                            jobject data, jint offset,
+                                            jint length, jboolean binary) {
+  const char* bytes =
+      reinterpret_cast<const char*>(jni->GetDirectBufferAddress(data));
+  CHECK(bytes, "Not a direct buffer");
+  DataBuffer buffer(rtc::Buffer(), binary);
+  buffer.data.SetData(bytes + offset, length);
+  return ExtractNativeDC(jni, j_dc)->Send(buffer);
 }
 
 JOW(void, DataChannel_dispose)(JNIEnv* jni, jobject j_dc) {
@@ -2372,6 +2405,11 @@ JOW(void, VideoRenderer_free)(JNIEnv*, jclass, jlong j_p) {
   delete reinterpret_cast<VideoRendererWrapper*>(j_p);
 }
 
+JOW(void, VideoRenderer_releaseNativeFrame)(
+    JNIEnv* jni, jclass, jlong j_frame_ptr) {
+  delete reinterpret_cast<cricket::VideoFrame*>(j_frame_ptr);
+}
+
 JOW(void, MediaStreamTrack_free)(JNIEnv*, jclass, jlong j_p) {
   CHECK_RELEASE(reinterpret_cast<MediaStreamTrackInterface*>(j_p));
 }
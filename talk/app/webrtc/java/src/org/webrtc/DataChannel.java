@@ -126,15 +126,30 @@ public class DataChannel {
   /** Close the channel. */
   public native void close();
 
-  /** Send |data| to the remote peer; return success. */
+  /**
+   * Send the remaining bytes of |buffer.data| to the remote peer; return
+   * success.  Direct and array-backed buffers are copied only once, straight
+   * into the native send buffer.  The position of |buffer.data| is left
+   * unchanged.
+   */
   public boolean send(Buffer buffer) {
-    // TODO(fischman): this could be cleverer about avoiding copies if the
-    // ByteBuffer is direct and/or is backed by an array.
-    byte[] data = new byte[buffer.data.remaining()];
-    buffer.data.get(data);
-    return sendNative(data, buffer.binary);
+    ByteBuffer data = buffer.data;
+    if (data.isDirect()) {
+      return sendDirectNative(
+          data, data.position(), data.remaining(), buffer.binary);
+    }
+    if (data.hasArray()) {
+      return sendNative(data.array(), data.arrayOffset() + data.position(),
+          data.remaining(), buffer.binary);
+    }
+    byte[] bytes = new byte[data.remaining()];
+    data.duplicate().get(bytes);
+    return sendNative(bytes, 0, bytes.length, buffer.binary);
   }
-  private native boolean sendNative(byte[] data, boolean binary);
+  private native boolean sendNative(
+      byte[] data, int offset, int length, boolean binary);
+  private native boolean sendDirectNative(
+      ByteBuffer data, int offset, int length, boolean binary);
 
   /** Dispose of native resources attached to this channel. */
   public native void dispose();
@@ -44,6 +44,9 @@ public class VideoRenderer {
     public final int height;
     public final int[] yuvStrides;
     public final ByteBuffer[] yuvPlanes;
+    // The native frame backing |yuvPlanes| for frames passed to a
+    // RetainingCallbacks, 0 otherwise.  See renderFrameDone().
+    private long nativeFramePointer;
 
     /**
      * Construct a frame of the given dimensions with the specified planar
@@ -64,6 +67,13 @@ public class VideoRenderer {
       this.yuvPlanes = yuvPlanes;
     }
 
+    // Called only by native code.
+    private I420Frame(int width, int height, int[] yuvStrides,
+        ByteBuffer[] yuvPlanes, long nativeFramePointer) {
+      this(width, height, yuvStrides, yuvPlanes);
+      this.nativeFramePointer = nativeFramePointer;
+    }
+
     /**
      * Copy the planes out of |source| into |this| and return |this|.  Calling
      * this with mismatched frame dimensions is a programming error and will
@@ -96,12 +106,33 @@ public class VideoRenderer {
     }
 }
 
-  /** The real meat of VideoRendererInterface. */
+  /**
+   * The real meat of VideoRendererInterface.  The planes of the frame passed
+   * to renderFrame() refer to native memory that is only valid until
+   * renderFrame() returns; copy them to use the frame later.
+   */
   public static interface Callbacks {
     public void setSize(int width, int height);
     public void renderFrame(I420Frame frame);
   }
 
+  /**
+   * Callbacks that keep the frames passed to renderFrame() without copying
+   * them.  The planes stay valid until the frame is handed back with
+   * renderFrameDone(), which must be called exactly once for every frame,
+   * including the ones that are dropped.
+   */
+  public static interface RetainingCallbacks extends Callbacks {
+  }
+
+  /** Release a frame that was passed to RetainingCallbacks.renderFrame(). */
+  public static void renderFrameDone(I420Frame frame) {
+    if (frame.nativeFramePointer != 0) {
+      releaseNativeFrame(frame.nativeFramePointer);
+      frame.nativeFramePointer = 0;
+    }
+  }
+
   // |this| either wraps a native (GUI) renderer or a client-supplied Callbacks
   // (Java) implementation; so exactly one of these will be non-0/null.
   final long nativeVideoRenderer;
@@ -133,4 +164,6 @@ public class VideoRenderer {
   private static native long nativeWrapVideoRenderer(Callbacks callbacks);
 
   private static native void free(long nativeVideoRenderer);
+
+  private static native void releaseNativeFrame(long nativeFramePointer);
 }
@@ -705,6 +705,18 @@ public class PeerConnectionTest extends TestCase {
             ByteBuffer.wrap(new byte[] { 1, 2, 3, 4, 5 }), true)));
     offeringExpectations.waitForAllExpectationsToBeSatisfied();
 
+    // Send the same message out of the middle of a direct buffer.
+    ByteBuffer directBinaryMessage = ByteBuffer.allocateDirect(7);
+    for (byte i = 0; i < 7; ++i) {
+      directBinaryMessage.put(i);
+    }
+    directBinaryMessage.position(1).limit(6);
+    offeringExpectations.expectMessage(expectedBinaryMessage, true);
+    assertTrue(answeringExpectations.dataChannel.send(
+        new DataChannel.Buffer(directBinaryMessage, true)));
+    offeringExpectations.waitForAllExpectationsToBeSatisfied();
+    assertEquals(1, directBinaryMessage.position());
+
     offeringExpectations.expectStateChange(DataChannel.State.CLOSING);
     answeringExpectations.expectStateChange(DataChannel.State.CLOSING);
     offeringExpectations.expectStateChange(DataChannel.State.CLOSED);
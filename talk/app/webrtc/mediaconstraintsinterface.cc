@@ -91,6 +91,8 @@ const char MediaConstraintsInterface::kEnableRtpDataChannels[] =
 // Google-specific constraint keys.
 const char MediaConstraintsInterface::kEnableDscp[] = "googDscp";
 const char MediaConstraintsInterface::kEnableIPv6[] = "googIPv6";
+const char MediaConstraintsInterface::kEcdsaDtlsIdentity[] =
+    "googEcdsaDtlsIdentity";
 const char MediaConstraintsInterface::kEnableVideoSuspendBelowMinBitrate[] =
     "googSuspendBelowMinBitrate";
 const char MediaConstraintsInterface::kImprovedWifiBwe[] =
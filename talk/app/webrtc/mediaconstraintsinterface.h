@@ -112,6 +112,8 @@ class MediaConstraintsInterface {
   static const char kEnableDscp[];  // googDscp
   // Constraint to enable IPv6 through JS.
   static const char kEnableIPv6[];  // googIPv6
+  // Generates the DTLS identity with an ECDSA P-256 key instead of RSA.
+  static const char kEcdsaDtlsIdentity[];  // googEcdsaDtlsIdentity
   // Temporary constraint to enable suspend below min bitrate feature.
   static const char kEnableVideoSuspendBelowMinBitrate[];
       // googSuspendBelowMinBitrate
@@ -460,6 +460,20 @@ bool PeerConnection::GetStats(StatsObserver* observer,
   return true;
 }
 
+bool PeerConnection::GetStatsDelta(StatsObserver* observer,
+                                   StatsOutputLevel level) {
+  if (!VERIFY(observer != NULL)) {
+    LOG(LS_ERROR) << "GetStatsDelta - observer is NULL.";
+    return false;
+  }
+
+  stats_->UpdateStats(level);
+  rtc::scoped_ptr<GetStatsMsg> msg(new GetStatsMsg(observer));
+  stats_->GetStatsDelta(&(msg->reports));
+  signaling_thread()->Post(this, MSG_GETSTATS, msg.release());
+  return true;
+}
+
 PeerConnectionInterface::SignalingState PeerConnection::signaling_state() {
   return signaling_state_;
 }
@@ -78,6 +78,7 @@ class PeerConnection : public PeerConnectionInterface,
   virtual bool GetStats(StatsObserver* observer,
                         webrtc::MediaStreamTrackInterface* track,
                         StatsOutputLevel level);
+  virtual bool GetStatsDelta(StatsObserver* observer, StatsOutputLevel level);
 
   virtual SignalingState signaling_state();
 
@@ -228,6 +228,11 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
   virtual bool GetStats(StatsObserver* observer,
                         MediaStreamTrackInterface* track,
                         StatsOutputLevel level) = 0;
+  // Like GetStats() for all tracks, but the reports only hold the values
+  // which changed since the last call, and the reports without a changed
+  // value are left out. Meant for polling many PeerConnections often.
+  virtual bool GetStatsDelta(StatsObserver* observer,
+                             StatsOutputLevel level) = 0;
 
   virtual rtc::scoped_refptr<DataChannelInterface> CreateDataChannel(
       const std::string& label,
@@ -433,10 +438,14 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
    public:
     Options() :
       disable_encryption(false),
-      disable_sctp_data_channels(false) {
+      disable_sctp_data_channels(false),
+      low_memory(false) {
     }
     bool disable_encryption;
     bool disable_sctp_data_channels;
+    // Trades the ability to recover older lost packets for a smaller memory
+    // footprint per connection, for devices which run many connections.
+    bool low_memory;
   };
 
   virtual void SetOptions(const Options& options) = 0;
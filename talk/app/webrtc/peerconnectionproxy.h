@@ -33,6 +33,13 @@
 
 namespace webrtc {
 
+// Keeps the observer of a posted SetLocalDescription() or
+// SetRemoteDescription() alive until the call has run.
+template <>
+struct AsyncArgument<SetSessionDescriptionObserver*> {
+  typedef rtc::scoped_refptr<SetSessionDescriptionObserver> Type;
+};
+
 // Define proxy for PeerConnectionInterface.
 BEGIN_PROXY_MAP(PeerConnection)
   PROXY_METHOD0(rtc::scoped_refptr<StreamCollectionInterface>,
@@ -47,6 +54,7 @@ BEGIN_PROXY_MAP(PeerConnection)
   PROXY_METHOD3(bool, GetStats, StatsObserver*,
                 MediaStreamTrackInterface*,
                 StatsOutputLevel)
+  PROXY_METHOD2(bool, GetStatsDelta, StatsObserver*, StatsOutputLevel)
   PROXY_METHOD2(rtc::scoped_refptr<DataChannelInterface>,
                 CreateDataChannel, const std::string&, const DataChannelInit*)
   PROXY_CONSTMETHOD0(const SessionDescriptionInterface*, local_description)
@@ -55,10 +63,12 @@ BEGIN_PROXY_MAP(PeerConnection)
                 const MediaConstraintsInterface*)
   PROXY_METHOD2(void, CreateAnswer, CreateSessionDescriptionObserver*,
                 const MediaConstraintsInterface*)
-  PROXY_METHOD2(void, SetLocalDescription, SetSessionDescriptionObserver*,
-                SessionDescriptionInterface*)
-  PROXY_METHOD2(void, SetRemoteDescription, SetSessionDescriptionObserver*,
-                SessionDescriptionInterface*)
+  // The result of these is reported to the observer, so the caller doesn't
+  // have to wait for them.
+  PROXY_ASYNC_METHOD2(SetLocalDescription, SetSessionDescriptionObserver*,
+                      SessionDescriptionInterface*)
+  PROXY_ASYNC_METHOD2(SetRemoteDescription, SetSessionDescriptionObserver*,
+                      SessionDescriptionInterface*)
   PROXY_METHOD2(bool, UpdateIce, const IceServers&,
                 const MediaConstraintsInterface*)
   PROXY_METHOD1(bool, AddIceCandidate, const IceCandidateInterface*)
@@ -51,10 +51,20 @@
 // END_PROXY()
 //
 // The proxy can be created using TestProxy::Create(Thread*, TestInterface*).
+//
+// A void method whose result is reported some other way, e.g. to an observer,
+// can be posted with PROXY_ASYNC_METHOD1/2 instead, such that the caller
+// doesn't wait for the owner thread. The arguments are copied and must stay
+// valid until the call has run. The calls keep their order with every other
+// call of the proxy: the queued calls run before a synchronous call does. On
+// the owner thread itself the call runs right away.
 
 #ifndef TALK_APP_WEBRTC_PROXY_H_
 #define TALK_APP_WEBRTC_PROXY_H_
 
+#include <deque>
+
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/thread.h"
 
 namespace webrtc {
@@ -220,13 +230,135 @@ class MethodCall3 : public rtc::Message,
   T3 a3_;
 };
 
+// How an argument of an asynchronous call is kept until the call runs. Can be
+// specialized to keep a reference to a ref counted argument, e.g.
+// template <> struct AsyncArgument<FooObserver*> {
+//   typedef rtc::scoped_refptr<FooObserver> Type;
+// };
+template <typename T>
+struct AsyncArgument {
+  typedef T Type;
+};
+
+class AsyncMethodCall {
+ public:
+  virtual ~AsyncMethodCall() {}
+  virtual void Run() = 0;
+};
+
+template <typename C, typename T1>
+class AsyncMethodCall1 : public AsyncMethodCall {
+ public:
+  typedef void (C::*Method)(T1 a1);
+  AsyncMethodCall1(C* c, Method m, T1 a1) : c_(c), m_(m), a1_(a1) {}
+
+  virtual void Run() { (c_->*m_)(a1_); }
+
+ private:
+  C* c_;
+  Method m_;
+  typename AsyncArgument<T1>::Type a1_;
+};
+
+template <typename C, typename T1, typename T2>
+class AsyncMethodCall2 : public AsyncMethodCall {
+ public:
+  typedef void (C::*Method)(T1 a1, T2 a2);
+  AsyncMethodCall2(C* c, Method m, T1 a1, T2 a2)
+      : c_(c), m_(m), a1_(a1), a2_(a2) {}
+
+  virtual void Run() { (c_->*m_)(a1_, a2_); }
+
+ private:
+  C* c_;
+  Method m_;
+  typename AsyncArgument<T1>::Type a1_;
+  typename AsyncArgument<T2>::Type a2_;
+};
+
+// The asynchronous calls of a proxy which haven't run yet. Every call posts a
+// message which runs the queued calls on the owner thread, and Flush() runs
+// them right away. A message sent to a thread is handled before the ones
+// posted to it, so a synchronous call flushes the queue first.
+class AsyncCallQueue : public rtc::MessageHandler {
+ public:
+  explicit AsyncCallQueue(rtc::Thread* thread)
+      : thread_(thread), has_calls_(false) {}
+  virtual ~AsyncCallQueue() {
+    for (std::deque<AsyncMethodCall*>::iterator it = calls_.begin();
+         it != calls_.end(); ++it) {
+      delete *it;
+    }
+  }
+
+  // Takes ownership of |call|. On the owner thread the call runs right away.
+  void Post(AsyncMethodCall* call) {
+    if (thread_->IsCurrent()) {
+      RunCalls();
+      call->Run();
+      delete call;
+      return;
+    }
+    {
+      rtc::CritScope lock(&crit_);
+      calls_.push_back(call);
+      has_calls_ = true;
+    }
+    thread_->Post(this);
+  }
+
+  // Runs the queued calls on the owner thread before returning.
+  void Flush() {
+    {
+      rtc::CritScope lock(&crit_);
+      if (!has_calls_)
+        return;
+    }
+    MethodCall0<AsyncCallQueue, void> call(this, &AsyncCallQueue::RunCalls);
+    call.Marshal(thread_);
+  }
+
+  // Runs the queued calls and drops the posted messages, such that the queue
+  // can be deleted. Must be called on the owner thread.
+  void Stop() {
+    RunCalls();
+    thread_->Clear(this);
+  }
+
+ private:
+  virtual void OnMessage(rtc::Message*) { RunCalls(); }
+
+  void RunCalls() {
+    while (true) {
+      AsyncMethodCall* call;
+      {
+        rtc::CritScope lock(&crit_);
+        if (calls_.empty()) {
+          has_calls_ = false;
+          return;
+        }
+        call = calls_.front();
+        calls_.pop_front();
+      }
+      call->Run();
+      delete call;
+    }
+  }
+
+  rtc::Thread* const thread_;
+  rtc::CriticalSection crit_;
+  std::deque<AsyncMethodCall*> calls_;
+  bool has_calls_;
+};
+
 #define BEGIN_PROXY_MAP(c) \
   class c##Proxy : public c##Interface {\
    protected:\
     typedef c##Interface C;\
     c##Proxy(rtc::Thread* thread, C* c)\
       : owner_thread_(thread), \
-        c_(c)  {}\
+        c_(c), \
+        async_calls_(thread) {}\
     ~c##Proxy() {\
       MethodCall0<c##Proxy, void> call(this, &c##Proxy::Release_s);\
       call.Marshal(owner_thread_);\
@@ -239,47 +371,67 @@ class MethodCall3 : public rtc::Message,
 
 #define PROXY_METHOD0(r, method)\
     r method() OVERRIDE {\
+      async_calls_.Flush();\
       MethodCall0<C, r> call(c_.get(), &C::method);\
       return call.Marshal(owner_thread_);\
     }\
 
 #define PROXY_CONSTMETHOD0(r, method)\
     r method() const OVERRIDE {\
+      async_calls_.Flush();\
       ConstMethodCall0<C, r> call(c_.get(), &C::method);\
       return call.Marshal(owner_thread_);\
      }\
 
 #define PROXY_METHOD1(r, method, t1)\
     r method(t1 a1) OVERRIDE {\
+      async_calls_.Flush();\
       MethodCall1<C, r, t1> call(c_.get(), &C::method, a1);\
       return call.Marshal(owner_thread_);\
     }\
 
 #define PROXY_CONSTMETHOD1(r, method, t1)\
     r method(t1 a1) const OVERRIDE {\
+      async_calls_.Flush();\
       ConstMethodCall1<C, r, t1> call(c_.get(), &C::method, a1);\
       return call.Marshal(owner_thread_);\
     }\
 
 #define PROXY_METHOD2(r, method, t1, t2)\
     r method(t1 a1, t2 a2) OVERRIDE {\
+      async_calls_.Flush();\
       MethodCall2<C, r, t1, t2> call(c_.get(), &C::method, a1, a2);\
       return call.Marshal(owner_thread_);\
     }\
 
 #define PROXY_METHOD3(r, method, t1, t2, t3)\
     r method(t1 a1, t2 a2, t3 a3) OVERRIDE {\
+      async_calls_.Flush();\
       MethodCall3<C, r, t1, t2, t3> call(c_.get(), &C::method, a1, a2, a3);\
       return call.Marshal(owner_thread_);\
     }\
 
+#define PROXY_ASYNC_METHOD1(method, t1)\
+    void method(t1 a1) OVERRIDE {\
+      async_calls_.Post(\
+          new AsyncMethodCall1<C, t1>(c_.get(), &C::method, a1));\
+    }\
+
+#define PROXY_ASYNC_METHOD2(method, t1, t2)\
+    void method(t1 a1, t2 a2) OVERRIDE {\
+      async_calls_.Post(\
+          new AsyncMethodCall2<C, t1, t2>(c_.get(), &C::method, a1, a2));\
+    }\
+
 #define END_PROXY() \
    private:\
     void Release_s() {\
+      async_calls_.Stop();\
       c_ = NULL;\
     }\
     mutable rtc::Thread* owner_thread_;\
     rtc::scoped_refptr<C> c_;\
+    mutable AsyncCallQueue async_calls_;\
   };\
 
 }  // namespace webrtc
@@ -38,6 +38,7 @@
 using ::testing::_;
 using ::testing::DoAll;
 using ::testing::Exactly;
+using ::testing::InSequence;
 using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
 
@@ -52,6 +53,8 @@ class FakeInterface : public rtc::RefCountInterface {
   virtual std::string Method1(std::string s) = 0;
   virtual std::string ConstMethod1(std::string s) const = 0;
   virtual std::string Method2(std::string s1, std::string s2) = 0;
+  virtual void AsyncMethod1(std::string s) = 0;
+  virtual void AsyncMethod2(std::string s1, std::string s2) = 0;
 
  protected:
   ~FakeInterface() {}
@@ -65,6 +68,8 @@ BEGIN_PROXY_MAP(Fake)
   PROXY_METHOD1(std::string, Method1, std::string)
   PROXY_CONSTMETHOD1(std::string, ConstMethod1, std::string)
   PROXY_METHOD2(std::string, Method2, std::string, std::string)
+  PROXY_ASYNC_METHOD1(AsyncMethod1, std::string)
+  PROXY_ASYNC_METHOD2(AsyncMethod2, std::string, std::string)
 END_PROXY()
 
 // Implementation of the test interface.
@@ -82,6 +87,8 @@ class Fake : public FakeInterface {
   MOCK_CONST_METHOD1(ConstMethod1, std::string(std::string));
 
   MOCK_METHOD2(Method2, std::string(std::string, std::string));
+  MOCK_METHOD1(AsyncMethod1, void(std::string));
+  MOCK_METHOD2(AsyncMethod2, void(std::string, std::string));
 
  protected:
   Fake() {}
@@ -167,4 +174,35 @@ TEST_F(ProxyTest, Method2) {
   EXPECT_EQ("Method2", fake_proxy_->Method2(arg1, arg2));
 }
 
+TEST_F(ProxyTest, AsyncMethod1) {
+  const std::string arg1 = "arg1";
+  EXPECT_CALL(*fake_, AsyncMethod1(arg1))
+            .Times(Exactly(1))
+            .WillOnce(InvokeWithoutArgs(this, &ProxyTest::CheckThread));
+  fake_proxy_->AsyncMethod1(arg1);
+  // Releasing the proxy runs the pending calls.
+  fake_proxy_ = NULL;
+}
+
+// Verifies that the posted calls run before a later synchronous call.
+TEST_F(ProxyTest, AsyncMethodsKeepOrder) {
+  const std::string arg1 = "arg1";
+  const std::string arg2 = "arg2";
+  {
+    InSequence sequence;
+    EXPECT_CALL(*fake_, AsyncMethod2(arg1, arg2))
+              .Times(Exactly(1))
+              .WillOnce(InvokeWithoutArgs(this, &ProxyTest::CheckThread));
+    EXPECT_CALL(*fake_, AsyncMethod1(arg1))
+              .Times(Exactly(1))
+              .WillOnce(InvokeWithoutArgs(this, &ProxyTest::CheckThread));
+    EXPECT_CALL(*fake_, Method0())
+              .Times(Exactly(1))
+              .WillOnce(Return("Method0"));
+  }
+  fake_proxy_->AsyncMethod2(arg1, arg2);
+  fake_proxy_->AsyncMethod1(arg1);
+  EXPECT_EQ("Method0", fake_proxy_->Method0());
+}
+
 }  // namespace webrtc
@@ -59,6 +59,8 @@ const char StatsReport::kStatsValueNameCaptureJitterMs[] =
 const char StatsReport::kStatsValueNameCaptureQueueDelayMsPerS[] =
     "googCaptureQueueDelayMsPerS";
 const char StatsReport::kStatsValueNameChannelId[] = "googChannelId";
+const char StatsReport::kStatsValueNameChannelSetupTimeMs[] =
+    "googChannelSetupTimeMs";
 const char StatsReport::kStatsValueNameCodecName[] = "googCodecName";
 const char StatsReport::kStatsValueNameComponent[] = "googComponent";
 const char StatsReport::kStatsValueNameContentName[] = "googContentName";
@@ -89,6 +91,8 @@ const char StatsReport::kStatsValueNameEchoReturnLoss[] =
 const char StatsReport::kStatsValueNameEchoReturnLossEnhancement[] =
     "googEchoCancellationReturnLossEnhancement";
 
+const char StatsReport::kStatsValueNameEncodeCpuUsagePercent[] =
+    "googEncodeCpuUsagePercent";
 const char StatsReport::kStatsValueNameEncodeRelStdDev[] =
     "googEncodeRelStdDev";
 const char StatsReport::kStatsValueNameEncodeUsagePercent[] =
@@ -97,6 +101,8 @@ const char StatsReport::kStatsValueNameExpandRate[] = "googExpandRate";
 const char StatsReport::kStatsValueNameFingerprint[] = "googFingerprint";
 const char StatsReport::kStatsValueNameFingerprintAlgorithm[] =
     "googFingerprintAlgorithm";
+const char StatsReport::kStatsValueNameFirstCandidateTimeMs[] =
+    "googFirstCandidateTimeMs";
 const char StatsReport::kStatsValueNameFirsReceived[] = "googFirsReceived";
 const char StatsReport::kStatsValueNameFirsSent[] = "googFirsSent";
 const char StatsReport::kStatsValueNameFrameHeightInput[] =
@@ -130,6 +136,8 @@ const char StatsReport::kStatsValueNameFrameWidthInput[] =
 const char StatsReport::kStatsValueNameFrameWidthReceived[] =
     "googFrameWidthReceived";
 const char StatsReport::kStatsValueNameFrameWidthSent[] = "googFrameWidthSent";
+const char StatsReport::kStatsValueNameIceConnectedTimeMs[] =
+    "googIceConnectedTimeMs";
 const char StatsReport::kStatsValueNameInitiator[] = "googInitiator";
 const char StatsReport::kStatsValueNameIssuerId[] = "googIssuerId";
 const char StatsReport::kStatsValueNameJitterReceived[] = "googJitterReceived";
@@ -199,7 +207,7 @@ void StatsReport::AddValue(StatsReport::StatsValueName name,
 }
 
 void StatsReport::AddValue(StatsReport::StatsValueName name, int64 value) {
-  AddValue(name, rtc::ToString<int64>(value));
+  values.push_back(Value(name, value));
 }
 
 template <typename T>
@@ -224,7 +232,11 @@ void StatsReport::ReplaceValue(StatsReport::StatsValueName name,
                                const std::string& value) {
   for (Values::iterator it = values.begin(); it != values.end(); ++it) {
     if ((*it).name == name) {
-      it->value = value;
+      if (it->is_int || it->value != value) {
+        it->value = value;
+        it->is_int = false;
+        it->changed = true;
+      }
       return;
     }
   }
@@ -233,6 +245,51 @@ void StatsReport::ReplaceValue(StatsReport::StatsValueName name,
   ASSERT(false);
 }
 
+void StatsReport::SetValue(StatsReport::StatsValueName name,
+                           const std::string& value) {
+  Value* found = FindValue(name);
+  if (!found) {
+    AddValue(name, value);
+  } else if (found->is_int || found->value != value) {
+    found->value = value;
+    found->is_int = false;
+    found->changed = true;
+  }
+}
+
+void StatsReport::SetValue(StatsReport::StatsValueName name, int64 value) {
+  Value* found = FindValue(name);
+  if (!found) {
+    AddValue(name, value);
+  } else if (!found->is_int || found->int_value != value) {
+    found->value = rtc::ToString<int64>(value);
+    found->int_value = value;
+    found->is_int = true;
+    found->changed = true;
+  }
+}
+
+void StatsReport::SetBoolean(StatsReport::StatsValueName name, bool value) {
+  SetValue(name, value ? "true" : "false");
+}
+
+void StatsReport::RemoveValue(StatsReport::StatsValueName name) {
+  for (Values::iterator it = values.begin(); it != values.end(); ++it) {
+    if (it->name == name) {
+      values.erase(it);
+      return;
+    }
+  }
+}
+
+StatsReport::Value* StatsReport::FindValue(StatsReport::StatsValueName name) {
+  for (Values::iterator it = values.begin(); it != values.end(); ++it) {
+    if (it->name == name)
+      return &(*it);
+  }
+  return NULL;
+}
+
 namespace {
 typedef std::map<std::string, StatsReport> StatsMap;
 
@@ -312,157 +369,159 @@ void CreateTrackReports(const TrackVector& tracks, StatsMap* reports) {
 }
 
 void ExtractStats(const cricket::VoiceReceiverInfo& info, StatsReport* report) {
-  report->AddValue(StatsReport::kStatsValueNameAudioOutputLevel,
+  report->SetValue(StatsReport::kStatsValueNameAudioOutputLevel,
                    info.audio_level);
-  report->AddValue(StatsReport::kStatsValueNameBytesReceived,
+  report->SetValue(StatsReport::kStatsValueNameBytesReceived,
                    info.bytes_rcvd);
-  report->AddValue(StatsReport::kStatsValueNameJitterReceived,
+  report->SetValue(StatsReport::kStatsValueNameJitterReceived,
                    info.jitter_ms);
-  report->AddValue(StatsReport::kStatsValueNameJitterBufferMs,
+  report->SetValue(StatsReport::kStatsValueNameJitterBufferMs,
                    info.jitter_buffer_ms);
-  report->AddValue(StatsReport::kStatsValueNamePreferredJitterBufferMs,
+  report->SetValue(StatsReport::kStatsValueNamePreferredJitterBufferMs,
                    info.jitter_buffer_preferred_ms);
-  report->AddValue(StatsReport::kStatsValueNameCurrentDelayMs,
+  report->SetValue(StatsReport::kStatsValueNameCurrentDelayMs,
                    info.delay_estimate_ms);
-  report->AddValue(StatsReport::kStatsValueNameExpandRate,
+  report->SetValue(StatsReport::kStatsValueNameExpandRate,
                    rtc::ToString<float>(info.expand_rate));
-  report->AddValue(StatsReport::kStatsValueNamePacketsReceived,
+  report->SetValue(StatsReport::kStatsValueNamePacketsReceived,
                    info.packets_rcvd);
-  report->AddValue(StatsReport::kStatsValueNamePacketsLost,
+  report->SetValue(StatsReport::kStatsValueNamePacketsLost,
                    info.packets_lost);
-  report->AddValue(StatsReport::kStatsValueNameDecodingCTSG,
+  report->SetValue(StatsReport::kStatsValueNameDecodingCTSG,
                    info.decoding_calls_to_silence_generator);
-  report->AddValue(StatsReport::kStatsValueNameDecodingCTN,
+  report->SetValue(StatsReport::kStatsValueNameDecodingCTN,
                    info.decoding_calls_to_neteq);
-  report->AddValue(StatsReport::kStatsValueNameDecodingNormal,
+  report->SetValue(StatsReport::kStatsValueNameDecodingNormal,
                    info.decoding_normal);
-  report->AddValue(StatsReport::kStatsValueNameDecodingPLC,
+  report->SetValue(StatsReport::kStatsValueNameDecodingPLC,
                    info.decoding_plc);
-  report->AddValue(StatsReport::kStatsValueNameDecodingCNG,
+  report->SetValue(StatsReport::kStatsValueNameDecodingCNG,
                    info.decoding_cng);
-  report->AddValue(StatsReport::kStatsValueNameDecodingPLCCNG,
+  report->SetValue(StatsReport::kStatsValueNameDecodingPLCCNG,
                    info.decoding_plc_cng);
-  report->AddValue(StatsReport::kStatsValueNameCaptureStartNtpTimeMs,
+  report->SetValue(StatsReport::kStatsValueNameCaptureStartNtpTimeMs,
                    info.capture_start_ntp_time_ms);
-  report->AddValue(StatsReport::kStatsValueNameCodecName, info.codec_name);
+  report->SetValue(StatsReport::kStatsValueNameCodecName, info.codec_name);
 }
 
 void ExtractStats(const cricket::VoiceSenderInfo& info, StatsReport* report) {
-  report->AddValue(StatsReport::kStatsValueNameAudioInputLevel,
+  report->SetValue(StatsReport::kStatsValueNameAudioInputLevel,
                    info.audio_level);
-  report->AddValue(StatsReport::kStatsValueNameBytesSent,
+  report->SetValue(StatsReport::kStatsValueNameBytesSent,
                    info.bytes_sent);
-  report->AddValue(StatsReport::kStatsValueNamePacketsSent,
+  report->SetValue(StatsReport::kStatsValueNamePacketsSent,
                    info.packets_sent);
-  report->AddValue(StatsReport::kStatsValueNamePacketsLost,
+  report->SetValue(StatsReport::kStatsValueNamePacketsLost,
                    info.packets_lost);
-  report->AddValue(StatsReport::kStatsValueNameJitterReceived,
+  report->SetValue(StatsReport::kStatsValueNameJitterReceived,
                    info.jitter_ms);
-  report->AddValue(StatsReport::kStatsValueNameRtt, info.rtt_ms);
-  report->AddValue(StatsReport::kStatsValueNameEchoCancellationQualityMin,
+  report->SetValue(StatsReport::kStatsValueNameRtt, info.rtt_ms);
+  report->SetValue(StatsReport::kStatsValueNameEchoCancellationQualityMin,
                    rtc::ToString<float>(info.aec_quality_min));
-  report->AddValue(StatsReport::kStatsValueNameEchoDelayMedian,
+  report->SetValue(StatsReport::kStatsValueNameEchoDelayMedian,
                    info.echo_delay_median_ms);
-  report->AddValue(StatsReport::kStatsValueNameEchoDelayStdDev,
+  report->SetValue(StatsReport::kStatsValueNameEchoDelayStdDev,
                    info.echo_delay_std_ms);
-  report->AddValue(StatsReport::kStatsValueNameEchoReturnLoss,
+  report->SetValue(StatsReport::kStatsValueNameEchoReturnLoss,
                    info.echo_return_loss);
-  report->AddValue(StatsReport::kStatsValueNameEchoReturnLossEnhancement,
+  report->SetValue(StatsReport::kStatsValueNameEchoReturnLossEnhancement,
                    info.echo_return_loss_enhancement);
-  report->AddValue(StatsReport::kStatsValueNameCodecName, info.codec_name);
-  report->AddBoolean(StatsReport::kStatsValueNameTypingNoiseState,
+  report->SetValue(StatsReport::kStatsValueNameCodecName, info.codec_name);
+  report->SetBoolean(StatsReport::kStatsValueNameTypingNoiseState,
                      info.typing_noise_detected);
 }
 
 void ExtractStats(const cricket::VideoReceiverInfo& info, StatsReport* report) {
-  report->AddValue(StatsReport::kStatsValueNameBytesReceived,
+  report->SetValue(StatsReport::kStatsValueNameBytesReceived,
                    info.bytes_rcvd);
-  report->AddValue(StatsReport::kStatsValueNamePacketsReceived,
+  report->SetValue(StatsReport::kStatsValueNamePacketsReceived,
                    info.packets_rcvd);
-  report->AddValue(StatsReport::kStatsValueNamePacketsLost,
+  report->SetValue(StatsReport::kStatsValueNamePacketsLost,
                    info.packets_lost);
 
-  report->AddValue(StatsReport::kStatsValueNameFirsSent,
+  report->SetValue(StatsReport::kStatsValueNameFirsSent,
                    info.firs_sent);
-  report->AddValue(StatsReport::kStatsValueNamePlisSent,
+  report->SetValue(StatsReport::kStatsValueNamePlisSent,
                    info.plis_sent);
-  report->AddValue(StatsReport::kStatsValueNameNacksSent,
+  report->SetValue(StatsReport::kStatsValueNameNacksSent,
                    info.nacks_sent);
-  report->AddValue(StatsReport::kStatsValueNameFrameWidthReceived,
+  report->SetValue(StatsReport::kStatsValueNameFrameWidthReceived,
                    info.frame_width);
-  report->AddValue(StatsReport::kStatsValueNameFrameHeightReceived,
+  report->SetValue(StatsReport::kStatsValueNameFrameHeightReceived,
                    info.frame_height);
-  report->AddValue(StatsReport::kStatsValueNameFrameRateReceived,
+  report->SetValue(StatsReport::kStatsValueNameFrameRateReceived,
                    info.framerate_rcvd);
-  report->AddValue(StatsReport::kStatsValueNameFrameRateDecoded,
+  report->SetValue(StatsReport::kStatsValueNameFrameRateDecoded,
                    info.framerate_decoded);
-  report->AddValue(StatsReport::kStatsValueNameFrameRateOutput,
+  report->SetValue(StatsReport::kStatsValueNameFrameRateOutput,
                    info.framerate_output);
 
-  report->AddValue(StatsReport::kStatsValueNameDecodeMs,
+  report->SetValue(StatsReport::kStatsValueNameDecodeMs,
                    info.decode_ms);
-  report->AddValue(StatsReport::kStatsValueNameMaxDecodeMs,
+  report->SetValue(StatsReport::kStatsValueNameMaxDecodeMs,
                    info.max_decode_ms);
-  report->AddValue(StatsReport::kStatsValueNameCurrentDelayMs,
+  report->SetValue(StatsReport::kStatsValueNameCurrentDelayMs,
                    info.current_delay_ms);
-  report->AddValue(StatsReport::kStatsValueNameTargetDelayMs,
+  report->SetValue(StatsReport::kStatsValueNameTargetDelayMs,
                    info.target_delay_ms);
-  report->AddValue(StatsReport::kStatsValueNameJitterBufferMs,
+  report->SetValue(StatsReport::kStatsValueNameJitterBufferMs,
                    info.jitter_buffer_ms);
-  report->AddValue(StatsReport::kStatsValueNameMinPlayoutDelayMs,
+  report->SetValue(StatsReport::kStatsValueNameMinPlayoutDelayMs,
                    info.min_playout_delay_ms);
-  report->AddValue(StatsReport::kStatsValueNameRenderDelayMs,
+  report->SetValue(StatsReport::kStatsValueNameRenderDelayMs,
                    info.render_delay_ms);
 
-  report->AddValue(StatsReport::kStatsValueNameCaptureStartNtpTimeMs,
+  report->SetValue(StatsReport::kStatsValueNameCaptureStartNtpTimeMs,
                    info.capture_start_ntp_time_ms);
 }
 
 void ExtractStats(const cricket::VideoSenderInfo& info, StatsReport* report) {
-  report->AddValue(StatsReport::kStatsValueNameBytesSent,
+  report->SetValue(StatsReport::kStatsValueNameBytesSent,
                    info.bytes_sent);
-  report->AddValue(StatsReport::kStatsValueNamePacketsSent,
+  report->SetValue(StatsReport::kStatsValueNamePacketsSent,
                    info.packets_sent);
-  report->AddValue(StatsReport::kStatsValueNamePacketsLost,
+  report->SetValue(StatsReport::kStatsValueNamePacketsLost,
                    info.packets_lost);
 
-  report->AddValue(StatsReport::kStatsValueNameFirsReceived,
+  report->SetValue(StatsReport::kStatsValueNameFirsReceived,
                    info.firs_rcvd);
-  report->AddValue(StatsReport::kStatsValueNamePlisReceived,
+  report->SetValue(StatsReport::kStatsValueNamePlisReceived,
                    info.plis_rcvd);
-  report->AddValue(StatsReport::kStatsValueNameNacksReceived,
+  report->SetValue(StatsReport::kStatsValueNameNacksReceived,
                    info.nacks_rcvd);
-  report->AddValue(StatsReport::kStatsValueNameFrameWidthInput,
+  report->SetValue(StatsReport::kStatsValueNameFrameWidthInput,
                    info.input_frame_width);
-  report->AddValue(StatsReport::kStatsValueNameFrameHeightInput,
+  report->SetValue(StatsReport::kStatsValueNameFrameHeightInput,
                    info.input_frame_height);
-  report->AddValue(StatsReport::kStatsValueNameFrameWidthSent,
+  report->SetValue(StatsReport::kStatsValueNameFrameWidthSent,
                    info.send_frame_width);
-  report->AddValue(StatsReport::kStatsValueNameFrameHeightSent,
+  report->SetValue(StatsReport::kStatsValueNameFrameHeightSent,
                    info.send_frame_height);
-  report->AddValue(StatsReport::kStatsValueNameFrameRateInput,
+  report->SetValue(StatsReport::kStatsValueNameFrameRateInput,
                    info.framerate_input);
-  report->AddValue(StatsReport::kStatsValueNameFrameRateSent,
+  report->SetValue(StatsReport::kStatsValueNameFrameRateSent,
                    info.framerate_sent);
-  report->AddValue(StatsReport::kStatsValueNameRtt, info.rtt_ms);
-  report->AddValue(StatsReport::kStatsValueNameCodecName, info.codec_name);
-  report->AddBoolean(StatsReport::kStatsValueNameCpuLimitedResolution,
+  report->SetValue(StatsReport::kStatsValueNameRtt, info.rtt_ms);
+  report->SetValue(StatsReport::kStatsValueNameCodecName, info.codec_name);
+  report->SetBoolean(StatsReport::kStatsValueNameCpuLimitedResolution,
                      (info.adapt_reason & 0x1) > 0);
-  report->AddBoolean(StatsReport::kStatsValueNameBandwidthLimitedResolution,
+  report->SetBoolean(StatsReport::kStatsValueNameBandwidthLimitedResolution,
                      (info.adapt_reason & 0x2) > 0);
-  report->AddBoolean(StatsReport::kStatsValueNameViewLimitedResolution,
+  report->SetBoolean(StatsReport::kStatsValueNameViewLimitedResolution,
                      (info.adapt_reason & 0x4) > 0);
-  report->AddValue(StatsReport::kStatsValueNameAdaptationChanges,
+  report->SetValue(StatsReport::kStatsValueNameAdaptationChanges,
                    info.adapt_changes);
-  report->AddValue(StatsReport::kStatsValueNameAvgEncodeMs, info.avg_encode_ms);
-  report->AddValue(StatsReport::kStatsValueNameCaptureJitterMs,
+  report->SetValue(StatsReport::kStatsValueNameAvgEncodeMs, info.avg_encode_ms);
+  report->SetValue(StatsReport::kStatsValueNameCaptureJitterMs,
                    info.capture_jitter_ms);
-  report->AddValue(StatsReport::kStatsValueNameCaptureQueueDelayMsPerS,
+  report->SetValue(StatsReport::kStatsValueNameCaptureQueueDelayMsPerS,
                    info.capture_queue_delay_ms_per_s);
-  report->AddValue(StatsReport::kStatsValueNameEncodeUsagePercent,
+  report->SetValue(StatsReport::kStatsValueNameEncodeUsagePercent,
                    info.encode_usage_percent);
-  report->AddValue(StatsReport::kStatsValueNameEncodeRelStdDev,
+  report->SetValue(StatsReport::kStatsValueNameEncodeRelStdDev,
                    info.encode_rsd);
+  report->SetValue(StatsReport::kStatsValueNameEncodeCpuUsagePercent,
+                   info.encode_cpu_usage_percent);
 }
 
 void ExtractStats(const cricket::BandwidthEstimationInfo& info,
@@ -472,28 +531,29 @@ void ExtractStats(const cricket::BandwidthEstimationInfo& info,
   report->id = StatsReport::kStatsReportVideoBweId;
   report->type = StatsReport::kStatsReportTypeBwe;
 
-  // Clear out stats from previous GatherStats calls if any.
-  if (report->timestamp != stats_gathering_started) {
-    report->values.clear();
-    report->timestamp = stats_gathering_started;
-  }
+  report->timestamp = stats_gathering_started;
 
-  report->AddValue(StatsReport::kStatsValueNameAvailableSendBandwidth,
+  report->SetValue(StatsReport::kStatsValueNameAvailableSendBandwidth,
                    info.available_send_bandwidth);
-  report->AddValue(StatsReport::kStatsValueNameAvailableReceiveBandwidth,
+  report->SetValue(StatsReport::kStatsValueNameAvailableReceiveBandwidth,
                    info.available_recv_bandwidth);
-  report->AddValue(StatsReport::kStatsValueNameTargetEncBitrate,
+  report->SetValue(StatsReport::kStatsValueNameTargetEncBitrate,
                    info.target_enc_bitrate);
-  report->AddValue(StatsReport::kStatsValueNameActualEncBitrate,
+  report->SetValue(StatsReport::kStatsValueNameActualEncBitrate,
                    info.actual_enc_bitrate);
-  report->AddValue(StatsReport::kStatsValueNameRetransmitBitrate,
+  report->SetValue(StatsReport::kStatsValueNameRetransmitBitrate,
                    info.retransmit_bitrate);
-  report->AddValue(StatsReport::kStatsValueNameTransmitBitrate,
+  report->SetValue(StatsReport::kStatsValueNameTransmitBitrate,
                    info.transmit_bitrate);
-  report->AddValue(StatsReport::kStatsValueNameBucketDelay,
+  report->SetValue(StatsReport::kStatsValueNameBucketDelay,
                    info.bucket_delay);
+  // The lists change with every update, so they are added anew.
+  report->RemoveValue(
+      StatsReport::kStatsValueNameRecvPacketGroupPropagationDeltaDebug);
+  report->RemoveValue(
+      StatsReport::kStatsValueNameRecvPacketGroupArrivalTimeDebug);
   if (level >= PeerConnectionInterface::kStatsOutputLevelDebug) {
-    report->AddValue(
+    report->SetValue(
         StatsReport::kStatsValueNameRecvPacketGroupPropagationDeltaSumDebug,
         info.total_received_propagation_delta_ms);
     if (info.recent_received_propagation_delta_ms.size() > 0) {
@@ -504,6 +564,9 @@ void ExtractStats(const cricket::BandwidthEstimationInfo& info,
           StatsReport::kStatsValueNameRecvPacketGroupArrivalTimeDebug,
           info.recent_received_packet_group_arrival_time_ms);
     }
+  } else {
+    report->RemoveValue(
+        StatsReport::kStatsValueNameRecvPacketGroupPropagationDeltaSumDebug);
   }
 }
 
@@ -648,6 +711,30 @@ bool StatsCollector::GetStats(MediaStreamTrackInterface* track,
   return true;
 }
 
+void StatsCollector::GetStatsDelta(StatsReports* reports) {
+  ASSERT(reports != NULL);
+  reports->clear();
+
+  for (StatsMap::iterator it = reports_.begin(); it != reports_.end(); ++it) {
+    StatsReport* delta = NULL;
+    StatsReport::Values& values = it->second.values;
+    for (StatsReport::Values::iterator value = values.begin();
+         value != values.end(); ++value) {
+      if (!value->changed)
+        continue;
+      value->changed = false;
+      if (!delta) {
+        reports->push_back(StatsReport());
+        delta = &reports->back();
+        delta->id = it->second.id;
+        delta->type = it->second.type;
+        delta->timestamp = it->second.timestamp;
+      }
+      delta->values.push_back(*value);
+    }
+  }
+}
+
 void
 StatsCollector::UpdateStats(PeerConnectionInterface::StatsOutputLevel level) {
   double time_now = GetTimeNow();
@@ -694,18 +781,14 @@ StatsReport* StatsCollector::PrepareLocalReport(
   StatsReport* report = GetOrCreateReport(StatsReport::kStatsReportTypeSsrc,
                                           ssrc_id, direction);
 
-  // Clear out stats from previous GatherStats calls if any.
-  // This is required since the report will be returned for the new values.
-  // Having the old values in the report will lead to multiple values with
-  // the same name.
-  // TODO(xians): Consider changing StatsReport to use map instead of vector.
-  report->values.clear();
+  // The values of previous GatherStats calls are updated in place, so that
+  // only the values which changed are formatted again.
   report->timestamp = stats_gathering_started_;
 
-  report->AddValue(StatsReport::kStatsValueNameSsrc, ssrc_id);
-  report->AddValue(StatsReport::kStatsValueNameTrackId, track_id);
+  report->SetValue(StatsReport::kStatsValueNameSsrc, ssrc_id);
+  report->SetValue(StatsReport::kStatsValueNameTrackId, track_id);
   // Add the mapping of SSRC to transport.
-  report->AddValue(StatsReport::kStatsValueNameTransportId,
+  report->SetValue(StatsReport::kStatsValueNameTransportId,
                    transport_id);
   return report;
 }
@@ -737,15 +820,13 @@ StatsReport* StatsCollector::PrepareRemoteReport(
   StatsReport* report = GetOrCreateReport(
       StatsReport::kStatsReportTypeRemoteSsrc, ssrc_id, direction);
 
-  // Clear out stats from previous GatherStats calls if any.
   // The timestamp will be added later. Zero it for debugging.
-  report->values.clear();
   report->timestamp = 0;
 
-  report->AddValue(StatsReport::kStatsValueNameSsrc, ssrc_id);
-  report->AddValue(StatsReport::kStatsValueNameTrackId, track_id);
+  report->SetValue(StatsReport::kStatsValueNameSsrc, ssrc_id);
+  report->SetValue(StatsReport::kStatsValueNameTrackId, track_id);
   // Add the mapping of SSRC to transport.
-  report->AddValue(StatsReport::kStatsValueNameTransportId,
+  report->SetValue(StatsReport::kStatsValueNameTransportId,
                    transport_id);
   return report;
 }
@@ -778,17 +859,18 @@ std::string StatsCollector::AddOneCertificateReport(
   rtc::Base64::EncodeFromArray(
       der_buffer.data(), der_buffer.length(), &der_base64);
 
-  StatsReport report;
+  const std::string report_id =
+      StatsId(StatsReport::kStatsReportTypeCertificate, fingerprint);
+  StatsReport& report = reports_[report_id];
   report.type = StatsReport::kStatsReportTypeCertificate;
-  report.id = StatsId(report.type, fingerprint);
+  report.id = report_id;
   report.timestamp = stats_gathering_started_;
-  report.AddValue(StatsReport::kStatsValueNameFingerprint, fingerprint);
-  report.AddValue(StatsReport::kStatsValueNameFingerprintAlgorithm,
+  report.SetValue(StatsReport::kStatsValueNameFingerprint, fingerprint);
+  report.SetValue(StatsReport::kStatsValueNameFingerprintAlgorithm,
                   digest_algorithm);
-  report.AddValue(StatsReport::kStatsValueNameDer, der_base64);
+  report.SetValue(StatsReport::kStatsValueNameDer, der_base64);
   if (!issuer_id.empty())
-    report.AddValue(StatsReport::kStatsValueNameIssuerId, issuer_id);
-  reports_[report.id] = report;
+    report.SetValue(StatsReport::kStatsValueNameIssuerId, issuer_id);
   return report.id;
 }
 
@@ -818,16 +900,30 @@ std::string StatsCollector::AddCertificateReports(
 }
 
 void StatsCollector::ExtractSessionInfo() {
-  // Extract information from the base session.
-  StatsReport report;
-  report.id = StatsId(StatsReport::kStatsReportTypeSession, session_->id());
-  report.type = StatsReport::kStatsReportTypeSession;
-  report.timestamp = stats_gathering_started_;
-  report.values.clear();
-  report.AddBoolean(StatsReport::kStatsValueNameInitiator,
-                    session_->initiator());
-
-  reports_[report.id] = report;
+  // Extract information from the base session. The reports are updated in
+  // place.
+  const std::string session_report_id =
+      StatsId(StatsReport::kStatsReportTypeSession, session_->id());
+  StatsReport& session_report = reports_[session_report_id];
+  session_report.id = session_report_id;
+  session_report.type = StatsReport::kStatsReportTypeSession;
+  session_report.timestamp = stats_gathering_started_;
+  session_report.SetBoolean(StatsReport::kStatsValueNameInitiator,
+                            session_->initiator());
+  // The phases of the call setup which have completed.
+  const WebRtcSession::SetupTimes& setup_times = session_->setup_times();
+  if (setup_times.create_channels_ms >= 0) {
+    session_report.SetValue(StatsReport::kStatsValueNameChannelSetupTimeMs,
+                            setup_times.create_channels_ms);
+  }
+  if (setup_times.first_candidate_ms >= 0) {
+    session_report.SetValue(StatsReport::kStatsValueNameFirstCandidateTimeMs,
+                            setup_times.first_candidate_ms);
+  }
+  if (setup_times.ice_connected_ms >= 0) {
+    session_report.SetValue(StatsReport::kStatsValueNameIceConnectedTimeMs,
+                            setup_times.ice_connected_ms);
+  }
 
   cricket::SessionStats stats;
   if (session_->GetStats(&stats)) {
@@ -865,61 +961,67 @@ void StatsCollector::ExtractSessionInfo() {
                = transport_iter->second.channel_stats.begin();
            channel_iter != transport_iter->second.channel_stats.end();
            ++channel_iter) {
-        StatsReport channel_report;
         std::ostringstream ostc;
         ostc << "Channel-" << transport_iter->second.content_name
              << "-" << channel_iter->component;
+        StatsReport& channel_report = reports_[ostc.str()];
         channel_report.id = ostc.str();
         channel_report.type = StatsReport::kStatsReportTypeComponent;
         channel_report.timestamp = stats_gathering_started_;
-        channel_report.AddValue(StatsReport::kStatsValueNameComponent,
+        channel_report.SetValue(StatsReport::kStatsValueNameComponent,
                                 channel_iter->component);
-        if (!local_cert_report_id.empty())
-          channel_report.AddValue(
+        if (!local_cert_report_id.empty()) {
+          channel_report.SetValue(
               StatsReport::kStatsValueNameLocalCertificateId,
               local_cert_report_id);
-        if (!remote_cert_report_id.empty())
-          channel_report.AddValue(
+        } else {
+          channel_report.RemoveValue(
+              StatsReport::kStatsValueNameLocalCertificateId);
+        }
+        if (!remote_cert_report_id.empty()) {
+          channel_report.SetValue(
               StatsReport::kStatsValueNameRemoteCertificateId,
               remote_cert_report_id);
-        reports_[channel_report.id] = channel_report;
+        } else {
+          channel_report.RemoveValue(
+              StatsReport::kStatsValueNameRemoteCertificateId);
+        }
         for (size_t i = 0;
              i < channel_iter->connection_infos.size();
              ++i) {
-          StatsReport report;
           const cricket::ConnectionInfo& info
               = channel_iter->connection_infos[i];
           std::ostringstream ost;
           ost << "Conn-" << transport_iter->first << "-"
               << channel_iter->component << "-" << i;
+          StatsReport& report = reports_[ost.str()];
           report.id = ost.str();
           report.type = StatsReport::kStatsReportTypeCandidatePair;
           report.timestamp = stats_gathering_started_;
           // Link from connection to its containing channel.
-          report.AddValue(StatsReport::kStatsValueNameChannelId,
+          report.SetValue(StatsReport::kStatsValueNameChannelId,
                           channel_report.id);
-          report.AddValue(StatsReport::kStatsValueNameBytesSent,
+          report.SetValue(StatsReport::kStatsValueNameBytesSent,
                           info.sent_total_bytes);
-          report.AddValue(StatsReport::kStatsValueNameBytesReceived,
+          report.SetValue(StatsReport::kStatsValueNameBytesReceived,
                           info.recv_total_bytes);
-          report.AddBoolean(StatsReport::kStatsValueNameWritable,
+          report.SetBoolean(StatsReport::kStatsValueNameWritable,
                             info.writable);
-          report.AddBoolean(StatsReport::kStatsValueNameReadable,
+          report.SetBoolean(StatsReport::kStatsValueNameReadable,
                             info.readable);
-          report.AddBoolean(StatsReport::kStatsValueNameActiveConnection,
+          report.SetBoolean(StatsReport::kStatsValueNameActiveConnection,
                             info.best_connection);
-          report.AddValue(StatsReport::kStatsValueNameLocalAddress,
+          report.SetValue(StatsReport::kStatsValueNameLocalAddress,
                           info.local_candidate.address().ToString());
-          report.AddValue(StatsReport::kStatsValueNameRemoteAddress,
+          report.SetValue(StatsReport::kStatsValueNameRemoteAddress,
                           info.remote_candidate.address().ToString());
-          report.AddValue(StatsReport::kStatsValueNameRtt, info.rtt);
-          report.AddValue(StatsReport::kStatsValueNameTransportType,
+          report.SetValue(StatsReport::kStatsValueNameRtt, info.rtt);
+          report.SetValue(StatsReport::kStatsValueNameTransportType,
                           info.local_candidate.protocol());
-          report.AddValue(StatsReport::kStatsValueNameLocalCandidateType,
+          report.SetValue(StatsReport::kStatsValueNameLocalCandidateType,
                           info.local_candidate.type());
-          report.AddValue(StatsReport::kStatsValueNameRemoteCandidateType,
+          report.SetValue(StatsReport::kStatsValueNameRemoteCandidateType,
                           info.remote_candidate.type());
-          reports_[report.id] = report;
         }
       }
     }
@@ -1050,8 +1152,8 @@ void StatsCollector::UpdateReportFromAudioTrack(AudioTrackInterface* track,
 
   int signal_level = 0;
   if (track->GetSignalLevel(&signal_level)) {
-    report->ReplaceValue(StatsReport::kStatsValueNameAudioInputLevel,
-                         rtc::ToString<int>(signal_level));
+    report->SetValue(StatsReport::kStatsValueNameAudioInputLevel,
+                     signal_level);
   }
 
   rtc::scoped_refptr<AudioProcessorInterface> audio_processor(
@@ -1061,19 +1163,18 @@ void StatsCollector::UpdateReportFromAudioTrack(AudioTrackInterface* track,
 
   AudioProcessorInterface::AudioProcessorStats stats;
   audio_processor->GetStats(&stats);
-  report->ReplaceValue(StatsReport::kStatsValueNameTypingNoiseState,
-                       stats.typing_noise_detected ? "true" : "false");
-  report->ReplaceValue(StatsReport::kStatsValueNameEchoReturnLoss,
-                       rtc::ToString<int>(stats.echo_return_loss));
-  report->ReplaceValue(
-      StatsReport::kStatsValueNameEchoReturnLossEnhancement,
-      rtc::ToString<int>(stats.echo_return_loss_enhancement));
-  report->ReplaceValue(StatsReport::kStatsValueNameEchoDelayMedian,
-                       rtc::ToString<int>(stats.echo_delay_median_ms));
-  report->ReplaceValue(StatsReport::kStatsValueNameEchoCancellationQualityMin,
-                       rtc::ToString<float>(stats.aec_quality_min));
-  report->ReplaceValue(StatsReport::kStatsValueNameEchoDelayStdDev,
-                       rtc::ToString<int>(stats.echo_delay_std_ms));
+  report->SetBoolean(StatsReport::kStatsValueNameTypingNoiseState,
+                     stats.typing_noise_detected);
+  report->SetValue(StatsReport::kStatsValueNameEchoReturnLoss,
+                   stats.echo_return_loss);
+  report->SetValue(StatsReport::kStatsValueNameEchoReturnLossEnhancement,
+                   stats.echo_return_loss_enhancement);
+  report->SetValue(StatsReport::kStatsValueNameEchoDelayMedian,
+                   stats.echo_delay_median_ms);
+  report->SetValue(StatsReport::kStatsValueNameEchoCancellationQualityMin,
+                   rtc::ToString<float>(stats.aec_quality_min));
+  report->SetValue(StatsReport::kStatsValueNameEchoDelayStdDev,
+                   stats.echo_delay_std_ms);
 }
 
 bool StatsCollector::GetTrackIdBySsrc(uint32 ssrc, std::string* track_id,
@@ -75,6 +75,11 @@ class StatsCollector {
   bool GetStats(MediaStreamTrackInterface* track,
                 StatsReports* reports);
 
+  // Gets the values which changed since the last call, in reports which only
+  // hold those values. The reports without a changed value are left out.
+  // UpdateStats must be called before this function, like for GetStats.
+  void GetStatsDelta(StatsReports* reports);
+
   // Prepare an SSRC report for the given ssrc. Used internally
   // in the ExtractStatsFromList template.
   StatsReport* PrepareLocalReport(uint32 ssrc, const std::string& transport,
@@ -120,7 +125,8 @@ class StatsCollector {
   bool GetTrackIdBySsrc(uint32 ssrc, std::string* track_id,
                         TrackDirection direction);
 
-  // A map from the report id to the report.
+  // A map from the report id to the report. The reports are kept between
+  // updates and their values updated in place.
   std::map<std::string, StatsReport> reports_;
   // Raw pointer to the session the statistics are gathered from.
   WebRtcSession* const session_;
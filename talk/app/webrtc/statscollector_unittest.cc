@@ -696,6 +696,64 @@ TEST_F(StatsCollectorTest, BytesCounterHandles64Bits) {
   EXPECT_EQ(kBytesSentString, result);
 }
 
+// Test that a second update changes the values in place, and that the delta
+// only holds the values which changed between the updates.
+TEST_F(StatsCollectorTest, GetStatsDeltaHasOnlyChangedValues) {
+  webrtc::StatsCollector stats(&session_);  // Implementation under test.
+  MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+      media_engine_, media_channel, &session_, "", false, NULL);
+  StatsReports reports;  // returned values.
+  cricket::VideoSenderInfo video_sender_info;
+  cricket::VideoMediaInfo stats_read;
+  cricket::VideoMediaInfo stats_read_later;
+
+  AddOutgoingVideoTrackStats();
+  stats.AddStream(stream_);
+
+  video_sender_info.add_ssrc(1234);
+  video_sender_info.bytes_sent = 1000;
+  video_sender_info.packets_sent = 10;
+  stats_read.senders.push_back(video_sender_info);
+  video_sender_info.bytes_sent = 2000;
+  stats_read_later.senders.push_back(video_sender_info);
+
+  EXPECT_CALL(session_, video_channel()).WillRepeatedly(Return(&video_channel));
+  EXPECT_CALL(session_, voice_channel()).WillRepeatedly(ReturnNull());
+  EXPECT_CALL(*media_channel, GetStats(_, _))
+      .WillOnce(DoAll(SetArgPointee<1>(stats_read), Return(true)))
+      .WillOnce(DoAll(SetArgPointee<1>(stats_read_later), Return(true)));
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  stats.GetStatsDelta(&reports);
+  EXPECT_EQ("1000", ExtractSsrcStatsValue(reports,
+      StatsReport::kStatsValueNameBytesSent));
+
+  stats.ClearUpdateStatsCache();
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  stats.GetStatsDelta(&reports);
+  const StatsReport* report = FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeSsrc, 1);
+  ASSERT_TRUE(report != NULL);
+  ASSERT_EQ(1u, report->values.size());
+  EXPECT_EQ(StatsReport::kStatsValueNameBytesSent, report->values[0].name);
+  EXPECT_EQ("2000", report->values[0].value);
+  EXPECT_TRUE(FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeSession, 1) == NULL);
+
+  // The full reports have each value once.
+  stats.GetStats(NULL, &reports);
+  report = FindNthReportByType(reports, StatsReport::kStatsReportTypeSsrc, 1);
+  ASSERT_TRUE(report != NULL);
+  int bytes_sent_values = 0;
+  for (size_t i = 0; i < report->values.size(); ++i) {
+    if (report->values[i].name == StatsReport::kStatsValueNameBytesSent)
+      ++bytes_sent_values;
+  }
+  EXPECT_EQ(1, bytes_sent_values);
+  EXPECT_EQ("2000", ExtractSsrcStatsValue(reports,
+      StatsReport::kStatsValueNameBytesSent));
+}
+
 // Test that BWE information is reported via stats.
 TEST_F(StatsCollectorTest, BandwidthEstimationInfoIsReported) {
   webrtc::StatsCollector stats(&session_);  // Implementation under test.
@@ -51,12 +51,23 @@ class StatsReport {
   std::string type;  // See below for contents.
 
   struct Value {
-    Value() : name(NULL) {}
+    Value() : name(NULL), int_value(0), is_int(false), changed(true) {}
     // The copy ctor can't be declared as explicit due to problems with STL.
-    Value(const Value& other) : name(other.name), value(other.value) {}
-    explicit Value(StatsValueName name) : name(name) {}
+    Value(const Value& other)
+        : name(other.name),
+          value(other.value),
+          int_value(other.int_value),
+          is_int(other.is_int),
+          changed(other.changed) {}
+    explicit Value(StatsValueName name)
+        : name(name), int_value(0), is_int(false), changed(true) {}
     Value(StatsValueName name, const std::string& value)
-        : name(name), value(value) {
+        : name(name), value(value), int_value(0), is_int(false),
+          changed(true) {
+    }
+    Value(StatsValueName name, int64 int_value)
+        : name(name), value(rtc::ToString<int64>(int_value)),
+          int_value(int_value), is_int(true), changed(true) {
     }
 
     // TODO(tommi): Remove this operator once we don't need it.
@@ -65,6 +76,9 @@ class StatsReport {
     Value& operator=(const Value& other) {
       const_cast<StatsValueName&>(name) = other.name;
       value = other.value;
+      int_value = other.int_value;
+      is_int = other.is_int;
+      changed = other.changed;
       return *this;
     }
 
@@ -76,6 +90,13 @@ class StatsReport {
     const StatsValueName name;
 
     std::string value;
+    // The number held by |value| if it was set from an integer. Lets an
+    // integer which has not changed skip the formatting of |value|.
+    int64 int_value;
+    bool is_int;
+    // Set whenever |value| changes, and cleared by
+    // StatsCollector::GetStatsDelta().
+    bool changed;
   };
 
   void AddValue(StatsValueName name, const std::string& value);
@@ -86,6 +107,18 @@ class StatsReport {
 
   void ReplaceValue(StatsValueName name, const std::string& value);
 
+  // Like AddValue() and AddBoolean(), but update the value of |name| in place
+  // if the report already has one. A value is only marked as changed, and an
+  // integer only formatted, when it differs from the previous one.
+  void SetValue(StatsValueName name, const std::string& value);
+  void SetValue(StatsValueName name, int64 value);
+  void SetBoolean(StatsValueName name, bool value);
+  // Removes the value of |name|, if the report has one.
+  void RemoveValue(StatsValueName name);
+
+  // Returns the value of |name|, or NULL if the report has none.
+  Value* FindValue(StatsValueName name);
+
   double timestamp;  // Time since 1970-01-01T00:00:00Z in milliseconds.
   typedef std::vector<Value> Values;
   Values values;
@@ -162,6 +195,7 @@ class StatsReport {
 
   // Internal StatsValue names
   static const char kStatsValueNameAvgEncodeMs[];
+  static const char kStatsValueNameEncodeCpuUsagePercent[];
   static const char kStatsValueNameEncodeRelStdDev[];
   static const char kStatsValueNameEncodeUsagePercent[];
   static const char kStatsValueNameCaptureJitterMs[];
@@ -213,6 +247,9 @@ class StatsReport {
   static const char kStatsValueNameTransmitBitrate[];
   static const char kStatsValueNameBucketDelay[];
   static const char kStatsValueNameInitiator[];
+  static const char kStatsValueNameChannelSetupTimeMs[];
+  static const char kStatsValueNameFirstCandidateTimeMs[];
+  static const char kStatsValueNameIceConnectedTimeMs[];
   static const char kStatsValueNameTransportType[];
   static const char kStatsValueNameContentName[];
   static const char kStatsValueNameComponent[];
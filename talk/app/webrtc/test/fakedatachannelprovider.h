@@ -30,7 +30,8 @@
 class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
  public:
   FakeDataChannelProvider()
-      : send_blocked_(false),
+      : send_batch_count_(0),
+        send_blocked_(false),
         transport_available_(false),
         ready_to_send_(false),
         transport_error_(false) {}
@@ -54,6 +55,19 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     return true;
   }
 
+  virtual size_t SendDataBatch(
+      const std::vector<cricket::SendDataParams>& params,
+      const std::vector<const rtc::Buffer*>& payloads,
+      cricket::SendDataResult* result) OVERRIDE {
+    ++send_batch_count_;
+    size_t sent = 0;
+    while (sent < params.size() &&
+           SendData(params[sent], *payloads[sent], result)) {
+      ++sent;
+    }
+    return sent;
+  }
+
   virtual bool ConnectDataChannel(webrtc::DataChannel* data_channel) OVERRIDE {
     ASSERT(connected_channels_.find(data_channel) == connected_channels_.end());
     if (!transport_available_) {
@@ -130,6 +144,10 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     return last_send_data_params_;
   }
 
+  int send_batch_count() const {
+    return send_batch_count_;
+  }
+
   bool IsConnected(webrtc::DataChannel* data_channel) const {
     return connected_channels_.find(data_channel) != connected_channels_.end();
   }
@@ -144,6 +162,7 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
 
  private:
   cricket::SendDataParams last_send_data_params_;
+  int send_batch_count_;
   bool send_blocked_;
   bool transport_available_;
   bool ready_to_send_;
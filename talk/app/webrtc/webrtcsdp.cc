@@ -424,6 +424,8 @@ static bool AddLine(const std::string& line, std::string* message) {
   return true;
 }
 
+// Copies the line at |*pos| of |message| to |line|, reusing the buffer of
+// |line|, and moves |*pos| to the next line.
 static bool GetLine(const std::string& message,
                     size_t* pos,
                     std::string* line) {
@@ -432,13 +434,11 @@ static bool GetLine(const std::string& message,
   if (line_end == std::string::npos) {
     return false;
   }
-  // Update the new start position
-  *pos = line_end + 1;
-  if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
+  const size_t next_line_begin = line_end + 1;
+  if (line_end > line_begin && (message[line_end - 1] == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
-  const char* cline = line->c_str();
+  const size_t line_length = line_end - line_begin;
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
   // the form:
@@ -446,12 +446,16 @@ static bool GetLine(const std::string& message,
   // where <type> MUST be exactly one case-significant character and
   // <value> is structured text whose format depends on <type>.
   // Whitespace MUST NOT be used on either side of the "=" sign.
-  if (cline[0] == kSdpDelimiterSpace ||
-      cline[1] != kSdpDelimiterEqual ||
-      cline[2] == kSdpDelimiterSpace) {
-    *pos = line_begin;
+  if (line_length < kLinePrefixLength ||
+      message[line_begin] == kSdpDelimiterSpace ||
+      message[line_begin + 1] != kSdpDelimiterEqual ||
+      (line_length > kLinePrefixLength &&
+       message[line_begin + 2] == kSdpDelimiterSpace)) {
     return false;
   }
+  line->assign(message, line_begin, line_length);
+  // Update the new start position
+  *pos = next_line_begin;
   return true;
 }
 
@@ -515,9 +519,8 @@ static bool GetLineWithType(const std::string& message, size_t* pos,
   return true;
 }
 
-static bool HasAttribute(const std::string& line,
-                         const std::string& attribute) {
-  return (line.compare(kLinePrefixLength, attribute.size(), attribute) == 0);
+static bool HasAttribute(const std::string& line, const char* attribute) {
+  return (line.compare(kLinePrefixLength, strlen(attribute), attribute) == 0);
 }
 
 // Verifies the candiate to be of the format candidate:<blah>
@@ -556,25 +559,24 @@ static bool SplitByDelimiter(const std::string& message,
   if (pos == std::string::npos) {
     return false;
   }
-  *field1 = message.substr(0, pos);
+  field1->assign(message, 0, pos);
   // The rest is the value.
-  *field2 = message.substr(pos + 1);
+  field2->assign(message, pos + 1, std::string::npos);
   return true;
 }
 
 // Get value only from <attribute>:<value>.
-static bool GetValue(const std::string& message, const std::string& attribute,
+static bool GetValue(const std::string& message, const char* attribute,
                      std::string* value, SdpParseError* error) {
-  std::string leftpart;
-  if (!SplitByDelimiter(message, kSdpDelimiterColon, &leftpart, value)) {
-    return ParseFailedGetValue(message, attribute, error);
-  }
+  const size_t pos = message.find(kSdpDelimiterColon);
   // The left part should end with the expected attribute.
-  if (leftpart.length() < attribute.length() ||
-      leftpart.compare(leftpart.length() - attribute.length(),
-                       attribute.length(), attribute) != 0) {
+  const size_t attribute_length = strlen(attribute);
+  if (pos == std::string::npos || pos < attribute_length ||
+      message.compare(pos - attribute_length, attribute_length,
+                      attribute) != 0) {
     return ParseFailedGetValue(message, attribute, error);
   }
+  value->assign(message, pos + 1, std::string::npos);
   return true;
 }
 
@@ -791,6 +793,53 @@ static void GetCandidatesByMindex(const SessionDescriptionInterface& desci,
   }
 }
 
+// Returns a generous estimate of the length of the serialized |jdesc|, such
+// that the message is rarely reallocated while it is built.
+static size_t EstimateSdpSize(const JsepSessionDescription& jdesc) {
+  // Typical line lengths, including attributes which come with the element.
+  const size_t kSessionSize = 200;
+  const size_t kContentSize = 600;
+  const size_t kCodecSize = 120;
+  const size_t kSsrcSize = 200;
+  const size_t kCandidateSize = 120;
+  const size_t kCryptoSize = 100;
+  const size_t kExtensionSize = 80;
+
+  const cricket::SessionDescription* desc = jdesc.description();
+  size_t size = kSessionSize;
+  int mline_index = 0;
+  for (cricket::ContentInfos::const_iterator it = desc->contents().begin();
+       it != desc->contents().end(); ++it, ++mline_index) {
+    const MediaContentDescription* mdesc =
+        static_cast<const MediaContentDescription*>(it->description);
+    size_t num_codecs = 0;
+    if (mdesc->type() == cricket::MEDIA_TYPE_AUDIO) {
+      num_codecs = static_cast<const AudioContentDescription*>(
+          mdesc)->codecs().size();
+    } else if (mdesc->type() == cricket::MEDIA_TYPE_VIDEO) {
+      num_codecs = static_cast<const VideoContentDescription*>(
+          mdesc)->codecs().size();
+    } else if (mdesc->type() == cricket::MEDIA_TYPE_DATA) {
+      num_codecs = static_cast<const DataContentDescription*>(
+          mdesc)->codecs().size();
+    }
+    size_t num_ssrcs = 0;
+    for (StreamParamsVec::const_iterator stream =
+             mdesc->streams().begin();
+         stream != mdesc->streams().end(); ++stream) {
+      num_ssrcs += stream->ssrcs.size();
+    }
+    const IceCandidateCollection* candidates = jdesc.candidates(mline_index);
+    if (candidates) {
+      size += candidates->count() * kCandidateSize;
+    }
+    size += kContentSize + num_codecs * kCodecSize + num_ssrcs * kSsrcSize +
+            mdesc->cryptos().size() * kCryptoSize +
+            mdesc->rtp_header_extensions().size() * kExtensionSize;
+  }
+  return size;
+}
+
 std::string SdpSerialize(const JsepSessionDescription& jdesc) {
   const cricket::SessionDescription* desc = jdesc.description();
   if (!desc) {
@@ -798,6 +847,7 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc) {
   }
 
   std::string message;
+  message.reserve(EstimateSdpSize(jdesc));
 
   // Session Description.
   AddLine(kSessionVersion, &message);
@@ -2654,7 +2704,8 @@ bool ParseSsrcAttribute(const std::string& line, SsrcInfoVec* ssrc_infos,
   // a=ssrc:<ssrc-id> <attribute>
   // a=ssrc:<ssrc-id> <attribute>:<value>
   std::string field1, field2;
-  if (!SplitByDelimiter(line.substr(kLinePrefixLength),
+  // The "a=" prefix stays in |field1|, which GetValue() accepts.
+  if (!SplitByDelimiter(line,
                         kSdpDelimiterSpace,
                         &field1,
                         &field2)) {
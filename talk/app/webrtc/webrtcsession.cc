@@ -38,10 +38,12 @@
 #include "talk/app/webrtc/mediastreamsignaling.h"
 #include "talk/app/webrtc/peerconnectioninterface.h"
 #include "talk/app/webrtc/webrtcsessiondescriptionfactory.h"
+#include "webrtc/base/bind.h"
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/stringencode.h"
 #include "webrtc/base/stringutils.h"
+#include "webrtc/base/timeutils.h"
 #include "talk/media/base/constants.h"
 #include "talk/media/base/videocapturer.h"
 #include "talk/session/media/channel.h"
@@ -75,6 +77,10 @@ const char kSdpWithoutIceUfragPwd[] =
 const char kSessionError[] = "Session error code: ";
 const char kSessionErrorDesc[] = "Session error description: ";
 
+// The number of sent video packets kept per stream for retransmission in low
+// memory mode, down from 600. That's still over a second of history at 1 Mbps.
+static const int kLowMemoryVideoPacketHistorySize = 128;
+
 // Compares |answer| against |offer|. Comparision is done
 // for number of m-lines in answer against offer. If matches true will be
 // returned otherwise false.
@@ -465,7 +471,9 @@ WebRtcSession::WebRtcSession(
       older_version_remote_peer_(false),
       dtls_enabled_(false),
       data_channel_type_(cricket::DCT_NONE),
-      ice_restart_latch_(new IceRestartAnswerLatch) {
+      ice_restart_latch_(new IceRestartAnswerLatch),
+      setup_started_(false),
+      setup_start_time_(0) {
 }
 
 WebRtcSession::~WebRtcSession() {
@@ -511,6 +519,14 @@ bool WebRtcSession::Initialize(
     }
   }
 
+  rtc::KeyType identity_key_type = rtc::KT_DEFAULT;
+  if (FindConstraint(
+          constraints,
+          MediaConstraintsInterface::kEcdsaDtlsIdentity,
+          &value, NULL) && value) {
+    identity_key_type = rtc::KT_ECDSA;
+  }
+
   // Enable creation of RTP data channels if the kEnableRtpDataChannels is set.
   // It takes precendence over the disable_sctp_data_channels
   // PeerConnectionFactoryInterface::Options.
@@ -613,6 +629,12 @@ bool WebRtcSession::Initialize(
       MediaConstraintsInterface::kOpusFec,
       &audio_options_.opus_fec);
 
+  if (options.low_memory) {
+    LOG(LS_INFO) << "Using low memory mode.";
+    video_options_.video_packet_history_size.Set(
+        kLowMemoryVideoPacketHistorySize);
+  }
+
   const cricket::VideoCodec default_codec(
       JsepSessionDescription::kDefaultVideoCodecId,
       JsepSessionDescription::kDefaultVideoCodecName,
@@ -631,7 +653,8 @@ bool WebRtcSession::Initialize(
       this,
       id(),
       data_channel_type_,
-      dtls_enabled_));
+      dtls_enabled_,
+      identity_key_type));
 
   webrtc_session_desc_factory_->SignalIdentityReady.connect(
       this, &WebRtcSession::OnIdentityReady);
@@ -695,6 +718,15 @@ bool WebRtcSession::GetSslRole(rtc::SSLRole* role) {
 
 void WebRtcSession::CreateOffer(CreateSessionDescriptionObserver* observer,
                                 const MediaConstraintsInterface* constraints) {
+  StartSetupClock();
+  // Have the worker thread create the media channels of the first offer
+  // while the offer is being made.
+  cricket::MediaSessionOptions options;
+  if (!voice_channel_ && !video_channel_ &&
+      mediastream_signaling_->GetOptionsForOffer(constraints, &options)) {
+    channel_manager_->PrewarmMediaChannels(options.has_audio,
+                                           options.has_video);
+  }
   webrtc_session_desc_factory_->CreateOffer(observer, constraints);
 }
 
@@ -773,6 +805,9 @@ bool WebRtcSession::SetRemoteDescription(SessionDescriptionInterface* desc,
 
   // Transport and Media channels will be created only when offer is set.
   Action action = GetAction(desc->type());
+  if (action == kOffer) {
+    StartSetupClock();
+  }
   if (action == kOffer && !CreateChannels(desc->description())) {
     // TODO(mallinath) - Handle CreateChannel failure, as new local description
     // is applied. Restore back to old description.
@@ -936,6 +971,15 @@ void WebRtcSession::SetAudioPlayout(uint32 ssrc, bool enable,
     LOG(LS_ERROR) << "SetAudioPlayout: No audio channel exists.";
     return;
   }
+  // Configure the channel in one trip to the worker thread, where the calls
+  // of the channel run directly.
+  worker_thread()->Invoke<void>(rtc::Bind(&WebRtcSession::SetAudioPlayout_w,
+                                          this, ssrc, enable, renderer));
+}
+
+void WebRtcSession::SetAudioPlayout_w(uint32 ssrc, bool enable,
+                                      cricket::AudioRenderer* renderer) {
+  ASSERT(worker_thread()->IsCurrent());
   if (!voice_channel_->SetRemoteRenderer(ssrc, renderer)) {
     // SetRenderer() can fail if the ssrc does not match any playout channel.
     LOG(LS_ERROR) << "SetAudioPlayout: ssrc is incorrect: " << ssrc;
@@ -957,6 +1001,15 @@ void WebRtcSession::SetAudioSend(uint32 ssrc, bool enable,
     LOG(LS_ERROR) << "SetAudioSend: No audio channel exists.";
     return;
   }
+  worker_thread()->Invoke<void>(rtc::Bind(&WebRtcSession::SetAudioSend_w,
+                                          this, ssrc, enable, options,
+                                          renderer));
+}
+
+void WebRtcSession::SetAudioSend_w(uint32 ssrc, bool enable,
+                                   const cricket::AudioOptions& options,
+                                   cricket::AudioRenderer* renderer) {
+  ASSERT(worker_thread()->IsCurrent());
   if (!voice_channel_->SetLocalRenderer(ssrc, renderer)) {
     // SetRenderer() can fail if the ssrc does not match any send channel.
     LOG(LS_ERROR) << "SetAudioSend: ssrc is incorrect: " << ssrc;
@@ -1028,6 +1081,13 @@ void WebRtcSession::SetVideoSend(uint32 ssrc, bool enable,
     LOG(LS_WARNING) << "SetVideoSend: No video channel exists.";
     return;
   }
+  worker_thread()->Invoke<void>(rtc::Bind(&WebRtcSession::SetVideoSend_w,
+                                          this, ssrc, enable, options));
+}
+
+void WebRtcSession::SetVideoSend_w(uint32 ssrc, bool enable,
+                                   const cricket::VideoOptions* options) {
+  ASSERT(worker_thread()->IsCurrent());
   if (!video_channel_->MuteStream(ssrc, !enable)) {
     // Allow that MuteStream fail if |enable| is false but assert otherwise.
     // This in the normal case when the underlying media channel has already
@@ -1091,6 +1151,17 @@ bool WebRtcSession::SendData(const cricket::SendDataParams& params,
   return data_channel_->SendData(params, payload, result);
 }
 
+size_t WebRtcSession::SendDataBatch(
+    const std::vector<cricket::SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    cricket::SendDataResult* result) {
+  if (!data_channel_.get()) {
+    LOG(LS_ERROR) << "SendDataBatch called when data_channel_ is NULL.";
+    return 0;
+  }
+  return data_channel_->SendDataBatch(params, payloads, result);
+}
+
 bool WebRtcSession::ConnectDataChannel(DataChannel* webrtc_data_channel) {
   if (!data_channel_.get()) {
     LOG(LS_ERROR) << "ConnectDataChannel called when data_channel_ is NULL.";
@@ -1237,6 +1308,10 @@ void WebRtcSession::SetIceConnectionState(
   }
 
   ice_connection_state_ = state;
+  if (state == PeerConnectionInterface::kIceConnectionConnected &&
+      setup_times_.ice_connected_ms < 0 && setup_started_) {
+    setup_times_.ice_connected_ms = rtc::TimeSince(setup_start_time_);
+  }
   if (ice_observer_) {
     ice_observer_->OnIceConnectionChange(ice_connection_state_);
   }
@@ -1322,6 +1397,11 @@ void WebRtcSession::ProcessNewLocalCandidate(
     return;
   }
 
+  if (setup_times_.first_candidate_ms < 0 && setup_started_ &&
+      !candidates.empty()) {
+    setup_times_.first_candidate_ms = rtc::TimeSince(setup_start_time_);
+  }
+
   for (cricket::Candidates::const_iterator citer = candidates.begin();
       citer != candidates.end(); ++citer) {
     // Use content_name as the candidate media id.
@@ -1469,20 +1549,20 @@ bool WebRtcSession::CreateChannels(const SessionDescription* desc) {
   }
 
   // Creating the media channels and transport proxies.
+  uint32 start_time = rtc::Time();
   const cricket::ContentInfo* voice = cricket::GetFirstAudioContent(desc);
-  if (voice && !voice->rejected && !voice_channel_) {
-    if (!CreateVoiceChannel(voice)) {
-      LOG(LS_ERROR) << "Failed to create voice channel.";
-      return false;
-    }
+  if (voice && (voice->rejected || voice_channel_)) {
+    voice = NULL;
   }
-
   const cricket::ContentInfo* video = cricket::GetFirstVideoContent(desc);
-  if (video && !video->rejected && !video_channel_) {
-    if (!CreateVideoChannel(video)) {
-      LOG(LS_ERROR) << "Failed to create video channel.";
-      return false;
-    }
+  if (video && (video->rejected || video_channel_)) {
+    video = NULL;
+  }
+  if ((voice || video) &&
+      !worker_thread()->Invoke<bool>(
+          rtc::Bind(&WebRtcSession::CreateMediaChannels_w, this,
+                    voice, video))) {
+    return false;
   }
 
   const cricket::ContentInfo* data = cricket::GetFirstDataContent(desc);
@@ -1494,9 +1574,32 @@ bool WebRtcSession::CreateChannels(const SessionDescription* desc) {
     }
   }
 
+  if (setup_times_.create_channels_ms < 0) {
+    setup_times_.create_channels_ms = rtc::TimeSince(start_time);
+  }
+  return true;
+}
+
+bool WebRtcSession::CreateMediaChannels_w(const cricket::ContentInfo* voice,
+                                          const cricket::ContentInfo* video) {
+  if (voice && !CreateVoiceChannel(voice)) {
+    LOG(LS_ERROR) << "Failed to create voice channel.";
+    return false;
+  }
+  if (video && !CreateVideoChannel(video)) {
+    LOG(LS_ERROR) << "Failed to create video channel.";
+    return false;
+  }
   return true;
 }
 
+void WebRtcSession::StartSetupClock() {
+  if (!setup_started_) {
+    setup_started_ = true;
+    setup_start_time_ = rtc::Time();
+  }
+}
+
 bool WebRtcSession::CreateVoiceChannel(const cricket::ContentInfo* content) {
   voice_channel_.reset(channel_manager_->CreateVoiceChannel(
       this, content->name, true));
@@ -197,6 +197,10 @@ class WebRtcSession : public cricket::BaseSession,
   virtual bool SendData(const cricket::SendDataParams& params,
                         const rtc::Buffer& payload,
                         cricket::SendDataResult* result) OVERRIDE;
+  virtual size_t SendDataBatch(
+      const std::vector<cricket::SendDataParams>& params,
+      const std::vector<const rtc::Buffer*>& payloads,
+      cricket::SendDataResult* result) OVERRIDE;
   virtual bool ConnectDataChannel(DataChannel* webrtc_data_channel) OVERRIDE;
   virtual void DisconnectDataChannel(DataChannel* webrtc_data_channel) OVERRIDE;
   virtual void AddSctpDataStream(uint32 sid) OVERRIDE;
@@ -221,6 +225,20 @@ class WebRtcSession : public cricket::BaseSession,
   // For unit test.
   bool waiting_for_identity() const;
 
+  // How long the phases of the first call setup took, in milliseconds, or -1
+  // for the phases which have not completed yet. The candidate and connection
+  // times count from the first CreateOffer() or the remote offer.
+  struct SetupTimes {
+    SetupTimes()
+        : create_channels_ms(-1),
+          first_candidate_ms(-1),
+          ice_connected_ms(-1) {}
+    int create_channels_ms;
+    int first_candidate_ms;
+    int ice_connected_ms;
+  };
+  const SetupTimes& setup_times() const { return setup_times_; }
+
  private:
   // Indicates the type of SessionDescription in a call to SetLocalDescription
   // and SetRemoteDescription.
@@ -248,6 +266,16 @@ class WebRtcSession : public cricket::BaseSession,
       const cricket::Candidates& candidates);
   virtual void OnCandidatesAllocationDone();
 
+  // The parts of SetAudioPlayout(), SetAudioSend() and SetVideoSend() which
+  // configure the channels, run on the worker thread.
+  void SetAudioPlayout_w(uint32 ssrc, bool enable,
+                         cricket::AudioRenderer* renderer);
+  void SetAudioSend_w(uint32 ssrc, bool enable,
+                      const cricket::AudioOptions& options,
+                      cricket::AudioRenderer* renderer);
+  void SetVideoSend_w(uint32 ssrc, bool enable,
+                      const cricket::VideoOptions* options);
+
   // Creates local session description with audio and video contents.
   bool CreateDefaultLocalDescription();
   // Enables media channels to allow sending of media.
@@ -275,6 +303,11 @@ class WebRtcSession : public cricket::BaseSession,
   // the BUNDLE option, this method will disable BUNDLE in PortAllocator.
   // This method will also delete any existing media channels before creating.
   bool CreateChannels(const cricket::SessionDescription* desc);
+  // Creates the voice and video channels with one hop to the worker thread.
+  bool CreateMediaChannels_w(const cricket::ContentInfo* voice,
+                             const cricket::ContentInfo* video);
+  // Starts the clock of |setup_times_| if the setup has not started yet.
+  void StartSetupClock();
 
   // Helper methods to create media channels.
   bool CreateVoiceChannel(const cricket::ContentInfo* content);
@@ -354,6 +387,10 @@ class WebRtcSession : public cricket::BaseSession,
   cricket::AudioOptions audio_options_;
   cricket::VideoOptions video_options_;
 
+  bool setup_started_;
+  uint32 setup_start_time_;
+  SetupTimes setup_times_;
+
   DISALLOW_COPY_AND_ASSIGN(WebRtcSession);
 };
 }  // namespace webrtc
@@ -3136,6 +3136,30 @@ TEST_F(WebRtcSessionTest, TestCreateOfferAfterIdentityRequestReturnSuccess) {
   EXPECT_TRUE(offer != NULL);
 }
 
+#if SSL_USE_OPENSSL
+// Verifies that the identity generated for DTLS has an ECDSA key when asked
+// to, which is signed, and fingerprinted, with SHA-256.
+TEST_F(WebRtcSessionTest, TestCreateOfferWithEcdsaDtlsIdentity) {
+  MAYBE_SKIP_TEST(rtc::SSLStreamAdapter::HaveDtlsSrtp);
+  constraints_.reset(new FakeConstraints());
+  constraints_->AddOptional(
+      webrtc::MediaConstraintsInterface::kEnableDtlsSrtp, true);
+  constraints_->AddOptional(
+      webrtc::MediaConstraintsInterface::kEcdsaDtlsIdentity, true);
+  Init(NULL);
+
+  EXPECT_TRUE_WAIT(!session_->waiting_for_identity(), 1000);
+  rtc::scoped_ptr<SessionDescriptionInterface> offer(CreateOffer(NULL));
+  ASSERT_TRUE(offer != NULL);
+  const TransportInfo* audio =
+      offer->description()->GetTransportInfoByName("audio");
+  ASSERT_TRUE(audio != NULL);
+  ASSERT_TRUE(audio->description.identity_fingerprint.get() != NULL);
+  EXPECT_EQ(rtc::DIGEST_SHA_256,
+            audio->description.identity_fingerprint->algorithm);
+}
+#endif  // SSL_USE_OPENSSL
+
 // Verifies that CreateOffer fails when CreateOffer is called after async
 // identity generation fails.
 TEST_F(WebRtcSessionTest, TestCreateOfferAfterIdentityRequestReturnFailure) {
@@ -111,7 +111,8 @@ WebRtcSessionDescriptionFactory::WebRtcSessionDescriptionFactory(
     WebRtcSession* session,
     const std::string& session_id,
     cricket::DataChannelType dct,
-    bool dtls_enabled)
+    bool dtls_enabled,
+    rtc::KeyType identity_key_type)
     : signaling_thread_(signaling_thread),
       mediastream_signaling_(mediastream_signaling),
       session_desc_factory_(channel_manager, &transport_desc_factory_),
@@ -124,6 +125,7 @@ WebRtcSessionDescriptionFactory::WebRtcSessionDescriptionFactory(
       session_(session),
       session_id_(session_id),
       data_channel_type_(dct),
+      identity_key_type_(identity_key_type),
       identity_request_state_(IDENTITY_NOT_NEEDED) {
   transport_desc_factory_.set_protocol(cricket::ICEPROTO_HYBRID);
   session_desc_factory_.set_add_legacy_streams(false);
@@ -288,7 +290,14 @@ void WebRtcSessionDescriptionFactory::OnMessage(rtc::Message* msg) {
     }
     case MSG_GENERATE_IDENTITY: {
       LOG(LS_INFO) << "Generating identity.";
-      SetIdentity(rtc::SSLIdentity::Generate(kWebRTCIdentityName));
+      rtc::SSLIdentity* identity =
+          rtc::SSLIdentity::Generate(kWebRTCIdentityName, identity_key_type_);
+      if (!identity) {
+        // E.g. an ECDSA key with NSS.
+        OnIdentityRequestFailed(0);
+        break;
+      }
+      SetIdentity(identity);
       break;
     }
     default:
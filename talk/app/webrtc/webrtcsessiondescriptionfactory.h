@@ -28,8 +28,11 @@
 #ifndef TALK_APP_WEBRTC_WEBRTCSESSIONDESCRIPTIONFACTORY_H_
 #define TALK_APP_WEBRTC_WEBRTCSESSIONDESCRIPTIONFACTORY_H_
 
+#include <queue>
+
 #include "talk/app/webrtc/peerconnectioninterface.h"
 #include "webrtc/base/messagehandler.h"
+#include "webrtc/base/sslidentity.h"
 #include "talk/p2p/base/transportdescriptionfactory.h"
 #include "talk/session/media/mediasession.h"
 
@@ -98,7 +101,9 @@ class WebRtcSessionDescriptionFactory : public rtc::MessageHandler,
       WebRtcSession* session,
       const std::string& session_id,
       cricket::DataChannelType dct,
-      bool dtls_enabled);
+      bool dtls_enabled,
+      // The key type of the identity generated without an identity service.
+      rtc::KeyType identity_key_type);
   virtual ~WebRtcSessionDescriptionFactory();
 
   static void CopyCandidatesFromSessionDescription(
@@ -160,6 +165,7 @@ class WebRtcSessionDescriptionFactory : public rtc::MessageHandler,
   WebRtcSession* session_;
   std::string session_id_;
   cricket::DataChannelType data_channel_type_;
+  const rtc::KeyType identity_key_type_;
   IdentityRequestState identity_request_state_;
 
   DISALLOW_COPY_AND_ASSIGN(WebRtcSessionDescriptionFactory);
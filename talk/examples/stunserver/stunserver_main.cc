@@ -31,14 +31,16 @@
 
 #include <iostream>
 
+#include "webrtc/base/stringencode.h"
 #include "webrtc/base/thread.h"
+#include "talk/p2p/base/stunbindingresponder.h"
 #include "talk/p2p/base/stunserver.h"
 
 using namespace cricket;
 
 int main(int argc, char* argv[]) {
-  if (argc != 2) {
-    std::cerr << "usage: stunserver address" << std::endl;
+  if (argc != 2 && argc != 3) {
+    std::cerr << "usage: stunserver address [threads]" << std::endl;
     return 1;
   }
 
@@ -50,6 +52,25 @@ int main(int argc, char* argv[]) {
 
   rtc::Thread *pthMain = rtc::Thread::Current();
 
+  // With a thread count, only Binding requests are answered, on that many
+  // threads sharing the port.
+  if (argc == 3) {
+    int num_threads = 0;
+    if (!rtc::FromString(argv[2], &num_threads) || num_threads < 1) {
+      std::cerr << "Invalid number of threads: " << argv[2] << std::endl;
+      return 1;
+    }
+    StunBindingResponder responder;
+    if (!responder.Start(server_addr, num_threads)) {
+      std::cerr << "Failed to bind the UDP sockets" << std::endl;
+      return 1;
+    }
+    std::cout << "Answering Binding requests at " << server_addr.ToString()
+              << " on " << num_threads << " thread(s)" << std::endl;
+    pthMain->Run();
+    return 0;
+  }
+
   rtc::AsyncUDPSocket* server_socket =
       rtc::AsyncUDPSocket::Create(pthMain->socketserver(), server_addr);
   if (!server_socket) {
@@ -29,6 +29,7 @@
 
 #include "webrtc/base/asyncudpsocket.h"
 #include "webrtc/base/optionsfile.h"
+#include "webrtc/base/scopedptrcollection.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/base/stringencode.h"
 #include "talk/p2p/base/basicpacketsocketfactory.h"
@@ -58,9 +59,70 @@ class TurnFileAuth : public cricket::TurnAuthInterface {
   rtc::OptionsFile file_;
 };
 
+// Runs one TurnServer on its own thread. With several shards, every shard
+// binds its own socket to the internal address with SO_REUSEPORT, and the
+// kernel spreads the clients over the sockets by their 5-tuple. A client thus
+// always reaches the same shard, which owns all of its allocations, so the
+// shards share nothing but the (read-only) auth file.
+class TurnShard : public rtc::Runnable {
+ public:
+  TurnShard(const rtc::SocketAddress& int_addr,
+            const rtc::IPAddress& ext_addr,
+            const std::string& realm,
+            TurnFileAuth* auth,
+            bool reuse_port)
+      : int_addr_(int_addr),
+        ext_addr_(ext_addr),
+        realm_(realm),
+        auth_(auth),
+        reuse_port_(reuse_port) {}
+
+  // Creates the server on |thread|, which must be the current thread.
+  bool Init(rtc::Thread* thread) {
+    rtc::AsyncSocket* socket = thread->socketserver()->CreateAsyncSocket(
+        int_addr_.family(), SOCK_DGRAM);
+    if (!socket)
+      return false;
+    if (reuse_port_ && socket->SetOption(rtc::Socket::OPT_REUSEPORT, 1) < 0) {
+      std::cerr << "Failed to enable SO_REUSEPORT" << std::endl;
+      delete socket;
+      return false;
+    }
+    rtc::AsyncUDPSocket* int_socket =
+        rtc::AsyncUDPSocket::Create(socket, int_addr_);
+    if (!int_socket) {
+      std::cerr << "Failed to create a UDP socket bound at"
+                << int_addr_.ToString() << std::endl;
+      return false;
+    }
+
+    server_.reset(new cricket::TurnServer(thread));
+    server_->set_realm(realm_);
+    server_->set_software(kSoftware);
+    server_->set_auth_hook(auth_);
+    server_->AddInternalSocket(int_socket, cricket::PROTO_UDP);
+    server_->SetExternalSocketFactory(new rtc::BasicPacketSocketFactory(),
+                                      rtc::SocketAddress(ext_addr_, 0));
+    return true;
+  }
+
+  virtual void Run(rtc::Thread* thread) {
+    if (Init(thread))
+      thread->ProcessMessages(rtc::kForever);
+  }
+
+ private:
+  const rtc::SocketAddress int_addr_;
+  const rtc::IPAddress ext_addr_;
+  const std::string realm_;
+  TurnFileAuth* const auth_;
+  const bool reuse_port_;
+  rtc::scoped_ptr<cricket::TurnServer> server_;
+};
+
 int main(int argc, char **argv) {
-  if (argc != 5) {
-    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file"
+  if (argc != 5 && argc != 6) {
+    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file [shards]"
               << std::endl;
     return 1;
   }
@@ -77,25 +139,35 @@ int main(int argc, char **argv) {
     return 1;
   }
 
-  rtc::Thread* main = rtc::Thread::Current();
-  rtc::AsyncUDPSocket* int_socket =
-      rtc::AsyncUDPSocket::Create(main->socketserver(), int_addr);
-  if (!int_socket) {
-    std::cerr << "Failed to create a UDP socket bound at"
-              << int_addr.ToString() << std::endl;
+  int num_shards = 1;
+  if (argc == 6 && (!rtc::FromString(argv[5], &num_shards) ||
+                    num_shards < 1)) {
+    std::cerr << "Invalid number of shards: " << argv[5] << std::endl;
     return 1;
   }
+  const bool reuse_port = num_shards > 1;
 
-  cricket::TurnServer server(main);
   TurnFileAuth auth(argv[4]);
-  server.set_realm(argv[3]);
-  server.set_software(kSoftware);
-  server.set_auth_hook(&auth);
-  server.AddInternalSocket(int_socket, cricket::PROTO_UDP);
-  server.SetExternalSocketFactory(new rtc::BasicPacketSocketFactory(),
-                                  rtc::SocketAddress(ext_addr, 0));
-
-  std::cout << "Listening internally at " << int_addr.ToString() << std::endl;
+
+  // The main thread runs the first shard, and every other shard gets a
+  // thread of its own.
+  rtc::ScopedPtrCollection<TurnShard> shards;
+  rtc::ScopedPtrCollection<rtc::Thread> threads;
+  for (int i = 0; i < num_shards; ++i)
+    shards.PushBack(new TurnShard(int_addr, ext_addr, argv[3], &auth,
+                                  reuse_port));
+
+  rtc::Thread* main = rtc::Thread::Current();
+  if (!shards.collection()[0]->Init(main))
+    return 1;
+  for (int i = 1; i < num_shards; ++i) {
+    rtc::Thread* thread = new rtc::Thread();
+    threads.PushBack(thread);
+    thread->Start(shards.collection()[i]);
+  }
+
+  std::cout << "Listening internally at " << int_addr.ToString()
+            << " with " << num_shards << " shard(s)" << std::endl;
 
   main->Run();
   return 0;
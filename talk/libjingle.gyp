@@ -312,6 +312,8 @@
       'sources': [
         'xmllite/qname.cc',
         'xmllite/qname.h',
+        'xmllite/xmlarena.cc',
+        'xmllite/xmlarena.h',
         'xmllite/xmlbuilder.cc',
         'xmllite/xmlbuilder.h',
         'xmllite/xmlconstants.cc',
@@ -491,10 +493,14 @@
         'media/base/mediaengine.h',
         'media/base/rtpdataengine.cc',
         'media/base/rtpdataengine.h',
+        'media/base/rtpforwarder.cc',
+        'media/base/rtpforwarder.h',
         'media/base/rtpdump.cc',
         'media/base/rtpdump.h',
         'media/base/rtputils.cc',
         'media/base/rtputils.h',
+        'media/base/rtpsplicer.cc',
+        'media/base/rtpsplicer.h',
         'media/base/screencastid.h',
         'media/base/streamparams.cc',
         'media/base/streamparams.h',
@@ -510,6 +516,8 @@
         'media/base/videoprocessor.h',
         'media/base/videorenderer.h',
         'media/base/voiceprocessor.h',
+        'media/base/vp8layerfilter.cc',
+        'media/base/vp8layerfilter.h',
         'media/base/yuvframegenerator.cc',
         'media/base/yuvframegenerator.h',
         'media/devices/deviceinfo.h',
@@ -544,6 +552,8 @@
         'media/webrtc/webrtcvideoframe.h',
         'media/webrtc/webrtcvideoframefactory.cc',
         'media/webrtc/webrtcvideoframefactory.h',
+        'media/webrtc/webrtcvideoframeview.cc',
+        'media/webrtc/webrtcvideoframeview.h',
         'media/webrtc/webrtcvie.h',
         'media/webrtc/webrtcvoe.h',
         'media/webrtc/webrtcvoiceengine.cc',
@@ -716,6 +726,8 @@
         'p2p/base/sessionmessages.h',
         'p2p/base/stun.cc',
         'p2p/base/stun.h',
+        'p2p/base/stunbindingresponder.cc',
+        'p2p/base/stunbindingresponder.h',
         'p2p/base/stunport.cc',
         'p2p/base/stunport.h',
         'p2p/base/stunrequest.cc',
@@ -143,7 +143,9 @@
         'media/base/codec_unittest.cc',
         'media/base/filemediaengine_unittest.cc',
         'media/base/rtpdataengine_unittest.cc',
+        'media/base/rtpforwarder_unittest.cc',
         'media/base/rtpdump_unittest.cc',
+        'media/base/rtpsplicer_unittest.cc',
         'media/base/rtputils_unittest.cc',
         'media/base/streamparams_unittest.cc',
         'media/base/testutils.cc',
@@ -152,11 +154,13 @@
         'media/base/videocapturer_unittest.cc',
         'media/base/videocommon_unittest.cc',
         'media/base/videoengine_unittest.h',
+        'media/base/vp8layerfilter_unittest.cc',
         'media/devices/dummydevicemanager_unittest.cc',
         'media/devices/filevideocapturer_unittest.cc',
         'media/sctp/sctpdataengine_unittest.cc',
         'media/webrtc/webrtcpassthroughrender_unittest.cc',
         'media/webrtc/webrtcvideocapturer_unittest.cc',
+        'media/webrtc/webrtcvideoframeview_unittest.cc',
         # Omitted because depends on non-open-source testdata files.
         # 'media/base/videoframe_unittest.h',
         # 'media/webrtc/webrtcvideoframe_unittest.cc',
@@ -213,6 +217,7 @@
         'p2p/base/relayserver_unittest.cc',
         'p2p/base/session_unittest.cc',
         'p2p/base/stun_unittest.cc',
+        'p2p/base/stunbindingresponder_unittest.cc',
         'p2p/base/stunport_unittest.cc',
         'p2p/base/stunrequest_unittest.cc',
         'p2p/base/stunserver_unittest.cc',
@@ -93,6 +93,8 @@ const char kCodecParamPort[] = "x-google-port";
 
 const int kGoogleRtpDataCodecId = 101;
 const char kGoogleRtpDataCodecName[] = "google-data";
+const int kGoogleRtpDataBatchCodecId = 112;
+const char kGoogleRtpDataBatchCodecName[] = "google-data-batch";
 
 const int kGoogleSctpDataCodecId = 108;
 const char kGoogleSctpDataCodecName[] = "google-sctp-data";
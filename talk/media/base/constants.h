@@ -110,6 +110,10 @@ extern const char kCodecParamPort[];
 // sctpdataengine.h to get the codec names they want to pass in.
 extern const int kGoogleRtpDataCodecId;
 extern const char kGoogleRtpDataCodecName[];
+// The same RTP data, but with several length prefixed messages per packet.
+// Only sent to receivers which negotiated it.
+extern const int kGoogleRtpDataBatchCodecId;
+extern const char kGoogleRtpDataBatchCodecName[];
 
 // TODO(pthatcher): Find an id that won't conflict with anything.  On
 // the other hand, it really shouldn't matter since the id won't be
@@ -329,6 +329,7 @@ struct VideoOptions {
     system_high_adaptation_threshhold.SetFrom(
         change.system_high_adaptation_threshhold);
     buffered_mode_latency.SetFrom(change.buffered_mode_latency);
+    video_packet_history_size.SetFrom(change.video_packet_history_size);
     dscp.SetFrom(change.dscp);
     suspend_below_min_bitrate.SetFrom(change.suspend_below_min_bitrate);
     unsignalled_recv_stream_limit.SetFrom(change.unsignalled_recv_stream_limit);
@@ -337,6 +338,7 @@ struct VideoOptions {
     use_improved_wifi_bandwidth_estimator.SetFrom(
         change.use_improved_wifi_bandwidth_estimator);
     use_payload_padding.SetFrom(change.use_payload_padding);
+    share_encoder.SetFrom(change.share_encoder);
   }
 
   bool operator==(const VideoOptions& o) const {
@@ -367,6 +369,7 @@ struct VideoOptions {
         system_high_adaptation_threshhold ==
             o.system_high_adaptation_threshhold &&
         buffered_mode_latency == o.buffered_mode_latency &&
+        video_packet_history_size == o.video_packet_history_size &&
         dscp == o.dscp &&
         suspend_below_min_bitrate == o.suspend_below_min_bitrate &&
         unsignalled_recv_stream_limit == o.unsignalled_recv_stream_limit &&
@@ -374,7 +377,8 @@ struct VideoOptions {
         screencast_min_bitrate == o.screencast_min_bitrate &&
         use_improved_wifi_bandwidth_estimator ==
             o.use_improved_wifi_bandwidth_estimator &&
-        use_payload_padding == o.use_payload_padding;
+        use_payload_padding == o.use_payload_padding &&
+        share_encoder == o.share_encoder;
   }
 
   std::string ToString() const {
@@ -407,6 +411,7 @@ struct VideoOptions {
     ost << ToStringIfSet("low", system_low_adaptation_threshhold);
     ost << ToStringIfSet("high", system_high_adaptation_threshhold);
     ost << ToStringIfSet("buffered mode latency", buffered_mode_latency);
+    ost << ToStringIfSet("packet history size", video_packet_history_size);
     ost << ToStringIfSet("dscp", dscp);
     ost << ToStringIfSet("suspend below min bitrate",
                          suspend_below_min_bitrate);
@@ -417,6 +422,7 @@ struct VideoOptions {
     ost << ToStringIfSet("improved wifi bwe",
                          use_improved_wifi_bandwidth_estimator);
     ost << ToStringIfSet("payload padding", use_payload_padding);
+    ost << ToStringIfSet("share encoder", share_encoder);
     ost << "}";
     return ost.str();
   }
@@ -477,6 +483,8 @@ struct VideoOptions {
   SettablePercent system_high_adaptation_threshhold;
   // Specify buffered mode latency in milliseconds.
   Settable<int> buffered_mode_latency;
+  // Number of sent packets kept per stream to answer NACKs in real-time mode.
+  Settable<int> video_packet_history_size;
   // Set DSCP value for packet sent from video channel.
   Settable<bool> dscp;
   // Enable WebRTC suspension of video. No video frames will be sent when the
@@ -492,6 +500,9 @@ struct VideoOptions {
   Settable<bool> use_improved_wifi_bandwidth_estimator;
   // Enable payload padding.
   Settable<bool> use_payload_padding;
+  // Let send streams fed by the same capturer with identical settings share
+  // one encoder, also across channels.
+  Settable<bool> share_encoder;
 };
 
 // A class for playing out soundclips.
@@ -887,6 +898,7 @@ struct VideoSenderInfo : public MediaSenderInfo {
         avg_encode_ms(0),
         encode_usage_percent(0),
         encode_rsd(0),
+        encode_cpu_usage_percent(0),
         capture_queue_delay_ms_per_s(0) {
   }
 
@@ -909,6 +921,7 @@ struct VideoSenderInfo : public MediaSenderInfo {
   int avg_encode_ms;
   int encode_usage_percent;
   int encode_rsd;
+  int encode_cpu_usage_percent;
   int capture_queue_delay_ms_per_s;
   VariableInfo<int> adapt_frame_drops;
   VariableInfo<int> effects_frame_drops;
@@ -1290,6 +1303,21 @@ class DataMediaChannel : public MediaChannel {
       const SendDataParams& params,
       const rtc::Buffer& payload,
       SendDataResult* result = NULL) = 0;
+  // Sends the payloads in order and stops at the first one which fails.
+  // Returns the number sent. Implementations may pack several payloads into
+  // one packet.
+  virtual size_t SendDataBatch(
+      const std::vector<SendDataParams>& params,
+      const std::vector<const rtc::Buffer*>& payloads,
+      SendDataResult* result = NULL) {
+    ASSERT(params.size() == payloads.size());
+    size_t sent = 0;
+    while (sent < params.size() &&
+           SendData(params[sent], *payloads[sent], result)) {
+      ++sent;
+    }
+    return sent;
+  }
   // Signals when data is received (params, data, len)
   sigslot::signal3<const ReceiveDataParams&,
                    const char*,
@@ -51,10 +51,16 @@ static const unsigned char kReservedSpace[] = {
 // more than this, we need to increase this number.
 static const size_t kMaxSrtpHmacOverhead = 16;
 
+// Each message of a batch packet is prefixed with its 16-bit length.
+static const size_t kBatchMessageHeaderLen = 2;
+
 RtpDataEngine::RtpDataEngine() {
   data_codecs_.push_back(
       DataCodec(kGoogleRtpDataCodecId,
                 kGoogleRtpDataCodecName, 0));
+  data_codecs_.push_back(
+      DataCodec(kGoogleRtpDataBatchCodecId,
+                kGoogleRtpDataBatchCodecName, 0));
   SetTiming(new rtc::Timing());
 }
 
@@ -125,9 +131,11 @@ void RtpClock::Tick(
 
 const DataCodec* FindUnknownCodec(const std::vector<DataCodec>& codecs) {
   DataCodec data_codec(kGoogleRtpDataCodecId, kGoogleRtpDataCodecName, 0);
+  DataCodec batch_codec(kGoogleRtpDataBatchCodecId,
+                        kGoogleRtpDataBatchCodecName, 0);
   std::vector<DataCodec>::const_iterator iter;
   for (iter = codecs.begin(); iter != codecs.end(); ++iter) {
-    if (!iter->Matches(data_codec)) {
+    if (!iter->Matches(data_codec) && !iter->Matches(batch_codec)) {
       return &(*iter);
     }
   }
@@ -233,18 +241,12 @@ bool RtpDataMediaChannel::RemoveRecvStream(uint32 ssrc) {
 void RtpDataMediaChannel::OnPacketReceived(
     rtc::Buffer* packet, const rtc::PacketTime& packet_time) {
   RtpHeader header;
-  if (!GetRtpHeader(packet->data(), packet->length(), &header)) {
-    // Don't want to log for every corrupt packet.
-    // LOG(LS_WARNING) << "Could not read rtp header from packet of length "
-    //                 << packet->length() << ".";
-    return;
-  }
-
   size_t header_length;
-  if (!GetRtpHeaderLen(packet->data(), packet->length(), &header_length)) {
+  if (!GetRtpHeaderAndLen(packet->data(), packet->length(),
+                          &header, &header_length) ||
+      packet->length() < header_length + sizeof(kReservedSpace)) {
     // Don't want to log for every corrupt packet.
-    // LOG(LS_WARNING) << "Could not read rtp header"
-    //                 << length from packet of length "
+    // LOG(LS_WARNING) << "Could not read rtp header from packet of length "
     //                 << packet->length() << ".";
     return;
   }
@@ -287,7 +289,25 @@ void RtpDataMediaChannel::OnPacketReceived(
   params.ssrc = header.ssrc;
   params.seq_num = header.seq_num;
   params.timestamp = header.timestamp;
-  SignalDataReceived(params, data, data_len);
+  if (codec.name != kGoogleRtpDataBatchCodecName) {
+    SignalDataReceived(params, data, data_len);
+    return;
+  }
+
+  // A batch packet carries one or more length prefixed messages.
+  while (data_len >= kBatchMessageHeaderLen) {
+    size_t message_len = rtc::GetBE16(data);
+    data += kBatchMessageHeaderLen;
+    data_len -= kBatchMessageHeaderLen;
+    if (message_len > data_len) {
+      LOG(LS_WARNING) << "Dropped the rest of truncated data packet "
+                      << header.ssrc << ":" << header.seq_num;
+      return;
+    }
+    SignalDataReceived(params, data, message_len);
+    data += message_len;
+    data_len -= message_len;
+  }
 }
 
 bool RtpDataMediaChannel::SetMaxSendBandwidth(int bps) {
@@ -299,17 +319,12 @@ bool RtpDataMediaChannel::SetMaxSendBandwidth(int bps) {
   return true;
 }
 
-bool RtpDataMediaChannel::SendData(
-    const SendDataParams& params,
-    const rtc::Buffer& payload,
-    SendDataResult* result) {
-  if (result) {
-    // If we return true, we'll set this to SDR_SUCCESS.
-    *result = SDR_ERROR;
-  }
+bool RtpDataMediaChannel::CanSendData(const SendDataParams& params,
+                                      size_t payload_len,
+                                      DataCodec* codec) {
   if (!sending_) {
     LOG(LS_WARNING) << "Not sending packet with ssrc=" << params.ssrc
-                    << " len=" << payload.length() << " before SetSend(true).";
+                    << " len=" << payload_len << " before SetSend(true).";
     return false;
   }
 
@@ -325,12 +340,44 @@ bool RtpDataMediaChannel::SendData(
     return false;
   }
 
-  DataCodec found_codec;
-  if (!FindCodecByName(send_codecs_, kGoogleRtpDataCodecName, &found_codec)) {
+  if (!FindCodecByName(send_codecs_, kGoogleRtpDataCodecName, codec)) {
     LOG(LS_WARNING) << "Not sending data because codec is unknown: "
                     << kGoogleRtpDataCodecName;
     return false;
   }
+  return true;
+}
+
+bool RtpDataMediaChannel::StartPacket(int payload_type, uint32 ssrc,
+                                      double now, RtpHeader* header) {
+  header->payload_type = payload_type;
+  header->ssrc = ssrc;
+  rtp_clock_by_send_ssrc_[ssrc]->Tick(now, &header->seq_num,
+                                      &header->timestamp);
+
+  // The buffer is reused for every packet, unless the last one was handed
+  // over to another thread.
+  send_buffer_.SetCapacity(kDataMaxRtpPacketLen);
+  send_buffer_.SetLength(kMinRtpPacketLen);
+  if (!SetRtpHeader(send_buffer_.data(), send_buffer_.length(), *header)) {
+    return false;
+  }
+  send_buffer_.AppendData(&kReservedSpace, sizeof(kReservedSpace));
+  return true;
+}
+
+bool RtpDataMediaChannel::SendData(
+    const SendDataParams& params,
+    const rtc::Buffer& payload,
+    SendDataResult* result) {
+  if (result) {
+    // If we return true, we'll set this to SDR_SUCCESS.
+    *result = SDR_ERROR;
+  }
+  DataCodec found_codec;
+  if (!CanSendData(params, payload.length(), &found_codec)) {
+    return false;
+  }
 
   size_t packet_len = (kMinRtpPacketLen + sizeof(kReservedSpace)
                        + payload.length() + kMaxSrtpHmacOverhead);
@@ -348,28 +395,18 @@ bool RtpDataMediaChannel::SendData(
   }
 
   RtpHeader header;
-  header.payload_type = found_codec.id;
-  header.ssrc = params.ssrc;
-  rtp_clock_by_send_ssrc_[header.ssrc]->Tick(
-      now, &header.seq_num, &header.timestamp);
-
-  rtc::Buffer packet;
-  packet.SetCapacity(packet_len);
-  packet.SetLength(kMinRtpPacketLen);
-  if (!SetRtpHeader(packet.data(), packet.length(), header)) {
+  if (!StartPacket(found_codec.id, params.ssrc, now, &header)) {
     return false;
   }
-  packet.AppendData(&kReservedSpace, sizeof(kReservedSpace));
-  packet.AppendData(payload.data(), payload.length());
+  send_buffer_.AppendData(payload.data(), payload.length());
 
   LOG(LS_VERBOSE) << "Sent RTP data packet: "
-                  << " stream=" << found_stream.id
                   << " ssrc=" << header.ssrc
                   << ", seqnum=" << header.seq_num
                   << ", timestamp=" << header.timestamp
                   << ", len=" << payload.length();
 
-  MediaChannel::SendPacket(&packet);
+  MediaChannel::SendPacket(&send_buffer_);
   send_limiter_->Use(packet_len, now);
   if (result) {
     *result = SDR_SUCCESS;
@@ -377,4 +414,85 @@ bool RtpDataMediaChannel::SendData(
   return true;
 }
 
+size_t RtpDataMediaChannel::SendDataBatch(
+    const std::vector<SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    SendDataResult* result) {
+  ASSERT(params.size() == payloads.size());
+  DataCodec batch_codec;
+  if (!FindCodecByName(send_codecs_, kGoogleRtpDataBatchCodecName,
+                       &batch_codec)) {
+    // The receiver expects one message per packet.
+    return DataMediaChannel::SendDataBatch(params, payloads, result);
+  }
+
+  size_t sent = 0;
+  while (sent < params.size()) {
+    // Packs the messages following |sent| on the same stream as long as they
+    // fit in one packet.
+    const uint32 ssrc = params[sent].ssrc;
+    size_t packet_len = (kMinRtpPacketLen + sizeof(kReservedSpace)
+                         + kMaxSrtpHmacOverhead);
+    size_t end = sent;
+    while (end < params.size() && params[end].ssrc == ssrc &&
+           params[end].type == cricket::DMT_TEXT &&
+           packet_len + kBatchMessageHeaderLen + payloads[end]->length() <=
+               kDataMaxRtpPacketLen) {
+      packet_len += kBatchMessageHeaderLen + payloads[end]->length();
+      ++end;
+    }
+    if (end - sent < 2) {
+      // Single messages are sent as they are, any error is reported there.
+      if (!SendData(params[sent], *payloads[sent], result)) {
+        return sent;
+      }
+      ++sent;
+      continue;
+    }
+
+    if (result) {
+      *result = SDR_ERROR;
+    }
+    DataCodec found_codec;
+    if (!CanSendData(params[sent], payloads[sent]->length(), &found_codec)) {
+      return sent;
+    }
+
+    double now = timing_->TimerNow();
+
+    if (!send_limiter_->CanUse(packet_len, now)) {
+      LOG(LS_VERBOSE) << "Dropped data packet of len=" << packet_len
+                      << "; already sent " << send_limiter_->used_in_period()
+                      << "/" << send_limiter_->max_per_period();
+      return sent;
+    }
+
+    RtpHeader header;
+    if (!StartPacket(batch_codec.id, ssrc, now, &header)) {
+      return sent;
+    }
+    for (size_t i = sent; i < end; ++i) {
+      uint8 message_len[kBatchMessageHeaderLen];
+      rtc::SetBE16(message_len, static_cast<uint16>(payloads[i]->length()));
+      send_buffer_.AppendData(message_len, sizeof(message_len));
+      send_buffer_.AppendData(payloads[i]->data(), payloads[i]->length());
+    }
+
+    LOG(LS_VERBOSE) << "Sent RTP data batch packet: "
+                    << " ssrc=" << header.ssrc
+                    << ", seqnum=" << header.seq_num
+                    << ", timestamp=" << header.timestamp
+                    << ", messages=" << end - sent
+                    << ", len=" << packet_len;
+
+    MediaChannel::SendPacket(&send_buffer_);
+    send_limiter_->Use(packet_len, now);
+    if (result) {
+      *result = SDR_SUCCESS;
+    }
+    sent = end;
+  }
+  return sent;
+}
+
 }  // namespace cricket
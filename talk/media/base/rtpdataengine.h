@@ -31,6 +31,7 @@
 #include <string>
 #include <vector>
 
+#include "webrtc/base/buffer.h"
 #include "webrtc/base/timing.h"
 #include "talk/media/base/constants.h"
 #include "talk/media/base/mediachannel.h"
@@ -39,6 +40,7 @@
 namespace cricket {
 
 struct DataCodec;
+struct RtpHeader;
 
 class RtpDataEngine : public DataEngineInterface {
  public:
@@ -125,9 +127,23 @@ class RtpDataMediaChannel : public DataMediaChannel {
     const SendDataParams& params,
     const rtc::Buffer& payload,
     SendDataResult* result);
+  // Packs consecutive messages of a stream into one packet when the remote
+  // side negotiated kGoogleRtpDataBatchCodecName.
+  virtual size_t SendDataBatch(
+      const std::vector<SendDataParams>& params,
+      const std::vector<const rtc::Buffer*>& payloads,
+      SendDataResult* result);
 
  private:
   void Construct(rtc::Timing* timing);
+  // Returns true if a message can be sent with |params|, and the codec to
+  // send it with.
+  bool CanSendData(const SendDataParams& params, size_t payload_len,
+                   DataCodec* codec);
+  // Writes the RTP header of the next packet of |ssrc| and the reserved
+  // space to |send_buffer_|.
+  bool StartPacket(int payload_type, uint32 ssrc, double now,
+                   RtpHeader* header);
 
   bool sending_;
   bool receiving_;
@@ -138,6 +154,7 @@ class RtpDataMediaChannel : public DataMediaChannel {
   std::vector<StreamParams> recv_streams_;
   std::map<uint32, RtpClock*> rtp_clock_by_send_ssrc_;
   rtc::scoped_ptr<rtc::RateLimiter> send_limiter_;
+  rtc::Buffer send_buffer_;
 };
 
 }  // namespace cricket
@@ -26,6 +26,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include "webrtc/base/buffer.h"
 #include "webrtc/base/gunit.h"
@@ -56,18 +57,20 @@ class FakeTiming : public rtc::Timing {
 
 class FakeDataReceiver : public sigslot::has_slots<> {
  public:
-  FakeDataReceiver() : has_received_data_(false) {}
+  FakeDataReceiver() : has_received_data_(false), num_received_data_(0) {}
 
   void OnDataReceived(
       const cricket::ReceiveDataParams& params,
       const char* data, size_t len) {
     has_received_data_ = true;
+    ++num_received_data_;
     last_received_data_ = std::string(data, len);
     last_received_data_len_ = len;
     last_received_data_params_ = params;
   }
 
   bool has_received_data() const { return has_received_data_; }
+  int num_received_data() const { return num_received_data_; }
   std::string last_received_data() const { return last_received_data_; }
   size_t last_received_data_len() const { return last_received_data_len_; }
   cricket::ReceiveDataParams last_received_data_params() const {
@@ -76,6 +79,7 @@ class FakeDataReceiver : public sigslot::has_slots<> {
 
  private:
   bool has_received_data_;
+  int num_received_data_;
   std::string last_received_data_;
   size_t last_received_data_len_;
   cricket::ReceiveDataParams last_received_data_params_;
@@ -474,4 +478,128 @@ TEST_F(RtpDataMediaChannelTest, InvalidRtpPackets) {
   // Too short
   dmc->OnPacketReceived(&packet, rtc::PacketTime());
   EXPECT_FALSE(HasReceivedData());
+
+  // Has a header but not the reserved space.
+  unsigned char short_data[] = {
+    0x80, 0x67, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x2A,
+    0x00, 0x00
+  };
+  rtc::Buffer short_packet(short_data, sizeof(short_data));
+  dmc->SetReceive(true);
+  cricket::DataCodec codec;
+  codec.id = 103;
+  codec.name = cricket::kGoogleRtpDataCodecName;
+  std::vector<cricket::DataCodec> codecs;
+  codecs.push_back(codec);
+  ASSERT_TRUE(dmc->SetRecvCodecs(codecs));
+  cricket::StreamParams stream;
+  stream.add_ssrc(42);
+  ASSERT_TRUE(dmc->AddRecvStream(stream));
+  dmc->OnPacketReceived(&short_packet, rtc::PacketTime());
+  EXPECT_FALSE(HasReceivedData());
+}
+
+TEST_F(RtpDataMediaChannelTest, SendDataBatch) {
+  rtc::scoped_ptr<cricket::RtpDataMediaChannel> dmc(CreateChannel());
+
+  ASSERT_TRUE(dmc->SetSend(true));
+  cricket::StreamParams stream;
+  stream.add_ssrc(42);
+  ASSERT_TRUE(dmc->AddSendStream(stream));
+
+  cricket::DataCodec codec;
+  codec.id = 103;
+  codec.name = cricket::kGoogleRtpDataCodecName;
+  std::vector<cricket::DataCodec> codecs;
+  codecs.push_back(codec);
+  ASSERT_TRUE(dmc->SetSendCodecs(codecs));
+
+  unsigned char data[] = "food";
+  rtc::Buffer payload(data, 4);
+  std::string x1150(1150, 'x');
+  rtc::Buffer large_payload(x1150.data(), x1150.length());
+  std::vector<cricket::SendDataParams> params(4);
+  for (size_t i = 0; i < params.size(); ++i) {
+    params[i].ssrc = 42;
+  }
+  std::vector<const rtc::Buffer*> payloads;
+  payloads.push_back(&payload);
+  payloads.push_back(&payload);
+  payloads.push_back(&large_payload);
+  payloads.push_back(&payload);
+  cricket::SendDataResult result;
+
+  // Without the batch codec every message is sent in its own packet.
+  EXPECT_EQ(4U, dmc->SendDataBatch(params, payloads, &result));
+  EXPECT_EQ(cricket::SDR_SUCCESS, result);
+  ASSERT_TRUE(HasSentData(3));
+  EXPECT_FALSE(HasSentData(4));
+
+  cricket::DataCodec batch_codec;
+  batch_codec.id = 104;
+  batch_codec.name = cricket::kGoogleRtpDataBatchCodecName;
+  codecs.push_back(batch_codec);
+  ASSERT_TRUE(dmc->SetSendCodecs(codecs));
+
+  // The first three messages fit in one packet, the last one doesn't and is
+  // sent as a single message.
+  EXPECT_EQ(4U, dmc->SendDataBatch(params, payloads, &result));
+  EXPECT_EQ(cricket::SDR_SUCCESS, result);
+  ASSERT_TRUE(HasSentData(5));
+  EXPECT_FALSE(HasSentData(6));
+
+  cricket::RtpHeader header4 = GetSentDataHeader(4);
+  EXPECT_EQ(104, header4.payload_type);
+  EXPECT_EQ(42U, header4.ssrc);
+  std::string batch = GetSentData(4);
+  ASSERT_EQ(4 + 3 * 2 + 4 + 4 + 1150U, batch.length());
+  EXPECT_EQ(std::string("\x00\x00\x00\x00\x00\x04" "food" "\x00\x04" "food"
+                        "\x04\x7E", 18), batch.substr(0, 18));
+  EXPECT_EQ(x1150, batch.substr(18));
+
+  cricket::RtpHeader header5 = GetSentDataHeader(5);
+  EXPECT_EQ(103, header5.payload_type);
+  EXPECT_EQ(static_cast<uint16>(header4.seq_num + 1),
+            static_cast<uint16>(header5.seq_num));
+  EXPECT_EQ(std::string("\x00\x00\x00\x00" "food", 8), GetSentData(5));
+
+  // Stops at the first message which can't be sent.
+  params[1].ssrc = 43;
+  EXPECT_EQ(1U, dmc->SendDataBatch(params, payloads, &result));
+  EXPECT_EQ(cricket::SDR_ERROR, result);
+}
+
+TEST_F(RtpDataMediaChannelTest, ReceiveDataBatch) {
+  // PT= 104, SN=2, TS=3, SSRC = 4, data = "abc", "", "de"
+  unsigned char data[] = {
+    0x80, 0x68, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x2A,
+    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x03, 'a', 'b', 'c',
+    0x00, 0x00,
+    0x00, 0x02, 'd', 'e'
+  };
+  rtc::Buffer packet(data, sizeof(data));
+
+  rtc::scoped_ptr<cricket::RtpDataMediaChannel> dmc(CreateChannel());
+  dmc->SetReceive(true);
+  cricket::DataCodec codec;
+  codec.id = 104;
+  codec.name = cricket::kGoogleRtpDataBatchCodecName;
+  std::vector<cricket::DataCodec> codecs;
+  codecs.push_back(codec);
+  ASSERT_TRUE(dmc->SetRecvCodecs(codecs));
+  cricket::StreamParams stream;
+  stream.add_ssrc(42);
+  ASSERT_TRUE(dmc->AddRecvStream(stream));
+
+  dmc->OnPacketReceived(&packet, rtc::PacketTime());
+  EXPECT_EQ(3, receiver()->num_received_data());
+  EXPECT_EQ("de", GetReceivedData());
+  EXPECT_EQ(2, GetReceivedDataParams().seq_num);
+
+  // A truncated message is dropped.
+  rtc::Buffer truncated_packet(data, sizeof(data) - 1);
+  dmc->OnPacketReceived(&truncated_packet, rtc::PacketTime());
+  EXPECT_EQ(5, receiver()->num_received_data());
+  EXPECT_EQ("", GetReceivedData());
 }
@@ -0,0 +1,499 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "talk/media/base/rtpforwarder.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/byteorder.h"
+#include "talk/media/base/rtputils.h"
+
+namespace cricket {
+
+static const int64 kRateWindowMs = 1000;
+static const int64 kKeyFrameRequestIntervalMs = 1000;
+// How much more than the bitrate of a higher layer it takes to switch to it.
+static const int kUpSwitchHeadroomPercent = 20;
+static const int kVideoClockRateKhz = 90;
+static const uint16 kOneByteExtensionProfile = 0xBEDE;
+static const int kAbsSendTimeFractionBits = 18;
+
+static const size_t kRtcpSenderReportLen = 28;
+static const size_t kRtcpFeedbackHeaderLen = 12;
+static const int kRtcpRtpfbNack = 1;
+static const int kRtcpPsfbPli = 1;
+static const int kRtcpPsfbFir = 4;
+static const int kRtcpPsfbAfb = 15;
+
+static bool IsNewerSeqNum(uint16 seq_num, uint16 prev_seq_num) {
+  return seq_num != prev_seq_num &&
+         static_cast<uint16>(seq_num - prev_seq_num) < 0x8000;
+}
+
+// Returns the length of the RTCP packet at the start of |data|, or 0 if it
+// does not fit into |len| bytes.
+static size_t GetRtcpPacketLen(const uint8* data, size_t len) {
+  if (len < kMinRtcpPacketLen || (data[0] >> 6) != 2) {
+    return 0;
+  }
+  const size_t packet_len = (rtc::GetBE16(data + 2) + 1) * 4;
+  return packet_len <= len ? packet_len : 0;
+}
+
+RtpForwarder::RtpForwarder(const std::vector<uint32>& layer_ssrcs,
+                           uint32 ssrc)
+    : layer_ssrcs_(layer_ssrcs),
+      ssrc_(ssrc),
+      layers_(layer_ssrcs.size()),
+      layer_(-1),
+      target_layer_(0),
+      key_frame_request_ms_(-1),
+      abs_send_time_id_(0),
+      vp8_payload_type_(-1),
+      red_payload_type_(-1),
+      received_seq_nums_(kSeqNumHistory),
+      sent_seq_nums_(kSeqNumHistory),
+      epoch_(0),
+      newest_seq_num_(0),
+      next_seq_num_(0),
+      timestamp_offset_(0),
+      has_sent_(false),
+      last_timestamp_(0),
+      last_send_ms_(0),
+      packets_sent_(0),
+      payload_bytes_sent_(0) {
+  memset(extension_ids_, 0, sizeof(extension_ids_));
+  for (int i = 0; i < 128; ++i) {
+    payload_types_[i] = static_cast<uint8>(i);
+  }
+}
+
+int RtpForwarder::GetLayer(uint32 ssrc) const {
+  for (size_t i = 0; i < layer_ssrcs_.size(); ++i) {
+    if (layer_ssrcs_[i] == ssrc) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+int RtpForwarder::GetLayerBitrate(int layer) const {
+  return layers_[layer].bitrate_bps;
+}
+
+void RtpForwarder::MapHeaderExtension(int id, int send_id) {
+  if (id > 0 && id < 15 && send_id > 0 && send_id < 15) {
+    extension_ids_[id] = static_cast<uint8>(send_id);
+  }
+}
+
+void RtpForwarder::SetAbsSendTimeExtension(int send_id) {
+  abs_send_time_id_ = send_id;
+}
+
+void RtpForwarder::MapPayloadType(int payload_type, int send_payload_type) {
+  if (payload_type >= 0 && payload_type < 128 && send_payload_type >= 0 &&
+      send_payload_type < 128) {
+    payload_types_[payload_type] = static_cast<uint8>(send_payload_type);
+  }
+}
+
+void RtpForwarder::SetVp8PayloadType(int payload_type,
+                                     int red_payload_type) {
+  vp8_payload_type_ = payload_type;
+  red_payload_type_ = red_payload_type;
+}
+
+void RtpForwarder::SetTargetBitrate(int bitrate_bps) {
+  int target_layer = 0;
+  for (size_t i = 1; i < layers_.size(); ++i) {
+    int64 needed_bps = layers_[i].bitrate_bps;
+    if (needed_bps == 0) {
+      continue;  // Nothing received on the layer yet.
+    }
+    if (static_cast<int>(i) > layer_) {
+      needed_bps = needed_bps * (100 + kUpSwitchHeadroomPercent) / 100;
+    }
+    if (needed_bps <= bitrate_bps) {
+      target_layer = static_cast<int>(i);
+    }
+  }
+  if (target_layer != target_layer_) {
+    target_layer_ = target_layer;
+    key_frame_request_ms_ = -1;
+  }
+  vp8_filter_.SetTargetBitrate(bitrate_bps);
+}
+
+bool RtpForwarder::GetKeyFrameRequest(int64 now_ms, uint32* ssrc) {
+  if (layer_ == target_layer_ ||
+      (key_frame_request_ms_ >= 0 &&
+       now_ms - key_frame_request_ms_ < kKeyFrameRequestIntervalMs)) {
+    return false;
+  }
+  key_frame_request_ms_ = now_ms;
+  *ssrc = layer_ssrcs_[target_layer_];
+  return true;
+}
+
+bool RtpForwarder::RewriteRtp(uint8* data, size_t len, int64 now_ms) {
+  uint32 ssrc;
+  size_t header_len;
+  int seq_num;
+  uint32 timestamp;
+  int payload_type;
+  if (!GetRtpSsrc(data, len, &ssrc) ||
+      !GetRtpHeaderLen(data, len, &header_len) ||
+      !GetRtpSeqNum(data, len, &seq_num) ||
+      !GetRtpTimestamp(data, len, &timestamp) ||
+      !GetRtpPayloadType(data, len, &payload_type)) {
+    return false;
+  }
+  const int layer = GetLayer(ssrc);
+  if (layer < 0) {
+    return false;
+  }
+  UpdateBitrate(layer, len, now_ms);
+
+  // Only the primary encoding of a RED packet with a single block is looked
+  // into.
+  uint8* payload = data + header_len;
+  size_t payload_len = len - header_len;
+  bool vp8 = payload_type == vp8_payload_type_;
+  if (payload_type == red_payload_type_ && payload_len > 0 &&
+      (payload[0] & 0x80) == 0) {
+    vp8 = (payload[0] & 0x7F) == vp8_payload_type_;
+    ++payload;
+    --payload_len;
+  }
+  if (layer != layer_) {
+    if (layer != target_layer_ || !vp8 ||
+        !Vp8LayerFilter::IsKeyFrame(payload, payload_len)) {
+      return false;
+    }
+    SwitchLayer(layer, static_cast<uint16>(seq_num), timestamp, now_ms);
+  }
+
+  // Reordered and retransmitted packets keep the numbers given to them when
+  // newer ones arrived.
+  const bool newest =
+      IsNewerSeqNum(static_cast<uint16>(seq_num), newest_seq_num_);
+  SeqNumMapping* received = &received_seq_nums_[seq_num % kSeqNumHistory];
+  if (!newest && (received->epoch != epoch_ ||
+                  received->seq_num != seq_num || !received->forwarded)) {
+    return false;
+  }
+  if (vp8 && !vp8_filter_.Filter(payload, payload_len, now_ms)) {
+    if (newest) {
+      AddReceivedSeqNum(static_cast<uint16>(seq_num), false);
+    } else {
+      received->forwarded = false;
+    }
+    return false;
+  }
+  const uint16 send_seq_num =
+      newest ? AddReceivedSeqNum(static_cast<uint16>(seq_num), true)
+             : received->mapped_seq_num;
+
+  const uint32 send_timestamp = timestamp + timestamp_offset_;
+  SetRtpSsrc(data, len, ssrc_);
+  SetRtpSeqNum(data, len, send_seq_num);
+  SetRtpTimestamp(data, len, send_timestamp);
+  data[1] = (data[1] & 0x80) | payload_types_[data[1] & 0x7F];
+  if (data[0] & 0x10) {
+    RewriteHeaderExtensions(data, header_len, now_ms);
+  }
+
+  if (newest) {
+    has_sent_ = true;
+    last_timestamp_ = send_timestamp;
+    last_send_ms_ = now_ms;
+  }
+  ++packets_sent_;
+  payload_bytes_sent_ += static_cast<uint32>(len - header_len);
+  return true;
+}
+
+bool RtpForwarder::RewriteSenderReport(const uint8* data, size_t len,
+                                       rtc::Buffer* report) const {
+  if (layer_ < 0) {
+    return false;
+  }
+  const uint32 layer_ssrc = layer_ssrcs_[layer_];
+  size_t packet_len;
+  for (size_t offset = 0;
+       (packet_len = GetRtcpPacketLen(data + offset, len - offset)) != 0;
+       offset += packet_len) {
+    const uint8* packet = data + offset;
+    if (packet[1] != kRtcpTypeSR || packet_len < kRtcpSenderReportLen ||
+        rtc::GetBE32(packet + 4) != layer_ssrc) {
+      continue;
+    }
+    // The report blocks are on what the sender receives, which is of no
+    // concern to the receiver of the sent stream.
+    uint8 sender_report[kRtcpSenderReportLen] = {0x80, kRtcpTypeSR};
+    rtc::SetBE16(sender_report + 2, kRtcpSenderReportLen / 4 - 1);
+    rtc::SetBE32(sender_report + 4, ssrc_);
+    memcpy(sender_report + 8, packet + 8, 8);  // NTP timestamp.
+    rtc::SetBE32(sender_report + 16,
+                 rtc::GetBE32(packet + 16) + timestamp_offset_);
+    rtc::SetBE32(sender_report + 20, packets_sent_);
+    rtc::SetBE32(sender_report + 24, payload_bytes_sent_);
+    report->SetData(sender_report, sizeof(sender_report));
+    return true;
+  }
+  return false;
+}
+
+bool RtpForwarder::RewriteFeedback(const uint8* data, size_t len,
+                                   uint32 sender_ssrc,
+                                   rtc::Buffer* feedback) {
+  // The compound packet starts with an empty receiver report.
+  uint8 receiver_report[8] = {0x80, kRtcpTypeRR};
+  rtc::SetBE16(receiver_report + 2, 1);
+  rtc::SetBE32(receiver_report + 4, sender_ssrc);
+  feedback->SetData(receiver_report, sizeof(receiver_report));
+
+  bool key_frame_request = false;
+  size_t packet_len;
+  for (size_t offset = 0;
+       (packet_len = GetRtcpPacketLen(data + offset, len - offset)) != 0;
+       offset += packet_len) {
+    const uint8* packet = data + offset;
+    const int fmt = packet[0] & 0x1F;
+    if (packet_len < kRtcpFeedbackHeaderLen) {
+      continue;
+    }
+    if (packet[1] == kRtcpTypeRTPFB) {
+      if (fmt == kRtcpRtpfbNack && rtc::GetBE32(packet + 8) == ssrc_) {
+        RewriteNack(packet, packet_len, sender_ssrc, feedback);
+      }
+    } else if (packet[1] == kRtcpTypePSFB) {
+      if (fmt == kRtcpPsfbPli) {
+        key_frame_request |= rtc::GetBE32(packet + 8) == ssrc_;
+      } else if (fmt == kRtcpPsfbFir) {
+        // Turned into a PLI, which leaves the FIR sequence numbers alone.
+        for (size_t entry = kRtcpFeedbackHeaderLen; entry + 8 <= packet_len;
+             entry += 8) {
+          key_frame_request |= rtc::GetBE32(packet + entry) == ssrc_;
+        }
+      } else if (fmt == kRtcpPsfbAfb && packet_len >= 20 &&
+                 memcmp(packet + 12, "REMB", 4) == 0) {
+        const size_t num_ssrcs = packet[16];
+        for (size_t i = 0; i < num_ssrcs && 24 + 4 * i <= packet_len; ++i) {
+          if (rtc::GetBE32(packet + 20 + 4 * i) != ssrc_) {
+            continue;
+          }
+          const int exponent = packet[17] >> 2;
+          const uint64 mantissa =
+              (static_cast<uint64>(packet[17] & 0x03) << 16) |
+              rtc::GetBE16(packet + 18);
+          const uint64 bitrate_bps =
+              exponent < 40 ? mantissa << exponent : INT_MAX;
+          SetTargetBitrate(static_cast<int>(
+              std::min<uint64>(bitrate_bps, INT_MAX)));
+          break;
+        }
+      }
+    }
+  }
+
+  if (key_frame_request && layer_ >= 0) {
+    uint8 pli[kRtcpFeedbackHeaderLen] = {0x80 | kRtcpPsfbPli,
+                                         kRtcpTypePSFB};
+    rtc::SetBE16(pli + 2, kRtcpFeedbackHeaderLen / 4 - 1);
+    rtc::SetBE32(pli + 4, sender_ssrc);
+    rtc::SetBE32(pli + 8, layer_ssrcs_[layer_]);
+    feedback->AppendData(pli, sizeof(pli));
+  }
+  return feedback->length() > sizeof(receiver_report);
+}
+
+void RtpForwarder::UpdateBitrate(int layer, size_t len, int64 now_ms) {
+  Layer& rate = layers_[layer];
+  if (rate.window_start_ms < 0) {
+    rate.window_start_ms = now_ms;
+  } else if (now_ms - rate.window_start_ms >= kRateWindowMs) {
+    rate.bitrate_bps = static_cast<int>(
+        rate.window_bytes * 8 * 1000 / (now_ms - rate.window_start_ms));
+    rate.window_start_ms = now_ms;
+    rate.window_bytes = 0;
+  }
+  rate.window_bytes += len;
+}
+
+void RtpForwarder::SwitchLayer(int layer, uint16 seq_num, uint32 timestamp,
+                               int64 now_ms) {
+  // The first layer keeps its numbering; every later one continues where
+  // the previous one stopped, with the time in between.
+  if (has_sent_) {
+    const int64 elapsed =
+        std::max<int64>(1, (now_ms - last_send_ms_) * kVideoClockRateKhz);
+    timestamp_offset_ =
+        last_timestamp_ + static_cast<uint32>(elapsed) - timestamp;
+    vp8_filter_.SwitchStream();
+  } else {
+    next_seq_num_ = seq_num;
+  }
+  ++epoch_;
+  newest_seq_num_ = static_cast<uint16>(seq_num - 1);
+  layer_ = layer;
+  key_frame_request_ms_ = -1;
+}
+
+uint16 RtpForwarder::AddReceivedSeqNum(uint16 seq_num, bool forwarded) {
+  const uint16 missing = static_cast<uint16>(seq_num - newest_seq_num_ - 1);
+  if (missing < kSeqNumHistory) {
+    for (uint16 i = missing; i > 0; --i) {
+      MapSeqNum(static_cast<uint16>(seq_num - i), next_seq_num_++, true);
+    }
+  }
+  newest_seq_num_ = seq_num;
+  const uint16 send_seq_num = next_seq_num_;
+  if (forwarded) {
+    ++next_seq_num_;
+  }
+  MapSeqNum(seq_num, send_seq_num, forwarded);
+  return send_seq_num;
+}
+
+void RtpForwarder::MapSeqNum(uint16 seq_num, uint16 send_seq_num,
+                             bool forwarded) {
+  SeqNumMapping& received = received_seq_nums_[seq_num % kSeqNumHistory];
+  received.epoch = epoch_;
+  received.seq_num = seq_num;
+  received.mapped_seq_num = send_seq_num;
+  received.forwarded = forwarded;
+  if (forwarded) {
+    SeqNumMapping& sent = sent_seq_nums_[send_seq_num % kSeqNumHistory];
+    sent.epoch = epoch_;
+    sent.seq_num = send_seq_num;
+    sent.mapped_seq_num = seq_num;
+    sent.forwarded = true;
+  }
+}
+
+void RtpForwarder::RewriteHeaderExtensions(uint8* data, size_t header_len,
+                                           int64 now_ms) const {
+  size_t offset = kMinRtpPacketLen + 4 * (data[0] & 0x0F);
+  if (offset + 4 > header_len ||
+      rtc::GetBE16(data + offset) != kOneByteExtensionProfile) {
+    return;
+  }
+  const size_t end = std::min<size_t>(
+      header_len, offset + 4 + 4 * rtc::GetBE16(data + offset + 2));
+  offset += 4;
+  while (offset < end) {
+    const int id = data[offset] >> 4;
+    if (id == 0) {
+      ++offset;  // Padding.
+      continue;
+    }
+    if (id == 15) {
+      break;
+    }
+    const size_t len = (data[offset] & 0x0F) + 1;
+    if (offset + 1 + len > end) {
+      break;
+    }
+    const int send_id = extension_ids_[id];
+    if (send_id == 0) {
+      memset(data + offset, 0, 1 + len);
+    } else {
+      data[offset] = static_cast<uint8>((send_id << 4) | (len - 1));
+      if (send_id == abs_send_time_id_ && len == 3) {
+        const uint32 abs_send_time = static_cast<uint32>(
+            ((now_ms << kAbsSendTimeFractionBits) / 1000) & 0x00FFFFFF);
+        data[offset + 1] = static_cast<uint8>(abs_send_time >> 16);
+        rtc::SetBE16(data + offset + 2, static_cast<uint16>(abs_send_time));
+      }
+    }
+    offset += 1 + len;
+  }
+}
+
+bool RtpForwarder::RewriteNack(const uint8* packet, size_t len,
+                               uint32 sender_ssrc,
+                               rtc::Buffer* feedback) const {
+  if (layer_ < 0) {
+    return false;
+  }
+  const size_t start = feedback->length();
+  uint8 header[kRtcpFeedbackHeaderLen] = {0x80 | kRtcpRtpfbNack,
+                                          kRtcpTypeRTPFB};
+  rtc::SetBE32(header + 4, sender_ssrc);
+  rtc::SetBE32(header + 8, layer_ssrcs_[layer_]);
+  feedback->AppendData(header, sizeof(header));
+
+  // Every packet asked for is mapped on its own, as the ones dropped in
+  // between shift the rest, and packed into items again.
+  bool has_item = false;
+  uint8 item[4] = {0};
+  for (size_t entry = kRtcpFeedbackHeaderLen; entry + 4 <= len; entry += 4) {
+    const uint16 first_seq_num = rtc::GetBE16(packet + entry);
+    const uint16 bitmask = rtc::GetBE16(packet + entry + 2);
+    for (int i = -1; i < 16; ++i) {
+      if (i >= 0 && (bitmask & (1 << i)) == 0) {
+        continue;
+      }
+      const uint16 send_seq_num = static_cast<uint16>(first_seq_num + i + 1);
+      const SeqNumMapping& sent =
+          sent_seq_nums_[send_seq_num % kSeqNumHistory];
+      // Packets of an earlier layer are not asked for again.
+      if (sent.epoch != epoch_ || sent.seq_num != send_seq_num ||
+          !sent.forwarded) {
+        continue;
+      }
+      const uint16 distance =
+          static_cast<uint16>(sent.mapped_seq_num - rtc::GetBE16(item) - 1);
+      if (has_item && distance < 16) {
+        rtc::SetBE16(item + 2, rtc::GetBE16(item + 2) | (1 << distance));
+        continue;
+      }
+      if (has_item) {
+        feedback->AppendData(item, sizeof(item));
+      }
+      rtc::SetBE16(item, sent.mapped_seq_num);
+      rtc::SetBE16(item + 2, 0);
+      has_item = true;
+    }
+  }
+  if (!has_item) {
+    feedback->SetLength(start);
+    return false;
+  }
+  feedback->AppendData(item, sizeof(item));
+  rtc::SetBE16(reinterpret_cast<uint8*>(feedback->data()) + start + 2,
+               static_cast<uint16>((feedback->length() - start) / 4 - 1));
+  return true;
+}
+
+}  // namespace cricket
@@ -0,0 +1,177 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef TALK_MEDIA_BASE_RTPFORWARDER_H_
+#define TALK_MEDIA_BASE_RTPFORWARDER_H_
+
+#include <vector>
+
+#include "talk/media/base/vp8layerfilter.h"
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/buffer.h"
+
+namespace cricket {
+
+// Relays received RTP streams as one sent stream without decoding them, e.g.
+// for a selective forwarding unit. The received streams are layers of the
+// same source, such as simulcast streams, of which one is forwarded at a time.
+// The sent stream keeps its own SSRC and continuous sequence numbers and
+// timestamps across switches between the layers, which happen where the
+// layer to switch to starts a key frame. The header extensions are mapped to
+// the IDs of the sending side, and the abs-send-time is restamped. Of a VP8
+// layer, the higher temporal layers are dropped as well when they do not fit
+// (see Vp8LayerFilter), without gaps in the sequence numbers sent.
+//
+// The layer is picked by the REMB the receiver of the sent stream reports,
+// against the bitrate measured for every layer. The rest of the feedback of
+// that receiver, NACK and key frame requests, is translated into feedback on
+// the forwarded layer for its sender.
+//
+// Key frames are only recognized in VP8 payloads. Not thread safe; every
+// packet is rewritten in place in amortized constant time.
+class RtpForwarder {
+ public:
+  // |layer_ssrcs| are the SSRCs of the received layers, the lowest bitrate
+  // first, and |ssrc| the one of the sent stream.
+  RtpForwarder(const std::vector<uint32>& layer_ssrcs, uint32 ssrc);
+
+  uint32 ssrc() const { return ssrc_; }
+  const std::vector<uint32>& layer_ssrcs() const { return layer_ssrcs_; }
+  // Returns the index of the layer with |ssrc|, or -1 if there is none.
+  int GetLayer(uint32 ssrc) const;
+  // The layer which is forwarded, -1 until the first key frame.
+  int layer() const { return layer_; }
+  // The layer which is switched to at its next key frame.
+  int target_layer() const { return target_layer_; }
+  // The bitrate received on |layer| over the last second.
+  int GetLayerBitrate(int layer) const;
+  // The highest temporal layer of the forwarded layer which is sent.
+  int temporal_layer() const { return vp8_filter_.temporal_layer(); }
+
+  // Sends the header extension received with |id| as |send_id|. Extensions
+  // without an ID to send are blanked out with padding.
+  void MapHeaderExtension(int id, int send_id);
+  // Restamps the sent abs-send-time extension |send_id|.
+  void SetAbsSendTimeExtension(int send_id);
+  // Sends the received payload type |payload_type| as |send_payload_type|.
+  void MapPayloadType(int payload_type, int send_payload_type);
+  // The received payload types of VP8 and of RED, which may carry VP8.
+  void SetVp8PayloadType(int payload_type, int red_payload_type);
+
+  // Picks the highest layer whose bitrate fits into |bitrate_bps|, and the
+  // temporal layers of it which fit. Switching to a higher layer than the
+  // forwarded one takes some headroom.
+  void SetTargetBitrate(int bitrate_bps);
+  // Returns true if a key frame is to be requested for switching layers, with
+  // the SSRC of the layer to request it from in |ssrc|. Returns true again
+  // if the key frame has not arrived within a second.
+  bool GetKeyFrameRequest(int64 now_ms, uint32* ssrc);
+
+  // Rewrites the |len| bytes of RTP received on a layer, in place, into a
+  // packet of the sent stream. Returns false if the packet is not to be sent.
+  bool RewriteRtp(uint8* data, size_t len, int64 now_ms);
+  // Turns the sender report of the forwarded layer in the compound RTCP
+  // packet |data| into one of the sent stream, in |report|. Returns false if
+  // there is none.
+  bool RewriteSenderReport(const uint8* data, size_t len,
+                           rtc::Buffer* report) const;
+  // Turns the feedback on the sent stream in the compound RTCP packet |data|
+  // into compound feedback from |sender_ssrc| on the forwarded layer, in
+  // |feedback|. A REMB sets the target bitrate instead. Returns false if
+  // there is no feedback to send.
+  bool RewriteFeedback(const uint8* data, size_t len, uint32 sender_ssrc,
+                       rtc::Buffer* feedback);
+
+ private:
+  // How many sequence numbers of the forwarded layer are kept mapped to the
+  // ones sent, for reordered packets and NACKs.
+  static const int kSeqNumHistory = 512;
+
+  // A received sequence number and the one it is sent with, or the other way
+  // around. |epoch| tells the forwarded layer they belong to.
+  struct SeqNumMapping {
+    SeqNumMapping() : epoch(0), seq_num(0), mapped_seq_num(0),
+                      forwarded(false) {}
+    uint16 epoch;
+    uint16 seq_num;
+    uint16 mapped_seq_num;
+    bool forwarded;
+  };
+
+  struct Layer {
+    Layer() : window_start_ms(-1), window_bytes(0), bitrate_bps(0) {}
+    int64 window_start_ms;
+    size_t window_bytes;
+    int bitrate_bps;
+  };
+
+  void UpdateBitrate(int layer, size_t len, int64 now_ms);
+  void SwitchLayer(int layer, uint16 seq_num, uint32 timestamp, int64 now_ms);
+  // Adds the newest sequence number received, numbering the ones missing
+  // before it for when they arrive. Returns the one to send it with.
+  uint16 AddReceivedSeqNum(uint16 seq_num, bool forwarded);
+  void MapSeqNum(uint16 seq_num, uint16 send_seq_num, bool forwarded);
+  void RewriteHeaderExtensions(uint8* data, size_t len, int64 now_ms) const;
+  bool RewriteNack(const uint8* packet, size_t len, uint32 sender_ssrc,
+                   rtc::Buffer* feedback) const;
+
+  const std::vector<uint32> layer_ssrcs_;
+  const uint32 ssrc_;
+  std::vector<Layer> layers_;
+  int layer_;
+  int target_layer_;
+  int64 key_frame_request_ms_;
+
+  // Received header extension ID to the one sent, 0 for none.
+  uint8 extension_ids_[15];
+  int abs_send_time_id_;
+  uint8 payload_types_[128];
+  int vp8_payload_type_;
+  int red_payload_type_;
+  Vp8LayerFilter vp8_filter_;
+
+  // Indexed by the received and the sent sequence numbers.
+  std::vector<SeqNumMapping> received_seq_nums_;
+  std::vector<SeqNumMapping> sent_seq_nums_;
+  // Counts the switches between layers.
+  uint16 epoch_;
+  uint16 newest_seq_num_;
+  uint16 next_seq_num_;
+  // What is added to the timestamps of the forwarded layer.
+  uint32 timestamp_offset_;
+  // The newest packet sent.
+  bool has_sent_;
+  uint32 last_timestamp_;
+  int64 last_send_ms_;
+  uint32 packets_sent_;
+  uint32 payload_bytes_sent_;
+};
+
+}  // namespace cricket
+
+#endif  // TALK_MEDIA_BASE_RTPFORWARDER_H_
@@ -0,0 +1,325 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <string.h>
+
+#include "webrtc/base/byteorder.h"
+#include "webrtc/base/gunit.h"
+#include "talk/media/base/rtpforwarder.h"
+#include "talk/media/base/rtputils.h"
+
+namespace cricket {
+
+static const uint32 kLowSsrc = 0x1111;
+static const uint32 kHighSsrc = 0x2222;
+static const uint32 kSendSsrc = 0x3333;
+static const uint32 kSenderSsrc = 0x4444;
+static const uint32 kReceiverSsrc = 0x5555;
+static const size_t kPacketLen = 100;
+static const int kVp8PayloadType = 100;
+
+class RtpForwarderTest : public testing::Test {
+ public:
+  RtpForwarderTest() : forwarder_(MakeLayers(), kSendSsrc) {
+    forwarder_.SetVp8PayloadType(kVp8PayloadType, -1);
+  }
+
+ protected:
+  static std::vector<uint32> MakeLayers() {
+    std::vector<uint32> layers;
+    layers.push_back(kLowSsrc);
+    layers.push_back(kHighSsrc);
+    return layers;
+  }
+
+  // A VP8 packet which starts a frame.
+  static void MakePacket(uint32 ssrc, int seq_num, uint32 timestamp,
+                         bool key_frame, uint8* packet) {
+    memset(packet, 0, kPacketLen);
+    RtpHeader header = {kVp8PayloadType, seq_num, timestamp, ssrc};
+    SetRtpHeader(packet, kPacketLen, header);
+    packet[kMinRtpPacketLen] = 0x10;
+    packet[kMinRtpPacketLen + 1] = key_frame ? 0x00 : 0x01;
+  }
+
+  bool Forward(uint32 ssrc, int seq_num, uint32 timestamp, bool key_frame,
+               int64 now_ms, uint8* packet) {
+    MakePacket(ssrc, seq_num, timestamp, key_frame, packet);
+    return forwarder_.RewriteRtp(packet, kPacketLen, now_ms);
+  }
+
+  static void ExpectHeader(const uint8* packet, int seq_num,
+                           uint32 timestamp) {
+    RtpHeader header;
+    EXPECT_TRUE(GetRtpHeader(packet, kPacketLen, &header));
+    EXPECT_EQ(kSendSsrc, header.ssrc);
+    EXPECT_EQ(seq_num, header.seq_num);
+    EXPECT_EQ(timestamp, header.timestamp);
+  }
+
+  // A REMB from the receiver of the sent stream, of less than 2^18 bps.
+  bool SendRemb(int bitrate_bps, rtc::Buffer* feedback) {
+    uint8 remb[24] = {0x8F, kRtcpTypePSFB, 0x00, 0x05};
+    rtc::SetBE32(remb + 4, kReceiverSsrc);
+    memcpy(remb + 12, "REMB", 4);
+    remb[16] = 1;
+    remb[17] = static_cast<uint8>(bitrate_bps >> 16);
+    rtc::SetBE16(remb + 18, static_cast<uint16>(bitrate_bps));
+    rtc::SetBE32(remb + 20, kSendSsrc);
+    return forwarder_.RewriteFeedback(remb, sizeof(remb), kSenderSsrc,
+                                      feedback);
+  }
+
+  // A NACK from the receiver of the sent stream for |seq_num| and the
+  // packets in |bitmask|.
+  bool SendNack(uint32 media_ssrc, uint16 seq_num, uint16 bitmask,
+                rtc::Buffer* feedback) {
+    uint8 nack[16] = {0x81, kRtcpTypeRTPFB, 0x00, 0x03};
+    rtc::SetBE32(nack + 4, kReceiverSsrc);
+    rtc::SetBE32(nack + 8, media_ssrc);
+    rtc::SetBE16(nack + 12, seq_num);
+    rtc::SetBE16(nack + 14, bitmask);
+    return forwarder_.RewriteFeedback(nack, sizeof(nack), kSenderSsrc,
+                                      feedback);
+  }
+
+  // Expects |feedback| to start with the empty receiver report of the
+  // forwarder and returns what follows it.
+  static const uint8* SkipReceiverReport(const rtc::Buffer& feedback) {
+    static const uint8 kReceiverReport[] = {
+        0x80, kRtcpTypeRR, 0x00, 0x01, 0x00, 0x00, 0x44, 0x44};
+    EXPECT_LE(sizeof(kReceiverReport), feedback.length());
+    EXPECT_EQ(0, memcmp(kReceiverReport, feedback.data(),
+                        sizeof(kReceiverReport)));
+    return reinterpret_cast<const uint8*>(feedback.data()) +
+           sizeof(kReceiverReport);
+  }
+
+  RtpForwarder forwarder_;
+};
+
+TEST_F(RtpForwarderTest, ForwardsLowestLayerFromKeyFrame) {
+  uint8 packet[kPacketLen];
+  uint32 ssrc;
+  EXPECT_TRUE(forwarder_.GetKeyFrameRequest(0, &ssrc));
+  EXPECT_EQ(kLowSsrc, ssrc);
+  EXPECT_FALSE(forwarder_.GetKeyFrameRequest(10, &ssrc));
+  EXPECT_TRUE(forwarder_.GetKeyFrameRequest(1000, &ssrc))
+      << "Key frame should be requested again.";
+
+  EXPECT_FALSE(Forward(kLowSsrc, 10, 1000, false, 0, packet));
+  EXPECT_FALSE(Forward(kHighSsrc, 20, 2000, true, 0, packet));
+  EXPECT_EQ(-1, forwarder_.layer());
+  EXPECT_FALSE(Forward(0x9999, 20, 2000, true, 0, packet));
+
+  EXPECT_TRUE(Forward(kLowSsrc, 11, 1000, true, 0, packet));
+  ExpectHeader(packet, 11, 1000);
+  EXPECT_EQ(0, forwarder_.layer());
+  EXPECT_TRUE(Forward(kLowSsrc, 12, 4000, false, 33, packet));
+  ExpectHeader(packet, 12, 4000);
+  EXPECT_FALSE(forwarder_.GetKeyFrameRequest(2000, &ssrc));
+}
+
+TEST_F(RtpForwarderTest, SwitchesLayersAtKeyFrames) {
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Forward(kLowSsrc, 10, 1000, true, 0, packet));
+  EXPECT_FALSE(Forward(kHighSsrc, 500, 7000, false, 0, packet));
+  // Measure the bitrates of the layers, 800 and 1600 bps.
+  EXPECT_TRUE(Forward(kLowSsrc, 11, 1090, false, 1000, packet));
+  EXPECT_FALSE(Forward(kHighSsrc, 501, 7090, false, 500, packet));
+  EXPECT_FALSE(Forward(kHighSsrc, 502, 7180, false, 1000, packet));
+  EXPECT_EQ(800, forwarder_.GetLayerBitrate(0));
+  EXPECT_EQ(1600, forwarder_.GetLayerBitrate(1));
+
+  // Switching up takes some headroom.
+  rtc::Buffer feedback;
+  EXPECT_FALSE(SendRemb(1 << 10, &feedback));
+  EXPECT_EQ(0, forwarder_.target_layer());
+  EXPECT_FALSE(SendRemb(2 << 10, &feedback));
+  EXPECT_EQ(1, forwarder_.target_layer());
+  uint32 ssrc;
+  EXPECT_TRUE(forwarder_.GetKeyFrameRequest(1000, &ssrc));
+  EXPECT_EQ(kHighSsrc, ssrc);
+
+  EXPECT_FALSE(Forward(kHighSsrc, 503, 7270, false, 1010, packet));
+  EXPECT_TRUE(Forward(kLowSsrc, 12, 1180, false, 1010, packet));
+  ExpectHeader(packet, 12, 1180);
+  EXPECT_TRUE(Forward(kHighSsrc, 504, 7360, true, 1020, packet));
+  // 10 ms at 90 kHz after the last packet.
+  ExpectHeader(packet, 13, 1180 + 900);
+  EXPECT_EQ(1, forwarder_.layer());
+  EXPECT_FALSE(Forward(kLowSsrc, 13, 1270, false, 1020, packet));
+  EXPECT_TRUE(Forward(kHighSsrc, 505, 7450, false, 1030, packet));
+  ExpectHeader(packet, 14, 1180 + 900 + 90);
+  EXPECT_FALSE(Forward(kHighSsrc, 503, 7270, false, 1030, packet))
+      << "Packets from before the switch should not be forwarded.";
+
+  // NACKs are translated back to the layer, but not for the packets sent
+  // before the switch.
+  ASSERT_TRUE(SendNack(kSendSsrc, 13, 0x0001, &feedback));
+  ASSERT_EQ(8u + 16u, feedback.length());
+  static const uint8 kNack[] = {
+      0x81, kRtcpTypeRTPFB, 0x00, 0x03,
+      0x00, 0x00, 0x44, 0x44,
+      0x00, 0x00, 0x22, 0x22,
+      0x01, 0xF8, 0x00, 0x01};  // 504 and 505.
+  EXPECT_EQ(0, memcmp(kNack, SkipReceiverReport(feedback), sizeof(kNack)));
+  EXPECT_FALSE(SendNack(kSendSsrc, 12, 0x0000, &feedback));
+}
+
+TEST_F(RtpForwarderTest, NumbersAroundDroppedTemporalLayers) {
+  // One frame of every temporal layer in 0, 2, 1, 2 for a second.
+  static const int kTemporalLayers[] = {0, 2, 1, 2, 0, 2, 1};
+  uint8 packet[kPacketLen];
+  for (int i = 0; i < 7; ++i) {
+    MakePacket(kLowSsrc, 10 + i, 1000 + 100 * i, i == 0, packet);
+    packet[kMinRtpPacketLen] = 0x90;
+    packet[kMinRtpPacketLen + 1] = 0x20;
+    packet[kMinRtpPacketLen + 2] =
+        static_cast<uint8>(kTemporalLayers[i] << 6 | 0x20);
+    packet[kMinRtpPacketLen + 3] = i == 0 ? 0x00 : 0x01;
+    const bool forwarded = forwarder_.RewriteRtp(packet, kPacketLen, 250 * i);
+    if (i == 4) {
+      // About 700 bps on each of layers 0 and 1, 1400 bps on layer 2.
+      forwarder_.SetTargetBitrate(2000);
+    }
+    if (i < 5) {
+      EXPECT_TRUE(forwarded);
+      ExpectHeader(packet, 10 + i, 1000 + 100 * i);
+    } else if (i == 5) {
+      EXPECT_FALSE(forwarded);
+      EXPECT_EQ(1, forwarder_.temporal_layer());
+    } else {
+      EXPECT_TRUE(forwarded);
+      ExpectHeader(packet, 15, 1600);
+    }
+  }
+
+  // The NACKs skip over the dropped packet.
+  rtc::Buffer feedback;
+  ASSERT_TRUE(SendNack(kSendSsrc, 14, 0x0001, &feedback));
+  static const uint8 kNack[] = {
+      0x81, kRtcpTypeRTPFB, 0x00, 0x03,
+      0x00, 0x00, 0x44, 0x44,
+      0x00, 0x00, 0x11, 0x11,
+      0x00, 0x0E, 0x00, 0x02};  // 14 and 16.
+  ASSERT_EQ(8u + sizeof(kNack), feedback.length());
+  EXPECT_EQ(0, memcmp(kNack, SkipReceiverReport(feedback), sizeof(kNack)));
+}
+
+TEST_F(RtpForwarderTest, MapsHeaderExtensions) {
+  forwarder_.MapHeaderExtension(1, 3);
+  forwarder_.MapHeaderExtension(2, 4);
+  forwarder_.SetAbsSendTimeExtension(4);
+  forwarder_.MapPayloadType(100, 120);
+
+  uint8 packet[kPacketLen];
+  MakePacket(kLowSsrc, 10, 1000, true, packet);
+  packet[0] |= 0x10;
+  static const uint8 kExtensions[] = {
+      0xBE, 0xDE, 0x00, 0x03,
+      0x10, 0xAA,              // ID 1, one byte.
+      0x22, 0x01, 0x02, 0x03,  // ID 2, abs-send-time.
+      0x51, 0xBB, 0xCC,        // ID 5, two bytes.
+      0x00, 0x00, 0x00};
+  memcpy(packet + kMinRtpPacketLen, kExtensions, sizeof(kExtensions));
+  packet[kMinRtpPacketLen + sizeof(kExtensions)] = 0x10;  // Key frame.
+  ASSERT_TRUE(forwarder_.RewriteRtp(packet, kPacketLen, 1000));
+
+  static const uint8 kExpected[] = {
+      0xBE, 0xDE, 0x00, 0x03,
+      0x30, 0xAA,
+      0x42, 0x04, 0x00, 0x00,  // One second in 6.18 fixed point.
+      0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00};
+  EXPECT_EQ(0, memcmp(kExpected, packet + kMinRtpPacketLen,
+                      sizeof(kExpected)));
+  int payload_type;
+  EXPECT_TRUE(GetRtpPayloadType(packet, kPacketLen, &payload_type));
+  EXPECT_EQ(120, payload_type);
+}
+
+TEST_F(RtpForwarderTest, TranslatesKeyFrameRequests) {
+  static const uint8 kPliAndFir[] = {
+      0x81, kRtcpTypePSFB, 0x00, 0x02,
+      0x00, 0x00, 0x55, 0x55,
+      0x00, 0x00, 0x33, 0x33,
+      0x84, kRtcpTypePSFB, 0x00, 0x04,
+      0x00, 0x00, 0x55, 0x55,
+      0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x33, 0x33, 0x01, 0x00, 0x00, 0x00};
+  rtc::Buffer feedback;
+  EXPECT_FALSE(forwarder_.RewriteFeedback(kPliAndFir, sizeof(kPliAndFir),
+                                          kSenderSsrc, &feedback))
+      << "Nothing is forwarded yet.";
+
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Forward(kLowSsrc, 10, 1000, true, 0, packet));
+  ASSERT_TRUE(forwarder_.RewriteFeedback(kPliAndFir, sizeof(kPliAndFir),
+                                         kSenderSsrc, &feedback));
+  ASSERT_EQ(8u + 12u, feedback.length()) << "Expected a single PLI.";
+  static const uint8 kPli[] = {
+      0x81, kRtcpTypePSFB, 0x00, 0x02,
+      0x00, 0x00, 0x44, 0x44,
+      0x00, 0x00, 0x11, 0x11};
+  EXPECT_EQ(0, memcmp(kPli, SkipReceiverReport(feedback), sizeof(kPli)));
+
+  // Feedback on other streams is left alone.
+  EXPECT_FALSE(SendNack(kLowSsrc, 10, 0x0000, &feedback));
+}
+
+TEST_F(RtpForwarderTest, RewritesSenderReport) {
+  static const uint8 kSenderReport[] = {
+      0x81, kRtcpTypeSR, 0x00, 0x0C,
+      0x00, 0x00, 0x11, 0x11,  // SSRC of the low layer.
+      0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+      0x00, 0x00, 0x10, 0x00,  // RTP timestamp.
+      0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x0A,
+      // Report block.
+      0x00, 0x00, 0x55, 0x55, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  rtc::Buffer report;
+  EXPECT_FALSE(forwarder_.RewriteSenderReport(
+      kSenderReport, sizeof(kSenderReport), &report));
+
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Forward(kLowSsrc, 10, 1000, true, 0, packet));
+  ASSERT_TRUE(forwarder_.RewriteSenderReport(
+      kSenderReport, sizeof(kSenderReport), &report));
+  static const uint8 kExpected[] = {
+      0x80, kRtcpTypeSR, 0x00, 0x06,
+      0x00, 0x00, 0x33, 0x33,
+      0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+      0x00, 0x00, 0x10, 0x00,
+      0x00, 0x00, 0x00, 0x01,  // Packets and payload bytes forwarded.
+      0x00, 0x00, 0x00, kPacketLen - kMinRtpPacketLen};
+  ASSERT_EQ(sizeof(kExpected), report.length());
+  EXPECT_EQ(0, memcmp(kExpected, report.data(), sizeof(kExpected)));
+}
+
+}  // namespace cricket
@@ -0,0 +1,288 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "talk/media/base/rtpsplicer.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/byteorder.h"
+#include "talk/media/base/rtputils.h"
+
+namespace cricket {
+
+static const int kVideoClockRateKhz = 90;
+
+static const size_t kRtcpSenderReportLen = 28;
+static const size_t kRtcpFeedbackHeaderLen = 12;
+static const size_t kRtcpRembLen = 20;
+static const int kRtcpRtpfbNack = 1;
+static const int kRtcpPsfbAfb = 15;
+// The ULPFEC header, and the protection length of the level 0 header, which
+// the mask of the protected packets follows.
+static const size_t kFecHeaderLen = 12;
+static const uint64 kMaxRembMantissa = 0x3FFFF;
+
+static bool IsNewerSeqNum(uint16 seq_num, uint16 prev_seq_num) {
+  return seq_num != prev_seq_num &&
+         static_cast<uint16>(seq_num - prev_seq_num) < 0x8000;
+}
+
+// Returns the length of the RTCP packet at the start of |data|, or 0 if it
+// does not fit into |len| bytes.
+static size_t GetRtcpPacketLen(const uint8* data, size_t len) {
+  if (len < kMinRtcpPacketLen || (data[0] >> 6) != 2) {
+    return 0;
+  }
+  const size_t packet_len = (rtc::GetBE16(data + 2) + 1) * 4;
+  return packet_len <= len ? packet_len : 0;
+}
+
+RtpSplicer::RtpSplicer(uint32 ssrc, uint32 rtx_ssrc)
+    : ssrc_(ssrc),
+      rtx_ssrc_(rtx_ssrc),
+      red_payload_type_(-1),
+      ulpfec_payload_type_(-1),
+      timestamp_offset_(0),
+      last_timestamp_(0),
+      last_send_ms_(0) {
+}
+
+void RtpSplicer::SetFecPayloadTypes(int red_payload_type,
+                                    int ulpfec_payload_type) {
+  red_payload_type_ = red_payload_type;
+  ulpfec_payload_type_ = ulpfec_payload_type;
+}
+
+bool RtpSplicer::RewriteRtp(uint8* data, size_t len, bool rtx, int64 now_ms) {
+  size_t header_len;
+  int payload_type;
+  int seq_num;
+  uint32 timestamp;
+  uint32 source_ssrc;
+  if ((rtx && rtx_ssrc_ == 0) || !GetRtpHeaderLen(data, len, &header_len) ||
+      !GetRtpPayloadType(data, len, &payload_type) ||
+      !GetRtpSeqNum(data, len, &seq_num) ||
+      !GetRtpTimestamp(data, len, &timestamp) ||
+      !GetRtpSsrc(data, len, &source_ssrc)) {
+    return false;
+  }
+  uint8* payload = data + header_len;
+  size_t payload_len = len - header_len;
+  if (data[0] & 0x20) {
+    const size_t padding_len = data[len - 1];
+    if (padding_len > payload_len) {
+      return false;
+    }
+    payload_len -= padding_len;
+  }
+
+  Stream* stream = rtx ? &rtx_ : &media_;
+  if (!stream->has_source || stream->source_ssrc != source_ssrc) {
+    SwitchSource(stream, source_ssrc, static_cast<uint16>(seq_num), timestamp,
+                 rtx, now_ms);
+  }
+  const bool moved = media_.seq_num_offset != 0 || timestamp_offset_ != 0;
+  if (rtx) {
+    // The original sequence number, absent from padding.
+    if (payload_len >= 2) {
+      rtc::SetBE16(payload, static_cast<uint16>(rtc::GetBE16(payload) +
+                                                media_.seq_num_offset));
+    }
+  } else {
+    SentPacket* sent = &history_[seq_num % kHistory];
+    sent->valid = true;
+    sent->seq_num = static_cast<uint16>(seq_num);
+    sent->timestamp = timestamp;
+    // Only a RED packet with a single block is looked into.
+    if (moved && payload_type == red_payload_type_ && payload_len > 0 &&
+        (payload[0] & 0x80) == 0 &&
+        (payload[0] & 0x7F) == ulpfec_payload_type_ &&
+        !RewriteFec(payload + 1, payload_len - 1)) {
+      return false;
+    }
+  }
+
+  const uint16 send_seq_num =
+      static_cast<uint16>(seq_num + stream->seq_num_offset);
+  const uint32 send_timestamp = timestamp + timestamp_offset_;
+  SetRtpSsrc(data, len, rtx ? rtx_ssrc_ : ssrc_);
+  SetRtpSeqNum(data, len, send_seq_num);
+  SetRtpTimestamp(data, len, send_timestamp);
+
+  // Retransmissions keep the numbers they were first sent with.
+  if (!stream->has_sent || IsNewerSeqNum(send_seq_num, stream->last_seq_num)) {
+    stream->has_sent = true;
+    stream->last_seq_num = send_seq_num;
+    if (!rtx) {
+      last_timestamp_ = send_timestamp;
+      last_send_ms_ = now_ms;
+    }
+  }
+  return true;
+}
+
+void RtpSplicer::RewriteSenderReport(uint8* data, size_t len) const {
+  if (len < kRtcpSenderReportLen || data[1] != kRtcpTypeSR) {
+    return;
+  }
+  rtc::SetBE32(data + 16, rtc::GetBE32(data + 16) + timestamp_offset_);
+}
+
+void RtpSplicer::RewriteFeedback(uint8* data, size_t len) const {
+  if (media_.seq_num_offset == 0) {
+    return;
+  }
+  size_t packet_len;
+  for (size_t offset = 0;
+       (packet_len = GetRtcpPacketLen(data + offset, len - offset)) != 0;
+       offset += packet_len) {
+    uint8* packet = data + offset;
+    if (packet[1] != kRtcpTypeRTPFB || (packet[0] & 0x1F) != kRtcpRtpfbNack ||
+        packet_len < kRtcpFeedbackHeaderLen ||
+        rtc::GetBE32(packet + 8) != ssrc_) {
+      continue;
+    }
+    // The bitmask of each NACK item is relative to its sequence number, which
+    // moves it along.
+    for (size_t item = kRtcpFeedbackHeaderLen; item + 4 <= packet_len;
+         item += 4) {
+      rtc::SetBE16(packet + item,
+                   static_cast<uint16>(rtc::GetBE16(packet + item) -
+                                       media_.seq_num_offset));
+    }
+  }
+}
+
+void RtpSplicer::SwitchSource(Stream* stream, uint32 source_ssrc,
+                              uint16 seq_num, uint32 timestamp, bool rtx,
+                              int64 now_ms) {
+  // The first source keeps its numbering; every later one continues where
+  // the previous one stopped, with the time in between.
+  if (stream->has_sent) {
+    stream->seq_num_offset =
+        static_cast<uint16>(stream->last_seq_num + 1 - seq_num);
+  }
+  if (!rtx) {
+    if (media_.has_sent) {
+      const int64 elapsed =
+          std::max<int64>(1, (now_ms - last_send_ms_) * kVideoClockRateKhz);
+      timestamp_offset_ =
+          last_timestamp_ + static_cast<uint32>(elapsed) - timestamp;
+    }
+    for (int i = 0; i < kHistory; ++i) {
+      history_[i].valid = false;
+    }
+  }
+  stream->has_source = true;
+  stream->source_ssrc = source_ssrc;
+}
+
+bool RtpSplicer::RewriteFec(uint8* fec, size_t len) const {
+  // RFC 5109: the mask is 48 bits long with the L bit set, else 16.
+  const size_t mask_len = (fec[0] & 0x40) ? 6 : 2;
+  if (len < kFecHeaderLen + mask_len) {
+    return false;
+  }
+  // The timestamp recovery is the XOR of the timestamps of the protected
+  // packets, which all moved.
+  const uint16 seq_num_base = rtc::GetBE16(fec + 2);
+  uint32 timestamp_recovery = rtc::GetBE32(fec + 4);
+  for (size_t i = 0; i < 8 * mask_len; ++i) {
+    if ((fec[kFecHeaderLen + i / 8] & (0x80 >> (i % 8))) == 0) {
+      continue;
+    }
+    const uint16 seq_num = static_cast<uint16>(seq_num_base + i);
+    const SentPacket& sent = history_[seq_num % kHistory];
+    if (!sent.valid || sent.seq_num != seq_num) {
+      return false;
+    }
+    timestamp_recovery ^= sent.timestamp ^ (sent.timestamp + timestamp_offset_);
+  }
+  rtc::SetBE16(fec + 2,
+               static_cast<uint16>(seq_num_base + media_.seq_num_offset));
+  rtc::SetBE32(fec + 4, timestamp_recovery);
+  return true;
+}
+
+bool RembCombiner::CombineRemb(const void* peer, uint8* data, size_t len,
+                               int64 now_ms) {
+  uint8* remb = NULL;
+  size_t packet_len;
+  for (size_t offset = 0;
+       (packet_len = GetRtcpPacketLen(data + offset, len - offset)) != 0;
+       offset += packet_len) {
+    uint8* packet = data + offset;
+    if (packet[1] == kRtcpTypePSFB && (packet[0] & 0x1F) == kRtcpPsfbAfb &&
+        packet_len >= kRtcpRembLen && memcmp(packet + 12, "REMB", 4) == 0) {
+      remb = packet;
+      break;
+    }
+  }
+  if (remb == NULL) {
+    return false;
+  }
+
+  const int exponent = remb[17] >> 2;
+  const uint64 mantissa =
+      (static_cast<uint64>(remb[17] & 0x03) << 16) | rtc::GetBE16(remb + 18);
+  Remb* received = &rembs_[peer];
+  received->bitrate_bps = mantissa << std::min(exponent, 40);
+  received->received_ms = now_ms;
+
+  uint64 lowest_bps = received->bitrate_bps;
+  for (std::map<const void*, Remb>::iterator it = rembs_.begin();
+       it != rembs_.end();) {
+    if (now_ms - it->second.received_ms > kRembTimeoutMs) {
+      rembs_.erase(it++);
+      continue;
+    }
+    lowest_bps = std::min(lowest_bps, it->second.bitrate_bps);
+    ++it;
+  }
+  if (lowest_bps < received->bitrate_bps) {
+    int lowest_exponent = 0;
+    while ((lowest_bps >> lowest_exponent) > kMaxRembMantissa) {
+      ++lowest_exponent;
+    }
+    const uint32 lowest_mantissa =
+        static_cast<uint32>(lowest_bps >> lowest_exponent);
+    remb[17] = static_cast<uint8>((lowest_exponent << 2) |
+                                  (lowest_mantissa >> 16));
+    rtc::SetBE16(remb + 18, static_cast<uint16>(lowest_mantissa));
+  }
+  return true;
+}
+
+void RembCombiner::RemovePeer(const void* peer) {
+  rembs_.erase(peer);
+}
+
+}  // namespace cricket
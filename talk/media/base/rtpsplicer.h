@@ -0,0 +1,142 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef TALK_MEDIA_BASE_RTPSPLICER_H_
+#define TALK_MEDIA_BASE_RTPSPLICER_H_
+
+#include <map>
+
+#include "webrtc/base/basictypes.h"
+
+namespace cricket {
+
+// Sends the RTP of changing sources as one continuous stream, e.g. a send
+// stream which shares the encoder of another one (see WebRtcVideoChannel2)
+// when its packets move from one encoder to another. Like RtpForwarder on a
+// layer switch, the sequence numbers of the new source continue where the
+// old one stopped, and its timestamps with the time in between. Unlike it,
+// every packet of a source is sent, so they are moved by fixed offsets, and
+// the NACKs of the receiver only need to be moved back.
+//
+// The RTX stream is spliced along with the media stream, with the original
+// sequence numbers it carries moved like the media. The ULPFEC sent in RED
+// keeps protecting the moved packets: its sequence number base and timestamp
+// recovery are rewritten to match. Not thread safe.
+class RtpSplicer {
+ public:
+  // |ssrc| is the SSRC of the sent stream, |rtx_ssrc| the one of its RTX
+  // stream or 0 for none.
+  RtpSplicer(uint32 ssrc, uint32 rtx_ssrc);
+
+  uint32 ssrc() const { return ssrc_; }
+  uint32 rtx_ssrc() const { return rtx_ssrc_; }
+  // The payload types of RED and of the ULPFEC sent in it, -1 for none.
+  void SetFecPayloadTypes(int red_payload_type, int ulpfec_payload_type);
+
+  // Rewrites the |len| bytes of RTP of a source, in place, into a packet of
+  // the sent stream, or of its RTX stream if |rtx| is set. A packet of
+  // another source than the previous one switches to that source. Returns
+  // false if the packet is not to be sent.
+  bool RewriteRtp(uint8* data, size_t len, bool rtx, int64 now_ms);
+  // Moves the RTP timestamp of the sender report at the start of |data| like
+  // the packets of the source it's from.
+  void RewriteSenderReport(uint8* data, size_t len) const;
+  // Moves the sequence numbers of the NACKs on the sent stream in the
+  // compound RTCP packet |data| back to the ones of the source.
+  void RewriteFeedback(uint8* data, size_t len) const;
+
+ private:
+  // How many packets of the source are remembered for the FEC protecting
+  // them. Covers the kMaxMediaPackets a FEC packet protects at most, with
+  // room for the packets sent in between.
+  static const int kHistory = 128;
+
+  struct Stream {
+    Stream() : has_source(false), source_ssrc(0), seq_num_offset(0),
+               has_sent(false), last_seq_num(0) {}
+    bool has_source;
+    uint32 source_ssrc;
+    uint16 seq_num_offset;
+    bool has_sent;
+    uint16 last_seq_num;
+  };
+
+  struct SentPacket {
+    SentPacket() : valid(false), seq_num(0), timestamp(0) {}
+    bool valid;
+    uint16 seq_num;
+    uint32 timestamp;
+  };
+
+  void SwitchSource(Stream* stream, uint32 source_ssrc, uint16 seq_num,
+                    uint32 timestamp, bool rtx, int64 now_ms);
+  bool RewriteFec(uint8* fec, size_t len) const;
+
+  const uint32 ssrc_;
+  const uint32 rtx_ssrc_;
+  int red_payload_type_;
+  int ulpfec_payload_type_;
+  Stream media_;
+  Stream rtx_;
+  // What is added to the timestamps of the source, of the media and RTX.
+  uint32 timestamp_offset_;
+  uint32 last_timestamp_;
+  int64 last_send_ms_;
+  // The source sequence numbers and timestamps of the newest media packets.
+  SentPacket history_[kHistory];
+};
+
+// Holds the newest REMB of each peer the packets of one encoder go to, and
+// lowers the REMB handed to the encoder to the lowest of them, so that the
+// stream fits the most constrained peer instead of the one reporting last.
+// Not thread safe.
+class RembCombiner {
+ public:
+  // Records the REMB of |peer| in the compound RTCP packet |data|, and lowers
+  // it in place to the lowest REMB a peer has reported within the timeout.
+  // Returns false if there is no REMB in the packet.
+  bool CombineRemb(const void* peer, uint8* data, size_t len, int64 now_ms);
+  void RemovePeer(const void* peer);
+  bool empty() const { return rembs_.empty(); }
+
+ private:
+  // A peer which hasn't reported for this long is left out.
+  static const int64 kRembTimeoutMs = 5000;
+
+  struct Remb {
+    Remb() : bitrate_bps(0), received_ms(0) {}
+    uint64 bitrate_bps;
+    int64 received_ms;
+  };
+
+  std::map<const void*, Remb> rembs_;
+};
+
+}  // namespace cricket
+
+#endif  // TALK_MEDIA_BASE_RTPSPLICER_H_
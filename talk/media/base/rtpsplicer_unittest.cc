@@ -0,0 +1,223 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include <string.h>
+
+#include "webrtc/base/byteorder.h"
+#include "webrtc/base/gunit.h"
+#include "talk/media/base/rtpsplicer.h"
+#include "talk/media/base/rtputils.h"
+
+namespace cricket {
+
+static const uint32 kSourceSsrc = 0x1111;
+static const uint32 kSourceRtxSsrc = 0x1112;
+static const uint32 kOtherSourceSsrc = 0x2222;
+static const uint32 kOtherSourceRtxSsrc = 0x2223;
+static const uint32 kSendSsrc = 0x3333;
+static const uint32 kSendRtxSsrc = 0x3334;
+static const uint32 kReceiverSsrc = 0x5555;
+static const size_t kPacketLen = 100;
+static const int kVp8PayloadType = 100;
+static const int kRedPayloadType = 116;
+static const int kUlpfecPayloadType = 117;
+// Where ULPFEC starts in a RED packet, after the RTP and the RED header.
+static const size_t kFecOffset = kMinRtpPacketLen + 1;
+
+class RtpSplicerTest : public testing::Test {
+ public:
+  RtpSplicerTest() : splicer_(kSendSsrc, kSendRtxSsrc) {
+    splicer_.SetFecPayloadTypes(kRedPayloadType, kUlpfecPayloadType);
+  }
+
+ protected:
+  static void MakePacket(int payload_type, uint32 ssrc, int seq_num,
+                         uint32 timestamp, uint8* packet) {
+    memset(packet, 0, kPacketLen);
+    RtpHeader header = {payload_type, seq_num, timestamp, ssrc};
+    SetRtpHeader(packet, kPacketLen, header);
+  }
+
+  bool Send(uint32 ssrc, int seq_num, uint32 timestamp, int64 now_ms,
+            uint8* packet) {
+    MakePacket(kVp8PayloadType, ssrc, seq_num, timestamp, packet);
+    return splicer_.RewriteRtp(packet, kPacketLen, false, now_ms);
+  }
+
+  // A ULPFEC packet protecting |seq_num_base| and the packets in |mask|.
+  bool SendFec(uint32 ssrc, int seq_num, uint32 timestamp,
+               uint16 seq_num_base, uint16 mask, uint32 timestamp_recovery,
+               uint8* packet) {
+    MakePacket(kRedPayloadType, ssrc, seq_num, timestamp, packet);
+    packet[kMinRtpPacketLen] = kUlpfecPayloadType;
+    rtc::SetBE16(packet + kFecOffset + 2, seq_num_base);
+    rtc::SetBE32(packet + kFecOffset + 4, timestamp_recovery);
+    rtc::SetBE16(packet + kFecOffset + 12, mask);
+    return splicer_.RewriteRtp(packet, kPacketLen, false, 0);
+  }
+
+  static void ExpectHeader(const uint8* packet, uint32 ssrc, int seq_num,
+                           uint32 timestamp) {
+    RtpHeader header;
+    EXPECT_TRUE(GetRtpHeader(packet, kPacketLen, &header));
+    EXPECT_EQ(ssrc, header.ssrc);
+    EXPECT_EQ(seq_num, header.seq_num);
+    EXPECT_EQ(timestamp, header.timestamp);
+  }
+
+  RtpSplicer splicer_;
+};
+
+TEST_F(RtpSplicerTest, KeepsNumberingOfFirstSource) {
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Send(kSourceSsrc, 100, 9000, 0, packet));
+  ExpectHeader(packet, kSendSsrc, 100, 9000);
+  EXPECT_TRUE(Send(kSourceSsrc, 101, 12000, 33, packet));
+  ExpectHeader(packet, kSendSsrc, 101, 12000);
+}
+
+TEST_F(RtpSplicerTest, ContinuesNumberingOfNewSource) {
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Send(kSourceSsrc, 100, 9000, 0, packet));
+  EXPECT_TRUE(Send(kSourceSsrc, 101, 12000, 33, packet));
+
+  // The packets of the new source follow with the time in between.
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5000, 777, 66, packet));
+  ExpectHeader(packet, kSendSsrc, 102, 12000 + 33 * 90);
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5001, 777 + 3000, 99, packet));
+  ExpectHeader(packet, kSendSsrc, 103, 12000 + 33 * 90 + 3000);
+
+  // A packet sent again keeps its number.
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5000, 777, 120, packet));
+  ExpectHeader(packet, kSendSsrc, 102, 12000 + 33 * 90);
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5002, 777 + 6000, 132, packet));
+  ExpectHeader(packet, kSendSsrc, 104, 12000 + 33 * 90 + 6000);
+}
+
+TEST_F(RtpSplicerTest, MovesRtxAlongWithMedia) {
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Send(kSourceSsrc, 100, 9000, 0, packet));
+  MakePacket(kVp8PayloadType, kSourceRtxSsrc, 20, 9000, packet);
+  rtc::SetBE16(packet + kMinRtpPacketLen, 100);
+  EXPECT_TRUE(splicer_.RewriteRtp(packet, kPacketLen, true, 10));
+  ExpectHeader(packet, kSendRtxSsrc, 20, 9000);
+  EXPECT_EQ(100, rtc::GetBE16(packet + kMinRtpPacketLen));
+
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5000, 777, 33, packet));
+  MakePacket(kVp8PayloadType, kOtherSourceRtxSsrc, 300, 777, packet);
+  rtc::SetBE16(packet + kMinRtpPacketLen, 5000);
+  EXPECT_TRUE(splicer_.RewriteRtp(packet, kPacketLen, true, 40));
+  ExpectHeader(packet, kSendRtxSsrc, 21, 9000 + 33 * 90);
+  EXPECT_EQ(101, rtc::GetBE16(packet + kMinRtpPacketLen));
+}
+
+TEST_F(RtpSplicerTest, MovesNacksBackToSource) {
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Send(kSourceSsrc, 100, 9000, 0, packet));
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5000, 777, 33, packet));
+
+  uint8 nack[16] = {0x81, kRtcpTypeRTPFB, 0x00, 0x03};
+  rtc::SetBE32(nack + 4, kReceiverSsrc);
+  rtc::SetBE32(nack + 8, kSendSsrc);
+  rtc::SetBE16(nack + 12, 101);
+  rtc::SetBE16(nack + 14, 0x0001);
+  splicer_.RewriteFeedback(nack, sizeof(nack));
+  EXPECT_EQ(5000, rtc::GetBE16(nack + 12));
+  EXPECT_EQ(0x0001, rtc::GetBE16(nack + 14));
+
+  // NACKs on other streams are left alone.
+  rtc::SetBE32(nack + 8, kReceiverSsrc);
+  splicer_.RewriteFeedback(nack, sizeof(nack));
+  EXPECT_EQ(5000, rtc::GetBE16(nack + 12));
+}
+
+TEST_F(RtpSplicerTest, MovesSenderReportTimestamp) {
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Send(kSourceSsrc, 100, 9000, 0, packet));
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5000, 777, 33, packet));
+
+  uint8 report[28] = {0x80, kRtcpTypeSR, 0x00, 0x06};
+  rtc::SetBE32(report + 16, 777);
+  splicer_.RewriteSenderReport(report, sizeof(report));
+  EXPECT_EQ(9000u + 33 * 90, rtc::GetBE32(report + 16));
+}
+
+TEST_F(RtpSplicerTest, RewritesFecOfMovedPackets) {
+  uint8 packet[kPacketLen];
+  EXPECT_TRUE(Send(kSourceSsrc, 100, 9000, 0, packet));
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5000, 777, 33, packet));
+  EXPECT_TRUE(Send(kOtherSourceSsrc, 5001, 3777, 66, packet));
+
+  const uint32 offset = 9000 + 33 * 90 - 777;
+  EXPECT_TRUE(SendFec(kOtherSourceSsrc, 5002, 3777, 5000, 0xC000,
+                      777 ^ 3777, packet));
+  ExpectHeader(packet, kSendSsrc, 103, 3777 + offset);
+  EXPECT_EQ(101, rtc::GetBE16(packet + kFecOffset + 2));
+  EXPECT_EQ((777 + offset) ^ (3777 + offset),
+            rtc::GetBE32(packet + kFecOffset + 4));
+
+  // FEC of packets it has not seen can't be rewritten.
+  EXPECT_FALSE(SendFec(kOtherSourceSsrc, 5003, 3777, 4990, 0x8000, 0,
+                       packet));
+}
+
+TEST(RembCombinerTest, LowersRembToLowestPeer) {
+  static const int kPeer1 = 1;
+  static const int kPeer2 = 2;
+  uint8 remb[24] = {0x8F, kRtcpTypePSFB, 0x00, 0x05};
+  memcpy(remb + 12, "REMB", 4);
+  remb[16] = 1;
+  RembCombiner combiner;
+
+  // 300000 bps, as 150000 << 1.
+  remb[17] = (1 << 2) | 0x02;
+  rtc::SetBE16(remb + 18, 0x49F0);
+  EXPECT_TRUE(combiner.CombineRemb(&kPeer1, remb, sizeof(remb), 0));
+  EXPECT_EQ((1 << 2) | 0x02, remb[17]);
+
+  // A higher REMB of another peer is lowered to the first one.
+  remb[17] = (4 << 2) | 0x02;
+  EXPECT_TRUE(combiner.CombineRemb(&kPeer2, remb, sizeof(remb), 1000));
+  const uint64 bitrate_bps =
+      ((static_cast<uint64>(remb[17] & 0x03) << 16) | rtc::GetBE16(remb + 18))
+      << (remb[17] >> 2);
+  EXPECT_EQ(300000u, bitrate_bps);
+
+  // Until the first peer times out, or is removed.
+  remb[17] = (4 << 2) | 0x02;
+  EXPECT_TRUE(combiner.CombineRemb(&kPeer2, remb, sizeof(remb), 10000));
+  EXPECT_EQ((4 << 2) | 0x02, remb[17]);
+  combiner.RemovePeer(&kPeer2);
+  EXPECT_TRUE(combiner.empty());
+
+  uint8 nack[16] = {0x81, kRtcpTypeRTPFB, 0x00, 0x03};
+  EXPECT_FALSE(combiner.CombineRemb(&kPeer1, nack, sizeof(nack), 0));
+}
+
+}  // namespace cricket
@@ -159,6 +159,21 @@ bool GetRtpHeader(const void* data, size_t len, RtpHeader* header) {
           GetRtpSsrc(data, len, &(header->ssrc)));
 }
 
+bool GetRtpHeaderAndLen(const void* data, size_t len,
+                        RtpHeader* header, size_t* header_len) {
+  if (!header || !GetRtpHeaderLen(data, len, header_len)) {
+    return false;
+  }
+  // GetRtpHeaderLen() checked that the fixed header is there.
+  const uint8* packet = static_cast<const uint8*>(data);
+  header->payload_type = packet[kRtpPayloadTypeOffset] & 0x7F;
+  header->seq_num = static_cast<int>(
+      rtc::GetBE16(packet + kRtpSeqNumOffset));
+  header->timestamp = rtc::GetBE32(packet + kRtpTimestampOffset);
+  header->ssrc = rtc::GetBE32(packet + kRtpSsrcOffset);
+  return true;
+}
+
 bool GetRtcpType(const void* data, size_t len, int* value) {
   if (len < kMinRtcpPacketLen) {
     return false;
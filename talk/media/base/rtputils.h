@@ -62,6 +62,10 @@ bool GetRtpHeaderLen(const void* data, size_t len, size_t* value);
 bool GetRtcpType(const void* data, size_t len, int* value);
 bool GetRtcpSsrc(const void* data, size_t len, uint32* value);
 bool GetRtpHeader(const void* data, size_t len, RtpHeader* header);
+// Same as GetRtpHeader() and GetRtpHeaderLen() together, but validates the
+// packet and reads the header in a single pass.
+bool GetRtpHeaderAndLen(const void* data, size_t len,
+                        RtpHeader* header, size_t* header_len);
 
 // Assumes marker bit is 0.
 bool SetRtpHeaderFlags(
@@ -172,6 +172,31 @@ TEST(RtpUtilsTest, GetRtpHeaderLen) {
                                &len));
 }
 
+TEST(RtpUtilsTest, GetRtpHeaderAndLen) {
+  RtpHeader header;
+  size_t len;
+  EXPECT_TRUE(GetRtpHeaderAndLen(kPcmuFrame, sizeof(kPcmuFrame), &header,
+                                 &len));
+  EXPECT_EQ(12U, len);
+  EXPECT_EQ(0, header.payload_type);
+  EXPECT_EQ(1, header.seq_num);
+  EXPECT_EQ(0u, header.timestamp);
+  EXPECT_EQ(1u, header.ssrc);
+
+  EXPECT_TRUE(GetRtpHeaderAndLen(
+      kRtpPacketWithMarkerAndCsrcAndExtension,
+      sizeof(kRtpPacketWithMarkerAndCsrcAndExtension), &header, &len));
+  EXPECT_EQ(sizeof(kRtpPacketWithMarkerAndCsrcAndExtension), len);
+  // The marker bit is not part of the payload type.
+  EXPECT_EQ(0, header.payload_type);
+
+  EXPECT_FALSE(GetRtpHeaderAndLen(kInvalidPacket, sizeof(kInvalidPacket),
+                                  &header, &len));
+  EXPECT_FALSE(GetRtpHeaderAndLen(kInvalidPacketWithCsrc,
+                                  sizeof(kInvalidPacketWithCsrc), &header,
+                                  &len));
+}
+
 TEST(RtpUtilsTest, GetRtcp) {
   int pt;
   EXPECT_TRUE(GetRtcpType(kRtcpReport, sizeof(kRtcpReport), &pt));
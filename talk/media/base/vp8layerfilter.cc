@@ -0,0 +1,235 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "talk/media/base/vp8layerfilter.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/byteorder.h"
+
+namespace cricket {
+
+static const int64 kRateWindowMs = 1000;
+
+// The fields of a VP8 payload descriptor, with the positions of the ones
+// which are rewritten, 0 if absent.
+struct Vp8Descriptor {
+  bool frame_start;
+  bool key_frame;
+  size_t picture_id_pos;
+  bool long_picture_id;
+  size_t tl0_pic_idx_pos;
+  bool has_temporal_layer;
+  int temporal_layer;
+  bool layer_sync;
+};
+
+static bool ParseVp8Descriptor(const uint8* payload, size_t len,
+                               Vp8Descriptor* descriptor) {
+  memset(descriptor, 0, sizeof(*descriptor));
+  if (len < 1) {
+    return false;
+  }
+  size_t offset = 1;
+  if (payload[0] & 0x80) {
+    if (len < 2) {
+      return false;
+    }
+    const uint8 extension = payload[1];
+    offset = 2;
+    if (extension & 0x80) {
+      if (offset >= len) {
+        return false;
+      }
+      descriptor->picture_id_pos = offset;
+      descriptor->long_picture_id = (payload[offset] & 0x80) != 0;
+      offset += descriptor->long_picture_id ? 2 : 1;
+    }
+    if (extension & 0x40) {
+      descriptor->tl0_pic_idx_pos = offset;
+      ++offset;
+    }
+    if (extension & 0x30) {
+      if (offset >= len) {
+        return false;
+      }
+      if (extension & 0x20) {
+        descriptor->has_temporal_layer = true;
+        descriptor->temporal_layer = payload[offset] >> 6;
+        descriptor->layer_sync = (payload[offset] & 0x20) != 0;
+      }
+      ++offset;
+    }
+  }
+  if (offset > len) {
+    return false;
+  }
+  // The start of partition 0 begins with the VP8 payload header, whose first
+  // bit is the inverse key frame flag.
+  descriptor->frame_start =
+      (payload[0] & 0x10) != 0 && (payload[0] & 0x07) == 0;
+  descriptor->key_frame = descriptor->frame_start && offset < len &&
+                          (payload[offset] & 0x01) == 0;
+  return true;
+}
+
+Vp8LayerFilter::Vp8LayerFilter()
+    : target_temporal_layer_(kMaxTemporalLayers - 1),
+      temporal_layer_(kMaxTemporalLayers - 1),
+      window_start_ms_(-1),
+      has_temporal_layers_(false),
+      switching_stream_(false),
+      picture_id_offset_(0),
+      tl0_pic_idx_offset_(0),
+      last_picture_id_(0),
+      last_tl0_pic_idx_(0),
+      dropped_picture_id_(-1) {
+  memset(window_bytes_, 0, sizeof(window_bytes_));
+  memset(bitrates_bps_, 0, sizeof(bitrates_bps_));
+}
+
+bool Vp8LayerFilter::IsKeyFrame(const uint8* payload, size_t len) {
+  Vp8Descriptor descriptor;
+  return ParseVp8Descriptor(payload, len, &descriptor) &&
+         descriptor.key_frame;
+}
+
+int Vp8LayerFilter::GetTemporalLayerBitrate(int temporal_layer) const {
+  int bitrate_bps = 0;
+  for (int i = 0; i <= temporal_layer && i < kMaxTemporalLayers; ++i) {
+    bitrate_bps += bitrates_bps_[i];
+  }
+  return bitrate_bps;
+}
+
+void Vp8LayerFilter::SetTargetBitrate(int bitrate_bps) {
+  target_temporal_layer_ = kMaxTemporalLayers - 1;
+  if (!has_temporal_layers_) {
+    return;
+  }
+  for (int i = 1; i < kMaxTemporalLayers; ++i) {
+    if (GetTemporalLayerBitrate(i) > bitrate_bps) {
+      target_temporal_layer_ = i - 1;
+      return;
+    }
+  }
+}
+
+void Vp8LayerFilter::SwitchStream() {
+  switching_stream_ = true;
+  dropped_picture_id_ = -1;
+  window_start_ms_ = -1;
+  memset(window_bytes_, 0, sizeof(window_bytes_));
+  memset(bitrates_bps_, 0, sizeof(bitrates_bps_));
+  has_temporal_layers_ = false;
+}
+
+bool Vp8LayerFilter::Filter(uint8* payload, size_t len, int64 now_ms) {
+  Vp8Descriptor descriptor;
+  if (!ParseVp8Descriptor(payload, len, &descriptor)) {
+    return false;
+  }
+  UpdateBitrates(descriptor.temporal_layer, len, now_ms);
+  has_temporal_layers_ |= descriptor.has_temporal_layer;
+
+  // The forwarded layers only change between frames.
+  if (descriptor.key_frame) {
+    temporal_layer_ = target_temporal_layer_;
+  } else if (descriptor.frame_start) {
+    temporal_layer_ = std::min(temporal_layer_, target_temporal_layer_);
+    if (descriptor.layer_sync &&
+        descriptor.temporal_layer > temporal_layer_ &&
+        descriptor.temporal_layer <= target_temporal_layer_) {
+      temporal_layer_ = descriptor.temporal_layer;
+    }
+  }
+
+  int picture_id = -1;
+  if (descriptor.picture_id_pos != 0) {
+    const uint8* field = payload + descriptor.picture_id_pos;
+    picture_id = descriptor.long_picture_id ? rtc::GetBE16(field) & 0x7FFF
+                                            : field[0] & 0x7F;
+  }
+  if (descriptor.temporal_layer > temporal_layer_) {
+    // Every dropped frame takes its PictureID out of the sequence.
+    if (picture_id >= 0 && picture_id != dropped_picture_id_) {
+      dropped_picture_id_ = picture_id;
+      --picture_id_offset_;
+    }
+    return false;
+  }
+
+  uint8* tl0_pic_idx = descriptor.tl0_pic_idx_pos != 0
+                           ? payload + descriptor.tl0_pic_idx_pos
+                           : NULL;
+  if (switching_stream_) {
+    if (picture_id >= 0) {
+      picture_id_offset_ =
+          static_cast<uint16>(last_picture_id_ + 1 - picture_id);
+    }
+    if (tl0_pic_idx != NULL) {
+      tl0_pic_idx_offset_ =
+          static_cast<uint8>(last_tl0_pic_idx_ + 1 - *tl0_pic_idx);
+    }
+    switching_stream_ = false;
+  }
+  if (picture_id >= 0) {
+    last_picture_id_ =
+        static_cast<uint16>((picture_id + picture_id_offset_) & 0x7FFF);
+    uint8* field = payload + descriptor.picture_id_pos;
+    if (descriptor.long_picture_id) {
+      rtc::SetBE16(field, 0x8000 | last_picture_id_);
+    } else {
+      field[0] = static_cast<uint8>(last_picture_id_ & 0x7F);
+    }
+  }
+  if (tl0_pic_idx != NULL) {
+    last_tl0_pic_idx_ = static_cast<uint8>(*tl0_pic_idx + tl0_pic_idx_offset_);
+    *tl0_pic_idx = last_tl0_pic_idx_;
+  }
+  return true;
+}
+
+void Vp8LayerFilter::UpdateBitrates(int temporal_layer, size_t len,
+                                    int64 now_ms) {
+  if (window_start_ms_ < 0) {
+    window_start_ms_ = now_ms;
+  } else if (now_ms - window_start_ms_ >= kRateWindowMs) {
+    for (int i = 0; i < kMaxTemporalLayers; ++i) {
+      bitrates_bps_[i] = static_cast<int>(
+          window_bytes_[i] * 8 * 1000 / (now_ms - window_start_ms_));
+      window_bytes_[i] = 0;
+    }
+    window_start_ms_ = now_ms;
+  }
+  window_bytes_[temporal_layer] += len;
+}
+
+}  // namespace cricket
@@ -0,0 +1,93 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef TALK_MEDIA_BASE_VP8LAYERFILTER_H_
+#define TALK_MEDIA_BASE_VP8LAYERFILTER_H_
+
+#include "webrtc/base/basictypes.h"
+
+namespace cricket {
+
+// Drops the higher temporal layers of a relayed VP8 stream to fit in a target
+// bitrate, and keeps the PictureID and TL0PICIDX of the payload descriptors
+// continuous over the dropped frames and over switches between simulcast
+// streams. A temporal layer is given up at any frame and picked up again at
+// a frame which is marked as layer sync, or at a key frame.
+//
+// Works on the RTP payload, in place and in constant time per packet.
+class Vp8LayerFilter {
+ public:
+  static const int kMaxTemporalLayers = 4;
+
+  Vp8LayerFilter();
+
+  // Returns true if the VP8 RTP payload |payload| starts a key frame.
+  static bool IsKeyFrame(const uint8* payload, size_t len);
+
+  // The highest temporal layer forwarded.
+  int temporal_layer() const { return temporal_layer_; }
+  // The bitrate of the temporal layers up to |temporal_layer| received over
+  // the last second, or 0 if the stream has no temporal layers.
+  int GetTemporalLayerBitrate(int temporal_layer) const;
+
+  // Picks the highest temporal layer to be forwarded whose bitrate, with the
+  // ones below it, fits into |bitrate_bps|.
+  void SetTargetBitrate(int bitrate_bps);
+  // Continues the numbering with another stream, which starts with a key
+  // frame.
+  void SwitchStream();
+
+  // Rewrites the payload descriptor of |payload| for being forwarded in
+  // place. Returns false if the packet is to be dropped.
+  bool Filter(uint8* payload, size_t len, int64 now_ms);
+
+ private:
+  void UpdateBitrates(int temporal_layer, size_t len, int64 now_ms);
+
+  int target_temporal_layer_;
+  int temporal_layer_;
+
+  int64 window_start_ms_;
+  size_t window_bytes_[kMaxTemporalLayers];
+  int bitrates_bps_[kMaxTemporalLayers];
+  bool has_temporal_layers_;
+
+  // What is added to the PictureID and TL0PICIDX received, and the last ones
+  // sent, in 15 and 8 bits.
+  bool switching_stream_;
+  uint16 picture_id_offset_;
+  uint8 tl0_pic_idx_offset_;
+  uint16 last_picture_id_;
+  uint8 last_tl0_pic_idx_;
+  // The PictureID of the last frame dropped, -1 for none.
+  int dropped_picture_id_;
+};
+
+}  // namespace cricket
+
+#endif  // TALK_MEDIA_BASE_VP8LAYERFILTER_H_
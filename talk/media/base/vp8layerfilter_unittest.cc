@@ -0,0 +1,142 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "webrtc/base/byteorder.h"
+#include "webrtc/base/gunit.h"
+#include "talk/media/base/vp8layerfilter.h"
+
+namespace cricket {
+
+static const int kPayloadLen = 20;
+
+// Makes the payload of a packet starting a frame, with a 15 bit PictureID,
+// TL0PICIDX and the temporal layer.
+static void MakePayload(int picture_id, int tl0_pic_idx, int temporal_layer,
+                        bool layer_sync, bool key_frame, uint8* payload) {
+  memset(payload, 0, kPayloadLen);
+  payload[0] = 0x90;
+  payload[1] = 0xE0;
+  rtc::SetBE16(payload + 2, static_cast<uint16>(0x8000 | picture_id));
+  payload[4] = static_cast<uint8>(tl0_pic_idx);
+  payload[5] = static_cast<uint8>(temporal_layer << 6 | (layer_sync << 5));
+  payload[6] = key_frame ? 0x00 : 0x01;
+}
+
+static int GetPictureId(const uint8* payload) {
+  return rtc::GetBE16(payload + 2) & 0x7FFF;
+}
+
+TEST(Vp8LayerFilterTest, IsKeyFrame) {
+  uint8 payload[kPayloadLen];
+  MakePayload(1, 1, 0, false, true, payload);
+  EXPECT_TRUE(Vp8LayerFilter::IsKeyFrame(payload, kPayloadLen));
+  MakePayload(1, 1, 0, false, false, payload);
+  EXPECT_FALSE(Vp8LayerFilter::IsKeyFrame(payload, kPayloadLen));
+  MakePayload(1, 1, 0, false, true, payload);
+  payload[0] &= ~0x10;  // Not the start of the frame.
+  EXPECT_FALSE(Vp8LayerFilter::IsKeyFrame(payload, kPayloadLen));
+
+  static const uint8 kShortKeyFrame[] = {0x10, 0x00};
+  EXPECT_TRUE(Vp8LayerFilter::IsKeyFrame(kShortKeyFrame,
+                                         sizeof(kShortKeyFrame)));
+  EXPECT_FALSE(Vp8LayerFilter::IsKeyFrame(payload, 3));
+}
+
+TEST(Vp8LayerFilterTest, DropsTemporalLayersAboveTarget) {
+  // Layers 0, 2, 1, 2 with one frame every 250 ms.
+  static const int kTemporalLayers[] = {0, 2, 1, 2};
+  Vp8LayerFilter filter;
+  uint8 payload[kPayloadLen];
+  int picture_id = 100;
+  int tl0_pic_idx = 7;
+  for (int i = 0; i < 4; ++i, ++picture_id) {
+    tl0_pic_idx += kTemporalLayers[i] == 0 ? 1 : 0;
+    MakePayload(picture_id, tl0_pic_idx, kTemporalLayers[i], false, i == 0,
+                payload);
+    EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 250 * i));
+    EXPECT_EQ(picture_id, GetPictureId(payload));
+  }
+  MakePayload(picture_id++, ++tl0_pic_idx, 0, false, false, payload);
+  EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 1000));
+  EXPECT_EQ(kPayloadLen * 8, filter.GetTemporalLayerBitrate(0));
+  EXPECT_EQ(2 * kPayloadLen * 8, filter.GetTemporalLayerBitrate(1));
+  EXPECT_EQ(4 * kPayloadLen * 8, filter.GetTemporalLayerBitrate(2));
+
+  filter.SetTargetBitrate(2 * kPayloadLen * 8);
+  MakePayload(picture_id++, tl0_pic_idx, 2, true, false, payload);
+  EXPECT_FALSE(filter.Filter(payload, kPayloadLen, 1250));
+  payload[0] &= ~0x10;  // The rest of the frame.
+  EXPECT_FALSE(filter.Filter(payload, kPayloadLen, 1250));
+  EXPECT_EQ(1, filter.temporal_layer());
+
+  // The PictureID skips the dropped frame.
+  MakePayload(picture_id++, tl0_pic_idx, 1, false, false, payload);
+  EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 1500));
+  EXPECT_EQ(picture_id - 2, GetPictureId(payload));
+  EXPECT_EQ(tl0_pic_idx, payload[4]);
+
+  // Layer 2 comes back at a layer sync frame only.
+  filter.SetTargetBitrate(10000);
+  MakePayload(picture_id++, tl0_pic_idx, 2, false, false, payload);
+  EXPECT_FALSE(filter.Filter(payload, kPayloadLen, 1750));
+  MakePayload(picture_id++, ++tl0_pic_idx, 0, false, false, payload);
+  EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 2000));
+  EXPECT_EQ(picture_id - 3, GetPictureId(payload));
+  MakePayload(picture_id++, tl0_pic_idx, 2, true, false, payload);
+  EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 2250));
+  EXPECT_EQ(picture_id - 3, GetPictureId(payload));
+  EXPECT_EQ(2, filter.temporal_layer());
+}
+
+TEST(Vp8LayerFilterTest, ContinuesNumberingOverStreamSwitches) {
+  Vp8LayerFilter filter;
+  uint8 payload[kPayloadLen];
+  MakePayload(0x7FFF, 255, 0, false, true, payload);
+  EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 0));
+
+  filter.SwitchStream();
+  MakePayload(500, 20, 0, false, true, payload);
+  EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 10));
+  EXPECT_EQ(0, GetPictureId(payload));
+  EXPECT_EQ(0, payload[4]);
+  MakePayload(501, 21, 0, false, false, payload);
+  EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 20));
+  EXPECT_EQ(1, GetPictureId(payload));
+  EXPECT_EQ(1, payload[4]);
+
+  // A short PictureID keeps its size.
+  filter.SwitchStream();
+  payload[0] = 0x90;
+  payload[1] = 0x80;
+  payload[2] = 0x05;
+  payload[3] = 0x00;  // Key frame.
+  EXPECT_TRUE(filter.Filter(payload, kPayloadLen, 30));
+  EXPECT_EQ(2, payload[2]);
+}
+
+}  // namespace cricket
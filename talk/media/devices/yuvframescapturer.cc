@@ -153,11 +153,10 @@ void YuvFramesCapturer::ReadFrame(bool first_frame) {
   if (!first_frame) {
     SignalFrameCaptured(this, &captured_frame_);
   }
-  uint8* buffer = new uint8[frame_data_size_];
-  frame_generator_->GenerateNextFrame(buffer, GetBarcodeValue());
+  // 2. Generate the next frame in place; downstream is done with the frame.
+  frame_generator_->GenerateNextFrame(
+      static_cast<uint8*>(captured_frame_.data), GetBarcodeValue());
   frame_index_++;
-  memmove(captured_frame_.data, buffer, frame_data_size_);
-  delete[] buffer;
 }
 
 
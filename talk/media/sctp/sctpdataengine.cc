@@ -102,16 +102,16 @@ std::string ListArray(const uint16* array, int num_elems) {
 }  // namespace
 
 namespace cricket {
-typedef rtc::ScopedMessageData<SctpInboundPacket> InboundPacketMessage;
-typedef rtc::ScopedMessageData<rtc::Buffer> OutboundPacketMessage;
-
 // TODO(ldixon): Find where this is defined, and also check is Sctp really
 // respects this.
 static const size_t kSctpMtu = 1280;
 
+// The number of free packets kept for reuse in each direction.
+static const size_t kMaxPooledPackets = 64;
+
 enum {
-  MSG_SCTPINBOUNDPACKET = 1,   // MessageData is SctpInboundPacket
-  MSG_SCTPOUTBOUNDPACKET = 2,  // MessageData is rtc:Buffer
+  MSG_SCTPINBOUNDPACKET = 1,   // inbound_packets_ is not empty.
+  MSG_SCTPOUTBOUNDPACKET = 2,  // outbound_packets_ is not empty.
 };
 
 struct SctpInboundPacket {
@@ -186,9 +186,7 @@ static int OnSctpOutboundPacket(void* addr, void* data, size_t length,
                   << "; tos: " << std::hex << static_cast<int>(tos)
                   << "; set_df: " << std::hex << static_cast<int>(set_df);
   // Note: We have to copy the data; the caller will delete it.
-  OutboundPacketMessage* msg =
-      new OutboundPacketMessage(new rtc::Buffer(data, length));
-  channel->worker_thread()->Post(channel, MSG_SCTPOUTBOUNDPACKET, msg);
+  channel->QueueOutboundPacket(data, length);
   return 0;
 }
 
@@ -213,16 +211,12 @@ static int OnSctpInboundPacket(struct socket* sock, union sctp_sockstore addr,
     LOG(LS_ERROR) << "Received an unknown PPID " << ppid
                   << " on an SCTP packet.  Dropping.";
   } else {
-    SctpInboundPacket* packet = new SctpInboundPacket;
-    packet->buffer.SetData(data, length);
-    packet->params.ssrc = rcv.rcv_sid;
-    packet->params.seq_num = rcv.rcv_ssn;
-    packet->params.timestamp = rcv.rcv_tsn;
-    packet->params.type = type;
-    packet->flags = flags;
-    // The ownership of |packet| transfers to |msg|.
-    InboundPacketMessage* msg = new InboundPacketMessage(packet);
-    channel->worker_thread()->Post(channel, MSG_SCTPINBOUNDPACKET, msg);
+    ReceiveDataParams params;
+    params.ssrc = rcv.rcv_sid;
+    params.seq_num = rcv.rcv_ssn;
+    params.timestamp = rcv.rcv_tsn;
+    params.type = type;
+    channel->QueueInboundPacket(data, length, params, flags);
   }
   free(data);
   return 1;
@@ -313,6 +307,16 @@ SctpDataMediaChannel::SctpDataMediaChannel(rtc::Thread* thread)
 
 SctpDataMediaChannel::~SctpDataMediaChannel() {
   CloseSctpSocket();
+  // usrsctp won't call back any more; drop what it left queued.
+  rtc::CritScope cs(&packets_crit_);
+  for (size_t i = 0; i < outbound_packets_.size(); ++i)
+    delete outbound_packets_[i];
+  for (size_t i = 0; i < free_outbound_packets_.size(); ++i)
+    delete free_outbound_packets_[i];
+  for (size_t i = 0; i < inbound_packets_.size(); ++i)
+    delete inbound_packets_[i];
+  for (size_t i = 0; i < free_inbound_packets_.size(); ++i)
+    delete free_inbound_packets_[i];
 }
 
 sockaddr_conn SctpDataMediaChannel::GetSctpSockAddr(int port) {
@@ -877,6 +881,81 @@ bool SctpDataMediaChannel::SetRecvCodecs(const std::vector<DataCodec>& codecs) {
       &local_port_);
 }
 
+void SctpDataMediaChannel::QueueOutboundPacket(const void* data,
+                                               size_t length) {
+  rtc::CritScope cs(&packets_crit_);
+  rtc::Buffer* buffer;
+  if (free_outbound_packets_.empty()) {
+    buffer = new rtc::Buffer(data, length, kSctpMtu);
+  } else {
+    buffer = free_outbound_packets_.back();
+    free_outbound_packets_.pop_back();
+    buffer->SetData(data, length);
+  }
+  outbound_packets_.push_back(buffer);
+  if (outbound_packets_.size() == 1) {
+    worker_thread_->Post(this, MSG_SCTPOUTBOUNDPACKET);
+  }
+}
+
+void SctpDataMediaChannel::QueueInboundPacket(const void* data, size_t length,
+                                              const ReceiveDataParams& params,
+                                              int flags) {
+  rtc::CritScope cs(&packets_crit_);
+  SctpInboundPacket* packet;
+  if (free_inbound_packets_.empty()) {
+    packet = new SctpInboundPacket;
+  } else {
+    packet = free_inbound_packets_.back();
+    free_inbound_packets_.pop_back();
+  }
+  packet->buffer.SetData(data, length);
+  packet->params = params;
+  packet->flags = flags;
+  inbound_packets_.push_back(packet);
+  if (inbound_packets_.size() == 1) {
+    worker_thread_->Post(this, MSG_SCTPINBOUNDPACKET);
+  }
+}
+
+void SctpDataMediaChannel::SendQueuedOutboundPackets() {
+  BufferList packets;
+  {
+    rtc::CritScope cs(&packets_crit_);
+    packets.swap(outbound_packets_);
+  }
+  for (size_t i = 0; i < packets.size(); ++i) {
+    OnPacketFromSctpToNetwork(packets[i]);
+  }
+  rtc::CritScope cs(&packets_crit_);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (free_outbound_packets_.size() < kMaxPooledPackets) {
+      free_outbound_packets_.push_back(packets[i]);
+    } else {
+      delete packets[i];
+    }
+  }
+}
+
+void SctpDataMediaChannel::DeliverQueuedInboundPackets() {
+  InboundPacketList packets;
+  {
+    rtc::CritScope cs(&packets_crit_);
+    packets.swap(inbound_packets_);
+  }
+  for (size_t i = 0; i < packets.size(); ++i) {
+    OnInboundPacketFromSctpToChannel(packets[i]);
+  }
+  rtc::CritScope cs(&packets_crit_);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (free_inbound_packets_.size() < kMaxPooledPackets) {
+      free_inbound_packets_.push_back(packets[i]);
+    } else {
+      delete packets[i];
+    }
+  }
+}
+
 void SctpDataMediaChannel::OnPacketFromSctpToNetwork(
     rtc::Buffer* buffer) {
   if (buffer->length() > kSctpMtu) {
@@ -929,18 +1008,12 @@ bool SctpDataMediaChannel::SendQueuedStreamResets() {
 
 void SctpDataMediaChannel::OnMessage(rtc::Message* msg) {
   switch (msg->message_id) {
-    case MSG_SCTPINBOUNDPACKET: {
-      rtc::scoped_ptr<InboundPacketMessage> pdata(
-          static_cast<InboundPacketMessage*>(msg->pdata));
-      OnInboundPacketFromSctpToChannel(pdata->data().get());
+    case MSG_SCTPINBOUNDPACKET:
+      DeliverQueuedInboundPackets();
       break;
-    }
-    case MSG_SCTPOUTBOUNDPACKET: {
-      rtc::scoped_ptr<OutboundPacketMessage> pdata(
-          static_cast<OutboundPacketMessage*>(msg->pdata));
-      OnPacketFromSctpToNetwork(pdata->data().get());
+    case MSG_SCTPOUTBOUNDPACKET:
+      SendQueuedOutboundPackets();
       break;
-    }
   }
 }
 }  // namespace cricket
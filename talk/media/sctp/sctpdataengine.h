@@ -42,6 +42,7 @@ enum PreservedErrno {
 }  // namespace cricket
 
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "talk/media/base/codec.h"
 #include "talk/media/base/mediachannel.h"
@@ -163,6 +164,13 @@ class SctpDataMediaChannel : public DataMediaChannel,
   // Exposed to allow Post call from c-callbacks.
   rtc::Thread* worker_thread() const { return worker_thread_; }
 
+  // Called from the c-callbacks, on the worker thread or a usrsctp thread.
+  // The packets are copied into pooled buffers and handed to the worker
+  // thread in batches: only the first packet of a batch posts a message.
+  void QueueOutboundPacket(const void* data, size_t length);
+  void QueueInboundPacket(const void* data, size_t length,
+                          const ReceiveDataParams& params, int flags);
+
   // TODO(ldixon): add a DataOptions class to mediachannel.h
   virtual bool SetOptions(int options) { return false; }
   virtual int GetOptions() const { return 0; }
@@ -212,6 +220,10 @@ class SctpDataMediaChannel : public DataMediaChannel,
   // Queues a stream for reset.
   bool ResetStream(uint32 ssrc);
 
+  // Called by OnMessage to hand the queued packets on.
+  void SendQueuedOutboundPackets();
+  void DeliverQueuedInboundPackets();
+
   // Called by OnMessage to send packet on the network.
   void OnPacketFromSctpToNetwork(rtc::Buffer* buffer);
   // Called by OnMessage to decide what to do with the packet.
@@ -252,6 +264,16 @@ class SctpDataMediaChannel : public DataMediaChannel,
 
   // A human-readable name for debugging messages.
   std::string debug_name_;
+
+  // The packets queued for the worker thread, and the pools they are
+  // allocated from and returned to.
+  typedef std::vector<rtc::Buffer*> BufferList;
+  typedef std::vector<SctpInboundPacket*> InboundPacketList;
+  rtc::CriticalSection packets_crit_;
+  BufferList outbound_packets_;
+  BufferList free_outbound_packets_;
+  InboundPacketList inbound_packets_;
+  InboundPacketList free_inbound_packets_;
 };
 
 }  // namespace cricket
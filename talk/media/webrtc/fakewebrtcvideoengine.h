@@ -283,6 +283,7 @@ class FakeWebRtcVideoEngine
           rtp_absolute_send_time_receive_id_(-1),
           sender_target_delay_(0),
           receiver_target_delay_(0),
+          send_side_history_size_(0),
           transmission_smoothing_(false),
           nack_(false),
           hybrid_nack_fec_(false),
@@ -323,6 +324,7 @@ class FakeWebRtcVideoEngine
     int rtp_absolute_send_time_receive_id_;
     int sender_target_delay_;
     int receiver_target_delay_;
+    int send_side_history_size_;
     bool transmission_smoothing_;
     bool nack_;
     bool hybrid_nack_fec_;
@@ -518,6 +520,10 @@ class FakeWebRtcVideoEngine
     WEBRTC_ASSERT_CHANNEL(channel);
     return channels_.find(channel)->second->receiver_target_delay_;
   }
+  int GetSendSideHistorySize(int channel) {
+    WEBRTC_ASSERT_CHANNEL(channel);
+    return channels_.find(channel)->second->send_side_history_size_;
+  }
   bool GetNackStatus(int channel) const {
     WEBRTC_ASSERT_CHANNEL(channel);
     return channels_.find(channel)->second->nack_;
@@ -798,6 +804,10 @@ class FakeWebRtcVideoEngine
   virtual unsigned int GetDiscardedPackets(const int channel) const {
     return 0;
   }
+  virtual unsigned int GetFramesDroppedByRateControl(
+      const int channel) const {
+    return 0;
+  }
 
   WEBRTC_STUB(SetKeyFrameRequestCallbackStatus, (const int, const bool));
   WEBRTC_STUB(SetSignalKeyPacketLossStatus, (const int, const bool,
@@ -1071,6 +1081,11 @@ class FakeWebRtcVideoEngine
     channels_[channel]->sender_target_delay_ = target_delay;
     return 0;
   }
+  WEBRTC_FUNC(SetSendSideHistorySize, (int channel, int num_packets)) {
+    WEBRTC_CHECK_CHANNEL(channel);
+    channels_[channel]->send_side_history_size_ = num_packets;
+    return 0;
+  }
   WEBRTC_FUNC(SetReceiverBufferingMode, (int channel, int target_delay)) {
     WEBRTC_CHECK_CHANNEL(channel);
     channels_[channel]->receiver_target_delay_ = target_delay;
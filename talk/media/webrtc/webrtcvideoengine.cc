@@ -58,9 +58,11 @@
 #include "talk/media/webrtc/webrtcvideodecoderfactory.h"
 #include "talk/media/webrtc/webrtcvideoencoderfactory.h"
 #include "talk/media/webrtc/webrtcvideoframe.h"
+#include "talk/media/webrtc/webrtcvideoframeview.h"
 #include "talk/media/webrtc/webrtcvie.h"
 #include "talk/media/webrtc/webrtcvoe.h"
 #include "talk/media/webrtc/webrtcvoiceengine.h"
+#include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/experiments.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
 
@@ -212,6 +214,58 @@ class WebRtcRenderAdapter : public webrtc::ExternalRenderer {
                            int64_t render_time,
                            void* handle) {
     rtc::CritScope cs(&crit_);
+    int64 elapsed_time_ns = 0;
+    int64 render_time_ns = 0;
+    if (!UpdateFrameTimes(rtp_time_stamp, ntp_time_ms, render_time,
+                          &elapsed_time_ns, &render_time_ns)) {
+      return 0;
+    }
+    // Note that here we send the |elapsed_time_ns| to renderer as the
+    // cricket::VideoFrame's elapsed_time_ and the |render_time_ns| as the
+    // cricket::VideoFrame's time_stamp_.
+    if (handle == NULL) {
+      return DeliverBufferFrame(buffer, buffer_size, render_time_ns,
+                                elapsed_time_ns);
+    } else {
+      return DeliverTextureFrame(handle, render_time_ns,
+                                 elapsed_time_ns);
+    }
+  }
+
+  // Renders the planes of the decoded frame without packing them first.
+  virtual int DeliverI420Frame(const webrtc::I420VideoFrame& webrtc_frame) {
+    rtc::CritScope cs(&crit_);
+    int64 elapsed_time_ns = 0;
+    int64 render_time_ns = 0;
+    if (!UpdateFrameTimes(webrtc_frame.timestamp(),
+                          webrtc_frame.ntp_time_ms(),
+                          webrtc_frame.render_time_ms(),
+                          &elapsed_time_ns, &render_time_ns)) {
+      return 0;
+    }
+    // Renderers only read the frame, so the planes aren't written through the
+    // view.
+    WebRtcVideoFrameView video_frame;
+    video_frame.Init(
+        const_cast<uint8*>(webrtc_frame.buffer(webrtc::kYPlane)),
+        webrtc_frame.stride(webrtc::kYPlane),
+        const_cast<uint8*>(webrtc_frame.buffer(webrtc::kUPlane)),
+        webrtc_frame.stride(webrtc::kUPlane),
+        const_cast<uint8*>(webrtc_frame.buffer(webrtc::kVPlane)),
+        webrtc_frame.stride(webrtc::kVPlane),
+        webrtc_frame.width(), webrtc_frame.height(), 1, 1, elapsed_time_ns,
+        render_time_ns);
+    return renderer_->RenderFrame(&video_frame) ? 0 : -1;
+  }
+
+  virtual bool IsTextureSupported() { return true; }
+
+  // Updates the capture start times and the frame rate for a frame, and
+  // converts its times to the ns timestamps of a cricket::VideoFrame. Returns
+  // false if there is no renderer to deliver the frame to.
+  bool UpdateFrameTimes(uint32_t rtp_time_stamp, int64_t ntp_time_ms,
+                        int64_t render_time, int64* elapsed_time_ns,
+                        int64* render_time_ns) {
     if (capture_start_rtp_time_stamp_ < 0) {
       capture_start_rtp_time_stamp_ = rtp_time_stamp;
     }
@@ -226,28 +280,15 @@ class WebRtcRenderAdapter : public webrtc::ExternalRenderer {
     }
     frame_rate_tracker_.Update(1);
     if (renderer_ == NULL) {
-      return 0;
+      return false;
     }
     // Convert elapsed_time_ms to ns timestamp.
-    int64 elapsed_time_ns =
-        elapsed_time_ms * rtc::kNumNanosecsPerMillisec;
+    *elapsed_time_ns = elapsed_time_ms * rtc::kNumNanosecsPerMillisec;
     // Convert milisecond render time to ns timestamp.
-    int64 render_time_ns = render_time *
-        rtc::kNumNanosecsPerMillisec;
-    // Note that here we send the |elapsed_time_ns| to renderer as the
-    // cricket::VideoFrame's elapsed_time_ and the |render_time_ns| as the
-    // cricket::VideoFrame's time_stamp_.
-    if (handle == NULL) {
-      return DeliverBufferFrame(buffer, buffer_size, render_time_ns,
-                                elapsed_time_ns);
-    } else {
-      return DeliverTextureFrame(handle, render_time_ns,
-                                 elapsed_time_ns);
-    }
+    *render_time_ns = render_time * rtc::kNumNanosecsPerMillisec;
+    return true;
   }
 
-  virtual bool IsTextureSupported() { return true; }
-
   int DeliverBufferFrame(unsigned char* buffer, int buffer_size,
                          int64 time_stamp, int64 elapsed_time) {
     WebRtcVideoFrame video_frame;
@@ -2455,11 +2496,13 @@ bool WebRtcVideoMediaChannel::GetStats(const StatsOptions& options,
       sinfo.avg_encode_ms = metrics.avg_encode_time_ms;
       sinfo.encode_usage_percent = metrics.encode_usage_percent;
       sinfo.encode_rsd = metrics.encode_rsd;
+      sinfo.encode_cpu_usage_percent = metrics.encode_cpu_usage_percent;
       sinfo.capture_queue_delay_ms_per_s = metrics.capture_queue_delay_ms_per_s;
 #else
       sinfo.capture_jitter_ms = -1;
       sinfo.avg_encode_ms = -1;
       sinfo.encode_usage_percent = -1;
+      sinfo.encode_cpu_usage_percent = -1;
       sinfo.capture_queue_delay_ms_per_s = -1;
 
       int capture_jitter_ms = 0;
@@ -2915,6 +2958,10 @@ bool WebRtcVideoMediaChannel::SetOptions(const VideoOptions &options) {
   bool buffer_latency_changed = options.buffered_mode_latency.IsSet() &&
       (options_.buffered_mode_latency != options.buffered_mode_latency);
 
+  bool packet_history_size_changed =
+      options.video_packet_history_size.IsSet() &&
+      (options_.video_packet_history_size != options.video_packet_history_size);
+
   bool dscp_option_changed = (options_.dscp != options.dscp);
 
   bool suspend_below_min_bitrate_changed =
@@ -2997,6 +3044,19 @@ bool WebRtcVideoMediaChannel::SetOptions(const VideoOptions &options) {
       }
     }
   }
+  int packet_history_size = 0;
+  if (packet_history_size_changed &&
+      options_.video_packet_history_size.Get(&packet_history_size)) {
+    LOG(LS_INFO) << "Packet history size is " << packet_history_size;
+    for (SendChannelMap::iterator it = send_channels_.begin();
+        it != send_channels_.end(); ++it) {
+      if (engine()->vie()->rtp()->SetSendSideHistorySize(
+          it->second->channel_id(), packet_history_size) != 0) {
+        LOG_RTCERR2(SetSendSideHistorySize, it->second->channel_id(),
+                    packet_history_size);
+      }
+    }
+  }
   if (buffer_latency_changed) {
     int buffer_latency =
         options_.buffered_mode_latency.GetWithDefaultIfUnset(
@@ -3536,6 +3596,14 @@ bool WebRtcVideoMediaChannel::ConfigureSending(int channel_id,
     }
   }
 
+  int packet_history_size = 0;
+  if (options_.video_packet_history_size.Get(&packet_history_size)) {
+    if (engine()->vie()->rtp()->SetSendSideHistorySize(
+        channel_id, packet_history_size) != 0) {
+      LOG_RTCERR2(SetSendSideHistorySize, channel_id, packet_history_size);
+    }
+  }
+
   int buffer_latency =
       options_.buffered_mode_latency.GetWithDefaultIfUnset(
           cricket::kBufferedModeDisabled);
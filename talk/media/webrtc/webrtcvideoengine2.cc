@@ -28,6 +28,7 @@
 #ifdef HAVE_WEBRTC_VIDEO
 #include "talk/media/webrtc/webrtcvideoengine2.h"
 
+#include <algorithm>
 #include <set>
 #include <string>
 
@@ -35,6 +36,9 @@
 #include "webrtc/base/buffer.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/stringutils.h"
+#include "webrtc/base/timeutils.h"
+#include "talk/media/base/rtpforwarder.h"
+#include "talk/media/base/rtputils.h"
 #include "talk/media/base/videocapturer.h"
 #include "talk/media/base/videorenderer.h"
 #include "talk/media/webrtc/constants.h"
@@ -57,6 +61,13 @@ static const int kNackHistoryMs = 1000;
 
 static const int kDefaultRtcpReceiverReportSsrc = 1;
 
+// Size of a sender report without report blocks.
+static const size_t kRtcpSenderReportLen = 28;
+static const size_t kRtcpReportBlockLen = 24;
+// Feedback message types of the RTCP payload-specific feedback.
+static const int kRtcpPsfbFir = 4;
+static const int kRtcpPsfbAfb = 15;
+
 struct VideoCodecPref {
   int payload_type;
   const char* name;
@@ -473,6 +484,19 @@ bool WebRtcVideoEngine2::ShouldIgnoreTrace(const std::string& trace) {
   return false;
 }
 
+void WebRtcVideoEngine2::AddSharedEncoder(WebRtcVideoChannel2* channel,
+                                          uint32 ssrc) {
+  shared_encoders_.push_back(std::make_pair(channel, ssrc));
+}
+
+void WebRtcVideoEngine2::RemoveSharedEncoder(WebRtcVideoChannel2* channel,
+                                             uint32 ssrc) {
+  shared_encoders_.erase(std::remove(shared_encoders_.begin(),
+                                     shared_encoders_.end(),
+                                     std::make_pair(channel, ssrc)),
+                         shared_encoders_.end());
+}
+
 WebRtcVideoEncoderFactory2* WebRtcVideoEngine2::GetVideoEncoderFactory() {
   return &default_video_encoder_factory_;
 }
@@ -657,6 +681,7 @@ WebRtcVideoChannel2::WebRtcVideoChannel2(
 
 void WebRtcVideoChannel2::Construct(webrtc::Call* call,
                                     WebRtcVideoEngine2* engine) {
+  engine_ = engine;
   rtcp_receiver_report_ssrc_ = kDefaultRtcpReceiverReportSsrc;
   sending_ = false;
   call_.reset(call);
@@ -674,6 +699,15 @@ void WebRtcVideoChannel2::SetDefaultOptions() {
 }
 
 WebRtcVideoChannel2::~WebRtcVideoChannel2() {
+  while (!forwarded_streams_.empty()) {
+    RemoveForwardedStream(forwarded_streams_.back().channel,
+                          forwarded_streams_.back().forwarder->ssrc());
+  }
+  while (!relayed_streams_.empty()) {
+    relayed_streams_.begin()->second->RemoveForwardedStream(
+        this, relayed_streams_.begin()->first);
+  }
+
   for (std::map<uint32, WebRtcVideoSendStream*>::iterator it =
            send_streams_.begin();
        it != send_streams_.end();
@@ -871,7 +905,8 @@ bool WebRtcVideoChannel2::AddSendStream(const StreamParams& sp) {
   }
 
   WebRtcVideoSendStream* stream =
-      new WebRtcVideoSendStream(call_.get(),
+      new WebRtcVideoSendStream(this,
+                                call_.get(),
                                 encoder_factory_,
                                 options_,
                                 send_codec_,
@@ -1104,6 +1139,14 @@ bool WebRtcVideoChannel2::RequestIntraFrame() {
 void WebRtcVideoChannel2::OnPacketReceived(
     rtc::Buffer* packet,
     const rtc::PacketTime& packet_time) {
+  uint32 ssrc = 0;
+  if (!forwarded_streams_.empty() &&
+      GetRtpSsrc(packet->data(), packet->length(), &ssrc) &&
+      ForwardRtp(*packet, ssrc) &&
+      receive_streams_.find(ssrc) == receive_streams_.end()) {
+    return;  // Relayed only.
+  }
+
   const webrtc::PacketReceiver::DeliveryStatus delivery_result =
       call_->Receiver()->DeliverPacket(
           reinterpret_cast<const uint8_t*>(packet->data()), packet->length());
@@ -1116,7 +1159,6 @@ void WebRtcVideoChannel2::OnPacketReceived(
       break;
   }
 
-  uint32 ssrc = 0;
   if (default_recv_ssrc_ != 0) {  // Already one default stream.
     LOG(LS_WARNING) << "Unknown SSRC, but default receive stream already set.";
     return;
@@ -1144,11 +1186,52 @@ void WebRtcVideoChannel2::OnPacketReceived(
 void WebRtcVideoChannel2::OnRtcpReceived(
     rtc::Buffer* packet,
     const rtc::PacketTime& packet_time) {
+  bool spliced;
+  {
+    rtc::CritScope cs(&splicer_lock_);
+    spliced = !splicers_.empty();
+  }
+  bool shares_encoder;
+  {
+    rtc::CritScope cs(&mirror_lock_);
+    shares_encoder = !rtp_mirrors_.empty();
+  }
+  rtc::Buffer feedback;
+  const rtc::Buffer* delivered = packet;
+  if (spliced || shares_encoder || !remb_combiner_.empty()) {
+    // The NACKs are moved back to the numbering of the encoder, and the REMB
+    // lowered to the one of the most constrained peer of the encoder.
+    feedback.SetData(packet->data(), packet->length());
+    uint8* data = reinterpret_cast<uint8*>(feedback.data());
+    {
+      rtc::CritScope cs(&splicer_lock_);
+      for (std::map<uint32, RtpSplicer*>::const_iterator it =
+               splicers_.begin();
+           it != splicers_.end();
+           ++it) {
+        it->second->RewriteFeedback(data, feedback.length());
+      }
+    }
+    CombineRemb(this, &feedback);
+    delivered = &feedback;
+  }
   if (call_->Receiver()->DeliverPacket(
-          reinterpret_cast<const uint8_t*>(packet->data()), packet->length()) !=
-      webrtc::PacketReceiver::DELIVERY_OK) {
+          reinterpret_cast<const uint8_t*>(delivered->data()),
+          delivered->length()) != webrtc::PacketReceiver::DELIVERY_OK) {
     LOG(LS_WARNING) << "Failed to deliver RTCP packet.";
   }
+  if (!shared_encoder_ssrcs_.empty()) {
+    ForwardRtcpFeedback(*packet);
+  }
+  if (!forwarded_streams_.empty()) {
+    ForwardSenderReports(*packet);
+  }
+  for (std::map<uint32, WebRtcVideoChannel2*>::iterator it =
+           relayed_streams_.begin();
+       it != relayed_streams_.end();
+       ++it) {
+    it->second->ForwardFeedback(this, it->first, *packet);
+  }
 }
 
 void WebRtcVideoChannel2::OnReadyToSend(bool ready) {
@@ -1248,15 +1331,460 @@ void WebRtcVideoChannel2::OnMessage(rtc::Message* msg) {
 }
 
 bool WebRtcVideoChannel2::SendRtp(const uint8_t* data, size_t len) {
+  uint32 ssrc = 0;
+  if (GetRtpSsrc(data, len, &ssrc)) {
+    rtc::CritScope cs(&mirror_lock_);
+    std::map<uint32, std::vector<RtpMirror> >::const_iterator it =
+        rtp_mirrors_.find(ssrc);
+    if (it != rtp_mirrors_.end()) {
+      for (size_t i = 0; i < it->second.size(); ++i) {
+        it->second[i].channel->SendMirroredRtp(it->second[i].ssrc, data, len);
+      }
+    }
+    if (mirror_only_ssrcs_.find(ssrc) != mirror_only_ssrcs_.end()) {
+      return true;
+    }
+  }
   rtc::Buffer packet(data, len, kMaxRtpPacketLen);
+  {
+    rtc::CritScope cs(&splicer_lock_);
+    bool rtx;
+    RtpSplicer* splicer = FindSplicer(ssrc, &rtx);
+    if (splicer != NULL &&
+        !splicer->RewriteRtp(reinterpret_cast<uint8*>(packet.data()), len, rtx,
+                             rtc::Time())) {
+      return true;
+    }
+  }
   return MediaChannel::SendPacket(&packet);
 }
 
 bool WebRtcVideoChannel2::SendRtcp(const uint8_t* data, size_t len) {
   rtc::Buffer packet(data, len, kMaxRtpPacketLen);
+  int type = 0;
+  uint32 ssrc = 0;
+  if (len >= kRtcpSenderReportLen && GetRtcpType(data, len, &type) &&
+      type == kRtcpTypeSR && GetRtcpSsrc(data, len, &ssrc)) {
+    {
+      rtc::CritScope cs(&mirror_lock_);
+      std::map<uint32, std::vector<RtpMirror> >::const_iterator it =
+          rtp_mirrors_.find(ssrc);
+      if (it != rtp_mirrors_.end()) {
+        for (size_t i = 0; i < it->second.size(); ++i) {
+          it->second[i].channel->SendMirroredSenderReport(it->second[i].ssrc,
+                                                          data);
+        }
+      }
+      if (mirror_only_ssrcs_.find(ssrc) != mirror_only_ssrcs_.end()) {
+        return true;
+      }
+    }
+    rtc::CritScope cs(&splicer_lock_);
+    bool rtx;
+    RtpSplicer* splicer = FindSplicer(ssrc, &rtx);
+    if (splicer != NULL) {
+      splicer->RewriteSenderReport(reinterpret_cast<uint8*>(packet.data()),
+                                   len);
+    }
+  }
   return MediaChannel::SendRtcp(&packet);
 }
 
+void WebRtcVideoChannel2::SendMirroredRtp(uint32 ssrc,
+                                          const uint8_t* data,
+                                          size_t len) {
+  rtc::Buffer packet(data, len, kMaxRtpPacketLen);
+  uint8* rtp = reinterpret_cast<uint8*>(packet.data());
+  {
+    rtc::CritScope cs(&splicer_lock_);
+    bool rtx;
+    RtpSplicer* splicer = FindSplicer(ssrc, &rtx);
+    if (splicer == NULL) {
+      SetRtpSsrc(rtp, len, ssrc);
+    } else if (!splicer->RewriteRtp(rtp, len, rtx, rtc::Time())) {
+      return;
+    }
+  }
+  MediaChannel::SendPacket(&packet);
+}
+
+void WebRtcVideoChannel2::SendMirroredSenderReport(uint32 ssrc,
+                                                   const uint8_t* data) {
+  // The mirrors only get the sender info; the report blocks and the rest of
+  // the compound packet are about the streams received by the encoding
+  // channel.
+  rtc::Buffer report(data, kRtcpSenderReportLen, kMaxRtpPacketLen);
+  uint8* header = reinterpret_cast<uint8*>(report.data());
+  header[0] = 0x80;
+  rtc::SetBE16(header + 2, kRtcpSenderReportLen / 4 - 1);
+  rtc::SetBE32(header + 4, ssrc);
+  {
+    rtc::CritScope cs(&splicer_lock_);
+    bool rtx;
+    RtpSplicer* splicer = FindSplicer(ssrc, &rtx);
+    if (splicer != NULL) {
+      splicer->RewriteSenderReport(header, kRtcpSenderReportLen);
+    }
+  }
+  MediaChannel::SendRtcp(&report);
+}
+
+void WebRtcVideoChannel2::AddSplicer(const std::vector<uint32>& ssrcs,
+                                     const std::vector<uint32>& rtx_ssrcs,
+                                     int red_payload_type,
+                                     int ulpfec_payload_type) {
+  rtc::CritScope cs(&splicer_lock_);
+  for (size_t i = 0; i < ssrcs.size(); ++i) {
+    RtpSplicer*& splicer = splicers_[ssrcs[i]];
+    if (splicer == NULL) {
+      splicer = new RtpSplicer(ssrcs[i],
+                               i < rtx_ssrcs.size() ? rtx_ssrcs[i] : 0);
+    }
+    splicer->SetFecPayloadTypes(red_payload_type, ulpfec_payload_type);
+  }
+}
+
+void WebRtcVideoChannel2::RemoveSplicer(const std::vector<uint32>& ssrcs) {
+  rtc::CritScope cs(&splicer_lock_);
+  for (size_t i = 0; i < ssrcs.size(); ++i) {
+    std::map<uint32, RtpSplicer*>::iterator it = splicers_.find(ssrcs[i]);
+    if (it != splicers_.end()) {
+      delete it->second;
+      splicers_.erase(it);
+    }
+  }
+}
+
+RtpSplicer* WebRtcVideoChannel2::FindSplicer(uint32 ssrc, bool* rtx) {
+  for (std::map<uint32, RtpSplicer*>::const_iterator it = splicers_.begin();
+       it != splicers_.end();
+       ++it) {
+    if (it->second->ssrc() == ssrc || it->second->rtx_ssrc() == ssrc) {
+      *rtx = it->second->rtx_ssrc() == ssrc;
+      return it->second;
+    }
+  }
+  return NULL;
+}
+
+void WebRtcVideoChannel2::CombineRemb(WebRtcVideoChannel2* channel,
+                                      rtc::Buffer* packet) {
+  remb_combiner_.CombineRemb(channel, reinterpret_cast<uint8*>(packet->data()),
+                             packet->length(), rtc::Time());
+}
+
+WebRtcVideoChannel2::WebRtcVideoSendStream*
+WebRtcVideoChannel2::FindSharedEncoder(WebRtcVideoSendStream* stream) {
+  const std::vector<std::pair<WebRtcVideoChannel2*, uint32> >& encoders =
+      engine_->shared_encoders();
+  for (size_t i = 0; i < encoders.size(); ++i) {
+    std::map<uint32, WebRtcVideoSendStream*>::iterator it =
+        encoders[i].first->send_streams_.find(encoders[i].second);
+    if (it != encoders[i].first->send_streams_.end() &&
+        it->second != stream && it->second->CanShareEncoderWith(stream)) {
+      return it->second;
+    }
+  }
+  return NULL;
+}
+
+void WebRtcVideoChannel2::SetRtpMirrors(
+    const std::vector<uint32>& ssrcs,
+    const std::vector<std::vector<RtpMirror> >& mirrors,
+    bool mirror_only) {
+  assert(ssrcs.size() == mirrors.size());
+  rtc::CritScope cs(&mirror_lock_);
+  for (size_t i = 0; i < ssrcs.size(); ++i) {
+    if (mirrors[i].empty()) {
+      rtp_mirrors_.erase(ssrcs[i]);
+    } else {
+      rtp_mirrors_[ssrcs[i]] = mirrors[i];
+    }
+    if (mirror_only) {
+      mirror_only_ssrcs_.insert(ssrcs[i]);
+    } else {
+      mirror_only_ssrcs_.erase(ssrcs[i]);
+    }
+  }
+}
+
+void WebRtcVideoChannel2::AddSharedEncoderSsrcs(
+    WebRtcVideoChannel2* channel,
+    const std::vector<uint32>& ssrcs,
+    const std::vector<uint32>& encoder_ssrcs) {
+  assert(ssrcs.size() == encoder_ssrcs.size());
+  std::map<uint32, uint32>& ssrc_map = shared_encoder_ssrcs_[channel];
+  for (size_t i = 0; i < ssrcs.size(); ++i) {
+    ssrc_map[ssrcs[i]] = encoder_ssrcs[i];
+  }
+}
+
+void WebRtcVideoChannel2::RemoveSharedEncoderSsrcs(
+    WebRtcVideoChannel2* channel,
+    const std::vector<uint32>& ssrcs) {
+  std::map<WebRtcVideoChannel2*, std::map<uint32, uint32> >::iterator it =
+      shared_encoder_ssrcs_.find(channel);
+  if (it == shared_encoder_ssrcs_.end()) {
+    return;
+  }
+  for (size_t i = 0; i < ssrcs.size(); ++i) {
+    it->second.erase(ssrcs[i]);
+  }
+  if (it->second.empty()) {
+    shared_encoder_ssrcs_.erase(it);
+    channel->remb_combiner_.RemovePeer(this);
+  }
+}
+
+// Rewrites the SSRC at |offset| of an RTCP packet of |len| bytes if it is one
+// of |ssrcs|.
+static bool RewriteRtcpSsrc(uint8* packet,
+                            size_t len,
+                            size_t offset,
+                            const std::map<uint32, uint32>& ssrcs) {
+  if (offset + 4 > len) {
+    return false;
+  }
+  std::map<uint32, uint32>::const_iterator it =
+      ssrcs.find(rtc::GetBE32(packet + offset));
+  if (it == ssrcs.end()) {
+    return false;
+  }
+  rtc::SetBE32(packet + offset, it->second);
+  return true;
+}
+
+// Rewrites the media source SSRCs which the report blocks and feedback
+// messages of a compound RTCP packet refer to. Returns true if any of them was
+// one of |ssrcs|.
+static bool RewriteRtcpMediaSsrcs(uint8* data,
+                                  size_t len,
+                                  const std::map<uint32, uint32>& ssrcs) {
+  bool rewritten = false;
+  size_t offset = 0;
+  while (offset + kMinRtcpPacketLen <= len) {
+    uint8* packet = data + offset;
+    const int count = packet[0] & 0x1F;
+    const size_t packet_len = (rtc::GetBE16(packet + 2) + 1) * 4;
+    if ((packet[0] >> 6) != 2 || offset + packet_len > len) {
+      break;
+    }
+    switch (packet[1]) {
+      case kRtcpTypeSR:
+      case kRtcpTypeRR: {
+        size_t block = packet[1] == kRtcpTypeSR ? kRtcpSenderReportLen : 8;
+        for (int i = 0; i < count; ++i, block += kRtcpReportBlockLen) {
+          rewritten |= RewriteRtcpSsrc(packet, packet_len, block, ssrcs);
+        }
+        break;
+      }
+      case kRtcpTypeRTPFB:
+        rewritten |= RewriteRtcpSsrc(packet, packet_len, 8, ssrcs);
+        break;
+      case kRtcpTypePSFB:
+        rewritten |= RewriteRtcpSsrc(packet, packet_len, 8, ssrcs);
+        if (count == kRtcpPsfbFir) {
+          for (size_t entry = 12; entry + 8 <= packet_len; entry += 8) {
+            rewritten |= RewriteRtcpSsrc(packet, packet_len, entry, ssrcs);
+          }
+        } else if (count == kRtcpPsfbAfb && packet_len >= 20 &&
+                   memcmp(packet + 12, "REMB", 4) == 0) {
+          const int num_ssrcs = packet[16];
+          for (int i = 0; i < num_ssrcs; ++i) {
+            rewritten |= RewriteRtcpSsrc(packet, packet_len, 20 + 4 * i, ssrcs);
+          }
+        }
+        break;
+    }
+    offset += packet_len;
+  }
+  return rewritten;
+}
+
+void WebRtcVideoChannel2::ForwardRtcpFeedback(const rtc::Buffer& packet) {
+  for (std::map<WebRtcVideoChannel2*, std::map<uint32, uint32> >::iterator it =
+           shared_encoder_ssrcs_.begin();
+       it != shared_encoder_ssrcs_.end();
+       ++it) {
+    rtc::Buffer feedback(packet.data(), packet.length(), kMaxRtpPacketLen);
+    uint8* data = reinterpret_cast<uint8*>(feedback.data());
+    {
+      rtc::CritScope cs(&splicer_lock_);
+      for (std::map<uint32, uint32>::const_iterator ssrc = it->second.begin();
+           ssrc != it->second.end();
+           ++ssrc) {
+        bool rtx;
+        RtpSplicer* splicer = FindSplicer(ssrc->first, &rtx);
+        if (splicer != NULL && !rtx) {
+          splicer->RewriteFeedback(data, feedback.length());
+        }
+      }
+    }
+    if (!RewriteRtcpMediaSsrcs(data, feedback.length(), it->second)) {
+      continue;
+    }
+    it->first->CombineRemb(this, &feedback);
+    it->first->call_->Receiver()->DeliverPacket(
+        reinterpret_cast<const uint8_t*>(feedback.data()), feedback.length());
+  }
+}
+
+bool WebRtcVideoChannel2::AddForwardedStream(
+    const std::vector<uint32>& recv_ssrcs,
+    WebRtcVideoChannel2* channel,
+    uint32 send_ssrc) {
+  LOG(LS_INFO) << "AddForwardedStream: " << send_ssrc;
+  if (recv_ssrcs.empty() || channel == NULL || channel == this) {
+    LOG(LS_ERROR) << "Invalid forwarded stream for ssrc " << send_ssrc;
+    return false;
+  }
+  if (channel->relayed_streams_.find(send_ssrc) !=
+      channel->relayed_streams_.end()) {
+    LOG(LS_ERROR) << "Forwarded stream with ssrc " << send_ssrc
+                  << " already exists.";
+    return false;
+  }
+
+  RtpForwarder* forwarder = new RtpForwarder(recv_ssrcs, send_ssrc);
+  SetupForwarder(forwarder, *channel);
+  forwarded_streams_.push_back(ForwardedStream(channel, forwarder));
+  channel->relayed_streams_[send_ssrc] = this;
+
+  uint32 layer_ssrc;
+  if (forwarder->GetKeyFrameRequest(rtc::Time(), &layer_ssrc)) {
+    SendKeyFrameRequest(layer_ssrc);
+  }
+  return true;
+}
+
+bool WebRtcVideoChannel2::RemoveForwardedStream(WebRtcVideoChannel2* channel,
+                                                uint32 send_ssrc) {
+  LOG(LS_INFO) << "RemoveForwardedStream: " << send_ssrc;
+  for (std::vector<ForwardedStream>::iterator it = forwarded_streams_.begin();
+       it != forwarded_streams_.end();
+       ++it) {
+    if (it->channel == channel && it->forwarder->ssrc() == send_ssrc) {
+      delete it->forwarder;
+      forwarded_streams_.erase(it);
+      channel->relayed_streams_.erase(send_ssrc);
+      return true;
+    }
+  }
+  LOG(LS_ERROR) << "No forwarded stream on ssrc " << send_ssrc;
+  return false;
+}
+
+void WebRtcVideoChannel2::SetupForwarder(
+    RtpForwarder* forwarder,
+    const WebRtcVideoChannel2& channel) const {
+  VideoCodecSettings send_codec;
+  if (channel.send_codec_.Get(&send_codec)) {
+    for (size_t i = 0; i < recv_codecs_.size(); ++i) {
+      const VideoCodecSettings& recv_codec = recv_codecs_[i];
+      if (_stricmp(recv_codec.codec.name.c_str(),
+                   send_codec.codec.name.c_str()) != 0) {
+        continue;
+      }
+      forwarder->MapPayloadType(recv_codec.codec.id, send_codec.codec.id);
+      forwarder->MapPayloadType(recv_codec.fec.red_payload_type,
+                                send_codec.fec.red_payload_type);
+      forwarder->MapPayloadType(recv_codec.fec.ulpfec_payload_type,
+                                send_codec.fec.ulpfec_payload_type);
+      if (_stricmp(recv_codec.codec.name.c_str(), kVp8CodecName) == 0) {
+        forwarder->SetVp8PayloadType(recv_codec.codec.id,
+                                     recv_codec.fec.red_payload_type);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < recv_rtp_extensions_.size(); ++i) {
+    for (size_t j = 0; j < channel.send_rtp_extensions_.size(); ++j) {
+      const webrtc::RtpExtension& extension = channel.send_rtp_extensions_[j];
+      if (recv_rtp_extensions_[i].name != extension.name) {
+        continue;
+      }
+      forwarder->MapHeaderExtension(recv_rtp_extensions_[i].id, extension.id);
+      if (extension.name == webrtc::RtpExtension::kAbsSendTime) {
+        forwarder->SetAbsSendTimeExtension(extension.id);
+      }
+    }
+  }
+}
+
+bool WebRtcVideoChannel2::ForwardRtp(const rtc::Buffer& packet, uint32 ssrc) {
+  const int64 now_ms = rtc::Time();
+  bool forwarded = false;
+  for (size_t i = 0; i < forwarded_streams_.size(); ++i) {
+    RtpForwarder* forwarder = forwarded_streams_[i].forwarder;
+    if (forwarder->GetLayer(ssrc) < 0) {
+      continue;
+    }
+    forwarded = true;
+    rtc::Buffer relayed_packet(
+        packet.data(), packet.length(), kMaxRtpPacketLen);
+    if (forwarder->RewriteRtp(reinterpret_cast<uint8*>(relayed_packet.data()),
+                              relayed_packet.length(),
+                              now_ms)) {
+      forwarded_streams_[i].channel->MediaChannel::SendPacket(
+          &relayed_packet);
+    }
+    uint32 layer_ssrc;
+    if (forwarder->GetKeyFrameRequest(now_ms, &layer_ssrc)) {
+      SendKeyFrameRequest(layer_ssrc);
+    }
+  }
+  return forwarded;
+}
+
+void WebRtcVideoChannel2::ForwardSenderReports(const rtc::Buffer& packet) {
+  for (size_t i = 0; i < forwarded_streams_.size(); ++i) {
+    rtc::Buffer report;
+    if (forwarded_streams_[i].forwarder->RewriteSenderReport(
+            reinterpret_cast<const uint8*>(packet.data()),
+            packet.length(),
+            &report)) {
+      forwarded_streams_[i].channel->MediaChannel::SendRtcp(&report);
+    }
+  }
+}
+
+void WebRtcVideoChannel2::ForwardFeedback(WebRtcVideoChannel2* channel,
+                                          uint32 send_ssrc,
+                                          const rtc::Buffer& packet) {
+  for (size_t i = 0; i < forwarded_streams_.size(); ++i) {
+    RtpForwarder* forwarder = forwarded_streams_[i].forwarder;
+    if (forwarded_streams_[i].channel != channel ||
+        forwarder->ssrc() != send_ssrc) {
+      continue;
+    }
+    rtc::Buffer feedback;
+    if (forwarder->RewriteFeedback(
+            reinterpret_cast<const uint8*>(packet.data()),
+            packet.length(),
+            rtcp_receiver_report_ssrc_,
+            &feedback)) {
+      MediaChannel::SendRtcp(&feedback);
+    }
+    // A REMB may have picked another layer.
+    uint32 layer_ssrc;
+    if (forwarder->GetKeyFrameRequest(rtc::Time(), &layer_ssrc)) {
+      SendKeyFrameRequest(layer_ssrc);
+    }
+    return;
+  }
+}
+
+void WebRtcVideoChannel2::SendKeyFrameRequest(uint32 ssrc) {
+  // An empty receiver report followed by a PLI.
+  uint8 data[20] = {0x80, kRtcpTypeRR, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+                    0x81, kRtcpTypePSFB, 0x00, 0x02};
+  rtc::SetBE32(data + 4, rtcp_receiver_report_ssrc_);
+  rtc::SetBE32(data + 12, rtcp_receiver_report_ssrc_);
+  rtc::SetBE32(data + 16, ssrc);
+  rtc::Buffer packet(data, sizeof(data), kMaxRtpPacketLen);
+  MediaChannel::SendRtcp(&packet);
+}
+
 void WebRtcVideoChannel2::StartAllSendStreams() {
   for (std::map<uint32, WebRtcVideoSendStream*>::iterator it =
            send_streams_.begin();
@@ -1284,19 +1812,24 @@ WebRtcVideoChannel2::WebRtcVideoSendStream::VideoSendStreamParameters::
 }
 
 WebRtcVideoChannel2::WebRtcVideoSendStream::WebRtcVideoSendStream(
+    WebRtcVideoChannel2* channel,
     webrtc::Call* call,
     WebRtcVideoEncoderFactory2* encoder_factory,
     const VideoOptions& options,
     const Settable<VideoCodecSettings>& codec_settings,
     const StreamParams& sp,
     const std::vector<webrtc::RtpExtension>& rtp_extensions)
-    : call_(call),
+    : channel_(channel),
+      call_(call),
       parameters_(webrtc::VideoSendStream::Config(), options, codec_settings),
       encoder_factory_(encoder_factory),
       capturer_(NULL),
       stream_(NULL),
+      stats_version_(0),
       sending_(false),
-      muted_(false) {
+      muted_(false),
+      shared_encoder_(NULL),
+      sending_mirrors_(0) {
   parameters_.config.rtp.max_packet_size = kVideoMtu;
 
   sp.GetPrimarySsrcs(&parameters_.config.rtp.ssrcs);
@@ -1312,6 +1845,8 @@ WebRtcVideoChannel2::WebRtcVideoSendStream::WebRtcVideoSendStream(
 }
 
 WebRtcVideoChannel2::WebRtcVideoSendStream::~WebRtcVideoSendStream() {
+  StopSharingEncoder();
+  channel_->RemoveSplicer(parameters_.config.rtp.ssrcs);
   DisconnectCapturer();
   if (stream_ != NULL) {
     call_->DestroyVideoSendStream(stream_);
@@ -1418,14 +1953,11 @@ bool WebRtcVideoChannel2::WebRtcVideoSendStream::SetCapturer(
       }
 
       capturer_ = NULL;
-      return true;
+    } else {
+      capturer_ = capturer;
     }
-
-    capturer_ = capturer;
   }
-  // Lock cannot be held while connecting the capturer to prevent lock-order
-  // violations.
-  capturer->SignalVideoFrame.connect(this, &WebRtcVideoSendStream::InputFrame);
+  UpdateEncoderSharing();
   return true;
 }
 
@@ -1438,26 +1970,35 @@ bool WebRtcVideoChannel2::WebRtcVideoSendStream::SetVideoFormat(
     return false;
   }
 
-  rtc::CritScope cs(&lock_);
-  if (format.width == 0 && format.height == 0) {
-    LOG(LS_INFO)
-        << "0x0 resolution selected. Captured frames will be dropped for ssrc: "
-        << parameters_.config.rtp.ssrcs[0] << ".";
-  } else {
-    // TODO(pbos): Fix me, this only affects the last stream!
-    parameters_.video_streams.back().max_framerate =
-        VideoFormat::IntervalToFps(format.interval);
-    SetDimensions(format.width, format.height);
-  }
+  {
+    rtc::CritScope cs(&lock_);
+    if (format.width == 0 && format.height == 0) {
+      LOG(LS_INFO) << "0x0 resolution selected. Captured frames will be "
+                      "dropped for ssrc: "
+                   << parameters_.config.rtp.ssrcs[0] << ".";
+    } else {
+      // TODO(pbos): Fix me, this only affects the last stream!
+      parameters_.video_streams.back().max_framerate =
+          VideoFormat::IntervalToFps(format.interval);
+      SetDimensions(format.width, format.height);
+    }
 
-  format_ = format;
+    format_ = format;
+  }
+  UpdateEncoderSharing();
   return true;
 }
 
 bool WebRtcVideoChannel2::WebRtcVideoSendStream::MuteStream(bool mute) {
-  rtc::CritScope cs(&lock_);
-  bool was_muted = muted_;
-  muted_ = mute;
+  bool was_muted;
+  {
+    rtc::CritScope cs(&lock_);
+    was_muted = muted_;
+    muted_ = mute;
+  }
+  if (was_muted != mute) {
+    UpdateEncoderSharing();
+  }
   return was_muted != mute;
 }
 
@@ -1473,18 +2014,24 @@ bool WebRtcVideoChannel2::WebRtcVideoSendStream::DisconnectCapturer() {
 
 void WebRtcVideoChannel2::WebRtcVideoSendStream::SetOptions(
     const VideoOptions& options) {
-  rtc::CritScope cs(&lock_);
-  VideoCodecSettings codec_settings;
-  if (parameters_.codec_settings.Get(&codec_settings)) {
-    SetCodecAndOptions(codec_settings, options);
-  } else {
-    parameters_.options = options;
+  {
+    rtc::CritScope cs(&lock_);
+    VideoCodecSettings codec_settings;
+    if (parameters_.codec_settings.Get(&codec_settings)) {
+      SetCodecAndOptions(codec_settings, options);
+    } else {
+      parameters_.options = options;
+    }
   }
+  UpdateEncoderSharing();
 }
 void WebRtcVideoChannel2::WebRtcVideoSendStream::SetCodec(
     const VideoCodecSettings& codec_settings) {
-  rtc::CritScope cs(&lock_);
-  SetCodecAndOptions(codec_settings, parameters_.options);
+  {
+    rtc::CritScope cs(&lock_);
+    SetCodecAndOptions(codec_settings, parameters_.options);
+  }
+  UpdateEncoderSharing();
 }
 void WebRtcVideoChannel2::WebRtcVideoSendStream::SetCodecAndOptions(
     const VideoCodecSettings& codec_settings,
@@ -1533,9 +2080,12 @@ void WebRtcVideoChannel2::WebRtcVideoSendStream::SetCodecAndOptions(
 
 void WebRtcVideoChannel2::WebRtcVideoSendStream::SetRtpExtensions(
     const std::vector<webrtc::RtpExtension>& rtp_extensions) {
-  rtc::CritScope cs(&lock_);
-  parameters_.config.rtp.extensions = rtp_extensions;
-  RecreateWebRtcStream();
+  {
+    rtc::CritScope cs(&lock_);
+    parameters_.config.rtp.extensions = rtp_extensions;
+    RecreateWebRtcStream();
+  }
+  UpdateEncoderSharing();
 }
 
 void WebRtcVideoChannel2::WebRtcVideoSendStream::SetDimensions(int width,
@@ -1570,18 +2120,245 @@ void WebRtcVideoChannel2::WebRtcVideoSendStream::SetDimensions(int width,
 }
 
 void WebRtcVideoChannel2::WebRtcVideoSendStream::Start() {
-  rtc::CritScope cs(&lock_);
-  assert(stream_ != NULL);
-  stream_->Start();
-  sending_ = true;
+  WebRtcVideoSendStream* shared_encoder;
+  {
+    rtc::CritScope cs(&lock_);
+    assert(stream_ != NULL);
+    sending_ = true;
+    UpdateSendState();
+    shared_encoder = shared_encoder_;
+  }
+  if (shared_encoder != NULL) {
+    shared_encoder->UpdateMirrors();
+  } else {
+    UpdateMirrors();
+  }
 }
 
 void WebRtcVideoChannel2::WebRtcVideoSendStream::Stop() {
-  rtc::CritScope cs(&lock_);
-  if (stream_ != NULL) {
+  WebRtcVideoSendStream* shared_encoder;
+  {
+    rtc::CritScope cs(&lock_);
+    sending_ = false;
+    UpdateSendState();
+    shared_encoder = shared_encoder_;
+  }
+  if (shared_encoder != NULL) {
+    shared_encoder->UpdateMirrors();
+  } else {
+    UpdateMirrors();
+  }
+}
+
+void WebRtcVideoChannel2::WebRtcVideoSendStream::UpdateSendState() {
+  if (stream_ == NULL) {
+    return;
+  }
+  if ((sending_ && shared_encoder_ == NULL) || sending_mirrors_ > 0) {
+    stream_->Start();
+  } else {
     stream_->Stop();
   }
-  sending_ = false;
+}
+
+std::vector<uint32> WebRtcVideoChannel2::WebRtcVideoSendStream::GetSsrcs() {
+  rtc::CritScope cs(&lock_);
+  std::vector<uint32> ssrcs = parameters_.config.rtp.ssrcs;
+  ssrcs.insert(ssrcs.end(),
+               parameters_.config.rtp.rtx.ssrcs.begin(),
+               parameters_.config.rtp.rtx.ssrcs.end());
+  return ssrcs;
+}
+
+bool WebRtcVideoChannel2::WebRtcVideoSendStream::IsSending() {
+  rtc::CritScope cs(&lock_);
+  return sending_;
+}
+
+static bool RtpExtensionsEqual(const std::vector<webrtc::RtpExtension>& a,
+                               const std::vector<webrtc::RtpExtension>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].name != b[i].name || a[i].id != b[i].id) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WebRtcVideoChannel2::WebRtcVideoSendStream::CanShareEncoderWith(
+    WebRtcVideoSendStream* other) {
+  // Only the worker thread holds the locks of two streams at a time.
+  rtc::CritScope cs(&lock_);
+  rtc::CritScope other_cs(&other->lock_);
+  VideoCodecSettings codec_settings;
+  VideoCodecSettings other_codec_settings;
+  if (shared_encoder_ != NULL || capturer_ == NULL ||
+      capturer_ != other->capturer_ ||
+      !parameters_.options.share_encoder.GetWithDefaultIfUnset(false) ||
+      !parameters_.codec_settings.Get(&codec_settings) ||
+      !other->parameters_.codec_settings.Get(&other_codec_settings)) {
+    return false;
+  }
+  const webrtc::VideoSendStream::Config& config = parameters_.config;
+  const webrtc::VideoSendStream::Config& other_config =
+      other->parameters_.config;
+  return codec_settings.codec == other_codec_settings.codec &&
+         codec_settings.fec.ulpfec_payload_type ==
+             other_codec_settings.fec.ulpfec_payload_type &&
+         codec_settings.fec.red_payload_type ==
+             other_codec_settings.fec.red_payload_type &&
+         codec_settings.rtx_payload_type ==
+             other_codec_settings.rtx_payload_type &&
+         parameters_.options == other->parameters_.options &&
+         config.rtp.ssrcs.size() == other_config.rtp.ssrcs.size() &&
+         config.rtp.rtx.ssrcs.size() == other_config.rtp.rtx.ssrcs.size() &&
+         RtpExtensionsEqual(config.rtp.extensions,
+                            other_config.rtp.extensions) &&
+         format_ == other->format_ && muted_ == other->muted_;
+}
+
+void WebRtcVideoChannel2::WebRtcVideoSendStream::UpdateEncoderSharing() {
+  StopSharingEncoder();
+
+  VideoCapturer* capturer;
+  bool share_encoder;
+  VideoCodecSettings codec_settings;
+  std::vector<uint32> ssrcs;
+  std::vector<uint32> rtx_ssrcs;
+  {
+    rtc::CritScope cs(&lock_);
+    capturer = capturer_;
+    share_encoder =
+        capturer_ != NULL && parameters_.codec_settings.Get(&codec_settings) &&
+        parameters_.options.share_encoder.GetWithDefaultIfUnset(false);
+    ssrcs = parameters_.config.rtp.ssrcs;
+    rtx_ssrcs = parameters_.config.rtp.rtx.ssrcs;
+  }
+  if (share_encoder) {
+    // Kept once the stream has shared an encoder, so that its own packets
+    // continue the numbering of the ones it got from another encoder.
+    channel_->AddSplicer(ssrcs, rtx_ssrcs, codec_settings.fec.red_payload_type,
+                         codec_settings.fec.ulpfec_payload_type);
+  }
+  WebRtcVideoSendStream* shared_encoder =
+      share_encoder ? channel_->FindSharedEncoder(this) : NULL;
+  if (shared_encoder != NULL) {
+    LOG(LS_INFO) << "Using the encoder of ssrc "
+                 << shared_encoder->GetSsrcs()[0] << " for ssrc "
+                 << GetSsrcs()[0] << ".";
+    shared_encoder->AddMirror(this);
+    return;
+  }
+  if (share_encoder) {
+    channel_->engine_->AddSharedEncoder(channel_, GetSsrcs()[0]);
+  }
+  // Lock cannot be held while connecting the capturer to prevent lock-order
+  // violations.
+  if (capturer != NULL) {
+    capturer->SignalVideoFrame.connect(this,
+                                       &WebRtcVideoSendStream::InputFrame);
+  }
+}
+
+void WebRtcVideoChannel2::WebRtcVideoSendStream::StopSharingEncoder() {
+  VideoCapturer* capturer;
+  WebRtcVideoSendStream* shared_encoder;
+  std::vector<WebRtcVideoSendStream*> mirrors;
+  {
+    rtc::CritScope cs(&lock_);
+    capturer = capturer_;
+    shared_encoder = shared_encoder_;
+    mirrors.swap(mirrors_);
+  }
+  if (capturer != NULL) {
+    capturer->SignalVideoFrame.disconnect(this);
+  }
+  if (shared_encoder != NULL) {
+    shared_encoder->RemoveMirror(this);
+  }
+  channel_->engine_->RemoveSharedEncoder(channel_, GetSsrcs()[0]);
+  if (mirrors.empty()) {
+    return;
+  }
+
+  UpdateMirrors();
+  for (size_t i = 0; i < mirrors.size(); ++i) {
+    mirrors[i]->SetSharedEncoder(NULL);
+    mirrors[i]->UpdateEncoderSharing();
+  }
+}
+
+void WebRtcVideoChannel2::WebRtcVideoSendStream::AddMirror(
+    WebRtcVideoSendStream* mirror) {
+  {
+    rtc::CritScope cs(&lock_);
+    mirrors_.push_back(mirror);
+  }
+  mirror->SetSharedEncoder(this);
+  UpdateMirrors();
+}
+
+void WebRtcVideoChannel2::WebRtcVideoSendStream::RemoveMirror(
+    WebRtcVideoSendStream* mirror) {
+  {
+    rtc::CritScope cs(&lock_);
+    mirrors_.erase(std::remove(mirrors_.begin(), mirrors_.end(), mirror),
+                   mirrors_.end());
+  }
+  mirror->SetSharedEncoder(NULL);
+  UpdateMirrors();
+}
+
+void WebRtcVideoChannel2::WebRtcVideoSendStream::UpdateMirrors() {
+  std::vector<WebRtcVideoSendStream*> mirrors;
+  bool sending;
+  {
+    rtc::CritScope cs(&lock_);
+    mirrors = mirrors_;
+    sending = sending_;
+  }
+  std::vector<uint32> ssrcs = GetSsrcs();
+  std::vector<std::vector<RtpMirror> > rtp_mirrors(ssrcs.size());
+  int sending_mirrors = 0;
+  for (size_t i = 0; i < mirrors.size(); ++i) {
+    if (!mirrors[i]->IsSending()) {
+      continue;
+    }
+    ++sending_mirrors;
+    std::vector<uint32> mirror_ssrcs = mirrors[i]->GetSsrcs();
+    assert(mirror_ssrcs.size() == ssrcs.size());
+    for (size_t j = 0; j < ssrcs.size(); ++j) {
+      rtp_mirrors[j].push_back(RtpMirror(mirrors[i]->channel_,
+                                         mirror_ssrcs[j]));
+    }
+  }
+  channel_->SetRtpMirrors(ssrcs, rtp_mirrors, !sending && sending_mirrors > 0);
+
+  rtc::CritScope cs(&lock_);
+  sending_mirrors_ = sending_mirrors;
+  UpdateSendState();
+}
+
+void WebRtcVideoChannel2::WebRtcVideoSendStream::SetSharedEncoder(
+    WebRtcVideoSendStream* shared_encoder) {
+  WebRtcVideoSendStream* old_shared_encoder;
+  {
+    rtc::CritScope cs(&lock_);
+    old_shared_encoder = shared_encoder_;
+    shared_encoder_ = shared_encoder;
+    UpdateSendState();
+  }
+  std::vector<uint32> ssrcs = GetSsrcs();
+  if (old_shared_encoder != NULL) {
+    channel_->RemoveSharedEncoderSsrcs(old_shared_encoder->channel_, ssrcs);
+  }
+  if (shared_encoder != NULL) {
+    channel_->AddSharedEncoderSsrcs(
+        shared_encoder->channel_, ssrcs, shared_encoder->GetSsrcs());
+  }
 }
 
 VideoSenderInfo
@@ -1592,11 +2369,12 @@ WebRtcVideoChannel2::WebRtcVideoSendStream::GetVideoSenderInfo() {
     info.add_ssrc(parameters_.config.rtp.ssrcs[i]);
   }
 
-  webrtc::VideoSendStream::Stats stats = stream_->GetStats();
+  stream_->GetStatsIfChanged(&stats_version_, &stats_);
+  const webrtc::VideoSendStream::Stats& stats = stats_;
   info.framerate_input = stats.input_frame_rate;
   info.framerate_sent = stats.encode_frame_rate;
 
-  for (std::map<uint32_t, webrtc::StreamStats>::iterator it =
+  for (std::map<uint32_t, webrtc::StreamStats>::const_iterator it =
            stats.substreams.begin();
        it != stats.substreams.end();
        ++it) {
@@ -1650,13 +2428,12 @@ void WebRtcVideoChannel2::WebRtcVideoSendStream::RecreateWebRtcStream() {
 
   stream_ = call_->CreateVideoSendStream(
       parameters_.config, parameters_.video_streams, encoder_settings);
+  stats_version_ = 0;
 
   encoder_factory_->DestroyVideoEncoderSettings(codec_settings.codec,
                                                 encoder_settings);
 
-  if (sending_) {
-    stream_->Start();
-  }
+  UpdateSendState();
 }
 
 WebRtcVideoChannel2::WebRtcVideoReceiveStream::WebRtcVideoReceiveStream(
@@ -1666,6 +2443,7 @@ WebRtcVideoChannel2::WebRtcVideoReceiveStream::WebRtcVideoReceiveStream(
     : call_(call),
       config_(config),
       stream_(NULL),
+      stats_version_(0),
       last_width_(-1),
       last_height_(-1),
       renderer_(NULL) {
@@ -1723,6 +2501,7 @@ void WebRtcVideoChannel2::WebRtcVideoReceiveStream::RecreateWebRtcStream() {
     call_->DestroyVideoReceiveStream(stream_);
   }
   stream_ = call_->CreateVideoReceiveStream(config_);
+  stats_version_ = 0;
   stream_->Start();
 }
 
@@ -1776,7 +2555,8 @@ VideoReceiverInfo
 WebRtcVideoChannel2::WebRtcVideoReceiveStream::GetVideoReceiverInfo() {
   VideoReceiverInfo info;
   info.add_ssrc(config_.rtp.remote_ssrc);
-  webrtc::VideoReceiveStream::Stats stats = stream_->GetStats();
+  stream_->GetStatsIfChanged(&stats_version_, &stats_);
+  const webrtc::VideoReceiveStream::Stats& stats = stats_;
   info.bytes_rcvd = stats.rtp_stats.bytes + stats.rtp_stats.header_bytes +
                     stats.rtp_stats.padding_bytes;
   info.packets_rcvd = stats.rtp_stats.packets;
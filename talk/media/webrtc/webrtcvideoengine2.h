@@ -29,12 +29,14 @@
 #define TALK_MEDIA_WEBRTC_WEBRTCVIDEOENGINE2_H_
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 
 #include "webrtc/base/cpumonitor.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "talk/media/base/mediaengine.h"
+#include "talk/media/base/rtpsplicer.h"
 #include "talk/media/webrtc/webrtcvideochannelfactory.h"
 #include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/system_wrappers/interface/thread_annotations.h"
@@ -65,6 +67,7 @@ class VideoFrame;
 class VideoProcessor;
 class VideoRenderer;
 class VoiceMediaChannel;
+class RtpForwarder;
 class WebRtcVideoChannel2;
 class WebRtcDecoderObserver;
 class WebRtcEncoderObserver;
@@ -153,6 +156,15 @@ class WebRtcVideoEngine2 : public sigslot::has_slots<> {
 
   rtc::CpuMonitor* cpu_monitor() { return cpu_monitor_.get(); }
 
+  // Send streams, as their channel and first SSRC, whose encoders may be
+  // shared with the send streams of other channels.
+  void AddSharedEncoder(WebRtcVideoChannel2* channel, uint32 ssrc);
+  void RemoveSharedEncoder(WebRtcVideoChannel2* channel, uint32 ssrc);
+  const std::vector<std::pair<WebRtcVideoChannel2*, uint32> >&
+  shared_encoders() const {
+    return shared_encoders_;
+  }
+
   virtual WebRtcVideoEncoderFactory2* GetVideoEncoderFactory();
 
  private:
@@ -177,6 +189,9 @@ class WebRtcVideoEngine2 : public sigslot::has_slots<> {
   rtc::scoped_ptr<rtc::CpuMonitor> cpu_monitor_;
   WebRtcVideoChannelFactory* channel_factory_;
   WebRtcVideoEncoderFactory2 default_video_encoder_factory_;
+
+  // Only used on the worker thread.
+  std::vector<std::pair<WebRtcVideoChannel2*, uint32> > shared_encoders_;
 };
 
 class WebRtcVideoChannel2 : public rtc::MessageHandler,
@@ -241,6 +256,18 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
 
   virtual void OnMessage(rtc::Message* msg) OVERRIDE;
 
+  // Relays the RTP received on |recv_ssrcs|, the layers of one source with
+  // the lowest bitrate first, to |channel| without decoding it, where it is
+  // sent as |send_ssrc|. The RTCP feedback |channel| receives for it picks
+  // the layer and goes back to the sender of the layers. Payload types and
+  // header extensions are mapped as set on both channels at the time of the
+  // call. Layers without a receive stream are not decoded. Both channels have
+  // to run on the same worker thread.
+  bool AddForwardedStream(const std::vector<uint32>& recv_ssrcs,
+                          WebRtcVideoChannel2* channel,
+                          uint32 send_ssrc);
+  bool RemoveForwardedStream(WebRtcVideoChannel2* channel, uint32 send_ssrc);
+
   // Implemented for VideoMediaChannelTest.
   bool sending() const { return sending_; }
   uint32 GetDefaultChannelSsrc() { return default_send_ssrc_; }
@@ -258,11 +285,39 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
     int rtx_payload_type;
   };
 
+  // A stream relayed from this channel to |channel|.
+  struct ForwardedStream {
+    ForwardedStream(WebRtcVideoChannel2* channel, RtpForwarder* forwarder)
+        : channel(channel), forwarder(forwarder) {}
+    WebRtcVideoChannel2* channel;
+    RtpForwarder* forwarder;
+  };
+
+  // Where the RTP packets and sender reports of a send stream are copied to.
+  struct RtpMirror {
+    RtpMirror(WebRtcVideoChannel2* channel, uint32 ssrc)
+        : channel(channel), ssrc(ssrc) {}
+    WebRtcVideoChannel2* channel;
+    uint32 ssrc;
+  };
+
   // Wrapper for the sender part, this is where the capturer is connected and
   // frames are then converted from cricket frames to webrtc frames.
+  //
+  // With VideoOptions::share_encoder, a send stream which is fed by the same
+  // capturer as another one with identical settings, typically in the channel
+  // of another peer, doesn't encode on its own. It is a mirror of the other
+  // stream: the RTP packets of that one are copied to its channel with the
+  // SSRCs rewritten, while the RTCP feedback of its peer is handed back the
+  // same way. The encoder gets the lowest REMB of the peers. The stream which
+  // encodes keeps doing so as long as itself or any of its mirrors are
+  // sending. Every stream sharing encoders is sent through an RtpSplicer, so
+  // that its numbering stays continuous when it moves to another encoder. The
+  // sharing is set up and torn down on the worker thread.
   class WebRtcVideoSendStream : public sigslot::has_slots<> {
    public:
     WebRtcVideoSendStream(
+        WebRtcVideoChannel2* channel,
         webrtc::Call* call,
         WebRtcVideoEncoderFactory2* encoder_factory,
         const VideoOptions& options,
@@ -287,6 +342,9 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
 
     VideoSenderInfo GetVideoSenderInfo();
 
+    // Returns true if |other| can be a mirror of this stream.
+    bool CanShareEncoderWith(WebRtcVideoSendStream* other);
+
    private:
     // Parameters needed to reconstruct the underlying stream.
     // webrtc::VideoSendStream doesn't support setting a lot of options on the
@@ -310,12 +368,34 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
                             const VideoOptions& options);
     void RecreateWebRtcStream();
     void SetDimensions(int width, int height);
-
+    void UpdateSendState() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+    // The SSRCs followed by the RTX SSRCs.
+    std::vector<uint32> GetSsrcs();
+    bool IsSending();
+
+    // Becomes a mirror of another stream, or encodes and connects the capturer
+    // itself, depending on the current settings.
+    void UpdateEncoderSharing();
+    // Stops being a mirror, or stops the mirrors of this stream and lets them
+    // find another stream to share an encoder with.
+    void StopSharingEncoder();
+    void AddMirror(WebRtcVideoSendStream* mirror);
+    void RemoveMirror(WebRtcVideoSendStream* mirror);
+    // Updates where the packets are copied to and if the encoder is running
+    // after the mirrors have changed or started or stopped sending.
+    void UpdateMirrors();
+    void SetSharedEncoder(WebRtcVideoSendStream* encoder);
+
+    WebRtcVideoChannel2* const channel_;
     webrtc::Call* const call_;
     WebRtcVideoEncoderFactory2* const encoder_factory_;
 
     rtc::CriticalSection lock_;
     webrtc::VideoSendStream* stream_ GUARDED_BY(lock_);
+    // Last stats snapshot of |stream_|, only refreshed when it has changed.
+    webrtc::VideoSendStream::Stats stats_ GUARDED_BY(lock_);
+    uint32_t stats_version_ GUARDED_BY(lock_);
     VideoSendStreamParameters parameters_ GUARDED_BY(lock_);
 
     VideoCapturer* capturer_ GUARDED_BY(lock_);
@@ -323,6 +403,13 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
     bool muted_ GUARDED_BY(lock_);
     VideoFormat format_ GUARDED_BY(lock_);
 
+    // The stream whose encoder this one uses, if any.
+    WebRtcVideoSendStream* shared_encoder_ GUARDED_BY(lock_);
+    // The streams using the encoder of this one, and how many of them are
+    // sending.
+    std::vector<WebRtcVideoSendStream*> mirrors_ GUARDED_BY(lock_);
+    int sending_mirrors_ GUARDED_BY(lock_);
+
     rtc::CriticalSection frame_lock_;
     webrtc::I420VideoFrame video_frame_ GUARDED_BY(frame_lock_);
   };
@@ -357,6 +444,9 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
 
     webrtc::VideoReceiveStream* stream_;
     webrtc::VideoReceiveStream::Config config_;
+    // Last stats snapshot of |stream_|, only refreshed when it has changed.
+    webrtc::VideoReceiveStream::Stats stats_;
+    uint32_t stats_version_;
 
     rtc::CriticalSection renderer_lock_;
     cricket::VideoRenderer* renderer_ GUARDED_BY(renderer_lock_);
@@ -382,6 +472,49 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
   void FillReceiverStats(VideoMediaInfo* info);
   void FillBandwidthEstimationStats(VideoMediaInfo* info);
 
+  WebRtcVideoSendStream* FindSharedEncoder(WebRtcVideoSendStream* stream);
+  // Sets where the RTP packets of send stream SSRC |ssrcs[i]| are copied to.
+  // With |mirror_only| they are not sent by this channel itself.
+  void SetRtpMirrors(const std::vector<uint32>& ssrcs,
+                     const std::vector<std::vector<RtpMirror> >& mirrors,
+                     bool mirror_only);
+  // Maps the SSRCs of a mirror send stream to the ones of the stream of
+  // |channel| whose encoder it uses, for the RTCP feedback handed to it.
+  void AddSharedEncoderSsrcs(WebRtcVideoChannel2* channel,
+                             const std::vector<uint32>& ssrcs,
+                             const std::vector<uint32>& encoder_ssrcs);
+  void RemoveSharedEncoderSsrcs(WebRtcVideoChannel2* channel,
+                                const std::vector<uint32>& ssrcs);
+  void ForwardRtcpFeedback(const rtc::Buffer& packet);
+  // Lowers the REMB in |packet| from the peer of |channel| to the lowest one
+  // of the peers the encoders of this channel send to.
+  void CombineRemb(WebRtcVideoChannel2* channel, rtc::Buffer* packet);
+  // Sends the packets of the send stream of SSRCs |ssrcs| and |rtx_ssrcs|
+  // through a splicer. Keeps the splicer it already has.
+  void AddSplicer(const std::vector<uint32>& ssrcs,
+                  const std::vector<uint32>& rtx_ssrcs,
+                  int red_payload_type,
+                  int ulpfec_payload_type);
+  void RemoveSplicer(const std::vector<uint32>& ssrcs);
+  // Returns the splicer of the media or RTX stream |ssrc|, NULL if none.
+  RtpSplicer* FindSplicer(uint32 ssrc, bool* rtx)
+      EXCLUSIVE_LOCKS_REQUIRED(splicer_lock_);
+  // Sends an RTP packet or a sender report of a stream whose encoder a send
+  // stream of this channel with |ssrc| shares.
+  void SendMirroredRtp(uint32 ssrc, const uint8_t* data, size_t len);
+  void SendMirroredSenderReport(uint32 ssrc, const uint8_t* data);
+
+  void SetupForwarder(RtpForwarder* forwarder,
+                      const WebRtcVideoChannel2& channel) const;
+  // Returns true if |ssrc| is a layer of a forwarded stream.
+  bool ForwardRtp(const rtc::Buffer& packet, uint32 ssrc);
+  void ForwardSenderReports(const rtc::Buffer& packet);
+  void ForwardFeedback(WebRtcVideoChannel2* channel,
+                       uint32 send_ssrc,
+                       const rtc::Buffer& packet);
+  void SendKeyFrameRequest(uint32 ssrc);
+
+  WebRtcVideoEngine2* engine_;
   uint32_t rtcp_receiver_report_ssrc_;
   bool sending_;
   rtc::scoped_ptr<webrtc::Call> call_;
@@ -400,6 +533,33 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
   std::vector<VideoCodecSettings> recv_codecs_;
   std::vector<webrtc::RtpExtension> recv_rtp_extensions_;
   VideoOptions options_;
+
+  rtc::CriticalSection mirror_lock_;
+  // Where the RTP packets of the send streams sharing their encoder are
+  // copied to, by SSRC.
+  std::map<uint32, std::vector<RtpMirror> > rtp_mirrors_
+      GUARDED_BY(mirror_lock_);
+  // SSRCs whose packets only go to the mirrors.
+  std::set<uint32> mirror_only_ssrcs_ GUARDED_BY(mirror_lock_);
+  // For the RTCP feedback of the mirror send streams, the SSRCs of the streams
+  // whose encoders they use, by their channel. Only used on the worker thread.
+  std::map<WebRtcVideoChannel2*, std::map<uint32, uint32> >
+      shared_encoder_ssrcs_;
+  // Never held while taking another lock, so that the mirrors of the streams
+  // of two channels can be sent to each other under their |mirror_lock_|.
+  rtc::CriticalSection splicer_lock_;
+  // The splicers of the send streams sharing encoders, by the SSRC of the
+  // media stream.
+  std::map<uint32, RtpSplicer*> splicers_ GUARDED_BY(splicer_lock_);
+  // The REMBs of the peers the encoders of this channel send to, by channel.
+  // Only used on the worker thread.
+  RembCombiner remb_combiner_;
+
+  // The streams relayed from this channel to others, and the channels the
+  // streams relayed to this one come from, by sent SSRC. Only used on the
+  // worker thread.
+  std::vector<ForwardedStream> forwarded_streams_;
+  std::map<uint32, WebRtcVideoChannel2*> relayed_streams_;
 };
 
 }  // namespace cricket
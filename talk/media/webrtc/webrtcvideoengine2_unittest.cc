@@ -72,7 +72,9 @@ FakeVideoSendStream::FakeVideoSendStream(
     const void* encoder_settings)
     : sending_(false),
       config_(config),
-      codec_settings_set_(false) {
+      codec_settings_set_(false),
+      stats_version_(1),
+      num_stats_copies_(0) {
   assert(config.encoder_settings.encoder != NULL);
   ReconfigureVideoEncoder(video_streams, encoder_settings);
 }
@@ -99,8 +101,29 @@ bool FakeVideoSendStream::GetVp8Settings(
   return true;
 }
 
+void FakeVideoSendStream::SetStats(
+    const webrtc::VideoSendStream::Stats& stats) {
+  stats_ = stats;
+  ++stats_version_;
+}
+
+int FakeVideoSendStream::num_stats_copies() const {
+  return num_stats_copies_;
+}
+
 webrtc::VideoSendStream::Stats FakeVideoSendStream::GetStats() const {
-  return webrtc::VideoSendStream::Stats();
+  return stats_;
+}
+
+bool FakeVideoSendStream::GetStatsIfChanged(
+    uint32_t* stats_version,
+    webrtc::VideoSendStream::Stats* stats) const {
+  if (*stats_version == stats_version_)
+    return false;
+  *stats = stats_;
+  *stats_version = stats_version_;
+  ++num_stats_copies_;
+  return true;
 }
 
 bool FakeVideoSendStream::ReconfigureVideoEncoder(
@@ -131,7 +154,10 @@ void FakeVideoSendStream::Stop() {
 
 FakeVideoReceiveStream::FakeVideoReceiveStream(
     const webrtc::VideoReceiveStream::Config& config)
-    : config_(config), receiving_(false) {
+    : config_(config),
+      receiving_(false),
+      stats_version_(1),
+      num_stats_copies_(0) {
 }
 
 webrtc::VideoReceiveStream::Config FakeVideoReceiveStream::GetConfig() {
@@ -142,8 +168,29 @@ bool FakeVideoReceiveStream::IsReceiving() const {
   return receiving_;
 }
 
+void FakeVideoReceiveStream::SetStats(
+    const webrtc::VideoReceiveStream::Stats& stats) {
+  stats_ = stats;
+  ++stats_version_;
+}
+
+int FakeVideoReceiveStream::num_stats_copies() const {
+  return num_stats_copies_;
+}
+
 webrtc::VideoReceiveStream::Stats FakeVideoReceiveStream::GetStats() const {
-  return webrtc::VideoReceiveStream::Stats();
+  return stats_;
+}
+
+bool FakeVideoReceiveStream::GetStatsIfChanged(
+    uint32_t* stats_version,
+    webrtc::VideoReceiveStream::Stats* stats) const {
+  if (*stats_version == stats_version_)
+    return false;
+  *stats = stats_;
+  *stats_version = stats_version_;
+  ++num_stats_copies_;
+  return true;
 }
 
 void FakeVideoReceiveStream::Start() {
@@ -1178,6 +1225,200 @@ TEST_F(WebRtcVideoChannel2Test, DISABLED_MultipleSendStreamsWithOneCapturer) {
   FAIL() << "Not implemented.";  // TODO(pbos): Implement.
 }
 
+TEST_F(WebRtcVideoChannel2Test, SharesEncoderWithChannelsOfSameCapturer) {
+  static const uint32 kOtherSsrc = 2;
+  cricket::FakeVideoCapturer capturer;
+  VideoOptions options;
+  options.share_encoder.Set(true);
+  EXPECT_TRUE(channel_->SetOptions(options));
+  FakeVideoSendStream* stream =
+      AddSendStream(StreamParams::CreateLegacy(kSsrcs1[0]));
+
+  rtc::scoped_ptr<VideoMediaChannel> other_channel(
+      engine_.CreateChannel(NULL));
+  FakeCall* other_call =
+      factory_.GetFakeChannel(other_channel.get())->GetFakeCall();
+  cricket::FakeNetworkInterface other_network;
+  other_channel->SetInterface(&other_network);
+  EXPECT_TRUE(other_channel->SetSendCodecs(engine_.codecs()));
+  EXPECT_TRUE(other_channel->SetOptions(options));
+  EXPECT_TRUE(
+      other_channel->AddSendStream(StreamParams::CreateLegacy(kOtherSsrc)));
+  ASSERT_EQ(1u, other_call->GetVideoSendStreams().size());
+  FakeVideoSendStream* other_stream = other_call->GetVideoSendStreams()[0];
+
+  EXPECT_TRUE(channel_->SetCapturer(kSsrcs1[0], &capturer));
+  EXPECT_TRUE(other_channel->SetCapturer(kOtherSsrc, &capturer));
+  EXPECT_TRUE(channel_->SetSend(true));
+  EXPECT_TRUE(other_channel->SetSend(true));
+  EXPECT_TRUE(stream->IsSending());
+  EXPECT_FALSE(other_stream->IsSending())
+      << "Stream using a shared encoder should not encode on its own.";
+
+  // The packets of the encoding stream are copied to the other channel.
+  uint8 packet[kMinRtpPacketLen] = {0x80, 100};
+  EXPECT_TRUE(SetRtpSsrc(packet, sizeof(packet), kSsrcs1[0]));
+  static_cast<webrtc::newapi::Transport*>(fake_channel_)
+      ->SendRtp(packet, sizeof(packet));
+  EXPECT_EQ(1, other_network.NumRtpPackets());
+  EXPECT_EQ(1, other_network.NumRtpPackets(kOtherSsrc));
+
+  // The encoder keeps running for the other channel.
+  EXPECT_TRUE(channel_->SetSend(false));
+  EXPECT_TRUE(stream->IsSending());
+
+  // Without the encoding stream the other one encodes on its own.
+  EXPECT_TRUE(channel_->RemoveSendStream(kSsrcs1[0]));
+  EXPECT_TRUE(other_stream->IsSending());
+}
+
+TEST_F(WebRtcVideoChannel2Test, KeepsNumberingWhenSharedEncoderChanges) {
+  static const uint32 kOtherSsrc = 2;
+  cricket::FakeVideoCapturer capturer;
+  VideoOptions options;
+  options.share_encoder.Set(true);
+  EXPECT_TRUE(channel_->SetOptions(options));
+  AddSendStream(StreamParams::CreateLegacy(kSsrcs1[0]));
+
+  rtc::scoped_ptr<VideoMediaChannel> other_channel(
+      engine_.CreateChannel(NULL));
+  FakeWebRtcVideoChannel2* other_fake_channel =
+      factory_.GetFakeChannel(other_channel.get());
+  cricket::FakeNetworkInterface other_network;
+  other_channel->SetInterface(&other_network);
+  EXPECT_TRUE(other_channel->SetSendCodecs(engine_.codecs()));
+  EXPECT_TRUE(other_channel->SetOptions(options));
+  EXPECT_TRUE(
+      other_channel->AddSendStream(StreamParams::CreateLegacy(kOtherSsrc)));
+  EXPECT_TRUE(channel_->SetCapturer(kSsrcs1[0], &capturer));
+  EXPECT_TRUE(other_channel->SetCapturer(kOtherSsrc, &capturer));
+  EXPECT_TRUE(channel_->SetSend(true));
+  EXPECT_TRUE(other_channel->SetSend(true));
+
+  uint8 packet[kMinRtpPacketLen] = {0x80, 100};
+  RtpHeader header = {100, 7, 90000, kSsrcs1[0]};
+  EXPECT_TRUE(SetRtpHeader(packet, sizeof(packet), header));
+  static_cast<webrtc::newapi::Transport*>(fake_channel_)
+      ->SendRtp(packet, sizeof(packet));
+  ASSERT_EQ(1, other_network.NumRtpPackets(kOtherSsrc));
+
+  // The other stream encodes on its own from now on, and its packets follow
+  // the ones it got from the first encoder.
+  EXPECT_TRUE(channel_->RemoveSendStream(kSsrcs1[0]));
+  header.seq_num = 2000;
+  header.timestamp = 1234;
+  header.ssrc = kOtherSsrc;
+  EXPECT_TRUE(SetRtpHeader(packet, sizeof(packet), header));
+  static_cast<webrtc::newapi::Transport*>(other_fake_channel)
+      ->SendRtp(packet, sizeof(packet));
+  ASSERT_EQ(2, other_network.NumRtpPackets(kOtherSsrc));
+  rtc::scoped_ptr<const rtc::Buffer> sent(other_network.GetRtpPacket(1));
+  int seq_num;
+  uint32 timestamp;
+  EXPECT_TRUE(GetRtpSeqNum(sent->data(), sent->length(), &seq_num));
+  EXPECT_TRUE(GetRtpTimestamp(sent->data(), sent->length(), &timestamp));
+  EXPECT_EQ(8, seq_num);
+  EXPECT_LT(90000u, timestamp);
+  other_channel->SetInterface(NULL);
+}
+
+TEST_F(WebRtcVideoChannel2Test, ForwardsReceivedLayersWithoutDecoding) {
+  static const uint32 kLayerSsrcs[] = {1, 2};
+  static const uint32 kOtherSsrc = 3;
+  cricket::FakeNetworkInterface network;
+  channel_->SetInterface(&network);
+  EXPECT_TRUE(channel_->SetRecvCodecs(engine_.codecs()));
+
+  rtc::scoped_ptr<VideoMediaChannel> other_channel(
+      engine_.CreateChannel(NULL));
+  FakeWebRtcVideoChannel2* other_fake_channel =
+      factory_.GetFakeChannel(other_channel.get());
+  cricket::FakeNetworkInterface other_network;
+  other_channel->SetInterface(&other_network);
+  EXPECT_TRUE(other_channel->SetSendCodecs(engine_.codecs()));
+
+  const std::vector<uint32> ssrcs = MAKE_VECTOR(kLayerSsrcs);
+  EXPECT_TRUE(
+      fake_channel_->AddForwardedStream(ssrcs, other_fake_channel, kOtherSsrc));
+  EXPECT_FALSE(
+      fake_channel_->AddForwardedStream(ssrcs, other_fake_channel, kOtherSsrc));
+  ASSERT_EQ(1, network.NumRtcpPackets())
+      << "A key frame should be requested for the lowest layer.";
+  rtc::scoped_ptr<const rtc::Buffer> pli(network.GetRtcpPacket(0));
+  ASSERT_EQ(20u, pli->length());
+  EXPECT_EQ(kLayerSsrcs[0], rtc::GetBE32(pli->data() + 16));
+
+  // A VP8 key frame, without a receive stream for the call to decode it.
+  uint8 packet[kMinRtpPacketLen + 3] = {
+      0x80, static_cast<uint8>(default_codec_.id), 0x00, 0x01};
+  packet[kMinRtpPacketLen] = 0x10;
+  EXPECT_TRUE(SetRtpSsrc(packet, sizeof(packet), kLayerSsrcs[1]));
+  rtc::Buffer higher_layer(packet, sizeof(packet));
+  channel_->OnPacketReceived(&higher_layer, rtc::PacketTime());
+  EXPECT_EQ(0, other_network.NumRtpPackets());
+
+  EXPECT_TRUE(SetRtpSsrc(packet, sizeof(packet), kLayerSsrcs[0]));
+  rtc::Buffer lowest_layer(packet, sizeof(packet));
+  channel_->OnPacketReceived(&lowest_layer, rtc::PacketTime());
+  EXPECT_EQ(1, other_network.NumRtpPackets(kOtherSsrc));
+  EXPECT_TRUE(fake_channel_->GetFakeCall()->GetVideoReceiveStreams().empty())
+      << "No default receive stream should be created for forwarded layers.";
+
+  // The forwarded stream goes away with the channel it is relayed to.
+  other_channel.reset();
+  EXPECT_FALSE(
+      fake_channel_->RemoveForwardedStream(other_fake_channel, kOtherSsrc));
+  channel_->SetInterface(NULL);
+}
+
+TEST_F(WebRtcVideoChannel2Test, KeepsUnchangedSendStats) {
+  FakeVideoSendStream* stream = AddSendStream();
+  webrtc::VideoSendStream::Stats stats;
+  stats.encode_frame_rate = 29;
+  stream->SetStats(stats);
+
+  VideoMediaInfo info;
+  ASSERT_TRUE(channel_->GetStats(StatsOptions(), &info));
+  ASSERT_EQ(1u, info.senders.size());
+  EXPECT_EQ(29, info.senders[0].framerate_sent);
+  EXPECT_EQ(1, stream->num_stats_copies());
+
+  ASSERT_TRUE(channel_->GetStats(StatsOptions(), &info));
+  ASSERT_EQ(1u, info.senders.size());
+  EXPECT_EQ(29, info.senders[0].framerate_sent);
+  EXPECT_EQ(1, stream->num_stats_copies());
+
+  stats.encode_frame_rate = 15;
+  stream->SetStats(stats);
+  ASSERT_TRUE(channel_->GetStats(StatsOptions(), &info));
+  EXPECT_EQ(15, info.senders[0].framerate_sent);
+  EXPECT_EQ(2, stream->num_stats_copies());
+}
+
+TEST_F(WebRtcVideoChannel2Test, KeepsUnchangedReceiveStats) {
+  FakeVideoReceiveStream* stream = AddRecvStream();
+  webrtc::VideoReceiveStream::Stats stats;
+  stats.decode_frame_rate = 29;
+  stream->SetStats(stats);
+
+  VideoMediaInfo info;
+  ASSERT_TRUE(channel_->GetStats(StatsOptions(), &info));
+  ASSERT_EQ(1u, info.receivers.size());
+  EXPECT_EQ(29, info.receivers[0].framerate_decoded);
+  EXPECT_EQ(1, stream->num_stats_copies());
+
+  ASSERT_TRUE(channel_->GetStats(StatsOptions(), &info));
+  ASSERT_EQ(1u, info.receivers.size());
+  EXPECT_EQ(29, info.receivers[0].framerate_decoded);
+  EXPECT_EQ(1, stream->num_stats_copies());
+
+  stats.decode_frame_rate = 15;
+  stream->SetStats(stats);
+  ASSERT_TRUE(channel_->GetStats(StatsOptions(), &info));
+  EXPECT_EQ(15, info.receivers[0].framerate_decoded);
+  EXPECT_EQ(2, stream->num_stats_copies());
+}
+
 TEST_F(WebRtcVideoChannel2Test, DISABLED_SendReceiveBitratesStats) {
   FAIL() << "Not implemented.";  // TODO(pbos): Implement.
 }
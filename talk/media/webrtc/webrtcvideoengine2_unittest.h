@@ -47,8 +47,16 @@ class FakeVideoSendStream : public webrtc::VideoSendStream {
   bool IsSending() const;
   bool GetVp8Settings(webrtc::VideoCodecVP8* settings) const;
 
+  // Replaces the stats, which then count as changed.
+  void SetStats(const webrtc::VideoSendStream::Stats& stats);
+  // The number of times GetStatsIfChanged() copied the stats out.
+  int num_stats_copies() const;
+
  private:
   virtual webrtc::VideoSendStream::Stats GetStats() const OVERRIDE;
+  virtual bool GetStatsIfChanged(
+      uint32_t* stats_version,
+      webrtc::VideoSendStream::Stats* stats) const OVERRIDE;
 
   virtual bool ReconfigureVideoEncoder(
       const std::vector<webrtc::VideoStream>& streams,
@@ -64,6 +72,9 @@ class FakeVideoSendStream : public webrtc::VideoSendStream {
   std::vector<webrtc::VideoStream> video_streams_;
   bool codec_settings_set_;
   webrtc::VideoCodecVP8 vp8_settings_;
+  webrtc::VideoSendStream::Stats stats_;
+  uint32_t stats_version_;
+  mutable int num_stats_copies_;
 };
 
 class FakeVideoReceiveStream : public webrtc::VideoReceiveStream {
@@ -75,8 +86,16 @@ class FakeVideoReceiveStream : public webrtc::VideoReceiveStream {
 
   bool IsReceiving() const;
 
+  // Replaces the stats, which then count as changed.
+  void SetStats(const webrtc::VideoReceiveStream::Stats& stats);
+  // The number of times GetStatsIfChanged() copied the stats out.
+  int num_stats_copies() const;
+
  private:
   virtual webrtc::VideoReceiveStream::Stats GetStats() const OVERRIDE;
+  virtual bool GetStatsIfChanged(
+      uint32_t* stats_version,
+      webrtc::VideoReceiveStream::Stats* stats) const OVERRIDE;
 
   virtual void Start() OVERRIDE;
   virtual void Stop() OVERRIDE;
@@ -84,6 +103,9 @@ class FakeVideoReceiveStream : public webrtc::VideoReceiveStream {
 
   webrtc::VideoReceiveStream::Config config_;
   bool receiving_;
+  webrtc::VideoReceiveStream::Stats stats_;
+  uint32_t stats_version_;
+  mutable int num_stats_copies_;
 };
 
 class FakeCall : public webrtc::Call {
@@ -1044,6 +1044,31 @@ TEST_F(WebRtcVideoEngineTestFake, BufferedModeLatency) {
   EXPECT_EQ(0, vie_.GetReceiverTargetDelay(recv_channel_num));
 }
 
+TEST_F(WebRtcVideoEngineTestFake, PacketHistorySize) {
+  EXPECT_TRUE(SetupEngine());
+
+  // Verify the ViE default is kept unless the option is set.
+  EXPECT_TRUE(channel_->AddSendStream(cricket::StreamParams::CreateLegacy(1)));
+  int first_send_channel = vie_.GetLastChannel();
+  EXPECT_EQ(0, vie_.GetSendSideHistorySize(first_send_channel));
+
+  cricket::VideoOptions options;
+  options.conference_mode.Set(true);
+  options.video_packet_history_size.Set(128);
+  EXPECT_TRUE(channel_->SetOptions(options));
+  EXPECT_EQ(128, vie_.GetSendSideHistorySize(first_send_channel));
+
+  // Receive channels keep no history of their own.
+  EXPECT_TRUE(channel_->AddRecvStream(cricket::StreamParams::CreateLegacy(2)));
+  int recv_channel_num = vie_.GetLastChannel();
+  EXPECT_EQ(0, vie_.GetSendSideHistorySize(recv_channel_num));
+
+  // New send streams pick up the option.
+  EXPECT_TRUE(channel_->AddSendStream(cricket::StreamParams::CreateLegacy(3)));
+  int second_send_channel = vie_.GetLastChannel();
+  EXPECT_EQ(128, vie_.GetSendSideHistorySize(second_send_channel));
+}
+
 TEST_F(WebRtcVideoEngineTestFake, AdditiveVideoOptions) {
   EXPECT_TRUE(SetupEngine());
 
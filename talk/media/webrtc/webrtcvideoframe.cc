@@ -51,6 +51,7 @@ class WebRtcVideoFrame::FrameBuffer {
   void Alias(uint8* data, size_t length);
   uint8* data();
   size_t length() const;
+  bool owns_data() const;
 
   webrtc::VideoFrame* frame();
   const webrtc::VideoFrame* frame() const;
@@ -97,6 +98,10 @@ size_t WebRtcVideoFrame::FrameBuffer::length() const {
   return video_frame_.Length();
 }
 
+bool WebRtcVideoFrame::FrameBuffer::owns_data() const {
+  return owned_data_.get() != NULL;
+}
+
 webrtc::VideoFrame* WebRtcVideoFrame::FrameBuffer::frame() {
   return &video_frame_;
 }
@@ -226,6 +231,9 @@ VideoFrame* WebRtcVideoFrame::Copy() const {
 }
 
 bool WebRtcVideoFrame::MakeExclusive() {
+  if (OwnsBuffer()) {
+    return true;
+  }
   const size_t length = video_buffer_->length();
   RefCountedBuffer* exclusive_buffer = new RefCountedBuffer(length);
   memcpy(exclusive_buffer->data(), video_buffer_->data(), length);
@@ -276,11 +284,10 @@ void WebRtcVideoFrame::Attach(
     RefCountedBuffer* video_buffer, size_t buffer_size, int w, int h,
     size_t pixel_width, size_t pixel_height, int64 elapsed_time,
     int64 time_stamp, int rotation) {
-  if (video_buffer_.get() == video_buffer) {
-    return;
+  if (video_buffer_.get() != video_buffer) {
+    video_buffer_ = video_buffer;
   }
   is_black_ = false;
-  video_buffer_ = video_buffer;
   frame()->SetWidth(w);
   frame()->SetHeight(h);
   pixel_width_ = pixel_width;
@@ -290,6 +297,18 @@ void WebRtcVideoFrame::Attach(
   rotation_ = rotation;
 }
 
+bool WebRtcVideoFrame::OwnsBuffer() const {
+  return video_buffer_->HasOneRef() && video_buffer_->owns_data();
+}
+
+WebRtcVideoFrame::RefCountedBuffer* WebRtcVideoFrame::RecycleOrCreateBuffer(
+    size_t size) {
+  if (OwnsBuffer() && video_buffer_->length() == size) {
+    return video_buffer_.get();
+  }
+  return new RefCountedBuffer(size);
+}
+
 webrtc::VideoFrame* WebRtcVideoFrame::frame() {
   return video_buffer_->frame();
 }
@@ -325,7 +344,7 @@ bool WebRtcVideoFrame::Reset(
 
   size_t desired_size = SizeOf(new_width, new_height);
   rtc::scoped_refptr<RefCountedBuffer> video_buffer(
-      new RefCountedBuffer(desired_size));
+      RecycleOrCreateBuffer(desired_size));
   // Since the libyuv::ConvertToI420 will handle the rotation, so the
   // new frame's rotation should always be 0.
   Attach(video_buffer.get(), desired_size, new_width, new_height, pixel_width,
@@ -369,7 +388,7 @@ void WebRtcVideoFrame::InitToEmptyBuffer(int w, int h, size_t pixel_width,
                                          int64 elapsed_time, int64 time_stamp) {
   size_t buffer_size = VideoFrame::SizeOf(w, h);
   rtc::scoped_refptr<RefCountedBuffer> video_buffer(
-      new RefCountedBuffer(buffer_size));
+      RecycleOrCreateBuffer(buffer_size));
   Attach(video_buffer.get(), buffer_size, w, h, pixel_width, pixel_height,
          elapsed_time, time_stamp, 0);
 }
@@ -120,6 +120,13 @@ class WebRtcVideoFrame : public VideoFrame {
   void InitToEmptyBuffer(int w, int h, size_t pixel_width, size_t pixel_height,
                          int64 elapsed_time, int64 time_stamp);
 
+  // Returns true if the buffer belongs to this frame alone: it isn't aliased
+  // and no copy of the frame shares it.
+  bool OwnsBuffer() const;
+  // Returns the buffer of the frame if it is owned and of |size| bytes, to be
+  // overwritten by new content of the frame, or else a new buffer.
+  RefCountedBuffer* RecycleOrCreateBuffer(size_t size);
+
   rtc::scoped_refptr<RefCountedBuffer> video_buffer_;
   bool is_black_;
   size_t pixel_width_;
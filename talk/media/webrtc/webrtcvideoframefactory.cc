@@ -25,23 +25,37 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "talk/media/base/videocapturer.h"
 #include "talk/media/webrtc/webrtcvideoframe.h"
 #include "talk/media/webrtc/webrtcvideoframefactory.h"
+#include "talk/media/webrtc/webrtcvideoframeview.h"
 #include "webrtc/base/logging.h"
 
 namespace cricket {
 
+WebRtcVideoFrameFactory::WebRtcVideoFrameFactory()
+    : recycled_frame_(new WebRtcVideoFrame()) {
+}
+
+WebRtcVideoFrameFactory::~WebRtcVideoFrameFactory() {}
+
 VideoFrame* WebRtcVideoFrameFactory::CreateAliasedFrame(
     const CapturedFrame* aliased_frame, int width, int height) const {
+  // A crop of an I420 frame is a view of the captured planes.
+  if (aliased_frame->width != width || aliased_frame->height != height) {
+    rtc::scoped_ptr<WebRtcVideoFrameView> view(new WebRtcVideoFrameView());
+    if (view->Init(aliased_frame, width, height)) {
+      return view.release();
+    }
+  }
   // TODO(pthatcher): Move Alias logic into the VideoFrameFactory and
   // out of the VideoFrame.
-  rtc::scoped_ptr<WebRtcVideoFrame> frame(new WebRtcVideoFrame());
-  if (!frame->Alias(aliased_frame, width, height)) {
+  if (!recycled_frame_->Alias(aliased_frame, width, height)) {
     LOG(LS_ERROR) <<
         "Failed to create WebRtcVideoFrame in CreateAliasedFrame.";
     return NULL;
   }
-  return frame.release();
+  return recycled_frame_->Copy();
 }
 
 }  // namespace cricket
@@ -28,16 +28,28 @@
 #define TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMEFACTORY_H_
 
 #include "talk/media/base/videoframefactory.h"
+#include "webrtc/base/scoped_ptr.h"
 
 namespace cricket {
 
 struct CapturedFrame;
+class WebRtcVideoFrame;
 
-// Creates instances of cricket::WebRtcVideoFrame.
+// Creates instances of cricket::WebRtcVideoFrame, or views of the captured
+// frame when an I420 frame only has to be cropped. Only to be used by the
+// thread which delivers the captured frames.
 class WebRtcVideoFrameFactory : public VideoFrameFactory {
  public:
+  WebRtcVideoFrameFactory();
+  virtual ~WebRtcVideoFrameFactory();
+
   virtual VideoFrame* CreateAliasedFrame(
       const CapturedFrame* aliased_frame, int width, int height) const OVERRIDE;
+
+ private:
+  // The frames handed out share the buffer of this frame, which is reused
+  // for the next conversion once they are all gone.
+  mutable rtc::scoped_ptr<WebRtcVideoFrame> recycled_frame_;
 };
 
 }  // namespace cricket
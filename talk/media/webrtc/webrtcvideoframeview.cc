@@ -0,0 +1,241 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "talk/media/webrtc/webrtcvideoframeview.h"
+
+#include "libyuv/convert_from.h"
+#include "talk/media/base/videocapturer.h"
+#include "talk/media/base/videocommon.h"
+#include "talk/media/webrtc/webrtcvideoframe.h"
+#include "webrtc/base/logging.h"
+
+namespace cricket {
+
+WebRtcVideoFrameView::WebRtcVideoFrameView()
+    : y_plane_(NULL),
+      u_plane_(NULL),
+      v_plane_(NULL),
+      y_pitch_(0),
+      u_pitch_(0),
+      v_pitch_(0),
+      width_(0),
+      height_(0),
+      pixel_width_(1),
+      pixel_height_(1),
+      elapsed_time_(0),
+      time_stamp_(0) {
+}
+
+WebRtcVideoFrameView::~WebRtcVideoFrameView() {}
+
+bool WebRtcVideoFrameView::Init(const CapturedFrame* frame, int dw, int dh) {
+  const int w = frame->width;
+  const int h = frame->height;
+  if (CanonicalFourCC(frame->fourcc) != FOURCC_I420 || frame->rotation != 0 ||
+      !frame->data || w <= 0 || h <= 0 ||
+      frame->data_size < SizeOf(w, h)) {
+    return false;
+  }
+  // Crop the way WebRtcVideoFrame::Reset() does.
+  dw = (dw > 4) ? (dw & ~3) : dw;
+  dh = (dh > 4) ? (dh & ~3) : dh;
+  if (dw <= 0 || dh <= 0 || dw > w || dh > h) {
+    return false;
+  }
+  const int horiz_crop = ((w - dw) / 2) & ~1;
+  const int vert_crop = ((h - dh) / 2) & ~1;
+
+  uint8* y = static_cast<uint8*>(frame->data);
+  const int32 y_pitch = w;
+  const int32 uv_pitch = (w + 1) / 2;
+  uint8* u = y + w * h;
+  uint8* v = u + uv_pitch * ((h + 1) / 2);
+  const int uv_offset = (vert_crop / 2) * uv_pitch + horiz_crop / 2;
+  Init(y + vert_crop * y_pitch + horiz_crop, y_pitch, u + uv_offset, uv_pitch,
+       v + uv_offset, uv_pitch, dw, dh, frame->pixel_width,
+       frame->pixel_height, frame->elapsed_time, frame->time_stamp);
+  return true;
+}
+
+void WebRtcVideoFrameView::Init(
+    uint8* y_plane, int32 y_pitch, uint8* u_plane, int32 u_pitch,
+    uint8* v_plane, int32 v_pitch, int w, int h, size_t pixel_width,
+    size_t pixel_height, int64 elapsed_time, int64 time_stamp) {
+  own_frame_.reset();
+  y_plane_ = y_plane;
+  u_plane_ = u_plane;
+  v_plane_ = v_plane;
+  y_pitch_ = y_pitch;
+  u_pitch_ = u_pitch;
+  v_pitch_ = v_pitch;
+  width_ = w;
+  height_ = h;
+  pixel_width_ = pixel_width;
+  pixel_height_ = pixel_height;
+  elapsed_time_ = elapsed_time;
+  time_stamp_ = time_stamp;
+}
+
+bool WebRtcVideoFrameView::InitToBlack(int w, int h, size_t pixel_width,
+                                       size_t pixel_height, int64 elapsed_time,
+                                       int64 time_stamp) {
+  WebRtcVideoFrame* frame =
+      own_frame_.get() ? own_frame_.release() : new WebRtcVideoFrame();
+  if (!frame->InitToBlack(w, h, pixel_width, pixel_height, elapsed_time,
+                          time_stamp)) {
+    delete frame;
+    return false;
+  }
+  Adopt(frame);
+  return true;
+}
+
+bool WebRtcVideoFrameView::Reset(
+    uint32 format, int w, int h, int dw, int dh, uint8* sample,
+    size_t sample_size, size_t pixel_width, size_t pixel_height,
+    int64 elapsed_time, int64 time_stamp, int rotation) {
+  WebRtcVideoFrame* frame =
+      own_frame_.get() ? own_frame_.release() : new WebRtcVideoFrame();
+  if (!frame->Reset(format, w, h, dw, dh, sample, sample_size, pixel_width,
+                    pixel_height, elapsed_time, time_stamp, rotation)) {
+    delete frame;
+    return false;
+  }
+  Adopt(frame);
+  return true;
+}
+
+VideoFrame* WebRtcVideoFrameView::Copy() const {
+  if (own_frame_.get()) {
+    VideoFrame* copy = own_frame_->Copy();
+    if (copy) {
+      copy->SetElapsedTime(elapsed_time_);
+      copy->SetTimeStamp(time_stamp_);
+    }
+    return copy;
+  }
+  if (!y_plane_) {
+    return NULL;
+  }
+  WebRtcVideoFrameView* copy = new WebRtcVideoFrameView();
+  copy->Init(y_plane_, y_pitch_, u_plane_, u_pitch_, v_plane_, v_pitch_,
+             static_cast<int>(width_), static_cast<int>(height_),
+             pixel_width_, pixel_height_, elapsed_time_, time_stamp_);
+  return copy;
+}
+
+bool WebRtcVideoFrameView::MakeExclusive() {
+  if (own_frame_.get()) {
+    // The frame may move to a buffer of its own.
+    own_frame_->SetElapsedTime(elapsed_time_);
+    own_frame_->SetTimeStamp(time_stamp_);
+    if (!own_frame_->MakeExclusive()) {
+      return false;
+    }
+    Adopt(own_frame_.release());
+    return true;
+  }
+  rtc::scoped_ptr<WebRtcVideoFrame> frame(new WebRtcVideoFrame());
+  if (!frame->InitToBlack(static_cast<int>(width_), static_cast<int>(height_),
+                          pixel_width_, pixel_height_, elapsed_time_,
+                          time_stamp_) ||
+      !CopyToPlanes(frame->GetYPlane(), frame->GetUPlane(),
+                    frame->GetVPlane(), frame->GetYPitch(),
+                    frame->GetUPitch(), frame->GetVPitch())) {
+    return false;
+  }
+  Adopt(frame.release());
+  return true;
+}
+
+size_t WebRtcVideoFrameView::CopyToBuffer(uint8* buffer, size_t size) const {
+  if (!y_plane_) {
+    return 0;
+  }
+
+  size_t needed = SizeOf(width_, height_);
+  if (needed <= size) {
+    const int32 uv_pitch = static_cast<int32>((width_ + 1) / 2);
+    uint8* u = buffer + width_ * height_;
+    uint8* v = u + uv_pitch * GetChromaHeight();
+    CopyToPlanes(buffer, u, v, static_cast<int32>(width_), uv_pitch, uv_pitch);
+  }
+  return needed;
+}
+
+size_t WebRtcVideoFrameView::ConvertToRgbBuffer(uint32 to_fourcc,
+                                                uint8* buffer, size_t size,
+                                                int stride_rgb) const {
+  if (!y_plane_) {
+    return 0;
+  }
+  size_t needed = (stride_rgb >= 0 ? stride_rgb : -stride_rgb) * height_;
+  if (size < needed) {
+    LOG(LS_WARNING) << "RGB buffer is not large enough";
+    return needed;
+  }
+
+  if (libyuv::ConvertFromI420(y_plane_, y_pitch_, u_plane_, u_pitch_,
+                              v_plane_, v_pitch_, buffer, stride_rgb,
+                              static_cast<int>(width_),
+                              static_cast<int>(height_),
+                              to_fourcc)) {
+    LOG(LS_WARNING) << "RGB type not supported: " << to_fourcc;
+    return 0;  // 0 indicates error
+  }
+  return needed;
+}
+
+VideoFrame* WebRtcVideoFrameView::CreateEmptyFrame(
+    int w, int h, size_t pixel_width, size_t pixel_height, int64 elapsed_time,
+    int64 time_stamp) const {
+  WebRtcVideoFrame* frame = new WebRtcVideoFrame();
+  if (!frame->InitToBlack(w, h, pixel_width, pixel_height, elapsed_time,
+                          time_stamp)) {
+    delete frame;
+    return NULL;
+  }
+  return frame;
+}
+
+void WebRtcVideoFrameView::Adopt(WebRtcVideoFrame* frame) {
+  own_frame_.reset(frame);
+  y_plane_ = frame->GetYPlane();
+  u_plane_ = frame->GetUPlane();
+  v_plane_ = frame->GetVPlane();
+  y_pitch_ = frame->GetYPitch();
+  u_pitch_ = frame->GetUPitch();
+  v_pitch_ = frame->GetVPitch();
+  width_ = frame->GetWidth();
+  height_ = frame->GetHeight();
+  pixel_width_ = frame->GetPixelWidth();
+  pixel_height_ = frame->GetPixelHeight();
+  elapsed_time_ = frame->GetElapsedTime();
+  time_stamp_ = frame->GetTimeStamp();
+}
+
+}  // namespace cricket
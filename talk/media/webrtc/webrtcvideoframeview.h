@@ -0,0 +1,126 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMEVIEW_H_
+#define TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMEVIEW_H_
+
+#include "talk/media/base/videoframe.h"
+#include "webrtc/base/scoped_ptr.h"
+
+namespace cricket {
+
+struct CapturedFrame;
+class WebRtcVideoFrame;
+
+// A video frame which refers to I420 planes that belong to someone else, such
+// as the center of a captured frame that is to be cropped, without copying
+// them. The planes must outlive the view and its copies, unless the view has
+// been given a buffer of its own by InitToBlack(), Reset() or MakeExclusive().
+class WebRtcVideoFrameView : public VideoFrame {
+ public:
+  WebRtcVideoFrameView();
+  virtual ~WebRtcVideoFrameView();
+
+  // Refers to the |dw| x |dh| center of |frame|, cropped the way
+  // WebRtcVideoFrame::Init() crops it. Returns false if |frame| isn't an
+  // upright I420 frame.
+  bool Init(const CapturedFrame* frame, int dw, int dh);
+
+  // Refers to the given planes of a |w| x |h| image.
+  void Init(uint8* y_plane, int32 y_pitch, uint8* u_plane, int32 u_pitch,
+            uint8* v_plane, int32 v_pitch, int w, int h, size_t pixel_width,
+            size_t pixel_height, int64 elapsed_time, int64 time_stamp);
+
+  // From base class VideoFrame.
+  virtual bool InitToBlack(int w, int h, size_t pixel_width,
+                           size_t pixel_height, int64 elapsed_time,
+                           int64 time_stamp);
+  virtual bool Reset(uint32 format, int w, int h, int dw, int dh, uint8* sample,
+                     size_t sample_size, size_t pixel_width,
+                     size_t pixel_height, int64 elapsed_time, int64 time_stamp,
+                     int rotation);
+
+  virtual size_t GetWidth() const { return width_; }
+  virtual size_t GetHeight() const { return height_; }
+  virtual const uint8* GetYPlane() const { return y_plane_; }
+  virtual const uint8* GetUPlane() const { return u_plane_; }
+  virtual const uint8* GetVPlane() const { return v_plane_; }
+  virtual uint8* GetYPlane() { return y_plane_; }
+  virtual uint8* GetUPlane() { return u_plane_; }
+  virtual uint8* GetVPlane() { return v_plane_; }
+  virtual int32 GetYPitch() const { return y_pitch_; }
+  virtual int32 GetUPitch() const { return u_pitch_; }
+  virtual int32 GetVPitch() const { return v_pitch_; }
+  virtual void* GetNativeHandle() const { return NULL; }
+
+  virtual size_t GetPixelWidth() const { return pixel_width_; }
+  virtual size_t GetPixelHeight() const { return pixel_height_; }
+  virtual int64 GetElapsedTime() const { return elapsed_time_; }
+  virtual int64 GetTimeStamp() const { return time_stamp_; }
+  virtual void SetElapsedTime(int64 elapsed_time) {
+    elapsed_time_ = elapsed_time;
+  }
+  virtual void SetTimeStamp(int64 time_stamp) { time_stamp_ = time_stamp; }
+
+  virtual int GetRotation() const { return ROTATION_0; }
+
+  virtual VideoFrame* Copy() const;
+  virtual bool MakeExclusive();
+  virtual size_t CopyToBuffer(uint8* buffer, size_t size) const;
+  virtual size_t ConvertToRgbBuffer(uint32 to_fourcc, uint8* buffer,
+                                    size_t size, int stride_rgb) const;
+
+ protected:
+  virtual VideoFrame* CreateEmptyFrame(int w, int h, size_t pixel_width,
+                                       size_t pixel_height, int64 elapsed_time,
+                                       int64 time_stamp) const;
+
+ private:
+  // Refers to the planes of |frame| from now on, and keeps it.
+  void Adopt(WebRtcVideoFrame* frame);
+
+  uint8* y_plane_;
+  uint8* u_plane_;
+  uint8* v_plane_;
+  int32 y_pitch_;
+  int32 u_pitch_;
+  int32 v_pitch_;
+  size_t width_;
+  size_t height_;
+  size_t pixel_width_;
+  size_t pixel_height_;
+  int64 elapsed_time_;
+  int64 time_stamp_;
+  // The buffer of the view, if it has one of its own.
+  rtc::scoped_ptr<WebRtcVideoFrame> own_frame_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebRtcVideoFrameView);
+};
+
+}  // namespace cricket
+
+#endif  // TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMEVIEW_H_
@@ -0,0 +1,144 @@
+/*
+ * libjingle
+ * Copyright 2014 Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+
+#include "talk/media/base/videocapturer.h"
+#include "talk/media/base/videocommon.h"
+#include "talk/media/webrtc/webrtcvideoframe.h"
+#include "talk/media/webrtc/webrtcvideoframefactory.h"
+#include "talk/media/webrtc/webrtcvideoframeview.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/scoped_ptr.h"
+
+static const int kWidth = 640;
+static const int kHeight = 480;
+
+class WebRtcVideoFrameViewTest : public testing::Test {
+ public:
+  WebRtcVideoFrameViewTest()
+      : buffer_(new uint8[cricket::VideoFrame::SizeOf(kWidth, kHeight)]) {
+    const size_t size = cricket::VideoFrame::SizeOf(kWidth, kHeight);
+    // Every row of the Y plane has its own value and every row of the U and
+    // V planes too.
+    for (size_t i = 0; i < size; ++i) {
+      buffer_[i] = static_cast<uint8>(i / kWidth);
+    }
+    captured_frame_.fourcc = cricket::FOURCC_I420;
+    captured_frame_.width = kWidth;
+    captured_frame_.height = kHeight;
+    captured_frame_.pixel_width = 1;
+    captured_frame_.pixel_height = 1;
+    captured_frame_.elapsed_time = 1234;
+    captured_frame_.time_stamp = 5678;
+    captured_frame_.data_size = static_cast<uint32>(size);
+    captured_frame_.data = buffer_.get();
+  }
+
+ protected:
+  rtc::scoped_ptr<uint8[]> buffer_;
+  cricket::CapturedFrame captured_frame_;
+};
+
+TEST_F(WebRtcVideoFrameViewTest, InitRefersToCroppedPlanes) {
+  cricket::WebRtcVideoFrameView view;
+  ASSERT_TRUE(view.Init(&captured_frame_, 480, 360));
+  EXPECT_EQ(480u, view.GetWidth());
+  EXPECT_EQ(360u, view.GetHeight());
+  EXPECT_EQ(kWidth, view.GetYPitch());
+  EXPECT_EQ(kWidth / 2, view.GetUPitch());
+  EXPECT_EQ(kWidth / 2, view.GetVPitch());
+  EXPECT_EQ(1234, view.GetElapsedTime());
+  EXPECT_EQ(5678, view.GetTimeStamp());
+
+  const uint8* y = buffer_.get();
+  const uint8* u = y + kWidth * kHeight;
+  const uint8* v = u + (kWidth / 2) * (kHeight / 2);
+  EXPECT_EQ(y + 60 * kWidth + 80, view.GetYPlane());
+  EXPECT_EQ(u + 30 * (kWidth / 2) + 40, view.GetUPlane());
+  EXPECT_EQ(v + 30 * (kWidth / 2) + 40, view.GetVPlane());
+}
+
+TEST_F(WebRtcVideoFrameViewTest, InitFailsForOtherFormats) {
+  cricket::WebRtcVideoFrameView view;
+  captured_frame_.fourcc = cricket::FOURCC_YUY2;
+  EXPECT_FALSE(view.Init(&captured_frame_, 480, 360));
+  captured_frame_.fourcc = cricket::FOURCC_I420;
+  captured_frame_.rotation = 90;
+  EXPECT_FALSE(view.Init(&captured_frame_, 480, 360));
+}
+
+TEST_F(WebRtcVideoFrameViewTest, CopyToBufferMatchesConvertedFrame) {
+  cricket::WebRtcVideoFrameView view;
+  ASSERT_TRUE(view.Init(&captured_frame_, 480, 360));
+  cricket::WebRtcVideoFrame frame;
+  ASSERT_TRUE(frame.Init(&captured_frame_, 480, 360));
+
+  const size_t size = cricket::VideoFrame::SizeOf(480, 360);
+  rtc::scoped_ptr<uint8[]> view_buffer(new uint8[size]);
+  rtc::scoped_ptr<uint8[]> frame_buffer(new uint8[size]);
+  EXPECT_EQ(size, view.CopyToBuffer(view_buffer.get(), size));
+  EXPECT_EQ(size, frame.CopyToBuffer(frame_buffer.get(), size));
+  EXPECT_EQ(0, memcmp(view_buffer.get(), frame_buffer.get(), size));
+}
+
+TEST_F(WebRtcVideoFrameViewTest, MakeExclusiveCopiesPlanes) {
+  cricket::WebRtcVideoFrameView view;
+  ASSERT_TRUE(view.Init(&captured_frame_, 480, 360));
+  const uint8 y_value = *view.GetYPlane();
+  ASSERT_TRUE(view.MakeExclusive());
+  EXPECT_EQ(480u, view.GetWidth());
+  EXPECT_EQ(360u, view.GetHeight());
+  EXPECT_EQ(1234, view.GetElapsedTime());
+  memset(buffer_.get(), 0, cricket::VideoFrame::SizeOf(kWidth, kHeight));
+  EXPECT_EQ(y_value, *view.GetYPlane());
+}
+
+TEST_F(WebRtcVideoFrameViewTest, FactoryReusesReleasedBuffer) {
+  cricket::WebRtcVideoFrameFactory factory;
+  // Convert to another format so that the factory has to allocate.
+  rtc::scoped_ptr<uint8[]> yuy2(new uint8[kWidth * kHeight * 2]);
+  memset(yuy2.get(), 0x80, kWidth * kHeight * 2);
+  captured_frame_.fourcc = cricket::FOURCC_YUY2;
+  captured_frame_.data_size = kWidth * kHeight * 2;
+  captured_frame_.data = yuy2.get();
+
+  rtc::scoped_ptr<cricket::VideoFrame> frame(
+      factory.CreateAliasedFrame(&captured_frame_, kWidth, kHeight));
+  ASSERT_TRUE(frame.get() != NULL);
+  const uint8* y_plane = frame->GetYPlane();
+  frame.reset();
+  frame.reset(factory.CreateAliasedFrame(&captured_frame_, kWidth, kHeight));
+  ASSERT_TRUE(frame.get() != NULL);
+  EXPECT_EQ(y_plane, frame->GetYPlane());
+
+  // A frame which is still held keeps its buffer.
+  rtc::scoped_ptr<cricket::VideoFrame> next_frame(
+      factory.CreateAliasedFrame(&captured_frame_, kWidth, kHeight));
+  ASSERT_TRUE(next_frame.get() != NULL);
+  EXPECT_NE(frame->GetYPlane(), next_frame->GetYPlane());
+}
@@ -366,6 +366,8 @@ WebRtcVoiceEngine::WebRtcVoiceEngine(VoEWrapper* voe_wrapper,
 void WebRtcVoiceEngine::Construct() {
   SetTraceFilter(log_filter_);
   initialized_ = false;
+  init_pending_ = false;
+  pending_set_devices_ = false;
   LOG(LS_VERBOSE) << "WebRtcVoiceEngine::WebRtcVoiceEngine";
   SetTraceOptions("");
   if (tracing_->SetTraceCallback(this) == -1) {
@@ -440,55 +442,61 @@ static void SetOpusFec(AudioCodec* codec, bool opus_fec) {
 }
 
 void WebRtcVoiceEngine::ConstructCodecs() {
-  LOG(LS_INFO) << "WebRtc VoiceEngine codecs:";
   int ncodecs = voe_wrapper_->codec()->NumOfCodecs();
   for (int i = 0; i < ncodecs; ++i) {
     webrtc::CodecInst voe_codec;
     if (voe_wrapper_->codec()->GetCodec(i, voe_codec) != -1) {
-      // Skip uncompressed formats.
-      if (_stricmp(voe_codec.plname, kL16CodecName) == 0) {
-        continue;
-      }
+      voe_codecs_.push_back(voe_codec);
+    }
+  }
 
-      const CodecPref* pref = NULL;
-      for (size_t j = 0; j < ARRAY_SIZE(kCodecPrefs); ++j) {
-        if (_stricmp(kCodecPrefs[j].name, voe_codec.plname) == 0 &&
-            kCodecPrefs[j].clockrate == voe_codec.plfreq &&
-            kCodecPrefs[j].channels == voe_codec.channels) {
-          pref = &kCodecPrefs[j];
-          break;
-        }
+  LOG(LS_INFO) << "WebRtc VoiceEngine codecs:";
+  for (std::vector<webrtc::CodecInst>::const_iterator it = voe_codecs_.begin();
+       it != voe_codecs_.end(); ++it) {
+    const webrtc::CodecInst& voe_codec = *it;
+    // Skip uncompressed formats.
+    if (_stricmp(voe_codec.plname, kL16CodecName) == 0) {
+      continue;
+    }
+
+    const CodecPref* pref = NULL;
+    for (size_t j = 0; j < ARRAY_SIZE(kCodecPrefs); ++j) {
+      if (_stricmp(kCodecPrefs[j].name, voe_codec.plname) == 0 &&
+          kCodecPrefs[j].clockrate == voe_codec.plfreq &&
+          kCodecPrefs[j].channels == voe_codec.channels) {
+        pref = &kCodecPrefs[j];
+        break;
       }
+    }
 
-      if (pref) {
-        // Use the payload type that we've configured in our pref table;
-        // use the offset in our pref table to determine the sort order.
-        AudioCodec codec(pref->payload_type, voe_codec.plname, voe_codec.plfreq,
-                         voe_codec.rate, voe_codec.channels,
-                         ARRAY_SIZE(kCodecPrefs) - (pref - kCodecPrefs));
-        LOG(LS_INFO) << ToString(codec);
-        if (IsIsac(codec)) {
-          // Indicate auto-bandwidth in signaling.
-          codec.bitrate = 0;
+    if (pref) {
+      // Use the payload type that we've configured in our pref table;
+      // use the offset in our pref table to determine the sort order.
+      AudioCodec codec(pref->payload_type, voe_codec.plname, voe_codec.plfreq,
+                       voe_codec.rate, voe_codec.channels,
+                       ARRAY_SIZE(kCodecPrefs) - (pref - kCodecPrefs));
+      LOG(LS_INFO) << ToString(codec);
+      if (IsIsac(codec)) {
+        // Indicate auto-bandwidth in signaling.
+        codec.bitrate = 0;
+      }
+      if (IsOpus(codec)) {
+        // Only add fmtp parameters that differ from the spec.
+        if (kPreferredMinPTime != kOpusDefaultMinPTime) {
+          codec.params[kCodecParamMinPTime] =
+              rtc::ToString(kPreferredMinPTime);
         }
-        if (IsOpus(codec)) {
-          // Only add fmtp parameters that differ from the spec.
-          if (kPreferredMinPTime != kOpusDefaultMinPTime) {
-            codec.params[kCodecParamMinPTime] =
-                rtc::ToString(kPreferredMinPTime);
-          }
-          if (kPreferredMaxPTime != kOpusDefaultMaxPTime) {
-            codec.params[kCodecParamMaxPTime] =
-                rtc::ToString(kPreferredMaxPTime);
-          }
-          // TODO(hellner): Add ptime, sprop-stereo, stereo and useinbandfec
-          // when they can be set to values other than the default.
-          SetOpusFec(&codec, false);
+        if (kPreferredMaxPTime != kOpusDefaultMaxPTime) {
+          codec.params[kCodecParamMaxPTime] =
+              rtc::ToString(kPreferredMaxPTime);
         }
-        codecs_.push_back(codec);
-      } else {
-        LOG(LS_WARNING) << "Unexpected codec: " << ToString(voe_codec);
+        // TODO(hellner): Add ptime, sprop-stereo, stereo and useinbandfec
+        // when they can be set to values other than the default.
+        SetOpusFec(&codec, false);
       }
+      codecs_.push_back(codec);
+    } else {
+      LOG(LS_WARNING) << "Unexpected codec: " << ToString(voe_codec);
     }
   }
   // Make sure they are in local preference order.
@@ -520,12 +528,26 @@ WebRtcVoiceEngine::~WebRtcVoiceEngine() {
 
 bool WebRtcVoiceEngine::Init(rtc::Thread* worker_thread) {
   LOG(LS_INFO) << "WebRtcVoiceEngine::Init";
+  init_pending_ = true;
+  return true;
+}
+
+bool WebRtcVoiceEngine::EnsureInit() {
+  if (initialized_) {
+    return true;
+  }
+  if (!init_pending_) {
+    LOG(LS_ERROR) << "WebRtcVoiceEngine used before Init";
+    return false;
+  }
+  // Note that, if initialization fails, init_pending_ stays set, so that the
+  // next channel tries again.
   bool res = InitInternal();
   if (res) {
     LOG(LS_INFO) << "WebRtcVoiceEngine::Init Done!";
   } else {
     LOG(LS_ERROR) << "WebRtcVoiceEngine::Init failed";
-    Terminate();
+    voe_wrapper_->base()->Terminate();
   }
   return res;
 }
@@ -562,8 +584,13 @@ bool WebRtcVoiceEngine::InitInternal() {
 
   // Set defaults for options, so that ApplyOptions applies them explicitly
   // when we clear option (channel) overrides. External clients can still
-  // modify the defaults via SetOptions (on the media engine).
-  if (!SetOptions(GetDefaultEngineOptions())) {
+  // modify the defaults via SetOptions (on the media engine), and the options
+  // set before the VoiceEngine was initialized are applied on top.
+  if (!ApplyOptions(GetDefaultEngineOptions()) || !ApplyOptions(options_)) {
+    return false;
+  }
+  if (!(option_overrides_ == AudioOptions()) &&
+      !ApplyOptions(option_overrides_)) {
     return false;
   }
 
@@ -581,9 +608,35 @@ bool WebRtcVoiceEngine::InitInternal() {
   }
 
   initialized_ = true;
+  init_pending_ = false;
+
+  // Apply the settings made while the initialization was pending.
+  if (pending_set_devices_ &&
+      !SetDevices(pending_in_device_.get(), pending_out_device_.get())) {
+    LOG(LS_WARNING) << "Failed to set the pending audio devices";
+  }
+  int value;
+  if (pending_delay_offset_.Get(&value) && !SetDelayOffset(value)) {
+    LOG(LS_WARNING) << "Failed to set the pending delay offset " << value;
+  }
+  if (pending_output_volume_.Get(&value) && !SetOutputVolume(value)) {
+    LOG(LS_WARNING) << "Failed to set the pending output volume " << value;
+  }
+  if (desired_local_monitor_enable_ && !ChangeLocalMonitor(true)) {
+    LOG(LS_WARNING) << "Failed to start the local monitor";
+  }
+  ClearPendingSettings();
   return true;
 }
 
+void WebRtcVoiceEngine::ClearPendingSettings() {
+  pending_set_devices_ = false;
+  pending_in_device_.reset();
+  pending_out_device_.reset();
+  pending_delay_offset_.Clear();
+  pending_output_volume_.Clear();
+}
+
 bool WebRtcVoiceEngine::EnsureSoundclipEngineInit() {
   if (voe_wrapper_sc_initialized_) {
     return true;
@@ -632,6 +685,8 @@ bool WebRtcVoiceEngine::EnsureSoundclipEngineInit() {
 void WebRtcVoiceEngine::Terminate() {
   LOG(LS_INFO) << "WebRtcVoiceEngine::Terminate";
   initialized_ = false;
+  init_pending_ = false;
+  ClearPendingSettings();
 
   StopAecDump();
 
@@ -648,6 +703,9 @@ int WebRtcVoiceEngine::GetCapabilities() {
 }
 
 VoiceMediaChannel *WebRtcVoiceEngine::CreateChannel() {
+  if (init_pending_ && !EnsureInit()) {
+    return NULL;
+  }
   WebRtcVoiceMediaChannel* ch = new WebRtcVoiceMediaChannel(this);
   if (!ch->valid()) {
     delete ch;
@@ -671,6 +729,10 @@ SoundclipMedia *WebRtcVoiceEngine::CreateSoundclip() {
 }
 
 bool WebRtcVoiceEngine::SetOptions(const AudioOptions& options) {
+  if (init_pending_) {
+    options_ = options;
+    return true;
+  }
   if (!ApplyOptions(options)) {
     return false;
   }
@@ -680,6 +742,10 @@ bool WebRtcVoiceEngine::SetOptions(const AudioOptions& options) {
 
 bool WebRtcVoiceEngine::SetOptionOverrides(const AudioOptions& overrides) {
   LOG(LS_INFO) << "Setting option overrides: " << overrides.ToString();
+  if (init_pending_) {
+    option_overrides_ = overrides;
+    return true;
+  }
   if (!ApplyOptions(overrides)) {
     return false;
   }
@@ -689,6 +755,10 @@ bool WebRtcVoiceEngine::SetOptionOverrides(const AudioOptions& overrides) {
 
 bool WebRtcVoiceEngine::ClearOptionOverrides() {
   LOG(LS_INFO) << "Clearing option overrides.";
+  if (init_pending_) {
+    option_overrides_ = AudioOptions();
+    return true;
+  }
   AudioOptions options = options_;
   // Only call ApplyOptions if |options_overrides_| contains overrided options.
   // ApplyOptions affects NS, AGC other options that is shared between
@@ -930,6 +1000,10 @@ bool WebRtcVoiceEngine::ApplyOptions(const AudioOptions& options_in) {
 }
 
 bool WebRtcVoiceEngine::SetDelayOffset(int offset) {
+  if (init_pending_) {
+    pending_delay_offset_.Set(offset);
+    return true;
+  }
   voe_wrapper_->processing()->SetDelayOffsetMs(offset);
   if (voe_wrapper_->processing()->DelayOffsetMs() != offset) {
     LOG_RTCERR1(SetDelayOffsetMs, offset);
@@ -956,6 +1030,13 @@ struct ResumeEntry {
 bool WebRtcVoiceEngine::SetDevices(const Device* in_device,
                                    const Device* out_device) {
 #if !defined(IOS)
+  if (init_pending_) {
+    pending_set_devices_ = true;
+    pending_in_device_.reset(in_device ? new Device(*in_device) : NULL);
+    pending_out_device_.reset(out_device ? new Device(*out_device) : NULL);
+    return true;
+  }
+
   int in_id = in_device ? rtc::FromString<int>(in_device->id) :
       kDefaultAudioDeviceId;
   int out_id = out_device ? rtc::FromString<int>(out_device->id) :
@@ -1109,6 +1190,12 @@ bool WebRtcVoiceEngine::FindWebRtcAudioDeviceId(
 }
 
 bool WebRtcVoiceEngine::GetOutputVolume(int* level) {
+  if (init_pending_ && pending_output_volume_.Get(level)) {
+    return true;
+  }
+  if (init_pending_ && !EnsureInit()) {
+    return false;
+  }
   unsigned int ulevel;
   if (voe_wrapper_->volume()->GetSpeakerVolume(ulevel) == -1) {
     LOG_RTCERR1(GetSpeakerVolume, level);
@@ -1120,6 +1207,10 @@ bool WebRtcVoiceEngine::GetOutputVolume(int* level) {
 
 bool WebRtcVoiceEngine::SetOutputVolume(int level) {
   ASSERT(level >= 0 && level <= 255);
+  if (init_pending_) {
+    pending_output_volume_.Set(level);
+    return true;
+  }
   if (voe_wrapper_->volume()->SetSpeakerVolume(level) == -1) {
     LOG_RTCERR1(SetSpeakerVolume, level);
     return false;
@@ -1128,6 +1219,10 @@ bool WebRtcVoiceEngine::SetOutputVolume(int level) {
 }
 
 int WebRtcVoiceEngine::GetInputLevel() {
+  // Nothing is captured before the VoiceEngine is initialized.
+  if (init_pending_) {
+    return 0;
+  }
   unsigned int ulevel;
   return (voe_wrapper_->volume()->GetSpeechInputLevel(ulevel) != -1) ?
       static_cast<int>(ulevel) : -1;
@@ -1135,6 +1230,12 @@ int WebRtcVoiceEngine::GetInputLevel() {
 
 bool WebRtcVoiceEngine::SetLocalMonitor(bool enable) {
   desired_local_monitor_enable_ = enable;
+  if (init_pending_ && !enable) {
+    return true;
+  }
+  if (init_pending_ && !EnsureInit()) {
+    return false;
+  }
   return ChangeLocalMonitor(desired_local_monitor_enable_);
 }
 
@@ -1180,38 +1281,36 @@ bool WebRtcVoiceEngine::FindCodec(const AudioCodec& in) {
 // Get the VoiceEngine codec that matches |in|, with the supplied settings.
 bool WebRtcVoiceEngine::FindWebRtcCodec(const AudioCodec& in,
                                         webrtc::CodecInst* out) {
-  int ncodecs = voe_wrapper_->codec()->NumOfCodecs();
-  for (int i = 0; i < ncodecs; ++i) {
-    webrtc::CodecInst voe_codec;
-    if (voe_wrapper_->codec()->GetCodec(i, voe_codec) != -1) {
-      AudioCodec codec(voe_codec.pltype, voe_codec.plname, voe_codec.plfreq,
-                       voe_codec.rate, voe_codec.channels, 0);
-      bool multi_rate = IsCodecMultiRate(voe_codec);
-      // Allow arbitrary rates for ISAC to be specified.
-      if (multi_rate) {
-        // Set codec.bitrate to 0 so the check for codec.Matches() passes.
-        codec.bitrate = 0;
-      }
-      if (codec.Matches(in)) {
-        if (out) {
-          // Fixup the payload type.
-          voe_codec.pltype = in.id;
-
-          // Set bitrate if specified.
-          if (multi_rate && in.bitrate != 0) {
-            voe_codec.rate = in.bitrate;
-          }
+  for (std::vector<webrtc::CodecInst>::const_iterator it = voe_codecs_.begin();
+       it != voe_codecs_.end(); ++it) {
+    webrtc::CodecInst voe_codec = *it;
+    AudioCodec codec(voe_codec.pltype, voe_codec.plname, voe_codec.plfreq,
+                     voe_codec.rate, voe_codec.channels, 0);
+    bool multi_rate = IsCodecMultiRate(voe_codec);
+    // Allow arbitrary rates for ISAC to be specified.
+    if (multi_rate) {
+      // Set codec.bitrate to 0 so the check for codec.Matches() passes.
+      codec.bitrate = 0;
+    }
+    if (codec.Matches(in)) {
+      if (out) {
+        // Fixup the payload type.
+        voe_codec.pltype = in.id;
+
+        // Set bitrate if specified.
+        if (multi_rate && in.bitrate != 0) {
+          voe_codec.rate = in.bitrate;
+        }
 
-          // Apply codec-specific settings.
-          if (IsIsac(codec)) {
-            // If ISAC and an explicit bitrate is not specified,
-            // enable auto bandwidth adjustment.
-            voe_codec.rate = (in.bitrate > 0) ? in.bitrate : -1;
-          }
-          *out = voe_codec;
+        // Apply codec-specific settings.
+        if (IsIsac(codec)) {
+          // If ISAC and an explicit bitrate is not specified,
+          // enable auto bandwidth adjustment.
+          voe_codec.rate = (in.bitrate > 0) ? in.bitrate : -1;
         }
-        return true;
+        *out = voe_codec;
       }
+      return true;
     }
   }
   return false;
@@ -1450,7 +1549,7 @@ bool WebRtcVoiceEngine::AdjustAgcLevel(int delta) {
 
 bool WebRtcVoiceEngine::SetAudioDeviceModule(webrtc::AudioDeviceModule* adm,
     webrtc::AudioDeviceModule* adm_sc) {
-  if (initialized_) {
+  if (initialized_ || init_pending_) {
     LOG(LS_WARNING) << "SetAudioDeviceModule can not be called after Init.";
     return false;
   }
@@ -1475,6 +1574,11 @@ bool WebRtcVoiceEngine::SetAudioDeviceModule(webrtc::AudioDeviceModule* adm,
 }
 
 bool WebRtcVoiceEngine::StartAecDump(rtc::PlatformFile file) {
+  if (init_pending_ && !EnsureInit()) {
+    if (!rtc::ClosePlatformFile(file))
+      LOG(LS_WARNING) << "Could not close file.";
+    return false;
+  }
   FILE* aec_dump_file_stream = rtc::FdopenPlatformFileForWriting(file);
   if (!aec_dump_file_stream) {
     LOG(LS_ERROR) << "Could not open AEC dump file stream.";
@@ -3535,16 +3639,15 @@ bool WebRtcVoiceMediaChannel::EnableRtcp(int channel) {
 }
 
 bool WebRtcVoiceMediaChannel::ResetRecvCodecs(int channel) {
-  int ncodecs = engine()->voe()->codec()->NumOfCodecs();
-  for (int i = 0; i < ncodecs; ++i) {
-    webrtc::CodecInst voe_codec;
-    if (engine()->voe()->codec()->GetCodec(i, voe_codec) != -1) {
-      voe_codec.pltype = -1;
-      if (engine()->voe()->codec()->SetRecPayloadType(
-          channel, voe_codec) == -1) {
-        LOG_RTCERR2(SetRecPayloadType, channel, ToString(voe_codec));
-        return false;
-      }
+  const std::vector<webrtc::CodecInst>& voe_codecs = engine()->voe_codecs();
+  for (std::vector<webrtc::CodecInst>::const_iterator it = voe_codecs.begin();
+       it != voe_codecs.end(); ++it) {
+    webrtc::CodecInst voe_codec = *it;
+    voe_codec.pltype = -1;
+    if (engine()->voe()->codec()->SetRecPayloadType(
+        channel, voe_codec) == -1) {
+      LOG_RTCERR2(SetRecPayloadType, channel, ToString(voe_codec));
+      return false;
     }
   }
   return true;
@@ -101,6 +101,9 @@ class WebRtcVoiceEngine
                     VoEWrapper* voe_wrapper_sc,
                     VoETraceWrapper* tracing);
   ~WebRtcVoiceEngine();
+  // Does not initialize the VoiceEngine yet, which opens the audio devices.
+  // That is left to the first channel, and the device, volume and option
+  // settings made until then are applied at that point.
   bool Init(rtc::Thread* worker_thread);
   void Terminate();
 
@@ -169,6 +172,9 @@ class WebRtcVoiceEngine
   bool AdjustAgcLevel(int delta);
 
   VoEWrapper* voe() { return voe_wrapper_.get(); }
+  const std::vector<webrtc::CodecInst>& voe_codecs() const {
+    return voe_codecs_;
+  }
   VoEWrapper* voe_sc() { return voe_wrapper_sc_.get(); }
   int GetLastEngineError();
 
@@ -195,6 +201,9 @@ class WebRtcVoiceEngine
   void Construct();
   void ConstructCodecs();
   bool InitInternal();
+  // Initializes the VoiceEngine if Init() was called and it is not yet.
+  bool EnsureInit();
+  void ClearPendingSettings();
   bool EnsureSoundclipEngineInit();
   void SetTraceFilter(int filter);
   void SetTraceOptions(const std::string& options);
@@ -248,6 +257,8 @@ class WebRtcVoiceEngine
   int log_filter_;
   std::string log_options_;
   bool is_dumping_aec_;
+  // The codecs of the VoiceEngine, which are enumerated once.
+  std::vector<webrtc::CodecInst> voe_codecs_;
   std::vector<AudioCodec> codecs_;
   std::vector<RtpHeaderExtension> rtp_header_extensions_;
   bool desired_local_monitor_enable_;
@@ -262,6 +273,14 @@ class WebRtcVoiceEngine
   webrtc::Config voe_config_;
 
   bool initialized_;
+  // Set by Init() until the VoiceEngine is initialized by EnsureInit(). The
+  // settings made in the meantime are kept to be applied by InitInternal().
+  bool init_pending_;
+  bool pending_set_devices_;
+  rtc::scoped_ptr<Device> pending_in_device_;
+  rtc::scoped_ptr<Device> pending_out_device_;
+  Settable<int> pending_delay_offset_;
+  Settable<int> pending_output_volume_;
   // See SetOptions and SetOptionOverrides for a description of the
   // difference between options and overrides.
   // options_ are the base options, which combined with the
@@ -352,14 +352,43 @@ TEST_F(WebRtcVoiceEngineTestFake, StartupShutdown) {
   EXPECT_FALSE(voe_.IsInited());
   EXPECT_FALSE(voe_sc_.IsInited());
   EXPECT_TRUE(engine_.Init(rtc::Thread::Current()));
+  // The engine is lazily initialized for the first channel, as is the
+  // soundclip engine for the first soundclip.
+  EXPECT_FALSE(voe_.IsInited());
+  channel_ = engine_.CreateChannel();
+  EXPECT_TRUE(channel_ != NULL);
   EXPECT_TRUE(voe_.IsInited());
-  // The soundclip engine is lazily initialized.
   EXPECT_FALSE(voe_sc_.IsInited());
+  delete channel_;
+  channel_ = NULL;
   engine_.Terminate();
   EXPECT_FALSE(voe_.IsInited());
   EXPECT_FALSE(voe_sc_.IsInited());
 }
 
+// Tests that the options set before the first channel are applied when the
+// engine is initialized for it.
+TEST_F(WebRtcVoiceEngineTestFake, SetOptionsBeforeFirstChannel) {
+  EXPECT_TRUE(engine_.Init(rtc::Thread::Current()));
+  cricket::AudioOptions options;
+  options.echo_cancellation.Set(false);
+  options.noise_suppression.Set(false);
+  EXPECT_TRUE(engine_.SetOptions(options));
+  EXPECT_FALSE(voe_.IsInited());
+
+  channel_ = engine_.CreateChannel();
+  EXPECT_TRUE(channel_ != NULL);
+  bool ec_enabled;
+  webrtc::EcModes ec_mode;
+  bool ns_enabled;
+  webrtc::NsModes ns_mode;
+  voe_.GetEcStatus(ec_enabled, ec_mode);
+  voe_.GetNsStatus(ns_enabled, ns_mode);
+  EXPECT_FALSE(ec_enabled);
+  EXPECT_FALSE(ns_enabled);
+  EXPECT_TRUE(engine_.GetOptions() == options);
+}
+
 // Tests that we can create and destroy a channel.
 TEST_F(WebRtcVoiceEngineTestFake, CreateChannel) {
   EXPECT_TRUE(engine_.Init(rtc::Thread::Current()));
@@ -3037,6 +3066,8 @@ TEST(WebRtcVoiceEngineTest, HasNoMonitorThread) {
   rtc::LogMessage::AddLogToStream(stream.get(), rtc::LS_VERBOSE);
   engine.SetLogging(rtc::LS_VERBOSE, "");
   EXPECT_TRUE(engine.Init(rtc::Thread::Current()));
+  // The VoiceEngine is initialized for the first channel.
+  delete engine.CreateChannel();
   engine.Terminate();
   rtc::LogMessage::RemoveLogToStream(stream.get());
 
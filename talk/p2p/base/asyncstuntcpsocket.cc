@@ -83,13 +83,19 @@ int AsyncStunTCPSocket::Send(const void *pv, size_t cb,
   if (cb != expected_pkt_len)
     return -1;
 
-  AppendToOutBuffer(pv, cb);
+  int res;
+  if (pad_bytes == 0) {
+    // Nothing to add to the packet, so it goes out without a copy.
+    res = SendUnbuffered(pv, cb);
+  } else {
+    AppendToOutBuffer(pv, cb);
 
-  ASSERT(pad_bytes < 4);
-  char padding[4] = {0};
-  AppendToOutBuffer(padding, pad_bytes);
+    ASSERT(pad_bytes < 4);
+    char padding[4] = {0};
+    AppendToOutBuffer(padding, pad_bytes);
 
-  int res = FlushOutBuffer();
+    res = FlushOutBuffer();
+  }
   if (res <= 0) {
     // drop packet if we made no progress
     ClearOutBuffer();
@@ -112,26 +118,29 @@ void AsyncStunTCPSocket::ProcessInput(char* data, size_t* len) {
   // |         Channel Number        |            Length             |
   // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 
-  while (true) {
-    // We need at least 4 bytes to read the STUN or ChannelData packet length.
-    if (*len < kPacketLenOffset + kPacketLenSize)
-      return;
-
+  // The packets are signaled from where they are in the buffer, and only the
+  // incomplete one at the end is moved to the front afterwards.
+  size_t pos = 0;
+  // We need at least 4 bytes to read the STUN or ChannelData packet length.
+  while (*len - pos >= kPacketLenOffset + kPacketLenSize) {
     int pad_bytes;
-    size_t expected_pkt_len = GetExpectedLength(data, *len, &pad_bytes);
+    size_t expected_pkt_len =
+        GetExpectedLength(data + pos, *len - pos, &pad_bytes);
     size_t actual_length = expected_pkt_len + pad_bytes;
 
-    if (*len < actual_length) {
-      return;
+    if (*len - pos < actual_length) {
+      break;
     }
 
-    SignalReadPacket(this, data, expected_pkt_len, remote_addr,
+    SignalReadPacket(this, data + pos, expected_pkt_len, remote_addr,
                      rtc::CreatePacketTime(0));
 
-    *len -= actual_length;
-    if (*len > 0) {
-      memmove(data, data + actual_length, *len);
-    }
+    pos += actual_length;
+  }
+
+  *len -= pos;
+  if (pos > 0 && *len > 0) {
+    memmove(data, data + pos, *len);
   }
 }
 
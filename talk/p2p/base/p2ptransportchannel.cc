@@ -130,6 +130,16 @@ class ConnectionCompare {
   }
 };
 
+// Whether |connections| is already in the order |cmp| sorts it into.
+bool IsSorted(const std::vector<cricket::Connection*>& connections,
+              ConnectionCompare cmp) {
+  for (size_t i = 1; i < connections.size(); ++i) {
+    if (cmp(connections[i], connections[i - 1]))
+      return false;
+  }
+  return true;
+}
+
 // Determines whether we should switch between two connections, based first on
 // static preferences and then (if those are equal) on latency estimates.
 bool ShouldSwitch(cricket::Connection* a_conn, cricket::Connection* b_conn) {
@@ -202,6 +212,7 @@ void P2PTransportChannel::AddAllocatorSession(PortAllocatorSession* session) {
 
 void P2PTransportChannel::AddConnection(Connection* connection) {
   connections_.push_back(connection);
+  AddToPingSchedule(connection);
   connection->set_remote_ice_mode(remote_ice_mode_);
   connection->SignalReadPacket.connect(
       this, &P2PTransportChannel::OnReadPacket);
@@ -324,6 +335,8 @@ void P2PTransportChannel::Reset() {
   allocator_sessions_.clear();
   ports_.clear();
   connections_.clear();
+  ping_schedule_.clear();
+  ping_schedule_entries_.clear();
   best_connection_ = NULL;
 
   // Forget about all of the candidates we got before.
@@ -736,9 +749,8 @@ bool P2PTransportChannel::CreateConnection(PortInterface* port,
 
 bool P2PTransportChannel::FindConnection(
     cricket::Connection* connection) const {
-  std::vector<Connection*>::const_iterator citer =
-      std::find(connections_.begin(), connections_.end(), connection);
-  return citer != connections_.end();
+  return ping_schedule_entries_.find(connection) !=
+      ping_schedule_entries_.end();
 }
 
 uint32 P2PTransportChannel::GetRemoteCandidateGeneration(
@@ -935,8 +947,11 @@ void P2PTransportChannel::SortConnections() {
   // one whose estimated latency is lowest.  So it is the only one that we
   // need to consider switching to.
 
+  // Most sorts are triggered by a single connection changing, and leave the
+  // order as it was, so only sort when the order is actually off.
   ConnectionCompare cmp;
-  std::stable_sort(connections_.begin(), connections_.end(), cmp);
+  if (!IsSorted(connections_, cmp))
+    std::stable_sort(connections_.begin(), connections_.end(), cmp);
   LOG(LS_VERBOSE) << "Sorting available connections:";
   for (uint32 i = 0; i < connections_.size(); ++i) {
     LOG(LS_VERBOSE) << connections_[i]->ToString();
@@ -1159,17 +1174,38 @@ Connection* P2PTransportChannel::FindNextPingableConnection() {
     return best_connection_;
   }
 
-  Connection* oldest_conn = NULL;
-  uint32 oldest_time = 0xFFFFFFFF;
-  for (uint32 i = 0; i < connections_.size(); ++i) {
-    if (IsPingable(connections_[i])) {
-      if (connections_[i]->last_ping_sent() < oldest_time) {
-        oldest_time = connections_[i]->last_ping_sent();
-        oldest_conn = connections_[i];
-      }
-    }
+  // The schedule is in the order connections are due, so this only walks
+  // past the ones that can't be pinged right now.
+  for (PingSchedule::const_iterator it = ping_schedule_.begin();
+       it != ping_schedule_.end(); ++it) {
+    ASSERT(it->last_ping_sent == it->connection->last_ping_sent());
+    if (IsPingable(it->connection))
+      return it->connection;
   }
-  return oldest_conn;
+  return NULL;
+}
+
+bool P2PTransportChannel::PingScheduleEntry::operator<(
+    const PingScheduleEntry& other) const {
+  if (last_ping_sent != other.last_ping_sent)
+    return last_ping_sent < other.last_ping_sent;
+  if (priority != other.priority)
+    return priority > other.priority;
+  return connection < other.connection;
+}
+
+void P2PTransportChannel::AddToPingSchedule(Connection* conn) {
+  ASSERT(ping_schedule_entries_.find(conn) == ping_schedule_entries_.end());
+  ping_schedule_entries_[conn] = ping_schedule_.insert(
+      PingScheduleEntry(conn->last_ping_sent(), conn->priority(), conn)).first;
+}
+
+void P2PTransportChannel::RemoveFromPingSchedule(Connection* conn) {
+  std::map<Connection*, PingSchedule::iterator>::iterator it =
+      ping_schedule_entries_.find(conn);
+  ASSERT(it != ping_schedule_entries_.end());
+  ping_schedule_.erase(it->second);
+  ping_schedule_entries_.erase(it);
 }
 
 // Apart from sending ping from |conn| this method also updates
@@ -1197,7 +1233,9 @@ void P2PTransportChannel::PingConnection(Connection* conn) {
     }
   }
   conn->set_use_candidate_attr(use_candidate);
+  RemoveFromPingSchedule(conn);
   conn->Ping(rtc::Time());
+  AddToPingSchedule(conn);
 }
 
 // When a connection's state changes, we need to figure out who to use as
@@ -1232,6 +1270,7 @@ void P2PTransportChannel::OnConnectionDestroyed(Connection* connection) {
       std::find(connections_.begin(), connections_.end(), connection);
   ASSERT(iter != connections_.end());
   connections_.erase(iter);
+  RemoveFromPingSchedule(connection);
 
   LOG_J(LS_INFO, this) << "Removed connection ("
     << static_cast<int>(connections_.size()) << " remaining)";
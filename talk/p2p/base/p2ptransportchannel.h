@@ -38,6 +38,7 @@
 #define TALK_P2P_BASE_P2PTRANSPORTCHANNEL_H_
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include "webrtc/base/asyncpacketsocket.h"
@@ -195,6 +196,8 @@ class P2PTransportChannel : public TransportChannelImpl,
   bool IsPingable(Connection* conn);
   Connection* FindNextPingableConnection();
   void PingConnection(Connection* conn);
+  void AddToPingSchedule(Connection* conn);
+  void RemoveFromPingSchedule(Connection* conn);
   void AddAllocatorSession(PortAllocatorSession* session);
   void AddConnection(Connection* connection);
 
@@ -232,6 +235,26 @@ class P2PTransportChannel : public TransportChannelImpl,
   std::vector<PortAllocatorSession*> allocator_sessions_;
   std::vector<PortInterface *> ports_;
   std::vector<Connection *> connections_;
+  // The connections in the order they are due for a ping: the one pinged
+  // longest ago first and, among equally old ones, the one with the highest
+  // priority at the time it was scheduled. The keys are copied into the
+  // entries, so the order can't change behind the set's back.
+  struct PingScheduleEntry {
+    PingScheduleEntry(uint32 last_ping_sent, uint64 priority,
+                      Connection* connection)
+        : last_ping_sent(last_ping_sent),
+          priority(priority),
+          connection(connection) {}
+    bool operator<(const PingScheduleEntry& other) const;
+
+    uint32 last_ping_sent;
+    uint64 priority;
+    Connection* connection;
+  };
+  typedef std::set<PingScheduleEntry> PingSchedule;
+  PingSchedule ping_schedule_;
+  // The entry of every connection in |ping_schedule_|.
+  std::map<Connection*, PingSchedule::iterator> ping_schedule_entries_;
   Connection* best_connection_;
   // Connection selected by the controlling agent. This should be used only
   // at controlled side when protocol type is RFC5245.
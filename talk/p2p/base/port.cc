@@ -219,6 +219,7 @@ void Port::Construct() {
     ice_username_fragment_ = rtc::CreateRandomString(ICE_UFRAG_LENGTH);
     password_ = rtc::CreateRandomString(ICE_PWD_LENGTH);
   }
+  password_key_.SetKey(password_.data(), password_.size());
   LOG_J(LS_INFO, this) << "Port created";
 }
 
@@ -421,7 +422,7 @@ bool Port::GetStunMessage(const char* data, size_t size,
 
     // If ICE, and the MESSAGE-INTEGRITY is bad, fail with a 401 Unauthorized
     if (IsStandardIce() &&
-        !stun_msg->ValidateMessageIntegrity(data, size, password_)) {
+        !stun_msg->ValidateMessageIntegrity(data, size, password_key_)) {
       LOG_J(LS_ERROR, this) << "Received STUN request with bad M-I "
                             << "from " << addr.ToSensitiveString();
       SendBindingErrorResponse(stun_msg.get(), addr, STUN_ERROR_UNAUTHORIZED,
@@ -632,7 +633,7 @@ void Port::SendBindingResponse(StunMessage* request,
   if (IsStandardIce()) {
     response.AddAttribute(
         new StunXorAddressAttribute(STUN_ATTR_XOR_MAPPED_ADDRESS, addr));
-    response.AddMessageIntegrity(password_);
+    response.AddMessageIntegrity(password_key_);
     response.AddFingerprint();
   } else if (IsGoogleIce()) {
     response.AddAttribute(
@@ -685,7 +686,7 @@ void Port::SendBindingErrorResponse(StunMessage* request,
     // because we don't have enough information to determine the shared secret.
     if (error_code != STUN_ERROR_BAD_REQUEST &&
         error_code != STUN_ERROR_UNAUTHORIZED)
-      response.AddMessageIntegrity(password_);
+      response.AddMessageIntegrity(password_key_);
     response.AddFingerprint();
   } else if (IsGoogleIce()) {
     // GICE responses include a username, if one exists.
@@ -824,7 +825,7 @@ class ConnectionRequest : public StunRequest {
           new StunUInt32Attribute(STUN_ATTR_PRIORITY, prflx_priority));
 
       // Adding Message Integrity attribute.
-      request->AddMessageIntegrity(connection_->remote_candidate().password());
+      request->AddMessageIntegrity(connection_->remote_password_key());
       // Adding Fingerprint.
       request->AddFingerprint();
     }
@@ -860,7 +861,9 @@ class ConnectionRequest : public StunRequest {
 Connection::Connection(Port* port, size_t index,
                        const Candidate& remote_candidate)
   : port_(port), local_candidate_index_(index),
-    remote_candidate_(remote_candidate), read_state_(STATE_READ_INIT),
+    remote_candidate_(remote_candidate),
+    remote_password_key_(remote_candidate.password()),
+    read_state_(STATE_READ_INIT),
     write_state_(STATE_WRITE_INIT), connected_(true), pruned_(false),
     use_candidate_attr_(false), remote_ice_mode_(ICEMODE_FULL),
     requests_(port->thread()), rtt_(DEFAULT_RTT), last_ping_sent_(0),
@@ -1037,8 +1040,7 @@ void Connection::OnReadPacket(
       case STUN_BINDING_RESPONSE:
       case STUN_BINDING_ERROR_RESPONSE:
         if (port_->IsGoogleIce() ||
-            msg->ValidateMessageIntegrity(
-                data, size, remote_candidate().password())) {
+            msg->ValidateMessageIntegrity(data, size, remote_password_key_)) {
           requests_.CheckResponse(msg.get());
         }
         // Otherwise silently discard the response message.
@@ -378,6 +378,8 @@ class Port : public PortInterface, public rtc::MessageHandler,
   // username_fragment().
   std::string ice_username_fragment_;
   std::string password_;
+  // |password_| as the key of the MESSAGE-INTEGRITY we sign and check.
+  StunMessageIntegrityKey password_key_;
   std::vector<Candidate> candidates_;
   AddressMap connections_;
   int timeout_delay_;
@@ -417,6 +419,10 @@ class Connection : public rtc::MessageHandler,
 
   // Returns the description of the remote port to which we communicate.
   const Candidate& remote_candidate() const { return remote_candidate_; }
+  // The remote candidate's password as a MESSAGE-INTEGRITY key.
+  const StunMessageIntegrityKey& remote_password_key() const {
+    return remote_password_key_;
+  }
 
   // Returns the pair priority.
   uint64 priority() const;
@@ -466,8 +472,8 @@ class Connection : public rtc::MessageHandler,
   // Error if Send() returns < 0
   virtual int GetError() = 0;
 
-  sigslot::signal4<Connection*, const char*, size_t,
-                   const rtc::PacketTime&> SignalReadPacket;
+  sigslot::st_signal4<Connection*, const char*, size_t,
+                      const rtc::PacketTime&> SignalReadPacket;
 
   sigslot::signal1<Connection*> SignalReadyToSend;
 
@@ -554,6 +560,7 @@ class Connection : public rtc::MessageHandler,
   Port* port_;
   size_t local_candidate_index_;
   Candidate remote_candidate_;
+  const StunMessageIntegrityKey remote_password_key_;
   ReadState read_state_;
   WriteState write_state_;
   bool connected_;
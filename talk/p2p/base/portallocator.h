@@ -55,6 +55,11 @@ const uint32 PORTALLOCATOR_ENABLE_SHARED_UFRAG = 0x80;
 const uint32 PORTALLOCATOR_ENABLE_SHARED_SOCKET = 0x100;
 const uint32 PORTALLOCATOR_ENABLE_STUN_RETRANSMIT_ATTRIBUTE = 0x200;
 const uint32 PORTALLOCATOR_ENABLE_TURN_SHARED_SOCKET = 0x400;
+// Starts all the allocation phases (UDP, relay, TCP) of a network at once
+// instead of one per step delay, so that the fastest candidate of each kind
+// is reported as early as possible. Pair with ENABLE_SHARED_SOCKET and
+// ENABLE_TURN_SHARED_SOCKET to also gather them from a single UDP socket.
+const uint32 PORTALLOCATOR_ENABLE_PARALLEL_PHASES = 0x800;
 
 const uint32 kDefaultPortAllocatorFlags = 0;
 
@@ -114,11 +114,18 @@ const uint32 DEFAULT_SND_BUF_SIZE = 90 * 1024;
 // 24 |                             data                              |
 //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 //
+// Once both sides have offered TCP_OPT_SACK_PERMITTED, the Control byte of a
+// packet without data holds the number of SACK blocks that follow the header.
+// Each block is the start and end sequence number of a range of data that was
+// received out of order.
+//
 //////////////////////////////////////////////////////////////////////
 
 #define PSEUDO_KEEPALIVE 0
 
 const uint32 HEADER_SIZE = 24;
+const uint32 SACK_BLOCK_SIZE = 8;
+const uint8 MAX_SACK_BLOCKS = 4;
 const uint32 PACKET_OVERHEAD = HEADER_SIZE + UDP_HEADER_SIZE + IP_HEADER_SIZE + JINGLE_HEADER_SIZE;
 
 const uint32 MIN_RTO   =   250; // 250 ms (RFC1122, Sec 4.2.3.1 "fractions of a second")
@@ -136,6 +143,7 @@ const uint8 TCP_OPT_EOL = 0;  // End of list.
 const uint8 TCP_OPT_NOOP = 1;  // No-op.
 const uint8 TCP_OPT_MSS = 2;  // Maximum segment size.
 const uint8 TCP_OPT_WND_SCALE = 3;  // Window scale factor.
+const uint8 TCP_OPT_SACK_PERMITTED = 4;  // Selective acknowledgements.
 
 const long DEFAULT_TIMEOUT = 4000; // If there are no pending clocks, wake up every 4 seconds
 const long CLOSED_TIMEOUT = 60 * 1000; // If the connection is closed, once per minute
@@ -227,7 +235,8 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32 conv)
       m_rbuf_len(DEFAULT_RCV_BUF_SIZE),
       m_rbuf(m_rbuf_len),
       m_sbuf_len(DEFAULT_SND_BUF_SIZE),
-      m_sbuf(m_sbuf_len) {
+      m_sbuf(m_sbuf_len),
+      m_packet(new uint8[MAX_PACKET]) {
 
   // Sanity check on buffer sizes (needed for OnTcpWriteable notification logic)
   ASSERT(m_rbuf_len + MIN_PACKET < m_sbuf_len);
@@ -261,6 +270,9 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32 conv)
   m_dup_acks = 0;
   m_recover = 0;
 
+  m_sack_enabled = false;
+  m_sack_high = m_sack_rexmit = 0;
+
   m_ts_recent = m_ts_lastack = 0;
 
   m_rx_rto = DEF_RTO;
@@ -269,6 +281,7 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32 conv)
   m_use_nagling = true;
   m_ack_delay = DEF_ACK_DELAY;
   m_support_wnd_scale = true;
+  m_support_sack = true;
 }
 
 PseudoTcp::~PseudoTcp() {
@@ -528,27 +541,31 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32 seq, uint8 flags,
 
   uint32 now = Now();
 
-  rtc::scoped_ptr<uint8[]> buffer(new uint8[MAX_PACKET]);
-  long_to_bytes(m_conv, buffer.get());
-  long_to_bytes(seq, buffer.get() + 4);
-  long_to_bytes(m_rcv_nxt, buffer.get() + 8);
+  uint8* buffer = m_packet.get();
+  long_to_bytes(m_conv, buffer);
+  long_to_bytes(seq, buffer + 4);
+  long_to_bytes(m_rcv_nxt, buffer + 8);
   buffer[12] = 0;
   buffer[13] = flags;
   short_to_bytes(
-      static_cast<uint16>(m_rcv_wnd >> m_rwnd_scale), buffer.get() + 14);
+      static_cast<uint16>(m_rcv_wnd >> m_rwnd_scale), buffer + 14);
 
   // Timestamp computations
-  long_to_bytes(now, buffer.get() + 16);
-  long_to_bytes(m_ts_recent, buffer.get() + 20);
+  long_to_bytes(now, buffer + 16);
+  long_to_bytes(m_ts_recent, buffer + 20);
   m_ts_lastack = m_rcv_nxt;
 
+  uint32 size = HEADER_SIZE + len;
   if (len) {
     size_t bytes_read = 0;
     rtc::StreamResult result = m_sbuf.ReadOffset(
-        buffer.get() + HEADER_SIZE, len, offset, &bytes_read);
+        buffer + HEADER_SIZE, len, offset, &bytes_read);
     RTC_UNUSED(result);
     ASSERT(result == rtc::SR_SUCCESS);
     ASSERT(static_cast<uint32>(bytes_read) == len);
+  } else if (m_sack_enabled && !m_rlist.empty()) {
+    buffer[12] = writeSackBlocks(buffer + HEADER_SIZE);
+    size += buffer[12] * SACK_BLOCK_SIZE;
   }
 
 #if _DEBUGMSG >= _DBG_VERBOSE
@@ -563,7 +580,7 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32 seq, uint8 flags,
 #endif // _DEBUGMSG
 
   IPseudoTcpNotify::WriteResult wres = m_notify->TcpWritePacket(
-      this, reinterpret_cast<char *>(buffer.get()), len + HEADER_SIZE);
+      this, reinterpret_cast<char *>(buffer), size);
   // Note: When len is 0, this is an ACK packet.  We don't read the return value for those,
   // and thus we won't retry.  So go ahead and treat the packet as a success (basically simulate
   // as if it were dropped), which will prevent our timers from being messed up.
@@ -594,8 +611,15 @@ bool PseudoTcp::parse(const uint8* buffer, uint32 size) {
   seg.tsval = bytes_to_long(buffer + 16);
   seg.tsecr = bytes_to_long(buffer + 20);
 
-  seg.data = reinterpret_cast<const char *>(buffer) + HEADER_SIZE;
-  seg.len = size - HEADER_SIZE;
+  // Only a peer we negotiated SACK with fills in the Control byte.
+  seg.sack = buffer + HEADER_SIZE;
+  seg.sack_count = m_sack_enabled ? buffer[12] : 0;
+  uint32 sack_size = seg.sack_count * SACK_BLOCK_SIZE;
+  if (size < HEADER_SIZE + sack_size)
+    return false;
+
+  seg.data = reinterpret_cast<const char *>(buffer) + HEADER_SIZE + sack_size;
+  seg.len = size - HEADER_SIZE - sack_size;
 
 #if _DEBUGMSG >= _DBG_VERBOSE
   LOG(LS_INFO) << "--> <CONV=" << seg.conv
@@ -713,6 +737,10 @@ bool PseudoTcp::process(Segment& seg) {
     m_ts_recent = seg.tsval;
   }
 
+  if (seg.sack_count) {
+    processSack(seg);
+  }
+
   // Check if this is a valuable ack
   if ((seg.ack > m_snd_una) && (seg.ack <= m_snd_nxt)) {
     // Calculate round-trip time
@@ -776,7 +804,7 @@ bool PseudoTcp::process(Segment& seg) {
 #if _DEBUGMSG >= _DBG_NORMAL
         LOG(LS_INFO) << "recovery retransmit";
 #endif // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
+        if (!retransmitHole(now)) {
           closedown(ECONNABORTED);
           return false;
         }
@@ -805,7 +833,8 @@ bool PseudoTcp::process(Segment& seg) {
         LOG(LS_INFO) << "enter recovery";
         LOG(LS_INFO) << "recovery retransmit";
 #endif // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
+        m_sack_rexmit = m_snd_una;
+        if (!retransmitHole(now)) {
           closedown(ECONNABORTED);
           return false;
         }
@@ -815,7 +844,17 @@ bool PseudoTcp::process(Segment& seg) {
         //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
         m_cwnd = m_ssthresh + 3 * m_mss;
       } else if (m_dup_acks > 3) {
-        m_cwnd += m_mss;
+        // Each further duplicate ack means a segment has left the network.
+        // With SACK that room is used for the next hole, otherwise for new
+        // data.
+        uint32 rexmit = m_sack_rexmit;
+        if (m_sack_enabled && !retransmitHole(now)) {
+          closedown(ECONNABORTED);
+          return false;
+        }
+        if (m_sack_rexmit == rexmit) {
+          m_cwnd += m_mss;
+        }
       }
     } else {
       m_dup_acks = 0;
@@ -1032,6 +1071,62 @@ bool PseudoTcp::transmit(const SList::iterator& seg, uint32 now) {
   return true;
 }
 
+void PseudoTcp::processSack(const Segment& seg) {
+  for (uint8 i = 0; i < seg.sack_count; ++i) {
+    uint32 start = bytes_to_long(seg.sack + i * SACK_BLOCK_SIZE);
+    uint32 end = bytes_to_long(seg.sack + i * SACK_BLOCK_SIZE + 4);
+    if ((start >= end) || (start < m_snd_una) || (end > m_snd_nxt)) {
+      continue;  // Stale or bogus.
+    }
+    for (SList::iterator it = m_slist.begin();
+         (it != m_slist.end()) && (it->seq < end); ++it) {
+      if ((it->xmit > 0) && (it->seq >= start) && (it->seq + it->len <= end)) {
+        it->bSacked = true;
+      }
+    }
+    m_sack_high = rtc::_max(m_sack_high, end);
+  }
+}
+
+uint8 PseudoTcp::writeSackBlocks(uint8* buf) const {
+  uint8 count = 0;
+  RList::const_iterator it = m_rlist.begin();
+  while ((it != m_rlist.end()) && (count < MAX_SACK_BLOCKS)) {
+    // |m_rlist| is sorted by sequence number; merge the segments that overlap
+    // or touch into a single block.
+    uint32 start = it->seq;
+    uint32 end = it->seq + it->len;
+    for (++it; (it != m_rlist.end()) && (it->seq <= end); ++it) {
+      end = rtc::_max(end, it->seq + it->len);
+    }
+    long_to_bytes(start, buf + count * SACK_BLOCK_SIZE);
+    long_to_bytes(end, buf + count * SACK_BLOCK_SIZE + 4);
+    ++count;
+  }
+  return count;
+}
+
+bool PseudoTcp::retransmitHole(uint32 now) {
+  SList::iterator it = m_slist.begin();
+  if (m_sack_enabled) {
+    while ((it != m_slist.end()) &&
+           (it->bSacked || (it->seq < m_sack_rexmit))) {
+      ++it;
+    }
+    // Past the first unacknowledged segment, only segments below data the
+    // peer has received are known to be lost.
+    if ((it == m_slist.end()) || (it->xmit == 0) ||
+        ((it != m_slist.begin()) && (it->seq + it->len > m_sack_high))) {
+      return true;
+    }
+  }
+  if (!transmit(it, now)) {
+    return false;
+  }
+  m_sack_rexmit = it->seq + it->len;
+  return true;
+}
+
 void PseudoTcp::attemptSend(SendFlags sflags) {
   uint32 now = Now();
 
@@ -1169,6 +1264,11 @@ PseudoTcp::disableWindowScale() {
   m_support_wnd_scale = false;
 }
 
+void
+PseudoTcp::disableSack() {
+  m_support_sack = false;
+}
+
 void
 PseudoTcp::queueConnectMessage() {
   rtc::ByteBuffer buf(rtc::ByteBuffer::ORDER_NETWORK);
@@ -1179,6 +1279,10 @@ PseudoTcp::queueConnectMessage() {
     buf.WriteUInt8(1);
     buf.WriteUInt8(m_rwnd_scale);
   }
+  if (m_support_sack) {
+    buf.WriteUInt8(TCP_OPT_SACK_PERMITTED);
+    buf.WriteUInt8(0);
+  }
   m_snd_wnd = static_cast<uint32>(buf.Length());
   queue(buf.Data(), static_cast<uint32>(buf.Length()), true);
 }
@@ -1229,6 +1333,10 @@ PseudoTcp::parseOptions(const char* data, uint32 len) {
       m_swnd_scale = 0;
     }
   }
+
+  m_sack_enabled = m_support_sack &&
+      (options_specified.find(TCP_OPT_SACK_PERMITTED) !=
+       options_specified.end());
 }
 
 void
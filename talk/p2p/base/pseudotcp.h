@@ -31,6 +31,7 @@
 #include <list>
 
 #include "webrtc/base/basictypes.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/stream.h"
 
 namespace cricket {
@@ -134,16 +135,21 @@ class PseudoTcp {
     const char * data;
     uint32 len;
     uint32 tsval, tsecr;
+    // Selective acknowledgement blocks, |sack_count| pairs of start and end
+    // sequence numbers in network order.
+    const uint8* sack;
+    uint8 sack_count;
   };
 
   struct SSegment {
     SSegment(uint32 s, uint32 l, bool c)
-        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c) {
+        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c), bSacked(false) {
     }
     uint32 seq, len;
     //uint32 tstamp;
     uint8 xmit;
     bool bCtrl;
+    bool bSacked;  // The peer has selectively acknowledged this segment.
   };
   typedef std::list<SSegment> SList;
 
@@ -174,6 +180,19 @@ class PseudoTcp {
   bool process(Segment& seg);
   bool transmit(const SList::iterator& seg, uint32 now);
 
+  // Marks the sent segments covered by the SACK blocks of |seg|.
+  void processSack(const Segment& seg);
+
+  // Writes the SACK blocks describing |m_rlist| to |buf|, and returns how
+  // many were written.
+  uint8 writeSackBlocks(uint8* buf) const;
+
+  // Retransmits the next segment the peer is missing during fast recovery.
+  // Without SACK this is always the first unacknowledged segment; with SACK
+  // it is the first hole below the highest selectively acknowledged byte
+  // that hasn't been retransmitted during this recovery yet.
+  bool retransmitHole(uint32 now);
+
   void adjustMTU();
 
  protected:
@@ -184,6 +203,10 @@ class PseudoTcp {
   // support for testing backward compatibility.
   void disableWindowScale();
 
+  // This method is only used in tests, to disable selective acknowledgements
+  // for testing backward compatibility.
+  void disableSack();
+
  private:
   // Queue the connect message with TCP options.
   void queueConnectMessage();
@@ -227,6 +250,9 @@ class PseudoTcp {
   uint8 m_swnd_scale;  // Window scale factor.
   rtc::FifoBuffer m_sbuf;
 
+  // Scratch buffer the outgoing packets are built in.
+  rtc::scoped_ptr<uint8[]> m_packet;
+
   // Maximum segment size, estimated protocol level, largest segment sent
   uint32 m_mss, m_msslevel, m_largest, m_mtu_advise;
   // Retransmit timer
@@ -244,6 +270,13 @@ class PseudoTcp {
   uint32 m_recover;
   uint32 m_t_ack;
 
+  // Selective acknowledgements: whether both sides support them, the end of
+  // the highest selectively acknowledged segment, and the end of the last
+  // segment retransmitted during the current recovery.
+  bool m_sack_enabled;
+  uint32 m_sack_high;
+  uint32 m_sack_rexmit;
+
   // Configuration options
   bool m_use_nagling;
   uint32 m_ack_delay;
@@ -251,6 +284,10 @@ class PseudoTcp {
   // This is used by unit tests to test backward compatibility of
   // PseudoTcp implementations that don't support window scaling.
   bool m_support_wnd_scale;
+
+  // Likewise for implementations that don't support selective
+  // acknowledgements.
+  bool m_support_sack;
 };
 
 }  // namespace cricket
@@ -54,6 +54,10 @@ class PseudoTcpForTest : public cricket::PseudoTcp {
   void disableWindowScale() {
     PseudoTcp::disableWindowScale();
   }
+
+  void disableSack() {
+    PseudoTcp::disableSack();
+  }
 };
 
 class PseudoTcpTestBase : public testing::Test,
@@ -114,6 +118,12 @@ class PseudoTcpTestBase : public testing::Test,
   void DisableLocalWindowScale() {
     local_.disableWindowScale();
   }
+  void DisableRemoteSack() {
+    remote_.disableSack();
+  }
+  void DisableLocalSack() {
+    local_.disableSack();
+  }
 
  protected:
   int Connect() {
@@ -640,6 +650,39 @@ TEST_F(PseudoTcpTest, TestSendWithDelayAndLoss) {
   TestTransfer(100000);  // less data so test runs faster
 }
 
+// Test sending data with 10% packet loss through a large window, where
+// selective acknowledgements let the sender repair several holes per round
+// trip.
+TEST_F(PseudoTcpTest, TestSendWithLossAndLargeWindow) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  SetRemoteOptRcvBuf(200000);
+  SetLocalOptRcvBuf(200000);
+  SetOptSndBuf(300000);
+  TestTransfer(100000);  // less data so test runs faster
+}
+
+// Test sending data with packet loss to a receiver that doesn't support
+// selective acknowledgements.
+TEST_F(PseudoTcpTest, TestSendWithLossRemoteNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableRemoteSack();
+  TestTransfer(100000);
+}
+
+// Test sending data with packet loss from a sender that doesn't support
+// selective acknowledgements.
+TEST_F(PseudoTcpTest, TestSendWithLossLocalNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableLocalSack();
+  TestTransfer(100000);
+}
+
 // Test sending data with 10% packet loss and Nagling disabled.  Transmission
 // should take about the same time as with Nagling enabled.
 TEST_F(PseudoTcpTest, TestSendWithLossAndOptNaglingOff) {
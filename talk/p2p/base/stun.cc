@@ -34,7 +34,6 @@
 #include "webrtc/base/crc32.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/messagedigest.h"
-#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/stringencode.h"
 
 using rtc::ByteBuffer;
@@ -141,10 +140,77 @@ const StunUInt16ListAttribute* StunMessage::GetUnknownAttributes() const {
       GetAttribute(STUN_ATTR_UNKNOWN_ATTRIBUTES));
 }
 
+// HMAC block size of SHA-1 (RFC 2104).
+static const size_t kHmacBlockSize = 64;
+
+StunMessageIntegrityKey::StunMessageIntegrityKey() {
+  SetKey(NULL, 0);
+}
+
+StunMessageIntegrityKey::StunMessageIntegrityKey(const std::string& key) {
+  SetKey(key.data(), key.size());
+}
+
+StunMessageIntegrityKey::StunMessageIntegrityKey(const char* key,
+                                                 size_t keylen) {
+  SetKey(key, keylen);
+}
+
+void StunMessageIntegrityKey::SetKey(const char* key, size_t keylen) {
+  key_.assign(key, keylen);
+
+  // Keys longer than a block are hashed first, and shorter ones padded with
+  // zeros.
+  uint8 block[kHmacBlockSize];
+  memset(block, 0, sizeof(block));
+  if (keylen > kHmacBlockSize) {
+    rtc::SHA1_CTX context;
+    rtc::SHA1Init(&context);
+    rtc::SHA1Update(&context, reinterpret_cast<const uint8*>(key), keylen);
+    rtc::SHA1Final(&context, block);
+  } else if (keylen > 0) {
+    memcpy(block, key, keylen);
+  }
+
+  uint8 pad[kHmacBlockSize];
+  for (size_t i = 0; i < kHmacBlockSize; ++i)
+    pad[i] = block[i] ^ 0x36;
+  rtc::SHA1Init(&inner_);
+  rtc::SHA1Update(&inner_, pad, kHmacBlockSize);
+  for (size_t i = 0; i < kHmacBlockSize; ++i)
+    pad[i] = block[i] ^ 0x5c;
+  rtc::SHA1Init(&outer_);
+  rtc::SHA1Update(&outer_, pad, kHmacBlockSize);
+}
+
+void StunMessageIntegrityKey::ComputeHmac(const char* data, size_t size,
+                                          const char* data2, size_t size2,
+                                          char* hmac) const {
+  // HMAC = H(K XOR opad, H(K XOR ipad, text)), starting from the states that
+  // already have the padded keys in them.
+  uint8 inner_digest[SHA1_DIGEST_SIZE];
+  rtc::SHA1_CTX context = inner_;
+  rtc::SHA1Update(&context, reinterpret_cast<const uint8*>(data), size);
+  if (size2 > 0) {
+    rtc::SHA1Update(&context, reinterpret_cast<const uint8*>(data2), size2);
+  }
+  rtc::SHA1Final(&context, inner_digest);
+
+  context = outer_;
+  rtc::SHA1Update(&context, inner_digest, sizeof(inner_digest));
+  rtc::SHA1Final(&context, reinterpret_cast<uint8*>(hmac));
+}
+
 // Verifies a STUN message has a valid MESSAGE-INTEGRITY attribute, using the
 // procedure outlined in RFC 5389, section 15.4.
 bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
                                            const std::string& password) {
+  return ValidateMessageIntegrity(data, size,
+                                  StunMessageIntegrityKey(password));
+}
+
+bool StunMessage::ValidateMessageIntegrity(
+    const char* data, size_t size, const StunMessageIntegrityKey& key) {
   // Verifying the size of the message.
   if ((size % 4) != 0) {
     return false;
@@ -186,35 +252,25 @@ bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
     return false;
   }
 
-  // Getting length of the message to calculate Message Integrity.
+  // The HMAC covers the message up to the M-I attribute, with the length in
+  // the header counting up to the end of M-I. Rather than copying the
+  // message to patch that up, the type and length are hashed separately.
+  //      0                   1                   2                   3
+  //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  //     |0 0|     STUN Message Type     |         Message Length        |
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   size_t mi_pos = current_pos;
-  rtc::scoped_ptr<char[]> temp_data(new char[current_pos]);
-  memcpy(temp_data.get(), data, current_pos);
-  if (size > mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize) {
-    // Stun message has other attributes after message integrity.
-    // Adjust the length parameter in stun message to calculate HMAC.
-    size_t extra_offset = size -
-        (mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize);
-    size_t new_adjusted_len = size - extra_offset - kStunHeaderSize;
-
-    // Writing new length of the STUN message @ Message Length in temp buffer.
-    //      0                   1                   2                   3
-    //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    //     |0 0|     STUN Message Type     |         Message Length        |
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    rtc::SetBE16(temp_data.get() + 2,
-                       static_cast<uint16>(new_adjusted_len));
-  }
+  size_t adjusted_len = mi_pos + kStunAttributeHeaderSize +
+      kStunMessageIntegritySize - kStunHeaderSize;
+  char type_and_length[4];
+  memcpy(type_and_length, data, 2);
+  rtc::SetBE16(type_and_length + 2, static_cast<uint16>(adjusted_len));
 
   char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
-                                      password.c_str(), password.size(),
-                                      temp_data.get(), mi_pos,
-                                      hmac, sizeof(hmac));
-  ASSERT(ret == sizeof(hmac));
-  if (ret != sizeof(hmac))
-    return false;
+  key.ComputeHmac(type_and_length, sizeof(type_and_length),
+                  data + sizeof(type_and_length),
+                  mi_pos - sizeof(type_and_length), hmac);
 
   // Comparing the calculated HMAC with the one present in the message.
   return memcmp(data + current_pos + kStunAttributeHeaderSize,
@@ -223,11 +279,15 @@ bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
 }
 
 bool StunMessage::AddMessageIntegrity(const std::string& password) {
-  return AddMessageIntegrity(password.c_str(), password.size());
+  return AddMessageIntegrity(StunMessageIntegrityKey(password));
 }
 
 bool StunMessage::AddMessageIntegrity(const char* key,
                                       size_t keylen) {
+  return AddMessageIntegrity(StunMessageIntegrityKey(key, keylen));
+}
+
+bool StunMessage::AddMessageIntegrity(const StunMessageIntegrityKey& key) {
   // Add the attribute with a dummy value. Since this is a known attribute, it
   // can't fail.
   StunByteStringAttribute* msg_integrity_attr =
@@ -240,19 +300,10 @@ bool StunMessage::AddMessageIntegrity(const char* key,
   if (!Write(&buf))
     return false;
 
-  int msg_len_for_hmac = static_cast<int>(
-      buf.Length() - kStunAttributeHeaderSize - msg_integrity_attr->length());
+  size_t msg_len_for_hmac =
+      buf.Length() - kStunAttributeHeaderSize - msg_integrity_attr->length();
   char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
-                                      key, keylen,
-                                      buf.Data(), msg_len_for_hmac,
-                                      hmac, sizeof(hmac));
-  ASSERT(ret == sizeof(hmac));
-  if (ret != sizeof(hmac)) {
-    LOG(LS_ERROR) << "HMAC computation failed. Message-Integrity "
-                  << "has dummy value.";
-    return false;
-  }
+  key.ComputeHmac(buf.Data(), msg_len_for_hmac, NULL, 0, hmac);
 
   // Insert correct HMAC into the attribute.
   msg_integrity_attr->CopyBytes(hmac, sizeof(hmac));
@@ -36,6 +36,7 @@
 
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/sha1.h"
 #include "webrtc/base/socketaddress.h"
 
 namespace cricket {
@@ -131,6 +132,34 @@ const size_t kStunLegacyTransactionIdLength = 16;
 // STUN Message Integrity HMAC length.
 const size_t kStunMessageIntegritySize = 20;
 
+// The value the CRC-32 of a message is XORed with for FINGERPRINT.
+extern const uint32 STUN_FINGERPRINT_XOR_VALUE;
+
+// The key of MESSAGE-INTEGRITY attributes, with the HMAC-SHA1 state for it
+// precomputed. Signing or validating many messages with the same password,
+// as connectivity checks do, then only hashes the messages themselves.
+class StunMessageIntegrityKey {
+ public:
+  StunMessageIntegrityKey();
+  explicit StunMessageIntegrityKey(const std::string& key);
+  StunMessageIntegrityKey(const char* key, size_t keylen);
+
+  const std::string& key() const { return key_; }
+  void SetKey(const char* key, size_t keylen);
+
+  // Computes the HMAC of |data| followed by |data2| into |hmac|, which must
+  // have room for kStunMessageIntegritySize bytes.
+  void ComputeHmac(const char* data, size_t size,
+                   const char* data2, size_t size2,
+                   char* hmac) const;
+
+ private:
+  std::string key_;
+  // The SHA-1 states after hashing the inner and outer padded keys.
+  rtc::SHA1_CTX inner_;
+  rtc::SHA1_CTX outer_;
+};
+
 class StunAttribute;
 class StunAddressAttribute;
 class StunXorAddressAttribute;
@@ -183,9 +212,12 @@ class StunMessage {
   // padding data (which we discard when reading a StunMessage).
   static bool ValidateMessageIntegrity(const char* data, size_t size,
                                        const std::string& password);
+  static bool ValidateMessageIntegrity(const char* data, size_t size,
+                                       const StunMessageIntegrityKey& key);
   // Adds a MESSAGE-INTEGRITY attribute that is valid for the current message.
   bool AddMessageIntegrity(const std::string& password);
   bool AddMessageIntegrity(const char* key, size_t keylen);
+  bool AddMessageIntegrity(const StunMessageIntegrityKey& key);
 
   // Verifies that a given buffer is STUN by checking for a correct FINGERPRINT.
   static bool ValidateFingerprint(const char* data, size_t size);
@@ -1215,6 +1215,41 @@ TEST_F(StunTest, AddMessageIntegrity) {
         kRfc5769SampleMsgPassword));
 }
 
+// Check that a precomputed key validates and signs several messages, and
+// that keys longer than the HMAC block are hashed first.
+TEST_F(StunTest, MessageIntegrityKey) {
+  const StunMessageIntegrityKey key(kRfc5769SampleMsgPassword);
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(
+      reinterpret_cast<const char*>(kRfc5769SampleRequest),
+      sizeof(kRfc5769SampleRequest), key));
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(
+      reinterpret_cast<const char*>(kRfc5769SampleResponse),
+      sizeof(kRfc5769SampleResponse), key));
+
+  IceMessage msg;
+  rtc::ByteBuffer buf(
+      reinterpret_cast<const char*>(kRfc5769SampleRequestWithoutMI),
+      sizeof(kRfc5769SampleRequestWithoutMI));
+  EXPECT_TRUE(msg.Read(&buf));
+  EXPECT_TRUE(msg.AddMessageIntegrity(key));
+  const StunByteStringAttribute* mi_attr =
+      msg.GetByteString(STUN_ATTR_MESSAGE_INTEGRITY);
+  EXPECT_EQ(0, memcmp(
+      mi_attr->bytes(), kCalculatedHmac1, sizeof(kCalculatedHmac1)));
+
+  const std::string long_key(100, 'k');
+  const std::string input("A message to authenticate.");
+  char hmac[kStunMessageIntegritySize];
+  StunMessageIntegrityKey(long_key).ComputeHmac(
+      input.data(), 10, input.data() + 10, input.size() - 10, hmac);
+  char expected[kStunMessageIntegritySize];
+  EXPECT_EQ(sizeof(expected),
+            rtc::ComputeHmac(rtc::DIGEST_SHA_1, long_key.data(),
+                             long_key.size(), input.data(), input.size(),
+                             expected, sizeof(expected)));
+  EXPECT_EQ(0, memcmp(hmac, expected, sizeof(hmac)));
+}
+
 // Check our STUN message validation code against the RFC5769 test messages.
 TEST_F(StunTest, ValidateFingerprint) {
   EXPECT_TRUE(StunMessage::ValidateFingerprint(
@@ -0,0 +1,264 @@
+/*
+ * libjingle
+ * Copyright 2014, Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "talk/p2p/base/stunbindingresponder.h"
+
+#include <string.h>
+
+#include "talk/p2p/base/stun.h"
+#include "webrtc/base/byteorder.h"
+#include "webrtc/base/crc32.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread.h"
+
+namespace cricket {
+
+namespace {
+
+// Offsets of the magic cookie, and of the XOR-MAPPED-ADDRESS port and
+// address in the responses.
+const size_t kMagicCookieOffset = 4;
+const size_t kMappedPortOffset = 26;
+const size_t kMappedAddressOffset = 28;
+// Size of the FINGERPRINT attribute that ends the responses.
+const size_t kFingerprintAttrSize = 8;
+
+// The success responses for IPv4 and IPv6 clients. The transaction ID, the
+// XOR-MAPPED-ADDRESS port and address and the FINGERPRINT are patched in.
+const uint8 kResponseTemplateV4[] = {
+  0x01, 0x01, 0x00, 0x14,  // Binding success response, 20 bytes attributes.
+  0x21, 0x12, 0xA4, 0x42,  // Magic cookie.
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // Transaction ID.
+  0x00, 0x20, 0x00, 0x08,  // XOR-MAPPED-ADDRESS, 8 bytes.
+  0x00, 0x01, 0, 0,  // IPv4, port.
+  0, 0, 0, 0,  // Address.
+  0x80, 0x28, 0x00, 0x04,  // FINGERPRINT, 4 bytes.
+  0, 0, 0, 0,
+};
+const uint8 kResponseTemplateV6[] = {
+  0x01, 0x01, 0x00, 0x20,  // Binding success response, 32 bytes attributes.
+  0x21, 0x12, 0xA4, 0x42,  // Magic cookie.
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // Transaction ID.
+  0x00, 0x20, 0x00, 0x14,  // XOR-MAPPED-ADDRESS, 20 bytes.
+  0x00, 0x02, 0, 0,  // IPv6, port.
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // Address.
+  0x80, 0x28, 0x00, 0x04,  // FINGERPRINT, 4 bytes.
+  0, 0, 0, 0,
+};
+
+// Number of datagrams read and answered at a time by a worker.
+const size_t kBatchSize = 64;
+// Binding requests are small; longer datagrams are truncated to this and
+// then fail the length check.
+const size_t kRequestSlotSize = 576;
+
+// Checks the header of |request| and that its attributes exactly fill the
+// message, with FINGERPRINT, if present, last and correct.
+bool IsStunBindingRequest(const char* request, size_t size) {
+  if (size < kStunHeaderSize ||
+      rtc::GetBE16(request) != STUN_BINDING_REQUEST ||
+      rtc::GetBE16(request + 2) != size - kStunHeaderSize ||
+      (size % 4) != 0 ||
+      rtc::GetBE32(request + 4) != kStunMagicCookie) {
+    return false;
+  }
+  size_t pos = kStunHeaderSize;
+  while (pos < size) {
+    if (size - pos < kStunAttributeHeaderSize)
+      return false;
+    uint16 attr_type = rtc::GetBE16(request + pos);
+    size_t attr_length = rtc::GetBE16(request + pos + 2);
+    pos += kStunAttributeHeaderSize;
+    // Attributes are padded to a multiple of four bytes.
+    size_t padded_length = (attr_length + 3) & ~3;
+    if (padded_length > size - pos)
+      return false;
+    pos += padded_length;
+    if (attr_type == STUN_ATTR_FINGERPRINT)
+      return pos == size && StunMessage::ValidateFingerprint(request, size);
+  }
+  return true;
+}
+
+}  // namespace
+
+size_t WriteStunBindingResponse(const char* request, size_t size,
+                                const rtc::SocketAddress& remote_addr,
+                                char* response) {
+  if (!IsStunBindingRequest(request, size))
+    return 0;
+
+  const rtc::IPAddress& ip = remote_addr.ipaddr();
+  size_t response_size;
+  if (ip.family() == AF_INET) {
+    response_size = sizeof(kResponseTemplateV4);
+    memcpy(response, kResponseTemplateV4, response_size);
+    rtc::SetBE32(response + kMappedAddressOffset,
+                 ip.v4AddressAsHostOrderInteger() ^ kStunMagicCookie);
+  } else if (ip.family() == AF_INET6) {
+    response_size = sizeof(kResponseTemplateV6);
+    memcpy(response, kResponseTemplateV6, response_size);
+    in6_addr v6 = ip.ipv6_address();
+    memcpy(response + kMappedAddressOffset, &v6, sizeof(v6));
+  } else {
+    return 0;
+  }
+  memcpy(response + kStunTransactionIdOffset,
+         request + kStunTransactionIdOffset, kStunTransactionIdLength);
+  if (ip.family() == AF_INET6) {
+    // An IPv6 address is XORed with the magic cookie and the transaction ID.
+    for (size_t i = 0; i < sizeof(in6_addr); ++i)
+      response[kMappedAddressOffset + i] ^= response[kMagicCookieOffset + i];
+  }
+  rtc::SetBE16(response + kMappedPortOffset,
+               static_cast<uint16>(remote_addr.port() ^
+                                   (kStunMagicCookie >> 16)));
+  uint32 crc = rtc::ComputeCrc32(response,
+                                 response_size - kFingerprintAttrSize);
+  rtc::SetBE32(response + response_size - StunUInt32Attribute::SIZE,
+               crc ^ STUN_FINGERPRINT_XOR_VALUE);
+  return response_size;
+}
+
+// Owns one socket and the thread answering on it.
+class StunBindingResponder::Worker : public sigslot::has_slots<> {
+ public:
+  Worker()
+      : buffers_(new char[kBatchSize *
+                          (kRequestSlotSize + kMaxStunBindingResponseSize)]) {
+    char* buffer = buffers_.get();
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      requests_[i].data = buffer;
+      requests_[i].capacity = kRequestSlotSize;
+      buffer += kRequestSlotSize;
+      responses_[i].data = buffer;
+      responses_[i].capacity = kMaxStunBindingResponseSize;
+      buffer += kMaxStunBindingResponseSize;
+    }
+    thread_.SetName("StunBindingResponder", this);
+  }
+
+  ~Worker() {
+    // The socket may only go once its thread no longer reads from it.
+    thread_.Stop();
+    socket_.reset();
+  }
+
+  bool Bind(const rtc::SocketAddress& address) {
+    socket_.reset(thread_.socketserver()->CreateAsyncSocket(address.family(),
+                                                            SOCK_DGRAM));
+    if (!socket_)
+      return false;
+    if (socket_->SetOption(rtc::Socket::OPT_REUSEPORT, 1) < 0) {
+      LOG(LS_ERROR) << "Failed to enable SO_REUSEPORT";
+      return false;
+    }
+    if (socket_->Bind(address) < 0) {
+      LOG(LS_ERROR) << "Bind() failed with error " << socket_->GetError();
+      return false;
+    }
+    socket_->SignalReadEvent.connect(this, &Worker::OnReadEvent);
+    return true;
+  }
+
+  bool Start() { return thread_.Start(); }
+
+  rtc::SocketAddress address() const { return socket_->GetLocalAddress(); }
+
+ private:
+  void OnReadEvent(rtc::AsyncSocket* socket) {
+    int count = socket_->RecvFromBatch(requests_, kBatchSize);
+    if (count <= 0)
+      return;
+    size_t num_responses = 0;
+    for (int i = 0; i < count; ++i) {
+      // Binding requests are small; a larger datagram is something else.
+      if (requests_[i].truncated)
+        continue;
+      size_t size = WriteStunBindingResponse(requests_[i].data,
+                                             requests_[i].size,
+                                             requests_[i].addr,
+                                             responses_[num_responses].data);
+      if (size != 0) {
+        responses_[num_responses].size = size;
+        responses_[num_responses].addr = requests_[i].addr;
+        ++num_responses;
+      }
+    }
+    // Responses that don't fit into the send buffer are dropped; the clients
+    // retransmit their requests.
+    if (num_responses > 0 &&
+        socket_->SendToBatch(responses_, num_responses) < 0) {
+      LOG_ERR(LS_VERBOSE) << "sendto";
+    }
+  }
+
+  rtc::Thread thread_;
+  rtc::scoped_ptr<rtc::AsyncSocket> socket_;
+  rtc::scoped_ptr<char[]> buffers_;
+  rtc::SocketDatagram requests_[kBatchSize];
+  rtc::SocketDatagram responses_[kBatchSize];
+};
+
+StunBindingResponder::StunBindingResponder() {
+}
+
+StunBindingResponder::~StunBindingResponder() {
+  Stop();
+}
+
+bool StunBindingResponder::Start(const rtc::SocketAddress& address,
+                                 int num_threads) {
+  ASSERT(workers_.empty());
+  rtc::SocketAddress bind_address = address;
+  for (int i = 0; i < num_threads; ++i) {
+    Worker* worker = new Worker();
+    workers_.push_back(worker);
+    if (!worker->Bind(bind_address)) {
+      Stop();
+      return false;
+    }
+    // With port 0 the first socket picks the port for all of them.
+    bind_address = worker->address();
+  }
+  for (size_t i = 0; i < workers_.size(); ++i)
+    workers_[i]->Start();
+  return true;
+}
+
+void StunBindingResponder::Stop() {
+  for (size_t i = 0; i < workers_.size(); ++i)
+    delete workers_[i];
+  workers_.clear();
+}
+
+rtc::SocketAddress StunBindingResponder::address() const {
+  return workers_.empty() ? rtc::SocketAddress() : workers_[0]->address();
+}
+
+}  // namespace cricket
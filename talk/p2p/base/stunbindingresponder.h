@@ -0,0 +1,83 @@
+/*
+ * libjingle
+ * Copyright 2014, Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TALK_P2P_BASE_STUNBINDINGRESPONDER_H_
+#define TALK_P2P_BASE_STUNBINDINGRESPONDER_H_
+
+#include <vector>
+
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/socketaddress.h"
+
+namespace cricket {
+
+// Size of the largest response WriteStunBindingResponse() writes.
+const size_t kMaxStunBindingResponseSize = 52;
+
+// Writes the success response to the STUN Binding request |request| of |size|
+// bytes, received from |remote_addr|, to |response|, which must have room for
+// kMaxStunBindingResponseSize bytes. The response carries XOR-MAPPED-ADDRESS
+// and FINGERPRINT and is patched into a prebuilt template, so no StunMessage
+// is parsed or built. Returns the size of the response, or 0 if |request| is
+// not a well-formed RFC 5389 Binding request.
+size_t WriteStunBindingResponse(const char* request, size_t size,
+                                const rtc::SocketAddress& remote_addr,
+                                char* response);
+
+// Answers STUN Binding requests on a number of threads. Every thread binds its
+// own socket to the same address with SO_REUSEPORT, and the kernel spreads
+// the clients over the sockets by their 5-tuple. The threads read and answer
+// the requests in batches with WriteStunBindingResponse() and drop everything
+// else, so unlike StunServer this never sends error responses or answers
+// legacy RFC 3489 requests.
+class StunBindingResponder {
+ public:
+  StunBindingResponder();
+  ~StunBindingResponder();
+
+  // Binds |num_threads| sockets to |address| and starts answering on them.
+  // If the port of |address| is 0, all sockets share the port the first one
+  // gets. Returns false if a socket could not be bound.
+  bool Start(const rtc::SocketAddress& address, int num_threads);
+  // Stops the threads and closes the sockets.
+  void Stop();
+
+  // The address the sockets are bound to, once started.
+  rtc::SocketAddress address() const;
+
+ private:
+  class Worker;
+
+  std::vector<Worker*> workers_;
+
+  DISALLOW_COPY_AND_ASSIGN(StunBindingResponder);
+};
+
+}  // namespace cricket
+
+#endif  // TALK_P2P_BASE_STUNBINDINGRESPONDER_H_
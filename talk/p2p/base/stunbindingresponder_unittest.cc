@@ -0,0 +1,140 @@
+/*
+ * libjingle
+ * Copyright 2014, Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string>
+
+#include "talk/p2p/base/stun.h"
+#include "talk/p2p/base/stunbindingresponder.h"
+#include "webrtc/base/asyncudpsocket.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/testclient.h"
+#include "webrtc/base/thread.h"
+
+using namespace cricket;
+
+static const rtc::SocketAddress kClientAddrV4("1.2.3.4", 1234);
+static const rtc::SocketAddress kClientAddrV6("2001:db8::1:2:3:4", 5678);
+static const char kTransactionId[] = "0123456789ab";
+
+// Returns a Binding request with |transaction_id| and, if |fingerprint| is
+// set, a FINGERPRINT.
+static std::string CreateRequest(const std::string& transaction_id,
+                                 bool fingerprint) {
+  StunMessage req;
+  req.SetType(STUN_BINDING_REQUEST);
+  req.SetTransactionID(transaction_id);
+  if (fingerprint)
+    req.AddFingerprint();
+  rtc::ByteBuffer buf;
+  req.Write(&buf);
+  return std::string(buf.Data(), buf.Length());
+}
+
+// Answers |request| from |remote_addr| and checks that the response is what
+// StunMessage would have produced.
+static void ExpectResponse(const std::string& request,
+                           const rtc::SocketAddress& remote_addr) {
+  char response[kMaxStunBindingResponseSize];
+  size_t size = WriteStunBindingResponse(request.data(), request.size(),
+                                         remote_addr, response);
+  ASSERT_NE(0u, size);
+  EXPECT_TRUE(StunMessage::ValidateFingerprint(response, size));
+
+  rtc::ByteBuffer buf(response, size);
+  StunMessage msg;
+  ASSERT_TRUE(msg.Read(&buf));
+  EXPECT_EQ(STUN_BINDING_RESPONSE, msg.type());
+  EXPECT_EQ(kTransactionId, msg.transaction_id());
+  const StunAddressAttribute* mapped_addr =
+      msg.GetAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
+  ASSERT_TRUE(mapped_addr != NULL);
+  EXPECT_EQ(remote_addr.ipaddr(), mapped_addr->ipaddr());
+  EXPECT_EQ(remote_addr.port(), mapped_addr->port());
+}
+
+TEST(StunBindingResponderTest, WritesResponseV4) {
+  ExpectResponse(CreateRequest(kTransactionId, false), kClientAddrV4);
+  ExpectResponse(CreateRequest(kTransactionId, true), kClientAddrV4);
+}
+
+TEST(StunBindingResponderTest, WritesResponseV6) {
+  ExpectResponse(CreateRequest(kTransactionId, false), kClientAddrV6);
+  ExpectResponse(CreateRequest(kTransactionId, true), kClientAddrV6);
+}
+
+TEST(StunBindingResponderTest, RejectsOtherMessages) {
+  char response[kMaxStunBindingResponseSize];
+
+  // Legacy RFC 3489 requests have no magic cookie.
+  std::string legacy = CreateRequest("0123456789abcdef", false);
+  EXPECT_EQ(0u, WriteStunBindingResponse(legacy.data(), legacy.size(),
+                                         kClientAddrV4, response));
+
+  std::string request = CreateRequest(kTransactionId, true);
+  EXPECT_EQ(0u, WriteStunBindingResponse(request.data(), request.size() - 4,
+                                         kClientAddrV4, response));
+
+  std::string bad_fingerprint = request;
+  bad_fingerprint[bad_fingerprint.size() - 1] ^= 1;
+  EXPECT_EQ(0u, WriteStunBindingResponse(bad_fingerprint.data(),
+                                         bad_fingerprint.size(),
+                                         kClientAddrV4, response));
+
+  std::string allocate = request;
+  allocate[1] = STUN_ALLOCATE_REQUEST;
+  EXPECT_EQ(0u, WriteStunBindingResponse(allocate.data(), allocate.size(),
+                                         kClientAddrV4, response));
+
+  const char* bad = "this is a completely nonsensical message";
+  EXPECT_EQ(0u, WriteStunBindingResponse(bad, strlen(bad), kClientAddrV4,
+                                         response));
+}
+
+TEST(StunBindingResponderTest, AnswersOverUdp) {
+  StunBindingResponder responder;
+  ASSERT_TRUE(responder.Start(rtc::SocketAddress("127.0.0.1", 0), 2));
+  EXPECT_NE(0, responder.address().port());
+
+  rtc::TestClient client(rtc::AsyncUDPSocket::Create(
+      rtc::Thread::Current()->socketserver(),
+      rtc::SocketAddress("127.0.0.1", 0)));
+  std::string request = CreateRequest(kTransactionId, true);
+  client.SendTo(request.data(), request.size(), responder.address());
+
+  rtc::scoped_ptr<rtc::TestClient::Packet> packet(client.NextPacket());
+  ASSERT_TRUE(packet.get() != NULL);
+  rtc::ByteBuffer buf(packet->buf, packet->size);
+  StunMessage msg;
+  ASSERT_TRUE(msg.Read(&buf));
+  EXPECT_EQ(STUN_BINDING_RESPONSE, msg.type());
+  const StunAddressAttribute* mapped_addr =
+      msg.GetAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
+  ASSERT_TRUE(mapped_addr != NULL);
+  EXPECT_EQ(client.address().port(), mapped_addr->port());
+}
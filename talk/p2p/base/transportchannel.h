@@ -123,8 +123,8 @@ class TransportChannel : public sigslot::has_slots<> {
       size_t result_len) = 0;
 
   // Signalled each time a packet is received on this channel.
-  sigslot::signal5<TransportChannel*, const char*,
-                   size_t, const rtc::PacketTime&, int> SignalReadPacket;
+  sigslot::st_signal5<TransportChannel*, const char*,
+                      size_t, const rtc::PacketTime&, int> SignalReadPacket;
 
   // This signal occurs when there is a change in the way that packets are
   // being routed, i.e. to a different remote location. The candidate
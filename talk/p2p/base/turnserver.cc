@@ -62,6 +62,91 @@ inline bool IsTurnChannelData(uint16 msg_type) {
   return ((msg_type & 0xC000) == 0x4000);
 }
 
+// Attributes are padded to a multiple of four bytes.
+static size_t PaddedLength(size_t length) {
+  return (length + 3) & ~static_cast<size_t>(3);
+}
+
+// The XOR-PEER-ADDRESS of a message is masked with its magic cookie and
+// transaction ID, which are the 16 bytes after the message type and length.
+static const size_t kStunXorKeyOffset = 4;
+static const size_t kStunXorKeyLength =
+    kStunMagicCookieLength + kStunTransactionIdLength;
+
+// Reads the XOR-PEER-ADDRESS attribute |value| of the message starting at
+// |msg| in place.
+static bool ReadXorPeerAddress(const char* msg, const char* value,
+                               size_t length, rtc::SocketAddress* addr) {
+  if (length < 4)
+    return false;
+  const char* xor_key = msg + kStunXorKeyOffset;
+  uint16 port = rtc::GetBE16(value + 2) ^ (kStunMagicCookie >> 16);
+  uint8 family = static_cast<uint8>(value[1]);
+  if (family == STUN_ADDRESS_IPV4 && length == 4 + sizeof(in_addr)) {
+    in_addr v4addr;
+    uint8* bytes = reinterpret_cast<uint8*>(&v4addr);
+    for (size_t i = 0; i < sizeof(v4addr); ++i)
+      bytes[i] = value[4 + i] ^ xor_key[i];
+    *addr = rtc::SocketAddress(rtc::IPAddress(v4addr), port);
+  } else if (family == STUN_ADDRESS_IPV6 && length == 4 + sizeof(in6_addr)) {
+    in6_addr v6addr;
+    uint8* bytes = reinterpret_cast<uint8*>(&v6addr);
+    for (size_t i = 0; i < sizeof(v6addr); ++i)
+      bytes[i] = value[4 + i] ^ xor_key[i];
+    *addr = rtc::SocketAddress(rtc::IPAddress(v6addr), port);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Extracts the peer address and the data of a send indication straight from
+// the packet, without building a TurnMessage; |payload| points into |data|.
+// Returns false if this isn't a well-formed RFC 5389 send indication, in
+// which case it's left to the full parser.
+static bool ParseSendIndication(const char* data, size_t size,
+                                rtc::SocketAddress* peer,
+                                const char** payload, size_t* payload_size) {
+  if (size < kStunHeaderSize ||
+      rtc::GetBE16(data) != TURN_SEND_INDICATION ||
+      rtc::GetBE16(data + 2) != size - kStunHeaderSize ||
+      rtc::GetBE32(data + 4) != kStunMagicCookie) {
+    return false;
+  }
+  bool has_peer = false;
+  bool has_data = false;
+  size_t pos = kStunHeaderSize;
+  while (pos + kStunAttributeHeaderSize <= size) {
+    uint16 type = rtc::GetBE16(data + pos);
+    size_t length = rtc::GetBE16(data + pos + 2);
+    pos += kStunAttributeHeaderSize;
+    if (length > size - pos)
+      return false;
+    // Like StunMessage, the first of several equal attributes counts.
+    if (type == STUN_ATTR_XOR_PEER_ADDRESS && !has_peer) {
+      if (!ReadXorPeerAddress(data, data + pos, length, peer))
+        return false;
+      has_peer = true;
+    } else if (type == STUN_ATTR_DATA && !has_data) {
+      *payload = data + pos;
+      *payload_size = length;
+      has_data = true;
+    }
+    pos += PaddedLength(length);
+  }
+  return pos == size && has_peer && has_data;
+}
+
+// Appends a STUN attribute, with its padding.
+static void WriteStunAttribute(uint16 type, const char* value, size_t length,
+                               rtc::ByteBuffer* buf) {
+  static const char kPadding[3] = {0};
+  buf->WriteUInt16(type);
+  buf->WriteUInt16(static_cast<uint16>(length));
+  buf->WriteBytes(value, length);
+  buf->WriteBytes(kPadding, PaddedLength(length) - length);
+}
+
 // IDs used for posted messages.
 enum {
   MSG_TIMEOUT,
@@ -92,12 +177,18 @@ class TurnServer::Allocation : public rtc::MessageHandler,
 
   void HandleTurnMessage(const TurnMessage* msg);
   void HandleChannelData(const char* data, size_t size);
+  // Relays the data of a send indication (see ParseSendIndication).
+  void HandleSendIndication(const rtc::SocketAddress& peer,
+                            const char* data, size_t size);
 
   sigslot::signal1<Allocation*> SignalDestroyed;
 
  private:
-  typedef std::list<Permission*> PermissionList;
-  typedef std::list<Channel*> ChannelList;
+  // Every relayed packet looks up its channel or permission, so they are
+  // kept keyed rather than in lists.
+  typedef std::map<rtc::IPAddress, Permission*> PermissionMap;
+  typedef std::map<int, Channel*> ChannelIdMap;
+  typedef std::map<rtc::SocketAddress, Channel*> ChannelAddressMap;
 
   void HandleAllocateRequest(const TurnMessage* msg);
   void HandleRefreshRequest(const TurnMessage* msg);
@@ -123,6 +214,8 @@ class TurnServer::Allocation : public rtc::MessageHandler,
                          const std::string& reason);
   void SendExternal(const void* data, size_t size,
                     const rtc::SocketAddress& peer);
+  void SendDataIndication(const rtc::SocketAddress& peer,
+                          const char* data, size_t size);
 
   void OnPermissionDestroyed(Permission* perm);
   void OnChannelDestroyed(Channel* channel);
@@ -133,11 +226,15 @@ class TurnServer::Allocation : public rtc::MessageHandler,
   Connection conn_;
   rtc::scoped_ptr<rtc::AsyncPacketSocket> external_socket_;
   std::string key_;
+  StunMessageIntegrityKey integrity_key_;
   std::string transaction_id_;
   std::string username_;
   std::string last_nonce_;
-  PermissionList perms_;
-  ChannelList channels_;
+  PermissionMap perms_;
+  ChannelIdMap channels_by_id_;
+  ChannelAddressMap channels_by_addr_;
+  // Reused for every packet relayed to the client.
+  rtc::ByteBuffer relay_buf_;
 };
 
 // Encapsulates a TURN permission.
@@ -289,7 +386,18 @@ void TurnServer::OnInternalPacket(rtc::AsyncPacketSocket* socket,
   ASSERT(iter != server_sockets_.end());
   Connection conn(addr, iter->second, socket);
   uint16 msg_type = rtc::GetBE16(data);
-  if (!IsTurnChannelData(msg_type)) {
+  rtc::SocketAddress peer;
+  const char* payload;
+  size_t payload_size;
+  if (msg_type == TURN_SEND_INDICATION &&
+      ParseSendIndication(data, size, &peer, &payload, &payload_size)) {
+    // Send indications carry data, and need neither authorization nor a
+    // response, so they skip the full STUN parsing.
+    Allocation* allocation = FindAllocation(&conn);
+    if (allocation) {
+      allocation->HandleSendIndication(peer, payload, payload_size);
+    }
+  } else if (!IsTurnChannelData(msg_type)) {
     // This is a STUN message.
     HandleStunMessage(&conn, data, size);
   } else {
@@ -628,19 +736,20 @@ TurnServer::Allocation::Allocation(TurnServer* server,
       thread_(thread),
       conn_(conn),
       external_socket_(socket),
-      key_(key) {
+      key_(key),
+      integrity_key_(key) {
   external_socket_->SignalReadPacket.connect(
       this, &TurnServer::Allocation::OnExternalPacket);
 }
 
 TurnServer::Allocation::~Allocation() {
-  for (ChannelList::iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    delete *it;
+  for (ChannelIdMap::iterator it = channels_by_id_.begin();
+       it != channels_by_id_.end(); ++it) {
+    delete it->second;
   }
-  for (PermissionList::iterator it = perms_.begin();
+  for (PermissionMap::iterator it = perms_.begin();
        it != perms_.end(); ++it) {
-    delete *it;
+    delete it->second;
   }
   thread_->Clear(this, MSG_TIMEOUT);
   LOG_J(LS_INFO, this) << "Allocation destroyed";
@@ -740,13 +849,18 @@ void TurnServer::Allocation::HandleSendIndication(const TurnMessage* msg) {
     return;
   }
 
+  HandleSendIndication(peer_attr->GetAddress(), data_attr->bytes(),
+                       data_attr->length());
+}
+
+void TurnServer::Allocation::HandleSendIndication(
+    const rtc::SocketAddress& peer, const char* data, size_t size) {
   // If a permission exists, send the data on to the peer.
-  if (HasPermission(peer_attr->GetAddress().ipaddr())) {
-    SendExternal(data_attr->bytes(), data_attr->length(),
-                 peer_attr->GetAddress());
+  if (HasPermission(peer.ipaddr())) {
+    SendExternal(data, size, peer);
   } else {
     LOG_J(LS_WARNING, this) << "Received send indication without permission"
-                            << "peer=" << peer_attr->GetAddress();
+                            << "peer=" << peer;
   }
 }
 
@@ -804,7 +918,8 @@ void TurnServer::Allocation::HandleChannelBindRequest(const TurnMessage* msg) {
     channel1 = new Channel(thread_, channel_id, peer_attr->GetAddress());
     channel1->SignalDestroyed.connect(this,
         &TurnServer::Allocation::OnChannelDestroyed);
-    channels_.push_back(channel1);
+    channels_by_id_[channel_id] = channel1;
+    channels_by_addr_[channel1->peer()] = channel1;
   } else {
     channel1->Refresh();
   }
@@ -844,22 +959,14 @@ void TurnServer::Allocation::OnExternalPacket(
   Channel* channel = FindChannel(addr);
   if (channel) {
     // There is a channel bound to this address. Send as a channel message.
-    rtc::ByteBuffer buf;
-    buf.WriteUInt16(channel->id());
-    buf.WriteUInt16(static_cast<uint16>(size));
-    buf.WriteBytes(data, size);
-    server_->Send(&conn_, buf);
+    relay_buf_.Clear();
+    relay_buf_.WriteUInt16(channel->id());
+    relay_buf_.WriteUInt16(static_cast<uint16>(size));
+    relay_buf_.WriteBytes(data, size);
+    server_->Send(&conn_, relay_buf_);
   } else if (HasPermission(addr.ipaddr())) {
     // No channel, but a permission exists. Send as a data indication.
-    TurnMessage msg;
-    msg.SetType(TURN_DATA_INDICATION);
-    msg.SetTransactionID(
-        rtc::CreateRandomString(kStunTransactionIdLength));
-    VERIFY(msg.AddAttribute(new StunXorAddressAttribute(
-        STUN_ATTR_XOR_PEER_ADDRESS, addr)));
-    VERIFY(msg.AddAttribute(new StunByteStringAttribute(
-        STUN_ATTR_DATA, data, size)));
-    server_->SendStun(&conn_, &msg);
+    SendDataIndication(addr, data, size);
   } else {
     LOG_J(LS_WARNING, this) << "Received external packet without permission, "
                             << "peer=" << addr;
@@ -886,7 +993,7 @@ void TurnServer::Allocation::AddPermission(const rtc::IPAddress& addr) {
     perm = new Permission(thread_, addr);
     perm->SignalDestroyed.connect(
         this, &TurnServer::Allocation::OnPermissionDestroyed);
-    perms_.push_back(perm);
+    perms_[addr] = perm;
   } else {
     perm->Refresh();
   }
@@ -894,36 +1001,24 @@ void TurnServer::Allocation::AddPermission(const rtc::IPAddress& addr) {
 
 TurnServer::Permission* TurnServer::Allocation::FindPermission(
     const rtc::IPAddress& addr) const {
-  for (PermissionList::const_iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  PermissionMap::const_iterator it = perms_.find(addr);
+  return (it != perms_.end()) ? it->second : NULL;
 }
 
 TurnServer::Channel* TurnServer::Allocation::FindChannel(int channel_id) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->id() == channel_id)
-      return *it;
-  }
-  return NULL;
+  ChannelIdMap::const_iterator it = channels_by_id_.find(channel_id);
+  return (it != channels_by_id_.end()) ? it->second : NULL;
 }
 
 TurnServer::Channel* TurnServer::Allocation::FindChannel(
     const rtc::SocketAddress& addr) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  ChannelAddressMap::const_iterator it = channels_by_addr_.find(addr);
+  return (it != channels_by_addr_.end()) ? it->second : NULL;
 }
 
 void TurnServer::Allocation::SendResponse(TurnMessage* msg) {
   // Success responses always have M-I.
-  msg->AddMessageIntegrity(key_);
+  msg->AddMessageIntegrity(integrity_key_);
   server_->SendStun(&conn_, msg);
 }
 
@@ -942,6 +1037,58 @@ void TurnServer::Allocation::SendExternal(const void* data, size_t size,
   external_socket_->SendTo(data, size, peer, options);
 }
 
+void TurnServer::Allocation::SendDataIndication(
+    const rtc::SocketAddress& peer, const char* data, size_t size) {
+  // Written directly rather than through a TurnMessage, as this is on the
+  // data path: the header, then XOR-PEER-ADDRESS, DATA and SOFTWARE.
+  char xor_key[kStunXorKeyLength];
+  rtc::SetBE32(xor_key, kStunMagicCookie);
+  for (size_t i = kStunMagicCookieLength; i < kStunXorKeyLength;
+       i += sizeof(uint32)) {
+    rtc::SetBE32(xor_key + i, rtc::CreateRandomId());
+  }
+
+  char addr[4 + sizeof(in6_addr)];
+  size_t addr_length = 4;
+  addr[0] = 0;
+  rtc::SetBE16(addr + 2, peer.port() ^ (kStunMagicCookie >> 16));
+  const rtc::IPAddress& ip = peer.ipaddr();
+  if (ip.family() == AF_INET) {
+    addr[1] = STUN_ADDRESS_IPV4;
+    in_addr v4addr = ip.ipv4_address();
+    memcpy(addr + 4, &v4addr, sizeof(v4addr));
+    addr_length += sizeof(v4addr);
+  } else {
+    ASSERT(ip.family() == AF_INET6);
+    addr[1] = STUN_ADDRESS_IPV6;
+    in6_addr v6addr = ip.ipv6_address();
+    memcpy(addr + 4, &v6addr, sizeof(v6addr));
+    addr_length += sizeof(v6addr);
+  }
+  for (size_t i = 4; i < addr_length; ++i)
+    addr[i] ^= xor_key[i - 4];
+
+  const std::string& software = server_->software();
+  size_t length = kStunAttributeHeaderSize + addr_length +
+                  kStunAttributeHeaderSize + PaddedLength(size);
+  if (!software.empty())
+    length += kStunAttributeHeaderSize + PaddedLength(software.size());
+
+  relay_buf_.Clear();
+  relay_buf_.WriteUInt16(TURN_DATA_INDICATION);
+  relay_buf_.WriteUInt16(static_cast<uint16>(length));
+  relay_buf_.WriteBytes(xor_key, kStunXorKeyLength);
+  WriteStunAttribute(STUN_ATTR_XOR_PEER_ADDRESS, addr, addr_length,
+                     &relay_buf_);
+  WriteStunAttribute(STUN_ATTR_DATA, data, size, &relay_buf_);
+  if (!software.empty()) {
+    WriteStunAttribute(STUN_ATTR_SOFTWARE, software.data(), software.size(),
+                       &relay_buf_);
+  }
+  ASSERT(relay_buf_.Length() == kStunHeaderSize + length);
+  server_->Send(&conn_, relay_buf_);
+}
+
 void TurnServer::Allocation::OnMessage(rtc::Message* msg) {
   ASSERT(msg->message_id == MSG_TIMEOUT);
   SignalDestroyed(this);
@@ -949,16 +1096,16 @@ void TurnServer::Allocation::OnMessage(rtc::Message* msg) {
 }
 
 void TurnServer::Allocation::OnPermissionDestroyed(Permission* perm) {
-  PermissionList::iterator it = std::find(perms_.begin(), perms_.end(), perm);
-  ASSERT(it != perms_.end());
+  PermissionMap::iterator it = perms_.find(perm->peer());
+  ASSERT(it != perms_.end() && it->second == perm);
   perms_.erase(it);
 }
 
 void TurnServer::Allocation::OnChannelDestroyed(Channel* channel) {
-  ChannelList::iterator it =
-      std::find(channels_.begin(), channels_.end(), channel);
-  ASSERT(it != channels_.end());
-  channels_.erase(it);
+  ASSERT(channels_by_id_.find(channel->id()) != channels_by_id_.end());
+  ASSERT(channels_by_addr_.find(channel->peer()) != channels_by_addr_.end());
+  channels_by_id_.erase(channel->id());
+  channels_by_addr_.erase(channel->peer());
 }
 
 TurnServer::Permission::Permission(rtc::Thread* thread,
@@ -33,6 +33,7 @@
 #include "webrtc/base/common.h"
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "talk/p2p/base/basicpacketsocketfactory.h"
 #include "talk/p2p/base/common.h"
 #include "talk/p2p/base/port.h"
@@ -246,7 +247,8 @@ BasicPortAllocatorSession::BasicPortAllocatorSession(
       allocation_started_(false),
       network_manager_started_(false),
       running_(false),
-      allocation_sequences_created_(false) {
+      allocation_sequences_created_(false),
+      start_time_(0) {
   allocator_->network_manager()->SignalNetworksChanged.connect(
       this, &BasicPortAllocatorSession::OnNetworksChanged);
   allocator_->network_manager()->StartUpdating();
@@ -283,12 +285,17 @@ void BasicPortAllocatorSession::StartGettingPorts() {
   }
 
   running_ = true;
+  start_time_ = rtc::Time();
   network_thread_->Post(this, MSG_CONFIG_START);
 
   if (flags() & PORTALLOCATOR_ENABLE_SHAKER)
     network_thread_->PostDelayed(ShakeDelay(), this, MSG_SHAKE);
 }
 
+int BasicPortAllocatorSession::ElapsedTime() const {
+  return rtc::TimeSince(start_time_);
+}
+
 void BasicPortAllocatorSession::StopGettingPorts() {
   ASSERT(rtc::Thread::Current() == network_thread_);
   running_ = false;
@@ -543,6 +550,8 @@ void BasicPortAllocatorSession::OnCandidateReady(
   // Since this port has atleast one candidate we should forward this port
   // to listners, to allow connections from this port.
   if (!data->ready()) {
+    LOG_J(LS_INFO, port) << "First candidate ready after "
+                         << ElapsedTime() << " ms";
     data->set_ready();
     SignalPortReady(this, port);
   }
@@ -630,7 +639,8 @@ void BasicPortAllocatorSession::MaybeSignalCandidatesAllocationDone() {
       return;
   }
   LOG(LS_INFO) << "All candidates gathered for " << content_name_ << ":"
-               << component_ << ":" << generation();
+               << component_ << ":" << generation() << " after "
+               << ElapsedTime() << " ms";
   SignalCandidatesAllocationDone(this);
 }
 
@@ -789,37 +799,46 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
     "Udp", "Relay", "Tcp", "SslTcp"
   };
 
-  // Perform all of the phases in the current step.
-  LOG_J(LS_INFO, network_) << "Allocation Phase="
-                           << PHASE_NAMES[phase_];
+  // Perform all of the phases in the current step. With parallel phases,
+  // that is all of the remaining ones.
+  while (true) {
+    LOG_J(LS_INFO, network_) << "Allocation Phase="
+                             << PHASE_NAMES[phase_] << " after "
+                             << session_->ElapsedTime() << " ms";
+
+    switch (phase_) {
+      case PHASE_UDP:
+        CreateUDPPorts();
+        CreateStunPorts();
+        EnableProtocol(PROTO_UDP);
+        break;
 
-  switch (phase_) {
-    case PHASE_UDP:
-      CreateUDPPorts();
-      CreateStunPorts();
-      EnableProtocol(PROTO_UDP);
-      break;
+      case PHASE_RELAY:
+        CreateRelayPorts();
+        break;
 
-    case PHASE_RELAY:
-      CreateRelayPorts();
-      break;
+      case PHASE_TCP:
+        CreateTCPPorts();
+        EnableProtocol(PROTO_TCP);
+        break;
 
-    case PHASE_TCP:
-      CreateTCPPorts();
-      EnableProtocol(PROTO_TCP);
-      break;
+      case PHASE_SSLTCP:
+        state_ = kCompleted;
+        EnableProtocol(PROTO_SSLTCP);
+        break;
 
-    case PHASE_SSLTCP:
-      state_ = kCompleted;
-      EnableProtocol(PROTO_SSLTCP);
-      break;
+      default:
+        ASSERT(false);
+    }
 
-    default:
-      ASSERT(false);
+    if (state() != kRunning)
+      break;
+    ++phase_;
+    if (!IsFlagSet(PORTALLOCATOR_ENABLE_PARALLEL_PHASES))
+      break;
   }
 
   if (state() == kRunning) {
-    ++phase_;
     session_->network_thread()->PostDelayed(
         session_->allocator()->step_delay(),
         this, MSG_ALLOCATION_PHASE);
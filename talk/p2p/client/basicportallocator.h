@@ -131,6 +131,10 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   virtual void StopGettingPorts();
   virtual bool IsGettingPorts() { return running_; }
 
+  // Milliseconds since StartGettingPorts, for logging how long each part of
+  // the gathering takes.
+  int ElapsedTime() const;
+
  protected:
   // Starts the process of getting the port configurations.
   virtual void GetPortConfigurations();
@@ -209,6 +213,7 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   bool network_manager_started_;
   bool running_;  // set when StartGetAllPorts is called
   bool allocation_sequences_created_;
+  uint32 start_time_;
   std::vector<PortConfiguration*> configs_;
   std::vector<AllocationSequence*> sequences_;
   std::vector<PortData> ports_;
@@ -27,6 +27,8 @@
 
 #include "talk/session/media/bundlefilter.h"
 
+#include <algorithm>
+
 #include "webrtc/base/logging.h"
 #include "talk/media/base/rtputils.h"
 
@@ -80,7 +82,12 @@ bool BundleFilter::DemuxPacket(const char* data, size_t len, bool rtcp) {
 }
 
 void BundleFilter::AddPayloadType(int payload_type) {
-  payload_types_.insert(payload_type);
+  if (payload_type < 0 || payload_type > kMaxPayloadType) {
+    LOG(LS_WARNING) << "Invalid payload type " << payload_type
+                    << " not added to filter";
+    return;
+  }
+  payload_types_.set(payload_type);
 }
 
 bool BundleFilter::AddStream(const StreamParams& stream) {
@@ -89,11 +96,15 @@ bool BundleFilter::AddStream(const StreamParams& stream) {
       return false;
   }
   streams_.push_back(stream);
+  UpdateSsrcs();
   return true;
 }
 
 bool BundleFilter::RemoveStream(uint32 ssrc) {
-  return RemoveStreamBySsrc(&streams_, ssrc);
+  if (!RemoveStreamBySsrc(&streams_, ssrc))
+    return false;
+  UpdateSsrcs();
+  return true;
 }
 
 bool BundleFilter::HasStreams() const {
@@ -104,15 +115,26 @@ bool BundleFilter::FindStream(uint32 ssrc) const {
   if (ssrc == 0) {
     return false;
   }
-  return (GetStreamBySsrc(streams_, ssrc, NULL));
+  return std::binary_search(ssrcs_.begin(), ssrcs_.end(), ssrc);
 }
 
 bool BundleFilter::FindPayloadType(int pl_type) const {
-  return payload_types_.find(pl_type) != payload_types_.end();
+  if (pl_type < 0 || pl_type > kMaxPayloadType)
+    return false;
+  return payload_types_.test(pl_type);
 }
 
 void BundleFilter::ClearAllPayloadTypes() {
-  payload_types_.clear();
+  payload_types_.reset();
+}
+
+void BundleFilter::UpdateSsrcs() {
+  ssrcs_.clear();
+  for (std::vector<StreamParams>::const_iterator it = streams_.begin();
+       it != streams_.end(); ++it) {
+    ssrcs_.insert(ssrcs_.end(), it->ssrcs.begin(), it->ssrcs.end());
+  }
+  std::sort(ssrcs_.begin(), ssrcs_.end());
 }
 
 }  // namespace cricket
@@ -28,7 +28,7 @@
 #ifndef TALK_SESSION_MEDIA_BUNDLEFILTER_H_
 #define TALK_SESSION_MEDIA_BUNDLEFILTER_H_
 
-#include <set>
+#include <bitset>
 #include <vector>
 
 #include "webrtc/base/basictypes.h"
@@ -45,6 +45,11 @@ namespace cricket {
 // This class determines whether a packet is destined for cricket::BaseChannel.
 // For rtp packets, this is decided based on the payload type. For rtcp packets,
 // this is decided based on the sender ssrc values.
+//
+// Every packet received on the shared transport is run through the filter of
+// each channel, so the lookups are kept constant or logarithmic: the payload
+// types are a bit per possible 7-bit value, and the ssrcs of all the added
+// streams, including their RTX and FEC ssrcs, are kept in one sorted vector.
 class BundleFilter {
  public:
   BundleFilter();
@@ -69,10 +74,17 @@ class BundleFilter {
   bool FindPayloadType(int pl_type) const;
   void ClearAllPayloadTypes();
 
-
  private:
-  std::set<int> payload_types_;
+  // RTP payload types are 7 bits.
+  static const int kMaxPayloadType = 127;
+
+  // Rebuilds |ssrcs_| from |streams_|.
+  void UpdateSsrcs();
+
+  std::bitset<kMaxPayloadType + 1> payload_types_;
   std::vector<StreamParams> streams_;
+  // The sorted ssrcs of all of |streams_|.
+  std::vector<uint32> ssrcs_;
 };
 
 }  // namespace cricket
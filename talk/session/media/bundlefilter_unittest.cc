@@ -211,3 +211,33 @@ TEST(BundleFilterTest, InvalidRtpPacket) {
       reinterpret_cast<const char*>(kSctpPacket),
       sizeof(kSctpPacket), false));
 }
+
+TEST(BundleFilterTest, RtcpFromSecondarySsrcOfStream) {
+  cricket::BundleFilter bundle_filter;
+  StreamParams stream;
+  stream.ssrcs.push_back(kSsrc3);
+  stream.ssrcs.push_back(kSsrc1);
+  EXPECT_TRUE(bundle_filter.AddStream(stream));
+  EXPECT_TRUE(bundle_filter.AddStream(StreamParams::CreateLegacy(kSsrc2)));
+  // SR from the second ssrc of the first stream.
+  EXPECT_TRUE(bundle_filter.DemuxPacket(
+      reinterpret_cast<const char*>(kRtcpPacketCompoundSrSdesSsrc1),
+      sizeof(kRtcpPacketCompoundSrSdesSsrc1), true));
+  EXPECT_TRUE(bundle_filter.RemoveStream(kSsrc3));
+  EXPECT_FALSE(bundle_filter.FindStream(kSsrc1));
+  EXPECT_TRUE(bundle_filter.FindStream(kSsrc2));
+  EXPECT_FALSE(bundle_filter.DemuxPacket(
+      reinterpret_cast<const char*>(kRtcpPacketCompoundSrSdesSsrc1),
+      sizeof(kRtcpPacketCompoundSrSdesSsrc1), true));
+}
+
+TEST(BundleFilterTest, InvalidPayloadTypeNotAdded) {
+  cricket::BundleFilter bundle_filter;
+  bundle_filter.AddPayloadType(-1);
+  bundle_filter.AddPayloadType(128);
+  EXPECT_FALSE(bundle_filter.FindPayloadType(-1));
+  EXPECT_FALSE(bundle_filter.FindPayloadType(128));
+  bundle_filter.AddPayloadType(127);
+  EXPECT_TRUE(bundle_filter.FindPayloadType(127));
+  EXPECT_FALSE(bundle_filter.FindPayloadType(kPayloadType1));
+}
@@ -188,7 +188,8 @@ BaseChannel::BaseChannel(rtc::Thread* thread,
       has_received_packet_(false),
       dtls_keyed_(false),
       secure_required_(false),
-      rtp_abs_sendtime_extn_id_(-1) {
+      rtp_abs_sendtime_extn_id_(-1),
+      handling_recv_packet_(false) {
   ASSERT(worker_thread_ == rtc::Thread::Current());
   LOG(LS_INFO) << "Created channel for " << content_name;
 }
@@ -387,8 +388,20 @@ void BaseChannel::OnChannelRead(TransportChannel* channel,
   // When using RTCP multiplexing we might get RTCP packets on the RTP
   // transport. We feed RTP traffic into the demuxer to determine if it is RTCP.
   bool rtcp = PacketIsRtcp(channel, data, len);
-  rtc::Buffer packet(data, len);
-  HandlePacket(rtcp, &packet, packet_time);
+
+  // This is the one copy an incoming packet gets on its way from the socket
+  // to the media channel: SRTP is unprotected in place. The buffer is kept
+  // so that its memory is reused for the next packet, unless this packet
+  // arrived while another one is still being handled from it.
+  if (handling_recv_packet_) {
+    rtc::Buffer packet(data, len);
+    HandlePacket(rtcp, &packet, packet_time);
+    return;
+  }
+  handling_recv_packet_ = true;
+  recv_packet_.SetData(data, len);
+  HandlePacket(rtcp, &recv_packet_, packet_time);
+  handling_recv_packet_ = false;
 }
 
 void BaseChannel::OnReadyToSend(TransportChannel* channel) {
@@ -799,9 +812,15 @@ bool BaseChannel::SetupDtlsSrtp(bool rtcp_channel) {
                << content_name() << " "
                << PacketType(rtcp_channel);
 
+  int key_len;
+  int salt_len;
+  if (!GetSrtpKeyAndSaltLengths(selected_cipher, &key_len, &salt_len)) {
+    LOG(LS_ERROR) << "Unsupported DTLS-SRTP cipher " << selected_cipher;
+    return false;
+  }
+
   // OK, we're now doing DTLS (RFC 5764)
-  std::vector<unsigned char> dtls_buffer(SRTP_MASTER_KEY_KEY_LEN * 2 +
-                                         SRTP_MASTER_KEY_SALT_LEN * 2);
+  std::vector<unsigned char> dtls_buffer(key_len * 2 + salt_len * 2);
 
   // RFC 5705 exporter using the RFC 5764 parameters
   if (!channel->ExportKeyingMaterial(
@@ -814,22 +833,16 @@ bool BaseChannel::SetupDtlsSrtp(bool rtcp_channel) {
   }
 
   // Sync up the keys with the DTLS-SRTP interface
-  std::vector<unsigned char> client_write_key(SRTP_MASTER_KEY_KEY_LEN +
-    SRTP_MASTER_KEY_SALT_LEN);
-  std::vector<unsigned char> server_write_key(SRTP_MASTER_KEY_KEY_LEN +
-    SRTP_MASTER_KEY_SALT_LEN);
+  std::vector<unsigned char> client_write_key(key_len + salt_len);
+  std::vector<unsigned char> server_write_key(key_len + salt_len);
   size_t offset = 0;
-  memcpy(&client_write_key[0], &dtls_buffer[offset],
-    SRTP_MASTER_KEY_KEY_LEN);
-  offset += SRTP_MASTER_KEY_KEY_LEN;
-  memcpy(&server_write_key[0], &dtls_buffer[offset],
-    SRTP_MASTER_KEY_KEY_LEN);
-  offset += SRTP_MASTER_KEY_KEY_LEN;
-  memcpy(&client_write_key[SRTP_MASTER_KEY_KEY_LEN],
-    &dtls_buffer[offset], SRTP_MASTER_KEY_SALT_LEN);
-  offset += SRTP_MASTER_KEY_SALT_LEN;
-  memcpy(&server_write_key[SRTP_MASTER_KEY_KEY_LEN],
-    &dtls_buffer[offset], SRTP_MASTER_KEY_SALT_LEN);
+  memcpy(&client_write_key[0], &dtls_buffer[offset], key_len);
+  offset += key_len;
+  memcpy(&server_write_key[0], &dtls_buffer[offset], key_len);
+  offset += key_len;
+  memcpy(&client_write_key[key_len], &dtls_buffer[offset], salt_len);
+  offset += salt_len;
+  memcpy(&server_write_key[key_len], &dtls_buffer[offset], salt_len);
 
   std::vector<unsigned char> *send_key, *recv_key;
   rtc::SSLRole role;
@@ -2184,6 +2197,21 @@ bool DataChannel::SendData(const SendDataParams& params,
                              media_channel(), params, payload, result));
 }
 
+size_t DataChannel::SendDataBatch(
+    const std::vector<SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    SendDataResult* result) {
+  return worker_thread()->Invoke<size_t>(Bind(
+      &DataChannel::SendDataBatch_w, this, params, payloads, result));
+}
+
+size_t DataChannel::SendDataBatch_w(
+    const std::vector<SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    SendDataResult* result) {
+  return media_channel()->SendDataBatch(params, payloads, result);
+}
+
 const ContentInfo* DataChannel::GetFirstContent(
     const SessionDescription* sdesc) {
   return GetFirstDataContent(sdesc);
@@ -393,6 +393,10 @@ class BaseChannel
   bool dtls_keyed_;
   bool secure_required_;
   int rtp_abs_sendtime_extn_id_;
+  // The buffer incoming packets are copied into, reused from one packet to
+  // the next, and whether a packet is being handled from it.
+  rtc::Buffer recv_packet_;
+  bool handling_recv_packet_;
 };
 
 // VoiceChannel is a specialization that adds support for early media, DTMF,
@@ -625,6 +629,11 @@ class DataChannel : public BaseChannel {
   virtual bool SendData(const SendDataParams& params,
                         const rtc::Buffer& payload,
                         SendDataResult* result);
+  // Sends the payloads in order with a single hop to the worker thread, and
+  // stops at the first one which fails. Returns the number sent.
+  virtual size_t SendDataBatch(const std::vector<SendDataParams>& params,
+                               const std::vector<const rtc::Buffer*>& payloads,
+                               SendDataResult* result);
 
   void StartMediaMonitor(int cms);
   void StopMediaMonitor();
@@ -705,6 +714,9 @@ class DataChannel : public BaseChannel {
   virtual bool SetRemoteContent_w(const MediaContentDescription* content,
                                   ContentAction action,
                                   std::string* error_desc);
+  size_t SendDataBatch_w(const std::vector<SendDataParams>& params,
+                         const std::vector<const rtc::Buffer*>& payloads,
+                         SendDataResult* result);
   virtual void ChangeState();
   virtual bool WantsPacket(bool rtcp, rtc::Buffer* packet);
 
@@ -54,6 +54,7 @@ namespace cricket {
 
 enum {
   MSG_VIDEOCAPTURESTATE = 1,
+  MSG_PREWARMMEDIACHANNELS,
 };
 
 using rtc::Bind;
@@ -68,6 +69,12 @@ struct CaptureStateParams : public rtc::MessageData {
   cricket::CaptureState state;
 };
 
+struct PrewarmParams : public rtc::MessageData {
+  PrewarmParams(bool a, bool v) : audio(a), video(v) {}
+  bool audio;
+  bool video;
+};
+
 static DataEngineInterface* ConstructDataEngine() {
 #ifdef HAVE_SCTP
   return new HybridDataEngine(new RtpDataEngine(), new SctpDataEngine());
@@ -123,6 +130,9 @@ void ChannelManager::Construct(MediaEngineInterface* me,
   audio_delay_offset_ = MediaEngineInterface::kDefaultAudioDelayOffset;
   audio_output_volume_ = kNotSetOutputVolume;
   local_renderer_ = NULL;
+  prewarmed_voice_channel_ = NULL;
+  prewarmed_video_channel_ = NULL;
+  prewarmed_video_voice_channel_ = NULL;
   capturing_ = false;
   monitoring_ = false;
   enable_rtx_ = false;
@@ -298,6 +308,10 @@ void ChannelManager::Terminate() {
 
 void ChannelManager::Terminate_w() {
   ASSERT(worker_thread_ == rtc::Thread::Current());
+  worker_thread_->Clear(this, MSG_PREWARMMEDIACHANNELS);
+  DestroyPrewarmedVideoChannel_w();
+  delete prewarmed_voice_channel_;
+  prewarmed_voice_channel_ = NULL;
   // Need to destroy the voice/video channels
   while (!video_channels_.empty()) {
     DestroyVideoChannel_w(video_channels_.back());
@@ -313,6 +327,40 @@ void ChannelManager::Terminate_w() {
   }
 }
 
+void ChannelManager::PrewarmMediaChannels(bool audio, bool video) {
+  if (!initialized_)
+    return;
+  if (worker_thread_->IsCurrent()) {
+    PrewarmMediaChannels_w(audio, video);
+  } else {
+    worker_thread_->Post(this, MSG_PREWARMMEDIACHANNELS,
+                         new PrewarmParams(audio, video));
+  }
+}
+
+void ChannelManager::PrewarmMediaChannels_w(bool audio, bool video) {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
+  if (!initialized_)
+    return;
+  if (audio && !prewarmed_voice_channel_) {
+    prewarmed_voice_channel_ = media_engine_->CreateChannel();
+  }
+  // The video channel is synced with the voice channel it is created with,
+  // so it is only handed out together with that voice channel.
+  if (video && !prewarmed_video_channel_ &&
+      (!audio || prewarmed_voice_channel_)) {
+    prewarmed_video_voice_channel_ = prewarmed_voice_channel_;
+    prewarmed_video_channel_ =
+        media_engine_->CreateVideoChannel(prewarmed_voice_channel_);
+  }
+}
+
+void ChannelManager::DestroyPrewarmedVideoChannel_w() {
+  delete prewarmed_video_channel_;
+  prewarmed_video_channel_ = NULL;
+  prewarmed_video_voice_channel_ = NULL;
+}
+
 VoiceChannel* ChannelManager::CreateVoiceChannel(
     BaseSession* session, const std::string& content_name, bool rtcp) {
   return worker_thread_->Invoke<VoiceChannel*>(
@@ -324,7 +372,12 @@ VoiceChannel* ChannelManager::CreateVoiceChannel_w(
     BaseSession* session, const std::string& content_name, bool rtcp) {
   // This is ok to alloc from a thread other than the worker thread
   ASSERT(initialized_);
-  VoiceMediaChannel* media_channel = media_engine_->CreateChannel();
+  // A pending prewarm comes too late for this channel.
+  worker_thread_->Clear(this, MSG_PREWARMMEDIACHANNELS);
+  VoiceMediaChannel* media_channel = prewarmed_voice_channel_;
+  prewarmed_voice_channel_ = NULL;
+  if (media_channel == NULL)
+    media_channel = media_engine_->CreateChannel();
   if (media_channel == NULL)
     return NULL;
 
@@ -355,6 +408,11 @@ void ChannelManager::DestroyVoiceChannel_w(VoiceChannel* voice_channel) {
   if (it == voice_channels_.end())
     return;
 
+  // A prewarmed video channel must not outlive the channel it is synced with.
+  if (prewarmed_video_channel_ &&
+      prewarmed_video_voice_channel_ == voice_channel->media_channel()) {
+    DestroyPrewarmedVideoChannel_w();
+  }
   voice_channels_.erase(it);
   delete voice_channel;
 }
@@ -372,10 +430,19 @@ VideoChannel* ChannelManager::CreateVideoChannel_w(
     VoiceChannel* voice_channel) {
   // This is ok to alloc from a thread other than the worker thread
   ASSERT(initialized_);
-  VideoMediaChannel* media_channel =
-      // voice_channel can be NULL in case of NullVoiceEngine.
-      media_engine_->CreateVideoChannel(voice_channel ?
-          voice_channel->media_channel() : NULL);
+  worker_thread_->Clear(this, MSG_PREWARMMEDIACHANNELS);
+  // voice_channel can be NULL in case of NullVoiceEngine.
+  VoiceMediaChannel* voice_media_channel =
+      voice_channel ? voice_channel->media_channel() : NULL;
+  VideoMediaChannel* media_channel = NULL;
+  if (prewarmed_video_channel_ &&
+      prewarmed_video_voice_channel_ == voice_media_channel) {
+    media_channel = prewarmed_video_channel_;
+    prewarmed_video_channel_ = NULL;
+    prewarmed_video_voice_channel_ = NULL;
+  } else {
+    media_channel = media_engine_->CreateVideoChannel(voice_media_channel);
+  }
   if (media_channel == NULL)
     return NULL;
 
@@ -909,6 +976,12 @@ void ChannelManager::OnMessage(rtc::Message* message) {
       delete data;
       break;
     }
+    case MSG_PREWARMMEDIACHANNELS: {
+      PrewarmParams* data = static_cast<PrewarmParams*>(message->pdata);
+      PrewarmMediaChannels_w(data->audio, data->video);
+      delete data;
+      break;
+    }
   }
 }
 
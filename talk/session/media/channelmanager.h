@@ -99,11 +99,20 @@ class ChannelManager : public rtc::MessageHandler,
 
   // Indicates whether the media engine is started.
   bool initialized() const { return initialized_; }
-  // Starts up the media engine.
+  // Starts up the media engine. The engines may leave opening the audio
+  // devices and starting their threads to the first channel which needs them,
+  // so the device and option settings applied here can take effect later.
   bool Init();
   // Shuts down the media engine.
   void Terminate();
 
+  // Creates the media channels of the next CreateVoiceChannel() and
+  // CreateVideoChannel() calls ahead of time on the worker thread, so that
+  // the media engine work overlaps with the rest of the call setup. Returns
+  // without waiting, unless it is called on the worker thread. At most one
+  // channel of each kind is kept until it is used or Terminate() is called.
+  void PrewarmMediaChannels(bool audio, bool video);
+
   // The operations below all occur on the worker thread.
 
   // Creates a voice channel, to be associated with the specified session.
@@ -253,6 +262,8 @@ class ChannelManager : public rtc::MessageHandler,
                  CaptureManager* cm,
                  rtc::Thread* worker_thread);
   void Terminate_w();
+  void PrewarmMediaChannels_w(bool audio, bool video);
+  void DestroyPrewarmedVideoChannel_w();
   VoiceChannel* CreateVoiceChannel_w(
       BaseSession* session, const std::string& content_name, bool rtcp);
   void DestroyVoiceChannel_w(VoiceChannel* voice_channel);
@@ -302,6 +313,12 @@ class ChannelManager : public rtc::MessageHandler,
   VideoRenderer* local_renderer_;
   bool enable_rtx_;
 
+  // The media channels created by PrewarmMediaChannels(), and the voice
+  // media channel that |prewarmed_video_channel_| is synced with.
+  VoiceMediaChannel* prewarmed_voice_channel_;
+  VideoMediaChannel* prewarmed_video_channel_;
+  VoiceMediaChannel* prewarmed_video_voice_channel_;
+
   bool capturing_;
   bool monitoring_;
 
@@ -165,6 +165,34 @@ TEST_F(ChannelManagerTest, CreateDestroyChannelsOnThread) {
   cm_->Terminate();
 }
 
+// Test that prewarmed media channels are used by the next channels, and that
+// the ones left over go away with Terminate().
+TEST_F(ChannelManagerTest, PrewarmMediaChannels) {
+  EXPECT_TRUE(cm_->Init());
+  cm_->PrewarmMediaChannels(true, true);
+  cricket::FakeVoiceMediaChannel* prewarmed_voice = fme_->GetVoiceChannel(0);
+  ASSERT_TRUE(prewarmed_voice != NULL);
+  ASSERT_TRUE(fme_->GetVideoChannel(0) != NULL);
+
+  cricket::VoiceChannel* voice_channel = cm_->CreateVoiceChannel(
+      session_, cricket::CN_AUDIO, false);
+  ASSERT_TRUE(voice_channel != NULL);
+  EXPECT_EQ(prewarmed_voice, voice_channel->media_channel());
+  cricket::VideoChannel* video_channel =
+      cm_->CreateVideoChannel(session_, cricket::CN_VIDEO,
+                              false, voice_channel);
+  ASSERT_TRUE(video_channel != NULL);
+  EXPECT_TRUE(fme_->GetVoiceChannel(1) == NULL);
+  EXPECT_TRUE(fme_->GetVideoChannel(1) == NULL);
+  cm_->DestroyVideoChannel(video_channel);
+  cm_->DestroyVoiceChannel(voice_channel);
+
+  cm_->PrewarmMediaChannels(true, false);
+  EXPECT_TRUE(fme_->GetVoiceChannel(0) != NULL);
+  cm_->Terminate();
+  EXPECT_TRUE(fme_->GetVoiceChannel(0) == NULL);
+}
+
 // Test that we fail to create a voice/video channel if the session is unable
 // to create a cricket::TransportChannel
 TEST_F(ChannelManagerTest, NoTransportChannelTest) {
@@ -32,6 +32,7 @@
 #include <set>
 #include <utility>
 
+#include "webrtc/base/base64.h"
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/scoped_ptr.h"
@@ -86,16 +87,23 @@ static bool IsMediaContentOfType(const ContentInfo* content,
 
 static bool CreateCryptoParams(int tag, const std::string& cipher,
                                CryptoParams *out) {
+  int key_len, salt_len;
+  if (!GetSrtpKeyAndSaltLengths(cipher, &key_len, &salt_len)) {
+    return false;
+  }
+  // Random base64 characters decode to random bytes. Draw enough of them for
+  // the master key and salt of |cipher|, and encode just those.
+  const size_t master_key_len = key_len + salt_len;
   std::string key;
-  key.reserve(SRTP_MASTER_KEY_BASE64_LEN);
-
-  if (!rtc::CreateRandomString(SRTP_MASTER_KEY_BASE64_LEN, &key)) {
+  if (!rtc::CreateRandomString((master_key_len + 2) / 3 * 4, &key)) {
     return false;
   }
+  std::string master_key = rtc::Base64::Decode(key, rtc::Base64::DO_STRICT);
+  master_key.resize(master_key_len);
   out->tag = tag;
   out->cipher_suite = cipher;
   out->key_params = kInline;
-  out->key_params += key;
+  out->key_params += rtc::Base64::Encode(master_key);
   return true;
 }
 
@@ -177,7 +185,8 @@ void GetSupportedDefaultCryptoSuites(
 }
 
 // For video support only 80-bit SHA1 HMAC. For audio 32-bit HMAC is
-// tolerated unless bundle is enabled because it is low overhead. Pick the
+// tolerated unless bundle is enabled because it is low overhead. The AES-GCM
+// suites are accepted for all media where libsrtp supports them. Pick the
 // crypto in the list that is supported.
 static bool SelectCrypto(const MediaContentDescription* offer,
                          bool bundle,
@@ -191,6 +200,12 @@ static bool SelectCrypto(const MediaContentDescription* offer,
         (CS_AES_CM_128_HMAC_SHA1_32 == i->cipher_suite && audio && !bundle)) {
       return CreateCryptoParams(i->tag, i->cipher_suite, crypto);
     }
+#if defined(HAVE_SRTP_AES_GCM)
+    if (CS_AEAD_AES_128_GCM == i->cipher_suite ||
+        CS_AEAD_AES_256_GCM == i->cipher_suite) {
+      return CreateCryptoParams(i->tag, i->cipher_suite, crypto);
+    }
+#endif
   }
   return false;
 }
@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 
+#include "webrtc/base/base64.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/fakesslidentity.h"
 #include "webrtc/base/messagedigest.h"
@@ -703,6 +704,38 @@ TEST_F(MediaSessionDescriptionFactoryTest, TestCreateVideoAnswer) {
   EXPECT_EQ(std::string(cricket::kMediaProtocolSavpf), vcd->protocol());
 }
 
+#if defined(HAVE_SRTP_AES_GCM)
+// Test that an offered AES-GCM suite is answered, with a master key and salt
+// of the length that suite takes.
+TEST_F(MediaSessionDescriptionFactoryTest, TestCreateVideoAnswerGcm) {
+  MediaSessionOptions opts;
+  opts.has_video = true;
+  f1_.set_secure(SEC_ENABLED);
+  f2_.set_secure(SEC_ENABLED);
+  rtc::scoped_ptr<SessionDescription> offer(f1_.CreateOffer(opts, NULL));
+  ASSERT_TRUE(offer.get() != NULL);
+  CryptoParamsVec cryptos;
+  cryptos.push_back(cricket::CryptoParams(
+      1, cricket::CS_AEAD_AES_256_GCM,
+      "inline:QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVoxMjM0NTY3ODlBQkNERUZHSEk=",
+      ""));
+  static_cast<MediaContentDescription*>(
+      offer->GetContentDescriptionByName("video"))->set_cryptos(cryptos);
+  rtc::scoped_ptr<SessionDescription> answer(
+      f2_.CreateAnswer(offer.get(), opts, NULL));
+  ASSERT_TRUE(answer.get() != NULL);
+  const VideoContentDescription* vcd =
+      static_cast<const VideoContentDescription*>(
+          answer->GetContentDescriptionByName("video"));
+  ASSERT_TRUE(vcd != NULL);
+  ASSERT_CRYPTO(vcd, 1U, cricket::CS_AEAD_AES_256_GCM);
+  const std::string& key_params = vcd->cryptos()[0].key_params;
+  ASSERT_EQ(0U, key_params.find("inline:"));
+  EXPECT_EQ(44U, rtc::Base64::Decode(key_params.substr(7),
+                                     rtc::Base64::DO_STRICT).size());
+}
+#endif  // HAVE_SRTP_AES_GCM
+
 TEST_F(MediaSessionDescriptionFactoryTest, TestCreateDataAnswer) {
   MediaSessionOptions opts;
   opts.data_channel_type = cricket::DCT_RTP;
@@ -73,10 +73,21 @@ namespace cricket {
 
 const char CS_AES_CM_128_HMAC_SHA1_80[] = "AES_CM_128_HMAC_SHA1_80";
 const char CS_AES_CM_128_HMAC_SHA1_32[] = "AES_CM_128_HMAC_SHA1_32";
+const char CS_AEAD_AES_128_GCM[] = "AEAD_AES_128_GCM";
+const char CS_AEAD_AES_256_GCM[] = "AEAD_AES_256_GCM";
 const int SRTP_MASTER_KEY_BASE64_LEN = SRTP_MASTER_KEY_LEN * 4 / 3;
 const int SRTP_MASTER_KEY_KEY_LEN = 16;
 const int SRTP_MASTER_KEY_SALT_LEN = 14;
 
+#if defined(HAVE_SRTP_AES_GCM)
+// Key and salt lengths of the AEAD_AES_*_GCM suites, see RFC 7714.
+static const int kSrtpAesGcm128KeyLen = 16;
+static const int kSrtpAesGcm256KeyLen = 32;
+static const int kSrtpAesGcmSaltLen = 12;
+#endif
+// The longest master key and salt of the suites above, AEAD_AES_256_GCM's.
+static const int kSrtpMaxMasterKeyLen = 44;
+
 #ifndef HAVE_SRTP
 
 // This helper function is used on systems that don't (yet) have SRTP,
@@ -114,6 +125,24 @@ void ShutdownSrtp() {
 #endif
 }
 
+bool GetSrtpKeyAndSaltLengths(const std::string& cs, int* key_len,
+                              int* salt_len) {
+  if (cs == CS_AES_CM_128_HMAC_SHA1_80 || cs == CS_AES_CM_128_HMAC_SHA1_32) {
+    *key_len = SRTP_MASTER_KEY_KEY_LEN;
+    *salt_len = SRTP_MASTER_KEY_SALT_LEN;
+    return true;
+  }
+#if defined(HAVE_SRTP_AES_GCM)
+  if (cs == CS_AEAD_AES_128_GCM || cs == CS_AEAD_AES_256_GCM) {
+    *key_len = (cs == CS_AEAD_AES_128_GCM) ? kSrtpAesGcm128KeyLen :
+        kSrtpAesGcm256KeyLen;
+    *salt_len = kSrtpAesGcmSaltLen;
+    return true;
+  }
+#endif
+  return false;
+}
+
 SrtpFilter::SrtpFilter()
     : state_(ST_INIT),
       signal_silent_time_in_ms_(0) {
@@ -257,6 +286,26 @@ bool SrtpFilter::UnprotectRtcp(void* p, int in_len, int* out_len) {
   }
 }
 
+bool SrtpFilter::ProtectRtp(std::vector<SrtpPacket>* packets) {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to ProtectRtp: SRTP not active";
+    for (size_t i = 0; i < packets->size(); ++i)
+      (*packets)[i].ok = false;
+    return false;
+  }
+  return send_session_->ProtectRtp(packets);
+}
+
+bool SrtpFilter::UnprotectRtp(std::vector<SrtpPacket>* packets) {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to UnprotectRtp: SRTP not active";
+    for (size_t i = 0; i < packets->size(); ++i)
+      (*packets)[i].ok = false;
+    return false;
+  }
+  return recv_session_->UnprotectRtp(packets);
+}
+
 bool SrtpFilter::GetRtpAuthParams(uint8** key, int* key_len, int* tag_len) {
   if (!IsActive()) {
     LOG(LS_WARNING) << "Failed to GetRtpAuthParams: SRTP not active";
@@ -407,17 +456,30 @@ bool SrtpFilter::ApplyParams(const CryptoParams& send_params,
     // We do not want to reset the ROC if the keys are the same. So just return.
     return true;
   }
+  // The master key and salt lengths depend on the cipher suite.
+  int send_key_len, send_salt_len, recv_key_len, recv_salt_len;
+  if (!GetSrtpKeyAndSaltLengths(send_params.cipher_suite,
+                                &send_key_len, &send_salt_len) ||
+      !GetSrtpKeyAndSaltLengths(recv_params.cipher_suite,
+                                &recv_key_len, &recv_salt_len)) {
+    LOG(LS_WARNING) << "Failed to apply negotiated SRTP parameters:"
+                    << " unsupported cipher_suite";
+    return false;
+  }
+  send_key_len += send_salt_len;
+  recv_key_len += recv_salt_len;
+
   // TODO(juberti): Zero these buffers after use.
   bool ret;
-  uint8 send_key[SRTP_MASTER_KEY_LEN], recv_key[SRTP_MASTER_KEY_LEN];
-  ret = (ParseKeyParams(send_params.key_params, send_key, sizeof(send_key)) &&
-         ParseKeyParams(recv_params.key_params, recv_key, sizeof(recv_key)));
+  uint8 send_key[kSrtpMaxMasterKeyLen], recv_key[kSrtpMaxMasterKeyLen];
+  ret = (ParseKeyParams(send_params.key_params, send_key, send_key_len) &&
+         ParseKeyParams(recv_params.key_params, recv_key, recv_key_len));
   if (ret) {
     CreateSrtpSessions();
     ret = (send_session_->SetSend(send_params.cipher_suite,
-                                  send_key, sizeof(send_key)) &&
+                                  send_key, send_key_len) &&
            recv_session_->SetRecv(recv_params.cipher_suite,
-                                  recv_key, sizeof(recv_key)));
+                                  recv_key, recv_key_len));
   }
   if (ret) {
     LOG(LS_INFO) << "SRTP activated with negotiated parameters:"
@@ -588,6 +650,83 @@ bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   return true;
 }
 
+bool SrtpSession::ProtectRtp(std::vector<SrtpPacket>* packets) {
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to protect SRTP packets: no SRTP Session";
+    for (size_t i = 0; i < packets->size(); ++i)
+      (*packets)[i].ok = false;
+    return false;
+  }
+
+  int failures = 0;
+  int last_err = err_status_ok;
+  for (size_t i = 0; i < packets->size(); ++i) {
+    SrtpPacket& packet = (*packets)[i];
+    packet.ok = false;
+    if (packet.capacity < packet.len + rtp_auth_tag_len_) {
+      ++failures;
+      last_err = err_status_bad_param;
+      continue;
+    }
+    int out_len = packet.len;
+    int err = srtp_protect(session_, packet.data, &out_len);
+    uint32 ssrc;
+    if (GetRtpSsrc(packet.data, packet.len, &ssrc)) {
+      srtp_stat_->AddProtectRtpResult(ssrc, err);
+    }
+    if (err != err_status_ok) {
+      ++failures;
+      last_err = err;
+      continue;
+    }
+    GetRtpSeqNum(packet.data, packet.len, &last_send_seq_num_);
+    packet.len = out_len;
+    packet.ok = true;
+  }
+  if (failures > 0) {
+    LOG(LS_WARNING) << "Failed to protect " << failures << " of "
+                    << packets->size() << " SRTP packets, last err="
+                    << last_err << ", last seqnum=" << last_send_seq_num_;
+    return false;
+  }
+  return true;
+}
+
+bool SrtpSession::UnprotectRtp(std::vector<SrtpPacket>* packets) {
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to unprotect SRTP packets: no SRTP Session";
+    for (size_t i = 0; i < packets->size(); ++i)
+      (*packets)[i].ok = false;
+    return false;
+  }
+
+  int failures = 0;
+  int last_err = err_status_ok;
+  for (size_t i = 0; i < packets->size(); ++i) {
+    SrtpPacket& packet = (*packets)[i];
+    int out_len = packet.len;
+    int err = srtp_unprotect(session_, packet.data, &out_len);
+    uint32 ssrc;
+    if (GetRtpSsrc(packet.data, packet.len, &ssrc)) {
+      srtp_stat_->AddUnprotectRtpResult(ssrc, err);
+    }
+    packet.ok = (err == err_status_ok);
+    if (!packet.ok) {
+      ++failures;
+      last_err = err;
+      continue;
+    }
+    packet.len = out_len;
+  }
+  if (failures > 0) {
+    LOG(LS_WARNING) << "Failed to unprotect " << failures << " of "
+                    << packets->size() << " SRTP packets, last err="
+                    << last_err;
+    return false;
+  }
+  return true;
+}
+
 bool SrtpSession::GetRtpAuthParams(uint8** key, int* key_len,
                                    int* tag_len) {
 #if defined(ENABLE_EXTERNAL_AUTH)
@@ -650,13 +789,23 @@ bool SrtpSession::SetKey(int type, const std::string& cs,
   } else if (cs == CS_AES_CM_128_HMAC_SHA1_32) {
     crypto_policy_set_aes_cm_128_hmac_sha1_32(&policy.rtp);   // rtp is 32,
     crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy.rtcp);  // rtcp still 80
+#if defined(HAVE_SRTP_AES_GCM)
+  } else if (cs == CS_AEAD_AES_128_GCM) {
+    crypto_policy_set_aes_gcm_128_16_auth(&policy.rtp);
+    crypto_policy_set_aes_gcm_128_16_auth(&policy.rtcp);
+  } else if (cs == CS_AEAD_AES_256_GCM) {
+    crypto_policy_set_aes_gcm_256_16_auth(&policy.rtp);
+    crypto_policy_set_aes_gcm_256_16_auth(&policy.rtcp);
+#endif
   } else {
     LOG(LS_WARNING) << "Failed to create SRTP session: unsupported"
                     << " cipher_suite " << cs.c_str();
     return false;
   }
 
-  if (!key || len != SRTP_MASTER_KEY_LEN) {
+  int key_len, salt_len;
+  if (!GetSrtpKeyAndSaltLengths(cs, &key_len, &salt_len) ||
+      !key || len != key_len + salt_len) {
     LOG(LS_WARNING) << "Failed to create SRTP session: invalid key";
     return false;
   }
@@ -801,6 +950,14 @@ bool SrtpSession::UnprotectRtcp(void* data, int in_len, int* out_len) {
   return SrtpNotAvailable(__FUNCTION__);
 }
 
+bool SrtpSession::ProtectRtp(std::vector<SrtpPacket>* packets) {
+  return SrtpNotAvailable(__FUNCTION__);
+}
+
+bool SrtpSession::UnprotectRtp(std::vector<SrtpPacket>* packets) {
+  return SrtpNotAvailable(__FUNCTION__);
+}
+
 void SrtpSession::set_signal_silent_time(uint32 signal_silent_time) {
   // Do nothing.
 }
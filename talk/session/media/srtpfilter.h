@@ -54,6 +54,14 @@ namespace cricket {
 extern const char CS_AES_CM_128_HMAC_SHA1_80[];
 // 128-bit AES with 32-bit SHA-1 HMAC.
 extern const char CS_AES_CM_128_HMAC_SHA1_32[];
+// AES-GCM with a 128-bit tag, from RFC 7714. These are only supported when
+// HAVE_SRTP_AES_GCM is defined, i.e. with libsrtp_aes_gcm=1 when libsrtp is
+// built with its OpenSSL crypto backend. That backend also uses AES-NI and the
+// SHA extensions, where the CPU has them, for the AES_CM suites.
+// 128-bit AES-GCM. Key is 128 bits and salt is 96 bits == 28 bytes.
+extern const char CS_AEAD_AES_128_GCM[];
+// 256-bit AES-GCM. Key is 256 bits and salt is 96 bits == 44 bytes.
+extern const char CS_AEAD_AES_256_GCM[];
 // Key is 128 bits and salt is 112 bits == 30 bytes. B64 bloat => 40 bytes.
 extern const int SRTP_MASTER_KEY_BASE64_LEN;
 
@@ -67,6 +75,27 @@ class SrtpStat;
 void EnableSrtpDebugging();
 void ShutdownSrtp();
 
+// Returns the lengths of the master key and the master salt used with the
+// cipher suite |cs|, or false if |cs| is not supported.
+bool GetSrtpKeyAndSaltLengths(const std::string& cs, int* key_len,
+                              int* salt_len);
+
+// An RTP packet that is protected or unprotected in place as part of a batch.
+struct SrtpPacket {
+  SrtpPacket() : data(NULL), len(0), capacity(0), ok(false) {}
+  SrtpPacket(void* data, int len, int capacity)
+      : data(data), len(len), capacity(capacity), ok(false) {}
+
+  void* data;
+  // The length of the packet. Updated to the new length if the packet is
+  // transformed.
+  int len;
+  // The size of the buffer at |data|. Only used when protecting.
+  int capacity;
+  // Set to whether the packet was transformed.
+  bool ok;
+};
+
 // Class to transform SRTP to/from RTP.
 // Initialize by calling SetSend with the local security params, then call
 // SetRecv once the remote security params are received. At that point
@@ -131,6 +160,12 @@ class SrtpFilter {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Encrypts/decrypts a batch of RTP packets in place, in order. Returns true
+  // if all packets were transformed; otherwise the |ok| flag of each packet
+  // tells whether it was. Failures are logged once per batch.
+  bool ProtectRtp(std::vector<SrtpPacket>* packets);
+  bool UnprotectRtp(std::vector<SrtpPacket>* packets);
+
   // Returns rtp auth params from srtp context.
   bool GetRtpAuthParams(uint8** key, int* key_len, int* tag_len);
 
@@ -215,6 +250,10 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Batch versions of the above, see SrtpFilter.
+  bool ProtectRtp(std::vector<SrtpPacket>* packets);
+  bool UnprotectRtp(std::vector<SrtpPacket>* packets);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8** key, int* key_len, int* tag_len);
 
@@ -40,6 +40,8 @@
 
 using cricket::CS_AES_CM_128_HMAC_SHA1_80;
 using cricket::CS_AES_CM_128_HMAC_SHA1_32;
+using cricket::CS_AEAD_AES_128_GCM;
+using cricket::CS_AEAD_AES_256_GCM;
 using cricket::CryptoParams;
 using cricket::CS_LOCAL;
 using cricket::CS_REMOTE;
@@ -47,6 +49,11 @@ using cricket::CS_REMOTE;
 static const uint8 kTestKey1[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234";
 static const uint8 kTestKey2[] = "4321ZYXWVUTSRQPONMLKJIHGFEDCBA";
 static const int kTestKeyLen = 30;
+static const uint8 kTestKeyGcm128[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ12";
+static const int kTestKeyGcm128Len = 28;
+static const uint8 kTestKeyGcm256[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ123456789ABCDEFGHI";
+static const int kTestKeyGcm256Len = 44;
 static const std::string kTestKeyParams1 =
     "inline:WVNfX19zZW1jdGwgKCkgewkyMjA7fQp9CnVubGVz";
 static const std::string kTestKeyParams2 =
@@ -55,16 +62,26 @@ static const std::string kTestKeyParams3 =
     "inline:1234X19zZW1jdGwgKCkgewkyMjA7fQp9CnVubGVz";
 static const std::string kTestKeyParams4 =
     "inline:4567QCVeeCFCanVmcjkpPywjNWhcYD0mXXtxaVBR";
+// kTestKeyGcm128 and kTestKeyGcm256.
+static const std::string kTestKeyParamsGcm128 =
+    "inline:QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVoxMg==";
+static const std::string kTestKeyParamsGcm256 =
+    "inline:QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVoxMjM0NTY3ODlBQkNERUZHSEk=";
 static const cricket::CryptoParams kTestCryptoParams1(
     1, "AES_CM_128_HMAC_SHA1_80", kTestKeyParams1, "");
 static const cricket::CryptoParams kTestCryptoParams2(
     1, "AES_CM_128_HMAC_SHA1_80", kTestKeyParams2, "");
 
+static bool IsGcmCipherSuite(const std::string& cs) {
+  return cs == CS_AEAD_AES_128_GCM || cs == CS_AEAD_AES_256_GCM;
+}
 static int rtp_auth_tag_len(const std::string& cs) {
+  if (IsGcmCipherSuite(cs))
+    return 16;
   return (cs == CS_AES_CM_128_HMAC_SHA1_32) ? 4 : 10;
 }
 static int rtcp_auth_tag_len(const std::string& cs) {
-  return 10;
+  return IsGcmCipherSuite(cs) ? 16 : 10;
 }
 
 class SrtpFilterTest : public testing::Test {
@@ -522,6 +539,100 @@ TEST_F(SrtpFilterTest, TestSetParamsKeyTooShort) {
                                  kTestKey1, kTestKeyLen - 1));
 }
 
+// Test that the batch functions fail while the filter is not active.
+TEST_F(SrtpFilterTest, TestProtectBatchNotActive) {
+  char rtp_packet[sizeof(kPcmuFrame) + 10];
+  memcpy(rtp_packet, kPcmuFrame, sizeof(kPcmuFrame));
+  std::vector<cricket::SrtpPacket> packets;
+  packets.push_back(cricket::SrtpPacket(rtp_packet, sizeof(kPcmuFrame),
+                                        sizeof(rtp_packet)));
+  packets[0].ok = true;
+  EXPECT_FALSE(f1_.ProtectRtp(&packets));
+  EXPECT_FALSE(packets[0].ok);
+  packets[0].ok = true;
+  EXPECT_FALSE(f1_.UnprotectRtp(&packets));
+  EXPECT_FALSE(packets[0].ok);
+  EXPECT_EQ(0, memcmp(rtp_packet, kPcmuFrame, sizeof(kPcmuFrame)));
+}
+
+#if defined(HAVE_SRTP_AES_GCM)
+// Test directly setting the params with AEAD_AES_128_GCM
+TEST_F(SrtpFilterTest, TestProtect_SetParamsDirect_AEAD_AES_128_GCM) {
+  EXPECT_TRUE(f1_.SetRtpParams(CS_AEAD_AES_128_GCM,
+                               kTestKeyGcm128, kTestKeyGcm128Len,
+                               CS_AEAD_AES_128_GCM,
+                               kTestKeyGcm128, kTestKeyGcm128Len));
+  EXPECT_TRUE(f2_.SetRtpParams(CS_AEAD_AES_128_GCM,
+                               kTestKeyGcm128, kTestKeyGcm128Len,
+                               CS_AEAD_AES_128_GCM,
+                               kTestKeyGcm128, kTestKeyGcm128Len));
+  EXPECT_TRUE(f1_.IsActive());
+  EXPECT_TRUE(f2_.IsActive());
+  TestProtectUnprotect(CS_AEAD_AES_128_GCM, CS_AEAD_AES_128_GCM);
+}
+
+// Test directly setting the params with AEAD_AES_256_GCM
+TEST_F(SrtpFilterTest, TestProtect_SetParamsDirect_AEAD_AES_256_GCM) {
+  EXPECT_TRUE(f1_.SetRtpParams(CS_AEAD_AES_256_GCM,
+                               kTestKeyGcm256, kTestKeyGcm256Len,
+                               CS_AEAD_AES_256_GCM,
+                               kTestKeyGcm256, kTestKeyGcm256Len));
+  EXPECT_TRUE(f2_.SetRtpParams(CS_AEAD_AES_256_GCM,
+                               kTestKeyGcm256, kTestKeyGcm256Len,
+                               CS_AEAD_AES_256_GCM,
+                               kTestKeyGcm256, kTestKeyGcm256Len));
+  EXPECT_TRUE(f1_.IsActive());
+  EXPECT_TRUE(f2_.IsActive());
+  TestProtectUnprotect(CS_AEAD_AES_256_GCM, CS_AEAD_AES_256_GCM);
+}
+
+// Test that we can encrypt/decrypt after negotiating AEAD_AES_128_GCM.
+TEST_F(SrtpFilterTest, TestProtect_AEAD_AES_128_GCM) {
+  std::vector<CryptoParams> offer(MakeVector(kTestCryptoParams1));
+  offer.push_back(CryptoParams(2, CS_AEAD_AES_128_GCM,
+                               kTestKeyParamsGcm128, ""));
+  std::vector<CryptoParams> answer(MakeVector(
+      CryptoParams(2, CS_AEAD_AES_128_GCM, kTestKeyParamsGcm128, "")));
+  TestSetParams(offer, answer);
+  TestProtectUnprotect(CS_AEAD_AES_128_GCM, CS_AEAD_AES_128_GCM);
+}
+
+// Test that we can encrypt/decrypt after negotiating AEAD_AES_256_GCM.
+TEST_F(SrtpFilterTest, TestProtect_AEAD_AES_256_GCM) {
+  std::vector<CryptoParams> offer(MakeVector(
+      CryptoParams(1, CS_AEAD_AES_256_GCM, kTestKeyParamsGcm256, "")));
+  std::vector<CryptoParams> answer(MakeVector(offer[0]));
+  TestSetParams(offer, answer);
+  TestProtectUnprotect(CS_AEAD_AES_256_GCM, CS_AEAD_AES_256_GCM);
+}
+
+// Test that a negotiated GCM suite doesn't accept a key sized for AES_CM.
+TEST_F(SrtpFilterTest, TestKeyTooShortGcm) {
+  std::vector<CryptoParams> offer(MakeVector(
+      CryptoParams(1, CS_AEAD_AES_256_GCM, kTestKeyParams1, "")));
+  EXPECT_TRUE(f1_.SetOffer(offer, CS_LOCAL));
+  EXPECT_FALSE(f1_.SetAnswer(offer, CS_REMOTE));
+  EXPECT_FALSE(f1_.IsActive());
+}
+
+// Test that the GCM suites don't accept keys sized for AES_CM.
+TEST_F(SrtpFilterTest, TestSetParamsWrongKeyLengthGcm) {
+  EXPECT_FALSE(f1_.SetRtpParams(CS_AEAD_AES_128_GCM,
+                                kTestKey1, kTestKeyLen,
+                                CS_AEAD_AES_128_GCM,
+                                kTestKey1, kTestKeyLen));
+}
+#else
+// Test that the GCM suites are rejected when libsrtp doesn't support them.
+TEST_F(SrtpFilterTest, TestSetParamsGcmNotSupported) {
+  EXPECT_FALSE(f1_.SetRtpParams(CS_AEAD_AES_128_GCM,
+                                kTestKeyGcm128, kTestKeyGcm128Len,
+                                CS_AEAD_AES_128_GCM,
+                                kTestKeyGcm128, kTestKeyGcm128Len));
+  EXPECT_FALSE(f1_.IsActive());
+}
+#endif  // HAVE_SRTP_AES_GCM
+
 #if defined(ENABLE_EXTERNAL_AUTH)
 TEST_F(SrtpFilterTest, TestGetSendAuthParams) {
   EXPECT_TRUE(f1_.SetRtpParams(CS_AES_CM_128_HMAC_SHA1_32,
@@ -668,6 +779,51 @@ TEST_F(SrtpSessionTest, TestBuffersTooSmall) {
                                sizeof(rtcp_packet_) - 14, &out_len));
 }
 
+// Test that a batch of packets is protected and unprotected as single packets
+// would be, and that a packet failing doesn't stop the others.
+TEST_F(SrtpSessionTest, TestProtectUnprotectBatch) {
+  static const int kNumPackets = 4;
+  EXPECT_TRUE(s1_.SetSend(CS_AES_CM_128_HMAC_SHA1_80, kTestKey1, kTestKeyLen));
+  EXPECT_TRUE(s2_.SetRecv(CS_AES_CM_128_HMAC_SHA1_80, kTestKey1, kTestKeyLen));
+
+  char packets[kNumPackets][sizeof(kPcmuFrame) + 10];
+  std::vector<cricket::SrtpPacket> batch;
+  for (int i = 0; i < kNumPackets; ++i) {
+    memcpy(packets[i], kPcmuFrame, sizeof(kPcmuFrame));
+    rtc::SetBE16(reinterpret_cast<uint8*>(packets[i]) + 2, 100 + i);
+    batch.push_back(cricket::SrtpPacket(packets[i], sizeof(kPcmuFrame),
+                                        sizeof(packets[i])));
+  }
+  // The third packet has no room for the auth tag.
+  batch[2].capacity = sizeof(kPcmuFrame);
+  EXPECT_FALSE(s1_.ProtectRtp(&batch));
+  for (int i = 0; i < kNumPackets; ++i) {
+    if (i == 2) {
+      EXPECT_FALSE(batch[i].ok);
+      EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)), batch[i].len);
+    } else {
+      EXPECT_TRUE(batch[i].ok);
+      EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)) +
+                rtp_auth_tag_len(CS_AES_CM_128_HMAC_SHA1_80), batch[i].len);
+    }
+  }
+  batch.erase(batch.begin() + 2);
+
+  // Tamper with the last packet; the others still get through.
+  packets[3][sizeof(kPcmuFrame) - 1] ^= 0x01;
+  EXPECT_FALSE(s2_.UnprotectRtp(&batch));
+  EXPECT_TRUE(batch[0].ok);
+  EXPECT_TRUE(batch[1].ok);
+  EXPECT_FALSE(batch[2].ok);
+  for (int i = 0; i < 2; ++i) {
+    char expected[sizeof(kPcmuFrame)];
+    memcpy(expected, kPcmuFrame, sizeof(kPcmuFrame));
+    rtc::SetBE16(reinterpret_cast<uint8*>(expected) + 2, 100 + i);
+    EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)), batch[i].len);
+    EXPECT_EQ(0, memcmp(packets[i], expected, sizeof(kPcmuFrame)));
+  }
+}
+
 TEST_F(SrtpSessionTest, TestReplay) {
   static const uint16 kMaxSeqnum = static_cast<uint16>(-1);
   static const uint16 seqnum_big = 62275;
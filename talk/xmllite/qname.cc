@@ -27,69 +27,179 @@
 
 #include "talk/xmllite/qname.h"
 
+#include "webrtc/base/criticalsection.h"
+
 namespace buzz {
 
+namespace {
+
+const size_t kNumBuckets = 256;
+
+// FNV-1a over the namespace, a separator and the local part.
+uint32 HashQName(const char* ns, const char* local) {
+  uint32 hash = 2166136261u;
+  for (const char* c = ns; *c; ++c)
+    hash = (hash ^ static_cast<uint8>(*c)) * 16777619u;
+  hash = (hash ^ ':') * 16777619u;
+  for (const char* c = local; *c; ++c)
+    hash = (hash ^ static_cast<uint8>(*c)) * 16777619u;
+  return hash;
+}
+
+}  // namespace
+
+QName::Data::Data(const std::string& ns, const std::string& local)
+    : ns(ns),
+      local(local),
+      ref_count(1),
+      hash(0),
+      next(NULL) {
+}
+
 QName::QName() {
+  LIBJINGLE_DEFINE_STATIC_LOCAL(Data, empty, (std::string(), std::string()));
+  data_ = &empty;
+  AddRef(data_);
 }
 
-QName::QName(const QName& qname)
-    : namespace_(qname.namespace_),
-      local_part_(qname.local_part_) {
+QName::QName(const QName& qname) : data_(qname.data_) {
+  AddRef(data_);
 }
 
 QName::QName(const StaticQName& const_value)
-    : namespace_(const_value.ns),
-      local_part_(const_value.local) {
+    : data_(new Data(const_value.ns, const_value.local)) {
 }
 
 QName::QName(const std::string& ns, const std::string& local)
-    : namespace_(ns),
-      local_part_(local) {
+    : data_(new Data(ns, local)) {
 }
 
 QName::QName(const std::string& merged_or_local) {
   size_t i = merged_or_local.rfind(':');
   if (i == std::string::npos) {
-    local_part_ = merged_or_local;
+    data_ = new Data(std::string(), merged_or_local);
   } else {
-    namespace_ = merged_or_local.substr(0, i);
-    local_part_ = merged_or_local.substr(i + 1);
+    data_ = new Data(merged_or_local.substr(0, i),
+                     merged_or_local.substr(i + 1));
   }
 }
 
+QName::QName(Data* data) : data_(data) {
+}
+
 QName::~QName() {
+  Release(data_);
+}
+
+QName& QName::operator=(const QName& qname) {
+  AddRef(qname.data_);
+  Release(data_);
+  data_ = qname.data_;
+  return *this;
+}
+
+void QName::AddRef(const Data* data) {
+  rtc::AtomicOps::Increment(&data->ref_count);
+}
+
+void QName::Release(const Data* data) {
+  if (rtc::AtomicOps::Decrement(&data->ref_count) == 0)
+    delete data;
 }
 
 std::string QName::Merged() const {
-  if (namespace_[0] == '\0')
-    return local_part_;
+  if (Namespace().empty())
+    return LocalPart();
 
   std::string result;
-  result.reserve(namespace_.length() + 1 + local_part_.length());
-  result += namespace_;
+  result.reserve(Namespace().length() + 1 + LocalPart().length());
+  result += Namespace();
   result += ':';
-  result += local_part_;
+  result += LocalPart();
   return result;
 }
 
 bool QName::IsEmpty() const {
-  return namespace_.empty() && local_part_.empty();
+  return Namespace().empty() && LocalPart().empty();
 }
 
 int QName::Compare(const StaticQName& other) const {
-  int result = local_part_.compare(other.local);
+  int result = LocalPart().compare(other.local);
   if (result != 0)
     return result;
 
-  return namespace_.compare(other.ns);
+  return Namespace().compare(other.ns);
 }
 
 int QName::Compare(const QName& other) const {
-  int result = local_part_.compare(other.local_part_);
+  if (data_ == other.data_)
+    return 0;
+
+  int result = LocalPart().compare(other.LocalPart());
   if (result != 0)
     return result;
 
-  return namespace_.compare(other.namespace_);
+  return Namespace().compare(other.Namespace());
+}
+
+const size_t QNameTable::kMaxSize;
+
+QNameTable::QNameTable() : buckets_(kNumBuckets), size_(0) {
+}
+
+QNameTable::~QNameTable() {
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    QName::Data* data = buckets_[i];
+    while (data) {
+      QName::Data* next = data->next;
+      QName::Release(data);
+      data = next;
+    }
+  }
+}
+
+QName QNameTable::Intern(const char* ns, const char* local) {
+  const uint32 hash = HashQName(ns, local);
+  QName::Data** bucket = &buckets_[hash % buckets_.size()];
+  for (QName::Data* data = *bucket; data; data = data->next) {
+    if (data->hash == hash && data->local == local && data->ns == ns) {
+      QName::AddRef(data);
+      return QName(data);
+    }
+  }
+
+  if (size_ >= kMaxSize) {
+    Purge();
+    if (size_ >= kMaxSize)
+      return QName(ns, local);
+  }
+
+  // The table keeps the first reference.
+  QName::Data* data = new QName::Data(ns, local);
+  data->hash = hash;
+  data->next = *bucket;
+  *bucket = data;
+  ++size_;
+  QName::AddRef(data);
+  return QName(data);
+}
+
+void QNameTable::Purge() {
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    QName::Data** link = &buckets_[i];
+    while (*link) {
+      QName::Data* data = *link;
+      // Only the table holds a reference. No other thread can add one, since
+      // that takes a QName referencing the data or a lookup in the table.
+      if (rtc::AtomicOps::AcquireLoad(&data->ref_count) == 1) {
+        *link = data->next;
+        delete data;
+        --size_;
+      } else {
+        link = &data->next;
+      }
+    }
+  }
 }
 
 }  // namespace buzz
@@ -29,10 +29,15 @@
 #define TALK_XMLLITE_QNAME_H_
 
 #include <string>
+#include <vector>
+
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/constructormagic.h"
 
 namespace buzz {
 
 class QName;
+class QNameTable;
 
 // StaticQName is used to represend constant quailified names. They
 // can be initialized statically and don't need intializers code, e.g.
@@ -58,8 +63,10 @@ class QName {
   explicit QName(const std::string& merged_or_local);
   ~QName();
 
-  const std::string& Namespace() const { return namespace_; }
-  const std::string& LocalPart() const { return local_part_; }
+  QName& operator=(const QName& qname);
+
+  const std::string& Namespace() const { return data_->ns; }
+  const std::string& LocalPart() const { return data_->local; }
   std::string Merged() const;
   bool IsEmpty() const;
 
@@ -83,8 +90,57 @@ class QName {
   }
 
  private:
-  std::string namespace_;
-  std::string local_part_;
+  friend class QNameTable;
+
+  // The immutable names, shared by all copies of a QName and by all the
+  // QNames interned by a QNameTable, so that copying a QName doesn't copy
+  // the strings.
+  struct Data {
+    Data(const std::string& ns, const std::string& local);
+
+    const std::string ns;
+    const std::string local;
+    mutable int ref_count;
+    // Used by the QNameTable the data is interned in, if any.
+    uint32 hash;
+    Data* next;
+  };
+
+  // Takes over a reference to |data|.
+  explicit QName(Data* data);
+
+  static void AddRef(const Data* data);
+  static void Release(const Data* data);
+
+  Data* data_;
+};
+
+// Interns the QNames resolved by one XML parser, so that all the elements
+// and attributes of a stream with the same name share one copy of it. Not
+// thread safe, but the QNames it returns are. The table holds at most
+// kMaxSize names at a time; names not used any more are dropped to make room
+// for new ones, and when all of them are in use Intern() returns names that
+// aren't interned.
+class QNameTable {
+ public:
+  static const size_t kMaxSize = 1024;
+
+  QNameTable();
+  ~QNameTable();
+
+  QName Intern(const char* ns, const char* local);
+
+  size_t size() const { return size_; }
+
+ private:
+  // Drops the names only referenced by the table.
+  void Purge();
+
+  // Chains of the names by hash.
+  std::vector<QName::Data*> buckets_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(QNameTable);
 };
 
 inline bool StaticQName::operator==(const QName& other) const {
@@ -25,7 +25,11 @@
  * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <stdio.h>
+
 #include <string>
+#include <vector>
+
 #include "webrtc/base/gunit.h"
 #include "talk/xmllite/qname.h"
 
@@ -129,3 +133,49 @@ TEST(QNameTest, TestStaticQName) {
   EXPECT_TRUE(name != name2);
   EXPECT_TRUE(name2 != name);
 }
+
+TEST(QNameTest, TestInterned) {
+  buzz::QNameTable table;
+  const QName name = table.Intern("namespace", "local");
+  const QName name2 = table.Intern("namespace", "local");
+  const QName name3 = table.Intern("namespace", "other");
+  EXPECT_EQ("namespace", name.Namespace());
+  EXPECT_EQ("local", name.LocalPart());
+  EXPECT_TRUE(name == QName("namespace", "local"));
+  // Interned names share their strings.
+  EXPECT_EQ(&name.LocalPart(), &name2.LocalPart());
+  EXPECT_TRUE(name != name3);
+  EXPECT_EQ(2u, table.size());
+}
+
+TEST(QNameTest, TestInternedOutliveTable) {
+  buzz::QNameTable* table = new buzz::QNameTable();
+  const QName name = table->Intern("", "local");
+  delete table;
+  EXPECT_EQ("", name.Namespace());
+  EXPECT_EQ("local", name.LocalPart());
+}
+
+TEST(QNameTest, TestInternedTableIsBounded) {
+  buzz::QNameTable table;
+  const QName kept = table.Intern("ns", "kept");
+  for (size_t i = 0; i < 2 * buzz::QNameTable::kMaxSize; ++i) {
+    char local[16];
+    sprintf(local, "name%d", static_cast<int>(i));
+    EXPECT_EQ(local, table.Intern("ns", local).LocalPart());
+  }
+  EXPECT_LE(table.size(), buzz::QNameTable::kMaxSize);
+  // Names still in use are kept.
+  EXPECT_EQ(&kept.LocalPart(), &table.Intern("ns", "kept").LocalPart());
+
+  // When all the names are in use, new ones aren't interned.
+  std::vector<QName> names;
+  for (size_t i = 0; i < buzz::QNameTable::kMaxSize; ++i) {
+    char local[16];
+    sprintf(local, "used%d", static_cast<int>(i));
+    names.push_back(table.Intern("ns", local));
+  }
+  EXPECT_EQ(buzz::QNameTable::kMaxSize, table.size());
+  EXPECT_EQ("extra", table.Intern("ns", "extra").LocalPart());
+  EXPECT_EQ(buzz::QNameTable::kMaxSize, table.size());
+}
@@ -0,0 +1,110 @@
+/*
+ * libjingle
+ * Copyright 2014, Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "talk/xmllite/xmlarena.h"
+
+#include <new>
+
+#include "webrtc/base/common.h"
+
+namespace buzz {
+
+namespace {
+
+const size_t kBlockSize = 4096;
+
+// Precedes every XmlArenaObject, to tell if it came from an arena. Keeps the
+// objects aligned for doubles and pointers.
+union ObjectHeader {
+  XmlArena* arena;
+  double align;
+};
+
+size_t AlignedSize(size_t size) {
+  const size_t alignment = sizeof(ObjectHeader);
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+XmlArena::XmlArena() : block_used_(0), size_(0) {
+}
+
+XmlArena::~XmlArena() {
+  for (size_t i = 0; i < blocks_.size(); ++i)
+    delete[] blocks_[i];
+}
+
+void XmlArena::Reset() {
+  for (size_t i = 1; i < blocks_.size(); ++i)
+    delete[] blocks_[i];
+  if (blocks_.size() > 1)
+    blocks_.resize(1);
+  block_used_ = 0;
+  size_ = 0;
+}
+
+void* XmlArena::Allocate(size_t size) {
+  size = AlignedSize(size);
+  ASSERT(size <= kBlockSize);
+  if (blocks_.empty() || block_used_ + size > kBlockSize) {
+    blocks_.push_back(new char[kBlockSize]);
+    block_used_ = 0;
+  }
+  void* p = blocks_.back() + block_used_;
+  block_used_ += size;
+  size_ += size;
+  return p;
+}
+
+void* XmlArenaObject::operator new(size_t size) {
+  return operator new(size, NULL);
+}
+
+void* XmlArenaObject::operator new(size_t size, XmlArena* arena) {
+  const size_t total_size = sizeof(ObjectHeader) + size;
+  ObjectHeader* header = static_cast<ObjectHeader*>(
+      arena ? arena->Allocate(total_size) : ::operator new(total_size));
+  header->arena = arena;
+  return header + 1;
+}
+
+void XmlArenaObject::operator delete(void* p) {
+  if (!p)
+    return;
+  ObjectHeader* header = static_cast<ObjectHeader*>(p) - 1;
+  // The arena frees its objects all at once.
+  if (!header->arena)
+    ::operator delete(header);
+}
+
+void XmlArenaObject::operator delete(void* p, XmlArena* arena) {
+  RTC_UNUSED(arena);
+  operator delete(p);
+}
+
+}  // namespace buzz
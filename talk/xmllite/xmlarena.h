@@ -0,0 +1,83 @@
+/*
+ * libjingle
+ * Copyright 2014, Google Inc.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TALK_XMLLITE_XMLARENA_H_
+#define TALK_XMLLITE_XMLARENA_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+
+namespace buzz {
+
+// Allocates the elements, attributes and texts of a parsed document, e.g. one
+// XMPP stanza, from a few large blocks instead of one heap allocation each.
+// The objects are still deleted one by one, so that the strings they own are
+// freed, but their memory is only returned when the arena is reset.
+class XmlArena {
+ public:
+  XmlArena();
+  // No objects allocated from the arena may be left.
+  ~XmlArena();
+
+  // Frees the memory of all the objects allocated from the arena, which must
+  // all have been deleted. Keeps the first block for the next document.
+  void Reset();
+
+  // The number of bytes allocated since the last Reset().
+  size_t size() const { return size_; }
+
+ private:
+  friend class XmlArenaObject;
+
+  void* Allocate(size_t size);
+
+  std::vector<char*> blocks_;
+  // The number of bytes used of the last block.
+  size_t block_used_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(XmlArena);
+};
+
+// The base class of the objects that can be allocated from an XmlArena with
+//   new (arena) XmlElement(name);
+// where a NULL |arena| allocates from the heap, like a plain new.
+class XmlArenaObject {
+ public:
+  static void* operator new(size_t size);
+  static void* operator new(size_t size, XmlArena* arena);
+  static void operator delete(void* p);
+  // Only called if a constructor throws.
+  static void operator delete(void* p, XmlArena* arena);
+};
+
+}  // namespace buzz
+
+#endif  // TALK_XMLLITE_XMLARENA_H_
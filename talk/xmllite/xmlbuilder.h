@@ -41,6 +41,7 @@
 
 namespace buzz {
 
+class XmlArena;
 class XmlElement;
 class XmlParseContext;
 
@@ -48,9 +49,15 @@ class XmlParseContext;
 class XmlBuilder : public XmlParseHandler {
 public:
   XmlBuilder();
+  // Allocates the built element and all its attributes and children from
+  // |arena|. The element must be deleted before the arena is reset.
+  explicit XmlBuilder(XmlArena * arena);
 
   static XmlElement * BuildElement(XmlParseContext * pctx,
                                   const char * name, const char ** atts);
+  static XmlElement * BuildElement(XmlParseContext * pctx,
+                                  const char * name, const char ** atts,
+                                  XmlArena * arena);
   virtual void StartElement(XmlParseContext * pctx,
                             const char * name, const char ** atts);
   virtual void EndElement(XmlParseContext * pctx, const char * name);
@@ -67,7 +74,11 @@ public:
   // Peek at the built element without taking ownership
   XmlElement * BuiltElement();
 
+  // Peek at the element being built, the parent of the next element
+  XmlElement * CurrentElement() { return pelCurrent_; }
+
 private:
+  XmlArena * const arena_;
   XmlElement * pelCurrent_;
   rtc::scoped_ptr<XmlElement> pelRoot_;
   rtc::scoped_ptr<std::vector<XmlElement*> > pvParents_;
@@ -30,6 +30,7 @@
 #include <iostream>
 #include "webrtc/base/common.h"
 #include "webrtc/base/gunit.h"
+#include "talk/xmllite/xmlarena.h"
 #include "talk/xmllite/xmlbuilder.h"
 #include "talk/xmllite/xmlelement.h"
 #include "talk/xmllite/xmlparser.h"
@@ -192,3 +193,30 @@ TEST(XmlBuilderTest, TestAttrCollision3) {
   EXPECT_TRUE(NULL == builder.BuiltElement());
 }
 
+
+TEST(XmlBuilderTest, TestArena) {
+  const std::string kXml = "<top a='b'><child xmlns='ns'>text</child>"
+      "<child2 c='d'/></top>";
+  buzz::XmlArena arena;
+  XmlBuilder builder(&arena);
+  XmlParser::ParseXml(&builder, kXml);
+  EXPECT_GT(arena.size(), 0u);
+  XmlElement* element = builder.CreateElement();
+  ASSERT_TRUE(element != NULL);
+  EXPECT_EQ("<top a=\"b\"><child xmlns=\"ns\">text</child><child2 c=\"d\"/>"
+      "</top>", element->Str());
+
+  // Copies are allocated from the heap, and outlive the arena.
+  XmlElement copy(*element);
+  delete element;
+  arena.Reset();
+  EXPECT_EQ(0u, arena.size());
+  EXPECT_EQ("<top a=\"b\"><child xmlns=\"ns\">text</child><child2 c=\"d\"/>"
+      "</top>", copy.Str());
+
+  // The arena is reused for the next document.
+  builder.Reset();
+  XmlParser::ParseXml(&builder, kXml);
+  EXPECT_EQ(copy.Str(), builder.BuiltElement()->Str());
+  builder.Reset();
+}
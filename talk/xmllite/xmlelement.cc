@@ -73,6 +73,7 @@ XmlText::~XmlText() {
 
 XmlElement::XmlElement(const QName& name) :
     name_(name),
+    arena_(NULL),
     first_attr_(NULL),
     last_attr_(NULL),
     first_child_(NULL),
@@ -83,6 +84,7 @@ XmlElement::XmlElement(const QName& name) :
 XmlElement::XmlElement(const XmlElement& elt) :
     XmlChild(),
     name_(elt.name_),
+    arena_(NULL),
     first_attr_(NULL),
     last_attr_(NULL),
     first_child_(NULL),
@@ -121,6 +123,7 @@ XmlElement::XmlElement(const XmlElement& elt) :
 
 XmlElement::XmlElement(const QName& name, bool useDefaultNs) :
   name_(name),
+  arena_(NULL),
   first_attr_(useDefaultNs ? new XmlAttr(QN_XMLNS, name.Namespace()) : NULL),
   last_attr_(first_attr_),
   first_child_(NULL),
@@ -128,6 +131,16 @@ XmlElement::XmlElement(const QName& name, bool useDefaultNs) :
   cdata_(false) {
 }
 
+XmlElement::XmlElement(const QName& name, XmlArena* arena) :
+    name_(name),
+    arena_(arena),
+    first_attr_(NULL),
+    last_attr_(NULL),
+    first_child_(NULL),
+    last_child_(NULL),
+    cdata_(false) {
+}
+
 bool XmlElement::IsTextImpl() const {
   return false;
 }
@@ -215,7 +228,7 @@ void XmlElement::SetAttr(const QName& name, const std::string& value) {
       break;
   }
   if (!attr) {
-    attr = new XmlAttr(name, value);
+    attr = new (arena_) XmlAttr(name, value);
     if (last_attr_)
       last_attr_->next_attr_ = attr;
     else
@@ -378,7 +391,7 @@ void XmlElement::AddAttr(const QName& name, const std::string& value) {
   ASSERT(!HasAttr(name));
 
   XmlAttr ** pprev = last_attr_ ? &(last_attr_->next_attr_) : &first_attr_;
-  last_attr_ = (*pprev = new XmlAttr(name, value));
+  last_attr_ = (*pprev = new (arena_) XmlAttr(name, value));
 }
 
 void XmlElement::AddAttr(const QName& name, const std::string& value,
@@ -399,7 +412,7 @@ void XmlElement::AddParsedText(const char* cstr, int len) {
     return;
   }
   XmlChild ** pprev = last_child_ ? &(last_child_->next_child_) : &first_child_;
-  last_child_ = *pprev = new XmlText(cstr, len);
+  last_child_ = *pprev = new (arena_) XmlText(cstr, len);
 }
 
 void XmlElement::AddCDATAText(const char* buf, int len) {
@@ -416,7 +429,7 @@ void XmlElement::AddText(const std::string& text) {
     return;
   }
   XmlChild ** pprev = last_child_ ? &(last_child_->next_child_) : &first_child_;
-  last_child_ = *pprev = new XmlText(text);
+  last_child_ = *pprev = new (arena_) XmlText(text);
 }
 
 void XmlElement::AddText(const std::string& text, int depth) {
@@ -33,6 +33,7 @@
 
 #include "webrtc/base/scoped_ptr.h"
 #include "talk/xmllite/qname.h"
+#include "talk/xmllite/xmlarena.h"
 
 namespace buzz {
 
@@ -41,7 +42,7 @@ class XmlText;
 class XmlElement;
 class XmlAttr;
 
-class XmlChild {
+class XmlChild : public XmlArenaObject {
  public:
   XmlChild* NextChild() { return next_child_; }
   const XmlChild* NextChild() const { return next_child_; }
@@ -105,7 +106,7 @@ class XmlText : public XmlChild {
   std::string text_;
 };
 
-class XmlAttr {
+class XmlAttr : public XmlArenaObject {
  public:
   XmlAttr* NextAttr() const { return next_attr_; }
   const QName& Name() const { return name_; }
@@ -238,7 +239,14 @@ class XmlElement : public XmlChild {
   virtual XmlText* AsTextImpl() const;
 
  private:
+  friend class XmlBuilder;
+
+  // Allocates the attributes and texts added to the element from |arena|, if
+  // not NULL. Used by XmlBuilder for elements allocated from the same arena.
+  explicit XmlElement(const QName& name, XmlArena* arena);
+
   QName name_;
+  XmlArena* arena_;
   XmlAttr* first_attr_;
   XmlAttr* last_attr_;
   XmlChild* first_child_;
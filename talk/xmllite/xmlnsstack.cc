@@ -58,29 +58,36 @@ void XmlnsStack::PopFrame() {
 
 std::pair<std::string, bool> XmlnsStack::NsForPrefix(
     const std::string& prefix) {
+  const char* ns = FindNsForPrefix(prefix);
+  if (!ns)
+    return std::make_pair(std::string(STR_EMPTY), false);
+  return std::make_pair(std::string(ns), true);
+}
+
+const char* XmlnsStack::FindNsForPrefix(const std::string& prefix) {
   if (prefix.length() >= 3 &&
       (prefix[0] == 'x' || prefix[0] == 'X') &&
       (prefix[1] == 'm' || prefix[1] == 'M') &&
       (prefix[2] == 'l' || prefix[2] == 'L')) {
     if (prefix == "xml")
-      return std::make_pair(NS_XML, true);
+      return NS_XML;
     if (prefix == "xmlns")
-      return std::make_pair(NS_XMLNS, true);
+      return NS_XMLNS;
     // Other names with xml prefix are illegal.
-    return std::make_pair(STR_EMPTY, false);
+    return NULL;
   }
 
   std::vector<std::string>::iterator pos;
   for (pos = pxmlnsStack_->end(); pos > pxmlnsStack_->begin(); ) {
     pos -= 2;
     if (*pos == prefix)
-      return std::make_pair(*(pos + 1), true);
+      return (pos + 1)->c_str();
   }
 
   if (prefix == STR_EMPTY)
-    return std::make_pair(STR_EMPTY, true);  // default namespace
+    return STR_EMPTY;  // default namespace
 
-  return std::make_pair(STR_EMPTY, false);  // none found
+  return NULL;  // none found
 }
 
 bool XmlnsStack::PrefixMatchesNs(const std::string& prefix,
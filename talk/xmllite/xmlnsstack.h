@@ -47,6 +47,10 @@ public:
   void Reset();
 
   std::pair<std::string, bool> NsForPrefix(const std::string& prefix);
+  // Like NsForPrefix(), but doesn't copy the namespace. Returns NULL if the
+  // prefix isn't bound. The namespace is valid until the next call to
+  // RemoveXmlns(), PopFrame() or Reset().
+  const char* FindNsForPrefix(const std::string& prefix);
   bool PrefixMatchesNs(const std::string & prefix, const std::string & ns);
   std::pair<std::string, bool> PrefixForNs(const std::string& ns, bool isAttr);
   std::pair<std::string, bool> AddNewPrefix(const std::string& ns, bool isAttr);
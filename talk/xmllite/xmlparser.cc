@@ -198,6 +198,7 @@ XmlParser::ParseXml(XmlParseHandler *pxph, std::string text) {
 
 XmlParser::ParseContext::ParseContext() :
     xmlnsstack_(),
+    qnames_(),
     raised_(XML_ERROR_NONE),
     line_number_(0),
     column_number_(0),
@@ -224,21 +225,21 @@ XmlParser::ParseContext::ResolveQName(const char* qname, bool isAttr) {
   const char *c;
   for (c = qname; *c; ++c) {
     if (*c == ':') {
-      const std::pair<std::string, bool> result =
-          xmlnsstack_.NsForPrefix(std::string(qname, c - qname));
-      if (!result.second)
+      const char* ns =
+          xmlnsstack_.FindNsForPrefix(std::string(qname, c - qname));
+      if (!ns)
         return QName();
-      return QName(result.first, c + 1);
+      return qnames_.Intern(ns, c + 1);
     }
   }
   if (isAttr)
-    return QName(STR_EMPTY, qname);
+    return qnames_.Intern(STR_EMPTY, qname);
 
-  std::pair<std::string, bool> result = xmlnsstack_.NsForPrefix(STR_EMPTY);
-  if (!result.second)
+  const char* ns = xmlnsstack_.FindNsForPrefix(STR_EMPTY);
+  if (!ns)
     return QName();
 
-  return QName(result.first, qname);
+  return qnames_.Intern(ns, qname);
 }
 
 void
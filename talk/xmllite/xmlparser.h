@@ -103,6 +103,7 @@ private:
 
   private:
     XmlnsStack xmlnsstack_;
+    QNameTable qnames_;
     XML_Error raised_;
     XML_Size line_number_;
     XML_Size column_number_;
@@ -43,7 +43,8 @@ XmppStanzaParser::XmppStanzaParser(XmppStanzaParseHandler *psph) :
   innerHandler_(this),
   parser_(&innerHandler_),
   depth_(0),
-  builder_() {
+  arena_(),
+  builder_(&arena_) {
 }
 
 void
@@ -51,6 +52,7 @@ XmppStanzaParser::Reset() {
   parser_.Reset();
   depth_ = 0;
   builder_.Reset();
+  arena_.Reset();
 }
 
 void
@@ -86,12 +88,26 @@ XmppStanzaParser::IncomingEndElement(
     return;
   }
 
+  XmlElement *child = builder_.CurrentElement();
   builder_.EndElement(pctx, name);
 
   if (depth_ == 1) {
     XmlElement *element = builder_.CreateElement();
     psph_->Stanza(element);
     delete element;
+    arena_.Reset();
+    return;
+  }
+
+  XmlElement *parent = builder_.CurrentElement();
+  if (child && parent &&
+      psph_->StanzaChild(builder_.BuiltElement(), parent, child)) {
+    XmlChild *predecessor = NULL;
+    for (XmlChild *sibling = parent->FirstChild(); sibling != child;
+         sibling = sibling->NextChild()) {
+      predecessor = sibling;
+    }
+    parent->RemoveChildAfter(predecessor);
   }
 }
 
@@ -28,6 +28,7 @@
 #ifndef _xmppstanzaparser_h_
 #define _xmppstanzaparser_h_
 
+#include "talk/xmllite/xmlarena.h"
 #include "talk/xmllite/xmlparser.h"
 #include "talk/xmllite/xmlbuilder.h"
 
@@ -40,6 +41,16 @@ class XmppStanzaParseHandler {
 public:
   virtual ~XmppStanzaParseHandler() {}
   virtual void StartStream(const XmlElement * pelStream) = 0;
+  // Called when a child element of a stanza, at any depth, has been parsed,
+  // before the rest of the stanza. |pelParent| is the element the child was
+  // added to, and |pelStanza| the stanza so far. The child is removed from
+  // the stanza and deleted if this returns true, so that large stanzas, like
+  // a Jingle transport-info with many candidates, can be processed one child
+  // at a time instead of walking the whole stanza later.
+  virtual bool StanzaChild(const XmlElement * pelStanza,
+                           const XmlElement * pelParent,
+                           const XmlElement * pelChild) { return false; }
+  // The stanza and all its elements are only valid during the call.
   virtual void Stanza(const XmlElement * pelStanza) = 0;
   virtual void EndStream() = 0;
   virtual void XmlError() = 0;
@@ -87,6 +98,8 @@ private:
   ParseHandler innerHandler_;
   XmlParser parser_;
   int depth_;
+  // The elements of the stanza being parsed, freed after each stanza.
+  XmlArena arena_;
   XmlBuilder builder_;
 
  };
@@ -39,7 +39,7 @@ class XmppStanzaParserTestHandler : public XmppStanzaParseHandler {
     return result;
   }
 
- private:
+ protected:
   std::stringstream ss_;
 };
 
@@ -166,3 +166,40 @@ TEST(XmppStanzaParserTest, TestError) {
   EXPECT_EQ("START<stream:stream xmlns:stream=\"st\" xmlns=\"jc\"/>STANZA"
       "<jc:foo xmlns:jc=\"jc\"/>ERROR", handler.StrClear());
 }
+
+// Consumes the candidate elements of stanzas as they are parsed.
+class XmppStanzaParserCandidateHandler : public XmppStanzaParserTestHandler {
+ public:
+  virtual bool StanzaChild(const XmlElement * stanza,
+                           const XmlElement * parent,
+                           const XmlElement * child) {
+    if (child->Name().LocalPart() != "candidate")
+      return false;
+    ss_ << "CANDIDATE(" << stanza->Attr(QName("id")) << ","
+        << parent->Name().LocalPart() << ")" << child->Str();
+    return true;
+  }
+};
+
+TEST(XmppStanzaParserTest, TestStreamedChildren) {
+  XmppStanzaParserCandidateHandler handler;
+  XmppStanzaParser parser(&handler);
+  std::string fragment;
+
+  fragment = "<stream:stream xmlns='j:c' xmlns:stream='str'>";
+  parser.Parse(fragment.c_str(), fragment.length(), false);
+  handler.StrClear();
+
+  fragment = "<iq id='1'><transport xmlns='t'><candidate port='1'/>"
+      "<other/><candidate port='2'/></transport></iq>";
+  parser.Parse(fragment.c_str(), fragment.length(), false);
+  EXPECT_EQ("CANDIDATE(1,transport)<t:candidate port=\"1\" xmlns:t=\"t\"/>"
+      "CANDIDATE(1,transport)<t:candidate port=\"2\" xmlns:t=\"t\"/>"
+      "STANZA<c:iq id=\"1\" xmlns:c=\"j:c\"><transport xmlns=\"t\"><other/>"
+      "</transport></c:iq>", handler.StrClear());
+
+  fragment = "<iq id='2'><candidate/></iq>";
+  parser.Parse(fragment.c_str(), fragment.length(), false);
+  EXPECT_EQ("CANDIDATE(2,iq)<c:candidate xmlns:c=\"j:c\"/>"
+      "STANZA<c:iq id=\"2\" xmlns:c=\"j:c\"/>", handler.StrClear());
+}
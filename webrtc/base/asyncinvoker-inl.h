@@ -15,8 +15,6 @@
 #include "webrtc/base/callback.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/messagehandler.h"
-#include "webrtc/base/refcount.h"
-#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/thread.h"
 
@@ -25,9 +23,10 @@ namespace rtc {
 class AsyncInvoker;
 
 // Helper class for AsyncInvoker. Runs a task and triggers a callback
-// on the calling thread if necessary. Instances are ref-counted so their
-// lifetime can be independent of AsyncInvoker.
-class AsyncClosure : public RefCountInterface {
+// on the calling thread if necessary. Instances are posted as the data of
+// their message, and so live as long as the message, independent of
+// AsyncInvoker.
+class AsyncClosure : public MessageData {
  public:
   virtual ~AsyncClosure() {}
   // Runs the asynchronous task, and triggers a callback to the calling
@@ -10,6 +10,8 @@
 
 #include "webrtc/base/asyncinvoker.h"
 
+#include "webrtc/base/scoped_ptr.h"
+
 namespace rtc {
 
 AsyncInvoker::AsyncInvoker() : destroying_(false) {}
@@ -22,11 +24,8 @@ AsyncInvoker::~AsyncInvoker() {
 }
 
 void AsyncInvoker::OnMessage(Message* msg) {
-  // Get the AsyncClosure shared ptr from this message's data.
-  ScopedRefMessageData<AsyncClosure>* data =
-      static_cast<ScopedRefMessageData<AsyncClosure>*>(msg->pdata);
-  scoped_refptr<AsyncClosure> closure = data->data();
-  delete msg->pdata;
+  // The message's data is the AsyncClosure itself.
+  scoped_ptr<AsyncClosure> closure(static_cast<AsyncClosure*>(msg->pdata));
   msg->pdata = NULL;
 
   // Execute the closure and trigger the return message if needed.
@@ -60,7 +59,7 @@ void AsyncInvoker::DoInvoke(Thread* thread, AsyncClosure* closure,
     delete closure;
     return;
   }
-  thread->Post(this, id, new ScopedRefMessageData<AsyncClosure>(closure));
+  thread->Post(this, id, closure);
 }
 
 NotifyingAsyncClosureBase::NotifyingAsyncClosureBase(AsyncInvoker* invoker,
@@ -77,8 +77,7 @@ class AsyncInvoker : public MessageHandler {
   void AsyncInvoke(Thread* thread,
                    const FunctorT& functor,
                    uint32 id = 0) {
-    AsyncClosure* closure =
-        new RefCountedObject<FireAndForgetAsyncClosure<FunctorT> >(functor);
+    AsyncClosure* closure = new FireAndForgetAsyncClosure<FunctorT>(functor);
     DoInvoke(thread, closure, id);
   }
 
@@ -90,7 +89,7 @@ class AsyncInvoker : public MessageHandler {
                    HostT* callback_host,
                    uint32 id = 0) {
     AsyncClosure* closure =
-        new RefCountedObject<NotifyingAsyncClosure<ReturnT, FunctorT, HostT> >(
+        new NotifyingAsyncClosure<ReturnT, FunctorT, HostT>(
             this, Thread::Current(), functor, callback, callback_host);
     DoInvoke(thread, closure, id);
   }
@@ -104,7 +103,7 @@ class AsyncInvoker : public MessageHandler {
                    HostT* callback_host,
                    uint32 id = 0) {
     AsyncClosure* closure =
-        new RefCountedObject<NotifyingAsyncClosure<void, FunctorT, HostT> >(
+        new NotifyingAsyncClosure<void, FunctorT, HostT>(
             this, Thread::Current(), functor, callback, callback_host);
     DoInvoke(thread, closure, id);
   }
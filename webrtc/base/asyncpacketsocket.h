@@ -90,6 +90,21 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr,
                      const PacketOptions& options) = 0;
 
+  // Sends a burst of packets that share |options|. Returns the number of
+  // packets sent, or -1 if the first one failed. Sockets that can't do
+  // better than one SendTo() per packet don't need to override this.
+  virtual int SendToBatch(const SocketDatagram* datagrams, size_t count,
+                          const PacketOptions& options) {
+    size_t sent = 0;
+    for (; sent < count; ++sent) {
+      if (SendTo(datagrams[sent].data, datagrams[sent].size,
+                 datagrams[sent].addr, options) < 0) {
+        break;
+      }
+    }
+    return (sent == 0 && count != 0) ? -1 : static_cast<int>(sent);
+  }
+
   // Close the socket.
   virtual int Close() = 0;
 
@@ -107,9 +122,9 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
 
   // Emitted each time a packet is read. Used only for UDP and
   // connected TCP sockets.
-  sigslot::signal5<AsyncPacketSocket*, const char*, size_t,
-                   const SocketAddress&,
-                   const PacketTime&> SignalReadPacket;
+  sigslot::st_signal5<AsyncPacketSocket*, const char*, size_t,
+                      const SocketAddress&,
+                      const PacketTime&> SignalReadPacket;
 
   // Emitted when the socket is currently able to send.
   sigslot::signal1<AsyncPacketSocket*> SignalReadyToSend;
@@ -12,6 +12,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "webrtc/base/byteorder.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/logging.h"
@@ -31,6 +33,22 @@ static const size_t kBufSize = kMaxPacketSize + kPacketLenSize;
 
 static const int kListenBacklog = 5;
 
+// Initial size of the input and output buffers of a connection.
+static const size_t kInitialBufSize = 4096;
+
+// Replaces |*buf| of |*size| bytes, of which the first |used| are kept, with
+// one of |new_size| bytes.
+static void ResizeBuffer(char** buf, size_t* size, size_t used,
+                         size_t new_size) {
+  ASSERT(used <= new_size);
+  char* new_buf = new char[new_size];
+  if (used > 0)
+    memcpy(new_buf, *buf, used);
+  delete [] *buf;
+  *buf = new_buf;
+  *size = new_size;
+}
+
 // Binds and connects |socket|
 AsyncSocket* AsyncTCPSocketBase::ConnectSocket(
     rtc::AsyncSocket* socket,
@@ -52,12 +70,13 @@ AsyncTCPSocketBase::AsyncTCPSocketBase(AsyncSocket* socket, bool listen,
                                        size_t max_packet_size)
     : socket_(socket),
       listen_(listen),
-      insize_(max_packet_size),
+      outbuf_(NULL),
+      insize_(std::min(kInitialBufSize, max_packet_size)),
       inpos_(0),
-      outsize_(max_packet_size),
-      outpos_(0) {
+      outsize_(0),
+      outpos_(0),
+      max_packet_size_(max_packet_size) {
   inbuf_ = new char[insize_];
-  outbuf_ = new char[outsize_];
 
   ASSERT(socket_.get() != NULL);
   socket_->SignalConnectEvent.connect(
@@ -136,13 +155,12 @@ int AsyncTCPSocketBase::SendTo(const void *pv, size_t cb,
 }
 
 int AsyncTCPSocketBase::SendRaw(const void * pv, size_t cb) {
-  if (outpos_ + cb > outsize_) {
+  if (outpos_ + cb > max_packet_size_) {
     socket_->SetError(EMSGSIZE);
     return -1;
   }
 
-  memcpy(outbuf_ + outpos_, pv, cb);
-  outpos_ += cb;
+  AppendToOutBuffer(pv, cb);
 
   return FlushOutBuffer();
 }
@@ -165,11 +183,37 @@ int AsyncTCPSocketBase::FlushOutBuffer() {
 }
 
 void AsyncTCPSocketBase::AppendToOutBuffer(const void* pv, size_t cb) {
-  ASSERT(outpos_ + cb < outsize_);
+  ASSERT(outpos_ + cb <= max_packet_size_);
+  if (outpos_ + cb > outsize_)
+    GrowOutBuffer(outpos_ + cb);
   memcpy(outbuf_ + outpos_, pv, cb);
   outpos_ += cb;
 }
 
+int AsyncTCPSocketBase::SendUnbuffered(const void* pv, size_t cb) {
+  ASSERT(IsOutBufferEmpty());
+  int res = socket_->Send(pv, cb);
+  if (res <= 0) {
+    return res;
+  }
+  if (static_cast<size_t>(res) > cb) {
+    ASSERT(false);
+    return -1;
+  }
+  if (static_cast<size_t>(res) < cb) {
+    AppendToOutBuffer(static_cast<const char*>(pv) + res, cb - res);
+  }
+  return res;
+}
+
+void AsyncTCPSocketBase::GrowOutBuffer(size_t size) {
+  size_t new_size = std::max(outsize_, kInitialBufSize);
+  while (new_size < size)
+    new_size *= 2;
+  ResizeBuffer(&outbuf_, &outsize_, outpos_,
+               std::min(new_size, max_packet_size_));
+}
+
 void AsyncTCPSocketBase::OnConnectEvent(AsyncSocket* socket) {
   SignalConnect(this);
 }
@@ -206,9 +250,16 @@ void AsyncTCPSocketBase::OnReadEvent(AsyncSocket* socket) {
     ProcessInput(inbuf_, &inpos_);
 
     if (inpos_ >= insize_) {
-      LOG(LS_ERROR) << "input buffer overflow";
-      ASSERT(false);
-      inpos_ = 0;
+      if (insize_ < max_packet_size_) {
+        // The buffer is full with the start of a packet; make room for the
+        // rest of it.
+        ResizeBuffer(&inbuf_, &insize_, inpos_,
+                     std::min(2 * insize_, max_packet_size_));
+      } else {
+        LOG(LS_ERROR) << "input buffer overflow";
+        ASSERT(false);
+        inpos_ = 0;
+      }
     }
   }
 }
@@ -274,21 +325,23 @@ int AsyncTCPSocket::Send(const void *pv, size_t cb,
 void AsyncTCPSocket::ProcessInput(char * data, size_t* len) {
   SocketAddress remote_addr(GetRemoteAddress());
 
-  while (true) {
-    if (*len < kPacketLenSize)
-      return;
-
-    PacketLength pkt_len = rtc::GetBE16(data);
-    if (*len < kPacketLenSize + pkt_len)
-      return;
+  // The packets are signaled from where they are in the buffer, and only the
+  // incomplete one at the end is moved to the front afterwards.
+  size_t pos = 0;
+  while (*len - pos >= kPacketLenSize) {
+    PacketLength pkt_len = rtc::GetBE16(data + pos);
+    if (*len - pos < kPacketLenSize + pkt_len)
+      break;
 
-    SignalReadPacket(this, data + kPacketLenSize, pkt_len, remote_addr,
+    SignalReadPacket(this, data + pos + kPacketLenSize, pkt_len, remote_addr,
                      CreatePacketTime(0));
 
-    *len -= kPacketLenSize + pkt_len;
-    if (*len > 0) {
-      memmove(data, data + kPacketLenSize + pkt_len, *len);
-    }
+    pos += kPacketLenSize + pkt_len;
+  }
+
+  *len -= pos;
+  if (pos > 0 && *len > 0) {
+    memmove(data, data + pos, *len);
   }
 }
 
@@ -55,6 +55,10 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
   int FlushOutBuffer();
   // Add data to |outbuf_|.
   void AppendToOutBuffer(const void* pv, size_t cb);
+  // Sends |pv| straight from the caller's memory and adds only what the
+  // socket didn't take to |outbuf_|. The out buffer must be empty. Returns
+  // like FlushOutBuffer().
+  int SendUnbuffered(const void* pv, size_t cb);
 
   // Helper methods for |outpos_|.
   bool IsOutBufferEmpty() const { return outpos_ == 0; }
@@ -67,10 +71,16 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
   void OnWriteEvent(AsyncSocket* socket);
   void OnCloseEvent(AsyncSocket* socket, int error);
 
+  // Grows |outbuf_| to hold at least |size| bytes.
+  void GrowOutBuffer(size_t size);
+
   scoped_ptr<AsyncSocket> socket_;
   bool listen_;
+  // Both buffers start small and grow as needed up to |max_packet_size_|,
+  // so that idle connections don't hold on to the maximum packet size twice.
   char* inbuf_, * outbuf_;
   size_t insize_, inpos_, outsize_, outpos_;
+  const size_t max_packet_size_;
 
   DISALLOW_EVIL_CONSTRUCTORS(AsyncTCPSocketBase);
 };
@@ -13,8 +13,13 @@
 
 namespace rtc {
 
+// Size of each receive slot of a read batch, enough for any UDP datagram.
+// Only the pages a datagram is written to are touched, so the slots cost
+// little more memory than the datagrams actually received.
 static const int BUF_SIZE = 64 * 1024;
 
+const size_t AsyncUDPSocket::kMaxReadBatch;
+
 AsyncUDPSocket* AsyncUDPSocket::Create(
     AsyncSocket* socket,
     const SocketAddress& bind_address) {
@@ -39,7 +44,11 @@ AsyncUDPSocket::AsyncUDPSocket(AsyncSocket* socket)
     : socket_(socket) {
   ASSERT(socket_);
   size_ = BUF_SIZE;
-  buf_ = new char[size_];
+  buf_ = new char[kMaxReadBatch * size_];
+  for (size_t i = 0; i < kMaxReadBatch; ++i) {
+    datagrams_[i].data = buf_ + i * size_;
+    datagrams_[i].capacity = size_;
+  }
 
   // The socket should start out readable but not writable.
   socket_->SignalReadEvent.connect(this, &AsyncUDPSocket::OnReadEvent);
@@ -69,6 +78,12 @@ int AsyncUDPSocket::SendTo(const void *pv, size_t cb,
   return socket_->SendTo(pv, cb, addr);
 }
 
+int AsyncUDPSocket::SendToBatch(const SocketDatagram* datagrams,
+                                size_t count,
+                                const rtc::PacketOptions& options) {
+  return socket_->SendToBatch(datagrams, count);
+}
+
 int AsyncUDPSocket::Close() {
   return socket_->Close();
 }
@@ -96,9 +111,8 @@ void AsyncUDPSocket::SetError(int error) {
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   ASSERT(socket_.get() == socket);
 
-  SocketAddress remote_addr;
-  int len = socket_->RecvFrom(buf_, size_, &remote_addr);
-  if (len < 0) {
+  int count = socket_->RecvFromBatch(datagrams_, kMaxReadBatch);
+  if (count < 0) {
     // An error here typically means we got an ICMP error in response to our
     // send datagram, indicating the remote address was unreachable.
     // When doing ICE, this kind of thing will often happen.
@@ -109,10 +123,17 @@ void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
     return;
   }
 
-  // TODO: Make sure that we got all of the packet.
-  // If we did not, then we should resize our buffer to be large enough.
-  SignalReadPacket(this, buf_, static_cast<size_t>(len), remote_addr,
-                   CreatePacketTime(0));
+  for (int i = 0; i < count; ++i) {
+    if (datagrams_[i].truncated) {
+      LOG(LS_WARNING) << "AsyncUDPSocket["
+                      << socket_->GetLocalAddress().ToSensitiveString()
+                      << "] dropped a datagram larger than "
+                      << datagrams_[i].capacity << " bytes";
+      continue;
+    }
+    SignalReadPacket(this, datagrams_[i].data, datagrams_[i].size,
+                     datagrams_[i].addr, CreatePacketTime(0));
+  }
 }
 
 void AsyncUDPSocket::OnWriteEvent(AsyncSocket* socket) {
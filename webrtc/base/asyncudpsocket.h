@@ -21,6 +21,9 @@ namespace rtc {
 // buffered since it is acceptable to drop packets under high load.
 class AsyncUDPSocket : public AsyncPacketSocket {
  public:
+  // Maximum number of datagrams read per read event.
+  static const size_t kMaxReadBatch = 16;
+
   // Binds |socket| and creates AsyncUDPSocket for it. Takes ownership
   // of |socket|. Returns NULL if bind() fails (|socket| is destroyed
   // in that case).
@@ -39,6 +42,8 @@ class AsyncUDPSocket : public AsyncPacketSocket {
                    const rtc::PacketOptions& options);
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr,
                      const rtc::PacketOptions& options);
+  virtual int SendToBatch(const SocketDatagram* datagrams, size_t count,
+                          const rtc::PacketOptions& options);
   virtual int Close();
 
   virtual State GetState() const;
@@ -54,8 +59,10 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   void OnWriteEvent(AsyncSocket* socket);
 
   scoped_ptr<AsyncSocket> socket_;
+  // Receive slots of |size_| bytes for the datagrams of a read batch.
   char* buf_;
   size_t size_;
+  SocketDatagram datagrams_[kMaxReadBatch];
 };
 
 }  // namespace rtc
@@ -9,6 +9,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include "webrtc/base/asyncudpsocket.h"
 #include "webrtc/base/gunit.h"
@@ -50,4 +51,96 @@ TEST_F(AsyncUdpSocketTest, OnWriteEvent) {
   EXPECT_TRUE(ready_to_send_);
 }
 
+class AsyncUdpSocketBatchTest
+    : public testing::Test,
+      public sigslot::has_slots<> {
+ public:
+  AsyncUdpSocketBatchTest() : pss_(new rtc::PhysicalSocketServer) {}
+
+  void OnReadPacket(AsyncPacketSocket* socket, const char* data, size_t size,
+                    const SocketAddress& remote_addr,
+                    const PacketTime& packet_time) {
+    packets_.push_back(std::string(data, size));
+  }
+
+ protected:
+  void CreateReceiver() {
+    receiver_.reset(AsyncUDPSocket::Create(pss_.get(),
+                                           SocketAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(receiver_.get() != NULL);
+    receiver_->SignalReadPacket.connect(
+        this, &AsyncUdpSocketBatchTest::OnReadPacket);
+  }
+
+  // Sends |count| packets of |size| bytes to |receiver_| in one batch, the
+  // last one a byte shorter if |short_last| is set.
+  void SendPackets(int count, size_t size, bool short_last) {
+    std::vector<std::string> payloads(count);
+    for (int i = 0; i < count; ++i) {
+      payloads[i] = std::string(
+          (short_last && i == count - 1) ? size - 1 : size,
+          static_cast<char>('a' + i));
+    }
+    SendPayloads(&payloads);
+  }
+
+  // Sends |payloads| to |receiver_| in one batch.
+  void SendPayloads(std::vector<std::string>* payloads) {
+    scoped_ptr<AsyncUDPSocket> sender(AsyncUDPSocket::Create(
+        pss_.get(), SocketAddress("127.0.0.1", 0)));
+    ASSERT_TRUE(sender.get() != NULL);
+    std::vector<SocketDatagram> datagrams(payloads->size());
+    for (size_t i = 0; i < payloads->size(); ++i) {
+      datagrams[i].data = &(*payloads)[i][0];
+      datagrams[i].size = (*payloads)[i].size();
+      datagrams[i].addr = receiver_->GetLocalAddress();
+    }
+    EXPECT_EQ(static_cast<int>(datagrams.size()),
+              sender->SendToBatch(&datagrams[0], datagrams.size(),
+                                  PacketOptions()));
+  }
+
+  scoped_ptr<PhysicalSocketServer> pss_;
+  scoped_ptr<AsyncUDPSocket> receiver_;
+  std::vector<std::string> packets_;
+};
+
+TEST_F(AsyncUdpSocketBatchTest, ReceivesBatchInOrder) {
+  CreateReceiver();
+  SendPackets(5, 1, false);
+  pss_->Wait(100, true);
+  ASSERT_EQ(5u, packets_.size());
+  for (size_t i = 0; i < packets_.size(); ++i)
+    EXPECT_EQ(std::string(1, static_cast<char>('a' + i)), packets_[i]);
+}
+
+// Equal-size packets to one destination go out with segmentation offload
+// where available and must still arrive as separate packets.
+TEST_F(AsyncUdpSocketBatchTest, ReceivesSegmentedBatchInOrder) {
+  CreateReceiver();
+  SendPackets(5, 1000, true);
+  pss_->Wait(100, true);
+  ASSERT_EQ(5u, packets_.size());
+  for (size_t i = 0; i < packets_.size(); ++i) {
+    EXPECT_EQ(std::string(i == 4 ? 999 : 1000, static_cast<char>('a' + i)),
+              packets_[i]);
+  }
+}
+
+// Datagrams larger than an RTP packet are received whole in any slot of a
+// batch, not only in the first one.
+TEST_F(AsyncUdpSocketBatchTest, ReceivesLargePacketsInBatch) {
+  CreateReceiver();
+  std::vector<std::string> payloads;
+  payloads.push_back(std::string(1, 'a'));
+  payloads.push_back(std::string(3000, 'b'));
+  payloads.push_back(std::string(1, 'c'));
+  payloads.push_back(std::string(60000, 'd'));
+  SendPayloads(&payloads);
+  pss_->Wait(100, true);
+  ASSERT_EQ(payloads.size(), packets_.size());
+  for (size_t i = 0; i < packets_.size(); ++i)
+    EXPECT_EQ(payloads[i], packets_[i]);
+}
+
 }  // namespace rtc
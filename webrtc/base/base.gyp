@@ -61,6 +61,8 @@
         'bind.h',
         'bind.h.pump',
         'buffer.h',
+        'bufferpool.cc',
+        'bufferpool.h',
         'bytebuffer.cc',
         'bytebuffer.h',
         'byteorder.h',
@@ -130,6 +132,8 @@
         'linuxwindowpicker.cc',
         'linuxwindowpicker.h',
         'linked_ptr.h',
+        'lockprofiler.cc',
+        'lockprofiler.h',
         'logging.cc',
         'logging.h',
         'macasyncsocket.cc',
@@ -168,6 +172,8 @@
         'nethelpers.h',
         'network.cc',
         'network.h',
+        'networkmonitor.cc',
+        'networkmonitor.h',
         'nssidentity.cc',
         'nssidentity.h',
         'nssstreamadapter.cc',
@@ -218,6 +224,7 @@
         'sha1.cc',
         'sha1.h',
         'sha1digest.h',
+        'sharedbuffer.h',
         'sharedexclusivelock.cc',
         'sharedexclusivelock.h',
         'signalthread.cc',
@@ -419,6 +426,7 @@
             'scopedptrcollection.h',
             'scoped_ref_ptr.h',
             'sec_buffer.h',
+            'sharedbuffer.h',
             'sharedexclusivelock.cc',
             'sharedexclusivelock.h',
             'sslconfig.h',
@@ -50,6 +50,7 @@
         'basictypes_unittest.cc',
         'bind_unittest.cc',
         'buffer_unittest.cc',
+        'bufferpool_unittest.cc',
         'bytebuffer_unittest.cc',
         'byteorder_unittest.cc',
         'callback_unittest.cc',
@@ -65,13 +66,16 @@
         'httpcommon_unittest.cc',
         'httpserver_unittest.cc',
         'ipaddress_unittest.cc',
+        'lockprofiler_unittest.cc',
         'logging_unittest.cc',
         'md5digest_unittest.cc',
         'messagedigest_unittest.cc',
         'messagequeue_unittest.cc',
         'multipart_unittest.cc',
         'nat_unittest.cc',
+        'nethelpers_unittest.cc',
         'network_unittest.cc',
+        'networkmonitor_unittest.cc',
         'nullsocketserver_unittest.cc',
         'optionsfile_unittest.cc',
         'pathutils_unittest.cc',
@@ -85,6 +89,7 @@
         'rollingaccumulator_unittest.cc',
         'scopedptrcollection_unittest.cc',
         'sha1digest_unittest.cc',
+        'sharedbuffer_unittest.cc',
         'sharedexclusivelock_unittest.cc',
         'signalthread_unittest.cc',
         'sigslot_unittest.cc',
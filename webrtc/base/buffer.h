@@ -13,29 +13,35 @@
 
 #include <string.h>
 
+#include "webrtc/base/bufferpool.h"
 #include "webrtc/base/scoped_ptr.h"
 
 namespace rtc {
 
 // Basic buffer class, can be grown and shrunk dynamically.
 // Unlike std::string/vector, does not initialize data when expanding capacity.
+// The storage comes from BufferPool.
 class Buffer {
  public:
-  Buffer() {
+  Buffer() : data_(NULL), capacity_(0) {
     Construct(NULL, 0, 0);
   }
-  Buffer(const void* data, size_t length) {
+  Buffer(const void* data, size_t length) : data_(NULL), capacity_(0) {
     Construct(data, length, length);
   }
-  Buffer(const void* data, size_t length, size_t capacity) {
+  Buffer(const void* data, size_t length, size_t capacity)
+      : data_(NULL), capacity_(0) {
     Construct(data, length, capacity);
   }
-  Buffer(const Buffer& buf) {
+  Buffer(const Buffer& buf) : data_(NULL), capacity_(0) {
     Construct(buf.data(), buf.length(), buf.length());
   }
+  ~Buffer() {
+    BufferPool::Free(data_, capacity_);
+  }
 
-  const char* data() const { return data_.get(); }
-  char* data() { return data_.get(); }
+  const char* data() const { return data_; }
+  char* data() { return data_; }
   // TODO: should this be size(), like STL?
   size_t length() const { return length_; }
   size_t capacity() const { return capacity_; }
@@ -48,7 +54,7 @@ class Buffer {
   }
   bool operator==(const Buffer& buf) const {
     return (length_ == buf.length() &&
-            memcmp(data_.get(), buf.data(), length_) == 0);
+            memcmp(data_, buf.data(), length_) == 0);
   }
   bool operator!=(const Buffer& buf) const {
     return !operator==(buf);
@@ -57,13 +63,13 @@ class Buffer {
   void SetData(const void* data, size_t length) {
     ASSERT(data != NULL || length == 0);
     SetLength(length);
-    memcpy(data_.get(), data, length);
+    memcpy(data_, data, length);
   }
   void AppendData(const void* data, size_t length) {
     ASSERT(data != NULL || length == 0);
     size_t old_length = length_;
     SetLength(length_ + length);
-    memcpy(data_.get() + old_length, data, length);
+    memcpy(data_ + old_length, data, length);
   }
   void SetLength(size_t length) {
     SetCapacity(length);
@@ -71,28 +77,39 @@ class Buffer {
   }
   void SetCapacity(size_t capacity) {
     if (capacity > capacity_) {
-      rtc::scoped_ptr<char[]> data(new char[capacity]);
-      memcpy(data.get(), data_.get(), length_);
-      data_.swap(data);
+      // Grows in place while the storage has room.
+      if (BufferPool::AllocatedSize(capacity) !=
+          BufferPool::AllocatedSize(capacity_)) {
+        char* data = BufferPool::Allocate(capacity);
+        memcpy(data, data_, length_);
+        BufferPool::Free(data_, capacity_);
+        data_ = data;
+      }
       capacity_ = capacity;
     }
   }
 
   void TransferTo(Buffer* buf) {
     ASSERT(buf != NULL);
-    buf->data_.reset(data_.release());
+    BufferPool::Free(buf->data_, buf->capacity_);
+    buf->data_ = data_;
     buf->length_ = length_;
     buf->capacity_ = capacity_;
+    data_ = NULL;
+    capacity_ = 0;
     Construct(NULL, 0, 0);
   }
 
  protected:
   void Construct(const void* data, size_t length, size_t capacity) {
-    data_.reset(new char[capacity_ = capacity]);
+    BufferPool::Free(data_, capacity_);
+    data_ = BufferPool::Allocate(capacity);
+    capacity_ = capacity;
+    length_ = 0;
     SetData(data, length);
   }
 
-  scoped_ptr<char[]> data_;
+  char* data_;
   size_t length_;
   size_t capacity_;
 };
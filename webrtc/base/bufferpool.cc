@@ -0,0 +1,202 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/bufferpool.h"
+
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/criticalsection.h"
+
+namespace rtc {
+
+namespace {
+
+const size_t kMinBlockSize = 64;
+const int kNumSizeClasses = 11;
+const size_t kMaxBlockSize = kMinBlockSize << (kNumSizeClasses - 1);
+
+// The most bytes of each size class a thread keeps for itself, and the most
+// kept in the shared lists. Beyond these, freed blocks are deleted.
+const size_t kMaxThreadCachedBytes = 64 * 1024;
+const size_t kMaxSharedBytes = 1024 * 1024;
+
+int SizeClass(size_t size) {
+  int size_class = 0;
+  for (size_t block_size = kMinBlockSize; block_size < size; block_size <<= 1)
+    ++size_class;
+  return size_class;
+}
+
+size_t BlockSize(int size_class) {
+  return kMinBlockSize << size_class;
+}
+
+size_t MaxBlocks(int size_class, size_t max_bytes) {
+  const size_t max_blocks = max_bytes / BlockSize(size_class);
+  return max_blocks < 4 ? 4 : max_blocks;
+}
+
+// A list of free blocks, linked through their first bytes.
+class FreeList {
+ public:
+  FreeList() : head_(NULL), count_(0) {}
+
+  bool empty() const { return head_ == NULL; }
+  size_t count() const { return count_; }
+
+  void Push(char* block) {
+    reinterpret_cast<FreeBlock*>(block)->next = head_;
+    head_ = reinterpret_cast<FreeBlock*>(block);
+    ++count_;
+  }
+
+  char* Pop() {
+    FreeBlock* block = head_;
+    head_ = block->next;
+    --count_;
+    return reinterpret_cast<char*>(block);
+  }
+
+  // Moves up to |count| blocks to |list|.
+  void MoveTo(FreeList* list, size_t count) {
+    while (count-- > 0 && !empty())
+      list->Push(Pop());
+  }
+
+  // Deletes the blocks beyond the first |count|.
+  void Trim(size_t count) {
+    while (count_ > count)
+      delete[] Pop();
+  }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  FreeBlock* head_;
+  size_t count_;
+};
+
+class SharedLists {
+ public:
+  // Moves up to |count| blocks of |size_class| to |list|.
+  void Take(int size_class, FreeList* list, size_t count) {
+    CritScope cs(&crit_);
+    lists_[size_class].MoveTo(list, count);
+  }
+
+  // Moves |count| blocks of |size_class| from |list|.
+  void Give(int size_class, FreeList* list, size_t count) {
+    CritScope cs(&crit_);
+    list->MoveTo(&lists_[size_class], count);
+    lists_[size_class].Trim(MaxBlocks(size_class, kMaxSharedBytes));
+  }
+
+ private:
+  CriticalSection crit_;
+  FreeList lists_[kNumSizeClasses];
+};
+
+SharedLists* GetSharedLists() {
+  LIBJINGLE_DEFINE_STATIC_LOCAL(SharedLists, shared_lists, ());
+  return &shared_lists;
+}
+
+#if defined(WEBRTC_POSIX)
+// The blocks a thread allocates and frees without locking. Handed back to the
+// shared lists when the thread exits.
+struct ThreadCache {
+  FreeList lists[kNumSizeClasses];
+};
+
+pthread_once_t g_cache_key_once = PTHREAD_ONCE_INIT;
+pthread_key_t g_cache_key;
+
+void DeleteThreadCache(void* data) {
+  ThreadCache* cache = static_cast<ThreadCache*>(data);
+  for (int i = 0; i < kNumSizeClasses; ++i)
+    GetSharedLists()->Give(i, &cache->lists[i], cache->lists[i].count());
+  delete cache;
+}
+
+void CreateThreadCacheKey() {
+  pthread_key_create(&g_cache_key, &DeleteThreadCache);
+}
+
+ThreadCache* GetThreadCache() {
+  pthread_once(&g_cache_key_once, &CreateThreadCacheKey);
+  ThreadCache* cache =
+      static_cast<ThreadCache*>(pthread_getspecific(g_cache_key));
+  if (!cache) {
+    cache = new ThreadCache();
+    pthread_setspecific(g_cache_key, cache);
+  }
+  return cache;
+}
+#endif
+
+}  // namespace
+
+// static
+char* BufferPool::Allocate(size_t size) {
+  if (size > kMaxBlockSize)
+    return new char[size];
+  const int size_class = SizeClass(size);
+#if defined(WEBRTC_POSIX)
+  FreeList* list = &GetThreadCache()->lists[size_class];
+  if (list->empty()) {
+    GetSharedLists()->Take(
+        size_class, list, MaxBlocks(size_class, kMaxThreadCachedBytes) / 2);
+  }
+#else
+  // Without thread exit notifications the blocks can't be cached per thread.
+  FreeList block;
+  GetSharedLists()->Take(size_class, &block, 1);
+  FreeList* list = &block;
+#endif
+  if (!list->empty())
+    return list->Pop();
+  return new char[BlockSize(size_class)];
+}
+
+// static
+void BufferPool::Free(char* data, size_t size) {
+  if (!data)
+    return;
+  if (size > kMaxBlockSize) {
+    delete[] data;
+    return;
+  }
+  const int size_class = SizeClass(size);
+#if defined(WEBRTC_POSIX)
+  FreeList* list = &GetThreadCache()->lists[size_class];
+  list->Push(data);
+  const size_t max_blocks = MaxBlocks(size_class, kMaxThreadCachedBytes);
+  if (list->count() > max_blocks)
+    GetSharedLists()->Give(size_class, list, max_blocks / 2);
+#else
+  FreeList block;
+  block.Push(data);
+  GetSharedLists()->Give(size_class, &block, 1);
+#endif
+}
+
+// static
+size_t BufferPool::AllocatedSize(size_t size) {
+  if (size > kMaxBlockSize)
+    return size;
+  return BlockSize(SizeClass(size));
+}
+
+}  // namespace rtc
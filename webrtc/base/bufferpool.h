@@ -0,0 +1,40 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_BUFFERPOOL_H_
+#define WEBRTC_BASE_BUFFERPOOL_H_
+
+#include <stddef.h>
+
+namespace rtc {
+
+// Allocates the storage of Buffer and ByteBuffer, which are created and grown
+// for every packet. Sizes up to 64 kB are rounded up to a power of two, and
+// freed blocks are kept to be reused for the same size class. On POSIX, each
+// thread keeps a few blocks of each class that it allocates and frees without
+// locking, and trades blocks in batches with lists shared by all threads;
+// elsewhere the shared lists are used directly. Larger sizes are allocated
+// with new[].
+class BufferPool {
+ public:
+  // Returns storage for |size| bytes, with room for AllocatedSize(size).
+  static char* Allocate(size_t size);
+
+  // Returns |data|, allocated for |size| bytes, to the pool. |size| may be
+  // any size with the same AllocatedSize() as the one it was allocated for.
+  static void Free(char* data, size_t size);
+
+  // The number of bytes the storage for |size| bytes has room for.
+  static size_t AllocatedSize(size_t size);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_BUFFERPOOL_H_
@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "webrtc/base/bufferpool.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/thread.h"
+
+namespace rtc {
+
+TEST(BufferPoolTest, RoundsUpToSizeClass) {
+  EXPECT_EQ(64U, BufferPool::AllocatedSize(0));
+  EXPECT_EQ(64U, BufferPool::AllocatedSize(64));
+  EXPECT_EQ(128U, BufferPool::AllocatedSize(65));
+  EXPECT_EQ(2048U, BufferPool::AllocatedSize(1500));
+  EXPECT_EQ(65536U, BufferPool::AllocatedSize(65536));
+  EXPECT_EQ(65537U, BufferPool::AllocatedSize(65537));
+}
+
+TEST(BufferPoolTest, ReusesFreedBlocks) {
+  char* data = BufferPool::Allocate(1500);
+  memset(data, 1, BufferPool::AllocatedSize(1500));
+  BufferPool::Free(data, 1500);
+  // Any size of the same class gets the block just freed.
+  EXPECT_EQ(data, BufferPool::Allocate(1100));
+  BufferPool::Free(data, 2048);
+
+  char* large = BufferPool::Allocate(100000);
+  memset(large, 1, 100000);
+  BufferPool::Free(large, 100000);
+}
+
+// Frees on another thread the blocks allocated on the calling thread.
+class FreeOnThread : public MessageHandler {
+ public:
+  FreeOnThread(char** blocks, int num_blocks)
+      : blocks_(blocks), num_blocks_(num_blocks) {}
+
+  virtual void OnMessage(Message* msg) {
+    for (int i = 0; i < num_blocks_; ++i)
+      BufferPool::Free(blocks_[i], 1000);
+  }
+
+ private:
+  char** blocks_;
+  int num_blocks_;
+};
+
+TEST(BufferPoolTest, FreesOnOtherThreads) {
+  const int kNumBlocks = 1000;
+  char* blocks[kNumBlocks];
+  for (int i = 0; i < kNumBlocks; ++i) {
+    blocks[i] = BufferPool::Allocate(1000);
+    memset(blocks[i], i, 1000);
+  }
+  FreeOnThread free_on_thread(blocks, kNumBlocks);
+  Thread thread;
+  thread.Start();
+  thread.Send(&free_on_thread);
+  thread.Stop();
+  // The thread handed its cache back to the shared lists when it exited.
+  for (int i = 0; i < kNumBlocks; ++i)
+    blocks[i] = BufferPool::Allocate(1000);
+  for (int i = 0; i < kNumBlocks; ++i)
+    BufferPool::Free(blocks[i], 1000);
+}
+
+}  // namespace rtc
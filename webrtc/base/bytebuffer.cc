@@ -16,6 +16,7 @@
 #include <algorithm>
 
 #include "webrtc/base/basictypes.h"
+#include "webrtc/base/bufferpool.h"
 #include "webrtc/base/byteorder.h"
 
 namespace rtc {
@@ -46,9 +47,10 @@ void ByteBuffer::Construct(const char* bytes, size_t len,
                            ByteOrder byte_order) {
   version_ = 0;
   start_ = 0;
-  size_ = len;
+  // Whatever room the pool gives beyond |len| is free to write to.
+  size_ = BufferPool::AllocatedSize(len);
   byte_order_ = byte_order;
-  bytes_ = new char[size_];
+  bytes_ = BufferPool::Allocate(size_);
 
   if (bytes) {
     end_ = len;
@@ -59,7 +61,7 @@ void ByteBuffer::Construct(const char* bytes, size_t len,
 }
 
 ByteBuffer::~ByteBuffer() {
-  delete[] bytes_;
+  BufferPool::Free(bytes_, size_);
 }
 
 bool ByteBuffer::ReadUInt8(uint8* val) {
@@ -195,10 +197,11 @@ void ByteBuffer::Resize(size_t size) {
     memmove(bytes_, bytes_ + start_, len);
   } else {
     // Reallocate a larger buffer.
-    size_ = _max(size, 3 * size_ / 2);
-    char* new_bytes = new char[size_];
+    const size_t old_size = size_;
+    size_ = BufferPool::AllocatedSize(_max(size, 3 * size_ / 2));
+    char* new_bytes = BufferPool::Allocate(size_);
     memcpy(new_bytes, bytes_ + start_, len);
-    delete [] bytes_;
+    BufferPool::Free(bytes_, old_size);
     bytes_ = new_bytes;
   }
   start_ = 0;
@@ -14,17 +14,20 @@
 
 namespace rtc {
 
-// This implementation is based on the sample implementation in RFC 1952.
+// This implementation is based on the sample implementation in RFC 1952,
+// extended to process eight bytes per iteration ("slicing-by-8"): table n
+// gives the CRC of a byte followed by n zero bytes, so eight lookups advance
+// the CRC over eight bytes.
 
 // CRC32 polynomial, in reversed form.
 // See RFC 1952, or http://en.wikipedia.org/wiki/Cyclic_redundancy_check
 static const uint32 kCrc32Polynomial = 0xEDB88320;
-static uint32 kCrc32Table[256] = { 0 };
+static uint32 kCrc32Table[8][256] = { { 0 } };
 
 static void EnsureCrc32TableInited() {
-  if (kCrc32Table[ARRAY_SIZE(kCrc32Table) - 1])
+  if (kCrc32Table[7][ARRAY_SIZE(kCrc32Table[0]) - 1])
     return;  // already inited
-  for (uint32 i = 0; i < ARRAY_SIZE(kCrc32Table); ++i) {
+  for (uint32 i = 0; i < ARRAY_SIZE(kCrc32Table[0]); ++i) {
     uint32 c = i;
     for (size_t j = 0; j < 8; ++j) {
       if (c & 1) {
@@ -33,7 +36,15 @@ static void EnsureCrc32TableInited() {
         c >>= 1;
       }
     }
-    kCrc32Table[i] = c;
+    kCrc32Table[0][i] = c;
+  }
+  // The last entry of the last table is filled in last, since it flags the
+  // tables as inited.
+  for (size_t t = 1; t < ARRAY_SIZE(kCrc32Table); ++t) {
+    for (uint32 i = 0; i < ARRAY_SIZE(kCrc32Table[0]); ++i) {
+      const uint32 c = kCrc32Table[t - 1][i];
+      kCrc32Table[t][i] = kCrc32Table[0][c & 0xFF] ^ (c >> 8);
+    }
   }
 }
 
@@ -42,8 +53,24 @@ uint32 UpdateCrc32(uint32 start, const void* buf, size_t len) {
 
   uint32 c = start ^ 0xFFFFFFFF;
   const uint8* u = static_cast<const uint8*>(buf);
+  // The bytes are combined explicitly, so this is independent of the
+  // alignment of |buf| and of the byte order of the host.
+  for (; len >= 8; len -= 8, u += 8) {
+    const uint32 lo = c ^ (u[0] | (u[1] << 8) | (u[2] << 16) |
+                           (static_cast<uint32>(u[3]) << 24));
+    const uint32 hi = u[4] | (u[5] << 8) | (u[6] << 16) |
+                      (static_cast<uint32>(u[7]) << 24);
+    c = kCrc32Table[7][lo & 0xFF] ^
+        kCrc32Table[6][(lo >> 8) & 0xFF] ^
+        kCrc32Table[5][(lo >> 16) & 0xFF] ^
+        kCrc32Table[4][lo >> 24] ^
+        kCrc32Table[3][hi & 0xFF] ^
+        kCrc32Table[2][(hi >> 8) & 0xFF] ^
+        kCrc32Table[1][(hi >> 16) & 0xFF] ^
+        kCrc32Table[0][hi >> 24];
+  }
   for (size_t i = 0; i < len; ++i) {
-    c = kCrc32Table[(c ^ u[i]) & 0xFF] ^ (c >> 8);
+    c = kCrc32Table[0][(c ^ u[i]) & 0xFF] ^ (c >> 8);
   }
   return c ^ 0xFFFFFFFF;
 }
@@ -32,4 +32,27 @@ TEST(Crc32Test, TestMultipleUpdates) {
   EXPECT_EQ(0x171A3F5FU, c);
 }
 
+// Verify that all lengths and alignments give the same result as a bitwise
+// computation of the CRC.
+TEST(Crc32Test, TestLengthsAndAlignments) {
+  uint8 buffer[100];
+  for (size_t i = 0; i < sizeof(buffer); ++i) {
+    buffer[i] = static_cast<uint8>(i * 31 + 7);
+  }
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t len = 0; len + offset <= sizeof(buffer); ++len) {
+      uint32 expected = 0xFFFFFFFF;
+      for (size_t i = 0; i < len; ++i) {
+        expected ^= buffer[offset + i];
+        for (int j = 0; j < 8; ++j) {
+          expected = (expected >> 1) ^ (0xEDB88320 & (0 - (expected & 1)));
+        }
+      }
+      expected ^= 0xFFFFFFFF;
+      EXPECT_EQ(expected, ComputeCrc32(buffer + offset, len))
+          << "offset " << offset << ", length " << len;
+    }
+  }
+}
+
 }  // namespace rtc
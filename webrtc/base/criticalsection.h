@@ -21,6 +21,11 @@
 #include <pthread.h>
 #endif
 
+#if defined(WEBRTC_LOCK_PROFILING)
+#include "webrtc/base/lockprofiler.h"
+#include "webrtc/base/timeutils.h"
+#endif
+
 #ifdef _DEBUG
 #define CS_TRACK_OWNER 1
 #endif  // _DEBUG
@@ -44,6 +49,32 @@ class CriticalSection {
   ~CriticalSection() {
     DeleteCriticalSection(&crit_);
   }
+#if defined(WEBRTC_LOCK_PROFILING)
+  RTC_LOCK_PROFILER_NOINLINE void Enter() {
+    const void* call_site = RTC_CALL_SITE();
+    if (TryEnterCriticalSection(&crit_) == FALSE) {
+      const uint64 start_us = TimeMicros();
+      EnterCriticalSection(&crit_);
+      LockProfiler::RecordWait(call_site,
+                               static_cast<int64>(TimeMicros() - start_us));
+    }
+    profile_state_.Locked(call_site);
+    TRACK_OWNER(thread_ = GetCurrentThreadId());
+  }
+  RTC_LOCK_PROFILER_NOINLINE bool TryEnter() {
+    if (TryEnterCriticalSection(&crit_) != FALSE) {
+      profile_state_.Locked(RTC_CALL_SITE());
+      TRACK_OWNER(thread_ = GetCurrentThreadId());
+      return true;
+    }
+    return false;
+  }
+  void Leave() {
+    TRACK_OWNER(thread_ = 0);
+    profile_state_.Unlocking();
+    LeaveCriticalSection(&crit_);
+  }
+#else
   void Enter() {
     EnterCriticalSection(&crit_);
     TRACK_OWNER(thread_ = GetCurrentThreadId());
@@ -59,6 +90,7 @@ class CriticalSection {
     TRACK_OWNER(thread_ = 0);
     LeaveCriticalSection(&crit_);
   }
+#endif
 
 #if CS_TRACK_OWNER
   bool CurrentThreadIsOwner() const { return thread_ == GetCurrentThreadId(); }
@@ -67,6 +99,9 @@ class CriticalSection {
  private:
   CRITICAL_SECTION crit_;
   TRACK_OWNER(DWORD thread_);  // The section's owning thread id
+#if defined(WEBRTC_LOCK_PROFILING)
+  LockProfileState profile_state_;
+#endif
 };
 #endif // WEBRTC_WIN 
 
@@ -84,6 +119,32 @@ class CriticalSection {
   ~CriticalSection() {
     pthread_mutex_destroy(&mutex_);
   }
+#if defined(WEBRTC_LOCK_PROFILING)
+  RTC_LOCK_PROFILER_NOINLINE void Enter() {
+    const void* call_site = RTC_CALL_SITE();
+    if (pthread_mutex_trylock(&mutex_) != 0) {
+      const uint64 start_us = TimeMicros();
+      pthread_mutex_lock(&mutex_);
+      LockProfiler::RecordWait(call_site,
+                               static_cast<int64>(TimeMicros() - start_us));
+    }
+    profile_state_.Locked(call_site);
+    TRACK_OWNER(thread_ = pthread_self());
+  }
+  RTC_LOCK_PROFILER_NOINLINE bool TryEnter() {
+    if (pthread_mutex_trylock(&mutex_) == 0) {
+      profile_state_.Locked(RTC_CALL_SITE());
+      TRACK_OWNER(thread_ = pthread_self());
+      return true;
+    }
+    return false;
+  }
+  void Leave() {
+    TRACK_OWNER(thread_ = 0);
+    profile_state_.Unlocking();
+    pthread_mutex_unlock(&mutex_);
+  }
+#else
   void Enter() {
     pthread_mutex_lock(&mutex_);
     TRACK_OWNER(thread_ = pthread_self());
@@ -99,6 +160,7 @@ class CriticalSection {
     TRACK_OWNER(thread_ = 0);
     pthread_mutex_unlock(&mutex_);
   }
+#endif
 
 #if CS_TRACK_OWNER
   bool CurrentThreadIsOwner() const { return pthread_equal(thread_, pthread_self()); }
@@ -107,6 +169,9 @@ class CriticalSection {
  private:
   pthread_mutex_t mutex_;
   TRACK_OWNER(pthread_t thread_);
+#if defined(WEBRTC_LOCK_PROFILING)
+  LockProfileState profile_state_;
+#endif
 };
 #endif // WEBRTC_POSIX
 
@@ -164,6 +229,21 @@ class AtomicOps {
   static int Decrement(int* i) {
     return ::InterlockedDecrement(reinterpret_cast<LONG*>(i));
   }
+  static int AcquireLoad(const int* i) {
+    // Aligned loads are acquire loads on the x86 family.
+    return *static_cast<const volatile int*>(i);
+  }
+  // Stores |new_value| in |*ptr| if it holds |old_value|. Returns the previous
+  // value of |*ptr|. Acts as a full memory barrier.
+  template <typename T>
+  static T* CompareAndSwapPtr(T** ptr, T* old_value, T* new_value) {
+    return static_cast<T*>(::InterlockedCompareExchangePointer(
+        reinterpret_cast<PVOID volatile*>(ptr), new_value, old_value));
+  }
+  template <typename T>
+  static T* AcquireLoadPtr(T* const* ptr) {
+    return *static_cast<T* const volatile*>(ptr);
+  }
 #else
   static int Increment(int* i) {
     return __sync_add_and_fetch(i, 1);
@@ -171,6 +251,17 @@ class AtomicOps {
   static int Decrement(int* i) {
     return __sync_sub_and_fetch(i, 1);
   }
+  static int AcquireLoad(const int* i) {
+    return __atomic_load_n(i, __ATOMIC_ACQUIRE);
+  }
+  template <typename T>
+  static T* CompareAndSwapPtr(T** ptr, T* old_value, T* new_value) {
+    return __sync_val_compare_and_swap(ptr, old_value, new_value);
+  }
+  template <typename T>
+  static T* AcquireLoadPtr(T* const* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+  }
 #endif
 };
 
@@ -0,0 +1,374 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/lockprofiler.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <new>
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+#include "webrtc/base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+// Size of the call site tables, a power of two. Call sites beyond it are
+// dropped.
+const int kMaxCallSites = 1024;
+
+// The tables are plain zero-initialized arrays, so that they can be used by
+// allocations made before main() and are never freed.
+struct LockSite {
+  const void* volatile call_site;
+  volatile int64 contended;
+  volatile int64 total_wait_us;
+  volatile int64 max_wait_us;
+  volatile int64 sampled;
+  volatile int64 total_hold_us;
+  volatile int64 max_hold_us;
+};
+
+struct AllocationSite {
+  const void* volatile call_site;
+  volatile int64 count;
+  volatile int64 total_bytes;
+};
+
+LockSite g_lock_sites[kMaxCallSites];
+AllocationSite g_allocation_sites[kMaxCallSites];
+
+#if defined(WEBRTC_WIN)
+void AtomicAdd(volatile int64* value, int64 delta) {
+  InterlockedExchangeAdd64(value, delta);
+}
+
+int64 AtomicCompareExchange(volatile int64* value, int64 old_value,
+                            int64 new_value) {
+  return InterlockedCompareExchange64(value, new_value, old_value);
+}
+
+const void* AtomicCompareExchange(const void* volatile* value,
+                                  const void* old_value,
+                                  const void* new_value) {
+  return InterlockedCompareExchangePointer(
+      const_cast<void* volatile*>(value), const_cast<void*>(new_value),
+      const_cast<void*>(old_value));
+}
+#else
+void AtomicAdd(volatile int64* value, int64 delta) {
+  __sync_fetch_and_add(value, delta);
+}
+
+int64 AtomicCompareExchange(volatile int64* value, int64 old_value,
+                            int64 new_value) {
+  return __sync_val_compare_and_swap(value, old_value, new_value);
+}
+
+const void* AtomicCompareExchange(const void* volatile* value,
+                                  const void* old_value,
+                                  const void* new_value) {
+  return __sync_val_compare_and_swap(value, old_value, new_value);
+}
+#endif
+
+void AtomicMax(volatile int64* value, int64 candidate) {
+  int64 current = *value;
+  while (candidate > current) {
+    const int64 previous = AtomicCompareExchange(value, current, candidate);
+    if (previous == current)
+      return;
+    current = previous;
+  }
+}
+
+// Returns the entry of |call_site| in |sites|, adding it if needed, or NULL if
+// the table is full.
+template <class Site>
+Site* FindSite(Site* sites, const void* call_site) {
+  const uint32 hash = static_cast<uint32>(
+      reinterpret_cast<uintptr_t>(call_site) >> 2) * 2654435761u;
+  for (int i = 0; i < kMaxCallSites; ++i) {
+    Site* site = &sites[(hash + i) & (kMaxCallSites - 1)];
+    const void* current = site->call_site;
+    if (current == NULL)
+      current = AtomicCompareExchange(&site->call_site, NULL, call_site);
+    if (current == NULL || current == call_site)
+      return site;
+  }
+  return NULL;
+}
+
+// The ScopedRealTimeThread depth of each thread is kept in thread local
+// storage, since __thread isn't available everywhere.
+#if defined(WEBRTC_WIN)
+const DWORD g_real_time_key = TlsAlloc();
+
+intptr_t RealTimeDepth() {
+  return reinterpret_cast<intptr_t>(TlsGetValue(g_real_time_key));
+}
+
+void SetRealTimeDepth(intptr_t depth) {
+  TlsSetValue(g_real_time_key, reinterpret_cast<void*>(depth));
+}
+#else
+pthread_once_t g_real_time_key_once = PTHREAD_ONCE_INIT;
+pthread_key_t g_real_time_key;
+
+void CreateRealTimeKey() {
+  pthread_key_create(&g_real_time_key, NULL);
+}
+
+intptr_t RealTimeDepth() {
+  pthread_once(&g_real_time_key_once, &CreateRealTimeKey);
+  return reinterpret_cast<intptr_t>(pthread_getspecific(g_real_time_key));
+}
+
+void SetRealTimeDepth(intptr_t depth) {
+  pthread_once(&g_real_time_key_once, &CreateRealTimeKey);
+  pthread_setspecific(g_real_time_key, reinterpret_cast<void*>(depth));
+}
+#endif
+
+void PrintCallSite(FILE* file, const void* call_site) {
+#if defined(WEBRTC_WIN)
+  fprintf(file, "%p", call_site);
+#else
+  Dl_info info;
+  if (!dladdr(call_site, &info) || !info.dli_sname) {
+    fprintf(file, "%p", call_site);
+    return;
+  }
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+  fprintf(file, "%s+0x%lx", status == 0 ? demangled : info.dli_sname,
+          static_cast<unsigned long>(static_cast<const char*>(call_site) -
+                                     static_cast<const char*>(info.dli_saddr)));
+  free(demangled);
+#endif
+}
+
+bool MoreWait(const LockProfiler::LockStats& a,
+              const LockProfiler::LockStats& b) {
+  return a.total_wait_us > b.total_wait_us;
+}
+
+bool MoreHold(const LockProfiler::LockStats& a,
+              const LockProfiler::LockStats& b) {
+  return a.total_hold_us > b.total_hold_us;
+}
+
+bool MoreAllocations(const LockProfiler::AllocationStats& a,
+                     const LockProfiler::AllocationStats& b) {
+  return a.count > b.count;
+}
+
+}  // namespace
+
+void LockProfiler::RecordWait(const void* call_site, int64 wait_us) {
+  LockSite* site = FindSite(g_lock_sites, call_site);
+  if (!site)
+    return;
+  AtomicAdd(&site->contended, 1);
+  AtomicAdd(&site->total_wait_us, wait_us);
+  AtomicMax(&site->max_wait_us, wait_us);
+}
+
+void LockProfiler::RecordHold(const void* call_site, int64 hold_us) {
+  LockSite* site = FindSite(g_lock_sites, call_site);
+  if (!site)
+    return;
+  AtomicAdd(&site->sampled, 1);
+  AtomicAdd(&site->total_hold_us, hold_us);
+  AtomicMax(&site->max_hold_us, hold_us);
+}
+
+void LockProfiler::RecordAllocation(const void* call_site, size_t bytes) {
+  if (!IsRealTimeThread())
+    return;
+  AllocationSite* site = FindSite(g_allocation_sites, call_site);
+  if (!site)
+    return;
+  AtomicAdd(&site->count, 1);
+  AtomicAdd(&site->total_bytes, static_cast<int64>(bytes));
+}
+
+bool LockProfiler::IsRealTimeThread() {
+  return RealTimeDepth() > 0;
+}
+
+void LockProfiler::GetLockStats(std::vector<LockStats>* stats) {
+  stats->clear();
+  for (int i = 0; i < kMaxCallSites; ++i) {
+    const LockSite& site = g_lock_sites[i];
+    if (!site.call_site)
+      continue;
+    LockStats lock_stats;
+    lock_stats.call_site = site.call_site;
+    lock_stats.contended = site.contended;
+    lock_stats.total_wait_us = site.total_wait_us;
+    lock_stats.max_wait_us = site.max_wait_us;
+    lock_stats.sampled = site.sampled;
+    lock_stats.total_hold_us = site.total_hold_us;
+    lock_stats.max_hold_us = site.max_hold_us;
+    stats->push_back(lock_stats);
+  }
+}
+
+void LockProfiler::GetAllocationStats(std::vector<AllocationStats>* stats) {
+  stats->clear();
+  for (int i = 0; i < kMaxCallSites; ++i) {
+    const AllocationSite& site = g_allocation_sites[i];
+    if (!site.call_site)
+      continue;
+    AllocationStats allocation_stats;
+    allocation_stats.call_site = site.call_site;
+    allocation_stats.count = site.count;
+    allocation_stats.total_bytes = site.total_bytes;
+    stats->push_back(allocation_stats);
+  }
+}
+
+void LockProfiler::PrintReport(FILE* file, size_t max_sites) {
+  std::vector<LockStats> locks;
+  GetLockStats(&locks);
+
+  std::sort(locks.begin(), locks.end(), MoreWait);
+  fprintf(file, "Lock wait (contended acquisitions, total/max us):\n");
+  for (size_t i = 0; i < locks.size() && i < max_sites; ++i) {
+    if (locks[i].contended == 0)
+      break;
+    fprintf(file, "  %8lld %10lld %8lld  ",
+            static_cast<long long>(locks[i].contended),
+            static_cast<long long>(locks[i].total_wait_us),
+            static_cast<long long>(locks[i].max_wait_us));
+    PrintCallSite(file, locks[i].call_site);
+    fprintf(file, "\n");
+  }
+
+  std::sort(locks.begin(), locks.end(), MoreHold);
+  fprintf(file, "Lock hold (sampled acquisitions, mean/max us):\n");
+  for (size_t i = 0; i < locks.size() && i < max_sites; ++i) {
+    if (locks[i].sampled == 0)
+      break;
+    fprintf(file, "  %8lld %10.1f %8lld  ",
+            static_cast<long long>(locks[i].sampled),
+            static_cast<double>(locks[i].total_hold_us) / locks[i].sampled,
+            static_cast<long long>(locks[i].max_hold_us));
+    PrintCallSite(file, locks[i].call_site);
+    fprintf(file, "\n");
+  }
+
+  std::vector<AllocationStats> allocations;
+  GetAllocationStats(&allocations);
+  std::sort(allocations.begin(), allocations.end(), MoreAllocations);
+  fprintf(file, "Real-time thread allocations (count, bytes):\n");
+  for (size_t i = 0; i < allocations.size(); ++i) {
+    fprintf(file, "  %8lld %10lld  ",
+            static_cast<long long>(allocations[i].count),
+            static_cast<long long>(allocations[i].total_bytes));
+    PrintCallSite(file, allocations[i].call_site);
+    fprintf(file, "\n");
+  }
+}
+
+LockProfileState::LockProfileState()
+    : depth_(0),
+      acquisitions_(0),
+      call_site_(NULL),
+      locked_at_us_(0) {}
+
+void LockProfileState::Locked(const void* call_site) {
+  if (depth_++ > 0)
+    return;
+  if (++acquisitions_ % LockProfiler::kHoldSampleInterval != 0)
+    return;
+  call_site_ = call_site;
+  locked_at_us_ = TimeMicros();
+}
+
+void LockProfileState::Unlocking() {
+  if (--depth_ > 0 || !call_site_)
+    return;
+  LockProfiler::RecordHold(call_site_,
+                           static_cast<int64>(TimeMicros() - locked_at_us_));
+  call_site_ = NULL;
+}
+
+ScopedRealTimeThread::ScopedRealTimeThread() {
+  SetRealTimeDepth(RealTimeDepth() + 1);
+}
+
+ScopedRealTimeThread::~ScopedRealTimeThread() {
+  SetRealTimeDepth(RealTimeDepth() - 1);
+}
+
+}  // namespace rtc
+
+// Reports the allocations made through operator new from real-time threads.
+// Chromium has its own allocator shims, and Windows links operator new from
+// the CRT in every module, so this is only done in standalone POSIX builds.
+#if defined(WEBRTC_LOCK_PROFILING) && defined(WEBRTC_POSIX) && \
+    !defined(WEBRTC_CHROMIUM_BUILD)
+namespace {
+
+void* ProfiledNew(const void* call_site, size_t size) {
+  rtc::LockProfiler::RecordAllocation(call_site, size);
+  void* memory = malloc(size ? size : 1);
+  if (!memory)
+    abort();
+  return memory;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  return ProfiledNew(RTC_CALL_SITE(), size);
+}
+
+void* operator new[](size_t size) {
+  return ProfiledNew(RTC_CALL_SITE(), size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw() {
+  rtc::LockProfiler::RecordAllocation(RTC_CALL_SITE(), size);
+  return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw() {
+  rtc::LockProfiler::RecordAllocation(RTC_CALL_SITE(), size);
+  return malloc(size ? size : 1);
+}
+
+void operator delete(void* memory) throw() {
+  free(memory);
+}
+
+void operator delete[](void* memory) throw() {
+  free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) throw() {
+  free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) throw() {
+  free(memory);
+}
+#endif
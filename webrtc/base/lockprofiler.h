@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Lock contention and real-time allocation profiling, for tracking latency
+// spikes down to the code responsible for them. The locks and allocators are
+// only instrumented in builds with enable_lock_profiling=1, which defines
+// WEBRTC_LOCK_PROFILING:
+//
+// * rtc::CriticalSection and webrtc::CriticalSectionWrapper record, per call
+//   site, the time spent waiting for every contended acquisition, and how
+//   long the lock is then held for one in kHoldSampleInterval acquisitions.
+//   The hold time includes the time spent waiting on condition variables
+//   with the lock.
+//
+// * Heap allocations through operator new (on POSIX) and AlignedMalloc are
+//   recorded, per call site, when they are made from a thread inside a
+//   ScopedRealTimeThread, such as the audio device callbacks.
+//
+// Call sites are return addresses, so scoped lockers such as CritScope only
+// show up as their callers once inlined. PrintReport() resolves them to
+// symbols where the platform can. Recording never allocates or takes a lock,
+// so it is safe from real-time threads.
+
+#ifndef WEBRTC_BASE_LOCKPROFILER_H_
+#define WEBRTC_BASE_LOCKPROFILER_H_
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/constructormagic.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define RTC_LOCK_PROFILER_NOINLINE __declspec(noinline)
+#define RTC_CALL_SITE() _ReturnAddress()
+#else
+#define RTC_LOCK_PROFILER_NOINLINE __attribute__((noinline))
+#define RTC_CALL_SITE() __builtin_return_address(0)
+#endif
+
+namespace rtc {
+
+class LockProfiler {
+ public:
+  // One in this many acquisitions of a lock has its hold time measured.
+  static const int kHoldSampleInterval = 16;
+
+  struct LockStats {
+    const void* call_site;
+    int64 contended;  // Acquisitions that had to wait.
+    int64 total_wait_us;
+    int64 max_wait_us;
+    int64 sampled;  // Acquisitions whose hold time was measured.
+    int64 total_hold_us;
+    int64 max_hold_us;
+  };
+
+  struct AllocationStats {
+    const void* call_site;
+    int64 count;
+    int64 total_bytes;
+  };
+
+  // Records that |call_site| waited |wait_us| for a lock.
+  static void RecordWait(const void* call_site, int64 wait_us);
+  // Records that |call_site| held a lock for |hold_us|.
+  static void RecordHold(const void* call_site, int64 hold_us);
+  // Records an allocation of |bytes| by |call_site|, if the calling thread is
+  // in a ScopedRealTimeThread.
+  static void RecordAllocation(const void* call_site, size_t bytes);
+
+  static bool IsRealTimeThread();
+
+  // Read back the statistics of all call sites recorded so far.
+  static void GetLockStats(std::vector<LockStats>* stats);
+  static void GetAllocationStats(std::vector<AllocationStats>* stats);
+
+  // Prints the |max_sites| call sites with the most time spent waiting for
+  // and holding locks, and all the real-time allocations.
+  static void PrintReport(FILE* file, size_t max_sites);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(LockProfiler);
+};
+
+// The state of a lock needed to measure its hold time. Only used with the lock
+// held.
+class LockProfileState {
+ public:
+  LockProfileState();
+
+  // Called by |call_site| right after taking the lock.
+  void Locked(const void* call_site);
+  // Called right before releasing the lock.
+  void Unlocking();
+
+ private:
+  // Number of times the owner has entered the lock, which may be recursive.
+  int depth_;
+  int acquisitions_;
+  // NULL unless the current acquisition is sampled.
+  const void* call_site_;
+  uint64 locked_at_us_;
+
+  DISALLOW_COPY_AND_ASSIGN(LockProfileState);
+};
+
+// Marks the calling thread as real-time while in scope, typically for the
+// duration of a callback from the audio device.
+class ScopedRealTimeThread {
+ public:
+  ScopedRealTimeThread();
+  ~ScopedRealTimeThread();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ScopedRealTimeThread);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_LOCKPROFILER_H_
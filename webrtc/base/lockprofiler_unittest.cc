@@ -0,0 +1,105 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/lockprofiler.h"
+
+namespace rtc {
+
+namespace {
+
+// Distinct addresses to use as call sites, since the tables are process wide.
+char g_wait_site;
+char g_hold_site;
+char g_allocation_site;
+char g_other_allocation_site;
+
+bool FindLockStats(const void* call_site, LockProfiler::LockStats* stats) {
+  std::vector<LockProfiler::LockStats> all_stats;
+  LockProfiler::GetLockStats(&all_stats);
+  for (size_t i = 0; i < all_stats.size(); ++i) {
+    if (all_stats[i].call_site == call_site) {
+      *stats = all_stats[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FindAllocationStats(const void* call_site,
+                         LockProfiler::AllocationStats* stats) {
+  std::vector<LockProfiler::AllocationStats> all_stats;
+  LockProfiler::GetAllocationStats(&all_stats);
+  for (size_t i = 0; i < all_stats.size(); ++i) {
+    if (all_stats[i].call_site == call_site) {
+      *stats = all_stats[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(LockProfilerTest, RecordsWaitTimes) {
+  LockProfiler::RecordWait(&g_wait_site, 10);
+  LockProfiler::RecordWait(&g_wait_site, 30);
+
+  LockProfiler::LockStats stats;
+  ASSERT_TRUE(FindLockStats(&g_wait_site, &stats));
+  EXPECT_EQ(2, stats.contended);
+  EXPECT_EQ(40, stats.total_wait_us);
+  EXPECT_EQ(30, stats.max_wait_us);
+  EXPECT_EQ(0, stats.sampled);
+}
+
+TEST(LockProfilerTest, SamplesHoldTimes) {
+  LockProfileState state;
+  for (int i = 0; i < 3 * LockProfiler::kHoldSampleInterval; ++i) {
+    state.Locked(&g_hold_site);
+    // Recursive acquisitions are part of the outer one.
+    state.Locked(&g_hold_site);
+    state.Unlocking();
+    state.Unlocking();
+  }
+
+  LockProfiler::LockStats stats;
+  ASSERT_TRUE(FindLockStats(&g_hold_site, &stats));
+  EXPECT_EQ(3, stats.sampled);
+  EXPECT_EQ(0, stats.contended);
+  EXPECT_LE(0, stats.max_hold_us);
+}
+
+TEST(LockProfilerTest, RecordsAllocationsOfRealTimeThreads) {
+  EXPECT_FALSE(LockProfiler::IsRealTimeThread());
+  LockProfiler::RecordAllocation(&g_other_allocation_site, 100);
+  {
+    ScopedRealTimeThread real_time_thread;
+    EXPECT_TRUE(LockProfiler::IsRealTimeThread());
+    LockProfiler::RecordAllocation(&g_allocation_site, 100);
+    {
+      ScopedRealTimeThread nested_real_time_thread;
+      LockProfiler::RecordAllocation(&g_allocation_site, 20);
+    }
+    EXPECT_TRUE(LockProfiler::IsRealTimeThread());
+  }
+  EXPECT_FALSE(LockProfiler::IsRealTimeThread());
+  LockProfiler::RecordAllocation(&g_allocation_site, 100);
+
+  LockProfiler::AllocationStats stats;
+  EXPECT_FALSE(FindAllocationStats(&g_other_allocation_site, &stats));
+  ASSERT_TRUE(FindAllocationStats(&g_allocation_site, &stats));
+  EXPECT_EQ(2, stats.count);
+  EXPECT_EQ(120, stats.total_bytes);
+}
+
+}  // namespace rtc
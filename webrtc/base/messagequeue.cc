@@ -105,12 +105,273 @@ void MessageQueueManager::ClearInternal(MessageHandler *handler) {
     (*iter)->Clear(handler);
 }
 
+//------------------------------------------------------------------
+// DelayedMessageQueue
+
+namespace {
+
+bool TriggersEarlier(const DelayedMessage& a, const DelayedMessage& b) {
+  int32 diff = TimeDiff(a.msTrigger_, b.msTrigger_);
+  return diff < 0 || (diff == 0 && a.num_ < b.num_);
+}
+
+}  // namespace
+
+DelayedMessageQueue::DelayedMessageQueue()
+    : base_(0), size_(0), expired_(NULL), free_nodes_(NULL) {
+  memset(slots_, 0, sizeof(slots_));
+  memset(level_size_, 0, sizeof(level_size_));
+}
+
+DelayedMessageQueue::~DelayedMessageQueue() {
+  // Message data is owned by the MessageQueue, which clears the queue before
+  // destroying it.
+  for (HandlerMap::iterator it = handlers_.begin(); it != handlers_.end();
+       ++it) {
+    Node* node = it->second;
+    while (node) {
+      Node* next = node->handler_next;
+      delete node;
+      node = next;
+    }
+  }
+  while (free_nodes_) {
+    Node* next = free_nodes_->next;
+    delete free_nodes_;
+    free_nodes_ = next;
+  }
+}
+
+void DelayedMessageQueue::Push(uint32 now, const DelayedMessage& dmsg) {
+  if (size_ == 0) {
+    // Nothing is scheduled relative to the old wheel time.
+    base_ = now;
+  }
+  Node* node = NewNode(dmsg);
+  Node*& handler_head = handlers_[dmsg.msg_.phandler];
+  node->handler_prev = NULL;
+  node->handler_next = handler_head;
+  if (handler_head)
+    handler_head->handler_prev = node;
+  handler_head = node;
+  Insert(node);
+  ++size_;
+}
+
+void DelayedMessageQueue::PopExpired(uint32 now, MessageList* due) {
+  if (size_ == 0)
+    return;
+  Advance(now);
+  if (!expired_)
+    return;
+
+  sort_buffer_.clear();
+  for (Node* node = expired_; node; node = node->next)
+    sort_buffer_.push_back(node);
+  expired_ = NULL;
+  std::sort(sort_buffer_.begin(), sort_buffer_.end(), NodeTriggersEarlier);
+  for (size_t i = 0; i < sort_buffer_.size(); ++i) {
+    Node* node = sort_buffer_[i];
+    due->push_back(node->dmsg.msg_);
+    HandlerMap::iterator it = handlers_.find(node->dmsg.msg_.phandler);
+    ASSERT(it != handlers_.end());
+    UnlinkHandler(it, node);
+    if (!it->second)
+      handlers_.erase(it);
+    FreeNode(node);
+  }
+  size_ -= sort_buffer_.size();
+  sort_buffer_.clear();
+}
+
+bool DelayedMessageQueue::NextTrigger(uint32* trigger) const {
+  if (size_ == 0)
+    return false;
+  const DelayedMessage* earliest = NULL;
+  for (Node* node = expired_; node; node = node->next) {
+    if (!earliest || TriggersEarlier(node->dmsg, *earliest))
+      earliest = &node->dmsg;
+  }
+  for (int level = 0; level < kWheelLevels; ++level) {
+    if (level_size_[level] == 0)
+      continue;
+    // Slots are cascaded in index order, starting with the slot for |base_|
+    // if it has not been cascaded yet. The first non-empty slot holds the
+    // earliest messages of the level.
+    const int shift = kWheelBits * level;
+    uint32 first = base_ >> shift;
+    if (level > 0 && (base_ & ((1u << shift) - 1)) != 0)
+      ++first;
+    for (int i = 0; i < kWheelSize; ++i) {
+      Node* node = slots_[level][(first + i) & kWheelMask];
+      if (!node)
+        continue;
+      for (; node; node = node->next) {
+        if (!earliest || TriggersEarlier(node->dmsg, *earliest))
+          earliest = &node->dmsg;
+      }
+      break;
+    }
+  }
+  ASSERT(earliest != NULL);
+  *trigger = earliest->msTrigger_;
+  return true;
+}
+
+void DelayedMessageQueue::Clear(MessageHandler* phandler, uint32 id,
+                                MessageList* removed) {
+  HandlerMap::iterator it = phandler ? handlers_.find(phandler)
+                                     : handlers_.begin();
+  while (it != handlers_.end()) {
+    Node* node = it->second;
+    while (node) {
+      Node* next = node->handler_next;
+      if (id == MQID_ANY || id == node->dmsg.msg_.message_id) {
+        removed->push_back(node->dmsg.msg_);
+        Unlink(node);
+        UnlinkHandler(it, node);
+        FreeNode(node);
+        --size_;
+      }
+      node = next;
+    }
+    if (!it->second) {
+      handlers_.erase(it++);
+    } else {
+      ++it;
+    }
+    if (phandler)
+      break;
+  }
+}
+
+bool DelayedMessageQueue::NodeTriggersEarlier(const Node* a, const Node* b) {
+  return TriggersEarlier(a->dmsg, b->dmsg);
+}
+
+DelayedMessageQueue::Node* DelayedMessageQueue::NewNode(
+    const DelayedMessage& dmsg) {
+  if (!free_nodes_)
+    return new Node(dmsg);
+  Node* node = free_nodes_;
+  free_nodes_ = node->next;
+  node->dmsg = dmsg;
+  return node;
+}
+
+void DelayedMessageQueue::FreeNode(Node* node) {
+  node->next = free_nodes_;
+  free_nodes_ = node;
+}
+
+void DelayedMessageQueue::Insert(Node* node) {
+  const uint32 trigger = node->dmsg.msTrigger_;
+  const int32 delay = TimeDiff(trigger, base_);
+  if (delay < 0) {
+    Link(&expired_, -1, node);
+    return;
+  }
+  int level = 0;
+  while (level < kWheelLevels - 1 &&
+         static_cast<uint32>(delay) >= (1u << (kWheelBits * (level + 1)))) {
+    ++level;
+  }
+  Link(&slots_[level][(trigger >> (kWheelBits * level)) & kWheelMask], level,
+       node);
+}
+
+void DelayedMessageQueue::Link(Node** list, int level, Node* node) {
+  node->list = list;
+  node->level = level;
+  node->prev = NULL;
+  node->next = *list;
+  if (*list)
+    (*list)->prev = node;
+  *list = node;
+  if (level >= 0)
+    ++level_size_[level];
+}
+
+void DelayedMessageQueue::Unlink(Node* node) {
+  if (node->prev) {
+    node->prev->next = node->next;
+  } else {
+    *node->list = node->next;
+  }
+  if (node->next)
+    node->next->prev = node->prev;
+  if (node->level >= 0)
+    --level_size_[node->level];
+}
+
+void DelayedMessageQueue::UnlinkHandler(HandlerMap::iterator it, Node* node) {
+  if (node->handler_prev) {
+    node->handler_prev->handler_next = node->handler_next;
+  } else {
+    it->second = node->handler_next;
+  }
+  if (node->handler_next)
+    node->handler_next->handler_prev = node->handler_prev;
+}
+
+void DelayedMessageQueue::Cascade() {
+  for (int level = 1; level < kWheelLevels; ++level) {
+    const uint32 index = (base_ >> (kWheelBits * level)) & kWheelMask;
+    Node* node = slots_[level][index];
+    slots_[level][index] = NULL;
+    while (node) {
+      Node* next = node->next;
+      --level_size_[level];
+      Insert(node);
+      node = next;
+    }
+    // The next level is only due when this one wraps around.
+    if (index != 0)
+      break;
+  }
+}
+
+void DelayedMessageQueue::Advance(uint32 now) {
+  while (TimeDiff(now, base_) >= 0) {
+    if ((base_ & kWheelMask) == 0)
+      Cascade();
+    int empty_levels = 0;
+    while (empty_levels < kWheelLevels && level_size_[empty_levels] == 0)
+      ++empty_levels;
+    if (empty_levels == kWheelLevels) {
+      base_ = now + 1;
+      return;
+    }
+    if (empty_levels > 0) {
+      // Nothing can be due before the first non-empty level is cascaded
+      // again, so skip ahead to that point.
+      uint32 next = (base_ | ((1u << (kWheelBits * empty_levels)) - 1)) + 1;
+      if (TimeDiff(now, next) < 0) {
+        base_ = now + 1;
+        return;
+      }
+      base_ = next;
+      continue;
+    }
+    Node** slot = &slots_[0][base_ & kWheelMask];
+    Node* node = *slot;
+    *slot = NULL;
+    while (node) {
+      Node* next = node->next;
+      --level_size_[0];
+      Link(&expired_, -1, node);
+      node = next;
+    }
+    ++base_;
+  }
+}
+
 //------------------------------------------------------------------
 // MessageQueue
 
 MessageQueue::MessageQueue(SocketServer* ss)
     : ss_(ss), fStop_(false), fPeekKeep_(false),
-      dmsgq_next_num_(0) {
+      dmsgq_next_num_(0), posted_(NULL), waiting_(0) {
   if (!ss_) {
     // Currently, MessageQueue holds a socket server, and is the base class for
     // Thread.  It seems like it makes more sense for Thread to hold the socket
@@ -195,18 +456,15 @@ bool MessageQueue::Get(Message *pmsg, int cmsWait, bool process_io) {
       // Otherwise, disposed MessageHandlers will cause deadlocks.
       {
         CritScope cs(&crit_);
+        TakePosted();
         // On the first pass, check for delayed messages that have been
         // triggered and calculate the next trigger time.
         if (first_pass) {
           first_pass = false;
-          while (!dmsgq_.empty()) {
-            if (TimeIsLater(msCurrent, dmsgq_.top().msTrigger_)) {
-              cmsDelayNext = TimeDiff(dmsgq_.top().msTrigger_, msCurrent);
-              break;
-            }
-            msgq_.push_back(dmsgq_.top().msg_);
-            dmsgq_.pop();
-          }
+          dmsgq_.PopExpired(msCurrent, &msgq_);
+          uint32 trigger;
+          if (dmsgq_.NextTrigger(&trigger))
+            cmsDelayNext = TimeDiff(trigger, msCurrent);
         }
         // Pull a message off the message queue, if available.
         if (msgq_.empty()) {
@@ -249,8 +507,15 @@ bool MessageQueue::Get(Message *pmsg, int cmsWait, bool process_io) {
         cmsNext = cmsDelayNext;
     }
 
-    // Wait and multiplex in the meantime
-    if (!ss_->Wait(cmsNext, process_io))
+    // Wait and multiplex in the meantime. Post() skips the wake-up unless
+    // |waiting_| is set, so check for messages posted before it was set.
+    // Both sides use full barriers, so either Post() sees |waiting_| or
+    // the message is seen here.
+    AtomicOps::Increment(&waiting_);
+    bool posted = AtomicOps::AcquireLoadPtr(&posted_) != NULL;
+    bool ok = posted || ss_->Wait(cmsNext, process_io);
+    AtomicOps::Decrement(&waiting_);
+    if (!ok)
       return false;
 
     // If the specified timeout expired, return
@@ -274,19 +539,42 @@ void MessageQueue::Post(MessageHandler *phandler, uint32 id,
     return;
 
   // Keep thread safe
-  // Add the message to the end of the queue
-  // Signal for the multiplexer to return
+  // Add the message to the posted stack without taking |crit_|
+  // Signal for the multiplexer to return, if it is waiting
 
-  CritScope cs(&crit_);
-  Message msg;
-  msg.phandler = phandler;
-  msg.message_id = id;
-  msg.pdata = pdata;
+  PostedMessage* posted = new PostedMessage;
+  posted->msg.phandler = phandler;
+  posted->msg.message_id = id;
+  posted->msg.pdata = pdata;
   if (time_sensitive) {
-    msg.ts_sensitive = Time() + kMaxMsgLatency;
+    posted->msg.ts_sensitive = Time() + kMaxMsgLatency;
+  }
+  PostedMessage* head;
+  do {
+    head = AtomicOps::AcquireLoadPtr(&posted_);
+    posted->next = head;
+  } while (AtomicOps::CompareAndSwapPtr(&posted_, head, posted) != head);
+  if (AtomicOps::AcquireLoad(&waiting_))
+    ss_->WakeUp();
+}
+
+void MessageQueue::TakePosted() {
+  PostedMessage* head;
+  do {
+    head = AtomicOps::AcquireLoadPtr(&posted_);
+    if (!head)
+      return;
+  } while (AtomicOps::CompareAndSwapPtr(&posted_, head,
+                                        static_cast<PostedMessage*>(NULL)) !=
+           head);
+  // The stack is newest first; splice it in reverse behind |msgq_|.
+  MessageList::iterator end = msgq_.end();
+  while (head) {
+    end = msgq_.insert(end, head->msg);
+    PostedMessage* next = head->next;
+    delete head;
+    head = next;
   }
-  msgq_.push_back(msg);
-  ss_->WakeUp();
 }
 
 void MessageQueue::DoDelayPost(int cmsDelay, uint32 tstamp,
@@ -295,7 +583,7 @@ void MessageQueue::DoDelayPost(int cmsDelay, uint32 tstamp,
     return;
 
   // Keep thread safe
-  // Add to the priority queue. Gets sorted soonest first.
+  // Add to the delayed queue. Gets sorted soonest first.
   // Signal for the multiplexer to return.
 
   CritScope cs(&crit_);
@@ -304,7 +592,7 @@ void MessageQueue::DoDelayPost(int cmsDelay, uint32 tstamp,
   msg.message_id = id;
   msg.pdata = pdata;
   DelayedMessage dmsg(cmsDelay, tstamp, dmsgq_next_num_, msg);
-  dmsgq_.push(dmsg);
+  dmsgq_.Push(Time(), dmsg);
   // If this message queue processes 1 message every millisecond for 50 days,
   // we will wrap this number.  Even then, only messages with identical times
   // will be misordered, and then only briefly.  This is probably ok.
@@ -314,12 +602,14 @@ void MessageQueue::DoDelayPost(int cmsDelay, uint32 tstamp,
 
 int MessageQueue::GetDelay() {
   CritScope cs(&crit_);
+  TakePosted();
 
   if (!msgq_.empty())
     return 0;
 
-  if (!dmsgq_.empty()) {
-    int delay = TimeUntil(dmsgq_.top().msTrigger_);
+  uint32 trigger;
+  if (dmsgq_.NextTrigger(&trigger)) {
+    int delay = TimeUntil(trigger);
     if (delay < 0)
       delay = 0;
     return delay;
@@ -331,6 +621,7 @@ int MessageQueue::GetDelay() {
 void MessageQueue::Clear(MessageHandler *phandler, uint32 id,
                          MessageList* removed) {
   CritScope cs(&crit_);
+  TakePosted();
 
   // Remove messages with phandler
 
@@ -358,23 +649,28 @@ void MessageQueue::Clear(MessageHandler *phandler, uint32 id,
     }
   }
 
-  // Remove from priority queue. Not directly iterable, so use this approach
+  // Remove from delayed queue
 
-  PriorityQueue::container_type::iterator new_end = dmsgq_.container().begin();
-  for (PriorityQueue::container_type::iterator it = new_end;
-       it != dmsgq_.container().end(); ++it) {
-    if (it->msg_.Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(it->msg_);
-      } else {
-        delete it->msg_.pdata;
-      }
-    } else {
-      *new_end++ = *it;
-    }
+  if (removed) {
+    dmsgq_.Clear(phandler, id, removed);
+  } else {
+    MessageList delayed;
+    dmsgq_.Clear(phandler, id, &delayed);
+    for (MessageList::iterator it = delayed.begin(); it != delayed.end(); ++it)
+      delete it->pdata;
+  }
+}
+
+size_t MessageQueue::size() const {
+  CritScope cs(&crit_);  // msgq_.size() is not thread safe.
+  size_t posted = 0;
+  // Nodes are only freed by TakePosted(), under |crit_|, and Post() never
+  // changes a node once it is on the stack.
+  for (const PostedMessage* node = AtomicOps::AcquireLoadPtr(&posted_); node;
+       node = node->next) {
+    ++posted;
   }
-  dmsgq_.container().erase(new_end, dmsgq_.container().end());
-  dmsgq_.reheap();
+  return msgq_.size() + dmsgq_.size() + (fPeekKeep_ ? 1u : 0u) + posted;
 }
 
 void MessageQueue::Dispatch(Message *pmsg) {
@@ -15,7 +15,7 @@
 
 #include <algorithm>
 #include <list>
-#include <queue>
+#include <map>
 #include <vector>
 
 #include "webrtc/base/basictypes.h"
@@ -144,8 +144,8 @@ struct Message {
 
 typedef std::list<Message> MessageList;
 
-// DelayedMessage goes into a priority queue, sorted by trigger time.  Messages
-// with the same trigger time are processed in num_ (FIFO) order.
+// DelayedMessage goes into a DelayedMessageQueue, sorted by trigger time.
+// Messages with the same trigger time are processed in num_ (FIFO) order.
 
 class DelayedMessage {
  public:
@@ -163,6 +163,88 @@ class DelayedMessage {
   Message msg_;
 };
 
+// DelayedMessageQueue holds the delayed messages of a MessageQueue in a
+// hierarchical timer wheel. Four levels of 256 slots cover the full 32-bit
+// millisecond clock; level N slots span 256^N ms and are cascaded into the
+// level below when the wheel time reaches them. Posting and removing a message
+// are O(1), and each handler's messages are linked together so that clearing
+// a handler does not touch messages of other handlers.
+// Not thread safe; MessageQueue guards it with its |crit_|.
+class DelayedMessageQueue {
+ public:
+  DelayedMessageQueue();
+  ~DelayedMessageQueue();
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // Adds |dmsg|, which triggers at |dmsg.msTrigger_|. |now| is the current
+  // time.
+  void Push(uint32 now, const DelayedMessage& dmsg);
+
+  // Appends the messages whose trigger time is not later than |now| to |due|,
+  // sorted by trigger time. Messages with the same trigger time are appended
+  // in FIFO order.
+  void PopExpired(uint32 now, MessageList* due);
+
+  // Returns false if the queue is empty, otherwise sets |trigger| to the
+  // earliest trigger time.
+  bool NextTrigger(uint32* trigger) const;
+
+  // Moves the messages matching |phandler| and |id| to |removed|. A NULL
+  // |phandler| matches all handlers.
+  void Clear(MessageHandler* phandler, uint32 id, MessageList* removed);
+
+ private:
+  static const int kWheelBits = 8;
+  static const int kWheelSize = 1 << kWheelBits;
+  static const uint32 kWheelMask = kWheelSize - 1;
+  static const int kWheelLevels = 4;
+
+  struct Node {
+    explicit Node(const DelayedMessage& dmsg) : dmsg(dmsg) {}
+
+    DelayedMessage dmsg;
+    // Links within the slot (or the expired list) holding the message.
+    Node** list;
+    int level;  // -1 for the expired list.
+    Node* prev;
+    Node* next;
+    // Links within the list of messages with the same handler.
+    Node* handler_prev;
+    Node* handler_next;
+  };
+  typedef std::map<MessageHandler*, Node*> HandlerMap;
+
+  static bool NodeTriggersEarlier(const Node* a, const Node* b);
+  Node* NewNode(const DelayedMessage& dmsg);
+  void FreeNode(Node* node);
+  // Puts |node| into the slot matching its trigger time relative to |base_|.
+  void Insert(Node* node);
+  void Link(Node** list, int level, Node* node);
+  void Unlink(Node* node);
+  void UnlinkHandler(HandlerMap::iterator it, Node* node);
+  // Re-inserts the messages of the higher level slots which are due to be
+  // split up at |base_|.
+  void Cascade();
+  // Moves all messages with a trigger time not later than |now| to
+  // |expired_|.
+  void Advance(uint32 now);
+
+  // All messages triggering before |base_| are in |expired_|.
+  uint32 base_;
+  size_t size_;
+  Node* slots_[kWheelLevels][kWheelSize];
+  size_t level_size_[kWheelLevels];
+  Node* expired_;
+  HandlerMap handlers_;
+  // Nodes are recycled to avoid an allocation per posted message.
+  Node* free_nodes_;
+  std::vector<Node*> sort_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(DelayedMessageQueue);
+};
+
 class MessageQueue {
  public:
   explicit MessageQueue(SocketServer* ss = NULL);
@@ -207,10 +289,7 @@ class MessageQueue {
   virtual int GetDelay();
 
   bool empty() const { return size() == 0u; }
-  size_t size() const {
-    CritScope cs(&crit_);  // msgq_.size() is not thread safe.
-    return msgq_.size() + dmsgq_.size() + (fPeekKeep_ ? 1u : 0u);
-  }
+  size_t size() const;
 
   // Internally posts a message which causes the doomed object to be deleted
   template<class T> void Dispose(T* doomed) {
@@ -224,15 +303,13 @@ class MessageQueue {
   sigslot::signal0<> SignalQueueDestroyed;
 
  protected:
-  class PriorityQueue : public std::priority_queue<DelayedMessage> {
-   public:
-    container_type& container() { return c; }
-    void reheap() { make_heap(c.begin(), c.end(), comp); }
-  };
-
   void DoDelayPost(int cmsDelay, uint32 tstamp, MessageHandler *phandler,
                    uint32 id, MessageData* pdata);
 
+  // Moves the messages of |posted_| to the end of |msgq_|, in the order they
+  // were posted. Must be called with |crit_| held.
+  void TakePosted();
+
   // The SocketServer is not owned by MessageQueue.
   SocketServer* ss_;
   // If a server isn't supplied in the constructor, use this one.
@@ -241,11 +318,23 @@ class MessageQueue {
   bool fPeekKeep_;
   Message msgPeek_;
   MessageList msgq_;
-  PriorityQueue dmsgq_;
+  DelayedMessageQueue dmsgq_;
   uint32 dmsgq_next_num_;
   mutable CriticalSection crit_;
 
  private:
+  struct PostedMessage {
+    Message msg;
+    PostedMessage* next;
+  };
+
+  // Post() pushes onto this lock-free stack, newest first, instead of taking
+  // |crit_|. TakePosted() empties it.
+  PostedMessage* posted_;
+  // Non-zero while the thread getting messages is blocked in ss_->Wait().
+  // Post() only wakes the socket server up then.
+  int waiting_;
+
   DISALLOW_COPY_AND_ASSIGN(MessageQueue);
 };
 
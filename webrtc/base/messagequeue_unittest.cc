@@ -138,3 +138,250 @@ TEST(MessageQueueManager, Clear) {
   EXPECT_TRUE(deleted);
   EXPECT_FALSE(MessageQueueManager::IsInitialized());
 }
+
+class DummyHandler : public MessageHandler {
+ public:
+  void OnMessage(Message* msg) { }
+};
+
+static DelayedMessage MakeDelayedMessage(uint32 trigger, uint32 num,
+                                         MessageHandler* handler, uint32 id) {
+  Message msg;
+  msg.phandler = handler;
+  msg.message_id = id;
+  return DelayedMessage(0, trigger, num, msg);
+}
+
+// Checks that messages come out of the timer wheel in the same order as they
+// would from a sorted queue, for delays spanning all wheel levels and with
+// the clock wrapping around.
+TEST(DelayedMessageQueueTest, PopsInTriggerOrder) {
+  static const uint32 kStarts[] = { 0u, 12345u, 0xFFFFFF00u, 0xFFFFFFF0u };
+  static const int kDelays[] = { 0, 1, 255, 256, 257, 1000, 65535, 65536,
+                                 65537, 100000, 16777215, 16777216, 20000000 };
+  const int kNumDelays = ARRAY_SIZE(kDelays);
+  DummyHandler handler;
+  for (size_t s = 0; s < ARRAY_SIZE(kStarts); ++s) {
+    DelayedMessageQueue queue;
+    uint32 now = kStarts[s];
+    for (int i = 0; i < 3 * kNumDelays; ++i) {
+      // Post in an order unrelated to the trigger times, with duplicates.
+      int delay = kDelays[(i * 7) % kNumDelays];
+      queue.Push(now, MakeDelayedMessage(now + delay, i, &handler, i));
+    }
+    EXPECT_EQ(static_cast<size_t>(3 * kNumDelays), queue.size());
+
+    uint32 last_trigger = now;
+    while (!queue.empty()) {
+      uint32 trigger;
+      ASSERT_TRUE(queue.NextTrigger(&trigger));
+      EXPECT_GE(TimeDiff(trigger, last_trigger), 0);
+      // Nothing is due before the reported trigger time.
+      MessageList due;
+      queue.PopExpired(trigger - 1, &due);
+      EXPECT_TRUE(due.empty());
+      queue.PopExpired(trigger, &due);
+      ASSERT_FALSE(due.empty());
+      // Messages with the same trigger time come out in posting order.
+      MessageList::iterator it = due.begin();
+      uint32 last_id = it->message_id;
+      for (++it; it != due.end(); ++it) {
+        EXPECT_LT(last_id, it->message_id);
+        last_id = it->message_id;
+      }
+      last_trigger = trigger;
+    }
+    EXPECT_FALSE(queue.NextTrigger(&last_trigger));
+  }
+}
+
+TEST(DelayedMessageQueueTest, PopsLateMessagesInOrder) {
+  DelayedMessageQueue queue;
+  DummyHandler handler;
+  queue.Push(1000, MakeDelayedMessage(1000 + 70000, 0, &handler, 2));
+  queue.Push(1000, MakeDelayedMessage(1000 + 300, 1, &handler, 1));
+  queue.Push(1000, MakeDelayedMessage(1000 - 5, 2, &handler, 0));
+  queue.Push(1000, MakeDelayedMessage(1000 + 80000, 3, &handler, 3));
+
+  // Jumping far ahead pops everything due, in trigger order.
+  MessageList due;
+  queue.PopExpired(1000 + 75000, &due);
+  ASSERT_EQ(3u, due.size());
+  uint32 id = 0;
+  for (MessageList::iterator it = due.begin(); it != due.end(); ++it)
+    EXPECT_EQ(id++, it->message_id);
+  uint32 trigger;
+  ASSERT_TRUE(queue.NextTrigger(&trigger));
+  EXPECT_EQ(1000u + 80000, trigger);
+}
+
+TEST(DelayedMessageQueueTest, ClearsByHandlerAndId) {
+  DelayedMessageQueue queue;
+  DummyHandler handler1;
+  DummyHandler handler2;
+  for (uint32 i = 0; i < 10; ++i) {
+    queue.Push(0, MakeDelayedMessage(i * 1000, 2 * i, &handler1, i % 2));
+    queue.Push(0, MakeDelayedMessage(i * 1000, 2 * i + 1, &handler2, i % 2));
+  }
+
+  MessageList removed;
+  queue.Clear(&handler1, 1, &removed);
+  EXPECT_EQ(5u, removed.size());
+  for (MessageList::iterator it = removed.begin(); it != removed.end(); ++it) {
+    EXPECT_EQ(&handler1, it->phandler);
+    EXPECT_EQ(1u, it->message_id);
+  }
+  EXPECT_EQ(15u, queue.size());
+
+  removed.clear();
+  queue.Clear(&handler2, MQID_ANY, &removed);
+  EXPECT_EQ(10u, removed.size());
+  EXPECT_EQ(5u, queue.size());
+
+  MessageList due;
+  queue.PopExpired(100000, &due);
+  EXPECT_EQ(5u, due.size());
+  for (MessageList::iterator it = due.begin(); it != due.end(); ++it) {
+    EXPECT_EQ(&handler1, it->phandler);
+    EXPECT_EQ(0u, it->message_id);
+  }
+
+  queue.Push(0, MakeDelayedMessage(10, 0, &handler1, 0));
+  queue.Push(0, MakeDelayedMessage(20, 1, &handler2, 0));
+  removed.clear();
+  queue.Clear(NULL, MQID_ANY, &removed);
+  EXPECT_EQ(2u, removed.size());
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MessageQueueTest, ClearRemovesOnlyMatchingDelayedMessages) {
+  DummyHandler handler1;
+  DummyHandler handler2;
+  PostDelayed(10000, &handler1, 1);
+  PostDelayed(10000, &handler1, 2);
+  PostDelayed(10000, &handler2, 1);
+  PostDelayed(0, &handler2, 2);
+  EXPECT_EQ(4u, size());
+
+  Clear(&handler1, 1);
+  EXPECT_EQ(3u, size());
+  Clear(&handler2);
+  EXPECT_EQ(1u, size());
+  EXPECT_GT(GetDelay(), 0);
+  EXPECT_LE(GetDelay(), 10000);
+
+  Message msg;
+  EXPECT_FALSE(Get(&msg, 0));
+  Clear(NULL);
+  EXPECT_TRUE(empty());
+}
+
+namespace {
+
+class WakeUpCountingSocketServer : public NullSocketServer {
+ public:
+  WakeUpCountingSocketServer() : wake_ups_(0) {}
+  virtual void WakeUp() {
+    AtomicOps::Increment(&wake_ups_);
+    NullSocketServer::WakeUp();
+  }
+  int wake_ups() const { return AtomicOps::AcquireLoad(&wake_ups_); }
+
+ private:
+  int wake_ups_;
+};
+
+// Records the ids of the messages it gets and quits |queue| after |count|.
+class RecordingHandler : public MessageHandler {
+ public:
+  RecordingHandler(MessageQueue* queue, size_t count)
+      : queue_(queue), count_(count) {}
+  virtual void OnMessage(Message* msg) {
+    ids_.push_back(msg->message_id);
+    if (ids_.size() == count_)
+      queue_->Quit();
+  }
+  const std::vector<uint32>& ids() const { return ids_; }
+
+ private:
+  MessageQueue* queue_;
+  const size_t count_;
+  std::vector<uint32> ids_;
+};
+
+class PostingRunnable : public Runnable {
+ public:
+  PostingRunnable(Thread* target, MessageHandler* handler, uint32 first_id,
+                  int count)
+      : target_(target), handler_(handler), first_id_(first_id),
+        count_(count) {}
+  virtual void Run(Thread* thread) {
+    for (int i = 0; i < count_; ++i)
+      target_->Post(handler_, first_id_ + i);
+  }
+
+ private:
+  Thread* target_;
+  MessageHandler* handler_;
+  uint32 first_id_;
+  int count_;
+};
+
+}  // namespace
+
+TEST(MessageQueuePostTest, OnlyWakesUpWaitingQueue) {
+  WakeUpCountingSocketServer ss;
+  MessageQueue queue(&ss);
+  DummyHandler handler;
+  // Nobody is waiting for messages, so there is nobody to wake up.
+  queue.Post(&handler, 1);
+  queue.Post(&handler, 2);
+  EXPECT_EQ(0, ss.wake_ups());
+  EXPECT_EQ(2u, queue.size());
+
+  Message msg;
+  ASSERT_TRUE(queue.Get(&msg, 0));
+  EXPECT_EQ(1u, msg.message_id);
+  ASSERT_TRUE(queue.Get(&msg, 0));
+  EXPECT_EQ(2u, msg.message_id);
+  EXPECT_FALSE(queue.Get(&msg, 0));
+  EXPECT_EQ(0, ss.wake_ups());
+
+  // Delayed posts still wake up, they change how long to wait for.
+  queue.PostDelayed(10000, &handler, 3);
+  EXPECT_EQ(1, ss.wake_ups());
+  queue.Clear(NULL);
+}
+
+TEST(MessageQueuePostTest, PostsFromManyThreadsKeepPerThreadOrder) {
+  const int kThreads = 4;
+  const int kPostsPerThread = 1000;
+  Thread target;
+  RecordingHandler handler(&target, kThreads * kPostsPerThread);
+  std::vector<Thread*> posters;
+  std::vector<PostingRunnable*> runnables;
+  for (int i = 0; i < kThreads; ++i) {
+    posters.push_back(new Thread());
+    runnables.push_back(new PostingRunnable(
+        &target, &handler, i * kPostsPerThread, kPostsPerThread));
+  }
+  for (int i = 0; i < kThreads; ++i)
+    posters[i]->Start(runnables[i]);
+  // The handler quits |target| after the last message.
+  target.Run();
+  for (int i = 0; i < kThreads; ++i) {
+    posters[i]->Stop();
+    delete posters[i];
+    delete runnables[i];
+  }
+
+  ASSERT_EQ(static_cast<size_t>(kThreads * kPostsPerThread),
+            handler.ids().size());
+  std::vector<uint32> next(kThreads);
+  for (int i = 0; i < kThreads; ++i)
+    next[i] = i * kPostsPerThread;
+  for (size_t i = 0; i < handler.ids().size(); ++i) {
+    uint32 id = handler.ids()[i];
+    EXPECT_EQ(next[id / kPostsPerThread]++, id);
+  }
+}
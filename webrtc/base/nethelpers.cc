@@ -17,8 +17,10 @@
 #endif
 
 #include "webrtc/base/byteorder.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/signalthread.h"
+#include "webrtc/base/timeutils.h"
 
 namespace rtc {
 
@@ -56,6 +58,114 @@ int ResolveHostname(const std::string& hostname, int family,
 #endif  // !__native_client__
 }
 
+namespace {
+
+// How long a resolved hostname is reused for. getaddrinfo doesn't report the
+// TTL of the records, so this is kept short.
+const int kHostnameCacheTtlMs = 60 * 1000;
+
+// The most hostnames kept; past it the expired ones are dropped.
+const size_t kMaxCachedHostnames = 256;
+
+}  // namespace
+
+// One resolve call, shared by all the lookups of its hostname that start
+// while it runs or until its result expires.
+class HostnameCache::Lookup {
+ public:
+  Lookup() : resolved_(false), expires_(0), error_(0), done_(true, false) {}
+
+ private:
+  friend class HostnameCache;
+
+  bool resolved_;  // Guarded by HostnameCache::crit_.
+  uint32 expires_;  // Guarded by HostnameCache::crit_.
+  // Written once before |done_| is set.
+  int error_;
+  std::vector<IPAddress> addresses_;
+  Event done_;
+};
+
+HostnameCache::HostnameCache(ResolveFunction resolve, int ttl_ms)
+    : resolve_(resolve), ttl_ms_(ttl_ms) {
+}
+
+HostnameCache::~HostnameCache() {
+}
+
+HostnameCache* HostnameCache::Instance() {
+  LIBJINGLE_DEFINE_STATIC_LOCAL(HostnameCache, instance,
+                                (&ResolveHostname, kHostnameCacheTtlMs));
+  return &instance;
+}
+
+int HostnameCache::Resolve(const std::string& hostname, int family,
+                           std::vector<IPAddress>* addresses) {
+  if (!addresses) {
+    return -1;
+  }
+  scoped_refptr<RefCountedObject<Lookup> > lookup;
+  bool owner = false;
+  {
+    CritScope cs(&crit_);
+    LookupMap::iterator it = lookups_.find(hostname);
+    if (it != lookups_.end() && it->second->resolved_ &&
+        TimeIsLater(it->second->expires_, Time())) {
+      lookups_.erase(it);
+      it = lookups_.end();
+    }
+    if (it != lookups_.end()) {
+      lookup = it->second;
+    } else {
+      if (lookups_.size() >= kMaxCachedHostnames) {
+        RemoveExpired();
+      }
+      lookup = new RefCountedObject<Lookup>();
+      lookups_[hostname] = lookup;
+      owner = true;
+    }
+  }
+
+  if (owner) {
+    lookup->error_ = resolve_(hostname, AF_UNSPEC, &lookup->addresses_);
+    {
+      CritScope cs(&crit_);
+      lookup->resolved_ = true;
+      lookup->expires_ = TimeAfter(ttl_ms_);
+      LookupMap::iterator it = lookups_.find(hostname);
+      if (lookup->error_ != 0 && it != lookups_.end() &&
+          it->second == lookup) {
+        lookups_.erase(it);
+      }
+    }
+    lookup->done_.Set();
+  } else {
+    lookup->done_.Wait(kForever);
+  }
+
+  addresses->clear();
+  if (lookup->error_ != 0) {
+    return lookup->error_;
+  }
+  for (size_t i = 0; i < lookup->addresses_.size(); ++i) {
+    if (family == AF_UNSPEC || lookup->addresses_[i].family() == family) {
+      addresses->push_back(lookup->addresses_[i]);
+    }
+  }
+  return 0;
+}
+
+void HostnameCache::RemoveExpired() {
+  const uint32 now = Time();
+  for (LookupMap::iterator it = lookups_.begin(); it != lookups_.end();) {
+    if (it->second->resolved_ && TimeIsLater(it->second->expires_, now)) {
+      lookups_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
 // AsyncResolver
 AsyncResolver::AsyncResolver() : error_(-1) {
 }
@@ -81,8 +191,8 @@ bool AsyncResolver::GetResolvedAddress(int family, SocketAddress* addr) const {
 }
 
 void AsyncResolver::DoWork() {
-  error_ = ResolveHostname(addr_.hostname().c_str(), addr_.family(),
-                           &addresses_);
+  error_ = HostnameCache::Instance()->Resolve(addr_.hostname(), addr_.family(),
+                                              &addresses_);
 }
 
 void AsyncResolver::OnWorkDone() {
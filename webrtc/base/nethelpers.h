@@ -19,8 +19,14 @@
 #endif
 
 #include <list>
+#include <map>
+#include <string>
 
 #include "webrtc/base/asyncresolverinterface.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/signalthread.h"
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/socketaddress.h"
@@ -31,6 +37,9 @@ class AsyncResolverTest;
 
 // AsyncResolver will perform async DNS resolution, signaling the result on
 // the SignalDone from AsyncResolverInterface when the operation completes.
+// Results are shared process-wide for a minute, and the resolvers started
+// for a hostname while it is being looked up wait for that lookup instead of
+// starting their own.
 class AsyncResolver : public SignalThread, public AsyncResolverInterface {
  public:
   AsyncResolver();
@@ -54,6 +63,43 @@ class AsyncResolver : public SignalThread, public AsyncResolverInterface {
   int error_;
 };
 
+// A cache of resolved hostnames, shared by the lookups of a hostname that
+// start while it is being resolved or until its result expires. Failures
+// aren't cached, so a hostname that failed to resolve is retried by the next
+// lookup.
+class HostnameCache {
+ public:
+  // Resolves |hostname| to the addresses of |family|, or of any family if
+  // |family| is AF_UNSPEC. Returns 0 on success or the resolver's error.
+  typedef int (*ResolveFunction)(const std::string& hostname, int family,
+                                 std::vector<IPAddress>* addresses);
+
+  HostnameCache(ResolveFunction resolve, int ttl_ms);
+  ~HostnameCache();
+
+  // The cache used by AsyncResolver, which resolves with getaddrinfo.
+  static HostnameCache* Instance();
+
+  // Same as ResolveFunction. Blocks until the hostname is resolved unless it
+  // is cached.
+  int Resolve(const std::string& hostname, int family,
+              std::vector<IPAddress>* addresses);
+
+ private:
+  class Lookup;
+  typedef std::map<std::string, scoped_refptr<RefCountedObject<Lookup> > >
+      LookupMap;
+
+  void RemoveExpired();
+
+  const ResolveFunction resolve_;
+  const int ttl_ms_;
+  CriticalSection crit_;
+  LookupMap lookups_;
+
+  DISALLOW_COPY_AND_ASSIGN(HostnameCache);
+};
+
 // rtc namespaced wrappers for inet_ntop and inet_pton so we can avoid
 // the windows-native versions of these.
 const char* inet_ntop(int af, const void *src, char* dst, socklen_t size);
@@ -0,0 +1,158 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/nethelpers.h"
+#include "webrtc/base/thread.h"
+
+namespace rtc {
+
+namespace {
+
+const char kHostname[] = "stun.example.org";
+const int kLongTtlMs = 60 * 1000;
+const int kWaitMs = 1000;
+
+// The state of FakeResolve, reset by each test.
+CriticalSection g_crit;
+int g_num_resolves = 0;
+int g_error = 0;
+Event* g_entered = NULL;
+Event* g_release = NULL;
+
+int NumResolves() {
+  CritScope cs(&g_crit);
+  return g_num_resolves;
+}
+
+// Resolves every hostname to an IPv4 and an IPv6 loopback address, or fails
+// with |g_error|. Waits for |g_release| if it is set.
+int FakeResolve(const std::string& hostname, int family,
+                std::vector<IPAddress>* addresses) {
+  {
+    CritScope cs(&g_crit);
+    ++g_num_resolves;
+  }
+  if (g_release) {
+    g_entered->Set();
+    g_release->Wait(kWaitMs);
+  }
+  if (g_error != 0) {
+    return g_error;
+  }
+  addresses->push_back(IPAddress(INADDR_LOOPBACK));
+  addresses->push_back(IPAddress(in6addr_loopback));
+  return 0;
+}
+
+class ResolveThread : public Thread {
+ public:
+  explicit ResolveThread(HostnameCache* cache) : cache_(cache), error_(-1) {}
+  virtual ~ResolveThread() { Stop(); }
+
+  int error() const { return error_; }
+  const std::vector<IPAddress>& addresses() const { return addresses_; }
+
+ private:
+  virtual void Run() {
+    error_ = cache_->Resolve(kHostname, AF_UNSPEC, &addresses_);
+  }
+
+  HostnameCache* const cache_;
+  int error_;
+  std::vector<IPAddress> addresses_;
+};
+
+}  // namespace
+
+class HostnameCacheTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    g_num_resolves = 0;
+    g_error = 0;
+    g_entered = NULL;
+    g_release = NULL;
+  }
+
+  virtual void TearDown() {
+    g_entered = NULL;
+    g_release = NULL;
+  }
+};
+
+TEST_F(HostnameCacheTest, ReturnsAddressesOfFamily) {
+  HostnameCache cache(&FakeResolve, kLongTtlMs);
+  std::vector<IPAddress> addresses;
+  EXPECT_EQ(0, cache.Resolve(kHostname, AF_INET, &addresses));
+  ASSERT_EQ(1u, addresses.size());
+  EXPECT_EQ(IPAddress(INADDR_LOOPBACK), addresses[0]);
+  EXPECT_EQ(0, cache.Resolve(kHostname, AF_UNSPEC, &addresses));
+  EXPECT_EQ(2u, addresses.size());
+}
+
+TEST_F(HostnameCacheTest, ReusesResultUntilItExpires) {
+  HostnameCache cache(&FakeResolve, kLongTtlMs);
+  std::vector<IPAddress> addresses;
+  EXPECT_EQ(0, cache.Resolve(kHostname, AF_INET, &addresses));
+  EXPECT_EQ(0, cache.Resolve(kHostname, AF_INET, &addresses));
+  EXPECT_EQ(1, NumResolves());
+  EXPECT_EQ(1u, addresses.size());
+
+  HostnameCache short_cache(&FakeResolve, 1);
+  EXPECT_EQ(0, short_cache.Resolve(kHostname, AF_INET, &addresses));
+  Thread::SleepMs(10);
+  EXPECT_EQ(0, short_cache.Resolve(kHostname, AF_INET, &addresses));
+  EXPECT_EQ(3, NumResolves());
+  EXPECT_EQ(1u, addresses.size());
+}
+
+TEST_F(HostnameCacheTest, DoesNotCacheFailures) {
+  HostnameCache cache(&FakeResolve, kLongTtlMs);
+  std::vector<IPAddress> addresses;
+  g_error = EAI_NONAME;
+  EXPECT_EQ(EAI_NONAME, cache.Resolve(kHostname, AF_INET, &addresses));
+  EXPECT_TRUE(addresses.empty());
+  g_error = 0;
+  EXPECT_EQ(0, cache.Resolve(kHostname, AF_INET, &addresses));
+  EXPECT_EQ(2, NumResolves());
+  EXPECT_EQ(1u, addresses.size());
+}
+
+TEST_F(HostnameCacheTest, CoalescesConcurrentLookups) {
+  HostnameCache cache(&FakeResolve, kLongTtlMs);
+  Event entered(false, false);
+  Event release(true, false);
+  g_entered = &entered;
+  g_release = &release;
+
+  ResolveThread first(&cache);
+  ResolveThread second(&cache);
+  first.Start();
+  ASSERT_TRUE(entered.Wait(kWaitMs));
+  // The second lookup starts while the first one is still resolving.
+  second.Start();
+  Thread::SleepMs(50);
+  release.Set();
+  first.Stop();
+  second.Stop();
+
+  EXPECT_EQ(1, NumResolves());
+  EXPECT_EQ(0, first.error());
+  EXPECT_EQ(0, second.error());
+  EXPECT_EQ(2u, first.addresses().size());
+  EXPECT_EQ(2u, second.addresses().size());
+}
+
+}  // namespace rtc
@@ -48,6 +48,7 @@
 #include <algorithm>
 
 #include "webrtc/base/logging.h"
+#include "webrtc/base/networkmonitor.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/socket.h"  // includes something that makes windows happy
 #include "webrtc/base/stream.h"
@@ -60,7 +61,8 @@ namespace {
 const uint32 kUpdateNetworksMessage = 1;
 const uint32 kSignalNetworksMessage = 2;
 
-// Fetch list of networks every two seconds.
+// Fetch list of networks every two seconds, unless NetworkMonitor tells us
+// about the changes.
 const int kNetworksUpdateIntervalMs = 2000;
 
 const int kHighestNetworkPreference = 127;
@@ -227,10 +229,12 @@ void NetworkManagerBase::MergeNetworkList(const NetworkList& new_networks,
 
 BasicNetworkManager::BasicNetworkManager()
     : thread_(NULL), sent_first_update_(false), start_count_(0),
-      ignore_non_default_routes_(false) {
+      ignore_non_default_routes_(false), monitored_(false) {
 }
 
 BasicNetworkManager::~BasicNetworkManager() {
+  if (monitored_)
+    NetworkMonitor::RemoveListener(this);
 }
 
 #if defined(__native_client__)
@@ -534,6 +538,8 @@ void BasicNetworkManager::StartUpdating() {
     if (sent_first_update_)
       thread_->Post(this, kSignalNetworksMessage);
   } else {
+    monitored_ = NetworkMonitor::AddListener(thread_, this,
+                                             kUpdateNetworksMessage);
     thread_->Post(this, kUpdateNetworksMessage);
   }
   ++start_count_;
@@ -546,6 +552,10 @@ void BasicNetworkManager::StopUpdating() {
 
   --start_count_;
   if (!start_count_) {
+    if (monitored_) {
+      NetworkMonitor::RemoveListener(this);
+      monitored_ = false;
+    }
     thread_->Clear(this);
     sent_first_update_ = false;
   }
@@ -584,7 +594,10 @@ void BasicNetworkManager::DoUpdateNetworks() {
     }
   }
 
-  thread_->PostDelayed(kNetworksUpdateIntervalMs, this, kUpdateNetworksMessage);
+  if (!monitored_) {
+    thread_->PostDelayed(kNetworksUpdateIntervalMs, this,
+                         kUpdateNetworksMessage);
+  }
 }
 
 void BasicNetworkManager::DumpNetworks(bool include_ignored) {
@@ -160,6 +160,8 @@ class BasicNetworkManager : public NetworkManagerBase,
   int start_count_;
   std::vector<std::string> network_ignore_list_;
   bool ignore_non_default_routes_;
+  // Whether NetworkMonitor reports the changes, so that there is no polling.
+  bool monitored_;
 };
 
 // Represents a Unix-type network interface, with a name and single address.
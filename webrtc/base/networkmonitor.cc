@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/networkmonitor.h"
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "webrtc/base/asyncfile.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/thread.h"
+
+namespace rtc {
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+
+// Reads the route netlink messages about links and addresses on a thread of
+// its own.
+class NetworkMonitor::Watcher : public sigslot::has_slots<> {
+ public:
+  explicit Watcher(NetworkMonitor* monitor)
+      : monitor_(monitor), thread_(&ss_), fd_(-1) {
+  }
+
+  ~Watcher() {
+    thread_.Stop();
+    file_.reset();
+    if (fd_ >= 0)
+      close(fd_);
+  }
+
+  bool Start() {
+    fd_ = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+    if (fd_ < 0) {
+      LOG_ERR(LS_WARNING) << "socket(AF_NETLINK)";
+      return false;
+    }
+    sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+      LOG_ERR(LS_WARNING) << "bind(AF_NETLINK)";
+      return false;
+    }
+    file_.reset(ss_.CreateFile(fd_));
+    file_->SignalReadEvent.connect(this, &Watcher::OnReadEvent);
+    thread_.SetName("NetworkMonitor", this);
+    return thread_.Start();
+  }
+
+ private:
+  void OnReadEvent(AsyncFile* file) {
+    // A change arrives as a burst of messages. Their content doesn't matter,
+    // since the listeners enumerate the interfaces again anyway.
+    char buf[4096];
+    bool changed = false;
+    while (true) {
+      ssize_t len = recv(fd_, buf, sizeof(buf), MSG_DONTWAIT);
+      if (len > 0 || (len < 0 && errno == ENOBUFS)) {
+        // ENOBUFS means that messages were lost; that's a change too.
+        changed = true;
+      } else {
+        break;
+      }
+    }
+    if (changed)
+      monitor_->OnNetworksChanged();
+  }
+
+  NetworkMonitor* const monitor_;
+  PhysicalSocketServer ss_;
+  Thread thread_;
+  scoped_ptr<AsyncFile> file_;
+  int fd_;
+};
+
+#else  // WEBRTC_LINUX && !WEBRTC_ANDROID
+
+class NetworkMonitor::Watcher {
+ public:
+  explicit Watcher(NetworkMonitor* monitor) {}
+  bool Start() { return false; }
+};
+
+#endif  // WEBRTC_LINUX && !WEBRTC_ANDROID
+
+// Protects the creation of the instance, which is never deleted.
+static CriticalSection instance_crit;
+
+NetworkMonitor* NetworkMonitor::Instance() {
+  static NetworkMonitor* instance = NULL;
+  CritScope cs(&instance_crit);
+  if (!instance)
+    instance = new NetworkMonitor();
+  return instance;
+}
+
+bool NetworkMonitor::AddListener(Thread* thread, MessageHandler* handler,
+                                 uint32 message_id) {
+  return Instance()->AddListenerInternal(thread, handler, message_id);
+}
+
+void NetworkMonitor::RemoveListener(MessageHandler* handler) {
+  Instance()->RemoveListenerInternal(handler);
+}
+
+NetworkMonitor::NetworkMonitor() {
+}
+
+NetworkMonitor::~NetworkMonitor() {
+}
+
+bool NetworkMonitor::AddListenerInternal(Thread* thread,
+                                         MessageHandler* handler,
+                                         uint32 message_id) {
+  CritScope cs(&crit_);
+  if (!watcher_) {
+    scoped_ptr<Watcher> watcher(new Watcher(this));
+    if (!watcher->Start())
+      return false;
+    watcher_.reset(watcher.release());
+  }
+  Listener listener = { thread, handler, message_id };
+  listeners_.push_back(listener);
+  return true;
+}
+
+void NetworkMonitor::RemoveListenerInternal(MessageHandler* handler) {
+  scoped_ptr<Watcher> stopped_watcher;
+  {
+    CritScope cs(&crit_);
+    for (size_t i = 0; i < listeners_.size(); ++i) {
+      if (listeners_[i].handler == handler) {
+        listeners_.erase(listeners_.begin() + i);
+        break;
+      }
+    }
+    if (listeners_.empty())
+      stopped_watcher.reset(watcher_.release());
+  }
+  // Stopped without |crit_|, which the watcher thread may be waiting for in
+  // OnNetworksChanged().
+}
+
+void NetworkMonitor::OnNetworksChanged() {
+  CritScope cs(&crit_);
+  for (size_t i = 0; i < listeners_.size(); ++i) {
+    listeners_[i].thread->Post(listeners_[i].handler,
+                               listeners_[i].message_id);
+  }
+}
+
+}  // namespace rtc
@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_NETWORKMONITOR_H_
+#define WEBRTC_BASE_NETWORKMONITOR_H_
+
+#include <vector>
+
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/scoped_ptr.h"
+
+namespace rtc {
+
+class MessageHandler;
+class Thread;
+
+// Watches the network interfaces of the machine and posts a message to the
+// registered handlers whenever they may have changed, so that the network
+// managers don't have to poll them. One monitor serves the whole process and
+// runs on a thread of its own while it has listeners. Linux is watched with
+// netlink; other platforms have no monitor.
+class NetworkMonitor {
+ public:
+  // Posts |message_id| to |handler| on |thread| on every change, starting the
+  // monitor if needed. Returns false if changes can't be watched on this
+  // machine, in which case the caller has to keep polling.
+  static bool AddListener(Thread* thread, MessageHandler* handler,
+                          uint32 message_id);
+  // Stops posting to |handler| and stops the monitor with the last listener.
+  // Messages posted already are left in the queue of the thread.
+  static void RemoveListener(MessageHandler* handler);
+
+ private:
+  class Watcher;
+
+  struct Listener {
+    Thread* thread;
+    MessageHandler* handler;
+    uint32 message_id;
+  };
+
+  static NetworkMonitor* Instance();
+
+  NetworkMonitor();
+  ~NetworkMonitor();
+
+  bool AddListenerInternal(Thread* thread, MessageHandler* handler,
+                           uint32 message_id);
+  void RemoveListenerInternal(MessageHandler* handler);
+  // Called by |watcher_| on its thread.
+  void OnNetworksChanged();
+
+  CriticalSection crit_;
+  std::vector<Listener> listeners_;
+  scoped_ptr<Watcher> watcher_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetworkMonitor);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_NETWORKMONITOR_H_
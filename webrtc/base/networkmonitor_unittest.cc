@@ -0,0 +1,36 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/messagehandler.h"
+#include "webrtc/base/networkmonitor.h"
+#include "webrtc/base/thread.h"
+
+namespace rtc {
+
+class NullHandler : public MessageHandler {
+ public:
+  virtual void OnMessage(Message* msg) {}
+};
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// The monitor stops with its last listener and starts again for the next.
+TEST(NetworkMonitorTest, StartsWithFirstListener) {
+  NullHandler handler1, handler2;
+  EXPECT_TRUE(NetworkMonitor::AddListener(Thread::Current(), &handler1, 1));
+  EXPECT_TRUE(NetworkMonitor::AddListener(Thread::Current(), &handler2, 1));
+  NetworkMonitor::RemoveListener(&handler1);
+  NetworkMonitor::RemoveListener(&handler2);
+  EXPECT_TRUE(NetworkMonitor::AddListener(Thread::Current(), &handler1, 1));
+  NetworkMonitor::RemoveListener(&handler1);
+}
+#endif
+
+}  // namespace rtc
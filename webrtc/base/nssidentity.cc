@@ -436,7 +436,12 @@ NSSIdentity* NSSIdentity::GenerateInternal(const SSLIdentityParams& params) {
   return identity;
 }
 
-NSSIdentity* NSSIdentity::Generate(const std::string &common_name) {
+NSSIdentity* NSSIdentity::Generate(const std::string &common_name,
+                                   KeyType key_type) {
+  if (key_type != KT_RSA) {
+    LOG(LS_ERROR) << "Only RSA identities are supported with NSS";
+    return NULL;
+  }
   SSLIdentityParams params;
   params.common_name = common_name;
   params.not_before = CERTIFICATE_WINDOW;
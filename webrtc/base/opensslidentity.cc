@@ -21,6 +21,8 @@
 #include <openssl/bn.h>
 #include <openssl/rsa.h>
 #include <openssl/crypto.h>
+#include <openssl/ec.h>
+#include <openssl/objects.h>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/helpers.h"
@@ -33,7 +35,7 @@ namespace rtc {
 // We could have exposed a myriad of parameters for the crypto stuff,
 // but keeping it simple seems best.
 
-// Strength of generated keys. Those are RSA.
+// Strength of generated RSA keys.
 static const int KEY_LENGTH = 1024;
 
 // Random bits for certificate serial number
@@ -46,8 +48,29 @@ static const int CERTIFICATE_LIFETIME = 60*60*24*30;  // 30 days, arbitrarily
 static const int CERTIFICATE_WINDOW = -60*60*24;
 
 // Generate a key pair. Caller is responsible for freeing the returned object.
-static EVP_PKEY* MakeKey() {
+static EVP_PKEY* MakeKey(KeyType key_type) {
   LOG(LS_INFO) << "Making key pair";
+  if (key_type == KT_ECDSA) {
+    EVP_PKEY* pkey = EVP_PKEY_new();
+    EC_KEY* ec_key = EC_KEY_new_by_curve_name(NID_X9_62_prime256v1);
+    if (!pkey || !ec_key) {
+      EVP_PKEY_free(pkey);
+      EC_KEY_free(ec_key);
+      return NULL;
+    }
+    // Refer to the curve by name in the certificate, not by its parameters.
+    EC_KEY_set_asn1_flag(ec_key, OPENSSL_EC_NAMED_CURVE);
+    if (!EC_KEY_generate_key(ec_key) ||
+        !EVP_PKEY_assign_EC_KEY(pkey, ec_key)) {
+      EVP_PKEY_free(pkey);
+      EC_KEY_free(ec_key);
+      return NULL;
+    }
+    // ownership of ec_key struct was assigned, don't free it.
+    LOG(LS_INFO) << "Returning key pair";
+    return pkey;
+  }
+
   EVP_PKEY* pkey = EVP_PKEY_new();
   // RSA_generate_key is deprecated. Use _ex version.
   BIGNUM* exponent = BN_new();
@@ -112,7 +135,10 @@ static X509* MakeCertificate(EVP_PKEY* pkey, const SSLIdentityParams& params) {
       !X509_gmtime_adj(X509_get_notAfter(x509), params.not_after))
     goto error;
 
-  if (!X509_sign(x509, pkey, EVP_sha1()))
+  // ECDSA certificates are new enough that every peer taking them also
+  // takes SHA-256 signatures.
+  if (!X509_sign(x509, pkey,
+                 EVP_PKEY_id(pkey) == EVP_PKEY_EC ? EVP_sha256() : EVP_sha1()))
     goto error;
 
   BN_free(serial_number);
@@ -138,8 +164,8 @@ static void LogSSLErrors(const std::string& prefix) {
   }
 }
 
-OpenSSLKeyPair* OpenSSLKeyPair::Generate() {
-  EVP_PKEY* pkey = MakeKey();
+OpenSSLKeyPair* OpenSSLKeyPair::Generate(KeyType key_type) {
+  EVP_PKEY* pkey = MakeKey(key_type);
   if (!pkey) {
     LogSSLErrors("Generating key pair");
     return NULL;
@@ -214,8 +240,20 @@ OpenSSLCertificate* OpenSSLCertificate::FromPEMString(
 // and before CleanupSSL.
 bool OpenSSLCertificate::GetSignatureDigestAlgorithm(
     std::string* algorithm) const {
-  return OpenSSLDigest::GetDigestName(
-      EVP_get_digestbyobj(x509_->sig_alg->algorithm), algorithm);
+  // EVP_get_digestbyobj() only knows the RSA signature algorithms, look the
+  // digest of e.g. ecdsa-with-SHA256 up from the signature algorithm instead.
+  int digest_nid;
+  if (!OBJ_find_sigid_algs(OBJ_obj2nid(x509_->sig_alg->algorithm),
+                           &digest_nid, NULL)) {
+    algorithm->clear();
+    return false;
+  }
+  const EVP_MD* md = EVP_get_digestbynid(digest_nid);
+  if (!md) {
+    algorithm->clear();
+    return false;
+  }
+  return OpenSSLDigest::GetDigestName(md, algorithm);
 }
 
 bool OpenSSLCertificate::ComputeDigest(const std::string& algorithm,
@@ -296,8 +334,8 @@ void OpenSSLCertificate::AddReference() const {
 }
 
 OpenSSLIdentity* OpenSSLIdentity::GenerateInternal(
-    const SSLIdentityParams& params) {
-  OpenSSLKeyPair *key_pair = OpenSSLKeyPair::Generate();
+    const SSLIdentityParams& params, KeyType key_type) {
+  OpenSSLKeyPair *key_pair = OpenSSLKeyPair::Generate(key_type);
   if (key_pair) {
     OpenSSLCertificate *certificate = OpenSSLCertificate::Generate(
         key_pair, params);
@@ -309,17 +347,18 @@ OpenSSLIdentity* OpenSSLIdentity::GenerateInternal(
   return NULL;
 }
 
-OpenSSLIdentity* OpenSSLIdentity::Generate(const std::string& common_name) {
+OpenSSLIdentity* OpenSSLIdentity::Generate(const std::string& common_name,
+                                           KeyType key_type) {
   SSLIdentityParams params;
   params.common_name = common_name;
   params.not_before = CERTIFICATE_WINDOW;
   params.not_after = CERTIFICATE_LIFETIME;
-  return GenerateInternal(params);
+  return GenerateInternal(params, key_type);
 }
 
 OpenSSLIdentity* OpenSSLIdentity::GenerateForTest(
     const SSLIdentityParams& params) {
-  return GenerateInternal(params);
+  return GenerateInternal(params, KT_DEFAULT);
 }
 
 SSLIdentity* OpenSSLIdentity::FromPEMStrings(
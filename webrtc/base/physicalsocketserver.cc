@@ -24,6 +24,17 @@
 #include <signal.h>
 #endif
 
+#if defined(WEBRTC_LINUX)
+#include <netinet/udp.h>
+#include <sys/epoll.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103  // Until this is in netinet/udp.h of all toolchains.
+#endif
+#elif defined(WEBRTC_MAC)
+#include <sys/types.h>
+#include <sys/event.h>
+#endif
+
 #if defined(WEBRTC_WIN)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -92,6 +103,15 @@ static const int ICMP_HEADER_SIZE = 8u;
 static const int ICMP_PING_TIMEOUT_MILLIS = 10000u;
 #endif
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// Maximum number of datagrams passed to one recvmmsg()/sendmmsg() call.
+static const size_t kMaxDatagramBatch = 64;
+// Maximum number of segments and payload bytes of one UDP_SEGMENT send. The
+// kernel takes up to 64 segments and a payload that fits an IPv6 datagram.
+static const size_t kMaxSegments = 64;
+static const size_t kMaxSegmentedSize = 0xffff - 40 - 8;
+#endif
+
 class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
  public:
   PhysicalSocket(PhysicalSocketServer* ss, SOCKET s = INVALID_SOCKET)
@@ -105,6 +125,9 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     // users can link it with a different version of this function by replacing
     // win32socketinit.cc. See win32socketinit.cc for more details.
     EnsureWinsockInit();
+#endif
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+    gso_enabled_ = true;
 #endif
     if (s_ != INVALID_SOCKET) {
       enabled_events_ = DE_READ | DE_WRITE;
@@ -127,7 +150,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     udp_ = (SOCK_DGRAM == type);
     UpdateLastError();
     if (udp_)
-      enabled_events_ = DE_READ | DE_WRITE;
+      SetEnabledEvents(DE_READ | DE_WRITE);
     return s_ != INVALID_SOCKET;
   }
 
@@ -209,12 +232,12 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
       state_ = CS_CONNECTED;
     } else if (IsBlockingError(GetError())) {
       state_ = CS_CONNECTING;
-      enabled_events_ |= DE_CONNECT;
+      EnableEvents(DE_CONNECT);
     } else {
       return SOCKET_ERROR;
     }
 
-    enabled_events_ |= DE_READ | DE_WRITE;
+    EnableEvents(DE_READ | DE_WRITE);
     return 0;
   }
 
@@ -278,7 +301,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     // We have seen minidumps where this may be false.
     ASSERT(sent <= static_cast<int>(cb));
     if ((sent < 0) && IsBlockingError(GetError())) {
-      enabled_events_ |= DE_WRITE;
+      EnableEvents(DE_WRITE);
     }
     return sent;
   }
@@ -300,7 +323,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     // We have seen minidumps where this may be false.
     ASSERT(sent <= static_cast<int>(length));
     if ((sent < 0) && IsBlockingError(GetError())) {
-      enabled_events_ |= DE_WRITE;
+      EnableEvents(DE_WRITE);
     }
     return sent;
   }
@@ -315,7 +338,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
       LOG(LS_WARNING) << "EOF from socket; deferring close event";
       // Must turn this back on so that the select() loop will notice the close
       // event.
-      enabled_events_ |= DE_READ;
+      EnableEvents(DE_READ);
       SetError(EWOULDBLOCK);
       return SOCKET_ERROR;
     }
@@ -323,7 +346,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     int error = GetError();
     bool success = (received >= 0) || IsBlockingError(error);
     if (udp_ || success) {
-      enabled_events_ |= DE_READ;
+      EnableEvents(DE_READ);
     }
     if (!success) {
       LOG_F(LS_VERBOSE) << "Error = " << error;
@@ -343,7 +366,44 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     int error = GetError();
     bool success = (received >= 0) || IsBlockingError(error);
     if (udp_ || success) {
-      enabled_events_ |= DE_READ;
+      EnableEvents(DE_READ);
+    }
+    if (!success) {
+      LOG_F(LS_VERBOSE) << "Error = " << error;
+    }
+    return received;
+  }
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  // Uses recvmmsg(), so that a burst of datagrams queued on the socket is
+  // drained with one system call.
+  virtual int RecvFromBatch(SocketDatagram* datagrams, size_t count) {
+    if (count > kMaxDatagramBatch)
+      count = kMaxDatagramBatch;
+    sockaddr_storage addrs[kMaxDatagramBatch];
+    iovec iovs[kMaxDatagramBatch];
+    mmsghdr msgs[kMaxDatagramBatch];
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+    for (size_t i = 0; i < count; ++i) {
+      iovs[i].iov_base = datagrams[i].data;
+      iovs[i].iov_len = datagrams[i].capacity;
+      msgs[i].msg_hdr.msg_name = &addrs[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int received = ::recvmmsg(s_, msgs, static_cast<unsigned int>(count), 0,
+                              NULL);
+    UpdateLastError();
+    for (int i = 0; i < received; ++i) {
+      datagrams[i].size = msgs[i].msg_len;
+      datagrams[i].truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+      SocketAddressFromSockAddrStorage(addrs[i], &datagrams[i].addr);
+    }
+    int error = GetError();
+    bool success = (received >= 0) || IsBlockingError(error);
+    if (udp_ || success) {
+      EnableEvents(DE_READ);
     }
     if (!success) {
       LOG_F(LS_VERBOSE) << "Error = " << error;
@@ -351,12 +411,48 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     return received;
   }
 
+  // Sends runs of equal-size datagrams to the same destination as one
+  // UDP_SEGMENT send where the kernel supports it and the rest with
+  // sendmmsg(), so that a burst of datagrams costs one system call.
+  virtual int SendToBatch(const SocketDatagram* datagrams, size_t count) {
+    int total = 0;
+    while (count > 0) {
+      size_t batch = SegmentableRun(datagrams, count);
+      int sent;
+      if (batch > 1) {
+        sent = SendSegmented(datagrams, batch);
+        if (sent < 0 && !gso_enabled_)
+          continue;  // Resend the run without segmentation offload.
+      } else {
+        batch = 1;
+        while (batch < count && batch < kMaxDatagramBatch &&
+               SegmentableRun(datagrams + batch, count - batch) < 2) {
+          ++batch;
+        }
+        sent = SendMultiple(datagrams, batch);
+      }
+      if (sent < 0)
+        return (total == 0) ? sent : total;
+      total += sent;
+      if (static_cast<size_t>(sent) < batch) {
+        // The kernel stops at the first datagram it can't send, typically
+        // because the send buffer is full.
+        EnableEvents(DE_WRITE);
+        break;
+      }
+      datagrams += batch;
+      count -= batch;
+    }
+    return total;
+  }
+#endif  // WEBRTC_LINUX && !WEBRTC_ANDROID
+
   int Listen(int backlog) {
     int err = ::listen(s_, backlog);
     UpdateLastError();
     if (err == 0) {
       state_ = CS_CONNECTING;
-      enabled_events_ |= DE_ACCEPT;
+      EnableEvents(DE_ACCEPT);
 #ifdef _DEBUG
       dbg_addr_ = "Listening @ ";
       dbg_addr_.append(GetLocalAddress().ToString());
@@ -373,7 +469,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     UpdateLastError();
     if (s == INVALID_SOCKET)
       return NULL;
-    enabled_events_ |= DE_ACCEPT;
+    EnableEvents(DE_ACCEPT);
     if (out_addr != NULL)
       SocketAddressFromSockAddrStorage(addr_storage, out_addr);
     return ss_->WrapSocket(s);
@@ -386,7 +482,7 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     UpdateLastError();
     s_ = INVALID_SOCKET;
     state_ = CS_CLOSED;
-    enabled_events_ = 0;
+    SetEnabledEvents(0);
     if (resolver_) {
       resolver_->Destroy(false);
       resolver_ = NULL;
@@ -483,6 +579,20 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     SetError(LAST_SYSTEM_ERROR);
   }
 
+  // All changes to |enabled_events_| after construction go through here, so
+  // that dispatchers can tell the socket server about them.
+  virtual void SetEnabledEvents(uint8 events) {
+    enabled_events_ = events;
+  }
+
+  void EnableEvents(uint8 events) {
+    SetEnabledEvents(enabled_events_ | events);
+  }
+
+  void DisableEvents(uint8 events) {
+    SetEnabledEvents(enabled_events_ & ~events);
+  }
+
   void MaybeRemapSendError() {
 #if defined(WEBRTC_MAC)
     // https://developer.apple.com/library/mac/documentation/Darwin/
@@ -526,6 +636,15 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
       case OPT_DSCP:
         LOG(LS_WARNING) << "Socket::OPT_DSCP not supported.";
         return -1;
+      case OPT_REUSEPORT:
+#if defined(SO_REUSEPORT)
+        *slevel = SOL_SOCKET;
+        *sopt = SO_REUSEPORT;
+        break;
+#else
+        LOG(LS_WARNING) << "Socket::OPT_REUSEPORT not supported.";
+        return -1;
+#endif
       case OPT_RTP_SENDTIME_EXTN_ID:
         return -1;  // No logging is necessary as this not a OS socket option.
       default:
@@ -535,6 +654,106 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
     return 0;
   }
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  // Returns the number of leading datagrams the kernel can send as one
+  // segmented datagram: all go to the same destination and have the size of
+  // the first one, except for the last, which may be shorter. Returns 0 when
+  // segmentation offload is not available.
+  size_t SegmentableRun(const SocketDatagram* datagrams, size_t count) const {
+    if (!udp_ || !gso_enabled_ || count == 0 || datagrams[0].size == 0)
+      return 0;
+    const size_t segment_size = datagrams[0].size;
+    size_t run = 1;
+    size_t bytes = segment_size;
+    while (run < count && run < kMaxSegments &&
+           bytes + datagrams[run].size <= kMaxSegmentedSize &&
+           datagrams[run].size != 0 &&
+           datagrams[run].size <= segment_size &&
+           datagrams[run].addr.EqualIPs(datagrams[0].addr) &&
+           datagrams[run].addr.EqualPorts(datagrams[0].addr)) {
+      bytes += datagrams[run].size;
+      if (datagrams[run++].size < segment_size)
+        break;
+    }
+    return run;
+  }
+
+  // Sends |count| datagrams from SegmentableRun() with one sendmsg(). The
+  // kernel sends all of them or none. Turns segmentation offload off for the
+  // socket if the kernel or the device doesn't support it.
+  int SendSegmented(const SocketDatagram* datagrams, size_t count) {
+    sockaddr_storage addr;
+    iovec iovs[kMaxSegments];
+    for (size_t i = 0; i < count; ++i) {
+      iovs[i].iov_base = datagrams[i].data;
+      iovs[i].iov_len = datagrams[i].size;
+    }
+    char control[CMSG_SPACE(sizeof(uint16))];
+    memset(control, 0, sizeof(control));
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addr;
+    msg.msg_namelen =
+        static_cast<socklen_t>(datagrams[0].addr.ToSockAddrStorage(&addr));
+    msg.msg_iov = iovs;
+    msg.msg_iovlen = count;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16));
+    uint16 segment_size = static_cast<uint16>(datagrams[0].size);
+    memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+    // Suppress SIGPIPE. See Send() for explanation.
+    int sent = ::sendmsg(s_, &msg, MSG_NOSIGNAL);
+    UpdateLastError();
+    if (sent < 0) {
+      int error = GetError();
+      // EIO comes from devices without checksum offload, the others from
+      // kernels without UDP_SEGMENT.
+      if (error == EIO || error == EINVAL || error == ENOPROTOOPT ||
+          error == EOPNOTSUPP) {
+        LOG(LS_INFO) << "UDP segmentation offload unavailable, error = "
+                     << error;
+        gso_enabled_ = false;
+        return -1;
+      }
+      MaybeRemapSendError();
+      if (IsBlockingError(GetError()))
+        EnableEvents(DE_WRITE);
+      return -1;
+    }
+    return static_cast<int>(count);
+  }
+
+  // Sends |count| datagrams, at most kMaxDatagramBatch, with one sendmmsg().
+  // Returns the number of datagrams sent or -1 if none could be sent.
+  int SendMultiple(const SocketDatagram* datagrams, size_t count) {
+    sockaddr_storage addrs[kMaxDatagramBatch];
+    iovec iovs[kMaxDatagramBatch];
+    mmsghdr msgs[kMaxDatagramBatch];
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+    for (size_t i = 0; i < count; ++i) {
+      iovs[i].iov_base = datagrams[i].data;
+      iovs[i].iov_len = datagrams[i].size;
+      msgs[i].msg_hdr.msg_name = &addrs[i];
+      msgs[i].msg_hdr.msg_namelen = static_cast<socklen_t>(
+          datagrams[i].addr.ToSockAddrStorage(&addrs[i]));
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    // Suppress SIGPIPE. See Send() for explanation.
+    int sent = ::sendmmsg(s_, msgs, static_cast<unsigned int>(count),
+                          MSG_NOSIGNAL);
+    UpdateLastError();
+    MaybeRemapSendError();
+    if (sent < 0 && IsBlockingError(GetError()))
+      EnableEvents(DE_WRITE);
+    return sent;
+  }
+#endif  // WEBRTC_LINUX && !WEBRTC_ANDROID
+
   PhysicalSocketServer* ss_;
   SOCKET s_;
   uint8 enabled_events_;
@@ -544,6 +763,10 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   mutable CriticalSection crit_;
   ConnState state_;
   AsyncResolver* resolver_;
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  // Cleared once a segmented send failed for lack of support.
+  bool gso_enabled_;
+#endif
 
 #ifdef _DEBUG
   std::string dbg_addr_;
@@ -881,24 +1104,24 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
     // Make sure we deliver connect/accept first. Otherwise, consumers may see
     // something like a READ followed by a CONNECT, which would be odd.
     if ((ff & DE_CONNECT) != 0) {
-      enabled_events_ &= ~DE_CONNECT;
+      DisableEvents(DE_CONNECT);
       SignalConnectEvent(this);
     }
     if ((ff & DE_ACCEPT) != 0) {
-      enabled_events_ &= ~DE_ACCEPT;
+      DisableEvents(DE_ACCEPT);
       SignalReadEvent(this);
     }
     if ((ff & DE_READ) != 0) {
-      enabled_events_ &= ~DE_READ;
+      DisableEvents(DE_READ);
       SignalReadEvent(this);
     }
     if ((ff & DE_WRITE) != 0) {
-      enabled_events_ &= ~DE_WRITE;
+      DisableEvents(DE_WRITE);
       SignalWriteEvent(this);
     }
     if ((ff & DE_CLOSE) != 0) {
       // The socket is now dead to us, so stop checking it.
-      enabled_events_ = 0;
+      SetEnabledEvents(0);
       SignalCloseEvent(this, err);
     }
   }
@@ -910,11 +1133,20 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
     ss_->Remove(this);
     return PhysicalSocket::Close();
   }
+
+ protected:
+  virtual void SetEnabledEvents(uint8 events) {
+    if (events == enabled_events_)
+      return;
+    PhysicalSocket::SetEnabledEvents(events);
+    ss_->Update(this);
+  }
 };
 
 class FileDispatcher: public Dispatcher, public AsyncFile {
  public:
-  FileDispatcher(int fd, PhysicalSocketServer *ss) : ss_(ss), fd_(fd) {
+  FileDispatcher(int fd, PhysicalSocketServer *ss)
+      : ss_(ss), fd_(fd), flags_(0) {
     set_readable(true);
 
     ss_->Add(this);
@@ -958,6 +1190,7 @@ class FileDispatcher: public Dispatcher, public AsyncFile {
 
   virtual void set_readable(bool value) {
     flags_ = value ? (flags_ | DE_READ) : (flags_ & ~DE_READ);
+    ss_->Update(this);
   }
 
   virtual bool writable() {
@@ -966,6 +1199,7 @@ class FileDispatcher: public Dispatcher, public AsyncFile {
 
   virtual void set_writable(bool value) {
     flags_ = value ? (flags_ | DE_WRITE) : (flags_ & ~DE_WRITE);
+    ss_->Update(this);
   }
 
  private:
@@ -1186,8 +1420,33 @@ class Signaler : public EventDispatcher {
   bool *pf_;
 };
 
+#if defined(WEBRTC_USE_POLL_BACKEND)
+// Maximum number of ready descriptors handled per call into the kernel.
+static const int kMaxPollEvents = 128;
+#endif
+
 PhysicalSocketServer::PhysicalSocketServer()
-    : fWait_(false) {
+    :
+#if defined(WEBRTC_USE_POLL_BACKEND)
+      poll_fd_(INVALID_SOCKET),
+      next_poll_key_(1),
+      processing_poll_events_(false),
+#endif
+      fWait_(false) {
+#if defined(WEBRTC_USE_EPOLL)
+  poll_fd_ = epoll_create(FD_SETSIZE);
+#elif defined(WEBRTC_USE_KQUEUE)
+  poll_fd_ = kqueue();
+#endif
+#if defined(WEBRTC_USE_POLL_BACKEND)
+  if (poll_fd_ == INVALID_SOCKET) {
+    // Not an error, we just fall back to select().
+    LOG_E(LS_WARNING, EN, errno) << "Failed to create poll descriptor, "
+                                 << "using select()";
+  } else {
+    fcntl(poll_fd_, F_SETFD, fcntl(poll_fd_, F_GETFD) | FD_CLOEXEC);
+  }
+#endif
   signal_wakeup_ = new Signaler(this, &fWait_);
 #if defined(WEBRTC_WIN)
   socket_ev_ = WSACreateEvent();
@@ -1203,6 +1462,10 @@ PhysicalSocketServer::~PhysicalSocketServer() {
 #endif
   delete signal_wakeup_;
   ASSERT(dispatchers_.empty());
+#if defined(WEBRTC_USE_POLL_BACKEND)
+  if (poll_fd_ != INVALID_SOCKET)
+    close(poll_fd_);
+#endif
 }
 
 void PhysicalSocketServer::WakeUp() {
@@ -1256,6 +1519,10 @@ void PhysicalSocketServer::Add(Dispatcher *pdispatcher) {
   if (pos != dispatchers_.end())
     return;
   dispatchers_.push_back(pdispatcher);
+#if defined(WEBRTC_USE_POLL_BACKEND)
+  if (poll_fd_ != INVALID_SOCKET)
+    AddPoll(pdispatcher);
+#endif
 }
 
 void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
@@ -1279,10 +1546,47 @@ void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
       --**it;
     }
   }
+#if defined(WEBRTC_USE_POLL_BACKEND)
+  if (poll_fd_ != INVALID_SOCKET)
+    RemovePoll(pdispatcher);
+#endif
+}
+
+void PhysicalSocketServer::Update(Dispatcher *pdispatcher) {
+#if defined(WEBRTC_USE_POLL_BACKEND)
+  CritScope cs(&crit_);
+  if (poll_fd_ == INVALID_SOCKET)
+    return;
+  PollEntryMap::iterator it = poll_entries_.find(pdispatcher);
+  if (it == poll_entries_.end()) {
+    // Dispatchers update their events before they are added and after they
+    // are removed, e.g. while being created or closed.
+    return;
+  }
+  if (processing_poll_events_) {
+    // Only the thread delivering events can get here, since it holds |crit_|.
+    if (!it->second.update_pending) {
+      it->second.update_pending = true;
+      pending_poll_updates_.push_back(it->second.key);
+    }
+    return;
+  }
+  UpdatePoll(pdispatcher, &it->second);
+#endif
 }
 
 #if defined(WEBRTC_POSIX)
 bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
+#if defined(WEBRTC_USE_POLL_BACKEND)
+  // The poll descriptor watches every dispatcher, so the (rare) wait that
+  // should only be interrupted by WakeUp() is left to select().
+  if (poll_fd_ != INVALID_SOCKET && process_io)
+    return WaitPoll(cmsWait);
+#endif
+  return WaitSelect(cmsWait, process_io);
+}
+
+bool PhysicalSocketServer::WaitSelect(int cmsWait, bool process_io) {
   // Calculate timing information
 
   struct timeval *ptvWait = NULL;
@@ -1433,6 +1737,229 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
   return true;
 }
 
+#if defined(WEBRTC_USE_POLL_BACKEND)
+void PhysicalSocketServer::AddPoll(Dispatcher* pdispatcher) {
+  PollEntry& entry = poll_entries_[pdispatcher];
+  entry.key = next_poll_key_++;
+  poll_keys_[entry.key] = pdispatcher;
+  UpdatePoll(pdispatcher, &entry);
+}
+
+void PhysicalSocketServer::RemovePoll(Dispatcher* pdispatcher) {
+  PollEntryMap::iterator it = poll_entries_.find(pdispatcher);
+  if (it == poll_entries_.end())
+    return;
+  if (it->second.registered_events != 0) {
+    // Deregister explicitly; the kernel only drops a descriptor by itself
+    // once it is closed.
+    int fd = pdispatcher->GetDescriptor();
+#if defined(WEBRTC_USE_EPOLL)
+    struct epoll_event event = {0};
+    epoll_ctl(poll_fd_, EPOLL_CTL_DEL, fd, &event);
+#elif defined(WEBRTC_USE_KQUEUE)
+    struct kevent changes[2];
+    EV_SET(&changes[0], fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+    EV_SET(&changes[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+    // One of the filters may never have been added; ENOENT is expected.
+    kevent(poll_fd_, changes, 2, NULL, 0, NULL);
+#endif
+  }
+  poll_keys_.erase(it->second.key);
+  poll_entries_.erase(it);
+}
+
+void PhysicalSocketServer::UpdatePoll(Dispatcher* pdispatcher,
+                                      PollEntry* entry) {
+  // Only read and write readiness is registered; the dispatcher event that
+  // is reported for it is worked out in ProcessPollEvent().
+  uint32 ff = pdispatcher->GetRequestedEvents();
+  uint32 events = 0;
+  if (ff & (DE_READ | DE_ACCEPT))
+    events |= DE_READ;
+  if (ff & (DE_WRITE | DE_CONNECT))
+    events |= DE_WRITE;
+  if (events == entry->registered_events)
+    return;
+
+  int fd = pdispatcher->GetDescriptor();
+#if defined(WEBRTC_USE_EPOLL)
+  // Descriptors with nothing to wait for are removed altogether, otherwise a
+  // hung up socket would return EPOLLHUP from every epoll_wait().
+  struct epoll_event event = {0};
+  event.data.u64 = entry->key;
+  if (events & DE_READ)
+    event.events |= EPOLLIN | EPOLLRDHUP;
+  if (events & DE_WRITE)
+    event.events |= EPOLLOUT;
+  int op = EPOLL_CTL_MOD;
+  if (entry->registered_events == 0) {
+    op = EPOLL_CTL_ADD;
+  } else if (events == 0) {
+    op = EPOLL_CTL_DEL;
+  }
+  if (epoll_ctl(poll_fd_, op, fd, &event) < 0) {
+    LOG_E(LS_ERROR, EN, errno) << "epoll_ctl " << op << " failed for " << fd;
+    return;
+  }
+#elif defined(WEBRTC_USE_KQUEUE)
+  struct kevent changes[2];
+  int count = 0;
+  void* udata = reinterpret_cast<void*>(entry->key);
+  if ((events ^ entry->registered_events) & DE_READ) {
+    EV_SET(&changes[count++], fd, EVFILT_READ,
+           (events & DE_READ) ? EV_ADD | EV_ENABLE : EV_DISABLE, 0, 0, udata);
+  }
+  if ((events ^ entry->registered_events) & DE_WRITE) {
+    EV_SET(&changes[count++], fd, EVFILT_WRITE,
+           (events & DE_WRITE) ? EV_ADD | EV_ENABLE : EV_DISABLE, 0, 0, udata);
+  }
+  if (kevent(poll_fd_, changes, count, NULL, 0, NULL) < 0) {
+    LOG_E(LS_ERROR, EN, errno) << "kevent failed for " << fd;
+    return;
+  }
+#endif
+  entry->registered_events = events;
+}
+
+void PhysicalSocketServer::FlushPendingPollUpdates() {
+  for (size_t i = 0; i < pending_poll_updates_.size(); ++i) {
+    PollKeyMap::iterator key = poll_keys_.find(pending_poll_updates_[i]);
+    if (key == poll_keys_.end())
+      continue;  // Removed since the update was queued.
+    PollEntry& entry = poll_entries_[key->second];
+    entry.update_pending = false;
+    UpdatePoll(key->second, &entry);
+  }
+  pending_poll_updates_.clear();
+}
+
+void PhysicalSocketServer::ProcessPollEvent(Dispatcher* pdispatcher,
+                                            bool readable,
+                                            bool writable,
+                                            bool check_error,
+                                            bool check_close) {
+  // Same translation as in WaitSelect(), except that the kernel tells us
+  // whether an error or a hang up is pending, which saves a getsockopt() and
+  // a recv(MSG_PEEK) on every readable packet.
+  int errcode = 0;
+  if (check_error) {
+    socklen_t len = sizeof(errcode);
+    ::getsockopt(pdispatcher->GetDescriptor(), SOL_SOCKET, SO_ERROR,
+                 &errcode, &len);
+  }
+
+  uint32 requested = pdispatcher->GetRequestedEvents();
+  uint32 ff = 0;
+  if (readable && (requested & (DE_READ | DE_ACCEPT))) {
+    if (requested & DE_ACCEPT) {
+      ff |= DE_ACCEPT;
+    } else if (errcode || (check_close && pdispatcher->IsDescriptorClosed())) {
+      ff |= DE_CLOSE;
+    } else {
+      ff |= DE_READ;
+    }
+  }
+  if (writable && (requested & (DE_WRITE | DE_CONNECT))) {
+    if (requested & DE_CONNECT) {
+      if (!errcode) {
+        ff |= DE_CONNECT;
+      } else {
+        ff |= DE_CLOSE;
+      }
+    } else {
+      ff |= DE_WRITE;
+    }
+  }
+
+  if (ff != 0) {
+    pdispatcher->OnPreEvent(ff);
+    pdispatcher->OnEvent(ff, errcode);
+  }
+}
+
+bool PhysicalSocketServer::WaitPoll(int cmsWait) {
+  uint32 msStop = 0;
+  if (cmsWait != kForever)
+    msStop = TimeAfter(cmsWait);
+  int cmsNext = cmsWait;
+
+  fWait_ = true;
+
+  while (fWait_) {
+#if defined(WEBRTC_USE_EPOLL)
+    struct epoll_event events[kMaxPollEvents];
+    int n = epoll_wait(poll_fd_, events, kMaxPollEvents, cmsNext);
+#elif defined(WEBRTC_USE_KQUEUE)
+    struct kevent events[kMaxPollEvents];
+    struct timespec ts;
+    struct timespec* pts = NULL;
+    if (cmsNext != kForever) {
+      ts.tv_sec = cmsNext / 1000;
+      ts.tv_nsec = (cmsNext % 1000) * 1000000;
+      pts = &ts;
+    }
+    int n = kevent(poll_fd_, NULL, 0, events, kMaxPollEvents, pts);
+#endif
+
+    if (n < 0) {
+      if (errno != EINTR) {
+        LOG_E(LS_ERROR, EN, errno) << "Failed to wait for poll events";
+        return false;
+      }
+      // Else ignore the error and keep going, see WaitSelect().
+    } else if (n == 0) {
+      // If timeout, return success
+      return true;
+    } else {
+      CritScope cr(&crit_);
+      processing_poll_events_ = true;
+      for (int i = 0; i < n; ++i) {
+#if defined(WEBRTC_USE_EPOLL)
+        PollKeyMap::iterator it = poll_keys_.find(events[i].data.u64);
+#elif defined(WEBRTC_USE_KQUEUE)
+        PollKeyMap::iterator it = poll_keys_.find(
+            reinterpret_cast<uintptr_t>(events[i].udata));
+#endif
+        if (it == poll_keys_.end()) {
+          // Removed while handling an earlier event of this batch.
+          continue;
+        }
+#if defined(WEBRTC_USE_EPOLL)
+        uint32 ev = events[i].events;
+        bool error = (ev & (EPOLLERR | EPOLLHUP)) != 0;
+        ProcessPollEvent(it->second,
+                         (ev & (EPOLLIN | EPOLLRDHUP)) != 0 || error,
+                         (ev & EPOLLOUT) != 0 || error,
+                         error,
+                         (ev & (EPOLLRDHUP | EPOLLHUP)) != 0);
+#elif defined(WEBRTC_USE_KQUEUE)
+        // kqueue reports each filter separately, so a descriptor that is
+        // both readable and writable shows up twice in the same batch.
+        bool eof = (events[i].flags & EV_EOF) != 0;
+        bool error = (events[i].flags & EV_ERROR) != 0 ||
+                     (eof && events[i].fflags != 0);
+        ProcessPollEvent(it->second,
+                         events[i].filter == EVFILT_READ,
+                         events[i].filter == EVFILT_WRITE,
+                         error,
+                         eof);
+#endif
+      }
+      processing_poll_events_ = false;
+      FlushPendingPollUpdates();
+    }
+
+    if (cmsWait != kForever) {
+      cmsNext = TimeUntil(msStop);
+      if (cmsNext < 0)
+        cmsNext = 0;
+    }
+  }
+
+  return true;
+}
+#endif  // WEBRTC_USE_POLL_BACKEND
+
 static void GlobalSignalHandler(int signum) {
   PosixSignalHandler::Instance()->OnPosixSignalReceived(signum);
 }
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_BASE_PHYSICALSOCKETSERVER_H__
 #define WEBRTC_BASE_PHYSICALSOCKETSERVER_H__
 
+#include <map>
 #include <vector>
 
 #include "webrtc/base/asyncfile.h"
@@ -22,6 +23,22 @@
 typedef int SOCKET;
 #endif // WEBRTC_POSIX
 
+// On platforms with a scalable readiness API, the socket server registers
+// each dispatcher with the kernel once and only visits the ready ones in
+// Wait(). select() remains the fallback if the poll descriptor can't be
+// created, and is always used when Wait() is called without |process_io|.
+#if !defined(WEBRTC_DISABLE_POLL_BACKEND)
+#if defined(WEBRTC_LINUX)
+#define WEBRTC_USE_EPOLL 1
+#elif defined(WEBRTC_MAC)
+#define WEBRTC_USE_KQUEUE 1
+#endif
+#endif  // !WEBRTC_DISABLE_POLL_BACKEND
+
+#if defined(WEBRTC_USE_EPOLL) || defined(WEBRTC_USE_KQUEUE)
+#define WEBRTC_USE_POLL_BACKEND 1
+#endif
+
 namespace rtc {
 
 // Event constants for the Dispatcher class.
@@ -76,6 +93,10 @@ class PhysicalSocketServer : public SocketServer {
 
   void Add(Dispatcher* dispatcher);
   void Remove(Dispatcher* dispatcher);
+  // Must be called whenever the value returned by
+  // |dispatcher|->GetRequestedEvents() changes, so that the poll backend can
+  // update its registration. A no-op for the select() loop.
+  void Update(Dispatcher* dispatcher);
 
 #if defined(WEBRTC_POSIX)
   AsyncFile* CreateFile(int fd);
@@ -103,8 +124,46 @@ class PhysicalSocketServer : public SocketServer {
 #if defined(WEBRTC_POSIX)
   static bool InstallSignal(int signum, void (*handler)(int));
 
+  bool WaitSelect(int cms, bool process_io);
+
   scoped_ptr<PosixSignalDispatcher> signal_dispatcher_;
 #endif
+
+#if defined(WEBRTC_USE_POLL_BACKEND)
+  // Registration state of a dispatcher in the poll descriptor. Ready events
+  // carry |key| rather than the dispatcher pointer, so an event for a
+  // dispatcher that was removed (and maybe reallocated at the same address)
+  // earlier in the same batch is dropped instead of misdelivered.
+  struct PollEntry {
+    PollEntry() : key(0), registered_events(0), update_pending(false) {}
+    uintptr_t key;
+    uint32 registered_events;
+    bool update_pending;
+  };
+  typedef std::map<Dispatcher*, PollEntry> PollEntryMap;
+  typedef std::map<uintptr_t, Dispatcher*> PollKeyMap;
+
+  bool WaitPoll(int cms);
+  void AddPoll(Dispatcher* dispatcher);
+  void RemovePoll(Dispatcher* dispatcher);
+  void UpdatePoll(Dispatcher* dispatcher, PollEntry* entry);
+  void FlushPendingPollUpdates();
+  void ProcessPollEvent(Dispatcher* dispatcher,
+                        bool readable,
+                        bool writable,
+                        bool check_error,
+                        bool check_close);
+
+  int poll_fd_;
+  uintptr_t next_poll_key_;
+  PollEntryMap poll_entries_;
+  PollKeyMap poll_keys_;
+  // Keys of dispatchers whose requested events changed while Wait() was
+  // delivering events. They are re-registered once the batch is done, so a
+  // socket that is disabled and re-enabled by its handler costs no syscalls.
+  std::vector<uintptr_t> pending_poll_updates_;
+  bool processing_poll_events_;
+#endif  // WEBRTC_USE_POLL_BACKEND
   DispatcherList dispatchers_;
   IteratorList iterators_;
   Signaler* signal_wakeup_;
@@ -152,6 +152,56 @@ TEST_F(PhysicalSocketTest, TestGetSetOptionsIPv6) {
   SocketTest::TestGetSetOptionsIPv6();
 }
 
+// Deletes the other socket from the read handler of whichever socket is
+// signaled first.
+class SocketDeleter : public sigslot::has_slots<> {
+ public:
+  SocketDeleter(scoped_ptr<AsyncSocket>* a, scoped_ptr<AsyncSocket>* b)
+      : a_(a), b_(b), read_events_(0) {
+  }
+
+  void OnReadEvent(AsyncSocket* socket) {
+    ++read_events_;
+    char buf[16];
+    socket->Recv(buf, sizeof(buf));
+    if (socket == a_->get()) {
+      b_->reset();
+    } else {
+      a_->reset();
+    }
+  }
+
+  int read_events() const { return read_events_; }
+
+ private:
+  scoped_ptr<AsyncSocket>* a_;
+  scoped_ptr<AsyncSocket>* b_;
+  int read_events_;
+};
+
+// Both sockets are readable when Wait() is entered, so they are reported in
+// the same batch of ready descriptors. The event for the deleted socket must
+// be dropped rather than delivered to freed memory.
+TEST_F(PhysicalSocketTest, TestDeleteSocketDuringReadEvent) {
+  PhysicalSocketServer ss;
+  scoped_ptr<AsyncSocket> a(ss.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  scoped_ptr<AsyncSocket> b(ss.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  scoped_ptr<AsyncSocket> sender(ss.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, a->Bind(SocketAddress("127.0.0.1", 0)));
+  ASSERT_EQ(0, b->Bind(SocketAddress("127.0.0.1", 0)));
+
+  SocketDeleter deleter(&a, &b);
+  a->SignalReadEvent.connect(&deleter, &SocketDeleter::OnReadEvent);
+  b->SignalReadEvent.connect(&deleter, &SocketDeleter::OnReadEvent);
+
+  EXPECT_EQ(1, sender->SendTo("a", 1, a->GetLocalAddress()));
+  EXPECT_EQ(1, sender->SendTo("b", 1, b->GetLocalAddress()));
+  EXPECT_TRUE(ss.Wait(100, true));
+
+  EXPECT_EQ(1, deleter.read_events());
+  EXPECT_TRUE((a.get() == NULL) != (b.get() == NULL));
+}
+
 #if defined(WEBRTC_POSIX)
 
 class PosixSignalDeliveryTest : public testing::Test {
@@ -66,6 +66,12 @@ class RefCountedObject : public T {
     return count;
   }
 
+  // Returns true if the caller holds the only reference, so that no other
+  // thread can be using the object.
+  bool HasOneRef() const {
+    return rtc::AtomicOps::AcquireLoad(&ref_count_) == 1;
+  }
+
  protected:
   virtual ~RefCountedObject() {
   }
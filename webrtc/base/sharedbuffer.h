@@ -0,0 +1,72 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_SHAREDBUFFER_H_
+#define WEBRTC_BASE_SHAREDBUFFER_H_
+
+#include <string.h>
+
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+
+namespace rtc {
+
+// Read-only bytes whose storage is shared by all copies, so that one packet
+// payload can be handed to several consumers without copying it. Slice()
+// returns part of the bytes, sharing the same storage. The storage is freed
+// when the last copy or slice is destroyed.
+class SharedBuffer {
+ public:
+  SharedBuffer() : offset_(0), length_(0) {}
+  // Copies |data| into new storage.
+  SharedBuffer(const void* data, size_t length)
+      : storage_(new RefCountedObject<Buffer>(data, length)),
+        offset_(0),
+        length_(length) {}
+  // Takes over the storage of |buffer|, which is left empty.
+  explicit SharedBuffer(Buffer* buffer)
+      : storage_(new RefCountedObject<Buffer>()),
+        offset_(0),
+        length_(buffer->length()) {
+    buffer->TransferTo(storage_.get());
+  }
+
+  const char* data() const {
+    return storage_ ? storage_->data() + offset_ : NULL;
+  }
+  size_t length() const { return length_; }
+
+  // Returns |length| bytes from |offset|, which must be within this buffer.
+  SharedBuffer Slice(size_t offset, size_t length) const {
+    ASSERT(offset + length <= length_);
+    SharedBuffer slice(*this);
+    slice.offset_ += offset;
+    slice.length_ = length;
+    return slice;
+  }
+
+  bool operator==(const SharedBuffer& buf) const {
+    return length_ == buf.length() &&
+        (length_ == 0 || memcmp(data(), buf.data(), length_) == 0);
+  }
+  bool operator!=(const SharedBuffer& buf) const {
+    return !operator==(buf);
+  }
+
+ private:
+  scoped_refptr<RefCountedObject<Buffer> > storage_;
+  size_t offset_;
+  size_t length_;
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_SHAREDBUFFER_H_
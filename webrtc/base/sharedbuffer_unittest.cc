@@ -0,0 +1,59 @@
+/*
+ *  Copyright 2014 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/sharedbuffer.h"
+
+namespace rtc {
+
+static const char kTestData[] = {
+  0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF
+};
+
+TEST(SharedBufferTest, TestConstructDefault) {
+  SharedBuffer buf;
+  EXPECT_EQ(0U, buf.length());
+  EXPECT_TRUE(buf.data() == NULL);
+  EXPECT_EQ(SharedBuffer(), buf);
+}
+
+TEST(SharedBufferTest, TestCopiesShareData) {
+  SharedBuffer buf1(kTestData, sizeof(kTestData));
+  SharedBuffer buf2(buf1);
+  EXPECT_EQ(buf1.data(), buf2.data());
+  EXPECT_EQ(sizeof(kTestData), buf2.length());
+  EXPECT_EQ(0, memcmp(buf2.data(), kTestData, sizeof(kTestData)));
+}
+
+TEST(SharedBufferTest, TestTakesBuffer) {
+  Buffer buffer(kTestData, sizeof(kTestData));
+  const char* data = buffer.data();
+  SharedBuffer buf(&buffer);
+  EXPECT_EQ(data, buf.data());
+  EXPECT_EQ(sizeof(kTestData), buf.length());
+  EXPECT_EQ(0U, buffer.length());
+}
+
+TEST(SharedBufferTest, TestSlice) {
+  SharedBuffer slice;
+  {
+    SharedBuffer buf(kTestData, sizeof(kTestData));
+    slice = buf.Slice(4, 8);
+    EXPECT_EQ(buf.data() + 4, slice.data());
+  }
+  // The slice keeps the storage alive.
+  EXPECT_EQ(8U, slice.length());
+  EXPECT_EQ(0, memcmp(slice.data(), kTestData + 4, 8));
+  SharedBuffer slice_of_slice = slice.Slice(2, 2);
+  EXPECT_EQ(2U, slice_of_slice.length());
+  EXPECT_EQ(kTestData[6], slice_of_slice.data()[0]);
+}
+
+}  // namespace rtc
@@ -2845,6 +2845,267 @@ namespace sigslot {
 		}
 	};
 
+	// Libjingle specific:
+	// st_signal4 and st_signal5 are for signals emitted for every packet. They
+	// connect to any has_slots<> like the other signals, but never lock and
+	// keep their first connections in the signal itself rather than in a
+	// list, so emitting is a walk over a small array. Connecting, disconnecting
+	// and emitting must all happen on the same thread, as is the case for
+	// objects driven by an rtc::Thread. A slot may disconnect itself or others,
+	// or delete the signal, while the signal is being emitted.
+	template<class connection_type>
+	class _st_signal_base : public _signal_base_interface
+	{
+	public:
+		_st_signal_base()
+			: m_slots(m_inline_slots), m_size(0), m_capacity(kInlineSlots),
+			m_emit_scope(NULL), m_has_removed(false)
+		{
+			;
+		}
+
+		_st_signal_base(const _st_signal_base<connection_type>& s)
+			: _signal_base_interface(s), m_slots(m_inline_slots), m_size(0),
+			m_capacity(kInlineSlots), m_emit_scope(NULL), m_has_removed(false)
+		{
+			for(size_t i = 0; i < s.m_size; ++i)
+			{
+				if(s.m_slots[i])
+				{
+					s.m_slots[i]->getdest()->signal_connect(this);
+					add(s.m_slots[i]->clone());
+				}
+			}
+		}
+
+		virtual ~_st_signal_base()
+		{
+			for(emit_scope* scope = m_emit_scope; scope; scope = scope->m_outer)
+				scope->m_destroyed = true;
+			disconnect_all();
+			if(m_slots != m_inline_slots)
+				delete[] m_slots;
+		}
+
+		void slot_duplicate(const has_slots_interface* oldtarget, has_slots_interface* newtarget)
+		{
+			const size_t size = m_size;
+			for(size_t i = 0; i < size; ++i)
+			{
+				if(m_slots[i] && m_slots[i]->getdest() == oldtarget)
+					add(m_slots[i]->duplicate(newtarget));
+			}
+		}
+
+		bool is_empty()
+		{
+			for(size_t i = 0; i < m_size; ++i)
+			{
+				if(m_slots[i])
+					return false;
+			}
+			return true;
+		}
+
+		void disconnect_all()
+		{
+			for(size_t i = 0; i < m_size; ++i)
+			{
+				if(m_slots[i])
+				{
+					m_slots[i]->getdest()->signal_disconnect(this);
+					remove(i);
+				}
+			}
+			compact();
+		}
+
+		void disconnect(has_slots_interface* pclass)
+		{
+			for(size_t i = 0; i < m_size; ++i)
+			{
+				if(m_slots[i] && m_slots[i]->getdest() == pclass)
+				{
+					remove(i);
+					compact();
+					pclass->signal_disconnect(this);
+					return;
+				}
+			}
+		}
+
+		void slot_disconnect(has_slots_interface* pslot)
+		{
+			for(size_t i = 0; i < m_size; ++i)
+			{
+				if(m_slots[i] && m_slots[i]->getdest() == pslot)
+					remove(i);
+			}
+			compact();
+		}
+
+	protected:
+		void add(connection_type* conn)
+		{
+			if(m_size == m_capacity)
+			{
+				connection_type** slots = new connection_type*[2 * m_capacity];
+				for(size_t i = 0; i < m_size; ++i)
+					slots[i] = m_slots[i];
+				if(m_slots != m_inline_slots)
+					delete[] m_slots;
+				m_slots = slots;
+				m_capacity *= 2;
+			}
+			m_slots[m_size++] = conn;
+		}
+
+		// Deleted slots are left as NULL while emitting, so that the indices
+		// of the others don't change.
+		void remove(size_t i)
+		{
+			delete m_slots[i];
+			m_slots[i] = NULL;
+			m_has_removed = true;
+		}
+
+		void compact()
+		{
+			if(m_emit_scope || !m_has_removed)
+				return;
+			size_t size = 0;
+			for(size_t i = 0; i < m_size; ++i)
+			{
+				if(m_slots[i])
+					m_slots[size++] = m_slots[i];
+			}
+			m_size = size;
+			m_has_removed = false;
+		}
+
+		// Marks the signal as being emitted for its lifetime, and tells if a
+		// slot deleted the signal.
+		class emit_scope
+		{
+		public:
+			explicit emit_scope(_st_signal_base<connection_type>* signal)
+				: m_signal(signal), m_outer(signal->m_emit_scope),
+				m_destroyed(false)
+			{
+				m_signal->m_emit_scope = this;
+			}
+
+			~emit_scope()
+			{
+				if(m_destroyed)
+					return;
+				m_signal->m_emit_scope = m_outer;
+				m_signal->compact();
+			}
+
+			bool destroyed() const
+			{
+				return m_destroyed;
+			}
+
+		private:
+			friend class _st_signal_base<connection_type>;
+
+			_st_signal_base<connection_type>* m_signal;
+			emit_scope* m_outer;
+			bool m_destroyed;
+		};
+
+		enum { kInlineSlots = 2 };
+
+		connection_type* m_inline_slots[kInlineSlots];
+		connection_type** m_slots;
+		size_t m_size;
+		size_t m_capacity;
+		// The innermost emit in progress, if any.
+		emit_scope* m_emit_scope;
+		bool m_has_removed;
+	};
+
+	template<class arg1_type, class arg2_type, class arg3_type, class arg4_type>
+	class st_signal4 : public _st_signal_base<_connection_base4<arg1_type,
+		arg2_type, arg3_type, arg4_type, single_threaded> >
+	{
+	public:
+		typedef _st_signal_base<_connection_base4<arg1_type, arg2_type,
+			arg3_type, arg4_type, single_threaded> > base;
+		typedef typename base::emit_scope emit_scope;
+		using base::m_slots;
+		using base::m_size;
+
+		template<class desttype>
+			void connect(desttype* pclass, void (desttype::*pmemfun)(arg1_type,
+			arg2_type, arg3_type, arg4_type))
+		{
+			this->add(new _connection4<desttype, arg1_type, arg2_type,
+				arg3_type, arg4_type, single_threaded>(pclass, pmemfun));
+			pclass->signal_connect(this);
+		}
+
+		void emit(arg1_type a1, arg2_type a2, arg3_type a3, arg4_type a4)
+		{
+			emit_scope scope(this);
+			// Slots connected while emitting are not called until next time.
+			const size_t size = m_size;
+			for(size_t i = 0; i < size && !scope.destroyed(); ++i)
+			{
+				if(m_slots[i])
+					m_slots[i]->emit(a1, a2, a3, a4);
+			}
+		}
+
+		void operator()(arg1_type a1, arg2_type a2, arg3_type a3, arg4_type a4)
+		{
+			emit(a1, a2, a3, a4);
+		}
+	};
+
+	template<class arg1_type, class arg2_type, class arg3_type, class arg4_type,
+	class arg5_type>
+	class st_signal5 : public _st_signal_base<_connection_base5<arg1_type,
+		arg2_type, arg3_type, arg4_type, arg5_type, single_threaded> >
+	{
+	public:
+		typedef _st_signal_base<_connection_base5<arg1_type, arg2_type,
+			arg3_type, arg4_type, arg5_type, single_threaded> > base;
+		typedef typename base::emit_scope emit_scope;
+		using base::m_slots;
+		using base::m_size;
+
+		template<class desttype>
+			void connect(desttype* pclass, void (desttype::*pmemfun)(arg1_type,
+			arg2_type, arg3_type, arg4_type, arg5_type))
+		{
+			this->add(new _connection5<desttype, arg1_type, arg2_type,
+				arg3_type, arg4_type, arg5_type, single_threaded>(pclass, pmemfun));
+			pclass->signal_connect(this);
+		}
+
+		void emit(arg1_type a1, arg2_type a2, arg3_type a3, arg4_type a4,
+			arg5_type a5)
+		{
+			emit_scope scope(this);
+			// Slots connected while emitting are not called until next time.
+			const size_t size = m_size;
+			for(size_t i = 0; i < size && !scope.destroyed(); ++i)
+			{
+				if(m_slots[i])
+					m_slots[i]->emit(a1, a2, a3, a4, a5);
+			}
+		}
+
+		void operator()(arg1_type a1, arg2_type a2, arg3_type a3, arg4_type a4,
+			arg5_type a5)
+		{
+			emit(a1, a2, a3, a4, a5);
+		}
+	};
+
 }; // namespace sigslot
 
 #endif // WEBRTC_BASE_SIGSLOT_H__
@@ -248,3 +248,84 @@ TEST(DestructionOrder, SlotFirst) {
   (*signal)();
   delete signal;
 }
+
+// Counts the packets it gets, and can disconnect itself from or delete the
+// signal on the first one.
+class PacketReceiver : public sigslot::has_slots<> {
+ public:
+  typedef sigslot::st_signal4<int, const char*, size_t, int> PacketSignal;
+
+  PacketReceiver() : signal_(NULL), count_(0), sum_(0),
+                     disconnect_(false), delete_signal_(false) {}
+
+  void Connect(PacketSignal* signal) {
+    signal_ = signal;
+    signal->connect(this, &PacketReceiver::OnPacket);
+  }
+  void OnPacket(int id, const char* data, size_t len, int value) {
+    ++count_;
+    sum_ += value;
+    if (disconnect_)
+      signal_->disconnect(this);
+    if (delete_signal_)
+      delete signal_;
+  }
+
+  PacketSignal* signal_;
+  int count_;
+  int sum_;
+  bool disconnect_;
+  bool delete_signal_;
+};
+
+TEST(SigslotST, EmitsToAllSlots) {
+  PacketReceiver::PacketSignal signal;
+  EXPECT_TRUE(signal.is_empty());
+  // More than fit in the signal itself.
+  PacketReceiver receivers[5];
+  for (int i = 0; i < 5; ++i)
+    receivers[i].Connect(&signal);
+  EXPECT_FALSE(signal.is_empty());
+  signal(1, "x", 1, 3);
+  signal.emit(2, "x", 1, 4);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(2, receivers[i].count_);
+    EXPECT_EQ(7, receivers[i].sum_);
+  }
+  signal.disconnect(&receivers[2]);
+  signal(3, "x", 1, 1);
+  EXPECT_EQ(2, receivers[2].count_);
+  EXPECT_EQ(3, receivers[4].count_);
+}
+
+TEST(SigslotST, SlotDisconnectsWhileEmitting) {
+  PacketReceiver::PacketSignal signal;
+  PacketReceiver first, second;
+  first.Connect(&signal);
+  second.Connect(&signal);
+  first.disconnect_ = true;
+  signal(1, "x", 1, 1);
+  signal(2, "x", 1, 1);
+  EXPECT_EQ(1, first.count_);
+  EXPECT_EQ(2, second.count_);
+}
+
+TEST(SigslotST, SlotDeletesSignalWhileEmitting) {
+  PacketReceiver::PacketSignal* signal = new PacketReceiver::PacketSignal();
+  PacketReceiver first, second;
+  first.Connect(signal);
+  second.Connect(signal);
+  first.delete_signal_ = true;
+  (*signal)(1, "x", 1, 1);
+  EXPECT_EQ(1, first.count_);
+  EXPECT_EQ(0, second.count_);
+}
+
+TEST(SigslotST, SlotDestroyedFirst) {
+  PacketReceiver::PacketSignal signal;
+  PacketReceiver* receiver = new PacketReceiver();
+  receiver->Connect(&signal);
+  delete receiver;
+  EXPECT_TRUE(signal.is_empty());
+  signal(1, "x", 1, 1);
+}
@@ -123,6 +123,23 @@ inline bool IsBlockingError(int e) {
   return (e == EWOULDBLOCK) || (e == EAGAIN) || (e == EINPROGRESS);
 }
 
+// A datagram for Socket::RecvFromBatch() and Socket::SendToBatch().
+struct SocketDatagram {
+  SocketDatagram() : data(NULL), capacity(0), size(0), truncated(false) {}
+
+  // Payload. RecvFromBatch() writes up to |capacity| bytes into it.
+  char* data;
+  size_t capacity;
+  // Number of valid bytes in |data|. Set by RecvFromBatch(), read by
+  // SendToBatch().
+  size_t size;
+  // Set by RecvFromBatch() if the datagram did not fit in |capacity| bytes
+  // and only its first |size| bytes were received.
+  bool truncated;
+  // Source address for RecvFromBatch(), destination for SendToBatch().
+  SocketAddress addr;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -143,6 +160,37 @@ class Socket {
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr) = 0;
   virtual int Recv(void *pv, size_t cb) = 0;
   virtual int RecvFrom(void *pv, size_t cb, SocketAddress *paddr) = 0;
+
+  // Receives up to |count| datagrams, using a single system call where the
+  // platform allows it. Returns the number of datagrams received, or -1 with
+  // the error set as for RecvFrom() if none could be read. The default
+  // implementation receives one datagram.
+  virtual int RecvFromBatch(SocketDatagram* datagrams, size_t count) {
+    if (count == 0)
+      return 0;
+    int received = RecvFrom(datagrams[0].data, datagrams[0].capacity,
+                            &datagrams[0].addr);
+    if (received < 0)
+      return received;
+    datagrams[0].size = static_cast<size_t>(received);
+    datagrams[0].truncated = false;
+    return 1;
+  }
+
+  // Sends |count| datagrams in order, using a single system call where the
+  // platform allows it. Returns the number of datagrams sent, or -1 with the
+  // error set as for SendTo() if the first one could not be sent.
+  virtual int SendToBatch(const SocketDatagram* datagrams, size_t count) {
+    size_t sent = 0;
+    for (; sent < count; ++sent) {
+      if (SendTo(datagrams[sent].data, datagrams[sent].size,
+                 datagrams[sent].addr) < 0) {
+        break;
+      }
+    }
+    return (sent == 0 && count != 0) ? -1 : static_cast<int>(sent);
+  }
+
   virtual int Listen(int backlog) = 0;
   virtual Socket *Accept(SocketAddress *paddr) = 0;
   virtual int Close() = 0;
@@ -169,6 +217,7 @@ class Socket {
     OPT_NODELAY,     // whether Nagle algorithm is enabled
     OPT_IPV6_V6ONLY, // Whether the socket is IPv6 only.
     OPT_DSCP,        // DSCP code
+    OPT_REUSEPORT,   // Whether other sockets may bind the same port.
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
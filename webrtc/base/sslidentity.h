@@ -116,6 +116,15 @@ class SSLCertChain {
   DISALLOW_COPY_AND_ASSIGN(SSLCertChain);
 };
 
+// The type of key pair an identity is generated with. ECDSA keys, on the
+// NIST P-256 curve, take a fraction of a millisecond to generate where RSA
+// keys can take hundreds of milliseconds on mobile devices.
+enum KeyType {
+  KT_RSA,
+  KT_ECDSA,
+  KT_DEFAULT = KT_RSA
+};
+
 // Parameters for generating an identity for testing. If common_name is
 // non-empty, it will be used for the certificate's subject and issuer name,
 // otherwise a random string will be used. |not_before| and |not_after| are
@@ -134,9 +143,11 @@ class SSLIdentity {
   // Generates an identity (keypair and self-signed certificate). If
   // common_name is non-empty, it will be used for the certificate's
   // subject and issuer name, otherwise a random string will be used.
-  // Returns NULL on failure.
+  // Returns NULL on failure, or if |key_type| isn't supported by the SSL
+  // library in use.
   // Caller is responsible for freeing the returned object.
-  static SSLIdentity* Generate(const std::string& common_name);
+  static SSLIdentity* Generate(const std::string& common_name,
+                               KeyType key_type = KT_DEFAULT);
 
   // Generates an identity with the specified validity period.
   static SSLIdentity* GenerateForTest(const SSLIdentityParams& params);
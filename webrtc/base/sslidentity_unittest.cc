@@ -206,3 +206,21 @@ TEST_F(SSLIdentityTest, PemDerConversion) {
 TEST_F(SSLIdentityTest, GetSignatureDigestAlgorithm) {
   TestGetSignatureDigestAlgorithm();
 }
+
+#if SSL_USE_OPENSSL
+TEST_F(SSLIdentityTest, GenerateEcdsa) {
+  rtc::scoped_ptr<SSLIdentity> identity(
+      SSLIdentity::Generate("test", rtc::KT_ECDSA));
+  ASSERT_TRUE(identity);
+
+  std::string digest_algorithm;
+  ASSERT_TRUE(identity->certificate().GetSignatureDigestAlgorithm(
+      &digest_algorithm));
+  EXPECT_EQ(rtc::DIGEST_SHA_256, digest_algorithm);
+
+  rtc::scoped_ptr<rtc::SSLCertificate> cert(rtc::SSLCertificate::FromPEMString(
+      identity->certificate().ToPEMString()));
+  ASSERT_TRUE(cert);
+  EXPECT_EQ(identity->certificate().ToPEMString(), cert->ToPEMString());
+}
+#endif  // SSL_USE_OPENSSL
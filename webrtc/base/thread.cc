@@ -17,11 +17,13 @@
 #if defined(WEBRTC_WIN)
 #include <comdef.h>
 #elif defined(WEBRTC_POSIX)
+#include <sched.h>
 #include <time.h>
 #endif
 
 #include "webrtc/base/common.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/stringutils.h"
 #include "webrtc/base/timeutils.h"
 
@@ -138,6 +140,9 @@ Thread::ScopedDisallowBlockingCalls::~ScopedDisallowBlockingCalls() {
 Thread::Thread(SocketServer* ss)
     : MessageQueue(ss),
       priority_(PRIORITY_NORMAL),
+      realtime_policy_(-1),
+      realtime_priority_(0),
+      cpu_mask_(0),
       running_(true, false),
 #if defined(WEBRTC_WIN)
       thread_(NULL),
@@ -212,6 +217,19 @@ bool Thread::SetPriority(ThreadPriority priority) {
 #endif
 }
 
+bool Thread::SetRealtimeScheduling(int policy, int priority,
+                                   uint64 cpu_mask) {
+#if defined(WEBRTC_POSIX) && !defined(__native_client__)
+  if (running()) return false;
+  realtime_policy_ = policy;
+  realtime_priority_ = priority;
+  cpu_mask_ = cpu_mask;
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool Thread::Start(Runnable* runnable) {
   ASSERT(owned_);
   if (!owned_) return false;
@@ -284,6 +302,34 @@ bool Thread::Start(Runnable* runnable) {
     return false;
   }
   running_.Set();
+
+#if !defined(__native_client__)
+  // Applied to the running thread, as without the privileges for real-time
+  // scheduling pthread_create() would fail with explicit attributes.
+  if (realtime_policy_ >= 0) {
+    struct sched_param param;
+    param.sched_priority = realtime_priority_;
+    error_code = pthread_setschedparam(thread_, realtime_policy_, &param);
+    if (error_code != 0) {
+      LOG(LS_WARNING) << "pthread_setschedparam, error " << error_code;
+    }
+  }
+#endif  // !defined(__native_client__)
+#if defined(WEBRTC_LINUX)
+  if (cpu_mask_ != 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu = 0; cpu < 64; ++cpu) {
+      if (cpu_mask_ & (static_cast<uint64>(1) << cpu)) {
+        CPU_SET(cpu, &cpus);
+      }
+    }
+    error_code = pthread_setaffinity_np(thread_, sizeof(cpus), &cpus);
+    if (error_code != 0) {
+      LOG(LS_WARNING) << "pthread_setaffinity_np, error " << error_code;
+    }
+  }
+#endif  // defined(WEBRTC_LINUX)
 #endif
   return true;
 }
@@ -405,7 +451,11 @@ void Thread::Send(MessageHandler *phandler, uint32 id, MessageData *pdata) {
     return;
   }
 
-  AutoThread thread;
+  // Only a thread unknown to rtc needs to be wrapped for the wait. Creating
+  // an AutoThread creates a socket server, too expensive for every Send().
+  scoped_ptr<AutoThread> auto_thread;
+  if (!Thread::Current())
+    auto_thread.reset(new AutoThread());
   Thread *current_thread = Thread::Current();
   ASSERT(current_thread != NULL);  // AutoThread ensures this
 
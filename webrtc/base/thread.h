@@ -139,6 +139,13 @@ class Thread : public MessageQueue {
   ThreadPriority priority() const { return priority_; }
   bool SetPriority(ThreadPriority priority);
 
+  // Schedules the thread with the real-time |policy| (SCHED_FIFO or SCHED_RR)
+  // at |priority| instead of priority(), and pins it to the CPUs set in
+  // |cpu_mask| (bit n for CPU n) unless it is 0. A negative |policy| keeps
+  // the scheduling of priority(). POSIX only, the CPU mask is only applied on
+  // Linux. Must be called before Start().
+  bool SetRealtimeScheduling(int policy, int priority, uint64 cpu_mask);
+
   // Starts the execution of the thread.
   bool Start(Runnable* runnable = NULL);
 
@@ -245,6 +252,9 @@ class Thread : public MessageQueue {
   std::list<_SendMessage> sendlist_;
   std::string name_;
   ThreadPriority priority_;
+  int realtime_policy_;
+  int realtime_priority_;
+  uint64 cpu_mask_;
   Event running_;  // Signalled means running.
 
 #if defined(WEBRTC_POSIX)
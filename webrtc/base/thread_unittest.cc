@@ -239,6 +239,17 @@ TEST(ThreadTest, Priorities) {
 
 }
 
+#if defined(WEBRTC_POSIX)
+// Test that the thread starts also if real-time scheduling isn't permitted.
+TEST(ThreadTest, RealtimeScheduling) {
+  Thread thread;
+  EXPECT_TRUE(thread.SetRealtimeScheduling(SCHED_RR, 10, 1));
+  EXPECT_TRUE(thread.Start());
+  EXPECT_FALSE(thread.SetRealtimeScheduling(SCHED_FIFO, 10, 0));
+  thread.Stop();
+}
+#endif
+
 TEST(ThreadTest, Wrap) {
   Thread* current_thread = Thread::Current();
   current_thread->UnwrapCurrent();
@@ -10,23 +10,214 @@
 
 #include "webrtc/common_audio/include/audio_util.h"
 
+#include "webrtc/common_audio/audio_util_neon.h"
+#include "webrtc/common_audio/audio_util_sse.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
+namespace {
+
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+bool UseSSE2() {
+#if defined(__SSE2__)
+  return true;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) != 0;
+#endif
+}
+#elif defined(WEBRTC_ARCH_ARM_V7)
+bool UseNEON() {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+  return true;
+#else
+  return (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) != 0;
+#endif
+}
+#endif
+
+template <typename T>
+void DeinterleaveC(const T* interleaved, int samples_per_channel,
+                   int num_channels, T** deinterleaved) {
+  for (int i = 0; i < num_channels; ++i) {
+    T* channel = deinterleaved[i];
+    int interleaved_idx = i;
+    for (int j = 0; j < samples_per_channel; ++j) {
+      channel[j] = interleaved[interleaved_idx];
+      interleaved_idx += num_channels;
+    }
+  }
+}
+
+template <typename T>
+void InterleaveC(const T* const* deinterleaved, int samples_per_channel,
+                 int num_channels, T* interleaved) {
+  for (int i = 0; i < num_channels; ++i) {
+    const T* channel = deinterleaved[i];
+    int interleaved_idx = i;
+    for (int j = 0; j < samples_per_channel; ++j) {
+      interleaved[interleaved_idx] = channel[j];
+      interleaved_idx += num_channels;
+    }
+  }
+}
+
+template <typename T>
+void DeinterleaveOptimized(const T* interleaved, int samples_per_channel,
+                           int num_channels, T** deinterleaved) {
+  if (num_channels == 2) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (UseSSE2()) {
+      DeinterleaveStereo_SSE2(interleaved, samples_per_channel,
+                              deinterleaved[0], deinterleaved[1]);
+      return;
+    }
+#elif defined(WEBRTC_ARCH_ARM_V7)
+    if (UseNEON()) {
+      DeinterleaveStereo_NEON(interleaved, samples_per_channel,
+                              deinterleaved[0], deinterleaved[1]);
+      return;
+    }
+#endif
+  }
+  DeinterleaveC(interleaved, samples_per_channel, num_channels,
+                deinterleaved);
+}
+
+template <typename T>
+void InterleaveOptimized(const T* const* deinterleaved,
+                         int samples_per_channel, int num_channels,
+                         T* interleaved) {
+  if (num_channels == 2) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (UseSSE2()) {
+      InterleaveStereo_SSE2(deinterleaved[0], deinterleaved[1],
+                            samples_per_channel, interleaved);
+      return;
+    }
+#elif defined(WEBRTC_ARCH_ARM_V7)
+    if (UseNEON()) {
+      InterleaveStereo_NEON(deinterleaved[0], deinterleaved[1],
+                            samples_per_channel, interleaved);
+      return;
+    }
+#endif
+  }
+  InterleaveC(deinterleaved, samples_per_channel, num_channels, interleaved);
+}
+
+}  // namespace
+
 void RoundToInt16(const float* src, size_t size, int16_t* dest) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (UseSSE2()) {
+    RoundToInt16_SSE2(src, size, dest);
+    return;
+  }
+#elif defined(WEBRTC_ARCH_ARM_V7)
+  if (UseNEON()) {
+    RoundToInt16_NEON(src, size, dest);
+    return;
+  }
+#endif
   for (size_t i = 0; i < size; ++i)
     dest[i] = RoundToInt16(src[i]);
 }
 
 void ScaleAndRoundToInt16(const float* src, size_t size, int16_t* dest) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (UseSSE2()) {
+    ScaleAndRoundToInt16_SSE2(src, size, dest);
+    return;
+  }
+#elif defined(WEBRTC_ARCH_ARM_V7)
+  if (UseNEON()) {
+    ScaleAndRoundToInt16_NEON(src, size, dest);
+    return;
+  }
+#endif
   for (size_t i = 0; i < size; ++i)
     dest[i] = ScaleAndRoundToInt16(src[i]);
 }
 
 void ScaleToFloat(const int16_t* src, size_t size, float* dest) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (UseSSE2()) {
+    ScaleToFloat_SSE2(src, size, dest);
+    return;
+  }
+#elif defined(WEBRTC_ARCH_ARM_V7)
+  if (UseNEON()) {
+    ScaleToFloat_NEON(src, size, dest);
+    return;
+  }
+#endif
   for (size_t i = 0; i < size; ++i)
     dest[i] = ScaleToFloat(src[i]);
 }
 
+void FloatToFloatS16(const float* src, size_t size, float* dest) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (UseSSE2()) {
+    FloatToFloatS16_SSE2(src, size, dest);
+    return;
+  }
+#elif defined(WEBRTC_ARCH_ARM_V7)
+  if (UseNEON()) {
+    FloatToFloatS16_NEON(src, size, dest);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = FloatToFloatS16(src[i]);
+}
+
+void FloatS16ToFloat(const float* src, size_t size, float* dest) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (UseSSE2()) {
+    FloatS16ToFloat_SSE2(src, size, dest);
+    return;
+  }
+#elif defined(WEBRTC_ARCH_ARM_V7)
+  if (UseNEON()) {
+    FloatS16ToFloat_NEON(src, size, dest);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = FloatS16ToFloat(src[i]);
+}
+
+template <>
+void Deinterleave<int16_t>(const int16_t* interleaved, int samples_per_channel,
+                           int num_channels, int16_t** deinterleaved) {
+  DeinterleaveOptimized(interleaved, samples_per_channel, num_channels,
+                        deinterleaved);
+}
+
+template <>
+void Deinterleave<float>(const float* interleaved, int samples_per_channel,
+                         int num_channels, float** deinterleaved) {
+  DeinterleaveOptimized(interleaved, samples_per_channel, num_channels,
+                        deinterleaved);
+}
+
+template <>
+void Interleave<int16_t>(const int16_t* const* deinterleaved,
+                         int samples_per_channel, int num_channels,
+                         int16_t* interleaved) {
+  InterleaveOptimized(deinterleaved, samples_per_channel, num_channels,
+                      interleaved);
+}
+
+template <>
+void Interleave<float>(const float* const* deinterleaved,
+                       int samples_per_channel, int num_channels,
+                       float* interleaved) {
+  InterleaveOptimized(deinterleaved, samples_per_channel, num_channels,
+                      interleaved);
+}
+
 }  // namespace webrtc
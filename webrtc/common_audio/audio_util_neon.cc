@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/audio_util_neon.h"
+
+#include <arm_neon.h>
+
+#include "webrtc/common_audio/include/audio_util.h"
+
+namespace webrtc {
+
+namespace {
+
+// The same constants as the scalar versions, so that the results are
+// identical.
+const float kMaxInt16 = limits_int16::max();
+const float kMinInt16 = limits_int16::min();
+const float kMaxInt16Inverse = 1.f / limits_int16::max();
+const float kMinInt16Inverse = -1.f / limits_int16::min();
+
+// Rounds |x|, which must be within the int16 range, away from zero by
+// adding +-0.5 and truncating. The scalar versions round 0 with -0.5, which
+// gives the same result.
+int32x4_t RoundAwayFromZero(float32x4_t x, uint32x4_t positive) {
+  return vcvtq_s32_f32(vaddq_f32(
+      x, vbslq_f32(positive, vdupq_n_f32(0.5f), vdupq_n_f32(-0.5f))));
+}
+
+}  // namespace
+
+void RoundToInt16_NEON(const float* src, size_t size, int16_t* dest) {
+  const float32x4_t kMax = vdupq_n_f32(kMaxInt16);
+  const float32x4_t kMin = vdupq_n_f32(kMinInt16);
+  const float32x4_t kZero = vdupq_n_f32(0.f);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    // Clamp first, since the conversion to int32 saturates at the int32
+    // range only.
+    float32x4_t low = vminq_f32(vmaxq_f32(vld1q_f32(&src[i]), kMin), kMax);
+    float32x4_t high = vminq_f32(vmaxq_f32(vld1q_f32(&src[i + 4]), kMin),
+                                 kMax);
+    vst1q_s16(&dest[i], vcombine_s16(
+        vqmovn_s32(RoundAwayFromZero(low, vcgtq_f32(low, kZero))),
+        vqmovn_s32(RoundAwayFromZero(high, vcgtq_f32(high, kZero)))));
+  }
+  for (; i < size; ++i)
+    dest[i] = RoundToInt16(src[i]);
+}
+
+void ScaleAndRoundToInt16_NEON(const float* src, size_t size, int16_t* dest) {
+  const float32x4_t kOne = vdupq_n_f32(1.f);
+  const float32x4_t kMinusOne = vdupq_n_f32(-1.f);
+  const float32x4_t kPositiveScale = vdupq_n_f32(kMaxInt16);
+  const float32x4_t kNegativeScale = vdupq_n_f32(-kMinInt16);
+  const float32x4_t kZero = vdupq_n_f32(0.f);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    float32x4_t low = vminq_f32(vmaxq_f32(vld1q_f32(&src[i]), kMinusOne),
+                                kOne);
+    float32x4_t high = vminq_f32(
+        vmaxq_f32(vld1q_f32(&src[i + 4]), kMinusOne), kOne);
+    uint32x4_t low_positive = vcgtq_f32(low, kZero);
+    uint32x4_t high_positive = vcgtq_f32(high, kZero);
+    low = vmulq_f32(low, vbslq_f32(low_positive, kPositiveScale,
+                                   kNegativeScale));
+    high = vmulq_f32(high, vbslq_f32(high_positive, kPositiveScale,
+                                     kNegativeScale));
+    vst1q_s16(&dest[i], vcombine_s16(
+        vqmovn_s32(RoundAwayFromZero(low, low_positive)),
+        vqmovn_s32(RoundAwayFromZero(high, high_positive))));
+  }
+  for (; i < size; ++i)
+    dest[i] = ScaleAndRoundToInt16(src[i]);
+}
+
+void ScaleToFloat_NEON(const int16_t* src, size_t size, float* dest) {
+  const int32x4_t kZero = vdupq_n_s32(0);
+  const float32x4_t kPositiveScale = vdupq_n_f32(kMaxInt16Inverse);
+  const float32x4_t kNegativeScale = vdupq_n_f32(kMinInt16Inverse);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    int16x8_t x = vld1q_s16(&src[i]);
+    int32x4_t low = vmovl_s16(vget_low_s16(x));
+    int32x4_t high = vmovl_s16(vget_high_s16(x));
+    vst1q_f32(&dest[i], vmulq_f32(
+        vcvtq_f32_s32(low),
+        vbslq_f32(vcgtq_s32(low, kZero), kPositiveScale, kNegativeScale)));
+    vst1q_f32(&dest[i + 4], vmulq_f32(
+        vcvtq_f32_s32(high),
+        vbslq_f32(vcgtq_s32(high, kZero), kPositiveScale, kNegativeScale)));
+  }
+  for (; i < size; ++i)
+    dest[i] = ScaleToFloat(src[i]);
+}
+
+void FloatToFloatS16_NEON(const float* src, size_t size, float* dest) {
+  const float32x4_t kPositiveScale = vdupq_n_f32(kMaxInt16);
+  const float32x4_t kNegativeScale = vdupq_n_f32(-kMinInt16);
+  const float32x4_t kZero = vdupq_n_f32(0.f);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    float32x4_t x = vld1q_f32(&src[i]);
+    vst1q_f32(&dest[i], vmulq_f32(x, vbslq_f32(vcgtq_f32(x, kZero),
+                                               kPositiveScale,
+                                               kNegativeScale)));
+  }
+  for (; i < size; ++i)
+    dest[i] = FloatToFloatS16(src[i]);
+}
+
+void FloatS16ToFloat_NEON(const float* src, size_t size, float* dest) {
+  const float32x4_t kMax = vdupq_n_f32(kMaxInt16);
+  const float32x4_t kMin = vdupq_n_f32(kMinInt16);
+  const float32x4_t kOne = vdupq_n_f32(1.f);
+  const float32x4_t kMinusOne = vdupq_n_f32(-1.f);
+  const float32x4_t kPositiveScale = vdupq_n_f32(kMaxInt16Inverse);
+  const float32x4_t kNegativeScale = vdupq_n_f32(kMinInt16Inverse);
+  const float32x4_t kZero = vdupq_n_f32(0.f);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    float32x4_t x = vld1q_f32(&src[i]);
+    float32x4_t y = vmulq_f32(x, vbslq_f32(vcgtq_f32(x, kZero),
+                                           kPositiveScale, kNegativeScale));
+    // Clamp to exactly +-1, which the multiplication may not give.
+    y = vbslq_f32(vcgeq_f32(x, kMax), kOne, y);
+    y = vbslq_f32(vcleq_f32(x, kMin), kMinusOne, y);
+    vst1q_f32(&dest[i], y);
+  }
+  for (; i < size; ++i)
+    dest[i] = FloatS16ToFloat(src[i]);
+}
+
+void DeinterleaveStereo_NEON(const int16_t* interleaved,
+                             int samples_per_channel,
+                             int16_t* left,
+                             int16_t* right) {
+  int i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    int16x8x2_t x = vld2q_s16(&interleaved[2 * i]);
+    vst1q_s16(&left[i], x.val[0]);
+    vst1q_s16(&right[i], x.val[1]);
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void DeinterleaveStereo_NEON(const float* interleaved,
+                             int samples_per_channel,
+                             float* left,
+                             float* right) {
+  int i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    float32x4x2_t x = vld2q_f32(&interleaved[2 * i]);
+    vst1q_f32(&left[i], x.val[0]);
+    vst1q_f32(&right[i], x.val[1]);
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void InterleaveStereo_NEON(const int16_t* left,
+                           const int16_t* right,
+                           int samples_per_channel,
+                           int16_t* interleaved) {
+  int i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    int16x8x2_t x;
+    x.val[0] = vld1q_s16(&left[i]);
+    x.val[1] = vld1q_s16(&right[i]);
+    vst2q_s16(&interleaved[2 * i], x);
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+void InterleaveStereo_NEON(const float* left,
+                           const float* right,
+                           int samples_per_channel,
+                           float* interleaved) {
+  int i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    float32x4x2_t x;
+    x.val[0] = vld1q_f32(&left[i]);
+    x.val[1] = vld1q_f32(&right[i]);
+    vst2q_f32(&interleaved[2 * i], x);
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_AUDIO_UTIL_NEON_H_
+#define WEBRTC_COMMON_AUDIO_AUDIO_UTIL_NEON_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// NEON versions of the functions in audio_util.h, with identical results other
+// than for denormals, which NEON flushes to zero. Only called after checking
+// for NEON support, if needed.
+void RoundToInt16_NEON(const float* src, size_t size, int16_t* dest);
+void ScaleAndRoundToInt16_NEON(const float* src, size_t size, int16_t* dest);
+void ScaleToFloat_NEON(const int16_t* src, size_t size, float* dest);
+void FloatToFloatS16_NEON(const float* src, size_t size, float* dest);
+void FloatS16ToFloat_NEON(const float* src, size_t size, float* dest);
+
+// Deinterleave() and Interleave() of stereo.
+void DeinterleaveStereo_NEON(const int16_t* interleaved,
+                             int samples_per_channel,
+                             int16_t* left,
+                             int16_t* right);
+void DeinterleaveStereo_NEON(const float* interleaved,
+                             int samples_per_channel,
+                             float* left,
+                             float* right);
+void InterleaveStereo_NEON(const int16_t* left,
+                           const int16_t* right,
+                           int samples_per_channel,
+                           int16_t* interleaved);
+void InterleaveStereo_NEON(const float* left,
+                           const float* right,
+                           int samples_per_channel,
+                           float* interleaved);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_AUDIO_UTIL_NEON_H_
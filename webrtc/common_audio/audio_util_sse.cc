@@ -0,0 +1,305 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/audio_util_sse.h"
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/include/audio_util.h"
+
+namespace webrtc {
+
+namespace {
+
+// The same constants as the scalar versions, so that the results are
+// identical.
+const float kMaxInt16 = limits_int16::max();
+const float kMinInt16 = limits_int16::min();
+const float kMaxInt16Inverse = 1.f / limits_int16::max();
+const float kMinInt16Inverse = -1.f / limits_int16::min();
+
+bool IsAligned(const void* pointer) {
+  return (reinterpret_cast<uintptr_t>(pointer) & 0x0F) == 0;
+}
+
+template <bool kAligned>
+__m128 LoadFloats(const float* src) {
+  return kAligned ? _mm_load_ps(src) : _mm_loadu_ps(src);
+}
+
+template <bool kAligned>
+void StoreFloats(float* dest, __m128 x) {
+  if (kAligned)
+    _mm_store_ps(dest, x);
+  else
+    _mm_storeu_ps(dest, x);
+}
+
+template <bool kAligned>
+__m128i LoadInts(const int16_t* src) {
+  return kAligned ? _mm_load_si128(reinterpret_cast<const __m128i*>(src)) :
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+template <bool kAligned>
+void StoreInts(int16_t* dest, __m128i x) {
+  if (kAligned)
+    _mm_store_si128(reinterpret_cast<__m128i*>(dest), x);
+  else
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), x);
+}
+
+// Returns |if_true| where |mask| is set and |if_false| elsewhere.
+__m128 Select(__m128 mask, __m128 if_true, __m128 if_false) {
+  return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+}
+
+// Rounds |x|, which must be within the int16 range, away from zero by
+// adding +-0.5 and truncating. The scalar versions round 0 with -0.5, which
+// gives the same result.
+__m128i RoundAwayFromZero(__m128 x, __m128 positive) {
+  const __m128 kHalf = _mm_set1_ps(0.5f);
+  const __m128 kMinusHalf = _mm_set1_ps(-0.5f);
+  return _mm_cvttps_epi32(_mm_add_ps(x, Select(positive, kHalf, kMinusHalf)));
+}
+
+template <bool kAligned>
+size_t RoundToInt16Blocks(const float* src, size_t size, int16_t* dest) {
+  const __m128 kMax = _mm_set1_ps(kMaxInt16);
+  const __m128 kMin = _mm_set1_ps(kMinInt16);
+  const __m128 kZero = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    // Clamp first, since _mm_cvttps_epi32() doesn't saturate.
+    __m128 low = _mm_min_ps(_mm_max_ps(LoadFloats<kAligned>(&src[i]), kMin),
+                            kMax);
+    __m128 high = _mm_min_ps(
+        _mm_max_ps(LoadFloats<kAligned>(&src[i + 4]), kMin), kMax);
+    StoreInts<kAligned>(&dest[i], _mm_packs_epi32(
+        RoundAwayFromZero(low, _mm_cmpgt_ps(low, kZero)),
+        RoundAwayFromZero(high, _mm_cmpgt_ps(high, kZero))));
+  }
+  return i;
+}
+
+template <bool kAligned>
+size_t ScaleAndRoundToInt16Blocks(const float* src, size_t size,
+                                  int16_t* dest) {
+  const __m128 kOne = _mm_set1_ps(1.f);
+  const __m128 kMinusOne = _mm_set1_ps(-1.f);
+  const __m128 kPositiveScale = _mm_set1_ps(kMaxInt16);
+  const __m128 kNegativeScale = _mm_set1_ps(-kMinInt16);
+  const __m128 kZero = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m128 low = _mm_min_ps(
+        _mm_max_ps(LoadFloats<kAligned>(&src[i]), kMinusOne), kOne);
+    __m128 high = _mm_min_ps(
+        _mm_max_ps(LoadFloats<kAligned>(&src[i + 4]), kMinusOne), kOne);
+    __m128 low_positive = _mm_cmpgt_ps(low, kZero);
+    __m128 high_positive = _mm_cmpgt_ps(high, kZero);
+    low = _mm_mul_ps(low, Select(low_positive, kPositiveScale,
+                                 kNegativeScale));
+    high = _mm_mul_ps(high, Select(high_positive, kPositiveScale,
+                                   kNegativeScale));
+    StoreInts<kAligned>(&dest[i], _mm_packs_epi32(
+        RoundAwayFromZero(low, low_positive),
+        RoundAwayFromZero(high, high_positive)));
+  }
+  return i;
+}
+
+template <bool kAligned>
+size_t ScaleToFloatBlocks(const int16_t* src, size_t size, float* dest) {
+  const __m128i kZero = _mm_setzero_si128();
+  const __m128 kPositiveScale = _mm_set1_ps(kMaxInt16Inverse);
+  const __m128 kNegativeScale = _mm_set1_ps(kMinInt16Inverse);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m128i x = LoadInts<kAligned>(&src[i]);
+    __m128i positive = _mm_cmpgt_epi16(x, kZero);
+    // Sign extend to 32 bits.
+    __m128 low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+    __m128 high =
+        _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+    __m128 low_positive = _mm_castsi128_ps(_mm_unpacklo_epi16(positive,
+                                                              positive));
+    __m128 high_positive = _mm_castsi128_ps(_mm_unpackhi_epi16(positive,
+                                                               positive));
+    StoreFloats<kAligned>(&dest[i], _mm_mul_ps(
+        low, Select(low_positive, kPositiveScale, kNegativeScale)));
+    StoreFloats<kAligned>(&dest[i + 4], _mm_mul_ps(
+        high, Select(high_positive, kPositiveScale, kNegativeScale)));
+  }
+  return i;
+}
+
+template <bool kAligned>
+size_t FloatToFloatS16Blocks(const float* src, size_t size, float* dest) {
+  const __m128 kPositiveScale = _mm_set1_ps(kMaxInt16);
+  const __m128 kNegativeScale = _mm_set1_ps(-kMinInt16);
+  const __m128 kZero = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m128 x = LoadFloats<kAligned>(&src[i]);
+    StoreFloats<kAligned>(&dest[i], _mm_mul_ps(
+        x, Select(_mm_cmpgt_ps(x, kZero), kPositiveScale, kNegativeScale)));
+  }
+  return i;
+}
+
+template <bool kAligned>
+size_t FloatS16ToFloatBlocks(const float* src, size_t size, float* dest) {
+  const __m128 kMax = _mm_set1_ps(kMaxInt16);
+  const __m128 kMin = _mm_set1_ps(kMinInt16);
+  const __m128 kOne = _mm_set1_ps(1.f);
+  const __m128 kMinusOne = _mm_set1_ps(-1.f);
+  const __m128 kPositiveScale = _mm_set1_ps(kMaxInt16Inverse);
+  const __m128 kNegativeScale = _mm_set1_ps(kMinInt16Inverse);
+  const __m128 kZero = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m128 x = LoadFloats<kAligned>(&src[i]);
+    __m128 y = _mm_mul_ps(x, Select(_mm_cmpgt_ps(x, kZero), kPositiveScale,
+                                    kNegativeScale));
+    // Clamp to exactly +-1, which the multiplication may not give.
+    y = Select(_mm_cmpge_ps(x, kMax), kOne, y);
+    y = Select(_mm_cmple_ps(x, kMin), kMinusOne, y);
+    StoreFloats<kAligned>(&dest[i], y);
+  }
+  return i;
+}
+
+}  // namespace
+
+void RoundToInt16_SSE2(const float* src, size_t size, int16_t* dest) {
+  size_t i = IsAligned(src) && IsAligned(dest) ?
+      RoundToInt16Blocks<true>(src, size, dest) :
+      RoundToInt16Blocks<false>(src, size, dest);
+  for (; i < size; ++i)
+    dest[i] = RoundToInt16(src[i]);
+}
+
+void ScaleAndRoundToInt16_SSE2(const float* src, size_t size, int16_t* dest) {
+  size_t i = IsAligned(src) && IsAligned(dest) ?
+      ScaleAndRoundToInt16Blocks<true>(src, size, dest) :
+      ScaleAndRoundToInt16Blocks<false>(src, size, dest);
+  for (; i < size; ++i)
+    dest[i] = ScaleAndRoundToInt16(src[i]);
+}
+
+void ScaleToFloat_SSE2(const int16_t* src, size_t size, float* dest) {
+  size_t i = IsAligned(src) && IsAligned(dest) ?
+      ScaleToFloatBlocks<true>(src, size, dest) :
+      ScaleToFloatBlocks<false>(src, size, dest);
+  for (; i < size; ++i)
+    dest[i] = ScaleToFloat(src[i]);
+}
+
+void FloatToFloatS16_SSE2(const float* src, size_t size, float* dest) {
+  size_t i = IsAligned(src) && IsAligned(dest) ?
+      FloatToFloatS16Blocks<true>(src, size, dest) :
+      FloatToFloatS16Blocks<false>(src, size, dest);
+  for (; i < size; ++i)
+    dest[i] = FloatToFloatS16(src[i]);
+}
+
+void FloatS16ToFloat_SSE2(const float* src, size_t size, float* dest) {
+  size_t i = IsAligned(src) && IsAligned(dest) ?
+      FloatS16ToFloatBlocks<true>(src, size, dest) :
+      FloatS16ToFloatBlocks<false>(src, size, dest);
+  for (; i < size; ++i)
+    dest[i] = FloatS16ToFloat(src[i]);
+}
+
+void DeinterleaveStereo_SSE2(const int16_t* interleaved,
+                             int samples_per_channel,
+                             int16_t* left,
+                             int16_t* right) {
+  int i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    __m128i x0 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&interleaved[2 * i]));
+    __m128i x1 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&interleaved[2 * i + 8]));
+    // The left samples are the low halves of the 32-bit frames. Sign extend
+    // them, so that the saturating pack keeps them as they are.
+    __m128i left_samples = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_slli_epi32(x0, 16), 16),
+        _mm_srai_epi32(_mm_slli_epi32(x1, 16), 16));
+    __m128i right_samples = _mm_packs_epi32(_mm_srai_epi32(x0, 16),
+                                            _mm_srai_epi32(x1, 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&left[i]), left_samples);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&right[i]), right_samples);
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void DeinterleaveStereo_SSE2(const float* interleaved,
+                             int samples_per_channel,
+                             float* left,
+                             float* right) {
+  int i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    __m128 x0 = _mm_loadu_ps(&interleaved[2 * i]);
+    __m128 x1 = _mm_loadu_ps(&interleaved[2 * i + 4]);
+    _mm_storeu_ps(&left[i], _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(&right[i], _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void InterleaveStereo_SSE2(const int16_t* left,
+                           const int16_t* right,
+                           int samples_per_channel,
+                           int16_t* interleaved) {
+  int i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    __m128i left_samples =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&left[i]));
+    __m128i right_samples =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&right[i]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&interleaved[2 * i]),
+                     _mm_unpacklo_epi16(left_samples, right_samples));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&interleaved[2 * i + 8]),
+                     _mm_unpackhi_epi16(left_samples, right_samples));
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+void InterleaveStereo_SSE2(const float* left,
+                           const float* right,
+                           int samples_per_channel,
+                           float* interleaved) {
+  int i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    __m128 left_samples = _mm_loadu_ps(&left[i]);
+    __m128 right_samples = _mm_loadu_ps(&right[i]);
+    _mm_storeu_ps(&interleaved[2 * i],
+                  _mm_unpacklo_ps(left_samples, right_samples));
+    _mm_storeu_ps(&interleaved[2 * i + 4],
+                  _mm_unpackhi_ps(left_samples, right_samples));
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+}  // namespace webrtc
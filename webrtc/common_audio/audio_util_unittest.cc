@@ -58,6 +58,29 @@ TEST(AudioUtilTest, ScaleToFloat) {
   ExpectArraysEq(kReference, output, kSize);
 }
 
+TEST(AudioUtilTest, FloatToFloatS16) {
+  const int kSize = 7;
+  const float kInput[kSize] = {
+      0.f, 0.4f / 32767.f, -0.4f / 32768.f, 0.5f, -0.5f, 1.f, -1.f};
+  const float kReference[kSize] = {
+      0.f, 0.4f, -0.4f, 16383.5f, -16384.f, 32767.f, -32768.f};
+  float output[kSize];
+  FloatToFloatS16(kInput, kSize, output);
+  ExpectArraysEq(kReference, output, kSize);
+}
+
+TEST(AudioUtilTest, FloatS16ToFloat) {
+  const int kSize = 9;
+  const float kInput[kSize] = {
+      0.f, 0.4f, -0.4f, 16383.5f, -16384.f, 32767.f, -32768.f, 40000.f,
+      -40000.f};
+  const float kReference[kSize] = {
+      0.f, 0.4f / 32767.f, -0.4f / 32768.f, 0.5f, -0.5f, 1.f, -1.f, 1.f, -1.f};
+  float output[kSize];
+  FloatS16ToFloat(kInput, kSize, output);
+  ExpectArraysEq(kReference, output, kSize);
+}
+
 TEST(AudioUtilTest, InterleavingStereo) {
   const int16_t kInterleaved[] = {2, 3, 4, 9, 8, 27, 16, 81};
   const int kSamplesPerChannel = 4;
@@ -90,4 +113,93 @@ TEST(AudioUtilTest, InterleavingMonoIsIdentical) {
   ExpectArraysEq(mono, interleaved, kSamplesPerChannel);
 }
 
+// The vectorized versions must match the scalar conversion of every sample,
+// for every alignment and for lengths which aren't multiples of the vector
+// size.
+TEST(AudioUtilTest, VectorizedConversionsMatchScalar) {
+  const int kSize = 203;
+  float floats[kSize + 1];
+  float float_s16s[kSize + 1];
+  int16_t ints[kSize + 1];
+  for (int i = 0; i < kSize + 1; ++i) {
+    // Cover [-1.5, 1.5], including the limits and exact halves.
+    floats[i] = (i - kSize / 2) / (kSize / 3.f);
+    float_s16s[i] = floats[i] * 32768.f + (i % 2 ? 0.5f : 0.f);
+    ints[i] = static_cast<int16_t>((i - kSize / 2) * 323);
+  }
+  floats[0] = 1.f;
+  floats[1] = -1.f;
+  floats[2] = 0.f;
+  float_s16s[0] = 32767.f;
+  float_s16s[1] = -32768.f;
+  float_s16s[2] = 32766.5f;
+  float_s16s[3] = -32767.5f;
+  ints[0] = limits_int16::max();
+  ints[1] = limits_int16::min();
+  ints[2] = 0;
+
+  for (int offset = 0; offset <= 1; ++offset) {
+    for (int size = kSize - 8; size <= kSize; ++size) {
+      const float* float_src = floats + offset;
+      const float* float_s16_src = float_s16s + offset;
+      const int16_t* int_src = ints + offset;
+      int16_t int_output[kSize];
+      float float_output[kSize];
+
+      RoundToInt16(float_s16_src, size, int_output);
+      for (int i = 0; i < size; ++i)
+        EXPECT_EQ(RoundToInt16(float_s16_src[i]), int_output[i]);
+      ScaleAndRoundToInt16(float_src, size, int_output);
+      for (int i = 0; i < size; ++i)
+        EXPECT_EQ(ScaleAndRoundToInt16(float_src[i]), int_output[i]);
+      ScaleToFloat(int_src, size, float_output);
+      for (int i = 0; i < size; ++i)
+        EXPECT_EQ(ScaleToFloat(int_src[i]), float_output[i]);
+      FloatToFloatS16(float_src, size, float_output);
+      for (int i = 0; i < size; ++i)
+        EXPECT_EQ(FloatToFloatS16(float_src[i]), float_output[i]);
+      FloatS16ToFloat(float_s16_src, size, float_output);
+      for (int i = 0; i < size; ++i)
+        EXPECT_EQ(FloatS16ToFloat(float_s16_src[i]), float_output[i]);
+    }
+  }
+}
+
+// Stereo takes the vectorized path, so test lengths which aren't multiples of
+// the vector size, and three channels.
+template <typename T>
+void TestInterleavingRoundTrip(int samples_per_channel, int num_channels) {
+  const int kMaxChannels = 3;
+  const int kMaxSamplesPerChannel = 100;
+  T interleaved[kMaxChannels * kMaxSamplesPerChannel];
+  T channel_data[kMaxChannels][kMaxSamplesPerChannel];
+  T* deinterleaved[kMaxChannels];
+  const int length = samples_per_channel * num_channels;
+  for (int i = 0; i < length; ++i)
+    interleaved[i] = static_cast<T>(i * 131 - 16000);
+  for (int i = 0; i < num_channels; ++i)
+    deinterleaved[i] = channel_data[i];
+
+  Deinterleave(interleaved, samples_per_channel, num_channels, deinterleaved);
+  for (int i = 0; i < num_channels; ++i) {
+    for (int j = 0; j < samples_per_channel; ++j)
+      EXPECT_EQ(interleaved[j * num_channels + i], deinterleaved[i][j]);
+  }
+
+  T output[kMaxChannels * kMaxSamplesPerChannel];
+  Interleave(deinterleaved, samples_per_channel, num_channels, output);
+  for (int i = 0; i < length; ++i)
+    EXPECT_EQ(interleaved[i], output[i]);
+}
+
+TEST(AudioUtilTest, InterleavingRoundTrip) {
+  for (int samples_per_channel = 1; samples_per_channel <= 100;
+       samples_per_channel += 11) {
+    for (int num_channels = 1; num_channels <= 3; ++num_channels) {
+      TestInterleavingRoundTrip<int16_t>(samples_per_channel, num_channels);
+      TestInterleavingRoundTrip<float>(samples_per_channel, num_channels);
+    }
+  }
+}
+
 }  // namespace webrtc
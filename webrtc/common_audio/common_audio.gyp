@@ -30,11 +30,17 @@
       },
       'sources': [
         'audio_util.cc',
+        'audio_util_neon.h',
+        'audio_util_sse.h',
         'fir_filter.cc',
         'fir_filter.h',
+        'fir_filter_avx.h',
         'fir_filter_neon.h',
         'fir_filter_sse.h',
         'include/audio_util.h',
+        'real_fourier.c',
+        'real_fourier.h',
+        'real_fourier_internal.h',
         'resampler/include/push_resampler.h',
         'resampler/include/resampler.h',
         'resampler/push_resampler.cc',
@@ -95,7 +101,11 @@
       ],
       'conditions': [
         ['target_arch=="ia32" or target_arch=="x64"', {
-          'dependencies': ['common_audio_sse2',],
+          'dependencies': [
+            'common_audio_avx',
+            'common_audio_avx2',
+            'common_audio_sse2',
+          ],
         }],
         ['target_arch=="arm" or target_arch=="armv7"', {
           'sources': [
@@ -156,14 +166,49 @@
           'target_name': 'common_audio_sse2',
           'type': 'static_library',
           'sources': [
+            'audio_util_sse.cc',
             'fir_filter_sse.cc',
+            'real_fourier_sse2.c',
             'resampler/sinc_resampler_sse.cc',
+            'signal_processing/cross_correlation_sse2.c',
+            'signal_processing/dot_product_with_scale_sse2.c',
+            'signal_processing/downsample_fast_sse2.c',
+            'signal_processing/filter_ma_fast_q12_sse2.c',
+            'signal_processing/min_max_operations_sse2.c',
+            'signal_processing/vector_scaling_operations_sse2.c',
+            'vad/vad_filterbank_sse2.c',
           ],
           'cflags': ['-msse2',],
           'xcode_settings': {
             'OTHER_CFLAGS': ['-msse2',],
           },
         },
+        {
+          # Only called after checking for AVX and FMA support at run time.
+          'target_name': 'common_audio_avx',
+          'type': 'static_library',
+          'sources': [
+            'fir_filter_avx.cc',
+            'resampler/sinc_resampler_avx.cc',
+          ],
+          'cflags': ['-mavx', '-mfma',],
+          'xcode_settings': {
+            'OTHER_CFLAGS': ['-mavx', '-mfma',],
+          },
+        },
+        {
+          # Only called after checking for AVX2 support at run time.
+          'target_name': 'common_audio_avx2',
+          'type': 'static_library',
+          'sources': [
+            'signal_processing/cross_correlation_avx2.c',
+            'signal_processing/min_max_operations_avx2.c',
+          ],
+          'cflags': ['-mavx2',],
+          'xcode_settings': {
+            'OTHER_CFLAGS': ['-mavx2',],
+          },
+        },
       ],  # targets
     }],
     ['(target_arch=="arm" and arm_version==7) or target_arch=="armv7"', {
@@ -173,6 +218,7 @@
           'type': 'static_library',
           'includes': ['../build/arm_neon.gypi',],
           'sources': [
+            'audio_util_neon.cc',
             'fir_filter_neon.cc',
             'resampler/sinc_resampler_neon.cc',
             'signal_processing/cross_correlation_neon.S',
@@ -197,6 +243,7 @@
           'sources': [
             'audio_util_unittest.cc',
             'fir_filter_unittest.cc',
+            'real_fourier_unittest.cc',
             'resampler/resampler_unittest.cc',
             'resampler/push_resampler_unittest.cc',
             'resampler/push_sinc_resampler_unittest.cc',
@@ -222,8 +269,48 @@
             }],
           ],
         },
+        {
+          'target_name': 'push_resampler_benchmark',
+          'type': 'executable',
+          'dependencies': [
+            'common_audio',
+            '<(webrtc_root)/system_wrappers/source/system_wrappers.gyp:system_wrappers',
+            '<(DEPTH)/third_party/gflags/gflags.gyp:gflags',
+          ],
+          'sources': [
+            'resampler/push_resampler_benchmark.cc',
+          ],
+        },
+        {
+          'target_name': 'real_fourier_benchmark',
+          'type': 'executable',
+          'dependencies': [
+            'common_audio',
+            '<(webrtc_root)/system_wrappers/source/system_wrappers.gyp:system_wrappers',
+            '<(DEPTH)/third_party/gflags/gflags.gyp:gflags',
+          ],
+          'sources': [
+            'real_fourier_benchmark.cc',
+          ],
+        },
       ],  # targets
       'conditions': [
+        ['target_arch=="ia32" or target_arch=="x64"', {
+          'targets': [
+            {
+              'target_name': 'spl_benchmark',
+              'type': 'executable',
+              'dependencies': [
+                'common_audio',
+                '<(webrtc_root)/system_wrappers/source/system_wrappers.gyp:system_wrappers',
+                '<(DEPTH)/third_party/gflags/gflags.gyp:gflags',
+              ],
+              'sources': [
+                'signal_processing/spl_benchmark.cc',
+              ],
+            },
+          ],
+        }],
         # TODO(henrike): remove build_with_chromium==1 when the bots are using
         # Chromium's buildbots.
         ['build_with_chromium==1 and OS=="android"', {
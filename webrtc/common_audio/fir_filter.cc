@@ -13,8 +13,12 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
+
+#include "webrtc/common_audio/fir_filter_avx.h"
 #include "webrtc/common_audio/fir_filter_neon.h"
 #include "webrtc/common_audio/fir_filter_sse.h"
+#include "webrtc/system_wrappers/interface/aligned_malloc.h"
 #include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
 
@@ -34,6 +38,145 @@ class FIRFilterC : public FIRFilter {
   scoped_ptr<float[]> state_;
 };
 
+namespace {
+
+// Computes |length| outputs from the |length| + |coefficients_length| - 1
+// samples of |in|, with the coefficients in reverse order.
+typedef void (*FilterBlockFunction)(const float* in,
+                                    const float* coefficients,
+                                    size_t coefficients_length,
+                                    size_t length,
+                                    float* out);
+
+void FIRFilterBlockC(const float* in,
+                     const float* coefficients,
+                     size_t coefficients_length,
+                     size_t length,
+                     float* out) {
+  for (size_t i = 0; i < length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < coefficients_length; ++j) {
+      sum += in[i + j] * coefficients[j];
+    }
+    out[i] = sum;
+  }
+}
+
+// Picks the fastest version the CPU supports. They all accept coefficient
+// lengths which are multiples of eight and coefficients aligned on 32 bytes.
+FilterBlockFunction SelectFilterBlock() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // AVX is not part of any baseline we build for, so it is always detected.
+  if (WebRtc_GetCPUInfo(kAVX) && WebRtc_GetCPUInfo(kFMA)) {
+    return FIRFilterBlockAVX;
+  }
+  return WebRtc_GetCPUInfo(kSSE2) ? FIRFilterBlockSSE2 : FIRFilterBlockC;
+#elif defined(WEBRTC_ARCH_ARM_V7)
+#if defined(WEBRTC_ARCH_ARM_NEON)
+  return FIRFilterBlockNEON;
+#else
+  return (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) ? FIRFilterBlockNEON :
+                                                          FIRFilterBlockC;
+#endif
+#else
+  return FIRFilterBlockC;
+#endif
+}
+
+// The largest number of samples written to the circular buffers before they
+// are filtered.
+const size_t kMaxBlockLength = 512;
+
+class MultiChannelFIRFilterImpl : public MultiChannelFIRFilter {
+ public:
+  MultiChannelFIRFilterImpl(const float* coefficients,
+                            size_t coefficients_length,
+                            int num_channels);
+
+  virtual void Filter(const float* const* in,
+                      size_t length,
+                      float* const* out) OVERRIDE;
+
+ private:
+  const FilterBlockFunction filter_block_;
+  // Padded to a multiple of eight.
+  const size_t coefficients_length_;
+  const size_t buffer_length_;
+  const int num_channels_;
+  scoped_ptr<float[], AlignedFreeDeleter> coefficients_;
+  // The circular buffers of |buffer_length_| samples of all channels, with
+  // |write_index_| the position of the next sample. The first
+  // |coefficients_length_| samples are repeated after the end, so that the
+  // samples of every output are contiguous.
+  scoped_ptr<float[], AlignedFreeDeleter> buffers_;
+  size_t write_index_;
+};
+
+MultiChannelFIRFilterImpl::MultiChannelFIRFilterImpl(
+    const float* coefficients,
+    size_t coefficients_length,
+    int num_channels)
+    : filter_block_(SelectFilterBlock()),
+      coefficients_length_((coefficients_length + 7) & ~0x07),
+      buffer_length_(coefficients_length_ + kMaxBlockLength),
+      num_channels_(num_channels),
+      coefficients_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * coefficients_length_, 32))),
+      buffers_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * (buffer_length_ +
+                                         coefficients_length_) * num_channels_,
+                        32))),
+      write_index_(0) {
+  // The coefficients are reversed, and padded with zeros for the oldest
+  // samples.
+  size_t padding = coefficients_length_ - coefficients_length;
+  memset(coefficients_.get(), 0, padding * sizeof(coefficients_[0]));
+  for (size_t i = 0; i < coefficients_length; ++i) {
+    coefficients_[i + padding] = coefficients[coefficients_length - i - 1];
+  }
+  memset(buffers_.get(), 0, (buffer_length_ + coefficients_length_) *
+         num_channels_ * sizeof(buffers_[0]));
+}
+
+void MultiChannelFIRFilterImpl::Filter(const float* const* in,
+                                       size_t length,
+                                       float* const* out) {
+  assert(length > 0);
+
+  for (size_t done = 0; done < length; done += kMaxBlockLength) {
+    const size_t block_length = std::min(length - done, kMaxBlockLength);
+    // Where the samples of the first output start. The outputs are computed
+    // in one run until that position wraps around, and in a second run after.
+    const size_t start = (write_index_ + buffer_length_ - coefficients_length_ +
+                          1) % buffer_length_;
+    const size_t first_run = std::min(block_length, buffer_length_ - start);
+
+    for (int ch = 0; ch < num_channels_; ++ch) {
+      float* buffer = &buffers_[(buffer_length_ + coefficients_length_) * ch];
+      const float* block_in = &in[ch][done];
+      float* block_out = &out[ch][done];
+      const size_t end_part =
+          std::min(block_length, buffer_length_ - write_index_);
+      memcpy(&buffer[write_index_], block_in, end_part * sizeof(*block_in));
+      memcpy(buffer, &block_in[end_part],
+             (block_length - end_part) * sizeof(*block_in));
+      if (write_index_ < coefficients_length_ || end_part < block_length) {
+        memcpy(&buffer[buffer_length_], buffer,
+               coefficients_length_ * sizeof(buffer[0]));
+      }
+      filter_block_(&buffer[start], coefficients_.get(), coefficients_length_,
+                    first_run, block_out);
+      if (first_run < block_length) {
+        filter_block_(buffer, coefficients_.get(), coefficients_length_,
+                      block_length - first_run, &block_out[first_run]);
+      }
+    }
+    write_index_ = (write_index_ + block_length) % buffer_length_;
+  }
+}
+
+}  // namespace
+
 FIRFilter* FIRFilter::Create(const float* coefficients,
                              size_t coefficients_length,
                              size_t max_input_length) {
@@ -45,6 +188,11 @@ FIRFilter* FIRFilter::Create(const float* coefficients,
   FIRFilter* filter = NULL;
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
+  // AVX is not part of any baseline we build for, so it is always detected.
+  if (WebRtc_GetCPUInfo(kAVX) && WebRtc_GetCPUInfo(kFMA)) {
+    return new FIRFilterAVX(coefficients, coefficients_length,
+                            max_input_length);
+  }
 #if defined(__SSE2__)
   filter =
       new FIRFilterSSE2(coefficients, coefficients_length, max_input_length);
@@ -116,4 +264,16 @@ void FIRFilterC::Filter(const float* in, size_t length, float* out) {
   }
 }
 
+MultiChannelFIRFilter* MultiChannelFIRFilter::Create(
+    const float* coefficients,
+    size_t coefficients_length,
+    int num_channels) {
+  if (!coefficients || coefficients_length <= 0 || num_channels <= 0) {
+    assert(false);
+    return NULL;
+  }
+  return new MultiChannelFIRFilterImpl(coefficients, coefficients_length,
+                                       num_channels);
+}
+
 }  // namespace webrtc
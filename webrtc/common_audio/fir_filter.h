@@ -35,6 +35,28 @@ class FIRFilter {
   virtual void Filter(const float* in, size_t length, float* out) = 0;
 };
 
+// Filters several channels with the same coefficients. The history of each
+// channel is kept in a circular buffer with its start repeated after its end,
+// so that the samples of every output are contiguous and no state is moved
+// between calls. The chunks can be of any length.
+class MultiChannelFIRFilter {
+ public:
+  // Creates a filter of |num_channels| channels with the given coefficients.
+  // All initial state values will be zeros.
+  static MultiChannelFIRFilter* Create(const float* coefficients,
+                                       size_t coefficients_length,
+                                       int num_channels);
+
+  virtual ~MultiChannelFIRFilter() {}
+
+  // Filters the |length| samples of each of the channels in |in|. |out| must
+  // have the same number of channels, of at least |length| samples each, and
+  // may be the same as |in|.
+  virtual void Filter(const float* const* in,
+                      size_t length,
+                      float* const* out) = 0;
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_COMMON_AUDIO_FIR_FILTER_H_
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/fir_filter_avx.h"
+
+#include <assert.h>
+#include <immintrin.h>
+#include <string.h>
+
+#include "webrtc/system_wrappers/interface/aligned_malloc.h"
+
+namespace webrtc {
+
+FIRFilterAVX::FIRFilterAVX(const float* coefficients,
+                           size_t coefficients_length,
+                           size_t max_input_length)
+    :  // Closest higher multiple of eight.
+      coefficients_length_((coefficients_length + 7) & ~0x07),
+      state_length_(coefficients_length_ - 1),
+      coefficients_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * coefficients_length_, 32))),
+      state_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * (max_input_length + state_length_),
+                        32))) {
+  // Add zeros at the end of the coefficients.
+  size_t padding = coefficients_length_ - coefficients_length;
+  memset(coefficients_.get(), 0.f, padding * sizeof(coefficients_[0]));
+  // The coefficients are reversed to compensate for the order in which the
+  // input samples are acquired (most recent last).
+  for (size_t i = 0; i < coefficients_length; ++i) {
+    coefficients_[i + padding] = coefficients[coefficients_length - i - 1];
+  }
+  memset(state_.get(),
+         0.f,
+         (max_input_length + state_length_) * sizeof(state_[0]));
+}
+
+void FIRFilterAVX::Filter(const float* in, size_t length, float* out) {
+  assert(length > 0);
+
+  memcpy(&state_[state_length_], in, length * sizeof(*in));
+
+  // Convolves the input signal |in| with the filter kernel |coefficients_|
+  // taking into account the previous state.
+  FIRFilterBlockAVX(state_.get(), coefficients_.get(), coefficients_length_,
+                    length, out);
+
+  // Update current state.
+  memmove(state_.get(), &state_[length], state_length_ * sizeof(state_[0]));
+}
+
+void FIRFilterBlockAVX(const float* in,
+                       const float* coefficients,
+                       size_t coefficients_length,
+                       size_t length,
+                       float* out) {
+  for (size_t i = 0; i < length; ++i) {
+    const float* in_ptr = &in[i];
+
+    // Unaligned loads are as fast as aligned ones on AVX capable CPUs when the
+    // data happens to be aligned, so |in_ptr| needs no special casing.
+    __m256 m_sum = _mm256_setzero_ps();
+    for (size_t j = 0; j < coefficients_length; j += 8) {
+      m_sum = _mm256_fmadd_ps(_mm256_loadu_ps(in_ptr + j),
+                              _mm256_load_ps(coefficients + j), m_sum);
+    }
+
+    // Sum components together.
+    __m128 m_sum4 = _mm_add_ps(_mm256_castps256_ps128(m_sum),
+                               _mm256_extractf128_ps(m_sum, 1));
+    m_sum4 = _mm_add_ps(_mm_movehl_ps(m_sum4, m_sum4), m_sum4);
+    _mm_store_ss(out + i,
+                 _mm_add_ss(m_sum4, _mm_shuffle_ps(m_sum4, m_sum4, 1)));
+  }
+
+  // Avoid the AVX to SSE transition penalty in the caller.
+  _mm256_zeroupper();
+}
+
+}  // namespace webrtc
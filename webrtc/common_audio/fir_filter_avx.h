@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_FIR_FILTER_AVX_H_
+#define WEBRTC_COMMON_AUDIO_FIR_FILTER_AVX_H_
+
+#include "webrtc/common_audio/fir_filter.h"
+#include "webrtc/system_wrappers/interface/aligned_malloc.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+// Requires both AVX and FMA; see FIRFilter::Create().
+class FIRFilterAVX : public FIRFilter {
+ public:
+  FIRFilterAVX(const float* coefficients,
+               size_t coefficients_length,
+               size_t max_input_length);
+
+  virtual void Filter(const float* in, size_t length, float* out) OVERRIDE;
+
+ private:
+  size_t coefficients_length_;
+  size_t state_length_;
+  scoped_ptr<float[], AlignedFreeDeleter> coefficients_;
+  scoped_ptr<float[], AlignedFreeDeleter> state_;
+};
+
+// Computes |length| outputs from the |length| + |coefficients_length| - 1
+// samples of |in|, with the coefficients in reverse order.
+// |coefficients_length| must be a multiple of eight and |coefficients|
+// must be 32-byte aligned.
+void FIRFilterBlockAVX(const float* in,
+                       const float* coefficients,
+                       size_t coefficients_length,
+                       size_t length,
+                       float* out);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_FIR_FILTER_AVX_H_
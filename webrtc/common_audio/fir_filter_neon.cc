@@ -49,24 +49,32 @@ void FIRFilterNEON::Filter(const float* in, size_t length, float* out) {
 
   // Convolves the input signal |in| with the filter kernel |coefficients_|
   // taking into account the previous state.
+  FIRFilterBlockNEON(state_.get(), coefficients_.get(), coefficients_length_,
+                     length, out);
+
+  // Update current state.
+  memmove(state_.get(), &state_[length], state_length_ * sizeof(state_[0]));
+}
+
+void FIRFilterBlockNEON(const float* in,
+                        const float* coefficients,
+                        size_t coefficients_length,
+                        size_t length,
+                        float* out) {
   for (size_t i = 0; i < length; ++i) {
-    float* in_ptr = &state_[i];
-    float* coef_ptr = coefficients_.get();
+    const float* in_ptr = &in[i];
 
     float32x4_t m_sum = vmovq_n_f32(0);
     float32x4_t m_in;
 
-    for (size_t j = 0; j < coefficients_length_; j += 4) {
+    for (size_t j = 0; j < coefficients_length; j += 4) {
        m_in = vld1q_f32(in_ptr + j);
-       m_sum = vmlaq_f32(m_sum, m_in, vld1q_f32(coef_ptr + j));
+       m_sum = vmlaq_f32(m_sum, m_in, vld1q_f32(coefficients + j));
     }
 
     float32x2_t m_half = vadd_f32(vget_high_f32(m_sum), vget_low_f32(m_sum));
     out[i] = vget_lane_f32(vpadd_f32(m_half, m_half), 0);
   }
-
-  // Update current state.
-  memmove(state_.get(), &state_[length], state_length_ * sizeof(state_[0]));
 }
 
 }  // namespace webrtc
@@ -49,9 +49,20 @@ void FIRFilterSSE2::Filter(const float* in, size_t length, float* out) {
 
   // Convolves the input signal |in| with the filter kernel |coefficients_|
   // taking into account the previous state.
+  FIRFilterBlockSSE2(state_.get(), coefficients_.get(), coefficients_length_,
+                     length, out);
+
+  // Update current state.
+  memmove(state_.get(), &state_[length], state_length_ * sizeof(state_[0]));
+}
+
+void FIRFilterBlockSSE2(const float* in,
+                        const float* coefficients,
+                        size_t coefficients_length,
+                        size_t length,
+                        float* out) {
   for (size_t i = 0; i < length; ++i) {
-    float* in_ptr = &state_[i];
-    float* coef_ptr = coefficients_.get();
+    const float* in_ptr = &in[i];
 
     __m128 m_sum = _mm_setzero_ps();
     __m128 m_in;
@@ -59,22 +70,21 @@ void FIRFilterSSE2::Filter(const float* in, size_t length, float* out) {
     // Depending on if the pointer is aligned with 16 bytes or not it is loaded
     // differently.
     if (reinterpret_cast<uintptr_t>(in_ptr) & 0x0F) {
-      for (size_t j = 0; j < coefficients_length_; j += 4) {
+      for (size_t j = 0; j < coefficients_length; j += 4) {
         m_in = _mm_loadu_ps(in_ptr + j);
-        m_sum = _mm_add_ps(m_sum, _mm_mul_ps(m_in, _mm_load_ps(coef_ptr + j)));
+        m_sum = _mm_add_ps(m_sum,
+                           _mm_mul_ps(m_in, _mm_load_ps(coefficients + j)));
       }
     } else {
-      for (size_t j = 0; j < coefficients_length_; j += 4) {
+      for (size_t j = 0; j < coefficients_length; j += 4) {
         m_in = _mm_load_ps(in_ptr + j);
-        m_sum = _mm_add_ps(m_sum, _mm_mul_ps(m_in, _mm_load_ps(coef_ptr + j)));
+        m_sum = _mm_add_ps(m_sum,
+                           _mm_mul_ps(m_in, _mm_load_ps(coefficients + j)));
       }
     }
     m_sum = _mm_add_ps(_mm_movehl_ps(m_sum, m_sum), m_sum);
     _mm_store_ss(out + i, _mm_add_ss(m_sum, _mm_shuffle_ps(m_sum, m_sum, 1)));
   }
-
-  // Update current state.
-  memmove(state_.get(), &state_[length], state_length_ * sizeof(state_[0]));
 }
 
 }  // namespace webrtc
@@ -32,6 +32,16 @@ class FIRFilterSSE2 : public FIRFilter {
   scoped_ptr<float[], AlignedFreeDeleter> state_;
 };
 
+// Computes |length| outputs from the |length| + |coefficients_length| - 1
+// samples of |in|, with the coefficients in reverse order.
+// |coefficients_length| must be a multiple of four and |coefficients|
+// must be 16-byte aligned.
+void FIRFilterBlockSSE2(const float* in,
+                        const float* coefficients,
+                        size_t coefficients_length,
+                        size_t length,
+                        float* out);
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_COMMON_AUDIO_FIR_FILTER_SSE_H_
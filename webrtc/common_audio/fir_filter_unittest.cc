@@ -10,10 +10,18 @@
 
 #include "webrtc/common_audio/fir_filter.h"
 
+#include <math.h>
+#include <stdio.h>
 #include <string.h>
 
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_audio/fir_filter_avx.h"
+#include "webrtc/system_wrappers/interface/aligned_malloc.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 namespace webrtc {
 
@@ -204,4 +212,179 @@ TEST(FIRFilterTest, SameOutputWhenSwapedCoefficientsAndInput) {
   }
 }
 
+// Fills the channels with different sums of sinusoids.
+void FillChannels(int num_channels, size_t length,
+                  std::vector<std::vector<float> >* channels) {
+  channels->resize(num_channels);
+  for (int ch = 0; ch < num_channels; ++ch) {
+    (*channels)[ch].resize(length);
+    for (size_t i = 0; i < length; ++i) {
+      (*channels)[ch][i] = static_cast<float>(
+          1000 * sin(0.01 * (ch + 1) * i) + 300 * cos(0.7 * i + ch));
+    }
+  }
+}
+
+// A low pass filter of |length| taps: a Hamming window of unit sum.
+std::vector<float> LowPassCoefficients(size_t length) {
+  std::vector<float> coefficients(length);
+  for (size_t i = 0; i < length; ++i) {
+    coefficients[i] = static_cast<float>(
+        0.54 - 0.46 * cos(2 * 3.14159265358979 * i / (length - 1))) / length;
+  }
+  return coefficients;
+}
+
+TEST(FIRFilterTest, MultiChannelMatchesOneFilterPerChannel) {
+  const int kNumChannels = 3;
+  // Includes a chunk longer than the blocks the filter works on.
+  const size_t kChunkLengths[] = {1, 5, 37, 160, 2, 700, 80};
+  const size_t kNumChunks = sizeof(kChunkLengths) / sizeof(kChunkLengths[0]);
+  const size_t kMaxChunkLength = 700;
+  const std::vector<float> coefficients = LowPassCoefficients(37);
+  std::vector<std::vector<float> > input;
+  FillChannels(kNumChannels, 1200, &input);
+
+  scoped_ptr<MultiChannelFIRFilter> multi_channel_filter(
+      MultiChannelFIRFilter::Create(&coefficients[0], coefficients.size(),
+                                    kNumChannels));
+  scoped_ptr<FIRFilter> filters[kNumChannels];
+  for (int ch = 0; ch < kNumChannels; ++ch) {
+    filters[ch].reset(FIRFilter::Create(&coefficients[0], coefficients.size(),
+                                        kMaxChunkLength));
+  }
+
+  size_t position = 0;
+  for (size_t chunk = 0; chunk < kNumChunks; ++chunk) {
+    const size_t length = kChunkLengths[chunk];
+    const float* in[kNumChannels];
+    float output[kNumChannels][kMaxChunkLength];
+    float* out[kNumChannels];
+    for (int ch = 0; ch < kNumChannels; ++ch) {
+      in[ch] = &input[ch][position];
+      out[ch] = output[ch];
+    }
+    multi_channel_filter->Filter(in, length, out);
+
+    for (int ch = 0; ch < kNumChannels; ++ch) {
+      float expected[kMaxChunkLength];
+      filters[ch]->Filter(in[ch], length, expected);
+      for (size_t i = 0; i < length; ++i) {
+        EXPECT_NEAR(expected[i], output[ch][i], 1e-3f)
+            << "channel " << ch << ", sample " << position + i;
+      }
+    }
+    position += length;
+  }
+}
+
+TEST(FIRFilterTest, MultiChannelFiltersInPlace) {
+  const int kNumChannels = 2;
+  const size_t kLength = 100;
+  std::vector<std::vector<float> > data;
+  FillChannels(kNumChannels, kLength, &data);
+  std::vector<std::vector<float> > expected(data);
+
+  scoped_ptr<MultiChannelFIRFilter> filter(MultiChannelFIRFilter::Create(
+      kCoefficients, kCoefficientsLength, kNumChannels));
+  float* channels[kNumChannels] = {&data[0][0], &data[1][0]};
+  filter->Filter(channels, kLength, channels);
+
+  for (int ch = 0; ch < kNumChannels; ++ch) {
+    scoped_ptr<FIRFilter> reference(FIRFilter::Create(
+        kCoefficients, kCoefficientsLength, kLength));
+    reference->Filter(&expected[ch][0], kLength, &expected[ch][0]);
+    for (size_t i = 0; i < kLength; ++i) {
+      EXPECT_NEAR(expected[ch][i], data[ch][i], 1e-3f);
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Ensure FIRFilterBlockAVX() matches a plain convolution for every input
+// alignment.
+TEST(FIRFilterTest, FilterBlockAVX) {
+  if (!WebRtc_GetCPUInfo(kAVX) || !WebRtc_GetCPUInfo(kFMA)) {
+    printf("Skipping test, AVX and FMA are not supported.\n");
+    return;
+  }
+
+  const size_t kLength = 40;
+  const size_t kOutputLength = 11;
+  scoped_ptr<float, AlignedFreeDeleter> coefficients(
+      static_cast<float*>(AlignedMalloc(kLength * sizeof(float), 32)));
+  float in[kLength + kOutputLength + 8];
+  for (size_t i = 0; i < kLength; ++i) {
+    coefficients.get()[i] = 0.01f * (i % 7) - 0.02f;
+  }
+  for (size_t i = 0; i < sizeof(in) / sizeof(in[0]); ++i) {
+    in[i] = static_cast<float>(sin(0.3 * i));
+  }
+  for (int offset = 0; offset < 8; ++offset) {
+    float out[kOutputLength];
+    FIRFilterBlockAVX(in + offset, coefficients.get(), kLength, kOutputLength,
+                      out);
+    for (size_t i = 0; i < kOutputLength; ++i) {
+      double expected = 0;
+      for (size_t j = 0; j < kLength; ++j) {
+        expected += in[offset + i + j] * coefficients.get()[j];
+      }
+      EXPECT_NEAR(expected, out[i], 1e-5) << "offset " << offset;
+    }
+  }
+}
+#endif
+
+// Compares the throughput of one FIRFilter per channel with the one of a
+// MultiChannelFIRFilter, for 10 ms chunks at 48 kHz.
+TEST(FIRFilterTest, DISABLED_Benchmark) {
+  const int kNumChannels = 8;
+  const size_t kChunkLength = 480;
+  const int kNumChunks = 2000;
+  const size_t kTapCounts[] = {16, 64, 128};
+
+  std::vector<std::vector<float> > input;
+  FillChannels(kNumChannels, kChunkLength, &input);
+  std::vector<std::vector<float> > output(input);
+  const float* in[kNumChannels];
+  float* out[kNumChannels];
+  for (int ch = 0; ch < kNumChannels; ++ch) {
+    in[ch] = &input[ch][0];
+    out[ch] = &output[ch][0];
+  }
+
+  printf("Filtering %d chunks of %d channels:\n", kNumChunks, kNumChannels);
+  for (size_t t = 0; t < sizeof(kTapCounts) / sizeof(kTapCounts[0]); ++t) {
+    const std::vector<float> coefficients = LowPassCoefficients(kTapCounts[t]);
+
+    scoped_ptr<FIRFilter> filters[kNumChannels];
+    for (int ch = 0; ch < kNumChannels; ++ch) {
+      filters[ch].reset(FIRFilter::Create(&coefficients[0],
+                                          coefficients.size(), kChunkLength));
+    }
+    TickTime start = TickTime::Now();
+    for (int i = 0; i < kNumChunks; ++i) {
+      for (int ch = 0; ch < kNumChannels; ++ch) {
+        filters[ch]->Filter(in[ch], kChunkLength, out[ch]);
+      }
+    }
+    double single_us = (TickTime::Now() - start).Microseconds();
+
+    scoped_ptr<MultiChannelFIRFilter> multi_channel_filter(
+        MultiChannelFIRFilter::Create(&coefficients[0], coefficients.size(),
+                                      kNumChannels));
+    start = TickTime::Now();
+    for (int i = 0; i < kNumChunks; ++i) {
+      multi_channel_filter->Filter(in, kChunkLength, out);
+    }
+    double multi_us = (TickTime::Now() - start).Microseconds();
+
+    const double samples = static_cast<double>(kNumChunks) * kChunkLength *
+        kNumChannels;
+    printf("%3d taps: FIRFilter %.1f Msamples/s, MultiChannelFIRFilter "
+           "%.1f Msamples/s\n", static_cast<int>(kTapCounts[t]),
+           samples / single_us, samples / multi_us);
+  }
+}
+
 }  // namespace webrtc
@@ -46,6 +46,20 @@ static inline float ScaleToFloat(int16_t v) {
   return v * (v > 0 ? kMaxInt16Inverse : -kMinInt16Inverse);
 }
 
+// Scale from [-1, 1] to the int16 range, without rounding.
+static inline float FloatToFloatS16(float v) {
+  return v > 0 ? v * limits_int16::max() : -v * limits_int16::min();
+}
+
+// Scale from the int16 range to float [-1, 1] with clamping.
+static inline float FloatS16ToFloat(float v) {
+  const float kMaxInt16Inverse = 1.f / limits_int16::max();
+  const float kMinInt16Inverse = 1.f / limits_int16::min();
+  if (v > 0)
+    return v >= limits_int16::max() ? 1.f : v * kMaxInt16Inverse;
+  return v <= limits_int16::min() ? -1.f : -v * kMinInt16Inverse;
+}
+
 // Round |size| elements of |src| to int16 with clamping and write to |dest|.
 void RoundToInt16(const float* src, size_t size, int16_t* dest);
 
@@ -56,6 +70,14 @@ void ScaleAndRoundToInt16(const float* src, size_t size, int16_t* dest);
 // Scale |size| elements of |src| to float [-1, 1] and write to |dest|.
 void ScaleToFloat(const int16_t* src, size_t size, float* dest);
 
+// Scale |size| elements of |src| from [-1, 1] to the int16 range, keeping
+// them as float, and write to |dest|.
+void FloatToFloatS16(const float* src, size_t size, float* dest);
+
+// Scale |size| elements of |src| from the int16 range to float [-1, 1] with
+// clamping and write to |dest|.
+void FloatS16ToFloat(const float* src, size_t size, float* dest);
+
 // Deinterleave audio from |interleaved| to the channel buffers pointed to
 // by |deinterleaved|. There must be sufficient space allocated in the
 // |deinterleaved| buffers (|num_channel| buffers with |samples_per_channel|
@@ -89,6 +111,22 @@ void Interleave(const T* const* deinterleaved, int samples_per_channel,
   }
 }
 
+// Specializations which vectorize stereo where the CPU allows it.
+template <>
+void Deinterleave<int16_t>(const int16_t* interleaved, int samples_per_channel,
+                           int num_channels, int16_t** deinterleaved);
+template <>
+void Deinterleave<float>(const float* interleaved, int samples_per_channel,
+                         int num_channels, float** deinterleaved);
+template <>
+void Interleave<int16_t>(const int16_t* const* deinterleaved,
+                         int samples_per_channel, int num_channels,
+                         int16_t* interleaved);
+template <>
+void Interleave<float>(const float* const* deinterleaved,
+                       int samples_per_channel, int num_channels,
+                       float* interleaved);
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_COMMON_AUDIO_INCLUDE_AUDIO_UTIL_H_
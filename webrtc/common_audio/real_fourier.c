@@ -0,0 +1,683 @@
+/*
+ * http://www.kurims.kyoto-u.ac.jp/~ooura/fft.html
+ * Copyright Takuya OOURA, 1996-2001
+ *
+ * You may use, copy, modify and distribute this code for any purpose (include
+ * commercial use) and without fee. Please refer to this package when you modify
+ * this code.
+ *
+ * Changes by the WebRTC authors:
+ *    - Trivial type modifications.
+ *    - Minimal code subset to do rdft of power-of-two lengths.
+ *    - The tables are computed once per length, and the stages can be
+ *      replaced by SIMD versions.
+ *
+ *  All changes are covered by the WebRTC license and IP grant:
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/real_fourier.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "webrtc/common_audio/real_fourier_internal.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+
+// Number of tables allocated in one block, of |length| / 4 floats each.
+enum { kNumTables = 8 };
+
+static void MakeBitReversalTable(int n, int* ip) {
+  int j, l, m;
+
+  ip[0] = 0;
+  l = n;
+  m = 1;
+  while ((m << 3) < l) {
+    l >>= 1;
+    for (j = 0; j < m; j++) {
+      ip[m + j] = ip[j] + l;
+    }
+    m <<= 1;
+  }
+}
+
+static void BitReverse(int n, const int* ip, float* a) {
+  int j, j1, k, k1, l, m, m2;
+  float xr, xi, yr, yi;
+
+  l = n;
+  m = 1;
+  while ((m << 3) < l) {
+    l >>= 1;
+    m <<= 1;
+  }
+  m2 = 2 * m;
+  if ((m << 3) == l) {
+    for (k = 0; k < m; k++) {
+      for (j = 0; j < k; j++) {
+        j1 = 2 * j + ip[k];
+        k1 = 2 * k + ip[j];
+        xr = a[j1];
+        xi = a[j1 + 1];
+        yr = a[k1];
+        yi = a[k1 + 1];
+        a[j1] = yr;
+        a[j1 + 1] = yi;
+        a[k1] = xr;
+        a[k1 + 1] = xi;
+        j1 += m2;
+        k1 += 2 * m2;
+        xr = a[j1];
+        xi = a[j1 + 1];
+        yr = a[k1];
+        yi = a[k1 + 1];
+        a[j1] = yr;
+        a[j1 + 1] = yi;
+        a[k1] = xr;
+        a[k1 + 1] = xi;
+        j1 += m2;
+        k1 -= m2;
+        xr = a[j1];
+        xi = a[j1 + 1];
+        yr = a[k1];
+        yi = a[k1 + 1];
+        a[j1] = yr;
+        a[j1 + 1] = yi;
+        a[k1] = xr;
+        a[k1 + 1] = xi;
+        j1 += m2;
+        k1 += 2 * m2;
+        xr = a[j1];
+        xi = a[j1 + 1];
+        yr = a[k1];
+        yi = a[k1 + 1];
+        a[j1] = yr;
+        a[j1 + 1] = yi;
+        a[k1] = xr;
+        a[k1 + 1] = xi;
+      }
+      j1 = 2 * k + m2 + ip[k];
+      k1 = j1 + m2;
+      xr = a[j1];
+      xi = a[j1 + 1];
+      yr = a[k1];
+      yi = a[k1 + 1];
+      a[j1] = yr;
+      a[j1 + 1] = yi;
+      a[k1] = xr;
+      a[k1 + 1] = xi;
+    }
+  } else {
+    for (k = 1; k < m; k++) {
+      for (j = 0; j < k; j++) {
+        j1 = 2 * j + ip[k];
+        k1 = 2 * k + ip[j];
+        xr = a[j1];
+        xi = a[j1 + 1];
+        yr = a[k1];
+        yi = a[k1 + 1];
+        a[j1] = yr;
+        a[j1 + 1] = yi;
+        a[k1] = xr;
+        a[k1 + 1] = xi;
+        j1 += m2;
+        k1 += m2;
+        xr = a[j1];
+        xi = a[j1 + 1];
+        yr = a[k1];
+        yi = a[k1 + 1];
+        a[j1] = yr;
+        a[j1 + 1] = yi;
+        a[k1] = xr;
+        a[k1 + 1] = xi;
+      }
+    }
+  }
+}
+
+static void MakeWt(int nw, int* ip, float* w) {
+  int j, nwh;
+  float delta, x, y;
+
+  nwh = nw >> 1;
+  delta = (float)atan(1.0f) / nwh;
+  w[0] = 1;
+  w[1] = 0;
+  w[nwh] = (float)cos(delta * nwh);
+  w[nwh + 1] = w[nwh];
+  for (j = 2; j < nwh; j += 2) {
+    x = (float)cos(delta * j);
+    y = (float)sin(delta * j);
+    w[j] = x;
+    w[j + 1] = y;
+    w[nw - j] = y;
+    w[nw - j + 1] = x;
+  }
+  MakeBitReversalTable(nw, ip);
+  BitReverse(nw, ip, w);
+}
+
+static void MakeCt(int nc, float* c) {
+  int j, nch;
+  float delta;
+
+  nch = nc >> 1;
+  delta = (float)atan(1.0f) / nch;
+  c[0] = (float)cos(delta * nch);
+  c[nch] = 0.5f * c[0];
+  for (j = 1; j < nch; j++) {
+    c[j] = 0.5f * (float)cos(delta * j);
+    c[nc - j] = 0.5f * (float)sin(delta * j);
+  }
+}
+
+// Arranges the twiddle factors of cft1st() as the SSE2 version loads them:
+// each group of 16 values has two halves, which use the factors at positions
+// 0, 1 and 2, 3 of the vectors.
+static void MakeCft1stTables(struct RealFourier* self) {
+  const int n = self->length;
+  const float* w = self->w;
+  int j, k1;
+
+  for (k1 = 0, j = 0; j < n; j += 16, k1 += 2) {
+    const int k2 = 2 * k1;
+    const float wk2r = w[k1 + 0];
+    const float wk2i = w[k1 + 1];
+    const float wk1r_first = w[k2 + 0];
+    const float wk1i_first = w[k2 + 1];
+    const float wk1r_second = w[k2 + 2];
+    const float wk1i_second = w[k2 + 3];
+    const float wk3r_first = wk1r_first - 2 * wk2i * wk1i_first;
+    const float wk3i_first = 2 * wk2i * wk1r_first - wk1i_first;
+    const float wk3r_second = wk1r_second - 2 * wk2r * wk1i_second;
+    const float wk3i_second = 2 * wk2r * wk1r_second - wk1i_second;
+    self->wk1r[k2 + 0] = wk1r_first;
+    self->wk1r[k2 + 1] = wk1r_first;
+    self->wk1r[k2 + 2] = wk1r_second;
+    self->wk1r[k2 + 3] = wk1r_second;
+    self->wk1i[k2 + 0] = -wk1i_first;
+    self->wk1i[k2 + 1] = wk1i_first;
+    self->wk1i[k2 + 2] = -wk1i_second;
+    self->wk1i[k2 + 3] = wk1i_second;
+    self->wk2r[k2 + 0] = wk2r;
+    self->wk2r[k2 + 1] = wk2r;
+    self->wk2r[k2 + 2] = -wk2i;
+    self->wk2r[k2 + 3] = -wk2i;
+    self->wk2i[k2 + 0] = -wk2i;
+    self->wk2i[k2 + 1] = wk2i;
+    self->wk2i[k2 + 2] = -wk2r;
+    self->wk2i[k2 + 3] = wk2r;
+    self->wk3r[k2 + 0] = wk3r_first;
+    self->wk3r[k2 + 1] = wk3r_first;
+    self->wk3r[k2 + 2] = wk3r_second;
+    self->wk3r[k2 + 3] = wk3r_second;
+    self->wk3i[k2 + 0] = -wk3i_first;
+    self->wk3i[k2 + 1] = wk3i_first;
+    self->wk3i[k2 + 2] = -wk3i_second;
+    self->wk3i[k2 + 3] = wk3i_second;
+  }
+}
+
+void WebRtc_RealFourierCft1stC(int n, float* a, const float* w) {
+  int j, k1, k2;
+  float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+  float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+
+  x0r = a[0] + a[2];
+  x0i = a[1] + a[3];
+  x1r = a[0] - a[2];
+  x1i = a[1] - a[3];
+  x2r = a[4] + a[6];
+  x2i = a[5] + a[7];
+  x3r = a[4] - a[6];
+  x3i = a[5] - a[7];
+  a[0] = x0r + x2r;
+  a[1] = x0i + x2i;
+  a[4] = x0r - x2r;
+  a[5] = x0i - x2i;
+  a[2] = x1r - x3i;
+  a[3] = x1i + x3r;
+  a[6] = x1r + x3i;
+  a[7] = x1i - x3r;
+  wk1r = w[2];
+  x0r = a[8] + a[10];
+  x0i = a[9] + a[11];
+  x1r = a[8] - a[10];
+  x1i = a[9] - a[11];
+  x2r = a[12] + a[14];
+  x2i = a[13] + a[15];
+  x3r = a[12] - a[14];
+  x3i = a[13] - a[15];
+  a[8] = x0r + x2r;
+  a[9] = x0i + x2i;
+  a[12] = x2i - x0i;
+  a[13] = x0r - x2r;
+  x0r = x1r - x3i;
+  x0i = x1i + x3r;
+  a[10] = wk1r * (x0r - x0i);
+  a[11] = wk1r * (x0r + x0i);
+  x0r = x3i + x1r;
+  x0i = x3r - x1i;
+  a[14] = wk1r * (x0i - x0r);
+  a[15] = wk1r * (x0i + x0r);
+  k1 = 0;
+  for (j = 16; j < n; j += 16) {
+    k1 += 2;
+    k2 = 2 * k1;
+    wk2r = w[k1];
+    wk2i = w[k1 + 1];
+    wk1r = w[k2];
+    wk1i = w[k2 + 1];
+    wk3r = wk1r - 2 * wk2i * wk1i;
+    wk3i = 2 * wk2i * wk1r - wk1i;
+    x0r = a[j] + a[j + 2];
+    x0i = a[j + 1] + a[j + 3];
+    x1r = a[j] - a[j + 2];
+    x1i = a[j + 1] - a[j + 3];
+    x2r = a[j + 4] + a[j + 6];
+    x2i = a[j + 5] + a[j + 7];
+    x3r = a[j + 4] - a[j + 6];
+    x3i = a[j + 5] - a[j + 7];
+    a[j] = x0r + x2r;
+    a[j + 1] = x0i + x2i;
+    x0r -= x2r;
+    x0i -= x2i;
+    a[j + 4] = wk2r * x0r - wk2i * x0i;
+    a[j + 5] = wk2r * x0i + wk2i * x0r;
+    x0r = x1r - x3i;
+    x0i = x1i + x3r;
+    a[j + 2] = wk1r * x0r - wk1i * x0i;
+    a[j + 3] = wk1r * x0i + wk1i * x0r;
+    x0r = x1r + x3i;
+    x0i = x1i - x3r;
+    a[j + 6] = wk3r * x0r - wk3i * x0i;
+    a[j + 7] = wk3r * x0i + wk3i * x0r;
+    wk1r = w[k2 + 2];
+    wk1i = w[k2 + 3];
+    wk3r = wk1r - 2 * wk2r * wk1i;
+    wk3i = 2 * wk2r * wk1r - wk1i;
+    x0r = a[j + 8] + a[j + 10];
+    x0i = a[j + 9] + a[j + 11];
+    x1r = a[j + 8] - a[j + 10];
+    x1i = a[j + 9] - a[j + 11];
+    x2r = a[j + 12] + a[j + 14];
+    x2i = a[j + 13] + a[j + 15];
+    x3r = a[j + 12] - a[j + 14];
+    x3i = a[j + 13] - a[j + 15];
+    a[j + 8] = x0r + x2r;
+    a[j + 9] = x0i + x2i;
+    x0r -= x2r;
+    x0i -= x2i;
+    a[j + 12] = -wk2i * x0r - wk2r * x0i;
+    a[j + 13] = -wk2i * x0i + wk2r * x0r;
+    x0r = x1r - x3i;
+    x0i = x1i + x3r;
+    a[j + 10] = wk1r * x0r - wk1i * x0i;
+    a[j + 11] = wk1r * x0i + wk1i * x0r;
+    x0r = x1r + x3i;
+    x0i = x1i - x3r;
+    a[j + 14] = wk3r * x0r - wk3i * x0i;
+    a[j + 15] = wk3r * x0i + wk3i * x0r;
+  }
+}
+
+static void CftMdl(int n, int l, float* a, const float* w) {
+  int j, j1, j2, j3, k, k1, k2, m, m2;
+  float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+  float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+
+  m = l << 2;
+  for (j = 0; j < l; j += 2) {
+    j1 = j + l;
+    j2 = j1 + l;
+    j3 = j2 + l;
+    x0r = a[j] + a[j1];
+    x0i = a[j + 1] + a[j1 + 1];
+    x1r = a[j] - a[j1];
+    x1i = a[j + 1] - a[j1 + 1];
+    x2r = a[j2] + a[j3];
+    x2i = a[j2 + 1] + a[j3 + 1];
+    x3r = a[j2] - a[j3];
+    x3i = a[j2 + 1] - a[j3 + 1];
+    a[j] = x0r + x2r;
+    a[j + 1] = x0i + x2i;
+    a[j2] = x0r - x2r;
+    a[j2 + 1] = x0i - x2i;
+    a[j1] = x1r - x3i;
+    a[j1 + 1] = x1i + x3r;
+    a[j3] = x1r + x3i;
+    a[j3 + 1] = x1i - x3r;
+  }
+  wk1r = w[2];
+  for (j = m; j < l + m; j += 2) {
+    j1 = j + l;
+    j2 = j1 + l;
+    j3 = j2 + l;
+    x0r = a[j] + a[j1];
+    x0i = a[j + 1] + a[j1 + 1];
+    x1r = a[j] - a[j1];
+    x1i = a[j + 1] - a[j1 + 1];
+    x2r = a[j2] + a[j3];
+    x2i = a[j2 + 1] + a[j3 + 1];
+    x3r = a[j2] - a[j3];
+    x3i = a[j2 + 1] - a[j3 + 1];
+    a[j] = x0r + x2r;
+    a[j + 1] = x0i + x2i;
+    a[j2] = x2i - x0i;
+    a[j2 + 1] = x0r - x2r;
+    x0r = x1r - x3i;
+    x0i = x1i + x3r;
+    a[j1] = wk1r * (x0r - x0i);
+    a[j1 + 1] = wk1r * (x0r + x0i);
+    x0r = x3i + x1r;
+    x0i = x3r - x1i;
+    a[j3] = wk1r * (x0i - x0r);
+    a[j3 + 1] = wk1r * (x0i + x0r);
+  }
+  k1 = 0;
+  m2 = 2 * m;
+  for (k = m2; k < n; k += m2) {
+    k1 += 2;
+    k2 = 2 * k1;
+    wk2r = w[k1];
+    wk2i = w[k1 + 1];
+    wk1r = w[k2];
+    wk1i = w[k2 + 1];
+    wk3r = wk1r - 2 * wk2i * wk1i;
+    wk3i = 2 * wk2i * wk1r - wk1i;
+    for (j = k; j < l + k; j += 2) {
+      j1 = j + l;
+      j2 = j1 + l;
+      j3 = j2 + l;
+      x0r = a[j] + a[j1];
+      x0i = a[j + 1] + a[j1 + 1];
+      x1r = a[j] - a[j1];
+      x1i = a[j + 1] - a[j1 + 1];
+      x2r = a[j2] + a[j3];
+      x2i = a[j2 + 1] + a[j3 + 1];
+      x3r = a[j2] - a[j3];
+      x3i = a[j2 + 1] - a[j3 + 1];
+      a[j] = x0r + x2r;
+      a[j + 1] = x0i + x2i;
+      x0r -= x2r;
+      x0i -= x2i;
+      a[j2] = wk2r * x0r - wk2i * x0i;
+      a[j2 + 1] = wk2r * x0i + wk2i * x0r;
+      x0r = x1r - x3i;
+      x0i = x1i + x3r;
+      a[j1] = wk1r * x0r - wk1i * x0i;
+      a[j1 + 1] = wk1r * x0i + wk1i * x0r;
+      x0r = x1r + x3i;
+      x0i = x1i - x3r;
+      a[j3] = wk3r * x0r - wk3i * x0i;
+      a[j3 + 1] = wk3r * x0i + wk3i * x0r;
+    }
+    wk1r = w[k2 + 2];
+    wk1i = w[k2 + 3];
+    wk3r = wk1r - 2 * wk2r * wk1i;
+    wk3i = 2 * wk2r * wk1r - wk1i;
+    for (j = k + m; j < l + (k + m); j += 2) {
+      j1 = j + l;
+      j2 = j1 + l;
+      j3 = j2 + l;
+      x0r = a[j] + a[j1];
+      x0i = a[j + 1] + a[j1 + 1];
+      x1r = a[j] - a[j1];
+      x1i = a[j + 1] - a[j1 + 1];
+      x2r = a[j2] + a[j3];
+      x2i = a[j2 + 1] + a[j3 + 1];
+      x3r = a[j2] - a[j3];
+      x3i = a[j2 + 1] - a[j3 + 1];
+      a[j] = x0r + x2r;
+      a[j + 1] = x0i + x2i;
+      x0r -= x2r;
+      x0i -= x2i;
+      a[j2] = -wk2i * x0r - wk2r * x0i;
+      a[j2 + 1] = -wk2i * x0i + wk2r * x0r;
+      x0r = x1r - x3i;
+      x0i = x1i + x3r;
+      a[j1] = wk1r * x0r - wk1i * x0i;
+      a[j1 + 1] = wk1r * x0i + wk1i * x0r;
+      x0r = x1r + x3i;
+      x0i = x1i - x3r;
+      a[j3] = wk3r * x0r - wk3i * x0i;
+      a[j3 + 1] = wk3r * x0i + wk3i * x0r;
+    }
+  }
+}
+
+static void CftFsubC(const struct RealFourier* self, float* a) {
+  const int n = self->length;
+  int j, j1, j2, j3, l;
+  float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+
+  WebRtc_RealFourierCft1stC(n, a, self->w);
+  l = 8;
+  while ((l << 2) < n) {
+    CftMdl(n, l, a, self->w);
+    l <<= 2;
+  }
+  if ((l << 2) == n) {
+    for (j = 0; j < l; j += 2) {
+      j1 = j + l;
+      j2 = j1 + l;
+      j3 = j2 + l;
+      x0r = a[j] + a[j1];
+      x0i = a[j + 1] + a[j1 + 1];
+      x1r = a[j] - a[j1];
+      x1i = a[j + 1] - a[j1 + 1];
+      x2r = a[j2] + a[j3];
+      x2i = a[j2 + 1] + a[j3 + 1];
+      x3r = a[j2] - a[j3];
+      x3i = a[j2 + 1] - a[j3 + 1];
+      a[j] = x0r + x2r;
+      a[j + 1] = x0i + x2i;
+      a[j2] = x0r - x2r;
+      a[j2 + 1] = x0i - x2i;
+      a[j1] = x1r - x3i;
+      a[j1 + 1] = x1i + x3r;
+      a[j3] = x1r + x3i;
+      a[j3 + 1] = x1i - x3r;
+    }
+  } else {
+    for (j = 0; j < l; j += 2) {
+      j1 = j + l;
+      x0r = a[j] - a[j1];
+      x0i = a[j + 1] - a[j1 + 1];
+      a[j] += a[j1];
+      a[j + 1] += a[j1 + 1];
+      a[j1] = x0r;
+      a[j1 + 1] = x0i;
+    }
+  }
+}
+
+static void CftBsubC(const struct RealFourier* self, float* a) {
+  const int n = self->length;
+  int j, j1, j2, j3, l;
+  float x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+
+  WebRtc_RealFourierCft1stC(n, a, self->w);
+  l = 8;
+  while ((l << 2) < n) {
+    CftMdl(n, l, a, self->w);
+    l <<= 2;
+  }
+  if ((l << 2) == n) {
+    for (j = 0; j < l; j += 2) {
+      j1 = j + l;
+      j2 = j1 + l;
+      j3 = j2 + l;
+      x0r = a[j] + a[j1];
+      x0i = -a[j + 1] - a[j1 + 1];
+      x1r = a[j] - a[j1];
+      x1i = -a[j + 1] + a[j1 + 1];
+      x2r = a[j2] + a[j3];
+      x2i = a[j2 + 1] + a[j3 + 1];
+      x3r = a[j2] - a[j3];
+      x3i = a[j2 + 1] - a[j3 + 1];
+      a[j] = x0r + x2r;
+      a[j + 1] = x0i - x2i;
+      a[j2] = x0r - x2r;
+      a[j2 + 1] = x0i + x2i;
+      a[j1] = x1r - x3i;
+      a[j1 + 1] = x1i - x3r;
+      a[j3] = x1r + x3i;
+      a[j3 + 1] = x1i + x3r;
+    }
+  } else {
+    for (j = 0; j < l; j += 2) {
+      j1 = j + l;
+      x0r = a[j] - a[j1];
+      x0i = -a[j + 1] + a[j1 + 1];
+      a[j] += a[j1];
+      a[j + 1] = -a[j + 1] - a[j1 + 1];
+      a[j1] = x0r;
+      a[j1 + 1] = x0i;
+    }
+  }
+}
+
+static void RftFsubC(const struct RealFourier* self, float* a) {
+  const int n = self->length;
+  const int nc = n >> 2;
+  const float* c = self->c;
+  int j, k, kk, m;
+  float wkr, wki, xr, xi, yr, yi;
+
+  m = n >> 1;
+  kk = 0;
+  for (j = 2; j < m; j += 2) {
+    k = n - j;
+    kk += 1;
+    wkr = 0.5f - c[nc - kk];
+    wki = c[kk];
+    xr = a[j] - a[k];
+    xi = a[j + 1] + a[k + 1];
+    yr = wkr * xr - wki * xi;
+    yi = wkr * xi + wki * xr;
+    a[j] -= yr;
+    a[j + 1] -= yi;
+    a[k] += yr;
+    a[k + 1] -= yi;
+  }
+}
+
+static void RftBsubC(const struct RealFourier* self, float* a) {
+  const int n = self->length;
+  const int nc = n >> 2;
+  const float* c = self->c;
+  int j, k, kk, m;
+  float wkr, wki, xr, xi, yr, yi;
+
+  a[1] = -a[1];
+  m = n >> 1;
+  kk = 0;
+  for (j = 2; j < m; j += 2) {
+    k = n - j;
+    kk += 1;
+    wkr = 0.5f - c[nc - kk];
+    wki = c[kk];
+    xr = a[j] - a[k];
+    xi = a[j + 1] + a[k + 1];
+    yr = wkr * xr + wki * xi;
+    yi = wkr * xi - wki * xr;
+    a[j] -= yr;
+    a[j + 1] = yi - a[j + 1];
+    a[k] += yr;
+    a[k + 1] = yi - a[k + 1];
+  }
+  a[m + 1] = -a[m + 1];
+}
+
+struct RealFourier* WebRtc_CreateRealFourierC(int order) {
+  struct RealFourier* self = NULL;
+  int table_length;
+  float* tables;
+
+  if (order < kRealFourierMinOrder || order > kRealFourierMaxOrder) {
+    return NULL;
+  }
+
+  self = malloc(sizeof(struct RealFourier));
+  if (self == NULL) {
+    return NULL;
+  }
+  self->length = 1 << order;
+  table_length = self->length >> 2;
+  // Over-allocate to align the tables on 16 bytes.
+  self->tables = malloc(kNumTables * table_length * sizeof(float) + 15);
+  if (self->tables == NULL) {
+    free(self);
+    return NULL;
+  }
+  tables = (float*)(((uintptr_t)self->tables + 15) & ~(uintptr_t)15);
+  self->w = tables;
+  self->c = tables + table_length;
+  self->wk1r = tables + 2 * table_length;
+  self->wk1i = tables + 3 * table_length;
+  self->wk2r = tables + 4 * table_length;
+  self->wk2i = tables + 5 * table_length;
+  self->wk3r = tables + 6 * table_length;
+  self->wk3i = tables + 7 * table_length;
+
+  MakeWt(table_length, self->ip, self->w);
+  MakeCt(table_length, self->c);
+  MakeCft1stTables(self);
+  MakeBitReversalTable(self->length, self->ip);
+
+  self->cftfsub = CftFsubC;
+  self->cftbsub = CftBsubC;
+  self->rftfsub = RftFsubC;
+  self->rftbsub = RftBsubC;
+  return self;
+}
+
+struct RealFourier* WebRtc_CreateRealFourier(int order) {
+  struct RealFourier* self = WebRtc_CreateRealFourierC(order);
+  if (self == NULL) {
+    return NULL;
+  }
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  WebRtc_RealFourierInitSSE2(self);
+#else
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtc_RealFourierInitSSE2(self);
+  }
+#endif
+#endif
+  return self;
+}
+
+void WebRtc_FreeRealFourier(struct RealFourier* self) {
+  if (self != NULL) {
+    free(self->tables);
+    free(self);
+  }
+}
+
+void WebRtc_RealFourierForward(const struct RealFourier* self, float* data) {
+  float xi;
+
+  BitReverse(self->length, self->ip, data);
+  self->cftfsub(self, data);
+  self->rftfsub(self, data);
+  xi = data[0] - data[1];
+  data[0] += data[1];
+  data[1] = xi;
+}
+
+void WebRtc_RealFourierInverse(const struct RealFourier* self, float* data) {
+  data[1] = 0.5f * (data[0] - data[1]);
+  data[0] -= data[1];
+  self->rftbsub(self, data);
+  BitReverse(self->length, self->ip, data);
+  self->cftbsub(self, data);
+}
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_REAL_FOURIER_H_
+#define WEBRTC_COMMON_AUDIO_REAL_FOURIER_H_
+
+// Supported FFT orders, i.e. lengths of 64 to 4096 samples.
+enum {
+  kRealFourierMinOrder = 6,
+  kRealFourierMaxOrder = 12
+};
+
+struct RealFourier;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Creates a real-valued FFT of length 2^|order|, with the twiddle factors and
+// the bit reversal table computed once for that length. Picks the fastest
+// version the CPU supports.
+//
+// Return value:
+//   The FFT, or NULL if |order| is out of range or allocation failed.
+struct RealFourier* WebRtc_CreateRealFourier(int order);
+void WebRtc_FreeRealFourier(struct RealFourier* self);
+
+// Computes the FFT of the 2^order real samples in |data|, in place. The
+// output is packed in the format of Ooura's rdft, which the AEC uses and NS
+// used before:
+//     Index:      0   1       2   3   . . .   N-2       N-1
+//     Component:  R0  R[N/2]  R1  -I1 . . .   R[N/2-1]  -I[N/2-1]
+// where R[n] and I[n] are the real and imaginary parts of bin n. Note the sign
+// of the imaginary parts.
+//
+// |data| does not have to be aligned, but the SSE2 version is faster when it
+// is aligned on a 16-byte boundary.
+void WebRtc_RealFourierForward(const struct RealFourier* self, float* data);
+
+// Computes the inverse of WebRtc_RealFourierForward(), in place. The output is
+// not scaled, i.e. it is N/2 times the original signal.
+void WebRtc_RealFourierInverse(const struct RealFourier* self, float* data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // WEBRTC_COMMON_AUDIO_REAL_FOURIER_H_
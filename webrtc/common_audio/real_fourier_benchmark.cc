@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of a forward and an inverse real FFT with the C version
+// and with the version the CPU picks, for every supported length.
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+
+#include "gflags/gflags.h"
+#include "webrtc/common_audio/real_fourier_internal.h"
+#include "webrtc/system_wrappers/interface/aligned_malloc.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+DEFINE_int32(iterations, 20000, "The number of transform pairs to time for "
+             "the shortest length. Longer lengths are timed "
+             "proportionally fewer times.");
+
+namespace webrtc {
+namespace {
+
+// Returns the average time in nanoseconds of a forward and an inverse
+// transform of |data|.
+double TimeTransforms(const RealFourier* fft, int iterations, float* data) {
+  const float scale = 2.0f / fft->length;
+  TickTime start = TickTime::Now();
+  for (int i = 0; i < iterations; ++i) {
+    WebRtc_RealFourierForward(fft, data);
+    WebRtc_RealFourierInverse(fft, data);
+    // Keeps the values from growing over the iterations.
+    data[0] *= scale;
+  }
+  return static_cast<double>((TickTime::Now() - start).Microseconds()) * 1000 /
+      iterations;
+}
+
+void RunBenchmark() {
+  printf("%6s %10s %10s %8s\n", "length", "c_ns", "best_ns", "speedup");
+  for (int order = kRealFourierMinOrder; order <= kRealFourierMaxOrder;
+       ++order) {
+    const int length = 1 << order;
+    const int iterations =
+        std::max(1, FLAGS_iterations >> (order - kRealFourierMinOrder));
+    scoped_ptr<float, AlignedFreeDeleter> data(
+        static_cast<float*>(AlignedMalloc(length * sizeof(float), 16)));
+    for (int i = 0; i < length; ++i)
+      data.get()[i] = static_cast<float>(sin(i * 0.1) + cos(i * 0.37));
+
+    RealFourier* c = WebRtc_CreateRealFourierC(order);
+    RealFourier* best = WebRtc_CreateRealFourier(order);
+    double c_ns = TimeTransforms(c, iterations, data.get());
+    double best_ns = TimeTransforms(best, iterations, data.get());
+    printf("%6d %10.1f %10.1f %7.2fx\n", length, c_ns, best_ns,
+           c_ns / best_ns);
+    WebRtc_FreeRealFourier(c);
+    WebRtc_FreeRealFourier(best);
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string usage = "Benchmarks the C version of the real FFT against the "
+      "one picked for this CPU.\nExample usage:\n" + std::string(argv[0]) +
+      " --iterations=10000\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  webrtc::RunBenchmark();
+  return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_REAL_FOURIER_INTERNAL_H_
+#define WEBRTC_COMMON_AUDIO_REAL_FOURIER_INTERNAL_H_
+
+#include "webrtc/common_audio/real_fourier.h"
+#include "webrtc/typedefs.h"
+
+// Length of the bit reversal table, 2 + sqrt(N/2) rounded up.
+enum { kRealFourierIpLength = 2 + (1 << (kRealFourierMaxOrder / 2)) };
+
+// One stage of the transform, applied to |a| in place.
+typedef void (*RealFourierStage)(const struct RealFourier* self, float* a);
+
+struct RealFourier {
+  int length;
+
+  // The complex sub-transforms and the real-valued post- and pre-processing.
+  RealFourierStage cftfsub;
+  RealFourierStage cftbsub;
+  RealFourierStage rftfsub;
+  RealFourierStage rftbsub;
+
+  int ip[kRealFourierIpLength];
+  // Twiddle factors of the complex transform and cosine table of the real one,
+  // |length| / 4 values each.
+  float* w;
+  float* c;
+  // The twiddle factors of each 16-value group of cft1st(), duplicated and
+  // with their signs arranged for the SSE2 version, |length| / 4 values each.
+  // Aligned on 16 bytes.
+  float* wk1r;
+  float* wk1i;
+  float* wk2r;
+  float* wk2i;
+  float* wk3r;
+  float* wk3i;
+  void* tables;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Creates the FFT with the C stages only. Used by WebRtc_CreateRealFourier(),
+// and by tests and benchmarks to compare against.
+struct RealFourier* WebRtc_CreateRealFourierC(int order);
+
+// The first butterflies of the complex transform, over |n| values.
+void WebRtc_RealFourierCft1stC(int n, float* a, const float* w);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Replaces the stages of |self| with their SSE2 versions.
+void WebRtc_RealFourierInitSSE2(struct RealFourier* self);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // WEBRTC_COMMON_AUDIO_REAL_FOURIER_INTERNAL_H_
@@ -0,0 +1,474 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * SSE2 versions of the stages of the real-valued FFT, for any supported
+ * length. The butterflies after the first stage work on two complex values of
+ * the same block at once, with the twiddle factor of the block broadcast.
+ * Every value is computed with the same operations, in the same order, as in
+ * the C version, so the results are identical.
+ */
+
+#include "webrtc/common_audio/real_fourier_internal.h"
+
+#include <emmintrin.h>
+
+// Flip the sign of the real or the imaginary parts of two complex values.
+static __inline __m128 SwapSign(void) {
+  return _mm_set_ps(1.f, -1.f, 1.f, -1.f);
+}
+static __inline __m128 ConjSign(void) {
+  return _mm_set_ps(-1.f, 1.f, -1.f, 1.f);
+}
+
+// Swaps the real and imaginary parts of the two complex values in |x|.
+static __inline __m128 SwapComplex(__m128 x) {
+  return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// Multiplies the two complex values in |x| by wr + j * wi, as
+// wr * xr - wi * xi and wr * xi + wi * xr. |wi| has the signs -, +, -, +.
+static __inline __m128 ComplexMul(__m128 x, __m128 wr, __m128 wi) {
+  return _mm_add_ps(_mm_mul_ps(wr, x), _mm_mul_ps(wi, SwapComplex(x)));
+}
+
+// Returns the twiddle factor wr + j * wi broadcast to two complex values, as
+// used by ComplexMul().
+static __inline void BroadcastTwiddle(float wr, float wi,
+                                      __m128* wr_v, __m128* wi_v) {
+  *wr_v = _mm_set1_ps(wr);
+  *wi_v = _mm_set_ps(wi, -wi, wi, -wi);
+}
+
+static void Cft1st(const struct RealFourier* self, float* a) {
+  const int n = self->length;
+  const __m128 mm_swap_sign = SwapSign();
+  int j, k2;
+
+  // The first group has trivial twiddle factors, which the C version
+  // simplifies. Use it to get the same results.
+  WebRtc_RealFourierCft1stC(16, a, self->w);
+
+  for (k2 = 4, j = 16; j < n; j += 16, k2 += 4) {
+    __m128 a00v = _mm_loadu_ps(&a[j + 0]);
+    __m128 a04v = _mm_loadu_ps(&a[j + 4]);
+    __m128 a08v = _mm_loadu_ps(&a[j + 8]);
+    __m128 a12v = _mm_loadu_ps(&a[j + 12]);
+    __m128 a01v = _mm_shuffle_ps(a00v, a08v, _MM_SHUFFLE(1, 0, 1, 0));
+    __m128 a23v = _mm_shuffle_ps(a00v, a08v, _MM_SHUFFLE(3, 2, 3, 2));
+    __m128 a45v = _mm_shuffle_ps(a04v, a12v, _MM_SHUFFLE(1, 0, 1, 0));
+    __m128 a67v = _mm_shuffle_ps(a04v, a12v, _MM_SHUFFLE(3, 2, 3, 2));
+
+    const __m128 wk1rv = _mm_load_ps(&self->wk1r[k2]);
+    const __m128 wk1iv = _mm_load_ps(&self->wk1i[k2]);
+    const __m128 wk2rv = _mm_load_ps(&self->wk2r[k2]);
+    const __m128 wk2iv = _mm_load_ps(&self->wk2i[k2]);
+    const __m128 wk3rv = _mm_load_ps(&self->wk3r[k2]);
+    const __m128 wk3iv = _mm_load_ps(&self->wk3i[k2]);
+    __m128 x0v = _mm_add_ps(a01v, a23v);
+    const __m128 x1v = _mm_sub_ps(a01v, a23v);
+    const __m128 x2v = _mm_add_ps(a45v, a67v);
+    const __m128 x3v = _mm_sub_ps(a45v, a67v);
+    const __m128 x3s = _mm_mul_ps(mm_swap_sign, SwapComplex(x3v));
+    a01v = _mm_add_ps(x0v, x2v);
+    x0v = _mm_sub_ps(x0v, x2v);
+    a45v = ComplexMul(x0v, wk2rv, wk2iv);
+    a23v = ComplexMul(_mm_add_ps(x1v, x3s), wk1rv, wk1iv);
+    a67v = ComplexMul(_mm_sub_ps(x1v, x3s), wk3rv, wk3iv);
+
+    a00v = _mm_shuffle_ps(a01v, a23v, _MM_SHUFFLE(1, 0, 1, 0));
+    a04v = _mm_shuffle_ps(a45v, a67v, _MM_SHUFFLE(1, 0, 1, 0));
+    a08v = _mm_shuffle_ps(a01v, a23v, _MM_SHUFFLE(3, 2, 3, 2));
+    a12v = _mm_shuffle_ps(a45v, a67v, _MM_SHUFFLE(3, 2, 3, 2));
+    _mm_storeu_ps(&a[j + 0], a00v);
+    _mm_storeu_ps(&a[j + 4], a04v);
+    _mm_storeu_ps(&a[j + 8], a08v);
+    _mm_storeu_ps(&a[j + 12], a12v);
+  }
+}
+
+// The radix-4 butterflies without twiddle factors, on the values |j| to
+// |j_end| of each quarter of |a|, |l| values apart.
+static void Radix4(int j, int j_end, int l, float* a) {
+  const __m128 mm_swap_sign = SwapSign();
+  for (; j < j_end; j += 4) {
+    const __m128 a0 = _mm_loadu_ps(&a[j]);
+    const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+    const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+    const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+    const __m128 x0 = _mm_add_ps(a0, a1);
+    const __m128 x1 = _mm_sub_ps(a0, a1);
+    const __m128 x2 = _mm_add_ps(a2, a3);
+    const __m128 x3 = _mm_sub_ps(a2, a3);
+    // x3i, x3r with the sign of x3i flipped.
+    const __m128 x3s = _mm_mul_ps(mm_swap_sign, SwapComplex(x3));
+    _mm_storeu_ps(&a[j], _mm_add_ps(x0, x2));
+    _mm_storeu_ps(&a[j + 2 * l], _mm_sub_ps(x0, x2));
+    _mm_storeu_ps(&a[j + l], _mm_add_ps(x1, x3s));
+    _mm_storeu_ps(&a[j + 3 * l], _mm_sub_ps(x1, x3s));
+  }
+}
+
+// The radix-4 butterflies with the twiddle factors wk1, wk2 and wk3.
+static void Radix4Twiddle(int j, int j_end, int l, float* a,
+                          __m128 wk1rv, __m128 wk1iv,
+                          __m128 wk2rv, __m128 wk2iv,
+                          __m128 wk3rv, __m128 wk3iv) {
+  const __m128 mm_swap_sign = SwapSign();
+  for (; j < j_end; j += 4) {
+    const __m128 a0 = _mm_loadu_ps(&a[j]);
+    const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+    const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+    const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+    const __m128 x0 = _mm_add_ps(a0, a1);
+    const __m128 x1 = _mm_sub_ps(a0, a1);
+    const __m128 x2 = _mm_add_ps(a2, a3);
+    const __m128 x3 = _mm_sub_ps(a2, a3);
+    const __m128 x3s = _mm_mul_ps(mm_swap_sign, SwapComplex(x3));
+    _mm_storeu_ps(&a[j], _mm_add_ps(x0, x2));
+    _mm_storeu_ps(&a[j + 2 * l],
+                  ComplexMul(_mm_sub_ps(x0, x2), wk2rv, wk2iv));
+    _mm_storeu_ps(&a[j + l], ComplexMul(_mm_add_ps(x1, x3s), wk1rv, wk1iv));
+    _mm_storeu_ps(&a[j + 3 * l],
+                  ComplexMul(_mm_sub_ps(x1, x3s), wk3rv, wk3iv));
+  }
+}
+
+static void CftMdl(int n, int l, float* a, const float* w) {
+  const __m128 mm_swap_sign = SwapSign();
+  const __m128 mm_conj_sign = ConjSign();
+  const int m = l << 2;
+  const int m2 = 2 * m;
+  int j, k, k1, k2;
+
+  Radix4(0, l, l, a);
+
+  // The second block multiplies by exp(-j * pi / 4), and by -j.
+  {
+    const __m128 wk1rv = _mm_set1_ps(w[2]);
+    for (j = m; j < l + m; j += 4) {
+      const __m128 a0 = _mm_loadu_ps(&a[j]);
+      const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+      const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+      const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+      const __m128 x0 = _mm_add_ps(a0, a1);
+      const __m128 x1 = _mm_sub_ps(a0, a1);
+      const __m128 x2 = _mm_add_ps(a2, a3);
+      const __m128 x3 = _mm_sub_ps(a2, a3);
+      // x2i - x0i, x0r - x2r.
+      const __m128 x20 = _mm_sub_ps(x2, x0);
+      const __m128 x02 = _mm_sub_ps(x0, x2);
+      const __m128 t = _mm_shuffle_ps(x20, x02, _MM_SHUFFLE(2, 0, 3, 1));
+      // x1r - x3i, x1i + x3r.
+      const __m128 y = _mm_add_ps(x1,
+                                  _mm_mul_ps(mm_swap_sign, SwapComplex(x3)));
+      // x3i + x1r, x3r - x1i.
+      const __m128 z = _mm_add_ps(SwapComplex(x3),
+                                  _mm_mul_ps(mm_conj_sign, x1));
+      // yr - yi, yr + yi.
+      const __m128 y_sum = _mm_add_ps(
+          _mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 2, 0, 0)),
+          _mm_mul_ps(mm_swap_sign,
+                     _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 1, 1))));
+      // zi - zr, zi + zr.
+      const __m128 z_sum = _mm_add_ps(
+          _mm_shuffle_ps(z, z, _MM_SHUFFLE(3, 3, 1, 1)),
+          _mm_mul_ps(mm_swap_sign,
+                     _mm_shuffle_ps(z, z, _MM_SHUFFLE(2, 2, 0, 0))));
+      _mm_storeu_ps(&a[j], _mm_add_ps(x0, x2));
+      _mm_storeu_ps(&a[j + 2 * l], _mm_shuffle_ps(t, t,
+                                                  _MM_SHUFFLE(3, 1, 2, 0)));
+      _mm_storeu_ps(&a[j + l], _mm_mul_ps(wk1rv, y_sum));
+      _mm_storeu_ps(&a[j + 3 * l], _mm_mul_ps(wk1rv, z_sum));
+    }
+  }
+
+  k1 = 0;
+  for (k = m2; k < n; k += m2) {
+    float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+    __m128 wk1rv, wk1iv, wk2rv, wk2iv, wk3rv, wk3iv;
+    k1 += 2;
+    k2 = 2 * k1;
+    wk2r = w[k1];
+    wk2i = w[k1 + 1];
+    wk1r = w[k2];
+    wk1i = w[k2 + 1];
+    wk3r = wk1r - 2 * wk2i * wk1i;
+    wk3i = 2 * wk2i * wk1r - wk1i;
+    BroadcastTwiddle(wk1r, wk1i, &wk1rv, &wk1iv);
+    BroadcastTwiddle(wk2r, wk2i, &wk2rv, &wk2iv);
+    BroadcastTwiddle(wk3r, wk3i, &wk3rv, &wk3iv);
+    Radix4Twiddle(k, l + k, l, a, wk1rv, wk1iv, wk2rv, wk2iv, wk3rv, wk3iv);
+
+    wk1r = w[k2 + 2];
+    wk1i = w[k2 + 3];
+    wk3r = wk1r - 2 * wk2r * wk1i;
+    wk3i = 2 * wk2r * wk1r - wk1i;
+    BroadcastTwiddle(wk1r, wk1i, &wk1rv, &wk1iv);
+    BroadcastTwiddle(-wk2i, wk2r, &wk2rv, &wk2iv);
+    BroadcastTwiddle(wk3r, wk3i, &wk3rv, &wk3iv);
+    Radix4Twiddle(k + m, l + (k + m), l, a, wk1rv, wk1iv, wk2rv, wk2iv, wk3rv,
+                  wk3iv);
+  }
+}
+
+static void CftFsubSSE2(const struct RealFourier* self, float* a) {
+  const int n = self->length;
+  int j, l;
+
+  Cft1st(self, a);
+  l = 8;
+  while ((l << 2) < n) {
+    CftMdl(n, l, a, self->w);
+    l <<= 2;
+  }
+  if ((l << 2) == n) {
+    Radix4(0, l, l, a);
+  } else {
+    for (j = 0; j < l; j += 4) {
+      const __m128 a0 = _mm_loadu_ps(&a[j]);
+      const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+      _mm_storeu_ps(&a[j], _mm_add_ps(a0, a1));
+      _mm_storeu_ps(&a[j + l], _mm_sub_ps(a0, a1));
+    }
+  }
+}
+
+static void CftBsubSSE2(const struct RealFourier* self, float* a) {
+  const __m128 mm_conj_sign = ConjSign();
+  const int n = self->length;
+  int j, l;
+
+  Cft1st(self, a);
+  l = 8;
+  while ((l << 2) < n) {
+    CftMdl(n, l, a, self->w);
+    l <<= 2;
+  }
+  if ((l << 2) == n) {
+    for (j = 0; j < l; j += 4) {
+      // The first input is conjugated, and so is the output.
+      const __m128 a0 = _mm_mul_ps(mm_conj_sign, _mm_loadu_ps(&a[j]));
+      const __m128 a1 = _mm_mul_ps(mm_conj_sign, _mm_loadu_ps(&a[j + l]));
+      const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+      const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+      const __m128 x0 = _mm_add_ps(a0, a1);
+      const __m128 x1 = _mm_sub_ps(a0, a1);
+      const __m128 x2 = _mm_add_ps(a2, a3);
+      const __m128 x3 = _mm_sub_ps(a2, a3);
+      const __m128 x2c = _mm_mul_ps(mm_conj_sign, x2);
+      const __m128 x3w = SwapComplex(x3);
+      _mm_storeu_ps(&a[j], _mm_add_ps(x0, x2c));
+      _mm_storeu_ps(&a[j + 2 * l], _mm_sub_ps(x0, x2c));
+      _mm_storeu_ps(&a[j + l], _mm_sub_ps(x1, x3w));
+      _mm_storeu_ps(&a[j + 3 * l], _mm_add_ps(x1, x3w));
+    }
+  } else {
+    for (j = 0; j < l; j += 4) {
+      const __m128 a0 = _mm_mul_ps(mm_conj_sign, _mm_loadu_ps(&a[j]));
+      const __m128 a1 = _mm_mul_ps(mm_conj_sign, _mm_loadu_ps(&a[j + l]));
+      _mm_storeu_ps(&a[j], _mm_add_ps(a0, a1));
+      _mm_storeu_ps(&a[j + l], _mm_sub_ps(a0, a1));
+    }
+  }
+}
+
+static void RftFsubSSE2(const struct RealFourier* self, float* a) {
+  const int n = self->length;
+  const int nc = n >> 2;
+  const int m = n >> 1;
+  const float* c = self->c;
+  int j1, j2, k1, k2;
+  float wkr, wki, xr, xi, yr, yi;
+
+  const __m128 mm_half = _mm_set1_ps(0.5f);
+
+  // Vectorized code (four at once).
+  //    Note: commented number are indexes for the first iteration of the loop,
+  //    for a length of 128.
+  for (j1 = 1, j2 = 2; j2 + 7 < m; j1 += 4, j2 += 8) {
+    // Load 'wk'.
+    const __m128 c_j1 = _mm_loadu_ps(&c[j1]);            //  1,  2,  3,  4,
+    const __m128 c_k1 = _mm_loadu_ps(&c[nc - 3 - j1]);   // 28, 29, 30, 31,
+    const __m128 wkrt = _mm_sub_ps(mm_half, c_k1);       // 28, 29, 30, 31,
+    const __m128 wkr_ =
+        _mm_shuffle_ps(wkrt, wkrt, _MM_SHUFFLE(0, 1, 2, 3));  // 31, 30, 29, 28,
+    const __m128 wki_ = c_j1;                                 //  1,  2,  3,  4,
+    // Load and shuffle 'a'.
+    const __m128 a_j2_0 = _mm_loadu_ps(&a[0 + j2]);      //   2,   3,   4,   5,
+    const __m128 a_j2_4 = _mm_loadu_ps(&a[4 + j2]);      //   6,   7,   8,   9,
+    const __m128 a_k2_0 = _mm_loadu_ps(&a[n - 6 - j2]);  // 120, 121, 122, 123,
+    const __m128 a_k2_4 = _mm_loadu_ps(&a[n - 2 - j2]);  // 124, 125, 126, 127,
+    const __m128 a_j2_p0 = _mm_shuffle_ps(
+        a_j2_0, a_j2_4, _MM_SHUFFLE(2, 0, 2, 0));  //   2,   4,   6,   8,
+    const __m128 a_j2_p1 = _mm_shuffle_ps(
+        a_j2_0, a_j2_4, _MM_SHUFFLE(3, 1, 3, 1));  //   3,   5,   7,   9,
+    const __m128 a_k2_p0 = _mm_shuffle_ps(
+        a_k2_4, a_k2_0, _MM_SHUFFLE(0, 2, 0, 2));  // 126, 124, 122, 120,
+    const __m128 a_k2_p1 = _mm_shuffle_ps(
+        a_k2_4, a_k2_0, _MM_SHUFFLE(1, 3, 1, 3));  // 127, 125, 123, 121,
+    // Calculate 'x'.
+    const __m128 xr_ = _mm_sub_ps(a_j2_p0, a_k2_p0);
+    // 2-126, 4-124, 6-122, 8-120,
+    const __m128 xi_ = _mm_add_ps(a_j2_p1, a_k2_p1);
+    // 3-127, 5-125, 7-123, 9-121,
+    // Calculate product into 'y'.
+    //    yr = wkr * xr - wki * xi;
+    //    yi = wkr * xi + wki * xr;
+    const __m128 a_ = _mm_mul_ps(wkr_, xr_);
+    const __m128 b_ = _mm_mul_ps(wki_, xi_);
+    const __m128 c_ = _mm_mul_ps(wkr_, xi_);
+    const __m128 d_ = _mm_mul_ps(wki_, xr_);
+    const __m128 yr_ = _mm_sub_ps(a_, b_);  // 2-126, 4-124, 6-122, 8-120,
+    const __m128 yi_ = _mm_add_ps(c_, d_);  // 3-127, 5-125, 7-123, 9-121,
+    // Update 'a'.
+    //    a[j2 + 0] -= yr;
+    //    a[j2 + 1] -= yi;
+    //    a[k2 + 0] += yr;
+    //    a[k2 + 1] -= yi;
+    const __m128 a_j2_p0n = _mm_sub_ps(a_j2_p0, yr_);  //   2,   4,   6,   8,
+    const __m128 a_j2_p1n = _mm_sub_ps(a_j2_p1, yi_);  //   3,   5,   7,   9,
+    const __m128 a_k2_p0n = _mm_add_ps(a_k2_p0, yr_);  // 126, 124, 122, 120,
+    const __m128 a_k2_p1n = _mm_sub_ps(a_k2_p1, yi_);  // 127, 125, 123, 121,
+    // Shuffle in right order and store.
+    const __m128 a_j2_0n = _mm_unpacklo_ps(a_j2_p0n, a_j2_p1n);
+    //   2,   3,   4,   5,
+    const __m128 a_j2_4n = _mm_unpackhi_ps(a_j2_p0n, a_j2_p1n);
+    //   6,   7,   8,   9,
+    const __m128 a_k2_0nt = _mm_unpackhi_ps(a_k2_p0n, a_k2_p1n);
+    // 122, 123, 120, 121,
+    const __m128 a_k2_4nt = _mm_unpacklo_ps(a_k2_p0n, a_k2_p1n);
+    // 126, 127, 124, 125,
+    const __m128 a_k2_0n = _mm_shuffle_ps(
+        a_k2_0nt, a_k2_0nt, _MM_SHUFFLE(1, 0, 3, 2));  // 120, 121, 122, 123,
+    const __m128 a_k2_4n = _mm_shuffle_ps(
+        a_k2_4nt, a_k2_4nt, _MM_SHUFFLE(1, 0, 3, 2));  // 124, 125, 126, 127,
+    _mm_storeu_ps(&a[0 + j2], a_j2_0n);
+    _mm_storeu_ps(&a[4 + j2], a_j2_4n);
+    _mm_storeu_ps(&a[n - 6 - j2], a_k2_0n);
+    _mm_storeu_ps(&a[n - 2 - j2], a_k2_4n);
+  }
+  // Scalar code for the remaining items.
+  for (; j2 < m; j1 += 1, j2 += 2) {
+    k2 = n - j2;
+    k1 = nc - j1;
+    wkr = 0.5f - c[k1];
+    wki = c[j1];
+    xr = a[j2 + 0] - a[k2 + 0];
+    xi = a[j2 + 1] + a[k2 + 1];
+    yr = wkr * xr - wki * xi;
+    yi = wkr * xi + wki * xr;
+    a[j2 + 0] -= yr;
+    a[j2 + 1] -= yi;
+    a[k2 + 0] += yr;
+    a[k2 + 1] -= yi;
+  }
+}
+
+static void RftBsubSSE2(const struct RealFourier* self, float* a) {
+  const int n = self->length;
+  const int nc = n >> 2;
+  const int m = n >> 1;
+  const float* c = self->c;
+  int j1, j2, k1, k2;
+  float wkr, wki, xr, xi, yr, yi;
+
+  const __m128 mm_half = _mm_set1_ps(0.5f);
+
+  a[1] = -a[1];
+  // Vectorized code (four at once).
+  //    Note: commented number are indexes for the first iteration of the loop,
+  //    for a length of 128.
+  for (j1 = 1, j2 = 2; j2 + 7 < m; j1 += 4, j2 += 8) {
+    // Load 'wk'.
+    const __m128 c_j1 = _mm_loadu_ps(&c[j1]);            //  1,  2,  3,  4,
+    const __m128 c_k1 = _mm_loadu_ps(&c[nc - 3 - j1]);   // 28, 29, 30, 31,
+    const __m128 wkrt = _mm_sub_ps(mm_half, c_k1);       // 28, 29, 30, 31,
+    const __m128 wkr_ =
+        _mm_shuffle_ps(wkrt, wkrt, _MM_SHUFFLE(0, 1, 2, 3));  // 31, 30, 29, 28,
+    const __m128 wki_ = c_j1;                                 //  1,  2,  3,  4,
+    // Load and shuffle 'a'.
+    const __m128 a_j2_0 = _mm_loadu_ps(&a[0 + j2]);      //   2,   3,   4,   5,
+    const __m128 a_j2_4 = _mm_loadu_ps(&a[4 + j2]);      //   6,   7,   8,   9,
+    const __m128 a_k2_0 = _mm_loadu_ps(&a[n - 6 - j2]);  // 120, 121, 122, 123,
+    const __m128 a_k2_4 = _mm_loadu_ps(&a[n - 2 - j2]);  // 124, 125, 126, 127,
+    const __m128 a_j2_p0 = _mm_shuffle_ps(
+        a_j2_0, a_j2_4, _MM_SHUFFLE(2, 0, 2, 0));  //   2,   4,   6,   8,
+    const __m128 a_j2_p1 = _mm_shuffle_ps(
+        a_j2_0, a_j2_4, _MM_SHUFFLE(3, 1, 3, 1));  //   3,   5,   7,   9,
+    const __m128 a_k2_p0 = _mm_shuffle_ps(
+        a_k2_4, a_k2_0, _MM_SHUFFLE(0, 2, 0, 2));  // 126, 124, 122, 120,
+    const __m128 a_k2_p1 = _mm_shuffle_ps(
+        a_k2_4, a_k2_0, _MM_SHUFFLE(1, 3, 1, 3));  // 127, 125, 123, 121,
+    // Calculate 'x'.
+    const __m128 xr_ = _mm_sub_ps(a_j2_p0, a_k2_p0);
+    // 2-126, 4-124, 6-122, 8-120,
+    const __m128 xi_ = _mm_add_ps(a_j2_p1, a_k2_p1);
+    // 3-127, 5-125, 7-123, 9-121,
+    // Calculate product into 'y'.
+    //    yr = wkr * xr + wki * xi;
+    //    yi = wkr * xi - wki * xr;
+    const __m128 a_ = _mm_mul_ps(wkr_, xr_);
+    const __m128 b_ = _mm_mul_ps(wki_, xi_);
+    const __m128 c_ = _mm_mul_ps(wkr_, xi_);
+    const __m128 d_ = _mm_mul_ps(wki_, xr_);
+    const __m128 yr_ = _mm_add_ps(a_, b_);  // 2-126, 4-124, 6-122, 8-120,
+    const __m128 yi_ = _mm_sub_ps(c_, d_);  // 3-127, 5-125, 7-123, 9-121,
+    // Update 'a'.
+    //    a[j2 + 0] = a[j2 + 0] - yr;
+    //    a[j2 + 1] = yi - a[j2 + 1];
+    //    a[k2 + 0] = yr + a[k2 + 0];
+    //    a[k2 + 1] = yi - a[k2 + 1];
+    const __m128 a_j2_p0n = _mm_sub_ps(a_j2_p0, yr_);  //   2,   4,   6,   8,
+    const __m128 a_j2_p1n = _mm_sub_ps(yi_, a_j2_p1);  //   3,   5,   7,   9,
+    const __m128 a_k2_p0n = _mm_add_ps(a_k2_p0, yr_);  // 126, 124, 122, 120,
+    const __m128 a_k2_p1n = _mm_sub_ps(yi_, a_k2_p1);  // 127, 125, 123, 121,
+    // Shuffle in right order and store.
+    const __m128 a_j2_0n = _mm_unpacklo_ps(a_j2_p0n, a_j2_p1n);
+    //   2,   3,   4,   5,
+    const __m128 a_j2_4n = _mm_unpackhi_ps(a_j2_p0n, a_j2_p1n);
+    //   6,   7,   8,   9,
+    const __m128 a_k2_0nt = _mm_unpackhi_ps(a_k2_p0n, a_k2_p1n);
+    // 122, 123, 120, 121,
+    const __m128 a_k2_4nt = _mm_unpacklo_ps(a_k2_p0n, a_k2_p1n);
+    // 126, 127, 124, 125,
+    const __m128 a_k2_0n = _mm_shuffle_ps(
+        a_k2_0nt, a_k2_0nt, _MM_SHUFFLE(1, 0, 3, 2));  // 120, 121, 122, 123,
+    const __m128 a_k2_4n = _mm_shuffle_ps(
+        a_k2_4nt, a_k2_4nt, _MM_SHUFFLE(1, 0, 3, 2));  // 124, 125, 126, 127,
+    _mm_storeu_ps(&a[0 + j2], a_j2_0n);
+    _mm_storeu_ps(&a[4 + j2], a_j2_4n);
+    _mm_storeu_ps(&a[n - 6 - j2], a_k2_0n);
+    _mm_storeu_ps(&a[n - 2 - j2], a_k2_4n);
+  }
+  // Scalar code for the remaining items.
+  for (; j2 < m; j1 += 1, j2 += 2) {
+    k2 = n - j2;
+    k1 = nc - j1;
+    wkr = 0.5f - c[k1];
+    wki = c[j1];
+    xr = a[j2 + 0] - a[k2 + 0];
+    xi = a[j2 + 1] + a[k2 + 1];
+    yr = wkr * xr + wki * xi;
+    yi = wkr * xi - wki * xr;
+    a[j2 + 0] = a[j2 + 0] - yr;
+    a[j2 + 1] = yi - a[j2 + 1];
+    a[k2 + 0] = yr + a[k2 + 0];
+    a[k2 + 1] = yi - a[k2 + 1];
+  }
+  a[m + 1] = -a[m + 1];
+}
+
+void WebRtc_RealFourierInitSSE2(struct RealFourier* self) {
+  self->cftfsub = CftFsubSSE2;
+  self->cftbsub = CftBsubSSE2;
+  self->rftfsub = RftFsubSSE2;
+  self->rftbsub = RftBsubSSE2;
+}
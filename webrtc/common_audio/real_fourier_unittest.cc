@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/real_fourier.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_audio/real_fourier_internal.h"
+
+namespace webrtc {
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+void FillInput(int length, float* data) {
+  for (int i = 0; i < length; ++i)
+    data[i] = static_cast<float>(100 * sin(i * 0.3) + 40 * cos(i * 1.7) +
+                                 (i % 5) - 2);
+}
+
+}  // namespace
+
+TEST(RealFourierTest, CreateFailsOutsideOfSupportedOrders) {
+  EXPECT_TRUE(WebRtc_CreateRealFourier(kRealFourierMinOrder - 1) == NULL);
+  EXPECT_TRUE(WebRtc_CreateRealFourier(kRealFourierMaxOrder + 1) == NULL);
+  EXPECT_TRUE(WebRtc_CreateRealFourierC(kRealFourierMaxOrder + 1) == NULL);
+}
+
+TEST(RealFourierTest, ForwardMatchesDft) {
+  for (int order = kRealFourierMinOrder; order <= kRealFourierMaxOrder;
+       ++order) {
+    SCOPED_TRACE(order);
+    const int length = 1 << order;
+    std::vector<float> input(length);
+    FillInput(length, &input[0]);
+    std::vector<float> output(input);
+    RealFourier* fft = WebRtc_CreateRealFourier(order);
+    ASSERT_TRUE(fft != NULL);
+    WebRtc_RealFourierForward(fft, &output[0]);
+    WebRtc_FreeRealFourier(fft);
+
+    for (int k = 0; k <= length / 2; ++k) {
+      double re = 0;
+      double im = 0;
+      for (int i = 0; i < length; ++i) {
+        re += input[i] * cos(2 * kPi * i * k / length);
+        im -= input[i] * sin(2 * kPi * i * k / length);
+      }
+      // Unpack the rdft format; the imaginary parts are stored negated.
+      const double tolerance = 1e-5 * length * 100;
+      if (k == 0) {
+        EXPECT_NEAR(re, output[0], tolerance);
+      } else if (k == length / 2) {
+        EXPECT_NEAR(re, output[1], tolerance);
+      } else {
+        EXPECT_NEAR(re, output[2 * k], tolerance);
+        EXPECT_NEAR(-im, output[2 * k + 1], tolerance);
+      }
+    }
+  }
+}
+
+TEST(RealFourierTest, InverseRestoresInputScaledByHalfLength) {
+  for (int order = kRealFourierMinOrder; order <= kRealFourierMaxOrder;
+       ++order) {
+    SCOPED_TRACE(order);
+    const int length = 1 << order;
+    std::vector<float> input(length);
+    FillInput(length, &input[0]);
+    std::vector<float> data(input);
+    RealFourier* fft = WebRtc_CreateRealFourier(order);
+    ASSERT_TRUE(fft != NULL);
+    WebRtc_RealFourierForward(fft, &data[0]);
+    WebRtc_RealFourierInverse(fft, &data[0]);
+    WebRtc_FreeRealFourier(fft);
+
+    for (int i = 0; i < length; ++i)
+      EXPECT_NEAR(input[i], data[i] * 2 / length, 1e-3);
+  }
+}
+
+// The optimized versions are bit-exact with the C version, so that the
+// modules built on the FFT do not depend on the CPU.
+TEST(RealFourierTest, OptimizedVersionMatchesC) {
+  for (int order = kRealFourierMinOrder; order <= kRealFourierMaxOrder;
+       ++order) {
+    SCOPED_TRACE(order);
+    const int length = 1 << order;
+    // Offset by one value to also cover unaligned data.
+    std::vector<float> c_data(length + 1);
+    std::vector<float> data(length + 1);
+    FillInput(length, &c_data[1]);
+    FillInput(length, &data[1]);
+    RealFourier* c_fft = WebRtc_CreateRealFourierC(order);
+    RealFourier* fft = WebRtc_CreateRealFourier(order);
+    ASSERT_TRUE(c_fft != NULL);
+    ASSERT_TRUE(fft != NULL);
+
+    WebRtc_RealFourierForward(c_fft, &c_data[1]);
+    WebRtc_RealFourierForward(fft, &data[1]);
+    EXPECT_EQ(0, memcmp(&c_data[1], &data[1], length * sizeof(data[0])));
+
+    WebRtc_RealFourierInverse(c_fft, &c_data[1]);
+    WebRtc_RealFourierInverse(fft, &data[1]);
+    EXPECT_EQ(0, memcmp(&c_data[1], &data[1], length * sizeof(data[0])));
+
+    WebRtc_FreeRealFourier(c_fft);
+    WebRtc_FreeRealFourier(fft);
+  }
+}
+
+}  // namespace webrtc
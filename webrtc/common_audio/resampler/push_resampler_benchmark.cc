@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of PushResampler for every pair of the sample rates used
+// by WebRTC, for both mono and stereo, and int16 and float samples.
+
+#include <math.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "gflags/gflags.h"
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/typedefs.h"
+
+DEFINE_int32(iterations, 10000,
+             "The number of 10 ms blocks to resample for each configuration.");
+DEFINE_bool(avx, true,
+            "Use the AVX convolution kernel if the CPU supports it. Disable to "
+            "compare against the SSE kernel.");
+
+namespace webrtc {
+namespace {
+
+const int kSampleRates[] = {8000, 16000, 32000, 44100, 48000};
+const int kNumSampleRates = sizeof(kSampleRates) / sizeof(*kSampleRates);
+
+WebRtc_CPUInfo g_cpu_info = NULL;
+
+// Hides AVX and FMA from SincResampler's kernel selection.
+int GetCPUInfoWithoutAVX(CPUFeature feature) {
+  if (feature == kAVX || feature == kFMA)
+    return 0;
+  return g_cpu_info(feature);
+}
+
+template <typename T>
+void FillInput(T* buffer, int length) {
+  for (int i = 0; i < length; ++i)
+    buffer[i] = static_cast<T>(10000 * sin(i * 0.01));
+}
+
+// Returns the average time in microseconds to resample one 10 ms block.
+template <typename T>
+double BenchmarkRates(int src_rate, int dst_rate, int num_channels) {
+  const int src_length = src_rate / 100 * num_channels;
+  const int dst_length = dst_rate / 100 * num_channels;
+  scoped_ptr<T[]> src(new T[src_length]);
+  scoped_ptr<T[]> dst(new T[dst_length]);
+  FillInput(src.get(), src_length);
+
+  PushResampler<T> resampler;
+  if (resampler.InitializeIfNeeded(src_rate, dst_rate, num_channels) != 0) {
+    fprintf(stderr, "Failed to initialize %d -> %d\n", src_rate, dst_rate);
+    return -1;
+  }
+  TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    if (resampler.Resample(src.get(), src_length, dst.get(), dst_length) !=
+        dst_length) {
+      fprintf(stderr, "Failed to resample %d -> %d\n", src_rate, dst_rate);
+      return -1;
+    }
+  }
+  return static_cast<double>((TickTime::Now() - start).Microseconds()) /
+      FLAGS_iterations;
+}
+
+void RunBenchmark() {
+  printf("%8s %8s %8s %12s %12s\n", "src_hz", "dst_hz", "channels",
+         "int16_us", "float_us");
+  double total_int16_us = 0;
+  double total_float_us = 0;
+  for (int i = 0; i < kNumSampleRates; ++i) {
+    for (int j = 0; j < kNumSampleRates; ++j) {
+      if (i == j)
+        continue;
+      for (int num_channels = 1; num_channels <= 2; ++num_channels) {
+        double int16_us = BenchmarkRates<int16_t>(
+            kSampleRates[i], kSampleRates[j], num_channels);
+        double float_us = BenchmarkRates<float>(
+            kSampleRates[i], kSampleRates[j], num_channels);
+        printf("%8d %8d %8d %12.2f %12.2f\n", kSampleRates[i],
+               kSampleRates[j], num_channels, int16_us, float_us);
+        total_int16_us += int16_us;
+        total_float_us += float_us;
+      }
+    }
+  }
+  printf("%26s %12.2f %12.2f\n", "total", total_int16_us, total_float_us);
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string usage = "Benchmarks PushResampler for all supported rate pairs.\n"
+      "Example usage:\n" + std::string(argv[0]) + " --iterations=1000\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  webrtc::g_cpu_info = WebRtc_GetCPUInfo;
+  if (!FLAGS_avx)
+    WebRtc_GetCPUInfo = webrtc::GetCPUInfoWithoutAVX;
+  printf("AVX kernel %s.\n",
+         WebRtc_GetCPUInfo(kAVX) && WebRtc_GetCPUInfo(kFMA) ? "enabled" :
+         "disabled");
+
+  webrtc::RunBenchmark();
+  return 0;
+}
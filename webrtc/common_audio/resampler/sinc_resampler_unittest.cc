@@ -161,6 +161,33 @@ TEST(SincResamplerTest, Convolve) {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Ensure Convolve_AVX() matches Convolve_C() for every input alignment.
+TEST(SincResamplerTest, ConvolveAVX) {
+  if (!WebRtc_GetCPUInfo(kAVX) || !WebRtc_GetCPUInfo(kFMA)) {
+    printf("Skipping test, AVX and FMA are not supported.\n");
+    return;
+  }
+
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+
+  static const double kEpsilon = 0.00000005;
+
+  const float* kernel = resampler.kernel_storage_.get();
+  // Use a second kernel, so that a mix-up of |k1| and |k2| is detected.
+  const float* kernel2 = kernel + SincResampler::kKernelSize;
+  for (int offset = 0; offset < 8; ++offset) {
+    double result = resampler.Convolve_C(kernel + offset, kernel, kernel2,
+                                         kKernelInterpolationFactor);
+    double result2 = resampler.Convolve_AVX(kernel + offset, kernel, kernel2,
+                                            kKernelInterpolationFactor);
+    EXPECT_NEAR(result2, result, kEpsilon) << "offset " << offset;
+  }
+}
+#endif
+
 // Benchmark for the various Convolve() methods.  Make sure to build with
 // branding=Chrome so that DCHECKs are compiled out when benchmarking.  Original
 // benchmarks were run with --convolve-iterations=50000000.
@@ -222,6 +249,21 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
          total_time_c_us / total_time_optimized_aligned_us,
          total_time_optimized_unaligned_us / total_time_optimized_aligned_us);
 #endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX) && WebRtc_GetCPUInfo(kFMA)) {
+    start = TickTime::Now();
+    for (int j = 0; j < kConvolveIterations; ++j) {
+      resampler.Convolve_AVX(
+          resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
+          resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    }
+    double total_time_avx_us = (TickTime::Now() - start).Microseconds();
+    printf("Convolve_AVX (unaligned) took %.2fms; which is %.2fx faster than "
+           "Convolve_C.\n", total_time_avx_us / 1000,
+           total_time_c_us / total_time_avx_us);
+  }
+#endif
 }
 
 #undef CONVOLVE_FUNC
@@ -345,7 +387,7 @@ INSTANTIATE_TEST_CASE_P(
         std::tr1::make_tuple(16000, 44100, kResamplingRMSError, -62.54),
         std::tr1::make_tuple(22050, 44100, kResamplingRMSError, -73.53),
         std::tr1::make_tuple(32000, 44100, kResamplingRMSError, -63.32),
-        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.53),
+        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.52),
         std::tr1::make_tuple(48000, 44100, -15.01, -64.04),
         std::tr1::make_tuple(96000, 44100, -18.49, -25.51),
         std::tr1::make_tuple(192000, 44100, -20.50, -13.31),
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+static int32_t HorizontalSumW32(__m256i x) {
+  __m128i y = _mm_add_epi32(_mm256_castsi256_si128(x),
+                            _mm256_extracti128_si256(x, 1));
+  y = _mm_add_epi32(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+  y = _mm_add_epi32(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(y);
+}
+
+/* AVX2 version of WebRtcSpl_CrossCorrelation(), see
+ * WebRtcSpl_CrossCorrelationSSE2(). Only called after checking for AVX2
+ * support at run time.
+ */
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2) {
+  const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+  int i = 0, j = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    const int16_t* seq2_ptr = seq2 + step_seq2 * i;
+    __m256i sum = _mm256_setzero_si256();
+    int32_t result = 0;
+
+    j = 0;
+    if (right_shifts == 0) {
+      for (; j <= dim_seq - 16; j += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)&seq1[j]);
+        __m256i y = _mm256_loadu_si256((const __m256i*)&seq2_ptr[j]);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(x, y));
+      }
+    } else {
+      for (; j <= dim_seq - 16; j += 16) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)&seq1[j]);
+        __m256i y = _mm256_loadu_si256((const __m256i*)&seq2_ptr[j]);
+        __m256i low = _mm256_mullo_epi16(x, y);
+        __m256i high = _mm256_mulhi_epi16(x, y);
+        sum = _mm256_add_epi32(
+            sum, _mm256_sra_epi32(_mm256_unpacklo_epi16(low, high), shift));
+        sum = _mm256_add_epi32(
+            sum, _mm256_sra_epi32(_mm256_unpackhi_epi16(low, high), shift));
+      }
+    }
+    result = HorizontalSumW32(sum);
+    for (; j < dim_seq; j++) {
+      result += (seq1[j] * seq2_ptr[j]) >> right_shifts;
+    }
+    *cross_correlation++ = result;
+  }
+}
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+static int32_t HorizontalSumW32(__m128i x) {
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(x);
+}
+
+/* SSE2 version of WebRtcSpl_CrossCorrelation(). Every product is shifted
+ * before it is accumulated, like in the C version, so pairs of products are
+ * only summed by _mm_madd_epi16() when there is no shift.
+ */
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2) {
+  const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+  int i = 0, j = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    const int16_t* seq2_ptr = seq2 + step_seq2 * i;
+    __m128i sum = _mm_setzero_si128();
+    int32_t result = 0;
+
+    j = 0;
+    if (right_shifts == 0) {
+      for (; j <= dim_seq - 8; j += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)&seq1[j]);
+        __m128i y = _mm_loadu_si128((const __m128i*)&seq2_ptr[j]);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(x, y));
+      }
+    } else {
+      for (; j <= dim_seq - 8; j += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)&seq1[j]);
+        __m128i y = _mm_loadu_si128((const __m128i*)&seq2_ptr[j]);
+        __m128i low = _mm_mullo_epi16(x, y);
+        __m128i high = _mm_mulhi_epi16(x, y);
+        sum = _mm_add_epi32(
+            sum, _mm_sra_epi32(_mm_unpacklo_epi16(low, high), shift));
+        sum = _mm_add_epi32(
+            sum, _mm_sra_epi32(_mm_unpackhi_epi16(low, high), shift));
+      }
+    }
+    result = HorizontalSumW32(sum);
+    for (; j < dim_seq; j++) {
+      result += (seq1[j] * seq2_ptr[j]) >> right_shifts;
+    }
+    *cross_correlation++ = result;
+  }
+}
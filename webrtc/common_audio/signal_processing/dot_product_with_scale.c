@@ -10,10 +10,10 @@
 
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 
-int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
-                                      const int16_t* vector2,
-                                      int length,
-                                      int scaling) {
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       int scaling) {
   int32_t sum = 0;
   int i = 0;
 
@@ -30,3 +30,16 @@ int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
 
   return sum;
 }
+
+int32_t WebRtcSpl_SumAbsDiffW16C(const int16_t* vector1,
+                                 const int16_t* vector2,
+                                 int length) {
+  int32_t sum = 0;
+  int i = 0;
+
+  for (i = 0; i < length; i++) {
+    sum += WEBRTC_SPL_ABS_W32(vector1[i] - vector2[i]);
+  }
+
+  return sum;
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+static int32_t HorizontalSumW32(__m128i x) {
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(x);
+}
+
+/* SSE2 version of WebRtcSpl_DotProductWithScale(). As in
+ * WebRtcSpl_CrossCorrelationSSE2(), every product is shifted before it is
+ * accumulated, and pairs of products are only summed by _mm_madd_epi16() when
+ * there is no shift.
+ */
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          int length,
+                                          int scaling) {
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m128i sum = _mm_setzero_si128();
+  int32_t result = 0;
+  int i = 0;
+
+  if (scaling == 0) {
+    for (; i <= length - 8; i += 8) {
+      __m128i x = _mm_loadu_si128((const __m128i*)&vector1[i]);
+      __m128i y = _mm_loadu_si128((const __m128i*)&vector2[i]);
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(x, y));
+    }
+  } else {
+    for (; i <= length - 8; i += 8) {
+      __m128i x = _mm_loadu_si128((const __m128i*)&vector1[i]);
+      __m128i y = _mm_loadu_si128((const __m128i*)&vector2[i]);
+      __m128i low = _mm_mullo_epi16(x, y);
+      __m128i high = _mm_mulhi_epi16(x, y);
+      sum = _mm_add_epi32(
+          sum, _mm_sra_epi32(_mm_unpacklo_epi16(low, high), shift));
+      sum = _mm_add_epi32(
+          sum, _mm_sra_epi32(_mm_unpackhi_epi16(low, high), shift));
+    }
+  }
+  result = HorizontalSumW32(sum);
+  for (; i < length; i++) {
+    result += (vector1[i] * vector2[i]) >> scaling;
+  }
+
+  return result;
+}
+
+/* SSE2 version of WebRtcSpl_SumAbsDiffW16(). The difference of the larger and
+ * the smaller value fits in 16 bits when read as unsigned, so the absolute
+ * differences are computed on eight samples at a time before they are widened
+ * to 32 bits.
+ */
+int32_t WebRtcSpl_SumAbsDiffW16SSE2(const int16_t* vector1,
+                                    const int16_t* vector2,
+                                    int length) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum = _mm_setzero_si128();
+  int32_t result = 0;
+  int i = 0;
+
+  for (; i <= length - 8; i += 8) {
+    __m128i x = _mm_loadu_si128((const __m128i*)&vector1[i]);
+    __m128i y = _mm_loadu_si128((const __m128i*)&vector2[i]);
+    __m128i diff = _mm_sub_epi16(_mm_max_epi16(x, y), _mm_min_epi16(x, y));
+    sum = _mm_add_epi32(sum, _mm_unpacklo_epi16(diff, zero));
+    sum = _mm_add_epi32(sum, _mm_unpackhi_epi16(diff, zero));
+  }
+  result = HorizontalSumW32(sum);
+  for (; i < length; i++) {
+    result += WEBRTC_SPL_ABS_W32(vector1[i] - vector2[i]);
+  }
+
+  return result;
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// The longest filter with an SSE2 version. The longer ones fall back to C.
+#define MAX_SSE2_COEFFICIENTS 64
+
+// SSE2 version of WebRtcSpl_DownsampleFast(). The coefficients are reversed
+// and zero padded to a multiple of eight, so that every output is computed
+// from forward loads of |data_in|, from its oldest sample on. The padding
+// reads up to seven samples past the newest one, so the last outputs are
+// computed like in the C version when those are beyond |data_in_length|.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 int data_in_length,
+                                 int16_t* data_out,
+                                 int data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 int coefficients_length,
+                                 int factor,
+                                 int delay) {
+  __m128i reversed_coefficients[MAX_SSE2_COEFFICIENTS / 8];
+  int16_t reversed[MAX_SSE2_COEFFICIENTS];
+  int padded_length = (coefficients_length + 7) & ~7;
+  int i = 0;
+  int j = 0;
+  int32_t out_s32 = 0;
+  int endpos = delay + factor * (data_out_length - 1) + 1;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length <= 0 || coefficients_length <= 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+  if (coefficients_length > MAX_SSE2_COEFFICIENTS) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  for (j = 0; j < padded_length; j++) {
+    reversed[j] = j < coefficients_length ?
+        coefficients[coefficients_length - 1 - j] : 0;
+  }
+  for (j = 0; j < padded_length / 8; j++) {
+    reversed_coefficients[j] =
+        _mm_loadu_si128((const __m128i*)&reversed[8 * j]);
+  }
+
+  for (i = delay; i < endpos; i += factor) {
+    const int16_t* oldest = &data_in[i - coefficients_length + 1];
+
+    if (i - coefficients_length + 1 + padded_length <= data_in_length) {
+      __m128i sum = _mm_setzero_si128();
+      for (j = 0; j < padded_length / 8; j++) {
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(
+            _mm_loadu_si128((const __m128i*)&oldest[8 * j]),
+            reversed_coefficients[j]));
+      }
+      sum = _mm_add_epi32(sum,
+                          _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+      sum = _mm_add_epi32(sum,
+                          _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+      out_s32 = 2048 + _mm_cvtsi128_si32(sum);  // Round value, 0.5 in Q12.
+    } else {
+      out_s32 = 2048;  // Round value, 0.5 in Q12.
+      for (j = 0; j < coefficients_length; j++) {
+        out_s32 += coefficients[j] * data_in[i - j];  // Q12.
+      }
+    }
+
+    out_s32 >>= 12;  // Q0.
+
+    // Saturate and store the output.
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32);
+  }
+
+  return 0;
+}
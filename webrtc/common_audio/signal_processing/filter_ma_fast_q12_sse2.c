@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// The longest filter with an SSE2 version. The longer ones fall back to C.
+#define MAX_SSE2_COEFFICIENTS 64
+
+// SSE2 version of WebRtcSpl_FilterMAFastQ12(). Like in
+// WebRtcSpl_DownsampleFastSSE2(), the coefficients are reversed and zero
+// padded to a multiple of eight, so that every output is computed from forward
+// loads of |in_ptr|, from its oldest sample on. The padding reads up to seven
+// samples past the newest one, so the last outputs are computed like in the C
+// version when those are beyond |length|.
+void WebRtcSpl_FilterMAFastQ12SSE2(int16_t* in_ptr,
+                                   int16_t* out_ptr,
+                                   int16_t* B,
+                                   int16_t B_length,
+                                   int16_t length) {
+  __m128i reversed_coefficients[MAX_SSE2_COEFFICIENTS / 8];
+  int16_t reversed[MAX_SSE2_COEFFICIENTS];
+  int padded_length = (B_length + 7) & ~7;
+  int i = 0;
+  int j = 0;
+  int32_t o = 0;
+
+  if (B_length <= 0 || B_length > MAX_SSE2_COEFFICIENTS) {
+    WebRtcSpl_FilterMAFastQ12C(in_ptr, out_ptr, B, B_length, length);
+    return;
+  }
+
+  for (j = 0; j < padded_length; j++) {
+    reversed[j] = j < B_length ? B[B_length - 1 - j] : 0;
+  }
+  for (j = 0; j < padded_length / 8; j++) {
+    reversed_coefficients[j] =
+        _mm_loadu_si128((const __m128i*)&reversed[8 * j]);
+  }
+
+  for (i = 0; i < length; i++) {
+    const int16_t* oldest = &in_ptr[i - B_length + 1];
+
+    if (i - B_length + 1 + padded_length <= length) {
+      __m128i sum = _mm_setzero_si128();
+      for (j = 0; j < padded_length / 8; j++) {
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(
+            _mm_loadu_si128((const __m128i*)&oldest[8 * j]),
+            reversed_coefficients[j]));
+      }
+      sum = _mm_add_epi32(sum,
+                          _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+      sum = _mm_add_epi32(sum,
+                          _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+      o = _mm_cvtsi128_si32(sum);
+    } else {
+      o = 0;
+      for (j = 0; j < B_length; j++) {
+        o += WEBRTC_SPL_MUL_16_16(B[j], in_ptr[i - j]);
+      }
+    }
+
+    // Saturate the output, like the C version.
+    o = WEBRTC_SPL_SAT((int32_t)134215679, o, (int32_t)-134217728);
+
+    *out_ptr++ = (int16_t)((o + (int32_t)2048) >> 12);
+  }
+}
@@ -146,8 +146,9 @@ extern "C" {
 // If the underlying platform is known to be ARM-Neon (WEBRTC_ARCH_ARM_NEON
 // defined), the pointers will be assigned to code optimized for Neon; otherwise
 // if run-time Neon detection (WEBRTC_DETECT_ARM_NEON) is enabled, the pointers
-// will be assigned to either Neon code or generic C code; otherwise, generic C
-// code will be assigned.
+// will be assigned to either Neon code or generic C code; on x86 the pointers
+// will be assigned to SSE2 or AVX2 code as detected at run time; otherwise,
+// generic C code will be assigned.
 // Note that this function MUST be called in any application that uses SPL
 // functions.
 void WebRtcSpl_Init();
@@ -202,6 +203,10 @@ int16_t WebRtcSpl_MaxAbsValueW16C(const int16_t* vector, int length);
 #if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON)
 int16_t WebRtcSpl_MaxAbsValueW16Neon(const int16_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, int length);
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, int length);
+#endif
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxAbsValueW16_mips(const int16_t* vector, int length);
 #endif
@@ -220,6 +225,10 @@ int32_t WebRtcSpl_MaxAbsValueW32C(const int32_t* vector, int length);
 #if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON)
 int32_t WebRtcSpl_MaxAbsValueW32Neon(const int32_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MaxAbsValueW32SSE2(const int32_t* vector, int length);
+int32_t WebRtcSpl_MaxAbsValueW32AVX2(const int32_t* vector, int length);
+#endif
 #if defined(MIPS_DSP_R1_LE)
 int32_t WebRtcSpl_MaxAbsValueW32_mips(const int32_t* vector, int length);
 #endif
@@ -240,6 +249,10 @@ int16_t WebRtcSpl_MaxValueW16C(const int16_t* vector, int length);
 #if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON)
 int16_t WebRtcSpl_MaxValueW16Neon(const int16_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, int length);
+int16_t WebRtcSpl_MaxValueW16AVX2(const int16_t* vector, int length);
+#endif
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxValueW16_mips(const int16_t* vector, int length);
 #endif
@@ -260,6 +273,10 @@ int32_t WebRtcSpl_MaxValueW32C(const int32_t* vector, int length);
 #if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON)
 int32_t WebRtcSpl_MaxValueW32Neon(const int32_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MaxValueW32SSE2(const int32_t* vector, int length);
+int32_t WebRtcSpl_MaxValueW32AVX2(const int32_t* vector, int length);
+#endif
 #if defined(MIPS32_LE)
 int32_t WebRtcSpl_MaxValueW32_mips(const int32_t* vector, int length);
 #endif
@@ -280,6 +297,10 @@ int16_t WebRtcSpl_MinValueW16C(const int16_t* vector, int length);
 #if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON)
 int16_t WebRtcSpl_MinValueW16Neon(const int16_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, int length);
+int16_t WebRtcSpl_MinValueW16AVX2(const int16_t* vector, int length);
+#endif
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MinValueW16_mips(const int16_t* vector, int length);
 #endif
@@ -300,6 +321,10 @@ int32_t WebRtcSpl_MinValueW32C(const int32_t* vector, int length);
 #if (defined WEBRTC_DETECT_ARM_NEON) || (defined WEBRTC_ARCH_ARM_NEON)
 int32_t WebRtcSpl_MinValueW32Neon(const int32_t* vector, int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MinValueW32SSE2(const int32_t* vector, int length);
+int32_t WebRtcSpl_MinValueW32AVX2(const int32_t* vector, int length);
+#endif
 #if defined(MIPS32_LE)
 int32_t WebRtcSpl_MinValueW32_mips(const int32_t* vector, int length);
 #endif
@@ -437,6 +462,15 @@ int WebRtcSpl_ScaleAndAddVectorsWithRoundNeon(const int16_t* in_vector1,
                                               int16_t* out_vector,
                                               int length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(const int16_t* in_vector1,
+                                              int16_t in_vector1_scale,
+                                              const int16_t* in_vector2,
+                                              int16_t in_vector2_scale,
+                                              int right_shifts,
+                                              int16_t* out_vector,
+                                              int length);
+#endif
 #if defined(MIPS_DSP_R1_LE)
 int WebRtcSpl_ScaleAndAddVectorsWithRound_mips(const int16_t* in_vector1,
                                                int16_t in_vector1_scale,
@@ -617,6 +651,22 @@ void WebRtcSpl_CrossCorrelationNeon(int32_t* cross_correlation,
                                     int16_t right_shifts,
                                     int16_t step_seq2);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2);
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    int16_t dim_seq,
+                                    int16_t dim_cross_correlation,
+                                    int16_t right_shifts,
+                                    int16_t step_seq2);
+#endif
 #if defined(MIPS32_LE)
 void WebRtcSpl_CrossCorrelation_mips(int32_t* cross_correlation,
                                      const int16_t* seq1,
@@ -686,10 +736,43 @@ int32_t WebRtcSpl_Energy(int16_t* vector, int vector_length, int* scale_factor);
 //                        output will be in Q(-|scaling|)
 //
 // Return value         : The dot product in Q(-scaling)
-int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
-                                      const int16_t* vector2,
-                                      int length,
-                                      int scaling);
+typedef int32_t (*DotProductWithScale)(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       int scaling);
+extern DotProductWithScale WebRtcSpl_DotProductWithScale;
+int32_t WebRtcSpl_DotProductWithScaleC(const int16_t* vector1,
+                                       const int16_t* vector2,
+                                       int length,
+                                       int scaling);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_DotProductWithScaleSSE2(const int16_t* vector1,
+                                          const int16_t* vector2,
+                                          int length,
+                                          int scaling);
+#endif
+
+// Calculates the sum of the absolute differences between two (int16_t)
+// vectors.
+//
+// Input:
+//      - vector1       : Vector 1
+//      - vector2       : Vector 2
+//      - length        : Number of samples
+//
+// Return value         : The sum of |vector1[i] - vector2[i]|
+typedef int32_t (*SumAbsDiffW16)(const int16_t* vector1,
+                                 const int16_t* vector2,
+                                 int length);
+extern SumAbsDiffW16 WebRtcSpl_SumAbsDiffW16;
+int32_t WebRtcSpl_SumAbsDiffW16C(const int16_t* vector1,
+                                 const int16_t* vector2,
+                                 int length);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_SumAbsDiffW16SSE2(const int16_t* vector1,
+                                    const int16_t* vector2,
+                                    int length);
+#endif
 
 // Filter operations.
 int WebRtcSpl_FilterAR(const int16_t* ar_coef,
@@ -704,11 +787,26 @@ int WebRtcSpl_FilterAR(const int16_t* ar_coef,
                        int16_t* out_vector_low,
                        int out_vector_low_length);
 
-void WebRtcSpl_FilterMAFastQ12(int16_t* in_vector,
-                               int16_t* out_vector,
-                               int16_t* ma_coef,
-                               int16_t ma_coef_length,
-                               int16_t vector_length);
+// Performs a MA filtering on a vector in Q12. See the description of
+// WebRtcSpl_FilterMAFastQ12() below.
+typedef void (*FilterMAFastQ12)(int16_t* in_vector,
+                                int16_t* out_vector,
+                                int16_t* ma_coef,
+                                int16_t ma_coef_length,
+                                int16_t vector_length);
+extern FilterMAFastQ12 WebRtcSpl_FilterMAFastQ12;
+void WebRtcSpl_FilterMAFastQ12C(int16_t* in_vector,
+                                int16_t* out_vector,
+                                int16_t* ma_coef,
+                                int16_t ma_coef_length,
+                                int16_t vector_length);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_FilterMAFastQ12SSE2(int16_t* in_vector,
+                                   int16_t* out_vector,
+                                   int16_t* ma_coef,
+                                   int16_t ma_coef_length,
+                                   int16_t vector_length);
+#endif
 
 // Performs a AR filtering on a vector in Q12
 // Input:
@@ -769,6 +867,16 @@ int WebRtcSpl_DownsampleFastNeon(const int16_t* data_in,
                                  int factor,
                                  int delay);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 int data_in_length,
+                                 int16_t* data_out,
+                                 int data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 int coefficients_length,
+                                 int factor,
+                                 int delay);
+#endif
 #if defined(MIPS32_LE)
 int WebRtcSpl_DownsampleFast_mips(const int16_t* data_in,
                                   int data_in_length,
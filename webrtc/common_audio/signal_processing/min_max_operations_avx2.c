@@ -0,0 +1,215 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the AVX2 implementations of the functions
+ * WebRtcSpl_MaxAbsValueW16()
+ * WebRtcSpl_MaxAbsValueW32()
+ * WebRtcSpl_MaxValueW16()
+ * WebRtcSpl_MaxValueW32()
+ * WebRtcSpl_MinValueW16()
+ * WebRtcSpl_MinValueW32()
+ *
+ * The description header can be found in signal_processing_library.h.
+ * The results are identical to those of the C versions. Only called after
+ * checking for AVX2 support at run time.
+ */
+
+#include <immintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+static int16_t HorizontalMaxW16(__m256i x) {
+  __m128i y = _mm_max_epi16(_mm256_castsi256_si128(x),
+                            _mm256_extracti128_si256(x, 1));
+  y = _mm_max_epi16(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+  y = _mm_max_epi16(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  y = _mm_max_epi16(y, _mm_shufflelo_epi16(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(y);
+}
+
+static int16_t HorizontalMinW16(__m256i x) {
+  __m128i y = _mm_min_epi16(_mm256_castsi256_si128(x),
+                            _mm256_extracti128_si256(x, 1));
+  y = _mm_min_epi16(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+  y = _mm_min_epi16(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  y = _mm_min_epi16(y, _mm_shufflelo_epi16(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(y);
+}
+
+static int32_t HorizontalMaxW32(__m256i x) {
+  __m128i y = _mm_max_epi32(_mm256_castsi256_si128(x),
+                            _mm256_extracti128_si256(x, 1));
+  y = _mm_max_epi32(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+  y = _mm_max_epi32(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(y);
+}
+
+static int32_t HorizontalMinW32(__m256i x) {
+  __m128i y = _mm_min_epi32(_mm256_castsi256_si128(x),
+                            _mm256_extracti128_si256(x, 1));
+  y = _mm_min_epi32(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+  y = _mm_min_epi32(y, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(y);
+}
+
+// Maximum absolute value of word16 vector.
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, int length) {
+  __m256i maximum_vector = _mm256_setzero_si256();
+  __m256i minimum_vector = _mm256_setzero_si256();
+  int maximum = 0, minimum = 0;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return -1;
+  }
+
+  // The largest absolute value is that of either the maximum or the minimum.
+  for (; i <= length - 16; i += 16) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    maximum_vector = _mm256_max_epi16(maximum_vector, x);
+    minimum_vector = _mm256_min_epi16(minimum_vector, x);
+  }
+  maximum = HorizontalMaxW16(maximum_vector);
+  minimum = HorizontalMinW16(minimum_vector);
+  for (; i < length; i++) {
+    maximum = WEBRTC_SPL_MAX(maximum, vector[i]);
+    minimum = WEBRTC_SPL_MIN(minimum, vector[i]);
+  }
+
+  maximum = WEBRTC_SPL_MAX(maximum, -minimum);
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// Maximum absolute value of word32 vector.
+int32_t WebRtcSpl_MaxAbsValueW32AVX2(const int32_t* vector, int length) {
+  __m256i maximum_vector = _mm256_setzero_si256();
+  __m256i minimum_vector = _mm256_setzero_si256();
+  int32_t maximum = 0, minimum = 0;
+  // Use uint32_t to accommodate the absolute value of 0x80000000.
+  uint32_t absolute_maximum = 0, absolute_minimum = 0;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return -1;
+  }
+
+  for (; i <= length - 8; i += 8) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    maximum_vector = _mm256_max_epi32(maximum_vector, x);
+    minimum_vector = _mm256_min_epi32(minimum_vector, x);
+  }
+  maximum = HorizontalMaxW32(maximum_vector);
+  minimum = HorizontalMinW32(minimum_vector);
+  for (; i < length; i++) {
+    maximum = WEBRTC_SPL_MAX(maximum, vector[i]);
+    minimum = WEBRTC_SPL_MIN(minimum, vector[i]);
+  }
+
+  absolute_maximum = (uint32_t)maximum;
+  absolute_minimum = 0 - (uint32_t)minimum;
+  absolute_maximum = WEBRTC_SPL_MAX(absolute_maximum, absolute_minimum);
+  absolute_maximum = WEBRTC_SPL_MIN(absolute_maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)absolute_maximum;
+}
+
+// Maximum value of word16 vector.
+int16_t WebRtcSpl_MaxValueW16AVX2(const int16_t* vector, int length) {
+  __m256i maximum_vector = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  int16_t maximum = WEBRTC_SPL_WORD16_MIN;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return maximum;
+  }
+
+  for (; i <= length - 16; i += 16) {
+    maximum_vector = _mm256_max_epi16(
+        maximum_vector, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW16(maximum_vector);
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Maximum value of word32 vector.
+int32_t WebRtcSpl_MaxValueW32AVX2(const int32_t* vector, int length) {
+  __m256i maximum_vector = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  int32_t maximum = WEBRTC_SPL_WORD32_MIN;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return maximum;
+  }
+
+  for (; i <= length - 8; i += 8) {
+    maximum_vector = _mm256_max_epi32(
+        maximum_vector, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW32(maximum_vector);
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Minimum value of word16 vector.
+int16_t WebRtcSpl_MinValueW16AVX2(const int16_t* vector, int length) {
+  __m256i minimum_vector = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  int16_t minimum = WEBRTC_SPL_WORD16_MAX;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return minimum;
+  }
+
+  for (; i <= length - 16; i += 16) {
+    minimum_vector = _mm256_min_epi16(
+        minimum_vector, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = HorizontalMinW16(minimum_vector);
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// Minimum value of word32 vector.
+int32_t WebRtcSpl_MinValueW32AVX2(const int32_t* vector, int length) {
+  __m256i minimum_vector = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  int32_t minimum = WEBRTC_SPL_WORD32_MAX;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return minimum;
+  }
+
+  for (; i <= length - 8; i += 8) {
+    minimum_vector = _mm256_min_epi32(
+        minimum_vector, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = HorizontalMinW32(minimum_vector);
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the SSE2 implementations of the functions
+ * WebRtcSpl_MaxAbsValueW16()
+ * WebRtcSpl_MaxAbsValueW32()
+ * WebRtcSpl_MaxValueW16()
+ * WebRtcSpl_MaxValueW32()
+ * WebRtcSpl_MinValueW16()
+ * WebRtcSpl_MinValueW32()
+ *
+ * The description header can be found in signal_processing_library.h.
+ * The results are identical to those of the C versions.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// Maximum of the eight values in |x|.
+static int16_t HorizontalMaxW16(__m128i x) {
+  x = _mm_max_epi16(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_max_epi16(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  x = _mm_max_epi16(x, _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(x);
+}
+
+// Minimum of the eight values in |x|.
+static int16_t HorizontalMinW16(__m128i x) {
+  x = _mm_min_epi16(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_min_epi16(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  x = _mm_min_epi16(x, _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(x);
+}
+
+// SSE2 has no 32-bit min and max, so they are selected with a comparison.
+static __m128i MaxW32(__m128i a, __m128i b) {
+  __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, a),
+                      _mm_andnot_si128(a_greater, b));
+}
+
+static __m128i MinW32(__m128i a, __m128i b) {
+  __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, b),
+                      _mm_andnot_si128(a_greater, a));
+}
+
+static int32_t HorizontalMaxW32(__m128i x) {
+  x = MaxW32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = MaxW32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(x);
+}
+
+static int32_t HorizontalMinW32(__m128i x) {
+  x = MinW32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = MinW32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(x);
+}
+
+// Maximum absolute value of word16 vector.
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, int length) {
+  __m128i maximum_vector = _mm_setzero_si128();
+  __m128i minimum_vector = _mm_setzero_si128();
+  int maximum = 0, minimum = 0;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return -1;
+  }
+
+  // The largest absolute value is that of either the maximum or the minimum.
+  for (; i <= length - 8; i += 8) {
+    __m128i x = _mm_loadu_si128((const __m128i*)&vector[i]);
+    maximum_vector = _mm_max_epi16(maximum_vector, x);
+    minimum_vector = _mm_min_epi16(minimum_vector, x);
+  }
+  maximum = HorizontalMaxW16(maximum_vector);
+  minimum = HorizontalMinW16(minimum_vector);
+  for (; i < length; i++) {
+    maximum = WEBRTC_SPL_MAX(maximum, vector[i]);
+    minimum = WEBRTC_SPL_MIN(minimum, vector[i]);
+  }
+
+  maximum = WEBRTC_SPL_MAX(maximum, -minimum);
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// Maximum absolute value of word32 vector.
+int32_t WebRtcSpl_MaxAbsValueW32SSE2(const int32_t* vector, int length) {
+  __m128i maximum_vector = _mm_setzero_si128();
+  __m128i minimum_vector = _mm_setzero_si128();
+  int32_t maximum = 0, minimum = 0;
+  // Use uint32_t to accommodate the absolute value of 0x80000000.
+  uint32_t absolute_maximum = 0, absolute_minimum = 0;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return -1;
+  }
+
+  for (; i <= length - 4; i += 4) {
+    __m128i x = _mm_loadu_si128((const __m128i*)&vector[i]);
+    maximum_vector = MaxW32(maximum_vector, x);
+    minimum_vector = MinW32(minimum_vector, x);
+  }
+  maximum = HorizontalMaxW32(maximum_vector);
+  minimum = HorizontalMinW32(minimum_vector);
+  for (; i < length; i++) {
+    maximum = WEBRTC_SPL_MAX(maximum, vector[i]);
+    minimum = WEBRTC_SPL_MIN(minimum, vector[i]);
+  }
+
+  absolute_maximum = (uint32_t)maximum;
+  absolute_minimum = 0 - (uint32_t)minimum;
+  absolute_maximum = WEBRTC_SPL_MAX(absolute_maximum, absolute_minimum);
+  absolute_maximum = WEBRTC_SPL_MIN(absolute_maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)absolute_maximum;
+}
+
+// Maximum value of word16 vector.
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, int length) {
+  __m128i maximum_vector = _mm_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  int16_t maximum = WEBRTC_SPL_WORD16_MIN;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return maximum;
+  }
+
+  for (; i <= length - 8; i += 8) {
+    maximum_vector = _mm_max_epi16(
+        maximum_vector, _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW16(maximum_vector);
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Maximum value of word32 vector.
+int32_t WebRtcSpl_MaxValueW32SSE2(const int32_t* vector, int length) {
+  __m128i maximum_vector = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  int32_t maximum = WEBRTC_SPL_WORD32_MIN;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return maximum;
+  }
+
+  for (; i <= length - 4; i += 4) {
+    maximum_vector = MaxW32(maximum_vector,
+                            _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW32(maximum_vector);
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Minimum value of word16 vector.
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, int length) {
+  __m128i minimum_vector = _mm_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  int16_t minimum = WEBRTC_SPL_WORD16_MAX;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return minimum;
+  }
+
+  for (; i <= length - 8; i += 8) {
+    minimum_vector = _mm_min_epi16(
+        minimum_vector, _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = HorizontalMinW16(minimum_vector);
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// Minimum value of word32 vector.
+int32_t WebRtcSpl_MinValueW32SSE2(const int32_t* vector, int length) {
+  __m128i minimum_vector = _mm_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  int32_t minimum = WEBRTC_SPL_WORD32_MAX;
+  int i = 0;
+
+  if (vector == NULL || length <= 0) {
+    return minimum;
+  }
+
+  for (; i <= length - 4; i += 4) {
+    minimum_vector = MinW32(minimum_vector,
+                            _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = HorizontalMinW32(minimum_vector);
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
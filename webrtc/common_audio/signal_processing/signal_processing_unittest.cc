@@ -10,6 +10,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 static const int kVector16Size = 9;
 static const int16_t vector16[kVector16Size] = {1, -15511, 4323, 1963,
@@ -496,6 +497,15 @@ TEST_F(SplTest, DotProductWithScaleTest) {
       vector16, kVector16Size, 2));
 }
 
+TEST_F(SplTest, SumAbsDiffW16Test) {
+  const int16_t kVector1[] = {-32768, 32767, 0, 5, -7, 100, 3, -1, 2};
+  const int16_t kVector2[] = {32767, -32768, 0, -5, 7, 98, 3, 1, -2};
+  const int kLength = sizeof(kVector1) / sizeof(kVector1[0]);
+  EXPECT_EQ(2 * 65535 + 10 + 14 + 2 + 2 + 4,
+            WebRtcSpl_SumAbsDiffW16(kVector1, kVector2, kLength));
+  EXPECT_EQ(0, WebRtcSpl_SumAbsDiffW16(kVector1, kVector1, kLength));
+}
+
 TEST_F(SplTest, CrossCorrelationTest) {
   // Note the function arguments relation specificed by API.
   const int kCrossCorrelationDimension = 3;
@@ -511,14 +521,14 @@ TEST_F(SplTest, CrossCorrelationTest) {
                              kCrossCorrelationDimension, kShift, kStep);
 
   // WebRtcSpl_CrossCorrelationC() and WebRtcSpl_CrossCorrelationNeon()
-  // are not bit-exact.
+  // are not bit-exact. The x86 versions are.
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_DETECT_ARM_NEON) || defined(WEBRTC_ARCH_ARM_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon) {
     expected = kExpectedNeon;
   }
 #endif
@@ -646,3 +656,177 @@ TEST_F(SplTest, Resample48WithSaturationTest) {
     EXPECT_EQ(kRefValue16kHz2, out_vector_w16[i]);
   }
 }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Fills |vector| with random samples, with a share of them at the limits of
+// the 16-bit range to exercise the saturation.
+static void FillRandomW16(int16_t* vector, int length, uint32_t* seed) {
+  for (int i = 0; i < length; ++i) {
+    *seed = *seed * 1103515245 + 12345;
+    int16_t value = static_cast<int16_t>(*seed >> 16);
+    if ((*seed & 0x1f) == 0)
+      value = (*seed & 0x20) ? WEBRTC_SPL_WORD16_MAX : WEBRTC_SPL_WORD16_MIN;
+    vector[i] = value;
+  }
+}
+
+// WEBRTC_SPL_WORD32_MIN is left out, since WebRtcSpl_MaxAbsValueW32C() relies
+// on the undefined abs(WEBRTC_SPL_WORD32_MIN) for it.
+static void FillRandomW32(int32_t* vector, int length, uint32_t* seed) {
+  for (int i = 0; i < length; ++i) {
+    *seed = *seed * 1103515245 + 12345;
+    int32_t value = static_cast<int32_t>(*seed ^ (*seed << 13));
+    if ((*seed & 0x1f) == 0 || value == WEBRTC_SPL_WORD32_MIN) {
+      value = (*seed & 0x20) ? WEBRTC_SPL_WORD32_MAX :
+          WEBRTC_SPL_WORD32_MIN + 1;
+    }
+    vector[i] = value;
+  }
+}
+
+// The x86 versions must be bit exact with the C versions, for lengths that
+// are not multiples of the vector sizes too.
+TEST_F(SplTest, X86MatchesC) {
+  ASSERT_TRUE(WebRtc_GetCPUInfo(kSSE2));
+  const bool avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+  const int kMaxLength = 200;
+  int16_t vector16[kMaxLength + 1];
+  int16_t other_vector16[kMaxLength + 1];
+  int32_t vector32[kMaxLength + 1];
+  uint32_t seed = 1;
+
+  for (int length = 1; length <= kMaxLength; length += 7) {
+    FillRandomW16(vector16, length, &seed);
+    FillRandomW32(vector32, length, &seed);
+    // The odd offsets keep the vectors unaligned.
+    const int16_t* v16 = vector16 + (length & 1);
+    const int32_t* v32 = vector32 + (length & 1);
+    const int n = length - (length & 1);
+    if (n == 0)
+      continue;
+    SCOPED_TRACE(length);
+
+    EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(v16, n),
+              WebRtcSpl_MaxAbsValueW16SSE2(v16, n));
+    EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(v32, n),
+              WebRtcSpl_MaxAbsValueW32SSE2(v32, n));
+    EXPECT_EQ(WebRtcSpl_MaxValueW16C(v16, n),
+              WebRtcSpl_MaxValueW16SSE2(v16, n));
+    EXPECT_EQ(WebRtcSpl_MaxValueW32C(v32, n),
+              WebRtcSpl_MaxValueW32SSE2(v32, n));
+    EXPECT_EQ(WebRtcSpl_MinValueW16C(v16, n),
+              WebRtcSpl_MinValueW16SSE2(v16, n));
+    EXPECT_EQ(WebRtcSpl_MinValueW32C(v32, n),
+              WebRtcSpl_MinValueW32SSE2(v32, n));
+    if (avx2) {
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(v16, n),
+                WebRtcSpl_MaxAbsValueW16AVX2(v16, n));
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(v32, n),
+                WebRtcSpl_MaxAbsValueW32AVX2(v32, n));
+      EXPECT_EQ(WebRtcSpl_MaxValueW16C(v16, n),
+                WebRtcSpl_MaxValueW16AVX2(v16, n));
+      EXPECT_EQ(WebRtcSpl_MaxValueW32C(v32, n),
+                WebRtcSpl_MaxValueW32AVX2(v32, n));
+      EXPECT_EQ(WebRtcSpl_MinValueW16C(v16, n),
+                WebRtcSpl_MinValueW16AVX2(v16, n));
+      EXPECT_EQ(WebRtcSpl_MinValueW32C(v32, n),
+                WebRtcSpl_MinValueW32AVX2(v32, n));
+    }
+
+    FillRandomW16(other_vector16, length, &seed);
+    int16_t expected16[kMaxLength];
+    int16_t actual16[kMaxLength];
+    for (int right_shifts = 0; right_shifts <= 16; right_shifts += 5) {
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundC(
+          v16, 1234, other_vector16, -32768, right_shifts, expected16, n));
+      EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+          v16, 1234, other_vector16, -32768, right_shifts, actual16, n));
+      for (int i = 0; i < n; ++i)
+        EXPECT_EQ(expected16[i], actual16[i]);
+    }
+
+    for (int scaling = 0; scaling <= 16; scaling += 4) {
+      EXPECT_EQ(WebRtcSpl_DotProductWithScaleC(v16, other_vector16, n, scaling),
+                WebRtcSpl_DotProductWithScaleSSE2(v16, other_vector16, n,
+                                                  scaling));
+    }
+    EXPECT_EQ(WebRtcSpl_SumAbsDiffW16C(v16, other_vector16, n),
+              WebRtcSpl_SumAbsDiffW16SSE2(v16, other_vector16, n));
+
+    // Correlate |v16| with lags of |vector16| in both directions, like
+    // WebRtcSpl_AutoCorrelation() and the NetEq time stretching do.
+    const int kLags = 4;
+    const int dim_seq = n - kLags;
+    int32_t expected32[kLags];
+    int32_t actual32[kLags];
+    for (int right_shifts = 0; right_shifts <= 6 && dim_seq > 0;
+         right_shifts += 3) {
+      for (int step = -1; step <= 1; step += 2) {
+        const int16_t* seq2 =
+            step > 0 ? other_vector16 : other_vector16 + kLags - 1;
+        WebRtcSpl_CrossCorrelationC(expected32, v16, seq2, dim_seq, kLags,
+                                    right_shifts, step);
+        WebRtcSpl_CrossCorrelationSSE2(actual32, v16, seq2, dim_seq, kLags,
+                                       right_shifts, step);
+        for (int i = 0; i < kLags; ++i)
+          EXPECT_EQ(expected32[i], actual32[i]);
+        if (avx2) {
+          WebRtcSpl_CrossCorrelationAVX2(actual32, v16, seq2, dim_seq, kLags,
+                                         right_shifts, step);
+          for (int i = 0; i < kLags; ++i)
+            EXPECT_EQ(expected32[i], actual32[i]);
+        }
+      }
+    }
+
+    // Filter the full-scale samples with large coefficients, so that the
+    // output saturates.
+    int16_t coefficients[kMaxLength];
+    FillRandomW16(coefficients, length, &seed);
+    for (int coefficients_length = 1; coefficients_length <= n;
+         coefficients_length += 5) {
+      const int kFactor = 2;
+      const int delay = coefficients_length - 1;
+      const int out_length = (n - delay - 1) / kFactor + 1;
+      EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(
+          v16, n, expected16, out_length, coefficients, coefficients_length,
+          kFactor, delay));
+      EXPECT_EQ(0, WebRtcSpl_DownsampleFastSSE2(
+          v16, n, actual16, out_length, coefficients, coefficients_length,
+          kFactor, delay));
+      for (int i = 0; i < out_length; ++i)
+        EXPECT_EQ(expected16[i], actual16[i]);
+
+      // The first |coefficients_length| - 1 samples are the filter state.
+      int16_t* in = const_cast<int16_t*>(v16) + coefficients_length - 1;
+      const int16_t filter_length = n - coefficients_length + 1;
+      WebRtcSpl_FilterMAFastQ12C(in, expected16, coefficients,
+                                 coefficients_length, filter_length);
+      WebRtcSpl_FilterMAFastQ12SSE2(in, actual16, coefficients,
+                                    coefficients_length, filter_length);
+      for (int i = 0; i < filter_length; ++i)
+        EXPECT_EQ(expected16[i], actual16[i]);
+    }
+  }
+
+  // The saturated absolute value of WEBRTC_SPL_WORD32_MIN.
+  FillRandomW32(vector32, kMaxLength, &seed);
+  vector32[0] = WEBRTC_SPL_WORD32_MIN;
+  EXPECT_EQ(WEBRTC_SPL_WORD32_MAX, WebRtcSpl_MaxAbsValueW32SSE2(vector32, 1));
+  EXPECT_EQ(WEBRTC_SPL_WORD32_MAX,
+            WebRtcSpl_MaxAbsValueW32SSE2(vector32, kMaxLength));
+  if (avx2) {
+    EXPECT_EQ(WEBRTC_SPL_WORD32_MAX,
+              WebRtcSpl_MaxAbsValueW32AVX2(vector32, kMaxLength));
+  }
+
+  // The error cases.
+  EXPECT_EQ(-1, WebRtcSpl_MaxAbsValueW16SSE2(NULL, kMaxLength));
+  EXPECT_EQ(WEBRTC_SPL_WORD16_MIN, WebRtcSpl_MaxValueW16SSE2(vector16, 0));
+  EXPECT_EQ(WEBRTC_SPL_WORD32_MAX, WebRtcSpl_MinValueW32SSE2(vector32, 0));
+  EXPECT_EQ(-1, WebRtcSpl_DownsampleFastSSE2(vector16, 1, other_vector16, 2,
+                                             vector16, 1, 1, 0));
+  EXPECT_EQ(-1, WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+      vector16, 1, other_vector16, 1, -1, other_vector16, 1));
+}
+#endif
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of the C and x86 versions of every SPL function with a
+// function pointer, on vectors of the sizes the audio coding module uses.
+
+#include <math.h>
+#include <stdio.h>
+
+#include <string>
+
+#include "gflags/gflags.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/typedefs.h"
+
+DEFINE_int32(iterations, 100000, "The number of calls to time per version.");
+
+namespace webrtc {
+namespace {
+
+// 20 ms at 32 kHz.
+const int kLength = 640;
+// The cross correlation and down sampling sizes used by NetEq's time
+// stretching at 32 kHz.
+const int kCorrelationLength = 50;
+const int kCorrelationLags = 60;
+const int kCoefficientsLength = 7;
+const int kDownsampleFactor = 8;
+
+int16_t g_vector16[kLength];
+int16_t g_other_vector16[kLength];
+int32_t g_vector32[kLength];
+int16_t g_out16[kLength];
+int32_t g_out32[kCorrelationLags];
+const int16_t kCoefficients[kCoefficientsLength] = {
+  487, 1095, 1528, 1672, 1528, 1095, 487
+};
+// Keeps the results alive.
+volatile int32_t g_sink = 0;
+
+void FillInput() {
+  for (int i = 0; i < kLength; ++i) {
+    g_vector16[i] = static_cast<int16_t>(10000 * sin(i * 0.01));
+    g_other_vector16[i] = static_cast<int16_t>(10000 * cos(i * 0.013));
+    g_vector32[i] = g_vector16[i] << 14;
+  }
+}
+
+// Calls one version of a function on the global vectors.
+typedef void (*Kernel)();
+
+// Returns the average time in nanoseconds of a call to |kernel|.
+double TimeKernel(Kernel kernel) {
+  TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i)
+    kernel();
+  return static_cast<double>((TickTime::Now() - start).Microseconds()) * 1000 /
+      FLAGS_iterations;
+}
+
+// Prints the times of the versions of a function the CPU supports, and their
+// speedup over the C version. |sse2| and |avx2| may be NULL.
+void BenchmarkKernel(const char* name, Kernel c, Kernel sse2, Kernel avx2) {
+  double c_ns = TimeKernel(c);
+  printf("%-28s %10.1f", name, c_ns);
+  if (sse2 && WebRtc_GetCPUInfo(kSSE2)) {
+    double sse2_ns = TimeKernel(sse2);
+    printf(" %10.1f %7.2fx", sse2_ns, c_ns / sse2_ns);
+  } else {
+    printf(" %10s %8s", "-", "-");
+  }
+  if (avx2 && WebRtc_GetCPUInfo(kAVX2)) {
+    double avx2_ns = TimeKernel(avx2);
+    printf(" %10.1f %7.2fx", avx2_ns, c_ns / avx2_ns);
+  } else {
+    printf(" %10s %8s", "-", "-");
+  }
+  printf("\n");
+}
+
+#define MIN_MAX_KERNELS(function, vector) \
+  void function##C() { \
+    g_sink += WebRtcSpl_##function##C(vector, kLength); \
+  } \
+  void function##SSE2() { \
+    g_sink += WebRtcSpl_##function##SSE2(vector, kLength); \
+  } \
+  void function##AVX2() { \
+    g_sink += WebRtcSpl_##function##AVX2(vector, kLength); \
+  }
+MIN_MAX_KERNELS(MaxAbsValueW16, g_vector16)
+MIN_MAX_KERNELS(MaxAbsValueW32, g_vector32)
+MIN_MAX_KERNELS(MaxValueW16, g_vector16)
+MIN_MAX_KERNELS(MaxValueW32, g_vector32)
+MIN_MAX_KERNELS(MinValueW16, g_vector16)
+MIN_MAX_KERNELS(MinValueW32, g_vector32)
+#undef MIN_MAX_KERNELS
+
+#define CROSS_CORRELATION_KERNEL(version) \
+  void CrossCorrelation##version() { \
+    WebRtcSpl_CrossCorrelation##version(g_out32, g_vector16, \
+                                        g_other_vector16, kCorrelationLength, \
+                                        kCorrelationLags, 2, 1); \
+    g_sink += g_out32[0]; \
+  }
+CROSS_CORRELATION_KERNEL(C)
+CROSS_CORRELATION_KERNEL(SSE2)
+CROSS_CORRELATION_KERNEL(AVX2)
+#undef CROSS_CORRELATION_KERNEL
+
+#define DOWNSAMPLE_FAST_KERNEL(version) \
+  void DownsampleFast##version() { \
+    WebRtcSpl_DownsampleFast##version( \
+        g_vector16, kLength, g_out16, kLength / kDownsampleFactor, \
+        kCoefficients, kCoefficientsLength, kDownsampleFactor, \
+        kCoefficientsLength - 1); \
+    g_sink += g_out16[0]; \
+  }
+DOWNSAMPLE_FAST_KERNEL(C)
+DOWNSAMPLE_FAST_KERNEL(SSE2)
+#undef DOWNSAMPLE_FAST_KERNEL
+
+#define SCALE_AND_ADD_KERNEL(version) \
+  void ScaleAndAddVectorsWithRound##version() { \
+    WebRtcSpl_ScaleAndAddVectorsWithRound##version( \
+        g_vector16, 12000, g_other_vector16, 4384, 14, g_out16, kLength); \
+    g_sink += g_out16[0]; \
+  }
+SCALE_AND_ADD_KERNEL(C)
+SCALE_AND_ADD_KERNEL(SSE2)
+#undef SCALE_AND_ADD_KERNEL
+
+#define DOT_PRODUCT_KERNELS(version) \
+  void DotProductWithScale##version() { \
+    g_sink += WebRtcSpl_DotProductWithScale##version( \
+        g_vector16, g_other_vector16, kLength, 2); \
+  } \
+  void SumAbsDiffW16##version() { \
+    g_sink += WebRtcSpl_SumAbsDiffW16##version(g_vector16, g_other_vector16, \
+                                               kLength); \
+  }
+DOT_PRODUCT_KERNELS(C)
+DOT_PRODUCT_KERNELS(SSE2)
+#undef DOT_PRODUCT_KERNELS
+
+void RunBenchmark() {
+  FillInput();
+  printf("%-28s %10s %10s %8s %10s %8s\n", "function", "c_ns", "sse2_ns",
+         "speedup", "avx2_ns", "speedup");
+  BenchmarkKernel("MaxAbsValueW16", MaxAbsValueW16C, MaxAbsValueW16SSE2,
+                  MaxAbsValueW16AVX2);
+  BenchmarkKernel("MaxAbsValueW32", MaxAbsValueW32C, MaxAbsValueW32SSE2,
+                  MaxAbsValueW32AVX2);
+  BenchmarkKernel("MaxValueW16", MaxValueW16C, MaxValueW16SSE2,
+                  MaxValueW16AVX2);
+  BenchmarkKernel("MaxValueW32", MaxValueW32C, MaxValueW32SSE2,
+                  MaxValueW32AVX2);
+  BenchmarkKernel("MinValueW16", MinValueW16C, MinValueW16SSE2,
+                  MinValueW16AVX2);
+  BenchmarkKernel("MinValueW32", MinValueW32C, MinValueW32SSE2,
+                  MinValueW32AVX2);
+  BenchmarkKernel("CrossCorrelation", CrossCorrelationC, CrossCorrelationSSE2,
+                  CrossCorrelationAVX2);
+  BenchmarkKernel("DownsampleFast", DownsampleFastC, DownsampleFastSSE2, NULL);
+  BenchmarkKernel("ScaleAndAddVectorsWithRound", ScaleAndAddVectorsWithRoundC,
+                  ScaleAndAddVectorsWithRoundSSE2, NULL);
+  BenchmarkKernel("DotProductWithScale", DotProductWithScaleC,
+                  DotProductWithScaleSSE2, NULL);
+  BenchmarkKernel("SumAbsDiffW16", SumAbsDiffW16C, SumAbsDiffW16SSE2, NULL);
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string usage = "Benchmarks the C and x86 versions of the SPL "
+      "functions.\nExample usage:\n" + std::string(argv[0]) +
+      " --iterations=10000\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  webrtc::RunBenchmark();
+  return 0;
+}
@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers, currently only for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -26,7 +26,10 @@ MaxValueW32 WebRtcSpl_MaxValueW32;
 MinValueW16 WebRtcSpl_MinValueW16;
 MinValueW32 WebRtcSpl_MinValueW32;
 CrossCorrelation WebRtcSpl_CrossCorrelation;
+DotProductWithScale WebRtcSpl_DotProductWithScale;
+SumAbsDiffW16 WebRtcSpl_SumAbsDiffW16;
 DownsampleFast WebRtcSpl_DownsampleFast;
+FilterMAFastQ12 WebRtcSpl_FilterMAFastQ12;
 ScaleAndAddVectorsWithRound WebRtcSpl_ScaleAndAddVectorsWithRound;
 CreateRealFFT WebRtcSpl_CreateRealFFT;
 FreeRealFFT WebRtcSpl_FreeRealFFT;
@@ -44,7 +47,10 @@ static void InitPointersToC() {
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16C;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32C;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationC;
+  WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
+  WebRtcSpl_SumAbsDiffW16 = WebRtcSpl_SumAbsDiffW16C;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
+  WebRtcSpl_FilterMAFastQ12 = WebRtcSpl_FilterMAFastQ12C;
   WebRtcSpl_ScaleAndAddVectorsWithRound =
       WebRtcSpl_ScaleAndAddVectorsWithRoundC;
   WebRtcSpl_CreateRealFFT = WebRtcSpl_CreateRealFFTC;
@@ -64,7 +70,10 @@ static void InitPointersToNeon() {
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16Neon;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32Neon;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationNeon;
+  WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
+  WebRtcSpl_SumAbsDiffW16 = WebRtcSpl_SumAbsDiffW16C;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastNeon;
+  WebRtcSpl_FilterMAFastQ12 = WebRtcSpl_FilterMAFastQ12C;
   /* TODO(henrik.lundin): re-enable NEON when the crash from bug 3243 is
      understood. */
   WebRtcSpl_ScaleAndAddVectorsWithRound =
@@ -76,6 +85,42 @@ static void InitPointersToNeon() {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Initialize function pointers to the SSE2 version, and to the AVX2 version
+ * of the functions that have one if the CPU supports AVX2. The functions
+ * without an x86 version keep the generic C version.
+ */
+static void InitPointersToX86() {
+  InitPointersToC();
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    return;
+  }
+  WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE2;
+  WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32SSE2;
+  WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16SSE2;
+  WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32SSE2;
+  WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16SSE2;
+  WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32SSE2;
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+  WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleSSE2;
+  WebRtcSpl_SumAbsDiffW16 = WebRtcSpl_SumAbsDiffW16SSE2;
+  WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+  WebRtcSpl_FilterMAFastQ12 = WebRtcSpl_FilterMAFastQ12SSE2;
+  WebRtcSpl_ScaleAndAddVectorsWithRound =
+      WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2;
+  if (!WebRtc_GetCPUInfo(kAVX2)) {
+    return;
+  }
+  WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16AVX2;
+  WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32AVX2;
+  WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16AVX2;
+  WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32AVX2;
+  WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16AVX2;
+  WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32AVX2;
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationAVX2;
+}
+#endif
+
 #if defined(MIPS32_LE)
 /* Initialize function pointers to the MIPS version. */
 static void InitPointersToMIPS() {
@@ -85,7 +130,10 @@ static void InitPointersToMIPS() {
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16_mips;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32_mips;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelation_mips;
+  WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
+  WebRtcSpl_SumAbsDiffW16 = WebRtcSpl_SumAbsDiffW16C;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFast_mips;
+  WebRtcSpl_FilterMAFastQ12 = WebRtcSpl_FilterMAFastQ12C;
   WebRtcSpl_CreateRealFFT = WebRtcSpl_CreateRealFFTC;
   WebRtcSpl_FreeRealFFT = WebRtcSpl_FreeRealFFTC;
   WebRtcSpl_RealForwardFFT = WebRtcSpl_RealForwardFFTC;
@@ -113,6 +161,8 @@ static void InitFunctionPointers(void) {
   InitPointersToNeon();
 #elif defined(MIPS32_LE)
   InitPointersToMIPS();
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  InitPointersToX86();
 #else
   InitPointersToC();
 #endif  /* WEBRTC_DETECT_ARM_NEON */
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the SSE2 implementation of the function
+ * WebRtcSpl_ScaleAndAddVectorsWithRound()
+ *
+ * The description header can be found in signal_processing_library.h.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// SSE2 version of WebRtcSpl_ScaleAndAddVectorsWithRound(). The samples of the
+// two vectors are interleaved, so that _mm_madd_epi16() scales and adds them
+// in one go.
+int WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(const int16_t* in_vector1,
+                                              int16_t in_vector1_scale,
+                                              const int16_t* in_vector2,
+                                              int16_t in_vector2_scale,
+                                              int right_shifts,
+                                              int16_t* out_vector,
+                                              int length) {
+  int i = 0;
+  int round_value = (1 << right_shifts) >> 1;
+  __m128i scales;
+  __m128i round;
+  __m128i shift;
+
+  if (in_vector1 == NULL || in_vector2 == NULL || out_vector == NULL ||
+      length <= 0 || right_shifts < 0) {
+    return -1;
+  }
+
+  scales = _mm_set_epi16(in_vector2_scale, in_vector1_scale,
+                         in_vector2_scale, in_vector1_scale,
+                         in_vector2_scale, in_vector1_scale,
+                         in_vector2_scale, in_vector1_scale);
+  round = _mm_set1_epi32(round_value);
+  shift = _mm_cvtsi32_si128(right_shifts);
+  for (; i <= length - 8; i += 8) {
+    __m128i x1 = _mm_loadu_si128((const __m128i*)&in_vector1[i]);
+    __m128i x2 = _mm_loadu_si128((const __m128i*)&in_vector2[i]);
+    __m128i low = _mm_madd_epi16(_mm_unpacklo_epi16(x1, x2), scales);
+    __m128i high = _mm_madd_epi16(_mm_unpackhi_epi16(x1, x2), scales);
+    low = _mm_sra_epi32(_mm_add_epi32(low, round), shift);
+    high = _mm_sra_epi32(_mm_add_epi32(high, round), shift);
+    // The C version truncates to 16 bits rather than saturating, so sign
+    // extend the low halves before packing.
+    low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+    high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+    _mm_storeu_si128((__m128i*)&out_vector[i], _mm_packs_epi32(low, high));
+  }
+  for (; i < length; i++) {
+    out_vector[i] = (int16_t)((
+        WEBRTC_SPL_MUL_16_16(in_vector1[i], in_vector1_scale)
+        + WEBRTC_SPL_MUL_16_16(in_vector2[i], in_vector2_scale)
+        + round_value) >> right_shifts);
+  }
+
+  return 0;
+}
@@ -10,10 +10,14 @@
 
 #include "webrtc/common_audio/vad/vad_core.h"
 
+#include <assert.h>
+#include <string.h>
+
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/common_audio/vad/vad_filterbank.h"
 #include "webrtc/common_audio/vad/vad_gmm.h"
 #include "webrtc/common_audio/vad/vad_sp.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/typedefs.h"
 
 // Spectrum Weighting
@@ -600,14 +604,76 @@ int WebRtcVad_set_mode_core(VadInstT* self, int mode) {
   return return_value;
 }
 
+// Returns 1 if |speech_frame|, sampled at |fs|, and the filter states of
+// |self| it would pass through are all zero, and 0 otherwise. The filters then
+// output zeros only, and keep their states, so the features need not be
+// calculated; the frame has no energy and the background models are not
+// updated. 48 kHz frames are never treated as silence, since the resampler
+// does not keep a zero state.
+static int IsDigitalSilence(const VadInstT* self, int fs,
+                            const int16_t* speech_frame, int frame_length) {
+  int num_downsampling_states = 0;
+  int i;
+
+  if (fs == 48000) {
+    return 0;
+  }
+  for (i = 0; i < frame_length; i++) {
+    if (speech_frame[i] != 0) {
+      return 0;
+    }
+  }
+  if (fs == 16000) {
+    num_downsampling_states = 2;
+  } else if (fs == 32000) {
+    num_downsampling_states = 4;
+  }
+  for (i = 0; i < num_downsampling_states; i++) {
+    if (self->downsampling_filter_states[i] != 0) {
+      return 0;
+    }
+  }
+  for (i = 0; i < 5; i++) {
+    if (self->upper_state[i] != 0 || self->lower_state[i] != 0) {
+      return 0;
+    }
+  }
+  for (i = 0; i < 4; i++) {
+    if (self->hp_filter_state[i] != 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Makes the VAD decision of |self| on a frame of digital silence, see
+// IsDigitalSilence(). |frame_length| is the number of samples at 8 kHz.
+static int CalcVadSilence(VadInstT* self, int frame_length) {
+  // |features| are not used when the total power is below |kMinEnergy|.
+  int16_t features[kNumChannels] = { 0 };
+
+  self->vad = GmmProbability(self, features, 0, frame_length);
+  return self->vad;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static int UseSSE2(void) {
+#if defined(__SSE2__)
+  return 1;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) != 0;
+#endif
+}
+#endif
+
 // Calculate VAD decision by first extracting feature values and then calculate
 // probability for both speech and background noise.
 
-int WebRtcVad_CalcVad48khz(VadInstT* inst, const int16_t* speech_frame,
-                           int frame_length) {
-  int vad;
+// Resamples the 48 kHz |speech_frame| to 8 kHz |speech_nb|, with the resampler
+// state of |inst|.
+static void Resample48khzTo8khz(VadInstT* inst, const int16_t* speech_frame,
+                                int frame_length, int16_t* speech_nb) {
   int i;
-  int16_t speech_nb[240];  // 30 ms in 8 kHz.
   // |tmp_mem| is a temporary memory used by resample function, length is
   // frame length in 10 ms (480 samples) + 256 extra.
   int32_t tmp_mem[480 + 256] = { 0 };
@@ -621,6 +687,14 @@ int WebRtcVad_CalcVad48khz(VadInstT* inst, const int16_t* speech_frame,
                                   &inst->state_48_to_8,
                                   tmp_mem);
   }
+}
+
+int WebRtcVad_CalcVad48khz(VadInstT* inst, const int16_t* speech_frame,
+                           int frame_length) {
+  int vad;
+  int16_t speech_nb[240];  // 30 ms in 8 kHz.
+
+  Resample48khzTo8khz(inst, speech_frame, frame_length, speech_nb);
 
   // Do VAD on an 8 kHz signal
   vad = WebRtcVad_CalcVad8khz(inst, speech_nb, frame_length / 6);
@@ -636,6 +710,10 @@ int WebRtcVad_CalcVad32khz(VadInstT* inst, const int16_t* speech_frame,
     int16_t speechNB[240]; // Downsampled speech frame: 480 samples (30ms in WB)
 
 
+    if (IsDigitalSilence(inst, 32000, speech_frame, frame_length)) {
+        return CalcVadSilence(inst, frame_length / 4);
+    }
+
     // Downsample signal 32->16->8 before doing VAD
     WebRtcVad_Downsampling(speech_frame, speechWB, &(inst->downsampling_filter_states[2]),
                            frame_length);
@@ -656,6 +734,10 @@ int WebRtcVad_CalcVad16khz(VadInstT* inst, const int16_t* speech_frame,
     int len, vad;
     int16_t speechNB[240]; // Downsampled speech frame: 480 samples (30ms in WB)
 
+    if (IsDigitalSilence(inst, 16000, speech_frame, frame_length)) {
+        return CalcVadSilence(inst, frame_length / 2);
+    }
+
     // Wideband: Downsample signal before doing VAD
     WebRtcVad_Downsampling(speech_frame, speechNB, inst->downsampling_filter_states,
                            frame_length);
@@ -671,6 +753,10 @@ int WebRtcVad_CalcVad8khz(VadInstT* inst, const int16_t* speech_frame,
 {
     int16_t feature_vector[kNumChannels], total_power;
 
+    if (IsDigitalSilence(inst, 8000, speech_frame, frame_length)) {
+        return CalcVadSilence(inst, frame_length);
+    }
+
     // Get power in the bands
     total_power = WebRtcVad_CalculateFeatures(inst, speech_frame, frame_length,
                                               feature_vector);
@@ -680,3 +766,101 @@ int WebRtcVad_CalcVad8khz(VadInstT* inst, const int16_t* speech_frame,
 
     return inst->vad;
 }
+
+void WebRtcVad_CalcVadMultiple(VadInstT* const* instances, int num_instances,
+                               int fs, const int16_t* const* speech_frames,
+                               int frame_length, int* vad_decisions) {
+  int i;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // The 48 kHz frames are resampled to 8 kHz first, as in
+  // WebRtcVad_CalcVad48khz().
+  int16_t speech_nb[kNumSse2Lanes][240];  // 30 ms in 8 kHz.
+  const int16_t* frames[kNumSse2Lanes];
+  VadInstT* selves[kNumSse2Lanes];
+  int indices[kNumSse2Lanes];
+  int16_t bands[kNumSse2Lanes][kNumChannels][kMaxBandLength];
+  VadInstT scratch;
+  const int filter_fs = (fs == 48000) ? 8000 : fs;
+  const int filter_length = (fs == 48000) ? frame_length / 6 : frame_length;
+  const int nb_length = frame_length * 8000 / fs;
+  int num_lanes = 0;
+  int k;
+
+  if (UseSSE2()) {
+    for (i = 0; i < num_instances; i++) {
+      if (IsDigitalSilence(instances[i], fs, speech_frames[i], frame_length)) {
+        vad_decisions[i] = CalcVadSilence(instances[i], nb_length);
+      } else {
+        indices[num_lanes] = i;
+        selves[num_lanes] = instances[i];
+        frames[num_lanes] = speech_frames[i];
+        if (fs == 48000) {
+          Resample48khzTo8khz(instances[i], speech_frames[i], frame_length,
+                              speech_nb[num_lanes]);
+          frames[num_lanes] = speech_nb[num_lanes];
+        }
+        num_lanes++;
+      }
+      if (num_lanes == 0 ||
+          (num_lanes < kNumSse2Lanes && i < num_instances - 1)) {
+        continue;
+      }
+
+      if (num_lanes == 1) {
+        // Nothing to share the lanes with.
+        if (filter_fs == 32000) {
+          vad_decisions[indices[0]] = WebRtcVad_CalcVad32khz(
+              selves[0], frames[0], filter_length);
+        } else if (filter_fs == 16000) {
+          vad_decisions[indices[0]] = WebRtcVad_CalcVad16khz(
+              selves[0], frames[0], filter_length);
+        } else {
+          vad_decisions[indices[0]] = WebRtcVad_CalcVad8khz(
+              selves[0], frames[0], filter_length);
+        }
+        num_lanes = 0;
+        continue;
+      }
+
+      // Fill the unused lanes with a copy of the first instance, whose results
+      // are thrown away.
+      if (num_lanes < kNumSse2Lanes) {
+        memcpy(&scratch, selves[0], sizeof(scratch));
+      }
+      for (k = num_lanes; k < kNumSse2Lanes; k++) {
+        selves[k] = &scratch;
+        frames[k] = frames[0];
+      }
+
+      WebRtcVad_SplitBandsSSE2(selves, filter_fs, frames, filter_length,
+                               bands);
+      for (k = 0; k < num_lanes; k++) {
+        int16_t feature_vector[kNumChannels];
+        int16_t total_power = WebRtcVad_LogOfBandEnergies(bands[k], nb_length,
+                                                          feature_vector);
+        selves[k]->vad = GmmProbability(selves[k], feature_vector,
+                                        total_power, nb_length);
+        vad_decisions[indices[k]] = selves[k]->vad;
+      }
+      num_lanes = 0;
+    }
+    return;
+  }
+#endif
+
+  for (i = 0; i < num_instances; i++) {
+    if (fs == 48000) {
+      vad_decisions[i] = WebRtcVad_CalcVad48khz(instances[i], speech_frames[i],
+                                                frame_length);
+    } else if (fs == 32000) {
+      vad_decisions[i] = WebRtcVad_CalcVad32khz(instances[i], speech_frames[i],
+                                                frame_length);
+    } else if (fs == 16000) {
+      vad_decisions[i] = WebRtcVad_CalcVad16khz(instances[i], speech_frames[i],
+                                                frame_length);
+    } else {
+      vad_decisions[i] = WebRtcVad_CalcVad8khz(instances[i], speech_frames[i],
+                                               frame_length);
+    }
+  }
+}
@@ -112,4 +112,20 @@ int WebRtcVad_CalcVad16khz(VadInstT* inst, const int16_t* speech_frame,
 int WebRtcVad_CalcVad8khz(VadInstT* inst, const int16_t* speech_frame,
                           int frame_length);
 
+// Makes the VAD decisions of |num_instances| instances at once, each on its
+// own frame, like the WebRtcVad_CalcVadXXkhz() function for |fs| does. On
+// x86 with SSE2 the frequency bands of up to four instances are calculated at
+// the same time, and the results are identical to those of separate calls.
+//
+// - instances     [i/o] : The VAD instances, with updated states.
+// - num_instances [i]   : Number of instances.
+// - fs            [i]   : Sampling frequency of all frames.
+// - speech_frames [i]   : The input frame of each instance.
+// - frame_length  [i]   : Number of samples in each frame.
+// - vad_decisions [o]   : The VAD decision of each instance, as returned by
+//                         WebRtcVad_CalcVadXXkhz().
+void WebRtcVad_CalcVadMultiple(VadInstT* const* instances, int num_instances,
+                               int fs, const int16_t* const* speech_frames,
+                               int frame_length, int* vad_decisions);
+
 #endif  // WEBRTC_COMMON_AUDIO_VAD_VAD_CORE_H_
@@ -20,12 +20,12 @@ static const int16_t kLogConst = 24660;  // 160*log10(2) in Q9.
 static const int16_t kLogEnergyIntPart = 14336;  // 14 in Q10
 
 // Coefficients used by HighPassFilter, Q14.
-static const int16_t kHpZeroCoefs[3] = { 6631, -13262, 6631 };
-static const int16_t kHpPoleCoefs[3] = { 16384, -7756, 5620 };
+const int16_t WebRtcVad_kHpZeroCoefs[3] = { 6631, -13262, 6631 };
+const int16_t WebRtcVad_kHpPoleCoefs[3] = { 16384, -7756, 5620 };
 
 // Allpass filter coefficients, upper and lower, in Q15.
 // Upper: 0.64, Lower: 0.17
-static const int16_t kAllPassCoefsQ15[2] = { 20972, 5571 };
+const int16_t WebRtcVad_kAllPassCoefsQ15[2] = { 20972, 5571 };
 
 // Adjustment for division with two in SplitFilter.
 static const int16_t kOffsetVector[6] = { 368, 368, 272, 176, 176, 176 };
@@ -56,15 +56,15 @@ static void HighPassFilter(const int16_t* data_in, int data_length,
 
   for (i = 0; i < data_length; i++) {
     // All-zero section (filter coefficients in Q14).
-    tmp32 = WEBRTC_SPL_MUL_16_16(kHpZeroCoefs[0], *in_ptr);
-    tmp32 += WEBRTC_SPL_MUL_16_16(kHpZeroCoefs[1], filter_state[0]);
-    tmp32 += WEBRTC_SPL_MUL_16_16(kHpZeroCoefs[2], filter_state[1]);
+    tmp32 = WEBRTC_SPL_MUL_16_16(WebRtcVad_kHpZeroCoefs[0], *in_ptr);
+    tmp32 += WEBRTC_SPL_MUL_16_16(WebRtcVad_kHpZeroCoefs[1], filter_state[0]);
+    tmp32 += WEBRTC_SPL_MUL_16_16(WebRtcVad_kHpZeroCoefs[2], filter_state[1]);
     filter_state[1] = filter_state[0];
     filter_state[0] = *in_ptr++;
 
     // All-pole section (filter coefficients in Q14).
-    tmp32 -= WEBRTC_SPL_MUL_16_16(kHpPoleCoefs[1], filter_state[2]);
-    tmp32 -= WEBRTC_SPL_MUL_16_16(kHpPoleCoefs[2], filter_state[3]);
+    tmp32 -= WEBRTC_SPL_MUL_16_16(WebRtcVad_kHpPoleCoefs[1], filter_state[2]);
+    tmp32 -= WEBRTC_SPL_MUL_16_16(WebRtcVad_kHpPoleCoefs[2], filter_state[3]);
     filter_state[3] = filter_state[2];
     filter_state[2] = (int16_t) (tmp32 >> 14);
     *out_ptr++ = filter_state[2];
@@ -126,11 +126,13 @@ static void SplitFilter(const int16_t* data_in, int data_length,
   int16_t tmp_out;
 
   // All-pass filtering upper branch.
-  AllPassFilter(&data_in[0], half_length, kAllPassCoefsQ15[0], upper_state,
+  AllPassFilter(&data_in[0], half_length, WebRtcVad_kAllPassCoefsQ15[0],
+                upper_state,
                 hp_data_out);
 
   // All-pass filtering lower branch.
-  AllPassFilter(&data_in[1], half_length, kAllPassCoefsQ15[1], lower_state,
+  AllPassFilter(&data_in[1], half_length, WebRtcVad_kAllPassCoefsQ15[1],
+                lower_state,
                 lp_data_out);
 
   // Make LP and HP signals.
@@ -246,13 +248,21 @@ static void LogOfEnergy(const int16_t* data_in, int data_length,
 
 int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
                                     int data_length, int16_t* features) {
-  int16_t total_energy = 0;
+  int16_t bands[kNumChannels][kMaxBandLength];
+
+  WebRtcVad_SplitBands(self, data_in, data_length, bands);
+  return WebRtcVad_LogOfBandEnergies(bands, data_length, features);
+}
+
+void WebRtcVad_SplitBands(VadInstT* self, const int16_t* data_in,
+                          int data_length,
+                          int16_t bands[kNumChannels][kMaxBandLength]) {
   // We expect |data_length| to be 80, 160 or 240 samples, which corresponds to
   // 10, 20 or 30 ms in 8 kHz. Therefore, the intermediate downsampled data will
   // have at most 120 samples after the first split and at most 60 samples after
   // the second split.
   int16_t hp_120[120], lp_120[120];
-  int16_t hp_60[60], lp_60[60];
+  int16_t lp_60[60];
   const int half_data_length = data_length >> 1;
   int length = half_data_length;  // |data_length| / 2, corresponds to
                                   // bandwidth = 2000 Hz after downsampling.
@@ -274,61 +284,67 @@ int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
   // For the upper band (2000 Hz - 4000 Hz) split at 3000 Hz and downsample.
   frequency_band = 1;
   in_ptr = hp_120;  // [2000 - 4000] Hz.
-  hp_out_ptr = hp_60;  // [3000 - 4000] Hz.
-  lp_out_ptr = lp_60;  // [2000 - 3000] Hz.
+  hp_out_ptr = bands[5];  // [3000 - 4000] Hz.
+  lp_out_ptr = bands[4];  // [2000 - 3000] Hz.
   SplitFilter(in_ptr, length, &self->upper_state[frequency_band],
               &self->lower_state[frequency_band], hp_out_ptr, lp_out_ptr);
 
-  // Energy in 3000 Hz - 4000 Hz.
-  length >>= 1;  // |data_length| / 4 <=> bandwidth = 1000 Hz.
-
-  LogOfEnergy(hp_60, length, kOffsetVector[5], &total_energy, &features[5]);
-
-  // Energy in 2000 Hz - 3000 Hz.
-  LogOfEnergy(lp_60, length, kOffsetVector[4], &total_energy, &features[4]);
-
   // For the lower band (0 Hz - 2000 Hz) split at 1000 Hz and downsample.
   frequency_band = 2;
   in_ptr = lp_120;  // [0 - 2000] Hz.
-  hp_out_ptr = hp_60;  // [1000 - 2000] Hz.
+  hp_out_ptr = bands[3];  // [1000 - 2000] Hz.
   lp_out_ptr = lp_60;  // [0 - 1000] Hz.
-  length = half_data_length;  // |data_length| / 2 <=> bandwidth = 2000 Hz.
   SplitFilter(in_ptr, length, &self->upper_state[frequency_band],
               &self->lower_state[frequency_band], hp_out_ptr, lp_out_ptr);
 
-  // Energy in 1000 Hz - 2000 Hz.
-  length >>= 1;  // |data_length| / 4 <=> bandwidth = 1000 Hz.
-  LogOfEnergy(hp_60, length, kOffsetVector[3], &total_energy, &features[3]);
-
   // For the lower band (0 Hz - 1000 Hz) split at 500 Hz and downsample.
   frequency_band = 3;
+  length >>= 1;  // |data_length| / 4 <=> bandwidth = 1000 Hz.
   in_ptr = lp_60;  // [0 - 1000] Hz.
-  hp_out_ptr = hp_120;  // [500 - 1000] Hz.
+  hp_out_ptr = bands[2];  // [500 - 1000] Hz.
   lp_out_ptr = lp_120;  // [0 - 500] Hz.
   SplitFilter(in_ptr, length, &self->upper_state[frequency_band],
               &self->lower_state[frequency_band], hp_out_ptr, lp_out_ptr);
 
-  // Energy in 500 Hz - 1000 Hz.
-  length >>= 1;  // |data_length| / 8 <=> bandwidth = 500 Hz.
-  LogOfEnergy(hp_120, length, kOffsetVector[2], &total_energy, &features[2]);
-
   // For the lower band (0 Hz - 500 Hz) split at 250 Hz and downsample.
   frequency_band = 4;
+  length >>= 1;  // |data_length| / 8 <=> bandwidth = 500 Hz.
   in_ptr = lp_120;  // [0 - 500] Hz.
-  hp_out_ptr = hp_60;  // [250 - 500] Hz.
+  hp_out_ptr = bands[1];  // [250 - 500] Hz.
   lp_out_ptr = lp_60;  // [0 - 250] Hz.
   SplitFilter(in_ptr, length, &self->upper_state[frequency_band],
               &self->lower_state[frequency_band], hp_out_ptr, lp_out_ptr);
 
-  // Energy in 250 Hz - 500 Hz.
+  // Remove 0 Hz - 80 Hz, by high pass filtering the lower band.
   length >>= 1;  // |data_length| / 16 <=> bandwidth = 250 Hz.
-  LogOfEnergy(hp_60, length, kOffsetVector[1], &total_energy, &features[1]);
+  HighPassFilter(lp_60, length, self->hp_filter_state, bands[0]);
+}
 
-  // Remove 0 Hz - 80 Hz, by high pass filtering the lower band.
-  HighPassFilter(lp_60, length, self->hp_filter_state, hp_120);
+int16_t WebRtcVad_LogOfBandEnergies(
+    int16_t bands[kNumChannels][kMaxBandLength], int data_length,
+    int16_t* features) {
+  int16_t total_energy = 0;
+  int length = data_length >> 2;  // Bandwidth = 1000 Hz.
+
+  // Energy in 3000 Hz - 4000 Hz.
+  LogOfEnergy(bands[5], length, kOffsetVector[5], &total_energy, &features[5]);
+
+  // Energy in 2000 Hz - 3000 Hz.
+  LogOfEnergy(bands[4], length, kOffsetVector[4], &total_energy, &features[4]);
+
+  // Energy in 1000 Hz - 2000 Hz.
+  LogOfEnergy(bands[3], length, kOffsetVector[3], &total_energy, &features[3]);
+
+  // Energy in 500 Hz - 1000 Hz.
+  length >>= 1;  // Bandwidth = 500 Hz.
+  LogOfEnergy(bands[2], length, kOffsetVector[2], &total_energy, &features[2]);
+
+  // Energy in 250 Hz - 500 Hz.
+  length >>= 1;  // Bandwidth = 250 Hz.
+  LogOfEnergy(bands[1], length, kOffsetVector[1], &total_energy, &features[1]);
 
   // Energy in 80 Hz - 250 Hz.
-  LogOfEnergy(hp_120, length, kOffsetVector[0], &total_energy, &features[0]);
+  LogOfEnergy(bands[0], length, kOffsetVector[0], &total_energy, &features[0]);
 
   return total_energy;
 }
@@ -18,6 +18,18 @@
 #include "webrtc/common_audio/vad/vad_core.h"
 #include "webrtc/typedefs.h"
 
+// Maximum number of samples in a frequency band, for 30 ms at 8 kHz.
+enum { kMaxBandLength = 60 };
+
+// Number of VAD instances that WebRtcVad_SplitBandsSSE2() filters at once.
+enum { kNumSse2Lanes = 4 };
+
+// Filter coefficients of the high pass filter, in Q14, and of the all-pass
+// filters of the bands, in Q15.
+extern const int16_t WebRtcVad_kHpZeroCoefs[3];
+extern const int16_t WebRtcVad_kHpPoleCoefs[3];
+extern const int16_t WebRtcVad_kAllPassCoefsQ15[2];
+
 // Takes |data_length| samples of |data_in| and calculates the logarithm of the
 // energy of each of the |kNumChannels| = 6 frequency bands used by the VAD:
 //        80 Hz - 250 Hz
@@ -41,4 +53,33 @@
 int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
                                     int data_length, int16_t* features);
 
+// The two steps of WebRtcVad_CalculateFeatures(). WebRtcVad_SplitBands()
+// splits |data_in| into the |kNumChannels| frequency bands, lowest first,
+// and WebRtcVad_LogOfBandEnergies() calculates the features from them. The
+// bands have |data_length| / 4 samples for 1000 Hz - 4000 Hz, half of that
+// for 500 Hz - 1000 Hz and a quarter for 80 Hz - 500 Hz.
+void WebRtcVad_SplitBands(VadInstT* self, const int16_t* data_in,
+                          int data_length,
+                          int16_t bands[kNumChannels][kMaxBandLength]);
+int16_t WebRtcVad_LogOfBandEnergies(
+    int16_t bands[kNumChannels][kMaxBandLength], int data_length,
+    int16_t* features);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// SSE2 version of WebRtcVad_SplitBands() for |kNumSse2Lanes| instances at
+// once, in separate lanes. Each of |frames| is first downsampled from |fs|
+// (8000, 16000 or 32000 Hz) to 8 kHz like WebRtcVad_Downsampling() does in
+// WebRtcVad_CalcVad16khz() and WebRtcVad_CalcVad32khz(). The bands of the
+// frame of |selves[i]| are written to |bands[i]|.
+//
+// - selves       [i/o] : The instances, whose filter states are updated.
+// - fs           [i]   : Sampling frequency of |frames|.
+// - frames       [i]   : The frame of each instance.
+// - frame_length [i]   : Number of samples in each frame.
+// - bands        [o]   : The frequency bands of each instance.
+void WebRtcVad_SplitBandsSSE2(VadInstT* const* selves, int fs,
+                              const int16_t* const* frames, int frame_length,
+                              int16_t bands[][kNumChannels][kMaxBandLength]);
+#endif
+
 #endif  // WEBRTC_COMMON_AUDIO_VAD_VAD_FILTERBANK_H_
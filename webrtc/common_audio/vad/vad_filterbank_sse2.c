@@ -0,0 +1,296 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/vad/vad_filterbank.h"
+
+#include <assert.h>
+#include <emmintrin.h>
+
+#include "webrtc/common_audio/vad/vad_sp.h"
+#include "webrtc/typedefs.h"
+
+// The filters are those of vad_filterbank.c and WebRtcVad_Downsampling() in
+// vad_sp.c, computed on the signals of |kNumSse2Lanes| instances at once. Each
+// sample is kept as a vector of 32-bit lanes, one per instance, holding the
+// sign extended 16-bit value of the scalar version. The 16x16-bit
+// multiplications of the scalar versions are done with _mm_madd_epi16() and a
+// coefficient in the low half of each lane, and the int16_t casts by sign
+// extending the low half. This gives results identical to the scalar versions.
+
+// Maximum number of samples at 16 kHz, for 30 ms.
+#define MAX_WIDEBAND_LENGTH 480
+
+// Returns |coefficient| in the low half of each lane, for MulW16().
+static __m128i CoefficientW16(int16_t coefficient) {
+  return _mm_set1_epi32(coefficient & 0xFFFF);
+}
+
+// Multiplies the 16-bit values in each lane of |a| by |coefficient|, from
+// CoefficientW16(), like WEBRTC_SPL_MUL_16_16().
+static __m128i MulW16(__m128i a, __m128i coefficient) {
+  return _mm_madd_epi16(a, coefficient);
+}
+
+// Casts each lane to int16_t, and sign extends it back.
+static __m128i CastW16(__m128i a) {
+  return _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+}
+
+static __m128i GatherW16(const int16_t* const* data, int index) {
+  return _mm_setr_epi32(data[0][index], data[1][index], data[2][index],
+                        data[3][index]);
+}
+
+// One output sample of WebRtcVad_Downsampling(), from the input samples
+// |upper| and |lower|.
+static __m128i DownsamplingSample(__m128i upper, __m128i lower,
+                                  __m128i* state_upper, __m128i* state_lower) {
+  const __m128i coefficient_upper = CoefficientW16(WebRtcVad_kAllPassCoefsQ13[0]);
+  const __m128i coefficient_lower = CoefficientW16(WebRtcVad_kAllPassCoefsQ13[1]);
+  const __m128i out_upper = CastW16(_mm_add_epi32(
+      _mm_srai_epi32(*state_upper, 1),
+      _mm_srai_epi32(MulW16(upper, coefficient_upper), 14)));
+  const __m128i out_lower = CastW16(_mm_add_epi32(
+      _mm_srai_epi32(*state_lower, 1),
+      _mm_srai_epi32(MulW16(lower, coefficient_lower), 14)));
+  *state_upper = _mm_sub_epi32(
+      upper, _mm_srai_epi32(MulW16(out_upper, coefficient_upper), 12));
+  *state_lower = _mm_sub_epi32(
+      lower, _mm_srai_epi32(MulW16(out_lower, coefficient_lower), 12));
+  return CastW16(_mm_add_epi32(out_upper, out_lower));
+}
+
+static void LoadDownsamplingStates(VadInstT* const* selves, int index,
+                                   __m128i* state_upper,
+                                   __m128i* state_lower) {
+  *state_upper = _mm_setr_epi32(selves[0]->downsampling_filter_states[index],
+                                selves[1]->downsampling_filter_states[index],
+                                selves[2]->downsampling_filter_states[index],
+                                selves[3]->downsampling_filter_states[index]);
+  *state_lower = _mm_setr_epi32(
+      selves[0]->downsampling_filter_states[index + 1],
+      selves[1]->downsampling_filter_states[index + 1],
+      selves[2]->downsampling_filter_states[index + 1],
+      selves[3]->downsampling_filter_states[index + 1]);
+}
+
+static void StoreDownsamplingStates(__m128i state_upper, __m128i state_lower,
+                                    int index, VadInstT* const* selves) {
+  int32_t upper[4];
+  int32_t lower[4];
+  int i;
+  _mm_storeu_si128((__m128i*) upper, state_upper);
+  _mm_storeu_si128((__m128i*) lower, state_lower);
+  for (i = 0; i < kNumSse2Lanes; i++) {
+    selves[i]->downsampling_filter_states[index] = upper[i];
+    selves[i]->downsampling_filter_states[index + 1] = lower[i];
+  }
+}
+
+// WebRtcVad_Downsampling() of |in_length| samples of |frames|, using the
+// states starting at |state_index|.
+static void DownsampleFrames(const int16_t* const* frames, int in_length,
+                             int state_index, VadInstT* const* selves,
+                             __m128i* out) {
+  __m128i state_upper, state_lower;
+  int n;
+  LoadDownsamplingStates(selves, state_index, &state_upper, &state_lower);
+  for (n = 0; n < in_length / 2; n++) {
+    out[n] = DownsamplingSample(GatherW16(frames, 2 * n),
+                                GatherW16(frames, 2 * n + 1),
+                                &state_upper, &state_lower);
+  }
+  StoreDownsamplingStates(state_upper, state_lower, state_index, selves);
+}
+
+// WebRtcVad_Downsampling() of |in_length| lane vectors.
+static void DownsampleLanes(const __m128i* in, int in_length, int state_index,
+                            VadInstT* const* selves, __m128i* out) {
+  __m128i state_upper, state_lower;
+  int n;
+  LoadDownsamplingStates(selves, state_index, &state_upper, &state_lower);
+  for (n = 0; n < in_length / 2; n++) {
+    out[n] = DownsamplingSample(in[2 * n], in[2 * n + 1], &state_upper,
+                                &state_lower);
+  }
+  StoreDownsamplingStates(state_upper, state_lower, state_index, selves);
+}
+
+// AllPassFilter() of vad_filterbank.c, from every second vector of |in|.
+static void AllPassFilter(const __m128i* in, int data_length,
+                          int16_t filter_coefficient, __m128i* filter_state,
+                          __m128i* out) {
+  const __m128i coefficient = CoefficientW16(filter_coefficient);
+  __m128i state32 = _mm_slli_epi32(*filter_state, 16);  // Q15
+  int i;
+
+  for (i = 0; i < data_length; i++) {
+    const __m128i tmp32 = _mm_add_epi32(state32, MulW16(*in, coefficient));
+    const __m128i tmp16 = _mm_srai_epi32(tmp32, 16);  // Q(-1)
+    out[i] = tmp16;
+    state32 = _mm_slli_epi32(_mm_sub_epi32(_mm_slli_epi32(*in, 14),  // Q14
+                                           MulW16(tmp16, coefficient)),
+                             1);  // Q15.
+    in += 2;
+  }
+
+  *filter_state = _mm_srai_epi32(state32, 16);  // Q(-1)
+}
+
+// SplitFilter() of vad_filterbank.c, with the states of |frequency_band|.
+static void SplitFilter(const __m128i* in, int data_length,
+                        int frequency_band, VadInstT* const* selves,
+                        __m128i* hp_out, __m128i* lp_out) {
+  const int half_length = data_length >> 1;  // Downsampling by 2.
+  __m128i upper_state = _mm_setr_epi32(selves[0]->upper_state[frequency_band],
+                                       selves[1]->upper_state[frequency_band],
+                                       selves[2]->upper_state[frequency_band],
+                                       selves[3]->upper_state[frequency_band]);
+  __m128i lower_state = _mm_setr_epi32(selves[0]->lower_state[frequency_band],
+                                       selves[1]->lower_state[frequency_band],
+                                       selves[2]->lower_state[frequency_band],
+                                       selves[3]->lower_state[frequency_band]);
+  int32_t upper[4];
+  int32_t lower[4];
+  int i;
+
+  AllPassFilter(&in[0], half_length, WebRtcVad_kAllPassCoefsQ15[0],
+                &upper_state, hp_out);
+  AllPassFilter(&in[1], half_length, WebRtcVad_kAllPassCoefsQ15[1],
+                &lower_state, lp_out);
+
+  _mm_storeu_si128((__m128i*) upper, upper_state);
+  _mm_storeu_si128((__m128i*) lower, lower_state);
+  for (i = 0; i < kNumSse2Lanes; i++) {
+    selves[i]->upper_state[frequency_band] = (int16_t) upper[i];
+    selves[i]->lower_state[frequency_band] = (int16_t) lower[i];
+  }
+
+  // Make LP and HP signals.
+  for (i = 0; i < half_length; i++) {
+    const __m128i tmp_out = hp_out[i];
+    hp_out[i] = CastW16(_mm_sub_epi32(hp_out[i], lp_out[i]));
+    lp_out[i] = CastW16(_mm_add_epi32(lp_out[i], tmp_out));
+  }
+}
+
+// HighPassFilter() of vad_filterbank.c.
+static void HighPassFilter(const __m128i* in, int data_length,
+                           VadInstT* const* selves, __m128i* out) {
+  const __m128i zero0 = CoefficientW16(WebRtcVad_kHpZeroCoefs[0]);
+  const __m128i zero1 = CoefficientW16(WebRtcVad_kHpZeroCoefs[1]);
+  const __m128i zero2 = CoefficientW16(WebRtcVad_kHpZeroCoefs[2]);
+  const __m128i pole1 = CoefficientW16(WebRtcVad_kHpPoleCoefs[1]);
+  const __m128i pole2 = CoefficientW16(WebRtcVad_kHpPoleCoefs[2]);
+  __m128i filter_state[4];
+  int32_t state[4];
+  int i, j;
+
+  for (j = 0; j < 4; j++) {
+    filter_state[j] = _mm_setr_epi32(selves[0]->hp_filter_state[j],
+                                     selves[1]->hp_filter_state[j],
+                                     selves[2]->hp_filter_state[j],
+                                     selves[3]->hp_filter_state[j]);
+  }
+
+  for (i = 0; i < data_length; i++) {
+    // All-zero section (filter coefficients in Q14).
+    __m128i tmp32 = MulW16(in[i], zero0);
+    tmp32 = _mm_add_epi32(tmp32, MulW16(filter_state[0], zero1));
+    tmp32 = _mm_add_epi32(tmp32, MulW16(filter_state[1], zero2));
+    filter_state[1] = filter_state[0];
+    filter_state[0] = in[i];
+
+    // All-pole section (filter coefficients in Q14).
+    tmp32 = _mm_sub_epi32(tmp32, MulW16(filter_state[2], pole1));
+    tmp32 = _mm_sub_epi32(tmp32, MulW16(filter_state[3], pole2));
+    filter_state[3] = filter_state[2];
+    filter_state[2] = CastW16(_mm_srai_epi32(tmp32, 14));
+    out[i] = filter_state[2];
+  }
+
+  for (j = 0; j < 4; j++) {
+    _mm_storeu_si128((__m128i*) state, filter_state[j]);
+    for (i = 0; i < kNumSse2Lanes; i++) {
+      selves[i]->hp_filter_state[j] = (int16_t) state[i];
+    }
+  }
+}
+
+// Scatters the |length| lane vectors of |in| into |band| of each instance.
+static void ScatterBand(const __m128i* in, int length, int band,
+                        int16_t bands[][kNumChannels][kMaxBandLength]) {
+  int32_t lanes[4];
+  int i, k;
+  for (i = 0; i < length; i++) {
+    _mm_storeu_si128((__m128i*) lanes, in[i]);
+    for (k = 0; k < kNumSse2Lanes; k++) {
+      bands[k][band][i] = (int16_t) lanes[k];
+    }
+  }
+}
+
+void WebRtcVad_SplitBandsSSE2(VadInstT* const* selves, int fs,
+                              const int16_t* const* frames, int frame_length,
+                              int16_t bands[][kNumChannels][kMaxBandLength]) {
+  __m128i wideband[MAX_WIDEBAND_LENGTH];
+  __m128i narrowband[240];
+  __m128i hp_120[120], lp_120[120];
+  __m128i hp_60[60], lp_60[60];
+  int data_length = frame_length;
+  int length;
+  int i;
+
+  // Downsample to 8 kHz, like WebRtcVad_CalcVad32khz() and
+  // WebRtcVad_CalcVad16khz().
+  if (fs == 32000) {
+    DownsampleFrames(frames, frame_length, 2, selves, wideband);
+    data_length >>= 1;
+    DownsampleLanes(wideband, data_length, 0, selves, narrowband);
+    data_length >>= 1;
+  } else if (fs == 16000) {
+    DownsampleFrames(frames, frame_length, 0, selves, narrowband);
+    data_length >>= 1;
+  } else {
+    assert(fs == 8000);
+    for (i = 0; i < frame_length; i++) {
+      narrowband[i] = GatherW16(frames, i);
+    }
+  }
+  assert(data_length <= 240);
+
+  // The splits of WebRtcVad_SplitBands().
+  length = data_length >> 1;
+  SplitFilter(narrowband, data_length, 0, selves, hp_120, lp_120);
+
+  // [2000 - 4000] Hz into [3000 - 4000] Hz and [2000 - 3000] Hz.
+  SplitFilter(hp_120, length, 1, selves, hp_60, lp_60);
+  ScatterBand(hp_60, length >> 1, 5, bands);
+  ScatterBand(lp_60, length >> 1, 4, bands);
+
+  // [0 - 2000] Hz into [1000 - 2000] Hz and [0 - 1000] Hz.
+  SplitFilter(lp_120, length, 2, selves, hp_60, lp_60);
+  ScatterBand(hp_60, length >> 1, 3, bands);
+
+  // [0 - 1000] Hz into [500 - 1000] Hz and [0 - 500] Hz.
+  length >>= 1;
+  SplitFilter(lp_60, length, 3, selves, hp_120, lp_120);
+  ScatterBand(hp_120, length >> 1, 2, bands);
+
+  // [0 - 500] Hz into [250 - 500] Hz and [0 - 250] Hz.
+  length >>= 1;
+  SplitFilter(lp_120, length, 4, selves, hp_60, lp_60);
+  ScatterBand(hp_60, length >> 1, 1, bands);
+
+  // [80 - 250] Hz.
+  length >>= 1;
+  HighPassFilter(lp_60, length, selves, hp_120);
+  ScatterBand(hp_120, length, 0, bands);
+}
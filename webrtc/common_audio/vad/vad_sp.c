@@ -18,7 +18,7 @@
 
 // Allpass filter coefficients, upper and lower, in Q13.
 // Upper: 0.64, Lower: 0.17.
-static const int16_t kAllPassCoefsQ13[2] = { 5243, 1392 };  // Q13.
+const int16_t WebRtcVad_kAllPassCoefsQ13[2] = { 5243, 1392 };  // Q13.
 static const int16_t kSmoothingDown = 6553;  // 0.2 in Q15.
 static const int16_t kSmoothingUp = 32439;  // 0.99 in Q15.
 
@@ -38,17 +38,19 @@ void WebRtcVad_Downsampling(const int16_t* signal_in,
   for (n = 0; n < half_length; n++) {
     // All-pass filtering upper branch.
     tmp16_1 = (int16_t) ((tmp32_1 >> 1) +
-        WEBRTC_SPL_MUL_16_16_RSFT(kAllPassCoefsQ13[0], *signal_in, 14));
+        WEBRTC_SPL_MUL_16_16_RSFT(WebRtcVad_kAllPassCoefsQ13[0], *signal_in,
+                                  14));
     *signal_out = tmp16_1;
     tmp32_1 = (int32_t) (*signal_in++) -
-        WEBRTC_SPL_MUL_16_16_RSFT(kAllPassCoefsQ13[0], tmp16_1, 12);
+        WEBRTC_SPL_MUL_16_16_RSFT(WebRtcVad_kAllPassCoefsQ13[0], tmp16_1, 12);
 
     // All-pass filtering lower branch.
     tmp16_2 = (int16_t) ((tmp32_2 >> 1) +
-        WEBRTC_SPL_MUL_16_16_RSFT(kAllPassCoefsQ13[1], *signal_in, 14));
+        WEBRTC_SPL_MUL_16_16_RSFT(WebRtcVad_kAllPassCoefsQ13[1], *signal_in,
+                                  14));
     *signal_out++ += tmp16_2;
     tmp32_2 = (int32_t) (*signal_in++) -
-        WEBRTC_SPL_MUL_16_16_RSFT(kAllPassCoefsQ13[1], tmp16_2, 12);
+        WEBRTC_SPL_MUL_16_16_RSFT(WebRtcVad_kAllPassCoefsQ13[1], tmp16_2, 12);
   }
   // Store the filter states.
   filter_state[0] = tmp32_1;
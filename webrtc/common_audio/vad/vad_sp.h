@@ -17,6 +17,10 @@
 #include "webrtc/common_audio/vad/vad_core.h"
 #include "webrtc/typedefs.h"
 
+// All-pass filter coefficients of WebRtcVad_Downsampling(), upper and lower,
+// in Q13.
+extern const int16_t WebRtcVad_kAllPassCoefsQ13[2];
+
 // Downsamples the signal by a factor 2, eg. 32->16 or 16->8.
 //
 // Inputs:
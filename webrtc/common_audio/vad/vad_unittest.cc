@@ -150,6 +150,97 @@ TEST_F(VadTest, ValidRatesFrameLengths) {
   }
 }
 
+TEST_F(VadTest, ProcessMultipleMatchesProcess) {
+  // Runs instances of different modes on a mix of signals and silence, which
+  // exercises both the grouped filtering and the early-out on silence, and
+  // compares with separately processed instances.
+  const int kNumInstances = 7;
+  const int kNumFrames = 20;
+  VadInst* handles[kNumInstances];
+  VadInst* references[kNumInstances];
+  int16_t frames[kNumInstances][kMaxFrameLength];
+  const int16_t* frame_pointers[kNumInstances];
+  int decisions[kNumInstances];
+  uint32_t seed = 12345;
+
+  for (int n = 0; n < kNumInstances; n++) {
+    frame_pointers[n] = frames[n];
+  }
+  for (size_t i = 0; i < kRatesSize; i++) {
+    for (size_t j = 0; j < kFrameLengthsSize; j++) {
+      if (!ValidRatesAndFrameLengths(kRates[i], kFrameLengths[j])) {
+        continue;
+      }
+      for (int n = 0; n < kNumInstances; n++) {
+        ASSERT_EQ(0, WebRtcVad_Create(&handles[n]));
+        ASSERT_EQ(0, WebRtcVad_Create(&references[n]));
+        ASSERT_EQ(0, WebRtcVad_Init(handles[n]));
+        ASSERT_EQ(0, WebRtcVad_Init(references[n]));
+        ASSERT_EQ(0, WebRtcVad_set_mode(handles[n], kModes[n % kModesSize]));
+        ASSERT_EQ(0, WebRtcVad_set_mode(references[n],
+                                        kModes[n % kModesSize]));
+      }
+      for (int frame = 0; frame < kNumFrames; frame++) {
+        for (int n = 0; n < kNumInstances; n++) {
+          // Instance |n| is silent in some frames, and in the first frames
+          // but the last for the highest instances.
+          const bool silent = (frame + n) % 5 == 0 ||
+              (n >= kNumInstances - 2 && frame < kNumFrames - 1);
+          const int amplitude = 1 << (4 + (n + frame) % 10);
+          for (int k = 0; k < kFrameLengths[j]; k++) {
+            seed = seed * 1103515245 + 12345;
+            frames[n][k] = silent ? 0 : static_cast<int16_t>(
+                (static_cast<int>((seed >> 16) & 0x7FFF) - 16384) *
+                amplitude / 16384 + (k * k * (n + 1)) % amplitude);
+          }
+        }
+        ASSERT_EQ(0, WebRtcVad_ProcessMultiple(handles, kNumInstances,
+                                               kRates[i], frame_pointers,
+                                               kFrameLengths[j], decisions));
+        for (int n = 0; n < kNumInstances; n++) {
+          EXPECT_EQ(WebRtcVad_Process(references[n], kRates[i], frames[n],
+                                      kFrameLengths[j]), decisions[n]);
+        }
+      }
+      for (int n = 0; n < kNumInstances; n++) {
+        WebRtcVad_Free(handles[n]);
+        WebRtcVad_Free(references[n]);
+      }
+    }
+  }
+}
+
+TEST_F(VadTest, ProcessMultipleApiTest) {
+  VadInst* handles[2] = { NULL, NULL };
+  int16_t speech[kMaxFrameLength] = { 0 };
+  const int16_t* frames[2] = { speech, speech };
+  int decisions[2] = { -1, -1 };
+
+  ASSERT_EQ(0, WebRtcVad_Create(&handles[0]));
+  ASSERT_EQ(0, WebRtcVad_Create(&handles[1]));
+  ASSERT_EQ(0, WebRtcVad_Init(handles[0]));
+
+  // Second instance not initialized.
+  EXPECT_EQ(-1, WebRtcVad_ProcessMultiple(handles, 2, kRates[0], frames,
+                                          kFrameLengths[0], decisions));
+  ASSERT_EQ(0, WebRtcVad_Init(handles[1]));
+  EXPECT_EQ(-1, WebRtcVad_ProcessMultiple(NULL, 2, kRates[0], frames,
+                                          kFrameLengths[0], decisions));
+  EXPECT_EQ(-1, WebRtcVad_ProcessMultiple(handles, 2, kRates[0], NULL,
+                                          kFrameLengths[0], decisions));
+  EXPECT_EQ(-1, WebRtcVad_ProcessMultiple(handles, 2, kRates[0], frames,
+                                          kFrameLengths[0], NULL));
+  EXPECT_EQ(-1, WebRtcVad_ProcessMultiple(handles, 2, 9999, frames,
+                                          kFrameLengths[0], decisions));
+  EXPECT_EQ(0, WebRtcVad_ProcessMultiple(handles, 2, kRates[0], frames,
+                                         kFrameLengths[0], decisions));
+  EXPECT_EQ(0, decisions[0]);
+  EXPECT_EQ(0, decisions[1]);
+
+  WebRtcVad_Free(handles[0]);
+  WebRtcVad_Free(handles[1]);
+}
+
 // TODO(bjornv): Add a process test, run on file.
 
 }  // namespace
@@ -103,6 +103,40 @@ int WebRtcVad_Process(VadInst* handle, int fs, const int16_t* audio_frame,
   return vad;
 }
 
+int WebRtcVad_ProcessMultiple(VadInst** handles, int num_handles, int fs,
+                              const int16_t* const* audio_frames,
+                              int frame_length, int* decisions) {
+  int i;
+
+  if (handles == NULL || audio_frames == NULL || decisions == NULL) {
+    return -1;
+  }
+  if (num_handles < 0) {
+    return -1;
+  }
+  for (i = 0; i < num_handles; i++) {
+    if (handles[i] == NULL || audio_frames[i] == NULL) {
+      return -1;
+    }
+    if (((VadInstT*) handles[i])->init_flag != kInitCheck) {
+      return -1;
+    }
+  }
+  if (WebRtcVad_ValidRateAndFrameLength(fs, frame_length) != 0) {
+    return -1;
+  }
+
+  WebRtcVad_CalcVadMultiple((VadInstT* const*) handles, num_handles, fs,
+                            audio_frames, frame_length, decisions);
+
+  for (i = 0; i < num_handles; i++) {
+    if (decisions[i] > 0) {
+      decisions[i] = 1;
+    }
+  }
+  return 0;
+}
+
 int WebRtcVad_ValidRateAndFrameLength(int rate, int frame_length) {
   int return_value = -1;
   size_t i;
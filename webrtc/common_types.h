@@ -767,7 +767,9 @@ struct RTPHeaderExtension {
         hasAbsoluteSendTime(false),
         absoluteSendTime(0),
         hasAudioLevel(false),
-        audioLevel(0) {}
+        audioLevel(0),
+        hasTransportSequenceNumber(false),
+        transportSequenceNumber(0) {}
 
   bool hasTransmissionTimeOffset;
   int32_t transmissionTimeOffset;
@@ -778,6 +780,11 @@ struct RTPHeaderExtension {
   // https://datatracker.ietf.org/doc/draft-lennox-avt-rtp-audio-level-exthdr/
   bool hasAudioLevel;
   uint8_t audioLevel;
+
+  // Sequence number of the packet over the transport, shared by all the
+  // streams it carries.
+  bool hasTransportSequenceNumber;
+  uint16_t transportSequenceNumber;
 };
 
 struct RTPHeader {
@@ -145,6 +145,37 @@ TEST(TestI420VideoFrame, CloneFrame) {
   EXPECT_TRUE(EqualFrames(frame1, *frame2));
 }
 
+TEST(TestI420VideoFrame, CopyFrameSharesBuffersUntilWritten) {
+  I420VideoFrame frame1, frame2;
+  const int kSizeY = 400;
+  const int kSizeUv = 100;
+  uint8_t buffer_y[kSizeY];
+  uint8_t buffer_u[kSizeUv];
+  uint8_t buffer_v[kSizeUv];
+  memset(buffer_y, 16, kSizeY);
+  memset(buffer_u, 8, kSizeUv);
+  memset(buffer_v, 4, kSizeUv);
+  EXPECT_EQ(0, frame1.CreateFrame(kSizeY, buffer_y, kSizeUv, buffer_u,
+                                  kSizeUv, buffer_v, 20, 20, 20, 10, 10));
+  EXPECT_EQ(0, frame2.CopyFrame(frame1));
+  const I420VideoFrame& const_frame1 = frame1;
+  const I420VideoFrame& const_frame2 = frame2;
+  for (int plane = 0; plane < kNumOfPlanes; ++plane) {
+    PlaneType type = static_cast<PlaneType>(plane);
+    EXPECT_EQ(const_frame1.buffer(type), const_frame2.buffer(type));
+  }
+
+  // Writing to a plane only copies that plane.
+  frame2.buffer(kUPlane)[0] = 0;
+  EXPECT_EQ(const_frame1.buffer(kYPlane), const_frame2.buffer(kYPlane));
+  EXPECT_NE(const_frame1.buffer(kUPlane), const_frame2.buffer(kUPlane));
+  EXPECT_EQ(const_frame1.buffer(kVPlane), const_frame2.buffer(kVPlane));
+  EXPECT_EQ(8, const_frame1.buffer(kUPlane)[0]);
+  EXPECT_EQ(0, const_frame2.buffer(kUPlane)[0]);
+  EXPECT_EQ(0, memcmp(buffer_u + 1, const_frame2.buffer(kUPlane) + 1,
+                      kSizeUv - 1));
+}
+
 TEST(TestI420VideoFrame, CopyBuffer) {
   I420VideoFrame frame1, frame2;
   int width = 15;
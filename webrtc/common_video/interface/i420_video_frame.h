@@ -64,19 +64,21 @@ class I420VideoFrame {
                           int width, int height,
                           int stride_y, int stride_u, int stride_v);
 
-  // Copy frame: If required size is bigger than allocated one, new buffers of
-  // adequate size will be allocated.
+  // Copy frame: The frames share the pixel data, which is copied when either
+  // frame is written to through the non-const buffer() (copy-on-write).
   // Return value: 0 on success, -1 on error.
   virtual int CopyFrame(const I420VideoFrame& videoFrame);
 
-  // Make a copy of |this|. The caller owns the returned frame.
+  // Make a copy of |this|, sharing the pixel data as CopyFrame() does. The
+  // caller owns the returned frame.
   // Return value: a new frame on success, NULL on error.
   virtual I420VideoFrame* CloneFrame() const;
 
   // Swap Frame.
   virtual void SwapFrame(I420VideoFrame* videoFrame);
 
-  // Get pointer to buffer per plane.
+  // Get pointer to buffer per plane. If the plane is shared with other frames,
+  // its data is copied first; prefer the const overload for reading.
   virtual uint8_t* buffer(PlaneType type);
   // Overloading with const.
   virtual const uint8_t* buffer(PlaneType type) const;
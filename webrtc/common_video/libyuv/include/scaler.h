@@ -33,7 +33,8 @@ class Scaler {
   Scaler();
   ~Scaler();
 
-  // Set interpolation properties:
+  // Set interpolation properties. Setting the current properties again is
+  // cheap, so this can be called for every frame.
   //
   // Return value: 0 - OK
   //              -1 - parameter error
@@ -44,7 +45,8 @@ class Scaler {
 
   // Scale frame
   // Memory is allocated by user. If dst_frame is not of sufficient size,
-  // the frame will be reallocated to the appropriate size.
+  // the frame will be reallocated to the appropriate size. The strides of
+  // dst_frame are set to the width of its planes rounded up to 16 bytes.
   // Return value: 0 - OK,
   //               -1 - parameter error
   //               -2 - scaler not set
@@ -15,6 +15,19 @@
 
 namespace webrtc {
 
+static libyuv::FilterMode ToLibyuvFilterMode(ScaleMethod method) {
+  switch (method) {
+    case kScalePoint:
+      return libyuv::kFilterNone;
+    case kScaleBilinear:
+      return libyuv::kFilterBilinear;
+    case kScaleBox:
+      return libyuv::kFilterBox;
+  }
+  assert(false);
+  return libyuv::kFilterBox;
+}
+
 Scaler::Scaler()
     : method_(kScaleBox),
       src_width_(0),
@@ -29,6 +42,12 @@ int Scaler::Set(int src_width, int src_height,
                 int dst_width, int dst_height,
                 VideoType src_video_type, VideoType dst_video_type,
                 ScaleMethod method) {
+  // Scalers are typically set up again for every frame, most of the time with
+  // unchanged settings.
+  if (set_ && src_width == src_width_ && src_height == src_height_ &&
+      dst_width == dst_width_ && dst_height == dst_height_ &&
+      method == method_ && SupportedVideoType(src_video_type, dst_video_type))
+    return 0;
   set_ = false;
   if (src_width < 1 || src_height < 1 || dst_width < 1 || dst_height < 1)
     return -1;
@@ -53,11 +72,14 @@ int Scaler::Scale(const I420VideoFrame& src_frame,
   if (!set_)
     return -2;
 
-  // Making sure that destination frame is of sufficient size.
-  // Aligning stride values based on width.
+  // Making sure that destination frame is of sufficient size. The strides
+  // are 16 byte aligned, which, together with the aligned plane buffers, lets
+  // libyuv use its SIMD row functions for every row.
+  int stride_y = 0;
+  int stride_uv = 0;
+  Calc16ByteAlignedStride(dst_width_, &stride_y, &stride_uv);
   dst_frame->CreateEmptyFrame(dst_width_, dst_height_,
-                              dst_width_, (dst_width_ + 1) / 2,
-                              (dst_width_ + 1) / 2);
+                              stride_y, stride_uv, stride_uv);
 
   return libyuv::I420Scale(src_frame.buffer(kYPlane),
                            src_frame.stride(kYPlane),
@@ -73,7 +95,7 @@ int Scaler::Scale(const I420VideoFrame& src_frame,
                            dst_frame->buffer(kVPlane),
                            dst_frame->stride(kVPlane),
                            dst_width_, dst_height_,
-                           libyuv::FilterMode(method_));
+                           ToLibyuvFilterMode(method_));
 }
 
 bool Scaler::SupportedVideoType(VideoType src_video_type,
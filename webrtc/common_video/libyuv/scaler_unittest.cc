@@ -114,6 +114,28 @@ TEST_F(TestScaler, ScaleSendingBufferTooSmall) {
   EXPECT_EQ(half_height_, test_frame2.height());
 }
 
+TEST_F(TestScaler, ScaleAlignsDestinationStrides) {
+  const int dst_width = 100;
+  const int dst_height = 60;
+  EXPECT_EQ(0, test_scaler_.Set(width_, height_, dst_width, dst_height,
+                                kI420, kI420, kScaleBox));
+  // Setting the same values again keeps the scaler set.
+  EXPECT_EQ(0, test_scaler_.Set(width_, height_, dst_width, dst_height,
+                                kI420, kI420, kScaleBox));
+  I420VideoFrame test_frame2;
+  EXPECT_EQ(0, test_scaler_.Scale(test_frame_, &test_frame2));
+  EXPECT_EQ(dst_width, test_frame2.width());
+  EXPECT_EQ(dst_height, test_frame2.height());
+  EXPECT_EQ(112, test_frame2.stride(kYPlane));
+  EXPECT_EQ(64, test_frame2.stride(kUPlane));
+  EXPECT_EQ(64, test_frame2.stride(kVPlane));
+
+  // Scaling into the frame again reuses its buffers.
+  const uint8_t* buffer_y = test_frame2.buffer(kYPlane);
+  EXPECT_EQ(0, test_scaler_.Scale(test_frame_, &test_frame2));
+  EXPECT_EQ(buffer_y, test_frame2.buffer(kYPlane));
+}
+
 //TODO (mikhal): Converge the test into one function that accepts the method.
 TEST_F(TestScaler, DISABLED_ON_ANDROID(PointScaleTest)) {
   double avg_psnr;
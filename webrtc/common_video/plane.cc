@@ -12,16 +12,124 @@
 
 #include <string.h>  // memcpy
 
-#include <algorithm>  // swap
+#include <algorithm>  // max
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 
 namespace webrtc {
 
 // Aligning pointer to 64 bytes for improved performance, e.g. use SIMD.
 static const int kBufferAlignment =  64;
 
+// Number of unused buffers a plane keeps around for reuse. A frame is
+// typically referenced by the encoder and a renderer while the next one is
+// being captured.
+static const size_t kMaxFreeBuffers = 3;
+
+class Plane::Buffer {
+ public:
+  explicit Buffer(int size)
+      : data_(static_cast<uint8_t*>(AlignedMalloc(size, kBufferAlignment))),
+        size_(size),
+        ref_count_(0) {}
+
+  int32_t AddRef() { return ++ref_count_; }
+  int32_t Release();
+
+  bool HasOneRef() { return ref_count_.Value() == 1; }
+  uint8_t* data() { return data_.get(); }
+  int size() const { return size_; }
+
+  // The pool the buffer is returned to when it is no longer referenced.
+  scoped_refptr<BufferPool> pool_;
+
+ private:
+  scoped_ptr<uint8_t, AlignedFreeDeleter> data_;
+  const int size_;
+  Atomic32 ref_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(Buffer);
+};
+
+// Buffers in the pool do not reference it, so that the pool is deleted with
+// the last Plane or in-use Buffer referencing it.
+class Plane::BufferPool {
+ public:
+  BufferPool()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        ref_count_(0) {}
+
+  ~BufferPool() {
+    for (size_t i = 0; i < free_buffers_.size(); ++i)
+      delete free_buffers_[i];
+  }
+
+  int32_t AddRef() { return ++ref_count_; }
+  int32_t Release() {
+    int32_t ref_count = --ref_count_;
+    if (ref_count == 0)
+      delete this;
+    return ref_count;
+  }
+
+  // Returns an unreferenced buffer of at least |size| bytes.
+  Buffer* Get(int size) {
+    Buffer* buffer = NULL;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      std::vector<Buffer*>::iterator it = free_buffers_.begin();
+      while (it != free_buffers_.end()) {
+        if ((*it)->size() >= size) {
+          buffer = *it;
+          free_buffers_.erase(it);
+          break;
+        }
+        // The planes have grown, smaller buffers are not needed any more.
+        delete *it;
+        it = free_buffers_.erase(it);
+      }
+    }
+    if (!buffer)
+      buffer = new Buffer(size);
+    buffer->pool_ = this;
+    return buffer;
+  }
+
+  void Return(Buffer* buffer) {
+    CriticalSectionScoped cs(crit_.get());
+    if (free_buffers_.size() < kMaxFreeBuffers) {
+      free_buffers_.push_back(buffer);
+    } else {
+      delete buffer;
+    }
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  std::vector<Buffer*> free_buffers_;
+  Atomic32 ref_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferPool);
+};
+
+int32_t Plane::Buffer::Release() {
+  int32_t ref_count = --ref_count_;
+  if (ref_count == 0) {
+    scoped_refptr<BufferPool> pool;
+    pool.swap(pool_);
+    if (pool.get()) {
+      pool->Return(this);
+    } else {
+      delete this;
+    }
+  }
+  return ref_count;
+}
+
 Plane::Plane()
-    : allocated_size_(0),
-      plane_size_(0),
+    : plane_size_(0),
       stride_(0) {}
 
 Plane::~Plane() {}
@@ -30,41 +138,41 @@ int Plane::CreateEmptyPlane(int allocated_size, int stride, int plane_size) {
   if (allocated_size < 1 || stride < 1 || plane_size < 1)
     return -1;
   stride_ = stride;
-  if (MaybeResize(allocated_size) < 0)
+  if (MaybeResize(allocated_size, false) < 0)
     return -1;
   plane_size_ = plane_size;
   return 0;
 }
 
-int Plane::MaybeResize(int new_size) {
+int Plane::MaybeResize(int new_size, bool keep_data) {
   if (new_size <= 0)
     return -1;
-  if (new_size <= allocated_size_)
+  if (buffer_.get() && new_size <= buffer_->size() && buffer_->HasOneRef())
     return 0;
-  scoped_ptr<uint8_t, AlignedFreeDeleter> new_buffer(static_cast<uint8_t*>(
-      AlignedMalloc(new_size, kBufferAlignment)));
-  if (buffer_.get()) {
-    memcpy(new_buffer.get(), buffer_.get(), plane_size_);
+  if (!pool_.get())
+    pool_ = new BufferPool();
+  scoped_refptr<Buffer> new_buffer(
+      pool_->Get(std::max(new_size, allocated_size())));
+  if (keep_data && buffer_.get()) {
+    memcpy(new_buffer->data(), buffer_->data(), plane_size_);
   }
-  buffer_.reset(new_buffer.release());
-  allocated_size_ = new_size;
+  buffer_ = new_buffer;
   return 0;
 }
 
 int Plane::Copy(const Plane& plane) {
-  if (MaybeResize(plane.allocated_size_) < 0)
+  if (!plane.buffer_.get())
     return -1;
-  if (plane.buffer_.get())
-    memcpy(buffer_.get(), plane.buffer_.get(), plane.plane_size_);
+  buffer_ = plane.buffer_;
   stride_ = plane.stride_;
   plane_size_ = plane.plane_size_;
   return 0;
 }
 
 int Plane::Copy(int size, int stride, const uint8_t* buffer) {
-  if (MaybeResize(size) < 0)
+  if (MaybeResize(size, false) < 0)
     return -1;
-  memcpy(buffer_.get(), buffer, size);
+  memcpy(buffer_->data(), buffer, size);
   plane_size_ = size;
   stride_ = stride;
   return 0;
@@ -72,9 +180,29 @@ int Plane::Copy(int size, int stride, const uint8_t* buffer) {
 
 void Plane::Swap(Plane& plane) {
   std::swap(stride_, plane.stride_);
-  std::swap(allocated_size_, plane.allocated_size_);
   std::swap(plane_size_, plane.plane_size_);
   buffer_.swap(plane.buffer_);
+  pool_.swap(plane.pool_);
+}
+
+int Plane::allocated_size() const {
+  return buffer_.get() ? buffer_->size() : 0;
+}
+
+bool Plane::IsShared() const {
+  return buffer_.get() && !buffer_->HasOneRef();
+}
+
+const uint8_t* Plane::buffer() const {
+  return buffer_.get() ? buffer_->data() : NULL;
+}
+
+uint8_t* Plane::buffer() {
+  if (!buffer_.get())
+    return NULL;
+  if (!buffer_->HasOneRef())
+    MaybeResize(buffer_->size(), true);
+  return buffer_->data();
 }
 
 }  // namespace webrtc
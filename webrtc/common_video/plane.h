@@ -11,14 +11,20 @@
 #ifndef COMMON_VIDEO_PLANE_H
 #define COMMON_VIDEO_PLANE_H
 
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/system_wrappers/interface/aligned_malloc.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_refptr.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
 // Helper class for I420VideoFrame: Store plane data and perform basic plane
 // operations.
+// The plane data is held in a reference counted buffer. Copying a plane shares
+// the buffer, which is copied on write: the non-const buffer() makes the
+// buffer exclusive to the plane first. Buffers replaced this way are recycled
+// through a pool owned by the plane once all other planes have released them.
 class Plane {
  public:
   Plane();
@@ -29,7 +35,8 @@ class Plane {
   // Return value: 0 on success ,-1 on error.
   int CreateEmptyPlane(int allocated_size, int stride, int plane_size);
 
-  // Copy the entire plane data.
+  // Copy the entire plane data. The data is shared with |plane| until either
+  // of the planes is written to.
   // Return value: 0 on success ,-1 on error.
   int Copy(const Plane& plane);
 
@@ -42,7 +49,7 @@ class Plane {
   void Swap(Plane& plane);
 
   // Get allocated size.
-  int allocated_size() const {return allocated_size_;}
+  int allocated_size() const;
 
   // Set actual size.
   void ResetSize() {plane_size_ = 0;}
@@ -53,21 +60,32 @@ class Plane {
   // Get stride value.
   int stride() const {return stride_;}
 
+  // Return true if the plane data is shared with another plane.
+  bool IsShared() const;
+
   // Return data pointer.
-  const uint8_t* buffer() const {return buffer_.get();}
-  // Overloading with non-const.
-  uint8_t* buffer() {return buffer_.get();}
+  const uint8_t* buffer() const;
+  // Overloading with non-const. If the data is shared with other planes, it is
+  // copied to a buffer exclusive to this plane first. The returned pointer is
+  // only valid for writing until the plane is copied.
+  uint8_t* buffer();
 
  private:
-  // Resize when needed: If current allocated size is less than new_size, buffer
-  // will be updated. Old data will be copied to new buffer.
+  class Buffer;
+  class BufferPool;
+
+  // Resize when needed: If current allocated size is less than new_size or the
+  // buffer is shared, buffer will be updated. If |keep_data| is true, old data
+  // will be copied to new buffer.
   // Return value: 0 on success ,-1 on error.
-  int MaybeResize(int new_size);
+  int MaybeResize(int new_size, bool keep_data);
 
-  scoped_ptr<uint8_t, AlignedFreeDeleter> buffer_;
-  int allocated_size_;
+  scoped_refptr<BufferPool> pool_;
+  scoped_refptr<Buffer> buffer_;
   int plane_size_;
   int stride_;
+
+  DISALLOW_COPY_AND_ASSIGN(Plane);
 };  // Plane
 
 }  // namespace webrtc
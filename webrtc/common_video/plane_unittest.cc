@@ -62,8 +62,8 @@ TEST(TestPlane, PlaneCopy) {
   int stride1 = plane1.stride();
   int stride2 = plane2.stride();
   plane1.Copy(plane2);
-  // Smaller size - keep buffer size as is.
-  EXPECT_EQ(size1, plane1.allocated_size());
+  // The buffer of |plane2| is shared.
+  EXPECT_EQ(plane2.allocated_size(), plane1.allocated_size());
   EXPECT_EQ(stride2, plane1.stride());
   plane2.Copy(plane1);
   // Verify increment of allocated size.
@@ -76,6 +76,61 @@ TEST(TestPlane, PlaneCopy) {
   plane2.Copy(size1, stride1, buffer1);
   EXPECT_GE(plane2.allocated_size(), size1);
   EXPECT_EQ(0, memcmp(buffer1, plane2.buffer(), size1));
+  EXPECT_GE(plane2.allocated_size(), size1);
+}
+
+TEST(TestPlane, PlaneCopyOnWrite) {
+  Plane plane1, plane2;
+  uint8_t buffer1[100];
+  memset(buffer1, 1, sizeof(buffer1));
+  EXPECT_EQ(0, plane1.Copy(sizeof(buffer1), 10, buffer1));
+  EXPECT_FALSE(plane1.IsShared());
+  EXPECT_EQ(-1, plane1.Copy(plane2));
+
+  // Copying shares the data.
+  EXPECT_EQ(0, plane2.Copy(plane1));
+  EXPECT_TRUE(plane1.IsShared());
+  EXPECT_TRUE(plane2.IsShared());
+  const Plane& const_plane1 = plane1;
+  const Plane& const_plane2 = plane2;
+  EXPECT_EQ(const_plane1.buffer(), const_plane2.buffer());
+
+  // Writing to one of the planes copies the data first.
+  const uint8_t* shared_buffer = const_plane1.buffer();
+  plane2.buffer()[0] = 2;
+  EXPECT_FALSE(plane1.IsShared());
+  EXPECT_FALSE(plane2.IsShared());
+  EXPECT_EQ(shared_buffer, const_plane1.buffer());
+  EXPECT_NE(shared_buffer, const_plane2.buffer());
+  EXPECT_EQ(1, const_plane1.buffer()[0]);
+  EXPECT_EQ(2, const_plane2.buffer()[0]);
+  EXPECT_EQ(0, memcmp(buffer1 + 1, const_plane2.buffer() + 1,
+                      sizeof(buffer1) - 1));
+
+  // A plane which is not shared is written to in place.
+  uint8_t* exclusive_buffer = plane2.buffer();
+  EXPECT_EQ(0, plane2.Copy(sizeof(buffer1), 10, buffer1));
+  EXPECT_EQ(exclusive_buffer, plane2.buffer());
+}
+
+TEST(TestPlane, PlaneReusesReleasedBuffers) {
+  Plane plane1, plane2;
+  const Plane& const_plane1 = plane1;
+  const Plane& const_plane2 = plane2;
+  EXPECT_EQ(0, plane1.CreateEmptyPlane(100, 10, 100));
+  const uint8_t* first_buffer = const_plane1.buffer();
+  plane2.Copy(plane1);
+  // |plane1| gets a new buffer since the old one is still used by |plane2|.
+  EXPECT_EQ(0, plane1.CreateEmptyPlane(100, 10, 100));
+  const uint8_t* second_buffer = const_plane1.buffer();
+  EXPECT_NE(first_buffer, second_buffer);
+  EXPECT_EQ(first_buffer, const_plane2.buffer());
+
+  // Once released by |plane2|, the first buffer is reused.
+  plane2.Copy(plane1);
+  EXPECT_EQ(0, plane1.CreateEmptyPlane(100, 10, 100));
+  EXPECT_EQ(first_buffer, const_plane1.buffer());
+  EXPECT_EQ(second_buffer, const_plane2.buffer());
 }
 
 TEST(TestPlane, PlaneSwap) {
@@ -13,6 +13,33 @@
 #include <string>
 
 namespace webrtc {
+void DelayHistogram::Add(int delay_ms) {
+  if (delay_ms < 0)
+    delay_ms = 0;
+  int bucket = delay_ms / kBucketMs;
+  if (bucket >= kNumBuckets)
+    bucket = kNumBuckets - 1;
+  ++counts[bucket];
+  ++num_samples;
+  if (delay_ms > max_ms)
+    max_ms = delay_ms;
+}
+
+int DelayHistogram::Percentile(int percent) const {
+  if (num_samples == 0)
+    return -1;
+  // The number of samples at or below the percentile, rounded up.
+  const uint64_t target =
+      (static_cast<uint64_t>(num_samples) * percent + 99) / 100;
+  uint64_t count = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    count += counts[i];
+    if (count >= target && count > 0)
+      return i == kNumBuckets - 1 ? max_ms : (i + 1) * kBucketMs;
+  }
+  return max_ms;
+}
+
 std::string FecConfig::ToString() const {
   std::stringstream ss;
   ss << "{ulpfec_payload_type: " << ulpfec_payload_type;
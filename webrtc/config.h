@@ -33,6 +33,23 @@ struct RtpStatistics {
   int extended_max_sequence_number;
 };
 
+// Distribution of a per-frame delay, in 10 ms buckets. Delays of a second or
+// more all go in the last bucket, which is reported as the largest delay.
+struct DelayHistogram {
+  enum { kBucketMs = 10, kNumBuckets = 100 };
+
+  DelayHistogram() : num_samples(0), max_ms(0), counts(kNumBuckets, 0) {}
+
+  void Add(int delay_ms);
+  // Returns the delay that |percent| of the samples are below, rounded up to
+  // a bucket boundary, or -1 if there are no samples.
+  int Percentile(int percent) const;
+
+  uint32_t num_samples;
+  int max_ms;
+  std::vector<uint32_t> counts;
+};
+
 struct StreamStats {
   StreamStats()
       : key_frames(0),
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/config.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace webrtc {
+
+TEST(DelayHistogramTest, NoSamples) {
+  DelayHistogram histogram;
+  EXPECT_EQ(0u, histogram.num_samples);
+  EXPECT_EQ(-1, histogram.Percentile(50));
+}
+
+TEST(DelayHistogramTest, PercentilesAreRoundedUpToBuckets) {
+  DelayHistogram histogram;
+  for (int delay_ms = 0; delay_ms < 100; ++delay_ms)
+    histogram.Add(delay_ms);
+  EXPECT_EQ(100u, histogram.num_samples);
+  EXPECT_EQ(99, histogram.max_ms);
+  EXPECT_EQ(10u, histogram.counts[0]);
+  EXPECT_EQ(10u, histogram.counts[9]);
+  EXPECT_EQ(10, histogram.Percentile(0));
+  EXPECT_EQ(10, histogram.Percentile(10));
+  EXPECT_EQ(20, histogram.Percentile(11));
+  EXPECT_EQ(50, histogram.Percentile(50));
+  EXPECT_EQ(100, histogram.Percentile(100));
+}
+
+TEST(DelayHistogramTest, ClampsOutOfRangeDelays) {
+  DelayHistogram histogram;
+  histogram.Add(-5);
+  histogram.Add(1234);
+  EXPECT_EQ(1u, histogram.counts[0]);
+  EXPECT_EQ(1u, histogram.counts[DelayHistogram::kNumBuckets - 1]);
+  EXPECT_EQ(DelayHistogram::kBucketMs, histogram.Percentile(50));
+  // Delays past the last bucket are reported as the largest delay.
+  EXPECT_EQ(1234, histogram.Percentile(100));
+}
+
+}  // namespace webrtc
@@ -11,9 +11,14 @@
 #ifndef WEBRTC_EXPERIMENTS_H_
 #define WEBRTC_EXPERIMENTS_H_
 
+#include <string>
+
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
+class BitrateEstimateCache;
+class SharedBitrateAllocator;
+
 struct RemoteBitrateEstimatorMinRate {
   RemoteBitrateEstimatorMinRate() : min_rate(30000) {}
   RemoteBitrateEstimatorMinRate(uint32_t min_rate) : min_rate(min_rate) {}
@@ -29,5 +34,76 @@ struct AimdRemoteRateControl {
 
   const bool enabled;
 };
+
+// Number of worker threads the ViE ProcessThread spreads modules across.
+// Modules belonging to the same channel always share a worker.
+struct ProcessThreadWorkers {
+  ProcessThreadWorkers() : num_workers(1) {}
+  explicit ProcessThreadWorkers(int num_workers) : num_workers(num_workers) {}
+
+  int num_workers;
+};
+
+// Number of threads the receiving video channels of an engine share for
+// decoding. With zero, every receiving channel has a decode thread of its own.
+struct VideoDecodeThreads {
+  VideoDecodeThreads() : num_threads(0) {}
+  explicit VideoDecodeThreads(int num_threads) : num_threads(num_threads) {}
+
+  int num_threads;
+};
+
+// Number of threads the receiving video channels of an engine share for FEC
+// recovery, so that FEC decoding doesn't hold up the network thread. Each
+// channel recovers its packets in order on a TaskQueue of these threads. With
+// zero, RED packets are handled on the network thread.
+struct FecRecoveryThreads {
+  FecRecoveryThreads() : num_threads(1) {}
+  explicit FecRecoveryThreads(int num_threads) : num_threads(num_threads) {}
+
+  int num_threads;
+};
+
+// Shares the network interface with the other engines this is set for, e.g.
+// all the engines sending over the same interface, see SharedBitrateAllocator.
+// Every channel group keeps estimating the bandwidth to its own peer, and gets
+// a share of the interface by |priority|. The allocator isn't owned and has to
+// outlive the engines. Without an allocator, every channel group uses its own
+// estimate.
+struct SharedBitrateAllocation {
+  SharedBitrateAllocation() : allocator(NULL), priority(1) {}
+  SharedBitrateAllocation(SharedBitrateAllocator* allocator, int priority)
+      : allocator(allocator), priority(priority) {}
+
+  SharedBitrateAllocator* allocator;
+  int priority;
+};
+
+// Starts the send-side bandwidth estimation of the engine's calls from the
+// estimate an earlier call stored under |key| in |cache|, see
+// BitrateEstimateCache, and stores the settled estimate there in turn. The
+// cache isn't owned and has to outlive the engine.
+struct CachedBitrateEstimate {
+  CachedBitrateEstimate() : cache(NULL) {}
+  CachedBitrateEstimate(BitrateEstimateCache* cache, const std::string& key)
+      : cache(cache), key(key) {}
+
+  BitrateEstimateCache* cache;
+  std::string key;
+};
+
+// Answers key frame requests, e.g. of receivers joining a broadcast, by
+// resending the packets of the last key frame and of all frames since from the
+// send side packet history, as long as that key frame is at most |max_age_ms|
+// old. A new key frame is only encoded when there is none to resend. Needs the
+// sent packets to be stored, i.e. NACK, and only applies to channels sending a
+// single stream.
+struct KeyFrameReplay {
+  KeyFrameReplay() : max_age_ms(0) {}
+  explicit KeyFrameReplay(int max_age_ms) : max_age_ms(max_age_ms) {}
+
+  // Zero disables the replay.
+  int max_age_ms;
+};
 }  // namespace webrtc
 #endif  // WEBRTC_EXPERIMENTS_H_
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/cng/include/webrtc_cng.h"
+#include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+
+using ::std::string;
+using ::std::tr1::make_tuple;
+using ::testing::Values;
+
+namespace webrtc {
+
+static const int kCngBlockDurationMs = 10;
+static const int kCngSidIntervalMs = 100;
+static const int kCngNumParamsNormal = 8;
+
+template <int kSamplingKhz>
+class CngSpeedTest : public AudioCodecSpeedTest {
+ protected:
+  CngSpeedTest()
+      : AudioCodecSpeedTest(kCngBlockDurationMs,
+                            kSamplingKhz,
+                            kSamplingKhz),
+        cng_encoder_(NULL),
+        cng_decoder_(NULL) {
+  }
+
+  virtual void SetUp() OVERRIDE {
+    AudioCodecSpeedTest::SetUp();
+    // Create encoder and decoder memory.
+    EXPECT_EQ(0, WebRtcCng_CreateEnc(&cng_encoder_));
+    EXPECT_EQ(0, WebRtcCng_CreateDec(&cng_decoder_));
+    EXPECT_EQ(0, WebRtcCng_InitDec(cng_decoder_));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    AudioCodecSpeedTest::TearDown();
+    // Free memory.
+    EXPECT_EQ(0, WebRtcCng_FreeEnc(cng_encoder_));
+    EXPECT_EQ(0, WebRtcCng_FreeDec(cng_decoder_));
+  }
+
+  // Encodes and decodes with |num_params| reflection coefficients.
+  void EncodeDecodeWithParams(int num_params) {
+    size_t kDurationSec = 400;  // Test audio length in second.
+    printf("Using %d reflection coefficients ...\n", num_params);
+    EXPECT_EQ(0, WebRtcCng_InitEnc(cng_encoder_, kSamplingKhz * 1000,
+                                   kCngSidIntervalMs, num_params));
+    EncodeDecode(kDurationSec);
+  }
+
+  virtual float EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                             int max_bytes, int* encoded_bytes) {
+    int16_t bytes;
+    clock_t clocks = clock();
+    int value = WebRtcCng_Encode(cng_encoder_, in_data, input_length_sample_,
+                                 bit_stream, &bytes, 0);
+    clocks = clock() - clocks;
+    EXPECT_GE(value, 0);
+    assert(bytes <= max_bytes);
+    *encoded_bytes = bytes;
+    return 1000.0 * clocks / CLOCKS_PER_SEC;
+  }
+
+  // Updates the noise with each SID frame, and generates a block of noise.
+  virtual float DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                             int16_t* out_data) {
+    clock_t clocks = clock();
+    if (encoded_bytes > 0) {
+      // The decoder doesn't change the SID frame.
+      EXPECT_EQ(0, WebRtcCng_UpdateSid(cng_decoder_,
+                                       const_cast<uint8_t*>(bit_stream),
+                                       encoded_bytes));
+    }
+    int value = WebRtcCng_Generate(cng_decoder_, out_data,
+                                   output_length_sample_, 0);
+    clocks = clock() - clocks;
+    EXPECT_EQ(0, value);
+    return 1000.0 * clocks / CLOCKS_PER_SEC;
+  }
+
+  CNG_enc_inst* cng_encoder_;
+  CNG_dec_inst* cng_decoder_;
+};
+
+typedef CngSpeedTest<8> Cng8kHzSpeedTest;
+typedef CngSpeedTest<16> Cng16kHzSpeedTest;
+typedef CngSpeedTest<32> Cng32kHzSpeedTest;
+typedef CngSpeedTest<48> Cng48kHzSpeedTest;
+
+#define ADD_TESTS(fixture) \
+TEST_P(fixture, CngNormalParamsTest) { \
+  EncodeDecodeWithParams(kCngNumParamsNormal); \
+} \
+TEST_P(fixture, CngMaxParamsTest) { \
+  EncodeDecodeWithParams(WEBRTC_CNG_MAX_LPC_ORDER); \
+}
+
+ADD_TESTS(Cng8kHzSpeedTest);
+ADD_TESTS(Cng16kHzSpeedTest);
+ADD_TESTS(Cng32kHzSpeedTest);
+ADD_TESTS(Cng48kHzSpeedTest);
+
+// CNG has no bit rate. There is no 8 kHz resource, so the 16 kHz speech is
+// coded as if it were 8 kHz.
+INSTANTIATE_TEST_CASE_P(
+    AllTest, Cng8kHzSpeedTest,
+    Values(make_tuple(1, 0, string("audio_coding/speech_mono_16kHz"),
+                      string("pcm"), false)));
+INSTANTIATE_TEST_CASE_P(
+    AllTest, Cng16kHzSpeedTest,
+    Values(make_tuple(1, 0, string("audio_coding/speech_mono_16kHz"),
+                      string("pcm"), false)));
+INSTANTIATE_TEST_CASE_P(
+    AllTest, Cng32kHzSpeedTest,
+    Values(make_tuple(1, 0, string("audio_coding/speech_mono_32_48kHz"),
+                      string("pcm"), false)));
+INSTANTIATE_TEST_CASE_P(
+    AllTest, Cng48kHzSpeedTest,
+    Values(make_tuple(1, 0, string("audio_coding/speech_mono_32_48kHz"),
+                      string("pcm"), false)));
+
+}  // namespace webrtc
@@ -337,6 +337,38 @@ uint8_t alaw_to_ulaw(uint8_t alaw);
 */
 uint8_t ulaw_to_alaw(uint8_t ulaw);
 
+/*! \brief Decode a block of A-law samples through a lookup table.
+    \param alaw The A-law samples to decode.
+    \param len The number of samples.
+    \param linear The linear values. */
+void alaw_to_linear_block(const uint8_t* alaw, int len, int16_t* linear);
+
+/*! \brief Decode a block of u-law samples through a lookup table.
+    \param ulaw The u-law samples to decode.
+    \param len The number of samples.
+    \param linear The linear values. */
+void ulaw_to_linear_block(const uint8_t* ulaw, int len, int16_t* linear);
+
+/*! \brief Encode a block of linear samples to A-law, with the vectorized
+    segment search of the CPU if it has one.
+    \param linear The samples to encode.
+    \param len The number of samples.
+    \param alaw The A-law values. */
+void linear_to_alaw_block(const int16_t* linear, int len, uint8_t* alaw);
+
+/*! \brief Encode a block of linear samples to u-law, with the vectorized
+    segment search of the CPU if it has one.
+    \param linear The samples to encode.
+    \param len The number of samples.
+    \param ulaw The u-law values. */
+void linear_to_ulaw_block(const int16_t* linear, int len, uint8_t* ulaw);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* SSE2 versions of linear_to_alaw_block() and linear_to_ulaw_block(). */
+void linear_to_alaw_block_sse2(const int16_t* linear, int len, uint8_t* alaw);
+void linear_to_ulaw_block_sse2(const int16_t* linear, int len, uint8_t* ulaw);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -12,12 +12,14 @@
 #include "g711_interface.h"
 #include "typedefs.h"
 
+// The codes are written to and read from |encoded| one byte per sample, in
+// memory order, on little and big endian CPUs alike.
+
 int16_t WebRtcG711_EncodeA(void* state,
                            int16_t* speechIn,
                            int16_t len,
                            int16_t* encoded) {
-  int n;
-  uint16_t tempVal, tempVal2;
+  uint8_t* encoded_bytes = (uint8_t*) encoded;
 
   // Set and discard to avoid getting warnings
   (void)(state = NULL);
@@ -27,25 +29,10 @@ int16_t WebRtcG711_EncodeA(void* state,
     return (-1);
   }
 
-  // Loop over all samples
-  for (n = 0; n < len; n++) {
-    tempVal = (uint16_t) linear_to_alaw(speechIn[n]);
-
-#ifdef WEBRTC_ARCH_BIG_ENDIAN
-    if ((n & 0x1) == 1) {
-      encoded[n >> 1] |= ((uint16_t) tempVal);
-    } else {
-      encoded[n >> 1] = ((uint16_t) tempVal) << 8;
-    }
-#else
-    if ((n & 0x1) == 1) {
-      tempVal2 |= ((uint16_t) tempVal) << 8;
-      encoded[n >> 1] |= ((uint16_t) tempVal) << 8;
-    } else {
-      tempVal2 = ((uint16_t) tempVal);
-      encoded[n >> 1] = ((uint16_t) tempVal);
-    }
-#endif
+  linear_to_alaw_block(speechIn, len, encoded_bytes);
+  // Clear the unused half of the last word.
+  if ((len & 0x1) == 1) {
+    encoded_bytes[len] = 0;
   }
   return (len);
 }
@@ -54,8 +41,7 @@ int16_t WebRtcG711_EncodeU(void* state,
                            int16_t* speechIn,
                            int16_t len,
                            int16_t* encoded) {
-  int n;
-  uint16_t tempVal;
+  uint8_t* encoded_bytes = (uint8_t*) encoded;
 
   // Set and discard to avoid getting warnings
   (void)(state = NULL);
@@ -65,23 +51,10 @@ int16_t WebRtcG711_EncodeU(void* state,
     return (-1);
   }
 
-  // Loop over all samples
-  for (n = 0; n < len; n++) {
-    tempVal = (uint16_t) linear_to_ulaw(speechIn[n]);
-
-#ifdef WEBRTC_ARCH_BIG_ENDIAN
-    if ((n & 0x1) == 1) {
-      encoded[n >> 1] |= ((uint16_t) tempVal);
-    } else {
-      encoded[n >> 1] = ((uint16_t) tempVal) << 8;
-    }
-#else
-    if ((n & 0x1) == 1) {
-      encoded[n >> 1] |= ((uint16_t) tempVal) << 8;
-    } else {
-      encoded[n >> 1] = ((uint16_t) tempVal);
-    }
-#endif
+  linear_to_ulaw_block(speechIn, len, encoded_bytes);
+  // Clear the unused half of the last word.
+  if ((len & 0x1) == 1) {
+    encoded_bytes[len] = 0;
   }
   return (len);
 }
@@ -91,9 +64,6 @@ int16_t WebRtcG711_DecodeA(void* state,
                            int16_t len,
                            int16_t* decoded,
                            int16_t* speechType) {
-  int n;
-  uint16_t tempVal;
-
   // Set and discard to avoid getting warnings
   (void)(state = NULL);
 
@@ -102,22 +72,7 @@ int16_t WebRtcG711_DecodeA(void* state,
     return (-1);
   }
 
-  for (n = 0; n < len; n++) {
-#ifdef WEBRTC_ARCH_BIG_ENDIAN
-    if ((n & 0x1) == 1) {
-      tempVal = ((uint16_t) encoded[n >> 1] & 0xFF);
-    } else {
-      tempVal = ((uint16_t) encoded[n >> 1] >> 8);
-    }
-#else
-    if ((n & 0x1) == 1) {
-      tempVal = (encoded[n >> 1] >> 8);
-    } else {
-      tempVal = (encoded[n >> 1] & 0xFF);
-    }
-#endif
-    decoded[n] = (int16_t) alaw_to_linear(tempVal);
-  }
+  alaw_to_linear_block((const uint8_t*) encoded, len, decoded);
 
   *speechType = 1;
   return (len);
@@ -128,9 +83,6 @@ int16_t WebRtcG711_DecodeU(void* state,
                            int16_t len,
                            int16_t* decoded,
                            int16_t* speechType) {
-  int n;
-  uint16_t tempVal;
-
   // Set and discard to avoid getting warnings
   (void)(state = NULL);
 
@@ -139,22 +91,7 @@ int16_t WebRtcG711_DecodeU(void* state,
     return (-1);
   }
 
-  for (n = 0; n < len; n++) {
-#ifdef WEBRTC_ARCH_BIG_ENDIAN
-    if ((n & 0x1) == 1) {
-      tempVal = ((uint16_t) encoded[n >> 1] & 0xFF);
-    } else {
-      tempVal = ((uint16_t) encoded[n >> 1] >> 8);
-    }
-#else
-    if ((n & 0x1) == 1) {
-      tempVal = (encoded[n >> 1] >> 8);
-    } else {
-      tempVal = (encoded[n >> 1] & 0xFF);
-    }
-#endif
-    decoded[n] = (int16_t) ulaw_to_linear(tempVal);
-  }
+  ulaw_to_linear_block((const uint8_t*) encoded, len, decoded);
 
   *speechType = 1;
   return (len);
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* SSE2 versions of the G.711 block encoders, which encode eight samples at a
+ * time. The segment search is done by converting the magnitudes to float: the
+ * exponent is the top bit of the magnitude, and the four bits below it, which
+ * are the quantization bits, are the top of the mantissa. The codes are
+ * bit-exact with linear_to_alaw() and linear_to_ulaw().
+ */
+
+#include <emmintrin.h>
+
+#include "g711.h"
+
+/* Returns (seg << 4) | ((magnitude >> (seg + 3)) & 0x0F) of the eight 16-bit
+ * unsigned magnitudes, with seg = top_bit(magnitude) - 7, for the magnitudes
+ * with their top bit from 7 to 14. The result of the other magnitudes is
+ * meaningless.
+ */
+static __inline __m128i segment_and_mantissa(__m128i magnitude) {
+  const __m128i zero = _mm_setzero_si128();
+  /* The exponent and the top mantissa bits of the float of 2^7 are
+     (127 + 7) << 4. */
+  const __m128i offset = _mm_set1_epi32((127 + 7) << 4);
+  __m128 low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(magnitude, zero));
+  __m128 high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(magnitude, zero));
+  __m128i code_low = _mm_sub_epi32(
+      _mm_srli_epi32(_mm_castps_si128(low), 23 - 4), offset);
+  __m128i code_high = _mm_sub_epi32(
+      _mm_srli_epi32(_mm_castps_si128(high), 23 - 4), offset);
+  return _mm_packs_epi32(code_low, code_high);
+}
+
+void linear_to_alaw_block_sse2(const int16_t* linear, int len, uint8_t* alaw) {
+  const __m128i sign_bit = _mm_set1_epi16(0x80);
+  const __m128i ami_mask = _mm_set1_epi16(ALAW_AMI_MASK);
+  const __m128i first_segment_end = _mm_set1_epi16(0x100);
+  int n = 0;
+
+  for (; n <= len - 8; n += 8) {
+    __m128i x = _mm_loadu_si128((const __m128i*)&linear[n]);
+    __m128i negative = _mm_srai_epi16(x, 15);
+    /* -x - 1 for the negative values, which keeps the magnitudes below
+       0x8000. */
+    __m128i magnitude = _mm_xor_si128(x, negative);
+    __m128i mask = _mm_or_si128(ami_mask, _mm_andnot_si128(negative, sign_bit));
+    /* The first segment is shifted down by 4 like the second one, instead of
+       by 3. */
+    __m128i first_segment = _mm_cmplt_epi16(magnitude, first_segment_end);
+    __m128i code = _mm_or_si128(
+        _mm_and_si128(first_segment, _mm_srli_epi16(magnitude, 4)),
+        _mm_andnot_si128(first_segment, segment_and_mantissa(magnitude)));
+    code = _mm_xor_si128(code, mask);
+    _mm_storel_epi64((__m128i*)&alaw[n], _mm_packus_epi16(code, code));
+  }
+  for (; n < len; n++)
+    alaw[n] = linear_to_alaw(linear[n]);
+}
+
+void linear_to_ulaw_block_sse2(const int16_t* linear, int len, uint8_t* ulaw) {
+  const __m128i bias = _mm_set1_epi16(ULAW_BIAS);
+  const __m128i sign_bit = _mm_set1_epi16(0x80);
+  const __m128i max_code = _mm_set1_epi16(0x7F);
+  const __m128i all_ones = _mm_set1_epi16(0xFF);
+  int n = 0;
+
+  for (; n <= len - 8; n += 8) {
+    __m128i x = _mm_loadu_si128((const __m128i*)&linear[n]);
+    __m128i negative = _mm_srai_epi16(x, 15);
+    /* ULAW_BIAS - x - 1 for the negative values. The bias puts the top bit at
+       7 or above, and the magnitudes fit in 16 bits when read as unsigned. */
+    __m128i magnitude = _mm_add_epi16(_mm_xor_si128(x, negative), bias);
+    __m128i mask = _mm_xor_si128(all_ones, _mm_and_si128(negative, sign_bit));
+    /* The magnitudes from 0x8000 on are beyond the last segment. */
+    __m128i beyond = _mm_srai_epi16(magnitude, 15);
+    __m128i code = _mm_or_si128(
+        _mm_and_si128(beyond, max_code),
+        _mm_andnot_si128(beyond, segment_and_mantissa(magnitude)));
+    code = _mm_xor_si128(code, mask);
+    _mm_storel_epi64((__m128i*)&ulaw[n], _mm_packus_epi16(code, code));
+  }
+  for (; n < len; n++)
+    ulaw[n] = linear_to_ulaw(linear[n]);
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/g711/include/g711_interface.h"
+#include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+
+using ::std::string;
+using ::std::tr1::make_tuple;
+using ::testing::ValuesIn;
+
+namespace webrtc {
+
+static const int kG711BlockDurationMs = 20;
+static const int kG711SamplingKhz = 8;
+
+class G711SpeedTest : public AudioCodecSpeedTest {
+ protected:
+  G711SpeedTest();
+  virtual float EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                             int max_bytes, int* encoded_bytes);
+  virtual float DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                             int16_t* out_data);
+  bool u_law_;
+};
+
+G711SpeedTest::G711SpeedTest()
+    : AudioCodecSpeedTest(kG711BlockDurationMs,
+                          kG711SamplingKhz,
+                          kG711SamplingKhz),
+      u_law_(false) {
+}
+
+float G711SpeedTest::EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                                  int max_bytes, int* encoded_bytes) {
+  int value;
+  clock_t clocks = clock();
+  if (u_law_) {
+    value = WebRtcG711_EncodeU(NULL, in_data, input_length_sample_,
+                               reinterpret_cast<int16_t*>(bit_stream));
+  } else {
+    value = WebRtcG711_EncodeA(NULL, in_data, input_length_sample_,
+                               reinterpret_cast<int16_t*>(bit_stream));
+  }
+  clocks = clock() - clocks;
+  EXPECT_EQ(input_length_sample_, value);
+  assert(value <= max_bytes);
+  *encoded_bytes = value;
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+float G711SpeedTest::DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                                  int16_t* out_data) {
+  int value;
+  int16_t audio_type;
+  // The decoders don't change the bit stream.
+  int16_t* encoded =
+      reinterpret_cast<int16_t*>(const_cast<uint8_t*>(bit_stream));
+  clock_t clocks = clock();
+  if (u_law_) {
+    value = WebRtcG711_DecodeU(NULL, encoded, encoded_bytes, out_data,
+                               &audio_type);
+  } else {
+    value = WebRtcG711_DecodeA(NULL, encoded, encoded_bytes, out_data,
+                               &audio_type);
+  }
+  clocks = clock() - clocks;
+  EXPECT_EQ(output_length_sample_, value);
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+TEST_P(G711SpeedTest, G711AEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+TEST_P(G711SpeedTest, G711UEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  u_law_ = true;
+  EncodeDecode(kDurationSec);
+}
+
+// There is no 8 kHz resource, so the 16 kHz speech is coded as if it were
+// 8 kHz. The content doesn't change the speed of the codec.
+const coding_param param_set[] =
+    {make_tuple(1, 64000, string("audio_coding/speech_mono_16kHz"),
+                string("pcm"), false)};
+
+INSTANTIATE_TEST_CASE_P(AllTest, G711SpeedTest,
+                        ValuesIn(param_set));
+
+}  // namespace webrtc
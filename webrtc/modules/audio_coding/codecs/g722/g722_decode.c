@@ -40,6 +40,7 @@
 
 #include "typedefs.h"
 #include "g722_enc_dec.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 
 #if !defined(FALSE)
@@ -49,6 +50,14 @@
 #define TRUE (!FALSE)
 #endif
 
+/* The number of sample pairs which go through the receive QMF at a time. */
+#define QMF_BLOCK_PAIRS 80
+
+static const int qmf_coeffs[12] =
+{
+       3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
+};
+
 static __inline int16_t saturate(int32_t amp)
 {
     int16_t amp16;
@@ -155,6 +164,58 @@ static void block4(g722_decode_state_t *s, int band, int d)
 }
 /*- End of function --------------------------------------------------------*/
 
+void WebRtc_g722_qmf_synthesis_c(const int16_t x[], int pairs,
+                                 int16_t amp[])
+{
+    int i;
+    int k;
+    int xout1;
+    int xout2;
+
+    for (k = 0;  k < pairs;  k++)
+    {
+        xout1 = 0;
+        xout2 = 0;
+        for (i = 0;  i < 12;  i++)
+        {
+            xout2 += x[2*i]*qmf_coeffs[i];
+            xout1 += x[2*i + 1]*qmf_coeffs[11 - i];
+        }
+        /* We shift by 12 to allow for the QMF filters (DC gain = 4096), less 1
+           to allow for the 15 bit input to the G.722 algorithm. */
+        /* WebRtc, tlegrand: added saturation */
+        amp[2*k] = saturate(xout1 >> 11);
+        amp[2*k + 1] = saturate(xout2 >> 11);
+        x += 2;
+    }
+}
+/*- End of function --------------------------------------------------------*/
+
+static g722_qmf_synthesis_t select_qmf_synthesis(void)
+{
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+    return WebRtc_g722_qmf_synthesis_sse2;
+#else
+    if (WebRtc_GetCPUInfo(kSSE2) != 0)
+        return WebRtc_g722_qmf_synthesis_sse2;
+#endif
+#endif
+    return WebRtc_g722_qmf_synthesis_c;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Applies the receive QMF to the |pairs| pairs collected in |qmf_in|, and
+   keeps the last of them as the history of the next block. */
+static int apply_receive_qmf(g722_decode_state_t *s, int16_t qmf_in[],
+                             int pairs, int16_t amp[])
+{
+    s->qmf_synthesis(qmf_in, pairs, amp);
+    memmove(qmf_in, &qmf_in[2*pairs], G722_QMF_HISTORY*sizeof(qmf_in[0]));
+    return 2*pairs;
+}
+/*- End of function --------------------------------------------------------*/
+
 g722_decode_state_t *WebRtc_g722_decode_init(g722_decode_state_t *s,
                                              int rate,
                                              int options)
@@ -179,6 +240,7 @@ g722_decode_state_t *WebRtc_g722_decode_init(g722_decode_state_t *s,
         s->packed = FALSE;
     s->band[0].det = 32;
     s->band[1].det = 8;
+    s->qmf_synthesis = select_qmf_synthesis();
     return s;
 }
 /*- End of function --------------------------------------------------------*/
@@ -244,28 +306,26 @@ int WebRtc_g722_decode(g722_decode_state_t *s, int16_t amp[],
            1688,   1360,   1040,    728,
             432,    136,   -432,   -136
     };
-    static const int qmf_coeffs[12] =
-    {
-           3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
-    };
 
     int dlowt;
     int rlow;
     int ihigh;
     int dhigh;
     int rhigh;
-    int xout1;
-    int xout2;
     int wd1;
     int wd2;
     int wd3;
     int code;
     int outlen;
-    int i;
     int j;
+    /* The QMF input of the current block of sample pairs */
+    int16_t qmf_in[G722_QMF_HISTORY + 2*QMF_BLOCK_PAIRS];
+    int qmf_pairs;
 
     outlen = 0;
     rhigh = 0;
+    memcpy(qmf_in, s->x, sizeof(s->x));
+    qmf_pairs = 0;
     for (j = 0;  j < len;  )
     {
         if (s->packed)
@@ -383,27 +443,23 @@ int WebRtc_g722_decode(g722_decode_state_t *s, int16_t amp[],
             }
             else
             {
-                /* Apply the receive QMF */
-                for (i = 0;  i < 22;  i++)
-                    s->x[i] = s->x[i + 2];
-                s->x[22] = rlow + rhigh;
-                s->x[23] = rlow - rhigh;
-
-                xout1 = 0;
-                xout2 = 0;
-                for (i = 0;  i < 12;  i++)
+                /* Collect the input of the receive QMF. The limits of rlow
+                   and rhigh keep it within 16 bits. */
+                qmf_in[G722_QMF_HISTORY + 2*qmf_pairs] = (int16_t) (rlow + rhigh);
+                qmf_in[G722_QMF_HISTORY + 2*qmf_pairs + 1] =
+                    (int16_t) (rlow - rhigh);
+                if (++qmf_pairs == QMF_BLOCK_PAIRS)
                 {
-                    xout2 += s->x[2*i]*qmf_coeffs[i];
-                    xout1 += s->x[2*i + 1]*qmf_coeffs[11 - i];
+                    outlen += apply_receive_qmf(s, qmf_in, qmf_pairs,
+                                                &amp[outlen]);
+                    qmf_pairs = 0;
                 }
-                /* We shift by 12 to allow for the QMF filters (DC gain = 4096), less 1
-                   to allow for the 15 bit input to the G.722 algorithm. */
-                /* WebRtc, tlegrand: added saturation */
-                amp[outlen++] = saturate(xout1 >> 11);
-                amp[outlen++] = saturate(xout2 >> 11);
             }
         }
     }
+    if (qmf_pairs > 0)
+        outlen += apply_receive_qmf(s, qmf_in, qmf_pairs, &amp[outlen]);
+    memcpy(s->x, qmf_in, sizeof(s->x));
     return outlen;
 }
 /*- End of function --------------------------------------------------------*/
@@ -53,6 +53,22 @@ enum
     G722_PACKED = 0x0002
 };
 
+/*! The number of samples of QMF history kept between calls. */
+#define G722_QMF_HISTORY 22
+
+/*! Applies the transmit QMF to |pairs| pairs of input samples. |x| holds the
+    G722_QMF_HISTORY previous samples followed by the 2*|pairs| new ones. The
+    low and high band samples of pair k go to |xlow|[k] and |xhigh|[k]. */
+typedef void (*g722_qmf_analysis_t)(const int16_t x[], int pairs,
+                                    int xlow[], int xhigh[]);
+
+/*! Applies the receive QMF to |pairs| pairs of sum and difference signals
+    rlow + rhigh and rlow - rhigh. |x| holds the G722_QMF_HISTORY previous
+    values followed by the 2*|pairs| new ones, and the 2*|pairs| output samples
+    go to |amp|. */
+typedef void (*g722_qmf_synthesis_t)(const int16_t x[], int pairs,
+                                     int16_t amp[]);
+
 typedef struct
 {
     /*! TRUE if the operating in the special ITU test mode, with the band split filters
@@ -65,8 +81,10 @@ typedef struct
     /*! 6 for 48000kbps, 7 for 56000kbps, or 8 for 64000kbps. */
     int bits_per_sample;
 
-    /*! Signal history for the QMF */
-    int x[24];
+    /*! Signal history for the QMF, oldest first */
+    int16_t x[G722_QMF_HISTORY];
+    /*! The transmit QMF for the CPU */
+    g722_qmf_analysis_t qmf_analysis;
 
     struct
     {
@@ -103,8 +121,10 @@ typedef struct
     /*! 6 for 48000kbps, 7 for 56000kbps, or 8 for 64000kbps. */
     int bits_per_sample;
 
-    /*! Signal history for the QMF */
-    int x[24];
+    /*! Signal history for the QMF, oldest first */
+    int16_t x[G722_QMF_HISTORY];
+    /*! The receive QMF for the CPU */
+    g722_qmf_synthesis_t qmf_synthesis;
 
     struct
     {
@@ -151,6 +171,17 @@ int WebRtc_g722_decode(g722_decode_state_t *s,
                        const uint8_t g722_data[],
                        int len);
 
+void WebRtc_g722_qmf_analysis_c(const int16_t x[], int pairs,
+                                int xlow[], int xhigh[]);
+void WebRtc_g722_qmf_synthesis_c(const int16_t x[], int pairs,
+                                 int16_t amp[]);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtc_g722_qmf_analysis_sse2(const int16_t x[], int pairs,
+                                   int xlow[], int xhigh[]);
+void WebRtc_g722_qmf_synthesis_sse2(const int16_t x[], int pairs,
+                                    int16_t amp[]);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,6 +40,7 @@
 
 #include "typedefs.h"
 #include "g722_enc_dec.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 #if !defined(FALSE)
 #define FALSE 0
@@ -48,6 +49,14 @@
 #define TRUE (!FALSE)
 #endif
 
+/* The number of sample pairs which go through the transmit QMF at a time. */
+#define QMF_BLOCK_PAIRS 80
+
+static const int qmf_coeffs[12] =
+{
+       3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
+};
+
 static __inline int16_t saturate(int32_t amp)
 {
     int16_t amp16;
@@ -151,6 +160,49 @@ static void block4(g722_encode_state_t *s, int band, int d)
 }
 /*- End of function --------------------------------------------------------*/
 
+void WebRtc_g722_qmf_analysis_c(const int16_t x[], int pairs,
+                                int xlow[], int xhigh[])
+{
+    int i;
+    int k;
+    /* Even and odd tap accumulators */
+    int sumeven;
+    int sumodd;
+
+    for (k = 0;  k < pairs;  k++)
+    {
+        /* Discard every other QMF output */
+        sumeven = 0;
+        sumodd = 0;
+        for (i = 0;  i < 12;  i++)
+        {
+            sumodd += x[2*i]*qmf_coeffs[i];
+            sumeven += x[2*i + 1]*qmf_coeffs[11 - i];
+        }
+        /* We shift by 12 to allow for the QMF filters (DC gain = 4096), plus 1
+           to allow for us summing two filters, plus 1 to allow for the 15 bit
+           input to the G.722 algorithm. */
+        xlow[k] = (sumeven + sumodd) >> 14;
+        xhigh[k] = (sumeven - sumodd) >> 14;
+        x += 2;
+    }
+}
+/*- End of function --------------------------------------------------------*/
+
+static g722_qmf_analysis_t select_qmf_analysis(void)
+{
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+    return WebRtc_g722_qmf_analysis_sse2;
+#else
+    if (WebRtc_GetCPUInfo(kSSE2) != 0)
+        return WebRtc_g722_qmf_analysis_sse2;
+#endif
+#endif
+    return WebRtc_g722_qmf_analysis_c;
+}
+/*- End of function --------------------------------------------------------*/
+
 g722_encode_state_t *WebRtc_g722_encode_init(g722_encode_state_t *s,
                                              int rate, int options)
 {
@@ -174,6 +226,7 @@ g722_encode_state_t *WebRtc_g722_encode_init(g722_encode_state_t *s,
         s->packed = FALSE;
     s->band[0].det = 32;
     s->band[1].det = 8;
+    s->qmf_analysis = select_qmf_analysis();
     return s;
 }
 /*- End of function --------------------------------------------------------*/
@@ -253,10 +306,6 @@ int WebRtc_g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     {
         -7408,  -1616,   7408,   1616
     };
-    static const int qmf_coeffs[12] =
-    {
-           3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
-    };
     static const int ihn[3] = {0, 1, 0};
     static const int ihp[3] = {0, 3, 2};
     static const int wh[3] = {0, -214, 798};
@@ -280,15 +329,20 @@ int WebRtc_g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     int xlow;
     int xhigh;
     int g722_bytes;
-    /* Even and odd tap accumulators */
-    int sumeven;
-    int sumodd;
+    /* The QMF input and output of the current block of sample pairs */
+    int16_t qmf_in[G722_QMF_HISTORY + 2*QMF_BLOCK_PAIRS];
+    int qmf_low[QMF_BLOCK_PAIRS];
+    int qmf_high[QMF_BLOCK_PAIRS];
+    int qmf_pairs;
+    int qmf_index;
     int ihigh;
     int ilow;
     int code;
 
     g722_bytes = 0;
     xhigh = 0;
+    qmf_pairs = 0;
+    qmf_index = 0;
     for (j = 0;  j < len;  )
     {
         if (s->itu_test_mode)
@@ -305,26 +359,27 @@ int WebRtc_g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
             }
             else
             {
-                /* Apply the transmit QMF */
-                /* Shuffle the buffer down */
-                for (i = 0;  i < 22;  i++)
-                    s->x[i] = s->x[i + 2];
-                s->x[22] = amp[j++];
-                s->x[23] = amp[j++];
-    
-                /* Discard every other QMF output */
-                sumeven = 0;
-                sumodd = 0;
-                for (i = 0;  i < 12;  i++)
+                if (qmf_index == qmf_pairs)
                 {
-                    sumodd += s->x[2*i]*qmf_coeffs[i];
-                    sumeven += s->x[2*i + 1]*qmf_coeffs[11 - i];
+                    /* Apply the transmit QMF to the next block of sample
+                       pairs. An odd sample left at the end has no pair, and
+                       is dropped. */
+                    qmf_pairs = (len - j) >> 1;
+                    if (qmf_pairs == 0)
+                        break;
+                    if (qmf_pairs > QMF_BLOCK_PAIRS)
+                        qmf_pairs = QMF_BLOCK_PAIRS;
+                    memcpy(qmf_in, s->x, sizeof(s->x));
+                    memcpy(&qmf_in[G722_QMF_HISTORY], &amp[j],
+                           2*qmf_pairs*sizeof(amp[0]));
+                    s->qmf_analysis(qmf_in, qmf_pairs, qmf_low, qmf_high);
+                    memcpy(s->x, &qmf_in[2*qmf_pairs], sizeof(s->x));
+                    qmf_index = 0;
                 }
-                /* We shift by 12 to allow for the QMF filters (DC gain = 4096), plus 1
-                   to allow for us summing two filters, plus 1 to allow for the 15 bit
-                   input to the G.722 algorithm. */
-                xlow = (sumeven + sumodd) >> 14;
-                xhigh = (sumeven - sumodd) >> 14;
+                xlow = qmf_low[qmf_index];
+                xhigh = qmf_high[qmf_index];
+                qmf_index++;
+                j += 2;
 
 #ifdef RUN_LIKE_REFERENCE_G722
                 /* The following lines are only used to verify bit-exactness
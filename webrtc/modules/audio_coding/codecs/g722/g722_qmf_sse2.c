@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* SSE2 versions of the G.722 transmit and receive QMF. Four pairs of samples
+ * are filtered at a time: the 24-sample window of every pair is multiplied with
+ * the interleaved even and odd taps by _mm_madd_epi16(), and the partial sums
+ * of the four pairs are added up together. The products and sums of the 16-bit
+ * samples and taps fit in 32 bits, so the results are bit-exact with the C
+ * versions.
+ */
+
+#include <emmintrin.h>
+
+#include "typedefs.h"
+#include "g722_enc_dec.h"
+
+/* The QMF taps in the order of the samples of a window, which alternate between
+ * the taps of the two filters. The transmit QMF adds the two filters up to get
+ * the low band and subtracts them to get the high band, while the receive QMF
+ * applies them apart.
+ */
+static const int16_t kLowBandTaps[3][8] = {
+  { 3, -11, -11, 53, 12, -156, 32, 362 },
+  { -210, -805, 951, 3876, 3876, 951, -805, -210 },
+  { 362, 32, -156, 12, 53, -11, -11, 3 }
+};
+static const int16_t kHighBandTaps[3][8] = {
+  { -3, -11, 11, 53, -12, -156, -32, 362 },
+  { 210, -805, -951, 3876, -3876, 951, 805, -210 },
+  { -362, 32, 156, 12, -53, -11, 11, 3 }
+};
+static const int16_t kEvenTaps[3][8] = {
+  { 3, 0, -11, 0, 12, 0, 32, 0 },
+  { -210, 0, 951, 0, 3876, 0, -805, 0 },
+  { 362, 0, -156, 0, 53, 0, -11, 0 }
+};
+static const int16_t kOddTaps[3][8] = {
+  { 0, -11, 0, 53, 0, -156, 0, 362 },
+  { 0, -805, 0, 3876, 0, 951, 0, -210 },
+  { 0, 32, 0, 12, 0, -11, 0, 3 }
+};
+
+static __inline __m128i load_taps(const int16_t taps[8]) {
+  return _mm_loadu_si128((const __m128i*)taps);
+}
+
+/* Returns the four partial sums of the 24-sample window at |x| multiplied
+ * with |taps|.
+ */
+static __inline __m128i window_sums(const int16_t* x, const __m128i taps[3]) {
+  __m128i sum =
+      _mm_madd_epi16(_mm_loadu_si128((const __m128i*)&x[0]), taps[0]);
+  sum = _mm_add_epi32(
+      sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)&x[8]), taps[1]));
+  return _mm_add_epi32(
+      sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)&x[16]), taps[2]));
+}
+
+/* Returns the totals of the partial sums |a|, |b|, |c| and |d|. */
+static __inline __m128i total_sums(__m128i a, __m128i b, __m128i c,
+                                   __m128i d) {
+  __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b),
+                             _mm_unpackhi_epi32(a, b));
+  __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d),
+                             _mm_unpackhi_epi32(c, d));
+  return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+}
+
+/* Filters the windows of four consecutive pairs starting at |x| with
+ * |taps|.
+ */
+static __inline __m128i filter_four_pairs(const int16_t* x,
+                                          const __m128i taps[3]) {
+  return total_sums(window_sums(&x[0], taps), window_sums(&x[2], taps),
+                    window_sums(&x[4], taps), window_sums(&x[6], taps));
+}
+
+void WebRtc_g722_qmf_analysis_sse2(const int16_t x[], int pairs,
+                                   int xlow[], int xhigh[]) {
+  __m128i low_taps[3];
+  __m128i high_taps[3];
+  int k = 0;
+  int i;
+
+  for (i = 0; i < 3; i++) {
+    low_taps[i] = load_taps(kLowBandTaps[i]);
+    high_taps[i] = load_taps(kHighBandTaps[i]);
+  }
+  for (; k <= pairs - 4; k += 4) {
+    const int16_t* window = &x[2 * k];
+    _mm_storeu_si128((__m128i*)&xlow[k],
+                     _mm_srai_epi32(filter_four_pairs(window, low_taps), 14));
+    _mm_storeu_si128((__m128i*)&xhigh[k],
+                     _mm_srai_epi32(filter_four_pairs(window, high_taps), 14));
+  }
+  WebRtc_g722_qmf_analysis_c(&x[2 * k], pairs - k, &xlow[k], &xhigh[k]);
+}
+
+void WebRtc_g722_qmf_synthesis_sse2(const int16_t x[], int pairs,
+                                    int16_t amp[]) {
+  __m128i even_taps[3];
+  __m128i odd_taps[3];
+  int k = 0;
+  int i;
+
+  for (i = 0; i < 3; i++) {
+    even_taps[i] = load_taps(kEvenTaps[i]);
+    odd_taps[i] = load_taps(kOddTaps[i]);
+  }
+  for (; k <= pairs - 4; k += 4) {
+    const int16_t* window = &x[2 * k];
+    __m128i xout1 = _mm_srai_epi32(filter_four_pairs(window, odd_taps), 11);
+    __m128i xout2 = _mm_srai_epi32(filter_four_pairs(window, even_taps), 11);
+    /* Interleave the outputs, and saturate them like the C version. */
+    _mm_storeu_si128((__m128i*)&amp[2 * k],
+                     _mm_packs_epi32(_mm_unpacklo_epi32(xout1, xout2),
+                                     _mm_unpackhi_epi32(xout1, xout2)));
+  }
+  WebRtc_g722_qmf_synthesis_c(&x[2 * k], pairs - k, &amp[2 * k]);
+}
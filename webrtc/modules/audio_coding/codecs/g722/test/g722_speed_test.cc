@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/g722/include/g722_interface.h"
+#include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+
+using ::std::string;
+using ::std::tr1::make_tuple;
+using ::testing::ValuesIn;
+
+namespace webrtc {
+
+static const int kG722BlockDurationMs = 20;
+static const int kG722SamplingKhz = 16;
+
+class G722SpeedTest : public AudioCodecSpeedTest {
+ protected:
+  G722SpeedTest();
+  virtual void SetUp() OVERRIDE;
+  virtual void TearDown() OVERRIDE;
+  virtual float EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                             int max_bytes, int* encoded_bytes);
+  virtual float DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                             int16_t* out_data);
+  G722EncInst* g722_encoder_;
+  G722DecInst* g722_decoder_;
+};
+
+G722SpeedTest::G722SpeedTest()
+    : AudioCodecSpeedTest(kG722BlockDurationMs,
+                          kG722SamplingKhz,
+                          kG722SamplingKhz),
+      g722_encoder_(NULL),
+      g722_decoder_(NULL) {
+}
+
+void G722SpeedTest::SetUp() {
+  AudioCodecSpeedTest::SetUp();
+  // Create encoder and decoder memory.
+  EXPECT_EQ(0, WebRtcG722_CreateEncoder(&g722_encoder_));
+  EXPECT_EQ(0, WebRtcG722_CreateDecoder(&g722_decoder_));
+  EXPECT_EQ(0, WebRtcG722_EncoderInit(g722_encoder_));
+  EXPECT_EQ(0, WebRtcG722_DecoderInit(g722_decoder_));
+}
+
+void G722SpeedTest::TearDown() {
+  AudioCodecSpeedTest::TearDown();
+  // Free memory.
+  EXPECT_EQ(0, WebRtcG722_FreeEncoder(g722_encoder_));
+  EXPECT_EQ(0, WebRtcG722_FreeDecoder(g722_decoder_));
+}
+
+float G722SpeedTest::EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                                  int max_bytes, int* encoded_bytes) {
+  clock_t clocks = clock();
+  int value = WebRtcG722_Encode(g722_encoder_, in_data, input_length_sample_,
+                                reinterpret_cast<int16_t*>(bit_stream));
+  clocks = clock() - clocks;
+  EXPECT_GT(value, 0);
+  assert(value <= max_bytes);
+  *encoded_bytes = value;
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+float G722SpeedTest::DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                                  int16_t* out_data) {
+  int value;
+  int16_t audio_type;
+  clock_t clocks = clock();
+  // The decoder doesn't change the bit stream.
+  value = WebRtcG722_Decode(
+      g722_decoder_,
+      reinterpret_cast<int16_t*>(const_cast<uint8_t*>(bit_stream)),
+      encoded_bytes, out_data, &audio_type);
+  clocks = clock() - clocks;
+  EXPECT_EQ(output_length_sample_, value);
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+TEST_P(G722SpeedTest, G722EncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+const coding_param param_set[] =
+    {make_tuple(1, 64000, string("audio_coding/speech_mono_16kHz"),
+                string("pcm"), false)};
+
+INSTANTIATE_TEST_CASE_P(AllTest, G722SpeedTest,
+                        ValuesIn(param_set));
+
+}  // namespace webrtc
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/ilbc/interface/ilbc.h"
+#include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+
+using ::std::string;
+using ::std::tr1::make_tuple;
+using ::testing::ValuesIn;
+
+namespace webrtc {
+
+// A block holds three 20 ms frames or two 30 ms frames.
+static const int kIlbcBlockDurationMs = 60;
+static const int kIlbcSamplingKhz = 8;
+
+class IlbcSpeedTest : public AudioCodecSpeedTest {
+ protected:
+  IlbcSpeedTest();
+  virtual void SetUp() OVERRIDE;
+  virtual void TearDown() OVERRIDE;
+  virtual float EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                             int max_bytes, int* encoded_bytes);
+  virtual float DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                             int16_t* out_data);
+  iLBC_encinst_t* ilbc_encoder_;
+  iLBC_decinst_t* ilbc_decoder_;
+};
+
+IlbcSpeedTest::IlbcSpeedTest()
+    : AudioCodecSpeedTest(kIlbcBlockDurationMs,
+                          kIlbcSamplingKhz,
+                          kIlbcSamplingKhz),
+      ilbc_encoder_(NULL),
+      ilbc_decoder_(NULL) {
+}
+
+void IlbcSpeedTest::SetUp() {
+  AudioCodecSpeedTest::SetUp();
+  // The bit rate selects the frame length: 15200 bps for 20 ms frames and
+  // 13330 bps for 30 ms frames.
+  int frame_length_ms = bit_rate_ == 15200 ? 20 : 30;
+  // Create encoder and decoder memory.
+  EXPECT_EQ(0, WebRtcIlbcfix_EncoderCreate(&ilbc_encoder_));
+  EXPECT_EQ(0, WebRtcIlbcfix_DecoderCreate(&ilbc_decoder_));
+  EXPECT_EQ(0, WebRtcIlbcfix_EncoderInit(ilbc_encoder_, frame_length_ms));
+  EXPECT_EQ(0, WebRtcIlbcfix_DecoderInit(ilbc_decoder_, frame_length_ms));
+}
+
+void IlbcSpeedTest::TearDown() {
+  AudioCodecSpeedTest::TearDown();
+  // Free memory.
+  EXPECT_EQ(0, WebRtcIlbcfix_EncoderFree(ilbc_encoder_));
+  EXPECT_EQ(0, WebRtcIlbcfix_DecoderFree(ilbc_decoder_));
+}
+
+float IlbcSpeedTest::EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                                  int max_bytes, int* encoded_bytes) {
+  clock_t clocks = clock();
+  int value = WebRtcIlbcfix_Encode(ilbc_encoder_, in_data,
+                                   input_length_sample_,
+                                   reinterpret_cast<int16_t*>(bit_stream));
+  clocks = clock() - clocks;
+  EXPECT_GT(value, 0);
+  assert(value <= max_bytes);
+  *encoded_bytes = value;
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+float IlbcSpeedTest::DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                                  int16_t* out_data) {
+  int value;
+  int16_t audio_type;
+  clock_t clocks = clock();
+  value = WebRtcIlbcfix_Decode(ilbc_decoder_,
+                               reinterpret_cast<const int16_t*>(bit_stream),
+                               encoded_bytes, out_data, &audio_type);
+  clocks = clock() - clocks;
+  EXPECT_EQ(output_length_sample_, value);
+  return 1000.0 * clocks / CLOCKS_PER_SEC;
+}
+
+TEST_P(IlbcSpeedTest, IlbcEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+// There is no 8 kHz resource, so the 16 kHz speech is coded as if it were
+// 8 kHz. The content doesn't change the speed of the codec.
+const coding_param param_set[] =
+    {make_tuple(1, 15200, string("audio_coding/speech_mono_16kHz"),
+                string("pcm"), false),
+     make_tuple(1, 13330, string("audio_coding/speech_mono_16kHz"),
+                string("pcm"), false)};
+
+INSTANTIATE_TEST_CASE_P(AllTest, IlbcSpeedTest,
+                        ValuesIn(param_set));
+
+}  // namespace webrtc
@@ -18,6 +18,10 @@
 
 #include "defines.h"
 
+/* The number of cross correlations computed by one call to
+   WebRtcSpl_CrossCorrelation() */
+#define XCORR_COEF_MAX_LAGS 100
+
 /*----------------------------------------------------------------*
  * cross correlation which finds the optimal lag for the
  * crossCorr*crossCorr/(energy) criteria
@@ -32,6 +36,7 @@ int WebRtcIlbcfix_XcorrCoef(
     int16_t step   /* (i) +1 or -1 */
                             ){
   int k;
+  int corrInd;
   int16_t maxlag;
   int16_t pos;
   int16_t max;
@@ -45,6 +50,7 @@ int WebRtcIlbcfix_XcorrCoef(
   int16_t scalediff;
   int32_t newCrit, maxCrit;
   int shifts;
+  int32_t crossCorrs[XCORR_COEF_MAX_LAGS];
 
   /* Initializations, to make sure that the first one is selected */
   crossCorrSqMod_Max=0;
@@ -78,10 +84,18 @@ int WebRtcIlbcfix_XcorrCoef(
   Energy=WebRtcSpl_DotProductWithScale(regressor, regressor, subl, shifts);
 
   for (k=0;k<searchLen;k++) {
-    tp = target;
-    rp = &regressor[pos];
-
-    crossCorr=WebRtcSpl_DotProductWithScale(tp, rp, subl, shifts);
+    /* Calculate the cross correlations of the next lags at once, to use the
+       vectorized versions of WebRtcSpl_CrossCorrelation() */
+    corrInd = k % XCORR_COEF_MAX_LAGS;
+    if (corrInd == 0) {
+      tp = target;
+      rp = &regressor[pos];
+      WebRtcSpl_CrossCorrelation(
+          crossCorrs, tp, rp, subl,
+          (int16_t)WEBRTC_SPL_MIN(searchLen - k, XCORR_COEF_MAX_LAGS),
+          (int16_t)shifts, step);
+    }
+    crossCorr = crossCorrs[corrInd];
 
     if ((Energy>0)&&(crossCorr>0)) {
 
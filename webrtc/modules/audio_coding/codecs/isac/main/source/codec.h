@@ -170,12 +170,34 @@ void WebRtcIsac_InitPitchAnalysis(PitchAnalysisStruct* State);
 
 void WebRtcIsac_InitTransform();
 
-void WebRtcIsac_Time2Spec(double* inre1, double* inre2, int16_t* outre,
-                          int16_t* outim, FFTstr* fftstr_obj);
+/* Tables of the transforms, filled in by WebRtcIsac_InitTransform(). */
+extern double WebRtcIsac_costab1[FRAMESAMPLES_HALF];
+extern double WebRtcIsac_sintab1[FRAMESAMPLES_HALF];
+extern double WebRtcIsac_costab2[FRAMESAMPLES_QUARTER];
+extern double WebRtcIsac_sintab2[FRAMESAMPLES_QUARTER];
 
-void WebRtcIsac_Spec2time(double* inre, double* inim, double* outre1,
+typedef void (*Time2Spec)(double* inre1, double* inre2, int16_t* outre,
+                          int16_t* outim, FFTstr* fftstr_obj);
+typedef void (*Spec2time)(double* inre, double* inim, double* outre1,
                           double* outre2, FFTstr* fftstr_obj);
 
+extern Time2Spec WebRtcIsac_Time2Spec;
+extern Spec2time WebRtcIsac_Spec2time;
+
+void WebRtcIsac_Time2SpecC(double* inre1, double* inre2, int16_t* outre,
+                           int16_t* outim, FFTstr* fftstr_obj);
+
+void WebRtcIsac_Spec2timeC(double* inre, double* inim, double* outre1,
+                           double* outre2, FFTstr* fftstr_obj);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_Time2SpecSSE2(double* inre1, double* inre2, int16_t* outre,
+                              int16_t* outim, FFTstr* fftstr_obj);
+
+void WebRtcIsac_Spec2timeSSE2(double* inre, double* inim, double* outre1,
+                              double* outre2, FFTstr* fftstr_obj);
+#endif
+
 
 /******************************* filter functions ****************************/
 
@@ -206,12 +228,40 @@ void WebRtcIsac_NormLatticeFilterMa(int orderCoef, float* stateF, float* stateG,
                                     float* lat_in, double* filtcoeflo,
                                     double* lat_out);
 
+/* Filtering of all orders of WebRtcIsac_NormLatticeFilterMa(). */
+typedef void (*NormLatticeFilterMaLoop)(int orderCoef, const float* sth,
+                                        const float* cth, const float* inv_cth,
+                                        float f[][HALF_SUBFRAMELEN],
+                                        float g[][HALF_SUBFRAMELEN]);
+extern NormLatticeFilterMaLoop WebRtcIsac_NormLatticeFilterMaLoop;
+
+void WebRtcIsac_NormLatticeFilterMaLoopC(int orderCoef, const float* sth,
+                                         const float* cth,
+                                         const float* inv_cth,
+                                         float f[][HALF_SUBFRAMELEN],
+                                         float g[][HALF_SUBFRAMELEN]);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_NormLatticeFilterMaLoopSSE2(int orderCoef, const float* sth,
+                                            const float* cth,
+                                            const float* inv_cth,
+                                            float f[][HALF_SUBFRAMELEN],
+                                            float g[][HALF_SUBFRAMELEN]);
+#endif
+
 void WebRtcIsac_NormLatticeFilterAr(int orderCoef, float* stateF, float* stateG,
                                     double* lat_in, double* lo_filt_coef,
                                     float* lat_out);
 
 void WebRtcIsac_Dir2Lat(double* a, int orderCoef, float* sth, float* cth);
 
-void WebRtcIsac_AutoCorr(double* r, const double* x, int N, int order);
+typedef void (*AutoCorr)(double* r, const double* x, int N, int order);
+extern AutoCorr WebRtcIsac_AutoCorr;
+
+void WebRtcIsac_AutoCorrC(double* r, const double* x, int N, int order);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_AutoCorrSSE2(double* r, const double* x, int N, int order);
+#endif
 
 #endif /* WEBRTC_MODULES_AUDIO_CODING_CODECS_ISAC_MAIN_SOURCE_CODEC_H_ */
@@ -84,7 +84,7 @@ void WebRtcIsac_ZeroPoleFilter(double *In, double *ZeroCoef, double *PoleCoef, i
 }
 
 
-void WebRtcIsac_AutoCorr(
+void WebRtcIsac_AutoCorrC(
     double *r,
     const double *x,
     int N,
@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* This file contains WebRtcIsac_AutoCorrSSE2(), an SSE2 version of
+ * WebRtcIsac_AutoCorrC() in filter_functions.c. Two lags are calculated at
+ * once, one in each lane, and each lane sums its products in the same order
+ * as the C version, so the results are identical.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+
+void WebRtcIsac_AutoCorrSSE2(double* r, const double* x, int N, int order) {
+  int lag = 0;
+  int n;
+
+  for (; lag + 1 <= order; lag += 2) {
+    /* The products of lag + 1 end one sample earlier than those of |lag|. */
+    __m128d sum = _mm_setzero_pd();
+    for (n = 0; n < N - lag - 1; n++) {
+      sum = _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(x[n]),
+                                       _mm_loadu_pd(&x[lag + n])));
+    }
+    _mm_storeu_pd(&r[lag], sum);
+    r[lag] += x[N - lag - 1] * x[N - 1];
+  }
+  for (; lag <= order; lag++) {
+    double sum = 0.0;
+    for (n = 0; n < N - lag; n++) {
+      sum += x[n] * x[lag + n];
+    }
+    r[lag] = sum;
+  }
+}
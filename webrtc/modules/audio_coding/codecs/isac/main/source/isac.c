@@ -29,7 +29,9 @@
 #include "webrtc/modules/audio_coding/codecs/isac/main/source/entropy_coding.h"
 #include "webrtc/modules/audio_coding/codecs/isac/main/source/lpc_shape_swb16_tables.h"
 #include "webrtc/modules/audio_coding/codecs/isac/main/source/os_specific_inline.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/pitch_estimator.h"
 #include "webrtc/modules/audio_coding/codecs/isac/main/source/structs.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 #define BIT_MASK_DEC_INIT 0x0001
 #define BIT_MASK_ENC_INIT 0x0002
@@ -37,6 +39,51 @@
 #define LEN_CHECK_SUM_WORD8     4
 #define MAX_NUM_LAYERS         10
 
+/* Declare function pointers. They default to the C versions, so that the
+ * internal functions can be used before an encoder or a decoder is
+ * initialized. */
+AutoCorr WebRtcIsac_AutoCorr = WebRtcIsac_AutoCorrC;
+NormLatticeFilterMaLoop WebRtcIsac_NormLatticeFilterMaLoop =
+    WebRtcIsac_NormLatticeFilterMaLoopC;
+PitchCorrelation WebRtcIsac_PitchCorrelation = WebRtcIsac_PitchCorrelationC;
+Time2Spec WebRtcIsac_Time2Spec = WebRtcIsac_Time2SpecC;
+Spec2time WebRtcIsac_Spec2time = WebRtcIsac_Spec2timeC;
+
+/****************************************************************************
+ * WebRtcIsac_InitSSE2(...)
+ *
+ * This function initializes function pointers for x86 platforms with SSE2.
+ * The SSE2 versions give results identical to the C versions.
+ */
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcIsac_InitSSE2(void) {
+  WebRtcIsac_AutoCorr = WebRtcIsac_AutoCorrSSE2;
+  WebRtcIsac_NormLatticeFilterMaLoop = WebRtcIsac_NormLatticeFilterMaLoopSSE2;
+  WebRtcIsac_PitchCorrelation = WebRtcIsac_PitchCorrelationSSE2;
+  WebRtcIsac_Time2Spec = WebRtcIsac_Time2SpecSSE2;
+  WebRtcIsac_Spec2time = WebRtcIsac_Spec2timeSSE2;
+}
+#endif
+
+/****************************************************************************
+ * InitFunctionPointers(...)
+ *
+ * This function selects the fastest versions of the internal functions which
+ * the platform supports.
+ */
+static void InitFunctionPointers(void) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  WebRtcIsac_InitSSE2();
+#else
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    WebRtcIsac_InitSSE2();
+  }
+#endif
+#endif
+}
+
 
 /****************************************************************************
  * UpdatePayloadSizeLimit(...)
@@ -416,6 +463,8 @@ int16_t WebRtcIsac_EncoderInit(ISACStruct* ISAC_main_inst,
   ISACMainStruct* instISAC = (ISACMainStruct*)ISAC_main_inst;
   int16_t status;
 
+  InitFunctionPointers();
+
   if ((codingMode != 0) && (codingMode != 1)) {
     instISAC->errorCode = ISAC_DISALLOWED_CODING_MODE;
     return -1;
@@ -956,6 +1005,8 @@ static int16_t DecoderInitUb(ISACUBStruct* instISAC) {
 int16_t WebRtcIsac_DecoderInit(ISACStruct* ISAC_main_inst) {
   ISACMainStruct* instISAC = (ISACMainStruct*)ISAC_main_inst;
 
+  InitFunctionPointers();
+
   if (DecoderInitLb(&instISAC->instLB) < 0) {
     return -1;
   }
@@ -24,6 +24,27 @@
 #endif
 
 /* filter the signal using normalized lattice filter */
+/* the filtering of all orders, from f[0] and g[0] and the states in f[k][0]
+   and g[k][0] */
+void WebRtcIsac_NormLatticeFilterMaLoopC(int orderCoef,
+                                         const float *sth,
+                                         const float *cth,
+                                         const float *inv_cth,
+                                         float f[][HALF_SUBFRAMELEN],
+                                         float g[][HALF_SUBFRAMELEN])
+{
+  int n,k;
+
+  for(k=0;k<orderCoef;k++)
+  {
+    for(n=0;n<(HALF_SUBFRAMELEN-1);n++)
+    {
+      f[k+1][n+1] = inv_cth[k]*(f[k][n+1] + sth[k]*g[k][n]);
+      g[k+1][n+1] = cth[k]*g[k][n] + sth[k]* f[k+1][n+1];
+    }
+  }
+}
+
 /* MA filter */
 void WebRtcIsac_NormLatticeFilterMa(int orderCoef,
                                      float *stateF,
@@ -77,14 +98,7 @@ void WebRtcIsac_NormLatticeFilterMa(int orderCoef,
     }
 
     /* filtering */
-    for(k=0;k<orderCoef;k++)
-    {
-      for(n=0;n<(HALF_SUBFRAMELEN-1);n++)
-      {
-        f[k+1][n+1] = inv_cth[k]*(f[k][n+1] + sth[k]*g[k][n]);
-        g[k+1][n+1] = cth[k]*g[k][n] + sth[k]* f[k+1][n+1];
-      }
-    }
+    WebRtcIsac_NormLatticeFilterMaLoop(orderCoef, sth, cth, inv_cth, f, g);
 
     for(n=0;n<HALF_SUBFRAMELEN;n++)
     {
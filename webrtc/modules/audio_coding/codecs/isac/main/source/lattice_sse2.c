@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* This file contains WebRtcIsac_NormLatticeFilterMaLoopSSE2(), an SSE2
+ * version of WebRtcIsac_NormLatticeFilterMaLoopC() in lattice.c. Each order
+ * only depends on the previous one, so four samples of an order are filtered
+ * at once, with the same operations as the C version.
+ */
+
+#include <xmmintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+
+void WebRtcIsac_NormLatticeFilterMaLoopSSE2(int orderCoef,
+                                            const float* sth,
+                                            const float* cth,
+                                            const float* inv_cth,
+                                            float f[][HALF_SUBFRAMELEN],
+                                            float g[][HALF_SUBFRAMELEN]) {
+  int k, n;
+
+  for (k = 0; k < orderCoef; k++) {
+    const __m128 sth_k = _mm_set1_ps(sth[k]);
+    const __m128 cth_k = _mm_set1_ps(cth[k]);
+    const __m128 inv_cth_k = _mm_set1_ps(inv_cth[k]);
+    for (n = 0; n + 4 <= HALF_SUBFRAMELEN - 1; n += 4) {
+      const __m128 g_in = _mm_loadu_ps(&g[k][n]);
+      const __m128 f_out = _mm_mul_ps(
+          inv_cth_k, _mm_add_ps(_mm_loadu_ps(&f[k][n + 1]),
+                                _mm_mul_ps(sth_k, g_in)));
+      _mm_storeu_ps(&f[k + 1][n + 1], f_out);
+      _mm_storeu_ps(&g[k + 1][n + 1], _mm_add_ps(_mm_mul_ps(cth_k, g_in),
+                                                 _mm_mul_ps(sth_k, f_out)));
+    }
+    for (; n < HALF_SUBFRAMELEN - 1; n++) {
+      f[k + 1][n + 1] = inv_cth[k] * (f[k][n + 1] + sth[k] * g[k][n]);
+      g[k + 1][n + 1] = cth[k] * g[k][n] + sth[k] * f[k + 1][n + 1];
+    }
+  }
+}
@@ -87,7 +87,7 @@ __inline static void Intrpol2D(double T[3][3], double *x, double *y, double *pea
 }
 
 
-static void PCorr(const double *in, double *outcorr)
+void WebRtcIsac_PitchCorrelationC(const double *in, double *outcorr)
 {
   double sum, ysum, prod;
   const double *x, *inptr;
@@ -176,8 +176,8 @@ void WebRtcIsac_InitializePitch(const double *in,
   memcpy(State->dec_buffer, buf_dec+PITCH_FRAME_LEN/2, sizeof(double) * (PITCH_CORR_LEN2+PITCH_CORR_STEP2+PITCH_MAX_LAG/2-PITCH_FRAME_LEN/2+2));
 
   /* compute correlation for first and second half of the frame */
-  PCorr(buf_dec, corrvec1);
-  PCorr(buf_dec + PITCH_CORR_STEP2, corrvec2);
+  WebRtcIsac_PitchCorrelation(buf_dec, corrvec1);
+  WebRtcIsac_PitchCorrelation(buf_dec + PITCH_CORR_STEP2, corrvec2);
 
   /* bias towards pitch lag of previous frame */
   log_lag = log(0.5 * old_lag);
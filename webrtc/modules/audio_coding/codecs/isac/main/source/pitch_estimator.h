@@ -28,6 +28,17 @@ void WebRtcIsac_PitchAnalysis(const double *in,               /* PITCH_FRAME_LEN
                               double *lags,
                               double *gains);
 
+/* Normalized correlations of PITCH_CORR_LEN2 samples of |in| for the
+   PITCH_LAG_SPAN2 lags up to PITCH_MAX_LAG/2 + 2, smallest lag first. */
+typedef void (*PitchCorrelation)(const double *in, double *outcorr);
+extern PitchCorrelation WebRtcIsac_PitchCorrelation;
+
+void WebRtcIsac_PitchCorrelationC(const double *in, double *outcorr);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_PitchCorrelationSSE2(const double *in, double *outcorr);
+#endif
+
 void WebRtcIsac_InitializePitch(const double *in,
                                 const double old_lag,
                                 const double old_gain,
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* This file contains WebRtcIsac_PitchCorrelationSSE2(), an SSE2 version of
+ * WebRtcIsac_PitchCorrelationC() in pitch_estimator.c. Two lags are
+ * correlated at once, one in each lane, with the products summed in the same
+ * order as the C version, so the results are identical.
+ */
+
+#include <emmintrin.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/pitch_estimator.h"
+
+void WebRtcIsac_PitchCorrelationSSE2(const double* in, double* outcorr) {
+  const double* x = in + PITCH_MAX_LAG / 2 + 2;
+  double ysum[PITCH_LAG_SPAN2];
+  int k = 0;
+  int n;
+
+  /* The energies are updated recursively, like in the C version. */
+  ysum[0] = 1e-13;
+  for (n = 0; n < PITCH_CORR_LEN2; n++) {
+    ysum[0] += in[n] * in[n];
+  }
+  for (k = 1; k < PITCH_LAG_SPAN2; k++) {
+    ysum[k] = ysum[k - 1] - in[k - 1] * in[k - 1];
+    ysum[k] += in[PITCH_CORR_LEN2 + k - 1] * in[PITCH_CORR_LEN2 + k - 1];
+  }
+
+  outcorr += PITCH_LAG_SPAN2 - 1;  /* Index of the last element. */
+  for (k = 0; k + 2 <= PITCH_LAG_SPAN2; k += 2) {
+    __m128d sum = _mm_setzero_pd();
+    double corr[2];
+    for (n = 0; n < PITCH_CORR_LEN2; n++) {
+      sum = _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(x[n]),
+                                       _mm_loadu_pd(&in[k + n])));
+    }
+    _mm_storeu_pd(corr, _mm_div_pd(sum, _mm_sqrt_pd(_mm_loadu_pd(&ysum[k]))));
+    outcorr[-k] = corr[0];
+    outcorr[-k - 1] = corr[1];
+  }
+  for (; k < PITCH_LAG_SPAN2; k++) {
+    double sum = 0.0;
+    for (n = 0; n < PITCH_CORR_LEN2; n++) {
+      sum += x[n] * in[k + n];
+    }
+    outcorr[-k] = sum / sqrt(ysum[k]);
+  }
+}
@@ -14,10 +14,10 @@
 #include "os_specific_inline.h"
 #include <math.h>
 
-static double costab1[FRAMESAMPLES_HALF];
-static double sintab1[FRAMESAMPLES_HALF];
-static double costab2[FRAMESAMPLES_QUARTER];
-static double sintab2[FRAMESAMPLES_QUARTER];
+double WebRtcIsac_costab1[FRAMESAMPLES_HALF];
+double WebRtcIsac_sintab1[FRAMESAMPLES_HALF];
+double WebRtcIsac_costab2[FRAMESAMPLES_QUARTER];
+double WebRtcIsac_sintab2[FRAMESAMPLES_QUARTER];
 
 void WebRtcIsac_InitTransform()
 {
@@ -27,26 +27,26 @@ void WebRtcIsac_InitTransform()
   fact = PI / (FRAMESAMPLES_HALF);
   phase = 0.0;
   for (k = 0; k < FRAMESAMPLES_HALF; k++) {
-    costab1[k] = cos(phase);
-    sintab1[k] = sin(phase);
+    WebRtcIsac_costab1[k] = cos(phase);
+    WebRtcIsac_sintab1[k] = sin(phase);
     phase += fact;
   }
 
   fact = PI * ((double) (FRAMESAMPLES_HALF - 1)) / ((double) FRAMESAMPLES_HALF);
   phase = 0.5 * fact;
   for (k = 0; k < FRAMESAMPLES_QUARTER; k++) {
-    costab2[k] = cos(phase);
-    sintab2[k] = sin(phase);
+    WebRtcIsac_costab2[k] = cos(phase);
+    WebRtcIsac_sintab2[k] = sin(phase);
     phase += fact;
   }
 }
 
 
-void WebRtcIsac_Time2Spec(double *inre1,
-                         double *inre2,
-                         int16_t *outreQ7,
-                         int16_t *outimQ7,
-                         FFTstr *fftstr_obj)
+void WebRtcIsac_Time2SpecC(double *inre1,
+                           double *inre2,
+                           int16_t *outreQ7,
+                           int16_t *outimQ7,
+                           FFTstr *fftstr_obj)
 {
 
   int k;
@@ -61,8 +61,8 @@ void WebRtcIsac_Time2Spec(double *inre1,
   /* Multiply with complex exponentials and combine into one complex vector */
   fact = 0.5 / sqrt(FRAMESAMPLES_HALF);
   for (k = 0; k < FRAMESAMPLES_HALF; k++) {
-    tmp1r = costab1[k];
-    tmp1i = sintab1[k];
+    tmp1r = WebRtcIsac_costab1[k];
+    tmp1i = WebRtcIsac_sintab1[k];
     tmpre[k] = (inre1[k] * tmp1r + inre2[k] * tmp1i) * fact;
     tmpim[k] = (inre2[k] * tmp1r - inre1[k] * tmp1i) * fact;
   }
@@ -78,8 +78,8 @@ void WebRtcIsac_Time2Spec(double *inre1,
     xi = tmpim[k] - tmpim[FRAMESAMPLES_HALF - 1 - k];
     yr = tmpim[k] + tmpim[FRAMESAMPLES_HALF - 1 - k];
 
-    tmp1r = costab2[k];
-    tmp1i = sintab2[k];
+    tmp1r = WebRtcIsac_costab2[k];
+    tmp1i = WebRtcIsac_sintab2[k];
     outreQ7[k] = (int16_t)WebRtcIsac_lrint((xr * tmp1r - xi * tmp1i) * 128.0);
     outimQ7[k] = (int16_t)WebRtcIsac_lrint((xr * tmp1i + xi * tmp1r) * 128.0);
     outreQ7[FRAMESAMPLES_HALF - 1 - k] = (int16_t)WebRtcIsac_lrint((-yr * tmp1i - yi * tmp1r) * 128.0);
@@ -88,7 +88,7 @@ void WebRtcIsac_Time2Spec(double *inre1,
 }
 
 
-void WebRtcIsac_Spec2time(double *inre, double *inim, double *outre1, double *outre2, FFTstr *fftstr_obj)
+void WebRtcIsac_Spec2timeC(double *inre, double *inim, double *outre1, double *outre2, FFTstr *fftstr_obj)
 {
 
   int k;
@@ -100,8 +100,8 @@ void WebRtcIsac_Spec2time(double *inre, double *inim, double *outre1, double *ou
 
   for (k = 0; k < FRAMESAMPLES_QUARTER; k++) {
     /* Move zero in time to beginning of frames */
-    tmp1r = costab2[k];
-    tmp1i = sintab2[k];
+    tmp1r = WebRtcIsac_costab2[k];
+    tmp1i = WebRtcIsac_sintab2[k];
     xr = inre[k] * tmp1r + inim[k] * tmp1i;
     xi = inim[k] * tmp1r - inre[k] * tmp1i;
     yr = -inim[FRAMESAMPLES_HALF - 1 - k] * tmp1r - inre[FRAMESAMPLES_HALF - 1 - k] * tmp1i;
@@ -122,8 +122,8 @@ void WebRtcIsac_Spec2time(double *inre, double *inim, double *outre1, double *ou
   /* Demodulate and separate */
   fact = sqrt(FRAMESAMPLES_HALF);
   for (k = 0; k < FRAMESAMPLES_HALF; k++) {
-    tmp1r = costab1[k];
-    tmp1i = sintab1[k];
+    tmp1r = WebRtcIsac_costab1[k];
+    tmp1i = WebRtcIsac_sintab1[k];
     xr = (outre1[k] * tmp1r - outre2[k] * tmp1i) * fact;
     outre2[k] = (outre2[k] * tmp1r + outre1[k] * tmp1i) * fact;
     outre1[k] = xr;
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* This file contains WebRtcIsac_Time2SpecSSE2() and WebRtcIsac_Spec2timeSSE2(),
+ * SSE2 versions of the functions in transform.c. The modulations before and
+ * after the DFT are done for two samples at once, with the same operations as
+ * the C versions, so the results are identical. The DFT is shared.
+ */
+
+#include <emmintrin.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/fft.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/os_specific_inline.h"
+
+/* Loads the two values ending at |p| in reverse order, i.e. p[0], p[-1]. */
+static __m128d LoadReversed(const double* p) {
+  const __m128d v = _mm_loadu_pd(p - 1);
+  return _mm_shuffle_pd(v, v, 1);
+}
+
+/* Stores the two values of |v| in reverse order, at p[0] and p[-1]. */
+static void StoreReversed(double* p, __m128d v) {
+  _mm_storeu_pd(p - 1, _mm_shuffle_pd(v, v, 1));
+}
+
+static __m128d Negate(__m128d v) {
+  return _mm_xor_pd(v, _mm_set1_pd(-0.0));
+}
+
+void WebRtcIsac_Time2SpecSSE2(double* inre1,
+                              double* inre2,
+                              int16_t* outreQ7,
+                              int16_t* outimQ7,
+                              FFTstr* fftstr_obj) {
+  const __m128d fact = _mm_set1_pd(0.5 / sqrt(FRAMESAMPLES_HALF));
+  const __m128d scale = _mm_set1_pd(128.0);
+  double tmpre[FRAMESAMPLES_HALF], tmpim[FRAMESAMPLES_HALF];
+  double out[4][2];
+  int dims[1];
+  int k;
+
+  dims[0] = FRAMESAMPLES_HALF;
+
+  /* Multiply with complex exponentials and combine into one complex vector */
+  for (k = 0; k < FRAMESAMPLES_HALF; k += 2) {
+    const __m128d re1 = _mm_loadu_pd(&inre1[k]);
+    const __m128d re2 = _mm_loadu_pd(&inre2[k]);
+    const __m128d tmp1r = _mm_loadu_pd(&WebRtcIsac_costab1[k]);
+    const __m128d tmp1i = _mm_loadu_pd(&WebRtcIsac_sintab1[k]);
+    _mm_storeu_pd(&tmpre[k], _mm_mul_pd(_mm_add_pd(_mm_mul_pd(re1, tmp1r),
+                                                   _mm_mul_pd(re2, tmp1i)),
+                                        fact));
+    _mm_storeu_pd(&tmpim[k], _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(re2, tmp1r),
+                                                   _mm_mul_pd(re1, tmp1i)),
+                                        fact));
+  }
+
+  /* Get DFT */
+  WebRtcIsac_Fftns(1, dims, tmpre, tmpim, -1, 1.0, fftstr_obj);
+
+  /* Use symmetry to separate into two complex vectors and center frames in
+   * time around zero */
+  for (k = 0; k < FRAMESAMPLES_QUARTER; k += 2) {
+    const __m128d re = _mm_loadu_pd(&tmpre[k]);
+    const __m128d im = _mm_loadu_pd(&tmpim[k]);
+    const __m128d re_rev = LoadReversed(&tmpre[FRAMESAMPLES_HALF - 1 - k]);
+    const __m128d im_rev = LoadReversed(&tmpim[FRAMESAMPLES_HALF - 1 - k]);
+    const __m128d xr = _mm_add_pd(re, re_rev);
+    const __m128d yi = _mm_add_pd(Negate(re), re_rev);
+    const __m128d xi = _mm_sub_pd(im, im_rev);
+    const __m128d yr = _mm_add_pd(im, im_rev);
+    const __m128d tmp1r = _mm_loadu_pd(&WebRtcIsac_costab2[k]);
+    const __m128d tmp1i = _mm_loadu_pd(&WebRtcIsac_sintab2[k]);
+    int i;
+
+    _mm_storeu_pd(out[0], _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(xr, tmp1r),
+                                                _mm_mul_pd(xi, tmp1i)),
+                                     scale));
+    _mm_storeu_pd(out[1], _mm_mul_pd(_mm_add_pd(_mm_mul_pd(xr, tmp1i),
+                                                _mm_mul_pd(xi, tmp1r)),
+                                     scale));
+    _mm_storeu_pd(out[2], _mm_mul_pd(
+        _mm_sub_pd(_mm_mul_pd(Negate(yr), tmp1i), _mm_mul_pd(yi, tmp1r)),
+        scale));
+    _mm_storeu_pd(out[3], _mm_mul_pd(
+        _mm_add_pd(_mm_mul_pd(Negate(yr), tmp1r), _mm_mul_pd(yi, tmp1i)),
+        scale));
+    /* The rounding is kept scalar, for the same int16_t wrap around of
+     * out-of-range values as the C version. */
+    for (i = 0; i < 2; i++) {
+      outreQ7[k + i] = (int16_t)WebRtcIsac_lrint(out[0][i]);
+      outimQ7[k + i] = (int16_t)WebRtcIsac_lrint(out[1][i]);
+      outreQ7[FRAMESAMPLES_HALF - 1 - k - i] =
+          (int16_t)WebRtcIsac_lrint(out[2][i]);
+      outimQ7[FRAMESAMPLES_HALF - 1 - k - i] =
+          (int16_t)WebRtcIsac_lrint(out[3][i]);
+    }
+  }
+}
+
+void WebRtcIsac_Spec2timeSSE2(double* inre,
+                              double* inim,
+                              double* outre1,
+                              double* outre2,
+                              FFTstr* fftstr_obj) {
+  const __m128d fact = _mm_set1_pd(sqrt(FRAMESAMPLES_HALF));
+  int dims;
+  int k;
+
+  dims = FRAMESAMPLES_HALF;
+
+  for (k = 0; k < FRAMESAMPLES_QUARTER; k += 2) {
+    /* Move zero in time to beginning of frames */
+    const __m128d tmp1r = _mm_loadu_pd(&WebRtcIsac_costab2[k]);
+    const __m128d tmp1i = _mm_loadu_pd(&WebRtcIsac_sintab2[k]);
+    const __m128d re = _mm_loadu_pd(&inre[k]);
+    const __m128d im = _mm_loadu_pd(&inim[k]);
+    const __m128d re_rev = LoadReversed(&inre[FRAMESAMPLES_HALF - 1 - k]);
+    const __m128d im_rev = LoadReversed(&inim[FRAMESAMPLES_HALF - 1 - k]);
+    const __m128d xr = _mm_add_pd(_mm_mul_pd(re, tmp1r),
+                                  _mm_mul_pd(im, tmp1i));
+    const __m128d xi = _mm_sub_pd(_mm_mul_pd(im, tmp1r),
+                                  _mm_mul_pd(re, tmp1i));
+    const __m128d yr = _mm_sub_pd(_mm_mul_pd(Negate(im_rev), tmp1r),
+                                  _mm_mul_pd(re_rev, tmp1i));
+    const __m128d yi = _mm_add_pd(_mm_mul_pd(Negate(re_rev), tmp1r),
+                                  _mm_mul_pd(im_rev, tmp1i));
+
+    /* Combine into one vector,  z = x + j * y */
+    _mm_storeu_pd(&outre1[k], _mm_sub_pd(xr, yi));
+    StoreReversed(&outre1[FRAMESAMPLES_HALF - 1 - k], _mm_add_pd(xr, yi));
+    _mm_storeu_pd(&outre2[k], _mm_add_pd(xi, yr));
+    StoreReversed(&outre2[FRAMESAMPLES_HALF - 1 - k],
+                  _mm_add_pd(Negate(xi), yr));
+  }
+
+  /* Get IDFT */
+  WebRtcIsac_Fftns(1, &dims, outre1, outre2, 1, FRAMESAMPLES_HALF, fftstr_obj);
+
+  /* Demodulate and separate */
+  for (k = 0; k < FRAMESAMPLES_HALF; k += 2) {
+    const __m128d tmp1r = _mm_loadu_pd(&WebRtcIsac_costab1[k]);
+    const __m128d tmp1i = _mm_loadu_pd(&WebRtcIsac_sintab1[k]);
+    const __m128d re1 = _mm_loadu_pd(&outre1[k]);
+    const __m128d re2 = _mm_loadu_pd(&outre2[k]);
+    _mm_storeu_pd(&outre1[k], _mm_mul_pd(_mm_sub_pd(_mm_mul_pd(re1, tmp1r),
+                                                    _mm_mul_pd(re2, tmp1i)),
+                                         fact));
+    _mm_storeu_pd(&outre2[k], _mm_mul_pd(_mm_add_pd(_mm_mul_pd(re2, tmp1r),
+                                                    _mm_mul_pd(re1, tmp1i)),
+                                         fact));
+  }
+}
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/interface/isac.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/settings.h"
+#include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+
+using ::std::string;
+using ::std::tr1::make_tuple;
+using ::testing::ValuesIn;
+
+namespace webrtc {
+
+static const int kIsacBlockDurationMs = 30;
+
+// The floating point iSAC, at 16 kHz (wideband) or 32 kHz (super-wideband).
+template <int kSamplingKhz>
+class IsacFloatSpeedTest : public AudioCodecSpeedTest {
+ protected:
+  IsacFloatSpeedTest()
+      : AudioCodecSpeedTest(kIsacBlockDurationMs,
+                            kSamplingKhz,
+                            kSamplingKhz),
+        isac_main_inst_(NULL) {
+  }
+
+  virtual void SetUp() OVERRIDE {
+    AudioCodecSpeedTest::SetUp();
+
+    // Check whether the allocated buffer for the bit stream is large enough.
+    EXPECT_GE(max_bytes_, STREAM_SIZE_MAX);
+
+    // Create encoder memory.
+    EXPECT_EQ(0, WebRtcIsac_Create(&isac_main_inst_));
+    EXPECT_EQ(0, WebRtcIsac_SetEncSampRate(isac_main_inst_,
+                                           kSamplingKhz * 1000));
+    EXPECT_EQ(0, WebRtcIsac_SetDecSampRate(isac_main_inst_,
+                                           kSamplingKhz * 1000));
+    EXPECT_EQ(0, WebRtcIsac_EncoderInit(isac_main_inst_, 1));
+    EXPECT_EQ(0, WebRtcIsac_DecoderInit(isac_main_inst_));
+    // Set bitrate and block length.
+    EXPECT_EQ(0, WebRtcIsac_Control(isac_main_inst_, bit_rate_,
+                                    block_duration_ms_));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    AudioCodecSpeedTest::TearDown();
+    // Free memory.
+    EXPECT_EQ(0, WebRtcIsac_Free(isac_main_inst_));
+  }
+
+  virtual float EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                             int max_bytes, int* encoded_bytes) {
+    // ISAC takes 10 ms everycall
+    const int subblocks = block_duration_ms_ / 10;
+    const int subblock_length = 10 * input_sampling_khz_;
+    int value;
+
+    clock_t clocks = clock();
+    size_t pointer = 0;
+    for (int idx = 0; idx < subblocks; idx++, pointer += subblock_length) {
+      value = WebRtcIsac_Encode(isac_main_inst_, &in_data[pointer],
+                                reinterpret_cast<int16_t*>(bit_stream));
+    }
+    clocks = clock() - clocks;
+    EXPECT_GT(value, 0);
+    assert(value <= max_bytes);
+    *encoded_bytes = value;
+    return 1000.0 * clocks / CLOCKS_PER_SEC;
+  }
+
+  virtual float DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                             int16_t* out_data) {
+    int value;
+    int16_t audio_type;
+    clock_t clocks = clock();
+    value = WebRtcIsac_Decode(isac_main_inst_,
+                              reinterpret_cast<const uint16_t*>(bit_stream),
+                              encoded_bytes, out_data, &audio_type);
+    clocks = clock() - clocks;
+    EXPECT_EQ(output_length_sample_, value);
+    return 1000.0 * clocks / CLOCKS_PER_SEC;
+  }
+
+  ISACStruct* isac_main_inst_;
+};
+
+typedef IsacFloatSpeedTest<kIsacWideband> IsacFloatWbSpeedTest;
+typedef IsacFloatSpeedTest<kIsacSuperWideband> IsacFloatSwbSpeedTest;
+
+TEST_P(IsacFloatWbSpeedTest, IsacEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+TEST_P(IsacFloatSwbSpeedTest, IsacEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+const coding_param wb_param_set[] =
+    {make_tuple(1, 10000, string("audio_coding/speech_mono_16kHz"),
+                string("pcm"), false),
+     make_tuple(1, 20000, string("audio_coding/speech_mono_16kHz"),
+                string("pcm"), false),
+     make_tuple(1, 32000, string("audio_coding/speech_mono_16kHz"),
+                string("pcm"), false)};
+
+const coding_param swb_param_set[] =
+    {make_tuple(1, 20000, string("audio_coding/speech_mono_32_48kHz"),
+                string("pcm"), false),
+     make_tuple(1, 40000, string("audio_coding/speech_mono_32_48kHz"),
+                string("pcm"), false),
+     make_tuple(1, 56000, string("audio_coding/speech_mono_32_48kHz"),
+                string("pcm"), false)};
+
+INSTANTIATE_TEST_CASE_P(AllTest, IsacFloatWbSpeedTest,
+                        ValuesIn(wb_param_set));
+INSTANTIATE_TEST_CASE_P(AllTest, IsacFloatSwbSpeedTest,
+                        ValuesIn(swb_param_set));
+
+}  // namespace webrtc
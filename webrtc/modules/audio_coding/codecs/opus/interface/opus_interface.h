@@ -22,6 +22,35 @@ typedef struct WebRtcOpusEncInst OpusEncInst;
 typedef struct WebRtcOpusDecInst OpusDecInst;
 
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst, int32_t channels);
+
+/****************************************************************************
+ * WebRtcOpus_MultistreamEncoderCreate(...)
+ *
+ * This function creates an encoder for more than two channels, e.g. 5.1 or
+ * ambisonics, which codes the channels as several mono and stereo Opus
+ * streams in one packet. All the other encoder functions apply to it.
+ *
+ * Input:
+ *      - channels           : Number of input channels (1-255, inclusive)
+ *      - streams            : Total number of coded streams
+ *      - coupled_streams    : Number of the streams which are stereo; these
+ *                             are the first ones
+ *      - mapping            : |channels| entries, giving for each input
+ *                             channel the coded channel it goes to; the
+ *                             coupled streams come first with two coded
+ *                             channels each, then the mono streams
+ *
+ * Output:
+ *      - inst               : Encoder context
+ *
+ * Return value              :  0 - Success
+ *                             -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamEncoderCreate(OpusEncInst** inst,
+                                            int32_t channels,
+                                            int32_t streams,
+                                            int32_t coupled_streams,
+                                            const uint8_t* mapping);
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
 /****************************************************************************
@@ -32,7 +61,8 @@ int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
  *
  * Input:
  *      - inst                  : Encoder context
- *      - audio_in              : Input speech data buffer
+ *      - audio_in              : Input speech data buffer, interleaved if
+ *                                there are several channels
  *      - samples               : Samples per channel in audio_in
  *      - length_encoded_buffer : Output buffer size
  *
@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include "opus.h"
+#include "opus_multistream.h"
 
 enum {
   /* Maximum supported frame size in WebRTC is 60 ms. */
@@ -33,9 +34,16 @@ enum {
 };
 
 struct WebRtcOpusEncInst {
+  /* Exactly one of these is set. */
   OpusEncoder* encoder;
+  OpusMSEncoder* multistream_encoder;
 };
 
+/* Applies an encoder CTL to whichever kind of encoder |inst| holds. */
+#define WEBRTC_OPUS_ENCODER_CTL(inst, request) \
+    ((inst)->encoder ? opus_encoder_ctl((inst)->encoder, request) : \
+        opus_multistream_encoder_ctl((inst)->multistream_encoder, request))
+
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst, int32_t channels) {
   OpusEncInst* state;
   if (inst != NULL) {
@@ -58,9 +66,36 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst, int32_t channels) {
   return -1;
 }
 
+int16_t WebRtcOpus_MultistreamEncoderCreate(OpusEncInst** inst,
+                                            int32_t channels,
+                                            int32_t streams,
+                                            int32_t coupled_streams,
+                                            const uint8_t* mapping) {
+  OpusEncInst* state;
+  if (inst != NULL && mapping != NULL) {
+    state = (OpusEncInst*) calloc(1, sizeof(OpusEncInst));
+    if (state) {
+      int error;
+      state->multistream_encoder = opus_multistream_encoder_create(
+          48000, channels, streams, coupled_streams, mapping,
+          OPUS_APPLICATION_AUDIO, &error);
+      if (error == OPUS_OK && state->multistream_encoder != NULL) {
+        *inst = state;
+        return 0;
+      }
+      free(state);
+    }
+  }
+  return -1;
+}
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   if (inst) {
-    opus_encoder_destroy(inst->encoder);
+    if (inst->encoder) {
+      opus_encoder_destroy(inst->encoder);
+    } else {
+      opus_multistream_encoder_destroy(inst->multistream_encoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -78,8 +113,13 @@ int16_t WebRtcOpus_Encode(OpusEncInst* inst, int16_t* audio_in, int16_t samples,
     return -1;
   }
 
-  res = opus_encode(inst->encoder, audio, samples, coded,
-                    length_encoded_buffer);
+  if (inst->encoder) {
+    res = opus_encode(inst->encoder, audio, samples, coded,
+                      length_encoded_buffer);
+  } else {
+    res = opus_multistream_encode(inst->multistream_encoder, audio, samples,
+                                  coded, length_encoded_buffer);
+  }
 
   if (res > 0) {
     return res;
@@ -89,7 +129,7 @@ int16_t WebRtcOpus_Encode(OpusEncInst* inst, int16_t* audio_in, int16_t samples,
 
 int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_BITRATE(rate));
+    return WEBRTC_OPUS_ENCODER_CTL(inst, OPUS_SET_BITRATE(rate));
   } else {
     return -1;
   }
@@ -97,8 +137,8 @@ int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
 
 int16_t WebRtcOpus_SetPacketLossRate(OpusEncInst* inst, int32_t loss_rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder,
-                            OPUS_SET_PACKET_LOSS_PERC(loss_rate));
+    return WEBRTC_OPUS_ENCODER_CTL(inst,
+                                   OPUS_SET_PACKET_LOSS_PERC(loss_rate));
   } else {
     return -1;
   }
@@ -106,7 +146,7 @@ int16_t WebRtcOpus_SetPacketLossRate(OpusEncInst* inst, int32_t loss_rate) {
 
 int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(1));
+    return WEBRTC_OPUS_ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(1));
   } else {
     return -1;
   }
@@ -114,7 +154,7 @@ int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(0));
+    return WEBRTC_OPUS_ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(0));
   } else {
     return -1;
   }
@@ -122,7 +162,7 @@ int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_COMPLEXITY(complexity));
+    return WEBRTC_OPUS_ENCODER_CTL(inst, OPUS_SET_COMPLEXITY(complexity));
   } else {
     return -1;
   }
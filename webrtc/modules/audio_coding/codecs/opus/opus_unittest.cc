@@ -231,6 +231,41 @@ TEST_F(OpusTest, OpusSetComplexity) {
   EXPECT_EQ(0, WebRtcOpus_EncoderFree(opus_stereo_encoder_));
 }
 
+// Encode 5.1 audio as two stereo and two mono streams.
+TEST_F(OpusTest, OpusMultistreamEncode) {
+  const int kChannels = 6;
+  const int kStreams = 4;
+  const int kCoupledStreams = 2;
+  // Front left/right and surround left/right go in the stereo streams, center
+  // and LFE in the mono ones.
+  const uint8_t kMapping[kChannels] = {0, 4, 1, 2, 3, 5};
+  WebRtcOpusEncInst* opus_multistream_encoder = NULL;
+
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(
+      NULL, kChannels, kStreams, kCoupledStreams, kMapping));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(
+      &opus_multistream_encoder, kChannels, kStreams, kCoupledStreams, NULL));
+  // More coupled streams than streams.
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(
+      &opus_multistream_encoder, kChannels, kStreams, kStreams + 1, kMapping));
+
+  EXPECT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(
+      &opus_multistream_encoder, kChannels, kStreams, kCoupledStreams,
+      kMapping));
+  EXPECT_EQ(0, WebRtcOpus_SetBitRate(opus_multistream_encoder, 256000));
+  EXPECT_EQ(0, WebRtcOpus_SetComplexity(opus_multistream_encoder, 5));
+  EXPECT_EQ(0, WebRtcOpus_SetPacketLossRate(opus_multistream_encoder, 10));
+  EXPECT_EQ(0, WebRtcOpus_EnableFec(opus_multistream_encoder));
+
+  // The speech data holds exactly one 20 ms frame of six channels.
+  ASSERT_EQ(kOpusMaxFrameSamples, kChannels * kOpus20msFrameSamples);
+  EXPECT_GT(WebRtcOpus_Encode(opus_multistream_encoder, speech_data_,
+                              kOpus20msFrameSamples, kMaxBytes, bitstream_),
+            0);
+
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(opus_multistream_encoder));
+}
+
 // Encode and decode one frame (stereo), initialize the decoder and
 // decode once more.
 TEST_F(OpusTest, OpusDecodeInit) {
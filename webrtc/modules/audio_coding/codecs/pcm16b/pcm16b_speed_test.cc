@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/pcm16b/include/pcm16b.h"
+#include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+
+using ::std::string;
+using ::std::tr1::make_tuple;
+using ::testing::Values;
+
+namespace webrtc {
+
+static const int kPcm16bBlockDurationMs = 20;
+
+template <int kSamplingKhz>
+class Pcm16bSpeedTest : public AudioCodecSpeedTest {
+ protected:
+  Pcm16bSpeedTest()
+      : AudioCodecSpeedTest(kPcm16bBlockDurationMs,
+                            kSamplingKhz,
+                            kSamplingKhz) {
+  }
+
+  virtual float EncodeABlock(int16_t* in_data, uint8_t* bit_stream,
+                             int max_bytes, int* encoded_bytes) {
+    clock_t clocks = clock();
+    int value = WebRtcPcm16b_Encode(in_data, input_length_sample_ * channels_,
+                                    bit_stream);
+    clocks = clock() - clocks;
+    EXPECT_EQ(input_length_sample_ * channels_ * 2, value);
+    assert(value <= max_bytes);
+    *encoded_bytes = value;
+    return 1000.0 * clocks / CLOCKS_PER_SEC;
+  }
+
+  virtual float DecodeABlock(const uint8_t* bit_stream, int encoded_bytes,
+                             int16_t* out_data) {
+    clock_t clocks = clock();
+    // The decoder doesn't change the bit stream.
+    int value = WebRtcPcm16b_Decode(const_cast<uint8_t*>(bit_stream),
+                                    encoded_bytes, out_data);
+    clocks = clock() - clocks;
+    EXPECT_EQ(output_length_sample_ * channels_, value);
+    return 1000.0 * clocks / CLOCKS_PER_SEC;
+  }
+};
+
+typedef Pcm16bSpeedTest<8> Pcm16b8kHzSpeedTest;
+typedef Pcm16bSpeedTest<16> Pcm16b16kHzSpeedTest;
+typedef Pcm16bSpeedTest<32> Pcm16b32kHzSpeedTest;
+
+TEST_P(Pcm16b8kHzSpeedTest, Pcm16bEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+TEST_P(Pcm16b16kHzSpeedTest, Pcm16bEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+TEST_P(Pcm16b32kHzSpeedTest, Pcm16bEncodeDecodeTest) {
+  size_t kDurationSec = 400;  // Test audio length in second.
+  EncodeDecode(kDurationSec);
+}
+
+// The bit rate is only informative; it follows from the sampling rate. There
+// is no 8 kHz resource, so the 16 kHz speech is coded as if it were 8 kHz.
+INSTANTIATE_TEST_CASE_P(
+    AllTest, Pcm16b8kHzSpeedTest,
+    Values(make_tuple(1, 128000, string("audio_coding/speech_mono_16kHz"),
+                      string("pcm"), false)));
+INSTANTIATE_TEST_CASE_P(
+    AllTest, Pcm16b16kHzSpeedTest,
+    Values(make_tuple(1, 256000, string("audio_coding/speech_mono_16kHz"),
+                      string("pcm"), false)));
+INSTANTIATE_TEST_CASE_P(
+    AllTest, Pcm16b32kHzSpeedTest,
+    Values(make_tuple(1, 512000, string("audio_coding/speech_mono_32_48kHz"),
+                      string("pcm"), false)));
+
+}  // namespace webrtc
@@ -10,13 +10,51 @@
 
 #include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 using ::std::tr1::get;
 
 namespace webrtc {
 
+// Reads the CPU time stamp counter, or returns 0 where there is none.
+static uint64_t CycleCount() {
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(_MSC_VER)
+  return __rdtsc();
+#elif defined(WEBRTC_ARCH_X86_FAMILY) && defined(__GNUC__)
+  uint32_t low, high;
+  __asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+  return (static_cast<uint64_t>(high) << 32) | low;
+#else
+  return 0;
+#endif
+}
+
+static void PrintCodingResult(const std::string& measurement,
+                              const std::string& trace,
+                              size_t audio_duration_sec,
+                              float time_ms,
+                              uint64_t cycles,
+                              size_t num_samples) {
+  char value[32];
+  if (time_ms > 0) {
+    snprintf(value, sizeof(value), "%.1f", audio_duration_sec * 1000 / time_ms);
+    test::PrintResult(measurement, "_realtime_factor", trace, value, "x",
+                      false);
+  }
+  if (cycles > 0 && num_samples > 0) {
+    snprintf(value, sizeof(value), "%.1f",
+             static_cast<double>(cycles) / num_samples);
+    test::PrintResult(measurement, "_cycles_per_sample", trace, value,
+                      "cycles", false);
+  }
+}
+
 AudioCodecSpeedTest::AudioCodecSpeedTest(int block_duration_ms,
                                          int input_sampling_khz,
                                          int output_sampling_khz)
@@ -31,6 +69,8 @@ AudioCodecSpeedTest::AudioCodecSpeedTest(int block_duration_ms,
       encoded_bytes_(0),
       encoding_time_ms_(0.0),
       decoding_time_ms_(0.0),
+      encoding_cycles_(0),
+      decoding_cycles_(0),
       out_file_(NULL) {
 }
 
@@ -70,15 +110,7 @@ void AudioCodecSpeedTest::SetUp() {
   bit_stream_.reset(new uint8_t[max_bytes_]);
 
   if (save_out_data_) {
-    std::string out_filename =
-        ::testing::UnitTest::GetInstance()->current_test_info()->name();
-
-    // Erase '/'
-    size_t found;
-    while ((found = out_filename.find('/')) != std::string::npos)
-      out_filename.replace(found, 1, "_");
-
-    out_filename = test::OutputPath() + out_filename + ".pcm";
+    std::string out_filename = test::OutputPath() + TestName() + ".pcm";
 
     out_file_ = fopen(out_filename.c_str(), "wb");
     assert(out_file_ != NULL);
@@ -102,10 +134,14 @@ void AudioCodecSpeedTest::EncodeDecode(size_t audio_duration_sec) {
 
   while (time_now_ms < audio_duration_sec * 1000) {
     // Encode & decode.
+    uint64_t cycles = CycleCount();
     time_ms = EncodeABlock(&in_data_[data_pointer_], &bit_stream_[0],
                            max_bytes_, &encoded_bytes_);
+    encoding_cycles_ += CycleCount() - cycles;
     encoding_time_ms_ += time_ms;
+    cycles = CycleCount();
     time_ms = DecodeABlock(&bit_stream_[0], encoded_bytes_, &out_data_[0]);
+    decoding_cycles_ += CycleCount() - cycles;
     decoding_time_ms_ += time_ms;
     if (save_out_data_) {
       fwrite(&out_data_[0], sizeof(int16_t),
@@ -119,6 +155,31 @@ void AudioCodecSpeedTest::EncodeDecode(size_t audio_duration_sec) {
   printf("Encoding: %.2f%% real time,\nDecoding: %.2f%% real time.\n",
          (encoding_time_ms_ / audio_duration_sec) / 10.0,
          (decoding_time_ms_ / audio_duration_sec) / 10.0);
+
+  const ::testing::TestInfo* test_info =
+      ::testing::UnitTest::GetInstance()->current_test_info();
+  std::string trace = std::string(test_info->test_case_name()) + "_" +
+      TestName();
+  size_t found;
+  while ((found = trace.find('/')) != std::string::npos)
+    trace.replace(found, 1, "_");
+  PrintCodingResult("audio_codec_encode", trace, audio_duration_sec,
+                    encoding_time_ms_, encoding_cycles_,
+                    time_now_ms * input_sampling_khz_ * channels_);
+  PrintCodingResult("audio_codec_decode", trace, audio_duration_sec,
+                    decoding_time_ms_, decoding_cycles_,
+                    time_now_ms * output_sampling_khz_ * channels_);
+}
+
+std::string AudioCodecSpeedTest::TestName() {
+  std::string name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+
+  // Erase '/'
+  size_t found;
+  while ((found = name.find('/')) != std::string::npos)
+    name.replace(found, 1, "_");
+  return name;
 }
 
 }  // namespace webrtc
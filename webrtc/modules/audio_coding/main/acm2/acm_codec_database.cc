@@ -423,14 +423,18 @@ int ACMCodecDB::CodecNumber(const CodecInst& codec_inst, int* mirror_id) {
     return kInvalidPayloadtype;
   }
 
+  // The codec is known by its id from here on, so there is no need to compare
+  // the payload name again.
+
   // Comfort Noise is special case, packet-size & rate is not checked.
-  if (STR_CASE_CMP(database_[codec_id].plname, "CN") == 0) {
+  if (codec_id == kCNNB || codec_id == kCNWB || codec_id == kCNSWB ||
+      codec_id == kCNFB) {
     *mirror_id = codec_id;
     return codec_id;
   }
 
   // RED is special case, packet-size & rate is not checked.
-  if (STR_CASE_CMP(database_[codec_id].plname, "red") == 0) {
+  if (codec_id == kRED) {
     *mirror_id = codec_id;
     return codec_id;
   }
@@ -461,7 +465,7 @@ int ACMCodecDB::CodecNumber(const CodecInst& codec_inst, int* mirror_id) {
   // Check the validity of rate. Codecs with multiple rates have their own
   // function for this.
   *mirror_id = codec_id;
-  if (STR_CASE_CMP("isac", codec_inst.plname) == 0) {
+  if (codec_id == kISAC || codec_id == kISACSWB || codec_id == kISACFB) {
     if (IsISACRateValid(codec_inst.rate)) {
       // Set mirrorID to iSAC WB which is only created once to be used both for
       // iSAC WB and SWB, because they need to share struct.
@@ -470,25 +474,25 @@ int ACMCodecDB::CodecNumber(const CodecInst& codec_inst, int* mirror_id) {
     } else {
       return kInvalidRate;
     }
-  } else if (STR_CASE_CMP("ilbc", codec_inst.plname) == 0) {
+  } else if (codec_id == kILBC) {
     return IsILBCRateValid(codec_inst.rate, codec_inst.pacsize)
         ? codec_id : kInvalidRate;
-  } else if (STR_CASE_CMP("amr", codec_inst.plname) == 0) {
+  } else if (codec_id == kGSMAMR) {
     return IsAMRRateValid(codec_inst.rate)
         ? codec_id : kInvalidRate;
-  } else if (STR_CASE_CMP("amr-wb", codec_inst.plname) == 0) {
+  } else if (codec_id == kGSMAMRWB) {
     return IsAMRwbRateValid(codec_inst.rate)
         ? codec_id : kInvalidRate;
-  } else if (STR_CASE_CMP("g7291", codec_inst.plname) == 0) {
+  } else if (codec_id == kG729_1) {
     return IsG7291RateValid(codec_inst.rate)
         ? codec_id : kInvalidRate;
-  } else if (STR_CASE_CMP("opus", codec_inst.plname) == 0) {
+  } else if (codec_id == kOpus) {
     return IsOpusRateValid(codec_inst.rate)
         ? codec_id : kInvalidRate;
-  } else if (STR_CASE_CMP("speex", codec_inst.plname) == 0) {
+  } else if (codec_id == kSPEEX8 || codec_id == kSPEEX16) {
     return IsSpeexRateValid(codec_inst.rate)
         ? codec_id : kInvalidRate;
-  } else if (STR_CASE_CMP("celt", codec_inst.plname) == 0) {
+  } else if (codec_id == kCELT32 || codec_id == kCELT32_2ch) {
     return IsCeltRateValid(codec_inst.rate)
         ? codec_id : kInvalidRate;
   }
@@ -508,25 +512,26 @@ int ACMCodecDB::CodecId(const CodecInst& codec_inst) {
 }
 
 int ACMCodecDB::CodecId(const char* payload_name, int frequency, int channels) {
-  for (int id = 0; id < kNumCodecs; id++) {
-    bool name_match = false;
-    bool frequency_match = false;
-    bool channels_match = false;
+  // The number of channels must match for all codecs but Opus. For opus we
+  // just check that number of channels is valid.
+  const bool is_opus = (STR_CASE_CMP(payload_name, "opus") == 0);
+  if (is_opus && channels != 1 && channels != 2) {
+    return -1;
+  }
 
+  for (int id = 0; id < kNumCodecs; id++) {
     // Payload name, sampling frequency and number of channels need to match.
     // NOTE! If |frequency| is -1, the frequency is not applicable, and is
     // always treated as true, like for RED.
-    name_match = (STR_CASE_CMP(database_[id].plname, payload_name) == 0);
-    frequency_match = (frequency == database_[id].plfreq) || (frequency == -1);
-    // The number of channels must match for all codecs but Opus.
-    if (STR_CASE_CMP(payload_name, "opus") != 0) {
-      channels_match = (channels == database_[id].channels);
-    } else {
-      // For opus we just check that number of channels is valid.
-      channels_match = (channels == 1 || channels == 2);
+    // The cheap integer compares rule out most of the entries before the
+    // payload names are compared.
+    if (frequency != database_[id].plfreq && frequency != -1) {
+      continue;
     }
-
-    if (name_match && frequency_match && channels_match) {
+    if (!is_opus && channels != database_[id].channels) {
+      continue;
+    }
+    if (STR_CASE_CMP(database_[id].plname, payload_name) == 0) {
       // We have found a matching codec in the list.
       return id;
     }
@@ -582,7 +587,7 @@ const NetEqDecoder* ACMCodecDB::NetEQDecoders() {
 // Gets mirror id. The Id is used for codecs sharing struct for settings that
 // need different payload types.
 int ACMCodecDB::MirrorID(int codec_id) {
-  if (STR_CASE_CMP(database_[codec_id].plname, "isac") == 0) {
+  if (codec_id == kISAC || codec_id == kISACSWB || codec_id == kISACFB) {
     return kISAC;
   } else {
     return codec_id;
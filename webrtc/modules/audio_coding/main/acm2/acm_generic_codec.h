@@ -596,6 +596,23 @@ class ACMGenericCodec {
   //
   virtual int SetPacketLossRate(int /* loss_rate */) { return 0; }
 
+  ///////////////////////////////////////////////////////////////////////////
+  // int SetComplexityAdaptation()
+  // Enables or disables adapting the encoder complexity to the time it takes
+  // to encode, lowering the complexity when encoding uses too large a share
+  // of the real time. Only codecs with a complexity setting, e.g. Opus,
+  // support this.
+  //
+  // Input:
+  //   -enable             : if true the complexity is adapted, otherwise the
+  //                         complexity set at init is used.
+  //
+  // Return value:
+  //   -1 if failed, or the codec does not support complexity adaptation
+  //    0 if succeeded.
+  //
+  virtual int SetComplexityAdaptation(bool /* enable */) { return -1; }
+
  protected:
   ///////////////////////////////////////////////////////////////////////////
   // All the functions with FunctionNameSafe(...) contain the actual
@@ -14,6 +14,7 @@
 #include "webrtc/modules/audio_coding/codecs/opus/interface/opus_interface.h"
 #include "webrtc/modules/audio_coding/main/acm2/acm_codec_database.h"
 #include "webrtc/modules/audio_coding/main/acm2/acm_common_defs.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 #endif
 
@@ -27,7 +28,10 @@ ACMOpus::ACMOpus(int16_t /* codec_id */)
     : encoder_inst_ptr_(NULL),
       sample_freq_(0),
       bitrate_(0),
-      channels_(1) {
+      channels_(1),
+      max_complexity_(0),
+      complexity_adaptation_enabled_(false),
+      complexity_controller_(0) {
   return;
 }
 
@@ -64,13 +68,33 @@ int16_t ACMOpus::SetBitRateSafe(const int32_t /*rate*/) {
   return -1;
 }
 
+int ACMOpus::SetComplexityAdaptation(bool /* enable */) {
+  return -1;
+}
+
 #else  //===================== Actual Implementation =======================
 
+namespace {
+
+#if defined(WEBRTC_ANDROID) || defined(WEBRTC_IOS) || defined(WEBRTC_ARCH_ARM)
+// If we are on Android, iOS and/or ARM, use a lower complexity setting as
+// default, to save encoder complexity.
+const int kDefaultComplexity = 5;
+#else
+// The default complexity of the Opus encoder.
+const int kDefaultComplexity = 10;
+#endif
+
+}  // namespace
+
 ACMOpus::ACMOpus(int16_t codec_id)
     : encoder_inst_ptr_(NULL),
       sample_freq_(32000),  // Default sampling frequency.
       bitrate_(20000),  // Default bit-rate.
-      channels_(1) {  // Default mono
+      channels_(1),  // Default mono
+      max_complexity_(kDefaultComplexity),
+      complexity_adaptation_enabled_(false),
+      complexity_controller_(kDefaultComplexity) {
   codec_id_ = codec_id;
   // Opus has internal DTX, but we dont use it for now.
   has_internal_dtx_ = false;
@@ -95,11 +119,25 @@ ACMOpus::~ACMOpus() {
 
 int16_t ACMOpus::InternalEncode(uint8_t* bitstream,
                                 int16_t* bitstream_len_byte) {
+  const int64_t start_time_us = TickTime::MicrosecondTimestamp();
+
   // Call Encoder.
   *bitstream_len_byte = WebRtcOpus_Encode(encoder_inst_ptr_,
                                           &in_audio_[in_audio_ix_read_],
                                           frame_len_smpl_,
                                           MAX_PAYLOAD_SIZE_BYTE, bitstream);
+
+  if (complexity_adaptation_enabled_ &&
+      complexity_controller_.FrameEncoded(
+          TickTime::MicrosecondTimestamp() - start_time_us,
+          frame_len_smpl_ * 1000 / encoder_params_.codec_inst.plfreq)) {
+    WEBRTC_TRACE(webrtc::kTraceStateInfo, webrtc::kTraceAudioCoding,
+                 unique_id_, "Opus complexity set to %d at %.1f%% encode usage",
+                 complexity_controller_.complexity(),
+                 complexity_controller_.encode_usage_percent());
+    WebRtcOpus_SetComplexity(encoder_inst_ptr_,
+                             complexity_controller_.complexity());
+  }
   // Check for error reported from encoder.
   if (*bitstream_len_byte < 0) {
     WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, unique_id_,
@@ -144,17 +182,13 @@ int16_t ACMOpus::InternalInitEncoder(WebRtcACMCodecParams* codec_params) {
 
   // TODO(tlegrand): Remove this code when we have proper APIs to set the
   // complexity at a higher level.
-#if defined(WEBRTC_ANDROID) || defined(WEBRTC_IOS) || defined(WEBRTC_ARCH_ARM)
-  // If we are on Android, iOS and/or ARM, use a lower complexity setting as
-  // default, to save encoder complexity.
-  const int kOpusComplexity5 = 5;
-  WebRtcOpus_SetComplexity(encoder_inst_ptr_, kOpusComplexity5);
+  ret = WebRtcOpus_SetComplexity(encoder_inst_ptr_, max_complexity_);
   if (ret < 0) {
      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, unique_id_,
                   "Setting complexity failed for Opus");
      return ret;
    }
-#endif
+  complexity_controller_.Reset(max_complexity_);
 
   return 0;
 }
@@ -225,6 +259,18 @@ int ACMOpus::SetPacketLossRate(int loss_rate) {
   return -1;
 }
 
+int ACMOpus::SetComplexityAdaptation(bool enable) {
+  if (!enable && complexity_adaptation_enabled_ &&
+      complexity_controller_.complexity() != max_complexity_) {
+    // Go back to the complexity set at init.
+    if (WebRtcOpus_SetComplexity(encoder_inst_ptr_, max_complexity_) < 0)
+      return -1;
+  }
+  complexity_controller_.Reset(max_complexity_);
+  complexity_adaptation_enabled_ = enable;
+  return 0;
+}
+
 #endif  // WEBRTC_CODEC_OPUS
 
 }  // namespace acm2
@@ -13,6 +13,7 @@
 
 #include "webrtc/common_audio/resampler/include/resampler.h"
 #include "webrtc/modules/audio_coding/main/acm2/acm_generic_codec.h"
+#include "webrtc/modules/audio_coding/main/acm2/opus_complexity_controller.h"
 
 struct WebRtcOpusEncInst;
 struct WebRtcOpusDecInst;
@@ -38,6 +39,8 @@ class ACMOpus : public ACMGenericCodec {
 
   virtual int SetPacketLossRate(int loss_rate) OVERRIDE;
 
+  virtual int SetComplexityAdaptation(bool enable) OVERRIDE;
+
  protected:
   void DestructEncoderSafe();
 
@@ -55,6 +58,11 @@ class ACMOpus : public ACMGenericCodec {
 
   bool fec_enabled_;
   int packet_loss_rate_;
+
+  // The complexity set at init, and the highest one the adaptation sets.
+  int max_complexity_;
+  bool complexity_adaptation_enabled_;
+  OpusComplexityController complexity_controller_;
 };
 
 }  // namespace acm2
@@ -122,6 +122,9 @@ AcmReceiver::AcmReceiver(const AudioCodingModule::Config& config)
       last_audio_decoder_(-1),  // Invalid value.
       previous_audio_activity_(AudioFrame::kVadPassive),
       current_sample_rate_hz_(config.neteq_config.sample_rate_hz),
+      get_audio_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      packet_queue_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      num_queued_packets_(0),
       nack_(),
       nack_enabled_(false),
       neteq_(NetEq::Create(config.neteq_config)),
@@ -332,18 +335,68 @@ int AcmReceiver::InsertPacket(const WebRtcRTPHeader& rtp_header,
   // we may need to insert sync-packets. We don't check |av_sync_| as we are
   // outside AcmReceiver's critical section.
   if (missing_packets_sync_stream_.get()) {
-    InsertStreamOfSyncPackets(missing_packets_sync_stream_.get());
+    InitialDelayManager::SyncStream* sync_stream =
+        missing_packets_sync_stream_.get();
+    for (int n = 0; n < sync_stream->num_sync_packets; ++n) {
+      QueuePacket(sync_stream->rtp_info, NULL, 0,
+                  sync_stream->receive_timestamp, true);
+      ++sync_stream->rtp_info.header.sequenceNumber;
+      sync_stream->rtp_info.header.timestamp += sync_stream->timestamp_step;
+      sync_stream->receive_timestamp += sync_stream->timestamp_step;
+    }
   }
 
-  if (neteq_->InsertPacket(rtp_header, incoming_payload, length_payload,
-                           receive_timestamp) < 0) {
-    LOG_FERR1(LS_ERROR, "AcmReceiver::InsertPacket", header->payloadType) <<
-        " Failed to insert packet";
-    return -1;
+  if (QueuePacket(rtp_header, incoming_payload, length_payload,
+                  receive_timestamp, false) > kMaxQueuedPackets) {
+    CriticalSectionScoped lock(get_audio_crit_sect_.get());
+    InsertQueuedPackets();
   }
   return 0;
 }
 
+size_t AcmReceiver::QueuePacket(const WebRtcRTPHeader& rtp_header,
+                                const uint8_t* payload,
+                                int length_payload,
+                                uint32_t receive_timestamp,
+                                bool sync_packet) {
+  CriticalSectionScoped lock(packet_queue_crit_sect_.get());
+  if (num_queued_packets_ == queued_packets_.size())
+    queued_packets_.push_back(QueuedPacket());
+  QueuedPacket* packet = &queued_packets_[num_queued_packets_];
+  packet->rtp_header = rtp_header;
+  packet->payload.assign(payload, payload + length_payload);
+  packet->receive_timestamp = receive_timestamp;
+  packet->sync_packet = sync_packet;
+  return ++num_queued_packets_;
+}
+
+void AcmReceiver::InsertQueuedPackets() {
+  size_t num_packets;
+  {
+    CriticalSectionScoped lock(packet_queue_crit_sect_.get());
+    queued_packets_.swap(inserted_packets_);
+    num_packets = num_queued_packets_;
+    num_queued_packets_ = 0;
+  }
+  for (size_t i = 0; i < num_packets; ++i) {
+    const QueuedPacket& packet = inserted_packets_[i];
+    if (packet.sync_packet) {
+      neteq_->InsertSyncPacket(packet.rtp_header, packet.receive_timestamp);
+      continue;
+    }
+    // NetEq copies the payload, so the storage can be reused.
+    if (neteq_->InsertPacket(packet.rtp_header,
+                             packet.payload.empty() ? NULL :
+                                 &packet.payload[0],
+                             static_cast<int>(packet.payload.size()),
+                             packet.receive_timestamp) < 0) {
+      LOG_FERR1(LS_ERROR, "AcmReceiver::InsertQueuedPackets",
+                packet.rtp_header.header.payloadType) <<
+          " Failed to insert packet";
+    }
+  }
+}
+
 int AcmReceiver::GetAudio(int desired_freq_hz, AudioFrame* audio_frame) {
   enum NetEqOutputType type;
   int16_t* ptr_audio_buffer = audio_frame->data_;
@@ -351,6 +404,9 @@ int AcmReceiver::GetAudio(int desired_freq_hz, AudioFrame* audio_frame) {
   int num_channels;
   bool return_silence = false;
 
+  CriticalSectionScoped get_audio_lock(get_audio_crit_sect_.get());
+  InsertQueuedPackets();
+
   {
     // Accessing members, take the lock.
     CriticalSectionScoped lock(crit_sect_.get());
@@ -393,32 +449,37 @@ int AcmReceiver::GetAudio(int desired_freq_hz, AudioFrame* audio_frame) {
     return -1;
   }
 
-  // Accessing members, take the lock.
-  CriticalSectionScoped lock(crit_sect_.get());
+  // NetEq always returns 10 ms of audio.
+  const int decoded_sample_rate_hz = samples_per_channel * 100;
 
-  // Update NACK.
-  int decoded_sequence_num = 0;
-  uint32_t decoded_timestamp = 0;
-  bool update_nack = nack_enabled_ &&  // Update NACK only if it is enabled.
-      neteq_->DecodedRtpInfo(&decoded_sequence_num, &decoded_timestamp);
-  if (update_nack) {
-    assert(nack_.get());
-    nack_->UpdateLastDecodedPacket(decoded_sequence_num, decoded_timestamp);
-  }
+  {
+    // Accessing members, take the lock.
+    CriticalSectionScoped lock(crit_sect_.get());
 
-  // NetEq always returns 10 ms of audio.
-  current_sample_rate_hz_ = samples_per_channel * 100;
+    // Update NACK.
+    int decoded_sequence_num = 0;
+    uint32_t decoded_timestamp = 0;
+    bool update_nack = nack_enabled_ &&  // Update NACK only if it is enabled.
+        neteq_->DecodedRtpInfo(&decoded_sequence_num, &decoded_timestamp);
+    if (update_nack) {
+      assert(nack_.get());
+      nack_->UpdateLastDecodedPacket(decoded_sequence_num, decoded_timestamp);
+    }
+
+    current_sample_rate_hz_ = decoded_sample_rate_hz;
+  }
 
-  // Update if resampling is required.
+  // Update if resampling is required. The resampler is only used here, so
+  // |crit_sect_| is not held while resampling.
   bool need_resampling = (desired_freq_hz != -1) &&
-      (current_sample_rate_hz_ != desired_freq_hz);
+      (decoded_sample_rate_hz != desired_freq_hz);
 
   if (ptr_audio_buffer == audio_buffer_) {
     // Data is written to local buffer.
     if (need_resampling) {
       samples_per_channel =
           resampler_.Resample10Msec(audio_buffer_,
-                                    current_sample_rate_hz_,
+                                    decoded_sample_rate_hz,
                                     desired_freq_hz,
                                     num_channels,
                                     AudioFrame::kMaxDataSizeSamples,
@@ -438,7 +499,7 @@ int AcmReceiver::GetAudio(int desired_freq_hz, AudioFrame* audio_frame) {
       // We might end up here ONLY if codec is changed.
       samples_per_channel =
           resampler_.Resample10Msec(audio_frame->data_,
-                                    current_sample_rate_hz_,
+                                    decoded_sample_rate_hz,
                                     desired_freq_hz,
                                     num_channels,
                                     AudioFrame::kMaxDataSizeSamples,
@@ -456,6 +517,9 @@ int AcmReceiver::GetAudio(int desired_freq_hz, AudioFrame* audio_frame) {
   audio_frame->samples_per_channel_ = samples_per_channel;
   audio_frame->sample_rate_hz_ = samples_per_channel * 100;
 
+  // Accessing members, take the lock.
+  CriticalSectionScoped lock(crit_sect_.get());
+
   // Should set |vad_activity| before calling SetAudioFrameActivityAndType().
   audio_frame->vad_activity_ = previous_audio_activity_;
   SetAudioFrameActivityAndType(vad_enabled_, type, audio_frame);
@@ -546,6 +610,11 @@ void AcmReceiver::DisableVad() {
 }
 
 void AcmReceiver::FlushBuffers() {
+  {
+    // Drop the packets that are not yet inserted into NetEq.
+    CriticalSectionScoped lock(packet_queue_crit_sect_.get());
+    num_queued_packets_ = 0;
+  }
   neteq_->FlushBuffers();
 }
 
@@ -553,6 +622,11 @@ void AcmReceiver::FlushBuffers() {
 // many as it can.
 int AcmReceiver::RemoveAllCodecs() {
   int ret_val = 0;
+  {
+    // No decoder is left for the packets not yet inserted into NetEq.
+    CriticalSectionScoped lock(packet_queue_crit_sect_.get());
+    num_queued_packets_ = 0;
+  }
   CriticalSectionScoped lock(crit_sect_.get());
   for (int n = 0; n < ACMCodecDB::kMaxNumCodecs; ++n) {
     if (decoders_[n].registered) {
@@ -575,6 +649,12 @@ int AcmReceiver::RemoveCodec(uint8_t payload_type) {
   if (codec_index < 0) {  // Such a payload-type is not registered.
     return 0;
   }
+  {
+    // Hand the packets received with |payload_type| to NetEq before the
+    // payload type is removed, as if they had been inserted right away.
+    CriticalSectionScoped lock(get_audio_crit_sect_.get());
+    InsertQueuedPackets();
+  }
   if (neteq_->RemovePayloadType(payload_type) != NetEq::kOK) {
     LOG_FERR1(LS_ERROR, "AcmReceiver::RemoveCodec", payload_type);
     return -1;
@@ -637,6 +717,11 @@ int AcmReceiver::LastAudioCodec(CodecInst* codec) const {
 }
 
 void AcmReceiver::NetworkStatistics(ACMNetworkStatistics* acm_stat) {
+  {
+    // Account for the packets received since the last GetAudio().
+    CriticalSectionScoped lock(get_audio_crit_sect_.get());
+    InsertQueuedPackets();
+  }
   NetEqNetworkStatistics neteq_stat;
   // NetEq function always returns zero, so we don't check the return value.
   neteq_->NetworkStatistics(&neteq_stat);
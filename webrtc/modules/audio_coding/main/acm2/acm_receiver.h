@@ -46,6 +46,10 @@ class AcmReceiver {
     int channels;
   };
 
+  // Past this many queued packets, InsertPacket() inserts the queue into NetEq
+  // itself, so that the queue stays bounded if GetAudio() is not called.
+  static const size_t kMaxQueuedPackets = 50;
+
   // Constructor of the class
   explicit AcmReceiver(const AudioCodingModule::Config& config);
 
@@ -53,7 +57,9 @@ class AcmReceiver {
   ~AcmReceiver();
 
   //
-  // Inserts a payload with its associated RTP-header into NetEq.
+  // Inserts a payload with its associated RTP-header into NetEq. The packet is
+  // queued and only inserted into NetEq by the next GetAudio() call, so that
+  // this call does not wait for the decoding of an ongoing GetAudio().
   //
   // Input:
   //   - rtp_header           : RTP header for the incoming payload containing
@@ -63,7 +69,7 @@ class AcmReceiver {
   //   - length_payload       : Length of incoming audio payload in bytes.
   //
   // Return value             : 0 if OK.
-  //                           <0 if NetEq returned an error.
+  //                           <0 if the payload type is not registered.
   //
   int InsertPacket(const WebRtcRTPHeader& rtp_header,
                    const uint8_t* incoming_payload,
@@ -318,8 +324,28 @@ class AcmReceiver {
   void GetDecodingCallStatistics(AudioDecodingCallStats* stats) const;
 
  private:
+  // A packet received by InsertPacket(), waiting to be inserted into NetEq.
+  struct QueuedPacket {
+    WebRtcRTPHeader rtp_header;
+    // Empty for sync-packets.
+    std::vector<uint8_t> payload;
+    uint32_t receive_timestamp;
+    bool sync_packet;
+  };
+
   int PayloadType2CodecIndex(uint8_t payload_type) const;
 
+  // Adds a packet to |queued_packets_|, reusing the storage of an earlier
+  // one. Returns the number of queued packets.
+  size_t QueuePacket(const WebRtcRTPHeader& rtp_header,
+                     const uint8_t* payload,
+                     int length_payload,
+                     uint32_t receive_timestamp,
+                     bool sync_packet);
+
+  // Inserts the queued packets into NetEq, in the order they were received.
+  void InsertQueuedPackets() EXCLUSIVE_LOCKS_REQUIRED(get_audio_crit_sect_);
+
   bool GetSilence(int desired_sample_rate_hz, AudioFrame* frame)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
@@ -337,10 +363,21 @@ class AcmReceiver {
   int last_audio_decoder_ GUARDED_BY(crit_sect_);
   AudioFrame::VADActivity previous_audio_activity_ GUARDED_BY(crit_sect_);
   int current_sample_rate_hz_ GUARDED_BY(crit_sect_);
-  ACMResampler resampler_ GUARDED_BY(crit_sect_);
+  // Serializes GetAudio() and the insertion of the queued packets into NetEq,
+  // neither of which holds |crit_sect_| while decoding or resampling.
+  scoped_ptr<CriticalSectionWrapper> get_audio_crit_sect_;
+  ACMResampler resampler_ GUARDED_BY(get_audio_crit_sect_);
   // Used in GetAudio, declared as member to avoid allocating every 10ms.
   // TODO(henrik.lundin) Stack-allocate in GetAudio instead?
-  int16_t audio_buffer_[AudioFrame::kMaxDataSizeSamples] GUARDED_BY(crit_sect_);
+  int16_t audio_buffer_[AudioFrame::kMaxDataSizeSamples]
+      GUARDED_BY(get_audio_crit_sect_);
+  // Only held to add packets to, or take them from, |queued_packets_|.
+  scoped_ptr<CriticalSectionWrapper> packet_queue_crit_sect_;
+  // The first |num_queued_packets_| entries are queued. The entries are
+  // swapped with |inserted_packets_| and reused, to not allocate per packet.
+  std::vector<QueuedPacket> queued_packets_ GUARDED_BY(packet_queue_crit_sect_);
+  size_t num_queued_packets_ GUARDED_BY(packet_queue_crit_sect_);
+  std::vector<QueuedPacket> inserted_packets_ GUARDED_BY(get_audio_crit_sect_);
   scoped_ptr<Nack> nack_ GUARDED_BY(crit_sect_);
   bool nack_enabled_ GUARDED_BY(crit_sect_);
   CallStatistics call_stats_ GUARDED_BY(crit_sect_);
@@ -11,6 +11,7 @@
 #include "webrtc/modules/audio_coding/main/acm2/acm_receiver.h"
 
 #include <algorithm>  // std::min
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "webrtc/modules/audio_coding/main/interface/audio_coding_module.h"
@@ -119,6 +120,30 @@ class AcmReceiverTest : public AudioPacketizationCallback,
     }
   }
 
+  // Inserts |num_packets| packets of 10 ms of PCM16B at 8 kHz. The codec
+  // should be registered.
+  void InsertPcm16bPackets(int num_packets) {
+    const CodecInst& codec = codecs_[ACMCodecDB::kPCM16B];
+    const std::vector<uint8_t> payload(codec.pacsize * sizeof(int16_t), 0);
+    rtp_header_.header.payloadType = codec.pltype;
+    rtp_header_.frameType = kAudioFrameSpeech;
+    rtp_header_.type.Audio.isCNG = false;
+    for (int n = 0; n < num_packets; ++n) {
+      ASSERT_EQ(0, receiver_->InsertPacket(
+          rtp_header_, &payload[0], static_cast<int>(payload.size())));
+      rtp_header_.header.sequenceNumber++;
+      rtp_header_.header.timestamp += codec.pacsize;
+    }
+  }
+
+  // Returns the amount of audio in NetEq's buffers, in milliseconds. This
+  // inserts the queued packets into NetEq.
+  int BufferSizeMs() {
+    ACMNetworkStatistics stats;
+    receiver_->NetworkStatistics(&stats);
+    return stats.currentBufferSize;
+  }
+
   virtual int SendData(
       FrameType frame_type,
       uint8_t payload_type,
@@ -374,6 +399,100 @@ TEST_F(AcmReceiverTest, DISABLED_ON_ANDROID(LastAudioCodec)) {
   }
 }
 
+// Packets wait in a queue until GetAudio(). NetworkStatistics() inserts them
+// first, so that the statistics account for them.
+TEST_F(AcmReceiverTest,
+       DISABLED_ON_ANDROID(NetworkStatisticsInsertsQueuedPackets)) {
+  const int id = ACMCodecDB::kPCM16B;
+  ASSERT_EQ(0, receiver_->AddCodec(id, codecs_[id].pltype,
+                                   codecs_[id].channels, NULL));
+  InsertPcm16bPackets(3);
+  EXPECT_EQ(30, BufferSizeMs());
+}
+
+// Queued packets reach NetEq before their payload type is removed, as if they
+// had been inserted right away. NetEq would reject them otherwise.
+TEST_F(AcmReceiverTest, DISABLED_ON_ANDROID(RemoveCodecInsertsQueuedPackets)) {
+  const int id = ACMCodecDB::kPCM16B;
+  ASSERT_EQ(0, receiver_->AddCodec(id, codecs_[id].pltype,
+                                   codecs_[id].channels, NULL));
+  InsertPcm16bPackets(3);
+  ASSERT_EQ(0, receiver_->RemoveCodec(codecs_[id].pltype));
+  // Without their decoder, NetEq can't tell the duration of the packets.
+  EXPECT_GT(BufferSizeMs(), 0);
+}
+
+TEST_F(AcmReceiverTest, DISABLED_ON_ANDROID(FlushBuffersDropsQueuedPackets)) {
+  const int id = ACMCodecDB::kPCM16B;
+  ASSERT_EQ(0, receiver_->AddCodec(id, codecs_[id].pltype,
+                                   codecs_[id].channels, NULL));
+  InsertPcm16bPackets(3);
+  receiver_->FlushBuffers();
+  EXPECT_EQ(0, BufferSizeMs());
+
+  // Later packets are inserted as usual.
+  InsertPcm16bPackets(2);
+  EXPECT_EQ(20, BufferSizeMs());
+}
+
+TEST_F(AcmReceiverTest,
+       DISABLED_ON_ANDROID(RemoveAllCodecsDropsQueuedPackets)) {
+  const int id = ACMCodecDB::kPCM16B;
+  ASSERT_EQ(0, receiver_->AddCodec(id, codecs_[id].pltype,
+                                   codecs_[id].channels, NULL));
+  InsertPcm16bPackets(3);
+  ASSERT_EQ(0, receiver_->RemoveAllCodecs());
+  // Had the packets stayed queued, they would be decodable again.
+  ASSERT_EQ(0, receiver_->AddCodec(id, codecs_[id].pltype,
+                                   codecs_[id].channels, NULL));
+  EXPECT_EQ(0, BufferSizeMs());
+}
+
+// Without GetAudio() calls, InsertPacket() inserts the queue into NetEq itself
+// once it is full.
+TEST_F(AcmReceiverTest, DISABLED_ON_ANDROID(InsertsQueueWhenFull)) {
+  const int kMaxQueuedPackets =
+      static_cast<int>(AcmReceiver::kMaxQueuedPackets);
+  // Leave room in NetEq, which would flush its buffer when full.
+  AudioCodingModule::Config config;
+  config.neteq_config.max_packets_in_buffer = 2 * kMaxQueuedPackets;
+  receiver_.reset(new AcmReceiver(config));
+  const int id = ACMCodecDB::kPCM16B;
+  ASSERT_EQ(0, receiver_->AddCodec(id, codecs_[id].pltype,
+                                   codecs_[id].channels, NULL));
+  InsertPcm16bPackets(kMaxQueuedPackets + 1);
+  // The queue was emptied, so this one stays queued. Dropping the queue leaves
+  // only the packets NetEq has.
+  InsertPcm16bPackets(1);
+  ASSERT_EQ(0, receiver_->RemoveAllCodecs());
+  ASSERT_EQ(0, receiver_->AddCodec(id, codecs_[id].pltype,
+                                   codecs_[id].channels, NULL));
+  EXPECT_EQ(10 * (kMaxQueuedPackets + 1), BufferSizeMs());
+}
+
+// A packet that NetEq rejects does not fail InsertPacket(), which returns
+// before the packet reaches NetEq, nor keep later packets out of NetEq.
+TEST_F(AcmReceiverTest, DISABLED_ON_ANDROID(NetEqErrorsAreNotReturned)) {
+  const int kCodecId[] = {
+      ACMCodecDB::kPCM16B, ACMCodecDB::kRED,
+      -1  // Terminator.
+  };
+  AddSetOfCodecs(kCodecId);
+  const uint8_t pcm16b_payload_type = codecs_[ACMCodecDB::kPCM16B].pltype;
+  // A redundant block of 255 bytes followed by the primary header, but no
+  // payload. NetEq fails to split it.
+  const uint8_t kRedPayload[] = {
+      static_cast<uint8_t>(0x80 | pcm16b_payload_type), 0, 0, 255,
+      pcm16b_payload_type
+  };
+  rtp_header_.header.payloadType = codecs_[ACMCodecDB::kRED].pltype;
+  EXPECT_EQ(0, receiver_->InsertPacket(rtp_header_, kRedPayload,
+                                       sizeof(kRedPayload)));
+  rtp_header_.header.sequenceNumber++;
+  InsertPcm16bPackets(1);
+  EXPECT_EQ(10, BufferSizeMs());
+}
+
 }  // namespace acm2
 
 }  // namespace webrtc
@@ -12,6 +12,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <vector>
 
 #include "webrtc/engine_configurations.h"
@@ -145,7 +146,8 @@ AudioCodingModuleImpl::AudioCodingModuleImpl(
       first_10ms_data_(false),
       callback_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
       packetization_callback_(NULL),
-      vad_callback_(NULL) {
+      vad_callback_(NULL),
+      encoder_owner_(NULL) {
 
   // Nullify send codec memory, set payload type and set codec name to
   // invalid values.
@@ -206,6 +208,17 @@ AudioCodingModuleImpl::AudioCodingModuleImpl(
 }
 
 AudioCodingModuleImpl::~AudioCodingModuleImpl() {
+  ShareEncoderWith(NULL);
+  std::vector<AudioCodingModuleImpl*> sharers;
+  {
+    CriticalSectionScoped lock(callback_crit_sect_);
+    sharers.swap(encoder_sharers_);
+  }
+  for (size_t i = 0; i < sharers.size(); ++i) {
+    CriticalSectionScoped lock(sharers[i]->acm_crit_sect_);
+    sharers[i]->encoder_owner_ = NULL;
+  }
+
   {
     CriticalSectionScoped lock(acm_crit_sect_);
     current_send_codec_idx_ = -1;
@@ -275,6 +288,10 @@ int32_t AudioCodingModuleImpl::Process() {
   bool dual_stream;
   {
     CriticalSectionScoped lock(acm_crit_sect_);
+    // The payloads are delivered by the owner of the shared encoder.
+    if (encoder_owner_ != NULL) {
+      return 0;
+    }
     dual_stream = (secondary_encoder_.get() != NULL);
   }
   if (dual_stream) {
@@ -686,6 +703,12 @@ int AudioCodingModuleImpl::ProcessSingleStream() {
       }
     }
 
+    for (size_t i = 0; i < encoder_sharers_.size(); ++i) {
+      encoder_sharers_[i]->SendSharedPayload(frame_type, encoding_type,
+                                             red_active, rtp_timestamp, stream,
+                                             length_bytes, my_fragmentation);
+    }
+
     if (vad_callback_ != NULL) {
       // Callback with VAD decision.
       vad_callback_->InFrameType(static_cast<int16_t>(encoding_type));
@@ -1215,6 +1238,154 @@ int AudioCodingModuleImpl::RegisterTransportCallback(
   return 0;
 }
 
+int AudioCodingModuleImpl::ShareEncoderWith(AudioCodingModule* encoder_owner) {
+  AudioCodingModuleImpl* owner =
+      static_cast<AudioCodingModuleImpl*>(encoder_owner);
+  if (owner == this) {
+    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                 "ShareEncoderWith(): cannot share the own encoder");
+    return -1;
+  }
+
+  if (owner != NULL) {
+    // The settings are read through the public getters, so that the locks of
+    // the two modules are never held at the same time.
+    CodecInst codec;
+    CodecInst owner_codec;
+    CodecInst secondary_codec;
+    if (SendCodec(&codec) < 0 || owner->SendCodec(&owner_codec) < 0) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "ShareEncoderWith(): no send codec registered");
+      return -1;
+    }
+    if (SecondarySendCodec(&secondary_codec) == 0 ||
+        owner->SecondarySendCodec(&secondary_codec) == 0) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "ShareEncoderWith(): not supported with dual-streaming");
+      return -1;
+    }
+    bool dtx, vad, owner_dtx, owner_vad;
+    ACMVADMode vad_mode, owner_vad_mode;
+    VAD(&dtx, &vad, &vad_mode);
+    owner->VAD(&owner_dtx, &owner_vad, &owner_vad_mode);
+    if (STR_CASE_CMP(codec.plname, owner_codec.plname) != 0 ||
+        codec.plfreq != owner_codec.plfreq ||
+        codec.pacsize != owner_codec.pacsize ||
+        codec.channels != owner_codec.channels ||
+        codec.rate != owner_codec.rate ||
+        REDStatus() != owner->REDStatus() ||
+        dtx != owner_dtx || vad != owner_vad || vad_mode != owner_vad_mode) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "ShareEncoderWith(): the send settings differ");
+      return -1;
+    }
+    if (owner->SharesEncoder()) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "ShareEncoderWith(): the owner shares an encoder itself");
+      return -1;
+    }
+    CriticalSectionScoped lock(callback_crit_sect_);
+    if (!encoder_sharers_.empty()) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "ShareEncoderWith(): the own encoder is shared");
+      return -1;
+    }
+  }
+
+  AudioCodingModuleImpl* previous_owner;
+  {
+    CriticalSectionScoped lock(acm_crit_sect_);
+    previous_owner = encoder_owner_;
+    encoder_owner_ = owner;
+  }
+  if (previous_owner != NULL) {
+    previous_owner->RemoveEncoderSharer(this);
+  }
+  if (owner != NULL) {
+    owner->AddEncoderSharer(this);
+  }
+  return 0;
+}
+
+bool AudioCodingModuleImpl::SharesEncoder() const {
+  CriticalSectionScoped lock(acm_crit_sect_);
+  return encoder_owner_ != NULL;
+}
+
+void AudioCodingModuleImpl::AddEncoderSharer(AudioCodingModuleImpl* sharer) {
+  CriticalSectionScoped lock(callback_crit_sect_);
+  encoder_sharers_.push_back(sharer);
+}
+
+void AudioCodingModuleImpl::RemoveEncoderSharer(
+    AudioCodingModuleImpl* sharer) {
+  CriticalSectionScoped lock(callback_crit_sect_);
+  std::vector<AudioCodingModuleImpl*>::iterator it =
+      std::find(encoder_sharers_.begin(), encoder_sharers_.end(), sharer);
+  if (it != encoder_sharers_.end()) {
+    encoder_sharers_.erase(it);
+  }
+}
+
+// Called by the owner of the shared encoder, with its callback lock held.
+// Dual-streaming is not supported when sharing, so only the payloads of
+// ProcessSingleStream() arrive here.
+void AudioCodingModuleImpl::SendSharedPayload(
+    FrameType frame_type,
+    WebRtcACMEncodingType encoding_type,
+    bool red_active,
+    uint32_t rtp_timestamp,
+    const uint8_t* stream,
+    int16_t length_bytes,
+    const RTPFragmentationHeader& fragmentation) {
+  uint8_t payload_type = 0;
+  RTPFragmentationHeader my_fragmentation;
+  {
+    CriticalSectionScoped lock(acm_crit_sect_);
+    switch (encoding_type) {
+      case kNoEncoding:
+        payload_type = previous_pltype_;
+        break;
+      case kActiveNormalEncoded:
+      case kPassiveNormalEncoded:
+        payload_type = static_cast<uint8_t>(send_codec_inst_.pltype);
+        break;
+      case kPassiveDTXNB:
+        payload_type = cng_nb_pltype_;
+        break;
+      case kPassiveDTXWB:
+        payload_type = cng_wb_pltype_;
+        break;
+      case kPassiveDTXSWB:
+        payload_type = cng_swb_pltype_;
+        break;
+      case kPassiveDTXFB:
+        payload_type = cng_fb_pltype_;
+        break;
+    }
+    previous_pltype_ = payload_type;
+    if (red_active) {
+      // RED is only applied on speech, so both fragments carry the payload
+      // type of the send codec.
+      my_fragmentation.CopyFrom(fragmentation);
+      for (int n = 0; n < my_fragmentation.fragmentationVectorSize; ++n) {
+        my_fragmentation.fragmentationPlType[n] = payload_type;
+      }
+      payload_type = red_pltype_;
+    }
+  }
+
+  CriticalSectionScoped lock(callback_crit_sect_);
+  if (packetization_callback_ != NULL) {
+    packetization_callback_->SendData(frame_type, payload_type, rtp_timestamp,
+                                      stream, length_bytes,
+                                      red_active ? &my_fragmentation : NULL);
+  }
+  if (vad_callback_ != NULL) {
+    vad_callback_->InFrameType(static_cast<int16_t>(encoding_type));
+  }
+}
+
 // Add 10MS of raw (PCM) audio data to the encoder.
 int AudioCodingModuleImpl::Add10MsData(
     const AudioFrame& audio_frame) {
@@ -1254,6 +1425,11 @@ int AudioCodingModuleImpl::Add10MsData(
     return -1;
   }
 
+  // The owner of the shared encoder encodes the audio.
+  if (encoder_owner_ != NULL) {
+    return 0;
+  }
+
   const AudioFrame* ptr_frame;
   // Perform a resampling, also down-mix if it is required and can be
   // performed before resampling (a down mix prior to resampling will take
@@ -1487,6 +1663,17 @@ int AudioCodingModuleImpl::SetPacketLossRate(int loss_rate) {
   return 0;
 }
 
+int AudioCodingModuleImpl::SetCodecComplexityAdaptation(bool enable) {
+  CriticalSectionScoped lock(acm_crit_sect_);
+  if (HaveValidEncoder("SetCodecComplexityAdaptation") &&
+      codecs_[current_send_codec_idx_]->SetComplexityAdaptation(enable) < 0) {
+      WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                   "Set codec complexity adaptation failed.");
+    return -1;
+  }
+  return 0;
+}
+
 /////////////////////////////////////////
 //   (VAD) Voice Activity Detection
 //
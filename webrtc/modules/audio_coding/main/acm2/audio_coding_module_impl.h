@@ -88,6 +88,9 @@ class AudioCodingModuleImpl : public AudioCodingModule {
   // called to deliver the encoded buffers.
   int RegisterTransportCallback(AudioPacketizationCallback* transport);
 
+  // Send the payloads encoded by |encoder_owner| instead of encoding locally.
+  int ShareEncoderWith(AudioCodingModule* encoder_owner);
+
   // Add 10 ms of raw (PCM) audio data to the encoder.
   int Add10MsData(const AudioFrame& audio_frame);
 
@@ -114,6 +117,9 @@ class AudioCodingModuleImpl : public AudioCodingModule {
   // Set target packet loss rate
   int SetPacketLossRate(int loss_rate);
 
+  // Enable or disable complexity adaptation of the send codec.
+  int SetCodecComplexityAdaptation(bool enable);
+
   /////////////////////////////////////////
   //   (VAD) Voice Activity Detection
   //   and
@@ -249,6 +255,23 @@ class AudioCodingModuleImpl : public AudioCodingModule {
 
   int InitializeReceiverSafe() EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
 
+  // Returns true if this module sends the payloads of another module.
+  bool SharesEncoder() const;
+
+  // Adds or removes a module which sends the payloads encoded by this one.
+  void AddEncoderSharer(AudioCodingModuleImpl* sharer);
+  void RemoveEncoderSharer(AudioCodingModuleImpl* sharer);
+
+  // Delivers a payload encoded by |encoder_owner_| to the transport callback,
+  // with the payload types mapped to the ones registered in this module.
+  void SendSharedPayload(FrameType frame_type,
+                         WebRtcACMEncodingType encoding_type,
+                         bool red_active,
+                         uint32_t rtp_timestamp,
+                         const uint8_t* stream,
+                         int16_t length_bytes,
+                         const RTPFragmentationHeader& fragmentation);
+
   bool HaveValidEncoder(const char* caller_name) const
       EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
 
@@ -374,6 +397,12 @@ class AudioCodingModuleImpl : public AudioCodingModule {
   AudioPacketizationCallback* packetization_callback_
       GUARDED_BY(callback_crit_sect_);
   ACMVADCallback* vad_callback_ GUARDED_BY(callback_crit_sect_);
+
+  // The module whose payloads this module sends, if any.
+  AudioCodingModuleImpl* encoder_owner_ GUARDED_BY(acm_crit_sect_);
+  // The modules which send the payloads encoded by this module.
+  std::vector<AudioCodingModuleImpl*> encoder_sharers_
+      GUARDED_BY(callback_crit_sect_);
 };
 
 }  // namespace acm2
@@ -75,6 +75,7 @@ class PacketizationCallbackStub : public AudioPacketizationCallback {
  public:
   PacketizationCallbackStub()
       : num_calls_(0),
+        last_payload_type_(0),
         crit_sect_(CriticalSectionWrapper::CreateCriticalSection()) {}
 
   virtual int32_t SendData(
@@ -86,6 +87,7 @@ class PacketizationCallbackStub : public AudioPacketizationCallback {
       const RTPFragmentationHeader* fragmentation) OVERRIDE {
     CriticalSectionScoped lock(crit_sect_.get());
     ++num_calls_;
+    last_payload_type_ = payload_type;
     last_payload_vec_.assign(payload_data, payload_data + payload_len_bytes);
     return 0;
   }
@@ -100,6 +102,11 @@ class PacketizationCallbackStub : public AudioPacketizationCallback {
     return last_payload_vec_.size();
   }
 
+  uint8_t last_payload_type() const {
+    CriticalSectionScoped lock(crit_sect_.get());
+    return last_payload_type_;
+  }
+
   void SwapBuffers(std::vector<uint8_t>* payload) {
     CriticalSectionScoped lock(crit_sect_.get());
     last_payload_vec_.swap(*payload);
@@ -107,6 +114,7 @@ class PacketizationCallbackStub : public AudioPacketizationCallback {
 
  private:
   int num_calls_ GUARDED_BY(crit_sect_);
+  uint8_t last_payload_type_ GUARDED_BY(crit_sect_);
   std::vector<uint8_t> last_payload_vec_ GUARDED_BY(crit_sect_);
   const scoped_ptr<CriticalSectionWrapper> crit_sect_;
 };
@@ -274,6 +282,62 @@ TEST_F(AudioCodingModuleTest, FailOnZeroDesiredFrequency) {
   EXPECT_EQ(-1, acm_->PlayoutData10Ms(0, &audio_frame));
 }
 
+// Let a second module send the payloads encoded by |acm_|, under its own
+// payload type.
+TEST_F(AudioCodingModuleTest, ShareEncoder) {
+  const uint8_t kSharerPayloadType = kPayloadType + 1;
+  const int kNumFrames = 10;
+  scoped_ptr<AudioCodingModule> sharer(
+      AudioCodingModule::Create(id_ + 1, clock_));
+  CodecInst codec = codec_;
+  codec.pltype = kSharerPayloadType;
+  ASSERT_EQ(0, sharer->RegisterSendCodec(codec));
+  PacketizationCallbackStub sharer_cb;
+  ASSERT_EQ(0, sharer->RegisterTransportCallback(&sharer_cb));
+
+  EXPECT_EQ(-1, sharer->ShareEncoderWith(sharer.get()));
+  ASSERT_EQ(0, sharer->ShareEncoderWith(acm_.get()));
+  // Sharing is only one level deep.
+  EXPECT_EQ(-1, acm_->ShareEncoderWith(sharer.get()));
+
+  std::vector<uint8_t> payload;
+  std::vector<uint8_t> sharer_payload;
+  for (int i = 0; i < kNumFrames; ++i) {
+    input_frame_.data_[0] = i;
+    EXPECT_EQ(0, sharer->Add10MsData(input_frame_));
+    EXPECT_EQ(0, sharer->Process());
+    InsertAudio();
+    Encode();
+    packet_cb_.SwapBuffers(&payload);
+    sharer_cb.SwapBuffers(&sharer_payload);
+    EXPECT_EQ(payload, sharer_payload);
+  }
+  EXPECT_EQ(kNumFrames, packet_cb_.num_calls());
+  EXPECT_EQ(kNumFrames, sharer_cb.num_calls());
+  EXPECT_EQ(kPayloadType, packet_cb_.last_payload_type());
+  EXPECT_EQ(kSharerPayloadType, sharer_cb.last_payload_type());
+
+  // After detaching, the sharer encodes on its own.
+  ASSERT_EQ(0, sharer->ShareEncoderWith(NULL));
+  EXPECT_EQ(0, sharer->Add10MsData(input_frame_));
+  EXPECT_EQ(kPayloadSizeBytes, sharer->Process());
+  EXPECT_EQ(kNumFrames + 1, sharer_cb.num_calls());
+  EXPECT_EQ(kNumFrames, packet_cb_.num_calls());
+}
+
+TEST_F(AudioCodingModuleTest, ShareEncoderRequiresSameCodec) {
+  scoped_ptr<AudioCodingModule> sharer(
+      AudioCodingModule::Create(id_ + 1, clock_));
+  EXPECT_EQ(-1, sharer->ShareEncoderWith(acm_.get()));
+  CodecInst codec = codec_;
+  codec.pacsize *= 2;
+  ASSERT_EQ(0, sharer->RegisterSendCodec(codec));
+  EXPECT_EQ(-1, sharer->ShareEncoderWith(acm_.get()));
+  ASSERT_EQ(0, sharer->RegisterSendCodec(codec_));
+  ASSERT_EQ(0, sharer->SetVAD(true, true, VADNormal));
+  EXPECT_EQ(-1, sharer->ShareEncoderWith(acm_.get()));
+}
+
 // A multi-threaded test for ACM. This base class is using the PCM16b 16 kHz
 // codec, while the derive class AcmIsacMtTest is using iSAC.
 class AudioCodingModuleMtTest : public AudioCodingModuleTest {
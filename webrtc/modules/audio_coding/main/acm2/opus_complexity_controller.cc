@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/main/acm2/opus_complexity_controller.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+namespace webrtc {
+
+namespace acm2 {
+
+namespace {
+
+// Weight of the previous usage in the smoothing, per frame. Gives a time
+// constant of about 20 frames.
+const float kUsageSmoothing = 0.95f;
+
+// Number of frames before the smoothed usage is trusted.
+const int kMinFramesForUsage = 10;
+
+}  // namespace
+
+const int OpusComplexityController::kHighUsagePercent;
+const int OpusComplexityController::kLowUsagePercent;
+const int OpusComplexityController::kFramesBeforeDecrease;
+const int OpusComplexityController::kFramesBeforeIncrease;
+const int OpusComplexityController::kMinComplexity;
+
+OpusComplexityController::OpusComplexityController(int max_complexity) {
+  Reset(max_complexity);
+}
+
+void OpusComplexityController::Reset(int max_complexity) {
+  assert(max_complexity >= kMinComplexity);
+  max_complexity_ = max_complexity;
+  complexity_ = max_complexity;
+  usage_percent_ = 0.0f;
+  num_frames_ = 0;
+  frames_since_change_ = 0;
+}
+
+bool OpusComplexityController::FrameEncoded(int64_t encode_time_us,
+                                            int frame_duration_ms) {
+  if (frame_duration_ms <= 0 || encode_time_us < 0)
+    return false;
+
+  const float usage_percent =
+      100.0f * encode_time_us / (1000.0f * frame_duration_ms);
+  if (num_frames_ == 0) {
+    usage_percent_ = usage_percent;
+  } else {
+    usage_percent_ = kUsageSmoothing * usage_percent_ +
+        (1.0f - kUsageSmoothing) * usage_percent;
+  }
+  ++num_frames_;
+  ++frames_since_change_;
+  if (num_frames_ < kMinFramesForUsage)
+    return false;
+
+  if (usage_percent_ > kHighUsagePercent) {
+    if (complexity_ > kMinComplexity &&
+        frames_since_change_ >= kFramesBeforeDecrease) {
+      --complexity_;
+      frames_since_change_ = 0;
+      return true;
+    }
+  } else if (usage_percent_ < kLowUsagePercent) {
+    if (complexity_ < max_complexity_ &&
+        frames_since_change_ >= kFramesBeforeIncrease) {
+      ++complexity_;
+      frames_since_change_ = 0;
+      return true;
+    }
+  } else {
+    // Only raise the complexity after a sustained period of low usage.
+    frames_since_change_ = std::min(frames_since_change_,
+                                    kFramesBeforeDecrease);
+  }
+  return false;
+}
+
+}  // namespace acm2
+
+}  // namespace webrtc
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_MAIN_ACM2_OPUS_COMPLEXITY_CONTROLLER_H_
+#define WEBRTC_MODULES_AUDIO_CODING_MAIN_ACM2_OPUS_COMPLEXITY_CONTROLLER_H_
+
+#include "webrtc/typedefs.h"
+
+//
+// This class adapts the Opus encoder complexity to the CPU load, in the
+// spirit of the OveruseFrameDetector for video. The load is measured as the
+// encode usage, the time spent encoding a frame divided by the duration of the
+// frame, smoothed over frames. The complexity is lowered while the usage is
+// high, and slowly raised again towards the initial complexity while it is
+// low.
+//
+// Thread Safety
+// =============
+// Please note that this class is not thread safe. The class must be protected
+// if different APIs are called from different threads.
+//
+
+namespace webrtc {
+
+namespace acm2 {
+
+class OpusComplexityController {
+ public:
+  // Encode usage above which the complexity is lowered.
+  static const int kHighUsagePercent = 20;
+  // Encode usage below which the complexity is raised.
+  static const int kLowUsagePercent = 8;
+  // Number of encoded frames between lowering the complexity, to let the
+  // usage settle.
+  static const int kFramesBeforeDecrease = 25;
+  // Number of encoded frames with low usage before raising the complexity.
+  static const int kFramesBeforeIncrease = 250;
+  static const int kMinComplexity = 0;
+
+  // |max_complexity| is the complexity the encoder starts at, and the highest
+  // complexity that is set.
+  explicit OpusComplexityController(int max_complexity);
+  ~OpusComplexityController() {}
+
+  // Resets to |max_complexity| and forgets the measured usage.
+  void Reset(int max_complexity);
+
+  // Reports that a frame of |frame_duration_ms| took |encode_time_us| to
+  // encode. Returns true if the complexity changed, and should be set in the
+  // encoder.
+  bool FrameEncoded(int64_t encode_time_us, int frame_duration_ms);
+
+  int complexity() const { return complexity_; }
+
+  // The smoothed encode usage, in percent.
+  float encode_usage_percent() const { return usage_percent_; }
+
+ private:
+  int max_complexity_;
+  int complexity_;
+  float usage_percent_;
+  int num_frames_;
+  int frames_since_change_;
+};
+
+}  // namespace acm2
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_MAIN_ACM2_OPUS_COMPLEXITY_CONTROLLER_H_
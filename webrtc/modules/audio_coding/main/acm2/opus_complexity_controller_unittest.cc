@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "gtest/gtest.h"
+#include "webrtc/modules/audio_coding/main/acm2/opus_complexity_controller.h"
+
+namespace webrtc {
+
+namespace acm2 {
+
+namespace {
+
+const int kMaxComplexity = 9;
+const int kFrameDurationMs = 20;
+// Encode times of 30% and 5% of the frame duration.
+const int64_t kHighEncodeTimeUs = 6000;
+const int64_t kLowEncodeTimeUs = 1000;
+
+// Reports |num_frames| frames encoded in |encode_time_us| each, and returns
+// the number of complexity changes.
+int EncodeFrames(OpusComplexityController* controller, int num_frames,
+                 int64_t encode_time_us) {
+  int num_changes = 0;
+  for (int i = 0; i < num_frames; ++i) {
+    if (controller->FrameEncoded(encode_time_us, kFrameDurationMs))
+      ++num_changes;
+  }
+  return num_changes;
+}
+
+}  // namespace
+
+TEST(OpusComplexityControllerTest, StartsAtMaxComplexity) {
+  OpusComplexityController controller(kMaxComplexity);
+  EXPECT_EQ(kMaxComplexity, controller.complexity());
+  EXPECT_EQ(0, EncodeFrames(&controller, 1000, kLowEncodeTimeUs));
+  EXPECT_EQ(kMaxComplexity, controller.complexity());
+  EXPECT_NEAR(5.0f, controller.encode_usage_percent(), 0.01f);
+}
+
+TEST(OpusComplexityControllerTest, LowersComplexityOnHighUsage) {
+  OpusComplexityController controller(kMaxComplexity);
+  EXPECT_EQ(1, EncodeFrames(&controller,
+                            OpusComplexityController::kFramesBeforeDecrease,
+                            kHighEncodeTimeUs));
+  EXPECT_EQ(kMaxComplexity - 1, controller.complexity());
+
+  // Keeps lowering, one step at a time, down to the minimum.
+  EncodeFrames(&controller,
+               OpusComplexityController::kFramesBeforeDecrease *
+                   (kMaxComplexity + 2),
+               kHighEncodeTimeUs);
+  EXPECT_EQ(OpusComplexityController::kMinComplexity,
+            controller.complexity());
+}
+
+TEST(OpusComplexityControllerTest, RaisesComplexitySlowlyOnLowUsage) {
+  OpusComplexityController controller(kMaxComplexity);
+  EncodeFrames(&controller,
+               3 * OpusComplexityController::kFramesBeforeDecrease,
+               kHighEncodeTimeUs);
+  EXPECT_EQ(kMaxComplexity - 3, controller.complexity());
+
+  // The smoothed usage needs some frames to go down, and the complexity is
+  // raised only after a long period of low usage.
+  EncodeFrames(&controller,
+               OpusComplexityController::kFramesBeforeIncrease / 2,
+               kLowEncodeTimeUs);
+  EXPECT_EQ(kMaxComplexity - 3, controller.complexity());
+  EncodeFrames(&controller, 3 * OpusComplexityController::kFramesBeforeIncrease,
+               kLowEncodeTimeUs);
+  EXPECT_EQ(kMaxComplexity, controller.complexity());
+
+  // Never above the maximum.
+  EXPECT_EQ(0, EncodeFrames(
+      &controller, 2 * OpusComplexityController::kFramesBeforeIncrease,
+      kLowEncodeTimeUs));
+  EXPECT_EQ(kMaxComplexity, controller.complexity());
+}
+
+TEST(OpusComplexityControllerTest, ResetRestoresMaxComplexity) {
+  OpusComplexityController controller(kMaxComplexity);
+  EncodeFrames(&controller,
+               2 * OpusComplexityController::kFramesBeforeDecrease,
+               kHighEncodeTimeUs);
+  EXPECT_LT(controller.complexity(), kMaxComplexity);
+  controller.Reset(5);
+  EXPECT_EQ(5, controller.complexity());
+  EXPECT_EQ(0.0f, controller.encode_usage_percent());
+}
+
+TEST(OpusComplexityControllerTest, IgnoresInvalidInput) {
+  OpusComplexityController controller(kMaxComplexity);
+  EXPECT_FALSE(controller.FrameEncoded(kHighEncodeTimeUs, 0));
+  EXPECT_FALSE(controller.FrameEncoded(-1, kFrameDurationMs));
+  EXPECT_EQ(0.0f, controller.encode_usage_percent());
+}
+
+}  // namespace acm2
+
+}  // namespace webrtc
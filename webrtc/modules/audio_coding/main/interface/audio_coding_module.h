@@ -353,6 +353,31 @@ class AudioCodingModule: public Module {
   virtual int32_t RegisterTransportCallback(
       AudioPacketizationCallback* transport) = 0;
 
+  ///////////////////////////////////////////////////////////////////////////
+  // int ShareEncoderWith()
+  // Send the payloads encoded by |encoder_owner| instead of encoding locally.
+  // Whenever |encoder_owner| delivers a payload from Process(), the same
+  // payload is delivered to the transport callback of this module, with the
+  // payload type mapped to the one registered in this module. While sharing,
+  // Add10MsData() and Process() of this module do nothing. The RTP
+  // timestamps follow those of |encoder_owner|.
+  //
+  // Both modules must have the same send codec, apart from the payload type,
+  // and the same RED and VAD/DTX settings, and neither may have a secondary
+  // send codec. The settings must not be changed while sharing. Sharing
+  // ends when NULL is given, or when either module is destroyed.
+  //
+  // Input:
+  //   -encoder_owner      : the module whose encoder to share, or NULL to
+  //                         encode locally again. It must not share the
+  //                         encoder of another module itself.
+  //
+  // Return value:
+  //   -1 if the encoder could not be shared,
+  //    0 if successful.
+  //
+  virtual int ShareEncoderWith(AudioCodingModule* encoder_owner) = 0;
+
   ///////////////////////////////////////////////////////////////////////////
   // int32_t Add10MsData()
   // Add 10MS of raw (PCM) audio data to the encoder. If the sampling
@@ -453,6 +478,24 @@ class AudioCodingModule: public Module {
   //
   virtual int SetPacketLossRate(int packet_loss_rate) = 0;
 
+  ///////////////////////////////////////////////////////////////////////////
+  // int SetCodecComplexityAdaptation()
+  // Enables or disables adapting the complexity of the send codec to the CPU
+  // time spent encoding. When enabled, the complexity is lowered step by step
+  // while encoding takes too large a share of the real time, and raised again
+  // slowly once it does not. Only codecs with a complexity setting, e.g. Opus,
+  // support this.
+  //
+  // Input:
+  //   -enable             : if true complexity adaptation is enabled,
+  //                         otherwise it is disabled.
+  //
+  // Return value:
+  //   -1 if failed, or the codec does not support complexity adaptation,
+  //    0 if succeeded.
+  //
+  virtual int SetCodecComplexityAdaptation(bool enable) = 0;
+
   ///////////////////////////////////////////////////////////////////////////
   //   (VAD) Voice Activity Detection
   //
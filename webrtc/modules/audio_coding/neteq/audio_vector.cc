@@ -19,24 +19,24 @@
 namespace webrtc {
 
 void AudioVector::Clear() {
-  first_free_ix_ = 0;
+  begin_index_ = 0;
+  end_index_ = 0;
 }
 
 void AudioVector::CopyFrom(AudioVector* copy_to) const {
   if (copy_to) {
+    copy_to->Clear();
     copy_to->Reserve(Size());
     assert(copy_to->capacity_ >= Size());
-    memcpy(copy_to->array_.get(), array_.get(), Size() * sizeof(int16_t));
-    copy_to->first_free_ix_ = first_free_ix_;
+    memcpy(copy_to->array_.get(), &array_[begin_index_],
+           Size() * sizeof(int16_t));
+    copy_to->end_index_ = Size();
   }
 }
 
 void AudioVector::PushFront(const AudioVector& prepend_this) {
-  size_t insert_length = prepend_this.Size();
-  Reserve(Size() + insert_length);
-  memmove(&array_[insert_length], &array_[0], Size() * sizeof(int16_t));
-  memcpy(&array_[0], &prepend_this.array_[0], insert_length * sizeof(int16_t));
-  first_free_ix_ += insert_length;
+  PushFront(&prepend_this.array_[prepend_this.begin_index_],
+            prepend_this.Size());
 }
 
 void AudioVector::PushFront(const int16_t* prepend_this, size_t length) {
@@ -45,13 +45,13 @@ void AudioVector::PushFront(const int16_t* prepend_this, size_t length) {
 }
 
 void AudioVector::PushBack(const AudioVector& append_this) {
-  PushBack(append_this.array_.get(), append_this.Size());
+  PushBack(&append_this.array_[append_this.begin_index_], append_this.Size());
 }
 
 void AudioVector::PushBack(const int16_t* append_this, size_t length) {
   Reserve(Size() + length);
-  memcpy(&array_[first_free_ix_], append_this, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  memcpy(&array_[end_index_], append_this, length * sizeof(int16_t));
+  end_index_ += length;
 }
 
 void AudioVector::PopFront(size_t length) {
@@ -59,51 +59,37 @@ void AudioVector::PopFront(size_t length) {
     // Remove all elements.
     Clear();
   } else {
-    size_t remaining_samples = Size() - length;
-    memmove(&array_[0], &array_[length], remaining_samples * sizeof(int16_t));
-    first_free_ix_ -= length;
+    begin_index_ += length;
   }
 }
 
 void AudioVector::PopBack(size_t length) {
   // Never remove more than what is in the array.
   length = std::min(length, Size());
-  first_free_ix_ -= length;
+  end_index_ -= length;
 }
 
 void AudioVector::Extend(size_t extra_length) {
   Reserve(Size() + extra_length);
-  memset(&array_[first_free_ix_], 0, extra_length * sizeof(int16_t));
-  first_free_ix_ += extra_length;
+  memset(&array_[end_index_], 0, extra_length * sizeof(int16_t));
+  end_index_ += extra_length;
 }
 
 void AudioVector::InsertAt(const int16_t* insert_this,
                            size_t length,
                            size_t position) {
-  Reserve(Size() + length);
   // Cap the position at the current vector length, to be sure the iterator
   // does not extend beyond the end of the vector.
   position = std::min(Size(), position);
-  int16_t* insert_position_ptr = &array_[position];
-  size_t samples_to_move = Size() - position;
-  memmove(insert_position_ptr + length, insert_position_ptr,
-          samples_to_move * sizeof(int16_t));
-  memcpy(insert_position_ptr, insert_this, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  memcpy(OpenGapAt(length, position), insert_this, length * sizeof(int16_t));
 }
 
 void AudioVector::InsertZerosAt(size_t length,
                                 size_t position) {
-  Reserve(Size() + length);
   // Cap the position at the current vector length, to be sure the iterator
   // does not extend beyond the end of the vector.
-  position = std::min(capacity_, position);
-  int16_t* insert_position_ptr = &array_[position];
-  size_t samples_to_move = Size() - position;
-  memmove(insert_position_ptr + length, insert_position_ptr,
-          samples_to_move * sizeof(int16_t));
-  memset(insert_position_ptr, 0, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  position = std::min(Size(), position);
+  memset(OpenGapAt(length, position), 0, length * sizeof(int16_t));
 }
 
 void AudioVector::OverwriteAt(const int16_t* insert_this,
@@ -112,10 +98,11 @@ void AudioVector::OverwriteAt(const int16_t* insert_this,
   // Cap the insert position at the current array length.
   position = std::min(Size(), position);
   Reserve(position + length);
-  memcpy(&array_[position], insert_this, length * sizeof(int16_t));
+  memcpy(&array_[begin_index_ + position], insert_this,
+         length * sizeof(int16_t));
   if (position + length > Size()) {
     // Array was expanded.
-    first_free_ix_ += position + length - Size();
+    end_index_ = begin_index_ + position + length;
   }
 }
 
@@ -126,7 +113,7 @@ void AudioVector::CrossFade(const AudioVector& append_this,
   assert(fade_length <= append_this.Size());
   fade_length = std::min(fade_length, Size());
   fade_length = std::min(fade_length, append_this.Size());
-  size_t position = Size() - fade_length;
+  size_t position = begin_index_ + Size() - fade_length;
   // Cross fade the overlapping regions.
   // |alpha| is the mixing factor in Q14.
   // TODO(hlundin): Consider skipping +1 in the denominator to produce a
@@ -146,20 +133,48 @@ void AudioVector::CrossFade(const AudioVector& append_this,
 }
 
 const int16_t& AudioVector::operator[](size_t index) const {
-  return array_[index];
+  return array_[begin_index_ + index];
 }
 
 int16_t& AudioVector::operator[](size_t index) {
-  return array_[index];
+  return array_[begin_index_ + index];
 }
 
 void AudioVector::Reserve(size_t n) {
-  if (capacity_ < n) {
-    scoped_ptr<int16_t[]> temp_array(new int16_t[n]);
-    memcpy(temp_array.get(), array_.get(), Size() * sizeof(int16_t));
+  if (begin_index_ + n <= capacity_)
+    return;
+  if (n <= capacity_ / 2) {
+    // More than half of the array has been popped from the front; moving the
+    // samples back costs no more than the pops which freed the space.
+    memmove(&array_[0], &array_[begin_index_], Size() * sizeof(int16_t));
+  } else {
+    // Grow geometrically, so that a vector fed with short blocks is not
+    // reallocated for each of them.
+    size_t new_capacity = 2 * n;
+    scoped_ptr<int16_t[]> temp_array(new int16_t[new_capacity]);
+    memcpy(temp_array.get(), &array_[begin_index_], Size() * sizeof(int16_t));
     array_.swap(temp_array);
-    capacity_ = n;
+    capacity_ = new_capacity;
+  }
+  end_index_ -= begin_index_;
+  begin_index_ = 0;
+}
+
+int16_t* AudioVector::OpenGapAt(size_t length, size_t position) {
+  assert(position <= Size());
+  if (length <= begin_index_ && position <= Size() - position) {
+    // Move the samples before |position| towards the front.
+    memmove(&array_[begin_index_ - length], &array_[begin_index_],
+            position * sizeof(int16_t));
+    begin_index_ -= length;
+  } else {
+    Reserve(Size() + length);
+    int16_t* insert_position_ptr = &array_[begin_index_ + position];
+    memmove(insert_position_ptr + length, insert_position_ptr,
+            (Size() - position) * sizeof(int16_t));
+    end_index_ += length;
   }
+  return &array_[begin_index_ + position];
 }
 
 }  // namespace webrtc
@@ -24,13 +24,15 @@ class AudioVector {
   // Creates an empty AudioVector.
   AudioVector()
       : array_(new int16_t[kDefaultInitialSize]),
-        first_free_ix_(0),
+        begin_index_(0),
+        end_index_(0),
         capacity_(kDefaultInitialSize) {}
 
   // Creates an AudioVector with an initial size.
   explicit AudioVector(size_t initial_size)
       : array_(new int16_t[initial_size]),
-        first_free_ix_(initial_size),
+        begin_index_(0),
+        end_index_(initial_size),
         capacity_(initial_size) {
     memset(array_.get(), 0, initial_size * sizeof(int16_t));
   }
@@ -94,10 +96,10 @@ class AudioVector {
   virtual void CrossFade(const AudioVector& append_this, size_t fade_length);
 
   // Returns the number of elements in this AudioVector.
-  virtual size_t Size() const { return first_free_ix_; }
+  virtual size_t Size() const { return end_index_ - begin_index_; }
 
   // Returns true if this AudioVector is empty.
-  virtual bool Empty() const { return (first_free_ix_ == 0); }
+  virtual bool Empty() const { return (end_index_ == begin_index_); }
 
   // Accesses and modifies an element of AudioVector.
   const int16_t& operator[](size_t index) const;
@@ -106,11 +108,24 @@ class AudioVector {
  private:
   static const size_t kDefaultInitialSize = 10;
 
+  // Makes room for |n| samples from the first sample on. The samples are moved
+  // to the start of the array if that frees enough space, otherwise the array
+  // is reallocated with room to grow.
   void Reserve(size_t n);
 
+  // Opens a gap of |length| uninitialized samples at |position|, which must not
+  // be beyond Size(), and returns a pointer to it. Moves the shorter side of
+  // the vector when there is room before the first sample.
+  int16_t* OpenGapAt(size_t length, size_t position);
+
+  // The samples are stored contiguously in array_[begin_index_, end_index_).
+  // Removing samples from the front only moves |begin_index_|, and the space
+  // it leaves is reused by the next insertions at the front, or reclaimed by
+  // Reserve().
   scoped_ptr<int16_t[]> array_;
-  size_t first_free_ix_;  // The first index after the last sample in array_.
-                          // Note that this index may point outside of array_.
+  size_t begin_index_;  // The index of the first sample in array_.
+  size_t end_index_;  // The first index after the last sample in array_.
+                      // Note that this index may point outside of array_.
   size_t capacity_;  // Allocated number of samples in the array.
 
   DISALLOW_COPY_AND_ASSIGN(AudioVector);
@@ -151,6 +151,42 @@ TEST_F(AudioVectorTest, PopFront) {
   EXPECT_EQ(0u, vec.Size());
 }
 
+// Pop samples from the front and insert new ones at the front and in the
+// middle, which reuses the space left by the pops, and keep pushing at the back.
+// Use a plain array as reference.
+TEST_F(AudioVectorTest, PopFrontThenInsert) {
+  AudioVector vec;
+  int16_t reference[100];
+  size_t reference_length = 0;
+  int16_t next_value = 0;
+  for (int round = 0; round < 20; ++round) {
+    vec.PushBack(array_, array_length());
+    memcpy(&reference[reference_length], array_, sizeof(array_));
+    reference_length += array_length();
+    vec.PopFront(4);
+    memmove(reference, &reference[4], (reference_length - 4) * sizeof(int16_t));
+    reference_length -= 4;
+    // Alternate between the front, the first half and the second half.
+    size_t position = (round % 3) * reference_length / 3;
+    int16_t insert_this[2] = {next_value, static_cast<int16_t>(next_value + 1)};
+    next_value += 2;
+    vec.InsertAt(insert_this, 2, position);
+    memmove(&reference[position + 2], &reference[position],
+            (reference_length - position) * sizeof(int16_t));
+    memcpy(&reference[position], insert_this, sizeof(insert_this));
+    reference_length += 2;
+    // Keep the vector short.
+    if (reference_length > 40) {
+      vec.PopBack(reference_length - 40);
+      reference_length = 40;
+    }
+    ASSERT_EQ(reference_length, vec.Size());
+    for (size_t i = 0; i < reference_length; ++i) {
+      EXPECT_EQ(reference[i], vec[i]);
+    }
+  }
+}
+
 // Test the PopBack method.
 TEST_F(AudioVectorTest, PopBack) {
   AudioVector vec;
@@ -391,4 +427,37 @@ TEST_F(AudioVectorTest, CrossFade) {
   }
 }
 
+// Cross-fade after popping from the front, so that the samples do not start
+// at the beginning of the array.
+TEST_F(AudioVectorTest, PopFrontThenCrossFade) {
+  static const size_t kLength = 100;
+  static const size_t kPopLength = 30;
+  static const size_t kFadeLength = 10;
+  AudioVector vec1(kLength);
+  AudioVector vec2(kLength);
+  // Set the elements to be popped to 50, the rest of |vec1| to 0, and all of
+  // |vec2| to 100.
+  for (size_t i = 0; i < kLength; ++i) {
+    vec1[i] = i < kPopLength ? 50 : 0;
+    vec2[i] = 100;
+  }
+  vec1.PopFront(kPopLength);
+  vec1.CrossFade(vec2, kFadeLength);
+  const size_t kRemaining = kLength - kPopLength;
+  ASSERT_EQ(kRemaining + kLength - kFadeLength, vec1.Size());
+  // First part untouched.
+  for (size_t i = 0; i < kRemaining - kFadeLength; ++i) {
+    EXPECT_EQ(0, vec1[i]);
+  }
+  // Check mixing zone.
+  for (size_t i = 0; i < kFadeLength; ++i) {
+    EXPECT_NEAR((i + 1) * 100 / (kFadeLength + 1),
+                vec1[kRemaining - kFadeLength + i], 1);
+  }
+  // Second part untouched.
+  for (size_t i = kRemaining; i < vec1.Size(); ++i) {
+    EXPECT_EQ(100, vec1[i]);
+  }
+}
+
 }  // namespace webrtc
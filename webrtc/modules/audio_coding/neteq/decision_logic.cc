@@ -13,6 +13,7 @@
 #include <algorithm>
 
 #include "webrtc/modules/audio_coding/neteq/buffer_level_filter.h"
+#include "webrtc/modules/audio_coding/neteq/decision_logic_decode_only.h"
 #include "webrtc/modules/audio_coding/neteq/decision_logic_fax.h"
 #include "webrtc/modules/audio_coding/neteq/decision_logic_normal.h"
 #include "webrtc/modules/audio_coding/neteq/delay_manager.h"
@@ -49,6 +50,14 @@ DecisionLogic* DecisionLogic::Create(int fs_hz,
                                   packet_buffer,
                                   delay_manager,
                                   buffer_level_filter);
+    case kPlayoutDecodeOnly:
+      return new DecisionLogicDecodeOnly(fs_hz,
+                                         output_size_samples,
+                                         playout_mode,
+                                         decoder_database,
+                                         packet_buffer,
+                                         delay_manager,
+                                         buffer_level_filter);
   }
   // This line cannot be reached, but must be here to avoid compiler errors.
   assert(false);
@@ -138,7 +147,9 @@ Operations DecisionLogic::GetDecision(const SyncBuffer& sync_buffer,
           prev_mode == kModePreemptiveExpandSuccess ||
           prev_mode == kModePreemptiveExpandLowEnergy);
 
-  FilterBufferLevel(cur_size_samples, prev_mode);
+  // The buffer level is irrelevant when decoding as fast as possible.
+  if (playout_mode_ != kPlayoutDecodeOnly)
+    FilterBufferLevel(cur_size_samples, prev_mode);
 
   return GetDecisionSpecialized(sync_buffer, expand, decoder_frame_length,
                                 packet_header, prev_mode, play_dtmf,
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/decision_logic_decode_only.h"
+
+#include <assert.h>
+
+#include "webrtc/modules/audio_coding/neteq/decoder_database.h"
+#include "webrtc/modules/audio_coding/neteq/sync_buffer.h"
+#include "webrtc/modules/interface/module_common_types.h"
+
+namespace webrtc {
+
+Operations DecisionLogicDecodeOnly::GetDecisionSpecialized(
+    const SyncBuffer& sync_buffer,
+    const Expand& expand,
+    int decoder_frame_length,
+    const RTPHeader* packet_header,
+    Modes prev_mode,
+    bool play_dtmf,
+    bool* reset_decoder) {
+  assert(playout_mode_ == kPlayoutDecodeOnly);
+  // Guard for errors, to avoid getting stuck in error mode.
+  if (prev_mode == kModeError) {
+    if (!packet_header) {
+      return kExpand;
+    } else {
+      return kUndefined;  // Use kUndefined to flag for a reset.
+    }
+  }
+
+  uint32_t target_timestamp = sync_buffer.end_timestamp();
+  uint32_t available_timestamp = 0;
+  bool is_cng_packet = false;
+  if (packet_header) {
+    available_timestamp = packet_header->timestamp;
+    is_cng_packet =
+        decoder_database_->IsComfortNoise(packet_header->payloadType);
+  }
+  // Signed difference between target and available timestamp.
+  const int32_t timestamp_diff =
+      (generated_noise_samples_ + target_timestamp) - available_timestamp;
+
+  if (is_cng_packet) {
+    if (timestamp_diff < 0 && prev_mode == kModeRfc3389Cng) {
+      // Not time to play this packet yet. Keep on playing CNG from previous
+      // CNG parameters.
+      return kRfc3389CngNoPacket;
+    }
+    return kRfc3389Cng;
+  }
+
+  if (!packet_header) {
+    // The caller has pulled all the data inserted so far.
+    if (cng_state_ == kCngRfc3389On) {
+      return kRfc3389CngNoPacket;
+    } else if (cng_state_ == kCngInternalOn) {
+      return kCodecInternalCng;
+    } else if (play_dtmf) {
+      return kDtmf;
+    }
+    return kExpand;
+  }
+
+  if (target_timestamp == available_timestamp) {
+    return kNormal;
+  } else if (!IsNewerTimestamp(available_timestamp, target_timestamp)) {
+    // A new stream or codec; signal for a reset.
+    return kUndefined;
+  }
+
+  // A future packet is available, so packets have been lost.
+  if (prev_mode == kModeRfc3389Cng || prev_mode == kModeCodecInternalCng) {
+    // Comfort noise is covering the gap. Play the packet once it is due.
+    if (timestamp_diff >= 0) {
+      return kNormal;
+    }
+    return prev_mode == kModeRfc3389Cng ? kRfc3389CngNoPacket :
+        kCodecInternalCng;
+  }
+  const uint32_t timestamp_leap = available_timestamp - target_timestamp;
+  if (timestamp_leap >=
+      static_cast<uint32_t>(output_size_samples_ * kMaxExpandsPerGap)) {
+    // Too long to conceal, e.g., because the sender was restarted. Jump
+    // ahead to the packet.
+    *reset_decoder = true;
+    return kNormal;
+  }
+  if (prev_mode == kModeExpand &&
+      timestamp_leap <=
+          static_cast<uint32_t>(output_size_samples_ *
+                                num_consecutive_expands_)) {
+    // The expansion has covered the gap.
+    return kMerge;
+  }
+  if (play_dtmf) {
+    return kDtmf;
+  }
+  return kExpand;
+}
+
+}  // namespace webrtc
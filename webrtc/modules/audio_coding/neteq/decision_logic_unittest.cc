@@ -51,6 +51,12 @@ TEST(DecisionLogic, CreateAndDestroy) {
                                 packet_buffer, &delay_manager,
                                 &buffer_level_filter);
   delete logic;
+  logic = DecisionLogic::Create(fs_hz, output_size_samples,
+                                kPlayoutDecodeOnly,
+                                &decoder_database,
+                                packet_buffer, &delay_manager,
+                                &buffer_level_filter);
+  delete logic;
 }
 
 // TODO(hlundin): Write more tests.
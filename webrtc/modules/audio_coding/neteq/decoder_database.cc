@@ -11,6 +11,7 @@
 #include "webrtc/modules/audio_coding/neteq/decoder_database.h"
 
 #include <assert.h>
+#include <string.h>  // memset
 #include <utility>  // pair
 
 #include "webrtc/modules/audio_coding/neteq/interface/audio_decoder.h"
@@ -18,7 +19,9 @@
 namespace webrtc {
 
 DecoderDatabase::DecoderDatabase()
-    : active_decoder_(-1), active_cng_decoder_(-1) {}
+    : active_decoder_(-1), active_cng_decoder_(-1) {
+  memset(decoders_by_payload_type_, 0, sizeof(decoders_by_payload_type_));
+}
 
 DecoderDatabase::~DecoderDatabase() {}
 
@@ -32,6 +35,7 @@ int DecoderDatabase::Size() const { return static_cast<int>(decoders_.size()); }
 
 void DecoderDatabase::Reset() {
   decoders_.clear();
+  memset(decoders_by_payload_type_, 0, sizeof(decoders_by_payload_type_));
   active_decoder_ = -1;
   active_cng_decoder_ = -1;
 }
@@ -52,6 +56,7 @@ int DecoderDatabase::RegisterPayload(uint8_t rtp_payload_type,
     // Database already contains a decoder with type |rtp_payload_type|.
     return kDecoderExists;
   }
+  decoders_by_payload_type_[rtp_payload_type] = &ret.first->second;
   return kOK;
 }
 
@@ -80,6 +85,7 @@ int DecoderDatabase::InsertExternal(uint8_t rtp_payload_type,
     // Database already contains a decoder with type |rtp_payload_type|.
     return kDecoderExists;
   }
+  decoders_by_payload_type_[rtp_payload_type] = &ret.first->second;
   return kOK;
 }
 
@@ -88,6 +94,7 @@ int DecoderDatabase::Remove(uint8_t rtp_payload_type) {
     // No decoder with that |rtp_payload_type|.
     return kDecoderNotFound;
   }
+  decoders_by_payload_type_[rtp_payload_type] = NULL;
   if (active_decoder_ == rtp_payload_type) {
     active_decoder_ = -1;  // No active decoder.
   }
@@ -99,12 +106,7 @@ int DecoderDatabase::Remove(uint8_t rtp_payload_type) {
 
 const DecoderDatabase::DecoderInfo* DecoderDatabase::GetDecoderInfo(
     uint8_t rtp_payload_type) const {
-  DecoderMap::const_iterator it = decoders_.find(rtp_payload_type);
-  if (it == decoders_.end()) {
-    // Decoder not found.
-    return NULL;
-  }
-  return &(*it).second;
+  return Find(rtp_payload_type);
 }
 
 uint8_t DecoderDatabase::GetRtpPayloadType(
@@ -125,12 +127,11 @@ AudioDecoder* DecoderDatabase::GetDecoder(uint8_t rtp_payload_type) {
     // These are not real decoders.
     return NULL;
   }
-  DecoderMap::iterator it = decoders_.find(rtp_payload_type);
-  if (it == decoders_.end()) {
+  DecoderInfo* info = Find(rtp_payload_type);
+  if (!info) {
     // Decoder not found.
     return NULL;
   }
-  DecoderInfo* info = &(*it).second;
   if (!info->decoder) {
     // Create the decoder object.
     AudioDecoder* decoder = AudioDecoder::CreateAudioDecoder(info->codec_type);
@@ -143,12 +144,12 @@ AudioDecoder* DecoderDatabase::GetDecoder(uint8_t rtp_payload_type) {
 
 bool DecoderDatabase::IsType(uint8_t rtp_payload_type,
                              NetEqDecoder codec_type) const {
-  DecoderMap::const_iterator it = decoders_.find(rtp_payload_type);
-  if (it == decoders_.end()) {
+  const DecoderInfo* info = Find(rtp_payload_type);
+  if (!info) {
     // Decoder not found.
     return false;
   }
-  return ((*it).second.codec_type == codec_type);
+  return (info->codec_type == codec_type);
 }
 
 bool DecoderDatabase::IsComfortNoise(uint8_t rtp_payload_type) const {
@@ -173,8 +174,7 @@ bool DecoderDatabase::IsRed(uint8_t rtp_payload_type) const {
 int DecoderDatabase::SetActiveDecoder(uint8_t rtp_payload_type,
                                       bool* new_decoder) {
   // Check that |rtp_payload_type| exists in the database.
-  DecoderMap::const_iterator it = decoders_.find(rtp_payload_type);
-  if (it == decoders_.end()) {
+  if (!Find(rtp_payload_type)) {
     // Decoder not found.
     return kDecoderNotFound;
   }
@@ -185,17 +185,17 @@ int DecoderDatabase::SetActiveDecoder(uint8_t rtp_payload_type,
     *new_decoder = true;
   } else if (active_decoder_ != rtp_payload_type) {
     // Moving from one active decoder to another. Delete the first one.
-    DecoderMap::iterator it = decoders_.find(active_decoder_);
-    if (it == decoders_.end()) {
+    DecoderInfo* info = Find(active_decoder_);
+    if (!info) {
       // Decoder not found. This should not be possible.
       assert(false);
       return kDecoderNotFound;
     }
-    if (!(*it).second.external) {
+    if (!info->external) {
       // Delete the AudioDecoder object, unless it is an externally created
       // decoder.
-      delete (*it).second.decoder;
-      (*it).second.decoder = NULL;
+      delete info->decoder;
+      info->decoder = NULL;
     }
     *new_decoder = true;
   }
@@ -213,24 +213,23 @@ AudioDecoder* DecoderDatabase::GetActiveDecoder() {
 
 int DecoderDatabase::SetActiveCngDecoder(uint8_t rtp_payload_type) {
   // Check that |rtp_payload_type| exists in the database.
-  DecoderMap::const_iterator it = decoders_.find(rtp_payload_type);
-  if (it == decoders_.end()) {
+  if (!Find(rtp_payload_type)) {
     // Decoder not found.
     return kDecoderNotFound;
   }
   if (active_cng_decoder_ >= 0 && active_cng_decoder_ != rtp_payload_type) {
     // Moving from one active CNG decoder to another. Delete the first one.
-    DecoderMap::iterator it = decoders_.find(active_cng_decoder_);
-    if (it == decoders_.end()) {
+    DecoderInfo* info = Find(active_cng_decoder_);
+    if (!info) {
       // Decoder not found. This should not be possible.
       assert(false);
       return kDecoderNotFound;
     }
-    if (!(*it).second.external) {
+    if (!info->external) {
       // Delete the AudioDecoder object, unless it is an externally created
       // decoder.
-      delete (*it).second.decoder;
-      (*it).second.decoder = NULL;
+      delete info->decoder;
+      info->decoder = NULL;
     }
   }
   active_cng_decoder_ = rtp_payload_type;
@@ -248,7 +247,7 @@ AudioDecoder* DecoderDatabase::GetActiveCngDecoder() {
 int DecoderDatabase::CheckPayloadTypes(const PacketList& packet_list) const {
   PacketList::const_iterator it;
   for (it = packet_list.begin(); it != packet_list.end(); ++it) {
-    if (decoders_.find((*it)->header.payloadType) == decoders_.end()) {
+    if (!Find((*it)->header.payloadType)) {
       // Payload type is not found.
       return kDecoderNotFound;
     }
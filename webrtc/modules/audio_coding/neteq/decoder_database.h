@@ -147,7 +147,16 @@ class DecoderDatabase {
  private:
   typedef std::map<uint8_t, DecoderInfo> DecoderMap;
 
+  // Returns the entry of |rtp_payload_type|, or NULL.
+  DecoderInfo* Find(uint8_t rtp_payload_type) const {
+    return rtp_payload_type <= kMaxRtpPayloadType ?
+        decoders_by_payload_type_[rtp_payload_type] : NULL;
+  }
+
   DecoderMap decoders_;
+  // Points to the entries of |decoders_|, indexed by payload type, so that
+  // the lookups for each packet need not search the map.
+  DecoderInfo* decoders_by_payload_type_[kMaxRtpPayloadType + 1];
   int active_decoder_;
   int active_cng_decoder_;
 
@@ -57,6 +57,31 @@ TEST(DecoderDatabase, GetDecoderInfo) {
   EXPECT_TRUE(info == NULL);  // Should not be found.
 }
 
+TEST(DecoderDatabase, LookupAfterRemoveAndReset) {
+  DecoderDatabase db;
+  const uint8_t kPayloadType = 17;
+  EXPECT_EQ(DecoderDatabase::kOK,
+            db.RegisterPayload(kPayloadType, kDecoderPCMu));
+  EXPECT_EQ(DecoderDatabase::kOK,
+            db.RegisterPayload(kPayloadType + 1, kDecoderPCMa));
+  EXPECT_EQ(DecoderDatabase::kOK, db.Remove(kPayloadType));
+  EXPECT_TRUE(db.GetDecoderInfo(kPayloadType) == NULL);
+  EXPECT_FALSE(db.IsType(kPayloadType, kDecoderPCMu));
+  EXPECT_TRUE(db.IsType(kPayloadType + 1, kDecoderPCMa));
+  // Register the payload type again, with another codec.
+  EXPECT_EQ(DecoderDatabase::kOK,
+            db.RegisterPayload(kPayloadType, kDecoderPCM16B));
+  EXPECT_TRUE(db.IsType(kPayloadType, kDecoderPCM16B));
+  db.Reset();
+  EXPECT_TRUE(db.GetDecoderInfo(kPayloadType) == NULL);
+  EXPECT_TRUE(db.GetDecoderInfo(kPayloadType + 1) == NULL);
+  // Payload types above 127 are never found.
+  EXPECT_TRUE(db.GetDecoderInfo(DecoderDatabase::kRtpPayloadTypeError) ==
+              NULL);
+  EXPECT_EQ(DecoderDatabase::kDecoderNotFound,
+            db.SetActiveCngDecoder(DecoderDatabase::kRtpPayloadTypeError));
+}
+
 TEST(DecoderDatabase, GetRtpPayloadType) {
   DecoderDatabase db;
   const uint8_t kPayloadType = 0;
@@ -241,12 +241,7 @@ int DspHelper::MinDistortion(const int16_t* signal, int min_lag,
   int best_index = -1;
   int32_t min_distortion = WEBRTC_SPL_WORD32_MAX;
   for (int i = min_lag; i <= max_lag; i++) {
-    int32_t sum_diff = 0;
-    const int16_t* data1 = signal;
-    const int16_t* data2 = signal - i;
-    for (int j = 0; j < length; j++) {
-      sum_diff += WEBRTC_SPL_ABS_W32(data1[j] - data2[j]);
-    }
+    int32_t sum_diff = WebRtcSpl_SumAbsDiffW16(signal, signal - i, length);
     // Compare with previous minimum.
     if (sum_diff < min_distortion) {
       min_distortion = sum_diff;
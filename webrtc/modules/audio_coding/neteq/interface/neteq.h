@@ -55,7 +55,12 @@ enum NetEqPlayoutMode {
   kPlayoutOn,
   kPlayoutOff,
   kPlayoutFax,
-  kPlayoutStreaming
+  kPlayoutStreaming,
+  // Decodes the packets in timestamp order as fast as GetAudio() is called,
+  // e.g., for recording or transcoding stored RTP streams. Packet loss is
+  // concealed with expansion, but there is no time-stretching, and the
+  // arrival times of the packets are ignored.
+  kPlayoutDecodeOnly
 };
 
 enum NetEqBackgroundNoiseMode {
@@ -28,10 +28,10 @@ class MockPayloadSplitter : public PayloadSplitter {
   MOCK_METHOD2(SplitAudio,
       int(PacketList* packet_list, const DecoderDatabase& decoder_database));
   MOCK_METHOD4(SplitBySamples,
-      void(const Packet* packet, int bytes_per_ms, int timestamps_per_ms,
+      void(Packet* packet, int bytes_per_ms, int timestamps_per_ms,
            PacketList* new_packets));
   MOCK_METHOD4(SplitByFrames,
-      int(const Packet* packet, int bytes_per_frame, int timestamps_per_frame,
+      int(Packet* packet, int bytes_per_frame, int timestamps_per_frame,
           PacketList* new_packets));
 };
 
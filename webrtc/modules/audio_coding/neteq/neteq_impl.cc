@@ -664,9 +664,11 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
 
     // Update statistics.
     if ((int32_t) (main_header.timestamp - timestamp_) >= 0 &&
-        !new_codec_) {
+        !new_codec_ &&
+        decision_logic_->playout_mode() != kPlayoutDecodeOnly) {
       // Only update statistics if incoming packet is not older than last played
-      // out packet, and if new codec flag is not set.
+      // out packet, and if new codec flag is not set. The arrival times are
+      // meaningless when decoding stored streams.
       delay_manager_->Update(main_header.sequenceNumber, main_header.timestamp,
                              fs_hz_);
     }
@@ -639,6 +639,49 @@ TEST_F(NetEqDecodingTest, TestFrameWaitingTimeStatistics) {
   EXPECT_EQ(100u, waiting_times.size());
 }
 
+// In decode-only mode, a stored stream which is dumped into NetEq at once
+// must be decoded frame by frame, without any frames being time-stretched
+// away. A missing packet is concealed.
+TEST_F(NetEqDecodingTest, DecodeOnlyMode) {
+  neteq_->SetPlayoutMode(kPlayoutDecodeOnly);
+  ASSERT_EQ(kPlayoutDecodeOnly, neteq_->PlayoutMode());
+  // Insert 30 packets at once, except for the 15th. Each packet contains
+  // 10 ms 16 kHz audio. The buffer holds all of them.
+  const int kNumFrames = 30;
+  const int kLostFrame = 15;
+  const int kSamples = 10 * 16;
+  const int kPayloadBytes = kSamples * 2;
+  for (int i = 0; i < kNumFrames; ++i) {
+    if (i == kLostFrame)
+      continue;
+    uint8_t payload[kPayloadBytes] = {0};
+    WebRtcRTPHeader rtp_info;
+    PopulateRtpInfo(i, i * kSamples, &rtp_info);
+    ASSERT_EQ(0, neteq_->InsertPacket(rtp_info, payload, kPayloadBytes, 0));
+  }
+  // Pull out all data. Every frame is played out once, so the stream ends
+  // after exactly |kNumFrames| blocks.
+  int num_concealed = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    int out_len;
+    int num_channels;
+    NetEqOutputType type;
+    ASSERT_EQ(0, neteq_->GetAudio(kMaxBlockSize, out_data_, &out_len,
+                                  &num_channels, &type));
+    ASSERT_EQ(kBlockSize16kHz, out_len);
+    if (type == kOutputPLC)
+      ++num_concealed;
+    else
+      EXPECT_EQ(kOutputNormal, type);
+  }
+  EXPECT_EQ(1, num_concealed);
+
+  NetEqNetworkStatistics network_stats;
+  ASSERT_EQ(0, neteq_->NetworkStatistics(&network_stats));
+  EXPECT_EQ(0, network_stats.accelerate_rate);
+  EXPECT_EQ(0, network_stats.preemptive_rate);
+}
+
 TEST_F(NetEqDecodingTest, TestAverageInterArrivalTimeNegative) {
   const int kNumFrames = 3000;  // Needed for convergence.
   int frame_index = 0;
@@ -8,36 +8,28 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-// This is the implementation of the PacketBuffer class. It is mostly based on
-// an STL list. The list is kept sorted at all times so that the next packet to
-// decode is at the beginning of the list.
+// This is the implementation of the PacketBuffer class. The packets are kept
+// in a circular array allocated once at construction, sorted at all times so
+// that the next packet to decode is at the front. Inserting or extracting a
+// packet therefore never allocates.
 
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 
-#include <algorithm>  // find_if()
+#include <algorithm>  // max()
 
 #include "webrtc/modules/audio_coding/neteq/decoder_database.h"
 #include "webrtc/modules/audio_coding/neteq/interface/audio_decoder.h"
 
 namespace webrtc {
 
-// Predicate used when inserting packets in the buffer list.
-// Operator() returns true when |packet| goes before |new_packet|.
-class NewTimestampIsLarger {
- public:
-  explicit NewTimestampIsLarger(const Packet* new_packet)
-      : new_packet_(new_packet) {
-  }
-  bool operator()(Packet* packet) {
-    return (*new_packet_ >= *packet);
-  }
-
- private:
-  const Packet* new_packet_;
-};
-
 PacketBuffer::PacketBuffer(size_t max_number_of_packets)
-    : max_number_of_packets_(max_number_of_packets) {}
+    : max_number_of_packets_(max_number_of_packets),
+      // The buffer is flushed before it grows beyond |max_number_of_packets|,
+      // except when that is zero.
+      capacity_(std::max<size_t>(max_number_of_packets, 1)),
+      packets_(new Packet*[capacity_]),
+      first_(0),
+      num_packets_(0) {}
 
 // Destructor. All packets in the buffer will be destroyed.
 PacketBuffer::~PacketBuffer() {
@@ -46,7 +38,8 @@ PacketBuffer::~PacketBuffer() {
 
 // Flush the buffer. All packets in the buffer will be destroyed.
 void PacketBuffer::Flush() {
-  DeleteAllPackets(&buffer_);
+  while (!Empty())
+    DeleteFront();
 }
 
 int PacketBuffer::InsertPacket(Packet* packet) {
@@ -59,19 +52,22 @@ int PacketBuffer::InsertPacket(Packet* packet) {
 
   int return_val = kOK;
 
-  if (buffer_.size() >= max_number_of_packets_) {
+  if (num_packets_ >= max_number_of_packets_) {
     // Buffer is full. Flush it.
     Flush();
     return_val = kFlushed;
   }
 
-  // Get an iterator pointing to the place in the buffer where the new packet
-  // should be inserted. The list is searched from the back, since the most
-  // likely case is that the new packet should be near the end of the list.
-  PacketList::reverse_iterator rit = std::find_if(
-      buffer_.rbegin(), buffer_.rend(),
-      NewTimestampIsLarger(packet));
-  buffer_.insert(rit.base(), packet);  // Insert the packet at that position.
+  // Find the place in the buffer where the new packet should be inserted,
+  // moving later packets up by one. The buffer is searched from the back,
+  // since the most likely case is that the new packet should be near the end.
+  size_t index = num_packets_;
+  while (index > 0 && !(*packet >= *PacketAt(index - 1))) {
+    Slot(index) = Slot(index - 1);
+    --index;
+  }
+  Slot(index) = packet;
+  ++num_packets_;
 
   return return_val;
 }
@@ -123,7 +119,7 @@ int PacketBuffer::NextTimestamp(uint32_t* next_timestamp) const {
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  *next_timestamp = buffer_.front()->header.timestamp;
+  *next_timestamp = PacketAt(0)->header.timestamp;
   return kOK;
 }
 
@@ -135,11 +131,10 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  PacketList::const_iterator it;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    if ((*it)->header.timestamp >= timestamp) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    if (PacketAt(i)->header.timestamp >= timestamp) {
       // Found a packet matching the search.
-      *next_timestamp = (*it)->header.timestamp;
+      *next_timestamp = PacketAt(i)->header.timestamp;
       return kOK;
     }
   }
@@ -150,7 +145,7 @@ const RTPHeader* PacketBuffer::NextRtpHeader() const {
   if (Empty()) {
     return NULL;
   }
-  return const_cast<const RTPHeader*>(&(buffer_.front()->header));
+  return const_cast<const RTPHeader*>(&(PacketAt(0)->header));
 }
 
 Packet* PacketBuffer::GetNextPacket(int* discard_count) {
@@ -159,17 +154,17 @@ Packet* PacketBuffer::GetNextPacket(int* discard_count) {
     return NULL;
   }
 
-  Packet* packet = buffer_.front();
+  Packet* packet = PacketAt(0);
   // Assert that the packet sanity checks in InsertPacket method works.
   assert(packet && packet->payload);
-  buffer_.pop_front();
+  PopFront();
   // Discard other packets with the same timestamp. These are duplicates or
   // redundant payloads that should not be used.
   if (discard_count) {
     *discard_count = 0;
   }
   while (!Empty() &&
-      buffer_.front()->header.timestamp == packet->header.timestamp) {
+      PacketAt(0)->header.timestamp == packet->header.timestamp) {
     if (DiscardNextPacket() != kOK) {
       assert(false);  // Must be ok by design.
     }
@@ -185,17 +180,17 @@ int PacketBuffer::DiscardNextPacket() {
     return kBufferEmpty;
   }
   // Assert that the packet sanity checks in InsertPacket method works.
-  assert(buffer_.front());
-  assert(buffer_.front()->payload);
-  DeleteFirstPacket(&buffer_);
+  assert(PacketAt(0));
+  assert(PacketAt(0)->payload);
+  DeleteFront();
   return kOK;
 }
 
 int PacketBuffer::DiscardOldPackets(uint32_t timestamp_limit) {
   while (!Empty() &&
-      timestamp_limit != buffer_.front()->header.timestamp &&
+      timestamp_limit != PacketAt(0)->header.timestamp &&
       static_cast<uint32_t>(timestamp_limit
-                            - buffer_.front()->header.timestamp) <
+                            - PacketAt(0)->header.timestamp) <
                             0xFFFFFFFF / 2) {
     if (DiscardNextPacket() != kOK) {
       assert(false);  // Must be ok by design.
@@ -206,11 +201,10 @@ int PacketBuffer::DiscardOldPackets(uint32_t timestamp_limit) {
 
 int PacketBuffer::NumSamplesInBuffer(DecoderDatabase* decoder_database,
                                      int last_decoded_length) const {
-  PacketList::const_iterator it;
   int num_samples = 0;
   int last_duration = last_decoded_length;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    Packet* packet = (*it);
+  for (size_t i = 0; i < num_packets_; ++i) {
+    Packet* packet = PacketAt(i);
     AudioDecoder* decoder =
         decoder_database->GetDecoder(packet->header.payloadType);
     if (decoder) {
@@ -233,9 +227,8 @@ int PacketBuffer::NumSamplesInBuffer(DecoderDatabase* decoder_database,
 }
 
 void PacketBuffer::IncrementWaitingTimes(int inc) {
-  PacketList::iterator it;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    (*it)->waiting_time += inc;
+  for (size_t i = 0; i < num_packets_; ++i) {
+    PacketAt(i)->waiting_time += inc;
   }
 }
 
@@ -257,8 +250,21 @@ void PacketBuffer::DeleteAllPackets(PacketList* packet_list) {
 }
 
 void PacketBuffer::BufferStat(int* num_packets, int* max_num_packets) const {
-  *num_packets = static_cast<int>(buffer_.size());
+  *num_packets = static_cast<int>(num_packets_);
   *max_num_packets = static_cast<int>(max_number_of_packets_);
 }
 
+void PacketBuffer::PopFront() {
+  assert(!Empty());
+  first_ = (first_ + 1) % capacity_;
+  --num_packets_;
+}
+
+void PacketBuffer::DeleteFront() {
+  Packet* first_packet = PacketAt(0);
+  PopFront();
+  delete [] first_packet->payload;
+  delete first_packet;
+}
+
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -43,7 +44,7 @@ class PacketBuffer {
   virtual void Flush();
 
   // Returns true for an empty buffer.
-  virtual bool Empty() const { return buffer_.empty(); }
+  virtual bool Empty() const { return num_packets_ == 0; }
 
   // Inserts |packet| into the buffer. The buffer will take over ownership of
   // the packet object.
@@ -102,7 +103,7 @@ class PacketBuffer {
   // Returns the number of packets in the buffer, including duplicates and
   // redundant packets.
   virtual int NumPacketsInBuffer() const {
-    return static_cast<int>(buffer_.size());
+    return static_cast<int>(num_packets_);
   }
 
   // Returns the number of samples in the buffer, including samples carried in
@@ -126,8 +127,25 @@ class PacketBuffer {
   static void DeleteAllPackets(PacketList* packet_list);
 
  private:
+  // Returns the slot of the |index|th packet, counting from the front.
+  Packet*& Slot(size_t index) {
+    return packets_[(first_ + index) % capacity_];
+  }
+  Packet* PacketAt(size_t index) const {
+    return packets_[(first_ + index) % capacity_];
+  }
+  // Removes the first packet from the buffer without deleting it.
+  void PopFront();
+  // Removes and deletes the first packet in the buffer.
+  void DeleteFront();
+
   size_t max_number_of_packets_;
-  PacketList buffer_;
+  const size_t capacity_;
+  // Circular array of |capacity_| packets, sorted in decoding order starting
+  // at index |first_|.
+  scoped_ptr<Packet*[]> packets_;
+  size_t first_;
+  size_t num_packets_;
   DISALLOW_COPY_AND_ASSIGN(PacketBuffer);
 };
 
@@ -144,6 +144,39 @@ TEST(PacketBuffer, OverfillBuffer) {
   buffer.Flush();
 }
 
+// Test that the buffer keeps the packets in order while the circular array
+// wraps around.
+TEST(PacketBuffer, WrapAround) {
+  PacketBuffer buffer(10);  // 10 packets.
+  PacketGenerator gen(0, 0, 0, 10);
+  const int payload_len = 10;
+
+  // Keep the buffer half full.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(PacketBuffer::kOK,
+              buffer.InsertPacket(gen.NextPacket(payload_len)));
+  }
+  uint32_t expected_ts = 0;
+  for (int i = 0; i < 50; ++i) {
+    // Insert every other packet in reverse order.
+    Packet* packet = gen.NextPacket(payload_len);
+    if (i % 2 == 0) {
+      Packet* next_packet = gen.NextPacket(payload_len);
+      EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(next_packet));
+    }
+    EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(packet));
+    for (int j = 0; j < (i % 2 == 0 ? 2 : 1); ++j) {
+      packet = buffer.GetNextPacket(NULL);
+      ASSERT_TRUE(packet != NULL);
+      EXPECT_EQ(expected_ts, packet->header.timestamp);
+      expected_ts += 10;
+      delete [] packet->payload;
+      delete packet;
+    }
+    EXPECT_EQ(5, buffer.NumPacketsInBuffer());
+  }
+}
+
 // Test inserting a list of packets.
 TEST(PacketBuffer, InsertPacketList) {
   PacketBuffer buffer(10);  // 10 packets.
@@ -17,12 +17,12 @@
 namespace webrtc {
 
 // The method loops through a list of packets {A, B, C, ...}. Each packet is
-// split into its corresponding RED payloads, {A1, A2, ...}, which is
-// temporarily held in the list |new_packets|.
-// When the first packet in |packet_list| has been processed, the orignal packet
-// is replaced by the new ones in |new_packets|, so that |packet_list| becomes:
-// {A1, A2, ..., B, C, ...}. The method then continues with B, and C, until all
-// the original packets have been replaced by their split payloads.
+// split into its corresponding RED payloads, {A1, A2, ...}. The primary
+// payload A1 is moved to the front of the payload of A, which is reused in
+// place. The redundant payloads are copied to new packets which are
+// temporarily held in the list |new_packets|, and inserted after A1 so that
+// |packet_list| becomes: {A1, A2, ..., B, C, ...}. The method then continues
+// with B, and C, until all the original packets have been split.
 int PayloadSplitter::SplitRed(PacketList* packet_list) {
   int ret = kOK;
   PacketList::iterator it = packet_list->begin();
@@ -47,20 +47,23 @@ int PayloadSplitter::SplitRed(PacketList* packet_list) {
 
     bool last_block = false;
     int sum_length = 0;
+    uint8_t primary_payload_type = 0;
+    int primary_payload_length = 0;
     while (!last_block) {
-      Packet* new_packet = new Packet;
-      new_packet->header = red_packet->header;
       // Check the F bit. If F == 0, this was the last block.
       last_block = ((*payload_ptr & 0x80) == 0);
-      // Bits 1 through 7 are payload type.
-      new_packet->header.payloadType = payload_ptr[0] & 0x7F;
       if (last_block) {
+        // Bits 1 through 7 are payload type.
+        primary_payload_type = payload_ptr[0] & 0x7F;
         // No more header data to read.
         ++sum_length;  // Account for RED header size of 1 byte.
-        new_packet->payload_length = red_packet->payload_length - sum_length;
-        new_packet->primary = true;  // Last block is always primary.
+        primary_payload_length = red_packet->payload_length - sum_length;
         payload_ptr += 1;  // Advance to first payload byte.
       } else {
+        Packet* new_packet = new Packet;
+        new_packet->header = red_packet->header;
+        // Bits 1 through 7 are payload type.
+        new_packet->header.payloadType = payload_ptr[0] & 0x7F;
         // Bits 8 through 21 are timestamp offset.
         int timestamp_offset = (payload_ptr[1] << 6) +
             ((payload_ptr[2] & 0xFC) >> 2);
@@ -71,20 +74,22 @@ int PayloadSplitter::SplitRed(PacketList* packet_list) {
             payload_ptr[3];
         new_packet->primary = false;
         payload_ptr += 4;  // Advance to next RED header.
+        sum_length += new_packet->payload_length;
+        sum_length += 4;  // Account for RED header size of 4 bytes.
+        // Store in new list of packets.
+        new_packets.push_back(new_packet);
       }
-      sum_length += new_packet->payload_length;
-      sum_length += 4;  // Account for RED header size of 4 bytes.
-      // Store in new list of packets.
-      new_packets.push_back(new_packet);
     }
 
     // Populate the new packets with payload data.
     // |payload_ptr| now points at the first payload byte.
+    const uint8_t* payload_end =
+        red_packet->payload + red_packet->payload_length;
+    bool primary_is_valid = true;
     PacketList::iterator new_it;
     for (new_it = new_packets.begin(); new_it != new_packets.end(); ++new_it) {
       int payload_length = (*new_it)->payload_length;
-      if (payload_ptr + payload_length >
-          red_packet->payload + red_packet->payload_length) {
+      if (payload_ptr + payload_length > payload_end) {
         // The block lengths in the RED headers do not match the overall packet
         // length. Something is corrupt. Discard this and the remaining
         // payloads from this packet.
@@ -94,6 +99,7 @@ int PayloadSplitter::SplitRed(PacketList* packet_list) {
           delete (*new_it);
           new_it = new_packets.erase(new_it);
         }
+        primary_is_valid = false;
         ret = kRedLengthMismatch;
         break;
       }
@@ -101,20 +107,38 @@ int PayloadSplitter::SplitRed(PacketList* packet_list) {
       memcpy((*new_it)->payload, payload_ptr, payload_length);
       payload_ptr += payload_length;
     }
-    // Reverse the order of the new packets, so that the primary payload is
-    // always first.
+    if (primary_payload_length < 0) {
+      primary_is_valid = false;
+      ret = kRedLengthMismatch;
+    }
+    // Reverse the order of the new packets, so that the most recent redundant
+    // payload comes right after the primary payload.
     new_packets.reverse();
-    // Insert new packets into original list, before the element pointed to by
-    // iterator |it|.
-    packet_list->splice(it, new_packets, new_packets.begin(),
-                        new_packets.end());
-    // Delete old packet payload.
-    delete [] (*it)->payload;
-    delete (*it);
-    // Remove |it| from the packet list. This operation effectively moves the
-    // iterator |it| to the next packet in the list. Thus, we do not have to
-    // increment it manually.
-    it = packet_list->erase(it);
+    if (primary_is_valid) {
+      // The last block ends exactly at the end of the RED payload. Move it to
+      // the front, overwriting the RED headers and the redundant payloads,
+      // which have been copied out already.
+      memmove(red_packet->payload, payload_ptr, primary_payload_length);
+      red_packet->payload_length = primary_payload_length;
+      red_packet->header.payloadType = primary_payload_type;
+      red_packet->primary = true;  // Last block is always primary.
+      // Insert the new packets after the primary payload.
+      ++it;
+      packet_list->splice(it, new_packets, new_packets.begin(),
+                          new_packets.end());
+    } else {
+      // Insert new packets into original list, before the element pointed to
+      // by iterator |it|.
+      packet_list->splice(it, new_packets, new_packets.begin(),
+                          new_packets.end());
+      // Delete old packet payload.
+      delete [] (*it)->payload;
+      delete (*it);
+      // Remove |it| from the packet list. This operation effectively moves
+      // the iterator |it| to the next packet in the list. Thus, we do not have
+      // to increment it manually.
+      it = packet_list->erase(it);
+    }
   }
   return ret;
 }
@@ -329,22 +353,16 @@ int PayloadSplitter::SplitAudio(PacketList* packet_list,
         continue;
       }
     }
-    // Insert new packets into original list, before the element pointed to by
-    // iterator |it|.
+    // |packet| now holds the first chunk. Insert the remaining chunks after
+    // it, and continue with the next original packet.
+    ++it;
     packet_list->splice(it, new_packets, new_packets.begin(),
                         new_packets.end());
-    // Delete old packet payload.
-    delete [] (*it)->payload;
-    delete (*it);
-    // Remove |it| from the packet list. This operation effectively moves the
-    // iterator |it| to the next packet in the list. Thus, we do not have to
-    // increment it manually.
-    it = packet_list->erase(it);
   }
   return kOK;
 }
 
-void PayloadSplitter::SplitBySamples(const Packet* packet,
+void PayloadSplitter::SplitBySamples(Packet* packet,
                                      int bytes_per_ms,
                                      int timestamps_per_ms,
                                      PacketList* new_packets) {
@@ -365,8 +383,16 @@ void PayloadSplitter::SplitBySamples(const Packet* packet,
       split_size_bytes * timestamps_per_ms / bytes_per_ms;
   uint32_t timestamp = packet->header.timestamp;
 
-  uint8_t* payload_ptr = packet->payload;
-  int len = packet->payload_length;
+  // The first chunk stays at the front of the payload of |packet|.
+  uint8_t* payload_ptr = packet->payload + split_size_bytes;
+  int len = packet->payload_length - split_size_bytes;
+  timestamp += timestamps_per_chunk;
+  if (len < split_size_bytes) {
+    // The last chunk is at most twice as large as the others.
+    split_size_bytes = packet->payload_length;
+    len = 0;
+  }
+  packet->payload_length = split_size_bytes;
   while (len >= (2 * split_size_bytes)) {
     Packet* new_packet = new Packet;
     new_packet->payload_length = split_size_bytes;
@@ -393,7 +419,7 @@ void PayloadSplitter::SplitBySamples(const Packet* packet,
   }
 }
 
-int PayloadSplitter::SplitByFrames(const Packet* packet,
+int PayloadSplitter::SplitByFrames(Packet* packet,
                                    int bytes_per_frame,
                                    int timestamps_per_frame,
                                    PacketList* new_packets) {
@@ -407,9 +433,11 @@ int PayloadSplitter::SplitByFrames(const Packet* packet,
     return kNoSplit;
   }
 
-  uint32_t timestamp = packet->header.timestamp;
-  uint8_t* payload_ptr = packet->payload;
-  int len = packet->payload_length;
+  // The first frame stays at the front of the payload of |packet|.
+  uint32_t timestamp = packet->header.timestamp + timestamps_per_frame;
+  uint8_t* payload_ptr = packet->payload + bytes_per_frame;
+  int len = packet->payload_length - bytes_per_frame;
+  packet->payload_length = bytes_per_frame;
   while (len > 0) {
     assert(len >= bytes_per_frame);
     Packet* new_packet = new Packet;
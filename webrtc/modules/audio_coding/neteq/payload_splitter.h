@@ -42,7 +42,8 @@ class PayloadSplitter {
 
   // Splits each packet in |packet_list| into its separate RED payloads. Each
   // RED payload is packetized into a Packet. The original elements in
-  // |packet_list| are properly deleted, and replaced by the new packets.
+  // |packet_list| are reused in place for the primary payloads, and followed
+  // by new packets for the redundant payloads.
   // Note that all packets in |packet_list| must be RED payloads, i.e., have
   // RED headers according to RFC 2198 at the very beginning of the payload.
   // Returns kOK or an error.
@@ -61,24 +62,27 @@ class PayloadSplitter {
                                const DecoderDatabase& decoder_database);
 
   // Iterates through |packet_list| and, if possible, splits each audio payload
-  // into suitable size chunks. The result is written back to |packet_list| as
-  // new packets. The decoder database is needed to get information about which
-  // payload type each packet contains.
+  // into suitable size chunks. The first chunk is kept in the original packet,
+  // and the remaining ones are written back to |packet_list| as new packets.
+  // The decoder database is needed to get information about which payload
+  // type each packet contains.
   virtual int SplitAudio(PacketList* packet_list,
                          const DecoderDatabase& decoder_database);
 
  private:
   // Splits the payload in |packet|. The payload is assumed to be from a
-  // sample-based codec.
-  virtual void SplitBySamples(const Packet* packet,
+  // sample-based codec. |packet| is truncated to the first chunk, and the
+  // remaining chunks are appended to |new_packets|.
+  virtual void SplitBySamples(Packet* packet,
                               int bytes_per_ms,
                               int timestamps_per_ms,
                               PacketList* new_packets);
 
   // Splits the payload in |packet|. The payload will be split into chunks of
   // size |bytes_per_frame|, corresponding to a |timestamps_per_frame|
-  // RTP timestamps.
-  virtual int SplitByFrames(const Packet* packet,
+  // RTP timestamps. |packet| is truncated to the first frame, and the
+  // remaining frames are appended to |new_packets|.
+  virtual int SplitByFrames(Packet* packet,
                             int bytes_per_frame,
                             int timestamps_per_frame,
                             PacketList* new_packets);
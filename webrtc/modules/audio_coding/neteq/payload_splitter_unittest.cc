@@ -170,6 +170,8 @@ TEST(RedPayloadSplitter, OnePacketTwoPayloads) {
   EXPECT_EQ(PayloadSplitter::kOK, splitter.SplitRed(&packet_list));
   ASSERT_EQ(2u, packet_list.size());
   // Check first packet. The first in list should always be the primary payload.
+  // The original packet is reused for it.
+  EXPECT_EQ(packet, packet_list.front());
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[1], kSequenceNumber,
                kBaseTimestamp, 1, true);
@@ -10,29 +10,39 @@
 
 #include "webrtc/modules/audio_coding/neteq/tools/input_audio_file.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 namespace webrtc {
 namespace test {
 
-InputAudioFile::InputAudioFile(const std::string file_name) {
-  fp_ = fopen(file_name.c_str(), "rb");
+InputAudioFile::InputAudioFile(const std::string file_name) : position_(0) {
+  file_.Open(file_name);
 }
 
-InputAudioFile::~InputAudioFile() { fclose(fp_); }
+InputAudioFile::~InputAudioFile() {}
 
 bool InputAudioFile::Read(size_t samples, int16_t* destination) {
-  if (!fp_) {
+  if (!file_.is_open()) {
     return false;
   }
-  size_t samples_read = fread(destination, sizeof(int16_t), samples, fp_);
+  const int16_t* file_samples = reinterpret_cast<const int16_t*>(file_.data());
+  const size_t num_file_samples = file_.size() / sizeof(int16_t);
+  size_t samples_read = std::min(samples, num_file_samples - position_);
+  memcpy(destination, &file_samples[position_],
+         samples_read * sizeof(int16_t));
+  position_ += samples_read;
   if (samples_read < samples) {
     // Rewind and read the missing samples.
-    rewind(fp_);
     size_t missing_samples = samples - samples_read;
-    if (fread(destination, sizeof(int16_t), missing_samples, fp_) <
-        missing_samples) {
+    if (missing_samples > num_file_samples) {
       // Could not read enough even after rewinding the file.
       return false;
     }
+    memcpy(&destination[samples_read], file_samples,
+           missing_samples * sizeof(int16_t));
+    position_ = missing_samples;
   }
   return true;
 }
@@ -16,12 +16,14 @@
 #include <string>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/test/testsupport/mapped_file.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 namespace test {
 
-// Class for handling a looping input audio file.
+// Class for handling a looping input audio file. The file is mapped into
+// memory, so that the samples are read straight from the page cache.
 class InputAudioFile {
  public:
   explicit InputAudioFile(const std::string file_name);
@@ -42,7 +44,9 @@ class InputAudioFile {
                                    size_t channels, int16_t* destination);
 
  private:
-  FILE* fp_;
+  MappedFile file_;
+  // The index of the next sample to read.
+  size_t position_;
   DISALLOW_COPY_AND_ASSIGN(InputAudioFile);
 };
 
@@ -0,0 +1,382 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Tool for simulating NetEq over many RTP dump files at once. Each file is
+// played out by its own NetEq instance on a thread pool, in simulated time,
+// and the network statistics of all files are aggregated at the end.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "google/gflags.h"
+#include "webrtc/base/fileutils.h"
+#include "webrtc/base/pathutils.h"
+#include "webrtc/modules/audio_coding/neteq/interface/neteq.h"
+#include "webrtc/modules/audio_coding/neteq/tools/packet.h"
+#include "webrtc/modules/audio_coding/neteq/tools/rtp_file_source.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+#include "webrtc/typedefs.h"
+
+DEFINE_int32(workers, 0, "Number of files simulated at the same time. 0 means "
+             "one per core.");
+DEFINE_string(extension, ".rtp", "Extension of the files simulated in the "
+              "directories given on the command line.");
+DEFINE_bool(per_file, false, "Prints the statistics of each file.");
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const int kMaxChannels = 5;
+const int kMaxSamplesPerMs = 48000 / 1000;
+const int kOutputBlockSizeMs = 10;
+const int kStatsIntervalMs = 1000;
+// NetEqNetworkStatistics rates are in Q14.
+const double kQ14 = 16384.0;
+
+// The default payload types of neteq_rtpplay.
+const struct {
+  NetEqDecoder decoder;
+  uint8_t payload_type;
+} kPayloadTypes[] = {
+  { kDecoderPCMu, 0 },
+  { kDecoderPCMa, 8 },
+  { kDecoderILBC, 102 },
+  { kDecoderISAC, 103 },
+  { kDecoderISACswb, 104 },
+  { kDecoderPCM16B, 93 },
+  { kDecoderPCM16Bwb, 94 },
+  { kDecoderPCM16Bswb32kHz, 95 },
+  { kDecoderPCM16Bswb48kHz, 96 },
+  { kDecoderG722, 9 },
+  { kDecoderAVT, 106 },
+  { kDecoderRED, 117 },
+  { kDecoderCNGnb, 13 },
+  { kDecoderCNGwb, 98 },
+  { kDecoderCNGswb32kHz, 99 },
+  { kDecoderCNGswb48kHz, 100 },
+};
+
+struct SimulationResult {
+  SimulationResult()
+      : ok(false),
+        duration_ms(0),
+        expand_rate(0),
+        preemptive_rate(0),
+        accelerate_rate(0),
+        mean_delay_ms(0),
+        max_delay_ms(0) {}
+
+  std::string file_name;
+  bool ok;
+  int duration_ms;
+  // Fractions of the output, averaged over the call.
+  double expand_rate;
+  double preemptive_rate;
+  double accelerate_rate;
+  // Jitter buffer delay, sampled every kStatsIntervalMs.
+  double mean_delay_ms;
+  int max_delay_ms;
+};
+
+// Averages the network statistics sampled during a call.
+class StatsAccumulator {
+ public:
+  StatsAccumulator()
+      : expand_sum_(0),
+        preemptive_sum_(0),
+        accelerate_sum_(0),
+        delay_sum_(0),
+        max_delay_ms_(0),
+        num_samples_(0) {}
+
+  // The rates are reset by each NetworkStatistics() call, so each sample
+  // covers the time since the previous one.
+  void Add(NetEq* neteq) {
+    NetEqNetworkStatistics stats;
+    if (neteq->NetworkStatistics(&stats) != NetEq::kOK)
+      return;
+    expand_sum_ += stats.expand_rate / kQ14;
+    preemptive_sum_ += stats.preemptive_rate / kQ14;
+    accelerate_sum_ += stats.accelerate_rate / kQ14;
+    delay_sum_ += stats.current_buffer_size_ms;
+    max_delay_ms_ = std::max(max_delay_ms_,
+                             static_cast<int>(stats.current_buffer_size_ms));
+    ++num_samples_;
+  }
+
+  void GetResult(SimulationResult* result) const {
+    if (num_samples_ == 0)
+      return;
+    result->expand_rate = expand_sum_ / num_samples_;
+    result->preemptive_rate = preemptive_sum_ / num_samples_;
+    result->accelerate_rate = accelerate_sum_ / num_samples_;
+    result->mean_delay_ms = delay_sum_ / num_samples_;
+    result->max_delay_ms = max_delay_ms_;
+  }
+
+ private:
+  double expand_sum_;
+  double preemptive_sum_;
+  double accelerate_sum_;
+  double delay_sum_;
+  int max_delay_ms_;
+  int num_samples_;
+};
+
+// Plays out |result->file_name| and fills in |result|.
+void SimulateFile(SimulationResult* result) {
+  scoped_ptr<RtpFileSource> source(RtpFileSource::Create(result->file_name));
+  if (!source) {
+    fprintf(stderr, "Cannot open %s\n", result->file_name.c_str());
+    return;
+  }
+  scoped_ptr<Packet> packet(source->NextPacket());
+  if (!packet) {
+    fprintf(stderr, "%s has no packets\n", result->file_name.c_str());
+    return;
+  }
+
+  int sample_rate_hz = 16000;
+  NetEq::Config config;
+  config.sample_rate_hz = sample_rate_hz;
+  scoped_ptr<NetEq> neteq(NetEq::Create(config));
+  for (size_t i = 0; i < sizeof(kPayloadTypes) / sizeof(kPayloadTypes[0]);
+       ++i) {
+    if (neteq->RegisterPayloadType(kPayloadTypes[i].decoder,
+                                   kPayloadTypes[i].payload_type) !=
+        NetEq::kOK) {
+      fprintf(stderr, "Cannot register payload type %d\n",
+              kPayloadTypes[i].payload_type);
+      return;
+    }
+  }
+
+  // Time jumps from one event to the next, as in neteq_rtpplay.
+  int64_t time_now_ms = static_cast<int64_t>(packet->time_ms());
+  int64_t next_output_time_ms = time_now_ms;
+  if (time_now_ms % kOutputBlockSizeMs != 0) {
+    next_output_time_ms +=
+        kOutputBlockSizeMs - time_now_ms % kOutputBlockSizeMs;
+  }
+  int64_t next_stats_time_ms = next_output_time_ms + kStatsIntervalMs;
+  int last_stats_duration_ms = 0;
+  StatsAccumulator stats;
+  while (packet) {
+    while (packet && packet->time_ms() <= time_now_ms) {
+      if (packet->valid_header() && packet->payload_length_bytes() > 0) {
+        WebRtcRTPHeader rtp_header;
+        rtp_header.header = packet->header();
+        // Errors are counted by NetEq as losses; keep going.
+        neteq->InsertPacket(rtp_header, packet->payload(),
+                            static_cast<int>(packet->payload_length_bytes()),
+                            static_cast<uint32_t>(
+                                packet->time_ms() * sample_rate_hz / 1000));
+      }
+      packet.reset(source->NextPacket());
+    }
+
+    if (time_now_ms >= next_output_time_ms) {
+      static const int kOutDataLen = kOutputBlockSizeMs * kMaxSamplesPerMs *
+          kMaxChannels;
+      int16_t out_data[kOutDataLen];
+      int num_channels;
+      int samples_per_channel;
+      if (neteq->GetAudio(kOutDataLen, out_data, &samples_per_channel,
+                          &num_channels, NULL) == NetEq::kOK) {
+        sample_rate_hz = 1000 * samples_per_channel / kOutputBlockSizeMs;
+      }
+      next_output_time_ms += kOutputBlockSizeMs;
+      result->duration_ms += kOutputBlockSizeMs;
+
+      if (next_output_time_ms >= next_stats_time_ms) {
+        stats.Add(neteq.get());
+        last_stats_duration_ms = result->duration_ms;
+        next_stats_time_ms += kStatsIntervalMs;
+      }
+    }
+
+    if (packet) {
+      time_now_ms = std::min(static_cast<int64_t>(packet->time_ms()),
+                             next_output_time_ms);
+    }
+  }
+
+  // Include the output since the last sample.
+  if (result->duration_ms > last_stats_duration_ms)
+    stats.Add(neteq.get());
+  stats.GetResult(result);
+  result->ok = true;
+}
+
+class SimulateFileTask : public QueuedTask {
+ public:
+  SimulateFileTask(SimulationResult* result,
+                   Atomic32* remaining,
+                   EventWrapper* done)
+      : result_(result), remaining_(remaining), done_(done) {}
+
+  virtual void Run() OVERRIDE {
+    SimulateFile(result_);
+    if (--*remaining_ == 0)
+      done_->Set();
+  }
+
+ private:
+  SimulationResult* const result_;
+  Atomic32* const remaining_;
+  EventWrapper* const done_;
+};
+
+bool HasExtension(const std::string& name, const std::string& extension) {
+  return name.size() >= extension.size() &&
+      name.compare(name.size() - extension.size(), extension.size(),
+                   extension) == 0;
+}
+
+// Adds |path| to |files|, or the files of |path| with --extension if it is a
+// directory.
+void AddFiles(const std::string& path, std::vector<std::string>* files) {
+  rtc::DirectoryIterator it;
+  if (!it.Iterate(rtc::Pathname(path, ""))) {
+    files->push_back(path);
+    return;
+  }
+  std::vector<std::string> directory_files;
+  do {
+    if (it.IsDirectory() || !HasExtension(it.Name(), FLAGS_extension))
+      continue;
+    directory_files.push_back(rtc::Pathname(path, it.Name()).pathname());
+  } while (it.Next());
+  // Keep the output stable from one run to the next.
+  std::sort(directory_files.begin(), directory_files.end());
+  files->insert(files->end(), directory_files.begin(), directory_files.end());
+}
+
+// Returns the |percentile| of |values|, sorting them.
+double Percentile(std::vector<double>* values, double percentile) {
+  std::sort(values->begin(), values->end());
+  size_t index = static_cast<size_t>(percentile * (values->size() - 1) + 0.5);
+  return (*values)[index];
+}
+
+void PrintResults(const std::vector<SimulationResult>& results) {
+  if (FLAGS_per_file) {
+    printf("%-40s %10s %8s %8s %8s %10s %9s\n", "file", "duration_s",
+           "expand%", "preempt%", "accel%", "delay_ms", "max_delay");
+  }
+  double total_ms = 0;
+  double expand_ms = 0;
+  double preemptive_ms = 0;
+  double accelerate_ms = 0;
+  double delay_ms = 0;
+  std::vector<double> expand_rates;
+  std::vector<double> delays;
+  int failed = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const SimulationResult& result = results[i];
+    if (!result.ok) {
+      ++failed;
+      continue;
+    }
+    if (FLAGS_per_file) {
+      printf("%-40s %10.1f %8.2f %8.2f %8.2f %10.1f %9d\n",
+             result.file_name.c_str(), result.duration_ms / 1000.0,
+             100 * result.expand_rate, 100 * result.preemptive_rate,
+             100 * result.accelerate_rate, result.mean_delay_ms,
+             result.max_delay_ms);
+    }
+    total_ms += result.duration_ms;
+    expand_ms += result.expand_rate * result.duration_ms;
+    preemptive_ms += result.preemptive_rate * result.duration_ms;
+    accelerate_ms += result.accelerate_rate * result.duration_ms;
+    delay_ms += result.mean_delay_ms * result.duration_ms;
+    expand_rates.push_back(100 * result.expand_rate);
+    delays.push_back(result.mean_delay_ms);
+  }
+
+  printf("Simulated %d files, %.1f s of audio (%d failed).\n",
+         static_cast<int>(results.size()) - failed, total_ms / 1000, failed);
+  if (expand_rates.empty())
+    return;
+  // The means are weighted by duration, the percentiles are over files.
+  printf("Expand rate:     %.2f %% (median %.2f %%, 95th percentile %.2f %%)\n",
+         100 * expand_ms / total_ms, Percentile(&expand_rates, 0.5),
+         Percentile(&expand_rates, 0.95));
+  printf("Preemptive rate: %.2f %%\n", 100 * preemptive_ms / total_ms);
+  printf("Accelerate rate: %.2f %%\n", 100 * accelerate_ms / total_ms);
+  printf("Delay:           %.1f ms (median %.1f ms, 95th percentile %.1f ms)\n",
+         delay_ms / total_ms, Percentile(&delays, 0.5),
+         Percentile(&delays, 0.95));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  using webrtc::test::SimulationResult;
+
+  std::string program_name = argv[0];
+  std::string usage = "Tool for simulating NetEq over many RTP dump files in "
+      "parallel.\n"
+      "Run " + program_name + " --helpshort for usage.\n"
+      "Example usage:\n" + program_name +
+      " --workers=8 rtp_dumps/ extra.rtp\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc < 2) {
+    printf("%s", google::ProgramUsage());
+    return 0;
+  }
+
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i)
+    webrtc::test::AddFiles(argv[i], &files);
+  if (files.empty()) {
+    fprintf(stderr, "No files to simulate\n");
+    return 1;
+  }
+
+  // Each task writes its own result, so they need no locking.
+  std::vector<SimulationResult> results(files.size());
+  for (size_t i = 0; i < files.size(); ++i)
+    results[i].file_name = files[i];
+
+  webrtc::scoped_ptr<webrtc::ThreadPool> thread_pool(
+      webrtc::ThreadPool::Create("NetEqBatch", FLAGS_workers));
+  if (thread_pool) {
+    // The pool drops the tasks that have not run when it is deleted, so wait
+    // for all of them first.
+    webrtc::Atomic32 remaining(static_cast<int32_t>(results.size()));
+    webrtc::scoped_ptr<webrtc::EventWrapper> done(
+        webrtc::EventWrapper::Create());
+    for (size_t i = 0; i < results.size(); ++i) {
+      thread_pool->PostTask(new webrtc::test::SimulateFileTask(
+          &results[i], &remaining, done.get()));
+    }
+    done->Wait(WEBRTC_EVENT_INFINITE);
+    // Let the last task return from Set() before |done| goes away.
+    thread_pool.reset();
+  } else {
+    for (size_t i = 0; i < results.size(); ++i)
+      webrtc::test::SimulateFile(&results[i]);
+  }
+
+  webrtc::test::PrintResults(results);
+  return 0;
+}
@@ -77,6 +77,25 @@ public:
     // downsampling of audio contributing to the mixed audio.
     virtual int32_t SetMinimumMixingFrequency(Frequency freq) = 0;
 
+    // Bridge mode is intended for conference servers, where every participant
+    // needs a mix of all other participants. The |maxSpeakers| loudest
+    // participants are mixed, together with the anonymous participants.
+    // The general AudioFrame passed to
+    // AudioMixerOutputReceiver::NewMixedAudio() is the full mix, which is the
+    // mix for every participant not part of it.
+    // For each participant that is part of the mix, uniqueAudioFrames holds a
+    // frame with that participant's id_ which contains the mix without its own
+    // audio. The limiter is not used in bridge mode; the mixes saturate.
+    virtual int32_t SetBridgeMode(bool enable, size_t maxSpeakers) = 0;
+
+    // When enabled, the participants are asked for their audio at its own
+    // sampling frequency, by calling GetAudioFrame() with a sample_rate_hz_ of
+    // -1, which every participant must then support. The participants of each
+    // frequency are mixed together and every frequency is resampled once,
+    // instead of every participant resampling to the mixing frequency. Has no
+    // effect in bridge mode.
+    virtual int32_t SetNativeRateMixing(bool enable) = 0;
+
 protected:
     AudioConferenceMixer() {}
 };
@@ -8,6 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer_defines.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_conference_mixer_impl.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
@@ -66,6 +70,43 @@ void SetParticipantStatistics(ParticipantStatistics* stats,
     stats->level = 0;  // TODO(andrew): to what should this be set?
 }
 
+// Adds the samples of |frame| to |mix|, upmixing |frame| first if needed.
+void AccumulateFrame(AudioFrame* frame, int num_channels,
+                     std::vector<int32_t>* mix) {
+    if (frame->num_channels_ < num_channels) {
+        // We only support mono-to-stereo.
+        assert(num_channels == 2 && frame->num_channels_ == 1);
+        AudioFrameOperations::MonoToStereo(frame);
+    }
+    const size_t length = mix->size();
+    int32_t* mix_data = &(*mix)[0];
+    const int16_t* frame_data = frame->data_;
+    for (size_t i = 0; i < length; ++i)
+        mix_data[i] += frame_data[i];
+}
+
+// Writes |mix|, without the samples of |exclude| if not NULL, to |frame| with
+// saturation. The accumulated sum never overflows, so the mix minus one
+// participant is exact up to the final saturation.
+void WriteMix(const std::vector<int32_t>& mix, const AudioFrame* exclude,
+              AudioFrame* frame) {
+    const size_t length = mix.size();
+    const int32_t* mix_data = &mix[0];
+    int16_t* frame_data = frame->data_;
+    if (exclude) {
+        const int16_t* exclude_data = exclude->data_;
+        for (size_t i = 0; i < length; ++i) {
+            frame_data[i] = static_cast<int16_t>(std::min(32767, std::max(
+                -32768, mix_data[i] - exclude_data[i])));
+        }
+    } else {
+        for (size_t i = 0; i < length; ++i) {
+            frame_data[i] = static_cast<int16_t>(
+                std::min(32767, std::max(-32768, mix_data[i])));
+        }
+    }
+}
+
 }  // namespace
 
 MixerParticipant::MixerParticipant()
@@ -118,9 +159,10 @@ AudioConferenceMixer* AudioConferenceMixer::Create(int id) {
 
 AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
     : _scratchParticipantsToMixAmount(0),
-      _scratchMixedParticipants(),
+      _scratchMixedParticipants(kMaximumAmountOfMixedParticipants),
       _scratchVadPositiveParticipantsAmount(0),
-      _scratchVadPositiveParticipants(),
+      _scratchVadPositiveParticipants(kMaximumAmountOfMixedParticipants),
+      _resampledAudio(AudioFrame::kMaxDataSizeSamples),
       _id(id),
       _minimumMixingFreq(kLowestPossible),
       _mixReceiver(NULL),
@@ -135,6 +177,9 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
       _additionalParticipantList(),
       _numMixedParticipants(0),
       use_limiter_(true),
+      _bridgeMode(false),
+      _maxBridgeSpeakers(kMaximumAmountOfMixedParticipants),
+      _nativeRateMixing(false),
       _timeStamp(0),
       _timeScheduler(kProcessPeriodicityInMs),
       _mixedAudioLevel(),
@@ -187,6 +232,11 @@ bool AudioConferenceMixerImpl::Init() {
 }
 
 AudioConferenceMixerImpl::~AudioConferenceMixerImpl() {
+    for (ResamplerMap::iterator iter = _resamplers.begin();
+         iter != _resamplers.end();
+         ++iter) {
+        delete iter->second;
+    }
     MemoryPool<AudioFrame>::DeleteMemoryPool(_audioFramePool);
     assert(_audioFramePool == NULL);
 }
@@ -226,6 +276,7 @@ int32_t AudioConferenceMixerImpl::Process() {
     AudioFrameList rampOutList;
     AudioFrameList additionalFramesList;
     std::map<int, MixerParticipant*> mixedParticipantsMap;
+    bool bridgeMode = false;
     {
         CriticalSectionScoped cs(_cbCrit.get());
 
@@ -275,12 +326,22 @@ int32_t AudioConferenceMixerImpl::Process() {
             }
         }
 
-        UpdateToMix(&mixList, &rampOutList, &mixedParticipantsMap,
-                    remainingParticipantsAllowedToMix);
+        bridgeMode = _bridgeMode;
+        if (!bridgeMode) {
+            UpdateToMix(&mixList, &rampOutList, &mixedParticipantsMap,
+                        remainingParticipantsAllowedToMix);
 
-        GetAdditionalAudio(&additionalFramesList);
-        UpdateMixedStatus(mixedParticipantsMap);
-        _scratchParticipantsToMixAmount = mixedParticipantsMap.size();
+            GetAdditionalAudio(&additionalFramesList);
+            UpdateMixedStatus(mixedParticipantsMap);
+            _scratchParticipantsToMixAmount = mixedParticipantsMap.size();
+        }
+    }
+
+    if (bridgeMode) {
+        const int32_t retval = ProcessBridge();
+        CriticalSectionScoped cs(_crit.get());
+        _processCalls--;
+        return retval;
     }
 
     // Get an AudioFrame for mixing from the memory pool.
@@ -320,6 +381,7 @@ int32_t AudioConferenceMixerImpl::Process() {
         MixFromList(*mixedAudio, &mixList);
         MixAnonomouslyFromList(*mixedAudio, &additionalFramesList);
         MixAnonomouslyFromList(*mixedAudio, &rampOutList);
+        MixRateGroups(*mixedAudio);
 
         if(mixedAudio->samples_per_channel_ == 0) {
             // Nothing was mixed, set the audio samples to silence.
@@ -359,12 +421,12 @@ int32_t AudioConferenceMixerImpl::Process() {
             timeForMixerCallback) {
             _mixerStatusCallback->MixedParticipants(
                 _id,
-                _scratchMixedParticipants,
+                &_scratchMixedParticipants[0],
                 static_cast<uint32_t>(_scratchParticipantsToMixAmount));
 
             _mixerStatusCallback->VADPositiveParticipants(
                 _id,
-                _scratchVadPositiveParticipants,
+                &_scratchVadPositiveParticipants[0],
                 _scratchVadPositiveParticipantsAmount);
             _mixerStatusCallback->MixedAudioLevel(_id,audioLevel);
         }
@@ -586,6 +648,27 @@ int32_t AudioConferenceMixerImpl::SetMinimumMixingFrequency(
     }
 }
 
+int32_t AudioConferenceMixerImpl::SetBridgeMode(bool enable,
+                                                size_t maxSpeakers) {
+    if (enable && maxSpeakers == 0) {
+        WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                     "SetBridgeMode needs at least one speaker");
+        return -1;
+    }
+    CriticalSectionScoped cs(_cbCrit.get());
+    _bridgeMode = enable;
+    if (enable) {
+        _maxBridgeSpeakers = maxSpeakers;
+    }
+    return 0;
+}
+
+int32_t AudioConferenceMixerImpl::SetNativeRateMixing(bool enable) {
+    CriticalSectionScoped cs(_cbCrit.get());
+    _nativeRateMixing = enable;
+    return 0;
+}
+
 // Check all AudioFrames that are to be mixed. The highest sampling frequency
 // found is the lowest that can be used without losing information.
 int32_t AudioConferenceMixerImpl::GetLowestMixingFrequency() {
@@ -652,7 +735,7 @@ void AudioConferenceMixerImpl::UpdateToMix(
             assert(false);
             return;
         }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
+        audioFrame->sample_rate_hz_ = _nativeRateMixing ? -1 : _outputFrequency;
 
         if((*participant)->GetAudioFrame(_id,*audioFrame) != 0) {
             WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
@@ -829,7 +912,7 @@ void AudioConferenceMixerImpl::GetAdditionalAudio(
             assert(false);
             return;
         }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
+        audioFrame->sample_rate_hz_ = _nativeRateMixing ? -1 : _outputFrequency;
         if((*participant)->GetAudioFrame(_id, *audioFrame) != 0) {
             WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
                          "failed to GetAudioFrame() from participant");
@@ -980,7 +1063,7 @@ int32_t AudioConferenceMixerImpl::MixFromList(
             assert(false);
             position = 0;
         }
-        MixFrames(&mixedAudio, (*iter), use_limiter_);
+        MixFrame(mixedAudio, *iter);
 
         SetParticipantStatistics(&_scratchMixedParticipants[position],
                                  **iter);
@@ -1003,11 +1086,71 @@ int32_t AudioConferenceMixerImpl::MixAnonomouslyFromList(
     for (AudioFrameList::const_iterator iter = audioFrameList->begin();
          iter != audioFrameList->end();
          ++iter) {
-        MixFrames(&mixedAudio, *iter, use_limiter_);
+        MixFrame(mixedAudio, *iter);
     }
     return 0;
 }
 
+void AudioConferenceMixerImpl::MixFrame(AudioFrame& mixedAudio,
+                                        AudioFrame* audioFrame) {
+    if (audioFrame->sample_rate_hz_ == mixedAudio.sample_rate_hz_) {
+        MixFrames(&mixedAudio, audioFrame, use_limiter_);
+        return;
+    }
+    AudioFrame*& groupAudio = _rateGroups[audioFrame->sample_rate_hz_];
+    if (groupAudio == NULL) {
+        if (_audioFramePool->PopMemory(groupAudio) == -1) {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            _rateGroups.erase(audioFrame->sample_rate_hz_);
+            return;
+        }
+        groupAudio->UpdateFrame(-1, mixedAudio.timestamp_, NULL, 0,
+                                audioFrame->sample_rate_hz_,
+                                AudioFrame::kNormalSpeech,
+                                AudioFrame::kVadPassive,
+                                mixedAudio.num_channels_);
+    }
+    MixFrames(groupAudio, audioFrame, use_limiter_);
+}
+
+void AudioConferenceMixerImpl::MixRateGroups(AudioFrame& mixedAudio) {
+    for (RateGroupMap::iterator iter = _rateGroups.begin();
+         iter != _rateGroups.end();
+         ++iter) {
+        AudioFrame* groupAudio = iter->second;
+        PushResampler<int16_t>*& resampler = _resamplers[iter->first];
+        if (resampler == NULL) {
+            resampler = new PushResampler<int16_t>();
+        }
+        int length = -1;
+        if (resampler->InitializeIfNeeded(groupAudio->sample_rate_hz_,
+                                          _outputFrequency,
+                                          groupAudio->num_channels_) == 0) {
+            length = resampler->Resample(
+                groupAudio->data_,
+                groupAudio->samples_per_channel_ * groupAudio->num_channels_,
+                &_resampledAudio[0],
+                static_cast<int>(_resampledAudio.size()));
+        }
+        if (length < 0) {
+            WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                         "failed to resample %d Hz to %d Hz", iter->first,
+                         _outputFrequency);
+        } else {
+            memcpy(groupAudio->data_, &_resampledAudio[0],
+                   sizeof(int16_t) * length);
+            groupAudio->samples_per_channel_ =
+                length / groupAudio->num_channels_;
+            groupAudio->sample_rate_hz_ = _outputFrequency;
+            mixedAudio += *groupAudio;
+        }
+        _audioFramePool->PushMemory(groupAudio);
+    }
+    _rateGroups.clear();
+}
+
 bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio) {
     if (!use_limiter_) {
       return true;
@@ -1036,4 +1179,234 @@ bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame& mixedAudio) {
     }
     return true;
 }
+
+bool AudioConferenceMixerImpl::IsLouder(const BridgeSource& a,
+                                        const BridgeSource& b) {
+    const bool aActive = a.audioFrame->vad_activity_ == AudioFrame::kVadActive;
+    const bool bActive = b.audioFrame->vad_activity_ == AudioFrame::kVadActive;
+    if (aActive != bActive) {
+        return aActive;
+    }
+    return a.audioFrame->energy_ > b.audioFrame->energy_;
+}
+
+void AudioConferenceMixerImpl::UpdateBridgeSources(size_t* numSpeakers) {
+    WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
+                 "UpdateBridgeSources(numSpeakers)");
+    _bridgeSources.clear();
+    for (MixerParticipantList::iterator participant = _participantList.begin();
+         participant != _participantList.end();
+         ++participant) {
+        AudioFrame* audioFrame = NULL;
+        if(_audioFramePool->PopMemory(audioFrame) == -1) {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            break;
+        }
+        audioFrame->sample_rate_hz_ = _outputFrequency;
+        if((*participant)->GetAudioFrame(_id, *audioFrame) != 0) {
+            WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
+                         "failed to GetAudioFrame() from participant");
+            _audioFramePool->PushMemory(audioFrame);
+            continue;
+        }
+        if(audioFrame->samples_per_channel_ != _sampleSize) {
+            // Empty or mismatching frame. Don't use it.
+            _audioFramePool->PushMemory(audioFrame);
+            (*participant)->_mixHistory->SetIsMixed(false);
+            continue;
+        }
+        CalculateEnergy(*audioFrame);
+        BridgeSource source = { *participant, audioFrame };
+        _bridgeSources.push_back(source);
+    }
+
+    // Only the loudest participants are needed, in no particular order.
+    *numSpeakers = std::min(_maxBridgeSpeakers, _bridgeSources.size());
+    std::nth_element(_bridgeSources.begin(),
+                     _bridgeSources.begin() + *numSpeakers,
+                     _bridgeSources.end(),
+                     IsLouder);
+
+    size_t numSources = *numSpeakers;
+    for (size_t i = 0; i < _bridgeSources.size(); ++i) {
+        BridgeSource& source = _bridgeSources[i];
+        bool wasMixed = false;
+        source.participant->_mixHistory->WasMixed(wasMixed);
+        if (i < *numSpeakers) {
+            if (!wasMixed) {
+                RampIn(*source.audioFrame);
+            }
+            source.participant->_mixHistory->SetIsMixed(true);
+        } else {
+            source.participant->_mixHistory->SetIsMixed(false);
+            if (wasMixed) {
+                // Keep it in the mix for one more frame while ramping out.
+                RampOut(*source.audioFrame);
+                _bridgeSources[numSources++] = source;
+            } else {
+                _audioFramePool->PushMemory(source.audioFrame);
+            }
+        }
+    }
+    _bridgeSources.resize(numSources);
+}
+
+int32_t AudioConferenceMixerImpl::ProcessBridge() {
+    AudioFrameList additionalFramesList;
+    size_t numSpeakers = 0;
+    {
+        CriticalSectionScoped cs(_cbCrit.get());
+        UpdateBridgeSources(&numSpeakers);
+        GetAdditionalAudio(&additionalFramesList);
+    }
+    // Anonymous frames not matching the mix length are not mixed.
+    for (AudioFrameList::iterator iter = additionalFramesList.begin();
+         iter != additionalFramesList.end();) {
+        if ((*iter)->samples_per_channel_ != _sampleSize) {
+            _audioFramePool->PushMemory(*iter);
+            iter = additionalFramesList.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    AudioFrame* mixedAudio = NULL;
+    if(_audioFramePool->PopMemory(mixedAudio) == -1) {
+        WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                     "failed PopMemory() call");
+        assert(false);
+        return -1;
+    }
+
+    bool timeForMixerCallback = false;
+    int32_t audioLevel = 0;
+    {
+        CriticalSectionScoped cs(_crit.get());
+
+        int numMixedChannels = MaxNumChannels(&additionalFramesList);
+        for (size_t i = 0; i < _bridgeSources.size(); ++i) {
+            numMixedChannels = std::max(
+                numMixedChannels, _bridgeSources[i].audioFrame->num_channels_);
+        }
+
+        // Sum all sources once. Every mix is derived from the sum.
+        _bridgeMix.assign(_sampleSize * numMixedChannels, 0);
+        for (size_t i = 0; i < _bridgeSources.size(); ++i) {
+            AccumulateFrame(_bridgeSources[i].audioFrame, numMixedChannels,
+                            &_bridgeMix);
+        }
+        for (AudioFrameList::iterator iter = additionalFramesList.begin();
+             iter != additionalFramesList.end();
+             ++iter) {
+            AccumulateFrame(*iter, numMixedChannels, &_bridgeMix);
+        }
+
+        mixedAudio->UpdateFrame(-1, _timeStamp, NULL, 0, _outputFrequency,
+                                AudioFrame::kNormalSpeech,
+                                AudioFrame::kVadPassive, numMixedChannels);
+        mixedAudio->samples_per_channel_ = _sampleSize;
+        WriteMix(_bridgeMix, NULL, mixedAudio);
+
+        // Everyone contributing to the mix gets the mix without itself. The
+        // samples of those frames are all written by WriteMix, so only the
+        // headers are copied from |mixedAudio|.
+        _bridgeUniqueAudio.clear();
+        for (size_t i = 0; i < _bridgeSources.size() +
+                 additionalFramesList.size(); ++i) {
+            AudioFrame* uniqueAudio = NULL;
+            if(_audioFramePool->PopMemory(uniqueAudio) == -1) {
+                WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                             "failed PopMemory() call");
+                assert(false);
+                break;
+            }
+            _bridgeUniqueAudio.push_back(uniqueAudio);
+        }
+        size_t unique = 0;
+        for (size_t i = 0; i < _bridgeSources.size() &&
+                 unique < _bridgeUniqueAudio.size(); ++i, ++unique) {
+            AudioFrame* uniqueAudio = _bridgeUniqueAudio[unique];
+            uniqueAudio->CopyHeaderFrom(*mixedAudio);
+            uniqueAudio->id_ = _bridgeSources[i].audioFrame->id_;
+            WriteMix(_bridgeMix, _bridgeSources[i].audioFrame, uniqueAudio);
+        }
+        for (AudioFrameList::iterator iter = additionalFramesList.begin();
+             iter != additionalFramesList.end() &&
+                 unique < _bridgeUniqueAudio.size(); ++iter, ++unique) {
+            AudioFrame* uniqueAudio = _bridgeUniqueAudio[unique];
+            uniqueAudio->CopyHeaderFrom(*mixedAudio);
+            uniqueAudio->id_ = (*iter)->id_;
+            WriteMix(_bridgeMix, *iter, uniqueAudio);
+        }
+        _bridgeUniqueFrames.assign(_bridgeUniqueAudio.begin(),
+                                   _bridgeUniqueAudio.end());
+
+        _timeStamp += _sampleSize;
+
+        _mixedAudioLevel.ComputeLevel(mixedAudio->data_, _sampleSize);
+        audioLevel = _mixedAudioLevel.GetLevel();
+
+        if(_mixerStatusCb) {
+            if (_scratchMixedParticipants.size() < numSpeakers) {
+                _scratchMixedParticipants.resize(numSpeakers);
+                _scratchVadPositiveParticipants.resize(numSpeakers);
+            }
+            _scratchParticipantsToMixAmount = numSpeakers;
+            _scratchVadPositiveParticipantsAmount = 0;
+            for (size_t i = 0; i < numSpeakers; ++i) {
+                const AudioFrame& frame = *_bridgeSources[i].audioFrame;
+                SetParticipantStatistics(&_scratchMixedParticipants[i], frame);
+                if (frame.vad_activity_ == AudioFrame::kVadActive) {
+                    SetParticipantStatistics(&_scratchVadPositiveParticipants[
+                        _scratchVadPositiveParticipantsAmount++], frame);
+                }
+            }
+            if(_amountOf10MsUntilNextCallback-- == 0) {
+                _amountOf10MsUntilNextCallback = _amountOf10MsBetweenCallbacks;
+                timeForMixerCallback = true;
+            }
+        }
+    }
+
+    {
+        CriticalSectionScoped cs(_cbCrit.get());
+        if(_mixReceiver != NULL) {
+            _mixReceiver->NewMixedAudio(
+                _id,
+                *mixedAudio,
+                _bridgeUniqueFrames.empty() ? NULL : &_bridgeUniqueFrames[0],
+                static_cast<uint32_t>(_bridgeUniqueFrames.size()));
+        }
+
+        if((_mixerStatusCallback != NULL) &&
+            timeForMixerCallback) {
+            _mixerStatusCallback->MixedParticipants(
+                _id,
+                &_scratchMixedParticipants[0],
+                static_cast<uint32_t>(_scratchParticipantsToMixAmount));
+
+            _mixerStatusCallback->VADPositiveParticipants(
+                _id,
+                &_scratchVadPositiveParticipants[0],
+                _scratchVadPositiveParticipantsAmount);
+            _mixerStatusCallback->MixedAudioLevel(_id,audioLevel);
+        }
+    }
+
+    // Reclaim all outstanding memory.
+    _audioFramePool->PushMemory(mixedAudio);
+    for (size_t i = 0; i < _bridgeUniqueAudio.size(); ++i) {
+        _audioFramePool->PushMemory(_bridgeUniqueAudio[i]);
+    }
+    _bridgeUniqueAudio.clear();
+    _bridgeUniqueFrames.clear();
+    for (size_t i = 0; i < _bridgeSources.size(); ++i) {
+        _audioFramePool->PushMemory(_bridgeSources[i].audioFrame);
+    }
+    _bridgeSources.clear();
+    ClearAudioFrameList(&additionalFramesList);
+    return 0;
+}
 }  // namespace webrtc
@@ -13,7 +13,9 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/engine_configurations.h"
 #include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer.h"
 #include "webrtc/modules/audio_conference_mixer/source/level_indicator.h"
@@ -85,9 +87,23 @@ public:
         MixerParticipant& participant, const bool mixable);
     virtual int32_t AnonymousMixabilityStatus(
         MixerParticipant& participant, bool& mixable);
+    virtual int32_t SetBridgeMode(bool enable, size_t maxSpeakers);
+    virtual int32_t SetNativeRateMixing(bool enable);
 private:
     enum{DEFAULT_AUDIO_FRAME_POOLSIZE = 50};
 
+    typedef std::map<int, AudioFrame*> RateGroupMap;
+    typedef std::map<int, PushResampler<int16_t>*> ResamplerMap;
+
+    struct BridgeSource
+    {
+        MixerParticipant* participant;
+        AudioFrame* audioFrame;
+    };
+
+    // Orders voice active sources first, then by decreasing energy.
+    static bool IsLouder(const BridgeSource& a, const BridgeSource& b);
+
     // Set/get mix frequency
     int32_t SetOutputFrequency(const Frequency frequency);
     Frequency OutputFrequency() const;
@@ -152,17 +168,42 @@ private:
     int32_t MixAnonomouslyFromList(AudioFrame& mixedAudio,
                                    const AudioFrameList* audioFrameList);
 
+    // Mixes |audioFrame| into |mixedAudio|, or into the rate group of its
+    // sampling frequency if that isn't the mixing frequency.
+    void MixFrame(AudioFrame& mixedAudio, AudioFrame* audioFrame);
+    // Resamples every rate group to the mixing frequency, mixes it into
+    // |mixedAudio| and reclaims it.
+    void MixRateGroups(AudioFrame& mixedAudio);
+
     bool LimitMixedAudio(AudioFrame& mixedAudio);
 
+    // Bridge mode counterpart of the mixing done in Process(). Fetches audio
+    // from all participants, mixes the loudest ones once and derives the mix
+    // of every mixed participant by subtracting its own audio.
+    int32_t ProcessBridge();
+
+    // Fills _bridgeSources with the frames to mix in bridge mode, the
+    // |numSpeakers| selected speakers first, followed by the ones being
+    // ramped out.
+    void UpdateBridgeSources(size_t* numSpeakers);
+
     // Scratch memory
     // Note that the scratch memory may only be touched in the scope of
     // Process().
     size_t         _scratchParticipantsToMixAmount;
-    ParticipantStatistics  _scratchMixedParticipants[
-        kMaximumAmountOfMixedParticipants];
+    std::vector<ParticipantStatistics> _scratchMixedParticipants;
     uint32_t         _scratchVadPositiveParticipantsAmount;
-    ParticipantStatistics  _scratchVadPositiveParticipants[
-        kMaximumAmountOfMixedParticipants];
+    std::vector<ParticipantStatistics> _scratchVadPositiveParticipants;
+    std::vector<BridgeSource> _bridgeSources;
+    std::vector<int32_t> _bridgeMix;
+    // The frames with the mix of each mixed participant, and the same frames
+    // as passed to NewMixedAudio().
+    std::vector<AudioFrame*> _bridgeUniqueAudio;
+    std::vector<const AudioFrame*> _bridgeUniqueFrames;
+    // The mixes of the frames which aren't at the mixing frequency, by
+    // frequency.
+    RateGroupMap _rateGroups;
+    std::vector<int16_t> _resampledAudio;
 
     scoped_ptr<CriticalSectionWrapper> _crit;
     scoped_ptr<CriticalSectionWrapper> _cbCrit;
@@ -196,6 +237,16 @@ private:
     // mixing.
     bool use_limiter_;
 
+    // Bridge mode settings, protected by _cbCrit.
+    bool _bridgeMode;
+    size_t _maxBridgeSpeakers;
+
+    // Protected by _cbCrit.
+    bool _nativeRateMixing;
+    // The resamplers of the rate groups, by frequency. Kept between the mix
+    // iterations since they carry the filter state of the stream.
+    ResamplerMap _resamplers;
+
     uint32_t _timeStamp;
 
     // Metronome class.
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer.h"
+#include "webrtc/modules/audio_conference_mixer/interface/audio_conference_mixer_defines.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const int kSamplesPerChannel = kSampleRateHz / 100;
+
+// Delivers 10 ms mono frames with all samples set to |value|.
+class ConstantParticipant : public MixerParticipant {
+ public:
+  ConstantParticipant(int id, int16_t value) : id_(id), value_(value) {}
+  virtual ~ConstantParticipant() {}
+
+  virtual int32_t GetAudioFrame(const int32_t id, AudioFrame& audio_frame) {
+    audio_frame.UpdateFrame(id_, 0, NULL, kSamplesPerChannel, kSampleRateHz,
+                            AudioFrame::kNormalSpeech, AudioFrame::kVadActive,
+                            1);
+    for (int i = 0; i < kSamplesPerChannel; ++i)
+      audio_frame.data_[i] = value_;
+    return 0;
+  }
+
+  virtual int32_t NeededFrequency(const int32_t id) { return kSampleRateHz; }
+
+  void set_value(int16_t value) { value_ = value; }
+
+ private:
+  const int id_;
+  int16_t value_;
+};
+
+// Keeps the first sample of the mixes of the last Process() call, by id. The
+// general mix has id -1. The participants' samples are constant, so outside
+// of ramps that is the value of the whole mix.
+class MixRecorder : public AudioMixerOutputReceiver {
+ public:
+  virtual ~MixRecorder() {}
+
+  virtual void NewMixedAudio(const int32_t id,
+                             const AudioFrame& general_audio_frame,
+                             const AudioFrame** unique_audio_frames,
+                             const uint32_t size) {
+    mixes_.clear();
+    mixes_[-1] = general_audio_frame.data_[0];
+    for (uint32_t i = 0; i < size; ++i) {
+      mixes_[unique_audio_frames[i]->id_] = unique_audio_frames[i]->data_[0];
+    }
+  }
+
+  const std::map<int, int16_t>& mixes() const { return mixes_; }
+
+ private:
+  std::map<int, int16_t> mixes_;
+};
+
+}  // namespace
+
+class AudioConferenceMixerBridgeTest : public ::testing::Test {
+ protected:
+  AudioConferenceMixerBridgeTest()
+      : mixer_(AudioConferenceMixer::Create(0)),
+        quiet_(1, 100),
+        normal_(2, 200),
+        loud_(3, 400) {}
+
+  virtual void SetUp() {
+    ASSERT_EQ(0, mixer_->RegisterMixedStreamCallback(recorder_));
+    ASSERT_EQ(0, mixer_->SetMixabilityStatus(quiet_, true));
+    ASSERT_EQ(0, mixer_->SetMixabilityStatus(normal_, true));
+    ASSERT_EQ(0, mixer_->SetMixabilityStatus(loud_, true));
+  }
+
+  virtual void TearDown() {
+    EXPECT_EQ(0, mixer_->SetMixabilityStatus(quiet_, false));
+    EXPECT_EQ(0, mixer_->SetMixabilityStatus(normal_, false));
+    EXPECT_EQ(0, mixer_->SetMixabilityStatus(loud_, false));
+    EXPECT_EQ(0, mixer_->UnRegisterMixedStreamCallback());
+  }
+
+  scoped_ptr<AudioConferenceMixer> mixer_;
+  MixRecorder recorder_;
+  ConstantParticipant quiet_;
+  ConstantParticipant normal_;
+  ConstantParticipant loud_;
+};
+
+TEST_F(AudioConferenceMixerBridgeTest, NeedsAtLeastOneSpeaker) {
+  EXPECT_EQ(-1, mixer_->SetBridgeMode(true, 0));
+  EXPECT_EQ(0, mixer_->SetBridgeMode(false, 0));
+}
+
+TEST_F(AudioConferenceMixerBridgeTest, MixesAllOthersForEachSpeaker) {
+  ASSERT_EQ(0, mixer_->SetBridgeMode(true, 2));
+  // The speakers are ramped in by the first mix.
+  ASSERT_EQ(0, mixer_->Process());
+  ASSERT_EQ(0, mixer_->Process());
+
+  const std::map<int, int16_t>& mixes = recorder_.mixes();
+  ASSERT_EQ(3u, mixes.size());
+  EXPECT_EQ(600, mixes.find(-1)->second);
+  ASSERT_TRUE(mixes.find(2) != mixes.end());
+  EXPECT_EQ(400, mixes.find(2)->second);
+  ASSERT_TRUE(mixes.find(3) != mixes.end());
+  EXPECT_EQ(200, mixes.find(3)->second);
+}
+
+TEST_F(AudioConferenceMixerBridgeTest, RampsOutReplacedSpeaker) {
+  ASSERT_EQ(0, mixer_->SetBridgeMode(true, 2));
+  ASSERT_EQ(0, mixer_->Process());
+  ASSERT_EQ(0, mixer_->Process());
+
+  // |normal_| is replaced by |quiet_|, but stays in the mixes while it is
+  // ramped out.
+  quiet_.set_value(1000);
+  ASSERT_EQ(0, mixer_->Process());
+  EXPECT_EQ(4u, recorder_.mixes().size());
+  EXPECT_TRUE(recorder_.mixes().find(2) != recorder_.mixes().end());
+
+  ASSERT_EQ(0, mixer_->Process());
+  const std::map<int, int16_t>& mixes = recorder_.mixes();
+  ASSERT_EQ(3u, mixes.size());
+  EXPECT_EQ(1400, mixes.find(-1)->second);
+  ASSERT_TRUE(mixes.find(1) != mixes.end());
+  EXPECT_EQ(400, mixes.find(1)->second);
+  ASSERT_TRUE(mixes.find(3) != mixes.end());
+  EXPECT_EQ(1000, mixes.find(3)->second);
+}
+
+}  // namespace webrtc
@@ -49,6 +49,13 @@ void CalculateEnergy(AudioFrame& audioFrame)
         audioFrame.energy_ += audioFrame.data_[position] *
                               audioFrame.data_[position];
     }
+    // Scale to the energy of 10 ms at 8 kHz, to compare frames of any
+    // sampling frequency.
+    const int scale = audioFrame.samples_per_channel_ / 80;
+    if(scale > 1)
+    {
+        audioFrame.energy_ /= scale;
+    }
 }
 
 void RampIn(AudioFrame& audioFrame)
@@ -14,7 +14,8 @@
 namespace webrtc {
 class AudioFrame;
 
-// Updates the audioFrame's energy (based on its samples).
+// Updates the audioFrame's energy (based on its samples), scaled such that
+// frames of different sampling frequencies compare.
 void CalculateEnergy(AudioFrame& audioFrame);
 
 // Apply linear step function that ramps in/out the audio samples in audioFrame
@@ -19,11 +19,45 @@
 #include "webrtc/system_wrappers/interface/logging.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
+#if defined(WEBRTC_LOCK_PROFILING)
+#include "webrtc/base/lockprofiler.h"
+#endif
+
 namespace webrtc {
 
 static const int kHighDelayThresholdMs = 300;
 static const int kLogHighDelayIntervalFrames = 500;  // 5 seconds.
 
+// A sample format packed in one word: the number of channels, the bytes per
+// sample and the selected channel.
+static int32_t PackFormat(uint8_t channels,
+                          uint8_t bytesPerSample,
+                          AudioDeviceModule::ChannelType channel)
+{
+    return (channels << 16) | (bytesPerSample << 8) | channel;
+}
+
+static void UnpackFormat(int32_t format,
+                         uint8_t* channels,
+                         uint8_t* bytesPerSample,
+                         AudioDeviceModule::ChannelType* channel)
+{
+    *channels = static_cast<uint8_t>(format >> 16);
+    *bytesPerSample = static_cast<uint8_t>(format >> 8);
+    *channel = static_cast<AudioDeviceModule::ChannelType>(format & 0xff);
+}
+
+// Atomic32 has no store. The writers hold _critSect, so the exchange succeeds
+// the first time.
+static void StoreFormat(Atomic32* format, int32_t value)
+{
+    int32_t oldValue;
+    do
+    {
+        oldValue = format->Value();
+    } while (!format->CompareExchange(value, oldValue));
+}
+
 // ----------------------------------------------------------------------------
 //  ctor
 // ----------------------------------------------------------------------------
@@ -40,12 +74,16 @@ AudioDeviceBuffer::AudioDeviceBuffer() :
     _recChannel(AudioDeviceModule::kChannelBoth),
     _recBytesPerSample(0),
     _playBytesPerSample(0),
+    _recFormat(PackFormat(0, 0, AudioDeviceModule::kChannelBoth)),
+    _playFormat(PackFormat(0, 0, AudioDeviceModule::kChannelBoth)),
+    _recBufferBytesPerSample(0),
+    _recBufferChannels(0),
     _recSamples(0),
     _recSize(0),
     _playSamples(0),
     _playSize(0),
-    _recFile(*FileWrapper::Create()),
-    _playFile(*FileWrapper::Create()),
+    _recFile(kMaxBufferSizeBytes),
+    _playFile(kMaxBufferSizeBytes),
     _currentMicLevel(0),
     _newMicLevel(0),
     _typingStatus(false),
@@ -67,17 +105,8 @@ AudioDeviceBuffer::AudioDeviceBuffer() :
 AudioDeviceBuffer::~AudioDeviceBuffer()
 {
     WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, _id, "%s destroyed", __FUNCTION__);
-    {
-        CriticalSectionScoped lock(&_critSect);
-
-        _recFile.Flush();
-        _recFile.CloseFile();
-        delete &_recFile;
-
-        _playFile.Flush();
-        _playFile.CloseFile();
-        delete &_playFile;
-    }
+    _recFile.Stop();
+    _playFile.Stop();
 
     delete &_critSect;
     delete &_critSectCb;
@@ -180,6 +209,8 @@ int32_t AudioDeviceBuffer::SetRecordingChannels(uint8_t channels)
     CriticalSectionScoped lock(&_critSect);
     _recChannels = channels;
     _recBytesPerSample = 2*channels;  // 16 bits per sample in mono, 32 bits in stereo
+    StoreFormat(&_recFormat,
+                PackFormat(_recChannels, _recBytesPerSample, _recChannel));
     return 0;
 }
 
@@ -195,6 +226,9 @@ int32_t AudioDeviceBuffer::SetPlayoutChannels(uint8_t channels)
     _playChannels = channels;
     // 16 bits per sample in mono, 32 bits in stereo
     _playBytesPerSample = 2*channels;
+    StoreFormat(&_playFormat,
+                PackFormat(_playChannels, _playBytesPerSample,
+                           AudioDeviceModule::kChannelBoth));
     return 0;
 }
 
@@ -229,6 +263,8 @@ int32_t AudioDeviceBuffer::SetRecordingChannel(const AudioDeviceModule::ChannelT
         _recBytesPerSample = 2;
     }
     _recChannel = channel;
+    StoreFormat(&_recFormat,
+                PackFormat(_recChannels, _recBytesPerSample, _recChannel));
 
     return 0;
 }
@@ -316,12 +352,7 @@ int32_t AudioDeviceBuffer::StartInputFileRecording(
 {
     WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, _id, "%s", __FUNCTION__);
 
-    CriticalSectionScoped lock(&_critSect);
-
-    _recFile.Flush();
-    _recFile.CloseFile();
-
-    return (_recFile.OpenFile(fileName, false, false, false));
+    return _recFile.Start(fileName);
 }
 
 // ----------------------------------------------------------------------------
@@ -332,12 +363,7 @@ int32_t AudioDeviceBuffer::StopInputFileRecording()
 {
     WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, _id, "%s", __FUNCTION__);
 
-    CriticalSectionScoped lock(&_critSect);
-
-    _recFile.Flush();
-    _recFile.CloseFile();
-
-    return 0;
+    return _recFile.Stop();
 }
 
 // ----------------------------------------------------------------------------
@@ -349,12 +375,7 @@ int32_t AudioDeviceBuffer::StartOutputFileRecording(
 {
     WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, _id, "%s", __FUNCTION__);
 
-    CriticalSectionScoped lock(&_critSect);
-
-    _playFile.Flush();
-    _playFile.CloseFile();
-
-    return (_playFile.OpenFile(fileName, false, false, false));
+    return _playFile.Start(fileName);
 }
 
 // ----------------------------------------------------------------------------
@@ -365,12 +386,7 @@ int32_t AudioDeviceBuffer::StopOutputFileRecording()
 {
     WEBRTC_TRACE(kTraceMemory, kTraceAudioDevice, _id, "%s", __FUNCTION__);
 
-    CriticalSectionScoped lock(&_critSect);
-
-    _playFile.Flush();
-    _playFile.CloseFile();
-
-    return 0;
+    return _playFile.Stop();
 }
 
 // ----------------------------------------------------------------------------
@@ -386,21 +402,32 @@ int32_t AudioDeviceBuffer::StopOutputFileRecording()
 //
 //  16-bit,48kHz mono,  10ms => nSamples=480 => _recSize=2*480=960 bytes
 //  16-bit,48kHz stereo,10ms => nSamples=480 => _recSize=4*480=1920 bytes
+//
+//  Runs on the real-time recording thread, which takes no lock shared with
+//  the API threads. SetRecordingChannel() may change the format during the
+//  recording, so it is read once, from one word.
 // ----------------------------------------------------------------------------
 
 int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
                                              uint32_t nSamples)
 {
-    CriticalSectionScoped lock(&_critSect);
-
-    if (_recBytesPerSample == 0)
+    uint8_t recChannels = 0;
+    uint8_t recBytesPerSample = 0;
+    AudioDeviceModule::ChannelType recChannel =
+        AudioDeviceModule::kChannelBoth;
+    UnpackFormat(_recFormat.Value(), &recChannels, &recBytesPerSample,
+                 &recChannel);
+    _recBufferChannels = recChannels;
+    _recBufferBytesPerSample = recBytesPerSample;
+
+    if (recBytesPerSample == 0)
     {
         assert(false);
         return -1;
     }
 
     _recSamples = nSamples;
-    _recSize = _recBytesPerSample*nSamples; // {2,4}*nSamples
+    _recSize = recBytesPerSample*nSamples; // {2,4}*nSamples
     if (_recSize > kMaxBufferSizeBytes)
     {
         assert(false);
@@ -413,7 +440,7 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
         return -1;
     }
 
-    if (_recChannel == AudioDeviceModule::kChannelBoth)
+    if (recChannel == AudioDeviceModule::kChannelBoth)
     {
         // (default) copy the complete input buffer to the local buffer
         memcpy(&_recBuffer[0], audioBuffer, _recSize);
@@ -423,7 +450,7 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
         int16_t* ptr16In = (int16_t*)audioBuffer;
         int16_t* ptr16Out = (int16_t*)&_recBuffer[0];
 
-        if (AudioDeviceModule::kChannelRight == _recChannel)
+        if (AudioDeviceModule::kChannelRight == recChannel)
         {
             ptr16In++;
         }
@@ -438,11 +465,8 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
         }
     }
 
-    if (_recFile.Open())
-    {
-        // write to binary file in mono or stereo (interleaved)
-        _recFile.Write(&_recBuffer[0], _recSize);
-    }
+    // write to binary file in mono or stereo (interleaved)
+    _recFile.Write(&_recBuffer[0], _recSize);
 
     return 0;
 }
@@ -453,13 +477,17 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
 
 int32_t AudioDeviceBuffer::DeliverRecordedData()
 {
+#if defined(WEBRTC_LOCK_PROFILING)
+    // Report the allocations made by the audio callback.
+    rtc::ScopedRealTimeThread real_time_thread;
+#endif
     CriticalSectionScoped lock(&_critSectCb);
 
     // Ensure that user has initialized all essential members
     if ((_recSampleRate == 0)     ||
         (_recSamples == 0)        ||
-        (_recBytesPerSample == 0) ||
-        (_recChannels == 0))
+        (_recBufferBytesPerSample == 0) ||
+        (_recBufferChannels == 0))
     {
         assert(false);
         return -1;
@@ -475,16 +503,17 @@ int32_t AudioDeviceBuffer::DeliverRecordedData()
     uint32_t newMicLevel(0);
     uint32_t totalDelayMS = _playDelayMS +_recDelayMS;
 
-    res = _ptrCbAudioTransport->RecordedDataIsAvailable(&_recBuffer[0],
-                                                        _recSamples,
-                                                        _recBytesPerSample,
-                                                        _recChannels,
-                                                        _recSampleRate,
-                                                        totalDelayMS,
-                                                        _clockDrift,
-                                                        _currentMicLevel,
-                                                        _typingStatus,
-                                                        newMicLevel);
+    res = _ptrCbAudioTransport->RecordedDataIsAvailable(
+        &_recBuffer[0],
+        _recSamples,
+        _recBufferBytesPerSample,
+        _recBufferChannels,
+        _recSampleRate,
+        totalDelayMS,
+        _clockDrift,
+        _currentMicLevel,
+        _typingStatus,
+        newMicLevel);
     if (res != -1)
     {
         _newMicLevel = newMicLevel;
@@ -499,17 +528,22 @@ int32_t AudioDeviceBuffer::DeliverRecordedData()
 
 int32_t AudioDeviceBuffer::RequestPlayoutData(uint32_t nSamples)
 {
+#if defined(WEBRTC_LOCK_PROFILING)
+    // Report the allocations made by the audio callback.
+    rtc::ScopedRealTimeThread real_time_thread;
+#endif
     uint32_t playSampleRate = 0;
     uint8_t playBytesPerSample = 0;
     uint8_t playChannels = 0;
     {
-        CriticalSectionScoped lock(&_critSect);
-
-        // Store copies under lock and use copies hereafter to avoid race with
-        // setter methods.
+        // Store copies and use copies hereafter to avoid race with setter
+        // methods. The real-time playout thread takes no lock shared with the
+        // API threads.
+        AudioDeviceModule::ChannelType playChannel =
+            AudioDeviceModule::kChannelBoth;
         playSampleRate = _playSampleRate;
-        playBytesPerSample = _playBytesPerSample;
-        playChannels = _playChannels;
+        UnpackFormat(_playFormat.Value(), &playChannels, &playBytesPerSample,
+                     &playChannel);
 
         // Ensure that user has initialized all essential members
         if ((playBytesPerSample == 0) ||
@@ -573,8 +607,6 @@ int32_t AudioDeviceBuffer::RequestPlayoutData(uint32_t nSamples)
 
 int32_t AudioDeviceBuffer::GetPlayoutData(void* audioBuffer)
 {
-    CriticalSectionScoped lock(&_critSect);
-
     if (_playSize > kMaxBufferSizeBytes)
     {
        WEBRTC_TRACE(kTraceError, kTraceUtility, _id, "_playSize %i exceeds "
@@ -585,11 +617,8 @@ int32_t AudioDeviceBuffer::GetPlayoutData(void* audioBuffer)
 
     memcpy(audioBuffer, &_playBuffer[0], _playSize);
 
-    if (_playFile.Open())
-    {
-        // write to binary file in mono or stereo (interleaved)
-        _playFile.Write(&_playBuffer[0], _playSize);
-    }
+    // write to binary file in mono or stereo (interleaved)
+    _playFile.Write(&_playBuffer[0], _playSize);
 
     return _playSamples;
 }
@@ -11,8 +11,9 @@
 #ifndef WEBRTC_AUDIO_DEVICE_AUDIO_DEVICE_BUFFER_H
 #define WEBRTC_AUDIO_DEVICE_AUDIO_DEVICE_BUFFER_H
 
+#include "webrtc/modules/audio_device/audio_file_dump.h"
 #include "webrtc/modules/audio_device/include/audio_device.h"
-#include "webrtc/system_wrappers/interface/file_wrapper.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -91,6 +92,16 @@ private:
     uint8_t                   _recBytesPerSample;
     uint8_t                   _playBytesPerSample;
 
+    // The channels, bytes per sample and selected channel above, packed in
+    // one word each, so that the real-time threads read a consistent format
+    // without a lock while the API threads change it.
+    Atomic32                  _recFormat;
+    Atomic32                  _playFormat;
+
+    // The format _recBuffer was filled in, for DeliverRecordedData().
+    uint8_t                   _recBufferBytesPerSample;
+    uint8_t                   _recBufferChannels;
+
     // 10ms in stereo @ 96kHz
     int8_t                          _recBuffer[kMaxBufferSizeBytes];
 
@@ -105,8 +116,9 @@ private:
     uint32_t                  _playSamples;
     uint32_t                  _playSize;          // in bytes
 
-    FileWrapper&                    _recFile;
-    FileWrapper&                    _playFile;
+    // Written by the real-time threads without waiting for the files.
+    AudioFileDump                   _recFile;
+    AudioFileDump                   _playFile;
 
     uint32_t                  _currentMicLevel;
     uint32_t                  _newMicLevel;
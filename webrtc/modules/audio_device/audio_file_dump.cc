@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_device/audio_file_dump.h"
+
+#include <string.h>
+
+#include "webrtc/modules/audio_device/single_rw_fifo.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/file_wrapper.h"
+#include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+
+// Half a second of 10 ms writes.
+const int kNumBlocks = 50;
+const int kWriteIntervalMs = 20;
+
+}  // namespace
+
+AudioFileDump::AudioFileDump(uint32_t max_length)
+    : max_length_(max_length),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      file_(FileWrapper::Create()),
+      enabled_(0),
+      writing_(0),
+      dropped_writes_(0) {
+}
+
+AudioFileDump::~AudioFileDump() {
+  Stop();
+}
+
+int32_t AudioFileDump::Start(const char* file_name) {
+  Stop();
+
+  CriticalSectionScoped lock(crit_.get());
+  if (file_->OpenFile(file_name, false, false, false) != 0)
+    return -1;
+
+  // Every block holds the length of the write followed by the audio.
+  const uint32_t block_size = sizeof(uint32_t) + max_length_;
+  memory_.reset(new int8_t[kNumBlocks * block_size]);
+  free_blocks_.reset(new SingleRwFifo(kNumBlocks));
+  queued_blocks_.reset(new SingleRwFifo(kNumBlocks));
+  for (int i = 0; i < kNumBlocks; ++i)
+    free_blocks_->Push(&memory_[i * block_size]);
+  dropped_writes_ = 0;
+
+  thread_.reset(ThreadWrapper::CreateThread(WriterThread, this,
+                                            kNormalPriority,
+                                            "AudioFileDump"));
+  unsigned int thread_id = 0;
+  if (!thread_.get() || !thread_->Start(thread_id)) {
+    thread_.reset();
+    file_->CloseFile();
+    return -1;
+  }
+  ++enabled_;
+  return 0;
+}
+
+int32_t AudioFileDump::Stop() {
+  CriticalSectionScoped lock(crit_.get());
+  if (!thread_.get())
+    return 0;
+
+  // Wait for a Write() which saw the file open to finish with its block.
+  --enabled_;
+  while (writing_.Value() != 0)
+    SleepMs(1);
+
+  thread_->SetNotAlive();
+  thread_->Stop();
+  thread_.reset();
+  WriteQueuedBlocks();
+  file_->Flush();
+  file_->CloseFile();
+  if (dropped_writes_ > 0) {
+    LOG(LS_WARNING) << "Dropped " << dropped_writes_
+                    << " writes since the dump fell behind.";
+  }
+
+  queued_blocks_.reset();
+  free_blocks_.reset();
+  memory_.reset();
+  return 0;
+}
+
+void AudioFileDump::Write(const void* data, uint32_t length) {
+  ++writing_;
+  if (enabled_.Value() != 0) {
+    if (length <= max_length_ && free_blocks_->size() > 0) {
+      int8_t* block = free_blocks_->Pop();
+      memcpy(block, &length, sizeof(length));
+      memcpy(block + sizeof(length), data, length);
+      queued_blocks_->Push(block);
+    } else {
+      ++dropped_writes_;
+    }
+  }
+  --writing_;
+}
+
+bool AudioFileDump::WriterThread(void* obj) {
+  return static_cast<AudioFileDump*>(obj)->WriterProcess();
+}
+
+bool AudioFileDump::WriterProcess() {
+  SleepMs(kWriteIntervalMs);
+  WriteQueuedBlocks();
+  return true;
+}
+
+// Runs on the writer thread, or on the thread of Stop() once the writer
+// thread is gone.
+void AudioFileDump::WriteQueuedBlocks() {
+  while (queued_blocks_->size() > 0) {
+    int8_t* block = queued_blocks_->Pop();
+    uint32_t length = 0;
+    memcpy(&length, block, sizeof(length));
+    file_->Write(block + sizeof(length), length);
+    free_blocks_->Push(block);
+  }
+}
+
+}  // namespace webrtc
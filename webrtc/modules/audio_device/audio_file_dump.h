@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_DEVICE_AUDIO_FILE_DUMP_H_
+#define WEBRTC_MODULES_AUDIO_DEVICE_AUDIO_FILE_DUMP_H_
+
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+class FileWrapper;
+class SingleRwFifo;
+class ThreadWrapper;
+
+// Dumps the audio of a real-time thread to a file. The real-time thread
+// copies the audio into a block taken from a preallocated pool and queues
+// it, and a thread of the dump writes the queued blocks to the file. Write()
+// neither locks nor waits; the other methods are called by the API threads.
+class AudioFileDump {
+ public:
+  // |max_length| is the largest number of bytes given to Write() at a time.
+  explicit AudioFileDump(uint32_t max_length);
+  ~AudioFileDump();
+
+  // Opens |file_name| and starts the writer thread. An open file is closed
+  // first.
+  int32_t Start(const char* file_name);
+  // Writes the queued audio and closes the file.
+  int32_t Stop();
+
+  // Queues |length| bytes for the file, if one is open. Only one thread may
+  // call Write(). The audio is dropped when the writer thread falls more
+  // than the pool behind.
+  void Write(const void* data, uint32_t length);
+
+ private:
+  static bool WriterThread(void* obj);
+  bool WriterProcess();
+  void WriteQueuedBlocks();
+
+  const uint32_t max_length_;
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<FileWrapper> file_;
+  scoped_ptr<int8_t[]> memory_;
+  scoped_ptr<SingleRwFifo> free_blocks_;
+  scoped_ptr<SingleRwFifo> queued_blocks_;
+  scoped_ptr<ThreadWrapper> thread_;
+
+  // Non-zero while a file is open.
+  Atomic32 enabled_;
+  // Non-zero while Write() runs, so that Stop() can wait for it to leave the
+  // blocks alone.
+  Atomic32 writing_;
+  // The number of writes dropped since Start(); only modified by Write().
+  int dropped_writes_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_DEVICE_AUDIO_FILE_DUMP_H_
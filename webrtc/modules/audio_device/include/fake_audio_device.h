@@ -36,7 +36,7 @@ class FakeAudioDeviceModule : public AudioDeviceModule {
   virtual int32_t SetStereoRecording(bool enable) { return 0; }
   virtual int32_t SetAGC(bool enable) { return 0; }
   virtual int32_t StopRecording() { return 0; }
-  virtual int32_t TimeUntilNextProcess() { return 0; }
+  virtual int32_t TimeUntilNextProcess() { return 1000; }
   virtual int32_t Process() { return 0; }
   virtual int32_t Terminate() { return 0; }
 
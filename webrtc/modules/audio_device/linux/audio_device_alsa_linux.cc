@@ -1394,7 +1394,8 @@ int32_t AudioDeviceLinuxALSA::StartRecording()
     _ptrThreadRec = ThreadWrapper::CreateThread(RecThreadFunc,
                                                 this,
                                                 kRealtimePriority,
-                                                threadName);
+                                                threadName,
+                                                kAudioDeviceThreadRole);
     if (_ptrThreadRec == NULL)
     {
         WEBRTC_TRACE(kTraceCritical, kTraceAudioDevice, _id,
@@ -1566,7 +1567,8 @@ int32_t AudioDeviceLinuxALSA::StartPlayout()
     _ptrThreadPlay =  ThreadWrapper::CreateThread(PlayThreadFunc,
                                                   this,
                                                   kRealtimePriority,
-                                                  threadName);
+                                                  threadName,
+                                                  kAudioDeviceThreadRole);
     if (_ptrThreadPlay == NULL)
     {
         WEBRTC_TRACE(kTraceCritical, kTraceAudioDevice, _id,
@@ -91,6 +91,8 @@ AudioDeviceLinuxPulse::AudioDeviceLinuxPulse(const int32_t id) :
     _tempSampleDataSize(0),
     _configuredLatencyPlay(0),
     _configuredLatencyRec(0),
+    _duplexTimerRunning(false),
+    _reportedRoundTripDelay(0),
     _paDeviceIndex(-1),
     _paStateChanged(false),
     _paMainloop(NULL),
@@ -213,7 +215,8 @@ int32_t AudioDeviceLinuxPulse::Init()
     // RECORDING
     const char* threadName = "webrtc_audio_module_rec_thread";
     _ptrThreadRec = ThreadWrapper::CreateThread(RecThreadFunc, this,
-                                                kRealtimePriority, threadName);
+                                                kRealtimePriority, threadName,
+                                                kAudioDeviceThreadRole);
     if (_ptrThreadRec == NULL)
     {
         WEBRTC_TRACE(kTraceCritical, kTraceAudioDevice, _id,
@@ -236,7 +239,8 @@ int32_t AudioDeviceLinuxPulse::Init()
     // PLAYOUT
     threadName = "webrtc_audio_module_play_thread";
     _ptrThreadPlay = ThreadWrapper::CreateThread(PlayThreadFunc, this,
-                                                 kRealtimePriority, threadName);
+                                                 kRealtimePriority, threadName,
+                                                 kAudioDeviceThreadRole);
     if (_ptrThreadPlay == NULL)
     {
         WEBRTC_TRACE(kTraceCritical, kTraceAudioDevice, _id,
@@ -272,6 +276,7 @@ int32_t AudioDeviceLinuxPulse::Terminate()
     Lock();
 
     _mixerManager.Close();
+    StopDuplexTimer();
 
     // RECORDING
     if (_ptrThreadRec)
@@ -1258,12 +1263,21 @@ int32_t AudioDeviceLinuxPulse::InitPlayout()
         size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
         uint32_t latency = bytesPerSec
             * WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS / WEBRTC_PA_MSECS_PER_SEC;
+        uint32_t minreq = latency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+        if (LowLatency())
+        {
+            // Start below the usual minimum and let underflows raise it.
+            latency = bytesPerSec * WEBRTC_PA_LOW_LATENCY_PLAYBACK_MSECS
+                / WEBRTC_PA_MSECS_PER_SEC;
+            minreq = bytesPerSec * WEBRTC_PA_LOW_LATENCY_PERIOD_MSECS
+                / WEBRTC_PA_MSECS_PER_SEC;
+        }
 
         // Set the play buffer attributes
         _playBufferAttr.maxlength = latency; // num bytes stored in the buffer
         _playBufferAttr.tlength = latency; // target fill level of play buffer
         // minimum free num bytes before server request more data
-        _playBufferAttr.minreq = latency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+        _playBufferAttr.minreq = minreq;
         _playBufferAttr.prebuf = _playBufferAttr.tlength
             - _playBufferAttr.minreq; // prebuffer tlength before starting playout
 
@@ -1286,6 +1300,7 @@ int32_t AudioDeviceLinuxPulse::InitPlayout()
     _playIsInitialized = true;
     _sndCardPlayDelay = 0;
     _sndCardRecDelay = 0;
+    _reportedRoundTripDelay = 0;
 
     return 0;
 }
@@ -1372,6 +1387,11 @@ int32_t AudioDeviceLinuxPulse::InitRecording()
         size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
         uint32_t latency = bytesPerSec
             * WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS / WEBRTC_PA_MSECS_PER_SEC;
+        if (LowLatency())
+        {
+            latency = bytesPerSec * WEBRTC_PA_LOW_LATENCY_PERIOD_MSECS
+                / WEBRTC_PA_MSECS_PER_SEC;
+        }
 
         // Set the rec buffer attributes
         // Note: fragsize specifies a maximum transfer size, not a minimum, so
@@ -1463,6 +1483,10 @@ int32_t AudioDeviceLinuxPulse::StopRecording()
 
     _recIsInitialized = false;
     _recording = false;
+    if (!_playIsInitialized)
+    {
+        StopDuplexTimer();
+    }
 
     WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
                  "  stopping recording");
@@ -1592,6 +1616,10 @@ int32_t AudioDeviceLinuxPulse::StopPlayout()
     _playing = false;
     _sndCardPlayDelay = 0;
     _sndCardRecDelay = 0;
+    if (!_recIsInitialized)
+    {
+        StopDuplexTimer();
+    }
 
     WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
                  "  stopping playback");
@@ -1663,15 +1691,23 @@ int32_t AudioDeviceLinuxPulse::SetPlayoutBuffer(
     uint16_t sizeMS)
 {
 
-    if (type != AudioDeviceModule::kFixedBufferSize)
+    CriticalSectionScoped lock(&_critSect);
+
+    // The buffer type selects the low-latency mode, which applies to both
+    // streams.
+    if (_recIsInitialized || _playIsInitialized)
     {
         WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
-                     " Adaptive buffer size not supported on this platform");
+                     "  buffer type can't change while a stream is "
+                     "initialized");
         return -1;
     }
 
     _playBufType = type;
-    _playBufDelayFixed = sizeMS;
+    if (type == AudioDeviceModule::kFixedBufferSize)
+    {
+        _playBufDelayFixed = sizeMS;
+    }
 
     return 0;
 }
@@ -1681,8 +1717,23 @@ int32_t AudioDeviceLinuxPulse::PlayoutBuffer(
     uint16_t& sizeMS) const
 {
 
+    CriticalSectionScoped lock(&_critSect);
+
     type = _playBufType;
-    sizeMS = _playBufDelayFixed;
+    if (type == AudioDeviceModule::kFixedBufferSize)
+    {
+        sizeMS = _playBufDelayFixed;
+    } else
+    {
+        // The target latency negotiated with the server.
+        sizeMS = 0;
+        if (_playIsInitialized && _configuredLatencyPlay > 0)
+        {
+            sizeMS = (uint16_t) (_configuredLatencyPlay
+                * WEBRTC_PA_MSECS_PER_SEC / (sample_rate_hz_ * 2
+                * _playChannels));
+        }
+    }
 
     return 0;
 }
@@ -2360,11 +2411,39 @@ void AudioDeviceLinuxPulse::PaStreamUnderflowCallbackHandler()
     size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
     uint32_t newLatency = _configuredLatencyPlay + bytesPerSec
         * WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS / WEBRTC_PA_MSECS_PER_SEC;
+    uint32_t minreq = newLatency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+    if (LowLatency())
+    {
+        uint32_t maxLatency = bytesPerSec
+            * WEBRTC_PA_LOW_LATENCY_PLAYBACK_MAXIMUM_MSECS
+            / WEBRTC_PA_MSECS_PER_SEC;
+        if ((uint32_t) _configuredLatencyPlay >= maxLatency)
+        {
+            // Higher latencies defeat the purpose; live with the underflows.
+            return;
+        }
+
+        // Keep the request size of one period and raise the target in small
+        // steps to find the smallest latency which doesn't underflow.
+        newLatency = _configuredLatencyPlay + bytesPerSec
+            * WEBRTC_PA_LOW_LATENCY_PLAYBACK_INCREMENT_MSECS
+            / WEBRTC_PA_MSECS_PER_SEC;
+        if (newLatency > maxLatency)
+        {
+            newLatency = maxLatency;
+        }
+        minreq = _playBufferAttr.minreq;
+
+        WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
+                     "  raising the playout latency to %u ms",
+                     (uint32_t) (newLatency * WEBRTC_PA_MSECS_PER_SEC
+                                 / bytesPerSec));
+    }
 
     // Set the play buffer attributes
     _playBufferAttr.maxlength = newLatency;
     _playBufferAttr.tlength = newLatency;
-    _playBufferAttr.minreq = newLatency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+    _playBufferAttr.minreq = minreq;
     _playBufferAttr.prebuf = _playBufferAttr.tlength - _playBufferAttr.minreq;
 
     pa_operation *op = LATE(pa_stream_set_buffer_attr)(_playStream,
@@ -2477,6 +2556,33 @@ int32_t AudioDeviceLinuxPulse::LatencyUsecs(pa_stream *stream)
     }
 }
 
+void AudioDeviceLinuxPulse::WritePlayoutData(const void* bufferData,
+                                             size_t bufferSize)
+{
+    PaLock();
+    if (LATE(pa_stream_write)(_playStream, bufferData,
+                              bufferSize, NULL, (int64_t) 0,
+                              PA_SEEK_RELATIVE) != PA_OK)
+    {
+        _writeErrors++;
+        if (_writeErrors > 10)
+        {
+            if (_playError == 1)
+            {
+                WEBRTC_TRACE(kTraceWarning, kTraceUtility, _id,
+                             "  pending playout error exists");
+            }
+            _playError = 1; // Triggers callback from module process thread
+            WEBRTC_TRACE(kTraceError, kTraceUtility, _id,
+                         "  kPlayoutError message posted: "
+                         "_writeErrors=%u, error=%d",
+                         _writeErrors, LATE(pa_context_errno)(_paContext));
+            _writeErrors = 0;
+        }
+    }
+    PaUnLock();
+}
+
 int32_t AudioDeviceLinuxPulse::ReadRecordedData(const void* bufferData,
                                                 size_t bufferSize)
 {
@@ -2726,8 +2832,25 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess()
         WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
                      "  play stream ready");
 
-        // We can now handle write callbacks
-        EnableWriteCallback();
+        if (LowLatency())
+        {
+            // Continue from what the server granted, which can be more than
+            // what we asked for.
+            const pa_buffer_attr* attr =
+                LATE(pa_stream_get_buffer_attr)(_playStream);
+            if (attr)
+            {
+                _playBufferAttr = *attr;
+                _configuredLatencyPlay = attr->tlength;
+            }
+            WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
+                         "  playout latency %u bytes, request size %u bytes",
+                         _playBufferAttr.tlength, _playBufferAttr.minreq);
+        } else
+        {
+            // We can now handle write callbacks
+            EnableWriteCallback();
+        }
 
         PaUnLock();
 
@@ -2740,7 +2863,18 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess()
 
         _playing = true;
         _playStartEvent.Set();
+        if (LowLatency())
+        {
+            StartDuplexTimer();
+        }
+
+        UnLock();
+        return true;
+    }
 
+    if (LowLatency())
+    {
+        DuplexProcess();
         UnLock();
         return true;
     }
@@ -2763,35 +2897,7 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess()
                 write = _tempBufferSpace;
             }
 
-            PaLock();
-            if (LATE(pa_stream_write)(
-                                      _playStream,
-                                      (void *) &_playBuffer[_playbackBufferUnused],
-                                      write, NULL, (int64_t) 0,
-                                      PA_SEEK_RELATIVE) != PA_OK)
-            {
-                _writeErrors++;
-                if (_writeErrors > 10)
-                {
-                    if (_playError == 1)
-                    {
-                        WEBRTC_TRACE(kTraceWarning,
-                                     kTraceUtility, _id,
-                                     "  pending playout error exists");
-                    }
-                    _playError = 1; // Triggers callback from module process thread
-                    WEBRTC_TRACE(
-                                 kTraceError,
-                                 kTraceUtility,
-                                 _id,
-                                 "  kPlayoutError message posted: "
-                                 "_writeErrors=%u, error=%d",
-                                 _writeErrors,
-                                 LATE(pa_context_errno)(_paContext));
-                    _writeErrors = 0;
-                }
-            }
-            PaUnLock();
+            WritePlayoutData(&_playBuffer[_playbackBufferUnused], write);
 
             _playbackBufferUnused += write;
             _tempBufferSpace -= write;
@@ -2833,33 +2939,7 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess()
 
             WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
                          "  will write");
-            PaLock();
-            if (LATE(pa_stream_write)(_playStream, (void *) &_playBuffer[0],
-                                      write, NULL, (int64_t) 0,
-                                      PA_SEEK_RELATIVE) != PA_OK)
-            {
-                _writeErrors++;
-                if (_writeErrors > 10)
-                {
-                    if (_playError == 1)
-                    {
-                        WEBRTC_TRACE(kTraceWarning,
-                                     kTraceUtility, _id,
-                                     "  pending playout error exists");
-                    }
-                    _playError = 1; // triggers callback from module process thread
-                    WEBRTC_TRACE(
-                                 kTraceError,
-                                 kTraceUtility,
-                                 _id,
-                                 "  kPlayoutError message posted: "
-                                 "_writeErrors=%u, error=%d",
-                                 _writeErrors,
-                                 LATE(pa_context_errno)(_paContext));
-                    _writeErrors = 0;
-                }
-            }
-            PaUnLock();
+            WritePlayoutData(&_playBuffer[0], write);
 
             _playbackBufferUnused = write;
         }
@@ -2936,8 +3016,22 @@ bool AudioDeviceLinuxPulse::RecThreadProcess()
         WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
                      "  done");
 
-        // We can now handle read callbacks
-        EnableReadCallback();
+        if (LowLatency())
+        {
+            const pa_buffer_attr* attr =
+                LATE(pa_stream_get_buffer_attr)(_recStream);
+            if (attr)
+            {
+                _recBufferAttr = *attr;
+            }
+            WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
+                         "  capture fragment size %u bytes",
+                         _recBufferAttr.fragsize);
+        } else
+        {
+            // We can now handle read callbacks
+            EnableReadCallback();
+        }
 
         PaUnLock();
 
@@ -2951,12 +3045,17 @@ bool AudioDeviceLinuxPulse::RecThreadProcess()
         _startRec = false;
         _recording = true;
         _recStartEvent.Set();
+        if (LowLatency())
+        {
+            // The play thread reads the stream from now on.
+            StartDuplexTimer();
+        }
 
         UnLock();
         return true;
     }
 
-    if (_recording)
+    if (_recording && !LowLatency())
     {
         // Read data and provide it to VoiceEngine
         if (ReadRecordedData(_tempSampleData, _tempSampleDataSize) == -1)
@@ -3024,6 +3123,178 @@ bool AudioDeviceLinuxPulse::RecThreadProcess()
     return true;
 }
 
+bool AudioDeviceLinuxPulse::LowLatency() const
+{
+    return _playBufType == AudioDeviceModule::kAdaptiveBufferSize;
+}
+
+void AudioDeviceLinuxPulse::StartDuplexTimer()
+{
+    if (_duplexTimerRunning)
+    {
+        return;
+    }
+    if (!_timeEventPlay.StartTimer(true, WEBRTC_PA_LOW_LATENCY_PERIOD_MSECS))
+    {
+        WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                     "  failed to start the duplex timer");
+        return;
+    }
+    _duplexTimerRunning = true;
+}
+
+void AudioDeviceLinuxPulse::StopDuplexTimer()
+{
+    if (!_duplexTimerRunning)
+    {
+        return;
+    }
+    _timeEventPlay.StopTimer();
+    _duplexTimerRunning = false;
+}
+
+// Services both streams in the low-latency mode, on the play thread every
+// time the duplex timer fires.
+void AudioDeviceLinuxPulse::DuplexProcess()
+{
+    // Playout goes first, so that the AEC gets the far-end audio before the
+    // near-end audio which may hold its echo.
+    if (_playing && WriteLowLatencyPlayout() == -1)
+    {
+        // We have stopped playing
+        return;
+    }
+    if (_recording && ReadLowLatencyCapture() == -1)
+    {
+        // We have stopped recording
+        return;
+    }
+    if (_playing && _recording)
+    {
+        ReportRoundTripDelay();
+    }
+}
+
+int32_t AudioDeviceLinuxPulse::WriteLowLatencyPlayout()
+{
+    PaLock();
+    size_t writable = LATE(pa_stream_writable_size)(_playStream);
+    _sndCardPlayDelay = (uint32_t) (LatencyUsecs(_playStream) / 1000);
+    PaUnLock();
+
+    if (writable == (size_t) -1)
+    {
+        WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id,
+                     "  pa_stream_writable_size() failed, err=%d",
+                     LATE(pa_context_errno)(_paContext));
+        return 0;
+    }
+
+    // Top the server buffer up to the target latency. Whatever doesn't fit of
+    // a 10 ms block is written the next time around.
+    const uint32_t numPlaySamples = _playbackBufferSize / (2 * _playChannels);
+    while (writable > 0)
+    {
+        if (_playbackBufferUnused == _playbackBufferSize)
+        {
+            // Ask for new PCM data without holding the audio-thread lock
+            UnLock();
+            _ptrAudioBuffer->RequestPlayoutData(numPlaySamples);
+            Lock();
+
+            // We have been unlocked - check the flag again
+            if (!_playing)
+            {
+                return -1;
+            }
+
+            uint32_t nSamples = _ptrAudioBuffer->GetPlayoutData(_playBuffer);
+            if (nSamples != numPlaySamples)
+            {
+                WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                             "  invalid number of output samples(%d)",
+                             nSamples);
+            }
+            _playbackBufferUnused = 0;
+        }
+
+        size_t write = _playbackBufferSize - _playbackBufferUnused;
+        if (writable < write)
+        {
+            write = writable;
+        }
+        WritePlayoutData(&_playBuffer[_playbackBufferUnused], write);
+        _playbackBufferUnused += write;
+        writable -= write;
+    }
+
+    return 0;
+}
+
+int32_t AudioDeviceLinuxPulse::ReadLowLatencyCapture()
+{
+    PaLock();
+    while (LATE(pa_stream_readable_size)(_recStream) > 0)
+    {
+        const void *sampleData;
+        size_t sampleDataSize;
+
+        if (LATE(pa_stream_peek)(_recStream, &sampleData, &sampleDataSize)
+            != 0)
+        {
+            _recError = 1; // triggers callback from module process thread
+            WEBRTC_TRACE(kTraceError, kTraceAudioDevice,
+                         _id, "  RECORD_ERROR message posted, error = %d",
+                         LATE(pa_context_errno)(_paContext));
+            break;
+        }
+
+        // A NULL pointer with a size is a hole in the stream, which is only
+        // dropped.
+        if (sampleData)
+        {
+            // Deliver to VoiceEngine without holding the mainloop lock.
+            PaUnLock();
+            if (ReadRecordedData(sampleData, sampleDataSize) == -1)
+            {
+                return -1;
+            }
+            PaLock();
+        }
+
+        if (LATE(pa_stream_drop)(_recStream) != 0)
+        {
+            WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice,
+                         _id, "  failed to drop, err=%d\n",
+                         LATE(pa_context_errno)(_paContext));
+            break;
+        }
+    }
+    PaUnLock();
+
+    return 0;
+}
+
+// Traces the latency from the play stream to the rec stream whenever it moves
+// by more than a period, since it is what the AEC has to find.
+void AudioDeviceLinuxPulse::ReportRoundTripDelay()
+{
+    const uint32_t roundTripDelay = _sndCardPlayDelay + _sndCardRecDelay;
+    const uint32_t change = roundTripDelay > _reportedRoundTripDelay ?
+        roundTripDelay - _reportedRoundTripDelay :
+        _reportedRoundTripDelay - roundTripDelay;
+    if (change < WEBRTC_PA_LOW_LATENCY_PERIOD_MSECS)
+    {
+        return;
+    }
+
+    WEBRTC_TRACE(kTraceStateInfo, kTraceAudioDevice, _id,
+                 "  device round-trip latency %u ms (playout %u ms, "
+                 "capture %u ms)",
+                 roundTripDelay, _sndCardPlayDelay, _sndCardRecDelay);
+    _reportedRoundTripDelay = roundTripDelay;
+}
+
 bool AudioDeviceLinuxPulse::KeyPressed() const{
 
   char szKey[32];
@@ -76,6 +76,21 @@ const uint32_t WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS = 10;
 // kNoLatencyRequirements case.)
 const uint32_t WEBRTC_PA_CAPTURE_BUFFER_EXTRA_MSECS = 750;
 
+// Low latency, selected with SetPlayoutBuffer(kAdaptiveBufferSize).
+
+// One thread services both streams on a timer with this period, rather than a
+// thread per direction woken by the read and write callbacks. The capture
+// stream is asked to transfer data at the same granularity.
+const uint32_t WEBRTC_PA_LOW_LATENCY_PERIOD_MSECS = 5;
+
+// The playback stream starts with this target latency and the request size of
+// one period. Every underflow raises the target by the increment, up to the
+// maximum, so the stream settles at the smallest latency the server and the
+// device can keep up with.
+const uint32_t WEBRTC_PA_LOW_LATENCY_PLAYBACK_MSECS = 15;
+const uint32_t WEBRTC_PA_LOW_LATENCY_PLAYBACK_INCREMENT_MSECS = 5;
+const uint32_t WEBRTC_PA_LOW_LATENCY_PLAYBACK_MAXIMUM_MSECS = 100;
+
 const uint32_t WEBRTC_PA_MSECS_PER_SEC = 1000;
 
 // Init _configuredLatencyRec/Play to this value to disable latency requirements
@@ -264,6 +279,7 @@ private:
     static void PaStreamOverflowCallback(pa_stream *unused, void *pThis);
     void PaStreamOverflowCallbackHandler();
     int32_t LatencyUsecs(pa_stream *stream);
+    void WritePlayoutData(const void* bufferData, size_t bufferSize);
     int32_t ReadRecordedData(const void* bufferData, size_t bufferSize);
     int32_t ProcessRecordedData(int8_t *bufferData,
                                 uint32_t bufferSizeInSamples,
@@ -283,6 +299,14 @@ private:
     bool RecThreadProcess();
     bool PlayThreadProcess();
 
+    bool LowLatency() const;
+    void StartDuplexTimer();
+    void StopDuplexTimer();
+    void DuplexProcess();
+    int32_t WriteLowLatencyPlayout();
+    int32_t ReadLowLatencyCapture();
+    void ReportRoundTripDelay();
+
 private:
     AudioDeviceBuffer* _ptrAudioBuffer;
 
@@ -356,6 +380,8 @@ private:
     size_t _tempSampleDataSize;
     int32_t _configuredLatencyPlay;
     int32_t _configuredLatencyRec;
+    bool _duplexTimerRunning;
+    uint32_t _reportedRoundTripDelay;
 
     // PulseAudio
     uint16_t _paDeviceIndex;
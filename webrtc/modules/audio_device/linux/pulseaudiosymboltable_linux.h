@@ -64,6 +64,7 @@ namespace webrtc_adm_linux_pulse {
   X(pa_stream_connect_record) \
   X(pa_stream_disconnect) \
   X(pa_stream_drop) \
+  X(pa_stream_get_buffer_attr) \
   X(pa_stream_get_device_index) \
   X(pa_stream_get_index) \
   X(pa_stream_get_latency) \
@@ -8,7 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include "webrtc/modules/audio_device/android/single_rw_fifo.h"
+#include "webrtc/modules/audio_device/single_rw_fifo.h"
 
 #include <assert.h>
 
@@ -45,7 +45,9 @@ inline void MemoryBarrier() {
 }
 
 #else
-#error Add an implementation of MemoryBarrier() for this platform!
+inline void MemoryBarrier() {
+  __sync_synchronize();
+}
 #endif
 
 }  // namespace subtle
@@ -8,8 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#ifndef WEBRTC_MODULES_AUDIO_DEVICE_ANDROID_SINGLE_RW_FIFO_H_
-#define WEBRTC_MODULES_AUDIO_DEVICE_ANDROID_SINGLE_RW_FIFO_H_
+#ifndef WEBRTC_MODULES_AUDIO_DEVICE_SINGLE_RW_FIFO_H_
+#define WEBRTC_MODULES_AUDIO_DEVICE_SINGLE_RW_FIFO_H_
 
 #include "webrtc/system_wrappers/interface/atomic32.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
@@ -46,4 +46,4 @@ class SingleRwFifo {
 
 }  // namespace webrtc
 
-#endif  // WEBRTC_MODULES_AUDIO_DEVICE_ANDROID_SINGLE_RW_FIFO_H_
+#endif  // WEBRTC_MODULES_AUDIO_DEVICE_SINGLE_RW_FIFO_H_
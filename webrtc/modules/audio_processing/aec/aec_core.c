@@ -43,6 +43,14 @@ static const float cnScaleHband =
 // Initial bin for averaging nlp gain in low band
 static const int freqAvgIc = PART_LEN / 2;
 
+// Signal based delay correction in the delay agnostic mode. A correction is
+// only made when the quality of the delay estimate exceeds a threshold, which
+// starts at |kDelayQualityThresholdMin| and follows the best quality seen up to
+// |kDelayQualityThresholdMax|.
+static const float kDelayQualityThresholdMin = 0.01f;
+static const float kDelayQualityThresholdMax = 0.07f;
+static const int kInitialShiftOffset = 5;
+
 // Matlab code to produce table:
 // win = sqrt(hanning(63)); win = [0 ; win(1:32)];
 // fprintf(1, '\t%.14f, %.14f, %.14f,\n', win);
@@ -635,6 +643,11 @@ int WebRtcAec_InitAec(AecCore* aec, int sampFreq) {
   aec->reported_delay_enabled = 1;
   aec->extended_filter_enabled = 0;
   aec->num_partitions = kNormalNumPartitions;
+  aec->delay_agnostic_enabled = 0;
+  aec->previous_delay = -2;  // (-2): Uninitialized.
+  aec->delay_correction_count = 0;
+  aec->shift_offset = kInitialShiftOffset;
+  aec->delay_quality_threshold = kDelayQualityThresholdMin;
 
   // Update the delay estimator with filter length.  We use half the
   // |num_partitions| to take the echo path into account.  In practice we say
@@ -736,6 +749,10 @@ int WebRtcAec_InitAec(AecCore* aec, int sampFreq) {
   if (WebRtc_GetCPUInfo(kSSE2)) {
     WebRtcAec_InitAec_SSE2();
   }
+  // Replaces a subset of the SSE2 functions.
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcAec_InitAec_AVX2();
+  }
 #endif
 
 #if defined(MIPS_FPU_LE)
@@ -780,6 +797,69 @@ int WebRtcAec_MoveFarReadPtr(AecCore* aec, int elements) {
   return elements_moved;
 }
 
+// Returns the number of partitions to move the far-end read pointer to align
+// the far-end with the near-end, from the last delay estimate.
+static int SignalBasedDelayCorrection(AecCore* self) {
+  int delay_correction = 0;
+  int last_delay = -2;
+  assert(self != NULL);
+  // 1. Check for a non-negative delay estimate. Note that the estimates we get
+  //    from the delay estimation are not compensated for lookahead. Hence, a
+  //    negative |last_delay| is an invalid one.
+  // 2. Verify that there is a delay change. In addition, only allow a change
+  //    if the delay is outside a certain region taking the AEC filter length
+  //    into account.
+  // 3. Only allow delay correction if the delay estimation quality exceeds
+  //    |delay_quality_threshold|.
+  // 4. Finally, verify that the proposed |delay_correction| is feasible by
+  //    comparing with the size of the far-end buffer.
+  last_delay = WebRtc_last_delay(self->delay_estimator);
+  if ((last_delay >= 0) && (last_delay != self->previous_delay) &&
+      (WebRtc_last_delay_quality(self->delay_estimator) >
+           self->delay_quality_threshold)) {
+    int delay = last_delay - WebRtc_lookahead(self->delay_estimator);
+    // Allow for a slack in the actual delay. The adaptive filter is
+    // |num_partitions| long, so we only correct if the delay estimate is
+    // non-positive or more than 3/4 of the filter length.
+    const int lower_bound = 0;
+    const int upper_bound = self->num_partitions * 3 / 4;
+    const int do_correction = delay <= lower_bound || delay > upper_bound;
+    if (do_correction == 1) {
+      int available_read = (int)WebRtc_available_read(self->far_buf);
+      // With |shift_offset| we gradually rely on the delay estimates. For
+      // positive delays we reduce the correction by |shift_offset| to lower
+      // the risk of pushing the AEC into a non causal state. For negative
+      // delays we rely on the values up to a rounding error, hence compensate
+      // by 1 element to make sure to push the delay into the causal region.
+      delay_correction = -delay;
+      delay_correction += delay > self->shift_offset ? self->shift_offset : 1;
+      self->shift_offset--;
+      self->shift_offset = (self->shift_offset <= 1 ? 1 : self->shift_offset);
+      if (delay_correction > available_read - self->mult - 1) {
+        // There is not enough data in the buffer to perform this shift. Hence,
+        // we do not rely on the delay estimate and do nothing.
+        delay_correction = 0;
+      } else {
+        self->previous_delay = last_delay;
+        ++self->delay_correction_count;
+      }
+    }
+  }
+  // Update the |delay_quality_threshold| once we have our first delay
+  // correction.
+  if (self->delay_correction_count > 0) {
+    float delay_quality = WebRtc_last_delay_quality(self->delay_estimator);
+    delay_quality = (delay_quality > kDelayQualityThresholdMax
+                         ? kDelayQualityThresholdMax
+                         : delay_quality);
+    self->delay_quality_threshold =
+        (delay_quality > self->delay_quality_threshold
+             ? delay_quality
+             : self->delay_quality_threshold);
+  }
+  return delay_correction;
+}
+
 void WebRtcAec_ProcessFrame(AecCore* aec,
                             const float* nearend,
                             const float* nearendH,
@@ -791,7 +871,9 @@ void WebRtcAec_ProcessFrame(AecCore* aec,
   // For each frame the process is as follows:
   // 1) If the system_delay indicates on being too small for processing a
   //    frame we stuff the buffer with enough data for 10 ms.
-  // 2) Adjust the buffer to the system delay, by moving the read pointer.
+  // 2) Adjust the buffer to the system delay, by moving the read pointer. In
+  //    the delay agnostic mode, also adjust it to the delay estimated from the
+  //    signals.
   // 3) TODO(bjornv): Investigate if we need to add this:
   //    If we can't move read pointer due to buffer size limitations we
   //    flush/stuff the buffer.
@@ -836,6 +918,17 @@ void WebRtcAec_ProcessFrame(AecCore* aec,
   WebRtc_MoveReadPtr(aec->far_time_buf, move_elements);
 #endif
 
+  if (aec->delay_agnostic_enabled) {
+    // The correction never leaves less far-end data than needed for this
+    // frame, see SignalBasedDelayCorrection(). The delay estimator histories
+    // are shifted along with the buffer.
+    move_elements = SignalBasedDelayCorrection(aec);
+    moved_elements = WebRtcAec_MoveFarReadPtr(aec, move_elements);
+    WebRtc_SoftResetDelayEstimator(aec->delay_estimator, moved_elements);
+    WebRtc_SoftResetDelayEstimatorFarend(aec->delay_estimator_farend,
+                                         moved_elements);
+  }
+
   // 4) Process as many blocks as possible.
   while (WebRtc_available_read(aec->nearFrBuf) >= PART_LEN) {
     ProcessBlock(aec);
@@ -969,6 +1062,14 @@ int WebRtcAec_delay_correction_enabled(AecCore* self) {
   return self->extended_filter_enabled;
 }
 
+void WebRtcAec_enable_delay_agnostic(AecCore* self, int enable) {
+  self->delay_agnostic_enabled = enable;
+}
+
+int WebRtcAec_delay_agnostic_enabled(AecCore* self) {
+  return self->delay_agnostic_enabled;
+}
+
 int WebRtcAec_system_delay(AecCore* self) { return self->system_delay; }
 
 void WebRtcAec_SetSystemDelay(AecCore* self, int delay) {
@@ -1076,14 +1177,14 @@ static void ProcessBlock(AecCore* aec) {
     aec->noisePow = aec->dMinPow;
   }
 
-  // Block wise delay estimation used for logging
-  if (aec->delay_logging_enabled) {
+  // Block wise delay estimation used for logging and the delay agnostic mode.
+  if (aec->delay_logging_enabled || aec->delay_agnostic_enabled) {
     int delay_estimate = 0;
     if (WebRtc_AddFarSpectrumFloat(
             aec->delay_estimator_farend, abs_far_spectrum, PART_LEN1) == 0) {
       delay_estimate = WebRtc_DelayEstimatorProcessFloat(
           aec->delay_estimator, abs_near_spectrum, PART_LEN1);
-      if (delay_estimate >= 0) {
+      if (delay_estimate >= 0 && aec->delay_logging_enabled) {
         // Update delay estimate buffer.
         aec->delay_histogram[delay_estimate]++;
       }
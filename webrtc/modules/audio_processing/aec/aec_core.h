@@ -54,6 +54,7 @@ int WebRtcAec_CreateAec(AecCore** aec);
 int WebRtcAec_FreeAec(AecCore* aec);
 int WebRtcAec_InitAec(AecCore* aec, int sampFreq);
 void WebRtcAec_InitAec_SSE2(void);
+void WebRtcAec_InitAec_AVX2(void);
 #if defined(MIPS_FPU_LE)
 void WebRtcAec_InitAec_mips(void);
 #endif
@@ -111,6 +112,14 @@ void WebRtcAec_enable_delay_correction(AecCore* self, int enable);
 // Returns non-zero if delay correction is enabled and zero if disabled.
 int WebRtcAec_delay_correction_enabled(AecCore* self);
 
+// In the delay agnostic mode the far-end buffer is aligned with the near-end
+// from the signals themselves, through the delay estimator, instead of from
+// the reported system delays. Non-zero enables, zero disables.
+void WebRtcAec_enable_delay_agnostic(AecCore* self, int enable);
+
+// Returns non-zero if the delay agnostic mode is enabled and zero if disabled.
+int WebRtcAec_delay_agnostic_enabled(AecCore* self);
+
 // Returns the current |system_delay|, i.e., the buffered difference between
 // far-end and near-end.
 int WebRtcAec_system_delay(AecCore* self);
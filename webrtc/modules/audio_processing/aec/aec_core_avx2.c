@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core AEC algorithm, AVX2 version of speed-critical functions.
+ * The functions not found here keep their SSE2 versions. Each bin goes through
+ * the same operations as in the SSE2 versions, so the results are bit-exact.
+ */
+
+#include <immintrin.h>
+#include <math.h>
+#include <string.h>  // memset
+
+#include "webrtc/modules/audio_processing/aec/aec_common.h"
+#include "webrtc/modules/audio_processing/aec/aec_core_internal.h"
+#include "webrtc/modules/audio_processing/aec/aec_rdft.h"
+
+__inline static float MulRe(float aRe, float aIm, float bRe, float bIm) {
+  return aRe * bRe - aIm * bIm;
+}
+
+__inline static float MulIm(float aRe, float aIm, float bRe, float bIm) {
+  return aRe * bIm + aIm * bRe;
+}
+
+static void FilterFarAVX2(AecCore* aec, float yf[2][PART_LEN1]) {
+  int i;
+  const int num_partitions = aec->num_partitions;
+  for (i = 0; i < num_partitions; i++) {
+    int j;
+    int xPos = (i + aec->xfBufBlockPos) * PART_LEN1;
+    int pos = i * PART_LEN1;
+    // Check for wrap
+    if (i + aec->xfBufBlockPos >= num_partitions) {
+      xPos -= num_partitions * (PART_LEN1);
+    }
+
+    // vectorized code (eight at once)
+    for (j = 0; j + 7 < PART_LEN1; j += 8) {
+      const __m256 xfBuf_re = _mm256_loadu_ps(&aec->xfBuf[0][xPos + j]);
+      const __m256 xfBuf_im = _mm256_loadu_ps(&aec->xfBuf[1][xPos + j]);
+      const __m256 wfBuf_re = _mm256_loadu_ps(&aec->wfBuf[0][pos + j]);
+      const __m256 wfBuf_im = _mm256_loadu_ps(&aec->wfBuf[1][pos + j]);
+      const __m256 yf_re = _mm256_loadu_ps(&yf[0][j]);
+      const __m256 yf_im = _mm256_loadu_ps(&yf[1][j]);
+      const __m256 a = _mm256_mul_ps(xfBuf_re, wfBuf_re);
+      const __m256 b = _mm256_mul_ps(xfBuf_im, wfBuf_im);
+      const __m256 c = _mm256_mul_ps(xfBuf_re, wfBuf_im);
+      const __m256 d = _mm256_mul_ps(xfBuf_im, wfBuf_re);
+      const __m256 e = _mm256_sub_ps(a, b);
+      const __m256 f = _mm256_add_ps(c, d);
+      const __m256 g = _mm256_add_ps(yf_re, e);
+      const __m256 h = _mm256_add_ps(yf_im, f);
+      _mm256_storeu_ps(&yf[0][j], g);
+      _mm256_storeu_ps(&yf[1][j], h);
+    }
+    // scalar code for the remaining items.
+    for (; j < PART_LEN1; j++) {
+      yf[0][j] += MulRe(aec->xfBuf[0][xPos + j],
+                        aec->xfBuf[1][xPos + j],
+                        aec->wfBuf[0][pos + j],
+                        aec->wfBuf[1][pos + j]);
+      yf[1][j] += MulIm(aec->xfBuf[0][xPos + j],
+                        aec->xfBuf[1][xPos + j],
+                        aec->wfBuf[0][pos + j],
+                        aec->wfBuf[1][pos + j]);
+    }
+  }
+}
+
+static void ScaleErrorSignalAVX2(AecCore* aec, float ef[2][PART_LEN1]) {
+  const __m256 k1e_10f = _mm256_set1_ps(1e-10f);
+  const __m256 kMu = aec->extended_filter_enabled
+                         ? _mm256_set1_ps(kExtendedMu)
+                         : _mm256_set1_ps(aec->normal_mu);
+  const __m256 kThresh = aec->extended_filter_enabled
+                             ? _mm256_set1_ps(kExtendedErrorThreshold)
+                             : _mm256_set1_ps(aec->normal_error_threshold);
+
+  int i;
+  // vectorized code (eight at once)
+  for (i = 0; i + 7 < PART_LEN1; i += 8) {
+    const __m256 xPow = _mm256_loadu_ps(&aec->xPow[i]);
+    const __m256 ef_re_base = _mm256_loadu_ps(&ef[0][i]);
+    const __m256 ef_im_base = _mm256_loadu_ps(&ef[1][i]);
+
+    const __m256 xPowPlus = _mm256_add_ps(xPow, k1e_10f);
+    __m256 ef_re = _mm256_div_ps(ef_re_base, xPowPlus);
+    __m256 ef_im = _mm256_div_ps(ef_im_base, xPowPlus);
+    const __m256 ef_re2 = _mm256_mul_ps(ef_re, ef_re);
+    const __m256 ef_im2 = _mm256_mul_ps(ef_im, ef_im);
+    const __m256 ef_sum2 = _mm256_add_ps(ef_re2, ef_im2);
+    const __m256 absEf = _mm256_sqrt_ps(ef_sum2);
+    const __m256 bigger = _mm256_cmp_ps(absEf, kThresh, _CMP_GT_OQ);
+    const __m256 absEfPlus = _mm256_add_ps(absEf, k1e_10f);
+    const __m256 absEfInv = _mm256_div_ps(kThresh, absEfPlus);
+    const __m256 ef_re_if = _mm256_mul_ps(ef_re, absEfInv);
+    const __m256 ef_im_if = _mm256_mul_ps(ef_im, absEfInv);
+    ef_re = _mm256_blendv_ps(ef_re, ef_re_if, bigger);
+    ef_im = _mm256_blendv_ps(ef_im, ef_im_if, bigger);
+    ef_re = _mm256_mul_ps(ef_re, kMu);
+    ef_im = _mm256_mul_ps(ef_im, kMu);
+
+    _mm256_storeu_ps(&ef[0][i], ef_re);
+    _mm256_storeu_ps(&ef[1][i], ef_im);
+  }
+  // scalar code for the remaining items.
+  {
+    const float mu =
+        aec->extended_filter_enabled ? kExtendedMu : aec->normal_mu;
+    const float error_threshold = aec->extended_filter_enabled
+                                      ? kExtendedErrorThreshold
+                                      : aec->normal_error_threshold;
+    for (; i < (PART_LEN1); i++) {
+      float abs_ef;
+      ef[0][i] /= (aec->xPow[i] + 1e-10f);
+      ef[1][i] /= (aec->xPow[i] + 1e-10f);
+      abs_ef = sqrtf(ef[0][i] * ef[0][i] + ef[1][i] * ef[1][i]);
+
+      if (abs_ef > error_threshold) {
+        abs_ef = error_threshold / (abs_ef + 1e-10f);
+        ef[0][i] *= abs_ef;
+        ef[1][i] *= abs_ef;
+      }
+
+      // Stepsize factor
+      ef[0][i] *= mu;
+      ef[1][i] *= mu;
+    }
+  }
+}
+
+static void FilterAdaptationAVX2(AecCore* aec,
+                                 float* fft,
+                                 float ef[2][PART_LEN1]) {
+  int i, j;
+  const int num_partitions = aec->num_partitions;
+  for (i = 0; i < num_partitions; i++) {
+    int xPos = (i + aec->xfBufBlockPos) * (PART_LEN1);
+    int pos = i * PART_LEN1;
+    // Check for wrap
+    if (i + aec->xfBufBlockPos >= num_partitions) {
+      xPos -= num_partitions * PART_LEN1;
+    }
+
+    // Process the whole array...
+    for (j = 0; j < PART_LEN; j += 8) {
+      // Load xfBuf and ef.
+      const __m256 xfBuf_re = _mm256_loadu_ps(&aec->xfBuf[0][xPos + j]);
+      const __m256 xfBuf_im = _mm256_loadu_ps(&aec->xfBuf[1][xPos + j]);
+      const __m256 ef_re = _mm256_loadu_ps(&ef[0][j]);
+      const __m256 ef_im = _mm256_loadu_ps(&ef[1][j]);
+      // Calculate the product of conjugate(xfBuf) by ef.
+      //   re(conjugate(a) * b) = aRe * bRe + aIm * bIm
+      //   im(conjugate(a) * b)=  aRe * bIm - aIm * bRe
+      const __m256 a = _mm256_mul_ps(xfBuf_re, ef_re);
+      const __m256 b = _mm256_mul_ps(xfBuf_im, ef_im);
+      const __m256 c = _mm256_mul_ps(xfBuf_re, ef_im);
+      const __m256 d = _mm256_mul_ps(xfBuf_im, ef_re);
+      const __m256 e = _mm256_add_ps(a, b);
+      const __m256 f = _mm256_sub_ps(c, d);
+      // Interleave real and imaginary parts. The unpacks work within each
+      // 128-bit lane, so the halves are put back in order afterwards.
+      const __m256 g_t = _mm256_unpacklo_ps(e, f);
+      const __m256 h_t = _mm256_unpackhi_ps(e, f);
+      const __m256 g = _mm256_permute2f128_ps(g_t, h_t, 0x20);
+      const __m256 h = _mm256_permute2f128_ps(g_t, h_t, 0x31);
+      // Store
+      _mm256_storeu_ps(&fft[2 * j + 0], g);
+      _mm256_storeu_ps(&fft[2 * j + 8], h);
+    }
+    // ... and fixup the first imaginary entry.
+    fft[1] = MulRe(aec->xfBuf[0][xPos + PART_LEN],
+                   -aec->xfBuf[1][xPos + PART_LEN],
+                   ef[0][PART_LEN],
+                   ef[1][PART_LEN]);
+
+    aec_rdft_inverse_128(fft);
+    memset(fft + PART_LEN, 0, sizeof(float) * PART_LEN);
+
+    // fft scaling
+    {
+      const __m256 scale_ps = _mm256_set1_ps(2.0f / PART_LEN2);
+      for (j = 0; j < PART_LEN; j += 8) {
+        const __m256 fft_ps = _mm256_loadu_ps(&fft[j]);
+        const __m256 fft_scale = _mm256_mul_ps(fft_ps, scale_ps);
+        _mm256_storeu_ps(&fft[j], fft_scale);
+      }
+    }
+    aec_rdft_forward_128(fft);
+
+    {
+      float wt1 = aec->wfBuf[1][pos];
+      aec->wfBuf[0][pos + PART_LEN] += fft[1];
+      for (j = 0; j < PART_LEN; j += 8) {
+        __m256 wtBuf_re = _mm256_loadu_ps(&aec->wfBuf[0][pos + j]);
+        __m256 wtBuf_im = _mm256_loadu_ps(&aec->wfBuf[1][pos + j]);
+        const __m256 fft0 = _mm256_loadu_ps(&fft[2 * j + 0]);
+        const __m256 fft8 = _mm256_loadu_ps(&fft[2 * j + 8]);
+        // The shuffles work within each 128-bit lane, which leaves the bins
+        // in the order 0, 1, 4, 5, 2, 3, 6, 7.
+        const __m256 fft_re_t =
+            _mm256_shuffle_ps(fft0, fft8, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 fft_im_t =
+            _mm256_shuffle_ps(fft0, fft8, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m256 fft_re = _mm256_castpd_ps(_mm256_permute4x64_pd(
+            _mm256_castps_pd(fft_re_t), _MM_SHUFFLE(3, 1, 2, 0)));
+        const __m256 fft_im = _mm256_castpd_ps(_mm256_permute4x64_pd(
+            _mm256_castps_pd(fft_im_t), _MM_SHUFFLE(3, 1, 2, 0)));
+        wtBuf_re = _mm256_add_ps(wtBuf_re, fft_re);
+        wtBuf_im = _mm256_add_ps(wtBuf_im, fft_im);
+        _mm256_storeu_ps(&aec->wfBuf[0][pos + j], wtBuf_re);
+        _mm256_storeu_ps(&aec->wfBuf[1][pos + j], wtBuf_im);
+      }
+      aec->wfBuf[1][pos] = wt1;
+    }
+  }
+}
+
+void WebRtcAec_InitAec_AVX2(void) {
+  WebRtcAec_FilterFar = FilterFarAVX2;
+  WebRtcAec_ScaleErrorSignal = ScaleErrorSignalAVX2;
+  WebRtcAec_FilterAdaptation = FilterAdaptationAVX2;
+}
@@ -27,7 +27,7 @@ enum {
 };
 static const int kNormalNumPartitions = 12;
 
-// Delay estimator constants, used for logging.
+// Delay estimator constants, used for logging and the delay agnostic mode.
 enum {
   kMaxDelayBlocks = 60
 };
@@ -140,6 +140,14 @@ struct AecCore {
   // Runtime selection of number of filter partitions.
   int num_partitions;
 
+  // 1 = delay agnostic mode enabled, 0 = disabled.
+  int delay_agnostic_enabled;
+  // Signal based delay correction, see SignalBasedDelayCorrection().
+  int previous_delay;
+  int delay_correction_count;
+  int shift_offset;
+  float delay_quality_threshold;
+
 #ifdef WEBRTC_AEC_DEBUG_DUMP
   RingBuffer* far_time_buf;
   FILE* farFile;
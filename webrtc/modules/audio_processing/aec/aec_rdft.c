@@ -659,6 +659,10 @@ void aec_rdft_init(void) {
   if (WebRtc_GetCPUInfo(kSSE2)) {
     aec_rdft_init_sse2();
   }
+  // Replaces a subset of the SSE2 functions.
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    aec_rdft_init_avx2();
+  }
 #endif
 #if defined(MIPS_FPU_LE)
   aec_rdft_init_mips();
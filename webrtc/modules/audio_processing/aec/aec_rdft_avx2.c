@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * AVX2 versions of the real-valued post- and pre-processing steps of the
+ * 128-point rdft. They process eight complex bins at once, twice as many as
+ * the SSE2 versions, with the same operations per bin, so the results are
+ * bit-exact. The complex sub-transforms stay on SSE2.
+ */
+
+#include "webrtc/modules/audio_processing/aec/aec_rdft.h"
+
+#include <immintrin.h>
+
+// Splits the 16 interleaved values |lo|, |hi| into their even and odd
+// elements.
+static __inline void Deinterleave(__m256 lo, __m256 hi,
+                                  __m256* even, __m256* odd) {
+  // The shuffles work within each 128-bit lane, which leaves the elements in
+  // the order 0, 1, 4, 5, 2, 3, 6, 7.
+  const __m256 even_t = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+  const __m256 odd_t = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+  *even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even_t),
+                                                 _MM_SHUFFLE(3, 1, 2, 0)));
+  *odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd_t),
+                                                _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// Inverse of Deinterleave().
+static __inline void Interleave(__m256 even, __m256 odd,
+                                __m256* lo, __m256* hi) {
+  const __m256 lo_t = _mm256_unpacklo_ps(even, odd);  // 0, 1, 2, 3, 8, 9, ...
+  const __m256 hi_t = _mm256_unpackhi_ps(even, odd);  // 4, 5, 6, 7, 12, ...
+  *lo = _mm256_permute2f128_ps(lo_t, hi_t, 0x20);
+  *hi = _mm256_permute2f128_ps(lo_t, hi_t, 0x31);
+}
+
+static __inline __m256 Reverse(__m256 a) {
+  return _mm256_permutevar8x32_ps(a, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+static void rftfsub_128_AVX2(float* a) {
+  const float* c = rdft_w + 32;
+  int j1, j2, k1, k2;
+  float wkr, wki, xr, xi, yr, yi;
+  const __m256 mm_half = _mm256_set1_ps(0.5f);
+
+  // Vectorized code (eight at once).
+  //    Note: commented number are indexes for the first iteration of the loop.
+  for (j1 = 1, j2 = 2; j2 + 15 < 64; j1 += 8, j2 += 16) {
+    __m256 a_j2_p0, a_j2_p1, a_k2_p0, a_k2_p1;
+    __m256 a_j2_0n, a_j2_8n, a_k2_0n, a_k2_8n;
+    // Load 'wk'.
+    const __m256 c_j1 = _mm256_loadu_ps(&c[j1]);       //  1, ...,  8,
+    const __m256 c_k1 = _mm256_loadu_ps(&c[25 - j1]);  // 24, ..., 31,
+    const __m256 wkr_ = Reverse(_mm256_sub_ps(mm_half, c_k1));  // 31, ..., 24,
+    const __m256 wki_ = c_j1;                                   //  1, ...,  8,
+    // Load and deinterleave 'a'.
+    Deinterleave(_mm256_loadu_ps(&a[0 + j2]), _mm256_loadu_ps(&a[8 + j2]),
+                 &a_j2_p0, &a_j2_p1);  // 2, 4, ..., 16,  3, 5, ..., 17,
+    Deinterleave(_mm256_loadu_ps(&a[114 - j2]), _mm256_loadu_ps(&a[122 - j2]),
+                 &a_k2_p0, &a_k2_p1);  // 112, ..., 126,  113, ..., 127,
+    a_k2_p0 = Reverse(a_k2_p0);  // 126, 124, ..., 112,
+    a_k2_p1 = Reverse(a_k2_p1);  // 127, 125, ..., 113,
+    {
+      // Calculate 'x'.
+      const __m256 xr_ = _mm256_sub_ps(a_j2_p0, a_k2_p0);
+      const __m256 xi_ = _mm256_add_ps(a_j2_p1, a_k2_p1);
+      // Calculate product into 'y'.
+      //    yr = wkr * xr - wki * xi;
+      //    yi = wkr * xi + wki * xr;
+      const __m256 a_ = _mm256_mul_ps(wkr_, xr_);
+      const __m256 b_ = _mm256_mul_ps(wki_, xi_);
+      const __m256 c_ = _mm256_mul_ps(wkr_, xi_);
+      const __m256 d_ = _mm256_mul_ps(wki_, xr_);
+      const __m256 yr_ = _mm256_sub_ps(a_, b_);
+      const __m256 yi_ = _mm256_add_ps(c_, d_);
+      // Update 'a'.
+      //    a[j2 + 0] -= yr;
+      //    a[j2 + 1] -= yi;
+      //    a[k2 + 0] += yr;
+      //    a[k2 + 1] -= yi;
+      const __m256 a_j2_p0n = _mm256_sub_ps(a_j2_p0, yr_);
+      const __m256 a_j2_p1n = _mm256_sub_ps(a_j2_p1, yi_);
+      const __m256 a_k2_p0n = _mm256_add_ps(a_k2_p0, yr_);
+      const __m256 a_k2_p1n = _mm256_sub_ps(a_k2_p1, yi_);
+      // Shuffle in right order and store.
+      Interleave(a_j2_p0n, a_j2_p1n, &a_j2_0n, &a_j2_8n);
+      Interleave(Reverse(a_k2_p0n), Reverse(a_k2_p1n), &a_k2_0n, &a_k2_8n);
+    }
+    _mm256_storeu_ps(&a[0 + j2], a_j2_0n);
+    _mm256_storeu_ps(&a[8 + j2], a_j2_8n);
+    _mm256_storeu_ps(&a[114 - j2], a_k2_0n);
+    _mm256_storeu_ps(&a[122 - j2], a_k2_8n);
+  }
+  // Scalar code for the remaining items.
+  for (; j2 < 64; j1 += 1, j2 += 2) {
+    k2 = 128 - j2;
+    k1 = 32 - j1;
+    wkr = 0.5f - c[k1];
+    wki = c[j1];
+    xr = a[j2 + 0] - a[k2 + 0];
+    xi = a[j2 + 1] + a[k2 + 1];
+    yr = wkr * xr - wki * xi;
+    yi = wkr * xi + wki * xr;
+    a[j2 + 0] -= yr;
+    a[j2 + 1] -= yi;
+    a[k2 + 0] += yr;
+    a[k2 + 1] -= yi;
+  }
+}
+
+static void rftbsub_128_AVX2(float* a) {
+  const float* c = rdft_w + 32;
+  int j1, j2, k1, k2;
+  float wkr, wki, xr, xi, yr, yi;
+  const __m256 mm_half = _mm256_set1_ps(0.5f);
+
+  a[1] = -a[1];
+  // Vectorized code (eight at once).
+  //    Note: commented number are indexes for the first iteration of the loop.
+  for (j1 = 1, j2 = 2; j2 + 15 < 64; j1 += 8, j2 += 16) {
+    __m256 a_j2_p0, a_j2_p1, a_k2_p0, a_k2_p1;
+    __m256 a_j2_0n, a_j2_8n, a_k2_0n, a_k2_8n;
+    // Load 'wk'.
+    const __m256 c_j1 = _mm256_loadu_ps(&c[j1]);       //  1, ...,  8,
+    const __m256 c_k1 = _mm256_loadu_ps(&c[25 - j1]);  // 24, ..., 31,
+    const __m256 wkr_ = Reverse(_mm256_sub_ps(mm_half, c_k1));  // 31, ..., 24,
+    const __m256 wki_ = c_j1;                                   //  1, ...,  8,
+    // Load and deinterleave 'a'.
+    Deinterleave(_mm256_loadu_ps(&a[0 + j2]), _mm256_loadu_ps(&a[8 + j2]),
+                 &a_j2_p0, &a_j2_p1);  // 2, 4, ..., 16,  3, 5, ..., 17,
+    Deinterleave(_mm256_loadu_ps(&a[114 - j2]), _mm256_loadu_ps(&a[122 - j2]),
+                 &a_k2_p0, &a_k2_p1);  // 112, ..., 126,  113, ..., 127,
+    a_k2_p0 = Reverse(a_k2_p0);  // 126, 124, ..., 112,
+    a_k2_p1 = Reverse(a_k2_p1);  // 127, 125, ..., 113,
+    {
+      // Calculate 'x'.
+      const __m256 xr_ = _mm256_sub_ps(a_j2_p0, a_k2_p0);
+      const __m256 xi_ = _mm256_add_ps(a_j2_p1, a_k2_p1);
+      // Calculate product into 'y'.
+      //    yr = wkr * xr + wki * xi;
+      //    yi = wkr * xi - wki * xr;
+      const __m256 a_ = _mm256_mul_ps(wkr_, xr_);
+      const __m256 b_ = _mm256_mul_ps(wki_, xi_);
+      const __m256 c_ = _mm256_mul_ps(wkr_, xi_);
+      const __m256 d_ = _mm256_mul_ps(wki_, xr_);
+      const __m256 yr_ = _mm256_add_ps(a_, b_);
+      const __m256 yi_ = _mm256_sub_ps(c_, d_);
+      // Update 'a'.
+      //    a[j2 + 0] = a[j2 + 0] - yr;
+      //    a[j2 + 1] = yi - a[j2 + 1];
+      //    a[k2 + 0] = yr + a[k2 + 0];
+      //    a[k2 + 1] = yi - a[k2 + 1];
+      const __m256 a_j2_p0n = _mm256_sub_ps(a_j2_p0, yr_);
+      const __m256 a_j2_p1n = _mm256_sub_ps(yi_, a_j2_p1);
+      const __m256 a_k2_p0n = _mm256_add_ps(a_k2_p0, yr_);
+      const __m256 a_k2_p1n = _mm256_sub_ps(yi_, a_k2_p1);
+      // Shuffle in right order and store.
+      Interleave(a_j2_p0n, a_j2_p1n, &a_j2_0n, &a_j2_8n);
+      Interleave(Reverse(a_k2_p0n), Reverse(a_k2_p1n), &a_k2_0n, &a_k2_8n);
+    }
+    _mm256_storeu_ps(&a[0 + j2], a_j2_0n);
+    _mm256_storeu_ps(&a[8 + j2], a_j2_8n);
+    _mm256_storeu_ps(&a[114 - j2], a_k2_0n);
+    _mm256_storeu_ps(&a[122 - j2], a_k2_8n);
+  }
+  // Scalar code for the remaining items.
+  for (; j2 < 64; j1 += 1, j2 += 2) {
+    k2 = 128 - j2;
+    k1 = 32 - j1;
+    wkr = 0.5f - c[k1];
+    wki = c[j1];
+    xr = a[j2 + 0] - a[k2 + 0];
+    xi = a[j2 + 1] + a[k2 + 1];
+    yr = wkr * xr + wki * xi;
+    yi = wkr * xi - wki * xr;
+    a[j2 + 0] = a[j2 + 0] - yr;
+    a[j2 + 1] = yi - a[j2 + 1];
+    a[k2 + 0] = yr + a[k2 + 0];
+    a[k2 + 1] = yi - a[k2 + 1];
+  }
+  a[65] = -a[65];
+}
+
+void aec_rdft_init_avx2(void) {
+  rftfsub_128 = rftfsub_128_AVX2;
+  rftbsub_128 = rftbsub_128_AVX2;
+}
@@ -410,6 +410,12 @@ int32_t WebRtcAec_Process(void* aecInst,
     retVal = -1;
   }
 
+  if (WebRtcAec_delay_agnostic_enabled(aecpc->aec)) {
+    // The AEC core aligns the far-end buffer from the signals, so there is no
+    // startup phase waiting for a stable reported delay.
+    aecpc->startup_phase = 0;
+  }
+
   // This returns the value of aec->extended_filter_enabled.
   if (WebRtcAec_delay_correction_enabled(aecpc->aec)) {
     ProcessExtended(
@@ -758,7 +764,8 @@ static int ProcessNormal(aecpc_t* aecpc,
     }
   } else {
     // AEC is enabled.
-    if (WebRtcAec_reported_delay_enabled(aecpc->aec)) {
+    if (WebRtcAec_reported_delay_enabled(aecpc->aec) &&
+        !WebRtcAec_delay_agnostic_enabled(aecpc->aec)) {
       EstBufDelayNormal(aecpc);
     }
 
@@ -836,7 +843,8 @@ static void ProcessExtended(aecpc_t* self,
     self->startup_phase = 0;
   }
 
-  if (WebRtcAec_reported_delay_enabled(self->aec)) {
+  if (WebRtcAec_reported_delay_enabled(self->aec) &&
+      !WebRtcAec_delay_agnostic_enabled(self->aec)) {
     EstBufDelayExtended(self);
   }
 
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of the AEC on the far- and near-end recordings in
+// resources/, at every sample rate it supports. Reports the time per 10 ms
+// frame.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/modules/audio_processing/aec/include/echo_cancellation.h"
+#include "webrtc/modules/audio_processing/splitting_filter.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/typedefs.h"
+
+DEFINE_int32(repetitions, 10,
+             "The number of times to run through the recordings at each "
+             "sample rate.");
+DEFINE_bool(avx2, true,
+            "Use the AVX2 kernels if the CPU supports them. Disable to compare "
+            "against the SSE2 kernels.");
+
+namespace webrtc {
+namespace {
+
+const int kSampleRates[] = {8000, 16000, 32000};
+const int kNumSampleRates = sizeof(kSampleRates) / sizeof(*kSampleRates);
+// The recordings in resources/ are interleaved stereo; only the left channel
+// is used.
+const int kNumFileChannels = 2;
+const int kDelayMs = 20;
+const int k32kHzFrameLength = 320;
+
+WebRtc_CPUInfo g_cpu_info = NULL;
+
+// Hides AVX2 from the AEC's kernel selection.
+int GetCPUInfoWithoutAVX2(CPUFeature feature) {
+  if (feature == kAVX2)
+    return 0;
+  return g_cpu_info(feature);
+}
+
+// Reads the left channel of |file_name| into |samples|.
+bool ReadFile(const std::string& file_name, std::vector<float>* samples) {
+  FILE* file = fopen(file_name.c_str(), "rb");
+  if (!file) {
+    fprintf(stderr, "Failed to open %s\n", file_name.c_str());
+    return false;
+  }
+  int16_t frame[kNumFileChannels];
+  while (fread(frame, sizeof(*frame), kNumFileChannels, file) ==
+         static_cast<size_t>(kNumFileChannels)) {
+    samples->push_back(frame[0]);
+  }
+  fclose(file);
+  return true;
+}
+
+// Splits full-band 32 kHz |samples| into |low_band| and |high_band|, the
+// format the AEC expects at that rate, 10 ms at a time.
+void SplitBands(const std::vector<float>& samples,
+                std::vector<float>* low_band,
+                std::vector<float>* high_band) {
+  float state1[kSplittingFilterStateSize] = {0};
+  float state2[kSplittingFilterStateSize] = {0};
+  const int num_frames = static_cast<int>(samples.size()) / k32kHzFrameLength;
+  low_band->resize(num_frames * k32kHzFrameLength / 2);
+  high_band->resize(num_frames * k32kHzFrameLength / 2);
+  for (int i = 0; i < num_frames; ++i) {
+    SplittingFilterAnalysis(&samples[i * k32kHzFrameLength],
+                            k32kHzFrameLength,
+                            &(*low_band)[i * k32kHzFrameLength / 2],
+                            &(*high_band)[i * k32kHzFrameLength / 2],
+                            state1, state2);
+  }
+}
+
+// Returns the average time in nanoseconds to process one 10 ms frame at
+// |sample_rate_hz|, or -1 on failure.
+double BenchmarkRate(int sample_rate_hz) {
+  char far_name[32];
+  char near_name[32];
+  snprintf(far_name, sizeof(far_name), "far%d_stereo", sample_rate_hz / 1000);
+  snprintf(near_name, sizeof(near_name), "near%d_stereo",
+           sample_rate_hz / 1000);
+  std::vector<float> far;
+  std::vector<float> near;
+  if (!ReadFile(test::ResourcePath(far_name, "pcm"), &far) ||
+      !ReadFile(test::ResourcePath(near_name, "pcm"), &near)) {
+    return -1;
+  }
+
+  // Above 16 kHz the AEC runs on the lower band and only applies its gains
+  // to the upper band.
+  std::vector<float> far_low, near_low, near_high;
+  const bool split = sample_rate_hz > 16000;
+  if (split) {
+    std::vector<float> far_high;
+    SplitBands(far, &far_low, &far_high);
+    SplitBands(near, &near_low, &near_high);
+  } else {
+    far_low.swap(far);
+    near_low.swap(near);
+  }
+  // 10 ms in each band.
+  const int frame_length = split ? k32kHzFrameLength / 2 : sample_rate_hz / 100;
+  const int num_frames = static_cast<int>(
+      std::min(far_low.size(), near_low.size()) / frame_length);
+  if (num_frames == 0) {
+    fprintf(stderr, "No data at %d Hz\n", sample_rate_hz);
+    return -1;
+  }
+  std::vector<float> out(frame_length);
+  std::vector<float> out_high(frame_length);
+
+  void* aec = NULL;
+  if (WebRtcAec_Create(&aec) != 0)
+    return -1;
+  int64_t elapsed_us = 0;
+  for (int r = 0; r < FLAGS_repetitions; ++r) {
+    if (WebRtcAec_Init(aec, sample_rate_hz, sample_rate_hz) != 0) {
+      fprintf(stderr, "Failed to initialize at %d Hz\n", sample_rate_hz);
+      WebRtcAec_Free(aec);
+      return -1;
+    }
+    TickTime start = TickTime::Now();
+    for (int i = 0; i < num_frames; ++i) {
+      const int offset = i * frame_length;
+      if (WebRtcAec_BufferFarend(aec, &far_low[offset], frame_length) != 0 ||
+          WebRtcAec_Process(aec, &near_low[offset],
+                            split ? &near_high[offset] : NULL, &out[0],
+                            split ? &out_high[0] : NULL, frame_length,
+                            kDelayMs, 0) != 0) {
+        fprintf(stderr, "Failed to process at %d Hz\n", sample_rate_hz);
+        WebRtcAec_Free(aec);
+        return -1;
+      }
+    }
+    elapsed_us += (TickTime::Now() - start).Microseconds();
+  }
+  WebRtcAec_Free(aec);
+  return 1000.0 * elapsed_us / (static_cast<double>(num_frames) *
+                                FLAGS_repetitions);
+}
+
+void RunBenchmark() {
+  printf("%8s %12s\n", "rate_hz", "ns_per_frame");
+  for (int i = 0; i < kNumSampleRates; ++i) {
+    printf("%8d %12.0f\n", kSampleRates[i], BenchmarkRate(kSampleRates[i]));
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string usage = "Benchmarks the AEC on the recordings in resources/.\n"
+      "Example usage:\n" + std::string(argv[0]) + " --repetitions=100\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  webrtc::g_cpu_info = WebRtc_GetCPUInfo;
+  if (!FLAGS_avx2)
+    WebRtc_GetCPUInfo = webrtc::GetCPUInfoWithoutAVX2;
+  printf("AVX2 kernels %s.\n",
+         WebRtc_GetCPUInfo(kAVX2) ? "enabled" : "disabled");
+
+  webrtc::RunBenchmark();
+  return 0;
+}
@@ -12,16 +12,76 @@
 
 #include "webrtc/modules/audio_processing/aec/include/echo_cancellation.h"
 
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include <algorithm>
+#include <vector>
+
 extern "C" {
 #include "webrtc/modules/audio_processing/aec/aec_core.h"
+#include "webrtc/modules/audio_processing/aec/aec_core_internal.h"
+#include "webrtc/modules/audio_processing/aec/aec_rdft.h"
 }
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 namespace webrtc {
+namespace {
+
+// Returns a random value in [-|scale|, |scale|].
+float RandomValue(float scale) {
+  return scale * (2.0f * rand() / RAND_MAX - 1.0f);
+}
+
+// Runs the AEC at 16 kHz on a noise far-end whose echo reaches the near-end
+// |echo_delay_ms| later, while a delay of 0 ms is reported. Returns the echo
+// return loss enhancement, in dB, over the last second.
+float DelayedEchoErle(int delay_agnostic, int echo_delay_ms) {
+  const int kSampleRateHz = 16000;
+  const int kFrameLength = 160;
+  const int kNumFrames = 1000;
+  const int kErleFrames = 100;
+  const int echo_delay = echo_delay_ms * kSampleRateHz / 1000;
+  void* handle = NULL;
+  EXPECT_EQ(0, WebRtcAec_Create(&handle));
+  EXPECT_EQ(0, WebRtcAec_Init(handle, kSampleRateHz, kSampleRateHz));
+  WebRtcAec_enable_delay_agnostic(WebRtcAec_aec_core(handle), delay_agnostic);
+
+  srand(42);
+  std::vector<float> far_end(kNumFrames * kFrameLength);
+  for (size_t i = 0; i < far_end.size(); ++i) {
+    far_end[i] = RandomValue(10000.0f);
+  }
+  float near[kFrameLength];
+  float out[kFrameLength];
+  double near_energy = 0;
+  double out_energy = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    const int offset = i * kFrameLength;
+    for (int j = 0; j < kFrameLength; ++j) {
+      const int k = offset + j - echo_delay;
+      near[j] = k >= 0 ? 0.5f * far_end[k] : 0;
+    }
+    EXPECT_EQ(0, WebRtcAec_BufferFarend(handle, &far_end[offset],
+                                        kFrameLength));
+    EXPECT_EQ(0, WebRtcAec_Process(handle, near, NULL, out, NULL,
+                                   kFrameLength, 0, 0));
+    if (i >= kNumFrames - kErleFrames) {
+      for (int j = 0; j < kFrameLength; ++j) {
+        near_energy += near[j] * near[j];
+        out_energy += out[j] * out[j];
+      }
+    }
+  }
+  EXPECT_EQ(0, WebRtcAec_Free(handle));
+  return static_cast<float>(10 * log10(near_energy / (out_energy + 1)));
+}
+
+}  // namespace
 
 TEST(EchoCancellationTest, CreateAndFreeHandlesErrors) {
   EXPECT_EQ(-1, WebRtcAec_Create(NULL));
@@ -47,4 +107,84 @@ TEST(EchoCancellationTest, ApplyAecCoreHandle) {
   EXPECT_EQ(0, WebRtcAec_Free(handle));
 }
 
+TEST(EchoCancellationTest, DelayAgnosticAlignsEchoOutsideFilter) {
+  // The echo delay is 200 ms, while the normal filter covers 48 ms.
+  const int kEchoDelayMs = 200;
+  const float erle = DelayedEchoErle(0, kEchoDelayMs);
+  const float erle_delay_agnostic = DelayedEchoErle(1, kEchoDelayMs);
+  EXPECT_GT(erle_delay_agnostic, erle + 10);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// The AVX2 kernels should be bit-exact with the SSE2 ones, as the reference
+// output of ApmTest.Process does not depend on the CPU.
+TEST(EchoCancellationTest, Avx2KernelsMatchSse2) {
+  if (!WebRtc_GetCPUInfo(kAVX2))
+    return;
+  AecCore* aec = NULL;
+  ASSERT_EQ(0, WebRtcAec_CreateAec(&aec));
+  ASSERT_EQ(0, WebRtcAec_InitAec(aec, 16000));
+  const int num_bins = aec->num_partitions * PART_LEN1;
+  srand(42);
+  for (int i = 0; i < num_bins; ++i) {
+    aec->xfBuf[0][i] = RandomValue(1.0f);
+    aec->xfBuf[1][i] = RandomValue(1.0f);
+    aec->wfBuf[0][i] = RandomValue(1.0f);
+    aec->wfBuf[1][i] = RandomValue(1.0f);
+  }
+  // Start in the middle of the buffer to cover the wrap-around.
+  aec->xfBufBlockPos = aec->num_partitions / 2;
+  // Errors around the threshold, so that only some of them are limited.
+  float ef[2][PART_LEN1];
+  for (int i = 0; i < PART_LEN1; ++i) {
+    aec->xPow[i] = 1.0f + RandomValue(0.5f);
+    ef[0][i] = RandomValue(2 * aec->normal_error_threshold);
+    ef[1][i] = RandomValue(2 * aec->normal_error_threshold);
+  }
+  float yf_sse2[2][PART_LEN1] = {{0}};
+  float ef_sse2[2][PART_LEN1];
+  float fft[PART_LEN2];
+  memcpy(ef_sse2, ef, sizeof(ef));
+  WebRtcAec_InitAec_SSE2();
+  aec_rdft_init_sse2();
+  WebRtcAec_FilterFar(aec, yf_sse2);
+  WebRtcAec_ScaleErrorSignal(aec, ef_sse2);
+  // Start from an empty filter so that only the tiny update is compared.
+  float wf_buf_sse2[2][kExtendedNumPartitions * PART_LEN1];
+  float wf_buf_saved[2][kExtendedNumPartitions * PART_LEN1];
+  memcpy(wf_buf_saved, aec->wfBuf, sizeof(wf_buf_saved));
+  memset(aec->wfBuf, 0, sizeof(aec->wfBuf));
+  WebRtcAec_FilterAdaptation(aec, fft, ef_sse2);
+  memcpy(wf_buf_sse2, aec->wfBuf, sizeof(wf_buf_sse2));
+
+  float yf_avx2[2][PART_LEN1] = {{0}};
+  float ef_avx2[2][PART_LEN1];
+  memcpy(ef_avx2, ef, sizeof(ef));
+  memcpy(aec->wfBuf, wf_buf_saved, sizeof(wf_buf_saved));
+  WebRtcAec_InitAec_AVX2();
+  aec_rdft_init_avx2();
+  WebRtcAec_FilterFar(aec, yf_avx2);
+  WebRtcAec_ScaleErrorSignal(aec, ef_avx2);
+  memset(aec->wfBuf, 0, sizeof(aec->wfBuf));
+  WebRtcAec_FilterAdaptation(aec, fft, ef_avx2);
+
+  float max_update = 0;
+  for (int j = 0; j < 2; ++j) {
+    for (int i = 0; i < num_bins; ++i)
+      max_update = std::max(max_update, fabsf(wf_buf_sse2[j][i]));
+  }
+  ASSERT_GT(max_update, 0);
+  for (int j = 0; j < 2; ++j) {
+    for (int i = 0; i < PART_LEN1; ++i) {
+      EXPECT_EQ(yf_sse2[j][i], yf_avx2[j][i]);
+      EXPECT_EQ(ef_sse2[j][i], ef_avx2[j][i]);
+    }
+    for (int i = 0; i < num_bins; ++i) {
+      EXPECT_EQ(wf_buf_sse2[j][i], aec->wfBuf[j][i]);
+    }
+  }
+  EXPECT_EQ(0, WebRtcAec_FreeAec(aec));
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
 }  // namespace webrtc
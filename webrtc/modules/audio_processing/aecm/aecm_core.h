@@ -431,6 +431,12 @@ void WebRtcAecm_StoreAdaptiveChannelNeon(AecmCore_t* aecm,
 void WebRtcAecm_ResetAdaptiveChannelNeon(AecmCore_t* aecm);
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Sets the above function pointers to their SSE2 versions, defined in file
+// aecm_core_sse2.c.
+void WebRtcAecm_InitSSE2(void);
+#endif
+
 #if defined(MIPS32_LE)
 void WebRtcAecm_CalcLinearEnergies_mips(AecmCore_t* aecm,
                                         const uint16_t* far_spectrum,
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core AECM algorithm, SSE2 version of speed-critical functions. The
+ * results are bit exact with the generic C versions in aecm_core.c.
+ */
+
+#include "webrtc/modules/audio_processing/aecm/aecm_core.h"
+
+#include <emmintrin.h>
+#include <string.h>
+
+// Multiplies the signed |a| with the unsigned |b| into the 32-bit products of
+// the lower (|lo|) and the upper (|hi|) four lanes, i.e.
+// WEBRTC_SPL_MUL_16_U16(a, b).
+static __inline void MulS16U16(__m128i a, __m128i b, __m128i* lo,
+                               __m128i* hi) {
+  const __m128i low = _mm_mullo_epi16(a, b);
+  // The unsigned high half is off by |b| where |a| is negative.
+  const __m128i high = _mm_sub_epi16(
+      _mm_mulhi_epu16(a, b),
+      _mm_and_si128(_mm_srai_epi16(a, 15), b));
+  *lo = _mm_unpacklo_epi16(low, high);
+  *hi = _mm_unpackhi_epi16(low, high);
+}
+
+// Adds the four 32-bit lanes of |v|.
+static __inline uint32_t HorizontalSum(__m128i v) {
+  v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+  v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+  return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+static void CalcLinearEnergiesSSE2(AecmCore_t* aecm,
+                                   const uint16_t* far_spectrum,
+                                   int32_t* echo_est,
+                                   uint32_t* far_energy,
+                                   uint32_t* echo_energy_adapt,
+                                   uint32_t* echo_energy_stored) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i far_energy_4 = zero;
+  __m128i echo_energy_adapt_4 = zero;
+  __m128i echo_energy_stored_4 = zero;
+  int i;
+
+  // All sums wrap around like the uint32_t sums of the C version.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i far =
+        _mm_loadu_si128((const __m128i*)&far_spectrum[i]);
+    const __m128i stored =
+        _mm_loadu_si128((const __m128i*)&aecm->channelStored[i]);
+    const __m128i adapt =
+        _mm_loadu_si128((const __m128i*)&aecm->channelAdapt16[i]);
+    __m128i echo_lo, echo_hi;
+    __m128i adapt_low, adapt_high;
+
+    MulS16U16(stored, far, &echo_lo, &echo_hi);
+    _mm_storeu_si128((__m128i*)&echo_est[i], echo_lo);
+    _mm_storeu_si128((__m128i*)&echo_est[i + 4], echo_hi);
+    echo_energy_stored_4 = _mm_add_epi32(echo_energy_stored_4,
+                                         _mm_add_epi32(echo_lo, echo_hi));
+
+    // WEBRTC_SPL_UMUL_16_16(aecm->channelAdapt16[i], far_spectrum[i]).
+    adapt_low = _mm_mullo_epi16(adapt, far);
+    adapt_high = _mm_mulhi_epu16(adapt, far);
+    echo_energy_adapt_4 = _mm_add_epi32(
+        echo_energy_adapt_4,
+        _mm_add_epi32(_mm_unpacklo_epi16(adapt_low, adapt_high),
+                      _mm_unpackhi_epi16(adapt_low, adapt_high)));
+
+    far_energy_4 = _mm_add_epi32(
+        far_energy_4,
+        _mm_add_epi32(_mm_unpacklo_epi16(far, zero),
+                      _mm_unpackhi_epi16(far, zero)));
+  }
+
+  *far_energy += HorizontalSum(far_energy_4);
+  *echo_energy_adapt += HorizontalSum(echo_energy_adapt_4);
+  *echo_energy_stored += HorizontalSum(echo_energy_stored_4);
+
+  // The last bin.
+  echo_est[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
+                                      far_spectrum[i]);
+  *far_energy += (uint32_t)far_spectrum[i];
+  *echo_energy_adapt += WEBRTC_SPL_UMUL_16_16(aecm->channelAdapt16[i],
+                                              far_spectrum[i]);
+  *echo_energy_stored += (uint32_t)echo_est[i];
+}
+
+static void StoreAdaptiveChannelSSE2(AecmCore_t* aecm,
+                                     const uint16_t* far_spectrum,
+                                     int32_t* echo_est) {
+  int i;
+
+  // During startup we store the channel every block.
+  memcpy(aecm->channelStored, aecm->channelAdapt16,
+         sizeof(int16_t) * PART_LEN1);
+  // Recalculate echo estimate.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i far =
+        _mm_loadu_si128((const __m128i*)&far_spectrum[i]);
+    const __m128i stored =
+        _mm_loadu_si128((const __m128i*)&aecm->channelStored[i]);
+    __m128i echo_lo, echo_hi;
+    MulS16U16(stored, far, &echo_lo, &echo_hi);
+    _mm_storeu_si128((__m128i*)&echo_est[i], echo_lo);
+    _mm_storeu_si128((__m128i*)&echo_est[i + 4], echo_hi);
+  }
+  echo_est[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
+                                      far_spectrum[i]);
+}
+
+static void ResetAdaptiveChannelSSE2(AecmCore_t* aecm) {
+  const __m128i zero = _mm_setzero_si128();
+  int i;
+
+  // The stored channel has a significantly lower MSE than the adaptive one for
+  // two consecutive calculations. Reset the adaptive channel.
+  memcpy(aecm->channelAdapt16, aecm->channelStored,
+         sizeof(int16_t) * PART_LEN1);
+  // Restore the W32 channel, by interleaving zeros below the stored channel.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i stored =
+        _mm_loadu_si128((const __m128i*)&aecm->channelStored[i]);
+    _mm_storeu_si128((__m128i*)&aecm->channelAdapt32[i],
+                     _mm_unpacklo_epi16(zero, stored));
+    _mm_storeu_si128((__m128i*)&aecm->channelAdapt32[i + 4],
+                     _mm_unpackhi_epi16(zero, stored));
+  }
+  aecm->channelAdapt32[i] =
+      WEBRTC_SPL_LSHIFT_W32((int32_t)aecm->channelStored[i], 16);
+}
+
+void WebRtcAecm_InitSSE2(void) {
+  WebRtcAecm_CalcLinearEnergies = CalcLinearEnergiesSSE2;
+  WebRtcAecm_StoreAdaptiveChannel = StoreAdaptiveChannelSSE2;
+  WebRtcAecm_ResetAdaptiveChannel = ResetAdaptiveChannelSSE2;
+}
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/aecm/include/echo_control_mobile.h"
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const int kFrameLength = 160;
+const int kNumFrames = 500;
+const int kEchoDelay = 400;
+
+// Runs the AECM on a far-end signal and the near end picking up its echo with
+// the kernels selected by |cpu_info|.
+std::vector<int16_t> ProcessEcho(WebRtc_CPUInfo cpu_info) {
+  WebRtc_CPUInfo saved_cpu_info = WebRtc_GetCPUInfo;
+  WebRtc_GetCPUInfo = cpu_info;
+  void* handle = NULL;
+  EXPECT_EQ(0, WebRtcAecm_Create(&handle));
+  EXPECT_EQ(0, WebRtcAecm_Init(handle, kSampleRateHz));
+  WebRtc_GetCPUInfo = saved_cpu_info;
+
+  srand(42);
+  std::vector<int16_t> far_end(kNumFrames * kFrameLength);
+  for (size_t i = 0; i < far_end.size(); ++i) {
+    far_end[i] = static_cast<int16_t>(rand() % 20001 - 10000);
+  }
+  std::vector<int16_t> near_end(far_end.size());
+  for (size_t i = 0; i < near_end.size(); ++i) {
+    int echo = i >= kEchoDelay ? far_end[i - kEchoDelay] / 2 : 0;
+    near_end[i] = static_cast<int16_t>(echo + rand() % 201 - 100);
+  }
+
+  std::vector<int16_t> out(near_end.size());
+  for (int i = 0; i < kNumFrames; ++i) {
+    const int offset = i * kFrameLength;
+    EXPECT_EQ(0, WebRtcAecm_BufferFarend(handle, &far_end[offset],
+                                         kFrameLength));
+    EXPECT_EQ(0, WebRtcAecm_Process(handle, &near_end[offset], NULL,
+                                    &out[offset], kFrameLength, 0));
+  }
+  EXPECT_EQ(0, WebRtcAecm_Free(handle));
+  return out;
+}
+
+}  // namespace
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(EchoControlMobileTest, Sse2KernelsAreBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  EXPECT_TRUE(ProcessEcho(WebRtc_GetCPUInfoNoASM) ==
+              ProcessEcho(WebRtc_GetCPUInfo));
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
+}  // namespace webrtc
@@ -113,10 +113,10 @@ static const int32_t kTargetLevelTable[64] = {134209536, 106606424, 84680493, 67
 int WebRtcAgc_AddMic(void *state, int16_t *in_mic, int16_t *in_mic_H,
                      int16_t samples)
 {
-    int32_t nrg, max_nrg, sample, tmp32;
+    int32_t sample, tmp32;
     int32_t *ptr;
     uint16_t targetGainIdx, gain;
-    int16_t i, n, L, M, subFrames, tmp16, tmp_speech[16];
+    int16_t i, L, M, subFrames, tmp16, tmp_speech[16];
     Agc_t *stt;
     stt = (Agc_t *)state;
 
@@ -272,20 +272,7 @@ int WebRtcAgc_AddMic(void *state, int16_t *in_mic, int16_t *in_mic_H,
         ptr = stt->env[0];
     }
 
-    for (i = 0; i < M; i++)
-    {
-        /* iterate over samples */
-        max_nrg = 0;
-        for (n = 0; n < L; n++)
-        {
-            nrg = WEBRTC_SPL_MUL_16_16(in_mic[i * L + n], in_mic[i * L + n]);
-            if (nrg > max_nrg)
-            {
-                max_nrg = nrg;
-            }
-        }
-        ptr[i] = max_nrg;
-    }
+    WebRtcAgc_CalcEnvelope(in_mic, M, L, ptr);
 
     /* compute energy */
     if ((M == 10) && (stt->inQueue > 0))
@@ -1500,6 +1487,8 @@ int WebRtcAgc_Create(void **agcInst)
         return -1;
     }
 
+    WebRtcSpl_Init();
+
 #ifdef AGC_DEBUG
     stt->fpt = fopen("./agc_test_log.txt", "wt");
     stt->agcLog = fopen("./agc_debug_log.txt", "wt");
@@ -21,6 +21,7 @@
 #endif
 
 #include "webrtc/modules/audio_processing/agc/include/gain_control.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 // To generate the gaintable, copy&paste the following lines to a Matlab window:
 // MaxGain = 6; MinGain = 0; CompRatio = 3; Knee = 1;
@@ -258,6 +259,83 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable, // Q16
     return 0;
 }
 
+static void CalcEnvelopeC(const int16_t* in, int num_subframes,
+                          int subframe_length, int32_t* env)
+{
+    int32_t nrg, max_nrg;
+    int k, n;
+
+    // iterate over sub frames
+    for (k = 0; k < num_subframes; k++)
+    {
+        // iterate over samples
+        max_nrg = 0;
+        for (n = 0; n < subframe_length; n++)
+        {
+            nrg = WEBRTC_SPL_MUL_16_16(in[k * subframe_length + n],
+                                       in[k * subframe_length + n]);
+            if (nrg > max_nrg)
+            {
+                max_nrg = nrg;
+            }
+        }
+        env[k] = max_nrg;
+    }
+}
+
+static void ApplyDigitalGainC(const int32_t* gains, int subframe_length_log2,
+                              int16_t* out)
+{
+    const int L = 1 << subframe_length_log2;
+    int32_t gain32, delta, out_tmp, tmp32;
+    int k, n;
+
+    // handle first sub frame separately
+    delta = WEBRTC_SPL_LSHIFT_W32(gains[1] - gains[0],
+                                  (4 - subframe_length_log2));
+    gain32 = WEBRTC_SPL_LSHIFT_W32(gains[0], 4);
+    // iterate over samples
+    for (n = 0; n < L; n++)
+    {
+        tmp32 = WEBRTC_SPL_MUL((int32_t)out[n],
+                               WEBRTC_SPL_RSHIFT_W32(gain32 + 127, 7));
+        out_tmp = WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
+        if (out_tmp > 4095)
+        {
+            out[n] = (int16_t)32767;
+        } else if (out_tmp < -4096)
+        {
+            out[n] = (int16_t)-32768;
+        } else
+        {
+            tmp32 = WEBRTC_SPL_MUL((int32_t)out[n],
+                                   WEBRTC_SPL_RSHIFT_W32(gain32, 4));
+            out[n] = (int16_t)WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
+        }
+        gain32 += delta;
+    }
+    // iterate over subframes
+    for (k = 1; k < 10; k++)
+    {
+        delta = WEBRTC_SPL_LSHIFT_W32(gains[k+1] - gains[k],
+                                      (4 - subframe_length_log2));
+        gain32 = WEBRTC_SPL_LSHIFT_W32(gains[k], 4);
+        // iterate over samples
+        for (n = 0; n < L; n++)
+        {
+            tmp32 = WEBRTC_SPL_MUL((int32_t)out[k * L + n],
+                                   WEBRTC_SPL_RSHIFT_W32(gain32, 4));
+            out[k * L + n] = (int16_t)WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
+            gain32 += delta;
+        }
+    }
+}
+
+// Initialized to the C versions in case WebRtcAgc_AddMic() is called before
+// WebRtcAgc_Init().
+CalcEnvelope WebRtcAgc_CalcEnvelope = CalcEnvelopeC;
+ApplyDigitalGain WebRtcAgc_ApplyDigitalGain = ApplyDigitalGainC;
+
 int32_t WebRtcAgc_InitDigital(DigitalAgc_t *stt, int16_t agcMode)
 {
 
@@ -282,6 +360,17 @@ int32_t WebRtcAgc_InitDigital(DigitalAgc_t *stt, int16_t agcMode)
     WebRtcAgc_InitVad(&stt->vadNearend);
     WebRtcAgc_InitVad(&stt->vadFarend);
 
+    // Initialize function pointers.
+    WebRtcAgc_CalcEnvelope = CalcEnvelopeC;
+    WebRtcAgc_ApplyDigitalGain = ApplyDigitalGainC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+        WebRtcAgc_InitSSE2();
+    }
+#endif
+
     return 0;
 }
 
@@ -303,17 +392,16 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc_t *stt, const int16_t *in_near,
     // array for gains (one value per ms, incl start & end)
     int32_t gains[11];
 
-    int32_t out_tmp, tmp32;
+    int32_t tmp32;
     int32_t env[10];
-    int32_t nrg, max_nrg;
     int32_t cur_level;
-    int32_t gain32, delta;
+    int32_t gain32;
     int16_t logratio;
     int16_t lower_thr, upper_thr;
     int16_t zeros = 0, zeros_fast, frac = 0;
     int16_t decay;
     int16_t gate, gain_adj;
-    int16_t k, n;
+    int16_t k;
     int16_t L, L2; // samples/subframe
 
     // determine number of samples per ms
@@ -402,21 +490,7 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc_t *stt, const int16_t *in_near,
     fprintf(stt->logFile, "%5.2f\t%d\t%d\t%d\t", (float)(stt->frameCounter) / 100, logratio, decay, stt->vadNearend.stdLongTerm);
 #endif
     // Find max amplitude per sub frame
-    // iterate over sub frames
-    for (k = 0; k < 10; k++)
-    {
-        // iterate over samples
-        max_nrg = 0;
-        for (n = 0; n < L; n++)
-        {
-            nrg = WEBRTC_SPL_MUL_16_16(out[k * L + n], out[k * L + n]);
-            if (nrg > max_nrg)
-            {
-                max_nrg = nrg;
-            }
-        }
-        env[k] = max_nrg;
-    }
+    WebRtcAgc_CalcEnvelope(out, 10, L, env);
 
     // Calculate gain per sub frame
     gains[0] = stt->gain;
@@ -559,70 +633,10 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc_t *stt, const int16_t *in_near,
     stt->gain = gains[10];
 
     // Apply gain
-    // handle first sub frame separately
-    delta = WEBRTC_SPL_LSHIFT_W32(gains[1] - gains[0], (4 - L2));
-    gain32 = WEBRTC_SPL_LSHIFT_W32(gains[0], 4);
-    // iterate over samples
-    for (n = 0; n < L; n++)
-    {
-        // For lower band
-        tmp32 = WEBRTC_SPL_MUL((int32_t)out[n], WEBRTC_SPL_RSHIFT_W32(gain32 + 127, 7));
-        out_tmp = WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
-        if (out_tmp > 4095)
-        {
-            out[n] = (int16_t)32767;
-        } else if (out_tmp < -4096)
-        {
-            out[n] = (int16_t)-32768;
-        } else
-        {
-            tmp32 = WEBRTC_SPL_MUL((int32_t)out[n], WEBRTC_SPL_RSHIFT_W32(gain32, 4));
-            out[n] = (int16_t)WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
-        }
-        // For higher band
-        if (FS == 32000)
-        {
-            tmp32 = WEBRTC_SPL_MUL((int32_t)out_H[n],
-                                   WEBRTC_SPL_RSHIFT_W32(gain32 + 127, 7));
-            out_tmp = WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
-            if (out_tmp > 4095)
-            {
-                out_H[n] = (int16_t)32767;
-            } else if (out_tmp < -4096)
-            {
-                out_H[n] = (int16_t)-32768;
-            } else
-            {
-                tmp32 = WEBRTC_SPL_MUL((int32_t)out_H[n],
-                                       WEBRTC_SPL_RSHIFT_W32(gain32, 4));
-                out_H[n] = (int16_t)WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
-            }
-        }
-        //
-
-        gain32 += delta;
-    }
-    // iterate over subframes
-    for (k = 1; k < 10; k++)
+    WebRtcAgc_ApplyDigitalGain(gains, L2, out);
+    if (FS == 32000)
     {
-        delta = WEBRTC_SPL_LSHIFT_W32(gains[k+1] - gains[k], (4 - L2));
-        gain32 = WEBRTC_SPL_LSHIFT_W32(gains[k], 4);
-        // iterate over samples
-        for (n = 0; n < L; n++)
-        {
-            // For lower band
-            tmp32 = WEBRTC_SPL_MUL((int32_t)out[k * L + n],
-                                   WEBRTC_SPL_RSHIFT_W32(gain32, 4));
-            out[k * L + n] = (int16_t)WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
-            // For higher band
-            if (FS == 32000)
-            {
-                tmp32 = WEBRTC_SPL_MUL((int32_t)out_H[k * L + n],
-                                       WEBRTC_SPL_RSHIFT_W32(gain32, 4));
-                out_H[k * L + n] = (int16_t)WEBRTC_SPL_RSHIFT_W32(tmp32 , 16);
-            }
-            gain32 += delta;
-        }
+        WebRtcAgc_ApplyDigitalGain(gains, L2, out_H);
     }
 
     return 0;
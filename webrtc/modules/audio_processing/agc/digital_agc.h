@@ -69,6 +69,25 @@ int16_t WebRtcAgc_ProcessVad(AgcVad_t *vadInst, // (i) VAD state
                              const int16_t *in, // (i) Speech signal
                              int16_t nrSamples); // (i) number of samples
 
+// Computes the envelope, the maximum energy of a sample, of |num_subframes|
+// consecutive sub frames of |subframe_length| samples of |in|.
+typedef void (*CalcEnvelope)(const int16_t* in, int num_subframes,
+                             int subframe_length, int32_t* env);
+extern CalcEnvelope WebRtcAgc_CalcEnvelope;
+
+// Applies the gains of the 10 sub frames of 1 << |subframe_length_log2|
+// samples to |out|, interpolated linearly from |gains|[k] (Q16) to
+// |gains|[k + 1] over sub frame k.
+typedef void (*ApplyDigitalGain)(const int32_t* gains,
+                                 int subframe_length_log2, int16_t* out);
+extern ApplyDigitalGain WebRtcAgc_ApplyDigitalGain;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Sets the above function pointers to their SSE2 versions, defined in file
+// digital_agc_sse2.c.
+void WebRtcAgc_InitSSE2(void);
+#endif
+
 int32_t WebRtcAgc_CalculateGainTable(int32_t *gainTable, // Q16
                                      int16_t compressionGaindB, // Q0 (in dB)
                                      int16_t targetLevelDbfs,// Q0 (in dB)
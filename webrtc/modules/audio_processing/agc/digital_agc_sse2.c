@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The digital AGC, SSE2 version of speed-critical functions. The results are
+ * bit exact with the generic C versions in digital_agc.c.
+ */
+
+#include "webrtc/modules/audio_processing/agc/digital_agc.h"
+
+#include <emmintrin.h>
+
+// Returns the largest magnitude of the eight samples in |v|, where the
+// magnitude of -32768 is 32768. Squaring it gives the largest energy.
+static __inline __m128i MaxMagnitude(__m128i max, __m128i v) {
+  const __m128i sign = _mm_srai_epi16(v, 15);
+  const __m128i magnitude = _mm_sub_epi16(_mm_xor_si128(v, sign), sign);
+  // There is no unsigned 16-bit max in SSE2. Offset both to signed.
+  return _mm_max_epi16(max, _mm_xor_si128(magnitude, _mm_set1_epi16(-32768)));
+}
+
+static void CalcEnvelopeSSE2(const int16_t* in, int num_subframes,
+                             int subframe_length, int32_t* env) {
+  int k, n;
+  for (k = 0; k < num_subframes; k++) {
+    const int16_t* subframe = &in[k * subframe_length];
+    __m128i max = _mm_set1_epi16(-32768);
+    int32_t max_magnitude;
+    for (n = 0; n + 8 <= subframe_length; n += 8) {
+      max = MaxMagnitude(
+          max, _mm_loadu_si128((const __m128i*)&subframe[n]));
+    }
+    max = _mm_max_epi16(max, _mm_srli_si128(max, 8));
+    max = _mm_max_epi16(max, _mm_srli_si128(max, 4));
+    max = _mm_max_epi16(max, _mm_srli_si128(max, 2));
+    max_magnitude = (_mm_cvtsi128_si32(max) & 0xFFFF) ^ 0x8000;
+    env[k] = max_magnitude * max_magnitude;
+    for (; n < subframe_length; n++) {
+      const int32_t nrg = WEBRTC_SPL_MUL_16_16(subframe[n], subframe[n]);
+      if (nrg > env[k]) {
+        env[k] = nrg;
+      }
+    }
+  }
+}
+
+// Packs the low 16 bits of the 32-bit lanes of |lo| and |hi|.
+static __inline __m128i PackLow16(__m128i lo, __m128i hi) {
+  return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16),
+                         _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+}
+
+// Returns (|samples| * |gain|) >> 16, truncated to 16 bits like the C version,
+// for eight samples and the eight 32-bit gains in |gain_lo| and |gain_hi|. With
+// |gain| = 65536 * gain_high + gain_low the product is split into
+// 65536 * samples * gain_high + samples * gain_low, whose upper 16 bits only
+// need 16-bit multiplications.
+static __inline __m128i ScaleSamples(__m128i samples, __m128i gain_lo,
+                                     __m128i gain_hi) {
+  const __m128i gain_high = _mm_packs_epi32(_mm_srai_epi32(gain_lo, 16),
+                                            _mm_srai_epi32(gain_hi, 16));
+  const __m128i gain_low = PackLow16(gain_lo, gain_hi);
+  // The high half of the signed |samples| times the unsigned |gain_low| is
+  // off by |gain_low| where |samples| is negative.
+  const __m128i low_product = _mm_sub_epi16(
+      _mm_mulhi_epu16(samples, gain_low),
+      _mm_and_si128(_mm_srai_epi16(samples, 15), gain_low));
+  return _mm_add_epi16(_mm_mullo_epi16(samples, gain_high), low_product);
+}
+
+static void ApplyDigitalGainSSE2(const int32_t* gains,
+                                 int subframe_length_log2, int16_t* out) {
+  const int L = 1 << subframe_length_log2;
+  int k, n;
+  for (k = 0; k < 10; k++) {
+    const int32_t delta = WEBRTC_SPL_LSHIFT_W32(gains[k + 1] - gains[k],
+                                                (4 - subframe_length_log2));
+    const int32_t gain32 = WEBRTC_SPL_LSHIFT_W32(gains[k], 4);
+    const __m128i step = _mm_set1_epi32(4 * delta);
+    // |gain32| of the samples in each lane.
+    __m128i gain_lo = _mm_add_epi32(_mm_set1_epi32(gain32),
+                                    _mm_setr_epi32(0, delta, 2 * delta,
+                                                   3 * delta));
+    __m128i gain_hi = _mm_add_epi32(gain_lo, step);
+    int16_t* subframe = &out[k * L];
+    for (n = 0; n < L; n += 8) {
+      const __m128i samples = _mm_loadu_si128((const __m128i*)&subframe[n]);
+      __m128i scaled = ScaleSamples(samples, _mm_srai_epi32(gain_lo, 4),
+                                    _mm_srai_epi32(gain_hi, 4));
+      if (k == 0) {
+        // Saturate the samples of the first subframe the gain would drive far
+        // beyond the 16-bit range.
+        const __m128i round = _mm_set1_epi32(127);
+        const __m128i out_tmp = ScaleSamples(
+            samples, _mm_srai_epi32(_mm_add_epi32(gain_lo, round), 7),
+            _mm_srai_epi32(_mm_add_epi32(gain_hi, round), 7));
+        const __m128i above = _mm_cmpgt_epi16(out_tmp, _mm_set1_epi16(4095));
+        const __m128i below = _mm_cmplt_epi16(out_tmp, _mm_set1_epi16(-4096));
+        scaled = _mm_or_si128(
+            _mm_andnot_si128(_mm_or_si128(above, below), scaled),
+            _mm_or_si128(_mm_and_si128(above, _mm_set1_epi16(32767)),
+                         _mm_and_si128(below, _mm_set1_epi16(-32768))));
+      }
+      _mm_storeu_si128((__m128i*)&subframe[n], scaled);
+      gain_lo = _mm_add_epi32(gain_hi, step);
+      gain_hi = _mm_add_epi32(gain_lo, step);
+    }
+  }
+}
+
+void WebRtcAgc_InitSSE2(void) {
+  WebRtcAgc_CalcEnvelope = CalcEnvelopeSSE2;
+  WebRtcAgc_ApplyDigitalGain = ApplyDigitalGainSSE2;
+}
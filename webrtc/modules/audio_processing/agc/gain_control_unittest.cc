@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/agc/include/gain_control.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumFrames = 500;
+const int32_t kMinMicLevel = 0;
+const int32_t kMaxMicLevel = 255;
+
+// Runs the AGC in |agc_mode| on speech-like bursts at |sample_rate_hz| with the
+// kernels selected by |cpu_info|. At 32 kHz the same signal is fed to the
+// upper band and both output bands are returned back to back.
+std::vector<int16_t> ProcessGain(WebRtc_CPUInfo cpu_info,
+                                 int16_t agc_mode,
+                                 uint32_t sample_rate_hz) {
+  // The AGC uses signal processing library functions set by WebRtcSpl_Init().
+  WebRtcSpl_Init();
+  WebRtc_CPUInfo saved_cpu_info = WebRtc_GetCPUInfo;
+  WebRtc_GetCPUInfo = cpu_info;
+  void* handle = NULL;
+  EXPECT_EQ(0, WebRtcAgc_Create(&handle));
+  EXPECT_EQ(0, WebRtcAgc_Init(handle, kMinMicLevel, kMaxMicLevel, agc_mode,
+                              sample_rate_hz));
+  WebRtc_GetCPUInfo = saved_cpu_info;
+  WebRtcAgc_config_t config;
+  config.targetLevelDbfs = 3;
+  config.compressionGaindB = 15;
+  config.limiterEnable = kAgcTrue;
+  EXPECT_EQ(0, WebRtcAgc_set_config(handle, config));
+
+  const int frame_length = sample_rate_hz == 8000 ? 80 : 160;
+  srand(42);
+  std::vector<int16_t> in(kNumFrames * frame_length);
+  for (size_t i = 0; i < in.size(); ++i) {
+    // A modulated tone with loud bursts, to make the gain both rise and fall
+    // and saturate the output at the onsets of the bursts.
+    const double amplitude =
+        i % 24000 < 2000 ? 30000 : 8000 * fabs(sin(0.003 * i));
+    in[i] = static_cast<int16_t>(amplitude * cos(0.07 * (i % 24000)) +
+                                 rand() % 101 - 50);
+  }
+
+  const bool split_bands = sample_rate_hz == 32000;
+  std::vector<int16_t> in_high_band(in);
+  std::vector<int16_t> out(in.size());
+  std::vector<int16_t> out_high_band(split_bands ? in.size() : 0);
+  int32_t mic_level = 127;
+  for (int i = 0; i < kNumFrames; ++i) {
+    const int offset = i * frame_length;
+    int16_t* high_band = split_bands ? &in_high_band[offset] : NULL;
+    int32_t mic_level_out = 0;
+    if (agc_mode == kAgcModeAdaptiveDigital) {
+      EXPECT_EQ(0, WebRtcAgc_VirtualMic(handle, &in[offset], high_band,
+                                        frame_length, mic_level,
+                                        &mic_level_out));
+      mic_level = mic_level_out;
+    } else {
+      EXPECT_EQ(0, WebRtcAgc_AddMic(handle, &in[offset], high_band,
+                                    frame_length));
+    }
+    uint8_t saturation_warning = 0;
+    EXPECT_EQ(0, WebRtcAgc_Process(
+        handle, &in[offset], high_band, frame_length, &out[offset],
+        split_bands ? &out_high_band[offset] : NULL, mic_level,
+        &mic_level_out, 0, &saturation_warning));
+    mic_level = mic_level_out;
+  }
+  out.insert(out.end(), out_high_band.begin(), out_high_band.end());
+  EXPECT_EQ(0, WebRtcAgc_Free(handle));
+  return out;
+}
+
+}  // namespace
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(GainControlTest, Sse2KernelsAreBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const int16_t kAgcModes[] = {kAgcModeAdaptiveAnalog, kAgcModeAdaptiveDigital,
+                               kAgcModeFixedDigital};
+  const uint32_t kSampleRatesHz[] = {8000, 16000, 32000};
+  for (size_t i = 0; i < sizeof(kAgcModes) / sizeof(*kAgcModes); ++i) {
+    for (size_t j = 0; j < sizeof(kSampleRatesHz) / sizeof(*kSampleRatesHz);
+         ++j) {
+      SCOPED_TRACE(kAgcModes[i]);
+      SCOPED_TRACE(kSampleRatesHz[j]);
+      EXPECT_TRUE(
+          ProcessGain(WebRtc_GetCPUInfoNoASM, kAgcModes[i],
+                      kSampleRatesHz[j]) ==
+          ProcessGain(WebRtc_GetCPUInfo, kAgcModes[i], kSampleRatesHz[j]));
+    }
+  }
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
+}  // namespace webrtc
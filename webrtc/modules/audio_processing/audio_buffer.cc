@@ -145,6 +145,7 @@ AudioBuffer::AudioBuffer(int input_samples_per_channel,
     mixed_low_pass_valid_(false),
     reference_copied_(false),
     activity_(AudioFrame::kVadUnknown),
+    float_processing_(false),
     keyboard_data_(NULL),
     channels_(new IFChannelBuffer(proc_samples_per_channel_,
                                   num_proc_channels_)) {
@@ -228,6 +229,15 @@ void AudioBuffer::CopyFrom(const float* const* data,
     data_ptr = process_buffer_->channels();
   }
 
+  if (float_processing_) {
+    // Scale to the int16 range, but keep the precision.
+    for (int i = 0; i < num_proc_channels_; ++i) {
+      FloatToFloatS16(data_ptr[i], proc_samples_per_channel_,
+                      channels_->fbuf()->channel(i));
+    }
+    return;
+  }
+
   // Convert to int16.
   for (int i = 0; i < num_proc_channels_; ++i) {
     ScaleAndRoundToInt16(data_ptr[i], proc_samples_per_channel_,
@@ -248,9 +258,15 @@ void AudioBuffer::CopyTo(int samples_per_channel,
     data_ptr = process_buffer_->channels();
   }
   for (int i = 0; i < num_proc_channels_; ++i) {
-    ScaleToFloat(channels_->ibuf()->channel(i),
-                 proc_samples_per_channel_,
-                 data_ptr[i]);
+    if (float_processing_) {
+      FloatS16ToFloat(channels_->fbuf_const()->channel(i),
+                      proc_samples_per_channel_,
+                      data_ptr[i]);
+    } else {
+      ScaleToFloat(channels_->ibuf()->channel(i),
+                   proc_samples_per_channel_,
+                   data_ptr[i]);
+    }
   }
 
   // Resample.
@@ -339,6 +355,24 @@ float* AudioBuffer::high_pass_split_data_f(int channel) {
       : NULL;
 }
 
+float* const* AudioBuffer::channels_f() {
+  mixed_low_pass_valid_ = false;
+  return channels_->fbuf()->channels();
+}
+
+float* const* AudioBuffer::low_pass_split_channels_f() {
+  mixed_low_pass_valid_ = false;
+  return split_channels_low_.get()
+      ? split_channels_low_->fbuf()->channels()
+      : channels_f();
+}
+
+float* const* AudioBuffer::high_pass_split_channels_f() {
+  return split_channels_high_.get()
+      ? split_channels_high_->fbuf()->channels()
+      : NULL;
+}
+
 const int16_t* AudioBuffer::mixed_low_pass_data() {
   // Currently only mixing stereo to mono is supported.
   assert(num_proc_channels_ == 1 || num_proc_channels_ == 2);
@@ -386,6 +420,14 @@ AudioFrame::VADActivity AudioBuffer::activity() const {
   return activity_;
 }
 
+void AudioBuffer::set_float_processing(bool enable) {
+  float_processing_ = enable;
+}
+
+bool AudioBuffer::float_processing() const {
+  return float_processing_;
+}
+
 int AudioBuffer::num_channels() const {
   return num_proc_channels_;
 }
@@ -411,16 +453,10 @@ void AudioBuffer::DeinterleaveFrom(AudioFrame* frame) {
   assert(frame->samples_per_channel_ ==  proc_samples_per_channel_);
   InitForNewData();
   activity_ = frame->vad_activity_;
+  float_processing_ = false;
 
-  int16_t* interleaved = frame->data_;
-  for (int i = 0; i < num_proc_channels_; i++) {
-    int16_t* deinterleaved = channels_->ibuf()->channel(i);
-    int interleaved_idx = i;
-    for (int j = 0; j < proc_samples_per_channel_; j++) {
-      deinterleaved[j] = interleaved[interleaved_idx];
-      interleaved_idx += num_proc_channels_;
-    }
-  }
+  Deinterleave(frame->data_, proc_samples_per_channel_, num_proc_channels_,
+               channels_->ibuf()->channels());
 }
 
 void AudioBuffer::InterleaveTo(AudioFrame* frame, bool data_changed) const {
@@ -434,15 +470,8 @@ void AudioBuffer::InterleaveTo(AudioFrame* frame, bool data_changed) const {
     return;
   }
 
-  int16_t* interleaved = frame->data_;
-  for (int i = 0; i < num_proc_channels_; i++) {
-    int16_t* deinterleaved = channels_->ibuf()->channel(i);
-    int interleaved_idx = i;
-    for (int j = 0; j < proc_samples_per_channel_; j++) {
-      interleaved[interleaved_idx] = deinterleaved[j];
-      interleaved_idx += num_proc_channels_;
-    }
-  }
+  Interleave(channels_->ibuf()->channels(), proc_samples_per_channel_,
+             num_proc_channels_, frame->data_);
 }
 
 void AudioBuffer::CopyLowPassToReference() {
@@ -15,6 +15,7 @@
 
 #include "webrtc/modules/audio_processing/common.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/modules/audio_processing/splitting_filter.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
 #include "webrtc/system_wrappers/interface/scoped_vector.h"
@@ -25,21 +26,6 @@ namespace webrtc {
 class PushSincResampler;
 class IFChannelBuffer;
 
-struct SplitFilterStates {
-  SplitFilterStates() {
-    memset(analysis_filter_state1, 0, sizeof(analysis_filter_state1));
-    memset(analysis_filter_state2, 0, sizeof(analysis_filter_state2));
-    memset(synthesis_filter_state1, 0, sizeof(synthesis_filter_state1));
-    memset(synthesis_filter_state2, 0, sizeof(synthesis_filter_state2));
-  }
-
-  static const int kStateSize = 6;
-  int analysis_filter_state1[kStateSize];
-  int analysis_filter_state2[kStateSize];
-  int synthesis_filter_state1[kStateSize];
-  int synthesis_filter_state2[kStateSize];
-};
-
 class AudioBuffer {
  public:
   // TODO(ajm): Switch to take ChannelLayouts.
@@ -77,6 +63,10 @@ class AudioBuffer {
   const float* low_pass_split_data_f(int channel) const;
   float* high_pass_split_data_f(int channel);
   const float* high_pass_split_data_f(int channel) const;
+  // Float arrays of all the channels, for processing them together.
+  float* const* channels_f();
+  float* const* low_pass_split_channels_f();
+  float* const* high_pass_split_channels_f();
 
   const float* keyboard_data() const;
 
@@ -85,6 +75,13 @@ class AudioBuffer {
   void set_activity(AudioFrame::VADActivity activity);
   AudioFrame::VADActivity activity() const;
 
+  // When enabled, CopyFrom() keeps the data in float instead of converting it
+  // to int16, and CopyTo() reads it back without rounding. Components with a
+  // float implementation should then use the float accessors with
+  // float_processing() as a hint. DeinterleaveFrom() always disables it.
+  void set_float_processing(bool enable);
+  bool float_processing() const;
+
   // Use for int16 interleaved data.
   void DeinterleaveFrom(AudioFrame* audioFrame);
   // If |data_changed| is false, only the non-audio data members will be copied
@@ -113,6 +110,7 @@ class AudioBuffer {
   bool mixed_low_pass_valid_;
   bool reference_copied_;
   AudioFrame::VADActivity activity_;
+  bool float_processing_;
 
   const float* keyboard_data_;
   scoped_ptr<IFChannelBuffer> channels_;
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/audio_frame_queue.h"
+
+#include <assert.h>
+
+namespace webrtc {
+
+AudioFrameQueue::AudioFrameQueue(int capacity)
+    : frames_(new AudioFrame[capacity]),
+      capacity_(capacity),
+      size_(0),
+      read_pos_(0),
+      write_pos_(0) {
+  assert(capacity > 0);
+}
+
+AudioFrameQueue::~AudioFrameQueue() {}
+
+bool AudioFrameQueue::Push(const AudioFrame& frame) {
+  // Only the consumer can change the size while we are here, and it can only
+  // decrease it.
+  if (size() >= capacity_)
+    return false;
+  frames_[write_pos_].CopyFrom(frame);
+  ++size_;
+  write_pos_ = (write_pos_ + 1) % capacity_;
+  return true;
+}
+
+AudioFrame* AudioFrameQueue::Front() {
+  if (size() <= 0)
+    return NULL;
+  return &frames_[read_pos_];
+}
+
+void AudioFrameQueue::Pop() {
+  if (size() <= 0) {
+    assert(false);
+    return;
+  }
+  read_pos_ = (read_pos_ + 1) % capacity_;
+  --size_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_AUDIO_FRAME_QUEUE_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_AUDIO_FRAME_QUEUE_H_
+
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+// A lock-free FIFO of AudioFrames with room for |capacity| frames, all
+// allocated up front. It assumes there is one producer thread, calling Push(),
+// and one consumer thread, calling Front() and Pop().
+class AudioFrameQueue {
+ public:
+  explicit AudioFrameQueue(int capacity);
+  ~AudioFrameQueue();
+
+  // Copies |frame| to the back of the queue. Returns false, dropping the
+  // frame, if the queue is full.
+  bool Push(const AudioFrame& frame);
+
+  // Returns the frame at the front of the queue, or NULL if it is empty. The
+  // frame stays valid until the next call to Pop().
+  AudioFrame* Front();
+  void Pop();
+
+  int size() { return size_.Value(); }
+  int capacity() const { return capacity_; }
+
+ private:
+  scoped_ptr<AudioFrame[]> frames_;
+  const int capacity_;
+
+  // The only state shared by the two threads. Its updates are full barriers,
+  // so a frame is completely written before the consumer can see it, and
+  // completely read before the producer can reuse its slot.
+  Atomic32 size_;
+
+  int read_pos_;  // Only used by the consumer.
+  int write_pos_;  // Only used by the producer.
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_AUDIO_FRAME_QUEUE_H_
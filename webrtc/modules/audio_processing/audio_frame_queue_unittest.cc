@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/audio_frame_queue.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+const int kCapacity = 4;
+const int kNumStressFrames = 1000;
+
+void SetFrame(int value, AudioFrame* frame) {
+  frame->samples_per_channel_ = 160;
+  frame->num_channels_ = 1;
+  frame->sample_rate_hz_ = 16000;
+  frame->timestamp_ = value;
+  for (int i = 0; i < frame->samples_per_channel_; ++i)
+    frame->data_[i] = static_cast<int16_t>(value + i);
+}
+
+bool FrameMatches(int value, const AudioFrame& frame) {
+  if (frame.timestamp_ != static_cast<uint32_t>(value) ||
+      frame.samples_per_channel_ != 160) {
+    return false;
+  }
+  for (int i = 0; i < frame.samples_per_channel_; ++i) {
+    if (frame.data_[i] != static_cast<int16_t>(value + i))
+      return false;
+  }
+  return true;
+}
+
+// Pushes |kNumStressFrames| numbered frames, retrying while the queue is full.
+bool Produce(void* obj) {
+  AudioFrameQueue* queue = static_cast<AudioFrameQueue*>(obj);
+  AudioFrame frame;
+  for (int i = 0; i < kNumStressFrames; ++i) {
+    SetFrame(i, &frame);
+    while (!queue->Push(frame))
+      SleepMs(0);
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(AudioFrameQueueTest, KeepsFramesInOrder) {
+  AudioFrameQueue queue(kCapacity);
+  EXPECT_EQ(kCapacity, queue.capacity());
+  EXPECT_EQ(0, queue.size());
+  EXPECT_TRUE(queue.Front() == NULL);
+
+  // Go around the ring a few times.
+  AudioFrame frame;
+  int next_push = 0;
+  int next_pop = 0;
+  for (int i = 0; i < 3 * kCapacity; ++i) {
+    SetFrame(next_push++, &frame);
+    EXPECT_TRUE(queue.Push(frame));
+    SetFrame(next_push++, &frame);
+    EXPECT_TRUE(queue.Push(frame));
+    EXPECT_EQ(2, queue.size());
+    for (int j = 0; j < 2; ++j) {
+      ASSERT_TRUE(queue.Front() != NULL);
+      EXPECT_TRUE(FrameMatches(next_pop++, *queue.Front()));
+      queue.Pop();
+    }
+    EXPECT_EQ(0, queue.size());
+  }
+}
+
+TEST(AudioFrameQueueTest, DropsFramesWhenFull) {
+  AudioFrameQueue queue(kCapacity);
+  AudioFrame frame;
+  for (int i = 0; i < kCapacity; ++i) {
+    SetFrame(i, &frame);
+    EXPECT_TRUE(queue.Push(frame));
+  }
+  SetFrame(kCapacity, &frame);
+  EXPECT_FALSE(queue.Push(frame));
+  EXPECT_EQ(kCapacity, queue.size());
+
+  // The queued frames are untouched, and there is room again after a Pop().
+  ASSERT_TRUE(queue.Front() != NULL);
+  EXPECT_TRUE(FrameMatches(0, *queue.Front()));
+  queue.Pop();
+  EXPECT_TRUE(queue.Push(frame));
+  for (int i = 1; i <= kCapacity; ++i) {
+    ASSERT_TRUE(queue.Front() != NULL);
+    EXPECT_TRUE(FrameMatches(i, *queue.Front()));
+    queue.Pop();
+  }
+  EXPECT_TRUE(queue.Front() == NULL);
+}
+
+TEST(AudioFrameQueueTest, PassesFramesBetweenThreads) {
+  AudioFrameQueue queue(kCapacity);
+  scoped_ptr<ThreadWrapper> producer(ThreadWrapper::CreateThread(
+      Produce, &queue, kNormalPriority, "AudioFrameQueueTest"));
+  unsigned int id;
+  ASSERT_TRUE(producer->Start(id));
+
+  int num_received = 0;
+  int num_matching = 0;
+  while (num_received < kNumStressFrames) {
+    AudioFrame* frame = queue.Front();
+    if (!frame) {
+      SleepMs(0);
+      continue;
+    }
+    if (FrameMatches(num_received, *frame))
+      ++num_matching;
+    ++num_received;
+    queue.Pop();
+  }
+  EXPECT_TRUE(producer->Stop());
+  EXPECT_EQ(kNumStressFrames, num_matching);
+  EXPECT_EQ(0, queue.size());
+}
+
+}  // namespace webrtc
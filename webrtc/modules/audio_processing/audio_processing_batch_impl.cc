@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/audio_processing_batch_impl.h"
+
+#include <assert.h>
+
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+
+namespace webrtc {
+
+AudioProcessingBatch* AudioProcessingBatch::Create(int num_workers) {
+  if (num_workers < 1)
+    return NULL;
+  AudioProcessingBatchImpl* batch = new AudioProcessingBatchImpl(num_workers);
+  if (!batch->Init()) {
+    delete batch;
+    return NULL;
+  }
+  return batch;
+}
+
+AudioProcessingBatchImpl::AudioProcessingBatchImpl(int num_workers)
+    : workers_(num_workers) {
+  assert(num_workers > 0);
+}
+
+AudioProcessingBatchImpl::~AudioProcessingBatchImpl() {}
+
+bool AudioProcessingBatchImpl::Init() {
+  if (workers_.size() > 1) {
+    pool_.reset(ThreadPool::Create("AudioProcessingBatch",
+                                   static_cast<int>(workers_.size()) - 1,
+                                   kRealtimePriority));
+    if (!pool_)
+      return false;
+  }
+  return true;
+}
+
+int AudioProcessingBatchImpl::ProcessStreams(AudioProcessingBatchItem* items,
+                                             size_t num_items) {
+  if (num_items == 0)
+    return AudioProcessing::kNoError;
+  if (!items)
+    return AudioProcessing::kNullPointerError;
+  for (size_t i = 0; i < num_items; ++i) {
+    if (!items[i].apm || !items[i].frame)
+      return AudioProcessing::kNullPointerError;
+  }
+
+  for (size_t i = 0; i < num_items; ++i)
+    workers_[WorkerForStream(items[i].apm)].items.push_back(&items[i]);
+
+  if (pool_) {
+    pool_->RunInParallel(this, static_cast<int>(workers_.size()));
+  } else {
+    Run(0);
+  }
+
+  for (size_t i = 0; i < num_items; ++i) {
+    if (items[i].error != AudioProcessing::kNoError)
+      return items[i].error;
+  }
+  return AudioProcessing::kNoError;
+}
+
+void AudioProcessingBatchImpl::RemoveStream(const AudioProcessing* apm) {
+  WorkerMap::iterator it = stream_workers_.find(apm);
+  if (it == stream_workers_.end())
+    return;
+  --workers_[it->second].num_streams;
+  stream_workers_.erase(it);
+}
+
+int AudioProcessingBatchImpl::num_workers() const {
+  return static_cast<int>(workers_.size());
+}
+
+void AudioProcessingBatchImpl::Run(int index) {
+  std::vector<AudioProcessingBatchItem*>& items = workers_[index].items;
+  for (size_t i = 0; i < items.size(); ++i)
+    items[i]->error = items[i]->apm->ProcessStream(items[i]->frame);
+  items.clear();
+}
+
+int AudioProcessingBatchImpl::WorkerForStream(const AudioProcessing* apm) {
+  WorkerMap::iterator it = stream_workers_.find(apm);
+  if (it != stream_workers_.end())
+    return it->second;
+  int least_loaded = 0;
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    if (workers_[i].num_streams < workers_[least_loaded].num_streams)
+      least_loaded = static_cast<int>(i);
+  }
+  ++workers_[least_loaded].num_streams;
+  stream_workers_[apm] = least_loaded;
+  return least_loaded;
+}
+
+}  // namespace webrtc
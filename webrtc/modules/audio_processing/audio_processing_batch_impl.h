@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_AUDIO_PROCESSING_BATCH_IMPL_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_AUDIO_PROCESSING_BATCH_IMPL_H_
+
+#include <map>
+#include <vector>
+
+#include "webrtc/modules/audio_processing/include/audio_processing_batch.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class AudioProcessingBatchImpl : public AudioProcessingBatch,
+                                 public ParallelTask {
+ public:
+  explicit AudioProcessingBatchImpl(int num_workers);
+  virtual ~AudioProcessingBatchImpl();
+
+  // Starts the thread pool. Returns false if it fails to start.
+  bool Init();
+
+  // AudioProcessingBatch implementation.
+  virtual int ProcessStreams(AudioProcessingBatchItem* items,
+                             size_t num_items) OVERRIDE;
+  virtual void RemoveStream(const AudioProcessing* apm) OVERRIDE;
+  virtual int num_workers() const OVERRIDE;
+
+  // Implements ParallelTask. Processes the items queued on worker |index|.
+  virtual void Run(int index) OVERRIDE;
+
+ private:
+  // The streams assigned to a worker, which are processed back-to-back by one
+  // thread in each batch.
+  struct Worker {
+    Worker() : num_streams(0) {}
+
+    // Queued for the next batch.
+    std::vector<AudioProcessingBatchItem*> items;
+    int num_streams;
+  };
+  typedef std::map<const AudioProcessing*, int> WorkerMap;
+
+  // Returns the worker of |apm|, assigning it to the least loaded one if it
+  // is new.
+  int WorkerForStream(const AudioProcessing* apm);
+
+  std::vector<Worker> workers_;
+  WorkerMap stream_workers_;
+  // The calling thread runs a worker too, so the pool has a thread less.
+  scoped_ptr<ThreadPool> pool_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_AUDIO_PROCESSING_BATCH_IMPL_H_
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/include/audio_processing_batch.h"
+
+#include <vector>
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_processing/include/mock_audio_processing.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace webrtc {
+namespace {
+
+const int kNumWorkers = 4;
+const int kNumStreams = 10;
+const int kNumBatches = 20;
+const unsigned long kWaitMs = 1000;
+
+// A stream which signals |processed_| when it has been processed. If
+// |wait_for_| is set, it waits for that stream to be processed first, which
+// only succeeds if the two are processed by different workers.
+class Stream {
+ public:
+  Stream()
+      : processed_(EventWrapper::Create()),
+        num_processed_(0),
+        wait_for_(NULL),
+        waited_(false) {
+    ON_CALL(apm_, ProcessStream(_))
+        .WillByDefault(Invoke(this, &Stream::ProcessStream));
+  }
+
+  int ProcessStream(AudioFrame* frame) {
+    EXPECT_EQ(&frame_, frame);
+    if (wait_for_)
+      waited_ = wait_for_->processed_->Wait(kWaitMs) == kEventSignaled;
+    ++num_processed_;
+    processed_->Set();
+    return AudioProcessing::kNoError;
+  }
+
+  MockAudioProcessing apm_;
+  AudioFrame frame_;
+  scoped_ptr<EventWrapper> processed_;
+  int num_processed_;
+  Stream* wait_for_;
+  bool waited_;
+};
+
+}  // namespace
+
+TEST(AudioProcessingBatchTest, ProcessesEveryStreamOfEveryBatch) {
+  scoped_ptr<AudioProcessingBatch> batch(
+      AudioProcessingBatch::Create(kNumWorkers));
+  ASSERT_TRUE(batch.get() != NULL);
+  EXPECT_EQ(kNumWorkers, batch->num_workers());
+
+  Stream streams[kNumStreams];
+  for (int i = 0; i < kNumStreams; ++i)
+    EXPECT_CALL(streams[i].apm_, ProcessStream(_)).Times(kNumBatches);
+
+  std::vector<AudioProcessingBatchItem> items;
+  for (int j = 0; j < kNumBatches; ++j) {
+    items.clear();
+    for (int i = 0; i < kNumStreams; ++i) {
+      items.push_back(
+          AudioProcessingBatchItem(&streams[i].apm_, &streams[i].frame_));
+    }
+    EXPECT_EQ(AudioProcessing::kNoError,
+              batch->ProcessStreams(&items[0], items.size()));
+  }
+
+  for (int i = 0; i < kNumStreams; ++i)
+    EXPECT_EQ(kNumBatches, streams[i].num_processed_);
+}
+
+TEST(AudioProcessingBatchTest, ReportsErrors) {
+  scoped_ptr<AudioProcessingBatch> batch(
+      AudioProcessingBatch::Create(kNumWorkers));
+  ASSERT_TRUE(batch.get() != NULL);
+
+  Stream streams[3];
+  EXPECT_CALL(streams[0].apm_, ProcessStream(_));
+  EXPECT_CALL(streams[1].apm_, ProcessStream(_))
+      .WillOnce(Return(AudioProcessing::kBadStreamParameterWarning));
+  EXPECT_CALL(streams[2].apm_, ProcessStream(_));
+
+  AudioProcessingBatchItem items[3];
+  for (int i = 0; i < 3; ++i)
+    items[i] = AudioProcessingBatchItem(&streams[i].apm_, &streams[i].frame_);
+  EXPECT_EQ(AudioProcessing::kBadStreamParameterWarning,
+            batch->ProcessStreams(items, 3));
+  EXPECT_EQ(AudioProcessing::kNoError, items[0].error);
+  EXPECT_EQ(AudioProcessing::kBadStreamParameterWarning, items[1].error);
+  EXPECT_EQ(AudioProcessing::kNoError, items[2].error);
+
+  items[1].frame = NULL;
+  EXPECT_EQ(AudioProcessing::kNullPointerError,
+            batch->ProcessStreams(items, 3));
+}
+
+TEST(AudioProcessingBatchTest, BalancesStreamsAcrossWorkers) {
+  scoped_ptr<AudioProcessingBatch> batch(AudioProcessingBatch::Create(2));
+  ASSERT_TRUE(batch.get() != NULL);
+  EXPECT_TRUE(AudioProcessingBatch::Create(0) == NULL);
+
+  Stream streams[3];
+  for (int i = 0; i < 3; ++i)
+    EXPECT_CALL(streams[i].apm_, ProcessStream(_)).Times(AnyNumber());
+  streams[0].wait_for_ = &streams[1];
+  AudioProcessingBatchItem items[2];
+  items[0] = AudioProcessingBatchItem(&streams[0].apm_, &streams[0].frame_);
+  items[1] = AudioProcessingBatchItem(&streams[1].apm_, &streams[1].frame_);
+  EXPECT_EQ(AudioProcessing::kNoError, batch->ProcessStreams(items, 2));
+  EXPECT_TRUE(streams[0].waited_);
+
+  // The third stream takes the place of the removed one.
+  batch->RemoveStream(&streams[0].apm_);
+  streams[2].wait_for_ = &streams[1];
+  items[0] = AudioProcessingBatchItem(&streams[2].apm_, &streams[2].frame_);
+  EXPECT_EQ(AudioProcessing::kNoError, batch->ProcessStreams(items, 2));
+  EXPECT_TRUE(streams[2].waited_);
+}
+
+}  // namespace webrtc
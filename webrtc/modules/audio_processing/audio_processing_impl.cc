@@ -15,6 +15,7 @@
 #include "webrtc/common_audio/include/audio_util.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/audio_processing/audio_buffer.h"
+#include "webrtc/modules/audio_processing/audio_frame_queue.h"
 #include "webrtc/modules/audio_processing/common.h"
 #include "webrtc/modules/audio_processing/echo_cancellation_impl.h"
 #include "webrtc/modules/audio_processing/echo_control_mobile_impl.h"
@@ -23,12 +24,15 @@
 #include "webrtc/modules/audio_processing/level_estimator_impl.h"
 #include "webrtc/modules/audio_processing/noise_suppression_impl.h"
 #include "webrtc/modules/audio_processing/processing_component.h"
+#include "webrtc/modules/audio_processing/splitting_filter.h"
 #include "webrtc/modules/audio_processing/voice_detection_impl.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/system_wrappers/interface/compile_assert.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/file_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
 // Files generated at build-time by the protobuf compiler.
@@ -48,6 +52,13 @@
   } while (0)
 
 namespace webrtc {
+namespace {
+
+// The number of 10 ms render frames which can wait for ProcessStream() when
+// RenderQueue is enabled.
+const int kRenderQueueCapacity = 20;
+
+}  // namespace
 
 // Throughout webrtc, it's assumed that success is represented by zero.
 COMPILE_ASSERT(AudioProcessing::kNoError == 0, no_error_must_be_zero);
@@ -81,7 +92,7 @@ AudioProcessingImpl::AudioProcessingImpl(const Config& config)
       voice_detection_(NULL),
       crit_(CriticalSectionWrapper::CreateCriticalSection()),
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-      debug_file_(FileWrapper::Create()),
+      debug_file_(FileWrapper::CreateAsync()),
       event_msg_(new audioproc::Event()),
 #endif
       fwd_in_format_(kSampleRate16kHz, 1),
@@ -94,7 +105,8 @@ AudioProcessingImpl::AudioProcessingImpl(const Config& config)
       delay_offset_ms_(0),
       was_stream_delay_set_(false),
       output_will_be_muted_(false),
-      key_pressed_(false) {
+      key_pressed_(false),
+      float_processing_enabled_(false) {
   echo_cancellation_ = new EchoCancellationImpl(this, crit_);
   component_list_.push_back(echo_cancellation_);
 
@@ -116,6 +128,9 @@ AudioProcessingImpl::AudioProcessingImpl(const Config& config)
   voice_detection_ = new VoiceDetectionImpl(this, crit_);
   component_list_.push_back(voice_detection_);
 
+  if (config.Get<RenderQueue>().enabled)
+    render_queue_.reset(new AudioFrameQueue(kRenderQueueCapacity));
+
   SetExtraOptions(config);
 }
 
@@ -301,6 +316,8 @@ void AudioProcessingImpl::SetExtraOptions(const Config& config) {
   std::list<ProcessingComponent*>::iterator it;
   for (it = component_list_.begin(); it != component_list_.end(); ++it)
     (*it)->SetExtraOptions(config);
+
+  float_processing_enabled_ = config.Get<FloatProcessing>().enabled;
 }
 
 int AudioProcessingImpl::input_sample_rate_hz() const {
@@ -349,6 +366,7 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
                                        ChannelLayout output_layout,
                                        float* const* dest) {
   CriticalSectionScoped crit_scoped(crit_);
+  AnalyzeQueuedReverseFramesLocked();
   if (!src || !dest) {
     return kNullPointerError;
   }
@@ -373,6 +391,7 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
   }
 #endif
 
+  capture_audio_->set_float_processing(float_processing_enabled_);
   capture_audio_->CopyFrom(src, samples_per_channel, input_layout);
   RETURN_ON_ERR(ProcessStreamLocked());
   if (output_copy_needed(is_data_processed())) {
@@ -396,6 +415,7 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
 
 int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
   CriticalSectionScoped crit_scoped(crit_);
+  AnalyzeQueuedReverseFramesLocked();
   if (!frame) {
     return kNullPointerError;
   }
@@ -454,6 +474,7 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
 
 
 int AudioProcessingImpl::ProcessStreamLocked() {
+  const int64_t start_us = TickTime::MicrosecondTimestamp();
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
   if (debug_file_->Open()) {
     audioproc::Stream* msg = event_msg_->mutable_stream();
@@ -467,15 +488,7 @@ int AudioProcessingImpl::ProcessStreamLocked() {
   AudioBuffer* ca = capture_audio_.get();  // For brevity.
   bool data_processed = is_data_processed();
   if (analysis_needed(data_processed)) {
-    for (int i = 0; i < fwd_proc_format_.num_channels(); i++) {
-      // Split into a low and high band.
-      WebRtcSpl_AnalysisQMF(ca->data(i),
-                            ca->samples_per_channel(),
-                            ca->low_pass_split_data(i),
-                            ca->high_pass_split_data(i),
-                            ca->filter_states(i)->analysis_filter_state1,
-                            ca->filter_states(i)->analysis_filter_state2);
-    }
+    SplitIntoBands(ca);
   }
 
   RETURN_ON_ERR(high_pass_filter_->ProcessCaptureAudio(ca));
@@ -491,21 +504,16 @@ int AudioProcessingImpl::ProcessStreamLocked() {
   RETURN_ON_ERR(gain_control_->ProcessCaptureAudio(ca));
 
   if (synthesis_needed(data_processed)) {
-    for (int i = 0; i < fwd_proc_format_.num_channels(); i++) {
-      // Recombine low and high bands.
-      WebRtcSpl_SynthesisQMF(ca->low_pass_split_data(i),
-                             ca->high_pass_split_data(i),
-                             ca->samples_per_split_channel(),
-                             ca->data(i),
-                             ca->filter_states(i)->synthesis_filter_state1,
-                             ca->filter_states(i)->synthesis_filter_state2);
-    }
+    MergeBands(ca);
   }
 
   // The level estimator operates on the recombined data.
   RETURN_ON_ERR(level_estimator_->ProcessStream(ca));
 
   was_stream_delay_set_ = false;
+  WEBRTC_HISTOGRAM_ADD("WebRTC.Audio.ProcessStreamTimeUs",
+                       static_cast<int>(TickTime::MicrosecondTimestamp() -
+                                        start_us));
   return kNoError;
 }
 
@@ -514,6 +522,8 @@ int AudioProcessingImpl::AnalyzeReverseStream(const float* const* data,
                                               int sample_rate_hz,
                                               ChannelLayout layout) {
   CriticalSectionScoped crit_scoped(crit_);
+  // Keep the frames in order.
+  AnalyzeQueuedReverseFramesLocked();
   if (data == NULL) {
     return kNullPointerError;
   }
@@ -540,12 +550,53 @@ int AudioProcessingImpl::AnalyzeReverseStream(const float* const* data,
   }
 #endif
 
+  render_audio_->set_float_processing(float_processing_enabled_);
   render_audio_->CopyFrom(data, samples_per_channel, layout);
   return AnalyzeReverseStreamLocked();
 }
 
 int AudioProcessingImpl::AnalyzeReverseStream(AudioFrame* frame) {
-  CriticalSectionScoped crit_scoped(crit_);
+  if (!render_queue_) {
+    CriticalSectionScoped crit_scoped(crit_);
+    return AnalyzeReverseFrameLocked(frame);
+  }
+
+  // Only the checks which don't need the lock are done here; the rest wait
+  // until the frame is analyzed.
+  if (frame == NULL) {
+    return kNullPointerError;
+  }
+  // Must be a native rate.
+  if (frame->sample_rate_hz_ != kSampleRate8kHz &&
+      frame->sample_rate_hz_ != kSampleRate16kHz &&
+      frame->sample_rate_hz_ != kSampleRate32kHz) {
+    return kBadSampleRateError;
+  }
+  if (frame->samples_per_channel_ !=
+      kChunkSizeMs * frame->sample_rate_hz_ / 1000) {
+    return kBadDataLengthError;
+  }
+  if (!render_queue_->Push(*frame)) {
+    LOG(LS_WARNING) << "Render queue full; dropping a reverse frame";
+    return kUnspecifiedError;
+  }
+  return kNoError;
+}
+
+void AudioProcessingImpl::AnalyzeQueuedReverseFramesLocked() {
+  if (!render_queue_)
+    return;
+  AudioFrame* frame;
+  while ((frame = render_queue_->Front()) != NULL) {
+    const int err = AnalyzeReverseFrameLocked(frame);
+    if (err != kNoError) {
+      LOG(LS_WARNING) << "Failed to analyze a queued reverse frame: " << err;
+    }
+    render_queue_->Pop();
+  }
+}
+
+int AudioProcessingImpl::AnalyzeReverseFrameLocked(AudioFrame* frame) {
   if (frame == NULL) {
     return kNullPointerError;
   }
@@ -589,15 +640,7 @@ int AudioProcessingImpl::AnalyzeReverseStream(AudioFrame* frame) {
 int AudioProcessingImpl::AnalyzeReverseStreamLocked() {
   AudioBuffer* ra = render_audio_.get();  // For brevity.
   if (rev_proc_format_.rate() == kSampleRate32kHz) {
-    for (int i = 0; i < rev_proc_format_.num_channels(); i++) {
-      // Split into low and high band.
-      WebRtcSpl_AnalysisQMF(ra->data(i),
-                            ra->samples_per_channel(),
-                            ra->low_pass_split_data(i),
-                            ra->high_pass_split_data(i),
-                            ra->filter_states(i)->analysis_filter_state1,
-                            ra->filter_states(i)->analysis_filter_state2);
-    }
+    SplitIntoBands(ra);
   }
 
   RETURN_ON_ERR(echo_cancellation_->ProcessRenderAudio(ra));
@@ -607,6 +650,48 @@ int AudioProcessingImpl::AnalyzeReverseStreamLocked() {
   return kNoError;
 }
 
+void AudioProcessingImpl::SplitIntoBands(AudioBuffer* audio) {
+  if (audio->float_processing()) {
+    SplittingFilterAnalysis(audio->channels_f(),
+                            audio->num_channels(),
+                            audio->samples_per_channel(),
+                            audio->low_pass_split_channels_f(),
+                            audio->high_pass_split_channels_f(),
+                            audio->filter_states(0));
+    return;
+  }
+  for (int i = 0; i < audio->num_channels(); ++i) {
+    SplitFilterStates* states = audio->filter_states(i);
+    WebRtcSpl_AnalysisQMF(audio->data(i),
+                          audio->samples_per_channel(),
+                          audio->low_pass_split_data(i),
+                          audio->high_pass_split_data(i),
+                          states->analysis_filter_state1,
+                          states->analysis_filter_state2);
+  }
+}
+
+void AudioProcessingImpl::MergeBands(AudioBuffer* audio) {
+  if (audio->float_processing()) {
+    SplittingFilterSynthesis(audio->low_pass_split_channels_f(),
+                             audio->high_pass_split_channels_f(),
+                             audio->num_channels(),
+                             audio->samples_per_split_channel(),
+                             audio->channels_f(),
+                             audio->filter_states(0));
+    return;
+  }
+  for (int i = 0; i < audio->num_channels(); ++i) {
+    SplitFilterStates* states = audio->filter_states(i);
+    WebRtcSpl_SynthesisQMF(audio->low_pass_split_data(i),
+                           audio->high_pass_split_data(i),
+                           audio->samples_per_split_channel(),
+                           audio->data(i),
+                           states->synthesis_filter_state1,
+                           states->synthesis_filter_state2);
+  }
+}
+
 int AudioProcessingImpl::set_stream_delay_ms(int delay) {
   Error retval = kNoError;
   was_stream_delay_set_ = true;
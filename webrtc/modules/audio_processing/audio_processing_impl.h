@@ -21,6 +21,7 @@
 namespace webrtc {
 
 class AudioBuffer;
+class AudioFrameQueue;
 class CriticalSectionWrapper;
 class EchoCancellationImpl;
 class EchoControlMobileImpl;
@@ -153,6 +154,14 @@ class AudioProcessingImpl : public AudioProcessing {
                             int num_reverse_channels);
   int ProcessStreamLocked();
   int AnalyzeReverseStreamLocked();
+  int AnalyzeReverseFrameLocked(AudioFrame* frame);
+  // Analyzes the frames left in |render_queue_| by AnalyzeReverseStream().
+  void AnalyzeQueuedReverseFramesLocked();
+
+  // Run the splitting filter on all channels of |audio|, in float if
+  // AudioBuffer::float_processing() is set.
+  void SplitIntoBands(AudioBuffer* audio);
+  void MergeBands(AudioBuffer* audio);
 
   bool is_data_processed() const;
   bool output_copy_needed(bool is_data_processed) const;
@@ -171,6 +180,8 @@ class AudioProcessingImpl : public AudioProcessing {
   CriticalSectionWrapper* crit_;
   scoped_ptr<AudioBuffer> render_audio_;
   scoped_ptr<AudioBuffer> capture_audio_;
+  // Only created when RenderQueue is enabled.
+  scoped_ptr<AudioFrameQueue> render_queue_;
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
   // TODO(andrew): make this more graceful. Ideally we would split this stuff
   // out into a separate class with an "enabled" and "disabled" implementation.
@@ -195,6 +206,7 @@ class AudioProcessingImpl : public AudioProcessing {
   bool output_will_be_muted_;
 
   bool key_pressed_;
+  bool float_processing_enabled_;
 };
 
 }  // namespace webrtc
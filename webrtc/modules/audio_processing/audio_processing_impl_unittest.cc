@@ -10,6 +10,9 @@
 
 #include "webrtc/modules/audio_processing/audio_processing_impl.h"
 
+#include <math.h>
+#include <string.h>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/config.h"
@@ -71,4 +74,156 @@ TEST(AudioProcessingImplTest, AudioParameterChangeTriggersInit) {
   EXPECT_EQ(mock.kBadSampleRateError, mock.AnalyzeReverseStream(&frame));
 }
 
+// With FloatProcessing the int16 conversions are skipped, which should only
+// change the output by about the int16 rounding error.
+TEST(AudioProcessingImplTest, FloatProcessingIsCloseToIntProcessing) {
+  const int kSampleRateHz = 32000;
+  const int kNumChannels = 2;
+  const int kSamplesPerChannel = SamplesFromRate(kSampleRateHz);
+  Config config;
+  config.Set<ExperimentalAgc>(new ExperimentalAgc(false));
+  scoped_ptr<AudioProcessing> apm(AudioProcessing::Create(config));
+  config.Set<FloatProcessing>(new FloatProcessing(true));
+  scoped_ptr<AudioProcessing> float_apm(AudioProcessing::Create(config));
+  AudioProcessing* apms[] = {apm.get(), float_apm.get()};
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_NOERR(apms[i]->high_pass_filter()->Enable(true));
+    EXPECT_NOERR(apms[i]->echo_cancellation()->Enable(true));
+    EXPECT_NOERR(apms[i]->noise_suppression()->Enable(true));
+    EXPECT_NOERR(apms[i]->level_estimator()->Enable(true));
+  }
+
+  ChannelBuffer<float> render(kSamplesPerChannel, kNumChannels);
+  ChannelBuffer<float> capture(kSamplesPerChannel, kNumChannels);
+  ChannelBuffer<float> float_capture(kSamplesPerChannel, kNumChannels);
+  double error_energy = 0;
+  double output_energy = 0;
+  for (int frame = 0; frame < 100; ++frame) {
+    for (int j = 0; j < kNumChannels; ++j) {
+      for (int k = 0; k < kSamplesPerChannel; ++k) {
+        const double t = (frame * kSamplesPerChannel + k) /
+            static_cast<double>(kSampleRateHz);
+        render.channel(j)[k] = 0.3f * sin(2 * M_PI * 440 * t);
+        capture.channel(j)[k] = 0.1f * sin(2 * M_PI * 440 * (t - 0.01)) +
+            0.2f * sin(2 * M_PI * (700 + 200 * j) * t) +
+            0.1f * sin(2 * M_PI * 11000 * t);
+      }
+    }
+    memcpy(float_capture.data(), capture.data(),
+           sizeof(float) * kSamplesPerChannel * kNumChannels);
+
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_NOERR(apms[i]->AnalyzeReverseStream(
+          render.channels(), kSamplesPerChannel, kSampleRateHz,
+          AudioProcessing::kStereo));
+      EXPECT_NOERR(apms[i]->set_stream_delay_ms(10));
+      apms[i]->echo_cancellation()->set_stream_drift_samples(0);
+    }
+    EXPECT_NOERR(apm->ProcessStream(
+        capture.channels(), kSamplesPerChannel, kSampleRateHz,
+        AudioProcessing::kStereo, kSampleRateHz, AudioProcessing::kStereo,
+        capture.channels()));
+    EXPECT_NOERR(float_apm->ProcessStream(
+        float_capture.channels(), kSamplesPerChannel, kSampleRateHz,
+        AudioProcessing::kStereo, kSampleRateHz, AudioProcessing::kStereo,
+        float_capture.channels()));
+
+    for (int k = 0; k < kSamplesPerChannel * kNumChannels; ++k) {
+      const double error = capture.data()[k] - float_capture.data()[k];
+      error_energy += error * error;
+      output_energy += capture.data()[k] * capture.data()[k];
+    }
+    EXPECT_NEAR(apm->noise_suppression()->speech_probability(),
+                float_apm->noise_suppression()->speech_probability(), 0.01);
+  }
+  EXPECT_GT(output_energy, 0);
+  // The float output should be within 40 dB of the int output.
+  EXPECT_LT(10 * log10(error_energy / output_energy), -40);
+  EXPECT_NEAR(apm->level_estimator()->RMS(),
+              float_apm->level_estimator()->RMS(), 1);
+}
+
+// Queuing the render frames should not change the output, as long as they
+// are all analyzed before the capture frame which follows them.
+TEST(AudioProcessingImplTest, RenderQueueIsBitExact) {
+  const int kSampleRateHz = 16000;
+  Config config;
+  config.Set<ExperimentalAgc>(new ExperimentalAgc(false));
+  scoped_ptr<AudioProcessing> apm(AudioProcessing::Create(config));
+  config.Set<RenderQueue>(new RenderQueue(true));
+  scoped_ptr<AudioProcessing> queue_apm(AudioProcessing::Create(config));
+  AudioProcessing* apms[] = {apm.get(), queue_apm.get()};
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_NOERR(apms[i]->echo_cancellation()->Enable(true));
+    EXPECT_NOERR(apms[i]->noise_suppression()->Enable(true));
+  }
+
+  AudioFrame render;
+  AudioFrame capture[2];
+  render.num_channels_ = 1;
+  SetFrameSampleRate(&render, kSampleRateHz);
+  int render_samples = 0;
+  int capture_samples = 0;
+  for (int frame = 0; frame < 100; ++frame) {
+    // Two render frames at a time, so that the queue holds more than one.
+    if (frame % 2 == 0) {
+      for (int j = 0; j < 2; ++j) {
+        for (int k = 0; k < render.samples_per_channel_;
+             ++k, ++render_samples) {
+          render.data_[k] = static_cast<int16_t>(
+              8000 * sin(2 * M_PI * 440 * render_samples / kSampleRateHz));
+        }
+        for (int i = 0; i < 2; ++i)
+          EXPECT_NOERR(apms[i]->AnalyzeReverseStream(&render));
+      }
+    }
+    capture[0].num_channels_ = 1;
+    SetFrameSampleRate(&capture[0], kSampleRateHz);
+    for (int k = 0; k < capture[0].samples_per_channel_;
+         ++k, ++capture_samples) {
+      const double t = capture_samples / static_cast<double>(kSampleRateHz);
+      capture[0].data_[k] = static_cast<int16_t>(
+          3000 * sin(2 * M_PI * 440 * (t - 0.01)) +
+          2000 * sin(2 * M_PI * 700 * t));
+    }
+    capture[1].CopyFrom(capture[0]);
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_NOERR(apms[i]->set_stream_delay_ms(10));
+      apms[i]->echo_cancellation()->set_stream_drift_samples(0);
+      EXPECT_NOERR(apms[i]->ProcessStream(&capture[i]));
+    }
+    ASSERT_EQ(0, memcmp(capture[0].data_, capture[1].data_,
+                        sizeof(int16_t) * capture[0].samples_per_channel_));
+  }
+}
+
+TEST(AudioProcessingImplTest, RenderQueueDropsFramesWhenFull) {
+  Config config;
+  config.Set<ExperimentalAgc>(new ExperimentalAgc(false));
+  config.Set<RenderQueue>(new RenderQueue(true));
+  scoped_ptr<AudioProcessing> apm(AudioProcessing::Create(config));
+  AudioFrame frame;
+  frame.num_channels_ = 1;
+  SetFrameSampleRate(&frame, 16000);
+
+  // Only the cheap checks are done when queuing.
+  SetFrameSampleRate(&frame, 44100);
+  EXPECT_EQ(apm->kBadSampleRateError, apm->AnalyzeReverseStream(&frame));
+  SetFrameSampleRate(&frame, 16000);
+  frame.samples_per_channel_ = 80;
+  EXPECT_EQ(apm->kBadDataLengthError, apm->AnalyzeReverseStream(&frame));
+  SetFrameSampleRate(&frame, 16000);
+
+  int num_queued = 0;
+  while (apm->AnalyzeReverseStream(&frame) == apm->kNoError)
+    ASSERT_LT(++num_queued, 1000);
+  EXPECT_GT(num_queued, 0);
+
+  // ProcessStream() empties the queue.
+  EXPECT_NOERR(apm->ProcessStream(&frame));
+  for (int i = 0; i < num_queued; ++i)
+    EXPECT_NOERR(apm->AnalyzeReverseStream(&frame));
+  EXPECT_EQ(apm->kUnspecifiedError, apm->AnalyzeReverseStream(&frame));
+}
+
 }  // namespace webrtc
@@ -68,7 +68,8 @@ EchoCancellationImpl::EchoCancellationImpl(const AudioProcessing* apm,
     stream_has_echo_(false),
     delay_logging_enabled_(false),
     delay_correction_enabled_(false),
-    reported_delay_enabled_(true) {}
+    reported_delay_enabled_(true),
+    delay_agnostic_enabled_(false) {}
 
 EchoCancellationImpl::~EchoCancellationImpl() {}
 
@@ -108,7 +109,7 @@ int EchoCancellationImpl::ProcessCaptureAudio(AudioBuffer* audio) {
     return apm_->kNoError;
   }
 
-  if (!apm_->was_stream_delay_set()) {
+  if (!apm_->was_stream_delay_set() && !delay_agnostic_enabled_) {
     return apm_->kStreamParameterNotSetError;
   }
 
@@ -324,6 +325,7 @@ int EchoCancellationImpl::Initialize() {
 void EchoCancellationImpl::SetExtraOptions(const Config& config) {
   delay_correction_enabled_ = config.Get<DelayCorrection>().enabled;
   reported_delay_enabled_ = config.Get<ReportedDelay>().enabled;
+  delay_agnostic_enabled_ = config.Get<DelayAgnostic>().enabled;
   Configure();
 }
 
@@ -365,6 +367,8 @@ int EchoCancellationImpl::ConfigureHandle(void* handle) const {
       static_cast<Handle*>(handle)), delay_correction_enabled_ ? 1 : 0);
   WebRtcAec_enable_reported_delay(WebRtcAec_aec_core(
       static_cast<Handle*>(handle)), reported_delay_enabled_ ? 1 : 0);
+  WebRtcAec_enable_delay_agnostic(WebRtcAec_aec_core(
+      static_cast<Handle*>(handle)), delay_agnostic_enabled_ ? 1 : 0);
   return WebRtcAec_set_config(static_cast<Handle*>(handle), config);
 }
 
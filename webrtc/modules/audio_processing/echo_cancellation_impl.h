@@ -73,6 +73,7 @@ class EchoCancellationImpl : public EchoCancellation,
   bool delay_logging_enabled_;
   bool delay_correction_enabled_;
   bool reported_delay_enabled_;
+  bool delay_agnostic_enabled_;
 };
 
 }  // namespace webrtc
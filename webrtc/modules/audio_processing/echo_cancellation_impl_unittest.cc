@@ -9,6 +9,7 @@
  */
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/interface/module_common_types.h"
 extern "C" {
 #include "webrtc/modules/audio_processing/aec/aec_core.h"
 }
@@ -78,4 +79,42 @@ TEST(EchoCancellationInternalTest, ReportedDelay) {
   EXPECT_EQ(1, WebRtcAec_reported_delay_enabled(aec_core));
 }
 
+TEST(EchoCancellationInternalTest, DelayAgnostic) {
+  scoped_ptr<AudioProcessing> ap(AudioProcessing::Create(0));
+  EXPECT_TRUE(ap->echo_cancellation()->aec_core() == NULL);
+
+  EXPECT_EQ(ap->kNoError, ap->echo_cancellation()->Enable(true));
+  EXPECT_TRUE(ap->echo_cancellation()->is_enabled());
+
+  AecCore* aec_core = ap->echo_cancellation()->aec_core();
+  ASSERT_TRUE(aec_core != NULL);
+  // Disabled by default.
+  EXPECT_EQ(0, WebRtcAec_delay_agnostic_enabled(aec_core));
+
+  AudioFrame frame;
+  frame.num_channels_ = 1;
+  frame.sample_rate_hz_ = 16000;
+  frame.samples_per_channel_ = 160;
+  // The stream delay is required unless in the delay agnostic mode.
+  EXPECT_EQ(ap->kStreamParameterNotSetError, ap->ProcessStream(&frame));
+
+  Config config;
+  config.Set<DelayAgnostic>(new DelayAgnostic(true));
+  ap->SetExtraOptions(config);
+  EXPECT_EQ(1, WebRtcAec_delay_agnostic_enabled(aec_core));
+  EXPECT_EQ(ap->kNoError, ap->ProcessStream(&frame));
+
+  // Retains setting after initialization.
+  EXPECT_EQ(ap->kNoError, ap->Initialize());
+  EXPECT_EQ(1, WebRtcAec_delay_agnostic_enabled(aec_core));
+
+  config.Set<DelayAgnostic>(new DelayAgnostic(false));
+  ap->SetExtraOptions(config);
+  EXPECT_EQ(0, WebRtcAec_delay_agnostic_enabled(aec_core));
+
+  // Retains setting after initialization.
+  EXPECT_EQ(ap->kNoError, ap->Initialize());
+  EXPECT_EQ(0, WebRtcAec_delay_agnostic_enabled(aec_core));
+}
+
 }  // namespace webrtc
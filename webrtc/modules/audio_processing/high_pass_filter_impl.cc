@@ -11,6 +11,7 @@
 #include "webrtc/modules/audio_processing/high_pass_filter_impl.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/audio_processing/audio_buffer.h"
@@ -26,10 +27,25 @@ const int16_t kFilterCoefficients8kHz[5] =
 const int16_t kFilterCoefficients[5] =
     {4012, -8024, 4012, 8002, -3913};
 
+// The fixed-point coefficients as used by Filter(), i.e. all in Q12. The
+// feedback coefficients have the sign of -a[1] and -a[2].
+const float kFloatFilterCoefficients8kHz[5] =
+    {3798.f / 4096, -7596.f / 4096, 3798.f / 4096, 7807.f / 4096,
+     -3733.f / 4096};
+
+const float kFloatFilterCoefficients[5] =
+    {4012.f / 4096, -8024.f / 4096, 4012.f / 4096, 8002.f / 4096,
+     -3913.f / 4096};
+
 struct FilterState {
   int16_t y[4];
   int16_t x[2];
   const int16_t* ba;
+
+  // State of FilterFloat().
+  float y_f[2];
+  float x_f[2];
+  const float* ba_f;
 };
 
 int InitializeFilter(FilterState* hpf, int sample_rate_hz) {
@@ -37,12 +53,16 @@ int InitializeFilter(FilterState* hpf, int sample_rate_hz) {
 
   if (sample_rate_hz == AudioProcessing::kSampleRate8kHz) {
     hpf->ba = kFilterCoefficients8kHz;
+    hpf->ba_f = kFloatFilterCoefficients8kHz;
   } else {
     hpf->ba = kFilterCoefficients;
+    hpf->ba_f = kFloatFilterCoefficients;
   }
 
   WebRtcSpl_MemSetW16(hpf->x, 0, 2);
   WebRtcSpl_MemSetW16(hpf->y, 0, 4);
+  memset(hpf->x_f, 0, sizeof(hpf->x_f));
+  memset(hpf->y_f, 0, sizeof(hpf->y_f));
 
   return AudioProcessing::kNoError;
 }
@@ -100,6 +120,29 @@ int Filter(FilterState* hpf, int16_t* data, int length) {
 
   return AudioProcessing::kNoError;
 }
+
+// Float version of Filter(), for data in the int16 range.
+int FilterFloat(FilterState* hpf, float* data, int length) {
+  assert(hpf != NULL);
+
+  float* y = hpf->y_f;
+  float* x = hpf->x_f;
+  const float* ba = hpf->ba_f;
+
+  for (int i = 0; i < length; i++) {
+    //  y[i] = b[0] * x[i] + b[1] * x[i-1] + b[2] * x[i-2]
+    //         + -a[1] * y[i-1] + -a[2] * y[i-2];
+    const float out = ba[0] * data[i] + ba[1] * x[0] + ba[2] * x[1] +
+                      ba[3] * y[0] + ba[4] * y[1];
+    x[1] = x[0];
+    x[0] = data[i];
+    y[1] = y[0];
+    y[0] = out;
+    data[i] = out;
+  }
+
+  return AudioProcessing::kNoError;
+}
 }  // namespace
 
 typedef FilterState Handle;
@@ -123,9 +166,15 @@ int HighPassFilterImpl::ProcessCaptureAudio(AudioBuffer* audio) {
 
   for (int i = 0; i < num_handles(); i++) {
     Handle* my_handle = static_cast<Handle*>(handle(i));
-    err = Filter(my_handle,
-                 audio->low_pass_split_data(i),
-                 audio->samples_per_split_channel());
+    if (audio->float_processing()) {
+      err = FilterFloat(my_handle,
+                        audio->low_pass_split_data_f(i),
+                        audio->samples_per_split_channel());
+    } else {
+      err = Filter(my_handle,
+                   audio->low_pass_split_data(i),
+                   audio->samples_per_split_channel());
+    }
 
     if (err != apm_->kNoError) {
       return GetHandleError(my_handle);
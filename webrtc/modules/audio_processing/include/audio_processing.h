@@ -65,6 +65,18 @@ struct ReportedDelay {
   bool enabled;
 };
 
+// Use to enable the delay agnostic mode of EchoCancellation. The delay between
+// the reverse and the capture streams is then estimated continuously from the
+// signals, and the far-end buffer is shifted to match. The stream delays
+// reported through AudioProcessing::set_stream_delay_ms() are not used and need
+// not be set. This configuration only applies to EchoCancellation and not
+// EchoControlMobile and is set with AudioProcessing::SetExtraOptions().
+struct DelayAgnostic {
+  DelayAgnostic() : enabled(false) {}
+  explicit DelayAgnostic(bool enabled) : enabled(enabled) {}
+  bool enabled;
+};
+
 // Must be provided through AudioProcessing::Create(Confg&). It will have no
 // impact if used with AudioProcessing::SetExtraOptions().
 struct ExperimentalAgc {
@@ -81,6 +93,32 @@ struct ExperimentalNs {
   bool enabled;
 };
 
+// Use to keep the data in float throughout the processing when using the float
+// interfaces, ProcessStream() and AnalyzeReverseStream() taking float* const*.
+// The splitting filter, high-pass filter, echo cancellation, noise suppression
+// and level estimator then operate on float directly. The fixed-point
+// components (AGC, AECM and VAD) still convert their bands to int16. The
+// output is not bit-exact with the int16 interface. It can be set in the
+// constructor or using AudioProcessing::SetExtraOptions().
+struct FloatProcessing {
+  FloatProcessing() : enabled(false) {}
+  explicit FloatProcessing(bool enabled) : enabled(enabled) {}
+  bool enabled;
+};
+
+// Use to decouple the render and capture threads. AnalyzeReverseStream()
+// taking an AudioFrame then only copies the frame into a lock-free queue,
+// without taking the lock held by ProcessStream(), and the queued frames are
+// analyzed at the start of the next ProcessStream() call. A frame arriving
+// when the queue is full is dropped and the call fails. Errors found when the
+// queued frames are analyzed are logged rather than returned. Must be provided
+// through AudioProcessing::Create(Config&).
+struct RenderQueue {
+  RenderQueue() : enabled(false) {}
+  explicit RenderQueue(bool enabled) : enabled(enabled) {}
+  bool enabled;
+};
+
 static const int kAudioProcMaxNativeSampleRateHz = 32000;
 
 // The Audio Processing Module (APM) provides a collection of voice processing
@@ -274,6 +312,8 @@ class AudioProcessing {
   // members of |frame| must be valid. |sample_rate_hz_| must correspond to
   // |input_sample_rate_hz()|
   //
+  // See RenderQueue for a mode which doesn't wait for |ProcessStream()|.
+  //
   // TODO(ajm): add const to input; requires an implementation fix.
   virtual int AnalyzeReverseStream(AudioFrame* frame) = 0;
 
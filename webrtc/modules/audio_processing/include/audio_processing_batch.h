@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_INCLUDE_AUDIO_PROCESSING_BATCH_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_INCLUDE_AUDIO_PROCESSING_BATCH_H_
+
+#include <stddef.h>  // size_t
+
+namespace webrtc {
+
+class AudioFrame;
+class AudioProcessing;
+
+// One capture frame of one stream in a batch.
+struct AudioProcessingBatchItem {
+  AudioProcessingBatchItem() : apm(NULL), frame(NULL), error(0) {}
+  AudioProcessingBatchItem(AudioProcessing* apm, AudioFrame* frame)
+      : apm(apm), frame(frame), error(0) {}
+
+  AudioProcessing* apm;
+  AudioFrame* frame;
+  // Set to the return value of |apm|->ProcessStream(|frame|).
+  int error;
+};
+
+// Runs AudioProcessing::ProcessStream() for many independent streams in
+// parallel, for servers which process a large number of streams every 10 ms.
+//
+// Each AudioProcessing instance is assigned to one worker the first time it is
+// seen and stays there. In each batch, the frames of a worker are processed
+// back-to-back by one thread, so that the state of a stream is only touched by
+// one core at a time. The workers are run by the calling thread and a thread
+// pool, which doesn't pin a worker to a thread from one batch to the next.
+//
+// Usage example, omitting error checking:
+// AudioProcessingBatch* batch = AudioProcessingBatch::Create(4);
+// std::vector<AudioProcessingBatchItem> items;
+// for (size_t i = 0; i < streams.size(); ++i) {
+//   streams[i].apm->set_stream_delay_ms(streams[i].delay_ms);
+//   items.push_back(AudioProcessingBatchItem(streams[i].apm,
+//                                            streams[i].frame));
+// }
+// batch->ProcessStreams(&items[0], items.size());
+//
+// A batch must not be shared between threads. An AudioProcessing instance
+// must not be used by other threads while a ProcessStreams() call including
+// it is running.
+class AudioProcessingBatch {
+ public:
+  // Creates a batch with |num_workers| workers, run by the calling thread and
+  // |num_workers| - 1 pool threads. Returns NULL on failure.
+  static AudioProcessingBatch* Create(int num_workers);
+  virtual ~AudioProcessingBatch() {}
+
+  // Processes the |num_items| frames in |items| and blocks until all are done.
+  // The stream parameters of each AudioProcessing, e.g. the stream delay,
+  // must be set before calling. A stream may appear more than once, in which
+  // case its frames are processed in order.
+  //
+  // Sets the |error| of every item and returns the first non-zero one, or
+  // AudioProcessing::kNoError if all frames were processed successfully.
+  virtual int ProcessStreams(AudioProcessingBatchItem* items,
+                             size_t num_items) = 0;
+
+  // Drops the worker assignment of |apm|. Must be called before an
+  // AudioProcessing instance which has been processed by the batch is
+  // destroyed, so that the workers remain evenly loaded.
+  virtual void RemoveStream(const AudioProcessing* apm) = 0;
+
+  virtual int num_workers() const = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_INCLUDE_AUDIO_PROCESSING_BATCH_H_
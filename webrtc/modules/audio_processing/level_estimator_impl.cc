@@ -31,7 +31,11 @@ int LevelEstimatorImpl::ProcessStream(AudioBuffer* audio) {
 
   RMSLevel* rms_level = static_cast<RMSLevel*>(handle(0));
   for (int i = 0; i < audio->num_channels(); ++i) {
-    rms_level->Process(audio->data(i), audio->samples_per_channel());
+    if (audio->float_processing()) {
+      rms_level->Process(audio->data_f(i), audio->samples_per_channel());
+    } else {
+      rms_level->Process(audio->data(i), audio->samples_per_channel());
+    }
   }
 
   return AudioProcessing::kNoError;
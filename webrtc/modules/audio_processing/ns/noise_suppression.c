@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "webrtc/common_audio/real_fourier.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/audio_processing/ns/defines.h"
 #include "webrtc/modules/audio_processing/ns/ns_core.h"
@@ -21,6 +22,7 @@ int WebRtcNs_Create(NsHandle** NS_inst) {
   *NS_inst = (NsHandle*) malloc(sizeof(NSinst_t));
   if (*NS_inst != NULL) {
     (*(NSinst_t**)NS_inst)->initFlag = 0;
+    (*(NSinst_t**)NS_inst)->real_fft = NULL;
     return 0;
   } else {
     return -1;
@@ -29,6 +31,9 @@ int WebRtcNs_Create(NsHandle** NS_inst) {
 }
 
 int WebRtcNs_Free(NsHandle* NS_inst) {
+  if (NS_inst != NULL) {
+    WebRtc_FreeRealFourier(((NSinst_t*) NS_inst)->real_fft);
+  }
   free(NS_inst);
   return 0;
 }
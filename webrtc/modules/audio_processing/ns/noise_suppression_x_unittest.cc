@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/ns/include/noise_suppression_x.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+const int kFrameLength = 160;
+const int kNumFrames = 500;
+
+// Runs the fixed-point noise suppression on a noisy tone at |sample_rate_hz|
+// with the kernels selected by |cpu_info|. At 32 kHz the same tone is fed to the
+// upper band and both output bands are returned back to back.
+std::vector<int16_t> ProcessNoise(WebRtc_CPUInfo cpu_info,
+                                  uint32_t sample_rate_hz) {
+  WebRtc_CPUInfo saved_cpu_info = WebRtc_GetCPUInfo;
+  WebRtc_GetCPUInfo = cpu_info;
+  NsxHandle* handle = NULL;
+  EXPECT_EQ(0, WebRtcNsx_Create(&handle));
+  EXPECT_EQ(0, WebRtcNsx_Init(handle, sample_rate_hz));
+  WebRtc_GetCPUInfo = saved_cpu_info;
+  EXPECT_EQ(0, WebRtcNsx_set_policy(handle, 2));
+
+  const int frame_length = sample_rate_hz == 8000 ? 80 : kFrameLength;
+  srand(42);
+  std::vector<int16_t> in(kNumFrames * frame_length);
+  for (size_t i = 0; i < in.size(); ++i) {
+    // Loud enough in places to saturate the synthesis.
+    const double tone = 30000 * sin(0.05 * i) * sin(0.0003 * i);
+    in[i] = static_cast<int16_t>(tone * 0.9 + rand() % 3001 - 1500);
+  }
+
+  const bool split_bands = sample_rate_hz == 32000;
+  std::vector<int16_t> in_high_band(in);
+  std::vector<int16_t> out(in.size());
+  std::vector<int16_t> out_high_band(split_bands ? in.size() : 0);
+  for (int i = 0; i < kNumFrames; ++i) {
+    const int offset = i * frame_length;
+    EXPECT_EQ(0, WebRtcNsx_Process(
+        handle, &in[offset], split_bands ? &in_high_band[offset] : NULL,
+        &out[offset], split_bands ? &out_high_band[offset] : NULL));
+  }
+  out.insert(out.end(), out_high_band.begin(), out_high_band.end());
+  EXPECT_EQ(0, WebRtcNsx_Free(handle));
+  return out;
+}
+
+}  // namespace
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(NoiseSuppressionXTest, Sse2KernelsAreBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const uint32_t kSampleRatesHz[] = {8000, 16000, 32000};
+  for (size_t i = 0; i < sizeof(kSampleRatesHz) / sizeof(*kSampleRatesHz);
+       ++i) {
+    SCOPED_TRACE(kSampleRatesHz[i]);
+    EXPECT_TRUE(ProcessNoise(WebRtc_GetCPUInfoNoASM, kSampleRatesHz[i]) ==
+                ProcessNoise(WebRtc_GetCPUInfo, kSampleRatesHz[i]));
+  }
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
+}  // namespace webrtc
@@ -12,11 +12,11 @@
 #include <string.h>
 //#include <stdio.h>
 #include <stdlib.h>
+#include "webrtc/common_audio/real_fourier.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/audio_processing/ns/include/noise_suppression.h"
 #include "webrtc/modules/audio_processing/ns/ns_core.h"
 #include "webrtc/modules/audio_processing/ns/windows_private.h"
-#include "webrtc/modules/audio_processing/utility/fft4g.h"
 
 // Set Feature Extraction Parameters
 void WebRtcNs_set_feature_extraction_parameters(NSinst_t* inst) {
@@ -108,10 +108,12 @@ int WebRtcNs_InitCore(NSinst_t* inst, uint32_t fs) {
   }
   inst->magnLen = inst->anaLen / 2 + 1; // Number of frequency bins
 
-  // Initialize fft work arrays.
-  inst->ip[0] = 0; // Setting this triggers initialization.
-  memset(inst->dataBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
-  WebRtc_rdft(inst->anaLen, 1, inst->dataBuf, inst->ip, inst->wfft);
+  // Initialize the FFT for the analysis length.
+  WebRtc_FreeRealFourier(inst->real_fft);
+  inst->real_fft = WebRtc_CreateRealFourier(inst->anaLen == 128 ? 7 : 8);
+  if (inst->real_fft == NULL) {
+    return -1;
+  }
 
   memset(inst->dataBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
   memset(inst->syntBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
@@ -840,7 +842,7 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
     //
     inst->blockInd++; // Update the block index only when we process a block.
     // FFT
-    WebRtc_rdft(inst->anaLen, 1, winData, inst->ip, inst->wfft);
+    WebRtc_RealFourierForward(inst->real_fft, winData);
 
     imag[0] = 0;
     real[0] = winData[0];
@@ -1133,7 +1135,7 @@ int WebRtcNs_ProcessCore(NSinst_t* inst,
       winData[2 * i] = real[i];
       winData[2 * i + 1] = imag[i];
     }
-    WebRtc_rdft(inst->anaLen, -1, winData, inst->ip, inst->wfft);
+    WebRtc_RealFourierInverse(inst->real_fft, winData);
 
     for (i = 0; i < inst->anaLen; i++) {
       real[i] = 2.0f * winData[i] / inst->anaLen; // fft scaling
@@ -75,9 +75,8 @@ typedef struct NSinst_t_ {
   float           overdrive;
   float           denoiseBound;
   int             gainmap;
-  // fft work arrays.
-  int             ip[IP_LENGTH];
-  float           wfft[W_LENGTH];
+  // FFT of |anaLen| samples.
+  struct RealFourier* real_fft;
 
   // parameters for new method: some not needed, will reduce/cleanup later
   int32_t         blockInd;                           //frame index counter
@@ -211,6 +211,15 @@ typedef void (*NormalizeRealBuffer) (NsxInst_t* inst,
                                      int16_t* out);
 extern NormalizeRealBuffer WebRtcNsx_NormalizeRealBuffer;
 
+// Updates the noise estimate from the log quantile estimate at |offset|.
+// Intended to be private.
+void WebRtcNsx_UpdateNoiseEstimate(NsxInst_t* inst, int offset);
+
+// Tables shared by the generic and the platform specific functions.
+extern const int16_t WebRtcNsx_kLogTable[9];
+extern const int16_t WebRtcNsx_kCounterDiv[201];
+extern const int16_t WebRtcNsx_kLogTableFrac[256];
+
 // Compute speech/noise probability.
 // Intended to be private.
 void WebRtcNsx_SpeechNoiseProb(NsxInst_t* inst,
@@ -235,6 +244,12 @@ void WebRtcNsx_AnalysisUpdateNeon(NsxInst_t* inst,
 void WebRtcNsx_PrepareSpectrumNeon(NsxInst_t* inst, int16_t* freq_buff);
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Sets some of the above function pointers to their SSE2 versions, defined in
+// file nsx_core_sse2.c.
+void WebRtcNsx_InitSSE2(void);
+#endif
+
 #if defined(MIPS32_LE)
 // For the above function pointers, functions for generic platforms are declared
 // and defined as static in file nsx_core.c, while those for MIPS platforms
@@ -0,0 +1,306 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The fixed-point noise suppression, SSE2 version of speed-critical functions.
+ * The results are bit exact with the generic C versions in nsx_core.c.
+ */
+
+#include "webrtc/modules/audio_processing/ns/nsx_core.h"
+
+#include <assert.h>
+#include <emmintrin.h>
+
+// Returns the lower 16 bits of (a * b) >> shift, i.e. what
+// (int16_t)WEBRTC_SPL_MUL_16_16_RSFT(a, b, shift) gives per lane.
+static __inline __m128i MulShiftRight(__m128i a, __m128i b, int shift) {
+  return _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(a, b), shift),
+                      _mm_slli_epi16(_mm_mulhi_epi16(a, b), 16 - shift));
+}
+
+// Returns the 32-bit (a * b + 2^(shift - 1)) >> shift of the lower (|lo|) and
+// the upper (|hi|) four lanes, i.e. WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND().
+static __inline void MulShiftRightWithRound(__m128i a, __m128i b, int shift,
+                                            __m128i* lo, __m128i* hi) {
+  const __m128i low = _mm_mullo_epi16(a, b);
+  const __m128i high = _mm_mulhi_epi16(a, b);
+  const __m128i round = _mm_set1_epi32(1 << (shift - 1));
+  *lo = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(low, high), round),
+                       shift);
+  *hi = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(low, high), round),
+                       shift);
+}
+
+// Packs the lower 16 bits of the 32-bit lanes of |lo| and |hi|, like a cast
+// to int16_t, where _mm_packs_epi32 would saturate.
+static __inline __m128i PackTruncate(__m128i lo, __m128i hi) {
+  return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16),
+                         _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+}
+
+// The step size of the quantile estimate |index|.
+static __inline int16_t QuantileDelta(const NsxInst_t* inst, int index) {
+  if (inst->noiseEstDensity[index] > 512) {
+    // Get the value for delta by shifting intead of dividing.
+    int factor = WebRtcSpl_NormW16(inst->noiseEstDensity[index]);
+    return (int16_t)(FACTOR_Q16 >> (14 - factor));
+  }
+  // Smaller step size during startup. This prevents from using unrealistic
+  // values causing overflow.
+  return inst->blockIndex < END_STARTUP_LONG ? FACTOR_Q7_STARTUP : FACTOR_Q7;
+}
+
+// Updates the quantile and the density estimate |index| one at a time, for the
+// bins left over by the vectorized loop.
+static void UpdateQuantile(NsxInst_t* inst,
+                           int index,
+                           int16_t lmagn,
+                           int16_t count_div,
+                           int16_t count_prod,
+                           int16_t logval,
+                           int16_t density_term) {
+  int16_t tmp16 = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT(
+      QuantileDelta(inst, index), count_div, 14);
+  int16_t tmp16no1;
+  if (lmagn > inst->noiseEstLogQuantile[index]) {
+    tmp16 += 2;
+    tmp16no1 = WEBRTC_SPL_RSHIFT_W16(tmp16, 2);
+    inst->noiseEstLogQuantile[index] += tmp16no1;
+  } else {
+    tmp16 += 1;
+    tmp16no1 = WEBRTC_SPL_RSHIFT_W16(tmp16, 1);
+    inst->noiseEstLogQuantile[index] -=
+        (int16_t)WEBRTC_SPL_MUL_16_16_RSFT(tmp16no1, 3, 1);
+    if (inst->noiseEstLogQuantile[index] < logval) {
+      inst->noiseEstLogQuantile[index] = logval;
+    }
+  }
+
+  if (WEBRTC_SPL_ABS_W16(lmagn - inst->noiseEstLogQuantile[index])
+      < WIDTH_Q8) {
+    tmp16no1 = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(
+                 inst->noiseEstDensity[index], count_prod, 15);
+    inst->noiseEstDensity[index] = tmp16no1 + density_term;
+  }
+}
+
+static void NoiseEstimationSSE2(NsxInst_t* inst,
+                                uint16_t* magn,
+                                uint32_t* noise,
+                                int16_t* q_noise) {
+  int16_t lmagn[HALF_ANAL_BLOCKL], counter, countDiv;
+  int16_t countProd, zeros, frac;
+  int16_t log2, tabind, logval, density_term;
+  const int16_t log2_const = 22713; // Q15
+  const int16_t width_factor = 21845;
+  int16_t delta[8];
+
+  int i, j, s, offset;
+
+  tabind = inst->stages - inst->normData;
+  assert(tabind < 9);
+  assert(tabind > -9);
+  if (tabind < 0) {
+    logval = -WebRtcNsx_kLogTable[-tabind];
+  } else {
+    logval = WebRtcNsx_kLogTable[tabind];
+  }
+
+  // lmagn(i)=log(magn(i))=log(2)*log2(magn(i))
+  // magn is in Q(-stages), and the real lmagn values are:
+  // real_lmagn(i)=log(magn(i)*2^stages)=log(magn(i))+log(2^stages)
+  // lmagn in Q8
+  for (i = 0; i < inst->magnLen; i++) {
+    if (magn[i]) {
+      zeros = WebRtcSpl_NormU32((uint32_t)magn[i]);
+      frac = (int16_t)((((uint32_t)magn[i] << zeros)
+                              & 0x7FFFFFFF) >> 23);
+      assert(frac < 256);
+      log2 = (int16_t)(((31 - zeros) << 8)
+                             + WebRtcNsx_kLogTableFrac[frac]);
+      lmagn[i] = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT(log2, log2_const, 15);
+      lmagn[i] += logval;
+    } else {
+      lmagn[i] = logval;
+    }
+  }
+
+  // loop over simultaneous estimates
+  for (s = 0; s < SIMULT; s++) {
+    const __m128i logval_8 = _mm_set1_epi16(logval);
+    const __m128i width_8 = _mm_set1_epi16(WIDTH_Q8);
+    const __m128i one_8 = _mm_set1_epi16(1);
+    const __m128i two_8 = _mm_set1_epi16(2);
+    const __m128i three_8 = _mm_set1_epi16(3);
+    __m128i count_div_8, count_prod_8, density_term_8;
+
+    offset = s * inst->magnLen;
+
+    // Get counter values from state
+    counter = inst->noiseEstCounter[s];
+    assert(counter < 201);
+    countDiv = WebRtcNsx_kCounterDiv[counter];
+    countProd = (int16_t)WEBRTC_SPL_MUL_16_16(counter, countDiv);
+    density_term = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(
+                     width_factor, countDiv, 15);
+    count_div_8 = _mm_set1_epi16(countDiv);
+    count_prod_8 = _mm_set1_epi16(countProd);
+    density_term_8 = _mm_set1_epi16(density_term);
+
+    // quant_est(...), eight bins at a time. Both branches of the quantile
+    // update are computed and the right one is picked per bin.
+    for (i = 0; i + 8 <= inst->magnLen; i += 8) {
+      int16_t* quantile_ptr = &inst->noiseEstLogQuantile[offset + i];
+      int16_t* density_ptr = &inst->noiseEstDensity[offset + i];
+      __m128i quantile = _mm_loadu_si128((__m128i*)quantile_ptr);
+      const __m128i lmagn_8 = _mm_loadu_si128((__m128i*)&lmagn[i]);
+      __m128i tmp16, up, down, is_up, close, density, density_lo, density_hi;
+
+      for (j = 0; j < 8; j++) {
+        delta[j] = QuantileDelta(inst, offset + i + j);
+      }
+      tmp16 = MulShiftRight(_mm_loadu_si128((__m128i*)delta), count_div_8,
+                            14);
+
+      // += QUANTILE*delta/(inst->counter[s]+1), QUANTILE=0.25.
+      up = _mm_add_epi16(quantile,
+                         _mm_srai_epi16(_mm_add_epi16(tmp16, two_8), 2));
+      // -= (1-QUANTILE)*delta/(inst->counter[s]+1), limited to |logval|.
+      down = MulShiftRight(_mm_srai_epi16(_mm_add_epi16(tmp16, one_8), 1),
+                           three_8, 1);
+      down = _mm_max_epi16(_mm_sub_epi16(quantile, down), logval_8);
+
+      is_up = _mm_cmpgt_epi16(lmagn_8, quantile);
+      quantile = _mm_or_si128(_mm_and_si128(is_up, up),
+                              _mm_andnot_si128(is_up, down));
+      _mm_storeu_si128((__m128i*)quantile_ptr, quantile);
+
+      // Update the density estimate where |lmagn - quantile| < WIDTH_Q8. The
+      // saturating differences keep the comparison exact.
+      close = _mm_and_si128(
+          _mm_cmplt_epi16(_mm_subs_epi16(lmagn_8, quantile), width_8),
+          _mm_cmplt_epi16(_mm_subs_epi16(quantile, lmagn_8), width_8));
+      density = _mm_loadu_si128((__m128i*)density_ptr);
+      MulShiftRightWithRound(density, count_prod_8, 15, &density_lo,
+                             &density_hi);
+      density = _mm_or_si128(
+          _mm_and_si128(close,
+                        _mm_add_epi16(PackTruncate(density_lo, density_hi),
+                                      density_term_8)),
+          _mm_andnot_si128(close, density));
+      _mm_storeu_si128((__m128i*)density_ptr, density);
+    }
+    for (; i < inst->magnLen; i++) {
+      UpdateQuantile(inst, offset + i, lmagn[i], countDiv, countProd, logval,
+                     density_term);
+    }
+
+    if (counter >= END_STARTUP_LONG) {
+      inst->noiseEstCounter[s] = 0;
+      if (inst->blockIndex >= END_STARTUP_LONG) {
+        WebRtcNsx_UpdateNoiseEstimate(inst, offset);
+      }
+    }
+    inst->noiseEstCounter[s]++;
+
+  }  // end loop over simultaneous estimates
+
+  // Sequentially update the noise during startup
+  if (inst->blockIndex < END_STARTUP_LONG) {
+    WebRtcNsx_UpdateNoiseEstimate(inst, offset);
+  }
+
+  for (i = 0; i < inst->magnLen; i++) {
+    noise[i] = (uint32_t)(inst->noiseEstQuantile[i]); // Q(qNoise)
+  }
+  (*q_noise) = (int16_t)inst->qNoise;
+}
+
+// Filter the data in the frequency domain, and create spectrum.
+static void PrepareSpectrumSSE2(NsxInst_t* inst, int16_t* freq_buf) {
+  const __m128i zero = _mm_setzero_si128();
+  int i;
+
+  // The filter is in Q14, so it fits int16_t like in the C version.
+  for (i = 0; i + 8 <= inst->magnLen; i += 8) {
+    const __m128i filter =
+        _mm_loadu_si128((__m128i*)&inst->noiseSupFilter[i]);
+    const __m128i real = _mm_loadu_si128((__m128i*)&inst->real[i]);
+    const __m128i imag = _mm_loadu_si128((__m128i*)&inst->imag[i]);
+    _mm_storeu_si128((__m128i*)&inst->real[i],
+                     MulShiftRight(real, filter, 14));
+    _mm_storeu_si128((__m128i*)&inst->imag[i],
+                     MulShiftRight(imag, filter, 14));
+  }
+  for (; i < inst->magnLen; i++) {
+    inst->real[i] = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT(inst->real[i],
+        (int16_t)(inst->noiseSupFilter[i]), 14); // Q(normData-stages)
+    inst->imag[i] = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT(inst->imag[i],
+        (int16_t)(inst->noiseSupFilter[i]), 14); // Q(normData-stages)
+  }
+
+  // Interleave the real and the negated imaginary parts.
+  for (i = 0; i + 8 <= inst->anaLen2; i += 8) {
+    const __m128i real = _mm_loadu_si128((__m128i*)&inst->real[i]);
+    const __m128i imag = _mm_sub_epi16(
+        zero, _mm_loadu_si128((__m128i*)&inst->imag[i]));
+    _mm_storeu_si128((__m128i*)&freq_buf[2 * i],
+                     _mm_unpacklo_epi16(real, imag));
+    _mm_storeu_si128((__m128i*)&freq_buf[2 * i + 8],
+                     _mm_unpackhi_epi16(real, imag));
+  }
+  for (; i <= inst->anaLen2; i++) {
+    freq_buf[2 * i] = inst->real[i];
+    freq_buf[2 * i + 1] = -inst->imag[i];
+  }
+}
+
+// For the noise supression process, synthesis, read out fully processed
+// segment, and update synthesis buffer.
+static void SynthesisUpdateSSE2(NsxInst_t* inst,
+                                int16_t* out_frame,
+                                int16_t gain_factor) {
+  const __m128i gain = _mm_set1_epi16(gain_factor);
+  int i;
+
+  // synthesis, anaLen is a multiple of eight.
+  assert(inst->anaLen % 8 == 0);
+  for (i = 0; i < inst->anaLen; i += 8) {
+    const __m128i window = _mm_loadu_si128((__m128i*)&inst->window[i]);
+    const __m128i real = _mm_loadu_si128((__m128i*)&inst->real[i]);
+    __m128i* synthesis = (__m128i*)&inst->synthesisBuffer[i];
+    __m128i lo, hi;
+    // Q0, window in Q14
+    MulShiftRightWithRound(window, real, 14, &lo, &hi);
+    // Q0, saturated to int16_t
+    MulShiftRightWithRound(PackTruncate(lo, hi), gain, 13, &lo, &hi);
+    _mm_storeu_si128(synthesis,
+                     _mm_adds_epi16(_mm_loadu_si128(synthesis),
+                                    _mm_packs_epi32(lo, hi)));
+  }
+
+  // read out fully processed segment
+  for (i = 0; i < inst->blockLen10ms; i++) {
+    out_frame[i] = inst->synthesisBuffer[i]; // Q0
+  }
+
+  // update synthesis buffer
+  WEBRTC_SPL_MEMCPY_W16(inst->synthesisBuffer,
+                        inst->synthesisBuffer + inst->blockLen10ms,
+                        inst->anaLen - inst->blockLen10ms);
+  WebRtcSpl_ZerosArrayW16(inst->synthesisBuffer
+      + inst->anaLen - inst->blockLen10ms, inst->blockLen10ms);
+}
+
+void WebRtcNsx_InitSSE2(void) {
+  WebRtcNsx_NoiseEstimation = NoiseEstimationSSE2;
+  WebRtcNsx_PrepareSpectrum = PrepareSpectrumSSE2;
+  WebRtcNsx_SynthesisUpdate = SynthesisUpdateSSE2;
+}
@@ -29,6 +29,18 @@ void RMSLevel::Reset() {
 }
 
 void RMSLevel::Process(const int16_t* data, int length) {
+  // Sum the squares exactly in integers and only convert the total of the
+  // chunk. This avoids a conversion and a dependent float addition per sample,
+  // and lets the compiler vectorize the loop.
+  int64_t sum_square = 0;
+  for (int i = 0; i < length; ++i) {
+    sum_square += data[i] * data[i];
+  }
+  sum_square_ += sum_square;
+  sample_count_ += length;
+}
+
+void RMSLevel::Process(const float* data, int length) {
   for (int i = 0; i < length; ++i) {
     sum_square_ += data[i] * data[i];
   }
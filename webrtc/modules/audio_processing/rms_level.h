@@ -36,6 +36,8 @@ class RMSLevel {
 
   // Pass each chunk of audio to Process() to accumulate the level.
   void Process(const int16_t* data, int length);
+  // Same as above, for float data in the int16 range.
+  void Process(const float* data, int length);
 
   // If all samples with the given |length| have a magnitude of zero, this is
   // a shortcut to avoid some computation.
@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/splitting_filter.h"
+
+#include <assert.h>
+
+#include "webrtc/modules/audio_processing/splitting_filter_sse2.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace {
+
+// The Q16 coefficients of WebRtcSpl_kAllPassFilter1 and 2 in
+// splitting_filter.c.
+const float kAllPassFilter1[3] = {6418.f / 65536, 36982.f / 65536,
+                                  57261.f / 65536};
+const float kAllPassFilter2[3] = {21333.f / 65536, 49062.f / 65536,
+                                  63010.f / 65536};
+
+// Filters |data| in place with a cascade of three first order all-pass
+// filters:
+//
+//         a_3 + q^-1    a_2 + q^-1    a_1 + q^-1
+// y[n] =  -----------   -----------   -----------   x[n]
+//         1 + a_3q^-1   1 + a_2q^-1   1 + a_1q^-1
+//
+// Each cascade stores its x[-1] and y[-1] in |filter_state|.
+void AllPassQMF(float* data, int data_length, const float* coefficients,
+                float* filter_state) {
+  for (int j = 0; j < 3; ++j) {
+    float x_prev = filter_state[2 * j];
+    float y_prev = filter_state[2 * j + 1];
+    const float a = coefficients[j];
+    for (int k = 0; k < data_length; ++k) {
+      // y[n] = x[n-1] + a * (x[n] - y[n-1])
+      const float x = data[k];
+      y_prev = x_prev + a * (x - y_prev);
+      x_prev = x;
+      data[k] = y_prev;
+    }
+    filter_state[2 * j] = x_prev;
+    filter_state[2 * j + 1] = y_prev;
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// If we know the minimum architecture at compile time, avoid CPU detection.
+bool UseSSE2() {
+#if defined(__SSE2__)
+  return true;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) != 0;
+#endif
+}
+#endif
+
+}  // namespace
+
+void SplittingFilterAnalysis(const float* in_data,
+                             int in_data_length,
+                             float* low_band,
+                             float* high_band,
+                             float* filter_state1,
+                             float* filter_state2) {
+  float half_in1[kMaxSplittingFilterBandLength];
+  float half_in2[kMaxSplittingFilterBandLength];
+  const int band_length = in_data_length / 2;
+  assert(in_data_length % 2 == 0);
+  assert(band_length <= kMaxSplittingFilterBandLength);
+
+  // Split even and odd samples.
+  for (int i = 0, k = 0; i < band_length; ++i, k += 2) {
+    half_in2[i] = in_data[k];
+    half_in1[i] = in_data[k + 1];
+  }
+
+  // All pass filter even and odd samples, independently.
+  AllPassQMF(half_in1, band_length, kAllPassFilter1, filter_state1);
+  AllPassQMF(half_in2, band_length, kAllPassFilter2, filter_state2);
+
+  // Take the sum and difference of filtered version of odd and even
+  // branches to get upper & lower band.
+  for (int i = 0; i < band_length; ++i) {
+    low_band[i] = (half_in1[i] + half_in2[i]) * 0.5f;
+    high_band[i] = (half_in1[i] - half_in2[i]) * 0.5f;
+  }
+}
+
+void SplittingFilterSynthesis(const float* low_band,
+                              const float* high_band,
+                              int band_length,
+                              float* out_data,
+                              float* filter_state1,
+                              float* filter_state2) {
+  float half_in1[kMaxSplittingFilterBandLength];
+  float half_in2[kMaxSplittingFilterBandLength];
+  assert(band_length <= kMaxSplittingFilterBandLength);
+
+  // Obtain the sum and difference channels out of upper and lower-band
+  // channels.
+  for (int i = 0; i < band_length; ++i) {
+    half_in1[i] = low_band[i] + high_band[i];
+    half_in2[i] = low_band[i] - high_band[i];
+  }
+
+  // All-pass filter the sum and difference channels.
+  AllPassQMF(half_in1, band_length, kAllPassFilter2, filter_state1);
+  AllPassQMF(half_in2, band_length, kAllPassFilter1, filter_state2);
+
+  // The filtered signals are even and odd samples of the output. Combine
+  // them.
+  for (int i = 0, k = 0; i < band_length; ++i) {
+    out_data[k++] = half_in2[i];
+    out_data[k++] = half_in1[i];
+  }
+}
+
+void SplittingFilterAnalysis(const float* const* in_data,
+                             int num_channels,
+                             int in_data_length,
+                             float* const* low_band,
+                             float* const* high_band,
+                             SplitFilterStates* states) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (UseSSE2()) {
+    SplittingFilterAnalysis_SSE2(in_data, num_channels, in_data_length,
+                                 low_band, high_band, states,
+                                 kAllPassFilter1, kAllPassFilter2);
+    return;
+  }
+#endif
+  for (int i = 0; i < num_channels; ++i) {
+    SplittingFilterAnalysis(in_data[i], in_data_length, low_band[i],
+                            high_band[i], states[i].analysis_filter_state1_f,
+                            states[i].analysis_filter_state2_f);
+  }
+}
+
+void SplittingFilterSynthesis(const float* const* low_band,
+                              const float* const* high_band,
+                              int num_channels,
+                              int band_length,
+                              float* const* out_data,
+                              SplitFilterStates* states) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (UseSSE2()) {
+    SplittingFilterSynthesis_SSE2(low_band, high_band, num_channels,
+                                  band_length, out_data, states,
+                                  kAllPassFilter1, kAllPassFilter2);
+    return;
+  }
+#endif
+  for (int i = 0; i < num_channels; ++i) {
+    SplittingFilterSynthesis(low_band[i], high_band[i], band_length,
+                             out_data[i], states[i].synthesis_filter_state1_f,
+                             states[i].synthesis_filter_state2_f);
+  }
+}
+
+}  // namespace webrtc
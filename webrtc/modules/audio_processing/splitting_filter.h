@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_SPLITTING_FILTER_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_SPLITTING_FILTER_H_
+
+#include <string.h>
+
+namespace webrtc {
+
+static const int kSplittingFilterStateSize = 6;
+
+// Maximum number of samples in a low/high-band frame.
+static const int kMaxSplittingFilterBandLength = 240;  // 10 ms at 48 kHz.
+
+// The states of the fixed-point and float splitting filters of one channel.
+struct SplitFilterStates {
+  SplitFilterStates() {
+    memset(analysis_filter_state1, 0, sizeof(analysis_filter_state1));
+    memset(analysis_filter_state2, 0, sizeof(analysis_filter_state2));
+    memset(synthesis_filter_state1, 0, sizeof(synthesis_filter_state1));
+    memset(synthesis_filter_state2, 0, sizeof(synthesis_filter_state2));
+    memset(analysis_filter_state1_f, 0, sizeof(analysis_filter_state1_f));
+    memset(analysis_filter_state2_f, 0, sizeof(analysis_filter_state2_f));
+    memset(synthesis_filter_state1_f, 0, sizeof(synthesis_filter_state1_f));
+    memset(synthesis_filter_state2_f, 0, sizeof(synthesis_filter_state2_f));
+  }
+
+  static const int kStateSize = kSplittingFilterStateSize;
+  int analysis_filter_state1[kStateSize];
+  int analysis_filter_state2[kStateSize];
+  int synthesis_filter_state1[kStateSize];
+  int synthesis_filter_state2[kStateSize];
+
+  // States of the float splitting filter.
+  float analysis_filter_state1_f[kSplittingFilterStateSize];
+  float analysis_filter_state2_f[kSplittingFilterStateSize];
+  float synthesis_filter_state1_f[kSplittingFilterStateSize];
+  float synthesis_filter_state2_f[kSplittingFilterStateSize];
+};
+
+
+// Float versions of WebRtcSpl_AnalysisQMF() and WebRtcSpl_SynthesisQMF(),
+// using the same all-pass QMF filters. The data has the range of int16_t, but
+// is neither rounded nor saturated. Each filter state has
+// kSplittingFilterStateSize elements.
+//
+// Splits |in_data| into a low and a high band, each of half the length.
+void SplittingFilterAnalysis(const float* in_data,
+                             int in_data_length,
+                             float* low_band,
+                             float* high_band,
+                             float* filter_state1,
+                             float* filter_state2);
+
+// Combines the |band_length| samples of |low_band| and |high_band| into
+// |out_data|, which has twice the length.
+void SplittingFilterSynthesis(const float* low_band,
+                              const float* high_band,
+                              int band_length,
+                              float* out_data,
+                              float* filter_state1,
+                              float* filter_state2);
+
+// Multi-channel versions of the above, using the float states in the
+// |num_channels| elements of |states|. The channels are filtered together,
+// two at a time with SSE2, with their even and odd branches in separate
+// lanes. The results are identical to those of the single channel versions.
+void SplittingFilterAnalysis(const float* const* in_data,
+                             int num_channels,
+                             int in_data_length,
+                             float* const* low_band,
+                             float* const* high_band,
+                             SplitFilterStates* states);
+void SplittingFilterSynthesis(const float* const* low_band,
+                              const float* const* high_band,
+                              int num_channels,
+                              int band_length,
+                              float* const* out_data,
+                              SplitFilterStates* states);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_SPLITTING_FILTER_H_
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/splitting_filter_sse2.h"
+
+#include <assert.h>
+#include <emmintrin.h>
+
+namespace webrtc {
+namespace {
+
+// The channels are filtered in pairs, with the lanes of each vector holding
+// one sample of the even and odd branches of the first and then the second
+// channel. An odd last channel is paired with a copy of itself, whose output
+// and states are discarded.
+
+// Gathers the six states of a cascade of all-pass filters for each lane.
+void LoadStates(const float* lane0,
+                const float* lane1,
+                const float* lane2,
+                const float* lane3,
+                __m128* x_prev,
+                __m128* y_prev) {
+  for (int j = 0; j < 3; ++j) {
+    x_prev[j] = _mm_setr_ps(lane0[2 * j], lane1[2 * j], lane2[2 * j],
+                            lane3[2 * j]);
+    y_prev[j] = _mm_setr_ps(lane0[2 * j + 1], lane1[2 * j + 1],
+                            lane2[2 * j + 1], lane3[2 * j + 1]);
+  }
+}
+
+void StoreStates(const __m128* x_prev,
+                 const __m128* y_prev,
+                 float* lane0,
+                 float* lane1,
+                 float* lane2,
+                 float* lane3) {
+  float* lanes[4] = {lane0, lane1, lane2, lane3};
+  float x[4];
+  float y[4];
+  for (int j = 0; j < 3; ++j) {
+    _mm_storeu_ps(x, x_prev[j]);
+    _mm_storeu_ps(y, y_prev[j]);
+    for (int k = 0; k < 4; ++k) {
+      lanes[k][2 * j] = x[k];
+      lanes[k][2 * j + 1] = y[k];
+    }
+  }
+}
+
+// AllPassQMF() of splitting_filter.cc for each lane. The three filters are
+// run sample by sample rather than one after another, which gives the same
+// result but lets their dependency chains overlap.
+void AllPassQMF(__m128* data,
+                int data_length,
+                const __m128* coefficients,
+                __m128* x_prev,
+                __m128* y_prev) {
+  for (int k = 0; k < data_length; ++k) {
+    __m128 x = data[k];
+    for (int j = 0; j < 3; ++j) {
+      // y[n] = x[n-1] + a * (x[n] - y[n-1])
+      const __m128 y = _mm_add_ps(
+          x_prev[j], _mm_mul_ps(coefficients[j], _mm_sub_ps(x, y_prev[j])));
+      x_prev[j] = x;
+      y_prev[j] = y;
+      x = y;
+    }
+    data[k] = x;
+  }
+}
+
+}  // namespace
+
+void SplittingFilterAnalysis_SSE2(const float* const* in_data,
+                                  int num_channels,
+                                  int in_data_length,
+                                  float* const* low_band,
+                                  float* const* high_band,
+                                  SplitFilterStates* states,
+                                  const float* all_pass_filter1,
+                                  const float* all_pass_filter2) {
+  __m128 filtered[kMaxSplittingFilterBandLength];
+  float unused_low_band[kMaxSplittingFilterBandLength];
+  float unused_high_band[kMaxSplittingFilterBandLength];
+  SplitFilterStates unused_states;
+  const int band_length = in_data_length / 2;
+  assert(in_data_length % 2 == 0);
+  assert(band_length <= kMaxSplittingFilterBandLength);
+
+  // The even samples go through the second filter, the odd ones through the
+  // first.
+  __m128 coefficients[3];
+  for (int j = 0; j < 3; ++j) {
+    coefficients[j] = _mm_setr_ps(all_pass_filter2[j], all_pass_filter1[j],
+                                  all_pass_filter2[j], all_pass_filter1[j]);
+  }
+
+  for (int c = 0; c < num_channels; c += 2) {
+    const bool has_pair = c + 1 < num_channels;
+    const float* in0 = in_data[c];
+    const float* in1 = has_pair ? in_data[c + 1] : in0;
+    float* low0 = low_band[c];
+    float* high0 = high_band[c];
+    float* low1 = has_pair ? low_band[c + 1] : unused_low_band;
+    float* high1 = has_pair ? high_band[c + 1] : unused_high_band;
+    SplitFilterStates* states0 = &states[c];
+    SplitFilterStates* states1 = has_pair ? &states[c + 1] : &unused_states;
+
+    __m128 x_prev[3];
+    __m128 y_prev[3];
+    LoadStates(states0->analysis_filter_state2_f,
+               states0->analysis_filter_state1_f,
+               states1->analysis_filter_state2_f,
+               states1->analysis_filter_state1_f,
+               x_prev, y_prev);
+
+    // Even and odd samples are adjacent, so each channel is one 64-bit load.
+    for (int i = 0; i < band_length; ++i) {
+      filtered[i] = _mm_loadh_pi(
+          _mm_loadl_pi(_mm_setzero_ps(),
+                       reinterpret_cast<const __m64*>(&in0[2 * i])),
+          reinterpret_cast<const __m64*>(&in1[2 * i]));
+    }
+
+    AllPassQMF(filtered, band_length, coefficients, x_prev, y_prev);
+
+    StoreStates(x_prev, y_prev,
+                states0->analysis_filter_state2_f,
+                states0->analysis_filter_state1_f,
+                states1->analysis_filter_state2_f,
+                states1->analysis_filter_state1_f);
+
+    // Take the sum and difference of the branches, four samples at a time
+    // after transposing them into one vector per branch.
+    const __m128 kHalf = _mm_set1_ps(0.5f);
+    int i = 0;
+    for (; i + 4 <= band_length; i += 4) {
+      // Each sample vector becomes one element of each branch vector.
+      __m128 even0 = filtered[i];
+      __m128 odd0 = filtered[i + 1];
+      __m128 even1 = filtered[i + 2];
+      __m128 odd1 = filtered[i + 3];
+      _MM_TRANSPOSE4_PS(even0, odd0, even1, odd1);
+      _mm_storeu_ps(&low0[i], _mm_mul_ps(_mm_add_ps(odd0, even0), kHalf));
+      _mm_storeu_ps(&high0[i], _mm_mul_ps(_mm_sub_ps(odd0, even0), kHalf));
+      _mm_storeu_ps(&low1[i], _mm_mul_ps(_mm_add_ps(odd1, even1), kHalf));
+      _mm_storeu_ps(&high1[i], _mm_mul_ps(_mm_sub_ps(odd1, even1), kHalf));
+    }
+    for (; i < band_length; ++i) {
+      float lanes[4];
+      _mm_storeu_ps(lanes, filtered[i]);
+      low0[i] = (lanes[1] + lanes[0]) * 0.5f;
+      high0[i] = (lanes[1] - lanes[0]) * 0.5f;
+      low1[i] = (lanes[3] + lanes[2]) * 0.5f;
+      high1[i] = (lanes[3] - lanes[2]) * 0.5f;
+    }
+  }
+}
+
+void SplittingFilterSynthesis_SSE2(const float* const* low_band,
+                                   const float* const* high_band,
+                                   int num_channels,
+                                   int band_length,
+                                   float* const* out_data,
+                                   SplitFilterStates* states,
+                                   const float* all_pass_filter1,
+                                   const float* all_pass_filter2) {
+  __m128 filtered[kMaxSplittingFilterBandLength];
+  float unused_out_data[2 * kMaxSplittingFilterBandLength];
+  SplitFilterStates unused_states;
+  assert(band_length <= kMaxSplittingFilterBandLength);
+
+  // The difference of the bands goes through the first filter and becomes the
+  // even samples, the sum goes through the second and becomes the odd ones.
+  __m128 coefficients[3];
+  for (int j = 0; j < 3; ++j) {
+    coefficients[j] = _mm_setr_ps(all_pass_filter1[j], all_pass_filter2[j],
+                                  all_pass_filter1[j], all_pass_filter2[j]);
+  }
+
+  for (int c = 0; c < num_channels; c += 2) {
+    const bool has_pair = c + 1 < num_channels;
+    const float* low0 = low_band[c];
+    const float* high0 = high_band[c];
+    const float* low1 = has_pair ? low_band[c + 1] : low0;
+    const float* high1 = has_pair ? high_band[c + 1] : high0;
+    float* out0 = out_data[c];
+    float* out1 = has_pair ? out_data[c + 1] : unused_out_data;
+    SplitFilterStates* states0 = &states[c];
+    SplitFilterStates* states1 = has_pair ? &states[c + 1] : &unused_states;
+
+    // Obtain the difference and sum of the bands, four samples at a time, and
+    // transpose them into one vector per sample.
+    int i = 0;
+    for (; i + 4 <= band_length; i += 4) {
+      const __m128 l0 = _mm_loadu_ps(&low0[i]);
+      const __m128 h0 = _mm_loadu_ps(&high0[i]);
+      const __m128 l1 = _mm_loadu_ps(&low1[i]);
+      const __m128 h1 = _mm_loadu_ps(&high1[i]);
+      __m128 sample0 = _mm_sub_ps(l0, h0);
+      __m128 sample1 = _mm_add_ps(l0, h0);
+      __m128 sample2 = _mm_sub_ps(l1, h1);
+      __m128 sample3 = _mm_add_ps(l1, h1);
+      _MM_TRANSPOSE4_PS(sample0, sample1, sample2, sample3);
+      filtered[i] = sample0;
+      filtered[i + 1] = sample1;
+      filtered[i + 2] = sample2;
+      filtered[i + 3] = sample3;
+    }
+    for (; i < band_length; ++i) {
+      filtered[i] = _mm_setr_ps(low0[i] - high0[i], low0[i] + high0[i],
+                                low1[i] - high1[i], low1[i] + high1[i]);
+    }
+
+    __m128 x_prev[3];
+    __m128 y_prev[3];
+    LoadStates(states0->synthesis_filter_state2_f,
+               states0->synthesis_filter_state1_f,
+               states1->synthesis_filter_state2_f,
+               states1->synthesis_filter_state1_f,
+               x_prev, y_prev);
+
+    AllPassQMF(filtered, band_length, coefficients, x_prev, y_prev);
+
+    StoreStates(x_prev, y_prev,
+                states0->synthesis_filter_state2_f,
+                states0->synthesis_filter_state1_f,
+                states1->synthesis_filter_state2_f,
+                states1->synthesis_filter_state1_f);
+
+    // The lanes of each channel are its next even and odd output samples.
+    for (i = 0; i < band_length; ++i) {
+      _mm_storel_pi(reinterpret_cast<__m64*>(&out0[2 * i]), filtered[i]);
+      _mm_storeh_pi(reinterpret_cast<__m64*>(&out1[2 * i]), filtered[i]);
+    }
+  }
+}
+
+}  // namespace webrtc
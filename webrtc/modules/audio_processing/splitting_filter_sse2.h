@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_SPLITTING_FILTER_SSE2_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_SPLITTING_FILTER_SSE2_H_
+
+#include "webrtc/modules/audio_processing/splitting_filter.h"
+
+namespace webrtc {
+
+// SSE2 versions of the multi-channel SplittingFilterAnalysis() and
+// SplittingFilterSynthesis(), given the three coefficients of each of the two
+// all-pass filters. Only called after checking for SSE2 support, if needed.
+void SplittingFilterAnalysis_SSE2(const float* const* in_data,
+                                  int num_channels,
+                                  int in_data_length,
+                                  float* const* low_band,
+                                  float* const* high_band,
+                                  SplitFilterStates* states,
+                                  const float* all_pass_filter1,
+                                  const float* all_pass_filter2);
+void SplittingFilterSynthesis_SSE2(const float* const* low_band,
+                                   const float* const* high_band,
+                                   int num_channels,
+                                   int band_length,
+                                   float* const* out_data,
+                                   SplitFilterStates* states,
+                                   const float* all_pass_filter1,
+                                   const float* all_pass_filter2);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_SPLITTING_FILTER_SSE2_H_
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include <math.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/modules/audio_processing/splitting_filter.h"
+
+namespace webrtc {
+namespace {
+
+const int kSamplesPer32kHzChannel = 320;
+const int kSamplesPer16kHzChannel = 160;
+const int kNumFrames = 20;
+
+// Fills |frame| with the |frame_index|th 10 ms of a sum of two tones, one in
+// each band.
+void GenerateFrame(int frame_index, int16_t* frame) {
+  for (int i = 0; i < kSamplesPer32kHzChannel; ++i) {
+    const double t = (frame_index * kSamplesPer32kHzChannel + i) / 32000.0;
+    frame[i] = static_cast<int16_t>(8000 * sin(2 * M_PI * 1000 * t) +
+                                    8000 * sin(2 * M_PI * 12000 * t));
+  }
+}
+
+}  // namespace
+
+// The float splitting filter should match the fixed-point one up to the
+// rounding of the latter.
+TEST(SplittingFilterTest, MatchesFixedPoint) {
+  int32_t analysis_state1[kSplittingFilterStateSize] = {0};
+  int32_t analysis_state2[kSplittingFilterStateSize] = {0};
+  int32_t synthesis_state1[kSplittingFilterStateSize] = {0};
+  int32_t synthesis_state2[kSplittingFilterStateSize] = {0};
+  float analysis_state1_f[kSplittingFilterStateSize] = {0};
+  float analysis_state2_f[kSplittingFilterStateSize] = {0};
+  float synthesis_state1_f[kSplittingFilterStateSize] = {0};
+  float synthesis_state2_f[kSplittingFilterStateSize] = {0};
+
+  int16_t in[kSamplesPer32kHzChannel];
+  int16_t low[kSamplesPer16kHzChannel];
+  int16_t high[kSamplesPer16kHzChannel];
+  int16_t out[kSamplesPer32kHzChannel];
+  float in_f[kSamplesPer32kHzChannel];
+  float low_f[kSamplesPer16kHzChannel];
+  float high_f[kSamplesPer16kHzChannel];
+  float out_f[kSamplesPer32kHzChannel];
+
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    GenerateFrame(frame, in);
+    for (int i = 0; i < kSamplesPer32kHzChannel; ++i)
+      in_f[i] = in[i];
+
+    WebRtcSpl_AnalysisQMF(in, kSamplesPer32kHzChannel, low, high,
+                          analysis_state1, analysis_state2);
+    SplittingFilterAnalysis(in_f, kSamplesPer32kHzChannel, low_f, high_f,
+                            analysis_state1_f, analysis_state2_f);
+    for (int i = 0; i < kSamplesPer16kHzChannel; ++i) {
+      EXPECT_NEAR(low[i], low_f[i], 2);
+      EXPECT_NEAR(high[i], high_f[i], 2);
+    }
+
+    WebRtcSpl_SynthesisQMF(low, high, kSamplesPer16kHzChannel, out,
+                           synthesis_state1, synthesis_state2);
+    SplittingFilterSynthesis(low_f, high_f, kSamplesPer16kHzChannel, out_f,
+                             synthesis_state1_f, synthesis_state2_f);
+    for (int i = 0; i < kSamplesPer32kHzChannel; ++i) {
+      EXPECT_NEAR(out[i], out_f[i], 4);
+    }
+  }
+}
+
+// Filtering the channels together should give exactly the same result as
+// filtering them one by one, for any number of channels.
+TEST(SplittingFilterTest, MultiChannelMatchesSingleChannel) {
+  const int kMaxChannels = 3;
+  int16_t frame[kSamplesPer32kHzChannel];
+  for (int num_channels = 1; num_channels <= kMaxChannels; ++num_channels) {
+    SplitFilterStates states[kMaxChannels];
+    SplitFilterStates reference_states[kMaxChannels];
+    float in[kMaxChannels][kSamplesPer32kHzChannel];
+    float low[kMaxChannels][kSamplesPer16kHzChannel];
+    float high[kMaxChannels][kSamplesPer16kHzChannel];
+    float out[kMaxChannels][kSamplesPer32kHzChannel];
+    float reference_low[kSamplesPer16kHzChannel];
+    float reference_high[kSamplesPer16kHzChannel];
+    float reference_out[kSamplesPer32kHzChannel];
+    float* in_ptrs[kMaxChannels] = {in[0], in[1], in[2]};
+    float* low_ptrs[kMaxChannels] = {low[0], low[1], low[2]};
+    float* high_ptrs[kMaxChannels] = {high[0], high[1], high[2]};
+    float* out_ptrs[kMaxChannels] = {out[0], out[1], out[2]};
+
+    for (int frame_index = 0; frame_index < kNumFrames; ++frame_index) {
+      // Give each channel a different signal, by scaling and delaying it.
+      for (int c = 0; c < num_channels; ++c) {
+        GenerateFrame(frame_index + c, frame);
+        for (int i = 0; i < kSamplesPer32kHzChannel; ++i)
+          in[c][i] = frame[i] / (c + 1.f);
+      }
+
+      SplittingFilterAnalysis(in_ptrs, num_channels, kSamplesPer32kHzChannel,
+                              low_ptrs, high_ptrs, states);
+      SplittingFilterSynthesis(low_ptrs, high_ptrs, num_channels,
+                               kSamplesPer16kHzChannel, out_ptrs, states);
+
+      for (int c = 0; c < num_channels; ++c) {
+        SplittingFilterAnalysis(in[c], kSamplesPer32kHzChannel,
+                                reference_low, reference_high,
+                                reference_states[c].analysis_filter_state1_f,
+                                reference_states[c].analysis_filter_state2_f);
+        SplittingFilterSynthesis(
+            reference_low, reference_high, kSamplesPer16kHzChannel,
+            reference_out, reference_states[c].synthesis_filter_state1_f,
+            reference_states[c].synthesis_filter_state2_f);
+        for (int i = 0; i < kSamplesPer16kHzChannel; ++i) {
+          ASSERT_EQ(reference_low[i], low[c][i]);
+          ASSERT_EQ(reference_high[i], high[c][i]);
+        }
+        for (int i = 0; i < kSamplesPer32kHzChannel; ++i)
+          ASSERT_EQ(reference_out[i], out[c][i]);
+      }
+    }
+  }
+}
+
+// Unlike the fixed-point version, the float splitting filter doesn't saturate.
+TEST(SplittingFilterTest, DoesNotSaturate) {
+  float analysis_state1[kSplittingFilterStateSize] = {0};
+  float analysis_state2[kSplittingFilterStateSize] = {0};
+  float in[kSamplesPer32kHzChannel];
+  float low[kSamplesPer16kHzChannel];
+  float high[kSamplesPer16kHzChannel];
+  for (int i = 0; i < kSamplesPer32kHzChannel; ++i)
+    in[i] = 100000;
+
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    SplittingFilterAnalysis(in, kSamplesPer32kHzChannel, low, high,
+                            analysis_state1, analysis_state2);
+  }
+  // DC ends up in the low band only.
+  for (int i = 0; i < kSamplesPer16kHzChannel; ++i) {
+    EXPECT_NEAR(100000, low[i], 1);
+    EXPECT_NEAR(0, high[i], 1);
+  }
+}
+
+}  // namespace webrtc
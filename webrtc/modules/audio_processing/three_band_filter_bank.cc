@@ -0,0 +1,145 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "webrtc/modules/audio_processing/three_band_filter_bank.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+namespace webrtc {
+namespace {
+
+// The prototype low-pass filter. Its cutoff, in cycles per full-band sample,
+// and the Kaiser window parameter were tuned for the best reconstruction.
+const int kFilterLength = 60;
+const double kCutoff = 0.092;
+const double kKaiserBeta = 8.5;
+
+// Zeroth order modified Bessel function of the first kind.
+double BesselI0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 50; ++k) {
+    term *= x / (2 * k);
+    sum += term * term;
+  }
+  return sum;
+}
+
+// Fills |prototype| with the kFilterLength coefficients of the prototype
+// filter, normalized to unity gain at DC.
+void DesignPrototype(double* prototype) {
+  const double center = (kFilterLength - 1) / 2.0;
+  double sum = 0.0;
+  for (int n = 0; n < kFilterLength; ++n) {
+    const double t = n - center;
+    const double sinc = t == 0.0 ? 2 * kCutoff :
+        sin(2 * M_PI * kCutoff * t) / (M_PI * t);
+    const double r = 2.0 * n / (kFilterLength - 1) - 1.0;
+    prototype[n] = sinc * BesselI0(kKaiserBeta * sqrt(1.0 - r * r)) /
+        BesselI0(kKaiserBeta);
+    sum += prototype[n];
+  }
+  for (int n = 0; n < kFilterLength; ++n)
+    prototype[n] /= sum;
+}
+
+}  // namespace
+
+const int ThreeBandFilterBank::kDelay = kFilterLength - 1;
+
+ThreeBandFilterBank::ThreeBandFilterBank(int length)
+    : length_(length),
+      analysis_filters_(new float[kNumBands * kFilterLength]),
+      synthesis_filters_(new float[kNumBands * kFilterLength]),
+      analysis_buffer_(new float[kFilterLength - 1 + length]),
+      synthesis_buffer_(new float[length + kFilterLength - 1]) {
+  assert(length > 0 && length % kNumBands == 0);
+  double prototype[kFilterLength];
+  DesignPrototype(prototype);
+
+  // Modulate the prototype to the center of each band, with the phases which
+  // cancel the aliasing between neighbouring bands.
+  const double center = (kFilterLength - 1) / 2.0;
+  for (int k = 0; k < kNumBands; ++k) {
+    const double phase = (k % 2 == 0 ? 1 : -1) * M_PI / 4;
+    for (int n = 0; n < kFilterLength; ++n) {
+      const double modulation = M_PI / kNumBands * (k + 0.5) * (n - center);
+      analysis_filters_[k * kFilterLength + kFilterLength - 1 - n] =
+          static_cast<float>(2 * prototype[n] * cos(modulation + phase));
+      synthesis_filters_[k * kFilterLength + n] = static_cast<float>(
+          kNumBands * 2 * prototype[n] * cos(modulation - phase));
+    }
+  }
+
+  memset(analysis_buffer_.get(), 0,
+         (kFilterLength - 1 + length) * sizeof(analysis_buffer_[0]));
+  memset(synthesis_buffer_.get(), 0,
+         (length + kFilterLength - 1) * sizeof(synthesis_buffer_[0]));
+}
+
+ThreeBandFilterBank::~ThreeBandFilterBank() {}
+
+void ThreeBandFilterBank::Analysis(const float* in,
+                                   int length,
+                                   float* const* out) {
+  assert(length == length_);
+  float* buffer = analysis_buffer_.get();
+  memcpy(&buffer[kFilterLength - 1], in, length * sizeof(*in));
+
+  // Each output sample of each band is the filtered input at every
+  // kNumBands-th sample. The window of input ends with that sample, so the
+  // inner loops run over contiguous data.
+  const int split_length = length / kNumBands;
+  for (int m = 0; m < split_length; ++m) {
+    const float* window = &buffer[kNumBands * m];
+    for (int k = 0; k < kNumBands; ++k) {
+      const float* filter = &analysis_filters_[k * kFilterLength];
+      float sum = 0.f;
+      for (int n = 0; n < kFilterLength; ++n)
+        sum += filter[n] * window[n];
+      out[k][m] = sum;
+    }
+  }
+
+  memmove(buffer, &buffer[length], (kFilterLength - 1) * sizeof(*buffer));
+}
+
+void ThreeBandFilterBank::Synthesis(const float* const* in,
+                                    int split_length,
+                                    float* out) {
+  const int length = kNumBands * split_length;
+  assert(length == length_);
+  float* buffer = synthesis_buffer_.get();
+
+  // Upsample and filter each band, by adding the filters scaled by each of its
+  // samples to the output at every kNumBands-th sample.
+  const float* filter0 = &synthesis_filters_[0];
+  const float* filter1 = &synthesis_filters_[kFilterLength];
+  const float* filter2 = &synthesis_filters_[2 * kFilterLength];
+  for (int m = 0; m < split_length; ++m) {
+    const float band0 = in[0][m];
+    const float band1 = in[1][m];
+    const float band2 = in[2][m];
+    float* window = &buffer[kNumBands * m];
+    for (int n = 0; n < kFilterLength; ++n)
+      window[n] += filter0[n] * band0 + filter1[n] * band1 + filter2[n] * band2;
+  }
+
+  memcpy(out, buffer, length * sizeof(*out));
+  memmove(buffer, &buffer[length], (kFilterLength - 1) * sizeof(*buffer));
+  memset(&buffer[kFilterLength - 1], 0, length * sizeof(*buffer));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+// Splits 48 kHz audio into three bands of 0-8, 8-16 and 16-24 kHz, each
+// sampled at 16 kHz, and combines them back. This is the full-band
+// counterpart of SplittingFilterAnalysis() and SplittingFilterSynthesis().
+//
+// It is a cosine modulated filter bank with a Kaiser windowed sinc prototype,
+// whose aliasing between the bands cancels out in the synthesis if they are
+// left unchanged. The reconstruction is delayed by kDelay samples and is
+// accurate to about 60 dB. As with the QMF high band, the spectrum of the
+// middle band is mirrored.
+//
+// There is one instance per channel, since it keeps the filter states.
+class ThreeBandFilterBank {
+ public:
+  static const int kNumBands = 3;
+  static const int kDelay;
+
+  // |length| is the number of full-band samples in each frame, which must be
+  // a multiple of kNumBands.
+  explicit ThreeBandFilterBank(int length);
+  ~ThreeBandFilterBank();
+
+  // Splits the |length| samples of |in| into the kNumBands bands of |out|,
+  // lowest first, each of |length| / kNumBands samples.
+  void Analysis(const float* in, int length, float* const* out);
+
+  // Combines the kNumBands bands of |split_length| samples in |in| into
+  // |out|, which has kNumBands * |split_length| samples.
+  void Synthesis(const float* const* in, int split_length, float* out);
+
+ private:
+  const int length_;
+  // The filters of all bands, kFilterLength coefficients each. The analysis
+  // ones are reversed, and the synthesis ones include the interpolation gain.
+  scoped_ptr<float[]> analysis_filters_;
+  scoped_ptr<float[]> synthesis_filters_;
+  // The last kFilterLength - 1 input samples, followed by the current frame.
+  scoped_ptr<float[]> analysis_buffer_;
+  // The current frame of output, followed by the kFilterLength - 1 samples
+  // which overlap with the next one.
+  scoped_ptr<float[]> synthesis_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreeBandFilterBank);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
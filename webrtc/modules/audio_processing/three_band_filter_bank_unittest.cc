@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include <math.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_processing/three_band_filter_bank.h"
+
+namespace webrtc {
+namespace {
+
+const int kSamplesPer48kHzChannel = 480;
+const int kSamplesPer16kHzChannel = 160;
+const int kNumFrames = 20;
+const int kNumBands = ThreeBandFilterBank::kNumBands;
+
+// Fills |frame| with the |frame_index|th 10 ms of a tone at |frequency|.
+void GenerateTone(int frame_index, float frequency, float* frame) {
+  for (int i = 0; i < kSamplesPer48kHzChannel; ++i) {
+    const double t = (frame_index * kSamplesPer48kHzChannel + i) / 48000.0;
+    frame[i] = static_cast<float>(10000 * sin(2 * M_PI * frequency * t));
+  }
+}
+
+}  // namespace
+
+// A tone in the middle of each band should end up in that band only.
+TEST(ThreeBandFilterBankTest, SeparatesBands) {
+  const float kFrequencies[kNumBands] = {4000.f, 12000.f, 20000.f};
+  float in[kSamplesPer48kHzChannel];
+  float bands[kNumBands][kSamplesPer16kHzChannel];
+  float* band_ptrs[kNumBands] = {bands[0], bands[1], bands[2]};
+
+  for (int tone = 0; tone < kNumBands; ++tone) {
+    ThreeBandFilterBank filter_bank(kSamplesPer48kHzChannel);
+    double energy[kNumBands] = {0};
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+      GenerateTone(frame, kFrequencies[tone], in);
+      filter_bank.Analysis(in, kSamplesPer48kHzChannel, band_ptrs);
+      // Skip the first frame, where the filters are still filling up.
+      if (frame == 0)
+        continue;
+      for (int k = 0; k < kNumBands; ++k) {
+        for (int i = 0; i < kSamplesPer16kHzChannel; ++i)
+          energy[k] += bands[k][i] * bands[k][i];
+      }
+    }
+    for (int k = 0; k < kNumBands; ++k) {
+      if (k != tone)
+        EXPECT_GT(10 * log10(energy[tone] / energy[k]), 60);
+    }
+  }
+}
+
+// Splitting and combining the bands again should give back the input,
+// delayed by kDelay samples.
+TEST(ThreeBandFilterBankTest, ReconstructsInput) {
+  ThreeBandFilterBank filter_bank(kSamplesPer48kHzChannel);
+  float in[kNumFrames * kSamplesPer48kHzChannel];
+  float out[kNumFrames * kSamplesPer48kHzChannel];
+  float bands[kNumBands][kSamplesPer16kHzChannel];
+  float* band_ptrs[kNumBands] = {bands[0], bands[1], bands[2]};
+
+  // A chirp through all the bands.
+  for (size_t i = 0; i < sizeof(in) / sizeof(in[0]); ++i) {
+    const double t = i / 48000.0;
+    in[i] = static_cast<float>(10000 * sin(2 * M_PI * (100 + 57500 * t) * t));
+  }
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    filter_bank.Analysis(&in[frame * kSamplesPer48kHzChannel],
+                         kSamplesPer48kHzChannel, band_ptrs);
+    filter_bank.Synthesis(band_ptrs, kSamplesPer16kHzChannel,
+                          &out[frame * kSamplesPer48kHzChannel]);
+  }
+
+  double signal = 0;
+  double error = 0;
+  for (int i = ThreeBandFilterBank::kDelay;
+       i < kNumFrames * kSamplesPer48kHzChannel; ++i) {
+    const double diff = out[i] - in[i - ThreeBandFilterBank::kDelay];
+    signal += in[i - ThreeBandFilterBank::kDelay] *
+        in[i - ThreeBandFilterBank::kDelay];
+    error += diff * diff;
+  }
+  EXPECT_GT(10 * log10(signal / error), 55);
+}
+
+}  // namespace webrtc
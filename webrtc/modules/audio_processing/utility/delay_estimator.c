@@ -14,6 +14,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+
 // Number of right shifts for scaling is linearly depending on number of bits in
 // the far-end binary spectrum.
 static const int kShiftsAtZero = 13;  // Right shifts at zero binary spectrum.
@@ -59,10 +61,10 @@ static int BitCount(uint32_t u32) {
 //                            row the number of times the matrix row and the
 //                            input vector have the same value
 //
-static void BitCountComparison(uint32_t binary_vector,
-                               const uint32_t* binary_matrix,
-                               int matrix_size,
-                               int32_t* bit_counts) {
+static void BitCountComparisonC(uint32_t binary_vector,
+                                const uint32_t* binary_matrix,
+                                int matrix_size,
+                                int32_t* bit_counts) {
   int n = 0;
 
   // Compare |binary_vector| with all rows of the |binary_matrix|
@@ -71,6 +73,8 @@ static void BitCountComparison(uint32_t binary_vector,
   }
 }
 
+BitCountComparison WebRtc_BitCountComparison;
+
 // Collects necessary statistics for the HistogramBasedValidation().  This
 // function has to be called prior to calling HistogramBasedValidation().  The
 // statistics updated and used by the HistogramBasedValidation() are:
@@ -418,6 +422,14 @@ BinaryDelayEstimator* WebRtc_CreateBinaryDelayEstimator(
 
   self->lookahead = max_lookahead;
 
+  // Initialize function pointers.
+  WebRtc_BitCountComparison = BitCountComparisonC;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtc_InitBinaryDelayEstimatorSSE2();
+  }
+#endif
+
   // Allocate memory for spectrum and history buffers.
   self->mean_bit_counts = NULL;
   self->bit_counts = NULL;
@@ -539,8 +551,9 @@ int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator* self,
   }
 
   // Compare with delayed spectra and store the |bit_counts| for each delay.
-  BitCountComparison(binary_near_spectrum, self->farend->binary_far_history,
-                     self->history_size, self->bit_counts);
+  WebRtc_BitCountComparison(binary_near_spectrum,
+                            self->farend->binary_far_history,
+                            self->history_size, self->bit_counts);
 
   // Update |mean_bit_counts|, which is the smoothed version of |bit_counts|.
   for (i = 0; i < self->history_size; i++) {
@@ -248,4 +248,18 @@ void WebRtc_MeanEstimatorFix(int32_t new_value,
                              int factor,
                              int32_t* mean_value);
 
+// Compares the |binary_vector| with all rows of the |binary_matrix| and counts
+// per row the number of bits that differ. This is the speed-critical part of
+// WebRtc_ProcessBinarySpectrum(), selected in
+// WebRtc_CreateBinaryDelayEstimator().
+typedef void (*BitCountComparison)(uint32_t binary_vector,
+                                   const uint32_t* binary_matrix,
+                                   int matrix_size,
+                                   int32_t* bit_counts);
+extern BitCountComparison WebRtc_BitCountComparison;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtc_InitBinaryDelayEstimatorSSE2(void);
+#endif
+
 #endif  // WEBRTC_MODULES_AUDIO_PROCESSING_UTILITY_DELAY_ESTIMATOR_H_
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The binary delay estimator, SSE2 version of speed-critical functions.
+ */
+
+#include "webrtc/modules/audio_processing/utility/delay_estimator.h"
+
+#include <emmintrin.h>
+
+// Counts the bits of each of the four 32-bit lanes of |v|, the same way as
+// BitCount() in delay_estimator.c.
+static __inline __m128i BitCount4(__m128i v) {
+  const __m128i m1 = _mm_set1_epi32(0x55555555);
+  const __m128i m2 = _mm_set1_epi32(0x33333333);
+  const __m128i m4 = _mm_set1_epi32(0x0f0f0f0f);
+  v = _mm_sub_epi32(v, _mm_and_si128(_mm_srli_epi32(v, 1), m1));
+  v = _mm_add_epi32(_mm_and_si128(v, m2),
+                    _mm_and_si128(_mm_srli_epi32(v, 2), m2));
+  v = _mm_and_si128(_mm_add_epi32(v, _mm_srli_epi32(v, 4)), m4);
+  // Sum the four byte counts, which add up to at most 32.
+  v = _mm_add_epi32(v, _mm_srli_epi32(v, 8));
+  v = _mm_add_epi32(v, _mm_srli_epi32(v, 16));
+  return _mm_and_si128(v, _mm_set1_epi32(0x3f));
+}
+
+static void BitCountComparisonSSE2(uint32_t binary_vector,
+                                   const uint32_t* binary_matrix,
+                                   int matrix_size,
+                                   int32_t* bit_counts) {
+  const __m128i vector_4 = _mm_set1_epi32((int)binary_vector);
+  int n = 0;
+
+  // Compare |binary_vector| with four rows of the |binary_matrix| at a time.
+  for (; n + 4 <= matrix_size; n += 4) {
+    const __m128i rows = _mm_loadu_si128((const __m128i*)&binary_matrix[n]);
+    _mm_storeu_si128((__m128i*)&bit_counts[n],
+                     BitCount4(_mm_xor_si128(vector_4, rows)));
+  }
+  for (; n < matrix_size; n++) {
+    const __m128i row = _mm_cvtsi32_si128((int)binary_matrix[n]);
+    bit_counts[n] = _mm_cvtsi128_si32(
+        BitCount4(_mm_xor_si128(vector_4, row)));
+  }
+}
+
+void WebRtc_InitBinaryDelayEstimatorSSE2(void) {
+  WebRtc_BitCountComparison = BitCountComparisonSSE2;
+}
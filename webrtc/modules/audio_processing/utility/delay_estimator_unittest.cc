@@ -15,6 +15,7 @@ extern "C" {
 #include "webrtc/modules/audio_processing/utility/delay_estimator_internal.h"
 #include "webrtc/modules/audio_processing/utility/delay_estimator_wrapper.h"
 }
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/typedefs.h"
 
 namespace {
@@ -616,6 +617,37 @@ TEST_F(DelayEstimatorTest, VerifyHistorySizeIsSetAndKeptAfterInit) {
   EXPECT_EQ(kDifferentHistorySize, WebRtc_history_size(handle_));
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST_F(DelayEstimatorTest, Sse2BitCountComparisonIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  // Creating an estimator selects the comparison, so get the C version by
+  // creating one without SSE2.
+  WebRtc_CPUInfo cpu_info = WebRtc_GetCPUInfo;
+  WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+  BinaryDelayEstimator* binary_handle =
+      WebRtc_CreateBinaryDelayEstimator(binary_farend_, kLookahead);
+  WebRtc_GetCPUInfo = cpu_info;
+  ASSERT_TRUE(binary_handle != NULL);
+  BitCountComparison bit_count_comparison_c = WebRtc_BitCountComparison;
+  WebRtc_InitBinaryDelayEstimatorSSE2();
+
+  int32_t bit_counts_c[kHistorySize];
+  int32_t bit_counts_sse2[kHistorySize];
+  // Cover all lengths of the non-vectorized tail.
+  for (int size = kHistorySize - 4; size <= kHistorySize; ++size) {
+    bit_count_comparison_c(binary_spectrum_[size], binary_spectrum_, size,
+                           bit_counts_c);
+    WebRtc_BitCountComparison(binary_spectrum_[size], binary_spectrum_, size,
+                              bit_counts_sse2);
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(bit_counts_c[i], bit_counts_sse2[i]);
+    }
+  }
+  WebRtc_FreeBinaryDelayEstimator(binary_handle);
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
 // TODO(bjornv): Add tests for SoftReset...(...).
 
 }  // namespace
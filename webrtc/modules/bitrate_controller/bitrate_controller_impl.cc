@@ -11,12 +11,27 @@
 
 #include "webrtc/modules/bitrate_controller/bitrate_controller_impl.h"
 
+#include <math.h>
+
 #include <algorithm>
 #include <utility>
 
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 
 namespace webrtc {
+namespace {
+
+// A cached estimate is started from at this share, halved for every
+// kCachedEstimateHalfLifeMs of its age, since the network may have changed
+// in between.
+const double kCachedEstimateShare = 0.8;
+const int64_t kCachedEstimateHalfLifeMs = 24 * 60 * 60 * 1000;
+// The estimate is only cached once it had the time to ramp up, and then
+// refreshed at this interval.
+const int64_t kMinTimeToCacheEstimateMs = 10000;
+const int64_t kCacheEstimateIntervalMs = 5000;
+
+}  // namespace
 
 class BitrateControllerImpl::RtcpBandwidthObserverImpl
     : public RtcpBandwidthObserver {
@@ -96,9 +111,17 @@ BitrateControllerImpl::BitrateControllerImpl(Clock* clock, bool enforce_min_bitr
       last_rtt_ms_(0),
       last_enforce_min_bitrate_(!enforce_min_bitrate_),
       bitrate_observers_modified_(false),
-      last_reserved_bitrate_bps_(0) {}
+      last_reserved_bitrate_bps_(0),
+      estimate_cache_(NULL),
+      cached_start_bitrate_bps_(0),
+      estimate_cache_set_ms_(0),
+      last_cached_ms_(0),
+      shared_allocator_(NULL),
+      shared_priority_(1) {}
 
 BitrateControllerImpl::~BitrateControllerImpl() {
+  if (shared_allocator_)
+    shared_allocator_->RemoveController(this);
   BitrateObserverConfList::iterator it = bitrate_observers_.begin();
   while (it != bitrate_observers_.end()) {
     delete it->second;
@@ -166,7 +189,8 @@ void BitrateControllerImpl::SetBitrateObserver(
     // you can only have one start bitrate, once we have our first estimate we
     // will adapt from there.
     if (bitrate_observers_.size() == 1) {
-      bandwidth_estimation_.SetSendBitrate(start_bitrate);
+      bandwidth_estimation_.SetSendBitrate(
+          std::max(start_bitrate, cached_start_bitrate_bps_));
     }
   }
 
@@ -205,6 +229,18 @@ void BitrateControllerImpl::RemoveBitrateObserver(BitrateObserver* observer) {
   }
 }
 
+void BitrateControllerImpl::SetBitrateObserverPriority(
+    BitrateObserver* observer,
+    int priority) {
+  CriticalSectionScoped cs(critsect_);
+  BitrateObserverConfList::iterator it = FindObserverConfigurationPair(
+      observer);
+  if (it != bitrate_observers_.end() && it->second->priority_ != priority) {
+    it->second->priority_ = std::max(priority, 1);
+    bitrate_observers_modified_ = true;
+  }
+}
+
 void BitrateControllerImpl::EnforceMinBitrate(bool enforce_min_bitrate) {
   CriticalSectionScoped cs(critsect_);
   enforce_min_bitrate_ = enforce_min_bitrate;
@@ -223,6 +259,59 @@ void BitrateControllerImpl::OnReceivedEstimatedBitrate(const uint32_t bitrate) {
   MaybeTriggerOnNetworkChanged();
 }
 
+void BitrateControllerImpl::SetEstimateCache(BitrateEstimateCache* cache,
+                                             const std::string& key) {
+  CriticalSectionScoped cs(critsect_);
+  estimate_cache_ = cache;
+  estimate_cache_key_ = key;
+  cached_start_bitrate_bps_ = 0;
+  estimate_cache_set_ms_ = clock_->TimeInMilliseconds();
+  last_cached_ms_ = 0;
+  uint32_t cached_bitrate_bps;
+  int64_t age_ms;
+  if (!cache || !cache->Lookup(key, &cached_bitrate_bps, &age_ms))
+    return;
+  cached_start_bitrate_bps_ = static_cast<uint32_t>(
+      cached_bitrate_bps * kCachedEstimateShare *
+      pow(0.5, static_cast<double>(std::max<int64_t>(age_ms, 0)) /
+                   kCachedEstimateHalfLifeMs) + 0.5);
+  if (!bitrate_observers_.empty()) {
+    // Already started, go up to the cached estimate if it's higher.
+    uint32_t current_estimate;
+    uint8_t loss;
+    uint32_t rtt;
+    bandwidth_estimation_.CurrentEstimate(&current_estimate, &loss, &rtt);
+    if (cached_start_bitrate_bps_ > current_estimate)
+      bandwidth_estimation_.SetSendBitrate(cached_start_bitrate_bps_);
+  }
+}
+
+void BitrateControllerImpl::SetSharedBitrateAllocator(
+    SharedBitrateAllocator* allocator,
+    int priority) {
+  CriticalSectionScoped cs(critsect_);
+  if (shared_allocator_ && shared_allocator_ != allocator)
+    shared_allocator_->RemoveController(this);
+  shared_allocator_ = allocator;
+  shared_priority_ = std::max(priority, 1);
+  MaybeTriggerOnNetworkChanged();
+}
+
+void BitrateControllerImpl::MaybeCacheEstimate(int64_t now_ms) {
+  if (!estimate_cache_ || bitrate_observers_.empty() ||
+      now_ms - estimate_cache_set_ms_ < kMinTimeToCacheEstimateMs ||
+      (last_cached_ms_ != 0 &&
+       now_ms - last_cached_ms_ < kCacheEstimateIntervalMs)) {
+    return;
+  }
+  uint32_t bitrate;
+  uint8_t fraction_loss;
+  uint32_t rtt;
+  bandwidth_estimation_.CurrentEstimate(&bitrate, &fraction_loss, &rtt);
+  estimate_cache_->Store(estimate_cache_key_, bitrate);
+  last_cached_ms_ = now_ms;
+}
+
 int32_t BitrateControllerImpl::TimeUntilNextProcess() {
   enum { kBitrateControllerUpdateIntervalMs = 25 };
   CriticalSectionScoped cs(critsect_);
@@ -238,6 +327,7 @@ int32_t BitrateControllerImpl::Process() {
     CriticalSectionScoped cs(critsect_);
     bandwidth_estimation_.UpdateEstimate(clock_->TimeInMilliseconds());
     MaybeTriggerOnNetworkChanged();
+    MaybeCacheEstimate(clock_->TimeInMilliseconds());
   }
   last_bitrate_update_ms_ = clock_->TimeInMilliseconds();
   return 0;
@@ -259,7 +349,7 @@ void BitrateControllerImpl::MaybeTriggerOnNetworkChanged() {
   uint8_t fraction_loss;
   uint32_t rtt;
   bandwidth_estimation_.CurrentEstimate(&bitrate, &fraction_loss, &rtt);
-  bitrate -= std::min(bitrate, reserved_bitrate_bps_);
+  bitrate = AllocatableBitrate(bitrate);
 
   if (bitrate_observers_modified_ ||
       bitrate != last_bitrate_bps_ ||
@@ -277,6 +367,16 @@ void BitrateControllerImpl::MaybeTriggerOnNetworkChanged() {
   }
 }
 
+uint32_t BitrateControllerImpl::AllocatableBitrate(
+    uint32_t estimate_bps) const {
+  uint32_t bitrate = estimate_bps;
+  if (shared_allocator_) {
+    bitrate = shared_allocator_->Allocate(this, estimate_bps,
+                                          shared_priority_);
+  }
+  return bitrate - std::min(bitrate, reserved_bitrate_bps_);
+}
+
 void BitrateControllerImpl::OnNetworkChanged(const uint32_t bitrate,
                                              const uint8_t fraction_loss,
                                              const uint32_t rtt) {
@@ -299,30 +399,37 @@ void BitrateControllerImpl::NormalRateAllocation(uint32_t bitrate,
                                                  uint8_t fraction_loss,
                                                  uint32_t rtt,
                                                  uint32_t sum_min_bitrates) {
-  uint32_t number_of_observers = bitrate_observers_.size();
-  uint32_t bitrate_per_observer = (bitrate - sum_min_bitrates) /
-      number_of_observers;
-  // Use map to sort list based on max bitrate.
+  // The bitrate above the minimum bitrates is split in proportion to the
+  // priorities.
+  int sum_priorities = 0;
+  // Use map to sort list based on max bitrate per priority.
   ObserverSortingMap list_max_bitrates;
   BitrateObserverConfList::iterator it;
   for (it = bitrate_observers_.begin(); it != bitrate_observers_.end(); ++it) {
+    sum_priorities += it->second->priority_;
     list_max_bitrates.insert(std::pair<uint32_t, ObserverConfiguration*>(
-        it->second->max_bitrate_,
-        new ObserverConfiguration(it->first, it->second->min_bitrate_)));
+        it->second->max_bitrate_ / it->second->priority_,
+        new ObserverConfiguration(it->first, it->second->min_bitrate_,
+                                  it->second->max_bitrate_,
+                                  it->second->priority_)));
   }
+  uint32_t bitrate_per_priority = (bitrate - sum_min_bitrates) /
+      sum_priorities;
   ObserverSortingMap::iterator max_it = list_max_bitrates.begin();
   while (max_it != list_max_bitrates.end()) {
-    number_of_observers--;
+    const int priority = max_it->second->priority_;
+    const uint32_t max_bitrate = max_it->second->max_bitrate_;
+    sum_priorities -= priority;
     uint32_t observer_allowance = max_it->second->min_bitrate_ +
-        bitrate_per_observer;
-    if (max_it->first < observer_allowance) {
+        bitrate_per_priority * priority;
+    if (max_bitrate < observer_allowance) {
       // We have more than enough for this observer.
       // Carry the remainder forward.
-      uint32_t remainder = observer_allowance - max_it->first;
-      if (number_of_observers != 0) {
-        bitrate_per_observer += remainder / number_of_observers;
+      uint32_t remainder = observer_allowance - max_bitrate;
+      if (sum_priorities != 0) {
+        bitrate_per_priority += remainder / sum_priorities;
       }
-      max_it->second->observer_->OnNetworkChanged(max_it->first, fraction_loss,
+      max_it->second->observer_->OnNetworkChanged(max_bitrate, fraction_loss,
                                                   rtt);
     } else {
       max_it->second->observer_->OnNetworkChanged(observer_allowance,
@@ -371,7 +478,7 @@ bool BitrateControllerImpl::AvailableBandwidth(uint32_t* bandwidth) const {
   uint32_t rtt;
   bandwidth_estimation_.CurrentEstimate(&bitrate, &fraction_loss, &rtt);
   if (bitrate) {
-    *bandwidth = bitrate - std::min(bitrate, reserved_bitrate_bps_);
+    *bandwidth = AllocatableBitrate(bitrate);
     return true;
   }
   return false;
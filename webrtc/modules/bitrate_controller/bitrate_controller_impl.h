@@ -19,6 +19,7 @@
 
 #include <list>
 #include <map>
+#include <string>
 #include <utility>
 
 #include "webrtc/modules/bitrate_controller/send_side_bandwidth_estimation.h"
@@ -43,8 +44,15 @@ class BitrateControllerImpl : public BitrateController {
 
   virtual void RemoveBitrateObserver(BitrateObserver* observer) OVERRIDE;
 
+  virtual void SetBitrateObserverPriority(BitrateObserver* observer,
+                                          int priority) OVERRIDE;
+
   virtual void EnforceMinBitrate(bool enforce_min_bitrate) OVERRIDE;
   virtual void SetReservedBitrate(uint32_t reserved_bitrate_bps) OVERRIDE;
+  virtual void SetEstimateCache(BitrateEstimateCache* cache,
+                                const std::string& key) OVERRIDE;
+  virtual void SetSharedBitrateAllocator(SharedBitrateAllocator* allocator,
+                                         int priority) OVERRIDE;
 
   virtual int32_t TimeUntilNextProcess() OVERRIDE;
   virtual int32_t Process() OVERRIDE;
@@ -58,20 +66,28 @@ class BitrateControllerImpl : public BitrateController {
                          uint32_t max_bitrate)
         : start_bitrate_(start_bitrate),
           min_bitrate_(min_bitrate),
-          max_bitrate_(max_bitrate) {
+          max_bitrate_(max_bitrate),
+          priority_(1) {
     }
     uint32_t start_bitrate_;
     uint32_t min_bitrate_;
     uint32_t max_bitrate_;
+    int priority_;
   };
   struct ObserverConfiguration {
     ObserverConfiguration(BitrateObserver* observer,
-                          uint32_t bitrate)
+                          uint32_t min_bitrate,
+                          uint32_t max_bitrate,
+                          int priority)
         : observer_(observer),
-          min_bitrate_(bitrate) {
+          min_bitrate_(min_bitrate),
+          max_bitrate_(max_bitrate),
+          priority_(priority) {
     }
     BitrateObserver* observer_;
     uint32_t min_bitrate_;
+    uint32_t max_bitrate_;
+    int priority_;
   };
   typedef std::pair<BitrateObserver*, BitrateConfiguration*>
       BitrateObserverConfiguration;
@@ -89,6 +105,13 @@ class BitrateControllerImpl : public BitrateController {
 
   void MaybeTriggerOnNetworkChanged() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
 
+  // Returns the bitrate to allocate to the observers, from |estimate_bps|.
+  uint32_t AllocatableBitrate(uint32_t estimate_bps) const
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+
+  // Stores the current estimate in the cache once it has settled.
+  void MaybeCacheEstimate(int64_t now_ms) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+
   void OnNetworkChanged(const uint32_t bitrate,
                         const uint8_t fraction_loss,  // 0 - 255.
                         const uint32_t rtt)
@@ -128,6 +151,16 @@ class BitrateControllerImpl : public BitrateController {
   bool bitrate_observers_modified_ GUARDED_BY(*critsect_);
   uint32_t last_reserved_bitrate_bps_ GUARDED_BY(*critsect_);
 
+  BitrateEstimateCache* estimate_cache_ GUARDED_BY(*critsect_);
+  std::string estimate_cache_key_ GUARDED_BY(*critsect_);
+  // The discounted cached estimate to start from, zero if there is none.
+  uint32_t cached_start_bitrate_bps_ GUARDED_BY(*critsect_);
+  int64_t estimate_cache_set_ms_ GUARDED_BY(*critsect_);
+  int64_t last_cached_ms_ GUARDED_BY(*critsect_);
+
+  SharedBitrateAllocator* shared_allocator_ GUARDED_BY(*critsect_);
+  int shared_priority_ GUARDED_BY(*critsect_);
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(BitrateControllerImpl);
 };
 }  // namespace webrtc
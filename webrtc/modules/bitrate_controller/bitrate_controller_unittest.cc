@@ -15,6 +15,7 @@
 
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
 
 using webrtc::RtcpBandwidthObserver;
 using webrtc::BitrateObserver;
@@ -101,6 +102,53 @@ TEST_F(BitrateControllerTest, UpdatingBitrateObserver) {
   EXPECT_EQ(1500000u, bitrate_observer.last_bitrate_);
 }
 
+TEST_F(BitrateControllerTest, StartsFromCachedEstimate) {
+  webrtc::scoped_ptr<webrtc::BitrateEstimateCache> cache(
+      webrtc::BitrateEstimateCache::Create(&clock_));
+  cache->Store("known", 1000000);
+  controller_->SetEstimateCache(cache.get(), "known");
+  TestBitrateObserver bitrate_observer;
+  controller_->SetBitrateObserver(&bitrate_observer, 200000, 100000, 1500000);
+  clock_.AdvanceTimeMilliseconds(25);
+  controller_->Process();
+  // Discounted, since the network may have changed.
+  EXPECT_EQ(800000u, bitrate_observer.last_bitrate_);
+
+  // The estimate is stored back once it had the time to settle.
+  uint32_t bitrate_bps;
+  int64_t age_ms;
+  for (int i = 0; i < 10000 / 25; ++i) {
+    bandwidth_observer_->OnReceivedEstimatedBitrate(600000);
+    clock_.AdvanceTimeMilliseconds(25);
+    controller_->Process();
+  }
+  ASSERT_TRUE(cache->Lookup("known", &bitrate_bps, &age_ms));
+  EXPECT_EQ(600000u, bitrate_bps);
+  EXPECT_LT(age_ms, 5000);
+  controller_->RemoveBitrateObserver(&bitrate_observer);
+
+  // An old estimate counts for less.
+  clock_.AdvanceTimeMilliseconds(24 * 60 * 60 * 1000);
+  BitrateController* controller =
+      BitrateController::CreateBitrateController(&clock_, true);
+  controller->SetEstimateCache(cache.get(), "known");
+  controller->SetBitrateObserver(&bitrate_observer, 200000, 100000, 1500000);
+  clock_.AdvanceTimeMilliseconds(25);
+  controller->Process();
+  EXPECT_EQ(240000u, bitrate_observer.last_bitrate_);
+  controller->RemoveBitrateObserver(&bitrate_observer);
+
+  // Unknown destinations and estimates below the start bitrate start from the
+  // start bitrate.
+  controller->SetEstimateCache(cache.get(), "unknown");
+  controller->SetBitrateObserver(&bitrate_observer, 200000, 100000, 1500000);
+  clock_.AdvanceTimeMilliseconds(25);
+  controller->Process();
+  EXPECT_EQ(200000u, bitrate_observer.last_bitrate_);
+  controller->RemoveBitrateObserver(&bitrate_observer);
+  delete controller;
+}
+
 TEST_F(BitrateControllerTest, OneBitrateObserverOneRtcpObserver) {
   TestBitrateObserver bitrate_observer;
   controller_->SetBitrateObserver(&bitrate_observer, 200000, 100000, 300000);
@@ -426,6 +474,29 @@ TEST_F(BitrateControllerTest, TwoBitrateObserversOneRtcpObserver) {
   controller_->RemoveBitrateObserver(&bitrate_observer_2);
 }
 
+TEST_F(BitrateControllerTest, TwoBitrateObserversWithPriorities) {
+  TestBitrateObserver bitrate_observer_1;
+  TestBitrateObserver bitrate_observer_2;
+  controller_->SetBitrateObserver(&bitrate_observer_1, 500000, 100000,
+                                  1000000);
+  controller_->SetBitrateObserver(&bitrate_observer_2, 0, 100000, 1000000);
+  controller_->SetBitrateObserverPriority(&bitrate_observer_2, 3);
+
+  // The 300 kbps above the min bitrates are split 1:3.
+  bandwidth_observer_->OnReceivedEstimatedBitrate(500000);
+  EXPECT_EQ(175000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(325000u, bitrate_observer_2.last_bitrate_);
+
+  // What the observer with the higher priority can't use goes to the other.
+  controller_->SetBitrateObserver(&bitrate_observer_2, 0, 100000, 200000);
+  bandwidth_observer_->OnReceivedEstimatedBitrate(480000);
+  EXPECT_EQ(280000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(200000u, bitrate_observer_2.last_bitrate_);
+
+  controller_->RemoveBitrateObserver(&bitrate_observer_1);
+  controller_->RemoveBitrateObserver(&bitrate_observer_2);
+}
+
 TEST_F(BitrateControllerTest, SetReservedBitrate) {
   TestBitrateObserver bitrate_observer;
   controller_->SetBitrateObserver(&bitrate_observer, 200000, 100000, 300000);
@@ -481,6 +552,85 @@ TEST_F(BitrateControllerTest, SetReservedBitrate) {
   controller_->RemoveBitrateObserver(&bitrate_observer);
 }
 
+TEST_F(BitrateControllerTest, SharedAllocatorKeepsEstimatePerController) {
+  webrtc::scoped_ptr<webrtc::SharedBitrateAllocator> allocator(
+      webrtc::SharedBitrateAllocator::Create());
+  webrtc::scoped_ptr<BitrateController> controller(
+      BitrateController::CreateBitrateController(&clock_, true));
+  webrtc::scoped_ptr<RtcpBandwidthObserver> bandwidth_observer(
+      controller->CreateRtcpBandwidthObserver());
+  controller_->SetSharedBitrateAllocator(allocator.get(), 1);
+  controller->SetSharedBitrateAllocator(allocator.get(), 1);
+  TestBitrateObserver bitrate_observer_1;
+  TestBitrateObserver bitrate_observer_2;
+  controller_->SetBitrateObserver(&bitrate_observer_1, 1000000, 100000,
+                                  1500000);
+  controller->SetBitrateObserver(&bitrate_observer_2, 1000000, 100000,
+                                 1500000);
+
+  // The REMB of one peer doesn't cap the encoders sending to the other.
+  bandwidth_observer_->OnReceivedEstimatedBitrate(300000);
+  bandwidth_observer->OnReceivedEstimatedBitrate(900000);
+  EXPECT_EQ(300000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(900000u, bitrate_observer_2.last_bitrate_);
+
+  // A known capacity is split, and what one controller can't use goes to the
+  // other.
+  allocator->SetCapacity(1000000);
+  clock_.AdvanceTimeMilliseconds(25);
+  controller_->Process();
+  controller->Process();
+  EXPECT_EQ(300000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(700000u, bitrate_observer_2.last_bitrate_);
+
+  controller_->RemoveBitrateObserver(&bitrate_observer_1);
+  controller->RemoveBitrateObserver(&bitrate_observer_2);
+  controller_->SetSharedBitrateAllocator(NULL, 1);
+}
+
+TEST_F(BitrateControllerTest, SharedAllocatorSplitsCapacityByPriority) {
+  webrtc::scoped_ptr<webrtc::SharedBitrateAllocator> allocator(
+      webrtc::SharedBitrateAllocator::Create());
+  allocator->SetCapacity(800000);
+  webrtc::scoped_ptr<BitrateController> controller(
+      BitrateController::CreateBitrateController(&clock_, true));
+  webrtc::scoped_ptr<RtcpBandwidthObserver> bandwidth_observer(
+      controller->CreateRtcpBandwidthObserver());
+  controller_->SetSharedBitrateAllocator(allocator.get(), 1);
+  controller->SetSharedBitrateAllocator(allocator.get(), 3);
+  TestBitrateObserver bitrate_observer_1;
+  TestBitrateObserver bitrate_observer_2;
+  controller_->SetBitrateObserver(&bitrate_observer_1, 1000000, 100000,
+                                  1500000);
+  controller->SetBitrateObserver(&bitrate_observer_2, 1000000, 100000,
+                                 1500000);
+  bandwidth_observer_->OnReceivedEstimatedBitrate(900000);
+  bandwidth_observer->OnReceivedEstimatedBitrate(900000);
+  clock_.AdvanceTimeMilliseconds(25);
+  controller_->Process();
+  controller->Process();
+  EXPECT_EQ(200000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(600000u, bitrate_observer_2.last_bitrate_);
+
+  // The reserved bitrate of one controller is taken from its own share.
+  controller_->SetReservedBitrate(50000);
+  clock_.AdvanceTimeMilliseconds(25);
+  controller_->Process();
+  controller->Process();
+  EXPECT_EQ(150000u, bitrate_observer_1.last_bitrate_);
+  EXPECT_EQ(600000u, bitrate_observer_2.last_bitrate_);
+
+  // A removed controller leaves the capacity to the others.
+  controller->RemoveBitrateObserver(&bitrate_observer_2);
+  controller.reset();
+  clock_.AdvanceTimeMilliseconds(25);
+  controller_->Process();
+  EXPECT_EQ(750000u, bitrate_observer_1.last_bitrate_);
+
+  controller_->RemoveBitrateObserver(&bitrate_observer_1);
+  controller_->SetSharedBitrateAllocator(NULL, 1);
+}
+
 class BitrateControllerTestNoEnforceMin : public BitrateControllerTest {
  protected:
   BitrateControllerTestNoEnforceMin() : BitrateControllerTest() {
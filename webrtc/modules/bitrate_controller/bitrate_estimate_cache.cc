@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+#include <utility>
+
+#include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_annotations.h"
+
+namespace webrtc {
+namespace {
+
+class InMemoryBitrateEstimateCache : public BitrateEstimateCache {
+ public:
+  explicit InMemoryBitrateEstimateCache(Clock* clock)
+      : clock_(clock),
+        crit_(CriticalSectionWrapper::CreateCriticalSection()) {}
+  virtual ~InMemoryBitrateEstimateCache() {}
+
+  virtual bool Lookup(const std::string& key,
+                      uint32_t* bitrate_bps,
+                      int64_t* age_ms) const OVERRIDE {
+    CriticalSectionScoped cs(crit_.get());
+    EstimateMap::const_iterator it = estimates_.find(key);
+    if (it == estimates_.end())
+      return false;
+    *bitrate_bps = it->second.first;
+    *age_ms = clock_->TimeInMilliseconds() - it->second.second;
+    return true;
+  }
+
+  virtual void Store(const std::string& key, uint32_t bitrate_bps) OVERRIDE {
+    CriticalSectionScoped cs(crit_.get());
+    estimates_[key] = std::make_pair(bitrate_bps, clock_->TimeInMilliseconds());
+  }
+
+ private:
+  // The estimate and the time it was stored at.
+  typedef std::map<std::string, std::pair<uint32_t, int64_t> > EstimateMap;
+
+  Clock* const clock_;
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  EstimateMap estimates_ GUARDED_BY(crit_);
+};
+
+}  // namespace
+
+BitrateEstimateCache* BitrateEstimateCache::Create(Clock* clock) {
+  return new InMemoryBitrateEstimateCache(clock);
+}
+
+}  // namespace webrtc
@@ -15,11 +15,16 @@
 #ifndef WEBRTC_MODULES_BITRATE_CONTROLLER_INCLUDE_BITRATE_CONTROLLER_H_
 #define WEBRTC_MODULES_BITRATE_CONTROLLER_INCLUDE_BITRATE_CONTROLLER_H_
 
+#include <string>
+
 #include "webrtc/modules/interface/module.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 
 namespace webrtc {
 
+class BitrateController;
+class Clock;
+
 class BitrateObserver {
  /*
   * Observer class for the encoders, each encoder should implement this class
@@ -36,6 +41,50 @@ class BitrateObserver {
   virtual ~BitrateObserver() {}
 };
 
+// Keeps the bandwidth estimates of earlier calls, so that a call to the same
+// destination can start from one instead of ramping up from the start
+// bitrate. What identifies a destination, e.g. the local network and the
+// remote address or prefix, is up to the embedder, who passes it as the key.
+// The cache is used from the threads of all controllers it is set for.
+class BitrateEstimateCache {
+ public:
+  // Creates a cache that keeps the estimates in memory, aged by |clock|.
+  static BitrateEstimateCache* Create(Clock* clock);
+  virtual ~BitrateEstimateCache() {}
+
+  // Returns false if there is no estimate for |key|, otherwise the estimate
+  // in bits per second and how long ago it was stored.
+  virtual bool Lookup(const std::string& key,
+                      uint32_t* bitrate_bps,
+                      int64_t* age_ms) const = 0;
+  virtual void Store(const std::string& key, uint32_t bitrate_bps) = 0;
+};
+
+// Divides the bandwidth of a network interface between the bitrate controllers
+// sending over it, e.g. those of all the calls of a process. Every controller
+// keeps estimating the bandwidth to its own peer from its own feedback, and
+// reports the estimate here to get its share of the interface: the capacity is
+// split between the controllers by priority, but no controller gets more than
+// it estimated, and what it can't use goes to the others. The allocator never
+// calls into its controllers, they pick up a changed share when they process.
+// Used from the threads of all its controllers.
+class SharedBitrateAllocator {
+ public:
+  static SharedBitrateAllocator* Create();
+  virtual ~SharedBitrateAllocator() {}
+
+  // Sets the bandwidth of the interface in bits per second. Zero, the default,
+  // means it is unknown, and every controller gets its own estimate.
+  virtual void SetCapacity(uint32_t capacity_bps) = 0;
+
+  // Updates the estimate and the priority of |controller| and returns its
+  // share in bits per second.
+  virtual uint32_t Allocate(const BitrateController* controller,
+                            uint32_t estimate_bps,
+                            int priority) = 0;
+  virtual void RemoveController(const BitrateController* controller) = 0;
+};
+
 class BitrateController : public Module {
 /*
  * This class collects feedback from all streams sent to a peer (via
@@ -73,10 +122,29 @@ class BitrateController : public Module {
 
   virtual void RemoveBitrateObserver(BitrateObserver* observer) = 0;
 
+  // Sets the share of |observer| in the bitrate above the minimum bitrates,
+  // relative to the other observers. All observers start with |priority| 1.
+  virtual void SetBitrateObserverPriority(BitrateObserver* observer,
+                                          int priority) = 0;
+
   // Changes the mode that was set in the constructor.
   virtual void EnforceMinBitrate(bool enforce_min_bitrate) = 0;
 
   virtual void SetReservedBitrate(uint32_t reserved_bitrate_bps) = 0;
+
+  // Starts the estimation from the estimate stored under |key| in |cache|,
+  // discounted by its age, if that is above the start bitrate. Once the
+  // estimate has settled it is stored there in turn. The cache isn't owned
+  // and has to outlive the controller, or be unset with NULL.
+  virtual void SetEstimateCache(BitrateEstimateCache* cache,
+                                const std::string& key) = 0;
+
+  // Shares the bandwidth of the network interface with the other controllers
+  // of |allocator|, getting a share by |priority|; the reserved bitrate is
+  // taken from that share. The allocator isn't owned and has to outlive the
+  // controller, or be unset with NULL.
+  virtual void SetSharedBitrateAllocator(SharedBitrateAllocator* allocator,
+                                         int priority) = 0;
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_BITRATE_CONTROLLER_INCLUDE_BITRATE_CONTROLLER_H_
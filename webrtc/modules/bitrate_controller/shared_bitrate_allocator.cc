@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_annotations.h"
+
+namespace webrtc {
+namespace {
+
+class SharedBitrateAllocatorImpl : public SharedBitrateAllocator {
+ public:
+  SharedBitrateAllocatorImpl()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        capacity_bps_(0) {}
+  virtual ~SharedBitrateAllocatorImpl() {}
+
+  virtual void SetCapacity(uint32_t capacity_bps) OVERRIDE {
+    CriticalSectionScoped cs(crit_.get());
+    capacity_bps_ = capacity_bps;
+  }
+
+  virtual uint32_t Allocate(const BitrateController* controller,
+                            uint32_t estimate_bps,
+                            int priority) OVERRIDE {
+    CriticalSectionScoped cs(crit_.get());
+    controllers_[controller] = std::make_pair(estimate_bps,
+                                              std::max(priority, 1));
+    if (capacity_bps_ == 0)
+      return estimate_bps;
+
+    // The capacity is split in proportion to the priorities, starting with
+    // the controllers estimating the least per priority, and what one of them
+    // can't use is carried forward to the others.
+    typedef std::multimap<uint32_t, ControllerMap::const_iterator> SortingMap;
+    SortingMap sorted;
+    int sum_priorities = 0;
+    for (ControllerMap::const_iterator it = controllers_.begin();
+         it != controllers_.end(); ++it) {
+      sum_priorities += it->second.second;
+      sorted.insert(std::make_pair(it->second.first / it->second.second, it));
+    }
+    uint32_t remaining_bps = capacity_bps_;
+    for (SortingMap::const_iterator it = sorted.begin(); it != sorted.end();
+         ++it) {
+      const uint32_t estimate = it->second->second.first;
+      const int controller_priority = it->second->second.second;
+      const uint32_t allowance = static_cast<uint32_t>(
+          static_cast<uint64_t>(remaining_bps) * controller_priority /
+          sum_priorities);
+      const uint32_t share = std::min(estimate, allowance);
+      if (it->second->first == controller)
+        return share;
+      remaining_bps -= share;
+      sum_priorities -= controller_priority;
+    }
+    assert(false);
+    return 0;
+  }
+
+  virtual void RemoveController(const BitrateController* controller) OVERRIDE {
+    CriticalSectionScoped cs(crit_.get());
+    controllers_.erase(controller);
+  }
+
+ private:
+  // The estimate and the priority of every controller.
+  typedef std::map<const BitrateController*, std::pair<uint32_t, int> >
+      ControllerMap;
+
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  uint32_t capacity_bps_ GUARDED_BY(crit_);
+  ControllerMap controllers_ GUARDED_BY(crit_);
+};
+
+}  // namespace
+
+SharedBitrateAllocator* SharedBitrateAllocator::Create() {
+  return new SharedBitrateAllocatorImpl();
+}
+
+}  // namespace webrtc
@@ -16,6 +16,14 @@
 
 namespace webrtc {
 
+namespace {
+
+// AddRegion() adds the rectangles one by one when the current region has more
+// than this many times the rows of the added region.
+const size_t kMaxRowsRatioForAddRect = 4;
+
+}  // namespace
+
 DesktopRegion::RowSpan::RowSpan(int32_t left, int32_t right)
     : left(left), right(right) {
 }
@@ -166,11 +174,72 @@ void DesktopRegion::MergeWithPrecedingRow(Rows::iterator row) {
 }
 
 void DesktopRegion::AddRegion(const DesktopRegion& region) {
-  // TODO(sergeyu): This function is not optimized - potentially it can iterate
-  // over rows of the two regions similar to how it works in Intersect().
-  for (Iterator it(region); !it.IsAtEnd(); it.Advance()) {
-    AddRect(it.rect());
+  if (region.rows_.empty())
+    return;
+  if (rows_.empty()) {
+    *this = region;
+    return;
+  }
+
+  // Merging rebuilds all rows of the current region, so a region much smaller
+  // than the current one is cheaper to add rectangle by rectangle.
+  if (region.rows_.size() * kMaxRowsRatioForAddRect < rows_.size()) {
+    for (Iterator it(region); !it.IsAtEnd(); it.Advance()) {
+      AddRect(it.rect());
+    }
+    return;
   }
+
+  // Step through rows of the both regions, similar to Intersect(), and build
+  // the union row by row. Each output row is appended at the end of
+  // |new_rows|, so the map insertions don't need to search.
+  DesktopRegion result;
+  Rows::const_iterator it1 = rows_.begin();
+  Rows::const_iterator end1 = rows_.end();
+  Rows::const_iterator it2 = region.rows_.begin();
+  Rows::const_iterator end2 = region.rows_.end();
+
+  // Top of the part of the regions that hasn't been added to |result| yet.
+  int32_t top = std::min(it1->second->top, it2->second->top);
+
+  while (it1 != end1 || it2 != end2) {
+    // Arrange for |it1| to always be the row starting at or above |it2|.
+    if (it1 == end1 ||
+        (it2 != end2 && std::max(top, it2->second->top) <
+                            std::max(top, it1->second->top))) {
+      std::swap(it1, it2);
+      std::swap(end1, end2);
+    }
+    top = std::max(top, it1->second->top);
+
+    Rows::iterator new_row;
+    if (it2 == end2 || top < it2->second->top) {
+      // Only |it1| covers |top|; copy its spans down to where |it2| starts.
+      int32_t bottom = it1->second->bottom;
+      if (it2 != end2 && it2->second->top < bottom)
+        bottom = it2->second->top;
+      new_row = result.rows_.insert(
+          result.rows_.end(), Rows::value_type(bottom, new Row(top, bottom)));
+      new_row->second->spans = it1->second->spans;
+    } else {
+      // Both rows cover |top|.
+      int32_t bottom = std::min(it1->second->bottom, it2->second->bottom);
+      new_row = result.rows_.insert(
+          result.rows_.end(), Rows::value_type(bottom, new Row(top, bottom)));
+      UnionRows(it1->second->spans, it2->second->spans,
+                &new_row->second->spans);
+    }
+    result.MergeWithPrecedingRow(new_row);
+    top = new_row->first;
+
+    // Move past the rows that were completely consumed.
+    if (it1 != end1 && it1->second->bottom == top)
+      ++it1;
+    if (it2 != end2 && it2->second->bottom == top)
+      ++it2;
+  }
+
+  Swap(&result);
 }
 
 void DesktopRegion::Intersect(const DesktopRegion& region1,
@@ -260,6 +329,32 @@ void DesktopRegion::IntersectRows(const RowSpanSet& set1,
   } while (it1 != end1 && it2 != end2);
 }
 
+// static
+void DesktopRegion::UnionRows(const RowSpanSet& set1,
+                              const RowSpanSet& set2,
+                              RowSpanSet* output) {
+  RowSpanSet::const_iterator it1 = set1.begin();
+  RowSpanSet::const_iterator it2 = set2.begin();
+  output->reserve(set1.size() + set2.size());
+
+  // Take the left-most of the remaining spans and append it to |output|,
+  // coalescing it with the last span if they touch or overlap.
+  while (it1 != set1.end() || it2 != set2.end()) {
+    RowSpanSet::const_iterator span;
+    if (it2 == set2.end() || (it1 != set1.end() && it1->left < it2->left)) {
+      span = it1++;
+    } else {
+      span = it2++;
+    }
+
+    if (!output->empty() && span->left <= output->back().right) {
+      output->back().right = std::max(output->back().right, span->right);
+    } else {
+      output->push_back(*span);
+    }
+  }
+}
+
 void DesktopRegion::IntersectWith(const DesktopRegion& region) {
   DesktopRegion old_region;
   Swap(&old_region);
@@ -286,6 +381,10 @@ void DesktopRegion::Subtract(const DesktopRegion& region) {
   // above |top|.
   Rows::iterator row_a = rows_.upper_bound(top);
 
+  // Spans of the current |row_a| after subtraction. Swapped with the spans of
+  // |row_a|, so its storage is reused from row to row.
+  RowSpanSet new_spans;
+
   // Step through rows of the both regions subtracting content of |row_b| from
   // |row_a|.
   while (row_a != rows_.end() && row_b != region.rows_.end()) {
@@ -333,7 +432,7 @@ void DesktopRegion::Subtract(const DesktopRegion& region) {
 
     // At this point the vertical range covered by |row_a| lays within the
     // range covered by |row_b|. Subtract |row_b| spans from |row_a|.
-    RowSpanSet new_spans;
+    new_spans.clear();
     SubtractRows(row_a->second->spans, row_b->second->spans, &new_spans);
     new_spans.swap(row_a->second->spans);
     top = row_a->second->bottom;
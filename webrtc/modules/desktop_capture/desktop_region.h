@@ -147,6 +147,11 @@ class DesktopRegion {
                             const RowSpanSet& set2,
                             RowSpanSet* output);
 
+  // Calculates the union of two sets of spans.
+  static void UnionRows(const RowSpanSet& set1,
+                        const RowSpanSet& set2,
+                        RowSpanSet* output);
+
   static void SubtractRows(const RowSpanSet& set_a,
                            const RowSpanSet& set_b,
                            RowSpanSet* output);
@@ -310,6 +310,44 @@ TEST(DesktopRegionTest, ComplexRegions) {
   }
 }
 
+// Verify that AddRegion() gives the same region as adding the rectangles of
+// the second region one by one.
+TEST(DesktopRegionTest, AddRegion) {
+  for (int c = 0; c < 200; ++c) {
+    SCOPED_TRACE(c);
+    DesktopRegion r1;
+    DesktopRegion r2;
+    for (int i = 0; i < 10; ++i) {
+      r1.AddRect(DesktopRect::MakeXYWH(
+          RadmonInt(100), RadmonInt(100), 1 + RadmonInt(30),
+          1 + RadmonInt(30)));
+      r2.AddRect(DesktopRect::MakeXYWH(
+          RadmonInt(100), RadmonInt(100), 1 + RadmonInt(30),
+          1 + RadmonInt(30)));
+    }
+
+    DesktopRegion expected(r1);
+    for (DesktopRegion::Iterator it(r2); !it.IsAtEnd(); it.Advance()) {
+      expected.AddRect(it.rect());
+    }
+
+    DesktopRegion r(r1);
+    r.AddRegion(r2);
+    EXPECT_TRUE(r.Equals(expected));
+
+    r = r2;
+    r.AddRegion(r1);
+    EXPECT_TRUE(r.Equals(expected));
+
+    r.AddRegion(DesktopRegion());
+    EXPECT_TRUE(r.Equals(expected));
+
+    r.Clear();
+    r.AddRegion(r1);
+    EXPECT_TRUE(r.Equals(r1));
+  }
+}
+
 TEST(DesktopRegionTest, Equals) {
   struct Region {
     int count;
@@ -707,4 +745,36 @@ TEST(DesktopRegionTest, DISABLED_Performance) {
   }
 }
 
+TEST(DesktopRegionTest, DISABLED_AddRegionPerformance) {
+  // Emulates accumulating the small updated regions of many frames.
+  DesktopRegion r;
+  for (int c = 0; c < 10000; ++c) {
+    DesktopRegion frame_region;
+    for (int i = 0; i < 10; ++i) {
+      frame_region.AddRect(DesktopRect::MakeXYWH(
+          RadmonInt(1000), RadmonInt(1000),
+          5 + RadmonInt(10) * 5, 5 + RadmonInt(10) * 5));
+    }
+    r.AddRegion(frame_region);
+    if (c % 100 == 0)
+      r.Clear();
+  }
+}
+
+TEST(DesktopRegionTest, DISABLED_AddLargeRegionPerformance) {
+  for (int c = 0; c < 1000; ++c) {
+    DesktopRegion r1;
+    DesktopRegion r2;
+    for (int i = 0; i < 200; ++i) {
+      r1.AddRect(DesktopRect::MakeXYWH(
+          RadmonInt(1000), RadmonInt(1000),
+          5 + RadmonInt(10) * 5, 5 + RadmonInt(10) * 5));
+      r2.AddRect(DesktopRect::MakeXYWH(
+          RadmonInt(1000), RadmonInt(1000),
+          5 + RadmonInt(10) * 5, 5 + RadmonInt(10) * 5));
+    }
+    r1.AddRegion(r2);
+  }
+}
+
 }  // namespace webrtc
@@ -12,11 +12,17 @@
 
 #include "string.h"
 
+#include <algorithm>
+
 #include "webrtc/modules/desktop_capture/differ_block.h"
 #include "webrtc/system_wrappers/interface/logging.h"
 
 namespace webrtc {
 
+// Block states while comparing hinted blocks.
+static const DiffInfo kDirtyBlock = 1;
+static const DiffInfo kCleanBlock = 2;
+
 Differ::Differ(int width, int height, int bpp, int stride) {
   // Dimensions of screen.
   width_ = width;
@@ -44,6 +50,14 @@ void Differ::CalcDirtyRegion(const void* prev_buffer, const void* curr_buffer,
   MergeBlocks(region);
 }
 
+void Differ::CalcDirtyRegionWithHints(const void* prev_buffer,
+                                      const void* curr_buffer,
+                                      const DesktopRegion& hints,
+                                      DesktopRegion* region) {
+  MarkHintedDirtyBlocks(prev_buffer, curr_buffer, hints);
+  MergeBlocks(region);
+}
+
 void Differ::MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer) {
   memset(diff_info_.get(), 0, diff_info_size_);
 
@@ -119,6 +133,57 @@ void Differ::MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer) {
   }
 }
 
+void Differ::MarkHintedDirtyBlocks(const void* prev_buffer,
+                                   const void* curr_buffer,
+                                   const DesktopRegion& hints) {
+  memset(diff_info_.get(), 0, diff_info_size_);
+
+  const DesktopRect screen_rect = DesktopRect::MakeWH(width_, height_);
+  for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance()) {
+    DesktopRect rect = it.rect();
+    rect.IntersectWith(screen_rect);
+    if (rect.is_empty())
+      continue;
+
+    int left_block = rect.left() / kBlockSize;
+    int right_block = (rect.right() - 1) / kBlockSize;
+    int top_block = rect.top() / kBlockSize;
+    int bottom_block = (rect.bottom() - 1) / kBlockSize;
+    for (int y = top_block; y <= bottom_block; y++) {
+      // Block rows are a full block high, except for the last one.
+      int block_height = std::min(kBlockSize, height_ - y * kBlockSize);
+      DiffInfo* diff_info = diff_info_.get() + y * diff_info_width_;
+      for (int x = left_block; x <= right_block; x++) {
+        // Adjacent hints may share a block; it is compared only once.
+        if (diff_info[x] != 0)
+          continue;
+        int block_width = std::min(kBlockSize, width_ - x * kBlockSize);
+        int offset = y * kBlockSize * bytes_per_row_ +
+            x * kBlockSize * bytes_per_pixel_;
+        const uint8_t* prev_block =
+            static_cast<const uint8_t*>(prev_buffer) + offset;
+        const uint8_t* curr_block =
+            static_cast<const uint8_t*>(curr_buffer) + offset;
+        DiffInfo diff;
+        if (block_width == kBlockSize && block_height == kBlockSize) {
+          diff = BlockDifference(prev_block, curr_block, bytes_per_row_);
+        } else {
+          diff = DiffPartialBlock(prev_block, curr_block, bytes_per_row_,
+                                  block_width, block_height);
+        }
+        // Unchanged blocks are marked as well, until the merge.
+        diff_info[x] = diff ? kDirtyBlock : kCleanBlock;
+      }
+    }
+  }
+
+  // Only dirty blocks may be left marked for MergeBlocks().
+  for (int i = 0; i < diff_info_size_; i++) {
+    if (diff_info_[i] == kCleanBlock)
+      diff_info_[i] = 0;
+  }
+}
+
 DiffInfo Differ::DiffPartialBlock(const uint8_t* prev_buffer,
                                   const uint8_t* curr_buffer,
                                   int stride, int width, int height) {
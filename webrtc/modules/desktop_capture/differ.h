@@ -43,6 +43,14 @@ class Differ {
   void CalcDirtyRegion(const void* prev_buffer, const void* curr_buffer,
                        DesktopRegion* region);
 
+  // Same as CalcDirtyRegion(), but only compares the blocks that intersect
+  // |hints|, e.g. the damage reported by the OS. The buffers must be
+  // identical outside of |hints|.
+  void CalcDirtyRegionWithHints(const void* prev_buffer,
+                                const void* curr_buffer,
+                                const DesktopRegion& hints,
+                                DesktopRegion* region);
+
  private:
   // Allow tests to access our private parts.
   friend class DifferTest;
@@ -50,6 +58,11 @@ class Differ {
   // Identify all of the blocks that contain changed pixels.
   void MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer);
 
+  // Identify the changed blocks among those that intersect |hints|.
+  void MarkHintedDirtyBlocks(const void* prev_buffer,
+                             const void* curr_buffer,
+                             const DesktopRegion& hints);
+
   // After the dirty blocks have been identified, this routine merges adjacent
   // blocks into a region.
   // The goal is to minimize the region that covers the dirty blocks.
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the cost of finding the changed blocks of 1080p and 2160p desktop
+// frames, with a full scan and with damage hints. Reports the time per frame.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "gflags/gflags.h"
+#include "webrtc/modules/desktop_capture/desktop_region.h"
+#include "webrtc/modules/desktop_capture/differ.h"
+#include "webrtc/modules/desktop_capture/differ_block.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+DEFINE_int32(repetitions, 100, "The number of frames to diff at each size.");
+DEFINE_bool(avx2, true,
+            "Use the AVX2 block differ if the CPU supports it. Disable to "
+            "compare against the SSE2 one.");
+
+namespace webrtc {
+namespace {
+
+struct FrameSize {
+  int width;
+  int height;
+};
+
+const FrameSize kFrameSizes[] = {{1920, 1080}, {3840, 2160}};
+const int kNumFrameSizes = sizeof(kFrameSizes) / sizeof(*kFrameSizes);
+
+// A typing-sized update: a line of text and the caret.
+const int kDamageWidth = 400;
+const int kDamageHeight = 40;
+
+WebRtc_CPUInfo g_cpu_info = NULL;
+
+// Hides AVX2 from the block differ's selection.
+int GetCPUInfoWithoutAVX2(CPUFeature feature) {
+  if (feature == kAVX2)
+    return 0;
+  return g_cpu_info(feature);
+}
+
+// Returns the time per frame in us.
+double BenchmarkDiffer(const FrameSize& size, bool use_hints) {
+  const int stride = size.width * kBytesPerPixel;
+  const int buffer_size = stride * size.height;
+  scoped_ptr<uint8_t[]> prev(new uint8_t[buffer_size]);
+  scoped_ptr<uint8_t[]> curr(new uint8_t[buffer_size]);
+  srand(42);
+  for (int i = 0; i < buffer_size; ++i)
+    prev[i] = static_cast<uint8_t>(rand());
+  memcpy(curr.get(), prev.get(), buffer_size);
+
+  // Change the last row of the damaged rect, the worst case for the blocks
+  // it overlaps.
+  const DesktopRect damage = DesktopRect::MakeXYWH(
+      size.width / 3, size.height / 3, kDamageWidth, kDamageHeight);
+  uint8_t* row = curr.get() + (damage.bottom() - 1) * stride +
+      damage.left() * kBytesPerPixel;
+  for (int i = 0; i < kDamageWidth * kBytesPerPixel; ++i)
+    row[i] ^= 0xff;
+  DesktopRegion hints(damage);
+
+  Differ differ(size.width, size.height, kBytesPerPixel, stride);
+  DesktopRegion dirty;
+  TickTime start = TickTime::Now();
+  for (int r = 0; r < FLAGS_repetitions; ++r) {
+    if (use_hints) {
+      differ.CalcDirtyRegionWithHints(prev.get(), curr.get(), hints, &dirty);
+    } else {
+      differ.CalcDirtyRegion(prev.get(), curr.get(), &dirty);
+    }
+  }
+  int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+  return static_cast<double>(elapsed_us) / FLAGS_repetitions;
+}
+
+void RunBenchmark() {
+  printf("%6s %6s %14s %14s\n", "width", "height", "full_us", "hinted_us");
+  for (int i = 0; i < kNumFrameSizes; ++i) {
+    printf("%6d %6d %14.1f %14.1f\n", kFrameSizes[i].width,
+           kFrameSizes[i].height, BenchmarkDiffer(kFrameSizes[i], false),
+           BenchmarkDiffer(kFrameSizes[i], true));
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string usage = "Benchmarks the desktop frame differ.\n"
+      "Example usage:\n" + std::string(argv[0]) + " --repetitions=1000\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  webrtc::g_cpu_info = WebRtc_GetCPUInfo;
+  if (!FLAGS_avx2)
+    WebRtc_GetCPUInfo = webrtc::GetCPUInfoWithoutAVX2;
+  printf("AVX2 block differ %s.\n",
+         WebRtc_GetCPUInfo(kAVX2) ? "enabled" : "disabled");
+
+  webrtc::RunBenchmark();
+  return 0;
+}
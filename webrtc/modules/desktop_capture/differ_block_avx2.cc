@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/differ_block_avx2.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+#include "webrtc/modules/desktop_capture/differ_block.h"
+
+namespace webrtc {
+
+// Unlike the SSE2 versions, which sum absolute differences, these only need to
+// know whether any byte differs: the rows are XORed together and tested for
+// zero.
+
+extern int BlockDifference_AVX2_W16(const uint8_t* image1,
+                                    const uint8_t* image2,
+                                    int stride) {
+  for (int y = 0; y < kBlockSize; ++y) {
+    const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+    const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+    __m256i diff0 = _mm256_xor_si256(_mm256_loadu_si256(i1),
+                                     _mm256_loadu_si256(i2));
+    __m256i diff1 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 1),
+                                     _mm256_loadu_si256(i2 + 1));
+    __m256i diff = _mm256_or_si256(diff0, diff1);
+    if (!_mm256_testz_si256(diff, diff)) {
+      _mm256_zeroupper();
+      return 1;
+    }
+    image1 += stride;
+    image2 += stride;
+  }
+  _mm256_zeroupper();
+  return 0;
+}
+
+extern int BlockDifference_AVX2_W32(const uint8_t* image1,
+                                    const uint8_t* image2,
+                                    int stride) {
+  for (int y = 0; y < kBlockSize; ++y) {
+    const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+    const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+    __m256i diff0 = _mm256_xor_si256(_mm256_loadu_si256(i1),
+                                     _mm256_loadu_si256(i2));
+    __m256i diff1 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 1),
+                                     _mm256_loadu_si256(i2 + 1));
+    __m256i diff2 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 2),
+                                     _mm256_loadu_si256(i2 + 2));
+    __m256i diff3 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 3),
+                                     _mm256_loadu_si256(i2 + 3));
+    __m256i diff = _mm256_or_si256(_mm256_or_si256(diff0, diff1),
+                                   _mm256_or_si256(diff2, diff3));
+    if (!_mm256_testz_si256(diff, diff)) {
+      _mm256_zeroupper();
+      return 1;
+    }
+    image1 += stride;
+    image2 += stride;
+  }
+  _mm256_zeroupper();
+  return 0;
+}
+
+}  // namespace webrtc
@@ -10,6 +10,9 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "webrtc/modules/desktop_capture/differ_block.h"
+#include "webrtc/modules/desktop_capture/differ_block_avx2.h"
+#include "webrtc/modules/desktop_capture/differ_block_sse2.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/interface/ref_count.h"
 
 namespace webrtc {
@@ -84,4 +87,29 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && !defined(WEBRTC_IOS)
+TEST(BlockDifferenceTestAvx2, MatchesSse2) {
+  if (!WebRtc_GetCPUInfo(kAVX2))
+    return;
+  uint8_t* block1;
+  uint8_t* block2;
+  PrepareBuffers(block1, block2);
+  const int stride = kBlockSize * kBytesPerPixel;
+  EXPECT_EQ(0, BlockDifference_AVX2_W32(block1, block2, stride));
+
+  // A change anywhere in the block is found, in the 16 pixel wide version
+  // only if it is in the left half.
+  for (int i = 0; i < kSizeOfBlock; ++i) {
+    block2[i] += 1;
+    EXPECT_EQ(BlockDifference_SSE2_W32(block1, block2, stride),
+              BlockDifference_AVX2_W32(block1, block2, stride));
+    EXPECT_EQ(BlockDifference_SSE2_W16(block1, block2, stride),
+              BlockDifference_AVX2_W16(block1, block2, stride));
+    EXPECT_EQ(i % stride < stride / 2,
+              BlockDifference_AVX2_W16(block1, block2, stride) == 1);
+    block2[i] -= 1;
+  }
+}
+#endif
+
 }  // namespace webrtc
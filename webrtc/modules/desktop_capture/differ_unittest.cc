@@ -649,4 +649,46 @@ TEST_F(DifferTest, MergeBlocks_MultiRect) {
   ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 1, 2, 1, 1));
 }
 
+TEST_F(DifferTest, Hints_OnlyHintedBlocksAreCompared) {
+  InitDiffer(kScreenWidth, kScreenHeight);
+  WriteBlockPixel(curr_.get(), 0, 0, 1, 1, 0xff00ff);
+  WriteBlockPixel(curr_.get(), 2, 2, 1, 1, 0xff00ff);
+
+  // The hint covers part of block (0,0) and all of block (1,0), but not the
+  // changed block (2,2).
+  DesktopRegion hints(DesktopRect::MakeXYWH(10, 10, kBlockSize * 2 - 10,
+                                            kBlockSize - 10));
+  DesktopRegion dirty;
+  differ_->CalcDirtyRegionWithHints(prev_.get(), curr_.get(), hints, &dirty);
+
+  ASSERT_EQ(1, RegionRectCount(dirty));
+  ASSERT_TRUE(CheckDirtyRegionContainsRect(dirty, 0, 0, 1, 1));
+}
+
+TEST_F(DifferTest, Hints_MatchFullScan) {
+  InitDiffer(kPartialScreenWidth, kPartialScreenHeight);
+  WritePixel(curr_.get(), 5, 5, 0xff00ff);
+  WritePixel(curr_.get(), kPartialScreenWidth - 1, kPartialScreenHeight - 1,
+             0xff00ff);
+  WritePixel(curr_.get(), kPartialScreenWidth - 1, 3, 0xff00ff);
+
+  DesktopRegion full_scan;
+  differ_->CalcDirtyRegion(prev_.get(), curr_.get(), &full_scan);
+
+  // Overlapping, adjacent and out of bounds hints covering the whole screen.
+  DesktopRegion hints;
+  hints.AddRect(DesktopRect::MakeXYWH(0, 0, 40, 40));
+  hints.AddRect(DesktopRect::MakeXYWH(20, 20, 100, 100));
+  hints.AddRect(DesktopRect::MakeXYWH(40, 0, 30, 20));
+  hints.AddRect(DesktopRect::MakeXYWH(0, 40, 20, 30));
+  DesktopRegion dirty;
+  differ_->CalcDirtyRegionWithHints(prev_.get(), curr_.get(), hints, &dirty);
+  EXPECT_TRUE(full_scan.Equals(dirty));
+
+  // Nothing is compared without hints.
+  differ_->CalcDirtyRegionWithHints(prev_.get(), curr_.get(), DesktopRegion(),
+                                    &dirty);
+  EXPECT_TRUE(dirty.is_empty());
+}
+
 }  // namespace webrtc
@@ -26,6 +26,7 @@
 #include "webrtc/modules/desktop_capture/screen_capturer_helper.h"
 #include "webrtc/modules/desktop_capture/x11/x_server_pixel_buffer.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
 
@@ -72,21 +73,23 @@ class ScreenCapturerLinux : public ScreenCapturer,
   void CaptureCursor();
 
   // Capture screen pixels to the current buffer in the queue. In the DAMAGE
-  // case, the ScreenCapturerHelper already holds the list of invalid rectangles
-  // from HandleXEvent(). In the non-DAMAGE case, this captures the
-  // whole screen, then calculates some invalid rectangles that include any
-  // differences between this and the previous capture.
+  // case, only the damaged rectangles are captured, and the rest of the
+  // buffer is brought up to date from the previous one. In the non-DAMAGE
+  // case, this captures the whole screen, then calculates some invalid
+  // rectangles that include any differences between this and the previous
+  // capture.
   DesktopFrame* CaptureScreen();
 
   // Called when the screen configuration is changed.
   void ScreenConfigurationChanged();
 
   // Synchronize the current buffer with |last_buffer_|, by copying pixels from
-  // the area of |last_invalid_rects|.
+  // the area of |last_invalid_rects| which is not in |captured_region|, the
+  // area about to be captured from the screen anyway.
   // Note this only works on the assumption that kNumBuffers == 2, as
   // |last_invalid_rects| holds the differences from the previous buffer and
   // the one prior to that (which will then be the current buffer).
-  void SynchronizeFrame();
+  void SynchronizeFrame(const DesktopRegion& captured_region);
 
   void DeinitXlib();
 
@@ -125,7 +128,8 @@ class ScreenCapturerLinux : public ScreenCapturer,
   // current with the last buffer used.
   DesktopRegion last_invalid_region_;
 
-  // |Differ| for use when polling for changes.
+  // |Differ| for use when polling for changes, and to narrow down the XDamage
+  // region.
   scoped_ptr<Differ> differ_;
 
   DISALLOW_COPY_AND_ASSIGN(ScreenCapturerLinux);
@@ -260,7 +264,7 @@ void ScreenCapturerLinux::Start(Callback* callback) {
 }
 
 void ScreenCapturerLinux::Capture(const DesktopRegion& region) {
-  TickTime capture_start_time = TickTime::Now();
+  const int64_t start_us = TickTime::MicrosecondTimestamp();
 
   queue_.MoveToNextFrame();
 
@@ -287,11 +291,10 @@ void ScreenCapturerLinux::Capture(const DesktopRegion& region) {
 
   // Refresh the Differ helper used by CaptureFrame(), if needed.
   DesktopFrame* frame = queue_.current_frame();
-  if (!use_damage_ && (
-      !differ_.get() ||
+  if (!differ_.get() ||
       (differ_->width() != frame->size().width()) ||
       (differ_->height() != frame->size().height()) ||
-      (differ_->bytes_per_row() != frame->stride()))) {
+      (differ_->bytes_per_row() != frame->stride())) {
     differ_.reset(new Differ(frame->size().width(), frame->size().height(),
                              DesktopFrame::kBytesPerPixel,
                              frame->stride()));
@@ -299,8 +302,12 @@ void ScreenCapturerLinux::Capture(const DesktopRegion& region) {
 
   DesktopFrame* result = CaptureScreen();
   last_invalid_region_ = result->updated_region();
+  const int64_t capture_time_us =
+      TickTime::MicrosecondTimestamp() - start_us;
   result->set_capture_time_ms(
-      (TickTime::Now() - capture_start_time).Milliseconds());
+      static_cast<int32_t>(capture_time_us / 1000));
+  WEBRTC_HISTOGRAM_ADD("WebRTC.DesktopCapture.CaptureTimeUs",
+                       static_cast<int>(capture_time_us));
   callback_->OnCaptureCompleted(result);
 }
 
@@ -389,13 +396,6 @@ DesktopFrame* ScreenCapturerLinux::CaptureScreen() {
   // expands that region to a grid.
   helper_.set_size_most_recent(frame->size());
 
-  // In the DAMAGE case, ensure the frame is up-to-date with the previous frame
-  // if any.  If there isn't a previous frame, that means a screen-resolution
-  // change occurred, and |invalid_rects| will be updated to include the whole
-  // screen.
-  if (use_damage_ && queue_.previous_frame())
-    SynchronizeFrame();
-
   DesktopRegion* updated_region = frame->mutable_updated_region();
 
   x_server_pixel_buffer_.Synchronize();
@@ -412,8 +412,6 @@ DesktopFrame* ScreenCapturerLinux::CaptureScreen() {
     }
     XFree(rects);
     helper_.InvalidateRegion(*updated_region);
-
-    // Capture the damaged portions of the desktop.
     helper_.TakeInvalidRegion(updated_region);
 
     // Clip the damaged portions to the current screen size, just in case some
@@ -422,10 +420,24 @@ DesktopFrame* ScreenCapturerLinux::CaptureScreen() {
     updated_region->IntersectWith(
         DesktopRect::MakeSize(x_server_pixel_buffer_.window_size()));
 
+    // Ensure the frame is up-to-date with the previous frame outside of the
+    // damage.
+    SynchronizeFrame(*updated_region);
+
+    // Capture the damaged portions of the desktop.
     for (DesktopRegion::Iterator it(*updated_region);
          !it.IsAtEnd(); it.Advance()) {
       x_server_pixel_buffer_.CaptureRect(it.rect(), frame);
     }
+
+    // XDamage often reports more than what changed, e.g. a whole window for
+    // a blinking caret. The frame matches the previous one outside of the
+    // damage, so only the damaged blocks need to be compared.
+    DCHECK(differ_.get() != NULL);
+    DesktopRegion damage_hints(*updated_region);
+    differ_->CalcDirtyRegionWithHints(queue_.previous_frame()->data(),
+                                      frame->data(), damage_hints,
+                                      updated_region);
   } else {
     // Doing full-screen polling, or this is the first capture after a
     // screen-resolution change.  In either case, need a full-screen capture.
@@ -462,21 +474,20 @@ void ScreenCapturerLinux::ScreenConfigurationChanged() {
   }
 }
 
-void ScreenCapturerLinux::SynchronizeFrame() {
+void ScreenCapturerLinux::SynchronizeFrame(
+    const DesktopRegion& captured_region) {
   // Synchronize the current buffer with the previous one since we do not
   // capture the entire desktop. Note that encoder may be reading from the
   // previous buffer at this time so thread access complaints are false
   // positives.
-
-  // TODO(hclam): We can reduce the amount of copying here by subtracting
-  // |capturer_helper_|s region from |last_invalid_region_|.
-  // http://crbug.com/92354
   DCHECK(queue_.previous_frame());
 
   DesktopFrame* current = queue_.current_frame();
   DesktopFrame* last = queue_.previous_frame();
   DCHECK(current != last);
-  for (DesktopRegion::Iterator it(last_invalid_region_);
+  DesktopRegion stale_region(last_invalid_region_);
+  stale_region.Subtract(captured_region);
+  for (DesktopRegion::Iterator it(stale_region);
        !it.IsAtEnd(); it.Advance()) {
     current->CopyPixelsFrom(*last, it.rect().top_left(), it.rect());
   }
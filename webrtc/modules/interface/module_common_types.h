@@ -671,7 +671,12 @@ class AudioFrame {
 
   AudioFrame& Append(const AudioFrame& rhs);
 
+  // Copies only the first |samples_per_channel_| * |num_channels_| samples of
+  // |src.data_|, the rest of |data_| is left as is.
   void CopyFrom(const AudioFrame& src);
+  // Copies all members but |data_|, for a frame whose samples are about to be
+  // written anyway.
+  void CopyHeaderFrom(const AudioFrame& src);
 
   void Mute();
 
@@ -753,6 +758,13 @@ inline void AudioFrame::UpdateFrame(int id, uint32_t timestamp,
 inline void AudioFrame::CopyFrom(const AudioFrame& src) {
   if (this == &src) return;
 
+  CopyHeaderFrom(src);
+  const int length = samples_per_channel_ * num_channels_;
+  assert(length <= kMaxDataSizeSamples && length >= 0);
+  memcpy(data_, src.data_, sizeof(int16_t) * length);
+}
+
+inline void AudioFrame::CopyHeaderFrom(const AudioFrame& src) {
   id_ = src.id_;
   timestamp_ = src.timestamp_;
   elapsed_time_ms_ = src.elapsed_time_ms_;
@@ -764,10 +776,6 @@ inline void AudioFrame::CopyFrom(const AudioFrame& src) {
   num_channels_ = src.num_channels_;
   energy_ = src.energy_;
   interleaved_ = src.interleaved_;
-
-  const int length = samples_per_channel_ * num_channels_;
-  assert(length <= kMaxDataSizeSamples && length >= 0);
-  memcpy(data_, src.data_, sizeof(int16_t) * length);
 }
 
 inline void AudioFrame::Mute() {
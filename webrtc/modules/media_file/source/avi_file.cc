@@ -49,6 +49,10 @@ static const uint32_t kAvifIsinterleaved  = 0x00000100;
 static const uint32_t kAvifTrustcktype    = 0x00000800;
 static const uint32_t kAvifWascapturefile = 0x00010000;
 
+// Size of the stdio buffer used when writing, large enough to hold a few
+// video frames so that most chunks don't cause a write to disk.
+static const size_t kWriteBufferSize = 64 * 1024;
+
 template <class T>
 T MinValue(T a, T b)
 {
@@ -177,7 +181,8 @@ AviFile::AviFile()
       _videoCodecConfigParamsLength(0),
       _videoStreamDataChunkPrefix(0),
       _audioStreamDataChunkPrefix(0),
-      _created(false)
+      _created(false),
+      _writeBuffer(NULL)
 {
   ResetComplexMembers();
 }
@@ -187,6 +192,7 @@ AviFile::~AviFile()
     Close();
 
     delete[] _videoCodecConfigParams;
+    delete[] _writeBuffer;
     delete _crit;
 }
 
@@ -363,8 +369,6 @@ int32_t AviFile::GetAudioStreamInfo(WAVEFORMATEX& waveHeader)
 int32_t AviFile::WriteAudio(const uint8_t* data, int32_t length)
 {
     _crit->Enter();
-    size_t newBytesWritten = _bytesWritten;
-
     if (_aviMode != Write)
     {
         _crit->Leave();
@@ -381,31 +385,9 @@ int32_t AviFile::WriteAudio(const uint8_t* data, int32_t length)
         return -1;
     }
 
-    // Start of chunk.
-    const uint32_t chunkOffset = ftell(_aviFile) - _moviListOffset;
-    _bytesWritten += PutLE32(_audioStreamDataChunkPrefix);
-    // Size is unknown at this point. Update later.
-    _bytesWritten += PutLE32(0);
-    const size_t chunkSizeMark = _bytesWritten;
-
-    _bytesWritten += PutBuffer(data, length);
-
-    const long chunkSize = PutLE32LengthFromCurrent(
-        static_cast<long>(chunkSizeMark));
-
-    // Make sure that the chunk is aligned on 2 bytes (= 1 sample).
-    if (chunkSize % 2)
-    {
-        _bytesWritten += PutByte(0);
-    }
-    // End of chunk
-
-    // Save chunk information for use when closing file.
-    AddChunkToIndexList(_audioStreamDataChunkPrefix, 0, // No flags.
-                        chunkOffset, chunkSize);
-
+    const size_t newBytesWritten = WriteMoviChunk(_audioStreamDataChunkPrefix,
+                                                  data, length);
     ++_audioFrames;
-    newBytesWritten = _bytesWritten - newBytesWritten;
     _crit->Leave();
     return static_cast<int32_t>(newBytesWritten);
 }
@@ -413,7 +395,6 @@ int32_t AviFile::WriteAudio(const uint8_t* data, int32_t length)
 int32_t AviFile::WriteVideo(const uint8_t* data, int32_t length)
 {
     _crit->Enter();
-    size_t newBytesWritten = _bytesWritten;
     if (_aviMode != Write)
     {
         _crit->Leave();
@@ -430,32 +411,37 @@ int32_t AviFile::WriteVideo(const uint8_t* data, int32_t length)
         return -1;
     }
 
-    // Start of chunk.
-    const uint32_t chunkOffset = ftell(_aviFile) - _moviListOffset;
-    _bytesWritten += PutLE32(_videoStreamDataChunkPrefix);
-    // Size is unknown at this point. Update later.
-    _bytesWritten += PutLE32(0);
-    const size_t chunkSizeMark = _bytesWritten;
+    const size_t newBytesWritten = WriteMoviChunk(_videoStreamDataChunkPrefix,
+                                                  data, length);
+    ++_videoFrames;
+    _crit->Leave();
+    return static_cast<int32_t>(newBytesWritten);
+}
 
-    _bytesWritten += PutBuffer(data, length);
+size_t AviFile::WriteMoviChunk(uint32_t chunkId, const uint8_t* data,
+                               int32_t length)
+{
+    const size_t startBytesWritten = _bytesWritten;
 
-    const long chunkSize = PutLE32LengthFromCurrent(
-        static_cast<long>(chunkSizeMark));
+    // Start of chunk. The size is known up front, so the chunk is written
+    // front to back without seeking, which would flush the write buffer.
+    const uint32_t chunkOffset = ftell(_aviFile) - _moviListOffset;
+    _bytesWritten += PutLE32(chunkId);
+    _bytesWritten += PutLE32(static_cast<uint32_t>(length));
+    _bytesWritten += PutBuffer(data, length);
 
     // Make sure that the chunk is aligned on 2 bytes (= 1 sample).
-    if (chunkSize % 2)
+    if (length % 2)
     {
         //Pad one byte, to WORD align.
         _bytesWritten += PutByte(0);
     }
-     //End chunk!
-    AddChunkToIndexList(_videoStreamDataChunkPrefix, 0, // No flags.
-                        chunkOffset, static_cast<uint32_t>(chunkSize));
+    // End of chunk.
 
-    ++_videoFrames;
-    newBytesWritten = _bytesWritten - newBytesWritten;
-    _crit->Leave();
-    return static_cast<int32_t>(newBytesWritten);
+    // Save chunk information for use when closing file.
+    AddChunkToIndexList(chunkId, 0, // No flags.
+                        chunkOffset, static_cast<uint32_t>(length));
+    return _bytesWritten - startBytesWritten;
 }
 
 int32_t AviFile::PrepareDataChunkHeaders()
@@ -687,6 +673,12 @@ int32_t AviFile::Create(const char* fileName)
     }
 #endif
 
+    if (!_writeBuffer)
+    {
+        _writeBuffer = new char[kWriteBufferSize];
+    }
+    setvbuf(_aviFile, _writeBuffer, _IOFBF, kWriteBufferSize);
+
     WriteRIFF();
     WriteHeaders();
 
@@ -1709,10 +1701,6 @@ uint32_t AviFile::StreamAndTwoCharCodeToTag(int32_t streamNum,
 
 void AviFile::ClearIndexList()
 {
-  for (IndexList::iterator iter = _indexList.begin();
-       iter != _indexList.end(); ++iter) {
-      delete *iter;
-  }
   _indexList.clear();
 }
 
@@ -1721,8 +1709,8 @@ void AviFile::AddChunkToIndexList(uint32_t inChunkId,
                                   uint32_t inOffset,
                                   uint32_t inSize)
 {
-    _indexList.push_back(new AVIINDEXENTRY(inChunkId, inFlags, inOffset,
-                                           inSize));
+    _indexList.push_back(AVIINDEXENTRY(inChunkId, inFlags, inOffset,
+                                       inSize));
 }
 
 void AviFile::WriteIndex()
@@ -1734,9 +1722,9 @@ void AviFile::WriteIndex()
     _bytesWritten += PutLE32(0);
     const size_t idxChunkSize = _bytesWritten;
 
-    for (IndexList::iterator iter = _indexList.begin();
+    for (IndexList::const_iterator iter = _indexList.begin();
          iter != _indexList.end(); ++iter) {
-        const AVIINDEXENTRY* item = *iter;
+        const AVIINDEXENTRY* item = &(*iter);
         _bytesWritten += PutLE32(item->ckid);
         _bytesWritten += PutLE32(item->dwFlags);
         _bytesWritten += PutLE32(item->dwChunkOffset);
@@ -14,7 +14,7 @@
 #define WEBRTC_MODULES_MEDIA_FILE_SOURCE_AVI_FILE_H_
 
 #include <stdio.h>
-#include <list>
+#include <vector>
 
 #include "webrtc/typedefs.h"
 
@@ -145,6 +145,11 @@ private:
 
     int32_t PrepareDataChunkHeaders();
 
+    // Writes a movi list chunk with |length| bytes of |data| and adds it to
+    // the index. Returns the number of bytes written.
+    size_t WriteMoviChunk(uint32_t chunkId, const uint8_t* data,
+                          int32_t length);
+
     int32_t ReadMoviSubChunk(uint8_t* data, int32_t& length, uint32_t tag1,
                              uint32_t tag2 = 0);
 
@@ -194,7 +199,7 @@ private:
     void WriteIndex();
 
 private:
-    typedef std::list<AVIINDEXENTRY*> IndexList;
+    typedef std::vector<AVIINDEXENTRY> IndexList;
     struct AVIMAINHEADER
     {
         AVIMAINHEADER();
@@ -269,6 +274,8 @@ private:
     uint32_t _videoStreamDataChunkPrefix;
     uint32_t _audioStreamDataChunkPrefix;
     bool _created;
+    // stdio buffer of |_aviFile| when writing.
+    char* _writeBuffer;
 
     IndexList _indexList;
 };
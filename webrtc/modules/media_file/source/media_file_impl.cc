@@ -894,7 +894,7 @@ int32_t MediaFileImpl::StartRecordingFile(
         return -1;
     }
 
-    FileWrapper* outputStream = FileWrapper::Create();
+    FileWrapper* outputStream = FileWrapper::CreateAsync();
     if(outputStream == NULL)
     {
         WEBRTC_TRACE(kTraceMemory, kTraceFile, _id,
@@ -44,6 +44,7 @@
         'audio_coding/codecs/isac/isacfix_test.gypi',
         'audio_coding/codecs/tools/audio_codec_speed_tests.gypi',
         'audio_processing/audio_processing_tests.gypi',
+        'rtp_rtcp/test/benchmark/rtp_rtcp_benchmarks.gypi',
         'rtp_rtcp/test/testFec/test_fec.gypi',
         'video_coding/main/source/video_coding_test.gypi',
         'video_coding/codecs/test/video_codecs_test_framework.gypi',
@@ -70,6 +71,7 @@
           'dependencies': [
             'acm_receive_test',
             'audio_coding_module',
+            'audio_conference_mixer',
             'audio_processing',
             'bitrate_controller',
             'CNG',
@@ -86,6 +88,7 @@
             'test_framework',
             'video_codecs_test_framework',
             'video_processing',
+            'video_render_module',
             'webrtc_utility',
             'webrtc_video_coding',
             '<@(neteq_dependencies)',
@@ -106,6 +109,7 @@
             'audio_coding/main/acm2/call_statistics_unittest.cc',
             'audio_coding/main/acm2/initial_delay_manager_unittest.cc',
             'audio_coding/main/acm2/nack_unittest.cc',
+            'audio_coding/main/acm2/opus_complexity_controller_unittest.cc',
             'audio_coding/codecs/cng/cng_unittest.cc',
             'audio_coding/codecs/isac/fix/source/filters_unittest.cc',
             'audio_coding/codecs/isac/fix/source/filterbanks_unittest.cc',
@@ -152,9 +156,16 @@
             'audio_coding/neteq/mock/mock_packet_buffer.h',
             'audio_coding/neteq/mock/mock_payload_splitter.h',
             'audio_coding/neteq/tools/packet_unittest.cc',
+            'audio_conference_mixer/source/audio_conference_mixer_unittest.cc',
             'audio_processing/aec/system_delay_unittest.cc',
             'audio_processing/aec/echo_cancellation_unittest.cc',
+            'audio_processing/aecm/echo_control_mobile_unittest.cc',
+            'audio_processing/agc/gain_control_unittest.cc',
+            'audio_processing/audio_frame_queue_unittest.cc',
+            'audio_processing/audio_processing_batch_unittest.cc',
             'audio_processing/echo_cancellation_impl_unittest.cc',
+            'audio_processing/splitting_filter_unittest.cc',
+            'audio_processing/three_band_filter_bank_unittest.cc',
             'audio_processing/utility/delay_estimator_unittest.cc',
             'audio_processing/utility/ring_buffer_unittest.cc',
             'bitrate_controller/bitrate_controller_unittest.cc',
@@ -173,10 +184,12 @@
             'desktop_capture/win/cursor_unittest_resources.rc',
             'media_file/source/media_file_unittest.cc',
             'module_common_types_unittest.cc',
+            'pacing/bitrate_prober_unittest.cc',
             'pacing/paced_sender_unittest.cc',
             'remote_bitrate_estimator/bwe_simulations.cc',
             'remote_bitrate_estimator/include/mock/mock_remote_bitrate_observer.h',
             'remote_bitrate_estimator/rate_statistics_unittest.cc',
+            'remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time_unittest.cc',
             'remote_bitrate_estimator/remote_bitrate_estimator_single_stream_unittest.cc',
             'remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.cc',
             'remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.h',
@@ -192,12 +205,15 @@
             'remote_bitrate_estimator/test/bwe_test_logging.h',
             'remote_bitrate_estimator/test/bwe_test.cc',
             'remote_bitrate_estimator/test/bwe_test.h',
+            'remote_bitrate_estimator/transport_feedback_adapter_unittest.cc',
             'rtp_rtcp/source/mock/mock_rtp_payload_strategy.h',
             'rtp_rtcp/source/byte_io_unittest.cc',
             'rtp_rtcp/source/fec_receiver_unittest.cc',
             'rtp_rtcp/source/fec_test_helper.cc',
             'rtp_rtcp/source/fec_test_helper.h',
+            'rtp_rtcp/source/fec_xor_unittest.cc',
             'rtp_rtcp/source/nack_rtx_unittest.cc',
+            'rtp_rtcp/source/nack_send_history_unittest.cc',
             'rtp_rtcp/source/producer_fec_unittest.cc',
             'rtp_rtcp/source/receive_statistics_unittest.cc',
             'rtp_rtcp/source/remote_ntp_time_estimator_unittest.cc',
@@ -216,6 +232,7 @@
             'rtp_rtcp/source/rtp_utility_unittest.cc',
             'rtp_rtcp/source/rtp_header_extension_unittest.cc',
             'rtp_rtcp/source/rtp_sender_unittest.cc',
+            'rtp_rtcp/source/tmmbr_help_unittest.cc',
             'rtp_rtcp/source/vp8_partition_aggregator_unittest.cc',
             'rtp_rtcp/test/testAPI/test_api.cc',
             'rtp_rtcp/test/testAPI/test_api.h',
@@ -223,16 +240,22 @@
             'rtp_rtcp/test/testAPI/test_api_rtcp.cc',
             'rtp_rtcp/test/testAPI/test_api_video.cc',
             'utility/source/audio_frame_operations_unittest.cc',
+            'utility/source/process_thread_impl_unittest.cc',
             'utility/source/file_player_unittests.cc',
             'video_coding/codecs/test/packet_manipulator_unittest.cc',
             'video_coding/codecs/test/stats_unittest.cc',
             'video_coding/codecs/test/videoprocessor_unittest.cc',
+            'video_coding/codecs/vp8/cpu_speed_controller_unittest.cc',
             'video_coding/codecs/vp8/default_temporal_layers_unittest.cc',
             'video_coding/codecs/vp8/reference_picture_selection_unittest.cc',
+            'video_coding/codecs/vp8/simulcast_encoder_unittest.cc',
             'video_coding/main/interface/mock/mock_vcm_callbacks.h',
             'video_coding/main/source/decoding_state_unittest.cc',
+            'video_coding/main/source/encoded_buffer_pool_unittest.cc',
             'video_coding/main/source/jitter_buffer_unittest.cc',
+            'video_coding/main/source/media_opt_util_unittest.cc',
             'video_coding/main/source/media_optimization_unittest.cc',
+            'video_coding/main/source/missing_sequence_numbers_unittest.cc',
             'video_coding/main/source/receiver_unittest.cc',
             'video_coding/main/source/session_info_unittest.cc',
             'video_coding/main/source/timing_unittest.cc',
@@ -252,6 +275,8 @@
             'video_processing/main/test/unit_test/deflickering_test.cc',
             'video_processing/main/test/unit_test/video_processing_unittest.cc',
             'video_processing/main/test/unit_test/video_processing_unittest.h',
+            'video_render/render_frame_queue_unittest.cc',
+            'video_render/video_render_scheduler_unittest.cc',
           ],
           'conditions': [
             ['enable_bwe_test_logging==1', {
@@ -277,6 +302,9 @@
             }],
             ['prefer_fixed_point==1', {
               'defines': [ 'WEBRTC_AUDIOPROC_FIXED_PROFILE' ],
+              'sources': [
+                'audio_processing/ns/noise_suppression_x_unittest.cc',
+              ],
             }, {
               'defines': [ 'WEBRTC_AUDIOPROC_FLOAT_PROFILE' ],
             }],
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/pacing/bitrate_prober.h"
+
+#include <assert.h>
+
+#include <algorithm>
+
+#include "webrtc/system_wrappers/interface/logging.h"
+
+namespace webrtc {
+namespace {
+// The initial clusters are sent at these multiples of the start bitrate.
+const int kProbeBitrateMultipliers[] = {3, 6};
+const int kPacketsPerProbe = 5;
+// The spacing can't be finer than the resolution of the clock.
+const int kMinProbeDeltaMs = 1;
+// A packet sent this much later than scheduled breaks the spacing, and the
+// cluster is started over.
+const int kMaxProbeDelayMs = 3;
+// A cluster which can't be sent within this many attempts is dropped.
+const int kMaxProbeAttempts = 3;
+
+int ComputeDeltaFromBitrate(int packet_size, int bitrate_bps) {
+  assert(bitrate_bps > 0);
+  return static_cast<int>(packet_size * 8 * 1000LL / bitrate_bps);
+}
+}  // namespace
+
+BitrateProber::BitrateProber()
+    : enabled_(false),
+      initialized_(false),
+      packet_size_last_send_(0),
+      time_last_send_ms_(-1) {}
+
+void BitrateProber::SetEnabled(bool enable) {
+  enabled_ = enable;
+  if (!enabled_)
+    clusters_.clear();
+}
+
+bool BitrateProber::IsProbing() const {
+  return enabled_ && !clusters_.empty();
+}
+
+void BitrateProber::MaybeInitializeProbe(int bitrate_bps) {
+  if (!enabled_ || initialized_ || bitrate_bps <= 0)
+    return;
+  initialized_ = true;
+  for (size_t i = 0; i < sizeof(kProbeBitrateMultipliers) /
+                             sizeof(kProbeBitrateMultipliers[0]); ++i) {
+    CreateProbeCluster(kProbeBitrateMultipliers[i] * bitrate_bps,
+                       kPacketsPerProbe);
+  }
+}
+
+void BitrateProber::CreateProbeCluster(int bitrate_bps, int num_packets) {
+  if (!enabled_ || bitrate_bps <= 0 || num_packets <= 0)
+    return;
+  LOG(LS_INFO) << "Probe cluster of " << num_packets << " packets at "
+               << bitrate_bps << " bps";
+  clusters_.push_back(ProbeCluster(bitrate_bps, num_packets));
+}
+
+int BitrateProber::TimeUntilNextProbe(int64_t now_ms) {
+  if (!IsProbing())
+    return -1;
+  ProbeCluster& cluster = clusters_.front();
+  // The first packet of a cluster only marks its start, and can be sent right
+  // away.
+  if (cluster.packets_sent == 0 || time_last_send_ms_ < 0)
+    return 0;
+  const int delta_ms = std::max(
+      kMinProbeDeltaMs,
+      ComputeDeltaFromBitrate(packet_size_last_send_, cluster.bitrate_bps));
+  const int64_t time_until_probe_ms = time_last_send_ms_ + delta_ms - now_ms;
+  if (time_until_probe_ms < -kMaxProbeDelayMs) {
+    // There was nothing to send in time, so the packets sent so far can't be
+    // used by the receiver.
+    if (++cluster.attempts >= kMaxProbeAttempts) {
+      LOG(LS_INFO) << "Dropping probe cluster at " << cluster.bitrate_bps
+                   << " bps";
+      clusters_.pop_front();
+      return IsProbing() ? 0 : -1;
+    }
+    cluster.packets_sent = 0;
+    return 0;
+  }
+  return static_cast<int>(std::max<int64_t>(time_until_probe_ms, 0));
+}
+
+void BitrateProber::PacketSent(int64_t now_ms, int packet_size) {
+  packet_size_last_send_ = packet_size;
+  time_last_send_ms_ = now_ms;
+  if (!IsProbing())
+    return;
+  ProbeCluster& cluster = clusters_.front();
+  if (++cluster.packets_sent >= cluster.num_packets)
+    clusters_.pop_front();
+}
+}  // namespace webrtc
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_PACING_BITRATE_PROBER_H_
+#define WEBRTC_MODULES_PACING_BITRATE_PROBER_H_
+
+#include <deque>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Schedules clusters of packets sent with a fixed spacing, so that the
+// receiver can measure the capacity of the path from how the spacing changes
+// on the way. At call start a few clusters are sent at multiples of the start
+// bitrate, which lets the receive-side estimate reach the link capacity
+// without waiting for the rate control to ramp up.
+class BitrateProber {
+ public:
+  BitrateProber();
+
+  // Probing is only allowed while enabled. Disabling drops any clusters that
+  // haven't been sent yet.
+  void SetEnabled(bool enable);
+
+  // Returns true if there are clusters left to send.
+  bool IsProbing() const;
+
+  // Creates the initial clusters at multiples of |bitrate_bps|, unless probing
+  // is disabled or this has been done before.
+  void MaybeInitializeProbe(int bitrate_bps);
+
+  // Adds a cluster of |num_packets| packets to be sent at |bitrate_bps|, after
+  // any clusters already queued.
+  void CreateProbeCluster(int bitrate_bps, int num_packets);
+
+  // Returns the number of milliseconds until the next packet of the current
+  // cluster should be sent, or -1 if not probing.
+  int TimeUntilNextProbe(int64_t now_ms);
+
+  // Called when a packet of |packet_size| bytes has been sent at |now_ms|.
+  void PacketSent(int64_t now_ms, int packet_size);
+
+ private:
+  struct ProbeCluster {
+    ProbeCluster(int bitrate_bps, int num_packets)
+        : bitrate_bps(bitrate_bps),
+          num_packets(num_packets),
+          packets_sent(0),
+          attempts(0) {}
+    int bitrate_bps;
+    int num_packets;
+    int packets_sent;
+    // The number of times the cluster was restarted because a packet couldn't
+    // be sent in time.
+    int attempts;
+  };
+
+  bool enabled_;
+  // True once the initial clusters have been created.
+  bool initialized_;
+  std::deque<ProbeCluster> clusters_;
+  int packet_size_last_send_;
+  int64_t time_last_send_ms_;
+};
+}  // namespace webrtc
+#endif  // WEBRTC_MODULES_PACING_BITRATE_PROBER_H_
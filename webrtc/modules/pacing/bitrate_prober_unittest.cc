@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/pacing/bitrate_prober.h"
+
+namespace webrtc {
+
+TEST(BitrateProberTest, VerifyStatesAndTimeBetweenProbes) {
+  BitrateProber prober;
+  EXPECT_FALSE(prober.IsProbing());
+  int64_t now_ms = 0;
+  EXPECT_EQ(-1, prober.TimeUntilNextProbe(now_ms));
+
+  prober.MaybeInitializeProbe(300000);
+  EXPECT_FALSE(prober.IsProbing());
+
+  prober.SetEnabled(true);
+  prober.MaybeInitializeProbe(300000);
+  EXPECT_TRUE(prober.IsProbing());
+  EXPECT_EQ(0, prober.TimeUntilNextProbe(now_ms));
+
+  // First cluster at 900 kbps: 1000 bytes every 8 ms.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(0, prober.TimeUntilNextProbe(now_ms));
+    prober.PacketSent(now_ms, 1000);
+    if (i < 4) {
+      EXPECT_EQ(8, prober.TimeUntilNextProbe(now_ms));
+    }
+    now_ms += 8;
+  }
+  // Second cluster at 1800 kbps: 1000 bytes every 4 ms, starting right away.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(0, prober.TimeUntilNextProbe(now_ms));
+    prober.PacketSent(now_ms, 1000);
+    now_ms += 4;
+  }
+  EXPECT_FALSE(prober.IsProbing());
+  EXPECT_EQ(-1, prober.TimeUntilNextProbe(now_ms));
+
+  // The initial clusters are only sent once.
+  prober.MaybeInitializeProbe(300000);
+  EXPECT_FALSE(prober.IsProbing());
+}
+
+TEST(BitrateProberTest, RestartsLateClusterAndGivesUp) {
+  BitrateProber prober;
+  prober.SetEnabled(true);
+  prober.CreateProbeCluster(800000, 3);
+  int64_t now_ms = 0;
+  for (int attempt = 0; attempt < 3; ++attempt) {
+    EXPECT_EQ(0, prober.TimeUntilNextProbe(now_ms));
+    prober.PacketSent(now_ms, 1000);
+    EXPECT_EQ(10, prober.TimeUntilNextProbe(now_ms));
+    // Nothing is sent in time.
+    now_ms += 20;
+  }
+  // Restarted twice, then dropped.
+  EXPECT_EQ(-1, prober.TimeUntilNextProbe(now_ms));
+  EXPECT_FALSE(prober.IsProbing());
+}
+
+TEST(BitrateProberTest, DisablingDropsClusters) {
+  BitrateProber prober;
+  prober.SetEnabled(true);
+  prober.CreateProbeCluster(800000, 5);
+  EXPECT_TRUE(prober.IsProbing());
+  prober.SetEnabled(false);
+  EXPECT_FALSE(prober.IsProbing());
+  EXPECT_EQ(-1, prober.TimeUntilNextProbe(0));
+}
+}  // namespace webrtc
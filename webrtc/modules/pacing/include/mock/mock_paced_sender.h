@@ -31,6 +31,7 @@ class MockPacedSender : public PacedSender {
                                 bool retransmission));
   MOCK_CONST_METHOD0(QueueInMs, int());
   MOCK_CONST_METHOD0(QueueInPackets, int());
+  MOCK_CONST_METHOD1(QueueDelayPercentileMs, int(int percentile));
 };
 
 }  // namespace webrtc
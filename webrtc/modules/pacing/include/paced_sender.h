@@ -11,22 +11,21 @@
 #ifndef WEBRTC_MODULES_PACED_SENDER_H_
 #define WEBRTC_MODULES_PACED_SENDER_H_
 
-#include <list>
-#include <set>
-
 #include "webrtc/modules/interface/module.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
 #include "webrtc/system_wrappers/interface/thread_annotations.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
+class BitrateProber;
 class Clock;
 class CriticalSectionWrapper;
 
 namespace paced_sender {
 class IntervalBudget;
 struct Packet;
-class PacketList;
+class PacketQueue;
+class QueueDelayStats;
 }  // namespace paced_sender
 
 class PacedSender : public Module {
@@ -77,6 +76,11 @@ class PacedSender : public Module {
 
   bool Enabled() const;
 
+  // Enable/disable probing. When enabled, the first packets are sent in
+  // clusters at multiples of the pacing bitrate, for the receiver to measure
+  // the capacity of the path. Disabled by default.
+  void SetProbingEnabled(bool enabled);
+
   // Temporarily pause all sending.
   void Pause();
 
@@ -103,6 +107,11 @@ class PacedSender : public Module {
   // Returns the time since the oldest queued packet was enqueued.
   virtual int QueueInMs() const;
 
+  // Returns the |percentile| (0-100) of the time packets recently sent by the
+  // pacer spent in the queue, in milliseconds. Returns 0 if no packet has been
+  // sent from the queue yet.
+  virtual int QueueDelayPercentileMs(int percentile) const;
+
   // Returns the number of milliseconds until the module want a worker thread
   // to call Process.
   virtual int32_t TimeUntilNextProcess() OVERRIDE;
@@ -111,17 +120,17 @@ class PacedSender : public Module {
   virtual int32_t Process() OVERRIDE;
 
  private:
-  // Return true if next packet in line should be transmitted.
-  // Return packet list that contains the next packet.
-  bool ShouldSendNextPacket(paced_sender::PacketList** packet_list)
+  // Return true if a queued packet should be transmitted, and set |packet| to
+  // it. This is the head of the queue unless the queue is too long.
+  bool ShouldSendNextPacket(const paced_sender::Packet** packet)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
-  // Local helper function to GetNextPacket.
-  paced_sender::Packet GetNextPacketFromList(paced_sender::PacketList* packets)
+  // Sends |packet|, which is in the queue. Returns false if the callback
+  // failed to send it, in which case the packet is kept in the queue.
+  bool SendNextPacket(const paced_sender::Packet& packet)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
-  bool SendPacketFromList(paced_sender::PacketList* packet_list)
-      EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  int QueueInMsInternal() const EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   // Updates the number of bytes that can be sent for the next time interval.
   void UpdateBytesPerInterval(uint32_t delta_time_in_ms)
@@ -146,16 +155,16 @@ class PacedSender : public Module {
   scoped_ptr<paced_sender::IntervalBudget> padding_budget_
       GUARDED_BY(critsect_);
 
+  scoped_ptr<BitrateProber> prober_ GUARDED_BY(critsect_);
+
   int64_t time_last_update_us_ GUARDED_BY(critsect_);
   int64_t time_last_send_us_ GUARDED_BY(critsect_);
   int64_t capture_time_ms_last_queued_ GUARDED_BY(critsect_);
   int64_t capture_time_ms_last_sent_ GUARDED_BY(critsect_);
 
-  scoped_ptr<paced_sender::PacketList> high_priority_packets_
-      GUARDED_BY(critsect_);
-  scoped_ptr<paced_sender::PacketList> normal_priority_packets_
-      GUARDED_BY(critsect_);
-  scoped_ptr<paced_sender::PacketList> low_priority_packets_
+  // All queued packets, ordered by priority and then by enqueue order.
+  scoped_ptr<paced_sender::PacketQueue> packets_ GUARDED_BY(critsect_);
+  scoped_ptr<paced_sender::QueueDelayStats> queue_delay_stats_
       GUARDED_BY(critsect_);
 };
 }  // namespace webrtc
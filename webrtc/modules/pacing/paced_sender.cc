@@ -12,12 +12,17 @@
 
 #include <assert.h>
 
+#include <algorithm>
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/modules/pacing/bitrate_prober.h"
 #include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
 #include "webrtc/system_wrappers/interface/trace_event.h"
 
 namespace {
@@ -38,59 +43,156 @@ const int kMaxQueueTimeWithoutSendingUs = 30000;
 namespace webrtc {
 namespace paced_sender {
 struct Packet {
-  Packet(uint32_t ssrc,
+  Packet(PacedSender::Priority priority,
+         uint32_t ssrc,
          uint16_t seq_number,
          int64_t capture_time_ms,
          int64_t enqueue_time_ms,
          int length_in_bytes,
-         bool retransmission)
-      : ssrc(ssrc),
+         bool retransmission,
+         uint64_t enqueue_order)
+      : priority(priority),
+        ssrc(ssrc),
         sequence_number(seq_number),
         capture_time_ms(capture_time_ms),
         enqueue_time_ms(enqueue_time_ms),
         bytes(length_in_bytes),
-        retransmission(retransmission) {}
+        retransmission(retransmission),
+        enqueue_order(enqueue_order) {}
+  PacedSender::Priority priority;
   uint32_t ssrc;
   uint16_t sequence_number;
   int64_t capture_time_ms;
   int64_t enqueue_time_ms;
   int bytes;
   bool retransmission;
+  uint64_t enqueue_order;
 };
 
-// STL list style class which prevents duplicates in the list.
-class PacketList {
+// Used by priority queue to sort packets. Returns true if |first| should be
+// sent after |second|.
+struct Comparator {
+  bool operator()(const Packet& first, const Packet& second) const {
+    if (first.priority != second.priority)
+      return first.priority > second.priority;
+    return first.enqueue_order > second.enqueue_order;
+  }
+};
+
+// Binary heap of packets ordered by (priority, enqueue order), which prevents
+// duplicates of the same (ssrc, sequence number) and keeps track of the
+// oldest enqueue time.
+class PacketQueue {
  public:
-  PacketList() {};
+  PacketQueue() : enqueue_count_(0) {}
+
+  bool empty() const { return heap_.empty(); }
+
+  size_t size() const { return heap_.size(); }
+
+  const Packet& top() const { return heap_.front(); }
+
+  // Removes |packet| from the queue. This is normally the top of the queue,
+  // unless a higher priority packet was pushed after |packet| was read.
+  void Erase(const Packet& packet) {
+    queued_.erase(std::make_pair(packet.ssrc, packet.sequence_number));
+    std::map<int64_t, int>::iterator it =
+        enqueue_times_.find(packet.enqueue_time_ms);
+    assert(it != enqueue_times_.end());
+    if (--it->second == 0)
+      enqueue_times_.erase(it);
+    if (heap_.front().enqueue_order == packet.enqueue_order) {
+      std::pop_heap(heap_.begin(), heap_.end(), Comparator());
+      heap_.pop_back();
+      return;
+    }
+    for (std::vector<Packet>::iterator packet_it = heap_.begin();
+         packet_it != heap_.end(); ++packet_it) {
+      if (packet_it->enqueue_order == packet.enqueue_order) {
+        *packet_it = heap_.back();
+        heap_.pop_back();
+        std::make_heap(heap_.begin(), heap_.end(), Comparator());
+        return;
+      }
+    }
+    assert(false);
+  }
 
-  bool empty() const {
-    return packet_list_.empty();
+  // Returns false if the packet is a duplicate and was not inserted.
+  bool push(PacedSender::Priority priority,
+            uint32_t ssrc,
+            uint16_t sequence_number,
+            int64_t capture_time_ms,
+            int64_t enqueue_time_ms,
+            int bytes,
+            bool retransmission) {
+    if (!queued_.insert(std::make_pair(ssrc, sequence_number)).second)
+      return false;
+    heap_.push_back(Packet(priority, ssrc, sequence_number, capture_time_ms,
+                           enqueue_time_ms, bytes, retransmission,
+                           enqueue_count_++));
+    std::push_heap(heap_.begin(), heap_.end(), Comparator());
+    ++enqueue_times_[enqueue_time_ms];
+    return true;
   }
 
-  Packet front() const {
-    return packet_list_.front();
+  // Returns the first queued packet of |priority|, or NULL if there is none.
+  const Packet* Front(PacedSender::Priority priority) const {
+    const Packet* front = NULL;
+    for (std::vector<Packet>::const_iterator it = heap_.begin();
+         it != heap_.end(); ++it) {
+      if (it->priority == priority &&
+          (front == NULL || it->enqueue_order < front->enqueue_order)) {
+        front = &*it;
+      }
+    }
+    return front;
   }
 
-  void pop_front() {
-    Packet& packet = packet_list_.front();
-    uint16_t sequence_number = packet.sequence_number;
-    uint32_t ssrc = packet.ssrc;
-    packet_list_.pop_front();
-    sequence_number_set_[ssrc].erase(sequence_number);
+  int64_t OldestEnqueueTime() const {
+    assert(!empty());
+    return enqueue_times_.begin()->first;
   }
 
-  void push_back(const Packet& packet) {
-    if (sequence_number_set_[packet.ssrc].find(packet.sequence_number) ==
-        sequence_number_set_[packet.ssrc].end()) {
-      // Don't insert duplicates.
-      packet_list_.push_back(packet);
-      sequence_number_set_[packet.ssrc].insert(packet.sequence_number);
+ private:
+  std::vector<Packet> heap_;
+  std::set<std::pair<uint32_t, uint16_t> > queued_;
+  std::map<int64_t, int> enqueue_times_;
+  uint64_t enqueue_count_;
+};
+
+// Keeps the queue delay of the most recently sent packets for percentile
+// queries.
+class QueueDelayStats {
+ public:
+  QueueDelayStats() : next_index_(0) {
+    delays_ms_.reserve(kMaxSamples);
+  }
+
+  void AddSample(int delay_ms) {
+    if (delays_ms_.size() < kMaxSamples) {
+      delays_ms_.push_back(delay_ms);
+    } else {
+      delays_ms_[next_index_] = delay_ms;
     }
+    next_index_ = (next_index_ + 1) % kMaxSamples;
+  }
+
+  int Percentile(int percentile) const {
+    if (delays_ms_.empty())
+      return 0;
+    percentile = std::max(0, std::min(100, percentile));
+    std::vector<int> sorted(delays_ms_);
+    size_t index = (sorted.size() - 1) * percentile / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
   }
 
  private:
-  std::list<Packet> packet_list_;
-  std::map<uint32_t, std::set<uint16_t> > sequence_number_set_;
+  static const size_t kMaxSamples = 500;
+
+  std::vector<int> delays_ms_;
+  size_t next_index_;
 };
 
 class IntervalBudget {
@@ -103,6 +205,8 @@ class IntervalBudget {
     target_rate_kbps_ = target_rate_kbps;
   }
 
+  int target_rate_kbps() const { return target_rate_kbps_; }
+
   void IncreaseBudget(int delta_time_ms) {
     int bytes = target_rate_kbps_ * delta_time_ms / 8;
     if (bytes_remaining_ < 0) {
@@ -141,12 +245,12 @@ PacedSender::PacedSender(Clock* clock,
       max_queue_length_ms_(kDefaultMaxQueueLengthMs),
       media_budget_(new paced_sender::IntervalBudget(max_bitrate_kbps)),
       padding_budget_(new paced_sender::IntervalBudget(min_bitrate_kbps)),
+      prober_(new BitrateProber()),
       time_last_update_us_(clock->TimeInMicroseconds()),
       capture_time_ms_last_queued_(0),
       capture_time_ms_last_sent_(0),
-      high_priority_packets_(new paced_sender::PacketList),
-      normal_priority_packets_(new paced_sender::PacketList),
-      low_priority_packets_(new paced_sender::PacketList) {
+      packets_(new paced_sender::PacketQueue),
+      queue_delay_stats_(new paced_sender::QueueDelayStats) {
   UpdateBytesPerInterval(kMinPacketLimitMs);
 }
 
@@ -172,6 +276,11 @@ bool PacedSender::Enabled() const {
   return enabled_;
 }
 
+void PacedSender::SetProbingEnabled(bool enabled) {
+  CriticalSectionScoped cs(critsect_.get());
+  prober_->SetEnabled(enabled);
+}
+
 void PacedSender::UpdateBitrate(int max_bitrate_kbps,
                                 int min_bitrate_kbps) {
   CriticalSectionScoped cs(critsect_.get());
@@ -187,6 +296,8 @@ bool PacedSender::SendPacket(Priority priority, uint32_t ssrc,
   if (!enabled_) {
     return true;  // We can send now.
   }
+  // Probing starts with the first packet, at the pacing bitrate set by then.
+  prober_->MaybeInitializeProbe(media_budget_->target_rate_kbps() * 1000);
   if (capture_time_ms < 0) {
     capture_time_ms = clock_->TimeInMilliseconds();
   }
@@ -196,24 +307,8 @@ bool PacedSender::SendPacket(Priority priority, uint32_t ssrc,
     TRACE_EVENT_ASYNC_BEGIN1("webrtc_rtp", "PacedSend", capture_time_ms,
                              "capture_time_ms", capture_time_ms);
   }
-  paced_sender::PacketList* packet_list = NULL;
-  switch (priority) {
-    case kHighPriority:
-      packet_list = high_priority_packets_.get();
-      break;
-    case kNormalPriority:
-      packet_list = normal_priority_packets_.get();
-      break;
-    case kLowPriority:
-      packet_list = low_priority_packets_.get();
-      break;
-  }
-  packet_list->push_back(paced_sender::Packet(ssrc,
-                                              sequence_number,
-                                              capture_time_ms,
-                                              clock_->TimeInMilliseconds(),
-                                              bytes,
-                                              retransmission));
+  packets_->push(priority, ssrc, sequence_number, capture_time_ms,
+                 clock_->TimeInMilliseconds(), bytes, retransmission);
   return false;
 }
 
@@ -224,28 +319,28 @@ void PacedSender::set_max_queue_length_ms(int max_queue_length_ms) {
 
 int PacedSender::QueueInMs() const {
   CriticalSectionScoped cs(critsect_.get());
-  int64_t now_ms = clock_->TimeInMilliseconds();
-  int64_t oldest_packet_enqueue_time = now_ms;
-  if (!high_priority_packets_->empty()) {
-    oldest_packet_enqueue_time =
-        std::min(oldest_packet_enqueue_time,
-                 high_priority_packets_->front().enqueue_time_ms);
-  }
-  if (!normal_priority_packets_->empty()) {
-    oldest_packet_enqueue_time =
-        std::min(oldest_packet_enqueue_time,
-                 normal_priority_packets_->front().enqueue_time_ms);
-  }
-  if (!low_priority_packets_->empty()) {
-    oldest_packet_enqueue_time =
-        std::min(oldest_packet_enqueue_time,
-                 low_priority_packets_->front().enqueue_time_ms);
-  }
-  return now_ms - oldest_packet_enqueue_time;
+  return QueueInMsInternal();
+}
+
+int PacedSender::QueueInMsInternal() const {
+  if (packets_->empty())
+    return 0;
+  return clock_->TimeInMilliseconds() - packets_->OldestEnqueueTime();
+}
+
+int PacedSender::QueueDelayPercentileMs(int percentile) const {
+  CriticalSectionScoped cs(critsect_.get());
+  return queue_delay_stats_->Percentile(percentile);
 }
 
 int32_t PacedSender::TimeUntilNextProcess() {
   CriticalSectionScoped cs(critsect_.get());
+  if (prober_->IsProbing() && !packets_->empty()) {
+    int time_until_probe_ms =
+        prober_->TimeUntilNextProbe(clock_->TimeInMilliseconds());
+    if (time_until_probe_ms >= 0)
+      return time_until_probe_ms;
+  }
   int64_t elapsed_time_ms = (clock_->TimeInMicroseconds() -
       time_last_update_us_ + 500) / 1000;
   if (elapsed_time_ms <= 0) {
@@ -270,15 +365,24 @@ int32_t PacedSender::Process() {
       uint32_t delta_time_ms = std::min(kMaxIntervalTimeMs, elapsed_time_ms);
       UpdateBytesPerInterval(delta_time_ms);
     }
-    paced_sender::PacketList* packet_list;
-    while (ShouldSendNextPacket(&packet_list)) {
-      if (!SendPacketFromList(packet_list))
+    if (prober_->IsProbing() && !packets_->empty()) {
+      // Queued packets are sent one at a time with the spacing of the probe
+      // cluster, regardless of the budget. Padding isn't used for probing.
+      int time_until_probe_ms = prober_->TimeUntilNextProbe(now_us / 1000);
+      if (time_until_probe_ms > 0)
+        return 0;
+      if (time_until_probe_ms == 0) {
+        SendNextPacket(packets_->top());
+        return 0;
+      }
+    }
+    // Send every packet the budget allows for in this interval as one burst.
+    const paced_sender::Packet* packet;
+    while (ShouldSendNextPacket(&packet)) {
+      if (!SendNextPacket(*packet))
         return 0;
     }
-    if (high_priority_packets_->empty() &&
-        normal_priority_packets_->empty() &&
-        low_priority_packets_->empty() &&
-        padding_budget_->bytes_remaining() > 0) {
+    if (packets_->empty() && padding_budget_->bytes_remaining() > 0) {
       int padding_needed = padding_budget_->bytes_remaining();
       critsect_->Leave();
       int bytes_sent = callback_->TimeToSendPadding(padding_needed);
@@ -290,9 +394,12 @@ int32_t PacedSender::Process() {
   return 0;
 }
 
-bool PacedSender::SendPacketFromList(paced_sender::PacketList* packet_list)
+bool PacedSender::SendNextPacket(const paced_sender::Packet& next_packet)
     EXCLUSIVE_LOCKS_REQUIRED(critsect_.get()) {
-  paced_sender::Packet packet = GetNextPacketFromList(packet_list);
+  // Copy the packet since the queue may be modified while the lock is
+  // released.
+  const paced_sender::Packet packet = next_packet;
+  UpdateMediaBytesSent(packet.bytes);
   critsect_->Leave();
 
   const bool success = callback_->TimeToSendPacket(packet.ssrc,
@@ -300,16 +407,29 @@ bool PacedSender::SendPacketFromList(paced_sender::PacketList* packet_list)
                                                    packet.capture_time_ms,
                                                    packet.retransmission);
   critsect_->Enter();
-  // If packet cannot be sent then keep it in packet list and exit early.
+  // If packet cannot be sent then keep it in the queue and exit early.
   // There's no need to send more packets.
   if (!success) {
     return false;
   }
-  packet_list->pop_front();
-  const bool last_packet =
-      packet_list->empty() ||
-      packet_list->front().capture_time_ms > packet.capture_time_ms;
-  if (packet_list != high_priority_packets_.get()) {
+  prober_->PacketSent(clock_->TimeInMilliseconds(), packet.bytes);
+  packets_->Erase(packet);
+  const int64_t queue_delay_ms =
+      clock_->TimeInMilliseconds() - packet.enqueue_time_ms;
+  queue_delay_stats_->AddSample(queue_delay_ms);
+  WEBRTC_HISTOGRAM_ADD("WebRTC.Pacer.QueueDelayMs",
+                       static_cast<int>(queue_delay_ms));
+  if (packet.priority != kHighPriority) {
+    // The rest of the packets of its priority may be queued behind higher
+    // priority ones.
+    const paced_sender::Packet* next =
+        packets_->empty() ? NULL : &packets_->top();
+    if (next != NULL && next->priority != packet.priority) {
+      next = next->priority < packet.priority ? packets_->Front(packet.priority)
+                                              : NULL;
+    }
+    const bool last_packet =
+        next == NULL || next->capture_time_ms > packet.capture_time_ms;
     if (packet.capture_time_ms > capture_time_ms_last_sent_) {
       capture_time_ms_last_sent_ = packet.capture_time_ms;
     } else if (packet.capture_time_ms == capture_time_ms_last_sent_ &&
@@ -325,61 +445,32 @@ void PacedSender::UpdateBytesPerInterval(uint32_t delta_time_ms) {
   padding_budget_->IncreaseBudget(delta_time_ms);
 }
 
-bool PacedSender::ShouldSendNextPacket(paced_sender::PacketList** packet_list) {
-  *packet_list = NULL;
-  if (media_budget_->bytes_remaining() <= 0) {
-    // All bytes consumed for this interval.
-    // Check if we have not sent in a too long time.
-    if (clock_->TimeInMicroseconds() - time_last_send_us_ >
-        kMaxQueueTimeWithoutSendingUs) {
-      if (!high_priority_packets_->empty()) {
-        *packet_list = high_priority_packets_.get();
-        return true;
-      }
-      if (!normal_priority_packets_->empty()) {
-        *packet_list = normal_priority_packets_.get();
-        return true;
-      }
-    }
-    // Send any old packets to avoid queuing for too long.
-    if (max_queue_length_ms_ >= 0 && QueueInMs() > max_queue_length_ms_) {
-      int64_t high_priority_capture_time = -1;
-      if (!high_priority_packets_->empty()) {
-        high_priority_capture_time =
-            high_priority_packets_->front().capture_time_ms;
-        *packet_list = high_priority_packets_.get();
-      }
-      if (!normal_priority_packets_->empty() &&
-          (high_priority_capture_time == -1 ||
-           high_priority_capture_time >
-               normal_priority_packets_->front().capture_time_ms)) {
-        *packet_list = normal_priority_packets_.get();
-      }
-      if (*packet_list)
-        return true;
-    }
+bool PacedSender::ShouldSendNextPacket(const paced_sender::Packet** packet) {
+  if (packets_->empty())
     return false;
-  }
-  if (!high_priority_packets_->empty()) {
-    *packet_list = high_priority_packets_.get();
+  *packet = &packets_->top();
+  if (media_budget_->bytes_remaining() > 0)
     return true;
-  }
-  if (!normal_priority_packets_->empty()) {
-    *packet_list = normal_priority_packets_.get();
+  // All bytes consumed for this interval. Low priority packets are only sent
+  // within the budget, and since they are ordered last they are at the top
+  // only when no other packets are queued.
+  if ((*packet)->priority == kLowPriority)
+    return false;
+  // Check if we have not sent in a too long time.
+  if (clock_->TimeInMicroseconds() - time_last_send_us_ >
+      kMaxQueueTimeWithoutSendingUs) {
     return true;
   }
-  if (!low_priority_packets_->empty()) {
-    *packet_list = low_priority_packets_.get();
-    return true;
+  // Send any old packets to avoid queuing for too long, the one captured first
+  // of the high and normal priority packets first in line.
+  if (max_queue_length_ms_ < 0 || QueueInMsInternal() <= max_queue_length_ms_)
+    return false;
+  if ((*packet)->priority == kHighPriority) {
+    const paced_sender::Packet* normal = packets_->Front(kNormalPriority);
+    if (normal != NULL && normal->capture_time_ms < (*packet)->capture_time_ms)
+      *packet = normal;
   }
-  return false;
-}
-
-paced_sender::Packet PacedSender::GetNextPacketFromList(
-    paced_sender::PacketList* packets) {
-  paced_sender::Packet packet = packets->front();
-  UpdateMediaBytesSent(packet.bytes);
-  return packet;
+  return true;
 }
 
 void PacedSender::UpdateMediaBytesSent(int num_bytes) {
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <vector>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -54,6 +56,26 @@ class PacedSenderPadding : public PacedSender::Callback {
   int padding_sent_;
 };
 
+// Records the time each packet was sent.
+class PacedSenderProbing : public PacedSender::Callback {
+ public:
+  explicit PacedSenderProbing(Clock* clock) : clock_(clock) {}
+
+  bool TimeToSendPacket(uint32_t ssrc, uint16_t sequence_number,
+                        int64_t capture_time_ms, bool retransmission) {
+    send_times_ms_.push_back(clock_->TimeInMilliseconds());
+    return true;
+  }
+
+  int TimeToSendPadding(int bytes) { return 0; }
+
+  const std::vector<int64_t>& send_times_ms() const { return send_times_ms_; }
+
+ private:
+  Clock* const clock_;
+  std::vector<int64_t> send_times_ms_;
+};
+
 class PacedSenderTest : public ::testing::Test {
  protected:
   PacedSenderTest() : clock_(123456) {
@@ -524,6 +546,40 @@ TEST_F(PacedSenderTest, MaxQueueLength) {
   send_bucket_->Process();
 }
 
+TEST_F(PacedSenderTest, MaxQueueLengthSendsFirstCapturedPacketFirst) {
+  uint32_t ssrc = 12346;
+  uint16_t sequence_number = 1234;
+  send_bucket_->UpdateBitrate(kPaceMultiplier * 30, 0);
+
+  const int64_t normal_capture_time_ms = clock_.TimeInMilliseconds();
+  EXPECT_FALSE(send_bucket_->SendPacket(PacedSender::kNormalPriority, ssrc,
+      sequence_number, normal_capture_time_ms, 1200, false));
+  clock_.AdvanceTimeMilliseconds(2001);
+  const int64_t high_capture_time_ms = clock_.TimeInMilliseconds();
+  EXPECT_FALSE(send_bucket_->SendPacket(PacedSender::kHighPriority, ssrc,
+      sequence_number + 1, high_capture_time_ms, 1200, false));
+  EXPECT_FALSE(send_bucket_->SendPacket(PacedSender::kHighPriority, ssrc,
+      sequence_number + 2, high_capture_time_ms, 1200, false));
+
+  // The first high priority packet uses up the budget. Then the queue is too
+  // long, and the normal priority packet was captured before the other high
+  // priority one, which is sent once too long has passed without sending.
+  testing::InSequence in_sequence;
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number + 1,
+                                          high_capture_time_ms, false))
+      .WillOnce(Return(true));
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number,
+                                          normal_capture_time_ms, false))
+      .WillOnce(Return(true));
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number + 2,
+                                          high_capture_time_ms, false))
+      .WillOnce(Return(true));
+  send_bucket_->Process();
+  clock_.AdvanceTimeMilliseconds(31);
+  send_bucket_->Process();
+  EXPECT_EQ(0, send_bucket_->QueueInMs());
+}
+
 TEST_F(PacedSenderTest, QueueTimeGrowsOverTime) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
@@ -542,5 +598,76 @@ TEST_F(PacedSenderTest, QueueTimeGrowsOverTime) {
   send_bucket_->Process();
   EXPECT_EQ(0, send_bucket_->QueueInMs());
 }
+
+TEST_F(PacedSenderTest, QueueDelayPercentiles) {
+  uint32_t ssrc = 12346;
+  uint16_t sequence_number = 1234;
+  EXPECT_EQ(0, send_bucket_->QueueDelayPercentileMs(50));
+
+  // Exhaust the budget of the first interval.
+  SendAndExpectPacket(PacedSender::kNormalPriority, ssrc, sequence_number++,
+                      clock_.TimeInMilliseconds(), 250, false);
+  SendAndExpectPacket(PacedSender::kNormalPriority, ssrc, sequence_number++,
+                      clock_.TimeInMilliseconds(), 250, false);
+  SendAndExpectPacket(PacedSender::kNormalPriority, ssrc, sequence_number++,
+                      clock_.TimeInMilliseconds(), 250, false);
+  send_bucket_->Process();
+
+  // Queue four packets 10 ms apart, all sent in a single burst.
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, _, _, false))
+      .Times(4)
+      .WillRepeatedly(Return(true));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_FALSE(send_bucket_->SendPacket(PacedSender::kNormalPriority, ssrc,
+        sequence_number++, clock_.TimeInMilliseconds(), 250, false));
+    clock_.AdvanceTimeMilliseconds(10);
+  }
+  EXPECT_EQ(40, send_bucket_->QueueInMs());
+  send_bucket_->Process();
+  EXPECT_EQ(0, send_bucket_->QueueInMs());
+
+  // Delays are 40, 30, 20 and 10 ms. The first three packets were not delayed.
+  EXPECT_EQ(0, send_bucket_->QueueDelayPercentileMs(0));
+  EXPECT_EQ(10, send_bucket_->QueueDelayPercentileMs(50));
+  EXPECT_EQ(40, send_bucket_->QueueDelayPercentileMs(100));
+}
+
+TEST_F(PacedSenderTest, ProbingWithInitialFrame) {
+  const int kPacketSize = 1000;
+  const int kNumPackets = 15;
+  PacedSenderProbing callback(&clock_);
+  // Probes at 3 and 6 times 1000 kbps, spaced 2 and 1 ms for 1000 bytes.
+  send_bucket_.reset(new PacedSender(&clock_, &callback, 1000, 0));
+  send_bucket_->SetProbingEnabled(true);
+  for (int i = 0; i < kNumPackets; ++i) {
+    EXPECT_FALSE(send_bucket_->SendPacket(PacedSender::kNormalPriority, 12345,
+        1234 + i, clock_.TimeInMilliseconds(), kPacketSize, false));
+  }
+  while (callback.send_times_ms().size() < 10u) {
+    int time_until_process = send_bucket_->TimeUntilNextProcess();
+    ASSERT_GE(time_until_process, 0);
+    clock_.AdvanceTimeMilliseconds(time_until_process);
+    send_bucket_->Process();
+  }
+  const std::vector<int64_t>& send_times_ms = callback.send_times_ms();
+  for (int i = 1; i < 5; ++i)
+    EXPECT_EQ(2, send_times_ms[i] - send_times_ms[i - 1]);
+  for (int i = 6; i < 10; ++i)
+    EXPECT_EQ(1, send_times_ms[i] - send_times_ms[i - 1]);
+}
+
+TEST_F(PacedSenderTest, NoProbingWhenDisabled) {
+  PacedSenderProbing callback(&clock_);
+  send_bucket_.reset(new PacedSender(&clock_, &callback, 1000, 0));
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_FALSE(send_bucket_->SendPacket(PacedSender::kNormalPriority, 12345,
+        1234 + i, clock_.TimeInMilliseconds(), 1000, false));
+  }
+  send_bucket_->Process();
+  // The first interval allows for 5 ms at 1000 kbps, sent as one burst.
+  ASSERT_FALSE(callback.send_times_ms().empty());
+  EXPECT_EQ(callback.send_times_ms().front(),
+            callback.send_times_ms().back());
+}
 }  // namespace test
 }  // namespace webrtc
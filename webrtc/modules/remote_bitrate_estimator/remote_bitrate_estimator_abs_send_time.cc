@@ -0,0 +1,388 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "webrtc/modules/remote_bitrate_estimator/rate_statistics.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/remote_bitrate_estimator/overuse_detector.h"
+#include "webrtc/modules/remote_bitrate_estimator/remote_rate_control.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace {
+// The absolute send time is a 6.18 fixed point number of seconds, which wraps
+// every 64 seconds.
+const int kAbsSendTimeFraction = 18;
+const uint32_t kAbsSendTimeMask = 0x00ffffff;
+const int32_t kAbsSendTimeHalfRange = 1 << 23;
+// Packets sent within this time of the first packet of a group, from any of
+// the streams, are handed to the over-use detector as one group.
+const int64_t kTimestampGroupLengthMs = 5;
+const int64_t kTimestampGroupLengthTicks =
+    (kTimestampGroupLengthMs << kAbsSendTimeFraction) / 1000;
+// Packets of at least this size received within this time of the first packet
+// are looked at as probes of the path capacity.
+const int kMinProbePacketSize = 200;
+const int64_t kInitialProbingIntervalMs = 2000;
+// A probe cluster is at least this many packets sent with about the same
+// spacing, which is at least |kMinProbeDeltaMs|.
+const int kMinClusterSize = 4;
+const float kMaxClusterDeltaDiffMs = 2.5f;
+const float kMinProbeDeltaMs = 1.0f;
+// The number of probes kept while looking for a cluster.
+const size_t kMaxProbes = 50;
+
+// Estimates the bandwidth of all incoming streams with one over-use detector,
+// from the send times in the absolute send time header extension. The work per
+// packet doesn't depend on the number of streams.
+//
+// During the first seconds, clusters of packets sent with a fixed spacing, as
+// a prober in the sender's pacer sends them, are also looked for. The rate at
+// which such a cluster got through is a measure of the capacity of the path,
+// and lets the estimate start there rather than ramp up to it.
+class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
+ public:
+  RemoteBitrateEstimatorAbsSendTime(RemoteBitrateObserver* observer,
+                                    Clock* clock,
+                                    uint32_t min_bitrate_bps);
+  virtual ~RemoteBitrateEstimatorAbsSendTime() {}
+
+  // Updates the incoming payload bitrate estimate and the over-use detector.
+  // Packets without the absolute send time are only counted in the bitrate.
+  // If an over-use is detected the remote bitrate estimate will be updated.
+  virtual void IncomingPacket(int64_t arrival_time_ms,
+                              int payload_size,
+                              const RTPHeader& header) OVERRIDE;
+
+  // Triggers a new estimate calculation.
+  // Implements the Module interface.
+  virtual int32_t Process() OVERRIDE;
+  virtual int32_t TimeUntilNextProcess() OVERRIDE;
+  // Set the current round-trip time experienced by the streams.
+  // Implements the StatsObserver interface.
+  virtual void OnRttUpdate(uint32_t rtt) OVERRIDE;
+
+  // Removes all data for |ssrc|.
+  virtual void RemoveStream(unsigned int ssrc) OVERRIDE;
+
+  virtual bool LatestEstimate(std::vector<unsigned int>* ssrcs,
+                              unsigned int* bitrate_bps) const OVERRIDE;
+
+  virtual bool GetStats(
+      ReceiveBandwidthEstimatorStats* output) const OVERRIDE;
+
+ private:
+  // Map from SSRC to the last incoming packet time in milliseconds, taken from
+  // clock_.
+  typedef std::map<unsigned int, int64_t> SsrcTimeMap;
+
+  struct Probe {
+    Probe(int64_t send_time_us, int64_t recv_time_ms, int payload_size)
+        : send_time_us(send_time_us),
+          recv_time_ms(recv_time_ms),
+          payload_size(payload_size) {}
+    int64_t send_time_us;
+    int64_t recv_time_ms;
+    int payload_size;
+  };
+
+  // Looks for clusters among the probes, and raises the estimate to the
+  // highest bitrate a cluster got through at. The probes are cleared once the
+  // estimate has been raised.
+  void ProcessProbes(int64_t now_ms);
+
+  // Returns the 90 kHz timestamp of the group of |send_time_24bits|. The
+  // timestamps wrap like RTP timestamps, unlike the absolute send time.
+  uint32_t GroupTimestamp(uint32_t send_time_24bits);
+
+  // Triggers a new estimate calculation.
+  void UpdateEstimate(int64_t now_ms);
+
+  void GetSsrcs(std::vector<unsigned int>* ssrcs) const;
+
+  Clock* clock_;
+  SsrcTimeMap ssrcs_;
+  // The entry of the stream of the last packet. Packets of a stream tend to
+  // come in bursts, so this usually saves the map lookup.
+  SsrcTimeMap::iterator last_ssrc_;
+  OveruseDetector overuse_detector_;
+  bool first_send_time_;
+  uint32_t last_send_time_24bits_;
+  // Send times in 2^-18 seconds, unwrapped.
+  int64_t unwrapped_send_time_;
+  int64_t group_start_send_time_;
+  RateStatistics incoming_bitrate_;
+  RemoteRateControl remote_rate_;
+  RemoteBitrateObserver* observer_;
+  scoped_ptr<CriticalSectionWrapper> crit_sect_;
+  int64_t last_process_time_;
+  // The arrival time of the first packet with the absolute send time, from
+  // clock_.
+  int64_t first_packet_time_ms_;
+  std::vector<Probe> probes_;
+};
+
+RemoteBitrateEstimatorAbsSendTime::RemoteBitrateEstimatorAbsSendTime(
+    RemoteBitrateObserver* observer,
+    Clock* clock,
+    uint32_t min_bitrate_bps)
+    : clock_(clock),
+      last_ssrc_(ssrcs_.end()),
+      overuse_detector_(OverUseDetectorOptions()),
+      first_send_time_(true),
+      last_send_time_24bits_(0),
+      unwrapped_send_time_(0),
+      group_start_send_time_(0),
+      incoming_bitrate_(500, 8000),
+      remote_rate_(min_bitrate_bps),
+      observer_(observer),
+      crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+      last_process_time_(-1),
+      first_packet_time_ms_(-1) {
+  assert(observer_);
+}
+
+void RemoteBitrateEstimatorAbsSendTime::IncomingPacket(
+    int64_t arrival_time_ms,
+    int payload_size,
+    const RTPHeader& header) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  CriticalSectionScoped cs(crit_sect_.get());
+  if (last_ssrc_ == ssrcs_.end() || last_ssrc_->first != header.ssrc)
+    last_ssrc_ = ssrcs_.insert(std::make_pair(header.ssrc, now_ms)).first;
+  last_ssrc_->second = now_ms;
+  incoming_bitrate_.Update(payload_size, now_ms);
+  if (!header.extension.hasAbsoluteSendTime)
+    return;
+  const BandwidthUsage prior_state = overuse_detector_.State();
+  overuse_detector_.Update(payload_size, -1,
+                           GroupTimestamp(header.extension.absoluteSendTime),
+                           arrival_time_ms);
+  if (first_packet_time_ms_ < 0)
+    first_packet_time_ms_ = now_ms;
+  if (payload_size >= kMinProbePacketSize &&
+      now_ms - first_packet_time_ms_ < kInitialProbingIntervalMs) {
+    if (probes_.size() >= kMaxProbes)
+      probes_.erase(probes_.begin());
+    probes_.push_back(Probe(
+        (unwrapped_send_time_ * 1000000) >> kAbsSendTimeFraction,
+        arrival_time_ms, payload_size));
+    ProcessProbes(now_ms);
+  }
+  if (overuse_detector_.State() == kBwOverusing) {
+    unsigned int incoming_bitrate = incoming_bitrate_.Rate(now_ms);
+    if (prior_state != kBwOverusing ||
+        remote_rate_.TimeToReduceFurther(now_ms, incoming_bitrate)) {
+      // The first overuse should immediately trigger a new estimate.
+      // We also have to update the estimate immediately if we are overusing
+      // and the target bitrate is too high compared to what we are receiving.
+      UpdateEstimate(now_ms);
+    }
+  }
+}
+
+uint32_t RemoteBitrateEstimatorAbsSendTime::GroupTimestamp(
+    uint32_t send_time_24bits) {
+  send_time_24bits &= kAbsSendTimeMask;
+  if (first_send_time_) {
+    first_send_time_ = false;
+    unwrapped_send_time_ = send_time_24bits;
+    group_start_send_time_ = unwrapped_send_time_;
+  } else {
+    // The difference to the previous send time, in [-2^23, 2^23) ticks.
+    const int32_t diff = static_cast<int32_t>(
+        (send_time_24bits - last_send_time_24bits_ + kAbsSendTimeHalfRange) &
+        kAbsSendTimeMask) - kAbsSendTimeHalfRange;
+    unwrapped_send_time_ += diff;
+  }
+  last_send_time_24bits_ = send_time_24bits;
+
+  int64_t timestamp_send_time = group_start_send_time_;
+  if (unwrapped_send_time_ < group_start_send_time_) {
+    // Sent before the current group. The detector drops it as reordered.
+    timestamp_send_time = unwrapped_send_time_;
+  } else if (unwrapped_send_time_ - group_start_send_time_ >=
+             kTimestampGroupLengthTicks) {
+    group_start_send_time_ = unwrapped_send_time_;
+    timestamp_send_time = group_start_send_time_;
+  }
+  return static_cast<uint32_t>(
+      (timestamp_send_time * 90000) >> kAbsSendTimeFraction);
+}
+
+void RemoteBitrateEstimatorAbsSendTime::ProcessProbes(int64_t now_ms) {
+  uint32_t best_bitrate_bps = 0;
+  // Running sums of the deltas to the previous probe, and of the sizes, of the
+  // current cluster.
+  float send_sum_ms = 0.0f;
+  float recv_sum_ms = 0.0f;
+  int size_sum = 0;
+  int count = 0;
+  for (size_t i = 1; i <= probes_.size(); ++i) {
+    float send_delta_ms = 0.0f;
+    if (i < probes_.size()) {
+      send_delta_ms =
+          (probes_[i].send_time_us - probes_[i - 1].send_time_us) / 1000.0f;
+      if (count > 0 &&
+          fabsf(send_delta_ms - send_sum_ms / count) <= kMaxClusterDeltaDiffMs) {
+        send_sum_ms += send_delta_ms;
+        recv_sum_ms += probes_[i].recv_time_ms - probes_[i - 1].recv_time_ms;
+        size_sum += probes_[i].payload_size;
+        ++count;
+        continue;
+      }
+    }
+    // The cluster ended with the previous probe.
+    if (count >= kMinClusterSize && send_sum_ms >= kMinProbeDeltaMs * count &&
+        recv_sum_ms > 0.0f) {
+      // The probes can't get through faster than they were sent, and the
+      // receive rate is what the path allowed for.
+      const float bitrate_bps =
+          size_sum * 8 * 1000.0f / std::max(send_sum_ms, recv_sum_ms);
+      best_bitrate_bps =
+          std::max(best_bitrate_bps, static_cast<uint32_t>(bitrate_bps));
+    }
+    if (i == probes_.size())
+      break;
+    send_sum_ms = send_delta_ms;
+    recv_sum_ms = probes_[i].recv_time_ms - probes_[i - 1].recv_time_ms;
+    size_sum = probes_[i].payload_size;
+    count = 1;
+  }
+  if (best_bitrate_bps == 0 ||
+      (remote_rate_.ValidEstimate() &&
+       best_bitrate_bps <= remote_rate_.LatestEstimate())) {
+    return;
+  }
+  LOG(LS_INFO) << "Probed bitrate " << best_bitrate_bps << " bps";
+  remote_rate_.SetEstimate(best_bitrate_bps, now_ms);
+  probes_.clear();
+  std::vector<unsigned int> ssrcs;
+  GetSsrcs(&ssrcs);
+  observer_->OnReceiveBitrateChanged(ssrcs, remote_rate_.LatestEstimate());
+}
+
+int32_t RemoteBitrateEstimatorAbsSendTime::Process() {
+  if (TimeUntilNextProcess() > 0) {
+    return 0;
+  }
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  UpdateEstimate(now_ms);
+  last_process_time_ = now_ms;
+  return 0;
+}
+
+int32_t RemoteBitrateEstimatorAbsSendTime::TimeUntilNextProcess() {
+  if (last_process_time_ < 0) {
+    return 0;
+  }
+  return last_process_time_ + kProcessIntervalMs - clock_->TimeInMilliseconds();
+}
+
+void RemoteBitrateEstimatorAbsSendTime::UpdateEstimate(int64_t now_ms) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  SsrcTimeMap::iterator it = ssrcs_.begin();
+  while (it != ssrcs_.end()) {
+    if (now_ms - it->second > kStreamTimeOutMs) {
+      // This stream hasn't received packets for |kStreamTimeOutMs|
+      // milliseconds and is considered stale.
+      ssrcs_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  last_ssrc_ = ssrcs_.end();
+  // We can't update the estimate if we don't have any active streams.
+  if (ssrcs_.empty()) {
+    remote_rate_.Reset();
+    overuse_detector_ = OveruseDetector(OverUseDetectorOptions());
+    first_send_time_ = true;
+    first_packet_time_ms_ = -1;
+    probes_.clear();
+    return;
+  }
+  const RateControlInput input(overuse_detector_.State(),
+                               incoming_bitrate_.Rate(now_ms),
+                               overuse_detector_.NoiseVar());
+  const RateControlRegion region = remote_rate_.Update(&input, now_ms);
+  unsigned int target_bitrate = remote_rate_.UpdateBandwidthEstimate(now_ms);
+  if (remote_rate_.ValidEstimate()) {
+    std::vector<unsigned int> ssrcs;
+    GetSsrcs(&ssrcs);
+    observer_->OnReceiveBitrateChanged(ssrcs, target_bitrate);
+  }
+  overuse_detector_.SetRateControlRegion(region);
+}
+
+void RemoteBitrateEstimatorAbsSendTime::OnRttUpdate(uint32_t rtt) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  remote_rate_.SetRtt(rtt);
+}
+
+void RemoteBitrateEstimatorAbsSendTime::RemoveStream(unsigned int ssrc) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  ssrcs_.erase(ssrc);
+  last_ssrc_ = ssrcs_.end();
+}
+
+bool RemoteBitrateEstimatorAbsSendTime::LatestEstimate(
+    std::vector<unsigned int>* ssrcs,
+    unsigned int* bitrate_bps) const {
+  CriticalSectionScoped cs(crit_sect_.get());
+  assert(bitrate_bps);
+  if (!remote_rate_.ValidEstimate()) {
+    return false;
+  }
+  GetSsrcs(ssrcs);
+  if (ssrcs->empty())
+    *bitrate_bps = 0;
+  else
+    *bitrate_bps = remote_rate_.LatestEstimate();
+  return true;
+}
+
+bool RemoteBitrateEstimatorAbsSendTime::GetStats(
+    ReceiveBandwidthEstimatorStats* output) const {
+  // Not implemented.
+  return false;
+}
+
+void RemoteBitrateEstimatorAbsSendTime::GetSsrcs(
+    std::vector<unsigned int>* ssrcs) const {
+  assert(ssrcs);
+  ssrcs->resize(ssrcs_.size());
+  int i = 0;
+  for (SsrcTimeMap::const_iterator it = ssrcs_.begin(); it != ssrcs_.end();
+       ++it, ++i) {
+    (*ssrcs)[i] = it->first;
+  }
+}
+}  // namespace
+
+RemoteBitrateEstimator* AbsoluteSendTimeRemoteBitrateEstimatorFactory::Create(
+    RemoteBitrateObserver* observer,
+    Clock* clock,
+    RateControlType control_type,
+    uint32_t min_bitrate_bps) const {
+  LOG(LS_INFO) << "AbsoluteSendTimeRemoteBitrateEstimatorFactory: "
+      "Instantiating.";
+  return new RemoteBitrateEstimatorAbsSendTime(observer, clock,
+                                               min_bitrate_bps);
+}
+}  // namespace webrtc
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.h"
+
+namespace webrtc {
+
+class RemoteBitrateEstimatorAbsSendTimeTest : public RemoteBitrateEstimatorTest {
+ public:
+  static const uint32_t kRemoteBitrateEstimatorMinBitrateBps = 30000;
+
+  RemoteBitrateEstimatorAbsSendTimeTest() {}
+  virtual void SetUp() {
+    bitrate_estimator_.reset(AbsoluteSendTimeRemoteBitrateEstimatorFactory().Create(
+        bitrate_observer_.get(),
+        &clock_,
+        kMimdControl,
+        kRemoteBitrateEstimatorMinBitrateBps));
+  }
+ protected:
+  DISALLOW_COPY_AND_ASSIGN(RemoteBitrateEstimatorAbsSendTimeTest);
+};
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, InitialBehavior) {
+  InitialBehaviorTestHelper(496696);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, RateIncreaseReordering) {
+  RateIncreaseReorderingTestHelper(496752);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, RateIncreaseRtpTimestamps) {
+  RateIncreaseRtpTimestampsTestHelper();
+}
+
+// Verify that the time it takes for the estimator to reduce the bitrate when
+// the capacity is tightened stays the same.
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, CapacityDropOneStream) {
+  CapacityDropTestHelper(1, false, 956214, 367);
+}
+
+// Verify that the time it takes for the estimator to reduce the bitrate when
+// the capacity is tightened stays the same. This test also verifies that we
+// handle wrap-arounds in this scenario.
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, CapacityDropOneStreamWrap) {
+  CapacityDropTestHelper(1, true, 956214, 367);
+}
+
+// Verify that the time it takes for the estimator to reduce the bitrate when
+// the capacity is tightened stays the same. This test also verifies that we
+// handle wrap-arounds in this scenario. This is a multi-stream test.
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, CapacityDropTwoStreamsWrap) {
+  CapacityDropTestHelper(2, true, 926105, 433);
+}
+
+// Verify that the time it takes for the estimator to reduce the bitrate when
+// the capacity is tightened stays the same. This test also verifies that we
+// handle wrap-arounds in this scenario. This is a multi-stream test.
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, CapacityDropThreeStreamsWrap) {
+  CapacityDropTestHelper(3, true, 926105, 433);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, CapacityDropThirteenStreamsWrap) {
+  CapacityDropTestHelper(13, true, 918970, 433);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, CapacityDropNineteenStreamsWrap) {
+  CapacityDropTestHelper(19, true, 917280, 433);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, CapacityDropThirtyStreamsWrap) {
+  CapacityDropTestHelper(30, true, 917554, 433);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, TestProbeDetection) {
+  const int kProbeLength = 5;
+  int64_t now_ms = clock_.TimeInMilliseconds();
+  // A cluster sent and received 10 ms apart: 800 kbps.
+  for (int i = 0; i < kProbeLength; ++i) {
+    clock_.AdvanceTimeMilliseconds(10);
+    now_ms = clock_.TimeInMilliseconds();
+    IncomingPacket(kDefaultSsrc, 1000, now_ms, 90 * now_ms,
+                   AbsSendTime(now_ms, 1000));
+  }
+  EXPECT_TRUE(bitrate_observer_->updated());
+  EXPECT_NEAR(800000u, bitrate_observer_->latest_bitrate(), 10000);
+  bitrate_observer_->Reset();
+
+  // A cluster sent 1 ms apart, which the path spreads out to 2 ms: 4 Mbps.
+  int64_t send_time_ms = now_ms;
+  for (int i = 0; i < kProbeLength; ++i) {
+    clock_.AdvanceTimeMilliseconds(2);
+    send_time_ms += 1;
+    now_ms = clock_.TimeInMilliseconds();
+    IncomingPacket(kDefaultSsrc, 1000, now_ms, 90 * send_time_ms,
+                   AbsSendTime(send_time_ms, 1000));
+  }
+  EXPECT_TRUE(bitrate_observer_->updated());
+  EXPECT_NEAR(4000000u, bitrate_observer_->latest_bitrate(), 10000);
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, TestProbeDetectionTooSmallDelta) {
+  // Packets sent back to back aren't a probe of the path.
+  int64_t now_ms = clock_.TimeInMilliseconds();
+  for (int i = 0; i < 10; ++i) {
+    IncomingPacket(kDefaultSsrc, 1000, now_ms, 90 * now_ms,
+                   AbsSendTime(now_ms, 1000));
+  }
+  EXPECT_FALSE(bitrate_observer_->updated());
+}
+
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, TestProbeDetectionSmallPackets) {
+  // Padding-sized packets aren't used as probes.
+  int64_t now_ms = clock_.TimeInMilliseconds();
+  for (int i = 0; i < 10; ++i) {
+    clock_.AdvanceTimeMilliseconds(10);
+    now_ms = clock_.TimeInMilliseconds();
+    IncomingPacket(kDefaultSsrc, 100, now_ms, 90 * now_ms,
+                   AbsSendTime(now_ms, 1000));
+  }
+  EXPECT_FALSE(bitrate_observer_->updated());
+}
+}  // namespace webrtc
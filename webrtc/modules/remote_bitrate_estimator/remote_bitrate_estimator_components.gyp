@@ -17,9 +17,12 @@
       'sources': [
         'overuse_detector.cc',
         'overuse_detector.h',
+        'remote_bitrate_estimator_abs_send_time.cc',
         'remote_bitrate_estimator_single_stream.cc',
         'remote_rate_control.cc',
         'remote_rate_control.h',
+        'transport_feedback_adapter.cc',
+        'transport_feedback_adapter.h',
       ],
     },
   ],
@@ -259,15 +259,4 @@ RemoteBitrateEstimator* RemoteBitrateEstimatorFactory::Create(
   return new RemoteBitrateEstimatorSingleStream(observer, clock,
                                                 min_bitrate_bps);
 }
-
-RemoteBitrateEstimator* AbsoluteSendTimeRemoteBitrateEstimatorFactory::Create(
-    RemoteBitrateObserver* observer,
-    Clock* clock,
-    RateControlType control_type,
-    uint32_t min_bitrate_bps) const {
-  LOG(LS_INFO) << "AbsoluteSendTimeRemoteBitrateEstimatorFactory: "
-      "Instantiating.";
-  return new RemoteBitrateEstimatorSingleStream(observer, clock,
-                                                min_bitrate_bps);
-}
 }  // namespace webrtc
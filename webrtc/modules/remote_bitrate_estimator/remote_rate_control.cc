@@ -91,6 +91,13 @@ uint32_t RemoteRateControl::UpdateBandwidthEstimate(int64_t now_ms) {
   return current_bit_rate_;
 }
 
+void RemoteRateControl::SetEstimate(uint32_t bitrate_bps, int64_t now_ms) {
+  current_bit_rate_ = std::min(std::max(bitrate_bps, min_configured_bit_rate_),
+                               max_configured_bit_rate_);
+  initialized_bit_rate_ = true;
+  last_bit_rate_change_ = now_ms;
+}
+
 void RemoteRateControl::SetRtt(unsigned int rtt) {
   rtt_ = rtt;
 }
@@ -36,6 +36,9 @@ class RemoteRateControl {
   int32_t SetConfiguredBitRates(uint32_t min_bit_rate, uint32_t max_bit_rate);
   uint32_t LatestEstimate() const;
   uint32_t UpdateBandwidthEstimate(int64_t now_ms);
+  // Sets the estimate to |bitrate_bps|, limited to the configured bitrates,
+  // e.g. from a measurement of the capacity of the path.
+  void SetEstimate(uint32_t bitrate_bps, int64_t now_ms);
   void SetRtt(unsigned int rtt);
   RateControlRegion Update(const RateControlInput* input, int64_t now_ms);
 
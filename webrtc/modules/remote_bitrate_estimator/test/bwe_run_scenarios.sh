@@ -0,0 +1,59 @@
+#!/bin/bash
+
+# Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+#
+# Use of this source code is governed by a BSD-style license
+# that can be found in the LICENSE file in the root of the source
+# tree. An additional intellectual property rights grant can be found
+# in the file PATENTS.  All contributing project authors may
+# be found in the AUTHORS file in the root of the source tree.
+
+# Runs every BWE simulation matching a gtest filter in its own process, as many
+# at a time as there are cores, and splits the PLOT lines of each run into one
+# CSV file per data set (e.g. per flow throughput and delay).
+#
+# Usage: bwe_run_scenarios.sh <test binary> <gtest filter> <output dir> [jobs]
+#
+# e.g. bwe_run_scenarios.sh out/Release/modules_unittests \
+#          '*BweSimulation*' /tmp/bwe
+#
+# Each test writes <output dir>/<test>/log, which can be piped into
+# bwe_plot.sh, and <output dir>/<test>/<data set>.csv with "seconds,value"
+# rows.
+
+if [ $# -lt 3 ]; then
+  echo "Usage: $0 <test binary> <gtest filter> <output dir> [jobs]" >&2
+  exit 1
+fi
+
+binary=$1
+filter=$2
+out_dir=$3
+jobs=${4:-$(getconf _NPROCESSORS_ONLN)}
+
+function list_tests {
+  "$binary" --gtest_filter="$filter" --gtest_list_tests | awk '
+    /^[^ ]/ { test_case = $1 }
+    /^  / { print test_case $1 }'
+}
+
+function run_test {
+  test=$1
+  dir="$out_dir/$(echo "$test" | tr '/' '_')"
+  mkdir -p "$dir"
+  "$binary" --gtest_filter="$test" > "$dir/log" 2>&1
+  status=$?
+  grep "^PLOT" "$dir/log" | awk -F '\t' -v dir="$dir" '{
+    name = $2
+    gsub(/[^A-Za-z0-9_.-]/, "_", name)
+    print $3 "," $4 > (dir "/" name ".csv")
+  }'
+  echo "$test: exit status $status"
+  return $status
+}
+
+export binary out_dir
+export -f run_test
+
+mkdir -p "$out_dir"
+list_tests | xargs -P "$jobs" -I {} bash -c 'run_test "$@"' _ {}
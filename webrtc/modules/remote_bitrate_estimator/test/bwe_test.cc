@@ -175,18 +175,20 @@ class PacketProcessorRunner {
   void FindPacketsToProcess(const FlowIds& flow_ids, Packets* in,
                             Packets* out) {
     assert(out->empty());
-    for (Packets::iterator it = in->begin(); it != in->end();) {
-      // TODO(holmer): Further optimize this by looking for consecutive flow ids
-      // in the packet list and only doing the binary search + splice once for a
-      // sequence.
-      if (std::binary_search(flow_ids.begin(), flow_ids.end(), it->flow_id())) {
-        Packets::iterator next = it;
-        ++next;
-        out->splice(out->end(), *in, it);
-        it = next;
-      } else {
-        ++it;
+    // Packets of a flow tend to come in runs, so the flow id lookup and the
+    // splice are done once per run of consecutive packets rather than once per
+    // packet, which keeps the distribution cheap with many flows.
+    Packets::iterator it = in->begin();
+    while (it != in->end()) {
+      const int flow_id = it->flow_id();
+      Packets::iterator run_end = it;
+      do {
+        ++run_end;
+      } while (run_end != in->end() && run_end->flow_id() == flow_id);
+      if (std::binary_search(flow_ids.begin(), flow_ids.end(), flow_id)) {
+        out->splice(out->end(), *in, it, run_end);
       }
+      it = run_end;
     }
   }
 
@@ -330,9 +332,13 @@ void BweTest::RunFor(int64_t time_ms) {
       ASSERT_TRUE(IsTimeSorted(packets));
     }
 
+    // Only look up the estimator when the flow changes between packets.
+    EstimatorMap::iterator est_it = estimators_.end();
     for (PacketsConstIt it = packets.begin(); it != packets.end(); ++it) {
-      EstimatorMap::iterator est_it = estimators_.find(it->flow_id());
-      ASSERT_TRUE(est_it != estimators_.end());
+      if (est_it == estimators_.end() || est_it->first != it->flow_id()) {
+        est_it = estimators_.find(it->flow_id());
+        ASSERT_TRUE(est_it != estimators_.end());
+      }
       est_it->second->EatPacket(*it);
     }
 
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/transport_feedback_adapter.h"
+
+#include <assert.h>
+
+#include <utility>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+namespace {
+// All the packets of the transport are handed to the estimator as one stream.
+const uint32_t kTransportSsrc = 0;
+
+// Converts |time_ms| to the 24-bit absolute send time, a 6.18 fixed point
+// number of seconds.
+uint32_t ToAbsoluteSendTime(int64_t time_ms) {
+  return static_cast<uint32_t>(((time_ms << 18) / 1000) & 0x00ffffff);
+}
+}  // namespace
+
+TransportFeedbackAdapter::TransportFeedbackAdapter(
+    RtcpBandwidthObserver* bandwidth_observer,
+    Clock* clock,
+    uint32_t min_bitrate_bps)
+    : bandwidth_observer_(bandwidth_observer),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      first_sequence_number_(0),
+      next_sequence_number_(0),
+      estimator_(AbsoluteSendTimeRemoteBitrateEstimatorFactory().Create(
+          this, clock, kAimdControl, min_bitrate_bps)) {
+  assert(bandwidth_observer_);
+}
+
+TransportFeedbackAdapter::~TransportFeedbackAdapter() {}
+
+uint16_t TransportFeedbackAdapter::OnSendingPacket(size_t length,
+                                                   int64_t send_time_ms) {
+  CriticalSectionScoped cs(crit_.get());
+  if (send_history_.size() >= kMaxSendHistory) {
+    // Feedback this late is of no use to the estimator.
+    send_history_.pop_front();
+    ++first_sequence_number_;
+  }
+  send_history_.push_back(SentPacket(send_time_ms, length));
+  return next_sequence_number_++;
+}
+
+void TransportFeedbackAdapter::OnReceivedTransportFeedback(
+    const std::vector<PacketArrival>& arrivals) {
+  std::vector<std::pair<int64_t, SentPacket> > packets;
+  packets.reserve(arrivals.size());
+  {
+    CriticalSectionScoped cs(crit_.get());
+    for (size_t i = 0; i < arrivals.size(); ++i) {
+      const uint16_t offset =
+          arrivals[i].sequence_number - first_sequence_number_;
+      if (offset >= send_history_.size())
+        continue;  // Not sent by us, or too old.
+      packets.push_back(
+          std::make_pair(arrivals[i].arrival_time_ms, send_history_[offset]));
+    }
+  }
+  // The estimator may report a new estimate, so it is called without holding
+  // our lock.
+  RTPHeader header;
+  header.ssrc = kTransportSsrc;
+  header.extension.hasAbsoluteSendTime = true;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    header.extension.absoluteSendTime =
+        ToAbsoluteSendTime(packets[i].second.send_time_ms);
+    estimator_->IncomingPacket(packets[i].first,
+                               static_cast<int>(packets[i].second.length),
+                               header);
+  }
+}
+
+void TransportFeedbackAdapter::OnReceiveBitrateChanged(
+    const std::vector<unsigned int>& ssrcs,
+    unsigned int bitrate) {
+  bandwidth_observer_->OnReceivedEstimatedBitrate(bitrate);
+}
+
+void TransportFeedbackAdapter::OnRttUpdate(uint32_t rtt) {
+  estimator_->OnRttUpdate(rtt);
+}
+
+int32_t TransportFeedbackAdapter::TimeUntilNextProcess() {
+  return estimator_->TimeUntilNextProcess();
+}
+
+int32_t TransportFeedbackAdapter::Process() {
+  return estimator_->Process();
+}
+
+}  // namespace webrtc
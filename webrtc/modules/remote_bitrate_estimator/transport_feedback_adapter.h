@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TRANSPORT_FEEDBACK_ADAPTER_H_
+#define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TRANSPORT_FEEDBACK_ADAPTER_H_
+
+#include <deque>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/interface/module.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class Clock;
+class CriticalSectionWrapper;
+
+// Estimates the bandwidth of a transport on the send side, from the arrival
+// times the receiver reports in transport feedback. The packets are numbered
+// when they are sent, and the send times are kept until the feedback about
+// them comes back. The send and arrival times are then handed to the same
+// over-use detector and rate control as a receiver would use for the absolute
+// send time, and the resulting estimate is reported to |bandwidth_observer|
+// like a REMB from the receiver.
+class TransportFeedbackAdapter : public TransportFeedbackObserver,
+                                 public RemoteBitrateObserver,
+                                 public CallStatsObserver,
+                                 public Module {
+ public:
+  TransportFeedbackAdapter(RtcpBandwidthObserver* bandwidth_observer,
+                           Clock* clock,
+                           uint32_t min_bitrate_bps);
+  virtual ~TransportFeedbackAdapter();
+
+  // Implements TransportFeedbackObserver.
+  virtual uint16_t OnSendingPacket(size_t length,
+                                   int64_t send_time_ms) OVERRIDE;
+  virtual void OnReceivedTransportFeedback(
+      const std::vector<PacketArrival>& arrivals) OVERRIDE;
+
+  // Implements RemoteBitrateObserver.
+  virtual void OnReceiveBitrateChanged(const std::vector<unsigned int>& ssrcs,
+                                       unsigned int bitrate) OVERRIDE;
+
+  // Implements CallStatsObserver.
+  virtual void OnRttUpdate(uint32_t rtt) OVERRIDE;
+
+  // Implements Module.
+  virtual int32_t TimeUntilNextProcess() OVERRIDE;
+  virtual int32_t Process() OVERRIDE;
+
+ private:
+  struct SentPacket {
+    SentPacket(int64_t send_time_ms, size_t length)
+        : send_time_ms(send_time_ms), length(length) {}
+    int64_t send_time_ms;
+    size_t length;
+  };
+
+  // The send history is a queue of the packets sent after the one with
+  // |first_sequence_number_|, so that finding a packet only takes an offset.
+  enum { kMaxSendHistory = 10000 };
+
+  RtcpBandwidthObserver* const bandwidth_observer_;
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  std::deque<SentPacket> send_history_;
+  uint16_t first_sequence_number_;
+  uint16_t next_sequence_number_;
+  const scoped_ptr<RemoteBitrateEstimator> estimator_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransportFeedbackAdapter);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TRANSPORT_FEEDBACK_ADAPTER_H_
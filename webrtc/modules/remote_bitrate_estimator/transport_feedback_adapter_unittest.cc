@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/remote_bitrate_estimator/transport_feedback_adapter.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+
+namespace webrtc {
+
+const uint32_t kMinBitrateBps = 30000;
+
+class TestBandwidthObserver : public RtcpBandwidthObserver {
+ public:
+  TestBandwidthObserver() : updated_(false), latest_bitrate_(0) {}
+
+  virtual void OnReceivedEstimatedBitrate(const uint32_t bitrate) OVERRIDE {
+    updated_ = true;
+    latest_bitrate_ = bitrate;
+  }
+
+  virtual void OnReceivedRtcpReceiverReport(
+      const ReportBlockList& report_blocks,
+      uint16_t rtt,
+      int64_t now_ms) OVERRIDE {}
+
+  bool updated() const { return updated_; }
+  uint32_t latest_bitrate() const { return latest_bitrate_; }
+
+ private:
+  bool updated_;
+  uint32_t latest_bitrate_;
+};
+
+class TransportFeedbackAdapterTest : public ::testing::Test {
+ protected:
+  static const size_t kPacketLength = 1000;
+  static const int64_t kPacketIntervalMs = 10;
+
+  TransportFeedbackAdapterTest()
+      : clock_(100000),
+        adapter_(&observer_, &clock_, kMinBitrateBps) {}
+
+  // Sends a packet every |kPacketIntervalMs| for |duration_ms|, and reports
+  // each of them as received |delay_ms| after it was sent, plus
+  // |delay_growth_ms| for each packet before it. Feedback is given every
+  // 100 ms.
+  void SendAndReceive(int64_t duration_ms, int64_t delay_ms,
+                      int64_t delay_growth_ms) {
+    std::vector<PacketArrival> arrivals;
+    for (int64_t t = 0; t < duration_ms; t += kPacketIntervalMs) {
+      const int64_t send_time_ms = clock_.TimeInMilliseconds();
+      const uint16_t sequence_number =
+          adapter_.OnSendingPacket(kPacketLength, send_time_ms);
+      arrivals.push_back(PacketArrival(sequence_number,
+                                       send_time_ms + delay_ms));
+      delay_ms += delay_growth_ms;
+      clock_.AdvanceTimeMilliseconds(kPacketIntervalMs);
+      if (arrivals.size() == 10) {
+        adapter_.OnReceivedTransportFeedback(arrivals);
+        arrivals.clear();
+      }
+      if (adapter_.TimeUntilNextProcess() <= 0)
+        adapter_.Process();
+    }
+  }
+
+  SimulatedClock clock_;
+  TestBandwidthObserver observer_;
+  TransportFeedbackAdapter adapter_;
+};
+
+TEST_F(TransportFeedbackAdapterTest, NumbersPacketsInSendOrder) {
+  EXPECT_EQ(0, adapter_.OnSendingPacket(kPacketLength, 0));
+  EXPECT_EQ(1, adapter_.OnSendingPacket(kPacketLength, 0));
+  EXPECT_EQ(2, adapter_.OnSendingPacket(kPacketLength, 0));
+}
+
+TEST_F(TransportFeedbackAdapterTest, IgnoresFeedbackAboutUnsentPackets) {
+  std::vector<PacketArrival> arrivals;
+  for (uint16_t i = 0; i < 100; ++i)
+    arrivals.push_back(PacketArrival(i, i * kPacketIntervalMs));
+  adapter_.OnReceivedTransportFeedback(arrivals);
+  clock_.AdvanceTimeMilliseconds(1000);
+  adapter_.Process();
+  EXPECT_FALSE(observer_.updated());
+}
+
+TEST_F(TransportFeedbackAdapterTest, EstimatesFromFeedback) {
+  SendAndReceive(5000, 50, 0);
+  ASSERT_TRUE(observer_.updated());
+  EXPECT_GE(observer_.latest_bitrate(), kMinBitrateBps);
+}
+
+TEST_F(TransportFeedbackAdapterTest, GrowingDelayLowersEstimate) {
+  SendAndReceive(5000, 50, 0);
+  ASSERT_TRUE(observer_.updated());
+  const uint32_t steady_bitrate = observer_.latest_bitrate();
+  // The packets queue up: each one arrives 2 ms later than the one before.
+  SendAndReceive(2000, 50, 2);
+  EXPECT_LT(observer_.latest_bitrate(), steady_bitrate);
+}
+
+}  // namespace webrtc
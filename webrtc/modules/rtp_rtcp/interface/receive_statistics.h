@@ -26,6 +26,7 @@ class StreamStatistician {
   virtual ~StreamStatistician();
 
   virtual bool GetStatistics(RtcpStatistics* statistics, bool reset) = 0;
+  // Doesn't block on the thread reporting the packets of the stream.
   virtual void GetDataCounters(uint32_t* bytes_received,
                                uint32_t* packets_received) const = 0;
   virtual uint32_t BitrateReceived() const = 0;
@@ -55,6 +56,19 @@ class ReceiveStatistics : public Module {
                               size_t bytes,
                               bool retransmitted) = 0;
 
+  // Returns the statistician of |ssrc|, creating it if there is none. The
+  // statistician lives as long as this object, so that it can be looked up
+  // once and the packets of its stream be reported with IncomingPacket()
+  // below. Returns NULL if no statistics are kept.
+  virtual StreamStatistician* GetOrCreateStatistician(uint32_t ssrc) = 0;
+
+  // Updates the statistics of |statistician|, which must have been returned
+  // by GetOrCreateStatistician(), with this packet.
+  virtual void IncomingPacket(StreamStatistician* statistician,
+                              const RTPHeader& rtp_header,
+                              size_t bytes,
+                              bool retransmitted) = 0;
+
   // Increment counter for number of FEC packets received.
   virtual void FecPacketReceived(uint32_t ssrc) = 0;
 
@@ -82,6 +96,11 @@ class NullReceiveStatistics : public ReceiveStatistics {
   virtual void IncomingPacket(const RTPHeader& rtp_header,
                               size_t bytes,
                               bool retransmitted) OVERRIDE;
+  virtual StreamStatistician* GetOrCreateStatistician(uint32_t ssrc) OVERRIDE;
+  virtual void IncomingPacket(StreamStatistician* statistician,
+                              const RTPHeader& rtp_header,
+                              size_t bytes,
+                              bool retransmitted) OVERRIDE;
   virtual void FecPacketReceived(uint32_t ssrc) OVERRIDE;
   virtual StatisticianMap GetActiveStatisticians() const OVERRIDE;
   virtual StreamStatistician* GetStatistician(uint32_t ssrc) const OVERRIDE;
@@ -87,6 +87,25 @@ class RTPPayloadRegistry {
                              uint32_t original_ssrc,
                              const RTPHeader& header) const;
 
+  // Same as above, and also derives the header of the restored packet from
+  // |header| into |restored_header|, so that it doesn't have to be parsed.
+  bool RestoreOriginalPacket(uint8_t** restored_packet,
+                             const uint8_t* packet,
+                             int* packet_length,
+                             uint32_t original_ssrc,
+                             const RTPHeader& header,
+                             RTPHeader* restored_header) const;
+
+  // Restores the original packet of the RTX packet |*packet| within its own
+  // buffer. Only the RTP header is moved, onto the RTX header, so the payload
+  // isn't copied. On success |*packet| points to the restored packet, which
+  // ends where the RTX packet did.
+  bool RestoreOriginalPacketInPlace(uint8_t** packet,
+                                    int* packet_length,
+                                    uint32_t original_ssrc,
+                                    const RTPHeader& header,
+                                    RTPHeader* restored_header) const;
+
   bool IsRed(const RTPHeader& header) const;
 
   // Returns true if the media of this RTP packet is encapsulated within an
@@ -146,6 +165,13 @@ class RTPPayloadRegistry {
       const uint32_t rate);
 
   bool IsRtxInternal(const RTPHeader& header) const;
+  // Rewrites the RTP header at |restored_packet|, copied from the RTX packet
+  // of |header|, into the header of the original packet.
+  bool RestoreOriginalHeader(uint8_t* restored_packet,
+                             uint16_t original_sequence_number,
+                             uint32_t original_ssrc,
+                             const RTPHeader& header,
+                             RTPHeader* restored_header) const;
 
   scoped_ptr<CriticalSectionWrapper> crit_sect_;
   RtpUtility::PayloadTypeMap payload_type_map_;
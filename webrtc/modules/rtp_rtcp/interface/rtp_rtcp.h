@@ -53,6 +53,9 @@ class RtpRtcp : public Module {
     *                             streams from the same client.
     *  paced_sender             - Spread any bursts of packets into smaller
     *                             bursts to minimize packet loss.
+    *  transport_feedback_callback - Numbers the outgoing packets of the
+    *                                transport and receives the feedback about
+    *                                their arrival.
     */
     int32_t id;
     bool audio;
@@ -70,6 +73,7 @@ class RtpRtcp : public Module {
     BitrateStatisticsObserver* send_bitrate_observer;
     FrameCountObserver* send_frame_count_observer;
     SendSideDelayObserver* send_side_delay_observer;
+    TransportFeedbackObserver* transport_feedback_callback;
   };
 
   /*
@@ -88,6 +92,13 @@ class RtpRtcp : public Module {
     virtual int32_t IncomingRtcpPacket(const uint8_t* incoming_packet,
                                        uint16_t incoming_packet_length) = 0;
 
+    /*
+    *   Records the arrival of a packet with the transport sequence number
+    *   header extension, to be reported to its sender in transport feedback.
+    */
+    virtual void IncomingTransportSequenceNumber(uint16_t sequence_number,
+                                                 int64_t arrival_time_ms) = 0;
+
     virtual void SetRemoteSSRC(const uint32_t ssrc) = 0;
 
     /**************************************************************************
@@ -606,6 +617,12 @@ class RtpRtcp : public Module {
     // Returns true if the module is configured to store packets.
     virtual bool StorePackets() const = 0;
 
+    // Resends the stored packets of the last key frame and of all frames
+    // since, to let a new receiver start decoding without a new key frame.
+    // Returns the number of bytes resent, or -1 if the last key frame is
+    // older than |max_age_ms| or no longer stored.
+    virtual int32_t ResendLastKeyFrame(int64_t max_age_ms) = 0;
+
     // Called on receipt of RTCP report block from remote side.
     virtual void RegisterSendChannelRtcpStatisticsCallback(
         RtcpStatisticsCallback* callback) = 0;
@@ -13,6 +13,7 @@
 
 #include <stddef.h>
 #include <list>
+#include <vector>
 
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/system_wrappers/interface/clock.h"
@@ -74,7 +75,8 @@ enum RTPExtensionType
    kRtpExtensionNone,
    kRtpExtensionTransmissionTimeOffset,
    kRtpExtensionAudioLevel,
-   kRtpExtensionAbsoluteSendTime
+   kRtpExtensionAbsoluteSendTime,
+   kRtpExtensionTransportSequenceNumber
 };
 
 enum RTCPAppSubTypes
@@ -101,7 +103,8 @@ enum RTCPPacketType
     kRtcpRemb           = 0x10000,
     kRtcpTransmissionTimeOffset = 0x20000,
     kRtcpXrReceiverReferenceTime = 0x40000,
-    kRtcpXrDlrrReportBlock = 0x80000
+    kRtcpXrDlrrReportBlock = 0x80000,
+    kRtcpTransportFeedback = 0x100000
 };
 
 enum KeyFrameRequestMethod
@@ -282,8 +285,16 @@ class RtpAudioFeedback {
 
 class RtcpIntraFrameObserver {
  public:
+  // Called for a FIR, where the receiver needs a decoder refresh point.
   virtual void OnReceivedIntraFrameRequest(uint32_t ssrc) = 0;
 
+  // Called for a PLI. The receiver still has its decoder state, so the
+  // picture may be recovered from a reference it has acknowledged. Handled as
+  // an intra frame request by default.
+  virtual void OnReceivedPictureLoss(uint32_t ssrc) {
+    OnReceivedIntraFrameRequest(ssrc);
+  }
+
   virtual void OnReceivedSLI(uint32_t ssrc,
                              uint8_t picture_id) = 0;
 
@@ -308,6 +319,34 @@ class RtcpBandwidthObserver {
   virtual ~RtcpBandwidthObserver() {}
 };
 
+// The arrival time, in the clock of the remote end, of a packet reported in
+// transport feedback.
+struct PacketArrival {
+  PacketArrival(uint16_t sequence_number, int64_t arrival_time_ms)
+      : sequence_number(sequence_number),
+        arrival_time_ms(arrival_time_ms) {}
+
+  uint16_t sequence_number;
+  int64_t arrival_time_ms;
+};
+
+// Numbers the outgoing packets of a transport and receives the feedback about
+// their arrival. The sequence numbers are shared by all the streams sent over
+// the transport, so that the feedback covers all of them.
+class TransportFeedbackObserver {
+ public:
+  // Returns the transport sequence number to write to a packet of |length|
+  // bytes, sent at |send_time_ms|.
+  virtual uint16_t OnSendingPacket(size_t length, int64_t send_time_ms) = 0;
+
+  // Called with the packets reported as received in a feedback message, in
+  // sequence number order. Lost packets are not reported.
+  virtual void OnReceivedTransportFeedback(
+      const std::vector<PacketArrival>& arrivals) = 0;
+
+  virtual ~TransportFeedbackObserver() {}
+};
+
 class RtcpRttStats {
  public:
   virtual void OnRttUpdate(uint32_t rtt) = 0;
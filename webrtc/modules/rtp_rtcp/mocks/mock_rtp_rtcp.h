@@ -48,6 +48,8 @@ class MockRtpRtcp : public RtpRtcp {
       int32_t());
   MOCK_METHOD2(IncomingRtcpPacket,
       int32_t(const uint8_t* incomingPacket, uint16_t packetLength));
+  MOCK_METHOD2(IncomingTransportSequenceNumber,
+      void(uint16_t sequence_number, int64_t arrival_time_ms));
   MOCK_METHOD1(SetRemoteSSRC, void(const uint32_t ssrc));
   MOCK_METHOD4(IncomingAudioNTP,
       int32_t(const uint32_t audioReceivedNTPsecs,
@@ -221,6 +223,7 @@ class MockRtpRtcp : public RtpRtcp {
   MOCK_METHOD2(SetStorePacketsStatus,
       int32_t(const bool enable, const uint16_t numberToStore));
   MOCK_CONST_METHOD0(StorePackets, bool());
+  MOCK_METHOD1(ResendLastKeyFrame, int32_t(int64_t max_age_ms));
   MOCK_METHOD1(RegisterSendChannelRtcpStatisticsCallback,
                void(RtcpStatisticsCallback*));
   MOCK_METHOD0(GetSendChannelRtcpStatisticsCallback,
@@ -81,7 +81,7 @@ int32_t FecReceiverImpl::AddReceivedRedPacket(
 
   ForwardErrorCorrection::ReceivedPacket* received_packet =
       new ForwardErrorCorrection::ReceivedPacket;
-  received_packet->pkt = new ForwardErrorCorrection::Packet;
+  received_packet->pkt = fec_->AllocatePacket();
 
   // get payload type from RED header
   uint8_t payload_type =
@@ -149,7 +149,7 @@ int32_t FecReceiverImpl::AddReceivedRedPacket(
     received_packet->pkt->length = blockLength;
 
     second_received_packet = new ForwardErrorCorrection::ReceivedPacket;
-    second_received_packet->pkt = new ForwardErrorCorrection::Packet;
+    second_received_packet->pkt = fec_->AllocatePacket();
 
     second_received_packet->is_fec = true;
     second_received_packet->seq_num = header.sequenceNumber;
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+
+namespace webrtc {
+
+void XorBuffer_C(uint8_t* dst, const uint8_t* src, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    dst[i] ^= src[i];
+  }
+}
+
+XorBufferFunction GetXorBufferFunction() {
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  return XorBuffer_SSE2;
+#else
+  // x86 CPU detection required.
+  return WebRtc_GetCPUInfo(kSSE2) ? XorBuffer_SSE2 : XorBuffer_C;
+#endif
+#elif defined(WEBRTC_ARCH_ARM_V7)
+#if defined(WEBRTC_ARCH_ARM_NEON)
+  return XorBuffer_NEON;
+#else
+  // ARM CPU detection required.
+  return (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) ? XorBuffer_NEON
+                                                        : XorBuffer_C;
+#endif
+#else
+  return XorBuffer_C;
+#endif
+}
+
+}  // namespace webrtc
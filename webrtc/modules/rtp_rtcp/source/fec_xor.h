@@ -0,0 +1,38 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// XORs |length| bytes of |src| into |dst|. The buffers must not overlap and
+// have no alignment requirements.
+typedef void (*XorBufferFunction)(uint8_t* dst,
+                                  const uint8_t* src,
+                                  size_t length);
+
+void XorBuffer_C(uint8_t* dst, const uint8_t* src, size_t length);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void XorBuffer_SSE2(uint8_t* dst, const uint8_t* src, size_t length);
+#elif defined(WEBRTC_ARCH_ARM_V7)
+void XorBuffer_NEON(uint8_t* dst, const uint8_t* src, size_t length);
+#endif
+
+// Returns the fastest XOR implementation supported by the CPU.
+XorBufferFunction GetXorBufferFunction();
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
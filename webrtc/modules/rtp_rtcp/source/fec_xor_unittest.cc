@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+#include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+
+namespace {
+
+void RandomizeBuffer(uint8_t* buffer, size_t length) {
+  for (size_t i = 0; i < length; ++i)
+    buffer[i] = rand() & 0xff;
+}
+
+// Compares |xor_buffer| against XorBuffer_C for all lengths up to
+// IP_PACKET_SIZE and a few unaligned offsets.
+void VerifyAgainstC(XorBufferFunction xor_buffer) {
+  uint8_t src[IP_PACKET_SIZE + 16];
+  uint8_t expected[IP_PACKET_SIZE + 16];
+  uint8_t actual[IP_PACKET_SIZE + 16];
+  for (size_t offset = 0; offset < 4; ++offset) {
+    for (size_t length = 0; length <= IP_PACKET_SIZE; ++length) {
+      RandomizeBuffer(src, sizeof(src));
+      RandomizeBuffer(expected, sizeof(expected));
+      memcpy(actual, expected, sizeof(actual));
+      XorBuffer_C(&expected[offset], &src[offset + 1], length);
+      xor_buffer(&actual[offset], &src[offset + 1], length);
+      ASSERT_EQ(0, memcmp(expected, actual, sizeof(actual)))
+          << "offset " << offset << " length " << length;
+    }
+  }
+}
+
+double BenchmarkMicroseconds(XorBufferFunction xor_buffer) {
+  const int kIterations = 200000;
+  uint8_t src[IP_PACKET_SIZE];
+  uint8_t dst[IP_PACKET_SIZE];
+  RandomizeBuffer(src, sizeof(src));
+  RandomizeBuffer(dst, sizeof(dst));
+  TickTime start = TickTime::Now();
+  for (int i = 0; i < kIterations; ++i)
+    xor_buffer(dst, src, sizeof(src));
+  return (TickTime::Now() - start).Microseconds();
+}
+
+}  // namespace
+
+TEST(FecXorTest, CXorsBytes) {
+  uint8_t dst[] = {0x00, 0xff, 0x0f, 0xaa};
+  const uint8_t src[] = {0xff, 0xff, 0xf0, 0x55};
+  XorBuffer_C(dst, src, sizeof(dst));
+  EXPECT_EQ(0xff, dst[0]);
+  EXPECT_EQ(0x00, dst[1]);
+  EXPECT_EQ(0xff, dst[2]);
+  EXPECT_EQ(0xff, dst[3]);
+}
+
+TEST(FecXorTest, DispatchedMatchesC) {
+  VerifyAgainstC(GetXorBufferFunction());
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(FecXorTest, SSE2MatchesC) {
+  if (!WebRtc_GetCPUInfo(kSSE2)) {
+    printf("Skipping SSE2 test, SSE2 not supported.\n");
+    return;
+  }
+  VerifyAgainstC(XorBuffer_SSE2);
+}
+#elif defined(WEBRTC_ARCH_ARM_V7)
+TEST(FecXorTest, NEONMatchesC) {
+  if (!(WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON)) {
+    printf("Skipping NEON test, NEON not supported.\n");
+    return;
+  }
+  VerifyAgainstC(XorBuffer_NEON);
+}
+#endif
+
+// Benchmark comparing the scalar and dispatched XOR kernels on full size
+// packets.
+TEST(FecXorTest, DISABLED_Benchmark) {
+  double c_us = BenchmarkMicroseconds(XorBuffer_C);
+  double optimized_us = BenchmarkMicroseconds(GetXorBufferFunction());
+  printf("XorBuffer_C took %.2fms.\n", c_us / 1000);
+  printf("Dispatched XorBuffer took %.2fms (%.2fx).\n", optimized_us / 1000,
+         c_us / optimized_us);
+}
+
+}  // namespace webrtc
@@ -36,17 +36,82 @@ const uint8_t kUlpHeaderSizeLBitClear = (2 + kMaskSizeLBitClear);
 // Transport header size in bytes. Assume UDP/IPv4 as a reasonable minimum.
 const uint8_t kTransportOverhead = 28;
 
+// Bounds the memory used by the packet mask cache, which is cleared when full.
+const size_t kMaxCachedPacketMasks = 256;
+
 enum {
   kMaxFecPackets = ForwardErrorCorrection::kMaxMediaPackets
 };
 
+// Free list of packets handed out by ForwardErrorCorrection::AllocatePacket().
+// Outstanding packets keep the pool alive after its owner is destroyed; the
+// pool deletes itself when it is detached and the last packet is returned.
+// Like ForwardErrorCorrection, the pool is not thread safe.
+class ForwardErrorCorrection::PacketPool {
+ public:
+  explicit PacketPool(size_t max_free_packets)
+      : max_free_packets_(max_free_packets),
+        num_outstanding_(0),
+        detached_(false) {
+    free_packets_.reserve(max_free_packets);
+  }
+
+  Packet* Allocate() {
+    Packet* packet;
+    if (free_packets_.empty()) {
+      packet = new Packet;
+      packet->pool_ = this;
+    } else {
+      packet = free_packets_.back();
+      free_packets_.pop_back();
+      packet->length = 0;
+    }
+    ++num_outstanding_;
+    return packet;
+  }
+
+  void Return(Packet* packet) {
+    assert(num_outstanding_ > 0);
+    --num_outstanding_;
+    if (!detached_ && free_packets_.size() < max_free_packets_) {
+      free_packets_.push_back(packet);
+      return;
+    }
+    delete packet;
+    if (detached_ && num_outstanding_ == 0)
+      delete this;
+  }
+
+  // Called when the owning ForwardErrorCorrection is destroyed.
+  void Detach() {
+    detached_ = true;
+    for (size_t i = 0; i < free_packets_.size(); ++i)
+      delete free_packets_[i];
+    free_packets_.clear();
+    if (num_outstanding_ == 0)
+      delete this;
+  }
+
+ private:
+  ~PacketPool() {}
+
+  const size_t max_free_packets_;
+  std::vector<Packet*> free_packets_;
+  size_t num_outstanding_;
+  bool detached_;
+};
+
 int32_t ForwardErrorCorrection::Packet::AddRef() { return ++ref_count_; }
 
 int32_t ForwardErrorCorrection::Packet::Release() {
   int32_t ref_count;
   ref_count = --ref_count_;
-  if (ref_count == 0)
-    delete this;
+  if (ref_count == 0) {
+    if (pool_)
+      pool_->Return(this);
+    else
+      delete this;
+  }
   return ref_count;
 }
 
@@ -83,10 +148,21 @@ ForwardErrorCorrection::RecoveredPacket::RecoveredPacket() {}
 ForwardErrorCorrection::RecoveredPacket::~RecoveredPacket() {}
 
 ForwardErrorCorrection::ForwardErrorCorrection()
-    : generated_fec_packets_(kMaxMediaPackets),
+    : xor_buffer_(GetXorBufferFunction()),
+      // Enough to hold the media and FEC packets of a full decoding window.
+      packet_pool_(new PacketPool(2 * kMaxMediaPackets)),
+      generated_fec_packets_(kMaxMediaPackets),
+      packet_mask_(kMaxFecPackets * kMaskSizeLBitSet),
+      tmp_packet_mask_(kMaxFecPackets * kMaskSizeLBitSet),
       fec_packet_received_(false) {}
 
-ForwardErrorCorrection::~ForwardErrorCorrection() {}
+ForwardErrorCorrection::~ForwardErrorCorrection() {
+  packet_pool_->Detach();
+}
+
+ForwardErrorCorrection::Packet* ForwardErrorCorrection::AllocatePacket() {
+  return packet_pool_->Allocate();
+}
 
 // Input packet
 //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -163,15 +239,11 @@ int32_t ForwardErrorCorrection::GenerateFEC(const PacketList& media_packet_list,
     fec_packet_list->push_back(&generated_fec_packets_[i]);
   }
 
-  const internal::PacketMaskTable mask_table(fec_mask_type, num_media_packets);
-
   // -- Generate packet masks --
-  // Always allocate space for a large mask.
-  uint8_t* packet_mask = new uint8_t[num_fec_packets * kMaskSizeLBitSet];
-  memset(packet_mask, 0, num_fec_packets * num_maskBytes);
-  internal::GeneratePacketMasks(num_media_packets, num_fec_packets,
-                                num_important_packets, use_unequal_protection,
-                                mask_table, packet_mask);
+  // |packet_mask_| always has space for a large mask.
+  GetPacketMasks(num_media_packets, num_fec_packets, num_important_packets,
+                 use_unequal_protection, fec_mask_type, num_maskBytes);
+  uint8_t* packet_mask = &packet_mask_[0];
 
   int num_maskBits = InsertZerosInBitMasks(media_packet_list, packet_mask,
                                            num_maskBytes, num_fec_packets);
@@ -179,7 +251,6 @@ int32_t ForwardErrorCorrection::GenerateFEC(const PacketList& media_packet_list,
   l_bit = (num_maskBits > 8 * kMaskSizeLBitClear);
 
   if (num_maskBits < 0) {
-    delete[] packet_mask;
     return -1;
   }
   if (l_bit) {
@@ -189,7 +260,6 @@ int32_t ForwardErrorCorrection::GenerateFEC(const PacketList& media_packet_list,
   GenerateFecBitStrings(media_packet_list, packet_mask, num_fec_packets, l_bit);
   GenerateFecUlpHeaders(media_packet_list, packet_mask, l_bit, num_fec_packets);
 
-  delete[] packet_mask;
   return 0;
 }
 
@@ -263,11 +333,10 @@ void ForwardErrorCorrection::GenerateFecBitStrings(
           generated_fec_packets_[i].data[9] ^= media_payload_length[1];
 
           // XOR with RTP payload, leaving room for the ULP header.
-          for (int32_t j = kFecHeaderSize + ulp_header_size;
-               j < fec_packet_length; j++) {
-            generated_fec_packets_[i].data[j] ^=
-                media_packet->data[j - fec_rtp_offset];
-          }
+          xor_buffer_(
+              &generated_fec_packets_[i].data[kFecHeaderSize + ulp_header_size],
+              &media_packet->data[kRtpHeaderSize],
+              media_packet->length - kRtpHeaderSize);
         }
         if (fec_packet_length > generated_fec_packets_[i].length) {
           generated_fec_packets_[i].length = fec_packet_length;
@@ -290,10 +359,45 @@ void ForwardErrorCorrection::GenerateFecBitStrings(
   }
 }
 
+void ForwardErrorCorrection::GetPacketMasks(int num_media_packets,
+                                            int num_fec_packets,
+                                            int num_important_packets,
+                                            bool use_unequal_protection,
+                                            FecMaskType fec_mask_type,
+                                            int num_mask_bytes) {
+  // The important packets only matter with unequal protection.
+  if (!use_unequal_protection || num_important_packets == 0) {
+    use_unequal_protection = false;
+    num_important_packets = 0;
+  }
+  // Each count is at most kMaxMediaPackets, which fits in 8 bits.
+  const uint32_t key = (static_cast<uint32_t>(num_media_packets) << 24) |
+                       (static_cast<uint32_t>(num_fec_packets) << 16) |
+                       (static_cast<uint32_t>(num_important_packets) << 8) |
+                       (use_unequal_protection ? 0x10 : 0) |
+                       static_cast<uint32_t>(fec_mask_type);
+  const size_t mask_length = num_fec_packets * num_mask_bytes;
+  PacketMaskCache::const_iterator it = packet_mask_cache_.find(key);
+  if (it == packet_mask_cache_.end()) {
+    if (packet_mask_cache_.size() >= kMaxCachedPacketMasks)
+      packet_mask_cache_.clear();
+    std::vector<uint8_t>& masks = packet_mask_cache_[key];
+    masks.resize(mask_length, 0);
+    const internal::PacketMaskTable mask_table(fec_mask_type,
+                                               num_media_packets);
+    internal::GeneratePacketMasks(num_media_packets, num_fec_packets,
+                                  num_important_packets,
+                                  use_unequal_protection, mask_table,
+                                  &masks[0]);
+    it = packet_mask_cache_.find(key);
+  }
+  assert(it->second.size() == mask_length);
+  memcpy(&packet_mask_[0], &it->second[0], mask_length);
+}
+
 int ForwardErrorCorrection::InsertZerosInBitMasks(
     const PacketList& media_packets, uint8_t* packet_mask, int num_mask_bytes,
     int num_fec_packets) {
-  uint8_t* new_mask = NULL;
   if (media_packets.size() <= 1) {
     return media_packets.size();
   }
@@ -312,7 +416,7 @@ int ForwardErrorCorrection::InsertZerosInBitMasks(
   if (media_packets.size() + total_missing_seq_nums > 8 * kMaskSizeLBitClear) {
     new_mask_bytes = kMaskSizeLBitSet;
   }
-  new_mask = new uint8_t[num_fec_packets * kMaskSizeLBitSet];
+  uint8_t* new_mask = &tmp_packet_mask_[0];
   memset(new_mask, 0, num_fec_packets * kMaskSizeLBitSet);
 
   PacketList::const_iterator it = media_packets.begin();
@@ -353,7 +457,6 @@ int ForwardErrorCorrection::InsertZerosInBitMasks(
   }
   // Replace the old mask with the new.
   memcpy(packet_mask, new_mask, kMaskSizeLBitSet * num_fec_packets);
-  delete[] new_mask;
   return new_bit_index;
 }
 
@@ -640,7 +743,7 @@ void ForwardErrorCorrection::InitRecovery(const FecPacket* fec_packet,
   const uint16_t ulp_header_size =
       fec_packet->pkt->data[0] & 0x40 ? kUlpHeaderSizeLBitSet
                                       : kUlpHeaderSizeLBitClear;  // L bit set?
-  recovered->pkt = new Packet;
+  recovered->pkt = AllocatePacket();
   memset(recovered->pkt->data, 0, IP_PACKET_SIZE);
   recovered->returned = false;
   recovered->was_recovered = true;
@@ -693,8 +796,10 @@ void ForwardErrorCorrection::XorPackets(const Packet* src_packet,
 
   // XOR with RTP payload.
   // TODO(marpan/ajm): Are we doing more XORs than required here?
-  for (int32_t i = kRtpHeaderSize; i < src_packet->length; ++i) {
-    dst_packet->pkt->data[i] ^= src_packet->data[i];
+  if (src_packet->length > kRtpHeaderSize) {
+    xor_buffer_(&dst_packet->pkt->data[kRtpHeaderSize],
+                &src_packet->data[kRtpHeaderSize],
+                src_packet->length - kRtpHeaderSize);
   }
 }
 
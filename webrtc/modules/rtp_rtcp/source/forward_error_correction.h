@@ -12,9 +12,11 @@
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_FORWARD_ERROR_CORRECTION_H_
 
 #include <list>
+#include <map>
 #include <vector>
 
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
 #include "webrtc/system_wrappers/interface/ref_count.h"
 #include "webrtc/system_wrappers/interface/scoped_refptr.h"
 #include "webrtc/typedefs.h"
@@ -33,27 +35,32 @@ class ForwardErrorCorrection {
   // Maximum number of media packets we can protect
   static const unsigned int kMaxMediaPackets = 48u;
 
+  class PacketPool;
+
   // TODO(holmer): As a next step all these struct-like packet classes should be
   // refactored into proper classes, and their members should be made private.
   // This will require parts of the functionality in forward_error_correction.cc
   // and receiver_fec.cc to be refactored into the packet classes.
   class Packet {
    public:
-    Packet() : length(0), data(), ref_count_(0) {}
+    Packet() : length(0), data(), ref_count_(0), pool_(NULL) {}
     virtual ~Packet() {}
 
     // Add a reference.
     virtual int32_t AddRef();
 
-    // Release a reference. Will delete the object if the reference count
-    // reaches zero.
+    // Release a reference. Will delete the object, or return it to the pool
+    // it was allocated from, if the reference count reaches zero.
     virtual int32_t Release();
 
     uint16_t length;               // Length of packet in bytes.
     uint8_t data[IP_PACKET_SIZE];  // Packet data.
 
    private:
+    friend class PacketPool;
+
     int32_t ref_count_;  // Counts the number of references to a packet.
+    PacketPool* pool_;   // Pool owning the storage, or NULL.
   };
 
   // TODO(holmer): Refactor into a proper class.
@@ -193,6 +200,11 @@ class ForwardErrorCorrection {
   int32_t DecodeFEC(ReceivedPacketList* received_packet_list,
                     RecoveredPacketList* recovered_packet_list);
 
+  // Returns a packet with |length| 0 and uninitialized |data|, taken from a
+  // pool owned by this instance. The packet is returned to the pool when its
+  // last reference is released, and it may outlive this instance.
+  Packet* AllocatePacket();
+
   // Get the number of FEC packets, given the number of media packets and the
   // protection factor.
   int GetNumberOfFecPackets(int num_media_packets, int protection_factor);
@@ -208,6 +220,19 @@ class ForwardErrorCorrection {
 
  private:
   typedef std::list<FecPacket*> FecPacketList;
+  // Packet masks keyed by the parameters they were generated for.
+  typedef std::map<uint32_t, std::vector<uint8_t> > PacketMaskCache;
+
+  // Copies the packet masks for the given parameters to |packet_mask_|. The
+  // masks are generated from the mask tables the first time they are needed
+  // and then reused, since a stream only uses a small set of frame sizes and
+  // protection factors.
+  void GetPacketMasks(int num_media_packets,
+                      int num_fec_packets,
+                      int num_important_packets,
+                      bool use_unequal_protection,
+                      FecMaskType fec_mask_type,
+                      int num_mask_bytes);
 
   void GenerateFecUlpHeaders(const PacketList& media_packet_list,
                              uint8_t* packet_mask, bool l_bit,
@@ -279,12 +304,12 @@ class ForwardErrorCorrection {
   void AttemptRecover(RecoveredPacketList* recovered_packet_list);
 
   // Initializes the packet recovery using the FEC packet.
-  static void InitRecovery(const FecPacket* fec_packet,
+  void InitRecovery(const FecPacket* fec_packet,
                            RecoveredPacket* recovered);
 
   // Performs XOR between |src_packet| and |dst_packet| and stores the result
   // in |dst_packet|.
-  static void XorPackets(const Packet* src_packet, RecoveredPacket* dst_packet);
+  void XorPackets(const Packet* src_packet, RecoveredPacket* dst_packet);
 
   // Finish up the recovery of a packet.
   static void FinishRecovery(RecoveredPacket* recovered);
@@ -303,7 +328,15 @@ class ForwardErrorCorrection {
   static void DiscardOldPackets(RecoveredPacketList* recovered_packet_list);
   static uint16_t ParseSequenceNumber(uint8_t* packet);
 
+  // XOR kernel selected for this CPU, used for all payload XORs.
+  const XorBufferFunction xor_buffer_;
+  PacketPool* packet_pool_;  // Deletes itself once detached and drained.
   std::vector<Packet> generated_fec_packets_;
+  // Scratch space for the packet masks, sized for kMaxMediaPackets FEC
+  // packets with the L bit set.
+  std::vector<uint8_t> packet_mask_;
+  std::vector<uint8_t> tmp_packet_mask_;
+  PacketMaskCache packet_mask_cache_;
   FecPacketList fec_packet_list_;
   bool fec_packet_received_;
 };
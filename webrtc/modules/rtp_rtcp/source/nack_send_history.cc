@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/nack_send_history.h"
+
+namespace webrtc {
+
+NackSendHistory::NackSendHistory() {}
+
+int NackSendHistory::SelectForSending(const uint16_t* nack_list,
+                                      int size,
+                                      int64_t now_ms,
+                                      int64_t retry_interval_ms,
+                                      int max_to_send,
+                                      uint16_t* to_send) {
+  if (send_times_ms_.empty()) {
+    sequence_numbers_.resize(kHistorySize, 0);
+    send_times_ms_.resize(kHistorySize, -1);
+  }
+  int num_to_send = 0;
+  for (int i = 0; i < size && num_to_send < max_to_send; ++i) {
+    const uint16_t sequence_number = nack_list[i];
+    const int index = sequence_number % kHistorySize;
+    if (sequence_numbers_[index] == sequence_number &&
+        send_times_ms_[index] >= 0 &&
+        now_ms - send_times_ms_[index] < retry_interval_ms) {
+      continue;
+    }
+    sequence_numbers_[index] = sequence_number;
+    send_times_ms_[index] = now_ms;
+    to_send[num_to_send++] = sequence_number;
+  }
+  return num_to_send;
+}
+
+}  // namespace webrtc
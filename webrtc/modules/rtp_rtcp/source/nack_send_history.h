@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_NACK_SEND_HISTORY_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_NACK_SEND_HISTORY_H_
+
+#include <vector>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Remembers when each sequence number was last NACKed, so that a NACK list
+// handed over again and again by the jitter buffer (video) or NetEq (audio)
+// only requests a packet again once the retransmission had time to arrive.
+// The times are kept in a ring indexed by sequence number, so sequence
+// numbers further than kHistorySize behind the newest one NACKed count as
+// never NACKed.
+class NackSendHistory {
+ public:
+  enum { kHistorySize = 1024 };
+
+  NackSendHistory();
+
+  // Copies the sequence numbers of |nack_list| which weren't NACKed in the
+  // last |retry_interval_ms| to |to_send|, at most |max_to_send| of them, and
+  // records them as NACKed at |now_ms|. Returns how many were copied.
+  int SelectForSending(const uint16_t* nack_list,
+                       int size,
+                       int64_t now_ms,
+                       int64_t retry_interval_ms,
+                       int max_to_send,
+                       uint16_t* to_send);
+
+ private:
+  // Allocated on first use, since most modules never send a NACK.
+  std::vector<uint16_t> sequence_numbers_;
+  std::vector<int64_t> send_times_ms_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_NACK_SEND_HISTORY_H_
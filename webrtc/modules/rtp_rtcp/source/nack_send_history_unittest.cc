@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/source/nack_send_history.h"
+
+namespace webrtc {
+
+const int64_t kRetryIntervalMs = 100;
+
+TEST(NackSendHistoryTest, OnlySendsNewSequenceNumbersWithinInterval) {
+  NackSendHistory history;
+  const uint16_t kFirstList[] = {10, 11, 12};
+  uint16_t to_send[10];
+  EXPECT_EQ(3, history.SelectForSending(kFirstList, 3, 1000, kRetryIntervalMs,
+                                        10, to_send));
+
+  const uint16_t kSecondList[] = {10, 12, 13, 14};
+  EXPECT_EQ(2, history.SelectForSending(kSecondList, 4, 1050,
+                                        kRetryIntervalMs, 10, to_send));
+  EXPECT_EQ(13, to_send[0]);
+  EXPECT_EQ(14, to_send[1]);
+}
+
+TEST(NackSendHistoryTest, ResendsAfterInterval) {
+  NackSendHistory history;
+  const uint16_t kList[] = {10, 11};
+  uint16_t to_send[10];
+  EXPECT_EQ(2, history.SelectForSending(kList, 2, 1000, kRetryIntervalMs, 10,
+                                        to_send));
+  EXPECT_EQ(0, history.SelectForSending(kList, 2, 1099, kRetryIntervalMs, 10,
+                                        to_send));
+  EXPECT_EQ(2, history.SelectForSending(kList, 2, 1100, kRetryIntervalMs, 10,
+                                        to_send));
+}
+
+TEST(NackSendHistoryTest, OnlyMarksSentSequenceNumbers) {
+  NackSendHistory history;
+  const uint16_t kList[] = {1, 2, 3, 4, 5};
+  uint16_t to_send[10];
+  EXPECT_EQ(2, history.SelectForSending(kList, 5, 1000, kRetryIntervalMs, 2,
+                                        to_send));
+  EXPECT_EQ(1, to_send[0]);
+  EXPECT_EQ(2, to_send[1]);
+  EXPECT_EQ(3, history.SelectForSending(kList, 5, 1000, kRetryIntervalMs, 10,
+                                        to_send));
+  EXPECT_EQ(3, to_send[0]);
+  EXPECT_EQ(5, to_send[2]);
+}
+
+TEST(NackSendHistoryTest, HandlesWrapAndOverwrittenEntries) {
+  NackSendHistory history;
+  const uint16_t kList[] = {65535, 0};
+  uint16_t to_send[10];
+  EXPECT_EQ(2, history.SelectForSending(kList, 2, 1000, kRetryIntervalMs, 10,
+                                        to_send));
+  // Shares the entry of 0 in the history, replacing it.
+  const uint16_t kFarList[] = {NackSendHistory::kHistorySize};
+  EXPECT_EQ(1, history.SelectForSending(kFarList, 1, 1000, kRetryIntervalMs,
+                                        10, to_send));
+  EXPECT_EQ(1, history.SelectForSending(kList, 2, 1000, kRetryIntervalMs, 10,
+                                        to_send));
+  EXPECT_EQ(0, to_send[0]);
+}
+
+}  // namespace webrtc
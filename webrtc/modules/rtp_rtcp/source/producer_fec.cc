@@ -12,6 +12,7 @@
 
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
+#include "webrtc/system_wrappers/interface/compile_assert.h"
 
 namespace webrtc {
 
@@ -36,49 +37,20 @@ struct RtpPacket {
   ForwardErrorCorrection::Packet* pkt;
 };
 
-RedPacket::RedPacket(int length)
-    : data_(new uint8_t[length]),
-      length_(length),
-      header_length_(0) {
-}
-
-RedPacket::~RedPacket() {
-  delete [] data_;
-}
+const int ProducerFec::kRedHeadroom;
 
-void RedPacket::CreateHeader(const uint8_t* rtp_header, int header_length,
-                             int red_pl_type, int pl_type) {
-  assert(header_length + kREDForFECHeaderLength <= length_);
-  memcpy(data_, rtp_header, header_length);
+// Writes the RTP header with the payload type replaced by |red_pl_type|,
+// followed by the RED header, to |buffer|. |rtp_header| and |buffer| may
+// overlap.
+static void WriteRedHeader(const uint8_t* rtp_header, int header_length,
+                           int red_pl_type, int pl_type, uint8_t* buffer) {
+  memmove(buffer, rtp_header, header_length);
   // Replace payload type.
-  data_[1] &= 0x80;
-  data_[1] += red_pl_type;
+  buffer[1] &= 0x80;
+  buffer[1] += red_pl_type;
   // Add RED header
   // f-bit always 0
-  data_[header_length] = pl_type;
-  header_length_ = header_length + kREDForFECHeaderLength;
-}
-
-void RedPacket::SetSeqNum(int seq_num) {
-  assert(seq_num >= 0 && seq_num < (1<<16));
-  RtpUtility::AssignUWord16ToBuffer(&data_[2], seq_num);
-}
-
-void RedPacket::AssignPayload(const uint8_t* payload, int length) {
-  assert(header_length_ + length <= length_);
-  memcpy(data_ + header_length_, payload, length);
-}
-
-void RedPacket::ClearMarkerBit() {
-  data_[1] &= 0x7F;
-}
-
-uint8_t* RedPacket::data() const {
-  return data_;
-}
-
-int RedPacket::length() const {
-  return length_;
+  buffer[header_length] = pl_type;
 }
 
 ProducerFec::ProducerFec(ForwardErrorCorrection* fec)
@@ -119,17 +91,15 @@ void ProducerFec::SetFecParameters(const FecProtectionParams* params,
   }
 }
 
-RedPacket* ProducerFec::BuildRedPacket(const uint8_t* data_buffer,
-                                       int payload_length,
-                                       int rtp_header_length,
-                                       int red_pl_type) {
-  RedPacket* red_packet = new RedPacket(payload_length +
-                                        kREDForFECHeaderLength +
-                                        rtp_header_length);
+uint8_t* ProducerFec::BuildRedPacketInPlace(uint8_t* data_buffer,
+                                            int rtp_header_length,
+                                            int red_pl_type) {
+  COMPILE_ASSERT(kRedHeadroom == kREDForFECHeaderLength,
+                 red_headroom_must_fit_the_red_header);
+  uint8_t* red_packet = data_buffer - kRedHeadroom;
   int pl_type = data_buffer[1] & 0x7f;
-  red_packet->CreateHeader(data_buffer, rtp_header_length,
-                           red_pl_type, pl_type);
-  red_packet->AssignPayload(data_buffer + rtp_header_length, payload_length);
+  WriteRedHeader(data_buffer, rtp_header_length, red_pl_type, pl_type,
+                 red_packet);
   return red_packet;
 }
 
@@ -144,7 +114,8 @@ int ProducerFec::AddRtpPacketAndGenerateFec(const uint8_t* data_buffer,
   const bool marker_bit = (data_buffer[1] & kRtpMarkerBitMask) ? true : false;
   if (media_packets_fec_.size() < ForwardErrorCorrection::kMaxMediaPackets) {
     // Generic FEC can only protect up to kMaxMediaPackets packets.
-    ForwardErrorCorrection::Packet* packet = new ForwardErrorCorrection::Packet;
+    ForwardErrorCorrection::Packet* packet = fec_->AllocatePacket();
+    packet->AddRef();
     packet->length = payload_length + rtp_header_length;
     memcpy(packet->data, data_buffer, packet->length);
     media_packets_fec_.push_back(packet);
@@ -207,34 +178,35 @@ bool ProducerFec::FecAvailable() const {
   return (fec_packets_.size() > 0);
 }
 
-RedPacket* ProducerFec::GetFecPacket(int red_pl_type,
-                                     int fec_pl_type,
-                                     uint16_t seq_num,
-                                     int rtp_header_length) {
+int ProducerFec::GetFecPacket(int red_pl_type,
+                              int fec_pl_type,
+                              uint16_t seq_num,
+                              int rtp_header_length,
+                              uint8_t* buffer) {
   if (fec_packets_.empty())
-    return NULL;
+    return 0;
   // Build FEC packet. The FEC packets in |fec_packets_| doesn't
   // have RTP headers, so we're reusing the header from the last
   // media packet.
   ForwardErrorCorrection::Packet* packet_to_send = fec_packets_.front();
   ForwardErrorCorrection::Packet* last_media_packet = media_packets_fec_.back();
-  RedPacket* return_packet = new RedPacket(packet_to_send->length +
-                                           kREDForFECHeaderLength +
-                                           rtp_header_length);
-  return_packet->CreateHeader(last_media_packet->data,
-                              rtp_header_length,
-                              red_pl_type,
-                              fec_pl_type);
-  return_packet->SetSeqNum(seq_num);
-  return_packet->ClearMarkerBit();
-  return_packet->AssignPayload(packet_to_send->data, packet_to_send->length);
+  const int length = rtp_header_length + kREDForFECHeaderLength +
+                     packet_to_send->length;
+  assert(length <= IP_PACKET_SIZE);
+  WriteRedHeader(last_media_packet->data, rtp_header_length, red_pl_type,
+                 fec_pl_type, buffer);
+  RtpUtility::AssignUWord16ToBuffer(&buffer[2], seq_num);
+  // Clear the marker bit.
+  buffer[1] &= 0x7F;
+  memcpy(buffer + rtp_header_length + kREDForFECHeaderLength,
+         packet_to_send->data, packet_to_send->length);
   fec_packets_.pop_front();
   if (fec_packets_.empty()) {
     // Done with all the FEC packets. Reset for next run.
     DeletePackets();
     num_frames_ = 0;
   }
-  return return_packet;
+  return length;
 }
 
 int ProducerFec::Overhead() const {
@@ -251,7 +223,7 @@ int ProducerFec::Overhead() const {
 
 void ProducerFec::DeletePackets() {
   while (!media_packets_fec_.empty()) {
-    delete media_packets_fec_.front();
+    media_packets_fec_.front()->Release();
     media_packets_fec_.pop_front();
   }
   assert(media_packets_fec_.empty());
@@ -19,24 +19,6 @@ namespace webrtc {
 
 struct RtpPacket;
 
-class RedPacket {
- public:
-  explicit RedPacket(int length);
-  ~RedPacket();
-  void CreateHeader(const uint8_t* rtp_header, int header_length,
-                    int red_pl_type, int pl_type);
-  void SetSeqNum(int seq_num);
-  void AssignPayload(const uint8_t* payload, int length);
-  void ClearMarkerBit();
-  uint8_t* data() const;
-  int length() const;
-
- private:
-  uint8_t* data_;
-  int length_;
-  int header_length_;
-};
-
 class ProducerFec {
  public:
   explicit ProducerFec(ForwardErrorCorrection* fec);
@@ -45,10 +27,18 @@ class ProducerFec {
   void SetFecParameters(const FecProtectionParams* params,
                         int max_fec_frames);
 
-  RedPacket* BuildRedPacket(const uint8_t* data_buffer,
-                            int payload_length,
-                            int rtp_header_length,
-                            int red_pl_type);
+  // The bytes needed in front of an RTP packet to turn it into a RED packet
+  // in place.
+  static const int kRedHeadroom = 1;
+
+  // Turns the RTP packet at |data_buffer| into a RED packet of |red_pl_type|
+  // in place. The RTP header is moved |kRedHeadroom| bytes to the front, into
+  // headroom reserved by the caller, and the RED header is written after it,
+  // so that the payload isn't moved. Returns the start of the RED packet,
+  // |kRedHeadroom| bytes before |data_buffer|.
+  static uint8_t* BuildRedPacketInPlace(uint8_t* data_buffer,
+                                        int rtp_header_length,
+                                        int red_pl_type);
 
   int AddRtpPacketAndGenerateFec(const uint8_t* data_buffer,
                                  int payload_length,
@@ -60,10 +50,15 @@ class ProducerFec {
 
   bool FecAvailable() const;
 
-  RedPacket* GetFecPacket(int red_pl_type,
-                          int fec_pl_type,
-                          uint16_t seq_num,
-                          int rtp_header_length);
+  // Writes the next FEC packet, as a RED packet with the RTP header of the
+  // last protected media packet, to |buffer|, which must hold
+  // IP_PACKET_SIZE bytes. Returns the length of the packet, or 0 if there is
+  // no FEC packet.
+  int GetFecPacket(int red_pl_type,
+                   int fec_pl_type,
+                   uint16_t seq_num,
+                   int rtp_header_length,
+                   uint8_t* buffer);
 
  private:
   void DeletePackets();
@@ -21,11 +21,10 @@ void VerifyHeader(uint16_t seq_num,
                   uint32_t timestamp,
                   int red_pltype,
                   int fec_pltype,
-                  RedPacket* packet,
+                  const uint8_t* data,
+                  int length,
                   bool marker_bit) {
-  EXPECT_GT(packet->length(), static_cast<int>(kRtpHeaderSize));
-  EXPECT_TRUE(packet->data() != NULL);
-  uint8_t* data = packet->data();
+  EXPECT_GT(length, static_cast<int>(kRtpHeaderSize));
   // Marker bit not set.
   EXPECT_EQ(marker_bit ? 0x80 : 0, data[1] & 0x80);
   EXPECT_EQ(red_pltype, data[1] & 0x7F);
@@ -77,19 +76,20 @@ TEST_F(ProducerFecTest, OneFrameFec) {
   }
   EXPECT_TRUE(producer_->FecAvailable());
   uint16_t seq_num = generator_->NextSeqNum();
-  RedPacket* packet = producer_->GetFecPacket(kRedPayloadType,
-                                              kFecPayloadType,
-                                              seq_num,
-                                              kRtpHeaderSize);
+  uint8_t packet[IP_PACKET_SIZE];
+  const int length = producer_->GetFecPacket(kRedPayloadType,
+                                             kFecPayloadType,
+                                             seq_num,
+                                             kRtpHeaderSize,
+                                             packet);
   EXPECT_FALSE(producer_->FecAvailable());
-  ASSERT_TRUE(packet != NULL);
+  ASSERT_GT(length, 0);
   VerifyHeader(seq_num, last_timestamp,
-               kRedPayloadType, kFecPayloadType, packet, false);
+               kRedPayloadType, kFecPayloadType, packet, length, false);
   while (!rtp_packets.empty()) {
     delete rtp_packets.front();
     rtp_packets.pop_front();
   }
-  delete packet;
 }
 
 TEST_F(ProducerFecTest, TwoFrameFec) {
@@ -120,39 +120,42 @@ TEST_F(ProducerFecTest, TwoFrameFec) {
   }
   EXPECT_TRUE(producer_->FecAvailable());
   uint16_t seq_num = generator_->NextSeqNum();
-  RedPacket* packet = producer_->GetFecPacket(kRedPayloadType,
-                                              kFecPayloadType,
-                                              seq_num,
-                                              kRtpHeaderSize);
+  uint8_t packet[IP_PACKET_SIZE];
+  const int length = producer_->GetFecPacket(kRedPayloadType,
+                                             kFecPayloadType,
+                                             seq_num,
+                                             kRtpHeaderSize,
+                                             packet);
   EXPECT_FALSE(producer_->FecAvailable());
-  EXPECT_TRUE(packet != NULL);
+  ASSERT_GT(length, 0);
   VerifyHeader(seq_num, last_timestamp,
-               kRedPayloadType, kFecPayloadType, packet, false);
+               kRedPayloadType, kFecPayloadType, packet, length, false);
   while (!rtp_packets.empty()) {
     delete rtp_packets.front();
     rtp_packets.pop_front();
   }
-  delete packet;
 }
 
-TEST_F(ProducerFecTest, BuildRedPacket) {
+TEST_F(ProducerFecTest, BuildRedPacketInPlace) {
   generator_->NewFrame(1);
   RtpPacket* packet = generator_->NextPacket(0, 10);
-  RedPacket* red_packet = producer_->BuildRedPacket(packet->data,
-                                                    packet->length -
-                                                    kRtpHeaderSize,
-                                                    kRtpHeaderSize,
-                                                    kRedPayloadType);
-  EXPECT_EQ(packet->length + 1, red_packet->length());
+  uint8_t buffer[ProducerFec::kRedHeadroom + IP_PACKET_SIZE];
+  uint8_t* rtp_packet = buffer + ProducerFec::kRedHeadroom;
+  memcpy(rtp_packet, packet->data, packet->length);
+  uint8_t* red_packet = ProducerFec::BuildRedPacketInPlace(rtp_packet,
+                                                           kRtpHeaderSize,
+                                                           kRedPayloadType);
+  EXPECT_EQ(buffer, red_packet);
   VerifyHeader(packet->header.header.sequenceNumber,
                packet->header.header.timestamp,
                kRedPayloadType,
                packet->header.header.payloadType,
                red_packet,
+               packet->length + 1,
                true);  // Marker bit set.
+  // The payload stays in place.
   for (int i = 0; i < 10; ++i)
-    EXPECT_EQ(i, red_packet->data()[kRtpHeaderSize + 1 + i]);
-  delete red_packet;
+    EXPECT_EQ(i, red_packet[kRtpHeaderSize + 1 + i]);
   delete packet;
 }
 
@@ -64,18 +64,22 @@ void StreamStatisticianImpl::ResetStatistics() {
   received_seq_max_ = 0;
   received_seq_first_ = 0;
   receive_counters_ = StreamDataCounters();
+  // Only changed under |stream_lock_|, so this doesn't race with updates.
+  total_received_bytes_ -= total_received_bytes_.Value();
+  total_received_packets_ -= total_received_packets_.Value();
 }
 
 void StreamStatisticianImpl::IncomingPacket(const RTPHeader& header,
                                             size_t bytes,
                                             bool retransmitted) {
-  UpdateCounters(header, bytes, retransmitted);
-  NotifyRtpCallback();
+  StreamDataCounters counters = UpdateCounters(header, bytes, retransmitted);
+  NotifyRtpCallback(counters, header.ssrc);
 }
 
-void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
-                                            size_t bytes,
-                                            bool retransmitted) {
+StreamDataCounters StreamStatisticianImpl::UpdateCounters(
+    const RTPHeader& header,
+    size_t bytes,
+    bool retransmitted) {
   CriticalSectionScoped cs(stream_lock_.get());
   bool in_order = InOrderPacketInternal(header.sequenceNumber);
   ssrc_ = header.ssrc;
@@ -85,6 +89,8 @@ void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
   receive_counters_.header_bytes += header.headerLength;
   receive_counters_.padding_bytes += header.paddingLength;
   ++receive_counters_.packets;
+  total_received_bytes_ += static_cast<int32_t>(bytes);
+  ++total_received_packets_;
   if (!in_order && retransmitted) {
     ++receive_counters_.retransmitted_packets;
   }
@@ -128,6 +134,7 @@ void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
   // Our measured overhead. Filter from RFC 5104 4.2.1.2:
   // avg_OH (new) = 15/16*avg_OH (old) + 1/16*pckt_OH,
   received_packet_overhead_ = (15 * received_packet_overhead_ + packet_oh) >> 4;
+  return receive_counters_;
 }
 
 void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
@@ -172,15 +179,9 @@ void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
   }
 }
 
-void StreamStatisticianImpl::NotifyRtpCallback() {
-  StreamDataCounters data;
-  uint32_t ssrc;
-  {
-    CriticalSectionScoped cs(stream_lock_.get());
-    data = receive_counters_;
-    ssrc = ssrc_;
-  }
-  rtp_callback_->DataCountersUpdated(data, ssrc);
+void StreamStatisticianImpl::NotifyRtpCallback(
+    const StreamDataCounters& counters, uint32_t ssrc) {
+  rtp_callback_->DataCountersUpdated(counters, ssrc);
 }
 
 void StreamStatisticianImpl::NotifyRtcpCallback() {
@@ -195,11 +196,15 @@ void StreamStatisticianImpl::NotifyRtcpCallback() {
 }
 
 void StreamStatisticianImpl::FecPacketReceived() {
+  StreamDataCounters counters;
+  uint32_t ssrc;
   {
     CriticalSectionScoped cs(stream_lock_.get());
     ++receive_counters_.fec_packets;
+    counters = receive_counters_;
+    ssrc = ssrc_;
   }
-  NotifyRtpCallback();
+  NotifyRtpCallback(counters, ssrc);
 }
 
 void StreamStatisticianImpl::SetMaxReorderingThreshold(
@@ -304,14 +309,10 @@ RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics() {
 
 void StreamStatisticianImpl::GetDataCounters(
     uint32_t* bytes_received, uint32_t* packets_received) const {
-  CriticalSectionScoped cs(stream_lock_.get());
-  if (bytes_received) {
-    *bytes_received = receive_counters_.bytes + receive_counters_.header_bytes +
-                      receive_counters_.padding_bytes;
-  }
-  if (packets_received) {
-    *packets_received = receive_counters_.packets;
-  }
+  if (bytes_received)
+    *bytes_received = static_cast<uint32_t>(total_received_bytes_.Value());
+  if (packets_received)
+    *packets_received = static_cast<uint32_t>(total_received_packets_.Value());
 }
 
 uint32_t StreamStatisticianImpl::BitrateReceived() const {
@@ -408,18 +409,29 @@ ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
 void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
                                            size_t bytes,
                                            bool retransmitted) {
-  StatisticianImplMap::iterator it;
-  {
-    CriticalSectionScoped cs(receive_statistics_lock_.get());
-    it = statisticians_.find(header.ssrc);
-    if (it == statisticians_.end()) {
-      std::pair<StatisticianImplMap::iterator, uint32_t> insert_result =
-          statisticians_.insert(std::make_pair(
-              header.ssrc, new StreamStatisticianImpl(clock_, this, this)));
-      it = insert_result.first;
-    }
+  IncomingPacket(GetOrCreateStatistician(header.ssrc), header, bytes,
+                 retransmitted);
+}
+
+StreamStatistician* ReceiveStatisticsImpl::GetOrCreateStatistician(
+    uint32_t ssrc) {
+  CriticalSectionScoped cs(receive_statistics_lock_.get());
+  StatisticianImplMap::iterator it = statisticians_.find(ssrc);
+  if (it == statisticians_.end()) {
+    it = statisticians_.insert(std::make_pair(
+        ssrc, new StreamStatisticianImpl(clock_, this, this))).first;
   }
-  it->second->IncomingPacket(header, bytes, retransmitted);
+  return it->second;
+}
+
+void ReceiveStatisticsImpl::IncomingPacket(StreamStatistician* statistician,
+                                           const RTPHeader& header,
+                                           size_t bytes,
+                                           bool retransmitted) {
+  // Statisticians are only deleted with this object, so |statistician| can be
+  // used without |receive_statistics_lock_|.
+  static_cast<StreamStatisticianImpl*>(statistician)->IncomingPacket(
+      header, bytes, retransmitted);
 }
 
 void ReceiveStatisticsImpl::FecPacketReceived(uint32_t ssrc) {
@@ -527,6 +539,16 @@ void NullReceiveStatistics::IncomingPacket(const RTPHeader& rtp_header,
                                            size_t bytes,
                                            bool retransmitted) {}
 
+StreamStatistician* NullReceiveStatistics::GetOrCreateStatistician(
+    uint32_t ssrc) {
+  return NULL;
+}
+
+void NullReceiveStatistics::IncomingPacket(StreamStatistician* statistician,
+                                           const RTPHeader& rtp_header,
+                                           size_t bytes,
+                                           bool retransmitted) {}
+
 void NullReceiveStatistics::FecPacketReceived(uint32_t ssrc) {}
 
 StatisticianMap NullReceiveStatistics::GetActiveStatisticians() const {
@@ -16,6 +16,7 @@
 #include <algorithm>
 
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
 
@@ -53,10 +54,12 @@ class StreamStatisticianImpl : public StreamStatistician {
   void UpdateJitter(const RTPHeader& header,
                     uint32_t receive_time_secs,
                     uint32_t receive_time_frac);
-  void UpdateCounters(const RTPHeader& rtp_header,
-                      size_t bytes,
-                      bool retransmitted);
-  void NotifyRtpCallback() LOCKS_EXCLUDED(stream_lock_.get());
+  // Returns the updated counters.
+  StreamDataCounters UpdateCounters(const RTPHeader& rtp_header,
+                                    size_t bytes,
+                                    bool retransmitted);
+  void NotifyRtpCallback(const StreamDataCounters& counters, uint32_t ssrc)
+      LOCKS_EXCLUDED(stream_lock_.get());
   void NotifyRtcpCallback() LOCKS_EXCLUDED(stream_lock_.get());
 
   Clock* clock_;
@@ -82,6 +85,10 @@ class StreamStatisticianImpl : public StreamStatistician {
   // Current counter values.
   uint16_t received_packet_overhead_;
   StreamDataCounters receive_counters_;
+  // Copies of the totals of |receive_counters_|, updated with it under
+  // |stream_lock_| but readable without taking it.
+  mutable Atomic32 total_received_bytes_;
+  mutable Atomic32 total_received_packets_;
 
   // Counter values when we sent the last report.
   uint32_t last_report_inorder_packets_;
@@ -105,6 +112,11 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
   virtual void IncomingPacket(const RTPHeader& header,
                               size_t bytes,
                               bool retransmitted) OVERRIDE;
+  virtual StreamStatistician* GetOrCreateStatistician(uint32_t ssrc) OVERRIDE;
+  virtual void IncomingPacket(StreamStatistician* statistician,
+                              const RTPHeader& header,
+                              size_t bytes,
+                              bool retransmitted) OVERRIDE;
   virtual void FecPacketReceived(uint32_t ssrc) OVERRIDE;
   virtual StatisticianMap GetActiveStatisticians() const OVERRIDE;
   virtual StreamStatistician* GetStatistician(uint32_t ssrc) const OVERRIDE;
@@ -96,6 +96,38 @@ TEST_F(ReceiveStatisticsTest, TwoIncomingSsrcs) {
   EXPECT_EQ(3u, packets_received);
 }
 
+TEST_F(ReceiveStatisticsTest, IncomingPacketsThroughStatistician) {
+  StreamStatistician* statistician =
+      receive_statistics_->GetOrCreateStatistician(kSsrc1);
+  ASSERT_TRUE(statistician != NULL);
+  EXPECT_EQ(statistician, receive_statistics_->GetStatistician(kSsrc1));
+  EXPECT_EQ(statistician,
+            receive_statistics_->GetOrCreateStatistician(kSsrc1));
+  EXPECT_TRUE(receive_statistics_->GetStatistician(kSsrc2) == NULL);
+
+  receive_statistics_->IncomingPacket(statistician, header1_, kPacketSize1,
+                                      false);
+  ++header1_.sequenceNumber;
+  clock_.AdvanceTimeMilliseconds(100);
+  receive_statistics_->IncomingPacket(statistician, header1_, kPacketSize1,
+                                      false);
+  ++header1_.sequenceNumber;
+  // Packets reported by ssrc end up in the same statistician.
+  receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+
+  uint32_t bytes_received = 0;
+  uint32_t packets_received = 0;
+  statistician->GetDataCounters(&bytes_received, &packets_received);
+  EXPECT_EQ(300u, bytes_received);
+  EXPECT_EQ(3u, packets_received);
+  EXPECT_EQ(1u, receive_statistics_->GetActiveStatisticians().size());
+
+  statistician->ResetStatistics();
+  statistician->GetDataCounters(&bytes_received, &packets_received);
+  EXPECT_EQ(0u, bytes_received);
+  EXPECT_EQ(0u, packets_received);
+}
+
 TEST_F(ReceiveStatisticsTest, ActiveStatisticians) {
   receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
   ++header1_.sequenceNumber;
@@ -45,6 +45,7 @@ using webrtc::RTCPUtility::RTCPPacketRTPFBTMMBN;
 using webrtc::RTCPUtility::RTCPPacketRTPFBTMMBNItem;
 using webrtc::RTCPUtility::RTCPPacketRTPFBTMMBR;
 using webrtc::RTCPUtility::RTCPPacketRTPFBTMMBRItem;
+using webrtc::RTCPUtility::RTCPPacketRTPFBTransportFeedback;
 using webrtc::RTCPUtility::RTCPPacketSR;
 using webrtc::RTCPUtility::RTCPPacketXRDLRRReportBlockItem;
 using webrtc::RTCPUtility::RTCPPacketXRReceiverReferenceTimeItem;
@@ -529,6 +530,40 @@ void CreateTmmbn(const RTCPPacketRTPFBTMMBN& tmmbn,
   }
 }
 
+// Transport-wide feedback.
+//
+// FCI:
+//
+//    0                   1                   2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |      base sequence number     |      packet status count      |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                       reference time (ms)                     |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |  recv delta   |  recv delta   |  recv delta   |  ...          |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+void CreateTransportFeedback(const RTCPPacketRTPFBTransportFeedback& feedback,
+                             const std::vector<int8_t>& deltas,
+                             size_t length,
+                             uint8_t* buffer,
+                             size_t* pos) {
+  const uint8_t kFmt = 15;
+  CreateHeader(kFmt, PT_RTPFB, length, buffer, pos);
+  AssignUWord32(buffer, pos, feedback.SenderSSRC);
+  AssignUWord32(buffer, pos, feedback.MediaSSRC);
+  AssignUWord16(buffer, pos, feedback.BaseSequenceNumber);
+  AssignUWord16(buffer, pos, feedback.PacketStatusCount);
+  AssignUWord32(buffer, pos, feedback.ReferenceTimeMs);
+  for (size_t i = 0; i < deltas.size(); ++i) {
+    AssignUWord8(buffer, pos, static_cast<uint8_t>(deltas[i]));
+  }
+  for (size_t i = deltas.size(); i % 4 != 0; ++i) {
+    AssignUWord8(buffer, pos, 0);
+  }
+}
+
 // Receiver Estimated Max Bitrate (REMB) (draft-alvestrand-rmcat-remb).
 //
 //    0                   1                   2                   3
@@ -1020,6 +1055,46 @@ void Tmmbn::Create(uint8_t* packet, size_t* length, size_t max_length) const {
               length);
 }
 
+bool TransportFeedback::WithReceivedPacket(uint16_t sequence_number,
+                                           int64_t arrival_time_ms) {
+  if (deltas_.empty()) {
+    feedback_.BaseSequenceNumber = sequence_number;
+    feedback_.ReferenceTimeMs = static_cast<uint32_t>(arrival_time_ms);
+    feedback_.PacketStatusCount = 1;
+    deltas_.push_back(0);
+    last_arrival_time_ms_ = arrival_time_ms;
+    return true;
+  }
+  const uint16_t next_sequence_number =
+      feedback_.BaseSequenceNumber + feedback_.PacketStatusCount;
+  const uint16_t missing = sequence_number - next_sequence_number;
+  if (missing >= kMaxPacketStatusCount - deltas_.size())
+    return false;
+  const int64_t delta_ms = arrival_time_ms - last_arrival_time_ms_;
+  if (delta_ms <= RTCPUtility::kTransportFeedbackNotReceived ||
+      delta_ms > 127) {
+    return false;
+  }
+  deltas_.insert(deltas_.end(), missing,
+                 RTCPUtility::kTransportFeedbackNotReceived);
+  deltas_.push_back(static_cast<int8_t>(delta_ms));
+  feedback_.PacketStatusCount = static_cast<uint16_t>(deltas_.size());
+  last_arrival_time_ms_ = arrival_time_ms;
+  return true;
+}
+
+void TransportFeedback::Create(uint8_t* packet,
+                               size_t* length,
+                               size_t max_length) const {
+  assert(!deltas_.empty());
+  if (*length + BlockLength() > max_length) {
+    LOG(LS_WARNING) << "Max packet size reached.";
+    return;
+  }
+  CreateTransportFeedback(feedback_, deltas_,
+                          BlockToHeaderLength(BlockLength()), packet, length);
+}
+
 void Xr::Create(uint8_t* packet, size_t* length, size_t max_length) const {
   if (*length + BlockLength() > max_length) {
     LOG(LS_WARNING) << "Max packet size reached.";
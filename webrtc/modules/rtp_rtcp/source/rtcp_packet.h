@@ -798,6 +798,77 @@ class Tmmbn : public RtcpPacket {
   DISALLOW_COPY_AND_ASSIGN(Tmmbn);
 };
 
+// Transport-wide feedback, reporting the arrival times of the packets of all
+// the streams of a transport by their transport sequence number.
+//
+//    0                   1                   2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |V=2|P| FMT=15  |   PT=205      |             length            |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                  SSRC of packet sender                        |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                  SSRC of media source                         |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |      base sequence number     |      packet status count      |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                       reference time (ms)                     |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |  recv delta   |  recv delta   |  recv delta   |  ...          |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+// There is one receive delta for each of the |packet status count| packets
+// starting at the base sequence number. It is the arrival time in ms relative
+// to the previous received packet, or to the reference time for the first
+// one, as a signed byte. Packets that haven't been received have the delta
+// -128. The deltas are padded with zeros to a 32-bit boundary.
+
+class TransportFeedback : public RtcpPacket {
+ public:
+  TransportFeedback()
+      : RtcpPacket(),
+        last_arrival_time_ms_(0) {
+    memset(&feedback_, 0, sizeof(feedback_));
+  }
+
+  virtual ~TransportFeedback() {}
+
+  void From(uint32_t ssrc) {
+    feedback_.SenderSSRC = ssrc;
+  }
+  void To(uint32_t ssrc) {
+    feedback_.MediaSSRC = ssrc;
+  }
+
+  // Adds a packet that arrived at |arrival_time_ms|. The packets between it
+  // and the previously added packet are reported as not received. Returns
+  // false if the packet doesn't fit in this message, because it comes before
+  // the previous packet, the message is full or its arrival time is too far
+  // from that of the previous packet.
+  bool WithReceivedPacket(uint16_t sequence_number, int64_t arrival_time_ms);
+
+  bool Empty() const { return deltas_.empty(); }
+
+ protected:
+  virtual void Create(
+      uint8_t* packet, size_t* length, size_t max_length) const OVERRIDE;
+
+ private:
+  enum { kMaxPacketStatusCount = 1024 };
+
+  size_t BlockLength() const {
+    const size_t kFciHeaderLength = 8;
+    return kCommonFbFmtLength + kFciHeaderLength +
+        (deltas_.size() + 3) / 4 * 4;
+  }
+
+  RTCPUtility::RTCPPacketRTPFBTransportFeedback feedback_;
+  std::vector<int8_t> deltas_;
+  int64_t last_arrival_time_ms_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransportFeedback);
+};
+
 // Receiver Estimated Max Bitrate (REMB) (draft-alvestrand-rmcat-remb).
 //
 //    0                   1                   2                   3
@@ -35,6 +35,7 @@ using webrtc::rtcp::Rrtr;
 using webrtc::rtcp::SenderReport;
 using webrtc::rtcp::Tmmbn;
 using webrtc::rtcp::Tmmbr;
+using webrtc::rtcp::TransportFeedback;
 using webrtc::rtcp::VoipMetric;
 using webrtc::rtcp::Xr;
 using webrtc::test::RtcpPacketParser;
@@ -619,6 +620,35 @@ TEST(RtcpPacketTest, Remb) {
   EXPECT_EQ(kRemoteSsrc + 2, ssrcs[2]);
 }
 
+TEST(RtcpPacketTest, TransportFeedback) {
+  TransportFeedback feedback;
+  feedback.From(kSenderSsrc);
+  feedback.To(kRemoteSsrc);
+  EXPECT_TRUE(feedback.Empty());
+  EXPECT_TRUE(feedback.WithReceivedPacket(100, 5000));
+  EXPECT_TRUE(feedback.WithReceivedPacket(103, 5127));
+  EXPECT_FALSE(feedback.Empty());
+
+  // Header, SSRCs, FCI and 4 deltas.
+  RawPacket packet = feedback.Build();
+  EXPECT_EQ(24u, packet.buffer_length());
+}
+
+TEST(RtcpPacketTest, TransportFeedbackRejectsUnreportablePackets) {
+  TransportFeedback feedback;
+  feedback.From(kSenderSsrc);
+  feedback.To(kRemoteSsrc);
+  EXPECT_TRUE(feedback.WithReceivedPacket(100, 5000));
+  // Reordered.
+  EXPECT_FALSE(feedback.WithReceivedPacket(99, 5001));
+  // The delta doesn't fit in 8 bits.
+  EXPECT_FALSE(feedback.WithReceivedPacket(101, 5128));
+  EXPECT_FALSE(feedback.WithReceivedPacket(101, 5000 - 128));
+  EXPECT_TRUE(feedback.WithReceivedPacket(101, 5000 - 127));
+  // Too many statuses for one message.
+  EXPECT_FALSE(feedback.WithReceivedPacket(100 + 1024, 5000));
+}
+
 TEST(RtcpPacketTest, Tmmbr) {
   Tmmbr tmmbr;
   tmmbr.From(kSenderSsrc);
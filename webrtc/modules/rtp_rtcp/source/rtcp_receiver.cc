@@ -41,6 +41,7 @@ RTCPReceiver::RTCPReceiver(const int32_t id, Clock* clock,
     _cbRtcpFeedback(NULL),
     _cbRtcpBandwidthObserver(NULL),
     _cbRtcpIntraFrameObserver(NULL),
+    transport_feedback_observer_(NULL),
     _criticalSectionRTCPReceiver(
         CriticalSectionWrapper::CreateCriticalSection()),
     main_ssrc_(0),
@@ -51,7 +52,9 @@ RTCPReceiver::RTCPReceiver(const int32_t id, Clock* clock,
     _lastReceivedXRNTPsecs(0),
     _lastReceivedXRNTPfrac(0),
     xr_rr_rtt_ms_(0),
+    _receivedReportBlocks(),
     _receivedInfoMap(),
+    _receivedCnames(),
     _packetTimeOutMS(0),
     _lastReceivedRrMs(0),
     _lastIncreasedSequenceNumberMs(0),
@@ -63,24 +66,12 @@ RTCPReceiver::~RTCPReceiver() {
   delete _criticalSectionRTCPReceiver;
   delete _criticalSectionFeedbacks;
 
-  while (!_receivedReportBlockMap.empty()) {
-    std::map<uint32_t, RTCPReportBlockInformation*>::iterator first =
-        _receivedReportBlockMap.begin();
-    delete first->second;
-    _receivedReportBlockMap.erase(first);
-  }
   while (!_receivedInfoMap.empty()) {
     std::map<uint32_t, RTCPReceiveInformation*>::iterator first =
         _receivedInfoMap.begin();
     delete first->second;
     _receivedInfoMap.erase(first);
   }
-  while (!_receivedCnameMap.empty()) {
-    std::map<uint32_t, RTCPCnameInformation*>::iterator first =
-        _receivedCnameMap.begin();
-    delete first->second;
-    _receivedCnameMap.erase(first);
-  }
 }
 
 void
@@ -146,11 +137,13 @@ uint32_t RTCPReceiver::RemoteSSRC() const {
 void RTCPReceiver::RegisterRtcpObservers(
     RtcpIntraFrameObserver* intra_frame_callback,
     RtcpBandwidthObserver* bandwidth_callback,
-    RtcpFeedback* feedback_callback) {
+    RtcpFeedback* feedback_callback,
+    TransportFeedbackObserver* transport_feedback_callback) {
   CriticalSectionScoped lock(_criticalSectionFeedbacks);
   _cbRtcpIntraFrameObserver = intra_frame_callback;
   _cbRtcpBandwidthObserver = bandwidth_callback;
   _cbRtcpFeedback = feedback_callback;
+  transport_feedback_observer_ = transport_feedback_callback;
 }
 
 void RTCPReceiver::SetSsrcs(uint32_t main_ssrc,
@@ -295,12 +288,11 @@ int32_t RTCPReceiver::StatisticsReceived(
   assert(receiveBlocks);
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
 
-  std::map<uint32_t, RTCPReportBlockInformation*>::const_iterator it =
-      _receivedReportBlockMap.begin();
-
-  while (it != _receivedReportBlockMap.end()) {
-    receiveBlocks->push_back(it->second->remoteReceiveBlock);
-    it++;
+  const std::vector<ReportBlockTable::Entry>& entries =
+      _receivedReportBlocks.entries();
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (entries[i].used)
+      receiveBlocks->push_back(entries[i].value.remoteReceiveBlock);
   }
   return 0;
 }
@@ -315,6 +307,11 @@ int32_t
 RTCPReceiver::IncomingRTCPPacket(RTCPPacketInformation& rtcpPacketInformation,
                                  RTCPUtility::RTCPParserV2* rtcpParser)
 {
+    // The send times are looked up before taking the receiver lock, so that
+    // the whole packet is handled under a single acquisition of it.
+    ReportSendTimes send_times;
+    LookUpReportSendTimes(rtcpParser, &send_times);
+
     CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
 
     _lastReceived = _clock->TimeInMilliseconds();
@@ -328,7 +325,8 @@ RTCPReceiver::IncomingRTCPPacket(RTCPPacketInformation& rtcpPacketInformation,
         {
         case RTCPUtility::kRtcpSrCode:
         case RTCPUtility::kRtcpRrCode:
-            HandleSenderReceiverReport(*rtcpParser, rtcpPacketInformation);
+            HandleSenderReceiverReport(*rtcpParser, rtcpPacketInformation,
+                                       send_times);
             break;
         case RTCPUtility::kRtcpSdesCode:
             HandleSDES(*rtcpParser);
@@ -340,7 +338,8 @@ RTCPReceiver::IncomingRTCPPacket(RTCPPacketInformation& rtcpPacketInformation,
             HandleXrReceiveReferenceTime(*rtcpParser, rtcpPacketInformation);
             break;
         case RTCPUtility::kRtcpXrDlrrReportBlockCode:
-            HandleXrDlrrReportBlock(*rtcpParser, rtcpPacketInformation);
+            HandleXrDlrrReportBlock(*rtcpParser, rtcpPacketInformation,
+                                    send_times);
             break;
         case RTCPUtility::kRtcpXrVoipMetricCode:
             HandleXRVOIPMetric(*rtcpParser, rtcpPacketInformation);
@@ -360,6 +359,9 @@ RTCPReceiver::IncomingRTCPPacket(RTCPPacketInformation& rtcpPacketInformation,
         case RTCPUtility::kRtcpRtpfbSrReqCode:
             HandleSR_REQ(*rtcpParser, rtcpPacketInformation);
             break;
+        case RTCPUtility::kRtcpRtpfbTransportFeedbackCode:
+            HandleTransportFeedback(*rtcpParser, rtcpPacketInformation);
+            break;
         case RTCPUtility::kRtcpPsfbPliCode:
             HandlePLI(*rtcpParser, rtcpPacketInformation);
             break;
@@ -395,10 +397,40 @@ RTCPReceiver::IncomingRTCPPacket(RTCPPacketInformation& rtcpPacketInformation,
     return 0;
 }
 
+void RTCPReceiver::LookUpReportSendTimes(RTCPUtility::RTCPParserV2* rtcpParser,
+                                         ReportSendTimes* send_times) {
+  int64_t send_time_ms;
+  RTCPUtility::RTCPPacketTypes packet_type = rtcpParser->Begin();
+  while (packet_type != RTCPUtility::kRtcpNotValidCode) {
+    const RTCPUtility::RTCPPacket& packet = rtcpParser->Packet();
+    if (packet_type == RTCPUtility::kRtcpReportBlockItemCode) {
+      const uint32_t last_sr = packet.ReportBlockItem.LastSR;
+      if (last_sr != 0 &&
+          !send_times->Find(ReportSendTimes::kSenderReport, last_sr,
+                            &send_time_ms)) {
+        uint32_t send_time = _rtpRtcp.SendTimeOfSendReport(last_sr);
+        send_times->Add(ReportSendTimes::kSenderReport, last_sr,
+                        send_time > 0 ? send_time : -1);
+      }
+    } else if (packet_type == RTCPUtility::kRtcpXrDlrrReportBlockItemCode) {
+      const uint32_t last_rr = packet.XRDLRRReportBlockItem.LastRR;
+      if (!send_times->Find(ReportSendTimes::kXrReceiverReport, last_rr,
+                            &send_time_ms)) {
+        if (!_rtpRtcp.SendTimeOfXrRrReport(last_rr, &send_time_ms))
+          send_time_ms = -1;
+        send_times->Add(ReportSendTimes::kXrReceiverReport, last_rr,
+                        send_time_ms);
+      }
+    }
+    packet_type = rtcpParser->Iterate();
+  }
+}
+
 // no need for critsect we have _criticalSectionRTCPReceiver
 void
 RTCPReceiver::HandleSenderReceiverReport(RTCPUtility::RTCPParserV2& rtcpParser,
-                                         RTCPPacketInformation& rtcpPacketInformation)
+                                         RTCPPacketInformation& rtcpPacketInformation,
+                                         const ReportSendTimes& send_times)
 {
     RTCPUtility::RTCPPacketTypes rtcpPacketType = rtcpParser.PacketType();
     const RTCPUtility::RTCPPacket& rtcpPacket   = rtcpParser.Packet();
@@ -468,7 +500,8 @@ RTCPReceiver::HandleSenderReceiverReport(RTCPUtility::RTCPParserV2& rtcpParser,
 
     while (rtcpPacketType == RTCPUtility::kRtcpReportBlockItemCode)
     {
-        HandleReportBlock(rtcpPacket, rtcpPacketInformation, remoteSSRC, numberOfReportBlocks);
+        HandleReportBlock(rtcpPacket, rtcpPacketInformation, remoteSSRC,
+                          numberOfReportBlocks, send_times);
         rtcpPacketType = rtcpParser.Iterate();
     }
 }
@@ -478,7 +511,8 @@ void RTCPReceiver::HandleReportBlock(
     const RTCPUtility::RTCPPacket& rtcpPacket,
     RTCPPacketInformation& rtcpPacketInformation,
     const uint32_t remoteSSRC,
-    const uint8_t numberOfReportBlocks)
+    const uint8_t numberOfReportBlocks,
+    const ReportSendTimes& send_times)
     EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver) {
   // This will be called once per report block in the RTCP packet.
   // We filter out all report blocks that are not for us.
@@ -496,12 +530,13 @@ void RTCPReceiver::HandleReportBlock(
     return;
   }
 
-  // To avoid problem with acquiring _criticalSectionRTCPSender while holding
-  // _criticalSectionRTCPReceiver.
-  _criticalSectionRTCPReceiver->Leave();
-  uint32_t sendTimeMS =
-      _rtpRtcp.SendTimeOfSendReport(rtcpPacket.ReportBlockItem.LastSR);
-  _criticalSectionRTCPReceiver->Enter();
+  // Without an SR to refer to, or if the SR was not looked up because the
+  // table was full, there is no RTT to compute.
+  int64_t send_time_ms = -1;
+  if (rtcpPacket.ReportBlockItem.LastSR != 0) {
+    send_times.Find(ReportSendTimes::kSenderReport,
+                    rtcpPacket.ReportBlockItem.LastSR, &send_time_ms);
+  }
 
   RTCPReportBlockInformation* reportBlock =
       CreateReportBlockInformation(remoteSSRC);
@@ -554,8 +589,8 @@ void RTCPReceiver::HandleReportBlock(
 
   int32_t RTT = 0;
 
-  if (sendTimeMS > 0) {
-    RTT = receiveTimeMS - d - sendTimeMS;
+  if (send_time_ms > 0) {
+    RTT = receiveTimeMS - d - static_cast<uint32_t>(send_time_ms);
     if (RTT <= 0) {
       RTT = 1;
     }
@@ -593,61 +628,23 @@ void RTCPReceiver::HandleReportBlock(
 
 RTCPReportBlockInformation*
 RTCPReceiver::CreateReportBlockInformation(uint32_t remoteSSRC) {
-  CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
-
-  std::map<uint32_t, RTCPReportBlockInformation*>::iterator it =
-      _receivedReportBlockMap.find(remoteSSRC);
-
-  RTCPReportBlockInformation* ptrReportBlockInfo = NULL;
-  if (it != _receivedReportBlockMap.end()) {
-    ptrReportBlockInfo = it->second;
-  } else {
-    ptrReportBlockInfo = new RTCPReportBlockInformation;
-    _receivedReportBlockMap[remoteSSRC] = ptrReportBlockInfo;
-  }
-  return ptrReportBlockInfo;
+  return _receivedReportBlocks.Insert(remoteSSRC);
 }
 
 RTCPReportBlockInformation*
 RTCPReceiver::GetReportBlockInformation(uint32_t remoteSSRC) const {
-  CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
-
-  std::map<uint32_t, RTCPReportBlockInformation*>::const_iterator it =
-      _receivedReportBlockMap.find(remoteSSRC);
-
-  if (it == _receivedReportBlockMap.end()) {
-    return NULL;
-  }
-  return it->second;
+  return const_cast<RTCPReportBlockInformation*>(
+      _receivedReportBlocks.Find(remoteSSRC));
 }
 
 RTCPCnameInformation*
 RTCPReceiver::CreateCnameInformation(uint32_t remoteSSRC) {
-  CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
-
-  std::map<uint32_t, RTCPCnameInformation*>::iterator it =
-      _receivedCnameMap.find(remoteSSRC);
-
-  if (it != _receivedCnameMap.end()) {
-    return it->second;
-  }
-  RTCPCnameInformation* cnameInfo = new RTCPCnameInformation;
-  memset(cnameInfo->name, 0, RTCP_CNAME_SIZE);
-  _receivedCnameMap[remoteSSRC] = cnameInfo;
-  return cnameInfo;
+  return _receivedCnames.Insert(remoteSSRC);
 }
 
 RTCPCnameInformation*
 RTCPReceiver::GetCnameInformation(uint32_t remoteSSRC) const {
-  CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
-
-  std::map<uint32_t, RTCPCnameInformation*>::const_iterator it =
-      _receivedCnameMap.find(remoteSSRC);
-
-  if (it == _receivedCnameMap.end()) {
-    return NULL;
-  }
-  return it->second;
+  return const_cast<RTCPCnameInformation*>(_receivedCnames.Find(remoteSSRC));
 }
 
 RTCPReceiveInformation*
@@ -865,14 +862,7 @@ void RTCPReceiver::HandleBYE(RTCPUtility::RTCPParserV2& rtcpParser) {
 
   // clear our lists
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
-  std::map<uint32_t, RTCPReportBlockInformation*>::iterator
-      reportBlockInfoIt = _receivedReportBlockMap.find(
-          rtcpPacket.BYE.SenderSSRC);
-
-  if (reportBlockInfoIt != _receivedReportBlockMap.end()) {
-    delete reportBlockInfoIt->second;
-    _receivedReportBlockMap.erase(reportBlockInfoIt);
-  }
+  _receivedReportBlocks.Erase(rtcpPacket.BYE.SenderSSRC);
   //  we can't delete it due to TMMBR
   std::map<uint32_t, RTCPReceiveInformation*>::iterator receiveInfoIt =
       _receivedInfoMap.find(rtcpPacket.BYE.SenderSSRC);
@@ -881,13 +871,7 @@ void RTCPReceiver::HandleBYE(RTCPUtility::RTCPParserV2& rtcpParser) {
     receiveInfoIt->second->readyForDelete = true;
   }
 
-  std::map<uint32_t, RTCPCnameInformation*>::iterator cnameInfoIt =
-      _receivedCnameMap.find(rtcpPacket.BYE.SenderSSRC);
-
-  if (cnameInfoIt != _receivedCnameMap.end()) {
-    delete cnameInfoIt->second;
-    _receivedCnameMap.erase(cnameInfoIt);
-  }
+  _receivedCnames.Erase(rtcpPacket.BYE.SenderSSRC);
   xr_rr_rtt_ms_ = 0;
   rtcpParser.Iterate();
 }
@@ -923,20 +907,22 @@ void RTCPReceiver::HandleXrReceiveReferenceTime(
 
 void RTCPReceiver::HandleXrDlrrReportBlock(
     RTCPUtility::RTCPParserV2& parser,
-    RTCPPacketInformation& rtcpPacketInformation) {
+    RTCPPacketInformation& rtcpPacketInformation,
+    const ReportSendTimes& send_times) {
   const RTCPUtility::RTCPPacket& packet = parser.Packet();
   // Iterate through sub-block(s), if any.
   RTCPUtility::RTCPPacketTypes packet_type = parser.Iterate();
 
   while (packet_type == RTCPUtility::kRtcpXrDlrrReportBlockItemCode) {
-    HandleXrDlrrReportBlockItem(packet, rtcpPacketInformation);
+    HandleXrDlrrReportBlockItem(packet, rtcpPacketInformation, send_times);
     packet_type = parser.Iterate();
   }
 }
 
 void RTCPReceiver::HandleXrDlrrReportBlockItem(
     const RTCPUtility::RTCPPacket& packet,
-    RTCPPacketInformation& rtcpPacketInformation)
+    RTCPPacketInformation& rtcpPacketInformation,
+    const ReportSendTimes& send_times)
     EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver) {
   if (registered_ssrcs_.find(packet.XRDLRRReportBlockItem.SSRC) ==
       registered_ssrcs_.end()) {
@@ -946,17 +932,10 @@ void RTCPReceiver::HandleXrDlrrReportBlockItem(
 
   rtcpPacketInformation.xr_dlrr_item = true;
 
-  // To avoid problem with acquiring _criticalSectionRTCPSender while holding
-  // _criticalSectionRTCPReceiver.
-  _criticalSectionRTCPReceiver->Leave();
-
-  int64_t send_time_ms;
-  bool found = _rtpRtcp.SendTimeOfXrRrReport(
-      packet.XRDLRRReportBlockItem.LastRR, &send_time_ms);
-
-  _criticalSectionRTCPReceiver->Enter();
-
-  if (!found) {
+  int64_t send_time_ms = -1;
+  send_times.Find(ReportSendTimes::kXrReceiverReport,
+                  packet.XRDLRRReportBlockItem.LastRR, &send_time_ms);
+  if (send_time_ms < 0) {
     return;
   }
 
@@ -1134,6 +1113,34 @@ RTCPReceiver::HandleSR_REQ(RTCPUtility::RTCPParserV2& rtcpParser,
     rtcpParser.Iterate();
 }
 
+// no need for critsect we have _criticalSectionRTCPReceiver
+void RTCPReceiver::HandleTransportFeedback(
+    RTCPUtility::RTCPParserV2& rtcpParser,
+    RTCPPacketInformation& rtcpPacketInformation) {
+  const RTCPUtility::RTCPPacket& rtcpPacket = rtcpParser.Packet();
+  if (main_ssrc_ != rtcpPacket.TransportFeedback.MediaSSRC) {
+    // Not to us.
+    rtcpParser.Iterate();
+    return;
+  }
+  // The arrival times are rebuilt from the deltas, in the clock of the
+  // receiver of our packets.
+  uint16_t sequence_number = rtcpPacket.TransportFeedback.BaseSequenceNumber;
+  int64_t arrival_time_ms = rtcpPacket.TransportFeedback.ReferenceTimeMs;
+  RTCPUtility::RTCPPacketTypes pktType = rtcpParser.Iterate();
+  while (pktType == RTCPUtility::kRtcpRtpfbTransportFeedbackItemCode) {
+    const int8_t delta = rtcpPacket.TransportFeedbackItem.ReceiveDelta;
+    if (delta != RTCPUtility::kTransportFeedbackNotReceived) {
+      arrival_time_ms += delta;
+      rtcpPacketInformation.transport_feedback_arrivals.push_back(
+          PacketArrival(sequence_number, arrival_time_ms));
+    }
+    ++sequence_number;
+    pktType = rtcpParser.Iterate();
+  }
+  rtcpPacketInformation.rtcpPacketTypeFlags |= kRtcpTransportFeedback;
+}
+
 // no need for critsect we have _criticalSectionRTCPReceiver
 void
 RTCPReceiver::HandleTMMBNItem(RTCPReceiveInformation& receiveInfo,
@@ -1402,16 +1409,16 @@ void RTCPReceiver::TriggerCallbacksFromRTCPPacket(
     // report can generate several RTCP packets, based on number relayed/mixed
     // a send report block should go out to all receivers.
     if (_cbRtcpIntraFrameObserver) {
-      if ((rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpPli) ||
-          (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpFir)) {
-        if (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpPli) {
-          LOG(LS_VERBOSE) << "Incoming PLI from SSRC "
-                       << rtcpPacketInformation.remoteSSRC;
-        } else {
-          LOG(LS_VERBOSE) << "Incoming FIR from SSRC "
-                       << rtcpPacketInformation.remoteSSRC;
-        }
+      // A FIR takes precedence, the key frame it asks for also repairs the
+      // picture loss.
+      if (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpFir) {
+        LOG(LS_VERBOSE) << "Incoming FIR from SSRC "
+                     << rtcpPacketInformation.remoteSSRC;
         _cbRtcpIntraFrameObserver->OnReceivedIntraFrameRequest(local_ssrc);
+      } else if (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpPli) {
+        LOG(LS_VERBOSE) << "Incoming PLI from SSRC "
+                     << rtcpPacketInformation.remoteSSRC;
+        _cbRtcpIntraFrameObserver->OnReceivedPictureLoss(local_ssrc);
       }
       if (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpSli) {
         _cbRtcpIntraFrameObserver->OnReceivedSLI(
@@ -1438,6 +1445,12 @@ void RTCPReceiver::TriggerCallbacksFromRTCPPacket(
             now);
       }
     }
+    if (transport_feedback_observer_ &&
+        (rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpTransportFeedback) &&
+        !rtcpPacketInformation.transport_feedback_arrivals.empty()) {
+      transport_feedback_observer_->OnReceivedTransportFeedback(
+          rtcpPacketInformation.transport_feedback_arrivals);
+    }
     if(_cbRtcpFeedback) {
       if(!(rtcpPacketInformation.rtcpPacketTypeFlags & kRtcpSr)) {
         _cbRtcpFeedback->OnReceiveReportReceived(_id,
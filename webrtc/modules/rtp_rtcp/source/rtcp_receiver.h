@@ -20,6 +20,7 @@
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/modules/rtp_rtcp/source/tmmbr_help.h"
+#include "webrtc/system_wrappers/interface/thread_annotations.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -50,7 +51,8 @@ public:
 
     void RegisterRtcpObservers(RtcpIntraFrameObserver* intra_frame_callback,
                                RtcpBandwidthObserver* bandwidth_callback,
-                               RtcpFeedback* feedback_callback);
+                               RtcpFeedback* feedback_callback,
+                               TransportFeedbackObserver* transport_feedback_callback);
 
     int32_t IncomingRTCPPacket(
         RTCPHelp::RTCPPacketInformation& rtcpPacketInformation,
@@ -115,24 +117,42 @@ public:
     RtcpStatisticsCallback* GetRtcpStatisticsCallback();
 
 protected:
-    RTCPHelp::RTCPReportBlockInformation* CreateReportBlockInformation(const uint32_t remoteSSRC);
-    RTCPHelp::RTCPReportBlockInformation* GetReportBlockInformation(const uint32_t remoteSSRC) const;
-
-    RTCPUtility::RTCPCnameInformation* CreateCnameInformation(const uint32_t remoteSSRC);
-    RTCPUtility::RTCPCnameInformation* GetCnameInformation(const uint32_t remoteSSRC) const;
+    // The returned pointers are valid until the next Create*() call, and
+    // only as long as _criticalSectionRTCPReceiver is held.
+    RTCPHelp::RTCPReportBlockInformation* CreateReportBlockInformation(
+        const uint32_t remoteSSRC)
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
+    RTCPHelp::RTCPReportBlockInformation* GetReportBlockInformation(
+        const uint32_t remoteSSRC) const
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
+
+    RTCPUtility::RTCPCnameInformation* CreateCnameInformation(
+        const uint32_t remoteSSRC)
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
+    RTCPUtility::RTCPCnameInformation* GetCnameInformation(
+        const uint32_t remoteSSRC) const
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
 
     RTCPHelp::RTCPReceiveInformation* CreateReceiveInformation(const uint32_t remoteSSRC);
     RTCPHelp::RTCPReceiveInformation* GetReceiveInformation(const uint32_t remoteSSRC);
 
     void UpdateReceiveInformation( RTCPHelp::RTCPReceiveInformation& receiveInformation);
 
+    // Looks up the send times of the SRs and XR RRs referred to by the packet
+    // in |rtcpParser|. Must be called without holding
+    // _criticalSectionRTCPReceiver, since it takes the RTCP sender lock.
+    void LookUpReportSendTimes(RTCPUtility::RTCPParserV2* rtcpParser,
+                               RTCPHelp::ReportSendTimes* send_times);
+
     void HandleSenderReceiverReport(RTCPUtility::RTCPParserV2& rtcpParser,
-                                    RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
+                                    RTCPHelp::RTCPPacketInformation& rtcpPacketInformation,
+                                    const RTCPHelp::ReportSendTimes& send_times);
 
     void HandleReportBlock(const RTCPUtility::RTCPPacket& rtcpPacket,
                            RTCPHelp::RTCPPacketInformation& rtcpPacketInformation,
                            const uint32_t remoteSSRC,
-                           const uint8_t numberOfReportBlocks);
+                           const uint8_t numberOfReportBlocks,
+                           const RTCPHelp::ReportSendTimes& send_times);
 
     void HandleSDES(RTCPUtility::RTCPParserV2& rtcpParser);
 
@@ -147,11 +167,13 @@ protected:
 
     void HandleXrDlrrReportBlock(
         RTCPUtility::RTCPParserV2& parser,
-        RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
+        RTCPHelp::RTCPPacketInformation& rtcpPacketInformation,
+        const RTCPHelp::ReportSendTimes& send_times);
 
     void HandleXrDlrrReportBlockItem(
         const RTCPUtility::RTCPPacket& packet,
-        RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
+        RTCPHelp::RTCPPacketInformation& rtcpPacketInformation,
+        const RTCPHelp::ReportSendTimes& send_times);
 
     void HandleXRVOIPMetric(RTCPUtility::RTCPParserV2& rtcpParser,
                             RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
@@ -205,6 +227,10 @@ protected:
     void HandleTMMBNItem(RTCPHelp::RTCPReceiveInformation& receiveInfo,
                          const RTCPUtility::RTCPPacket& rtcpPacket);
 
+    void HandleTransportFeedback(
+        RTCPUtility::RTCPParserV2& rtcpParser,
+        RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
+
     void HandleFIR(RTCPUtility::RTCPParserV2& rtcpParser,
                    RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
 
@@ -221,6 +247,8 @@ protected:
  private:
   typedef std::map<uint32_t, RTCPHelp::RTCPReceiveInformation*>
       ReceivedInfoMap;
+  typedef RTCPHelp::SsrcTable<RTCPHelp::RTCPReportBlockInformation>
+      ReportBlockTable;
   int32_t           _id;
   Clock*                  _clock;
   RTCPMethod              _method;
@@ -231,6 +259,7 @@ protected:
   RtcpFeedback*           _cbRtcpFeedback;
   RtcpBandwidthObserver*  _cbRtcpBandwidthObserver;
   RtcpIntraFrameObserver* _cbRtcpIntraFrameObserver;
+  TransportFeedbackObserver* transport_feedback_observer_;
 
   CriticalSectionWrapper* _criticalSectionRTCPReceiver;
   uint32_t          main_ssrc_;
@@ -252,11 +281,9 @@ protected:
   uint16_t xr_rr_rtt_ms_;
 
   // Received report blocks.
-  std::map<uint32_t, RTCPHelp::RTCPReportBlockInformation*>
-      _receivedReportBlockMap;
+  ReportBlockTable _receivedReportBlocks;
   ReceivedInfoMap _receivedInfoMap;
-  std::map<uint32_t, RTCPUtility::RTCPCnameInformation*>
-      _receivedCnameMap;
+  RTCPHelp::SsrcTable<RTCPUtility::RTCPCnameInformation> _receivedCnames;
 
   uint32_t            _packetTimeOutMS;
 
@@ -100,6 +100,28 @@ RTCPPacketInformation::AddReportInfo(
   report_blocks.push_back(report_block_info.remoteReceiveBlock);
 }
 
+bool ReportSendTimes::Find(Report report,
+                           uint32_t id,
+                           int64_t* send_time_ms) const {
+  for (size_t i = 0; i < size_; ++i) {
+    if (entries_[i].report == report && entries_[i].id == id) {
+      *send_time_ms = entries_[i].send_time_ms;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReportSendTimes::Add(Report report, uint32_t id, int64_t send_time_ms) {
+  if (size_ == kMaxReports)
+    return false;
+  entries_[size_].report = report;
+  entries_[size_].id = id;
+  entries_[size_].send_time_ms = send_time_ms;
+  ++size_;
+  return true;
+}
+
 RTCPReportBlockInformation::RTCPReportBlockInformation():
     remoteReceiveBlock(),
     remoteMaxJitter(0),
@@ -12,6 +12,8 @@
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_RECEIVER_HELP_H_
 
 
+#include <vector>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"  // RTCPReportBlock
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
@@ -23,6 +25,144 @@ namespace webrtc {
 namespace RTCPHelp
 {
 
+// A table from SSRC to T, stored by value in one flat array with linear
+// probing. Looking up and adding an SSRC doesn't allocate, except when the
+// table grows, which it does when it gets half full. Insert() and Erase()
+// invalidate the pointers to the values.
+template <typename T>
+class SsrcTable {
+ public:
+  struct Entry {
+    Entry() : used(false), ssrc(0), value() {}
+    bool used;
+    uint32_t ssrc;
+    T value;
+  };
+
+  SsrcTable() : size_(0) {}
+
+  T* Find(uint32_t ssrc) {
+    if (entries_.empty())
+      return NULL;
+    for (size_t i = Slot(ssrc); entries_[i].used; i = Next(i)) {
+      if (entries_[i].ssrc == ssrc)
+        return &entries_[i].value;
+    }
+    return NULL;
+  }
+  const T* Find(uint32_t ssrc) const {
+    return const_cast<SsrcTable*>(this)->Find(ssrc);
+  }
+
+  // Returns the value of |ssrc|, adding a default constructed one if the
+  // table doesn't have it.
+  T* Insert(uint32_t ssrc) {
+    T* value = Find(ssrc);
+    if (value)
+      return value;
+    if (2 * (size_ + 1) > entries_.size())
+      Grow();
+    size_t i = Slot(ssrc);
+    while (entries_[i].used)
+      i = Next(i);
+    entries_[i].used = true;
+    entries_[i].ssrc = ssrc;
+    entries_[i].value = T();
+    ++size_;
+    return &entries_[i].value;
+  }
+
+  bool Erase(uint32_t ssrc) {
+    if (!Find(ssrc))
+      return false;
+    size_t i = Slot(ssrc);
+    while (entries_[i].ssrc != ssrc)
+      i = Next(i);
+    // Move the entries after the erased one back, so that none of them is
+    // separated from its slot by a free entry.
+    for (size_t j = Next(i); entries_[j].used; j = Next(j)) {
+      const size_t slot = Slot(entries_[j].ssrc);
+      // Move |j| to |i| unless its slot is cyclically in (i, j].
+      const bool keep = (i < j) ? (i < slot && slot <= j)
+                                : (i < slot || slot <= j);
+      if (!keep) {
+        entries_[i] = entries_[j];
+        i = j;
+      }
+    }
+    entries_[i] = Entry();
+    --size_;
+    return true;
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // All the entries of the table. The free ones have |used| false.
+  const std::vector<Entry>& entries() const { return entries_; }
+
+ private:
+  enum { kMinCapacity = 8 };
+
+  size_t Slot(uint32_t ssrc) const {
+    // The capacity is a power of two. Mix the high bits of the product into
+    // the low ones that select the slot.
+    const uint32_t hash = ssrc * 2654435769u;
+    return static_cast<size_t>(hash ^ (hash >> 16)) & (entries_.size() - 1);
+  }
+  size_t Next(size_t i) const { return (i + 1) & (entries_.size() - 1); }
+
+  void Grow() {
+    std::vector<Entry> old_entries(
+        entries_.empty() ? static_cast<size_t>(kMinCapacity)
+                         : 2 * entries_.size());
+    old_entries.swap(entries_);
+    for (size_t i = 0; i < old_entries.size(); ++i) {
+      if (!old_entries[i].used)
+        continue;
+      size_t j = Slot(old_entries[i].ssrc);
+      while (entries_[j].used)
+        j = Next(j);
+      entries_[j] = old_entries[i];
+    }
+  }
+
+  std::vector<Entry> entries_;
+  size_t size_;
+};
+
+// The send times of our own SRs and XR RRs that the report blocks and DLRR
+// items of one RTCP packet refer to. They are looked up in the RTCP sender
+// before the packet is handled, so that the receiver lock is taken once for
+// the whole packet. Holds up to kMaxReports lookups, without allocating.
+class ReportSendTimes {
+ public:
+  enum Report { kSenderReport, kXrReceiverReport };
+  enum { kMaxReports = 64 };
+
+  ReportSendTimes() : size_(0) {}
+
+  // Returns true if the send time of |report| with |id| was looked up, in
+  // which case |*send_time_ms| is set to it, or to -1 if it wasn't found.
+  bool Find(Report report, uint32_t id, int64_t* send_time_ms) const;
+
+  // Adds a looked up send time, -1 if not found. Returns false if there is no
+  // room for it.
+  bool Add(Report report, uint32_t id, int64_t send_time_ms);
+
+ private:
+  struct Entry {
+    Report report;
+    uint32_t id;
+    int64_t send_time_ms;
+  };
+
+  Entry entries_[kMaxReports];
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReportSendTimes);
+};
+
 class RTCPReportBlockInformation
 {
 public:
@@ -82,6 +222,7 @@ public:
 
     uint32_t xr_originator_ssrc;
     bool xr_dlrr_item;
+    std::vector<PacketArrival> transport_feedback_arrivals;
     RTCPVoIPMetric*  VoIPMetric;
 
 private:
@@ -12,6 +12,8 @@
 /*
  * This file includes unit tests for the RTCPReceiver.
  */
+#include <map>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -25,6 +27,8 @@
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_impl.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 
+using ::testing::_;
+
 namespace webrtc {
 
 namespace {  // Anonymous namespace; hide utility functions and classes.
@@ -59,6 +63,15 @@ class TestTransport : public Transport,
   RTCPReceiver* rtcp_receiver_;
 };
 
+class MockRtcpIntraFrameObserver : public RtcpIntraFrameObserver {
+ public:
+  MOCK_METHOD1(OnReceivedIntraFrameRequest, void(uint32_t ssrc));
+  MOCK_METHOD1(OnReceivedPictureLoss, void(uint32_t ssrc));
+  MOCK_METHOD2(OnReceivedSLI, void(uint32_t ssrc, uint8_t picture_id));
+  MOCK_METHOD2(OnReceivedRPSI, void(uint32_t ssrc, uint64_t picture_id));
+  MOCK_METHOD2(OnLocalSsrcChanged, void(uint32_t old_ssrc, uint32_t new_ssrc));
+};
+
 class RtcpReceiverTest : public ::testing::Test {
  protected:
   static const uint32_t kRemoteBitrateEstimatorMinBitrateBps = 30000;
@@ -123,6 +136,8 @@ class RtcpReceiverTest : public ::testing::Test {
     rtcp_packet_info_.ntp_frac = rtcpPacketInformation.ntp_frac;
     rtcp_packet_info_.rtp_timestamp = rtcpPacketInformation.rtp_timestamp;
     rtcp_packet_info_.xr_dlrr_item = rtcpPacketInformation.xr_dlrr_item;
+    rtcp_packet_info_.transport_feedback_arrivals =
+        rtcpPacketInformation.transport_feedback_arrivals;
     if (rtcpPacketInformation.VoIPMetric) {
       rtcp_packet_info_.AddVoIPMetric(rtcpPacketInformation.VoIPMetric);
     }
@@ -140,6 +155,49 @@ class RtcpReceiverTest : public ::testing::Test {
 };
 
 
+TEST(SsrcTableTest, FindsInsertedValues) {
+  RTCPHelp::SsrcTable<int> table;
+  EXPECT_TRUE(table.Find(1) == NULL);
+  EXPECT_FALSE(table.Erase(1));
+  for (uint32_t ssrc = 0; ssrc < 100; ++ssrc)
+    *table.Insert(ssrc * 0x10001) = static_cast<int>(ssrc);
+  EXPECT_EQ(100u, table.size());
+  for (uint32_t ssrc = 0; ssrc < 100; ++ssrc) {
+    ASSERT_TRUE(table.Find(ssrc * 0x10001) != NULL);
+    EXPECT_EQ(static_cast<int>(ssrc), *table.Find(ssrc * 0x10001));
+  }
+  // Inserting an SSRC again returns the existing value.
+  EXPECT_EQ(7, *table.Insert(7 * 0x10001));
+  EXPECT_EQ(100u, table.size());
+}
+
+TEST(SsrcTableTest, ErasesWithoutLosingOtherValues) {
+  RTCPHelp::SsrcTable<uint32_t> table;
+  std::map<uint32_t, uint32_t> reference;
+  uint32_t ssrc = 12345;
+  for (int i = 0; i < 2000; ++i) {
+    // A simple LCG, so that SSRCs are both added and erased again.
+    ssrc = ssrc * 1664525u + 1013904223u;
+    const uint32_t key = ssrc % 200;
+    if (ssrc & 0x10000) {
+      *table.Insert(key) = ssrc;
+      reference[key] = ssrc;
+    } else {
+      EXPECT_EQ(reference.erase(key) == 1, table.Erase(key));
+    }
+    ASSERT_EQ(reference.size(), table.size());
+  }
+  for (uint32_t key = 0; key < 200; ++key) {
+    std::map<uint32_t, uint32_t>::const_iterator it = reference.find(key);
+    if (it == reference.end()) {
+      EXPECT_TRUE(table.Find(key) == NULL);
+    } else {
+      ASSERT_TRUE(table.Find(key) != NULL);
+      EXPECT_EQ(it->second, *table.Find(key));
+    }
+  }
+}
+
 TEST_F(RtcpReceiverTest, BrokenPacketIsIgnored) {
   const uint8_t bad_packet[] = {0, 0, 0, 0};
   EXPECT_EQ(0, InjectRtcpPacket(bad_packet, sizeof(bad_packet)));
@@ -159,6 +217,54 @@ TEST_F(RtcpReceiverTest, InjectSrPacket) {
             kRtcpSr & rtcp_packet_info_.rtcpPacketTypeFlags);
 }
 
+TEST_F(RtcpReceiverTest, InjectTransportFeedback) {
+  const uint32_t kSenderSsrc = 0x10203;
+  const uint32_t kSourceSsrc = 0x123456;
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kSourceSsrc);
+  rtcp_receiver_->SetSsrcs(kSourceSsrc, ssrcs);
+
+  rtcp::TransportFeedback feedback;
+  feedback.From(kSenderSsrc);
+  feedback.To(kSourceSsrc);
+  EXPECT_TRUE(feedback.WithReceivedPacket(0xfffe, 1000));
+  EXPECT_TRUE(feedback.WithReceivedPacket(0xffff, 1010));
+  // Sequence number 0 is lost.
+  EXPECT_TRUE(feedback.WithReceivedPacket(1, 1005));
+  rtcp::RawPacket p = feedback.Build();
+  EXPECT_EQ(0, InjectRtcpPacket(p.buffer(), p.buffer_length()));
+  EXPECT_EQ(kRtcpTransportFeedback, rtcp_packet_info_.rtcpPacketTypeFlags);
+  ASSERT_EQ(3u, rtcp_packet_info_.transport_feedback_arrivals.size());
+  EXPECT_EQ(0xfffe,
+            rtcp_packet_info_.transport_feedback_arrivals[0].sequence_number);
+  EXPECT_EQ(1000,
+            rtcp_packet_info_.transport_feedback_arrivals[0].arrival_time_ms);
+  EXPECT_EQ(0xffff,
+            rtcp_packet_info_.transport_feedback_arrivals[1].sequence_number);
+  EXPECT_EQ(1010,
+            rtcp_packet_info_.transport_feedback_arrivals[1].arrival_time_ms);
+  EXPECT_EQ(1,
+            rtcp_packet_info_.transport_feedback_arrivals[2].sequence_number);
+  EXPECT_EQ(1005,
+            rtcp_packet_info_.transport_feedback_arrivals[2].arrival_time_ms);
+}
+
+TEST_F(RtcpReceiverTest, TransportFeedbackToOtherSsrcIgnored) {
+  const uint32_t kSourceSsrc = 0x123456;
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kSourceSsrc);
+  rtcp_receiver_->SetSsrcs(kSourceSsrc, ssrcs);
+
+  rtcp::TransportFeedback feedback;
+  feedback.From(0x10203);
+  feedback.To(kSourceSsrc + 1);
+  EXPECT_TRUE(feedback.WithReceivedPacket(0, 1000));
+  rtcp::RawPacket p = feedback.Build();
+  EXPECT_EQ(0, InjectRtcpPacket(p.buffer(), p.buffer_length()));
+  EXPECT_EQ(0U, rtcp_packet_info_.rtcpPacketTypeFlags);
+  EXPECT_TRUE(rtcp_packet_info_.transport_feedback_arrivals.empty());
+}
+
 TEST_F(RtcpReceiverTest, XrPacketWithZeroReportBlocksIgnored) {
   rtcp::Xr xr;
   xr.From(0x2345);
@@ -446,6 +552,37 @@ TEST_F(RtcpReceiverTest, TmmbrReceivedWithNoIncomingPacket) {
   EXPECT_EQ(-1, rtcp_receiver_->TMMBRReceived(0, 0, NULL));
 }
 
+TEST(ReportSendTimesTest, FindsAddedSendTimes) {
+  RTCPHelp::ReportSendTimes send_times;
+  int64_t send_time_ms = 0;
+  EXPECT_FALSE(send_times.Find(RTCPHelp::ReportSendTimes::kSenderReport, 1,
+                               &send_time_ms));
+  EXPECT_TRUE(send_times.Add(RTCPHelp::ReportSendTimes::kSenderReport, 1, 10));
+  EXPECT_TRUE(
+      send_times.Add(RTCPHelp::ReportSendTimes::kXrReceiverReport, 1, -1));
+  EXPECT_TRUE(send_times.Find(RTCPHelp::ReportSendTimes::kSenderReport, 1,
+                              &send_time_ms));
+  EXPECT_EQ(10, send_time_ms);
+  // The same id of another kind of report is a separate entry.
+  EXPECT_TRUE(send_times.Find(RTCPHelp::ReportSendTimes::kXrReceiverReport, 1,
+                              &send_time_ms));
+  EXPECT_EQ(-1, send_time_ms);
+}
+
+TEST(ReportSendTimesTest, RejectsSendTimesWhenFull) {
+  RTCPHelp::ReportSendTimes send_times;
+  for (uint32_t id = 0; id < RTCPHelp::ReportSendTimes::kMaxReports; ++id) {
+    EXPECT_TRUE(send_times.Add(RTCPHelp::ReportSendTimes::kSenderReport, id,
+                               id));
+  }
+  EXPECT_FALSE(send_times.Add(RTCPHelp::ReportSendTimes::kSenderReport,
+                              RTCPHelp::ReportSendTimes::kMaxReports, 0));
+  int64_t send_time_ms = 0;
+  EXPECT_FALSE(send_times.Find(RTCPHelp::ReportSendTimes::kSenderReport,
+                               RTCPHelp::ReportSendTimes::kMaxReports,
+                               &send_time_ms));
+}
+
 TEST_F(RtcpReceiverTest, TwoReportBlocks) {
   const uint32_t kSenderSsrc = 0x10203;
   const uint32_t kSourceSsrcs[] = {0x40506, 0x50607};
@@ -677,6 +814,84 @@ TEST_F(RtcpReceiverTest, Callbacks) {
                                kCumulativeLoss, kJitter));
 }
 
+TEST_F(RtcpReceiverTest, PliIsReportedAsPictureLoss) {
+  const uint32_t kMediaFlowSsrc = 0x2040608;
+  const uint32_t kSenderSsrc = 0x10203;
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kMediaFlowSsrc);
+  rtcp_receiver_->SetSsrcs(kMediaFlowSsrc, ssrcs);
+  MockRtcpIntraFrameObserver observer;
+  rtcp_receiver_->RegisterRtcpObservers(&observer, NULL, NULL, NULL);
+
+  rtcp::Pli pli;
+  pli.From(kSenderSsrc);
+  pli.To(kMediaFlowSsrc);
+  rtcp::ReceiverReport rr;
+  rr.From(kSenderSsrc);
+  rr.Append(&pli);
+  rtcp::RawPacket p = rr.Build();
+
+  EXPECT_CALL(observer, OnReceivedPictureLoss(kMediaFlowSsrc)).Times(1);
+  EXPECT_CALL(observer, OnReceivedIntraFrameRequest(_)).Times(0);
+  EXPECT_EQ(0, InjectRtcpPacket(p.buffer(), p.buffer_length()));
+  EXPECT_TRUE(rtcp_packet_info_.rtcpPacketTypeFlags & kRtcpPli);
+  rtcp_receiver_->RegisterRtcpObservers(NULL, NULL, NULL, NULL);
+}
+
+TEST_F(RtcpReceiverTest, FirIsReportedAsIntraFrameRequest) {
+  const uint32_t kMediaFlowSsrc = 0x2040608;
+  const uint32_t kSenderSsrc = 0x10203;
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kMediaFlowSsrc);
+  rtcp_receiver_->SetSsrcs(kMediaFlowSsrc, ssrcs);
+  MockRtcpIntraFrameObserver observer;
+  rtcp_receiver_->RegisterRtcpObservers(&observer, NULL, NULL, NULL);
+
+  rtcp::Fir fir;
+  fir.From(kSenderSsrc);
+  fir.To(kMediaFlowSsrc);
+  fir.WithCommandSeqNum(1);
+  rtcp::ReceiverReport rr;
+  rr.From(kSenderSsrc);
+  rr.Append(&fir);
+  rtcp::RawPacket p = rr.Build();
+
+  EXPECT_CALL(observer, OnReceivedIntraFrameRequest(kMediaFlowSsrc)).Times(1);
+  EXPECT_CALL(observer, OnReceivedPictureLoss(_)).Times(0);
+  EXPECT_EQ(0, InjectRtcpPacket(p.buffer(), p.buffer_length()));
+  EXPECT_TRUE(rtcp_packet_info_.rtcpPacketTypeFlags & kRtcpFir);
+  rtcp_receiver_->RegisterRtcpObservers(NULL, NULL, NULL, NULL);
+}
+
+// A FIR and a PLI in the same compound packet only give a key frame request.
+TEST_F(RtcpReceiverTest, FirTakesPrecedenceOverPli) {
+  const uint32_t kMediaFlowSsrc = 0x2040608;
+  const uint32_t kSenderSsrc = 0x10203;
+  std::set<uint32_t> ssrcs;
+  ssrcs.insert(kMediaFlowSsrc);
+  rtcp_receiver_->SetSsrcs(kMediaFlowSsrc, ssrcs);
+  MockRtcpIntraFrameObserver observer;
+  rtcp_receiver_->RegisterRtcpObservers(&observer, NULL, NULL, NULL);
+
+  rtcp::Pli pli;
+  pli.From(kSenderSsrc);
+  pli.To(kMediaFlowSsrc);
+  rtcp::Fir fir;
+  fir.From(kSenderSsrc);
+  fir.To(kMediaFlowSsrc);
+  fir.WithCommandSeqNum(1);
+  rtcp::ReceiverReport rr;
+  rr.From(kSenderSsrc);
+  rr.Append(&pli);
+  rr.Append(&fir);
+  rtcp::RawPacket p = rr.Build();
+
+  EXPECT_CALL(observer, OnReceivedIntraFrameRequest(kMediaFlowSsrc)).Times(1);
+  EXPECT_CALL(observer, OnReceivedPictureLoss(_)).Times(0);
+  EXPECT_EQ(0, InjectRtcpPacket(p.buffer(), p.buffer_length()));
+  rtcp_receiver_->RegisterRtcpObservers(NULL, NULL, NULL, NULL);
+}
+
 }  // Anonymous namespace
 
 }  // namespace webrtc
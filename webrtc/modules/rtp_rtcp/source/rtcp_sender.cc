@@ -17,6 +17,7 @@
 #include <algorithm>  // min
 
 #include "webrtc/common_types.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_impl.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
@@ -26,6 +27,12 @@ namespace webrtc {
 
 using RTCPUtility::RTCPCnameInformation;
 
+namespace {
+// A receiver report without report blocks.
+const int kRrHeaderLength = 8;
+const int kReportBlockLength = rtcp::kReportBlockLength;
+}  // namespace
+
 NACKStringBuilder::NACKStringBuilder() :
     _stream(""), _count(0), _consecutive(false)
 {
@@ -103,7 +110,8 @@ RTCPSender::RTCPSender(const int32_t id,
     _remoteSSRC(0),
     _CNAME(),
     receive_statistics_(receive_statistics),
-    internal_report_blocks_(),
+    report_blocks_(),
+    next_report_ssrc_(0),
     external_report_blocks_(),
     _csrcCNAMEs(),
 
@@ -125,6 +133,11 @@ RTCPSender::RTCPSender(const int32_t id,
     _rembSSRC(NULL),
     _rembBitrate(0),
 
+    transport_arrivals_(),
+    has_transport_sequence_number_(false),
+    last_transport_sequence_number_(0),
+    last_transport_feedback_time_ms_(0),
+
     _tmmbrHelp(),
     _tmmbr_Send(0),
     _packetOH_Send(0),
@@ -148,16 +161,6 @@ RTCPSender::~RTCPSender() {
   delete [] _rembSSRC;
   delete [] _appData;
 
-  while (!internal_report_blocks_.empty()) {
-    delete internal_report_blocks_.begin()->second;
-    internal_report_blocks_.erase(internal_report_blocks_.begin());
-  }
-  while (!external_report_blocks_.empty()) {
-    std::map<uint32_t, RTCPReportBlock*>::iterator it =
-        external_report_blocks_.begin();
-    delete it->second;
-    external_report_blocks_.erase(it);
-  }
   while (!_csrcCNAMEs.empty()) {
     std::map<uint32_t, RTCPCnameInformation*>::iterator it =
         _csrcCNAMEs.begin();
@@ -276,6 +279,31 @@ RTCPSender::SetREMBData(const uint32_t bitrate,
     return 0;
 }
 
+void RTCPSender::IncomingTransportSequenceNumber(uint16_t sequence_number,
+                                                 int64_t arrival_time_ms) {
+  CriticalSectionScoped lock(_criticalSectionRTCPSender);
+  int64_t unwrapped = sequence_number;
+  if (has_transport_sequence_number_) {
+    const int16_t diff = static_cast<int16_t>(
+        sequence_number -
+        static_cast<uint16_t>(last_transport_sequence_number_));
+    unwrapped = last_transport_sequence_number_ + diff;
+  }
+  has_transport_sequence_number_ = true;
+  last_transport_sequence_number_ = unwrapped;
+  transport_arrivals_[unwrapped] = arrival_time_ms;
+  // Don't let the arrivals pile up if the feedback can't be sent.
+  if (transport_arrivals_.size() > kMaxTransportArrivals)
+    transport_arrivals_.erase(transport_arrivals_.begin());
+}
+
+bool RTCPSender::TimeToSendTransportFeedback() const {
+  CriticalSectionScoped lock(_criticalSectionRTCPSender);
+  return _method != kRtcpOff && !transport_arrivals_.empty() &&
+      _clock->TimeInMilliseconds() - last_transport_feedback_time_ms_ >=
+          kTransportFeedbackIntervalMs;
+}
+
 bool
 RTCPSender::TMMBR() const
 {
@@ -539,43 +567,25 @@ void RTCPSender::GetPacketTypeCounter(
 int32_t RTCPSender::AddExternalReportBlock(
     uint32_t SSRC,
     const RTCPReportBlock* reportBlock) {
-  CriticalSectionScoped lock(_criticalSectionRTCPSender);
-  return AddReportBlock(SSRC, &external_report_blocks_, reportBlock);
-}
-
-int32_t RTCPSender::AddReportBlock(
-    uint32_t SSRC,
-    std::map<uint32_t, RTCPReportBlock*>* report_blocks,
-    const RTCPReportBlock* reportBlock) {
   assert(reportBlock);
-
-  if (report_blocks->size() >= RTCP_MAX_REPORT_BLOCKS) {
+  CriticalSectionScoped lock(_criticalSectionRTCPSender);
+  if (external_report_blocks_.size() >= RTCP_MAX_REPORT_BLOCKS &&
+      external_report_blocks_.find(SSRC) == external_report_blocks_.end()) {
     LOG(LS_WARNING) << "Too many report blocks.";
     return -1;
   }
-  std::map<uint32_t, RTCPReportBlock*>::iterator it =
-      report_blocks->find(SSRC);
-  if (it != report_blocks->end()) {
-    delete it->second;
-    report_blocks->erase(it);
-  }
-  RTCPReportBlock* copyReportBlock = new RTCPReportBlock();
-  memcpy(copyReportBlock, reportBlock, sizeof(RTCPReportBlock));
-  (*report_blocks)[SSRC] = copyReportBlock;
+  RTCPReportBlock& report_block = external_report_blocks_[SSRC];
+  report_block = *reportBlock;
+  report_block.sourceSSRC = SSRC;
   return 0;
 }
 
 int32_t RTCPSender::RemoveExternalReportBlock(uint32_t SSRC) {
   CriticalSectionScoped lock(_criticalSectionRTCPSender);
 
-  std::map<uint32_t, RTCPReportBlock*>::iterator it =
-      external_report_blocks_.find(SSRC);
-
-  if (it == external_report_blocks_.end()) {
+  if (external_report_blocks_.erase(SSRC) == 0) {
     return -1;
   }
-  delete it->second;
-  external_report_blocks_.erase(it);
   return 0;
 }
 
@@ -643,20 +653,13 @@ int32_t RTCPSender::BuildSR(const FeedbackState& feedback_state,
                                       feedback_state.media_bytes_sent);
     pos += 4;
 
-    uint8_t numberOfReportBlocks = 0;
-    int32_t retVal = WriteAllReportBlocksToBuffer(rtcpbuffer, pos,
-                                                  numberOfReportBlocks,
-                                                  NTPsec, NTPfrac);
-    if(retVal < 0)
-    {
-        //
-        return retVal ;
-    }
-    pos = retVal;
-    rtcpbuffer[posNumberOfReportBlocks] += numberOfReportBlocks;
+    rtcpbuffer[posNumberOfReportBlocks] +=
+        WriteReportBlocks(rtcpbuffer, pos, 0);
 
-    uint16_t len = uint16_t((pos/4) -1);
-    RtpUtility::AssignUWord16ToBuffer(rtcpbuffer + 2, len);
+    uint16_t len = uint16_t((pos - posNumberOfReportBlocks) / 4 - 1);
+    RtpUtility::AssignUWord16ToBuffer(rtcpbuffer + posNumberOfReportBlocks + 2,
+                                      len);
+    BuildAdditionalRR(rtcpbuffer, pos);
     return 0;
 }
 
@@ -776,19 +779,13 @@ RTCPSender::BuildRR(uint8_t* rtcpbuffer,
     RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + pos, _SSRC);
     pos += 4;
 
-    uint8_t numberOfReportBlocks = 0;
-    int retVal = WriteAllReportBlocksToBuffer(rtcpbuffer, pos,
-                                              numberOfReportBlocks,
-                                              NTPsec, NTPfrac);
-    if(retVal < 0)
-    {
-        return pos;
-    }
-    pos = retVal;
-    rtcpbuffer[posNumberOfReportBlocks] += numberOfReportBlocks;
+    rtcpbuffer[posNumberOfReportBlocks] +=
+        WriteReportBlocks(rtcpbuffer, pos, 0);
 
-    uint16_t len = uint16_t((pos)/4 -1);
-    RtpUtility::AssignUWord16ToBuffer(rtcpbuffer + 2, len);
+    uint16_t len = uint16_t((pos - posNumberOfReportBlocks) / 4 - 1);
+    RtpUtility::AssignUWord16ToBuffer(rtcpbuffer + posNumberOfReportBlocks + 2,
+                                      len);
+    BuildAdditionalRR(rtcpbuffer, pos);
     return 0;
 }
 
@@ -1098,6 +1095,31 @@ RTCPSender::BuildREMB(uint8_t* rtcpbuffer, int& pos)
     return 0;
 }
 
+int32_t RTCPSender::BuildTransportFeedback(uint8_t* rtcpbuffer, int& pos) {
+  // Report as many of the arrivals as fit, in messages of consecutive
+  // packets. The rest are reported in the next feedback.
+  while (!transport_arrivals_.empty()) {
+    rtcp::TransportFeedback feedback;
+    feedback.From(_SSRC);
+    feedback.To(_remoteSSRC);
+    std::map<int64_t, int64_t>::iterator it = transport_arrivals_.begin();
+    while (it != transport_arrivals_.end() &&
+           feedback.WithReceivedPacket(static_cast<uint16_t>(it->first),
+                                       it->second)) {
+      ++it;
+    }
+    size_t length = 0;
+    feedback.Build(rtcpbuffer + pos, &length, IP_PACKET_SIZE - pos);
+    if (length == 0) {
+      return -2;
+    }
+    pos += static_cast<int>(length);
+    transport_arrivals_.erase(transport_arrivals_.begin(), it);
+  }
+  last_transport_feedback_time_ms_ = _clock->TimeInMilliseconds();
+  return 0;
+}
+
 void
 RTCPSender::SetTargetBitrate(unsigned int target_bitrate)
 {
@@ -1682,6 +1704,11 @@ int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
       rtcpPacketTypeFlags |= kRtcpXrVoipMetric;
       _xrSendVoIPMetric = false;
   }
+  if(!transport_arrivals_.empty())
+  {
+      // Attach the pending transport feedback to every RTCP packet.
+      rtcpPacketTypeFlags |= kRtcpTransportFeedback;
+  }
   if(_sendTMMBN)  // Set when having received a TMMBR.
   {
       rtcpPacketTypeFlags |= kRtcpTmmbn;
@@ -1756,22 +1783,13 @@ int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
 
   // We need to send our NTP even if we haven't received any reports.
   _clock->CurrentNtp(NTPsec, NTPfrac);
+  report_blocks_.clear();
   if (ShouldSendReportBlocks(rtcpPacketTypeFlags)) {
-    StatisticianMap statisticians =
-        receive_statistics_->GetActiveStatisticians();
-    if (!statisticians.empty()) {
-      StatisticianMap::const_iterator it;
-      int i;
-      for (it = statisticians.begin(), i = 0; it != statisticians.end();
-           ++it, ++i) {
-        RTCPReportBlock report_block;
-        if (PrepareReport(
-                feedback_state, it->second, &report_block, &NTPsec, &NTPfrac))
-          AddReportBlock(it->first, &internal_report_blocks_, &report_block);
-      }
-      if (_IJ && !statisticians.empty()) {
-        rtcpPacketTypeFlags |= kRtcpTransmissionTimeOffset;
-      }
+    CollectReportBlocks(feedback_state,
+                        MaxReportBlocks(rtcpPacketTypeFlags, buffer_size),
+                        &NTPsec, &NTPfrac);
+    if (_IJ && report_blocks_.size() > external_report_blocks_.size()) {
+      rtcpPacketTypeFlags |= kRtcpTransmissionTimeOffset;
     }
   }
 
@@ -1868,6 +1886,15 @@ int RTCPSender::PrepareRTCP(const FeedbackState& feedback_state,
         return position;
       }
   }
+  if(rtcpPacketTypeFlags & kRtcpTransportFeedback)
+  {
+      buildVal = BuildTransportFeedback(rtcp_buffer, position);
+      if (buildVal == -1) {
+        return -1;
+      } else if (buildVal == -2) {
+        return position;
+      }
+  }
   if(rtcpPacketTypeFlags & kRtcpRemb)
   {
       buildVal = BuildREMB(rtcp_buffer, position);
@@ -2092,70 +2119,119 @@ bool RTCPSender::RtcpXrReceiverReferenceTime() const {
   return xrSendReceiverReferenceTimeEnabled_;
 }
 
-// called under critsect _criticalSectionRTCPSender
-int32_t RTCPSender::WriteAllReportBlocksToBuffer(
-    uint8_t* rtcpbuffer,
-    int pos,
-    uint8_t& numberOfReportBlocks,
-    const uint32_t NTPsec,
-    const uint32_t NTPfrac) {
-  numberOfReportBlocks = external_report_blocks_.size();
-  numberOfReportBlocks += internal_report_blocks_.size();
-  if ((pos + numberOfReportBlocks * 24) >= IP_PACKET_SIZE) {
-    LOG(LS_WARNING) << "Can't fit all report blocks.";
-    return -1;
+size_t RTCPSender::SdesLength() const {
+  // Each CNAME item is padded with at least one zero byte to a 32-bit
+  // boundary.
+  size_t length = 4 + ((6 + strlen(_CNAME)) / 4 + 1) * 4;
+  std::map<uint32_t, RTCPCnameInformation*>::const_iterator it =
+      _csrcCNAMEs.begin();
+  for (; it != _csrcCNAMEs.end(); ++it)
+    length += ((6 + strlen(it->second->name)) / 4 + 1) * 4;
+  return length;
+}
+
+size_t RTCPSender::MaxReportBlocks(uint32_t rtcp_packet_type,
+                                   int buffer_size) const {
+  int available = buffer_size - RTCP_FEEDBACK_RESERVED_LENGTH;
+  if (rtcp_packet_type & kRtcpSr) {
+    available -= 28 + static_cast<int>(SdesLength());
+  } else if (rtcp_packet_type & kRtcpRr) {
+    available -= 8;
+    if (_CNAME[0] != 0)
+      available -= static_cast<int>(SdesLength());
+  } else {
+    return 0;
   }
-  pos = WriteReportBlocksToBuffer(rtcpbuffer, pos, internal_report_blocks_);
-  while (!internal_report_blocks_.empty()) {
-    delete internal_report_blocks_.begin()->second;
-    internal_report_blocks_.erase(internal_report_blocks_.begin());
+  if (available < kReportBlockLength)
+    return 0;
+  // Every RTCP_MAX_REPORT_BLOCKS blocks after the first ones take another
+  // receiver report header.
+  const int kChunkLength =
+      RTCP_MAX_REPORT_BLOCKS * kReportBlockLength + kRrHeaderLength;
+  const int chunks = (available + kRrHeaderLength) / kChunkLength;
+  const int remaining = std::max(
+      0, (available + kRrHeaderLength) % kChunkLength - kRrHeaderLength);
+  return chunks * RTCP_MAX_REPORT_BLOCKS + remaining / kReportBlockLength;
+}
+
+void RTCPSender::CollectReportBlocks(const FeedbackState& feedback_state,
+                                     size_t max_report_blocks,
+                                     uint32_t* ntp_secs,
+                                     uint32_t* ntp_frac) {
+  std::map<uint32_t, RTCPReportBlock>::const_iterator external_it =
+      external_report_blocks_.begin();
+  for (; external_it != external_report_blocks_.end() &&
+             report_blocks_.size() < max_report_blocks;
+       ++external_it) {
+    report_blocks_.push_back(external_it->second);
   }
-  pos = WriteReportBlocksToBuffer(rtcpbuffer, pos, external_report_blocks_);
-  return pos;
-}
 
-int32_t RTCPSender::WriteReportBlocksToBuffer(
-    uint8_t* rtcpbuffer,
-    int32_t position,
-    const std::map<uint32_t, RTCPReportBlock*>& report_blocks) {
-  std::map<uint32_t, RTCPReportBlock*>::const_iterator it =
-      report_blocks.begin();
-  for (; it != report_blocks.end(); it++) {
-    uint32_t remoteSSRC = it->first;
-    RTCPReportBlock* reportBlock = it->second;
-    if (reportBlock) {
-      // Remote SSRC
-      RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + position, remoteSSRC);
-      position += 4;
-
-      // fraction lost
-      rtcpbuffer[position++] = reportBlock->fractionLost;
-
-      // cumulative loss
-      RtpUtility::AssignUWord24ToBuffer(rtcpbuffer + position,
-                                        reportBlock->cumulativeLost);
-      position += 3;
-
-      // extended highest seq_no, contain the highest sequence number received
-      RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + position,
-                                        reportBlock->extendedHighSeqNum);
-      position += 4;
-
-      // Jitter
-      RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + position,
-                                        reportBlock->jitter);
-      position += 4;
-
-      RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + position,
-                                        reportBlock->lastSR);
-      position += 4;
-
-      RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + position,
-                                        reportBlock->delaySinceLastSR);
-      position += 4;
+  const StatisticianMap statisticians =
+      receive_statistics_->GetActiveStatisticians();
+  if (statisticians.empty())
+    return;
+  // Continue with the stream after the last one reported, so that all
+  // streams are reported in turn when they don't fit in one packet.
+  StatisticianMap::const_iterator it =
+      statisticians.lower_bound(next_report_ssrc_);
+  for (size_t i = 0; i < statisticians.size() &&
+                     report_blocks_.size() < max_report_blocks;
+       ++i, ++it) {
+    if (it == statisticians.end())
+      it = statisticians.begin();
+    RTCPReportBlock report_block;
+    if (!PrepareReport(
+            feedback_state, it->second, &report_block, ntp_secs, ntp_frac)) {
+      continue;
     }
+    report_block.sourceSSRC = it->first;
+    report_blocks_.push_back(report_block);
+  }
+  if (it == statisticians.end())
+    it = statisticians.begin();
+  next_report_ssrc_ = it->first;
+}
+
+uint8_t RTCPSender::WriteReportBlocks(uint8_t* rtcpbuffer,
+                                      int& pos,
+                                      size_t first) {
+  uint8_t count = 0;
+  for (size_t i = first;
+       i < report_blocks_.size() && count < RTCP_MAX_REPORT_BLOCKS;
+       ++i, ++count) {
+    const RTCPReportBlock& report_block = report_blocks_[i];
+    RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + pos,
+                                      report_block.sourceSSRC);
+    rtcpbuffer[pos + 4] = report_block.fractionLost;
+    RtpUtility::AssignUWord24ToBuffer(rtcpbuffer + pos + 5,
+                                      report_block.cumulativeLost);
+    RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + pos + 8,
+                                      report_block.extendedHighSeqNum);
+    RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + pos + 12,
+                                      report_block.jitter);
+    RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + pos + 16,
+                                      report_block.lastSR);
+    RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + pos + 20,
+                                      report_block.delaySinceLastSR);
+    pos += kReportBlockLength;
+  }
+  return count;
+}
+
+void RTCPSender::BuildAdditionalRR(uint8_t* rtcpbuffer, int& pos) {
+  for (size_t first = RTCP_MAX_REPORT_BLOCKS; first < report_blocks_.size();
+       first += RTCP_MAX_REPORT_BLOCKS) {
+    const int start = pos;
+    rtcpbuffer[pos++] = 0x80;
+    rtcpbuffer[pos++] = 201;
+    pos += 2;  // Length.
+    RtpUtility::AssignUWord32ToBuffer(rtcpbuffer + pos, _SSRC);
+    pos += 4;
+    rtcpbuffer[start] += WriteReportBlocks(rtcpbuffer, pos, first);
+    RtpUtility::AssignUWord16ToBuffer(rtcpbuffer + start + 2,
+                                      static_cast<uint16_t>(
+                                          (pos - start) / 4 - 1));
   }
-  return position;
 }
 
 // no callbacks allowed inside this function
@@ -14,6 +14,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "webrtc/modules/remote_bitrate_estimator/include/bwe_defines.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
@@ -136,6 +137,18 @@ public:
                         const uint8_t numberOfSSRC,
                         const uint32_t* SSRC);
 
+    /*
+    *   Transport feedback
+    */
+    // Records the arrival of a packet with a transport sequence number, to be
+    // reported in the next transport feedback.
+    void IncomingTransportSequenceNumber(uint16_t sequence_number,
+                                         int64_t arrival_time_ms);
+
+    // Returns true if there are arrivals to report, and no transport feedback
+    // has been sent for kTransportFeedbackIntervalMs.
+    bool TimeToSendTransportFeedback() const;
+
     /*
     *   TMMBR
     */
@@ -180,22 +193,33 @@ public:
 private:
     int32_t SendToNetwork(const uint8_t* dataBuffer, const uint16_t length);
 
-    int32_t WriteAllReportBlocksToBuffer(uint8_t* rtcpbuffer,
-                            int pos,
-                            uint8_t& numberOfReportBlocks,
-                            const uint32_t NTPsec,
-                            const uint32_t NTPfrac)
+    // Returns the number of report blocks that fit in a compound packet of
+    // |buffer_size| bytes with the report and SDES of |rtcp_packet_type|,
+    // leaving room for the feedback messages.
+    size_t MaxReportBlocks(uint32_t rtcp_packet_type, int buffer_size) const
         EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
 
-    int32_t WriteReportBlocksToBuffer(
-        uint8_t* rtcpbuffer,
-        int32_t position,
-        const std::map<uint32_t, RTCPReportBlock*>& report_blocks);
+    size_t SdesLength() const
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
+
+    // Collects the report blocks of this packet into |report_blocks_|, the
+    // external ones first. If not all streams fit, the next packet continues
+    // with the streams that were left out.
+    void CollectReportBlocks(const FeedbackState& feedback_state,
+                             size_t max_report_blocks,
+                             uint32_t* ntp_secs,
+                             uint32_t* ntp_frac)
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
 
-    int32_t AddReportBlock(
-        uint32_t SSRC,
-        std::map<uint32_t, RTCPReportBlock*>* report_blocks,
-        const RTCPReportBlock* receiveBlock);
+    // Writes up to RTCP_MAX_REPORT_BLOCKS report blocks starting with
+    // |report_blocks_[first]|. Returns the number of blocks written.
+    uint8_t WriteReportBlocks(uint8_t* rtcpbuffer, int& pos, size_t first)
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
+
+    // Writes the report blocks that didn't fit in the SR or RR in additional
+    // receiver reports.
+    void BuildAdditionalRR(uint8_t* rtcpbuffer, int& pos)
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
 
     bool PrepareReport(const FeedbackState& feedback_state,
                        StreamStatistician* statistician,
@@ -239,6 +263,8 @@ private:
         EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
     int32_t BuildREMB(uint8_t* rtcpbuffer, int& pos)
         EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
+    int32_t BuildTransportFeedback(uint8_t* rtcpbuffer, int& pos)
+        EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
     int32_t BuildTMMBR(ModuleRtpRtcpImpl* module, uint8_t* rtcpbuffer, int& pos)
         EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPSender);
     int32_t BuildTMMBN(uint8_t* rtcpbuffer, int& pos)
@@ -305,9 +331,14 @@ private:
 
     ReceiveStatistics* receive_statistics_
         GUARDED_BY(_criticalSectionRTCPSender);
-    std::map<uint32_t, RTCPReportBlock*> internal_report_blocks_
+    // The report blocks of the packet being built, with the SSRC of the
+    // reported stream in |sourceSSRC|. Reused, so that building a packet
+    // doesn't allocate.
+    std::vector<RTCPReportBlock> report_blocks_
         GUARDED_BY(_criticalSectionRTCPSender);
-    std::map<uint32_t, RTCPReportBlock*> external_report_blocks_
+    // The stream to report first in the next packet.
+    uint32_t next_report_ssrc_ GUARDED_BY(_criticalSectionRTCPSender);
+    std::map<uint32_t, RTCPReportBlock> external_report_blocks_
         GUARDED_BY(_criticalSectionRTCPSender);
     std::map<uint32_t, RTCPUtility::RTCPCnameInformation*> _csrcCNAMEs
         GUARDED_BY(_criticalSectionRTCPSender);
@@ -339,6 +370,18 @@ private:
     uint32_t*     _rembSSRC GUARDED_BY(_criticalSectionRTCPSender);
     uint32_t      _rembBitrate GUARDED_BY(_criticalSectionRTCPSender);
 
+    // Transport feedback
+    // Arrival times of the packets to report, by unwrapped transport sequence
+    // number.
+    std::map<int64_t, int64_t> transport_arrivals_
+        GUARDED_BY(_criticalSectionRTCPSender);
+    bool has_transport_sequence_number_ GUARDED_BY(_criticalSectionRTCPSender);
+    // Unwrapped transport sequence number of the last packet.
+    int64_t last_transport_sequence_number_
+        GUARDED_BY(_criticalSectionRTCPSender);
+    int64_t last_transport_feedback_time_ms_
+        GUARDED_BY(_criticalSectionRTCPSender);
+
     TMMBRHelp           _tmmbrHelp GUARDED_BY(_criticalSectionRTCPSender);
     uint32_t      _tmmbr_Send GUARDED_BY(_criticalSectionRTCPSender);
     uint32_t      _packetOH_Send GUARDED_BY(_criticalSectionRTCPSender);
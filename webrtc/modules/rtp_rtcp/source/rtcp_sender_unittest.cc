@@ -27,6 +27,7 @@
 #include "webrtc/modules/rtp_rtcp/source/rtp_receiver_video.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_impl.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
+#include "webrtc/test/rtcp_packet_parser.h"
 
 namespace webrtc {
 
@@ -222,7 +223,8 @@ class TestTransport : public Transport,
                       public NullRtpData {
  public:
   TestTransport()
-      : rtcp_receiver_(NULL) {
+      : rtcp_receiver_(NULL),
+        last_rtcp_packet_length_(0) {
   }
   void SetRTCPReceiver(RTCPReceiver* rtcp_receiver) {
     rtcp_receiver_ = rtcp_receiver;
@@ -232,6 +234,8 @@ class TestTransport : public Transport,
   }
 
   virtual int SendRTCPPacket(int /*ch*/, const void *packet, int packet_len) {
+    memcpy(last_rtcp_packet_, packet, packet_len);
+    last_rtcp_packet_length_ = packet_len;
     RTCPUtility::RTCPParserV2 rtcpParser((uint8_t*)packet,
                                          (int32_t)packet_len,
                                          true); // Allow non-compound RTCP
@@ -268,6 +272,8 @@ class TestTransport : public Transport,
   }
   RTCPReceiver* rtcp_receiver_;
   RTCPHelp::RTCPPacketInformation rtcp_packet_info_;
+  uint8_t last_rtcp_packet_[IP_PACKET_SIZE];
+  int last_rtcp_packet_length_;
 };
 
 class RtcpSenderTest : public ::testing::Test {
@@ -319,6 +325,22 @@ class RtcpSenderTest : public ::testing::Test {
             packet_type) != 0U;
   }
 
+  // Has |receive_statistics_| receive a packet on each of |num_streams|
+  // streams, with SSRCs from |kFirstSsrc| on.
+  void ReceivePacketsOnStreams(int num_streams) {
+    for (int i = 0; i < num_streams; ++i) {
+      RTPHeader header;
+      header.ssrc = kFirstSsrc + i;
+      header.sequenceNumber = 11111;
+      header.timestamp = 1234567;
+      header.payloadType = 100;
+      header.headerLength = 12;
+      receive_statistics_->IncomingPacket(header, 100, false);
+    }
+  }
+
+  static const uint32_t kFirstSsrc = 0x10000;
+
   OverUseDetectorOptions over_use_detector_options_;
   SimulatedClock clock_;
   scoped_ptr<RTPPayloadRegistry> rtp_payload_registry_;
@@ -400,6 +422,51 @@ TEST_F(RtcpSenderTest, TestCompound_NoRtpReceived) {
       kRtcpTransmissionTimeOffset);
 }
 
+TEST_F(RtcpSenderTest, ReportsMoreThan31StreamsInAdditionalReceiverReports) {
+  const int kNumStreams = 40;
+  ReceivePacketsOnStreams(kNumStreams);
+  EXPECT_EQ(0, rtcp_sender_->SetRTCPStatus(kRtcpCompound));
+  RTCPSender::FeedbackState feedback_state = rtp_rtcp_impl_->GetFeedbackState();
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state, kRtcpRr));
+
+  test::RtcpPacketParser parser;
+  parser.Parse(test_transport_->last_rtcp_packet_,
+               test_transport_->last_rtcp_packet_length_);
+  EXPECT_EQ(2, parser.receiver_report()->num_packets());
+  EXPECT_EQ(kNumStreams, parser.report_block()->num_packets());
+  for (int i = 0; i < kNumStreams; ++i)
+    EXPECT_EQ(1, parser.report_blocks_per_ssrc(kFirstSsrc + i));
+}
+
+TEST_F(RtcpSenderTest, ReportsStreamsInTurnIfNotAllFit) {
+  const int kNumStreams = 100;
+  ReceivePacketsOnStreams(kNumStreams);
+  EXPECT_EQ(0, rtcp_sender_->SetRTCPStatus(kRtcpCompound));
+  RTCPSender::FeedbackState feedback_state = rtp_rtcp_impl_->GetFeedbackState();
+
+  test::RtcpPacketParser parser;
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state, kRtcpRr));
+  EXPECT_LE(test_transport_->last_rtcp_packet_length_, IP_PACKET_SIZE);
+  parser.Parse(test_transport_->last_rtcp_packet_,
+               test_transport_->last_rtcp_packet_length_);
+  const int first_report_blocks = parser.report_block()->num_packets();
+  EXPECT_GT(first_report_blocks, 31);
+  EXPECT_LT(first_report_blocks, kNumStreams);
+
+  // The next packets report the streams that were left out.
+  while (parser.report_block()->num_packets() < kNumStreams) {
+    ReceivePacketsOnStreams(kNumStreams);
+    EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state, kRtcpRr));
+    parser.Parse(test_transport_->last_rtcp_packet_,
+                 test_transport_->last_rtcp_packet_length_);
+  }
+  // The last packet continues with the first streams again.
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_GE(parser.report_blocks_per_ssrc(kFirstSsrc + i), 1);
+    EXPECT_LE(parser.report_blocks_per_ssrc(kFirstSsrc + i), 2);
+  }
+}
+
 TEST_F(RtcpSenderTest, TestXrReceiverReferenceTime) {
   EXPECT_EQ(0, rtcp_sender_->SetRTCPStatus(kRtcpCompound));
   RTCPSender::FeedbackState feedback_state = rtp_rtcp_impl_->GetFeedbackState();
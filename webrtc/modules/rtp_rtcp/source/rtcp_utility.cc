@@ -34,6 +34,7 @@ RTCPUtility::RTCPParserV2::RTCPParserV2(const uint8_t* rtcpData,
       _ptrRTCPBlockEnd(NULL),
       _state(State_TopLevel),
       _numberOfBlocks(0),
+      _numberOfPacketStatuses(0),
       _packetType(kRtcpNotValidCode) {
   Validate();
 }
@@ -63,6 +64,7 @@ RTCPUtility::RTCPPacketTypes
 RTCPUtility::RTCPParserV2::Begin()
 {
     _ptrRTCPData = _ptrRTCPDataBegin;
+    _state = State_TopLevel;
 
     return Iterate();
 }
@@ -101,6 +103,9 @@ RTCPUtility::RTCPParserV2::Iterate()
         case State_RTPFB_TMMBNItem:
             IterateTMMBNItem();
             break;
+        case State_RTPFB_TransportFeedbackItem:
+            IterateTransportFeedbackItem();
+            break;
         case State_PSFB_SLIItem:
             IterateSLIItem();
             break;
@@ -330,6 +335,16 @@ RTCPUtility::RTCPParserV2::IterateTMMBNItem()
     }
 }
 
+void
+RTCPUtility::RTCPParserV2::IterateTransportFeedbackItem()
+{
+    const bool success = ParseTransportFeedbackItem();
+    if (!success)
+    {
+        Iterate();
+    }
+}
+
 void
 RTCPUtility::RTCPParserV2::IterateSLIItem()
 {
@@ -1200,6 +1215,15 @@ RTCPUtility::RTCPParserV2::ParseFBCommon(const RTCPCommonHeader& header)
             // Note: No state transition, SR REQ is empty!
             return true;
         }
+        case 15:
+        {
+            // Transport-wide feedback
+            _packetType = kRtcpRtpfbTransportFeedbackCode;
+            _packet.TransportFeedback.SenderSSRC = senderSSRC;
+            _packet.TransportFeedback.MediaSSRC  = mediaSSRC;
+
+            return ParseTransportFeedback();
+        }
         default:
             break;
         }
@@ -1499,6 +1523,63 @@ RTCPUtility::RTCPParserV2::ParseTMMBNItem()
     return true;
 }
 
+bool
+RTCPUtility::RTCPParserV2::ParseTransportFeedback()
+{
+    // Transport-wide feedback, see rtcp::TransportFeedback.
+
+    const ptrdiff_t length = _ptrRTCPBlockEnd - _ptrRTCPData;
+
+    if (length < 8)
+    {
+        EndCurrentBlock();
+        return false;
+    }
+
+    _packet.TransportFeedback.BaseSequenceNumber = *_ptrRTCPData++ << 8;
+    _packet.TransportFeedback.BaseSequenceNumber += *_ptrRTCPData++;
+
+    _numberOfPacketStatuses = *_ptrRTCPData++ << 8;
+    _numberOfPacketStatuses += *_ptrRTCPData++;
+    _packet.TransportFeedback.PacketStatusCount = _numberOfPacketStatuses;
+
+    _packet.TransportFeedback.ReferenceTimeMs = *_ptrRTCPData++ << 24;
+    _packet.TransportFeedback.ReferenceTimeMs += *_ptrRTCPData++ << 16;
+    _packet.TransportFeedback.ReferenceTimeMs += *_ptrRTCPData++ << 8;
+    _packet.TransportFeedback.ReferenceTimeMs += *_ptrRTCPData++;
+
+    if (_ptrRTCPBlockEnd - _ptrRTCPData < _numberOfPacketStatuses)
+    {
+        EndCurrentBlock();
+        return false;
+    }
+
+    _state = State_RTPFB_TransportFeedbackItem;
+
+    return true;
+}
+
+bool
+RTCPUtility::RTCPParserV2::ParseTransportFeedbackItem()
+{
+    // One receive delta per packet status, followed by padding.
+    if (_numberOfPacketStatuses == 0 || _ptrRTCPData >= _ptrRTCPBlockEnd)
+    {
+        _state = State_TopLevel;
+
+        EndCurrentBlock();
+        return false;
+    }
+
+    _packetType = kRtcpRtpfbTransportFeedbackItemCode;
+
+    _packet.TransportFeedbackItem.ReceiveDelta =
+        static_cast<int8_t>(*_ptrRTCPData++);
+    --_numberOfPacketStatuses;
+
+    return true;
+}
+
 bool
 RTCPUtility::RTCPParserV2::ParseSLIItem()
 {
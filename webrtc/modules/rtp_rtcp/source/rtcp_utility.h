@@ -153,6 +153,24 @@ namespace RTCPUtility {
         uint32_t MeasuredOverhead;
     };
 
+    // Transport-wide feedback, see rtcp::TransportFeedback.
+    struct RTCPPacketRTPFBTransportFeedback
+    {
+        uint32_t SenderSSRC;
+        uint32_t MediaSSRC;
+        uint16_t BaseSequenceNumber;
+        uint16_t PacketStatusCount;
+        uint32_t ReferenceTimeMs;
+    };
+    // The receive delta of a transport feedback packet status.
+    const int8_t kTransportFeedbackNotReceived = -128;
+    struct RTCPPacketRTPFBTransportFeedbackItem
+    {
+        // Arrival time in ms relative to the previous received packet, or
+        // kTransportFeedbackNotReceived.
+        int8_t ReceiveDelta;
+    };
+
     struct RTCPPacketPSFBFIR
     {
         uint32_t SenderSSRC;
@@ -239,6 +257,8 @@ namespace RTCPUtility {
         RTCPPacketRTPFBTMMBRItem  TMMBRItem;
         RTCPPacketRTPFBTMMBN      TMMBN;
         RTCPPacketRTPFBTMMBNItem  TMMBNItem;
+        RTCPPacketRTPFBTransportFeedback     TransportFeedback;
+        RTCPPacketRTPFBTransportFeedbackItem TransportFeedbackItem;
         RTCPPacketPSFBFIR         FIR;
         RTCPPacketPSFBFIRItem     FIRItem;
 
@@ -290,6 +310,10 @@ namespace RTCPUtility {
         // draft-perkins-avt-rapid-rtp-sync
         kRtcpRtpfbSrReqCode,
 
+        // Transport-wide feedback
+        kRtcpRtpfbTransportFeedbackCode,
+        kRtcpRtpfbTransportFeedbackItemCode,
+
         // RFC 3611
         kRtcpXrHeaderCode,
         kRtcpXrReceiverReferenceTimeCode,
@@ -375,6 +399,7 @@ namespace RTCPUtility {
             State_RTPFB_NACKItem,  // NACK FCI item
             State_RTPFB_TMMBRItem, // TMMBR FCI item
             State_RTPFB_TMMBNItem, // TMMBN FCI item
+            State_RTPFB_TransportFeedbackItem, // Transport feedback packet status
             State_PSFB_SLIItem,    // SLI FCI item
             State_PSFB_RPSIItem,   // RPSI FCI item
             State_PSFB_FIRItem,    // FIR FCI item
@@ -394,6 +419,7 @@ namespace RTCPUtility {
         void IterateNACKItem();
         void IterateTMMBRItem();
         void IterateTMMBNItem();
+        void IterateTransportFeedbackItem();
         void IterateSLIItem();
         void IterateRPSIItem();
         void IterateFIRItem();
@@ -432,6 +458,8 @@ namespace RTCPUtility {
         bool ParseNACKItem();
         bool ParseTMMBRItem();
         bool ParseTMMBNItem();
+        bool ParseTransportFeedback();
+        bool ParseTransportFeedbackItem();
         bool ParseSLIItem();
         bool ParseRPSIItem();
         bool ParseFIRItem();
@@ -452,6 +480,7 @@ namespace RTCPUtility {
 
         ParseState               _state;
         uint8_t            _numberOfBlocks;
+        uint16_t           _numberOfPacketStatuses;
 
         RTCPPacketTypes          _packetType;
         RTCPPacket               _packet;
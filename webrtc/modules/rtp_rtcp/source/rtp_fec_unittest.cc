@@ -8,11 +8,15 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
 #include <list>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 using webrtc::ForwardErrorCorrection;
 
@@ -793,6 +797,100 @@ TEST_F(RtpFecTest, FecRecoveryNonConsecutivePacketsWrap) {
   EXPECT_FALSE(IsRecoveryComplete());
 }
 
+TEST_F(RtpFecTest, AllocatedPacketsAreRecycled) {
+  ForwardErrorCorrection::Packet* packet = fec_->AllocatePacket();
+  EXPECT_EQ(0, packet->length);
+  packet->AddRef();
+  packet->length = 100;
+  packet->Release();
+
+  // The released storage is handed out again, with the length reset.
+  ForwardErrorCorrection::Packet* recycled_packet = fec_->AllocatePacket();
+  EXPECT_EQ(packet, recycled_packet);
+  EXPECT_EQ(0, recycled_packet->length);
+  recycled_packet->AddRef();
+  recycled_packet->Release();
+}
+
+TEST_F(RtpFecTest, AllocatedPacketOutlivesFec) {
+  webrtc::scoped_refptr<ForwardErrorCorrection::Packet> packet;
+  {
+    ForwardErrorCorrection fec;
+    packet = fec.AllocatePacket();
+    packet->length = kRtpHeaderSize;
+  }
+  // Releasing the last reference after |fec| is gone frees the pool.
+  EXPECT_EQ(kRtpHeaderSize, packet->length);
+  packet = NULL;
+}
+
+TEST_F(RtpFecTest, CachedPacketMasksMatchGeneratedMasks) {
+  // Typical frame sizes, with and without unequal protection.
+  const int kNumMediaPackets[] = {1, 4, 12, 30};
+  const uint8_t kProtectionFactor = 80;
+  for (size_t i = 0; i < sizeof(kNumMediaPackets) / sizeof(int); ++i) {
+    for (int num_important_packets = 0; num_important_packets < 2;
+         ++num_important_packets) {
+      ClearList(&media_packet_list_);
+      fec_seq_num_ = ConstructMediaPackets(kNumMediaPackets[i]);
+      std::vector<std::vector<uint8_t> > first_packets;
+      for (int round = 0; round < 2; ++round) {
+        // The second round uses the cached masks.
+        ASSERT_EQ(0, fec_->GenerateFEC(media_packet_list_, kProtectionFactor,
+                                       num_important_packets,
+                                       num_important_packets > 0,
+                                       webrtc::kFecMaskBursty,
+                                       &fec_packet_list_));
+        PacketList::iterator it = fec_packet_list_.begin();
+        for (size_t j = 0; it != fec_packet_list_.end(); ++it, ++j) {
+          std::vector<uint8_t> packet((*it)->data,
+                                      (*it)->data + (*it)->length);
+          if (round == 0)
+            first_packets.push_back(packet);
+          else
+            EXPECT_EQ(first_packets[j], packet) << kNumMediaPackets[i];
+        }
+        EXPECT_EQ(first_packets.size(), fec_packet_list_.size());
+        fec_packet_list_.clear();
+      }
+      // A new instance, which generates the masks from scratch, agrees.
+      ForwardErrorCorrection fec;
+      ASSERT_EQ(0, fec.GenerateFEC(media_packet_list_, kProtectionFactor,
+                                   num_important_packets,
+                                   num_important_packets > 0,
+                                   webrtc::kFecMaskBursty, &fec_packet_list_));
+      ASSERT_EQ(first_packets.size(), fec_packet_list_.size());
+      PacketList::iterator it = fec_packet_list_.begin();
+      for (size_t j = 0; it != fec_packet_list_.end(); ++it, ++j) {
+        EXPECT_EQ(first_packets[j],
+                  std::vector<uint8_t>((*it)->data,
+                                       (*it)->data + (*it)->length));
+      }
+      fec_packet_list_.clear();
+    }
+  }
+}
+
+// Benchmark of FEC generation over typical frame sizes, where the packet
+// masks are cached after the first frame.
+TEST_F(RtpFecTest, DISABLED_BenchmarkGenerateFec) {
+  const int kNumMediaPackets[] = {1, 4, 12, 30};
+  const int kIterations = 2000;
+  for (size_t i = 0; i < sizeof(kNumMediaPackets) / sizeof(int); ++i) {
+    ClearList(&media_packet_list_);
+    fec_seq_num_ = ConstructMediaPackets(kNumMediaPackets[i]);
+    webrtc::TickTime start = webrtc::TickTime::Now();
+    for (int j = 0; j < kIterations; ++j) {
+      fec_->GenerateFEC(media_packet_list_, 50, 0, false,
+                        webrtc::kFecMaskBursty, &fec_packet_list_);
+      fec_packet_list_.clear();
+    }
+    printf("%d media packets: %.2fus per frame.\n", kNumMediaPackets[i],
+           static_cast<double>(
+               (webrtc::TickTime::Now() - start).Microseconds()) / kIterations);
+  }
+}
+
 void RtpFecTest::TearDown() {
   fec_->ResetState(&recovered_packet_list_);
   delete fec_;
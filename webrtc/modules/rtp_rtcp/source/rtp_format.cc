@@ -10,9 +10,50 @@
 
 #include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
 
+#include <assert.h>
+#include <string.h>
+
 #include "webrtc/modules/rtp_rtcp/source/rtp_format_h264.h"
 
 namespace webrtc {
+RtpPayloadSlices::RtpPayloadSlices() : length_(0) {}
+
+RtpPayloadSlices::~RtpPayloadSlices() {}
+
+void RtpPayloadSlices::Clear() {
+  slices_.clear();
+  header_.clear();
+  length_ = 0;
+}
+
+uint8_t* RtpPayloadSlices::AppendHeader(size_t length) {
+  const size_t offset = header_.size();
+  header_.resize(offset + length);
+  // Header bytes following header bytes extend the same slice.
+  if (!slices_.empty() && slices_.back().data == NULL) {
+    slices_.back().length += length;
+  } else {
+    slices_.push_back(Slice(NULL, offset, length));
+  }
+  length_ += length;
+  return &header_[offset];
+}
+
+void RtpPayloadSlices::AppendPayload(const uint8_t* data, size_t length) {
+  assert(data);
+  slices_.push_back(Slice(data, 0, length));
+  length_ += length;
+}
+
+void RtpPayloadSlices::CopyTo(uint8_t* buffer) const {
+  for (size_t i = 0; i < slices_.size(); ++i) {
+    const Slice& slice = slices_[i];
+    memcpy(buffer, slice.data ? slice.data : &header_[slice.offset],
+           slice.length);
+    buffer += slice.length;
+  }
+}
+
 RtpPacketizer* RtpPacketizer::Create(RtpVideoCodecTypes type,
                                      size_t max_payload_len) {
   switch (type) {
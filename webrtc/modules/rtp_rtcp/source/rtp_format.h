@@ -11,12 +11,56 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_H_
 
+#include <vector>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 
 namespace webrtc {
 
+// The payload of one RTP packet, described by reference instead of being
+// copied into a buffer. It is a sequence of slices, each either referring to
+// the payload data given to RtpPacketizer::SetPayloadData() or holding header
+// bytes written by the packetizer.
+class RtpPayloadSlices {
+ public:
+  RtpPayloadSlices();
+  ~RtpPayloadSlices();
+
+  void Clear();
+
+  // Appends |length| header bytes and returns where to write them. The
+  // pointer is valid until the next call to AppendHeader() or Clear().
+  uint8_t* AppendHeader(size_t length);
+
+  // Appends a reference to the |length| bytes at |data|, which must stay valid
+  // as long as the slices are used.
+  void AppendPayload(const uint8_t* data, size_t length);
+
+  // Total number of bytes in the slices.
+  size_t length() const { return length_; }
+
+  // Gathers the slices into |buffer|, which must hold length() bytes.
+  void CopyTo(uint8_t* buffer) const;
+
+ private:
+  struct Slice {
+    Slice(const uint8_t* data, size_t offset, size_t length)
+        : data(data), offset(offset), length(length) {}
+
+    const uint8_t* data;  // NULL for header bytes.
+    size_t offset;  // Offset of header bytes in |header_|.
+    size_t length;
+  };
+
+  std::vector<Slice> slices_;
+  std::vector<uint8_t> header_;
+  size_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(RtpPayloadSlices);
+};
+
 class RtpPacketizer {
  public:
   static RtpPacketizer* Create(RtpVideoCodecTypes type, size_t max_payload_len);
@@ -37,6 +81,12 @@ class RtpPacketizer {
   virtual bool NextPacket(uint8_t* buffer,
                           size_t* bytes_to_send,
                           bool* last_packet) = 0;
+
+  // Same as NextPacket(), but describes the next payload in |payload| without
+  // copying the payload data. The payload data given to SetPayloadData() must
+  // stay valid as long as |payload| is used.
+  virtual bool NextPacketSlices(RtpPayloadSlices* payload,
+                                bool* last_packet) = 0;
 };
 
 class RtpDepacketizer {
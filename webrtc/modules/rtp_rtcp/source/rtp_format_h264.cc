@@ -29,6 +29,7 @@ enum Nalu {
 
 static const size_t kNalHeaderSize = 1;
 static const size_t kFuAHeaderSize = 2;
+static const size_t kLengthFieldSize = 2;
 
 // Bit masks for FU (A and B) indicators.
 enum NalDefs { kFBit = 0x80, kNriMask = 0x60, kTypeMask = 0x1F };
@@ -36,7 +37,37 @@ enum NalDefs { kFBit = 0x80, kNriMask = 0x60, kTypeMask = 0x1F };
 // Bit masks for FU (A and B) headers.
 enum FuDefs { kSBit = 0x80, kEBit = 0x40, kRBit = 0x20 };
 
-void ParseSingleNalu(WebRtcRTPHeader* rtp_header,
+bool IsKeyFrameNalu(uint8_t nal_type) {
+  return nal_type == Nalu::kSps || nal_type == Nalu::kPps ||
+         nal_type == Nalu::kIdr;
+}
+
+// Verifies that the aggregated NAL units of a STAP-A packet, each preceded by
+// its length, fill the packet exactly, so that the jitter buffer can later
+// split them up without checking the lengths again.
+bool ParseStapANalus(const uint8_t* payload_data,
+                     size_t payload_data_length,
+                     bool* key_frame) {
+  *key_frame = false;
+  size_t offset = kNalHeaderSize;
+  if (offset == payload_data_length)
+    return false;
+  while (offset < payload_data_length) {
+    if (payload_data_length - offset <= kLengthFieldSize)
+      return false;
+    size_t nalu_length =
+        (payload_data[offset] << 8) | payload_data[offset + 1];
+    offset += kLengthFieldSize;
+    if (nalu_length == 0 || nalu_length > payload_data_length - offset)
+      return false;
+    if (IsKeyFrameNalu(payload_data[offset] & NalDefs::kTypeMask))
+      *key_frame = true;
+    offset += nalu_length;
+  }
+  return true;
+}
+
+bool ParseSingleNalu(WebRtcRTPHeader* rtp_header,
                      const uint8_t* payload_data,
                      size_t payload_data_length) {
   rtp_header->type.Video.codec = kRtpVideoH264;
@@ -45,28 +76,27 @@ void ParseSingleNalu(WebRtcRTPHeader* rtp_header,
   h264_header->single_nalu = true;
   h264_header->stap_a = false;
 
+  bool key_frame = false;
   uint8_t nal_type = payload_data[0] & NalDefs::kTypeMask;
   if (nal_type == Nalu::kStapA) {
-    nal_type = payload_data[3] & NalDefs::kTypeMask;
+    // A STAP-A is a key frame if any of its NAL units is, e.g. an IDR slice
+    // aggregated after the SPS and PPS.
+    if (!ParseStapANalus(payload_data, payload_data_length, &key_frame))
+      return false;
     h264_header->stap_a = true;
+  } else {
+    key_frame = IsKeyFrameNalu(nal_type);
   }
-
-  switch (nal_type) {
-    case Nalu::kSps:
-    case Nalu::kPps:
-    case Nalu::kIdr:
-      rtp_header->frameType = kVideoFrameKey;
-      break;
-    default:
-      rtp_header->frameType = kVideoFrameDelta;
-      break;
-  }
+  rtp_header->frameType = key_frame ? kVideoFrameKey : kVideoFrameDelta;
+  return true;
 }
 
-void ParseFuaNalu(WebRtcRTPHeader* rtp_header,
+bool ParseFuaNalu(WebRtcRTPHeader* rtp_header,
                   const uint8_t* payload_data,
                   size_t payload_data_length,
                   size_t* offset) {
+  if (payload_data_length <= kFuAHeaderSize)
+    return false;
   uint8_t fnri = payload_data[0] & (NalDefs::kFBit | NalDefs::kNriMask);
   uint8_t original_nal_type = payload_data[1] & NalDefs::kTypeMask;
   bool first_fragment = (payload_data[1] & FuDefs::kSBit) > 0;
@@ -90,6 +120,7 @@ void ParseFuaNalu(WebRtcRTPHeader* rtp_header,
   RTPVideoHeaderH264* h264_header = &rtp_header->type.Video.codecHeader.H264;
   h264_header->single_nalu = false;
   h264_header->stap_a = false;
+  return true;
 }
 }  // namespace
 
@@ -157,10 +188,13 @@ int RtpPacketizerH264::PacketizeStapA(size_t fragment_index,
   // Aggregate fragments into one packet (STAP-A).
   size_t payload_size_left = max_payload_len_;
   int aggregated_fragments = 0;
+  // The headers needed in addition to the next fragment: nothing if it's
+  // sent alone, otherwise its length field, plus the STAP-A NALU header and
+  // the length field of the first fragment when it's the second one.
+  size_t fragment_headers_length = 0;
   assert(payload_size_left >= fragment_length);
-  while (payload_size_left >= fragment_length) {
+  while (payload_size_left >= fragment_length + fragment_headers_length) {
     if (fragment_length > 0) {
-      assert(fragment_length > 0);
       uint8_t header = payload_data_[fragment_offset];
       packets_.push(Packet(fragment_offset,
                            fragment_length,
@@ -168,11 +202,10 @@ int RtpPacketizerH264::PacketizeStapA(size_t fragment_index,
                            false,
                            true,
                            header));
-      // If we are going to try to aggregate more fragments into this packet
-      // we need to add the STAP-A NALU header.
+      payload_size_left -= fragment_length + fragment_headers_length;
+      fragment_headers_length = kLengthFieldSize;
       if (aggregated_fragments == 0)
-        payload_size_left -= kNalHeaderSize;
-      payload_size_left -= fragment_length;
+        fragment_headers_length += kNalHeaderSize + kLengthFieldSize;
       ++aggregated_fragments;
     }
     // Next fragment.
@@ -182,7 +215,8 @@ int RtpPacketizerH264::PacketizeStapA(size_t fragment_index,
     fragment_offset = fragmentation_.fragmentationOffset[fragment_index];
     fragment_length = fragmentation_.fragmentationLength[fragment_index];
   }
-  packets_.back().last_fragment = true;
+  if (aggregated_fragments > 0)
+    packets_.back().last_fragment = true;
   return fragment_index;
 }
 
@@ -190,8 +224,17 @@ bool RtpPacketizerH264::NextPacket(uint8_t* buffer,
                                    size_t* bytes_to_send,
                                    bool* last_packet) {
   *bytes_to_send = 0;
+  if (!NextPacketSlices(&packet_slices_, last_packet))
+    return false;
+  packet_slices_.CopyTo(buffer);
+  *bytes_to_send = packet_slices_.length();
+  return true;
+}
+
+bool RtpPacketizerH264::NextPacketSlices(RtpPayloadSlices* payload,
+                                         bool* last_packet) {
+  payload->Clear();
   if (packets_.empty()) {
-    *bytes_to_send = 0;
     *last_packet = true;
     return false;
   }
@@ -200,36 +243,30 @@ bool RtpPacketizerH264::NextPacket(uint8_t* buffer,
 
   if (packet.first_fragment && packet.last_fragment) {
     // Single NAL unit packet.
-    *bytes_to_send = packet.size;
-    memcpy(buffer, &payload_data_[packet.offset], packet.size);
+    payload->AppendPayload(&payload_data_[packet.offset], packet.size);
     packets_.pop();
   } else if (packet.aggregated) {
-    NextAggregatePacket(buffer, bytes_to_send);
+    NextAggregatePacket(payload);
   } else {
-    NextFragmentPacket(buffer, bytes_to_send);
+    NextFragmentPacket(payload);
   }
   *last_packet = packets_.empty();
-  assert(*bytes_to_send <= max_payload_len_);
+  assert(payload->length() <= max_payload_len_);
   return true;
 }
 
-void RtpPacketizerH264::NextAggregatePacket(uint8_t* buffer,
-                                            size_t* bytes_to_send) {
+void RtpPacketizerH264::NextAggregatePacket(RtpPayloadSlices* payload) {
   Packet packet = packets_.front();
   assert(packet.first_fragment);
   // STAP-A NALU header.
-  buffer[0] = (packet.header & (kFBit | kNriMask)) | kStapA;
-  int index = kNalHeaderSize;
-  *bytes_to_send += kNalHeaderSize;
+  payload->AppendHeader(kNalHeaderSize)[0] =
+      (packet.header & (kFBit | kNriMask)) | kStapA;
   while (packet.aggregated) {
     // Add NAL unit length field.
-    RtpUtility::AssignUWord16ToBuffer(&buffer[index], packet.size);
-    index += 2;
-    *bytes_to_send += 2;
+    RtpUtility::AssignUWord16ToBuffer(payload->AppendHeader(kLengthFieldSize),
+                                      packet.size);
     // Add NAL unit.
-    memcpy(&buffer[index], &payload_data_[packet.offset], packet.size);
-    index += packet.size;
-    *bytes_to_send += packet.size;
+    payload->AppendPayload(&payload_data_[packet.offset], packet.size);
     packets_.pop();
     if (packet.last_fragment)
       break;
@@ -238,8 +275,7 @@ void RtpPacketizerH264::NextAggregatePacket(uint8_t* buffer,
   assert(packet.last_fragment);
 }
 
-void RtpPacketizerH264::NextFragmentPacket(uint8_t* buffer,
-                                           size_t* bytes_to_send) {
+void RtpPacketizerH264::NextFragmentPacket(RtpPayloadSlices* payload) {
   Packet packet = packets_.front();
   // NAL unit fragmented over multiple packets (FU-A).
   // We do not send original NALU header, so it will be replaced by the
@@ -252,16 +288,10 @@ void RtpPacketizerH264::NextFragmentPacket(uint8_t* buffer,
   fu_header |= (packet.last_fragment ? kEBit : 0);
   uint8_t type = packet.header & kTypeMask;
   fu_header |= type;
-  buffer[0] = fu_indicator;
-  buffer[1] = fu_header;
-
-  if (packet.last_fragment) {
-    *bytes_to_send = packet.size + kFuAHeaderSize;
-    memcpy(buffer + kFuAHeaderSize, &payload_data_[packet.offset], packet.size);
-  } else {
-    *bytes_to_send = packet.size + kFuAHeaderSize;
-    memcpy(buffer + kFuAHeaderSize, &payload_data_[packet.offset], packet.size);
-  }
+  uint8_t* header = payload->AppendHeader(kFuAHeaderSize);
+  header[0] = fu_indicator;
+  header[1] = fu_header;
+  payload->AppendPayload(&payload_data_[packet.offset], packet.size);
   packets_.pop();
 }
 
@@ -272,15 +302,21 @@ RtpDepacketizerH264::RtpDepacketizerH264(RtpData* const callback)
 bool RtpDepacketizerH264::Parse(WebRtcRTPHeader* rtp_header,
                                 const uint8_t* payload_data,
                                 size_t payload_data_length) {
+  if (payload_data_length == 0)
+    return false;
   uint8_t nal_type = payload_data[0] & NalDefs::kTypeMask;
   size_t offset = 0;
   if (nal_type == Nalu::kFuA) {
-    // Fragmented NAL units (FU-A).
-    ParseFuaNalu(rtp_header, payload_data, payload_data_length, &offset);
+    // Fragmented NAL units (FU-A). The original NAL header is written over
+    // the FU-A header of the first fragment, so that all fragments are passed
+    // on in place and appended to the frame without further copies.
+    if (!ParseFuaNalu(rtp_header, payload_data, payload_data_length, &offset))
+      return false;
   } else {
     // We handle STAP-A and single NALU's the same way here. The jitter buffer
     // will depacketize the STAP-A into NAL units later.
-    ParseSingleNalu(rtp_header, payload_data, payload_data_length);
+    if (!ParseSingleNalu(rtp_header, payload_data, payload_data_length))
+      return false;
   }
   if (callback_->OnReceivedPayloadData(payload_data + offset,
                                        payload_data_length - offset,
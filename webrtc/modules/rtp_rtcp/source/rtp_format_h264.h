@@ -41,6 +41,9 @@ class RtpPacketizerH264 : public RtpPacketizer {
                           size_t* bytes_to_send,
                           bool* last_packet) OVERRIDE;
 
+  virtual bool NextPacketSlices(RtpPayloadSlices* payload,
+                                bool* last_packet) OVERRIDE;
+
  private:
   struct Packet {
     Packet(size_t offset,
@@ -70,14 +73,16 @@ class RtpPacketizerH264 : public RtpPacketizer {
   int PacketizeStapA(size_t fragment_index,
                      size_t fragment_offset,
                      size_t fragment_length);
-  void NextAggregatePacket(uint8_t* buffer, size_t* bytes_to_send);
-  void NextFragmentPacket(uint8_t* buffer, size_t* bytes_to_send);
+  void NextAggregatePacket(RtpPayloadSlices* payload);
+  void NextFragmentPacket(RtpPayloadSlices* payload);
 
   const uint8_t* payload_data_;
   size_t payload_size_;
   const size_t max_payload_len_;
   RTPFragmentationHeader fragmentation_;
   PacketQueue packets_;
+  // Reused by NextPacket().
+  RtpPayloadSlices packet_slices_;
 
   DISALLOW_COPY_AND_ASSIGN(RtpPacketizerH264);
 };
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
 #include <vector>
 
 #include "testing/gmock/include/gmock/gmock.h"
@@ -248,6 +250,112 @@ TEST(RtpPacketizerH264Test, TestMixedStapA_FUA) {
   EXPECT_FALSE(packetizer->NextPacket(packet, &length, &last));
 }
 
+TEST(RtpPacketizerH264Test, TestSlicesMatchCopiedPackets) {
+  const size_t kFuaNaluSize = 2 * (kMaxPayloadSize - 100);
+  const size_t kStapANaluSize = 100;
+  RTPFragmentationHeader fragmentation;
+  fragmentation.VerifyAndAllocateFragmentationHeader(3);
+  fragmentation.fragmentationOffset[0] = 0;
+  fragmentation.fragmentationLength[0] = kFuaNaluSize;
+  fragmentation.fragmentationOffset[1] = kFuaNaluSize;
+  fragmentation.fragmentationLength[1] = kStapANaluSize;
+  fragmentation.fragmentationOffset[2] = kFuaNaluSize + kStapANaluSize;
+  fragmentation.fragmentationLength[2] = kStapANaluSize;
+  const size_t kFrameSize = kFuaNaluSize + 2 * kStapANaluSize;
+  uint8_t frame[kFrameSize];
+  for (size_t i = 0; i < kFrameSize; ++i)
+    frame[i] = i;
+  for (size_t i = 0; i < fragmentation.fragmentationVectorSize; ++i)
+    frame[fragmentation.fragmentationOffset[i]] = kIdr;
+  scoped_ptr<RtpPacketizer> packetizer(
+      RtpPacketizer::Create(kRtpVideoH264, kMaxPayloadSize));
+  packetizer->SetPayloadData(frame, kFrameSize, &fragmentation);
+  scoped_ptr<RtpPacketizer> slices_packetizer(
+      RtpPacketizer::Create(kRtpVideoH264, kMaxPayloadSize));
+  slices_packetizer->SetPayloadData(frame, kFrameSize, &fragmentation);
+
+  // Two FU-A packets and one STAP-A packet.
+  RtpPayloadSlices slices;
+  bool last = false;
+  for (int i = 0; i < 3; ++i) {
+    uint8_t packet[kMaxPayloadSize] = {0};
+    size_t length = 0;
+    bool slices_last = false;
+    ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+    ASSERT_TRUE(slices_packetizer->NextPacketSlices(&slices, &slices_last));
+    EXPECT_EQ(last, slices_last);
+    ASSERT_EQ(length, slices.length());
+    uint8_t gathered[kMaxPayloadSize] = {0};
+    slices.CopyTo(gathered);
+    EXPECT_EQ(0, memcmp(packet, gathered, length));
+  }
+  EXPECT_TRUE(last);
+  EXPECT_FALSE(slices_packetizer->NextPacketSlices(&slices, &last));
+  EXPECT_EQ(0u, slices.length());
+}
+
+TEST(RtpPacketizerH264Test, TestStapACountsLengthFields) {
+  // The NAL units fit in one packet together with the STAP-A header, but not
+  // with their length fields as well.
+  const size_t kFirstNaluSize = kMaxPayloadSize / 2 - 2;
+  const size_t kSecondNaluSize = kMaxPayloadSize / 2 - 1;
+  const size_t kFrameSize = kFirstNaluSize + kSecondNaluSize;
+  uint8_t frame[kFrameSize] = {0};
+  frame[0] = Nalu::kSlice;
+  frame[kFirstNaluSize] = Nalu::kSlice;
+  RTPFragmentationHeader fragmentation;
+  fragmentation.VerifyAndAllocateFragmentationHeader(2);
+  fragmentation.fragmentationOffset[0] = 0;
+  fragmentation.fragmentationLength[0] = kFirstNaluSize;
+  fragmentation.fragmentationOffset[1] = kFirstNaluSize;
+  fragmentation.fragmentationLength[1] = kSecondNaluSize;
+  scoped_ptr<RtpPacketizer> packetizer(
+      RtpPacketizer::Create(kRtpVideoH264, kMaxPayloadSize));
+  packetizer->SetPayloadData(frame, kFrameSize, &fragmentation);
+
+  uint8_t packet[kMaxPayloadSize] = {0};
+  size_t length = 0;
+  bool last = false;
+  // Each NAL unit is sent in a packet of its own.
+  ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+  EXPECT_EQ(kFirstNaluSize, length);
+  EXPECT_FALSE(last);
+  EXPECT_EQ(Nalu::kSlice, packet[0]);
+  ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+  EXPECT_EQ(kSecondNaluSize, length);
+  EXPECT_TRUE(last);
+  EXPECT_EQ(Nalu::kSlice, packet[0]);
+  EXPECT_FALSE(packetizer->NextPacket(packet, &length, &last));
+}
+
+TEST(RtpPacketizerH264Test, TestMaxSizeNaluIsNotAggregated) {
+  const size_t kSmallNaluSize = 10;
+  const size_t kFrameSize = kMaxPayloadSize + kSmallNaluSize;
+  uint8_t frame[kFrameSize] = {0};
+  frame[0] = Nalu::kIdr;
+  frame[kMaxPayloadSize] = Nalu::kSlice;
+  RTPFragmentationHeader fragmentation;
+  fragmentation.VerifyAndAllocateFragmentationHeader(2);
+  fragmentation.fragmentationOffset[0] = 0;
+  fragmentation.fragmentationLength[0] = kMaxPayloadSize;
+  fragmentation.fragmentationOffset[1] = kMaxPayloadSize;
+  fragmentation.fragmentationLength[1] = kSmallNaluSize;
+  scoped_ptr<RtpPacketizer> packetizer(
+      RtpPacketizer::Create(kRtpVideoH264, kMaxPayloadSize));
+  packetizer->SetPayloadData(frame, kFrameSize, &fragmentation);
+
+  uint8_t packet[kMaxPayloadSize] = {0};
+  size_t length = 0;
+  bool last = false;
+  ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+  EXPECT_EQ(kMaxPayloadSize, length);
+  EXPECT_EQ(Nalu::kIdr, packet[0]);
+  ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+  EXPECT_EQ(kSmallNaluSize, length);
+  EXPECT_EQ(Nalu::kSlice, packet[0]);
+  EXPECT_TRUE(last);
+}
+
 TEST(RtpPacketizerH264Test, TestFUAOddSize) {
   const size_t kExpectedPayloadSizes[2] = {600, 600};
   TestFua(
@@ -359,6 +467,38 @@ TEST_F(RtpDepacketizerH264Test, TestStapADelta) {
   EXPECT_TRUE(last_header_.type.Video.codecHeader.H264.stap_a);
 }
 
+TEST_F(RtpDepacketizerH264Test, TestStapAKeyNotFirst) {
+  uint8_t packet[9] = {Nalu::kStapA,  // F=0, NRI=0, Type=24.
+                       // Length, nal header, payload.
+                       0, 0x02, Nalu::kSei, 0xFF,
+                       0, 0x02, Nalu::kIdr, 0xFF};
+
+  WebRtcRTPHeader expected_header = WebRtcRTPHeader();
+  ExpectPacket(packet, sizeof(packet));
+  EXPECT_TRUE(depacketizer_->Parse(&expected_header, packet, sizeof(packet)));
+  EXPECT_EQ(kVideoFrameKey, last_header_.frameType);
+  EXPECT_TRUE(last_header_.type.Video.codecHeader.H264.stap_a);
+}
+
+TEST_F(RtpDepacketizerH264Test, TestMalformedPacketsAreDropped) {
+  EXPECT_CALL(callback_, OnReceivedPayloadData(_, _, _)).Times(0);
+  WebRtcRTPHeader header = WebRtcRTPHeader();
+
+  // The second NAL unit is longer than the rest of the packet.
+  uint8_t long_stap_a[8] = {Nalu::kStapA, 0, 0x02, Nalu::kIdr, 0xFF,
+                            0, 0x04, Nalu::kIdr};
+  EXPECT_FALSE(depacketizer_->Parse(&header, long_stap_a,
+                                    sizeof(long_stap_a)));
+  // A length field cut in half.
+  uint8_t truncated_stap_a[5] = {Nalu::kStapA, 0, 0x01, Nalu::kIdr, 0};
+  EXPECT_FALSE(depacketizer_->Parse(&header, truncated_stap_a,
+                                    sizeof(truncated_stap_a)));
+  // An FU-A without payload.
+  uint8_t empty_fu_a[2] = {Nalu::kFuA, FuDefs::kSBit | Nalu::kIdr};
+  EXPECT_FALSE(depacketizer_->Parse(&header, empty_fu_a, sizeof(empty_fu_a)));
+  EXPECT_FALSE(depacketizer_->Parse(&header, empty_fu_a, 0));
+}
+
 TEST_F(RtpDepacketizerH264Test, TestFuA) {
   uint8_t packet1[3] = {
       Nalu::kFuA,                  // F=0, NRI=0, Type=28.
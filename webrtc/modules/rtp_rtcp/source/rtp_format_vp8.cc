@@ -80,6 +80,17 @@ void RtpPacketizerVp8::SetPayloadData(
 bool RtpPacketizerVp8::NextPacket(uint8_t* buffer,
                                   size_t* bytes_to_send,
                                   bool* last_packet) {
+  if (!NextPacketSlices(&packet_slices_, last_packet)) {
+    return false;
+  }
+  packet_slices_.CopyTo(buffer);
+  *bytes_to_send = packet_slices_.length();
+  return true;
+}
+
+bool RtpPacketizerVp8::NextPacketSlices(RtpPayloadSlices* payload,
+                                        bool* last_packet) {
+  payload->Clear();
   if (!packets_calculated_) {
     int ret = 0;
     if (aggr_mode_ == kAggrPartitions && balance_) {
@@ -97,11 +108,9 @@ bool RtpPacketizerVp8::NextPacket(uint8_t* buffer,
   InfoStruct packet_info = packets_.front();
   packets_.pop();
 
-  int bytes = WriteHeaderAndPayload(packet_info, buffer, max_payload_len_);
-  if (bytes < 0) {
+  if (WriteHeaderAndPayload(packet_info, payload) < 0) {
     return false;
   }
-  *bytes_to_send = bytes;
 
   *last_packet = packets_.empty();
   return true;
@@ -309,8 +318,7 @@ void RtpPacketizerVp8::QueuePacket(int start_pos,
 }
 
 int RtpPacketizerVp8::WriteHeaderAndPayload(const InfoStruct& packet_info,
-                                            uint8_t* buffer,
-                                            int buffer_length) const {
+                                            RtpPayloadSlices* payload) const {
   // Write the VP8 payload descriptor.
   //       0
   //       0 1 2 3 4 5 6 7 8
@@ -327,20 +335,24 @@ int RtpPacketizerVp8::WriteHeaderAndPayload(const InfoStruct& packet_info,
   //      +-+-+-+-+-+-+-+-+-+
 
   assert(packet_info.size > 0);
+  const int header_length =
+      vp8_fixed_payload_descriptor_bytes_ + PayloadDescriptorExtraLength();
+  uint8_t* buffer = payload->AppendHeader(header_length);
   buffer[0] = 0;
   if (XFieldPresent())            buffer[0] |= kXBit;
   if (hdr_info_.nonReference)     buffer[0] |= kNBit;
   if (packet_info.first_fragment) buffer[0] |= kSBit;
   buffer[0] |= (packet_info.first_partition_ix & kPartIdField);
 
-  const int extension_length = WriteExtensionFields(buffer, buffer_length);
+  if (WriteExtensionFields(buffer, header_length) < 0) {
+    return -1;
+  }
 
-  memcpy(&buffer[vp8_fixed_payload_descriptor_bytes_ + extension_length],
-         &payload_data_[packet_info.payload_start_pos], packet_info.size);
+  payload->AppendPayload(&payload_data_[packet_info.payload_start_pos],
+                         packet_info.size);
 
-  // Return total length of written data.
-  return packet_info.size + vp8_fixed_payload_descriptor_bytes_
-      + extension_length;
+  // Return total length of the payload.
+  return static_cast<int>(payload->length());
 }
 
 int RtpPacketizerVp8::WriteExtensionFields(uint8_t* buffer,
@@ -79,6 +79,9 @@ class RtpPacketizerVp8 : public RtpPacketizer {
                           size_t* bytes_to_send,
                           bool* last_packet) OVERRIDE;
 
+  virtual bool NextPacketSlices(RtpPayloadSlices* payload,
+                                bool* last_packet) OVERRIDE;
+
  private:
   typedef struct {
     int payload_start_pos;
@@ -137,12 +140,12 @@ class RtpPacketizerVp8 : public RtpPacketizer {
                    int first_partition_in_packet,
                    bool start_on_new_fragment);
 
-  // Write the payload header and copy the payload to the buffer.
-  // The info in packet_info determines which part of the payload is written
-  // and what to write in the header fields.
+  // Write the payload header and append a reference to the payload to
+  // |payload|. The info in packet_info determines which part of the payload
+  // is referenced and what to write in the header fields. Returns the payload
+  // length, or -1 on error.
   int WriteHeaderAndPayload(const InfoStruct& packet_info,
-                            uint8_t* buffer,
-                            int buffer_length) const;
+                            RtpPayloadSlices* payload) const;
 
 
   // Write the X field and the appropriate extension fields to buffer.
@@ -199,6 +202,8 @@ class RtpPacketizerVp8 : public RtpPacketizer {
   const int max_payload_len_;
   InfoQueue packets_;
   bool packets_calculated_;
+  // Reused by NextPacket().
+  RtpPayloadSlices packet_slices_;
 
   DISALLOW_COPY_AND_ASSIGN(RtpPacketizerVp8);
 };
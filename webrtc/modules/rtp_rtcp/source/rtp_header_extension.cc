@@ -16,30 +16,48 @@
 namespace webrtc {
 
 RtpHeaderExtensionMap::RtpHeaderExtensionMap() {
+  Erase();
 }
 
 RtpHeaderExtensionMap::~RtpHeaderExtensionMap() {
-  Erase();
 }
 
 void RtpHeaderExtensionMap::Erase() {
-  while (!extensionMap_.empty()) {
-    std::map<uint8_t, HeaderExtension*>::iterator it =
-        extensionMap_.begin();
-    delete it->second;
-    extensionMap_.erase(it);
+  for (uint8_t id = 0; id < kNumIds; ++id)
+    types_[id] = kRtpExtensionNone;
+  size_ = 0;
+  UpdateLayout();
+}
+
+void RtpHeaderExtensionMap::UpdateLayout() {
+  for (int type = 0; type < kNumTypes; ++type) {
+    ids_[type] = 0;
+    block_starts_[type] = 0;
+  }
+  // The blocks are laid out in the order of their IDs.
+  uint16_t length = 0;
+  for (uint8_t id = kMinId; id <= kMaxId; ++id) {
+    const RTPExtensionType type = types_[id];
+    if (type == kRtpExtensionNone)
+      continue;
+    ids_[type] = id;
+    block_starts_[type] = kRtpOneByteHeaderLength + length;
+    length += HeaderExtension(type).length;
+  }
+  // Add RTP extension header length.
+  if (length > 0) {
+    length += kRtpOneByteHeaderLength;
   }
+  total_length_ = length;
 }
 
 int32_t RtpHeaderExtensionMap::Register(const RTPExtensionType type,
                                         const uint8_t id) {
-  if (id < 1 || id > 14) {
+  if (type == kRtpExtensionNone || id < kMinId || id > kMaxId) {
     return -1;
   }
-  std::map<uint8_t, HeaderExtension*>::iterator it =
-      extensionMap_.find(id);
-  if (it != extensionMap_.end()) {
-    if (it->second->type != type) {
+  if (types_[id] != kRtpExtensionNone) {
+    if (types_[id] != type) {
       // An extension is already registered with the same id
       // but a different type, so return failure.
       return -1;
@@ -48,7 +66,9 @@ int32_t RtpHeaderExtensionMap::Register(const RTPExtensionType type,
     // so return success.
     return 0;
   }
-  extensionMap_[id] = new HeaderExtension(type);
+  types_[id] = type;
+  ++size_;
+  UpdateLayout();
   return 0;
 }
 
@@ -57,107 +77,60 @@ int32_t RtpHeaderExtensionMap::Deregister(const RTPExtensionType type) {
   if (GetId(type, &id) != 0) {
     return 0;
   }
-  std::map<uint8_t, HeaderExtension*>::iterator it =
-      extensionMap_.find(id);
-  assert(it != extensionMap_.end());
-  delete it->second;
-  extensionMap_.erase(it);
+  types_[id] = kRtpExtensionNone;
+  --size_;
+  UpdateLayout();
   return 0;
 }
 
 bool RtpHeaderExtensionMap::IsRegistered(RTPExtensionType type) const {
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-    extensionMap_.begin();
-  for (; it != extensionMap_.end(); ++it) {
-    if (it->second->type == type)
-      return true;
-  }
-  return false;
+  uint8_t id;
+  return GetId(type, &id) == 0;
 }
 
 int32_t RtpHeaderExtensionMap::GetType(const uint8_t id,
                                        RTPExtensionType* type) const {
   assert(type);
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.find(id);
-  if (it == extensionMap_.end()) {
+  RTPExtensionType registered_type = GetTypeOrNone(id);
+  if (registered_type == kRtpExtensionNone) {
     return -1;
   }
-  HeaderExtension* extension = it->second;
-  *type = extension->type;
+  *type = registered_type;
   return 0;
 }
 
 int32_t RtpHeaderExtensionMap::GetId(const RTPExtensionType type,
                                      uint8_t* id) const {
   assert(id);
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-
-  while (it != extensionMap_.end()) {
-    HeaderExtension* extension = it->second;
-    if (extension->type == type) {
-      *id = it->first;
-      return 0;
-    }
-    it++;
+  if (type <= kRtpExtensionNone || type >= kNumTypes || ids_[type] == 0) {
+    return -1;
   }
-  return -1;
+  *id = ids_[type];
+  return 0;
 }
 
 uint16_t RtpHeaderExtensionMap::GetTotalLengthInBytes() const {
-  // Get length for each extension block.
-  uint16_t length = 0;
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-  while (it != extensionMap_.end()) {
-    HeaderExtension* extension = it->second;
-    length += extension->length;
-    it++;
-  }
-  // Add RTP extension header length.
-  if (length > 0) {
-    length += kRtpOneByteHeaderLength;
-  }
-  return length;
+  return total_length_;
 }
 
 int32_t RtpHeaderExtensionMap::GetLengthUntilBlockStartInBytes(
     const RTPExtensionType type) const {
-  uint8_t id;
-  if (GetId(type, &id) != 0) {
-    // Not registered.
+  if (!IsRegistered(type)) {
     return -1;
   }
-  // Get length until start of extension block type.
-  uint16_t length = kRtpOneByteHeaderLength;
-
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-  while (it != extensionMap_.end()) {
-    HeaderExtension* extension = it->second;
-    if (extension->type == type) {
-      break;
-    } else {
-      length += extension->length;
-    }
-    it++;
-  }
-  return length;
+  return block_starts_[type];
 }
 
 int32_t RtpHeaderExtensionMap::Size() const {
-  return extensionMap_.size();
+  return size_;
 }
 
 RTPExtensionType RtpHeaderExtensionMap::First() const {
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-  if (it == extensionMap_.end()) {
-     return kRtpExtensionNone;
+  for (uint8_t id = kMinId; id <= kMaxId; ++id) {
+    if (types_[id] != kRtpExtensionNone)
+      return types_[id];
   }
-  HeaderExtension* extension = it->second;
-  return extension->type;
+  return kRtpExtensionNone;
 }
 
 RTPExtensionType RtpHeaderExtensionMap::Next(RTPExtensionType type) const {
@@ -165,27 +138,18 @@ RTPExtensionType RtpHeaderExtensionMap::Next(RTPExtensionType type) const {
   if (GetId(type, &id) != 0) {
     return kRtpExtensionNone;
   }
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.find(id);
-  if (it == extensionMap_.end()) {
-    return kRtpExtensionNone;
-  }
-  it++;
-  if (it == extensionMap_.end()) {
-    return kRtpExtensionNone;
+  for (++id; id <= kMaxId; ++id) {
+    if (types_[id] != kRtpExtensionNone)
+      return types_[id];
   }
-  HeaderExtension* extension = it->second;
-  return extension->type;
+  return kRtpExtensionNone;
 }
 
 void RtpHeaderExtensionMap::GetCopy(RtpHeaderExtensionMap* map) const {
   assert(map);
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-  while (it != extensionMap_.end()) {
-    HeaderExtension* extension = it->second;
-    map->Register(extension->type, it->first);
-    it++;
+  for (uint8_t id = kMinId; id <= kMaxId; ++id) {
+    if (types_[id] != kRtpExtensionNone)
+      map->Register(types_[id], id);
   }
 }
 }  // namespace webrtc
@@ -11,8 +11,6 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_RTP_HEADER_EXTENSION_H_
 #define WEBRTC_MODULES_RTP_RTCP_RTP_HEADER_EXTENSION_H_
 
-#include <map>
-
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 #include "webrtc/typedefs.h"
 
@@ -24,6 +22,7 @@ const size_t kRtpOneByteHeaderLength = 4;
 const size_t kTransmissionTimeOffsetLength = 4;
 const size_t kAudioLevelLength = 4;
 const size_t kAbsoluteSendTimeLength = 4;
+const size_t kTransportSequenceNumberLength = 4;
 
 struct HeaderExtension {
   HeaderExtension(RTPExtensionType extension_type)
@@ -42,6 +41,9 @@ struct HeaderExtension {
       case kRtpExtensionAbsoluteSendTime:
         length = kAbsoluteSendTimeLength;
         break;
+      case kRtpExtensionTransportSequenceNumber:
+        length = kTransportSequenceNumberLength;
+        break;
       default:
         assert(false);
     }
@@ -51,6 +53,11 @@ struct HeaderExtension {
    uint8_t length;
 };
 
+// Maps the one-byte header extension IDs to extension types. The map is a
+// table indexed by ID, so that looking up the IDs of a received packet is a
+// plain array access, and copying the map doesn't allocate. The ID and block
+// position of each type are cached when the map changes, since the sender
+// looks them up for every packet it stamps.
 class RtpHeaderExtensionMap {
  public:
   RtpHeaderExtensionMap();
@@ -66,6 +73,11 @@ class RtpHeaderExtensionMap {
 
   int32_t GetType(const uint8_t id, RTPExtensionType* type) const;
 
+  // Same as GetType(), but returns kRtpExtensionNone if |id| isn't registered.
+  RTPExtensionType GetTypeOrNone(uint8_t id) const {
+    return id < kNumIds ? types_[id] : kRtpExtensionNone;
+  }
+
   int32_t GetId(const RTPExtensionType type, uint8_t* id) const;
 
   uint16_t GetTotalLengthInBytes() const;
@@ -81,7 +93,25 @@ class RtpHeaderExtensionMap {
   RTPExtensionType Next(RTPExtensionType type) const;
 
  private:
-  std::map<uint8_t, HeaderExtension*> extensionMap_;
+  // The one-byte header has a four bit ID; 0 and 15 are reserved.
+  static const uint8_t kMinId = 1;
+  static const uint8_t kMaxId = 14;
+  static const uint8_t kNumIds = 16;
+
+  static const int kNumTypes = kRtpExtensionTransportSequenceNumber + 1;
+
+  // Recomputes |ids_|, |block_starts_| and |total_length_| from |types_|.
+  void UpdateLayout();
+
+  // Indexed by ID. kRtpExtensionNone for the IDs that aren't registered.
+  RTPExtensionType types_[kNumIds];
+  int32_t size_;
+  // Indexed by type. Zero for the types that aren't registered.
+  uint8_t ids_[kNumTypes];
+  // Indexed by type. The length until the start of the block of each
+  // registered type, including the one-byte header.
+  uint16_t block_starts_[kNumTypes];
+  uint16_t total_length_;
 };
 }
 
@@ -111,10 +111,52 @@ TEST_F(RtpHeaderExtensionTest, GetCopy) {
   EXPECT_EQ(kRtpExtensionTransmissionTimeOffset, mapOut.First());
 }
 
+TEST_F(RtpHeaderExtensionTest, GetTypeOrNone) {
+  EXPECT_EQ(kRtpExtensionNone, map_.GetTypeOrNone(kId));
+  EXPECT_EQ(0, map_.Register(kRtpExtensionAbsoluteSendTime, kId));
+  EXPECT_EQ(kRtpExtensionAbsoluteSendTime, map_.GetTypeOrNone(kId));
+  EXPECT_EQ(kRtpExtensionNone, map_.GetTypeOrNone(kId + 1));
+  EXPECT_EQ(kRtpExtensionNone, map_.GetTypeOrNone(15));
+  EXPECT_EQ(kRtpExtensionNone, map_.GetTypeOrNone(255));
+}
+
+TEST_F(RtpHeaderExtensionTest, BlocksAreOrderedById) {
+  EXPECT_EQ(0, map_.Register(kRtpExtensionAbsoluteSendTime, kId + 1));
+  EXPECT_EQ(0, map_.Register(kRtpExtensionTransmissionTimeOffset, kId));
+  EXPECT_EQ(2, map_.Size());
+  EXPECT_EQ(kRtpExtensionTransmissionTimeOffset, map_.First());
+  EXPECT_EQ(kRtpExtensionAbsoluteSendTime,
+            map_.Next(kRtpExtensionTransmissionTimeOffset));
+  EXPECT_EQ(static_cast<int>(kRtpOneByteHeaderLength +
+                             kTransmissionTimeOffsetLength),
+            map_.GetLengthUntilBlockStartInBytes(
+                kRtpExtensionAbsoluteSendTime));
+
+  // A copy is independent of the original.
+  RtpHeaderExtensionMap copy = map_;
+  EXPECT_EQ(0, map_.Deregister(kRtpExtensionTransmissionTimeOffset));
+  EXPECT_EQ(1, map_.Size());
+  EXPECT_EQ(2, copy.Size());
+  EXPECT_EQ(kRtpExtensionTransmissionTimeOffset, copy.GetTypeOrNone(kId));
+
+  // The layout follows the registrations.
+  EXPECT_EQ(static_cast<int>(kRtpOneByteHeaderLength),
+            map_.GetLengthUntilBlockStartInBytes(
+                kRtpExtensionAbsoluteSendTime));
+  EXPECT_EQ(kRtpOneByteHeaderLength + kAbsoluteSendTimeLength,
+            map_.GetTotalLengthInBytes());
+  EXPECT_EQ(static_cast<int>(kRtpOneByteHeaderLength +
+                             kTransmissionTimeOffsetLength),
+            copy.GetLengthUntilBlockStartInBytes(
+                kRtpExtensionAbsoluteSendTime));
+}
+
 TEST_F(RtpHeaderExtensionTest, Erase) {
   EXPECT_EQ(0, map_.Register(kRtpExtensionTransmissionTimeOffset, kId));
   EXPECT_EQ(1, map_.Size());
   map_.Erase();
   EXPECT_EQ(0, map_.Size());
+  EXPECT_EQ(0, map_.GetTotalLengthInBytes());
+  EXPECT_FALSE(map_.IsRegistered(kRtpExtensionTransmissionTimeOffset));
 }
 }  // namespace webrtc
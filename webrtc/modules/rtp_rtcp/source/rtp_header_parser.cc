@@ -53,10 +53,12 @@ bool RtpHeaderParserImpl::Parse(const uint8_t* packet,
   RtpUtility::RtpHeaderParser rtp_parser(packet, length);
   memset(header, 0, sizeof(*header));
 
+  // The map is a small table, so copying it is cheaper than parsing under the
+  // lock.
   RtpHeaderExtensionMap map;
   {
     CriticalSectionScoped cs(critical_section_.get());
-    rtp_header_extension_map_.GetCopy(&map);
+    map = rtp_header_extension_map_;
   }
 
   const bool valid_rtpheader = rtp_parser.Parse(*header, &map);
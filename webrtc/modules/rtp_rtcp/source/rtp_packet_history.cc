@@ -12,10 +12,9 @@
 
 #include <assert.h>
 #include <stdlib.h>
-#include <string.h>   // memset
-#include <limits>
-#include <set>
+#include <string.h>   // memcpy
 
+#include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
@@ -24,12 +23,33 @@ namespace webrtc {
 
 enum { kMinPacketRequestBytes = 50 };
 
+RTPPacketHistory::BorrowedPacket::BorrowedPacket()
+    : critsect_(NULL),
+      data_(NULL),
+      length_(0),
+      stored_time_ms_(0) {
+}
+
+RTPPacketHistory::BorrowedPacket::~BorrowedPacket() {
+  Release();
+}
+
+void RTPPacketHistory::BorrowedPacket::Release() {
+  if (!critsect_)
+    return;
+  data_ = NULL;
+  length_ = 0;
+  CriticalSectionWrapper* critsect = critsect_;
+  critsect_ = NULL;
+  critsect->Leave();
+}
+
 RTPPacketHistory::RTPPacketHistory(Clock* clock)
   : clock_(clock),
     critsect_(CriticalSectionWrapper::CreateCriticalSection()),
     store_(false),
-    prev_index_(0),
-    max_packet_length_(0) {
+    max_packet_length_(0),
+    slot_mask_(0) {
 }
 
 RTPPacketHistory::~RTPPacketHistory() {
@@ -58,12 +78,13 @@ void RTPPacketHistory::Allocate(uint16_t number_to_store) {
   assert(number_to_store > 0);
   assert(!store_);
   store_ = true;
-  stored_packets_.resize(number_to_store);
-  stored_seq_nums_.resize(number_to_store);
-  stored_lengths_.resize(number_to_store);
-  stored_times_.resize(number_to_store);
-  stored_send_times_.resize(number_to_store);
-  stored_types_.resize(number_to_store);
+  // Round up to a power of two, so that a sequence number maps to its slot
+  // with a mask, also across the sequence number wrap.
+  uint32_t number_of_slots = 1;
+  while (number_of_slots < number_to_store)
+    number_of_slots <<= 1;
+  slot_mask_ = static_cast<uint16_t>(number_of_slots - 1);
+  slots_.resize(number_of_slots);
 }
 
 void RTPPacketHistory::Free() {
@@ -71,20 +92,11 @@ void RTPPacketHistory::Free() {
     return;
   }
 
-  std::vector<std::vector<uint8_t> >::iterator it;
-  for (it = stored_packets_.begin(); it != stored_packets_.end(); ++it) {
-    it->clear();
-  }
-
-  stored_packets_.clear();
-  stored_seq_nums_.clear();
-  stored_lengths_.clear();
-  stored_times_.clear();
-  stored_send_times_.clear();
-  stored_types_.clear();
+  std::vector<StoredPacket>().swap(slots_);
+  std::vector<uint8_t>().swap(packet_buffer_);
 
   store_ = false;
-  prev_index_ = 0;
+  slot_mask_ = 0;
   max_packet_length_ = 0;
 }
 
@@ -104,10 +116,16 @@ void RTPPacketHistory::VerifyAndAllocatePacketLength(uint16_t packet_length) {
     return;
   }
 
-  std::vector<std::vector<uint8_t> >::iterator it;
-  for (it = stored_packets_.begin(); it != stored_packets_.end(); ++it) {
-    it->resize(packet_length);
+  // The payloads are laid out with a stride of |max_packet_length_|, so the
+  // stored packets have to be moved to the new layout.
+  std::vector<uint8_t> packet_buffer(slots_.size() * packet_length);
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    if (slots_[i].length == 0)
+      continue;
+    memcpy(&packet_buffer[i * packet_length],
+           &packet_buffer_[i * max_packet_length_], slots_[i].length);
   }
+  packet_buffer_.swap(packet_buffer);
   max_packet_length_ = packet_length;
 }
 
@@ -128,33 +146,73 @@ int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
   assert(packet);
   assert(packet_length > 3);
 
+  uint8_t* slot_data = StorePacketInfo(packet, packet_length, max_packet_length,
+                                       capture_time_ms, type);
+  if (!slot_data)
+    return -1;
+  memcpy(slot_data, packet, packet_length);
+  return 0;
+}
+
+int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* rtp_header,
+                                       uint16_t rtp_header_length,
+                                       const RtpPayloadSlices& payload,
+                                       uint16_t max_packet_length,
+                                       int64_t capture_time_ms,
+                                       StorageType type) {
+  if (type == kDontStore) {
+    return 0;
+  }
+
+  CriticalSectionScoped cs(critsect_);
+  if (!store_) {
+    return 0;
+  }
+
+  assert(rtp_header);
+  assert(rtp_header_length > 3);
+
+  const size_t packet_length = rtp_header_length + payload.length();
+  if (packet_length > 0xFFFF) {
+    LOG(LS_WARNING) << "Failed to store RTP packet with length: "
+                    << packet_length;
+    return -1;
+  }
+  uint8_t* slot_data = StorePacketInfo(
+      rtp_header, static_cast<uint16_t>(packet_length), max_packet_length,
+      capture_time_ms, type);
+  if (!slot_data)
+    return -1;
+  memcpy(slot_data, rtp_header, rtp_header_length);
+  payload.CopyTo(slot_data + rtp_header_length);
+  return 0;
+}
+
+uint8_t* RTPPacketHistory::StorePacketInfo(const uint8_t* rtp_header,
+                                           uint16_t packet_length,
+                                           uint16_t max_packet_length,
+                                           int64_t capture_time_ms,
+                                           StorageType type) {
   VerifyAndAllocatePacketLength(max_packet_length);
 
   if (packet_length > max_packet_length_) {
     LOG(LS_WARNING) << "Failed to store RTP packet with length: "
                     << packet_length;
-    return -1;
+    return NULL;
   }
 
-  const uint16_t seq_num = (packet[2] << 8) + packet[3];
+  const uint16_t seq_num = (rtp_header[2] << 8) + rtp_header[3];
 
   // Store packet
-  std::vector<std::vector<uint8_t> >::iterator it =
-      stored_packets_.begin() + prev_index_;
-  std::copy(packet, packet + packet_length, it->begin());
-
-  stored_seq_nums_[prev_index_] = seq_num;
-  stored_lengths_[prev_index_] = packet_length;
-  stored_times_[prev_index_] = (capture_time_ms > 0) ? capture_time_ms :
+  const int index = seq_num & slot_mask_;
+  StoredPacket& slot = slots_[index];
+  slot.sequence_number = seq_num;
+  slot.length = packet_length;
+  slot.stored_time_ms = (capture_time_ms > 0) ? capture_time_ms :
       clock_->TimeInMilliseconds();
-  stored_send_times_[prev_index_] = 0;  // Packet not sent.
-  stored_types_[prev_index_] = type;
-
-  ++prev_index_;
-  if (prev_index_ >= stored_seq_nums_.size()) {
-    prev_index_ = 0;
-  }
-  return 0;
+  slot.send_time_ms = 0;  // Packet not sent.
+  slot.type = type;
+  return &packet_buffer_[index * max_packet_length_];
 }
 
 bool RTPPacketHistory::HasRTPPacket(uint16_t sequence_number) const {
@@ -162,19 +220,7 @@ bool RTPPacketHistory::HasRTPPacket(uint16_t sequence_number) const {
   if (!store_) {
     return false;
   }
-
-  int32_t index = 0;
-  bool found = FindSeqNum(sequence_number, &index);
-  if (!found) {
-    return false;
-  }
-
-  uint16_t length = stored_lengths_.at(index);
-  if (length == 0 || length > max_packet_length_) {
-    // Invalid length.
-    return false;
-  }
-  return true;
+  return FindSeqNum(sequence_number) >= 0;
 }
 
 bool RTPPacketHistory::GetPacketAndSetSendTime(uint16_t sequence_number,
@@ -189,50 +235,68 @@ bool RTPPacketHistory::GetPacketAndSetSendTime(uint16_t sequence_number,
     return false;
   }
 
-  int32_t index = 0;
-  bool found = FindSeqNum(sequence_number, &index);
-  if (!found) {
+  int index = FindSeqNum(sequence_number);
+  if (index < 0) {
     LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number;
     return false;
   }
 
-  uint16_t length = stored_lengths_.at(index);
-  assert(length <= max_packet_length_);
-  if (length == 0) {
-    LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number
-                    << ", len " << length;
+  StoredPacket* slot = &slots_[index];
+  if (!CheckAndSetSendTime(slot, min_elapsed_time_ms, retransmit))
     return false;
+  memcpy(packet, PacketData(index), slot->length);
+  *packet_length = slot->length;
+  *stored_time_ms = slot->stored_time_ms;
+  return true;
+}
+
+bool RTPPacketHistory::BorrowPacketAndSetSendTime(uint16_t sequence_number,
+                                                  uint32_t min_elapsed_time_ms,
+                                                  bool retransmit,
+                                                  BorrowedPacket* packet) {
+  assert(packet->critsect_ == NULL);
+  critsect_->Enter();
+  if (store_) {
+    int index = FindSeqNum(sequence_number);
+    if (index < 0) {
+      LOG(LS_WARNING) << "No match for getting seqNum " << sequence_number;
+    } else if (CheckAndSetSendTime(&slots_[index], min_elapsed_time_ms,
+                                   retransmit)) {
+      // The lock is handed over to |packet|.
+      packet->critsect_ = critsect_;
+      packet->data_ = PacketData(index);
+      packet->length_ = slots_[index].length;
+      packet->stored_time_ms_ = slots_[index].stored_time_ms;
+      return true;
+    }
   }
+  critsect_->Leave();
+  return false;
+}
+
+bool RTPPacketHistory::CheckAndSetSendTime(StoredPacket* slot,
+                                           uint32_t min_elapsed_time_ms,
+                                           bool retransmit) {
+  assert(slot->length <= max_packet_length_);
 
   // Verify elapsed time since last retrieve.
   int64_t now = clock_->TimeInMilliseconds();
   if (min_elapsed_time_ms > 0 &&
-      ((now - stored_send_times_.at(index)) < min_elapsed_time_ms)) {
+      ((now - slot->send_time_ms) < min_elapsed_time_ms)) {
     return false;
   }
 
-  if (retransmit && stored_types_.at(index) == kDontRetransmit) {
+  if (retransmit && slot->type == kDontRetransmit) {
     // No bytes copied since this packet shouldn't be retransmitted or is
     // of zero size.
     return false;
   }
-  stored_send_times_[index] = clock_->TimeInMilliseconds();
-  GetPacket(index, packet, packet_length, stored_time_ms);
+  slot->send_time_ms = now;
   return true;
 }
 
-void RTPPacketHistory::GetPacket(int index,
-                                 uint8_t* packet,
-                                 uint16_t* packet_length,
-                                 int64_t* stored_time_ms) const {
-  // Get packet.
-  uint16_t length = stored_lengths_.at(index);
-  std::vector<std::vector<uint8_t> >::const_iterator it_found_packet =
-      stored_packets_.begin() + index;
-  std::copy(it_found_packet->begin(), it_found_packet->begin() + length,
-            packet);
-  *packet_length = length;
-  *stored_time_ms = stored_times_.at(index);
+const uint8_t* RTPPacketHistory::PacketData(int index) const {
+  return &packet_buffer_[index * max_packet_length_];
 }
 
 bool RTPPacketHistory::GetBestFittingPacket(uint8_t* packet,
@@ -244,54 +308,30 @@ bool RTPPacketHistory::GetBestFittingPacket(uint8_t* packet,
   int index = FindBestFittingPacket(*packet_length);
   if (index < 0)
     return false;
-  GetPacket(index, packet, packet_length, stored_time_ms);
+  memcpy(packet, PacketData(index), slots_[index].length);
+  *packet_length = slots_[index].length;
+  *stored_time_ms = slots_[index].stored_time_ms;
   return true;
 }
 
 // private, lock should already be taken
-bool RTPPacketHistory::FindSeqNum(uint16_t sequence_number,
-                                  int32_t* index) const {
-  uint16_t temp_sequence_number = 0;
-  if (prev_index_ > 0) {
-    *index = prev_index_ - 1;
-    temp_sequence_number = stored_seq_nums_[*index];
-  } else {
-    *index = stored_seq_nums_.size() - 1;
-    temp_sequence_number = stored_seq_nums_[*index];  // wrap
-  }
-
-  int32_t idx = (prev_index_ - 1) - (temp_sequence_number - sequence_number);
-  if (idx >= 0 && idx < static_cast<int>(stored_seq_nums_.size())) {
-    *index = idx;
-    temp_sequence_number = stored_seq_nums_[*index];
-  }
-
-  if (temp_sequence_number != sequence_number) {
-    // We did not found a match, search all.
-    for (uint16_t m = 0; m < stored_seq_nums_.size(); m++) {
-      if (stored_seq_nums_[m] == sequence_number) {
-        *index = m;
-        temp_sequence_number = stored_seq_nums_[*index];
-        break;
-      }
-    }
-  }
-  if (temp_sequence_number == sequence_number) {
-    // We found a match.
-    return true;
-  }
-  return false;
+int RTPPacketHistory::FindSeqNum(uint16_t sequence_number) const {
+  int index = sequence_number & slot_mask_;
+  const StoredPacket& slot = slots_[index];
+  if (slot.length == 0 || slot.sequence_number != sequence_number)
+    return -1;
+  return index;
 }
 
 int RTPPacketHistory::FindBestFittingPacket(uint16_t size) const {
-  if (size < kMinPacketRequestBytes || stored_lengths_.empty())
+  if (size < kMinPacketRequestBytes || slots_.empty())
     return -1;
   int min_diff = -1;
   size_t best_index = 0;
-  for (size_t i = 0; i < stored_lengths_.size(); ++i) {
-    if (stored_lengths_[i] == 0)
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    if (slots_[i].length == 0)
       continue;
-    int diff = abs(stored_lengths_[i] - size);
+    int diff = abs(slots_[i].length - size);
     if (min_diff < 0 || diff < min_diff) {
       min_diff = diff;
       best_index = i;
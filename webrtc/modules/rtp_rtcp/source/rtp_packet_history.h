@@ -15,6 +15,7 @@
 
 #include <vector>
 
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 #include "webrtc/typedefs.h"
@@ -24,9 +25,40 @@ namespace webrtc {
 
 class Clock;
 class CriticalSectionWrapper;
+class RtpPayloadSlices;
 
+// Packets are stored in a ring of slots indexed by sequence number, so every
+// lookup is O(1). The ring holds at least as many packets as requested in
+// SetStorePacketsStatus(); a stored packet is evicted by the packet whose
+// sequence number maps to the same slot.
 class RTPPacketHistory {
  public:
+  // Read access to a stored packet without copying it, see
+  // BorrowPacketAndSetSendTime(). The history stays locked while a packet is
+  // borrowed, so the object should be short-lived.
+  class BorrowedPacket {
+   public:
+    BorrowedPacket();
+    ~BorrowedPacket();
+
+    // Returns the packet to the history. Called by the destructor.
+    void Release();
+
+    const uint8_t* data() const { return data_; }
+    uint16_t length() const { return length_; }
+    int64_t stored_time_ms() const { return stored_time_ms_; }
+
+   private:
+    friend class RTPPacketHistory;
+
+    CriticalSectionWrapper* critsect_;
+    const uint8_t* data_;
+    uint16_t length_;
+    int64_t stored_time_ms_;
+
+    DISALLOW_COPY_AND_ASSIGN(BorrowedPacket);
+  };
+
   RTPPacketHistory(Clock* clock);
   ~RTPPacketHistory();
 
@@ -41,6 +73,15 @@ class RTPPacketHistory {
                        int64_t capture_time_ms,
                        StorageType type);
 
+  // Same as above, but gathers the packet from the RTP header in |rtp_header|
+  // and the payload in |payload|, so that the payload is copied only once.
+  int32_t PutRTPPacket(const uint8_t* rtp_header,
+                       uint16_t rtp_header_length,
+                       const RtpPayloadSlices& payload,
+                       uint16_t max_packet_length,
+                       int64_t capture_time_ms,
+                       StorageType type);
+
   // Gets stored RTP packet corresponding to the input sequence number.
   // The packet is copied to the buffer pointed to by ptr_rtp_packet.
   // The rtp_packet_length should show the available buffer size.
@@ -59,33 +100,72 @@ class RTPPacketHistory {
                                uint16_t* packet_length,
                                int64_t* stored_time_ms);
 
+  // Same as GetPacketAndSetSendTime(), but hands out the stored packet in
+  // |packet| instead of copying it. |packet| must not already hold a packet.
+  bool BorrowPacketAndSetSendTime(uint16_t sequence_number,
+                                  uint32_t min_elapsed_time_ms,
+                                  bool retransmit,
+                                  BorrowedPacket* packet);
+
   bool GetBestFittingPacket(uint8_t* packet, uint16_t* packet_length,
                             int64_t* stored_time_ms);
 
   bool HasRTPPacket(uint16_t sequence_number) const;
 
  private:
-  void GetPacket(int index, uint8_t* packet, uint16_t* packet_length,
-                 int64_t* stored_time_ms) const;
+  // Metadata of one slot; the payload lives in |packet_buffer_| at
+  // |index| * |max_packet_length_|.
+  struct StoredPacket {
+    StoredPacket()
+        : length(0),
+          sequence_number(0),
+          type(kDontStore),
+          stored_time_ms(0),
+          send_time_ms(0) {}
+
+    uint16_t length;  // Zero if the slot is empty.
+    uint16_t sequence_number;
+    StorageType type;
+    int64_t stored_time_ms;
+    int64_t send_time_ms;  // Zero if the packet has not been sent.
+  };
+
   void Allocate(uint16_t number_to_store) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
   void Free() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  void VerifyAndAllocatePacketLength(uint16_t packet_length);
-  bool FindSeqNum(uint16_t sequence_number, int32_t* index) const;
-  int FindBestFittingPacket(uint16_t size) const;
+  void VerifyAndAllocatePacketLength(uint16_t packet_length)
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  // Fills in the slot of the packet with the RTP header |rtp_header| and
+  // returns where to write the packet, or NULL if it is too long.
+  uint8_t* StorePacketInfo(const uint8_t* rtp_header,
+                           uint16_t packet_length,
+                           uint16_t max_packet_length,
+                           int64_t capture_time_ms,
+                           StorageType type)
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  // Returns the index of the slot holding |sequence_number|, or -1.
+  int FindSeqNum(uint16_t sequence_number) const
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  // Checks whether the packet in |slot| may be sent now and updates its send
+  // time if so.
+  bool CheckAndSetSendTime(StoredPacket* slot,
+                           uint32_t min_elapsed_time_ms,
+                           bool retransmit)
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  const uint8_t* PacketData(int index) const
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  int FindBestFittingPacket(uint16_t size) const
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
 
  private:
   Clock* clock_;
   CriticalSectionWrapper* critsect_;
-  bool store_;
-  uint32_t prev_index_;
-  uint16_t max_packet_length_;
-
-  std::vector<std::vector<uint8_t> > stored_packets_;
-  std::vector<uint16_t> stored_seq_nums_;
-  std::vector<uint16_t> stored_lengths_;
-  std::vector<int64_t> stored_times_;
-  std::vector<int64_t> stored_send_times_;
-  std::vector<StorageType> stored_types_;
+  bool store_ GUARDED_BY(critsect_);
+  uint16_t max_packet_length_ GUARDED_BY(critsect_);
+  // Number of slots minus one; the number of slots is a power of two.
+  uint16_t slot_mask_ GUARDED_BY(critsect_);
+
+  std::vector<StoredPacket> slots_ GUARDED_BY(critsect_);
+  std::vector<uint8_t> packet_buffer_ GUARDED_BY(critsect_);
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_RTP_PACKET_HISTORY_H_
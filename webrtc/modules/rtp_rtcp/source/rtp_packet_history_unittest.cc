@@ -203,4 +203,76 @@ TEST_F(RtpPacketHistoryTest, MinResendTime) {
   EXPECT_FALSE(hist_->GetPacketAndSetSendTime(kSeqNum, 101, false, packet_,
                                               &len, &time));
 }
+
+TEST_F(RtpPacketHistoryTest, BorrowRtpPacket) {
+  hist_->SetStorePacketsStatus(true, 10);
+  uint16_t len = 0;
+  int64_t capture_time_ms = 1;
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                   capture_time_ms, kAllowRetransmission));
+
+  RTPPacketHistory::BorrowedPacket packet;
+  EXPECT_TRUE(hist_->BorrowPacketAndSetSendTime(kSeqNum, 0, false, &packet));
+  EXPECT_EQ(len, packet.length());
+  EXPECT_EQ(capture_time_ms, packet.stored_time_ms());
+  for (int i = 0; i < len; i++)  {
+    EXPECT_EQ(packet_[i], packet.data()[i]);
+  }
+  packet.Release();
+  EXPECT_TRUE(packet.data() == NULL);
+
+  // The send time was updated by the borrow.
+  EXPECT_FALSE(hist_->BorrowPacketAndSetSendTime(kSeqNum, 100, false,
+                                                 &packet));
+  EXPECT_FALSE(hist_->BorrowPacketAndSetSendTime(kSeqNum + 1, 0, false,
+                                                 &packet));
+}
+
+TEST_F(RtpPacketHistoryTest, EvictsOldestAcrossWrap) {
+  const uint16_t kNumberToStore = 10;
+  hist_->SetStorePacketsStatus(true, kNumberToStore);
+  // Store 20 packets around the sequence number wrap; at least the last
+  // |kNumberToStore| of them must be kept.
+  const uint16_t kFirstSeqNum = 65530;
+  for (uint16_t i = 0; i < 20; ++i) {
+    uint16_t len = 0;
+    CreateRtpPacket(kFirstSeqNum + i, kSsrc, kPayload, kTimestamp, packet_,
+                    &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, kMaxPacketLength,
+                                     fake_clock_.TimeInMilliseconds(),
+                                     kAllowRetransmission));
+  }
+  for (uint16_t i = 20 - kNumberToStore; i < 20; ++i) {
+    uint16_t seq_num = kFirstSeqNum + i;
+    EXPECT_TRUE(hist_->HasRTPPacket(seq_num));
+    uint16_t len_out = kMaxPacketLength;
+    int64_t time;
+    EXPECT_TRUE(hist_->GetPacketAndSetSendTime(seq_num, 0, false, packet_out_,
+                                               &len_out, &time));
+    EXPECT_EQ(seq_num, (packet_out_[2] << 8) + packet_out_[3]);
+  }
+  EXPECT_FALSE(hist_->HasRTPPacket(kFirstSeqNum));
+}
+
+TEST_F(RtpPacketHistoryTest, KeepsPacketsWhenMaxLengthGrows) {
+  hist_->SetStorePacketsStatus(true, 10);
+  uint16_t len = 0;
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, 100,
+                                   fake_clock_.TimeInMilliseconds(),
+                                   kAllowRetransmission));
+  uint16_t len2 = 0;
+  CreateRtpPacket(kSeqNum + 1, kSsrc, kPayload, kTimestamp, packet_, &len2);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len2, kMaxPacketLength,
+                                   fake_clock_.TimeInMilliseconds(),
+                                   kAllowRetransmission));
+
+  uint16_t len_out = kMaxPacketLength;
+  int64_t time;
+  EXPECT_TRUE(hist_->GetPacketAndSetSendTime(kSeqNum, 0, false, packet_out_,
+                                             &len_out, &time));
+  EXPECT_EQ(len, len_out);
+  EXPECT_EQ(kSeqNum, (packet_out_[2] << 8) + packet_out_[3]);
+}
 }  // namespace webrtc
@@ -245,6 +245,18 @@ bool RTPPayloadRegistry::RestoreOriginalPacket(uint8_t** restored_packet,
                                                int* packet_length,
                                                uint32_t original_ssrc,
                                                const RTPHeader& header) const {
+  RTPHeader restored_header;
+  return RestoreOriginalPacket(restored_packet, packet, packet_length,
+                               original_ssrc, header, &restored_header);
+}
+
+bool RTPPayloadRegistry::RestoreOriginalPacket(
+    uint8_t** restored_packet,
+    const uint8_t* packet,
+    int* packet_length,
+    uint32_t original_ssrc,
+    const RTPHeader& header,
+    RTPHeader* restored_header) const {
   if (kRtxHeaderSize + header.headerLength > *packet_length) {
     return false;
   }
@@ -258,20 +270,57 @@ bool RTPPayloadRegistry::RestoreOriginalPacket(uint8_t** restored_packet,
          *packet_length - header.headerLength - kRtxHeaderSize);
   *packet_length -= kRtxHeaderSize;
 
+  return RestoreOriginalHeader(*restored_packet, original_sequence_number,
+                               original_ssrc, header, restored_header);
+}
+
+bool RTPPayloadRegistry::RestoreOriginalPacketInPlace(
+    uint8_t** packet,
+    int* packet_length,
+    uint32_t original_ssrc,
+    const RTPHeader& header,
+    RTPHeader* restored_header) const {
+  if (kRtxHeaderSize + header.headerLength > *packet_length) {
+    return false;
+  }
+  const uint8_t* rtx_header = *packet + header.headerLength;
+  uint16_t original_sequence_number = (rtx_header[0] << 8) + rtx_header[1];
+
+  // Move the RTP header forward onto the RTX header, the payload stays put.
+  memmove(*packet + kRtxHeaderSize, *packet, header.headerLength);
+  *packet += kRtxHeaderSize;
+  *packet_length -= kRtxHeaderSize;
+
+  return RestoreOriginalHeader(*packet, original_sequence_number,
+                               original_ssrc, header, restored_header);
+}
+
+bool RTPPayloadRegistry::RestoreOriginalHeader(
+    uint8_t* restored_packet,
+    uint16_t original_sequence_number,
+    uint32_t original_ssrc,
+    const RTPHeader& header,
+    RTPHeader* restored_header) const {
   // Replace the SSRC and the sequence number with the originals.
-  RtpUtility::AssignUWord16ToBuffer(*restored_packet + 2,
+  RtpUtility::AssignUWord16ToBuffer(restored_packet + 2,
                                     original_sequence_number);
-  RtpUtility::AssignUWord32ToBuffer(*restored_packet + 8, original_ssrc);
+  RtpUtility::AssignUWord32ToBuffer(restored_packet + 8, original_ssrc);
+
+  // Everything else in the header, including its length, stays the same.
+  *restored_header = header;
+  restored_header->sequenceNumber = original_sequence_number;
+  restored_header->ssrc = original_ssrc;
 
   CriticalSectionScoped cs(crit_sect_.get());
 
   if (payload_type_rtx_ != -1) {
     if (header.payloadType == payload_type_rtx_ &&
         incoming_payload_type_ != -1) {
-      (*restored_packet)[1] = static_cast<uint8_t>(incoming_payload_type_);
+      restored_packet[1] = static_cast<uint8_t>(incoming_payload_type_);
       if (header.markerBit) {
-        (*restored_packet)[1] |= kRtpMarkerBitMask;  // Marker bit is set.
+        restored_packet[1] |= kRtpMarkerBitMask;  // Marker bit is set.
       }
+      restored_header->payloadType = incoming_payload_type_;
     } else {
       LOG(LS_WARNING) << "Incorrect RTX configuration, dropping packet.";
       return false;
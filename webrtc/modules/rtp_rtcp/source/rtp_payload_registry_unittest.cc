@@ -214,6 +214,95 @@ TEST_F(RtpPayloadRegistryTest,
   EXPECT_FALSE(media_type_unchanged);
 }
 
+TEST_F(RtpPayloadRegistryTest, RestoresRtxPacketAndItsHeader) {
+  const uint8_t kRtxPayloadType = 97;
+  const uint8_t kMediaPayloadType = 100;
+  const uint32_t kMediaSsrc = 0x11111111;
+  rtp_payload_registry_->SetRtxSsrc(0x22222222);
+  rtp_payload_registry_->SetRtxPayloadType(kRtxPayloadType);
+  RTPHeader media_header;
+  media_header.payloadType = kMediaPayloadType;
+  media_header.ssrc = kMediaSsrc;
+  rtp_payload_registry_->SetIncomingPayloadType(media_header);
+
+  // Marker bit set, sequence number 1000, timestamp 0x01020304, RTX SSRC,
+  // followed by the original sequence number 0x1234 and the payload.
+  const uint8_t kRtxPacket[] = {
+      0x80, 0x80 | kRtxPayloadType, 0x03, 0xE8, 0x01, 0x02, 0x03, 0x04,
+      0x22, 0x22, 0x22, 0x22, 0x12, 0x34, 0xAA, 0xBB, 0xCC};
+  RTPHeader rtx_header;
+  RtpUtility::RtpHeaderParser rtx_parser(kRtxPacket, sizeof(kRtxPacket));
+  ASSERT_TRUE(rtx_parser.Parse(rtx_header));
+  EXPECT_TRUE(rtp_payload_registry_->IsRtx(rtx_header));
+
+  uint8_t restored_packet[sizeof(kRtxPacket)];
+  uint8_t* restored_packet_ptr = restored_packet;
+  int length = sizeof(kRtxPacket);
+  RTPHeader restored_header;
+  ASSERT_TRUE(rtp_payload_registry_->RestoreOriginalPacket(
+      &restored_packet_ptr, kRtxPacket, &length, kMediaSsrc, rtx_header,
+      &restored_header));
+  EXPECT_EQ(static_cast<int>(sizeof(kRtxPacket)) - 2, length);
+
+  // The derived header matches the header parsed from the restored packet.
+  RTPHeader parsed_header;
+  RtpUtility::RtpHeaderParser parser(restored_packet, length);
+  ASSERT_TRUE(parser.Parse(parsed_header));
+  EXPECT_EQ(0x1234, restored_header.sequenceNumber);
+  EXPECT_EQ(parsed_header.sequenceNumber, restored_header.sequenceNumber);
+  EXPECT_EQ(kMediaSsrc, restored_header.ssrc);
+  EXPECT_EQ(parsed_header.ssrc, restored_header.ssrc);
+  EXPECT_EQ(kMediaPayloadType, restored_header.payloadType);
+  EXPECT_EQ(parsed_header.payloadType, restored_header.payloadType);
+  EXPECT_TRUE(restored_header.markerBit);
+  EXPECT_EQ(parsed_header.markerBit, restored_header.markerBit);
+  EXPECT_EQ(parsed_header.timestamp, restored_header.timestamp);
+  EXPECT_EQ(parsed_header.headerLength, restored_header.headerLength);
+  EXPECT_EQ(0xAA, restored_packet[restored_header.headerLength]);
+}
+
+TEST_F(RtpPayloadRegistryTest, RestoresRtxPacketInPlace) {
+  const uint8_t kRtxPayloadType = 97;
+  const uint8_t kMediaPayloadType = 100;
+  const uint32_t kMediaSsrc = 0x11111111;
+  rtp_payload_registry_->SetRtxSsrc(0x22222222);
+  rtp_payload_registry_->SetRtxPayloadType(kRtxPayloadType);
+  RTPHeader media_header;
+  media_header.payloadType = kMediaPayloadType;
+  media_header.ssrc = kMediaSsrc;
+  rtp_payload_registry_->SetIncomingPayloadType(media_header);
+
+  const uint8_t kRtxPacket[] = {
+      0x80, kRtxPayloadType, 0x03, 0xE8, 0x01, 0x02, 0x03, 0x04,
+      0x22, 0x22, 0x22, 0x22, 0x12, 0x34, 0xAA, 0xBB, 0xCC};
+  RTPHeader rtx_header;
+  RtpUtility::RtpHeaderParser rtx_parser(kRtxPacket, sizeof(kRtxPacket));
+  ASSERT_TRUE(rtx_parser.Parse(rtx_header));
+
+  // Restoring in place gives the same packet as restoring into a copy.
+  uint8_t copied_packet[sizeof(kRtxPacket)];
+  uint8_t* copied_packet_ptr = copied_packet;
+  int copied_length = sizeof(kRtxPacket);
+  RTPHeader copied_header;
+  ASSERT_TRUE(rtp_payload_registry_->RestoreOriginalPacket(
+      &copied_packet_ptr, kRtxPacket, &copied_length, kMediaSsrc, rtx_header,
+      &copied_header));
+
+  uint8_t packet[sizeof(kRtxPacket)];
+  memcpy(packet, kRtxPacket, sizeof(kRtxPacket));
+  uint8_t* packet_ptr = packet;
+  int length = sizeof(kRtxPacket);
+  RTPHeader restored_header;
+  ASSERT_TRUE(rtp_payload_registry_->RestoreOriginalPacketInPlace(
+      &packet_ptr, &length, kMediaSsrc, rtx_header, &restored_header));
+  EXPECT_EQ(packet + 2, packet_ptr);
+  ASSERT_EQ(copied_length, length);
+  EXPECT_EQ(0, memcmp(copied_packet, packet_ptr, length));
+  EXPECT_EQ(copied_header.sequenceNumber, restored_header.sequenceNumber);
+  EXPECT_EQ(copied_header.ssrc, restored_header.ssrc);
+  EXPECT_EQ(copied_header.payloadType, restored_header.payloadType);
+}
+
 class ParameterizedRtpPayloadRegistryTest :
     public RtpPayloadRegistryTest,
     public ::testing::WithParamInterface<int> {
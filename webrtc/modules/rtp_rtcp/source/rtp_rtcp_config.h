@@ -28,10 +28,15 @@ enum { RTCP_INTERVAL_VIDEO_MS       = 1000 };
 enum { RTCP_INTERVAL_AUDIO_MS       = 5000 };
 enum { RTCP_SEND_BEFORE_KEY_FRAME_MS= 100 };
 enum { RTCP_MAX_REPORT_BLOCKS       = 31};      // RFC 3550 page 37
+// Room left for the feedback messages when filling a compound packet with
+// report blocks.
+enum { RTCP_FEEDBACK_RESERVED_LENGTH = 400 };
 enum { RTCP_MIN_FRAME_LENGTH_MS     = 17};
 enum { kRtcpAppCode_DATA_SIZE           = 32*4};    // multiple of 4, this is not a limitation of the size
 enum { RTCP_RPSI_DATA_SIZE          = 30};
 enum { RTCP_NUMBER_OF_SR            = 60 };
+enum { kTransportFeedbackIntervalMs = 100 };
+enum { kMaxTransportArrivals = 10000 };  // Pending transport feedback
 
 enum { MAX_NUMBER_OF_TEMPORAL_ID    = 8 };          // RFC
 enum { MAX_NUMBER_OF_DEPENDENCY_QUALITY_ID  = 128 };// RFC
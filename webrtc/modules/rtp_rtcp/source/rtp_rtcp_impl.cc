@@ -40,7 +40,8 @@ RtpRtcp::Configuration::Configuration()
       paced_sender(NULL),
       send_bitrate_observer(NULL),
       send_frame_count_observer(NULL),
-      send_side_delay_observer(NULL) {
+      send_side_delay_observer(NULL),
+      transport_feedback_callback(NULL) {
 }
 
 RtpRtcp* RtpRtcp::CreateRtpRtcp(const RtpRtcp::Configuration& configuration) {
@@ -65,7 +66,8 @@ ModuleRtpRtcpImpl::ModuleRtpRtcpImpl(const Configuration& configuration)
                   configuration.paced_sender,
                   configuration.send_bitrate_observer,
                   configuration.send_frame_count_observer,
-                  configuration.send_side_delay_observer),
+                  configuration.send_side_delay_observer,
+                  configuration.transport_feedback_callback),
       rtcp_sender_(configuration.id,
                    configuration.audio,
                    configuration.clock,
@@ -80,15 +82,14 @@ ModuleRtpRtcpImpl::ModuleRtpRtcpImpl(const Configuration& configuration)
       last_rtt_process_time_(configuration.clock->TimeInMilliseconds()),
       packet_overhead_(28),  // IPV4 UDP.
       critical_section_module_ptrs_(
-          CriticalSectionWrapper::CreateCriticalSection()),
+          CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+              "ModuleRtpRtcp")),
       critical_section_module_ptrs_feedback_(
           CriticalSectionWrapper::CreateCriticalSection()),
       default_module_(
           static_cast<ModuleRtpRtcpImpl*>(configuration.default_module)),
       padding_index_(static_cast<size_t>(-1)),  // Start padding at first child.
       nack_method_(kNackOff),
-      nack_last_time_sent_full_(0),
-      nack_last_seq_number_sent_(0),
       simulcast_(false),
       key_frame_req_method_(kKeyFrameReqFirRtp),
       remote_bitrate_(configuration.remote_bitrate_estimator),
@@ -103,7 +104,8 @@ ModuleRtpRtcpImpl::ModuleRtpRtcpImpl(const Configuration& configuration)
   // TODO(pwestin) move to constructors of each rtp/rtcp sender/receiver object.
   rtcp_receiver_.RegisterRtcpObservers(configuration.intra_frame_callback,
                                        configuration.bandwidth_callback,
-                                       configuration.rtcp_feedback);
+                                       configuration.rtcp_feedback,
+                                       configuration.transport_feedback_callback);
   rtcp_sender_.RegisterSendTransport(configuration.outgoing_transport);
 
   // Make sure that RTCP objects are aware of our SSRC.
@@ -231,6 +233,10 @@ int32_t ModuleRtpRtcpImpl::Process() {
 
     if (rtcp_sender_.TimeToSendRTCPReport()) {
       rtcp_sender_.SendRTCP(GetFeedbackState(), kRtcpReport);
+    } else if (rtcp_sender_.TimeToSendTransportFeedback()) {
+      // Transport feedback is sent more often than the reports, so that the
+      // sender can react to congestion within a round-trip time.
+      rtcp_sender_.SendRTCP(GetFeedbackState(), kRtcpTransportFeedback);
     }
   }
 
@@ -279,6 +285,12 @@ int32_t ModuleRtpRtcpImpl::IncomingRtcpPacket(
   return ret_val;
 }
 
+void ModuleRtpRtcpImpl::IncomingTransportSequenceNumber(
+    uint16_t sequence_number, int64_t arrival_time_ms) {
+  rtcp_sender_.IncomingTransportSequenceNumber(sequence_number,
+                                               arrival_time_ms);
+}
+
 int32_t ModuleRtpRtcpImpl::RegisterSendPayload(
     const CodecInst& voice_codec) {
   return rtp_sender_.RegisterPayload(
@@ -939,41 +951,17 @@ int32_t ModuleRtpRtcpImpl::SendNACK(const uint16_t* nack_list,
   if (wait_time == 5) {
     wait_time = 100;  // During startup we don't have an RTT.
   }
-  const int64_t now = clock_->TimeInMilliseconds();
-  const int64_t time_limit = now - wait_time;
-  uint16_t nackLength = size;
-  uint16_t start_id = 0;
-
-  if (nack_last_time_sent_full_ < time_limit) {
-    // Send list. Set the timer to make sure we only send a full NACK list once
-    // within every time_limit.
-    nack_last_time_sent_full_ = now;
-  } else {
-    // Only send if extended list.
-    if (nack_last_seq_number_sent_ == nack_list[size - 1]) {
-      // Last seq num is the same don't send list.
-      return 0;
-    } else {
-      // Send NACKs only for new sequence numbers to avoid re-sending
-      // NACKs for sequences we have already sent.
-      for (int i = 0; i < size; ++i)  {
-        if (nack_last_seq_number_sent_ == nack_list[i]) {
-          start_id = i + 1;
-          break;
-        }
-      }
-      nackLength = size - start_id;
-    }
-  }
-  // Our RTCP NACK implementation is limited to kRtcpMaxNackFields sequence
-  // numbers per RTCP packet.
-  if (nackLength > kRtcpMaxNackFields) {
-    nackLength = kRtcpMaxNackFields;
+  // Only NACK the sequence numbers which weren't NACKed within wait_time,
+  // limited to kRtcpMaxNackFields sequence numbers per RTCP packet.
+  uint16_t nack_to_send[kRtcpMaxNackFields];
+  const int nack_length = nack_send_history_.SelectForSending(
+      nack_list, size, clock_->TimeInMilliseconds(), wait_time,
+      kRtcpMaxNackFields, nack_to_send);
+  if (nack_length == 0) {
+    return 0;
   }
-  nack_last_seq_number_sent_ = nack_list[start_id + nackLength - 1];
-
   return rtcp_sender_.SendRTCP(
-      GetFeedbackState(), kRtcpNack, nackLength, &nack_list[start_id]);
+      GetFeedbackState(), kRtcpNack, nack_length, nack_to_send);
 }
 
 // Store the sent packets, needed to answer to a Negative acknowledgment
@@ -989,6 +977,10 @@ bool ModuleRtpRtcpImpl::StorePackets() const {
   return rtp_sender_.StorePackets();
 }
 
+int32_t ModuleRtpRtcpImpl::ResendLastKeyFrame(int64_t max_age_ms) {
+  return rtp_sender_.ResendLastKeyFrame(max_age_ms);
+}
+
 void ModuleRtpRtcpImpl::RegisterSendChannelRtcpStatisticsCallback(
     RtcpStatisticsCallback* callback) {
   rtcp_receiver_.RegisterRtcpStatisticsCallback(callback);
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp.h"
+#include "webrtc/modules/rtp_rtcp/source/nack_send_history.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_receiver.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_sender.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_sender.h"
@@ -42,6 +43,9 @@ class ModuleRtpRtcpImpl : public RtpRtcp {
   virtual int32_t IncomingRtcpPacket(const uint8_t* incoming_packet,
                                      uint16_t incoming_packet_length) OVERRIDE;
 
+  virtual void IncomingTransportSequenceNumber(
+      uint16_t sequence_number, int64_t arrival_time_ms) OVERRIDE;
+
   virtual void SetRemoteSSRC(const uint32_t ssrc);
 
   // Sender part.
@@ -248,6 +252,8 @@ class ModuleRtpRtcpImpl : public RtpRtcp {
 
   virtual bool StorePackets() const OVERRIDE;
 
+  virtual int32_t ResendLastKeyFrame(int64_t max_age_ms) OVERRIDE;
+
   // Called on receipt of RTCP report block from remote side.
   virtual void RegisterSendChannelRtcpStatisticsCallback(
       RtcpStatisticsCallback* callback) OVERRIDE;
@@ -417,8 +423,7 @@ class ModuleRtpRtcpImpl : public RtpRtcp {
 
   // Send side
   NACKMethod            nack_method_;
-  uint32_t        nack_last_time_sent_full_;
-  uint16_t        nack_last_seq_number_sent_;
+  NackSendHistory nack_send_history_;
 
   bool                  simulcast_;
   VideoCodec            send_video_codec_;
@@ -12,6 +12,7 @@
 
 #include <stdlib.h>  // srand
 
+#include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_sender_audio.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_sender_video.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
@@ -48,7 +49,8 @@ RTPSender::RTPSender(const int32_t id,
                      PacedSender* paced_sender,
                      BitrateStatisticsObserver* bitrate_callback,
                      FrameCountObserver* frame_count_observer,
-                     SendSideDelayObserver* send_side_delay_observer)
+                     SendSideDelayObserver* send_side_delay_observer,
+                     TransportFeedbackObserver* transport_feedback_observer)
     : clock_(clock),
       bitrate_sent_(clock, this),
       id_(id),
@@ -56,7 +58,8 @@ RTPSender::RTPSender(const int32_t id,
       audio_(NULL),
       video_(NULL),
       paced_sender_(paced_sender),
-      send_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
+      send_critsect_(
+          CriticalSectionWrapper::CreateAdaptiveCriticalSection("RTPSender")),
       transport_(transport),
       sending_media_(true),                      // Default to sending media.
       max_payload_length_(IP_PACKET_SIZE - 28),  // Default is IP-v4/UDP.
@@ -77,6 +80,7 @@ RTPSender::RTPSender(const int32_t id,
       bitrate_callback_(bitrate_callback),
       frame_count_observer_(frame_count_observer),
       send_side_delay_observer_(send_side_delay_observer),
+      transport_feedback_observer_(transport_feedback_observer),
       // RTP variables
       start_timestamp_forced_(false),
       start_timestamp_(0),
@@ -94,6 +98,9 @@ RTPSender::RTPSender(const int32_t id,
       include_csrcs_(true),
       rtx_(kRtxOff),
       payload_type_rtx_(-1),
+      has_key_frame_(false),
+      key_frame_sequence_number_(0),
+      key_frame_time_ms_(0),
       target_bitrate_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
       target_bitrate_(0) {
   memset(nack_byte_count_times_, 0, sizeof(nack_byte_count_times_));
@@ -434,6 +441,12 @@ int32_t RTPSender::SendOutgoingData(
     if (frame_type == kFrameEmpty)
       return 0;
 
+    if (frame_type == kVideoFrameKey) {
+      CriticalSectionScoped cs(send_critsect_);
+      has_key_frame_ = true;
+      key_frame_sequence_number_ = sequence_number_;
+      key_frame_time_ms_ = clock_->TimeInMilliseconds();
+    }
     ret_val = video_->SendVideo(video_type, frame_type, payload_type,
                                 capture_timestamp, capture_time_ms,
                                 payload_data, payload_size,
@@ -557,6 +570,7 @@ int RTPSender::SendPadData(int payload_type,
     }
 
     UpdateAbsoluteSendTime(padding_packet, length, rtp_header, now_ms);
+    UpdateTransportSequenceNumber(padding_packet, length, rtp_header, now_ms);
     if (!SendPacketToNetwork(padding_packet, length))
       break;
     bytes_sent += padding_bytes_in_packet;
@@ -579,19 +593,27 @@ int32_t RTPSender::ReSendPacket(uint16_t packet_id, uint32_t min_resend_time) {
   uint16_t length = IP_PACKET_SIZE;
   uint8_t data_buffer[IP_PACKET_SIZE];
   int64_t capture_time_ms;
-  if (!packet_history_.GetPacketAndSetSendTime(packet_id, min_resend_time, true,
-                                               data_buffer, &length,
-                                               &capture_time_ms)) {
-    // Packet not found.
-    return 0;
-  }
 
   if (paced_sender_) {
-    RtpUtility::RtpHeaderParser rtp_parser(data_buffer, length);
     RTPHeader header;
-    if (!rtp_parser.Parse(header)) {
-      assert(false);
-      return -1;
+    {
+      // Only the header is needed to queue the packet. The pacer fetches the
+      // packet from the history again when it is time to send it.
+      RTPPacketHistory::BorrowedPacket packet;
+      if (!packet_history_.BorrowPacketAndSetSendTime(packet_id,
+                                                      min_resend_time,
+                                                      true,
+                                                      &packet)) {
+        // Packet not found.
+        return 0;
+      }
+      RtpUtility::RtpHeaderParser rtp_parser(packet.data(), packet.length());
+      if (!rtp_parser.Parse(header)) {
+        assert(false);
+        return -1;
+      }
+      length = packet.length();
+      capture_time_ms = packet.stored_time_ms();
     }
     // Convert from TickTime to Clock since capture_time_ms is based on
     // TickTime.
@@ -608,6 +630,16 @@ int32_t RTPSender::ReSendPacket(uint16_t packet_id, uint32_t min_resend_time) {
       // We will be called when it is time.
       return length;
     }
+    // The send time was updated above, so don't check it again.
+    min_resend_time = 0;
+    length = IP_PACKET_SIZE;
+  }
+
+  if (!packet_history_.GetPacketAndSetSendTime(packet_id, min_resend_time, true,
+                                               data_buffer, &length,
+                                               &capture_time_ms)) {
+    // Packet not found.
+    return 0;
   }
   int rtx = kRtxOff;
   {
@@ -619,6 +651,39 @@ int32_t RTPSender::ReSendPacket(uint16_t packet_id, uint32_t min_resend_time) {
       length : -1;
 }
 
+int32_t RTPSender::ResendLastKeyFrame(int64_t max_age_ms) {
+  uint16_t sequence_number;
+  uint16_t end_sequence_number;
+  {
+    CriticalSectionScoped lock(send_critsect_);
+    if (!has_key_frame_ ||
+        clock_->TimeInMilliseconds() - key_frame_time_ms_ > max_age_ms) {
+      return -1;
+    }
+    sequence_number = key_frame_sequence_number_;
+    end_sequence_number = sequence_number_;
+  }
+  // The key frame is useless without the start of it.
+  if (!packet_history_.HasRTPPacket(sequence_number)) {
+    return -1;
+  }
+  int32_t bytes_resent = 0;
+  for (; sequence_number != end_sequence_number; ++sequence_number) {
+    const int32_t bytes_sent = ReSendPacket(sequence_number);
+    if (bytes_sent < 0) {
+      LOG(LS_WARNING) << "Failed resending RTP packet " << sequence_number
+                      << " of the last key frame.";
+      break;
+    }
+    bytes_resent += bytes_sent;
+  }
+  if (bytes_resent > 0) {
+    UpdateNACKBitRate(bytes_resent, clock_->TimeInMilliseconds());
+    nack_bitrate_.Update(bytes_resent);
+  }
+  return bytes_resent;
+}
+
 bool RTPSender::SendPacketToNetwork(const uint8_t *packet, uint32_t size) {
   int bytes_sent = -1;
   if (transport_) {
@@ -807,6 +872,8 @@ bool RTPSender::PrepareAndSendPacket(uint8_t* buffer,
   UpdateTransmissionTimeOffset(buffer_to_send_ptr, length, rtp_header,
                                diff_ms);
   UpdateAbsoluteSendTime(buffer_to_send_ptr, length, rtp_header, now_ms);
+  UpdateTransportSequenceNumber(buffer_to_send_ptr, length, rtp_header,
+                                now_ms);
   bool ret = SendPacketToNetwork(buffer_to_send_ptr, length);
   if (ret) {
     CriticalSectionScoped lock(send_critsect_);
@@ -906,50 +973,108 @@ int32_t RTPSender::SendToNetwork(
     uint8_t *buffer, int payload_length, int rtp_header_length,
     int64_t capture_time_ms, StorageType storage,
     PacedSender::Priority priority) {
-  RtpUtility::RtpHeaderParser rtp_parser(buffer,
-                                         payload_length + rtp_header_length);
+  const uint32_t length = payload_length + rtp_header_length;
+  RtpUtility::RtpHeaderParser rtp_parser(buffer, length);
   RTPHeader rtp_header;
   rtp_parser.Parse(rtp_header);
 
   int64_t now_ms = clock_->TimeInMilliseconds();
+  UpdateSendTimeExtensions(buffer, length, rtp_header, capture_time_ms,
+                           now_ms);
 
-  // |capture_time_ms| <= 0 is considered invalid.
-  // TODO(holmer): This should be changed all over Video Engine so that negative
-  // time is consider invalid, while 0 is considered a valid time.
-  if (capture_time_ms > 0) {
-    UpdateTransmissionTimeOffset(buffer, payload_length + rtp_header_length,
-                                 rtp_header, now_ms - capture_time_ms);
+  // Used for NACK and to spread out the transmission of packets.
+  if (packet_history_.PutRTPPacket(buffer, length, max_payload_length_,
+                                   capture_time_ms, storage) != 0) {
+    return -1;
+  }
+  if (PacePacket(rtp_header, payload_length, capture_time_ms, storage,
+                 priority)) {
+    return 0;
+  }
+  assert(payload_length - rtp_header.paddingLength > 0);
+  return SendMediaPacket(buffer, length, rtp_header, capture_time_ms, now_ms);
+}
+
+int32_t RTPSender::SendSlicesToNetwork(
+    uint8_t* rtp_header, int rtp_header_length,
+    const RtpPayloadSlices& payload, int64_t capture_time_ms,
+    StorageType storage, PacedSender::Priority priority) {
+  const int payload_length = static_cast<int>(payload.length());
+  const uint32_t length = rtp_header_length + payload_length;
+  if (length > IP_PACKET_SIZE) {
+    return -1;
   }
+  // The header extensions are in the header, so it can be updated on its own.
+  RtpUtility::RtpHeaderParser rtp_parser(rtp_header, rtp_header_length);
+  RTPHeader header;
+  rtp_parser.Parse(header);
 
-  UpdateAbsoluteSendTime(buffer, payload_length + rtp_header_length,
-                         rtp_header, now_ms);
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  UpdateSendTimeExtensions(rtp_header, rtp_header_length, header,
+                           capture_time_ms, now_ms);
 
   // Used for NACK and to spread out the transmission of packets.
-  if (packet_history_.PutRTPPacket(buffer, rtp_header_length + payload_length,
+  if (packet_history_.PutRTPPacket(rtp_header, rtp_header_length, payload,
                                    max_payload_length_, capture_time_ms,
                                    storage) != 0) {
     return -1;
   }
+  if (PacePacket(header, payload_length, capture_time_ms, storage,
+                 priority)) {
+    return 0;
+  }
+  // Gather the packet to send rather than sending the stored copy, which
+  // would keep the history locked while the packet is on its way to the
+  // network.
+  uint8_t data_buffer[IP_PACKET_SIZE];
+  memcpy(data_buffer, rtp_header, rtp_header_length);
+  payload.CopyTo(data_buffer + rtp_header_length);
+  return SendMediaPacket(data_buffer, length, header, capture_time_ms, now_ms);
+}
 
-  if (paced_sender_ && storage != kDontStore) {
-    int64_t clock_delta_ms = clock_->TimeInMilliseconds() -
-        TickTime::MillisecondTimestamp();
-    if (!paced_sender_->SendPacket(priority, rtp_header.ssrc,
-                                   rtp_header.sequenceNumber,
-                                   capture_time_ms + clock_delta_ms,
-                                   payload_length, false)) {
-      // We can't send the packet right now.
-      // We will be called when it is time.
-      return 0;
-    }
+void RTPSender::UpdateSendTimeExtensions(uint8_t* rtp_packet,
+                                         uint16_t rtp_packet_length,
+                                         const RTPHeader& rtp_header,
+                                         int64_t capture_time_ms,
+                                         int64_t now_ms) const {
+  // |capture_time_ms| <= 0 is considered invalid.
+  // TODO(holmer): This should be changed all over Video Engine so that negative
+  // time is consider invalid, while 0 is considered a valid time.
+  if (capture_time_ms > 0) {
+    UpdateTransmissionTimeOffset(rtp_packet, rtp_packet_length, rtp_header,
+                                 now_ms - capture_time_ms);
   }
+  UpdateAbsoluteSendTime(rtp_packet, rtp_packet_length, rtp_header, now_ms);
+}
+
+bool RTPSender::PacePacket(const RTPHeader& rtp_header,
+                           int payload_length,
+                           int64_t capture_time_ms,
+                           StorageType storage,
+                           PacedSender::Priority priority) {
+  if (!paced_sender_ || storage == kDontStore)
+    return false;
+  int64_t clock_delta_ms = clock_->TimeInMilliseconds() -
+      TickTime::MillisecondTimestamp();
+  // The pacer fetches the packet from the history when it is time to send it,
+  // unless it can be sent right now.
+  return !paced_sender_->SendPacket(priority, rtp_header.ssrc,
+                                    rtp_header.sequenceNumber,
+                                    capture_time_ms + clock_delta_ms,
+                                    payload_length, false);
+}
+
+int32_t RTPSender::SendMediaPacket(uint8_t* buffer,
+                                   uint32_t length,
+                                   const RTPHeader& rtp_header,
+                                   int64_t capture_time_ms,
+                                   int64_t now_ms) {
   if (capture_time_ms > 0) {
     UpdateDelayStatistics(capture_time_ms, now_ms);
   }
-  uint32_t length = payload_length + rtp_header_length;
+  UpdateTransportSequenceNumber(buffer, length, rtp_header, now_ms);
   if (!SendPacketToNetwork(buffer, length))
     return -1;
-  assert(payload_length - rtp_header.paddingLength > 0);
   {
     CriticalSectionScoped lock(send_critsect_);
     media_has_been_sent_ = true;
@@ -1137,6 +1262,10 @@ uint16_t RTPSender::BuildRTPHeaderExtension(uint8_t* data_buffer) const {
         block_length = BuildAbsoluteSendTimeExtension(
             data_buffer + kHeaderLength + total_block_length);
         break;
+      case kRtpExtensionTransportSequenceNumber:
+        block_length = BuildTransportSequenceNumberExtension(
+            data_buffer + kHeaderLength + total_block_length);
+        break;
       default:
         assert(false);
     }
@@ -1259,6 +1388,38 @@ uint8_t RTPSender::BuildAbsoluteSendTimeExtension(uint8_t* data_buffer) const {
   return kAbsoluteSendTimeLength;
 }
 
+uint8_t RTPSender::BuildTransportSequenceNumberExtension(
+    uint8_t* data_buffer) const {
+  // The transport sequence number numbers the packets of all the streams sent
+  // over the same transport, so that the receiver can report their arrival
+  // times in transport feedback.
+  //
+  //    0                   1                   2                   3
+  //    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  //   |  ID   | len=1 |   transport sequence number   |      0x00     |
+  //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  //
+  // The sequence number is written when the packet is sent.
+
+  // Get id defined by user.
+  uint8_t id;
+  if (rtp_header_extension_map_.GetId(kRtpExtensionTransportSequenceNumber,
+                                      &id) != 0) {
+    // Not registered.
+    return 0;
+  }
+  size_t pos = 0;
+  const uint8_t len = 1;
+  data_buffer[pos++] = (id << 4) + len;
+  RtpUtility::AssignUWord16ToBuffer(data_buffer + pos, 0);
+  pos += 2;
+  data_buffer[pos++] = 0;  // Padding.
+  // kTransportSequenceNumberLength is including the pad byte.
+  assert(pos == kTransportSequenceNumberLength);
+  return kTransportSequenceNumberLength;
+}
+
 void RTPSender::UpdateTransmissionTimeOffset(
     uint8_t *rtp_packet, const uint16_t rtp_packet_length,
     const RTPHeader &rtp_header, const int64_t time_diff_ms) const {
@@ -1393,6 +1554,59 @@ void RTPSender::UpdateAbsoluteSendTime(
                                     ((now_ms << 18) / 1000) & 0x00ffffff);
 }
 
+void RTPSender::UpdateTransportSequenceNumber(
+    uint8_t* rtp_packet, const uint16_t rtp_packet_length,
+    const RTPHeader& rtp_header, const int64_t now_ms) const {
+  if (!transport_feedback_observer_)
+    return;
+  int block_pos;
+  {
+    CriticalSectionScoped cs(send_critsect_);
+    // Get id.
+    uint8_t id = 0;
+    if (rtp_header_extension_map_.GetId(kRtpExtensionTransportSequenceNumber,
+                                        &id) != 0) {
+      // Not registered.
+      return;
+    }
+    // Get length until start of header extension block.
+    int extension_block_pos =
+        rtp_header_extension_map_.GetLengthUntilBlockStartInBytes(
+            kRtpExtensionTransportSequenceNumber);
+    if (extension_block_pos < 0) {
+      // The feature is not enabled.
+      return;
+    }
+    block_pos = 12 + rtp_header.numCSRCs + extension_block_pos;
+    if (rtp_packet_length < block_pos + kTransportSequenceNumberLength ||
+        rtp_header.headerLength <
+            block_pos + kTransportSequenceNumberLength) {
+      LOG(LS_WARNING)
+          << "Failed to update transport sequence number, invalid length.";
+      return;
+    }
+    // Verify that header contains extension.
+    if (!((rtp_packet[12 + rtp_header.numCSRCs] == 0xBE) &&
+          (rtp_packet[12 + rtp_header.numCSRCs + 1] == 0xDE))) {
+      LOG(LS_WARNING) << "Failed to update transport sequence number, hdr "
+                         "extension not found.";
+      return;
+    }
+    // Verify first byte in block.
+    const uint8_t first_block_byte = (id << 4) + 1;
+    if (rtp_packet[block_pos] != first_block_byte) {
+      LOG(LS_WARNING) << "Failed to update transport sequence number.";
+      return;
+    }
+  }
+  // The observer is shared by all the senders of the transport, so it is
+  // called without holding our lock.
+  const uint16_t sequence_number =
+      transport_feedback_observer_->OnSendingPacket(rtp_packet_length, now_ms);
+  RtpUtility::AssignUWord16ToBuffer(rtp_packet + block_pos + 1,
+                                    sequence_number);
+}
+
 void RTPSender::SetSendingStatus(bool enabled) {
   if (enabled) {
     uint32_t frequency_hz = SendPayloadFrequency();
@@ -1407,6 +1621,8 @@ void RTPSender::SetSendingStatus(bool enabled) {
       ssrc_db_.ReturnSSRC(ssrc_);
       ssrc_ = ssrc_db_.CreateSSRC();  // Can't be 0.
     }
+    // The stored packets are of the old stream.
+    has_key_frame_ = false;
     // Don't initialize seq number if SSRC passed externally.
     if (!sequence_number_forced_ && !ssrc_forced_) {
       // Generate a new sequence number.
@@ -1456,6 +1672,7 @@ uint32_t RTPSender::GenerateNewSSRC() {
     return 0;
   }
   ssrc_ = ssrc_db_.CreateSSRC();  // Can't be 0.
+  has_key_frame_ = false;
   return ssrc_;
 }
 
@@ -1470,6 +1687,7 @@ void RTPSender::SetSSRC(uint32_t ssrc) {
   ssrc_db_.ReturnSSRC(ssrc_);
   ssrc_db_.RegisterSSRC(ssrc);
   ssrc_ = ssrc;
+  has_key_frame_ = false;
   if (!sequence_number_forced_) {
     sequence_number_ =
         rand() / (RAND_MAX / MAX_INIT_RTP_SEQ_NUMBER);  // NOLINT
@@ -1510,6 +1728,7 @@ void RTPSender::SetSequenceNumber(uint16_t seq) {
   CriticalSectionScoped cs(send_critsect_);
   sequence_number_forced_ = true;
   sequence_number_ = seq;
+  has_key_frame_ = false;
 }
 
 uint16_t RTPSender::SequenceNumber() const {
@@ -34,6 +34,7 @@ namespace webrtc {
 class CriticalSectionWrapper;
 class RTPSenderAudio;
 class RTPSenderVideo;
+class RtpPayloadSlices;
 
 class RTPSenderInterface {
  public:
@@ -63,6 +64,14 @@ class RTPSenderInterface {
       uint8_t *data_buffer, int payload_length, int rtp_header_length,
       int64_t capture_time_ms, StorageType storage,
       PacedSender::Priority priority) = 0;
+
+  // Same as SendToNetwork(), but the packet is the RTP header in |rtp_header|
+  // followed by |payload|, which is gathered directly into the packet history.
+  // It is gathered a second time only if the packet is sent right away.
+  virtual int32_t SendSlicesToNetwork(
+      uint8_t* rtp_header, int rtp_header_length,
+      const RtpPayloadSlices& payload, int64_t capture_time_ms,
+      StorageType storage, PacedSender::Priority priority) = 0;
 };
 
 class RTPSender : public RTPSenderInterface, public Bitrate::Observer {
@@ -72,7 +81,8 @@ class RTPSender : public RTPSenderInterface, public Bitrate::Observer {
             PacedSender *paced_sender,
             BitrateStatisticsObserver* bitrate_callback,
             FrameCountObserver* frame_count_observer,
-            SendSideDelayObserver* send_side_delay_observer);
+            SendSideDelayObserver* send_side_delay_observer,
+            TransportFeedbackObserver* transport_feedback_observer);
   virtual ~RTPSender();
 
   void ProcessBitrate();
@@ -161,6 +171,7 @@ class RTPSender : public RTPSenderInterface, public Bitrate::Observer {
   uint8_t BuildTransmissionTimeOffsetExtension(uint8_t *data_buffer) const;
   uint8_t BuildAudioLevelExtension(uint8_t* data_buffer) const;
   uint8_t BuildAbsoluteSendTimeExtension(uint8_t* data_buffer) const;
+  uint8_t BuildTransportSequenceNumberExtension(uint8_t* data_buffer) const;
 
   bool UpdateAudioLevel(uint8_t *rtp_packet,
                         const uint16_t rtp_packet_length,
@@ -185,6 +196,11 @@ class RTPSender : public RTPSenderInterface, public Bitrate::Observer {
 
   int32_t ReSendPacket(uint16_t packet_id, uint32_t min_resend_time = 0);
 
+  // Resends the packets of the last key frame and of all frames since, e.g.
+  // for a receiver that joins the stream. Returns the number of bytes resent,
+  // or -1 if the key frame is older than |max_age_ms| or no longer stored.
+  int32_t ResendLastKeyFrame(int64_t max_age_ms);
+
   bool ProcessNACKBitRate(const uint32_t now);
 
   // RTX.
@@ -221,6 +237,11 @@ class RTPSender : public RTPSenderInterface, public Bitrate::Observer {
       int64_t capture_time_ms, StorageType storage,
       PacedSender::Priority priority) OVERRIDE;
 
+  virtual int32_t SendSlicesToNetwork(
+      uint8_t* rtp_header, int rtp_header_length,
+      const RtpPayloadSlices& payload, int64_t capture_time_ms,
+      StorageType storage, PacedSender::Priority priority) OVERRIDE;
+
   // Audio.
 
   // Send a DTMF tone using RFC 2833 (4733).
@@ -324,12 +345,41 @@ class RTPSender : public RTPSenderInterface, public Bitrate::Observer {
                               const uint16_t rtp_packet_length,
                               const RTPHeader &rtp_header,
                               const int64_t now_ms) const;
+  // Writes the next transport sequence number to a packet that is sent at
+  // |now_ms|. Only to be called right before the packet is sent, so that every
+  // number is used by a sent packet.
+  void UpdateTransportSequenceNumber(uint8_t* rtp_packet,
+                                     const uint16_t rtp_packet_length,
+                                     const RTPHeader& rtp_header,
+                                     const int64_t now_ms) const;
 
   void UpdateRtpStats(const uint8_t* buffer,
                       uint32_t size,
                       const RTPHeader& header,
                       bool is_rtx,
                       bool is_retransmit);
+
+  // Updates the header extensions telling the send time of a packet which is
+  // about to be stored or sent.
+  void UpdateSendTimeExtensions(uint8_t* rtp_packet,
+                                uint16_t rtp_packet_length,
+                                const RTPHeader& rtp_header,
+                                int64_t capture_time_ms,
+                                int64_t now_ms) const;
+  // Hands a stored media packet to the pacer. Returns true if the pacer sends
+  // it later, and false if it is to be sent now.
+  bool PacePacket(const RTPHeader& rtp_header,
+                  int payload_length,
+                  int64_t capture_time_ms,
+                  StorageType storage,
+                  PacedSender::Priority priority);
+  // Sends a media packet on its first transmission and updates the delay and
+  // RTP statistics.
+  int32_t SendMediaPacket(uint8_t* buffer,
+                          uint32_t length,
+                          const RTPHeader& rtp_header,
+                          int64_t capture_time_ms,
+                          int64_t now_ms);
   bool IsFecPacket(const uint8_t* buffer, const RTPHeader& header) const;
 
   Clock* clock_;
@@ -373,6 +423,7 @@ class RTPSender : public RTPSenderInterface, public Bitrate::Observer {
   BitrateStatisticsObserver* const bitrate_callback_;
   FrameCountObserver* const frame_count_observer_;
   SendSideDelayObserver* const send_side_delay_observer_;
+  TransportFeedbackObserver* const transport_feedback_observer_;
 
   // RTP variables
   bool start_timestamp_forced_ GUARDED_BY(send_critsect_);
@@ -395,6 +446,10 @@ class RTPSender : public RTPSenderInterface, public Bitrate::Observer {
   int rtx_ GUARDED_BY(send_critsect_);
   uint32_t ssrc_rtx_ GUARDED_BY(send_critsect_);
   int payload_type_rtx_ GUARDED_BY(send_critsect_);
+  // The first packet of the last key frame sent.
+  bool has_key_frame_ GUARDED_BY(send_critsect_);
+  uint16_t key_frame_sequence_number_ GUARDED_BY(send_critsect_);
+  int64_t key_frame_time_ms_ GUARDED_BY(send_critsect_);
 
   // Note: Don't access this variable directly, always go through
   // SetTargetBitrateKbps or GetTargetBitrateKbps. Also remember
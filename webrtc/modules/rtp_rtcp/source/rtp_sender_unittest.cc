@@ -17,6 +17,7 @@
 #include "webrtc/modules/pacing/include/mock/mock_paced_sender.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_format_video_generic.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extension.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_sender.h"
@@ -29,6 +30,7 @@ namespace webrtc {
 namespace {
 const int kTransmissionTimeOffsetExtensionId = 1;
 const int kAbsoluteSendTimeExtensionId = 14;
+const int kTransportSequenceNumberExtensionId = 13;
 const int kPayload = 100;
 const uint32_t kTimestamp = 10;
 const uint16_t kSeqNum = 33;
@@ -95,7 +97,8 @@ class RtpSenderTest : public ::testing::Test {
 
   virtual void SetUp() {
     rtp_sender_.reset(new RTPSender(0, false, &fake_clock_, &transport_, NULL,
-                                    &mock_paced_sender_, NULL, NULL, NULL));
+                                    &mock_paced_sender_, NULL, NULL, NULL,
+                                    NULL));
     rtp_sender_->SetSequenceNumber(kSeqNum);
   }
 
@@ -673,7 +676,8 @@ TEST_F(RtpSenderTest, SendPadding) {
 TEST_F(RtpSenderTest, SendRedundantPayloads) {
   MockTransport transport;
   rtp_sender_.reset(new RTPSender(0, false, &fake_clock_, &transport, NULL,
-                                  &mock_paced_sender_, NULL, NULL, NULL));
+                                  &mock_paced_sender_, NULL, NULL, NULL,
+                                  NULL));
   rtp_sender_->SetSequenceNumber(kSeqNum);
   // Make all packets go through the pacer.
   EXPECT_CALL(mock_paced_sender_,
@@ -789,6 +793,159 @@ TEST_F(RtpSenderTest, SendGenericVideo) {
   EXPECT_EQ(0, memcmp(payload, payload_data, sizeof(payload)));
 }
 
+TEST_F(RtpSenderTest, ResendLastKeyFrame) {
+  char payload_name[RTP_PAYLOAD_NAME_SIZE] = "GENERIC";
+  const uint8_t payload_type = 127;
+  ASSERT_EQ(0, rtp_sender_->RegisterPayload(payload_name, payload_type, 90000,
+                                            0, 1500));
+  rtp_sender_->SetStorePacketsStatus(true, 10);
+  uint8_t payload[] = {47, 11, 32, 93, 89};
+
+  // Nothing to resend before the first key frame.
+  ASSERT_EQ(0, rtp_sender_->SendOutgoingData(kVideoFrameDelta, payload_type,
+                                             1234, 4321, payload,
+                                             sizeof(payload), NULL));
+  EXPECT_EQ(-1, rtp_sender_->ResendLastKeyFrame(1000));
+
+  ASSERT_EQ(0, rtp_sender_->SendOutgoingData(kVideoFrameKey, payload_type,
+                                             1234, 4321, payload,
+                                             sizeof(payload), NULL));
+  ASSERT_EQ(0, rtp_sender_->SendOutgoingData(kVideoFrameDelta, payload_type,
+                                             1234, 4321, payload,
+                                             sizeof(payload), NULL));
+  EXPECT_EQ(3, transport_.packets_sent_);
+  const int packet_length = transport_.last_sent_packet_len_;
+
+  // The key frame and the delta frame after it are resent, in order.
+  EXPECT_EQ(2 * packet_length, rtp_sender_->ResendLastKeyFrame(1000));
+  EXPECT_EQ(5, transport_.packets_sent_);
+  RtpUtility::RtpHeaderParser rtp_parser(transport_.last_sent_packet_,
+                                         transport_.last_sent_packet_len_);
+  webrtc::RTPHeader rtp_header;
+  ASSERT_TRUE(rtp_parser.Parse(rtp_header));
+  EXPECT_EQ(kSeqNum + 2, rtp_header.sequenceNumber);
+
+  // Too old to be resent.
+  fake_clock_.AdvanceTimeMilliseconds(1001);
+  EXPECT_EQ(-1, rtp_sender_->ResendLastKeyFrame(1000));
+  EXPECT_EQ(5, transport_.packets_sent_);
+}
+
+TEST_F(RtpSenderTest, SendVp8Video) {
+  char payload_name[RTP_PAYLOAD_NAME_SIZE] = "VP8";
+  const uint8_t payload_type = 120;
+  ASSERT_EQ(0, rtp_sender_->RegisterPayload(payload_name, payload_type, 90000,
+                                            0, 1500));
+  rtp_sender_->SetStorePacketsStatus(true, 10);
+  const size_t kFrameSize = 3000;
+  uint8_t frame[kFrameSize];
+  for (size_t i = 0; i < kFrameSize; ++i)
+    frame[i] = static_cast<uint8_t>(i);
+  RTPVideoTypeHeader vp8_header;
+  vp8_header.VP8.InitRTPVideoHeaderVP8();
+
+  ASSERT_EQ(0, rtp_sender_->SendOutgoingData(kVideoFrameKey, payload_type,
+                                             1234, 4321, frame, kFrameSize,
+                                             NULL, NULL, &vp8_header));
+
+  // Each packet carries a one byte VP8 payload descriptor.
+  const int kRtpHeaderLength = rtp_sender_->RTPHeaderLength();
+  EXPECT_EQ(3, transport_.packets_sent_);
+  EXPECT_EQ(kFrameSize + transport_.packets_sent_ * (kRtpHeaderLength + 1),
+            transport_.total_bytes_sent_);
+  const size_t last_payload_length =
+      transport_.last_sent_packet_len_ - kRtpHeaderLength - 1;
+  EXPECT_EQ(0, memcmp(&frame[kFrameSize - last_payload_length],
+                      &transport_.last_sent_packet_[kRtpHeaderLength + 1],
+                      last_payload_length));
+}
+
+TEST_F(RtpSenderTest, SendSlicesToNetwork) {
+  rtp_sender_->SetStorePacketsStatus(true, 10);
+  const uint8_t kFrame[] = {47, 11, 32, 93, 89, 13, 42};
+  for (int i = 0; i < 2; ++i) {
+    const StorageType storage = i == 0 ? kAllowRetransmission : kDontStore;
+    int32_t rtp_length = rtp_sender_->BuildRTPheader(
+        packet_, kPayload, kMarkerBit, kTimestamp, 0);
+    RtpPayloadSlices payload;
+    payload.AppendHeader(1)[0] = 0xAB;
+    payload.AppendPayload(&kFrame[2], sizeof(kFrame) - 2);
+
+    EXPECT_EQ(0, rtp_sender_->SendSlicesToNetwork(
+        packet_, rtp_length, payload, 0, storage,
+        PacedSender::kNormalPriority));
+    EXPECT_EQ(i + 1, transport_.packets_sent_);
+    ASSERT_EQ(rtp_length + static_cast<int>(payload.length()),
+              transport_.last_sent_packet_len_);
+    EXPECT_EQ(0, memcmp(packet_, transport_.last_sent_packet_, rtp_length));
+    EXPECT_EQ(0xAB, transport_.last_sent_packet_[rtp_length]);
+    EXPECT_EQ(0, memcmp(&kFrame[2],
+                        &transport_.last_sent_packet_[rtp_length + 1],
+                        sizeof(kFrame) - 2));
+  }
+
+  // Only the stored packet can be retransmitted.
+  EXPECT_EQ(transport_.last_sent_packet_len_,
+            rtp_sender_->ReSendPacket(kSeqNum));
+  EXPECT_EQ(3, transport_.packets_sent_);
+  RtpUtility::RtpHeaderParser rtp_parser(transport_.last_sent_packet_,
+                                         transport_.last_sent_packet_len_);
+  webrtc::RTPHeader rtp_header;
+  ASSERT_TRUE(rtp_parser.Parse(rtp_header));
+  EXPECT_EQ(kSeqNum, rtp_header.sequenceNumber);
+  EXPECT_EQ(0, rtp_sender_->ReSendPacket(kSeqNum + 1));
+  EXPECT_EQ(3, transport_.packets_sent_);
+}
+
+TEST_F(RtpSenderTest, SendsTransportSequenceNumber) {
+  class TestObserver : public TransportFeedbackObserver {
+   public:
+    TestObserver()
+        : next_sequence_number_(0xfffe), last_length_(0),
+          last_send_time_ms_(-1) {}
+    virtual uint16_t OnSendingPacket(size_t length,
+                                     int64_t send_time_ms) OVERRIDE {
+      last_length_ = length;
+      last_send_time_ms_ = send_time_ms;
+      return next_sequence_number_++;
+    }
+    virtual void OnReceivedTransportFeedback(
+        const std::vector<PacketArrival>& arrivals) OVERRIDE {}
+
+    uint16_t next_sequence_number_;
+    size_t last_length_;
+    int64_t last_send_time_ms_;
+  } observer;
+
+  rtp_sender_.reset(new RTPSender(0, false, &fake_clock_, &transport_, NULL,
+                                  &mock_paced_sender_, NULL, NULL, NULL,
+                                  &observer));
+  EXPECT_EQ(0, rtp_sender_->RegisterRtpHeaderExtension(
+      kRtpExtensionTransportSequenceNumber,
+      kTransportSequenceNumberExtensionId));
+  RtpHeaderExtensionMap map;
+  map.Register(kRtpExtensionTransportSequenceNumber,
+               kTransportSequenceNumberExtensionId);
+
+  const uint16_t kExpectedSequenceNumbers[] = {0xfffe, 0xffff, 0};
+  for (int i = 0; i < 3; ++i) {
+    fake_clock_.AdvanceTimeMilliseconds(10);
+    SendPacket(fake_clock_.TimeInMilliseconds(), 100);
+    ASSERT_EQ(i + 1, transport_.packets_sent_);
+    EXPECT_EQ(static_cast<size_t>(transport_.last_sent_packet_len_),
+              observer.last_length_);
+    EXPECT_EQ(fake_clock_.TimeInMilliseconds(), observer.last_send_time_ms_);
+
+    RtpUtility::RtpHeaderParser rtp_parser(transport_.last_sent_packet_,
+                                           transport_.last_sent_packet_len_);
+    webrtc::RTPHeader rtp_header;
+    ASSERT_TRUE(rtp_parser.Parse(rtp_header, &map));
+    EXPECT_TRUE(rtp_header.extension.hasTransportSequenceNumber);
+    EXPECT_EQ(kExpectedSequenceNumbers[i],
+              rtp_header.extension.transportSequenceNumber);
+  }
+}
+
 TEST_F(RtpSenderTest, FrameCountCallbacks) {
   class TestCallback : public FrameCountObserver {
    public:
@@ -821,7 +978,8 @@ TEST_F(RtpSenderTest, FrameCountCallbacks) {
   } callback;
 
   rtp_sender_.reset(new RTPSender(0, false, &fake_clock_, &transport_, NULL,
-                                  &mock_paced_sender_, NULL, &callback, NULL));
+                                  &mock_paced_sender_, NULL, &callback, NULL,
+                                  NULL));
 
   char payload_name[RTP_PAYLOAD_NAME_SIZE] = "GENERIC";
   const uint8_t payload_type = 127;
@@ -870,7 +1028,8 @@ TEST_F(RtpSenderTest, BitrateCallbacks) {
     BitrateStatistics bitrate_;
   } callback;
   rtp_sender_.reset(new RTPSender(0, false, &fake_clock_, &transport_, NULL,
-                                  &mock_paced_sender_, &callback, NULL, NULL));
+                                  &mock_paced_sender_, &callback, NULL, NULL,
+                                  NULL));
 
   // Simulate kNumPackets sent with kPacketInterval ms intervals.
   const uint32_t kNumPackets = 15;
@@ -926,7 +1085,8 @@ class RtpSenderAudioTest : public RtpSenderTest {
   virtual void SetUp() {
     payload_ = kAudioPayload;
     rtp_sender_.reset(new RTPSender(0, true, &fake_clock_, &transport_, NULL,
-                                    &mock_paced_sender_, NULL, NULL, NULL));
+                                    &mock_paced_sender_, NULL, NULL, NULL,
+                                    NULL));
     rtp_sender_->SetSequenceNumber(kSeqNum);
   }
 };
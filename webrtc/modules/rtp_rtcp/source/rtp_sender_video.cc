@@ -119,17 +119,26 @@ RTPSenderVideo::SendVideoPacket(uint8_t* data_buffer,
     int fec_overhead_sent = 0;
     int video_sent = 0;
 
-    RedPacket* red_packet = producer_fec_.BuildRedPacket(data_buffer,
+    // The media packet is protected as it is, so it is added to the FEC
+    // before it is turned into a RED packet in place.
+    int fec_ret = 0;
+    if (protect) {
+      fec_ret = producer_fec_.AddRtpPacketAndGenerateFec(data_buffer,
                                                          payload_length,
-                                                         rtp_header_length,
-                                                         _payloadTypeRED);
+                                                         rtp_header_length);
+    }
+
+    uint8_t* red_packet = ProducerFec::BuildRedPacketInPlace(
+        data_buffer, rtp_header_length, _payloadTypeRED);
+    const uint16_t red_payload_length =
+        payload_length + ProducerFec::kRedHeadroom;
     TRACE_EVENT_INSTANT2("webrtc_rtp", "Video::PacketRed",
                          "timestamp", capture_timestamp,
                          "seqnum", _rtpSender.SequenceNumber());
     // Sending the media packet with RED header.
     int packet_success = _rtpSender.SendToNetwork(
-        red_packet->data(),
-        red_packet->length() - rtp_header_length,
+        red_packet,
+        red_payload_length,
         rtp_header_length,
         capture_time_ms,
         storage,
@@ -138,25 +147,20 @@ RTPSenderVideo::SendVideoPacket(uint8_t* data_buffer,
     ret |= packet_success;
 
     if (packet_success == 0) {
-      video_sent += red_packet->length();
+      video_sent += red_payload_length + rtp_header_length;
     }
-    delete red_packet;
-    red_packet = NULL;
 
-    if (protect) {
-      ret = producer_fec_.AddRtpPacketAndGenerateFec(data_buffer,
-                                                     payload_length,
-                                                     rtp_header_length);
-      if (ret != 0)
-        return ret;
-    }
+    if (fec_ret != 0)
+      return fec_ret;
 
+    uint8_t fec_packet[IP_PACKET_SIZE];
     while (producer_fec_.FecAvailable()) {
-      red_packet = producer_fec_.GetFecPacket(
+      const int fec_packet_length = producer_fec_.GetFecPacket(
           _payloadTypeRED,
           _payloadTypeFEC,
           _rtpSender.IncrementSequenceNumber(),
-          rtp_header_length);
+          rtp_header_length,
+          fec_packet);
       StorageType storage = kDontRetransmit;
       if (_retransmissionSettings & kRetransmitFECPackets) {
         storage = kAllowRetransmission;
@@ -166,8 +170,8 @@ RTPSenderVideo::SendVideoPacket(uint8_t* data_buffer,
                            "seqnum", _rtpSender.SequenceNumber());
       // Sending FEC packet with RED header.
       int packet_success = _rtpSender.SendToNetwork(
-          red_packet->data(),
-          red_packet->length() - rtp_header_length,
+          fec_packet,
+          fec_packet_length - rtp_header_length,
           rtp_header_length,
           capture_time_ms,
           storage,
@@ -176,10 +180,8 @@ RTPSenderVideo::SendVideoPacket(uint8_t* data_buffer,
       ret |= packet_success;
 
       if (packet_success == 0) {
-        fec_overhead_sent += red_packet->length();
+        fec_overhead_sent += fec_packet_length;
       }
-      delete red_packet;
-      red_packet = NULL;
     }
     _videoBitrate.Update(video_sent);
     _fecOverheadRate.Update(fec_overhead_sent);
@@ -200,6 +202,42 @@ RTPSenderVideo::SendVideoPacket(uint8_t* data_buffer,
   return ret;
 }
 
+int32_t RTPSenderVideo::SendVideoPacket(uint8_t* rtp_header,
+                                        const uint16_t rtp_header_length,
+                                        const RtpPayloadSlices& payload,
+                                        const uint32_t capture_timestamp,
+                                        int64_t capture_time_ms,
+                                        StorageType storage,
+                                        bool protect) {
+  const uint16_t payload_length = static_cast<uint16_t>(payload.length());
+  if (_fecEnabled) {
+    // RED and FEC are built from the whole packet, with headroom for
+    // building the RED packet in place.
+    uint8_t packet_buffer[ProducerFec::kRedHeadroom + IP_PACKET_SIZE];
+    uint8_t* data_buffer = packet_buffer + ProducerFec::kRedHeadroom;
+    if (rtp_header_length + payload_length > IP_PACKET_SIZE)
+      return -1;
+    memcpy(data_buffer, rtp_header, rtp_header_length);
+    payload.CopyTo(data_buffer + rtp_header_length);
+    return SendVideoPacket(data_buffer, payload_length, rtp_header_length,
+                           capture_timestamp, capture_time_ms, storage,
+                           protect);
+  }
+  TRACE_EVENT_INSTANT2("webrtc_rtp", "Video::PacketNormal",
+                       "timestamp", capture_timestamp,
+                       "seqnum", _rtpSender.SequenceNumber());
+  int ret = _rtpSender.SendSlicesToNetwork(rtp_header,
+                                           rtp_header_length,
+                                           payload,
+                                           capture_time_ms,
+                                           storage,
+                                           PacedSender::kNormalPriority);
+  if (ret == 0) {
+    _videoBitrate.Update(payload_length + rtp_header_length);
+  }
+  return ret;
+}
+
 int32_t
 RTPSenderVideo::SendRTPIntraRequest()
 {
@@ -288,6 +326,8 @@ int32_t RTPSenderVideo::SendVideo(const RtpVideoCodecTypes videoType,
   if (payloadSize == 0) {
     return -1;
   }
+  TRACE_EVENT2("webrtc_rtp", "Video::Packetize",
+               "timestamp", captureTimeStamp, "size", payloadSize);
 
   if (frameType == kVideoFrameKey) {
     producer_fec_.SetFecParameters(&key_fec_params_, _numberFirstPartition);
@@ -350,8 +390,10 @@ int32_t RTPSenderVideo::SendGeneric(const FrameType frame_type,
   uint32_t payload_length = (size + num_packets - 1) / num_packets;
   assert(payload_length <= max_length);
 
-  // Fragment packet into packets of max MaxPayloadLength bytes payload.
-  uint8_t buffer[IP_PACKET_SIZE];
+  // Fragment packet into packets of max MaxPayloadLength bytes payload, with
+  // headroom for building RED packets in place.
+  uint8_t packet_buffer[ProducerFec::kRedHeadroom + IP_PACKET_SIZE];
+  uint8_t* buffer = packet_buffer + ProducerFec::kRedHeadroom;
 
   uint8_t generic_header = RtpFormatVideoGeneric::kFirstPacketBit;
   if (frame_type == kVideoFrameKey) {
@@ -448,22 +490,22 @@ RTPSenderVideo::SendVP8(const FrameType frameType,
     // only protect base layers, so look for these two cases.
     bool protect = rtpTypeHdr->VP8.temporalIdx == 0 ||
         rtpTypeHdr->VP8.temporalIdx == kNoTemporalIdx;
+    // The packets refer to the encoded frame instead of copying it.
+    RtpPayloadSlices payload;
     while (!last)
     {
-        // Write VP8 Payload Descriptor and VP8 payload.
-        uint8_t dataBuffer[IP_PACKET_SIZE] = {0};
-        size_t payloadBytesInPacket = 0;
-        if (!packetizer.NextPacket(
-                &dataBuffer[rtpHeaderLength], &payloadBytesInPacket, &last))
+        // Write VP8 Payload Descriptor and refer to VP8 payload.
+        if (!packetizer.NextPacketSlices(&payload, &last))
           return -1;
 
         // Write RTP header.
         // Set marker bit true if this is the last packet in frame.
-        _rtpSender.BuildRTPheader(dataBuffer, payloadType, last,
+        uint8_t rtpHeader[IP_PACKET_SIZE];
+        _rtpSender.BuildRTPheader(rtpHeader, payloadType, last,
             captureTimeStamp, capture_time_ms);
-        if (-1 == SendVideoPacket(dataBuffer, payloadBytesInPacket,
-                                  rtpHeaderLength, captureTimeStamp,
-                                  capture_time_ms, storage, protect))
+        if (-1 == SendVideoPacket(rtpHeader, rtpHeaderLength, payload,
+                                  captureTimeStamp, capture_time_ms, storage,
+                                  protect))
         {
           LOG(LS_WARNING)
               << "RTPSenderVideo::SendVP8 failed to send packet number "
@@ -496,22 +538,22 @@ bool RTPSenderVideo::SendH264(const FrameType frameType,
   bool protect = (frameType == kVideoFrameKey);
   bool last = false;
 
+  // The packets refer to the encoded frame instead of copying it.
+  RtpPayloadSlices payload;
   while (!last) {
-    // Write H264 payload.
-    uint8_t dataBuffer[IP_PACKET_SIZE] = {0};
-    size_t payload_bytes_in_packet = 0;
-    if (!packetizer->NextPacket(
-            &dataBuffer[rtp_header_length], &payload_bytes_in_packet, &last)) {
+    // Refer to H264 payload.
+    if (!packetizer->NextPacketSlices(&payload, &last)) {
       return false;
     }
 
     // Write RTP header.
     // Set marker bit true if this is the last packet in frame.
+    uint8_t rtp_header[IP_PACKET_SIZE];
     _rtpSender.BuildRTPheader(
-        dataBuffer, payloadType, last, captureTimeStamp, capture_time_ms);
-    if (SendVideoPacket(dataBuffer,
-                        payload_bytes_in_packet,
+        rtp_header, payloadType, last, captureTimeStamp, capture_time_ms);
+    if (SendVideoPacket(rtp_header,
                         rtp_header_length,
+                        payload,
                         captureTimeStamp,
                         capture_time_ms,
                         storage,
@@ -18,6 +18,7 @@
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
 #include "webrtc/modules/rtp_rtcp/source/producer_fec.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_sender.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
@@ -86,6 +87,9 @@ public:
     int SetSelectiveRetransmissions(uint8_t settings);
 
 protected:
+    // When FEC is enabled the packet is turned into a RED packet in place,
+    // which needs ProducerFec::kRedHeadroom writable bytes in front of
+    // |dataBuffer|.
     virtual int32_t SendVideoPacket(uint8_t* dataBuffer,
                                     const uint16_t payloadLength,
                                     const uint16_t rtpHeaderLength,
@@ -94,6 +98,16 @@ protected:
                                     StorageType storage,
                                     bool protect);
 
+    // Same as above, but takes the RTP header and the payload separately, so
+    // that the payload is copied only once when FEC is off.
+    int32_t SendVideoPacket(uint8_t* rtp_header,
+                            const uint16_t rtp_header_length,
+                            const RtpPayloadSlices& payload,
+                            const uint32_t capture_timestamp,
+                            int64_t capture_time_ms,
+                            StorageType storage,
+                            bool protect);
+
 private:
     int32_t SendGeneric(const FrameType frame_type,
                         const int8_t payload_type,
@@ -398,6 +398,10 @@ bool RtpHeaderParser::Parse(RTPHeader& header,
   header.extension.hasAbsoluteSendTime = false;
   header.extension.absoluteSendTime = 0;
 
+  // May not be present in packet.
+  header.extension.hasTransportSequenceNumber = false;
+  header.extension.transportSequenceNumber = 0;
+
   // May not be present in packet.
   header.extension.hasAudioLevel = false;
   header.extension.audioLevel = 0;
@@ -469,8 +473,8 @@ void RtpHeaderParser::ParseOneByteExtensionHeader(
       return;
     }
 
-    RTPExtensionType type;
-    if (ptrExtensionMap->GetType(id, &type) != 0) {
+    const RTPExtensionType type = ptrExtensionMap->GetTypeOrNone(id);
+    if (type == kRtpExtensionNone) {
       // If we encounter an unknown extension, just skip over it.
       LOG(LS_WARNING) << "Failed to find extension id: "
                       << static_cast<int>(id);
@@ -540,6 +544,22 @@ void RtpHeaderParser::ParseOneByteExtensionHeader(
           header.extension.hasAbsoluteSendTime = true;
           break;
         }
+        case kRtpExtensionTransportSequenceNumber: {
+          if (len != 1) {
+            LOG(LS_WARNING) << "Incorrect transport sequence number len: "
+                            << len;
+            return;
+          }
+          //  0                   1                   2
+          //  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3
+          // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+          // |  ID   | len=1 |   transport sequence number   |
+          // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+          header.extension.transportSequenceNumber = (ptr[0] << 8) + ptr[1];
+          header.extension.hasTransportSequenceNumber = true;
+          break;
+        }
         default: {
           LOG(LS_WARNING) << "Extension type not implemented: " << type;
           return;
@@ -11,11 +11,28 @@
 #include "webrtc/modules/rtp_rtcp/source/tmmbr_help.h"
 
 #include <assert.h>
-#include <limits>
 #include <string.h>
+
+#include <algorithm>
+#include <limits>
+
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_config.h"
 
 namespace webrtc {
+namespace {
+struct Candidate {
+  Candidate(uint32_t tmmbr, uint32_t packet_oh, uint32_t ssrc)
+      : tmmbr(tmmbr), packet_oh(packet_oh), ssrc(ssrc) {}
+  uint32_t tmmbr;
+  uint32_t packet_oh;
+  uint32_t ssrc;
+};
+
+bool LowerPacketOH(const Candidate& a, const Candidate& b) {
+  return a.packet_oh < b.packet_oh;
+}
+}  // namespace
+
 TMMBRSet::TMMBRSet() :
     _sizeOfSet(0),
     _lengthOfSet(0)
@@ -269,175 +286,108 @@ TMMBRHelp::FindTMMBRBoundingSet(int32_t numCandidates, TMMBRSet& candidateSet)
         return (numBoundingSet == 1) ? 1 : -1;
     }
 
-    // 1. Sort by increasing packetOH
-    for (int i = candidateSet.sizeOfSet() - 1; i >= 0; i--)
+    // 1. Sort by increasing packetOH, keeping the order of equal ones.
+    std::vector<Candidate> candidates;
+    candidates.reserve(candidateSet.sizeOfSet());
+    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
     {
-        for (int j = 1; j <= i; j++)
+        if (candidateSet.Tmmbr(i) > 0)
         {
-            if (candidateSet.PacketOH(j-1) > candidateSet.PacketOH(j))
-            {
-                candidateSet.SwapEntries(j-1, j);
-            }
+            candidates.push_back(Candidate(candidateSet.Tmmbr(i),
+                                           candidateSet.PacketOH(i),
+                                           candidateSet.Ssrc(i)));
         }
     }
+    std::stable_sort(candidates.begin(), candidates.end(), LowerPacketOH);
     // 2. For tuples with same OH, keep the one w/ the lowest bitrate
-    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
+    // (the first one if more than 1).
+    size_t numDistinct = 0;
+    for (size_t i = 0; i < candidates.size(); i++)
     {
-        if (candidateSet.Tmmbr(i) > 0)
+        if (numDistinct > 0 &&
+            candidates[numDistinct - 1].packet_oh == candidates[i].packet_oh)
         {
-            // get min bitrate for packets w/ same OH
-            uint32_t currentPacketOH = candidateSet.PacketOH(i);
-            uint32_t currentMinTMMBR = candidateSet.Tmmbr(i);
-            uint32_t currentMinIndexTMMBR = i;
-            for (uint32_t j = i+1; j < candidateSet.sizeOfSet(); j++)
+            if (candidates[i].tmmbr < candidates[numDistinct - 1].tmmbr)
             {
-                if(candidateSet.PacketOH(j) == currentPacketOH)
-                {
-                    if(candidateSet.Tmmbr(j) < currentMinTMMBR)
-                    {
-                        currentMinTMMBR = candidateSet.Tmmbr(j);
-                        currentMinIndexTMMBR = j;
-                    }
-                }
-            }
-            // keep lowest bitrate
-            for (uint32_t j = 0; j < candidateSet.sizeOfSet(); j++)
-            {
-              if(candidateSet.PacketOH(j) == currentPacketOH
-                  && j != currentMinIndexTMMBR)
-                {
-                    candidateSet.ClearEntry(j);
-                }
+                candidates[numDistinct - 1] = candidates[i];
             }
+        } else
+        {
+            candidates[numDistinct++] = candidates[i];
         }
     }
-    // 3. Select and remove tuple w/ lowest tmmbr.
-    // (If more than 1, choose the one w/ highest OH).
-    uint32_t minTMMBR = 0;
-    uint32_t minIndexTMMBR = 0;
-    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
+    candidates.erase(candidates.begin() + numDistinct, candidates.end());
+    if (candidates.empty())
     {
-        if (candidateSet.Tmmbr(i) > 0)
-        {
-            minTMMBR = candidateSet.Tmmbr(i);
-            minIndexTMMBR = i;
-            break;
-        }
+        return -1;
     }
 
-    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
+    // 3. Select tuple w/ lowest tmmbr.
+    // (If more than 1, choose the one w/ highest OH).
+    size_t minIndexTMMBR = 0;
+    for (size_t i = 1; i < candidates.size(); i++)
     {
-        if (candidateSet.Tmmbr(i) > 0 && candidateSet.Tmmbr(i) <= minTMMBR)
+        if (candidates[i].tmmbr <= candidates[minIndexTMMBR].tmmbr)
         {
-            // get min bitrate
-            minTMMBR = candidateSet.Tmmbr(i);
             minIndexTMMBR = i;
         }
     }
-    // first member of selected list
-    _boundingSet.SetEntry(numBoundingSet,
-                          candidateSet.Tmmbr(minIndexTMMBR),
-                          candidateSet.PacketOH(minIndexTMMBR),
-                          candidateSet.Ssrc(minIndexTMMBR));
-
-    // set intersection value
-    _ptrIntersectionBoundingSet[numBoundingSet] = 0;
-    // calculate its maximum packet rate (where its line crosses x-axis)
-    _ptrMaxPRBoundingSet[numBoundingSet]
-        = _boundingSet.Tmmbr(numBoundingSet) * 1000
-        / float(8 * _boundingSet.PacketOH(numBoundingSet));
-    numBoundingSet++;
-    // remove from candidate list
-    candidateSet.ClearEntry(minIndexTMMBR);
-    numCandidates--;
+    // The selected list, as indices into |candidates|. Each tuple is stored
+    // with the packet rate where its line intersects the line of the
+    // previous tuple, and its maximum packet rate (where its line crosses
+    // the x-axis).
+    std::vector<size_t> selected;
+    selected.reserve(candidates.size());
+    selected.push_back(minIndexTMMBR);
+    _ptrIntersectionBoundingSet[0] = 0;
+    _ptrMaxPRBoundingSet[0] = candidates[minIndexTMMBR].tmmbr * 1000
+        / float(8 * candidates[minIndexTMMBR].packet_oh);
 
     // 4. Discard from candidate list all tuple w/ lower OH
-    // (next tuple must be steeper)
-    for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
-    {
-        if(candidateSet.Tmmbr(i) > 0
-            && candidateSet.PacketOH(i) < _boundingSet.PacketOH(0))
-        {
-            candidateSet.ClearEntry(i);
-            numCandidates--;
-        }
-    }
-
-    if (numCandidates == 0)
-    {
-        // Should be true already:_boundingSet.lengthOfSet = numBoundingSet;
-        assert(_boundingSet.lengthOfSet() == numBoundingSet);
-        return numBoundingSet;
-    }
-
-    bool getNewCandidate = true;
-    int curCandidateTMMBR = 0;
-    int curCandidateIndex = 0;
-    int curCandidatePacketOH = 0;
-    int curCandidateSSRC = 0;
-    do
+    // (next tuple must be steeper). These are the ones sorted before it.
+    // 5. Go through the remaining tuples in order of increasing OH.
+    for (size_t i = minIndexTMMBR + 1; i < candidates.size(); i++)
     {
-        if (getNewCandidate)
+        const Candidate& candidate = candidates[i];
+        while (true)
         {
-            // 5. Remove first remaining tuple from candidate list
-            for (uint32_t i = 0; i < candidateSet.sizeOfSet(); i++)
+            // 6. Calculate packet rate and intersection of the current
+            // line with line of last tuple in selected list
+            const Candidate& last = candidates[selected.back()];
+            float packetRate
+                = float(candidate.tmmbr - last.tmmbr) * 1000
+                / (8 * (candidate.packet_oh - last.packet_oh));
+
+            // 7. If the packet rate is equal or lower than intersection of
+            //    last tuple in selected list,
+            //    remove last tuple in selected list & go back to step 6
+            if (selected.size() > 1 &&
+                packetRate <= _ptrIntersectionBoundingSet[selected.size() - 1])
             {
-                if (candidateSet.Tmmbr(i) > 0)
-                {
-                    curCandidateTMMBR    = candidateSet.Tmmbr(i);
-                    curCandidatePacketOH = candidateSet.PacketOH(i);
-                    curCandidateSSRC     = candidateSet.Ssrc(i);
-                    curCandidateIndex    = i;
-                    candidateSet.ClearEntry(curCandidateIndex);
-                    break;
-                }
+                selected.pop_back();
+                continue;
             }
-        }
-
-        // 6. Calculate packet rate and intersection of the current
-        // line with line of last tuple in selected list
-        float packetRate
-            = float(curCandidateTMMBR
-                    - _boundingSet.Tmmbr(numBoundingSet-1))*1000
-            / (8*(curCandidatePacketOH
-                  - _boundingSet.PacketOH(numBoundingSet-1)));
-
-        // 7. If the packet rate is equal or lower than intersection of
-        //    last tuple in selected list,
-        //    remove last tuple in selected list & go back to step 6
-        if(packetRate <= _ptrIntersectionBoundingSet[numBoundingSet-1])
-        {
-            // remove last tuple and goto step 6
-            numBoundingSet--;
-            _boundingSet.ClearEntry(numBoundingSet);
-            _ptrIntersectionBoundingSet[numBoundingSet] = 0;
-            _ptrMaxPRBoundingSet[numBoundingSet]        = 0;
-            getNewCandidate = false;
-        } else
-        {
             // 8. If packet rate is lower than maximum packet rate of
             // last tuple in selected list, add current tuple to selected
             // list
-            if (packetRate < _ptrMaxPRBoundingSet[numBoundingSet-1])
+            if (packetRate < _ptrMaxPRBoundingSet[selected.size() - 1])
             {
-                _boundingSet.SetEntry(numBoundingSet,
-                                      curCandidateTMMBR,
-                                      curCandidatePacketOH,
-                                      curCandidateSSRC);
-                _ptrIntersectionBoundingSet[numBoundingSet] = packetRate;
-                _ptrMaxPRBoundingSet[numBoundingSet]
-                    = _boundingSet.Tmmbr(numBoundingSet)*1000
-                    / float(8*_boundingSet.PacketOH(numBoundingSet));
-                numBoundingSet++;
+                _ptrIntersectionBoundingSet[selected.size()] = packetRate;
+                _ptrMaxPRBoundingSet[selected.size()] = candidate.tmmbr * 1000
+                    / float(8 * candidate.packet_oh);
+                selected.push_back(i);
             }
-            numCandidates--;
-            getNewCandidate = true;
+            break;
         }
-
         // 9. Go back to step 5 if any tuple remains in candidate list
-    } while (numCandidates > 0);
+    }
 
-    return numBoundingSet;
+    for (size_t i = 0; i < selected.size(); i++)
+    {
+        const Candidate& tuple = candidates[selected[i]];
+        _boundingSet.AddEntry(tuple.tmmbr, tuple.packet_oh, tuple.ssrc);
+    }
+    return static_cast<int32_t>(selected.size());
 }
 
 bool TMMBRHelp::IsOwner(const uint32_t ssrc,
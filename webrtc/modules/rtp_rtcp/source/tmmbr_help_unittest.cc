@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/source/tmmbr_help.h"
+
+namespace webrtc {
+namespace {
+
+TEST(TMMBRHelpTest, SingleCandidate) {
+  TMMBRHelp tmmbr_help;
+  TMMBRSet* candidates = tmmbr_help.VerifyAndAllocateCandidateSet(1);
+  candidates->SetEntry(0, 100, 40, 1);
+
+  TMMBRSet* bounding_set = NULL;
+  ASSERT_EQ(1, tmmbr_help.FindTMMBRBoundingSet(bounding_set));
+  ASSERT_TRUE(bounding_set != NULL);
+  ASSERT_EQ(1u, bounding_set->lengthOfSet());
+  EXPECT_EQ(100u, bounding_set->Tmmbr(0));
+  EXPECT_EQ(40u, bounding_set->PacketOH(0));
+  EXPECT_EQ(1u, bounding_set->Ssrc(0));
+}
+
+// Candidates sharing a packet overhead collapse into the one with the lowest
+// bitrate, and do not leave empty entries in the bounding set.
+TEST(TMMBRHelpTest, TwoCandidatesWithSameOverhead) {
+  TMMBRHelp tmmbr_help;
+  TMMBRSet* candidates = tmmbr_help.VerifyAndAllocateCandidateSet(2);
+  candidates->SetEntry(0, 300, 20, 1);
+  candidates->SetEntry(1, 250, 20, 2);
+
+  TMMBRSet* bounding_set = NULL;
+  ASSERT_EQ(1, tmmbr_help.FindTMMBRBoundingSet(bounding_set));
+  ASSERT_TRUE(bounding_set != NULL);
+  ASSERT_EQ(1u, bounding_set->lengthOfSet());
+  EXPECT_EQ(250u, bounding_set->Tmmbr(0));
+  EXPECT_EQ(20u, bounding_set->PacketOH(0));
+  EXPECT_EQ(2u, bounding_set->Ssrc(0));
+}
+
+TEST(TMMBRHelpTest, DuplicateOverheads) {
+  TMMBRHelp tmmbr_help;
+  TMMBRSet* candidates = tmmbr_help.VerifyAndAllocateCandidateSet(5);
+  // The lowest bitrate, bounding at low packet rates.
+  candidates->SetEntry(0, 120, 40, 1);
+  candidates->SetEntry(1, 100, 40, 2);
+  // A larger overhead, bounding at high packet rates.
+  candidates->SetEntry(2, 180, 200, 3);
+  candidates->SetEntry(3, 150, 200, 4);
+  candidates->SetEntry(4, 150, 200, 5);
+
+  TMMBRSet* bounding_set = NULL;
+  ASSERT_EQ(2, tmmbr_help.FindTMMBRBoundingSet(bounding_set));
+  ASSERT_TRUE(bounding_set != NULL);
+  ASSERT_EQ(2u, bounding_set->lengthOfSet());
+  EXPECT_EQ(100u, bounding_set->Tmmbr(0));
+  EXPECT_EQ(40u, bounding_set->PacketOH(0));
+  EXPECT_EQ(2u, bounding_set->Ssrc(0));
+  // The first of the equal candidates is kept.
+  EXPECT_EQ(150u, bounding_set->Tmmbr(1));
+  EXPECT_EQ(200u, bounding_set->PacketOH(1));
+  EXPECT_EQ(4u, bounding_set->Ssrc(1));
+
+  EXPECT_TRUE(tmmbr_help.IsOwner(2, 2));
+  EXPECT_TRUE(tmmbr_help.IsOwner(4, 2));
+  EXPECT_FALSE(tmmbr_help.IsOwner(1, 2));
+  EXPECT_FALSE(tmmbr_help.IsOwner(3, 2));
+  EXPECT_FALSE(tmmbr_help.IsOwner(5, 2));
+}
+
+// A candidate with a larger overhead and a larger bitrate than one it never
+// undercuts is not part of the bounding set.
+TEST(TMMBRHelpTest, DuplicateOverheadsOutsideBoundingSet) {
+  TMMBRHelp tmmbr_help;
+  TMMBRSet* candidates = tmmbr_help.VerifyAndAllocateCandidateSet(4);
+  candidates->SetEntry(0, 100, 40, 1);
+  candidates->SetEntry(1, 100, 40, 2);
+  candidates->SetEntry(2, 300, 80, 3);
+  candidates->SetEntry(3, 400, 80, 4);
+
+  TMMBRSet* bounding_set = NULL;
+  ASSERT_EQ(1, tmmbr_help.FindTMMBRBoundingSet(bounding_set));
+  ASSERT_TRUE(bounding_set != NULL);
+  ASSERT_EQ(1u, bounding_set->lengthOfSet());
+  EXPECT_EQ(100u, bounding_set->Tmmbr(0));
+  EXPECT_EQ(1u, bounding_set->Ssrc(0));
+}
+
+}  // namespace
+}  // namespace webrtc
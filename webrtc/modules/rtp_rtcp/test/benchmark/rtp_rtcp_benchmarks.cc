@@ -0,0 +1,499 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the per packet cost of the RTP/RTCP module's hot paths: VP8
+// packetization, FEC encoding and decoding, RTP header parsing, the packet
+// history used for retransmissions, building and parsing RTCP reports and
+// NACKs, and the TMMBR bounding set. Every case is printed as ns_per_packet
+// and packets_per_second perf results, so that runs can be compared by
+// machine.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_format_vp8.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
+#include "webrtc/modules/rtp_rtcp/source/tmmbr_help.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/typedefs.h"
+
+DEFINE_int32(iterations, 10000,
+             "The number of times each case is run. A case handles one frame, "
+             "packet or RTCP report per run.");
+
+namespace webrtc {
+namespace {
+
+const uint32_t kSsrc = 0x12345678;
+const uint32_t kRemoteSsrc = 0x87654321;
+const int kMaxPayloadLength = 1200;
+const int kRtpHeaderLength = 12;
+// Large enough for the biggest compound RTCP packets built below.
+const size_t kRtcpBufferLength = 8192;
+
+// Keeps the compiler from dropping the benchmarked work.
+volatile size_t g_sink = 0;
+
+void PrintResult(const std::string& measurement,
+                 const std::string& trace,
+                 int64_t elapsed_us,
+                 int64_t num_packets) {
+  if (elapsed_us <= 0)
+    elapsed_us = 1;
+  if (num_packets <= 0)
+    num_packets = 1;
+  char ns_per_packet[32];
+  char packets_per_second[32];
+  snprintf(ns_per_packet, sizeof(ns_per_packet), "%.1f",
+           1000.0 * elapsed_us / num_packets);
+  snprintf(packets_per_second, sizeof(packets_per_second), "%.0f",
+           1e6 * num_packets / elapsed_us);
+  test::PrintResult(measurement, "_ns_per_packet", trace, ns_per_packet, "ns",
+                    false);
+  test::PrintResult(measurement, "_packets_per_second", trace,
+                    packets_per_second, "packets/s", false);
+}
+
+void WriteRtpHeader(uint16_t seq_num, uint32_t timestamp, uint8_t* packet) {
+  memset(packet, 0, kRtpHeaderLength);
+  packet[0] = 0x80;  // Version 2.
+  packet[1] = 100;   // Payload type.
+  RtpUtility::AssignUWord16ToBuffer(&packet[2], seq_num);
+  RtpUtility::AssignUWord32ToBuffer(&packet[4], timestamp);
+  RtpUtility::AssignUWord32ToBuffer(&packet[8], kSsrc);
+}
+
+// Packetizes |frame_length| byte frames, either copying each packet into a
+// buffer or only describing it with payload slices.
+void BenchmarkPacketizeVp8(int frame_length, bool use_slices) {
+  std::vector<uint8_t> frame(frame_length);
+  for (int i = 0; i < frame_length; ++i)
+    frame[i] = static_cast<uint8_t>(i);
+  RTPVideoHeaderVP8 hdr_info;
+  hdr_info.InitRTPVideoHeaderVP8();
+  hdr_info.pictureId = 17;
+  uint8_t packet[IP_PACKET_SIZE];
+  RtpPayloadSlices slices;
+
+  int64_t num_packets = 0;
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    RtpPacketizerVp8 packetizer(hdr_info, kMaxPayloadLength);
+    packetizer.SetPayloadData(&frame[0], frame.size(), NULL);
+    bool last_packet = false;
+    while (!last_packet) {
+      if (use_slices) {
+        if (!packetizer.NextPacketSlices(&slices, &last_packet))
+          break;
+        g_sink += slices.length();
+      } else {
+        size_t num_bytes = 0;
+        if (!packetizer.NextPacket(packet, &num_bytes, &last_packet))
+          break;
+        g_sink += num_bytes;
+      }
+      ++num_packets;
+    }
+  }
+  const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+
+  char trace[64];
+  snprintf(trace, sizeof(trace), "%d_bytes%s", frame_length,
+           use_slices ? "_slices" : "");
+  PrintResult("rtp_packetize_vp8", trace, elapsed_us, num_packets);
+}
+
+class FecBenchmark {
+ public:
+  FecBenchmark(int num_media_packets, uint8_t protection_factor,
+               FecMaskType mask_type)
+      : num_media_packets_(num_media_packets),
+        protection_factor_(protection_factor),
+        mask_type_(mask_type) {
+    for (int i = 0; i < num_media_packets_; ++i) {
+      ForwardErrorCorrection::Packet* packet =
+          new ForwardErrorCorrection::Packet();
+      packet->length = kMaxPayloadLength;
+      for (int j = kRtpHeaderLength; j < packet->length; ++j)
+        packet->data[j] = static_cast<uint8_t>(i + j);
+      WriteRtpHeader(kFirstSeqNum + i, 3000, packet->data);
+      if (i == num_media_packets_ - 1)
+        packet->data[1] |= 0x80;  // Marker bit on the last packet.
+      media_packets_.push_back(packet);
+    }
+  }
+
+  ~FecBenchmark() {
+    while (!media_packets_.empty()) {
+      delete media_packets_.front();
+      media_packets_.pop_front();
+    }
+  }
+
+  // Counts the protected media packets.
+  void BenchmarkEncode() {
+    ForwardErrorCorrection fec;
+    ForwardErrorCorrection::PacketList fec_packets;
+    int64_t num_packets = 0;
+    const TickTime start = TickTime::Now();
+    for (int i = 0; i < FLAGS_iterations; ++i) {
+      // The FEC packets are owned by |fec| and reused by the next call.
+      fec_packets.clear();
+      fec.GenerateFEC(media_packets_, protection_factor_, 0, false, mask_type_,
+                      &fec_packets);
+      g_sink += fec_packets.size();
+      num_packets += num_media_packets_;
+    }
+    const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+    PrintResult("fec_encode", Trace(), elapsed_us, num_packets);
+  }
+
+  // Receives all but the first media packet together with the FEC packets,
+  // and counts the received packets. The cost includes copying the packets
+  // into the received list, as the receiver does.
+  void BenchmarkDecode() {
+    ForwardErrorCorrection encoder;
+    ForwardErrorCorrection::PacketList fec_packets;
+    if (encoder.GenerateFEC(media_packets_, protection_factor_, 0, false,
+                            mask_type_, &fec_packets) != 0 ||
+        fec_packets.empty()) {
+      return;
+    }
+
+    ForwardErrorCorrection decoder;
+    ForwardErrorCorrection::ReceivedPacketList received_packets;
+    ForwardErrorCorrection::RecoveredPacketList recovered_packets;
+    int64_t num_packets = 0;
+    const TickTime start = TickTime::Now();
+    for (int i = 0; i < FLAGS_iterations; ++i) {
+      ForwardErrorCorrection::PacketList::const_iterator it =
+          media_packets_.begin();
+      uint16_t seq_num = kFirstSeqNum;
+      for (++it, ++seq_num; it != media_packets_.end(); ++it, ++seq_num)
+        AddReceivedPacket(**it, seq_num, false, &received_packets);
+      for (it = fec_packets.begin(); it != fec_packets.end(); ++it, ++seq_num)
+        AddReceivedPacket(**it, seq_num, true, &received_packets);
+      num_packets += received_packets.size();
+
+      decoder.DecodeFEC(&received_packets, &recovered_packets);
+      g_sink += recovered_packets.size();
+      decoder.ResetState(&recovered_packets);
+    }
+    const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+    PrintResult("fec_decode", Trace(), elapsed_us, num_packets);
+  }
+
+ private:
+  static const uint16_t kFirstSeqNum = 1000;
+
+  static void AddReceivedPacket(
+      const ForwardErrorCorrection::Packet& packet,
+      uint16_t seq_num,
+      bool is_fec,
+      ForwardErrorCorrection::ReceivedPacketList* received_packets) {
+    ForwardErrorCorrection::ReceivedPacket* received_packet =
+        new ForwardErrorCorrection::ReceivedPacket();
+    received_packet->pkt = new ForwardErrorCorrection::Packet();
+    received_packet->pkt->length = packet.length;
+    memcpy(received_packet->pkt->data, packet.data, packet.length);
+    received_packet->seq_num = seq_num;
+    received_packet->is_fec = is_fec;
+    received_packet->ssrc = kSsrc;
+    received_packets->push_back(received_packet);
+  }
+
+  std::string Trace() const {
+    char trace[64];
+    snprintf(trace, sizeof(trace), "%d_packets_%d_protection_%s",
+             num_media_packets_, protection_factor_,
+             mask_type_ == kFecMaskBursty ? "bursty" : "random");
+    return trace;
+  }
+
+  const int num_media_packets_;
+  const uint8_t protection_factor_;
+  const FecMaskType mask_type_;
+  ForwardErrorCorrection::PacketList media_packets_;
+};
+
+void BenchmarkParseRtpHeader(bool with_extensions) {
+  scoped_ptr<RtpHeaderParser> parser(RtpHeaderParser::Create());
+  const uint8_t kTransmissionOffsetId = 1;
+  const uint8_t kAbsoluteSendTimeId = 3;
+  parser->RegisterRtpHeaderExtension(kRtpExtensionTransmissionTimeOffset,
+                                     kTransmissionOffsetId);
+  parser->RegisterRtpHeaderExtension(kRtpExtensionAbsoluteSendTime,
+                                     kAbsoluteSendTimeId);
+
+  uint8_t packet[IP_PACKET_SIZE];
+  memset(packet, 0, sizeof(packet));
+  WriteRtpHeader(1000, 3000, packet);
+  size_t length = kRtpHeaderLength;
+  if (with_extensions) {
+    packet[0] |= 0x10;
+    // One-byte header extensions, two 32-bit words long.
+    const uint8_t kExtensions[] = {
+        0xBE, 0xDE, 0x00, 0x02,
+        (kTransmissionOffsetId << 4) | 2, 0x00, 0x01, 0x02,
+        (kAbsoluteSendTimeId << 4) | 2, 0x03, 0x04, 0x05};
+    memcpy(&packet[length], kExtensions, sizeof(kExtensions));
+    length += sizeof(kExtensions);
+  }
+  length += kMaxPayloadLength;
+
+  RTPHeader header;
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    if (parser->Parse(packet, length, &header))
+      g_sink += header.headerLength;
+  }
+  const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+  PrintResult("rtp_header_parse",
+              with_extensions ? "with_extensions" : "no_extensions",
+              elapsed_us, FLAGS_iterations);
+}
+
+// Stores one packet and looks up an older one per run, the way the sender
+// resends a packet for each NACKed sequence number.
+void BenchmarkPacketHistory(uint16_t history_length, bool borrow) {
+  RTPPacketHistory history(Clock::GetRealTimeClock());
+  history.SetStorePacketsStatus(true, history_length);
+  const uint16_t lookup_distance = history_length / 2;
+
+  uint8_t packet[IP_PACKET_SIZE];
+  memset(packet, 0, sizeof(packet));
+  const uint16_t packet_length = kRtpHeaderLength + kMaxPayloadLength;
+  uint8_t resend_buffer[IP_PACKET_SIZE];
+
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    const uint16_t seq_num = static_cast<uint16_t>(i);
+    WriteRtpHeader(seq_num, 3000, packet);
+    history.PutRTPPacket(packet, packet_length, IP_PACKET_SIZE, 0,
+                         kAllowRetransmission);
+    if (i < lookup_distance)
+      continue;
+    const uint16_t resend_seq_num = seq_num - lookup_distance;
+    if (borrow) {
+      RTPPacketHistory::BorrowedPacket borrowed;
+      if (history.BorrowPacketAndSetSendTime(resend_seq_num, 0, true,
+                                             &borrowed)) {
+        ++g_sink;
+      }
+    } else {
+      uint16_t length = sizeof(resend_buffer);
+      int64_t stored_time_ms;
+      if (history.GetPacketAndSetSendTime(resend_seq_num, 0, true,
+                                          resend_buffer, &length,
+                                          &stored_time_ms)) {
+        g_sink += length;
+      }
+    }
+  }
+  const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+
+  char trace[64];
+  snprintf(trace, sizeof(trace), "%d_stored_%s", history_length,
+           borrow ? "borrow" : "copy");
+  PrintResult("rtp_packet_history", trace, elapsed_us, FLAGS_iterations);
+}
+
+// Builds a compound packet of receiver reports holding |num_report_blocks|
+// report blocks in total.
+void BuildReceiverReports(int num_report_blocks,
+                          std::vector<rtcp::ReportBlock>* report_blocks,
+                          uint8_t* buffer,
+                          size_t* length) {
+  const int kBlocksPerReport = 31;
+  const int kMaxReports = 7;
+  rtcp::ReceiverReport reports[kMaxReports];
+  for (int i = 0; i < num_report_blocks; ++i) {
+    rtcp::ReceiverReport* report = &reports[i / kBlocksPerReport];
+    if (i % kBlocksPerReport == 0) {
+      report->From(kSsrc);
+      if (report != &reports[0])
+        reports[0].Append(report);
+    }
+    report->WithReportBlock(&(*report_blocks)[i]);
+  }
+  reports[0].Build(buffer, length, kRtcpBufferLength);
+}
+
+std::vector<rtcp::ReportBlock> CreateReportBlocks(int num_report_blocks) {
+  std::vector<rtcp::ReportBlock> report_blocks(num_report_blocks);
+  for (int i = 0; i < num_report_blocks; ++i) {
+    report_blocks[i].To(kRemoteSsrc + i);
+    report_blocks[i].WithFractionLost(i);
+    report_blocks[i].WithCumulativeLost(10 * i);
+    report_blocks[i].WithExtHighestSeqNum(20000 + i);
+    report_blocks[i].WithJitter(30 + i);
+    report_blocks[i].WithLastSr(0x11223344);
+    report_blocks[i].WithDelayLastSr(0x1000);
+  }
+  return report_blocks;
+}
+
+void BenchmarkBuildRtcp(int num_report_blocks) {
+  std::vector<rtcp::ReportBlock> report_blocks =
+      CreateReportBlocks(num_report_blocks);
+  uint8_t buffer[kRtcpBufferLength];
+
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    size_t length = 0;
+    BuildReceiverReports(num_report_blocks, &report_blocks, buffer, &length);
+    g_sink += length;
+  }
+  const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+
+  char trace[64];
+  snprintf(trace, sizeof(trace), "%d_report_blocks", num_report_blocks);
+  PrintResult("rtcp_build_rr", trace, elapsed_us, FLAGS_iterations);
+}
+
+void BenchmarkParseRtcp(int num_report_blocks) {
+  std::vector<rtcp::ReportBlock> report_blocks =
+      CreateReportBlocks(num_report_blocks);
+  uint8_t buffer[kRtcpBufferLength];
+  size_t length = 0;
+  BuildReceiverReports(num_report_blocks, &report_blocks, buffer, &length);
+
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    RTCPUtility::RTCPParserV2 parser(buffer, length, true);
+    RTCPUtility::RTCPPacketTypes type = parser.Begin();
+    while (type != RTCPUtility::kRtcpNotValidCode) {
+      if (type == RTCPUtility::kRtcpReportBlockItemCode)
+        g_sink += parser.Packet().ReportBlockItem.SSRC;
+      type = parser.Iterate();
+    }
+  }
+  const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+
+  char trace[64];
+  snprintf(trace, sizeof(trace), "%d_report_blocks", num_report_blocks);
+  PrintResult("rtcp_parse_rr", trace, elapsed_us, FLAGS_iterations);
+}
+
+// Builds NACKs for |num_missing| sequence numbers, every second one lost so
+// that the bitmasks are half full.
+void BenchmarkBuildNack(int num_missing) {
+  std::vector<uint16_t> nack_list(num_missing);
+  for (int i = 0; i < num_missing; ++i)
+    nack_list[i] = static_cast<uint16_t>(65000 + 2 * i);
+  uint8_t buffer[kRtcpBufferLength];
+
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    rtcp::Nack nack;
+    nack.From(kSsrc);
+    nack.To(kRemoteSsrc);
+    nack.WithList(&nack_list[0], num_missing);
+    size_t length = 0;
+    nack.Build(buffer, &length, sizeof(buffer));
+    g_sink += length;
+  }
+  const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+
+  char trace[64];
+  snprintf(trace, sizeof(trace), "%d_missing", num_missing);
+  PrintResult("rtcp_build_nack", trace, elapsed_us, FLAGS_iterations);
+}
+
+// Computes the bounding set of |num_candidates| TMMBR requests with spread out
+// bitrates and overheads, the way the receiver does for each received TMMBR.
+// Counts the candidates.
+void BenchmarkTmmbrBoundingSet(int num_candidates) {
+  TMMBRHelp tmmbr_help;
+
+  const TickTime start = TickTime::Now();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    TMMBRSet* candidates =
+        tmmbr_help.VerifyAndAllocateCandidateSet(num_candidates);
+    for (int j = 0; j < num_candidates; ++j) {
+      candidates->AddEntry(100 + (j * 7919) % 5000, 20 + (j * 104729) % 500,
+                           kRemoteSsrc + j);
+    }
+    TMMBRSet* bounding_set = NULL;
+    g_sink += tmmbr_help.FindTMMBRBoundingSet(bounding_set);
+  }
+  const int64_t elapsed_us = (TickTime::Now() - start).Microseconds();
+
+  char trace[64];
+  snprintf(trace, sizeof(trace), "%d_candidates", num_candidates);
+  PrintResult("tmmbr_bounding_set", trace, elapsed_us,
+              static_cast<int64_t>(FLAGS_iterations) * num_candidates);
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  google::SetUsageMessage(
+      "Measures the per packet cost of RTP packetization, FEC, RTP header "
+      "parsing, the packet history, RTCP and TMMBR.\n"
+      "Usage: rtp_rtcp_benchmarks [--iterations=N]");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  const int kFrameLengths[] = {1000, 10000, 100000};
+  for (size_t i = 0; i < sizeof(kFrameLengths) / sizeof(*kFrameLengths); ++i) {
+    webrtc::BenchmarkPacketizeVp8(kFrameLengths[i], false);
+    webrtc::BenchmarkPacketizeVp8(kFrameLengths[i], true);
+  }
+
+  const int kNumMediaPackets[] = {4, 12, 48};
+  const uint8_t kProtectionFactors[] = {26, 128, 255};
+  const webrtc::FecMaskType kMaskTypes[] = {webrtc::kFecMaskRandom,
+                                            webrtc::kFecMaskBursty};
+  for (size_t i = 0; i < sizeof(kNumMediaPackets) / sizeof(int); ++i) {
+    for (size_t j = 0; j < sizeof(kProtectionFactors); ++j) {
+      for (size_t k = 0; k < sizeof(kMaskTypes) / sizeof(*kMaskTypes); ++k) {
+        webrtc::FecBenchmark fec(kNumMediaPackets[i], kProtectionFactors[j],
+                                 kMaskTypes[k]);
+        fec.BenchmarkEncode();
+        fec.BenchmarkDecode();
+      }
+    }
+  }
+
+  webrtc::BenchmarkParseRtpHeader(false);
+  webrtc::BenchmarkParseRtpHeader(true);
+
+  webrtc::BenchmarkPacketHistory(600, false);
+  webrtc::BenchmarkPacketHistory(600, true);
+
+  const int kNumReportBlocks[] = {1, 10, 31, 100, 200};
+  for (size_t i = 0; i < sizeof(kNumReportBlocks) / sizeof(int); ++i) {
+    webrtc::BenchmarkBuildRtcp(kNumReportBlocks[i]);
+    webrtc::BenchmarkParseRtcp(kNumReportBlocks[i]);
+  }
+
+  const int kNumMissing[] = {1, 10, 100, 500};
+  for (size_t i = 0; i < sizeof(kNumMissing) / sizeof(int); ++i)
+    webrtc::BenchmarkBuildNack(kNumMissing[i]);
+
+  const int kNumTmmbrCandidates[] = {10, 100, 1000};
+  for (size_t i = 0; i < sizeof(kNumTmmbrCandidates) / sizeof(int); ++i)
+    webrtc::BenchmarkTmmbrBoundingSet(kNumTmmbrCandidates[i]);
+  return 0;
+}
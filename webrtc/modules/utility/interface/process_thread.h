@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_UTILITY_INTERFACE_PROCESS_THREAD_H_
 #define WEBRTC_MODULES_UTILITY_INTERFACE_PROCESS_THREAD_H_
 
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -19,7 +20,26 @@ class Module;
 class ProcessThread
 {
 public:
+    // Process() timing of a registered module.
+    struct ModuleStats
+    {
+        ModuleStats()
+            : process_count(0),
+              total_process_time_us(0),
+              max_process_time_us(0) {}
+        int64_t process_count;
+        int64_t total_process_time_us;
+        int64_t max_process_time_us;
+    };
+
     static ProcessThread* CreateProcessThread();
+    // Creates a process thread which spreads the registered modules across
+    // |num_workers| threads.
+    static ProcessThread* CreateProcessThread(int num_workers);
+    // Creates a process thread whose workers are scheduled as |role|, see
+    // ThreadWrapper::SetRoleConfig().
+    static ProcessThread* CreateProcessThread(int num_workers,
+                                              ThreadRole role);
     static void DestroyProcessThread(ProcessThread* module);
 
     virtual int32_t Start() = 0;
@@ -27,6 +47,22 @@ public:
 
     virtual int32_t RegisterModule(Module* module) = 0;
     virtual int32_t DeRegisterModule(const Module* module) = 0;
+
+    // Registers |module| like RegisterModule(), but modules registered with
+    // the same |affinity|, e.g. all modules of one channel, are always
+    // processed on the same thread.
+    virtual int32_t RegisterModuleWithAffinity(Module* module, int affinity)
+    {
+        return RegisterModule(module);
+    }
+
+    // Returns the Process() timing of |module| in |stats|. Returns -1 if
+    // |module| isn't registered or stats aren't collected.
+    virtual int32_t GetModuleStats(const Module* module,
+                                   ModuleStats* stats) const
+    {
+        return -1;
+    }
 protected:
     virtual ~ProcessThread();
 };
@@ -8,164 +8,332 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include "webrtc/modules/interface/module.h"
 #include "webrtc/modules/utility/source/process_thread_impl.h"
 
+#include <assert.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "webrtc/modules/interface/module.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 namespace webrtc {
-ProcessThread::~ProcessThread()
-{
+namespace {
+// Longest time a module goes without having TimeUntilNextProcess() queried.
+// This bounds the delay for modules whose deadline moves earlier between
+// calls, e.g. due to incoming packets.
+const int64_t kMaxWaitMs = 100;
+// The next pass time while none is posted.
+const int64_t kNoPassMs = std::numeric_limits<int64_t>::max();
+}  // namespace
+
+ProcessThread::~ProcessThread() {}
+
+ProcessThread* ProcessThread::CreateProcessThread() {
+  return new ProcessThreadImpl(1, kUnspecifiedThreadRole);
 }
 
-ProcessThread* ProcessThread::CreateProcessThread()
-{
-    return new ProcessThreadImpl();
+ProcessThread* ProcessThread::CreateProcessThread(int num_workers) {
+  return new ProcessThreadImpl(num_workers, kUnspecifiedThreadRole);
 }
 
-void ProcessThread::DestroyProcessThread(ProcessThread* module)
-{
-    delete module;
+ProcessThread* ProcessThread::CreateProcessThread(int num_workers,
+                                                  ThreadRole role) {
+  return new ProcessThreadImpl(num_workers, role);
 }
 
-ProcessThreadImpl::ProcessThreadImpl()
-    : _timeEvent(*EventWrapper::Create()),
-      _critSectModules(CriticalSectionWrapper::CreateCriticalSection()),
-      _thread(NULL)
-{
+void ProcessThread::DestroyProcessThread(ProcessThread* module) {
+  delete module;
 }
 
-ProcessThreadImpl::~ProcessThreadImpl()
-{
-    delete _critSectModules;
-    delete &_timeEvent;
+class ProcessThreadImpl::Worker::ProcessTask : public QueuedTask {
+ public:
+  explicit ProcessTask(Worker* worker) : worker_(worker) {}
+
+  virtual void Run() OVERRIDE { worker_->Process(); }
+
+ private:
+  Worker* const worker_;
+};
+
+ProcessThreadImpl::Worker::Worker(int index, ThreadRole role)
+    : index_(index),
+      role_(role),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      module_done_(ConditionVariableWrapper::CreateConditionVariable()),
+      next_pass_ms_(kNoPassMs),
+      thread_id_(0),
+      processing_(NULL) {}
+
+ProcessThreadImpl::Worker::~Worker() {
+  assert(!pool_);
 }
 
-int32_t ProcessThreadImpl::Start()
-{
-    CriticalSectionScoped lock(_critSectModules);
-    if(_thread)
-    {
-        return -1;
-    }
-    _thread = ThreadWrapper::CreateThread(Run, this, kNormalPriority,
-                                          "ProcessThread");
-    unsigned int id;
-    int32_t retVal = _thread->Start(id);
-    if(retVal >= 0)
-    {
-        return 0;
-    }
-    delete _thread;
-    _thread = NULL;
+int32_t ProcessThreadImpl::Worker::Start() {
+  CriticalSectionScoped lock(crit_.get());
+  if (pool_)
+    return -1;
+  char name[32];
+  if (index_ == 0) {
+    snprintf(name, sizeof(name), "ProcessThread");
+  } else {
+    snprintf(name, sizeof(name), "ProcessThread%d", index_);
+  }
+  pool_.reset(ThreadPool::Create(name, 1, kNormalPriority, role_));
+  if (!pool_)
     return -1;
+  next_pass_ms_ = kNoPassMs;
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  SchedulePass(now_ms, now_ms);
+  return 0;
 }
 
-int32_t ProcessThreadImpl::Stop()
-{
-    _critSectModules->Enter();
-    if(_thread)
-    {
-        _thread->SetNotAlive();
+int32_t ProcessThreadImpl::Worker::Stop() {
+  ThreadPool* pool = NULL;
+  {
+    CriticalSectionScoped lock(crit_.get());
+    pool = pool_.release();
+  }
+  // Deleted without |crit_| held, as it waits for a running pass. The passes
+  // that have not run are dropped.
+  delete pool;
+  return 0;
+}
 
-        ThreadWrapper* thread = _thread;
-        _thread = NULL;
+bool ProcessThreadImpl::Worker::HasModule(const Module* module) const {
+  CriticalSectionScoped lock(crit_.get());
+  return modules_.find(module) != modules_.end();
+}
 
-        _timeEvent.Set();
-        _critSectModules->Leave();
+void ProcessThreadImpl::Worker::AddModule(Module* module) {
+  CriticalSectionScoped lock(crit_.get());
+  ModuleEntry& entry = modules_[module];
+  entry.module = module;
+  // Queried for its first deadline by the thread, without |crit_| held.
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  Schedule(&entry, now_ms, 0);
+  // The deadline of the just registered module may be earlier than all
+  // others.
+  SchedulePass(now_ms, now_ms);
+}
 
-        if(thread->Stop())
-        {
-            delete thread;
-        } else {
-            return -1;
-        }
-    } else {
-        _critSectModules->Leave();
-    }
-    return 0;
+bool ProcessThreadImpl::Worker::RemoveModule(const Module* module) {
+  CriticalSectionScoped lock(crit_.get());
+  // Stale heap entries are skipped when they reach the top.
+  if (modules_.erase(module) == 0)
+    return false;
+  // Once this returns the module is no longer called, unless it deregisters
+  // itself from its own Process().
+  while (processing_ == module && thread_id_ != ThreadWrapper::GetThreadId())
+    module_done_->SleepCS(*crit_);
+  return true;
 }
 
-int32_t ProcessThreadImpl::RegisterModule(Module* module)
-{
-    CriticalSectionScoped lock(_critSectModules);
+size_t ProcessThreadImpl::Worker::num_modules() const {
+  CriticalSectionScoped lock(crit_.get());
+  return modules_.size();
+}
 
-    // Only allow module to be registered once.
-    for (ModuleList::iterator iter = _modules.begin();
-         iter != _modules.end(); ++iter) {
-        if(module == *iter)
-        {
-            return -1;
-        }
-    }
+bool ProcessThreadImpl::Worker::GetModuleStats(const Module* module,
+                                               ModuleStats* stats) const {
+  CriticalSectionScoped lock(crit_.get());
+  ModuleMap::const_iterator it = modules_.find(module);
+  if (it == modules_.end())
+    return false;
+  *stats = it->second.stats;
+  return true;
+}
 
-    _modules.push_front(module);
-
-    // Wake the thread calling ProcessThreadImpl::Process() to update the
-    // waiting time. The waiting time for the just registered module may be
-    // shorter than all other registered modules.
-    _timeEvent.Set();
-    return 0;
-}
-
-int32_t ProcessThreadImpl::DeRegisterModule(const Module* module)
-{
-    CriticalSectionScoped lock(_critSectModules);
-    for (ModuleList::iterator iter = _modules.begin();
-         iter != _modules.end(); ++iter) {
-        if(module == *iter)
-        {
-            _modules.erase(iter);
-            return 0;
-        }
+void ProcessThreadImpl::Worker::Process() {
+  std::vector<Module*> due_modules;
+  {
+    CriticalSectionScoped lock(crit_.get());
+    if (!pool_)
+      return;
+    thread_id_ = ThreadWrapper::GetThreadId();
+    // Collect the modules which are due, so that each module is processed at
+    // most once per pass even if it is due again immediately.
+    const int64_t now_ms = TickTime::MillisecondTimestamp();
+    // Passes posted for a later time, which have been overtaken by an earlier
+    // one, find nothing new and leave |next_pass_ms_| alone.
+    if (next_pass_ms_ <= now_ms)
+      next_pass_ms_ = kNoPassMs;
+    while (!deadlines_.empty()) {
+      const Deadline& deadline = deadlines_.front();
+      ModuleMap::iterator it = modules_.find(deadline.module);
+      if (it != modules_.end() &&
+          it->second.generation == deadline.generation) {
+        if (deadline.time_ms > now_ms)
+          break;
+        due_modules.push_back(it->second.module);
+      }
+      std::pop_heap(deadlines_.begin(), deadlines_.end(), LaterDeadline());
+      deadlines_.pop_back();
     }
-    return -1;
+  }
+  for (size_t i = 0; i < due_modules.size(); ++i)
+    ProcessModule(due_modules[i]);
+
+  CriticalSectionScoped lock(crit_.get());
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  const int64_t run_at_ms =
+      deadlines_.empty() ? now_ms + kMaxWaitMs : deadlines_.front().time_ms;
+  SchedulePass(now_ms, run_at_ms);
 }
 
-bool ProcessThreadImpl::Run(void* obj)
-{
-    return static_cast<ProcessThreadImpl*>(obj)->Process();
-}
-
-bool ProcessThreadImpl::Process()
-{
-    // Wait for the module that should be called next, but don't block thread
-    // longer than 100 ms.
-    int32_t minTimeToNext = 100;
-    {
-        CriticalSectionScoped lock(_critSectModules);
-        for (ModuleList::iterator iter = _modules.begin();
-             iter != _modules.end(); ++iter) {
-          int32_t timeToNext = (*iter)->TimeUntilNextProcess();
-            if(minTimeToNext > timeToNext)
-            {
-                minTimeToNext = timeToNext;
-            }
-        }
-    }
+void ProcessThreadImpl::Worker::SchedulePass(int64_t now_ms,
+                                             int64_t run_at_ms) {
+  // Stopped; Start() schedules the first pass.
+  if (!pool_)
+    return;
+  run_at_ms = std::max(run_at_ms, now_ms);
+  if (run_at_ms >= next_pass_ms_)
+    return;
+  next_pass_ms_ = run_at_ms;
+  if (run_at_ms == now_ms) {
+    pool_->PostTask(new ProcessTask(this));
+  } else {
+    pool_->PostDelayedTask(new ProcessTask(this),
+                           static_cast<uint32_t>(run_at_ms - now_ms));
+  }
+}
+
+void ProcessThreadImpl::Worker::ProcessModule(Module* module) {
+  {
+    CriticalSectionScoped lock(crit_.get());
+    // A module processed earlier in this pass may have deregistered it.
+    if (modules_.find(module) == modules_.end())
+      return;
+    // Marked, so that DeRegisterModule() waits for the module to return.
+    processing_ = module;
+  }
+  // Called without |crit_| held, so that modules can register and deregister
+  // modules, and the other threads aren't blocked while they run.
+  int64_t time_until_next_ms = module->TimeUntilNextProcess();
+  int64_t elapsed_us = -1;
+  if (time_until_next_ms < 1) {
+    const int64_t start_us = TickTime::MicrosecondTimestamp();
+    module->Process();
+    elapsed_us = TickTime::MicrosecondTimestamp() - start_us;
+    time_until_next_ms = module->TimeUntilNextProcess();
+  }
 
-    if(minTimeToNext > 0)
-    {
-        if(kEventError == _timeEvent.Wait(minTimeToNext))
-        {
-            return true;
-        }
-        CriticalSectionScoped lock(_critSectModules);
-        if(!_thread)
-        {
-            return false;
-        }
+  CriticalSectionScoped lock(crit_.get());
+  processing_ = NULL;
+  module_done_->WakeAll();
+  // The module may have been deregistered meanwhile.
+  ModuleMap::iterator it = modules_.find(module);
+  if (it == modules_.end())
+    return;
+  if (elapsed_us >= 0) {
+    ModuleStats* stats = &it->second.stats;
+    ++stats->process_count;
+    stats->total_process_time_us += elapsed_us;
+    stats->max_process_time_us =
+        std::max(stats->max_process_time_us, elapsed_us);
+  }
+  Schedule(&it->second, TickTime::MillisecondTimestamp(), time_until_next_ms);
+}
+
+void ProcessThreadImpl::Worker::Schedule(ModuleEntry* entry,
+                                         int64_t now_ms,
+                                         int64_t time_until_next_ms) {
+  time_until_next_ms = std::max<int64_t>(0, std::min(time_until_next_ms,
+                                                     kMaxWaitMs));
+  ++entry->generation;
+  deadlines_.push_back(Deadline(now_ms + time_until_next_ms, entry->module,
+                                entry->generation));
+  std::push_heap(deadlines_.begin(), deadlines_.end(), LaterDeadline());
+}
+
+ProcessThreadImpl::ProcessThreadImpl(int num_workers, ThreadRole role) {
+  assert(num_workers > 0);
+  for (int i = 0; i < std::max(1, num_workers); ++i)
+    workers_.push_back(new Worker(i, role));
+}
+
+ProcessThreadImpl::~ProcessThreadImpl() {
+  Stop();
+  for (size_t i = 0; i < workers_.size(); ++i)
+    delete workers_[i];
+}
+
+int32_t ProcessThreadImpl::Start() {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->Start() != 0) {
+      for (size_t j = 0; j < i; ++j)
+        workers_[j]->Stop();
+      return -1;
     }
-    {
-        CriticalSectionScoped lock(_critSectModules);
-        for (ModuleList::iterator iter = _modules.begin();
-             iter != _modules.end(); ++iter) {
-          int32_t timeToNext = (*iter)->TimeUntilNextProcess();
-            if(timeToNext < 1)
-            {
-                (*iter)->Process();
-            }
-        }
+  }
+  return 0;
+}
+
+int32_t ProcessThreadImpl::Stop() {
+  int32_t ret = 0;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->Stop() != 0)
+      ret = -1;
+  }
+  return ret;
+}
+
+int32_t ProcessThreadImpl::RegisterModule(Module* module) {
+  return RegisterModuleOnWorker(module, LeastLoadedWorker());
+}
+
+int32_t ProcessThreadImpl::RegisterModuleWithAffinity(Module* module,
+                                                      int affinity) {
+  return RegisterModuleOnWorker(module, WorkerForAffinity(affinity));
+}
+
+int32_t ProcessThreadImpl::DeRegisterModule(const Module* module) {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->RemoveModule(module))
+      return 0;
+  }
+  return -1;
+}
+
+int32_t ProcessThreadImpl::GetModuleStats(const Module* module,
+                                          ModuleStats* stats) const {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->GetModuleStats(module, stats))
+      return 0;
+  }
+  return -1;
+}
+
+ProcessThreadImpl::Worker* ProcessThreadImpl::WorkerForAffinity(
+    int affinity) const {
+  unsigned int index = static_cast<unsigned int>(affinity) % workers_.size();
+  return workers_[index];
+}
+
+ProcessThreadImpl::Worker* ProcessThreadImpl::LeastLoadedWorker() const {
+  Worker* least_loaded = workers_[0];
+  size_t min_modules = least_loaded->num_modules();
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    size_t num_modules = workers_[i]->num_modules();
+    if (num_modules < min_modules) {
+      least_loaded = workers_[i];
+      min_modules = num_modules;
     }
-    return true;
+  }
+  return least_loaded;
 }
+
+int32_t ProcessThreadImpl::RegisterModuleOnWorker(Module* module,
+                                                  Worker* worker) {
+  // Only allow module to be registered once.
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->HasModule(module))
+      return -1;
+  }
+  worker->AddModule(module);
+  return 0;
+}
+
 }  // namespace webrtc
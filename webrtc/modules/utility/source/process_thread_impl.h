@@ -11,39 +11,115 @@
 #ifndef WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 #define WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 
-#include <list>
+#include <map>
+#include <vector>
 
 #include "webrtc/modules/utility/interface/process_thread.h"
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
-#include "webrtc/system_wrappers/interface/event_wrapper.h"
-#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_annotations.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
-class ProcessThreadImpl : public ProcessThread
-{
-public:
-    ProcessThreadImpl();
-    virtual ~ProcessThreadImpl();
 
-    virtual int32_t Start();
-    virtual int32_t Stop();
+// Runs the registered modules on a pool of worker threads. Each module is
+// owned by one worker, which keeps its modules in a heap ordered by their next
+// deadline and runs a pass as a delayed task at the earliest one, instead of
+// polling every module. Each worker has a ThreadPool of one thread, so that a
+// module is always processed on the same thread.
+class ProcessThreadImpl : public ProcessThread {
+ public:
+  ProcessThreadImpl(int num_workers, ThreadRole role);
+  virtual ~ProcessThreadImpl();
 
-    virtual int32_t RegisterModule(Module* module);
-    virtual int32_t DeRegisterModule(const Module* module);
+  virtual int32_t Start() OVERRIDE;
+  virtual int32_t Stop() OVERRIDE;
 
-protected:
-    static bool Run(void* obj);
+  virtual int32_t RegisterModule(Module* module) OVERRIDE;
+  virtual int32_t DeRegisterModule(const Module* module) OVERRIDE;
+  virtual int32_t RegisterModuleWithAffinity(Module* module,
+                                             int affinity) OVERRIDE;
+  virtual int32_t GetModuleStats(const Module* module,
+                                 ModuleStats* stats) const OVERRIDE;
 
-    bool Process();
+ private:
+  class Worker {
+   public:
+    Worker(int index, ThreadRole role);
+    ~Worker();
 
-private:
-    typedef std::list<Module*> ModuleList;
-    EventWrapper&           _timeEvent;
-    CriticalSectionWrapper* _critSectModules;
-    ModuleList              _modules;
-    ThreadWrapper*          _thread;
+    int32_t Start();
+    int32_t Stop();
+
+    bool HasModule(const Module* module) const;
+    void AddModule(Module* module);
+    bool RemoveModule(const Module* module);
+    size_t num_modules() const;
+    bool GetModuleStats(const Module* module, ModuleStats* stats) const;
+
+   private:
+    struct ModuleEntry {
+      ModuleEntry() : module(NULL), generation(0) {}
+      Module* module;
+      // Incremented whenever the module is rescheduled, invalidating any
+      // older entry in the heap.
+      uint32_t generation;
+      ModuleStats stats;
+    };
+    struct Deadline {
+      Deadline(int64_t time_ms, const Module* module, uint32_t generation)
+          : time_ms(time_ms), module(module), generation(generation) {}
+      int64_t time_ms;
+      const Module* module;
+      uint32_t generation;
+    };
+    // Orders the heap so that the earliest deadline is at the top.
+    struct LaterDeadline {
+      bool operator()(const Deadline& a, const Deadline& b) const {
+        return a.time_ms > b.time_ms;
+      }
+    };
+    typedef std::map<const Module*, ModuleEntry> ModuleMap;
+
+    class ProcessTask;
+
+    // Processes the modules that are due, and schedules the next pass.
+    void Process();
+    // Posts a pass at |run_at_ms| unless an earlier one is posted already.
+    void SchedulePass(int64_t now_ms, int64_t run_at_ms)
+        EXCLUSIVE_LOCKS_REQUIRED(crit_);
+    // Processes |module| if it is still registered and due.
+    void ProcessModule(Module* module);
+
+    // Pushes the next deadline of |entry| onto the heap.
+    void Schedule(ModuleEntry* entry, int64_t now_ms,
+                  int64_t time_until_next_ms) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+    const int index_;
+    const ThreadRole role_;
+    scoped_ptr<CriticalSectionWrapper> crit_;
+    ModuleMap modules_ GUARDED_BY(crit_);
+    std::vector<Deadline> deadlines_ GUARDED_BY(crit_);
+    // Signaled when the module being processed returns.
+    scoped_ptr<ConditionVariableWrapper> module_done_;
+    // Set while the worker is started.
+    scoped_ptr<ThreadPool> pool_ GUARDED_BY(crit_);
+    // The earliest pass that is posted, if any.
+    int64_t next_pass_ms_ GUARDED_BY(crit_);
+    uint32_t thread_id_ GUARDED_BY(crit_);
+    // The module being called by the thread, or NULL.
+    const Module* processing_ GUARDED_BY(crit_);
+  };
+
+  Worker* WorkerForAffinity(int affinity) const;
+  Worker* LeastLoadedWorker() const;
+  int32_t RegisterModuleOnWorker(Module* module, Worker* worker);
+
+  std::vector<Worker*> workers_;
 };
+
 }  // namespace webrtc
 
-#endif // WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
+#endif  // WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
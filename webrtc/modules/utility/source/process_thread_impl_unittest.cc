@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/interface/module.h"
+#include "webrtc/modules/utility/source/process_thread_impl.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+
+// Module which wants to be processed every |interval_ms| and signals an event
+// after |signal_after| calls to Process().
+class FakeModule : public Module {
+ public:
+  FakeModule(int interval_ms, int signal_after)
+      : interval_ms_(interval_ms),
+        signal_after_(signal_after),
+        process_count_(0),
+        next_process_ms_(0),
+        done_(EventWrapper::Create()),
+        crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        thread_id_(0) {}
+
+  virtual int32_t TimeUntilNextProcess() OVERRIDE {
+    CriticalSectionScoped lock(crit_.get());
+    return static_cast<int32_t>(
+        next_process_ms_ - TickTime::MillisecondTimestamp());
+  }
+
+  virtual int32_t Process() OVERRIDE {
+    CriticalSectionScoped lock(crit_.get());
+    next_process_ms_ = TickTime::MillisecondTimestamp() + interval_ms_;
+    thread_id_ = ThreadWrapper::GetThreadId();
+    if (++process_count_ == signal_after_)
+      done_->Set();
+    return 0;
+  }
+
+  bool WaitForDone() { return done_->Wait(2000) == kEventSignaled; }
+
+  uint32_t thread_id() const {
+    CriticalSectionScoped lock(crit_.get());
+    return thread_id_;
+  }
+
+ private:
+  const int interval_ms_;
+  const int signal_after_;
+  int process_count_;
+  int64_t next_process_ms_;
+  scoped_ptr<EventWrapper> done_;
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  uint32_t thread_id_;
+};
+
+// Module which takes a while in Process(), and may deregister itself there.
+class SlowModule : public Module {
+ public:
+  SlowModule(ProcessThread* process_thread, bool deregister_itself)
+      : process_thread_(process_thread),
+        deregister_itself_(deregister_itself),
+        started_(EventWrapper::Create()),
+        returned_(0) {}
+
+  virtual int32_t TimeUntilNextProcess() OVERRIDE { return 0; }
+
+  virtual int32_t Process() OVERRIDE {
+    started_->Set();
+    if (deregister_itself_) {
+      EXPECT_EQ(0, process_thread_->DeRegisterModule(this));
+    }
+    scoped_ptr<EventWrapper> never_set(EventWrapper::Create());
+    never_set->Wait(50);
+    ++returned_;
+    return 0;
+  }
+
+  bool WaitForStarted() { return started_->Wait(2000) == kEventSignaled; }
+
+  int returned() { return returned_.Value(); }
+
+ private:
+  ProcessThread* const process_thread_;
+  const bool deregister_itself_;
+  scoped_ptr<EventWrapper> started_;
+  Atomic32 returned_;
+};
+
+TEST(ProcessThreadImplTest, ProcessesRegisteredModule) {
+  ProcessThreadImpl process_thread(1, kUnspecifiedThreadRole);
+  FakeModule module(5, 3);
+  EXPECT_EQ(0, process_thread.RegisterModule(&module));
+  EXPECT_EQ(-1, process_thread.RegisterModule(&module));
+  EXPECT_EQ(0, process_thread.Start());
+  EXPECT_TRUE(module.WaitForDone());
+  EXPECT_EQ(0, process_thread.Stop());
+
+  ProcessThread::ModuleStats stats;
+  EXPECT_EQ(0, process_thread.GetModuleStats(&module, &stats));
+  EXPECT_GE(stats.process_count, 3);
+  EXPECT_GE(stats.total_process_time_us, stats.max_process_time_us);
+
+  EXPECT_EQ(0, process_thread.DeRegisterModule(&module));
+  EXPECT_EQ(-1, process_thread.DeRegisterModule(&module));
+  EXPECT_EQ(-1, process_thread.GetModuleStats(&module, &stats));
+}
+
+TEST(ProcessThreadImplTest, ProcessesModulesAgainAfterRestart) {
+  ProcessThreadImpl process_thread(1, kUnspecifiedThreadRole);
+  FakeModule module(5, 3);
+  EXPECT_EQ(0, process_thread.RegisterModule(&module));
+  EXPECT_EQ(0, process_thread.Start());
+  EXPECT_EQ(-1, process_thread.Start());
+  EXPECT_EQ(0, process_thread.Stop());
+  EXPECT_EQ(0, process_thread.Stop());
+
+  // Registered while stopped.
+  FakeModule other_module(5, 3);
+  EXPECT_EQ(0, process_thread.RegisterModule(&other_module));
+  EXPECT_EQ(0, process_thread.Start());
+  EXPECT_TRUE(module.WaitForDone());
+  EXPECT_TRUE(other_module.WaitForDone());
+  EXPECT_EQ(0, process_thread.Stop());
+}
+
+TEST(ProcessThreadImplTest, SpreadsModulesAcrossWorkers) {
+  ProcessThreadImpl process_thread(2, kUnspecifiedThreadRole);
+  FakeModule module1(5, 2);
+  FakeModule module2(5, 2);
+  FakeModule module3(5, 2);
+  EXPECT_EQ(0, process_thread.RegisterModule(&module1));
+  EXPECT_EQ(0, process_thread.RegisterModule(&module2));
+  // |module4| is registered with the same affinity below.
+  EXPECT_EQ(0, process_thread.RegisterModuleWithAffinity(&module3, 7));
+  EXPECT_EQ(0, process_thread.Start());
+  EXPECT_TRUE(module1.WaitForDone());
+  EXPECT_TRUE(module2.WaitForDone());
+  EXPECT_TRUE(module3.WaitForDone());
+  EXPECT_NE(module1.thread_id(), module2.thread_id());
+
+  FakeModule module4(5, 2);
+  EXPECT_EQ(0, process_thread.RegisterModuleWithAffinity(&module4, 7));
+  EXPECT_TRUE(module4.WaitForDone());
+  EXPECT_EQ(module3.thread_id(), module4.thread_id());
+  EXPECT_EQ(0, process_thread.Stop());
+}
+
+TEST(ProcessThreadImplTest, DeRegisterWaitsForProcess) {
+  ProcessThreadImpl process_thread(1, kUnspecifiedThreadRole);
+  SlowModule module(&process_thread, false);
+  EXPECT_EQ(0, process_thread.RegisterModule(&module));
+  EXPECT_EQ(0, process_thread.Start());
+  ASSERT_TRUE(module.WaitForStarted());
+  EXPECT_EQ(0, process_thread.DeRegisterModule(&module));
+  const int returned = module.returned();
+  EXPECT_GE(returned, 1);
+  // Not called again once deregistered.
+  scoped_ptr<EventWrapper> never_set(EventWrapper::Create());
+  never_set->Wait(100);
+  EXPECT_EQ(returned, module.returned());
+  EXPECT_EQ(0, process_thread.Stop());
+}
+
+TEST(ProcessThreadImplTest, ModuleDeRegistersItself) {
+  ProcessThreadImpl process_thread(1, kUnspecifiedThreadRole);
+  SlowModule module(&process_thread, true);
+  FakeModule other_module(5, 3);
+  EXPECT_EQ(0, process_thread.RegisterModule(&module));
+  EXPECT_EQ(0, process_thread.RegisterModule(&other_module));
+  EXPECT_EQ(0, process_thread.Start());
+  ASSERT_TRUE(module.WaitForStarted());
+  EXPECT_TRUE(other_module.WaitForDone());
+  EXPECT_EQ(1, module.returned());
+  EXPECT_EQ(-1, process_thread.DeRegisterModule(&module));
+  EXPECT_EQ(0, process_thread.Stop());
+}
+
+}  // namespace webrtc
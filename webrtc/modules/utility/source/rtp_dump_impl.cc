@@ -68,7 +68,7 @@ void RtpDump::DestroyRtpDump(RtpDump* object)
 
 RtpDumpImpl::RtpDumpImpl()
     : _critSect(CriticalSectionWrapper::CreateCriticalSection()),
-      _file(*FileWrapper::Create()),
+      _file(*FileWrapper::CreateAsync()),
       _startTime(0)
 {
 }
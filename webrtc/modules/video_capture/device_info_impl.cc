@@ -198,6 +198,7 @@ int32_t DeviceInfoImpl::GetBestMatchedCapability(
                                     && requested.rawType != kVideoUnknown
                                     && (capability.rawType == requested.rawType
                                         || capability.rawType == kVideoI420
+                                        || capability.rawType == kVideoNV12
                                         || capability.rawType == kVideoYUY2
                                         || capability.rawType == kVideoYV12))
                                 {
@@ -257,10 +257,11 @@ int32_t DeviceInfoLinux::FillCapabilities(int fd)
     video_fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     video_fmt.fmt.pix.sizeimage = 0;
 
-    int totalFmts = 3;
+    int totalFmts = 4;
     unsigned int videoFormats[] = {
         V4L2_PIX_FMT_MJPEG,
         V4L2_PIX_FMT_YUV420,
+        V4L2_PIX_FMT_NV12,
         V4L2_PIX_FMT_YUYV };
 
     int sizes = 13;
@@ -296,6 +297,10 @@ int32_t DeviceInfoLinux::FillCapabilities(int fd)
                     {
                         cap.rawType = kVideoI420;
                     }
+                    else if (videoFormats[fmts] == V4L2_PIX_FMT_NV12)
+                    {
+                        cap.rawType = kVideoNV12;
+                    }
                     else if (videoFormats[fmts] == V4L2_PIX_FMT_MJPEG)
                     {
                         cap.rawType = kVideoMJPEG;
@@ -22,7 +22,9 @@
 #include <new>
 
 #include "webrtc/modules/video_capture/linux/video_capture_linux.h"
+#include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/ref_count.h"
 #include "webrtc/system_wrappers/interface/thread_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
@@ -50,6 +52,12 @@ VideoCaptureModuleV4L2::VideoCaptureModuleV4L2(const int32_t id)
     : VideoCaptureImpl(id), 
       _captureThread(NULL),
       _captureCritSect(CriticalSectionWrapper::CreateCriticalSection()),
+      _decodeThread(NULL),
+      _decodeCritSect(CriticalSectionWrapper::CreateCriticalSection()),
+      _decodeEvent(EventWrapper::Create()),
+      _pendingBufferIndex(-1),
+      _pendingBytesUsed(0),
+      _pendingCaptureTime(0),
       _deviceId(-1), 
       _deviceFd(-1),
       _buffersAllocatedByDevice(-1),
@@ -117,6 +125,8 @@ VideoCaptureModuleV4L2::~VideoCaptureModuleV4L2()
     {
         delete _captureCritSect;
     }
+    delete _decodeCritSect;
+    delete _decodeEvent;
     if (_deviceFd != -1)
       close(_deviceFd);
 }
@@ -152,19 +162,22 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
 
     // Supported video formats in preferred order.
     // If the requested resolution is larger than VGA, we prefer MJPEG. Go for
-    // I420 otherwise.
-    const int nFormats = 4;
+    // I420 otherwise. NV12 is preferred over YUY2 since it converts to I420
+    // by copying the luma as it is.
+    const int nFormats = 5;
     unsigned int fmts[nFormats];
     if (capability.width > 640 || capability.height > 480) {
         fmts[0] = V4L2_PIX_FMT_MJPEG;
         fmts[1] = V4L2_PIX_FMT_YUV420;
-        fmts[2] = V4L2_PIX_FMT_YUYV;
-        fmts[3] = V4L2_PIX_FMT_JPEG;
+        fmts[2] = V4L2_PIX_FMT_NV12;
+        fmts[3] = V4L2_PIX_FMT_YUYV;
+        fmts[4] = V4L2_PIX_FMT_JPEG;
     } else {
         fmts[0] = V4L2_PIX_FMT_YUV420;
-        fmts[1] = V4L2_PIX_FMT_YUYV;
-        fmts[2] = V4L2_PIX_FMT_MJPEG;
-        fmts[3] = V4L2_PIX_FMT_JPEG;
+        fmts[1] = V4L2_PIX_FMT_NV12;
+        fmts[2] = V4L2_PIX_FMT_YUYV;
+        fmts[3] = V4L2_PIX_FMT_MJPEG;
+        fmts[4] = V4L2_PIX_FMT_JPEG;
     }
 
     // Enumerate image formats.
@@ -214,6 +227,8 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
         _captureVideoType = kVideoYUY2;
     else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_YUV420)
         _captureVideoType = kVideoI420;
+    else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_NV12)
+        _captureVideoType = kVideoNV12;
     else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_MJPEG ||
              video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_JPEG)
         _captureVideoType = kVideoMJPEG;
@@ -275,6 +290,13 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
         return -1;
     }
 
+    if (_captureVideoType == kVideoMJPEG && !StartDecodeThread())
+    {
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
+                   "failed to start the MJPEG decode thread");
+        return -1;
+    }
+
     //start capture thread;
     if (!_captureThread)
     {
@@ -314,6 +336,8 @@ int32_t VideoCaptureModuleV4L2::StopCapture()
             assert(false);
         }
     }
+    // The decode thread holds capture buffers until it is stopped.
+    StopDecodeThread();
 
     CriticalSectionScoped cs(_captureCritSect);
     if (_captureStarted)
@@ -388,6 +412,22 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
     return true;
 }
 
+bool VideoCaptureModuleV4L2::EnqueueBuffer(uint32_t index)
+{
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(struct v4l2_buffer));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1)
+    {
+        WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture, _id,
+                   "Failed to enqueue capture buffer");
+        return false;
+    }
+    return true;
+}
+
 bool VideoCaptureModuleV4L2::DeAllocateVideoBuffers()
 {
     // unmap buffers
@@ -467,6 +507,17 @@ bool VideoCaptureModuleV4L2::CaptureProcess()
                 return true;
             }
         }
+        if (_decodeThread)
+        {
+            // The frame is stamped now, so that the time spent waiting for
+            // the decode thread does not count as capture delay.
+            const int64_t captureTime =
+                Clock::GetRealTimeClock()->CurrentNtpInMilliseconds();
+            QueueForDecode(buf.index, buf.bytesused, captureTime);
+            _captureCritSect->Leave();
+            usleep(0);
+            return true;
+        }
         VideoCaptureCapability frameInfo;
         frameInfo.width = _currentWidth;
         frameInfo.height = _currentHeight;
@@ -476,17 +527,104 @@ bool VideoCaptureModuleV4L2::CaptureProcess()
         IncomingFrame((unsigned char*) _pool[buf.index].start,
                       buf.bytesused, frameInfo);
         // enqueue the buffer again
-        if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1)
-        {
-            WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture, _id,
-                       "Failed to enqueue capture buffer");
-        }
+        EnqueueBuffer(buf.index);
     }
     _captureCritSect->Leave();
     usleep(0);
     return true;
 }
 
+bool VideoCaptureModuleV4L2::StartDecodeThread()
+{
+    _pendingBufferIndex = -1;
+    _decodeThread = ThreadWrapper::CreateThread(
+        VideoCaptureModuleV4L2::DecodeThread, this, kHighPriority,
+        "V4L2DecodeThread");
+    unsigned int id;
+    if (!_decodeThread || !_decodeThread->Start(id))
+    {
+        delete _decodeThread;
+        _decodeThread = NULL;
+        return false;
+    }
+    return true;
+}
+
+void VideoCaptureModuleV4L2::StopDecodeThread()
+{
+    if (!_decodeThread)
+        return;
+    _decodeThread->SetNotAlive();
+    _decodeEvent->Set();
+    if (_decodeThread->Stop())
+    {
+        delete _decodeThread;
+        _decodeThread = NULL;
+    }
+    else
+    {
+        // Couldn't stop the thread, leak instead of crash.
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, -1,
+                     "%s: could not stop decode thread", __FUNCTION__);
+        assert(false);
+    }
+    // A pending buffer is released along with the others by the caller.
+    CriticalSectionScoped cs(_decodeCritSect);
+    _pendingBufferIndex = -1;
+}
+
+void VideoCaptureModuleV4L2::QueueForDecode(uint32_t index,
+                                            uint32_t bytesUsed,
+                                            int64_t captureTime)
+{
+    int32_t droppedIndex;
+    {
+        CriticalSectionScoped cs(_decodeCritSect);
+        droppedIndex = _pendingBufferIndex;
+        _pendingBufferIndex = index;
+        _pendingBytesUsed = bytesUsed;
+        _pendingCaptureTime = captureTime;
+    }
+    // The decode thread has not got to the previous frame yet, so give its
+    // buffer back to the device rather than wait.
+    if (droppedIndex >= 0)
+        EnqueueBuffer(droppedIndex);
+    _decodeEvent->Set();
+}
+
+bool VideoCaptureModuleV4L2::DecodeThread(void* obj)
+{
+    return static_cast<VideoCaptureModuleV4L2*> (obj)->DecodeProcess();
+}
+
+bool VideoCaptureModuleV4L2::DecodeProcess()
+{
+    _decodeEvent->Wait(100);
+
+    uint32_t index;
+    uint32_t bytesUsed;
+    int64_t captureTime;
+    {
+        CriticalSectionScoped cs(_decodeCritSect);
+        if (_pendingBufferIndex < 0)
+            return true;
+        index = _pendingBufferIndex;
+        bytesUsed = _pendingBytesUsed;
+        captureTime = _pendingCaptureTime;
+        _pendingBufferIndex = -1;
+    }
+
+    VideoCaptureCapability frameInfo;
+    frameInfo.width = _currentWidth;
+    frameInfo.height = _currentHeight;
+    frameInfo.rawType = _captureVideoType;
+
+    IncomingFrame((unsigned char*) _pool[index].start, bytesUsed, frameInfo,
+                  captureTime);
+    EnqueueBuffer(index);
+    return true;
+}
+
 int32_t VideoCaptureModuleV4L2::CaptureSettings(VideoCaptureCapability& settings)
 {
     settings.width = _currentWidth;
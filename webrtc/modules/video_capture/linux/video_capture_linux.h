@@ -17,6 +17,7 @@
 namespace webrtc
 {
 class CriticalSectionWrapper;
+class EventWrapper;
 class ThreadWrapper;
 namespace videocapturemodule
 {
@@ -38,10 +39,31 @@ private:
     bool CaptureProcess();
     bool AllocateVideoBuffers();
     bool DeAllocateVideoBuffers();
+    bool EnqueueBuffer(uint32_t index);
+
+    // MJPEG frames are decoded on their own thread, so that the decoding of
+    // large frames does not hold up the dequeuing of the next ones. The
+    // capture thread hands over the dequeued buffer, and the decode thread
+    // puts it back in the queue once the frame is delivered.
+    static bool DecodeThread(void*);
+    bool DecodeProcess();
+    bool StartDecodeThread();
+    void StopDecodeThread();
+    void QueueForDecode(uint32_t index, uint32_t bytesUsed,
+                        int64_t captureTime);
 
     ThreadWrapper* _captureThread;
     CriticalSectionWrapper* _captureCritSect;
 
+    ThreadWrapper* _decodeThread;
+    CriticalSectionWrapper* _decodeCritSect;
+    EventWrapper* _decodeEvent;
+    // The buffer waiting for the decode thread, or -1. Only the latest frame
+    // is kept when the decoding falls behind.
+    int32_t _pendingBufferIndex;
+    uint32_t _pendingBytesUsed;
+    int64_t _pendingCaptureTime;
+
     int32_t _deviceId;
     int32_t _deviceFd;
 
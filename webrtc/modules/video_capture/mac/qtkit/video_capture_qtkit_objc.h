@@ -44,6 +44,8 @@
   int _captureDeviceCount;
   char _captureDeviceNameUTF8[1024];
   char _captureDeviceNameUniqueID[1024];
+  // Holds the frames whose rows are padded, packed for IncomingFrame().
+  NSMutableData* _packedFrame;
 }
 
 - (void)getCaptureDevices;
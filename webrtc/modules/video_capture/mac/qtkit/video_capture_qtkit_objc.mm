@@ -46,6 +46,7 @@ using namespace videocapturemodule;
   [_captureDecompressedVideoOutput release];
   [_captureSession release];
   [_captureDevices release];
+  [_packedFrame release];
 
   [super dealloc];
 }
@@ -130,7 +131,7 @@ using namespace videocapturemodule;
           (id)kCVPixelBufferWidthKey,
           [NSNumber numberWithDouble:_frameHeight],
           (id)kCVPixelBufferHeightKey,
-          [NSNumber numberWithUnsignedInt:kCVPixelFormatType_32ARGB],
+          [NSNumber numberWithUnsignedInt:kCVPixelFormatType_422YpCbCr8],
           (id)kCVPixelBufferPixelFormatTypeKey,
           nil];
   [_captureDecompressedVideoOutput
@@ -200,7 +201,7 @@ using namespace videocapturemodule;
           (id)kCVPixelBufferWidthKey,
           [NSNumber numberWithDouble:_frameHeight],
           (id)kCVPixelBufferHeightKey,
-          [NSNumber numberWithUnsignedInt:kCVPixelFormatType_32ARGB],
+          [NSNumber numberWithUnsignedInt:kCVPixelFormatType_422YpCbCr8],
           (id)kCVPixelBufferPixelFormatTypeKey,
           nil];
 
@@ -235,19 +236,35 @@ using namespace videocapturemodule;
 
   const int kFlags = 0;
   if (CVPixelBufferLockBaseAddress(videoFrame, kFlags) == kCVReturnSuccess) {
-    void *baseAddress = CVPixelBufferGetBaseAddress(videoFrame);
+    uint8_t* baseAddress =
+        static_cast<uint8_t*>(CVPixelBufferGetBaseAddress(videoFrame));
     size_t bytesPerRow = CVPixelBufferGetBytesPerRow(videoFrame);
+    int frameWidth = CVPixelBufferGetWidth(videoFrame);
     int frameHeight = CVPixelBufferGetHeight(videoFrame);
-    int frameSize = bytesPerRow * frameHeight;
+    // The buffer holds the UYVY of the camera itself, which saves QTKit the
+    // conversion to RGB and the module the conversion back. Rows padded by
+    // the driver are packed, since IncomingFrame() expects none.
+    size_t packedBytesPerRow = 2 * frameWidth;
+    int frameSize = packedBytesPerRow * frameHeight;
+    if (bytesPerRow != packedBytesPerRow) {
+      if (!_packedFrame)
+        _packedFrame = [[NSMutableData alloc] init];
+      [_packedFrame setLength:frameSize];
+      uint8_t* packed = static_cast<uint8_t*>([_packedFrame mutableBytes]);
+      for (int row = 0; row < frameHeight; ++row) {
+        memcpy(packed + row * packedBytesPerRow,
+               baseAddress + row * bytesPerRow, packedBytesPerRow);
+      }
+      baseAddress = packed;
+    }
 
     VideoCaptureCapability tempCaptureCapability;
-    tempCaptureCapability.width = _frameWidth;
-    tempCaptureCapability.height = _frameHeight;
+    tempCaptureCapability.width = frameWidth;
+    tempCaptureCapability.height = frameHeight;
     tempCaptureCapability.maxFPS = _frameRate;
-    // TODO(wu) : Update actual type and not hard-coded value.
-    tempCaptureCapability.rawType = kVideoBGRA;
+    tempCaptureCapability.rawType = kVideoUYVY;
 
-    _owner->IncomingFrame((unsigned char*)baseAddress, frameSize,
+    _owner->IncomingFrame(baseAddress, frameSize,
                           tempCaptureCapability, 0);
     CVPixelBufferUnlockBaseAddress(videoFrame, kFlags);
   }
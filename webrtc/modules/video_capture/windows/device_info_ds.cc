@@ -608,6 +608,10 @@ int32_t DeviceInfoDS::CreateCapabilityMap(
             {
                 capability.rawType = kVideoI420;
             }
+            else if (pmt->subtype == MEDIASUBTYPE_NV12)
+            {
+                capability.rawType = kVideoNV12;
+            }
             else if (pmt->subtype == MEDIASUBTYPE_IYUV)
             {
                 capability.rawType = kVideoIYUV;
@@ -106,6 +106,19 @@ CaptureInputPin::GetMediaType (IN int iPosition, OUT CMediaType * pmt)
         }
         break;
         case 1:
+        {
+            // Native to many cameras, and converted to I420 without touching
+            // the luma in place of a color converter filter in the graph.
+            pvi->bmiHeader.biCompression = MAKEFOURCC('N','V','1','2');
+            pvi->bmiHeader.biBitCount = 12; //bit per pixel
+            pvi->bmiHeader.biWidth = _requestedCapability.width;
+            pvi->bmiHeader.biHeight = _requestedCapability.height;
+            pvi->bmiHeader.biSizeImage = 3*_requestedCapability.height
+                                        *_requestedCapability.width/2;
+            pmt->SetSubtype(&MEDIASUBTYPE_NV12);
+        }
+        break;
+        case 2:
         {
             pvi->bmiHeader.biCompression = MAKEFOURCC('Y','U','Y','2');;
             pvi->bmiHeader.biBitCount = 16; //bit per pixel
@@ -116,7 +129,7 @@ CaptureInputPin::GetMediaType (IN int iPosition, OUT CMediaType * pmt)
             pmt->SetSubtype(&MEDIASUBTYPE_YUY2);
         }
         break;
-        case 2:
+        case 3:
         {
             pvi->bmiHeader.biCompression = BI_RGB;
             pvi->bmiHeader.biBitCount = 24; //bit per pixel
@@ -127,7 +140,7 @@ CaptureInputPin::GetMediaType (IN int iPosition, OUT CMediaType * pmt)
             pmt->SetSubtype(&MEDIASUBTYPE_RGB24);
         }
         break;
-        case 3:
+        case 4:
         {
             pvi->bmiHeader.biCompression = MAKEFOURCC('U','Y','V','Y');
             pvi->bmiHeader.biBitCount = 16; //bit per pixel
@@ -138,7 +151,7 @@ CaptureInputPin::GetMediaType (IN int iPosition, OUT CMediaType * pmt)
             pmt->SetSubtype(&MEDIASUBTYPE_UYVY);
         }
         break;
-        case 4:
+        case 5:
         {
             pvi->bmiHeader.biCompression = MAKEFOURCC('M','J','P','G');
             pvi->bmiHeader.biBitCount = 12; //bit per pixel
@@ -219,6 +232,12 @@ CaptureInputPin::CheckMediaType ( IN const CMediaType * pMediaType)
             _resultingCapability.rawType = kVideoI420;
             return S_OK; // This format is acceptable.
         }
+        if(*SubType == MEDIASUBTYPE_NV12
+            && pvi->bmiHeader.biCompression == MAKEFOURCC('N','V','1','2'))
+        {
+            _resultingCapability.rawType = kVideoNV12;
+            return S_OK; // This format is acceptable.
+        }
         if(*SubType == MEDIASUBTYPE_YUY2
             && pvi->bmiHeader.biCompression == MAKEFOURCC('Y','U','Y','2'))
         {
@@ -286,6 +305,12 @@ CaptureInputPin::CheckMediaType ( IN const CMediaType * pMediaType)
             _resultingCapability.rawType = kVideoI420;
             return S_OK; // This format is acceptable.
         }
+        if(*SubType == MEDIASUBTYPE_NV12
+            && pvi->bmiHeader.biCompression == MAKEFOURCC('N','V','1','2'))
+        {
+            _resultingCapability.rawType = kVideoNV12;
+            return S_OK; // This format is acceptable.
+        }
         if(*SubType == MEDIASUBTYPE_YUY2
             && pvi->bmiHeader.biCompression == MAKEFOURCC('Y','U','Y','2'))
         {
@@ -44,6 +44,7 @@ class MockVideoEncoder : public VideoEncoder {
   MOCK_METHOD1(SetPeriodicKeyFrames, int32_t(bool enable));
   MOCK_METHOD2(CodecConfigParameters,
                int32_t(uint8_t* /*buffer*/, int32_t));
+  MOCK_CONST_METHOD0(SupportsNativeHandle, bool());
 };
 
 class MockDecodedImageCallback : public DecodedImageCallback {
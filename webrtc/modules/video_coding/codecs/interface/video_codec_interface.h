@@ -33,6 +33,9 @@ struct CodecSpecificInfoVP8 {
   uint8_t pictureIdSLI;
   bool hasReceivedRPSI;
   uint64_t pictureIdRPSI;
+  // A picture loss or key frame request from the receiver, which in feedback
+  // mode is recovered from the established reference when possible.
+  bool hasReceivedPLI;
   int16_t pictureId;  // Negative value to skip pictureId.
   bool nonReference;
   uint8_t simulcastIdx;
@@ -161,6 +164,11 @@ public:
     //
     // Return value                : WEBRTC_VIDEO_CODEC_OK if OK, < 0 otherwise.
     virtual int32_t CodecConfigParameters(uint8_t* /*buffer*/, int32_t /*size*/) { return WEBRTC_VIDEO_CODEC_ERROR; }
+
+    // Returns true if the encoder can encode frames that only carry a native
+    // handle, e.g. a texture, without their I420 buffers being read. Frames
+    // with a native handle are never given to other encoders.
+    virtual bool SupportsNativeHandle() const { return false; }
 };
 
 class DecodedImageCallback
@@ -0,0 +1,182 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+#
+# Use of this source code is governed by a BSD-style license
+# that can be found in the LICENSE file in the root of the source
+# tree. An additional intellectual property rights grant can be found
+# in the file PATENTS.  All contributing project authors may
+# be found in the AUTHORS file in the root of the source tree.
+
+
+"""Script to find regressions between two runs of the video codec tests.
+
+videoprocessor_integrationtest writes <test name>_codec_stats.json to its
+output directory for each test. Given the files of a baseline build and of a
+new build, this script compares the per-frame encode and decode times and
+PSNR of each test with Welch's t-test, and the summary values that have a
+single sample (e.g. the bit rate mismatch) by their relative change.
+
+A change is reported as a regression when it is for the worse, larger than
+--min_change percent and, for per-frame values, statistically significant at
+the --significance level. The script returns 1 if any regression is found.
+
+Example:
+  compare_codec_stats.py baseline_out/ new_out/
+"""
+
+import glob
+import json
+import math
+import optparse
+import os
+import sys
+
+
+# Per-frame values, and whether a higher value is better.
+_FRAME_METRICS = [
+    ('encode_ms', False),
+    ('decode_ms', False),
+    ('psnr', True),
+]
+
+# Summary values with no per-frame samples, and whether higher is better.
+_SUMMARY_METRICS = [
+    ('key_frame_bytes', False),
+    ('max_rate_mismatch_percent', False),
+    ('min_psnr', True),
+    ('ssim', True),
+    ('min_ssim', True),
+    ('dropped_frames', False),
+]
+
+
+def _ParseArgs():
+  """Registers the command-line options."""
+  usage = 'usage: %prog [options] baseline new'
+  parser = optparse.OptionParser(usage=usage)
+  parser.add_option('--significance', type='float', default=0.01,
+                    help=('Two-sided p-value below which a per-frame change '
+                          'is significant. Default: %default'))
+  parser.add_option('--min_change', type='float', default=2.0,
+                    help=('Smallest relative change, in percent, reported as '
+                          'a regression. Default: %default'))
+  options, args = parser.parse_args()
+  if len(args) != 2:
+    parser.error('Expected the baseline and the new results.')
+  return options, args[0], args[1]
+
+
+def _LoadResults(path):
+  """Returns the results in |path|, a file or a directory, by test name."""
+  if os.path.isdir(path):
+    file_names = glob.glob(os.path.join(path, '*_codec_stats.json'))
+  else:
+    file_names = [path]
+  results = {}
+  for file_name in file_names:
+    with open(file_name) as result_file:
+      result = json.load(result_file)
+    results[result['test']] = result
+  return results
+
+
+def _MeanAndVariance(values):
+  mean = sum(values) / float(len(values))
+  if len(values) < 2:
+    return mean, 0.0
+  variance = sum((x - mean) ** 2 for x in values) / (len(values) - 1)
+  return mean, variance
+
+
+def _WelchPValue(baseline, new):
+  """Returns the two-sided p-value of Welch's t-test for equal means.
+
+  The t distribution is approximated by the normal distribution, which is
+  close enough for the hundreds of frames of the codec tests.
+  """
+  if len(baseline) < 2 or len(new) < 2:
+    return 1.0
+  baseline_mean, baseline_variance = _MeanAndVariance(baseline)
+  new_mean, new_variance = _MeanAndVariance(new)
+  error = math.sqrt(baseline_variance / len(baseline) +
+                    new_variance / len(new))
+  if error == 0:
+    return 1.0 if new_mean == baseline_mean else 0.0
+  t = (new_mean - baseline_mean) / error
+  return math.erfc(abs(t) / math.sqrt(2))
+
+
+def _RelativeChange(baseline, new):
+  if baseline == 0:
+    return 0.0 if new == 0 else float('inf')
+  return 100.0 * (new - baseline) / abs(baseline)
+
+
+def _IsWorse(change, higher_is_better):
+  return change < 0 if higher_is_better else change > 0
+
+
+def _CompareTest(baseline, new, options):
+  """Prints the changes of one test and returns its regressed metrics."""
+  regressions = []
+  rows = []
+  for metric, higher_is_better in _FRAME_METRICS:
+    baseline_values = baseline['frames'].get(metric, [])
+    new_values = new['frames'].get(metric, [])
+    if not baseline_values or not new_values:
+      continue
+    baseline_mean = _MeanAndVariance(baseline_values)[0]
+    new_mean = _MeanAndVariance(new_values)[0]
+    change = _RelativeChange(baseline_mean, new_mean)
+    p_value = _WelchPValue(baseline_values, new_values)
+    regressed = (_IsWorse(change, higher_is_better) and
+                 abs(change) > options.min_change and
+                 p_value < options.significance)
+    rows.append((metric, baseline_mean, new_mean, change,
+                 '%.4f' % p_value, regressed))
+  for metric, higher_is_better in _SUMMARY_METRICS:
+    if metric not in baseline['summary'] or metric not in new['summary']:
+      continue
+    baseline_value = baseline['summary'][metric]
+    new_value = new['summary'][metric]
+    change = _RelativeChange(baseline_value, new_value)
+    regressed = (_IsWorse(change, higher_is_better) and
+                 abs(change) > options.min_change)
+    rows.append((metric, baseline_value, new_value, change, '-', regressed))
+
+  for metric, baseline_value, new_value, change, p_value, regressed in rows:
+    sys.stdout.write('  %-26s %10.3f %10.3f %+8.2f%% %8s%s\n' % (
+        metric, baseline_value, new_value, change, p_value,
+        '  REGRESSION' if regressed else ''))
+    if regressed:
+      regressions.append(metric)
+  return regressions
+
+
+def main():
+  options, baseline_path, new_path = _ParseArgs()
+  baseline_results = _LoadResults(baseline_path)
+  new_results = _LoadResults(new_path)
+
+  regressions = []
+  for test in sorted(baseline_results):
+    if test not in new_results:
+      sys.stdout.write('%s: missing in the new results\n' % test)
+      continue
+    sys.stdout.write('%s:\n  %-26s %10s %10s %9s %8s\n' % (
+        test, 'metric', 'baseline', 'new', 'change', 'p-value'))
+    regressions += ['%s.%s' % (test, metric) for metric in
+                    _CompareTest(baseline_results[test], new_results[test],
+                                 options)]
+
+  if regressions:
+    sys.stdout.write('REGRESSIONS (%d):\n' % len(regressions))
+    for regression in regressions:
+      sys.stdout.write('  %s\n' % regression)
+    return 1
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
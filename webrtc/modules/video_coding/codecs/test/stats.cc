@@ -183,5 +183,75 @@ void Stats::PrintSummary() {
          (total_encoding_time_in_us + total_decoding_time_in_us) / 1000);
 }
 
+namespace {
+
+// Writes |values| as a JSON array.
+void WriteJsonArray(FILE* file, const std::vector<double>& values) {
+  fprintf(file, "[");
+  for (size_t i = 0; i < values.size(); ++i)
+    fprintf(file, "%s%.3f", i > 0 ? ", " : "", values[i]);
+  fprintf(file, "]");
+}
+
+double Average(const std::vector<double>& values) {
+  if (values.empty())
+    return 0;
+  double sum = 0;
+  for (size_t i = 0; i < values.size(); ++i)
+    sum += values[i];
+  return sum / values.size();
+}
+
+}  // namespace
+
+bool Stats::WriteJson(FILE* file,
+                      const std::string& test_name,
+                      const std::vector<double>& frame_psnr,
+                      const std::map<std::string, double>& summary) const {
+  std::vector<double> encode_ms;
+  std::vector<double> decode_ms;
+  std::vector<double> frame_bytes;
+  std::vector<double> key_frame_bytes;
+  for (std::vector<FrameStatistic>::const_iterator it = stats_.begin();
+       it != stats_.end(); ++it) {
+    encode_ms.push_back(it->encode_time_in_us / 1000.0);
+    // Frames lost to packet loss have no decode time.
+    if (it->decoding_successful)
+      decode_ms.push_back(it->decode_time_in_us / 1000.0);
+    frame_bytes.push_back(it->encoded_frame_length_in_bytes);
+    if (it->frame_type == kKeyFrame)
+      key_frame_bytes.push_back(it->encoded_frame_length_in_bytes);
+  }
+
+  std::map<std::string, double> averages(summary);
+  averages["encode_ms"] = Average(encode_ms);
+  averages["decode_ms"] = Average(decode_ms);
+  averages["frame_bytes"] = Average(frame_bytes);
+  averages["key_frame_bytes"] = Average(key_frame_bytes);
+  averages["key_frames"] = static_cast<double>(key_frame_bytes.size());
+  if (!frame_psnr.empty())
+    averages["psnr"] = Average(frame_psnr);
+
+  fprintf(file, "{\n  \"test\": \"%s\",\n  \"summary\": {",
+          test_name.c_str());
+  for (std::map<std::string, double>::const_iterator it = averages.begin();
+       it != averages.end(); ++it) {
+    fprintf(file, "%s\n    \"%s\": %.3f", it == averages.begin() ? "" : ",",
+            it->first.c_str(), it->second);
+  }
+  fprintf(file, "\n  },\n  \"frames\": {\n    \"encode_ms\": ");
+  WriteJsonArray(file, encode_ms);
+  fprintf(file, ",\n    \"decode_ms\": ");
+  WriteJsonArray(file, decode_ms);
+  fprintf(file, ",\n    \"frame_bytes\": ");
+  WriteJsonArray(file, frame_bytes);
+  fprintf(file, ",\n    \"key_frame_bytes\": ");
+  WriteJsonArray(file, key_frame_bytes);
+  fprintf(file, ",\n    \"psnr\": ");
+  WriteJsonArray(file, frame_psnr);
+  fprintf(file, "\n  }\n}\n");
+  return ferror(file) == 0;
+}
+
 }  // namespace test
 }  // namespace webrtc
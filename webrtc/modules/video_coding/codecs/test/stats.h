@@ -11,6 +11,10 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_TEST_STATS_H_
 #define WEBRTC_MODULES_VIDEO_CODING_CODECS_TEST_STATS_H_
 
+#include <stdio.h>
+
+#include <map>
+#include <string>
 #include <vector>
 
 #include "webrtc/common_video/interface/video_image.h"
@@ -61,6 +65,16 @@ class Stats {
   // processing
   void PrintSummary();
 
+  // Writes the statistics of each frame and their averages to |file| as a
+  // JSON object, for tools that compare the results of different builds
+  // (see compare_codec_stats.py). |frame_psnr| holds the PSNR of each frame
+  // and |summary| extra values computed by the caller, such as the bit rate
+  // accuracy. Returns false if the file can't be written.
+  bool WriteJson(FILE* file,
+                 const std::string& test_name,
+                 const std::vector<double>& frame_psnr,
+                 const std::map<std::string, double>& summary) const;
+
   std::vector<FrameStatistic> stats_;
 };
 
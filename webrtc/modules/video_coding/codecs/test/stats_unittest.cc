@@ -10,6 +10,12 @@
 
 #include "webrtc/modules/video_coding/codecs/test/stats.h"
 
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/typedefs.h"
 
@@ -60,5 +66,44 @@ TEST_F(StatsTest, AddMany) {
   stats_->PrintSummary();  // should not crash
 }
 
+TEST_F(StatsTest, WriteJson) {
+  FrameStatistic& key_frame = stats_->NewFrame(0);
+  key_frame.frame_type = kKeyFrame;
+  key_frame.encode_time_in_us = 3000;
+  key_frame.decode_time_in_us = 1000;
+  key_frame.decoding_successful = true;
+  key_frame.encoded_frame_length_in_bytes = 4000;
+  FrameStatistic& delta_frame = stats_->NewFrame(1);
+  delta_frame.encode_time_in_us = 1000;
+  delta_frame.encoded_frame_length_in_bytes = 1000;
+
+  std::vector<double> frame_psnr;
+  frame_psnr.push_back(40.0);
+  frame_psnr.push_back(30.0);
+  std::map<std::string, double> summary;
+  summary["max_rate_mismatch_percent"] = 12.5;
+
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file != NULL);
+  EXPECT_TRUE(stats_->WriteJson(file, "Test", frame_psnr, summary));
+  std::string json(ftell(file), '\0');
+  rewind(file);
+  ASSERT_EQ(json.size(), fread(&json[0], 1, json.size(), file));
+  fclose(file);
+
+  EXPECT_NE(std::string::npos, json.find("\"test\": \"Test\""));
+  EXPECT_NE(std::string::npos, json.find("\"encode_ms\": 2.000"));
+  // Only the decoded frame counts.
+  EXPECT_NE(std::string::npos, json.find("\"decode_ms\": 1.000"));
+  EXPECT_NE(std::string::npos, json.find("\"key_frame_bytes\": 4000.000,"));
+  EXPECT_NE(std::string::npos, json.find("\"key_frames\": 1.000"));
+  EXPECT_NE(std::string::npos,
+            json.find("\"max_rate_mismatch_percent\": 12.500"));
+  EXPECT_NE(std::string::npos, json.find("\"psnr\": 35.000"));
+  EXPECT_NE(std::string::npos, json.find("\"psnr\": [40.000, 30.000]"));
+  EXPECT_NE(std::string::npos,
+            json.find("\"frame_bytes\": [4000.000, 1000.000]"));
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -54,7 +54,6 @@ VideoProcessorImpl::VideoProcessorImpl(webrtc::VideoEncoder* encoder,
       stats_(stats),
       encode_callback_(NULL),
       decode_callback_(NULL),
-      source_buffer_(NULL),
       first_key_frame_has_been_excluded_(false),
       last_frame_missing_(false),
       initialized_(false),
@@ -79,7 +78,6 @@ bool VideoProcessorImpl::Init() {
 
   // Initialize data structures used by the encoder/decoder APIs
   size_t frame_length_in_bytes = frame_reader_->FrameLength();
-  source_buffer_ = new uint8_t[frame_length_in_bytes];
   last_successful_frame_buffer_ = new uint8_t[frame_length_in_bytes];
   // Set fixed properties common for all frames.
   // To keep track of spatial resize actions by encoder.
@@ -137,7 +135,6 @@ bool VideoProcessorImpl::Init() {
 }
 
 VideoProcessorImpl::~VideoProcessorImpl() {
-  delete[] source_buffer_;
   delete[] last_successful_frame_buffer_;
   encoder_->RegisterEncodeCompleteCallback(NULL);
   delete encode_callback_;
@@ -179,15 +176,16 @@ bool VideoProcessorImpl::ProcessFrame(int frame_number) {
   if (frame_number == 0) {
     prev_time_stamp_ = -1;
   }
-  if (frame_reader_->ReadFrame(source_buffer_)) {
+  const uint8_t* source_buffer = frame_reader_->NextFrame();
+  if (source_buffer) {
     // Copy the source frame to the newly read frame data.
     int size_y = config_.codec_settings->width * config_.codec_settings->height;
     int half_width = (config_.codec_settings->width + 1) / 2;
     int half_height = (config_.codec_settings->height + 1) / 2;
     int size_uv = half_width * half_height;
-    source_frame_.CreateFrame(size_y, source_buffer_,
-                              size_uv, source_buffer_ + size_y,
-                              size_uv, source_buffer_ + size_y + size_uv,
+    source_frame_.CreateFrame(size_y, source_buffer,
+                              size_uv, source_buffer + size_y,
+                              size_uv, source_buffer + size_y + size_uv,
                               config_.codec_settings->width,
                               config_.codec_settings->height,
                               config_.codec_settings->width,
@@ -9,6 +9,12 @@
  */
 
 #include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -24,6 +30,7 @@
 #include "webrtc/test/testsupport/gtest_disable.h"
 #include "webrtc/test/testsupport/metrics/video_metrics.h"
 #include "webrtc/test/testsupport/packet_reader.h"
+#include "webrtc/test/testsupport/perf_test.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -35,6 +42,17 @@ const int kMaxNumRateUpdates = 3;
 const int kPercTargetvsActualMismatch = 20;
 const int kBaseKeyFrameInterval = 3000;
 
+void PrintPerfResult(const std::string& modifier,
+                     const std::string& trace,
+                     double value,
+                     const std::string& units,
+                     bool important) {
+  char value_string[32];
+  snprintf(value_string, sizeof(value_string), "%.3f", value);
+  webrtc::test::PrintResult("videoprocessor", modifier, trace, value_string,
+                            units, important);
+}
+
 // Codec and network settings.
 struct CodecConfigPars {
   float packet_loss;
@@ -143,6 +161,8 @@ class VideoProcessorIntegrationTest: public testing::Test {
   bool denoising_on_;
   bool frame_dropper_on_;
   bool spatial_resize_on_;
+  // Encoding rate mismatch in percent at the end of each rate update.
+  std::vector<float> encoding_rate_mismatches_;
 
 
   VideoProcessorIntegrationTest() {}
@@ -295,6 +315,7 @@ class VideoProcessorIntegrationTest: public testing::Test {
            " Number of spatial resizes = %d, \n",
            num_frames_to_hit_target_, num_dropped_frames, num_resize_actions);
     EXPECT_LE(perc_encoding_rate_mismatch_, max_encoding_rate_mismatch);
+    encoding_rate_mismatches_.push_back(perc_encoding_rate_mismatch_);
     if (num_key_frames_ > 0) {
       int perc_key_frame_size_mismatch = 100 * sum_key_frame_size_mismatch_ /
               num_key_frames_;
@@ -399,6 +420,41 @@ class VideoProcessorIntegrationTest: public testing::Test {
     delete encoder_;
   }
 
+  // Prints the main results for the perf dashboards and writes the statistics
+  // of each frame to <test name>_codec_stats.json in the output directory,
+  // for compare_codec_stats.py.
+  void WriteResults(const webrtc::test::QualityMetricsResult& psnr_result,
+                    const webrtc::test::QualityMetricsResult& ssim_result) {
+    const std::string test_name =
+        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::map<std::string, double> summary;
+    summary["min_psnr"] = psnr_result.min;
+    summary["ssim"] = ssim_result.average;
+    summary["min_ssim"] = ssim_result.min;
+    summary["dropped_frames"] = processor_->NumberDroppedFrames();
+    float max_rate_mismatch = 0;
+    for (size_t i = 0; i < encoding_rate_mismatches_.size(); ++i)
+      max_rate_mismatch = std::max(max_rate_mismatch,
+                                   encoding_rate_mismatches_[i]);
+    summary["max_rate_mismatch_percent"] = max_rate_mismatch;
+
+    std::vector<double> frame_psnr;
+    for (size_t i = 0; i < psnr_result.frames.size(); ++i)
+      frame_psnr.push_back(psnr_result.frames[i].value);
+
+    PrintPerfResult("_psnr", test_name, psnr_result.average, "dB", true);
+    PrintPerfResult("_ssim", test_name, ssim_result.average, "", false);
+    PrintPerfResult("_rate_mismatch", test_name, max_rate_mismatch, "%",
+                    false);
+
+    const std::string file_name =
+        webrtc::test::OutputPath() + test_name + "_codec_stats.json";
+    FILE* file = fopen(file_name.c_str(), "w");
+    ASSERT_TRUE(file != NULL) << "Cannot open " << file_name;
+    EXPECT_TRUE(stats_.WriteJson(file, test_name, frame_psnr, summary));
+    fclose(file);
+  }
+
   // Processes all frames in the clip and verifies the result.
   void ProcessFramesAndVerify(QualityMetrics quality_metrics,
                               RateProfile rate_profile,
@@ -493,6 +549,7 @@ class VideoProcessorIntegrationTest: public testing::Test {
            psnr_result.average, psnr_result.min,
            ssim_result.average, ssim_result.min);
     stats_.PrintSummary();
+    WriteResults(psnr_result, ssim_result);
     EXPECT_GT(psnr_result.average, quality_metrics.minimum_avg_psnr);
     EXPECT_GT(psnr_result.min, quality_metrics.minimum_min_psnr);
     EXPECT_GT(ssim_result.average, quality_metrics.minimum_avg_ssim);
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/codecs/vp8/cpu_speed_controller.h"
+
+namespace webrtc {
+
+namespace {
+// The fastest realtime speed of libvpx.
+const int kFastestSpeed = -16;
+// Speed up above, and slow down below, these shares of the frame interval.
+const float kHighUsage = 0.7f;
+const float kLowUsage = 0.35f;
+// Weight of the history when smoothing the usage.
+const float kUsageSmoothing = 0.9f;
+// Frames to wait after a change before the next one, to let the usage settle
+// on the new speed. Also keeps the expensive first key frame from counting
+// for much.
+const int kMinFramesBetweenChanges = 30;
+}  // namespace
+
+CpuSpeedController::CpuSpeedController()
+    : configured_speed_(0),
+      cpu_speed_(0),
+      usage_(0.0f),
+      frames_since_change_(0) {}
+
+void CpuSpeedController::Init(int configured_speed) {
+  configured_speed_ = configured_speed;
+  cpu_speed_ = configured_speed;
+  usage_ = 0.0f;
+  frames_since_change_ = 0;
+}
+
+bool CpuSpeedController::FrameEncoded(int64_t encode_time_us,
+                                      int frame_interval_ms) {
+  if (frame_interval_ms <= 0)
+    return false;
+  const float usage = encode_time_us / (1000.0f * frame_interval_ms);
+  usage_ = kUsageSmoothing * usage_ + (1.0f - kUsageSmoothing) * usage;
+  if (++frames_since_change_ < kMinFramesBetweenChanges)
+    return false;
+
+  int new_speed = cpu_speed_;
+  if (usage_ > kHighUsage && cpu_speed_ > kFastestSpeed) {
+    --new_speed;
+  } else if (usage_ < kLowUsage && cpu_speed_ < configured_speed_) {
+    ++new_speed;
+  }
+  if (new_speed == cpu_speed_)
+    return false;
+  cpu_speed_ = new_speed;
+  frames_since_change_ = 0;
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file defines a controller adapting the VP8 encoder speed setting
+ * (-cpu-used) to the time it takes to encode a frame.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_CPU_SPEED_CONTROLLER_H_
+#define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_CPU_SPEED_CONTROLLER_H_
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Makes the encoder faster, at the cost of compression efficiency, when
+// encoding takes a large share of the frame interval, and goes back towards
+// the configured speed when there is headroom again. In realtime mode a more
+// negative speed is faster.
+class CpuSpeedController {
+ public:
+  CpuSpeedController();
+
+  // Starts over from |configured_speed|, which is also the slowest speed the
+  // controller will use.
+  void Init(int configured_speed);
+
+  // Reports that a frame took |encode_time_us| to encode, with
+  // |frame_interval_ms| between frames. Returns true if cpu_speed() changed.
+  bool FrameEncoded(int64_t encode_time_us, int frame_interval_ms);
+
+  int cpu_speed() const { return cpu_speed_; }
+
+ private:
+  int configured_speed_;
+  int cpu_speed_;
+  // Smoothed share of the frame interval spent encoding.
+  float usage_;
+  int frames_since_change_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_CPU_SPEED_CONTROLLER_H_
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/codecs/vp8/cpu_speed_controller.h"
+
+namespace webrtc {
+
+static const int kConfiguredSpeed = -6;
+static const int kFastestSpeed = -16;
+static const int kFrameIntervalMs = 33;
+static const int kSlowEncodeUs = 30000;
+static const int kFastEncodeUs = 5000;
+
+// Encodes |num_frames| frames taking |encode_time_us| each.
+static void EncodeFrames(CpuSpeedController* controller,
+                         int64_t encode_time_us,
+                         int num_frames) {
+  for (int i = 0; i < num_frames; ++i)
+    controller->FrameEncoded(encode_time_us, kFrameIntervalMs);
+}
+
+TEST(CpuSpeedControllerTest, SpeedsUpWhenEncodingIsSlow) {
+  CpuSpeedController controller;
+  controller.Init(kConfiguredSpeed);
+  EncodeFrames(&controller, kSlowEncodeUs, 29);
+  EXPECT_EQ(kConfiguredSpeed, controller.cpu_speed());
+  EXPECT_TRUE(controller.FrameEncoded(kSlowEncodeUs, kFrameIntervalMs));
+  EXPECT_EQ(kConfiguredSpeed - 1, controller.cpu_speed());
+
+  EncodeFrames(&controller, kSlowEncodeUs, 1000);
+  EXPECT_EQ(kFastestSpeed, controller.cpu_speed());
+}
+
+TEST(CpuSpeedControllerTest, SlowsDownWithHeadroom) {
+  CpuSpeedController controller;
+  controller.Init(kConfiguredSpeed);
+  EncodeFrames(&controller, kSlowEncodeUs, 100);
+  EXPECT_LT(controller.cpu_speed(), kConfiguredSpeed);
+
+  EncodeFrames(&controller, kFastEncodeUs, 1000);
+  EXPECT_EQ(kConfiguredSpeed, controller.cpu_speed());
+
+  controller.Init(kConfiguredSpeed);
+  EncodeFrames(&controller, kSlowEncodeUs, 100);
+  controller.Init(kConfiguredSpeed);
+  EXPECT_EQ(kConfiguredSpeed, controller.cpu_speed());
+}
+
+TEST(CpuSpeedControllerTest, KeepsSpeedWithModerateUsage) {
+  CpuSpeedController controller;
+  controller.Init(kConfiguredSpeed);
+  EncodeFrames(&controller, kFrameIntervalMs * 1000 / 2, 1000);
+  EXPECT_EQ(kConfiguredSpeed, controller.cpu_speed());
+  EXPECT_FALSE(controller.FrameEncoded(kSlowEncodeUs, 0));
+}
+
+}  // namespace webrtc
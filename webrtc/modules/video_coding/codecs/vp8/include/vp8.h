@@ -17,9 +17,23 @@
 
 namespace webrtc {
 
+// Lets the VP8 encoder trade compression efficiency for speed at runtime when
+// encoding takes a large share of the frame interval. With it, the encoder
+// also emits one token partition per encoder thread. Set through
+// VideoCodec::extra_options.
+struct VP8SpeedAdaptation {
+  VP8SpeedAdaptation() : enabled(false) {}
+  explicit VP8SpeedAdaptation(bool enabled) : enabled(enabled) {}
+
+  bool enabled;
+};
+
 class VP8Encoder : public VideoEncoder {
  public:
   static VP8Encoder* Create();
+  // Creates an encoder producing every simulcast stream of the send codec,
+  // with the streams encoded in parallel.
+  static VP8Encoder* CreateSimulcast();
 
   virtual ~VP8Encoder() {};
 };  // end of VP8Encoder class
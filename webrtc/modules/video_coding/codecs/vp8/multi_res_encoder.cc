@@ -0,0 +1,479 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/codecs/vp8/multi_res_encoder.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "vpx/vpx_encoder.h"
+#include "vpx/vp8cx.h"
+
+#include "webrtc/common.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/modules/interface/module_common_types.h"
+#include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
+
+namespace webrtc {
+namespace {
+
+// Same thread split as a single stream encoder. The encoders of a
+// multi-resolution encoder run one after the other, so every encoder can use
+// all cores.
+int NumberOfEncoderThreads(int width, int height, int number_of_cores) {
+  if (width * height >= 1920 * 1080 && number_of_cores > 8) {
+    return 8;
+  } else if (width * height > 1280 * 960 && number_of_cores >= 6) {
+    return 3;
+  } else if (width * height > 640 * 480 && number_of_cores >= 3) {
+    return 2;
+  }
+  return 1;
+}
+
+int GreatestCommonDivisor(int a, int b) {
+  while (b != 0) {
+    const int c = a % b;
+    a = b;
+    b = c;
+  }
+  return a;
+}
+
+}  // namespace
+
+MultiResEncoder::Stream::Stream()
+    : temporal_layers(NULL),
+      picture_id(0),
+      bitrate_kbit(0) {
+  memset(&codec, 0, sizeof(codec));
+}
+
+MultiResEncoder::Stream::~Stream() {
+  delete temporal_layers;
+  delete [] encoded_image._buffer;
+}
+
+MultiResEncoder::MultiResEncoder()
+    : encoded_complete_callback_(NULL),
+      cpu_speed_(-6),
+      timestamp_(0),
+      inited_(false),
+      encoders_(NULL),
+      configs_(NULL),
+      raw_images_(NULL),
+      downsampling_factors_(NULL) {
+}
+
+MultiResEncoder::~MultiResEncoder() {
+  Release();
+}
+
+int MultiResEncoder::InitEncode(const VideoCodec* inst,
+                                int number_of_cores,
+                                uint32_t /*max_payload_size*/) {
+  if (inst == NULL || inst->numberOfSimulcastStreams < 1 ||
+      inst->numberOfSimulcastStreams > kMaxSimulcastStreams) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  if (inst->width < 1 || inst->height < 1 || inst->maxFramerate < 1 ||
+      number_of_cores < 1) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  for (int i = 0; i < inst->numberOfSimulcastStreams; ++i) {
+    const SimulcastStream& stream = inst->simulcastStream[i];
+    // Every stream is downscaled from the next larger one.
+    const SimulcastStream& larger = i + 1 < inst->numberOfSimulcastStreams ?
+        inst->simulcastStream[i + 1] : stream;
+    if (stream.width < 1 || stream.height < 1 ||
+        stream.width > larger.width || stream.height > larger.height) {
+      return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+    }
+  }
+  int ret_val = Release();
+  if (ret_val < 0) {
+    return ret_val;
+  }
+
+  Config default_options;
+  const Config& options =
+      inst->extra_options ? *inst->extra_options : default_options;
+  const int num_streams = inst->numberOfSimulcastStreams;
+  for (int i = 0; i < num_streams; ++i) {
+    const SimulcastStream& stream = inst->simulcastStream[i];
+    Stream* s = new Stream;
+    streams_.push_back(s);
+    s->codec = *inst;
+    s->codec.width = stream.width;
+    s->codec.height = stream.height;
+    s->codec.maxBitrate = stream.maxBitrate;
+    s->codec.minBitrate = stream.minBitrate;
+    s->codec.qpMax = stream.qpMax;
+    s->codec.codecSpecific.VP8.numberOfTemporalLayers =
+        stream.numberOfTemporalLayers;
+    s->codec.numberOfSimulcastStreams = 0;
+    memset(s->codec.simulcastStream, 0, sizeof(s->codec.simulcastStream));
+    const int num_temporal_layers = stream.numberOfTemporalLayers > 1 ?
+        stream.numberOfTemporalLayers : 1;
+    s->temporal_layers = options.Get<TemporalLayers::Factory>()
+                             .Create(num_temporal_layers, rand());
+    // random start 16 bits is enough.
+    s->picture_id = static_cast<uint16_t>(rand()) & 0x7FFF;
+    s->encoded_image._size = CalcBufferSize(kI420, stream.width,
+                                            stream.height);
+    s->encoded_image._buffer = new uint8_t[s->encoded_image._size];
+    s->encoded_image._completeFrame = true;
+  }
+
+  switch (inst->codecSpecific.VP8.complexity) {
+    case kComplexityHigh:
+      cpu_speed_ = -5;
+      break;
+    case kComplexityHigher:
+      cpu_speed_ = -4;
+      break;
+    case kComplexityMax:
+      cpu_speed_ = -3;
+      break;
+    default:
+      cpu_speed_ = -6;
+      break;
+  }
+#if defined(WEBRTC_ARCH_ARM)
+  cpu_speed_ = -12;
+#endif
+
+  encoders_ = new vpx_codec_ctx_t[num_streams];
+  configs_ = new vpx_codec_enc_cfg_t[num_streams];
+  raw_images_ = new vpx_image_t[num_streams];
+  downsampling_factors_ = new vpx_rational_t[num_streams];
+  memset(encoders_, 0, sizeof(*encoders_) * num_streams);
+  memset(raw_images_, 0, sizeof(*raw_images_) * num_streams);
+
+  // The highest resolution is configured first and the lower ones copy its
+  // settings.
+  vpx_codec_enc_cfg_t* config = &configs_[0];
+  if (vpx_codec_enc_config_default(vpx_codec_vp8_cx(), config, 0)) {
+    Release();
+    return WEBRTC_VIDEO_CODEC_ERROR;
+  }
+  config->g_timebase.num = 1;
+  config->g_timebase.den = 90000;
+  config->g_lag_in_frames = 0;
+  // The streams can't be resilient differently, and temporal layers need
+  // resilience on.
+  config->g_error_resilient =
+      inst->codecSpecific.VP8.resilience != kResilienceOff ? 1 : 0;
+  for (int i = 0; i < num_streams; ++i) {
+    if (inst->simulcastStream[i].numberOfTemporalLayers > 1)
+      config->g_error_resilient = 1;
+  }
+  config->rc_dropframe_thresh = inst->codecSpecific.VP8.frameDroppingOn ?
+      30 : 0;
+  config->rc_end_usage = VPX_CBR;
+  config->g_pass = VPX_RC_ONE_PASS;
+  // Resizing would break the fixed downsampling factors.
+  config->rc_resize_allowed = 0;
+  config->rc_min_quantizer = 2;
+  config->rc_undershoot_pct = 100;
+  config->rc_overshoot_pct = 15;
+  config->rc_buf_initial_sz = 500;
+  config->rc_buf_optimal_sz = 600;
+  config->rc_buf_sz = 1000;
+  // All resolutions share the key frame interval, so that their key frames
+  // coincide.
+  if (inst->codecSpecific.VP8.keyFrameInterval > 0) {
+    config->kf_mode = VPX_KF_AUTO;
+    config->kf_max_dist = inst->codecSpecific.VP8.keyFrameInterval;
+  } else {
+    config->kf_mode = VPX_KF_DISABLED;
+  }
+  for (int i = 1; i < num_streams; ++i)
+    configs_[i] = configs_[0];
+
+  for (int i = 0; i < num_streams; ++i) {
+    const Stream* s = streams_[i];
+    const int encoder_idx = EncoderIndex(i);
+    config = &configs_[encoder_idx];
+    config->g_w = s->codec.width;
+    config->g_h = s->codec.height;
+    config->rc_max_quantizer = s->codec.qpMax;
+    config->g_threads = NumberOfEncoderThreads(s->codec.width,
+                                               s->codec.height,
+                                               number_of_cores);
+    vpx_rational_t* factor = &downsampling_factors_[encoder_idx];
+    if (i == 0) {
+      // The lowest resolution is not downsampled any further.
+      factor->num = 1;
+      factor->den = 1;
+    } else {
+      // The factor from this resolution down to the next lower one.
+      const int lower_width = streams_[i - 1]->codec.width;
+      const int gcd = GreatestCommonDivisor(s->codec.width, lower_width);
+      factor->num = s->codec.width / gcd;
+      factor->den = lower_width / gcd;
+    }
+    // The images are wrapped without data, which is set in Encode().
+    vpx_img_wrap(&raw_images_[encoder_idx], IMG_FMT_I420, s->codec.width,
+                 s->codec.height, 1, NULL);
+  }
+  AllocateBitrate(inst->startBitrate, inst->maxFramerate);
+
+  if (vpx_codec_enc_init_multi(encoders_, vpx_codec_vp8_cx(), configs_,
+                               num_streams, VPX_CODEC_USE_OUTPUT_PARTITION,
+                               downsampling_factors_)) {
+    Release();
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  inited_ = true;
+  for (int i = 0; i < num_streams; ++i) {
+    vpx_codec_ctx_t* encoder = &encoders_[i];
+    const uint32_t max_intra_target = std::max<uint32_t>(
+        300, configs_[i].rc_buf_optimal_sz * inst->maxFramerate / 20);
+    vpx_codec_control(encoder, VP8E_SET_STATIC_THRESHOLD, 1);
+    vpx_codec_control(encoder, VP8E_SET_CPUUSED, cpu_speed_);
+    vpx_codec_control(encoder, VP8E_SET_TOKEN_PARTITIONS,
+                      static_cast<vp8e_token_partitions>(
+                          VP8_ONE_TOKENPARTITION));
+#if !defined(WEBRTC_ARCH_ARM)
+    // The lower resolutions are denoised as part of the highest one.
+    vpx_codec_control(encoder, VP8E_SET_NOISE_SENSITIVITY,
+                      i == 0 && inst->codecSpecific.VP8.denoisingOn ? 1 : 0);
+#endif
+    vpx_codec_control(encoder, VP8E_SET_MAX_INTRA_BITRATE_PCT,
+                      max_intra_target);
+  }
+  timestamp_ = 0;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int MultiResEncoder::Encode(const I420VideoFrame& input_image,
+                            const CodecSpecificInfo* /*codec_specific_info*/,
+                            const std::vector<VideoFrameType>* frame_types) {
+  TRACE_EVENT1("webrtc", "VP8::MultiResEncode", "timestamp",
+               input_image.timestamp());
+  if (!inited_) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  if (input_image.IsZeroSize()) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  if (encoded_complete_callback_ == NULL) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  if (!BuildPyramid(input_image)) {
+    return WEBRTC_VIDEO_CODEC_ERROR;
+  }
+
+  // A key frame requested for any stream is a key frame for all of them,
+  // since every resolution predicts from the next lower one.
+  bool send_key_frame = false;
+  if (frame_types) {
+    for (size_t i = 0; i < frame_types->size(); ++i) {
+      if ((*frame_types)[i] == kKeyFrame)
+        send_key_frame = true;
+    }
+  }
+  const int num_streams = static_cast<int>(streams_.size());
+  for (int i = 0; i < num_streams; ++i) {
+    int flags = send_key_frame ? VPX_EFLAG_FORCE_KF :
+        streams_[i]->temporal_layers->EncodeFlags(input_image.timestamp());
+    vpx_codec_control(&encoders_[EncoderIndex(i)], VP8E_SET_FRAME_FLAGS,
+                      flags);
+  }
+
+  const VideoCodec& codec = streams_.back()->codec;
+  assert(codec.maxFramerate > 0);
+  const uint32_t duration = 90000 / codec.maxFramerate;
+  // Encodes all resolutions, the lowest first.
+  if (vpx_codec_encode(encoders_, raw_images_, timestamp_, duration, 0,
+                       VPX_DL_REALTIME)) {
+    return WEBRTC_VIDEO_CODEC_ERROR;
+  }
+  timestamp_ += duration;
+
+  int ret_val = WEBRTC_VIDEO_CODEC_OK;
+  for (int i = 0; i < num_streams; ++i) {
+    const int stream_ret_val = GetEncodedPartitions(i, input_image);
+    if (stream_ret_val < 0 && ret_val == WEBRTC_VIDEO_CODEC_OK)
+      ret_val = stream_ret_val;
+  }
+  return ret_val;
+}
+
+int MultiResEncoder::GetEncodedPartitions(int stream_idx,
+                                          const I420VideoFrame& input_image) {
+  Stream* s = streams_[stream_idx];
+  vpx_codec_ctx_t* encoder = &encoders_[EncoderIndex(stream_idx)];
+  EncodedImage& encoded_image = s->encoded_image;
+  vpx_codec_iter_t iter = NULL;
+  int part_idx = 0;
+  encoded_image._length = 0;
+  encoded_image._frameType = kDeltaFrame;
+  RTPFragmentationHeader frag_info;
+  frag_info.VerifyAndAllocateFragmentationHeader(
+      (1 << VP8_ONE_TOKENPARTITION) + 1);
+  CodecSpecificInfo codec_specific;
+  memset(&codec_specific, 0, sizeof(codec_specific));
+
+  const vpx_codec_cx_pkt_t* pkt = NULL;
+  while ((pkt = vpx_codec_get_cx_data(encoder, &iter)) != NULL) {
+    if (pkt->kind != VPX_CODEC_CX_FRAME_PKT)
+      continue;
+    assert(encoded_image._length + pkt->data.frame.sz <= encoded_image._size);
+    memcpy(&encoded_image._buffer[encoded_image._length],
+           pkt->data.frame.buf, pkt->data.frame.sz);
+    frag_info.fragmentationOffset[part_idx] = encoded_image._length;
+    frag_info.fragmentationLength[part_idx] = pkt->data.frame.sz;
+    frag_info.fragmentationPlType[part_idx] = 0;  // not known here
+    frag_info.fragmentationTimeDiff[part_idx] = 0;
+    encoded_image._length += pkt->data.frame.sz;
+    ++part_idx;
+    // End of frame
+    if ((pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT) == 0) {
+      const bool key_frame = (pkt->data.frame.flags & VPX_FRAME_IS_KEY) != 0;
+      if (key_frame)
+        encoded_image._frameType = kKeyFrame;
+      codec_specific.codecType = kVideoCodecVP8;
+      CodecSpecificInfoVP8* vp8_info = &codec_specific.codecSpecific.VP8;
+      vp8_info->pictureId = s->picture_id;
+      vp8_info->simulcastIdx = stream_idx;
+      vp8_info->keyIdx = kNoKeyIdx;
+      vp8_info->nonReference =
+          (pkt->data.frame.flags & VPX_FRAME_IS_DROPPABLE) != 0;
+      s->temporal_layers->PopulateCodecSpecific(key_frame, vp8_info,
+                                                input_image.timestamp());
+      s->picture_id = (s->picture_id + 1) & 0x7FFF;
+      break;
+    }
+  }
+  // A stream without bitrate is encoded, since the higher resolutions depend
+  // on it, but not sent.
+  if (encoded_image._length == 0 || s->bitrate_kbit == 0)
+    return WEBRTC_VIDEO_CODEC_OK;
+  encoded_image._timeStamp = input_image.timestamp();
+  encoded_image.capture_time_ms_ = input_image.render_time_ms();
+  encoded_image._encodedWidth = s->codec.width;
+  encoded_image._encodedHeight = s->codec.height;
+  return encoded_complete_callback_->Encoded(encoded_image, &codec_specific,
+                                             &frag_info);
+}
+
+int MultiResEncoder::RegisterEncodeCompleteCallback(
+    EncodedImageCallback* callback) {
+  encoded_complete_callback_ = callback;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int MultiResEncoder::Release() {
+  int ret_val = WEBRTC_VIDEO_CODEC_OK;
+  const int num_streams = static_cast<int>(streams_.size());
+  if (encoders_ != NULL) {
+    if (inited_) {
+      for (int i = 0; i < num_streams; ++i) {
+        if (vpx_codec_destroy(&encoders_[i]))
+          ret_val = WEBRTC_VIDEO_CODEC_MEMORY;
+      }
+    }
+    delete [] encoders_;
+    encoders_ = NULL;
+  }
+  if (raw_images_ != NULL) {
+    for (int i = 0; i < num_streams; ++i)
+      vpx_img_free(&raw_images_[i]);
+    delete [] raw_images_;
+    raw_images_ = NULL;
+  }
+  delete [] configs_;
+  configs_ = NULL;
+  delete [] downsampling_factors_;
+  downsampling_factors_ = NULL;
+  for (size_t i = 0; i < streams_.size(); ++i)
+    delete streams_[i];
+  streams_.clear();
+  inited_ = false;
+  return ret_val;
+}
+
+int MultiResEncoder::SetChannelParameters(uint32_t /*packet_loss*/,
+                                          int /*rtt*/) {
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int MultiResEncoder::SetRates(uint32_t new_bitrate_kbit,
+                              uint32_t frame_rate) {
+  if (!inited_) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  if (frame_rate < 1) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  AllocateBitrate(new_bitrate_kbit, frame_rate);
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    if (vpx_codec_enc_config_set(&encoders_[i], &configs_[i])) {
+      return WEBRTC_VIDEO_CODEC_ERROR;
+    }
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+void MultiResEncoder::AllocateBitrate(uint32_t bitrate_kbit,
+                                      uint32_t frame_rate) {
+  // Same split as the one the send side configures the RTP modules with.
+  uint32_t bitrate_remainder = bitrate_kbit;
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    Stream* s = streams_[i];
+    s->bitrate_kbit = std::min(bitrate_remainder, s->codec.maxBitrate);
+    bitrate_remainder -= s->bitrate_kbit;
+    s->codec.maxFramerate = frame_rate;
+    // An encoder can't be configured without a bitrate, even for a stream
+    // that is not sent.
+    const uint32_t target_kbit = std::max<uint32_t>(s->bitrate_kbit, 1);
+    vpx_codec_enc_cfg_t* config = &configs_[EncoderIndex(i)];
+    config->rc_target_bitrate = target_kbit;
+    s->temporal_layers->ConfigureBitrates(target_kbit, s->codec.maxBitrate,
+                                          frame_rate, config);
+  }
+}
+
+bool MultiResEncoder::BuildPyramid(const I420VideoFrame& input_image) {
+  const I420VideoFrame* larger = &input_image;
+  for (int i = static_cast<int>(streams_.size()) - 1; i >= 0; --i) {
+    Stream* s = streams_[i];
+    const int width = s->codec.width;
+    const int height = s->codec.height;
+    const I420VideoFrame* frame = &s->frame;
+    if (larger == &input_image && larger->width() == width &&
+        larger->height() == height) {
+      // The largest stream is encoded from the input itself.
+      frame = &input_image;
+    } else if (s->scaler.Set(larger->width(), larger->height(), width, height,
+                             kI420, kI420, kScaleBox) != 0 ||
+               s->scaler.Scale(*larger, &s->frame) != 0) {
+      return false;
+    }
+    vpx_image_t* raw = &raw_images_[EncoderIndex(i)];
+    // The input is const. VP8's raw image is not defined as const.
+    raw->planes[VPX_PLANE_Y] = const_cast<uint8_t*>(frame->buffer(kYPlane));
+    raw->planes[VPX_PLANE_U] = const_cast<uint8_t*>(frame->buffer(kUPlane));
+    raw->planes[VPX_PLANE_V] = const_cast<uint8_t*>(frame->buffer(kVPlane));
+    raw->stride[VPX_PLANE_Y] = frame->stride(kYPlane);
+    raw->stride[VPX_PLANE_U] = frame->stride(kUPlane);
+    raw->stride[VPX_PLANE_V] = frame->stride(kVPlane);
+    larger = frame;
+  }
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file defines an encoder producing all simulcast streams of a VP8
+ * send codec with the multi-resolution encoder of libvpx.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_MULTI_RES_ENCODER_H_
+#define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_MULTI_RES_ENCODER_H_
+
+#include <vector>
+
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+
+// VPX forward declaration
+typedef struct vpx_codec_ctx vpx_codec_ctx_t;
+typedef struct vpx_codec_enc_cfg vpx_codec_enc_cfg_t;
+typedef struct vpx_image vpx_image_t;
+struct vpx_rational;
+
+namespace webrtc {
+
+class TemporalLayers;
+
+// MultiResEncoder encodes all simulcast streams with one libvpx
+// multi-resolution encoder. libvpx encodes the streams from the lowest
+// resolution up and reuses the motion vectors and mode decisions of each
+// stream for the next higher one, which makes the higher resolutions
+// considerably cheaper than with an independent encoder per stream. The
+// streams are encoded on the calling thread and delivered in stream order,
+// with the stream index set as simulcastIdx. Requires libvpx to be built with
+// CONFIG_MULTI_RES_ENCODING.
+class MultiResEncoder : public VP8Encoder {
+ public:
+  MultiResEncoder();
+  virtual ~MultiResEncoder();
+
+  virtual int InitEncode(const VideoCodec* codec_settings,
+                         int number_of_cores,
+                         uint32_t max_payload_size);
+  virtual int Encode(const I420VideoFrame& input_image,
+                     const CodecSpecificInfo* codec_specific_info,
+                     const std::vector<VideoFrameType>* frame_types);
+  virtual int RegisterEncodeCompleteCallback(EncodedImageCallback* callback);
+  virtual int Release();
+  virtual int SetChannelParameters(uint32_t packet_loss, int rtt);
+  virtual int SetRates(uint32_t new_bitrate_kbit, uint32_t frame_rate);
+
+ private:
+  struct Stream {
+    Stream();
+    ~Stream();
+
+    VideoCodec codec;
+    TemporalLayers* temporal_layers;
+    // The input downscaled to the size of the stream.
+    I420VideoFrame frame;
+    Scaler scaler;
+    EncodedImage encoded_image;
+    uint16_t picture_id;
+    // Zero if the stream is not sent.
+    uint32_t bitrate_kbit;
+  };
+
+  // libvpx orders the encoders from the highest resolution down, the reverse
+  // of the stream order.
+  int EncoderIndex(int stream_idx) const {
+    return static_cast<int>(streams_.size()) - 1 - stream_idx;
+  }
+
+  // Splits |bitrate_kbit| over the streams, lowest stream first, and
+  // configures the encoders with the result.
+  void AllocateBitrate(uint32_t bitrate_kbit, uint32_t frame_rate);
+  // Downscales |input_image| into the frames of the streams and points the
+  // raw images of the encoders at them.
+  bool BuildPyramid(const I420VideoFrame& input_image);
+  // Delivers the output of the encoder of stream |stream_idx|.
+  int GetEncodedPartitions(int stream_idx, const I420VideoFrame& input_image);
+
+  std::vector<Stream*> streams_;
+  EncodedImageCallback* encoded_complete_callback_;
+  int cpu_speed_;
+  int64_t timestamp_;
+  bool inited_;
+  // In libvpx order, see EncoderIndex().
+  vpx_codec_ctx_t* encoders_;
+  vpx_codec_enc_cfg_t* configs_;
+  vpx_image_t* raw_images_;
+  vpx_rational* downsampling_factors_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_MULTI_RES_ENCODER_H_
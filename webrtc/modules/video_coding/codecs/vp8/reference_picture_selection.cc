@@ -62,6 +62,15 @@ bool ReferencePictureSelection::ReceivedSLI(uint32_t now_ts) {
   return send_refresh;
 }
 
+bool ReferencePictureSelection::ReceivedPictureLoss(uint32_t now_ts) {
+  if (!received_ack_)
+    return false;
+  // Unlike an SLI, a picture loss is reported once per lost picture, so the
+  // refresh is always sent.
+  last_refresh_time_ = now_ts;
+  return true;
+}
+
 int ReferencePictureSelection::EncodeFlags(int picture_id, bool send_refresh,
                                            uint32_t now_ts) {
   int flags = 0;
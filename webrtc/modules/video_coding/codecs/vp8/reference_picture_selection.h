@@ -37,6 +37,14 @@ class ReferencePictureSelection {
   // Returns true if it's time to encode a decoder refresh, otherwise false.
   bool ReceivedSLI(uint32_t now_ts);
 
+  // Report a received picture loss indication. The loss can be recovered
+  // without a key frame by sending a refresh frame, predicted only from the
+  // established reference, as long as the receiver has acknowledged one.
+  // |now_ts| is the RTP timestamp corresponding to the current time.
+  // Returns true if a decoder refresh should be encoded, or false if there is
+  // no established reference and a key frame must be sent instead.
+  bool ReceivedPictureLoss(uint32_t now_ts);
+
   // Returns the recommended VP8 encode flags needed. May refresh the decoder
   // and/or update the reference buffers.
   // |picture_id| picture id of the frame to be encoded.
@@ -95,6 +95,26 @@ TEST_F(TestRPS, TestDecoderRefresh) {
             kNoPropagationAltRef);
 }
 
+TEST_F(TestRPS, TestPictureLossRefreshesFromEstablishedReference) {
+  uint32_t time = kRtt + 1;
+  EXPECT_TRUE(rps_.ReceivedPictureLoss(90 * time));
+  EXPECT_EQ(rps_.EncodeFlags(1, true, 90 * time), kRefreshFromGolden |
+            kNoPropagationGolden);
+  // Every picture loss is refreshed, while SLIs are limited to one refresh
+  // per RTT.
+  EXPECT_TRUE(rps_.ReceivedPictureLoss(90 * time));
+  EXPECT_FALSE(rps_.ReceivedSLI(90 * time));
+}
+
+TEST_F(TestRPS, TestPictureLossWithoutEstablishedReference) {
+  // A key frame which hasn't been acknowledged leaves no reference to refresh
+  // from.
+  rps_.EncodedKeyFrame(1);
+  EXPECT_FALSE(rps_.ReceivedPictureLoss(90 * (kRtt + 1)));
+  rps_.ReceivedRPSI(1);
+  EXPECT_TRUE(rps_.ReceivedPictureLoss(90 * (kRtt + 1)));
+}
+
 TEST_F(TestRPS, TestWrap) {
   EXPECT_EQ(rps_.ReceivedSLI(0xffffffff), true);
   EXPECT_EQ(rps_.ReceivedSLI(1), false);
@@ -0,0 +1,286 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/codecs/vp8/simulcast_encoder.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/modules/interface/module_common_types.h"
+
+namespace webrtc {
+
+SimulcastEncoder::StreamCallback::StreamCallback()
+    : has_output_(false),
+      has_fragmentation_(false) {
+  memset(&codec_specific_info_, 0, sizeof(codec_specific_info_));
+}
+
+int32_t SimulcastEncoder::StreamCallback::Encoded(
+    EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const RTPFragmentationHeader* fragmentation) {
+  // The buffer stays valid until the stream encoder encodes again, which is
+  // after the image has been delivered.
+  encoded_image_ = encoded_image;
+  if (codec_specific_info) {
+    codec_specific_info_ = *codec_specific_info;
+  } else {
+    memset(&codec_specific_info_, 0, sizeof(codec_specific_info_));
+    codec_specific_info_.codecType = kVideoCodecVP8;
+  }
+  has_fragmentation_ = fragmentation != NULL;
+  if (has_fragmentation_)
+    fragmentation_.CopyFrom(*fragmentation);
+  has_output_ = true;
+  return 0;
+}
+
+int32_t SimulcastEncoder::StreamCallback::Deliver(
+    int stream_idx, EncodedImageCallback* callback) {
+  if (!has_output_)
+    return 0;
+  has_output_ = false;
+  codec_specific_info_.codecSpecific.VP8.simulcastIdx = stream_idx;
+  return callback->Encoded(encoded_image_, &codec_specific_info_,
+                           has_fragmentation_ ? &fragmentation_ : NULL);
+}
+
+SimulcastEncoder::Stream::Stream(VideoEncoder* encoder)
+    : encoder_(encoder),
+      frame_types_(1, kDeltaFrame),
+      error_(WEBRTC_VIDEO_CODEC_OK),
+      bitrate_kbit_(0) {
+  memset(&codec_, 0, sizeof(codec_));
+  encoder_->RegisterEncodeCompleteCallback(&callback_);
+}
+
+SimulcastEncoder::Stream::~Stream() {
+  encoder_->Release();
+}
+
+void SimulcastEncoder::Stream::Encode(const I420VideoFrame& input_image) {
+  // The input is encoded as is if it has the size of the stream.
+  const I420VideoFrame& frame = frame_.IsZeroSize() ? input_image : frame_;
+  error_ = encoder_->Encode(frame, NULL, &frame_types_);
+}
+
+void SimulcastEncoder::EncodeTask::Run(int index) {
+  streams_[index]->Encode(input_image_);
+}
+
+SimulcastEncoder::SimulcastEncoder(CreateStreamEncoder create_stream_encoder)
+    : create_stream_encoder_(create_stream_encoder),
+      encoded_complete_callback_(NULL) {
+  assert(create_stream_encoder_);
+}
+
+SimulcastEncoder::~SimulcastEncoder() {
+  Release();
+}
+
+int SimulcastEncoder::InitEncode(const VideoCodec* inst,
+                                 int number_of_cores,
+                                 uint32_t max_payload_size) {
+  if (inst == NULL || inst->numberOfSimulcastStreams < 1 ||
+      inst->numberOfSimulcastStreams > kMaxSimulcastStreams) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  if (inst->width < 1 || inst->height < 1 || number_of_cores < 1) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  for (int i = 0; i < inst->numberOfSimulcastStreams; ++i) {
+    const SimulcastStream& stream = inst->simulcastStream[i];
+    // Every stream is downscaled from the next larger one.
+    const SimulcastStream& larger = i + 1 < inst->numberOfSimulcastStreams ?
+        inst->simulcastStream[i + 1] : stream;
+    if (stream.width < 1 || stream.height < 1 ||
+        stream.width > larger.width || stream.height > larger.height) {
+      return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+    }
+  }
+  int ret_val = Release();
+  if (ret_val < 0) {
+    return ret_val;
+  }
+
+  const int num_streams = inst->numberOfSimulcastStreams;
+  // The streams are encoded in parallel, so they share the cores.
+  const int cores_per_stream = std::max(1, number_of_cores / num_streams);
+  for (int i = 0; i < num_streams; ++i) {
+    const SimulcastStream& stream = inst->simulcastStream[i];
+    Stream* s = new Stream(create_stream_encoder_());
+    streams_.push_back(s);
+    VideoCodec* codec = s->codec();
+    *codec = *inst;
+    codec->width = stream.width;
+    codec->height = stream.height;
+    codec->maxBitrate = stream.maxBitrate;
+    codec->minBitrate = stream.minBitrate;
+    codec->qpMax = stream.qpMax;
+    codec->codecSpecific.VP8.numberOfTemporalLayers =
+        stream.numberOfTemporalLayers;
+    codec->numberOfSimulcastStreams = 0;
+    memset(codec->simulcastStream, 0, sizeof(codec->simulcastStream));
+  }
+  AllocateBitrate(inst->startBitrate);
+  for (int i = 0; i < num_streams; ++i) {
+    Stream* s = streams_[i];
+    // A stream encoder can't be initialized without a bitrate.
+    s->codec()->startBitrate = std::max<uint32_t>(s->bitrate_kbit(), 1);
+    ret_val = s->encoder()->InitEncode(s->codec(), cores_per_stream,
+                                       max_payload_size);
+    if (ret_val < 0) {
+      Release();
+      return ret_val;
+    }
+  }
+  // The calling thread encodes one of the streams.
+  if (num_streams > 1) {
+    pool_.reset(ThreadPool::Create("SimulcastEncoder", num_streams - 1,
+                                   kHighPriority, kEncoderThreadRole));
+    if (!pool_) {
+      Release();
+      return WEBRTC_VIDEO_CODEC_ERROR;
+    }
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int SimulcastEncoder::Encode(const I420VideoFrame& input_image,
+                             const CodecSpecificInfo* codec_specific_info,
+                             const std::vector<VideoFrameType>* frame_types) {
+  if (streams_.empty()) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  if (input_image.IsZeroSize()) {
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  }
+  if (encoded_complete_callback_ == NULL) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  if (!BuildPyramid(input_image)) {
+    return WEBRTC_VIDEO_CODEC_ERROR;
+  }
+
+  const int num_streams = static_cast<int>(streams_.size());
+  for (int i = 0; i < num_streams; ++i) {
+    VideoFrameType frame_type = kDeltaFrame;
+    if (frame_types && static_cast<int>(frame_types->size()) > i)
+      frame_type = (*frame_types)[i];
+    (*streams_[i]->frame_types())[0] = frame_type;
+  }
+
+  // Largest first, so that the calling thread starts on the largest stream.
+  std::vector<Stream*> sent_streams;
+  for (int i = num_streams - 1; i >= 0; --i) {
+    if (streams_[i]->bitrate_kbit() > 0)
+      sent_streams.push_back(streams_[i]);
+  }
+  EncodeTask task(sent_streams, input_image);
+  if (pool_) {
+    pool_->RunInParallel(&task, static_cast<int>(sent_streams.size()));
+  } else {
+    for (size_t i = 0; i < sent_streams.size(); ++i)
+      task.Run(static_cast<int>(i));
+  }
+
+  int ret_val = WEBRTC_VIDEO_CODEC_OK;
+  for (int i = 0; i < num_streams; ++i) {
+    if (streams_[i]->bitrate_kbit() == 0)
+      continue;
+    if (streams_[i]->error() < 0) {
+      if (ret_val == WEBRTC_VIDEO_CODEC_OK)
+        ret_val = streams_[i]->error();
+      continue;
+    }
+    streams_[i]->callback()->Deliver(i, encoded_complete_callback_);
+  }
+  return ret_val;
+}
+
+int SimulcastEncoder::RegisterEncodeCompleteCallback(
+    EncodedImageCallback* callback) {
+  encoded_complete_callback_ = callback;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int SimulcastEncoder::Release() {
+  for (size_t i = 0; i < streams_.size(); ++i)
+    delete streams_[i];
+  streams_.clear();
+  pool_.reset();
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int SimulcastEncoder::SetChannelParameters(uint32_t packet_loss, int rtt) {
+  for (size_t i = 0; i < streams_.size(); ++i)
+    streams_[i]->encoder()->SetChannelParameters(packet_loss, rtt);
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int SimulcastEncoder::SetRates(uint32_t new_bitrate_kbit,
+                               uint32_t frame_rate) {
+  if (streams_.empty()) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  AllocateBitrate(new_bitrate_kbit);
+  int ret_val = WEBRTC_VIDEO_CODEC_OK;
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    // A stream without bitrate is not encoded until it gets some again.
+    if (streams_[i]->bitrate_kbit() == 0)
+      continue;
+    int stream_ret_val = streams_[i]->encoder()->SetRates(
+        streams_[i]->bitrate_kbit(), frame_rate);
+    if (stream_ret_val < 0 && ret_val == WEBRTC_VIDEO_CODEC_OK)
+      ret_val = stream_ret_val;
+  }
+  return ret_val;
+}
+
+void SimulcastEncoder::AllocateBitrate(uint32_t bitrate_kbit) {
+  // Same split as the one the send side configures the RTP modules with.
+  uint32_t bitrate_remainder = bitrate_kbit;
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    const uint32_t bitrate = std::min(bitrate_remainder,
+                                      streams_[i]->codec()->maxBitrate);
+    streams_[i]->set_bitrate_kbit(bitrate);
+    bitrate_remainder -= bitrate;
+  }
+}
+
+bool SimulcastEncoder::BuildPyramid(const I420VideoFrame& input_image) {
+  const I420VideoFrame* larger = &input_image;
+  for (int i = static_cast<int>(streams_.size()) - 1; i >= 0; --i) {
+    Stream* s = streams_[i];
+    const int width = s->codec()->width;
+    const int height = s->codec()->height;
+    if (larger == &input_image && larger->width() == width &&
+        larger->height() == height) {
+      // The largest stream is encoded from the input itself.
+      s->frame()->ResetSize();
+      continue;
+    }
+    if (s->scaler()->Set(larger->width(), larger->height(), width, height,
+                         kI420, kI420, kScaleBox) != 0 ||
+        s->scaler()->Scale(*larger, s->frame()) != 0) {
+      return false;
+    }
+    s->frame()->set_timestamp(input_image.timestamp());
+    s->frame()->set_ntp_time_ms(input_image.ntp_time_ms());
+    s->frame()->set_render_time_ms(input_image.render_time_ms());
+    larger = s->frame();
+  }
+  return true;
+}
+
+}  // namespace webrtc
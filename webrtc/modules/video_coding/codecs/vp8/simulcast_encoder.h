@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file defines an encoder producing all simulcast streams of a VP8
+ * send codec, one VP8 encoder per stream.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_SIMULCAST_ENCODER_H_
+#define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_SIMULCAST_ENCODER_H_
+
+#include <vector>
+
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/common_video/libyuv/include/scaler.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+
+namespace webrtc {
+
+class ThreadPool;
+
+// SimulcastEncoder downscales every input frame once into a pyramid, each
+// stream from the next larger one, and encodes the streams in parallel on the
+// calling thread and a pool of one thread less than there are streams. The
+// encoded images are delivered on the calling thread, in stream
+// order, with the stream index set as simulcastIdx.
+class SimulcastEncoder : public VP8Encoder {
+ public:
+  typedef VideoEncoder* (*CreateStreamEncoder)();
+
+  // |create_stream_encoder| creates the encoder of each stream.
+  explicit SimulcastEncoder(CreateStreamEncoder create_stream_encoder);
+  virtual ~SimulcastEncoder();
+
+  virtual int InitEncode(const VideoCodec* codec_settings,
+                         int number_of_cores,
+                         uint32_t max_payload_size);
+  virtual int Encode(const I420VideoFrame& input_image,
+                     const CodecSpecificInfo* codec_specific_info,
+                     const std::vector<VideoFrameType>* frame_types);
+  virtual int RegisterEncodeCompleteCallback(EncodedImageCallback* callback);
+  virtual int Release();
+  virtual int SetChannelParameters(uint32_t packet_loss, int rtt);
+  virtual int SetRates(uint32_t new_bitrate_kbit, uint32_t frame_rate);
+
+ private:
+  // Keeps the output of a stream encoder until it is delivered.
+  class StreamCallback : public EncodedImageCallback {
+   public:
+    StreamCallback();
+
+    virtual int32_t Encoded(EncodedImage& encoded_image,
+                            const CodecSpecificInfo* codec_specific_info,
+                            const RTPFragmentationHeader* fragmentation);
+
+    // Delivers the kept output, if any, to |callback| as stream
+    // |stream_idx|.
+    int32_t Deliver(int stream_idx, EncodedImageCallback* callback);
+
+   private:
+    bool has_output_;
+    EncodedImage encoded_image_;
+    CodecSpecificInfo codec_specific_info_;
+    RTPFragmentationHeader fragmentation_;
+    bool has_fragmentation_;
+  };
+
+  class Stream {
+   public:
+    explicit Stream(VideoEncoder* encoder);
+    ~Stream();
+
+    // Encodes |frame_|, or |input_image| if |frame_| is empty because the
+    // input has the size of the stream.
+    void Encode(const I420VideoFrame& input_image);
+
+    VideoEncoder* encoder() { return encoder_.get(); }
+    VideoCodec* codec() { return &codec_; }
+    I420VideoFrame* frame() { return &frame_; }
+    Scaler* scaler() { return &scaler_; }
+    StreamCallback* callback() { return &callback_; }
+    std::vector<VideoFrameType>* frame_types() { return &frame_types_; }
+    int error() const { return error_; }
+    uint32_t bitrate_kbit() const { return bitrate_kbit_; }
+    void set_bitrate_kbit(uint32_t bitrate_kbit) {
+      bitrate_kbit_ = bitrate_kbit;
+    }
+
+   private:
+    const scoped_ptr<VideoEncoder> encoder_;
+    VideoCodec codec_;
+    // The input downscaled to the size of the stream.
+    I420VideoFrame frame_;
+    Scaler scaler_;
+    StreamCallback callback_;
+    std::vector<VideoFrameType> frame_types_;
+    int error_;
+    // Zero if the stream is not sent.
+    uint32_t bitrate_kbit_;
+  };
+
+  // Encodes one frame of each of |streams|.
+  class EncodeTask : public ParallelTask {
+   public:
+    EncodeTask(const std::vector<Stream*>& streams,
+               const I420VideoFrame& input_image)
+        : streams_(streams), input_image_(input_image) {}
+
+    virtual void Run(int index) OVERRIDE;
+
+   private:
+    const std::vector<Stream*>& streams_;
+    const I420VideoFrame& input_image_;
+  };
+
+  // Splits |bitrate_kbit| over the streams, lowest stream first.
+  void AllocateBitrate(uint32_t bitrate_kbit);
+  // Downscales |input_image| into the frames of the streams.
+  bool BuildPyramid(const I420VideoFrame& input_image);
+
+  const CreateStreamEncoder create_stream_encoder_;
+  std::vector<Stream*> streams_;
+  EncodedImageCallback* encoded_complete_callback_;
+  // NULL with a single stream.
+  scoped_ptr<ThreadPool> pool_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_SIMULCAST_ENCODER_H_
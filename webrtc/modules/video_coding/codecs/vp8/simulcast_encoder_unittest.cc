@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/codecs/vp8/simulcast_encoder.h"
+
+#include <string.h>
+
+#include <set>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumStreams = 3;
+const int kWidth = 640;
+const int kHeight = 360;
+
+// Emits one byte per frame, and records what it was given.
+class FakeStreamEncoder : public VideoEncoder {
+ public:
+  FakeStreamEncoder()
+      : callback_(NULL),
+        width_(0),
+        height_(0),
+        bitrate_kbit_(0),
+        frame_width_(0),
+        frame_height_(0),
+        frame_type_(kDeltaFrame),
+        thread_id_(0),
+        num_encoded_(0) {}
+
+  virtual int32_t InitEncode(const VideoCodec* codec_settings,
+                             int32_t number_of_cores,
+                             uint32_t max_payload_size) {
+    EXPECT_EQ(0, codec_settings->numberOfSimulcastStreams);
+    width_ = codec_settings->width;
+    height_ = codec_settings->height;
+    bitrate_kbit_ = codec_settings->startBitrate;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  virtual int32_t Encode(const I420VideoFrame& input_image,
+                         const CodecSpecificInfo* codec_specific_info,
+                         const std::vector<VideoFrameType>* frame_types) {
+    frame_width_ = input_image.width();
+    frame_height_ = input_image.height();
+    frame_type_ = (*frame_types)[0];
+    thread_id_ = ThreadWrapper::GetThreadId();
+    ++num_encoded_;
+    EncodedImage image(&payload_, 1, 1);
+    image._encodedWidth = input_image.width();
+    image._encodedHeight = input_image.height();
+    image._timeStamp = input_image.timestamp();
+    image._frameType = frame_type_;
+    CodecSpecificInfo info;
+    memset(&info, 0, sizeof(info));
+    info.codecType = kVideoCodecVP8;
+    callback_->Encoded(image, &info, NULL);
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  virtual int32_t RegisterEncodeCompleteCallback(
+      EncodedImageCallback* callback) {
+    callback_ = callback;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  virtual int32_t Release() { return WEBRTC_VIDEO_CODEC_OK; }
+
+  virtual int32_t SetChannelParameters(uint32_t packet_loss, int rtt) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  virtual int32_t SetRates(uint32_t new_bitrate_kbit, uint32_t frame_rate) {
+    bitrate_kbit_ = new_bitrate_kbit;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  EncodedImageCallback* callback_;
+  uint8_t payload_;
+  int width_;
+  int height_;
+  uint32_t bitrate_kbit_;
+  int frame_width_;
+  int frame_height_;
+  VideoFrameType frame_type_;
+  uint32_t thread_id_;
+  int num_encoded_;
+};
+
+std::vector<FakeStreamEncoder*> stream_encoders;
+
+VideoEncoder* CreateFakeStreamEncoder() {
+  stream_encoders.push_back(new FakeStreamEncoder());
+  return stream_encoders.back();
+}
+
+// Records the images delivered by the simulcast encoder.
+class EncodedImageRecorder : public EncodedImageCallback {
+ public:
+  virtual int32_t Encoded(EncodedImage& encoded_image,
+                          const CodecSpecificInfo* codec_specific_info,
+                          const RTPFragmentationHeader* fragmentation) {
+    images_.push_back(encoded_image);
+    simulcast_idxs_.push_back(
+        codec_specific_info->codecSpecific.VP8.simulcastIdx);
+    return 0;
+  }
+
+  std::vector<EncodedImage> images_;
+  std::vector<int> simulcast_idxs_;
+};
+
+}  // namespace
+
+class SimulcastEncoderTest : public ::testing::Test {
+ protected:
+  SimulcastEncoderTest() : encoder_(CreateFakeStreamEncoder) {}
+
+  virtual void SetUp() {
+    stream_encoders.clear();
+    memset(&codec_, 0, sizeof(codec_));
+    codec_.codecType = kVideoCodecVP8;
+    codec_.width = kWidth;
+    codec_.height = kHeight;
+    codec_.maxFramerate = 30;
+    codec_.startBitrate = 1000;
+    codec_.numberOfSimulcastStreams = kNumStreams;
+    for (int i = 0; i < kNumStreams; ++i) {
+      const int scale = 1 << (kNumStreams - 1 - i);
+      codec_.simulcastStream[i].width = kWidth / scale;
+      codec_.simulcastStream[i].height = kHeight / scale;
+      codec_.simulcastStream[i].numberOfTemporalLayers = 1;
+      codec_.simulcastStream[i].maxBitrate = 200 * (i + 1);
+    }
+    encoder_.RegisterEncodeCompleteCallback(&recorder_);
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_.InitEncode(&codec_, 4, 1200));
+    ASSERT_EQ(static_cast<size_t>(kNumStreams), stream_encoders.size());
+
+    input_.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+    memset(input_.buffer(kYPlane), 0x80, input_.allocated_size(kYPlane));
+    memset(input_.buffer(kUPlane), 0x80, input_.allocated_size(kUPlane));
+    memset(input_.buffer(kVPlane), 0x80, input_.allocated_size(kVPlane));
+    input_.set_timestamp(90000);
+  }
+
+  virtual void TearDown() {
+    // The stream encoders are owned by |encoder_|.
+    encoder_.Release();
+    stream_encoders.clear();
+  }
+
+  SimulcastEncoder encoder_;
+  EncodedImageRecorder recorder_;
+  VideoCodec codec_;
+  I420VideoFrame input_;
+};
+
+TEST_F(SimulcastEncoderTest, EncodesPyramidInParallelAndDeliversInOrder) {
+  // 200 + 400 kbps, and the remaining 400 kbps to the largest stream.
+  EXPECT_EQ(200u, stream_encoders[0]->bitrate_kbit_);
+  EXPECT_EQ(400u, stream_encoders[1]->bitrate_kbit_);
+  EXPECT_EQ(400u, stream_encoders[2]->bitrate_kbit_);
+
+  std::vector<VideoFrameType> frame_types(kNumStreams, kDeltaFrame);
+  frame_types[1] = kKeyFrame;
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_.Encode(input_, NULL, &frame_types));
+
+  ASSERT_EQ(static_cast<size_t>(kNumStreams), recorder_.images_.size());
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_EQ(i, recorder_.simulcast_idxs_[i]);
+    EXPECT_EQ(codec_.simulcastStream[i].width,
+              recorder_.images_[i]._encodedWidth);
+    EXPECT_EQ(codec_.simulcastStream[i].height,
+              recorder_.images_[i]._encodedHeight);
+    EXPECT_EQ(90000u, recorder_.images_[i]._timeStamp);
+    EXPECT_EQ(frame_types[i], stream_encoders[i]->frame_type_);
+  }
+  // The streams are shared out between the calling thread and the two
+  // threads of the pool.
+  std::set<uint32_t> thread_ids;
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_NE(0u, stream_encoders[i]->thread_id_);
+    thread_ids.insert(stream_encoders[i]->thread_id_);
+  }
+  EXPECT_LE(thread_ids.size(), 3u);
+}
+
+TEST_F(SimulcastEncoderTest, SkipsStreamsWithoutBitrate) {
+  // Only enough for the smallest stream.
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_.SetRates(150, 30));
+  EXPECT_EQ(150u, stream_encoders[0]->bitrate_kbit_);
+
+  std::vector<VideoFrameType> frame_types(kNumStreams, kDeltaFrame);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_.Encode(input_, NULL, &frame_types));
+  }
+  ASSERT_EQ(10u, recorder_.images_.size());
+  for (size_t i = 0; i < recorder_.images_.size(); ++i)
+    EXPECT_EQ(0, recorder_.simulcast_idxs_[i]);
+  EXPECT_EQ(10, stream_encoders[0]->num_encoded_);
+  EXPECT_EQ(0, stream_encoders[1]->num_encoded_);
+  EXPECT_EQ(0, stream_encoders[2]->num_encoded_);
+
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_.SetRates(700, 30));
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_.Encode(input_, NULL, &frame_types));
+  EXPECT_EQ(100u, stream_encoders[2]->bitrate_kbit_);
+  EXPECT_EQ(1, stream_encoders[2]->num_encoded_);
+  EXPECT_EQ(kWidth, stream_encoders[2]->frame_width_);
+}
+
+TEST_F(SimulcastEncoderTest, RejectsStreamsLargerThanTheNextOne) {
+  codec_.simulcastStream[0].width = kWidth;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_ERR_PARAMETER,
+            encoder_.InitEncode(&codec_, 4, 1200));
+}
+
+}  // namespace webrtc
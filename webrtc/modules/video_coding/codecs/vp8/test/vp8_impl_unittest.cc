@@ -269,4 +269,77 @@ TEST_F(TestVp8Impl, DISABLED_ON_ANDROID(DecodeWithACompleteKeyFrame)) {
   EXPECT_GT(I420PSNR(&input_frame_, &decoded_video_frame_), 36);
 }
 
+// Counts the encoded images of every simulcast stream.
+class SimulcastEncodeCounter : public webrtc::EncodedImageCallback {
+ public:
+  SimulcastEncodeCounter() {
+    memset(num_frames_, 0, sizeof(num_frames_));
+  }
+  virtual int Encoded(EncodedImage& encoded_image,
+                      const CodecSpecificInfo* codec_specific_info,
+                      const RTPFragmentationHeader* fragmentation) {
+    ++num_frames_[codec_specific_info->codecSpecific.VP8.simulcastIdx];
+    return 0;
+  }
+  int num_frames(int stream_idx) const { return num_frames_[stream_idx]; }
+
+ private:
+  int num_frames_[kMaxSimulcastStreams];
+};
+
+// Measures the encode time of three simulcast streams, to compare the
+// multi-resolution encoder with the encoder per stream.
+TEST(TestVp8Simulcast, DISABLED_EncodeTime) {
+  const int kNumStreams = 3;
+  const int kWidth = 1280;
+  const int kHeight = 720;
+  const int kNumFrames = 300;
+  VideoCodec codec;
+  memset(&codec, 0, sizeof(codec));
+  codec.codecType = kVideoCodecVP8;
+  codec.width = kWidth;
+  codec.height = kHeight;
+  codec.maxFramerate = 30;
+  codec.startBitrate = 2500;
+  codec.maxBitrate = 2500;
+  codec.qpMax = 56;
+  codec.numberOfSimulcastStreams = kNumStreams;
+  for (int i = 0; i < kNumStreams; ++i) {
+    SimulcastStream* stream = &codec.simulcastStream[i];
+    stream->width = kWidth >> (kNumStreams - 1 - i);
+    stream->height = kHeight >> (kNumStreams - 1 - i);
+    stream->numberOfTemporalLayers = 1;
+    stream->maxBitrate = 1500 >> (2 * (kNumStreams - 1 - i));
+    stream->qpMax = 56;
+  }
+  scoped_ptr<VideoEncoder> encoder(VP8Encoder::CreateSimulcast());
+  SimulcastEncodeCounter counter;
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->RegisterEncodeCompleteCallback(&counter));
+  ASSERT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->InitEncode(&codec, 4, 1440));
+
+  I420VideoFrame frame;
+  frame.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+  int64_t encode_time_ms = 0;
+  for (int n = 0; n < kNumFrames; ++n) {
+    // A gradient moving by a pixel per frame.
+    uint8_t* y = frame.buffer(kYPlane);
+    for (int row = 0; row < kHeight; ++row) {
+      for (int col = 0; col < kWidth; ++col)
+        y[row * kWidth + col] = static_cast<uint8_t>(row + col + n);
+    }
+    memset(frame.buffer(kUPlane), 128, frame.allocated_size(kUPlane));
+    memset(frame.buffer(kVPlane), 128, frame.allocated_size(kVPlane));
+    frame.set_timestamp(n * 90000 / codec.maxFramerate);
+    const int64_t start_ms = TickTime::MillisecondTimestamp();
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Encode(frame, NULL, NULL));
+    encode_time_ms += TickTime::MillisecondTimestamp() - start_ms;
+  }
+  for (int i = 0; i < kNumStreams; ++i)
+    EXPECT_GT(counter.num_frames(i), 0);
+  printf("Encoded %d frames of %d streams in %.2f ms per frame.\n",
+         kNumFrames, kNumStreams,
+         static_cast<double>(encode_time_ms) / kNumFrames);
+}
+
 }  // namespace webrtc
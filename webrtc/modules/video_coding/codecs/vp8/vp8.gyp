@@ -10,6 +10,11 @@
   'includes': [
     '../../../../build/common.gypi',
   ],
+  'variables': {
+    # Encode simulcast with the multi-resolution encoder of libvpx, which
+    # requires libvpx to be configured with --enable-multi-res-encoding.
+    'libvpx_multi_res_encoding%': 0,
+  },
   'targets': [
     {
       'target_name': 'webrtc_vp8',
@@ -25,12 +30,25 @@
             '<(DEPTH)/third_party/libvpx/libvpx.gyp:libvpx',
           ],
         }],
+        ['libvpx_multi_res_encoding==1', {
+          'defines': [
+            'WEBRTC_LIBVPX_MULTI_RES_ENCODING',
+          ],
+          'sources': [
+            'multi_res_encoder.cc',
+            'multi_res_encoder.h',
+          ],
+        }],
       ],
       'sources': [
+        'cpu_speed_controller.h',
+        'cpu_speed_controller.cc',
         'reference_picture_selection.h',
         'reference_picture_selection.cc',
         'include/vp8.h',
         'include/vp8_common_types.h',
+        'simulcast_encoder.cc',
+        'simulcast_encoder.h',
         'vp8_factory.cc',
         'vp8_impl.cc',
         'default_temporal_layers.cc',
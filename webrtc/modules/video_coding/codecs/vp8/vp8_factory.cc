@@ -9,6 +9,10 @@
  *
  */
 
+#if defined(WEBRTC_LIBVPX_MULTI_RES_ENCODING)
+#include "webrtc/modules/video_coding/codecs/vp8/multi_res_encoder.h"
+#endif
+#include "webrtc/modules/video_coding/codecs/vp8/simulcast_encoder.h"
 #include "webrtc/modules/video_coding/codecs/vp8/vp8_impl.h"
 
 namespace webrtc {
@@ -17,6 +21,18 @@ VP8Encoder* VP8Encoder::Create() {
   return new VP8EncoderImpl();
 }
 
+static VideoEncoder* CreateStreamEncoder() {
+  return new VP8EncoderImpl();
+}
+
+VP8Encoder* VP8Encoder::CreateSimulcast() {
+#if defined(WEBRTC_LIBVPX_MULTI_RES_ENCODING)
+  return new MultiResEncoder();
+#else
+  return new SimulcastEncoder(CreateStreamEncoder);
+#endif
+}
+
 VP8Decoder* VP8Decoder::Create() {
   return new VP8DecoderImpl();
 }
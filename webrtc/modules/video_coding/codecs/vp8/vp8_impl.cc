@@ -16,6 +16,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+
+#include <algorithm>
 #include <vector>
 
 #include "vpx/vpx_encoder.h"
@@ -34,15 +36,52 @@
 enum { kVp8ErrorPropagationTh = 30 };
 
 namespace webrtc {
+namespace {
+
+// Postprocessing is turned off when the average decode time exceeds this
+// fraction of the frame interval.
+const float kMaxDecodeTimeFractionForPostProc = 0.8f;
+// Frame rate used for the frame interval if the codec settings have none.
+const int kDefaultDecoderFramerate = 30;
+
+// Number of decoder threads for the given resolution. libvpx decodes
+// macroblock rows in parallel, so the work per thread is only significant
+// above VGA.
+int NumberOfDecoderThreads(int width, int height, int number_of_cores) {
+  if (width * height >= 1920 * 1080 && number_of_cores > 4) {
+    return 4;
+  } else if (width * height > 640 * 480 && number_of_cores >= 3) {
+    return 2;
+  }
+  return 1;
+}
+
+// Parses the resolution of a VP8 key frame (RFC 6386, section 9.1). Returns
+// false if |buffer| doesn't start with a key frame header.
+bool ParseKeyFrameResolution(const uint8_t* buffer, uint32_t length,
+                             int* width, int* height) {
+  if (buffer == NULL || length < 10 || (buffer[0] & 0x01) != 0 ||
+      buffer[3] != 0x9d || buffer[4] != 0x01 || buffer[5] != 0x2a) {
+    return false;
+  }
+  *width = (buffer[6] | (buffer[7] << 8)) & 0x3fff;
+  *height = (buffer[8] | (buffer[9] << 8)) & 0x3fff;
+  return true;
+}
+
+}  // namespace
 
 VP8EncoderImpl::VP8EncoderImpl()
     : encoded_image_(),
+      encoded_buffer_(NULL),
+      encoded_buffer_size_(0),
       encoded_complete_callback_(NULL),
       inited_(false),
       timestamp_(0),
       picture_id_(0),
       feedback_mode_(false),
       cpu_speed_(-6),  // default value
+      adapt_speed_(false),
       rc_max_intra_target_(0),
       token_partitions_(VP8_ONE_TOKENPARTITION),
       rps_(new ReferencePictureSelection),
@@ -61,10 +100,11 @@ VP8EncoderImpl::~VP8EncoderImpl() {
 }
 
 int VP8EncoderImpl::Release() {
-  if (encoded_image_._buffer != NULL) {
-    delete [] encoded_image_._buffer;
-    encoded_image_._buffer = NULL;
-  }
+  delete [] encoded_buffer_;
+  encoded_buffer_ = NULL;
+  encoded_buffer_size_ = 0;
+  encoded_image_._buffer = NULL;
+  encoded_image_._size = 0;
   if (encoder_ != NULL) {
     if (vpx_codec_destroy(encoder_)) {
       return WEBRTC_VIDEO_CODEC_MEMORY;
@@ -163,12 +203,7 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
   // random start 16 bits is enough.
   picture_id_ = static_cast<uint16_t>(rand()) & 0x7FFF;
 
-  // allocate memory for encoded image
-  if (encoded_image_._buffer != NULL) {
-    delete [] encoded_image_._buffer;
-  }
-  encoded_image_._size = CalcBufferSize(kI420, codec_.width, codec_.height);
-  encoded_image_._buffer = new uint8_t[encoded_image_._size];
+  // The buffer to gather the output in is only allocated when needed.
   encoded_image_._completeFrame = true;
 
   // Creating a wrapper to the image - setting image data to NULL. Actual
@@ -271,6 +306,19 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
   // and video quality
   cpu_speed_ = -12;
 #endif
+  adapt_speed_ = options.Get<VP8SpeedAdaptation>().enabled;
+  speed_controller_.Init(cpu_speed_);
+  token_partitions_ = VP8_ONE_TOKENPARTITION;
+  if (adapt_speed_) {
+    // Let the receiver decode with as many threads as the encoder uses.
+    if (config_->g_threads >= 8) {
+      token_partitions_ = VP8_EIGHT_TOKENPARTITION;
+    } else if (config_->g_threads >= 4) {
+      token_partitions_ = VP8_FOUR_TOKENPARTITION;
+    } else if (config_->g_threads >= 2) {
+      token_partitions_ = VP8_TWO_TOKENPARTITION;
+    }
+  }
   rps_->Init();
   return InitAndSetControlSettings(inst);
 }
@@ -357,12 +405,9 @@ int VP8EncoderImpl::Encode(const I420VideoFrame& input_image,
   int flags = temporal_layers_->EncodeFlags(input_image.timestamp());
 
   bool send_keyframe = (frame_type == kKeyFrame);
-  if (send_keyframe) {
-    // Key frame request from caller.
-    // Will update both golden and alt-ref.
-    flags = VPX_EFLAG_FORCE_KF;
-  } else if (feedback_mode_ && codec_specific_info) {
-    // Handle RPSI and SLI messages and set up the appropriate encode flags.
+  if (!send_keyframe && feedback_mode_ && codec_specific_info) {
+    // Handle RPSI, SLI and PLI messages and set up the appropriate encode
+    // flags.
     bool sendRefresh = false;
     if (codec_specific_info->codecType == kVideoCodecVP8) {
       if (codec_specific_info->codecSpecific.VP8.hasReceivedRPSI) {
@@ -372,9 +417,23 @@ int VP8EncoderImpl::Encode(const I420VideoFrame& input_image,
       if (codec_specific_info->codecSpecific.VP8.hasReceivedSLI) {
         sendRefresh = rps_->ReceivedSLI(input_image.timestamp());
       }
+      if (codec_specific_info->codecSpecific.VP8.hasReceivedPLI) {
+        // Fall back to a key frame if the receiver has no reference yet.
+        if (rps_->ReceivedPictureLoss(input_image.timestamp()))
+          sendRefresh = true;
+        else
+          send_keyframe = true;
+      }
+    }
+    if (!send_keyframe) {
+      flags = rps_->EncodeFlags(picture_id_, sendRefresh,
+                                input_image.timestamp());
     }
-    flags = rps_->EncodeFlags(picture_id_, sendRefresh,
-                              input_image.timestamp());
+  }
+  if (send_keyframe) {
+    // Key frame request from caller.
+    // Will update both golden and alt-ref.
+    flags = VPX_EFLAG_FORCE_KF;
   }
 
   // TODO(holmer): Ideally the duration should be the timestamp diff of this
@@ -384,11 +443,19 @@ int VP8EncoderImpl::Encode(const I420VideoFrame& input_image,
   // frame rate to calculate an average duration for now.
   assert(codec_.maxFramerate > 0);
   uint32_t duration = 90000 / codec_.maxFramerate;
+  const int64_t encode_start_us = TickTime::MicrosecondTimestamp();
   if (vpx_codec_encode(encoder_, raw_, timestamp_, duration, flags,
                        VPX_DL_REALTIME)) {
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   timestamp_ += duration;
+  if (adapt_speed_ &&
+      speed_controller_.FrameEncoded(
+          TickTime::MicrosecondTimestamp() - encode_start_us,
+          1000 / codec_.maxFramerate)) {
+    cpu_speed_ = speed_controller_.cpu_speed();
+    vpx_codec_control(encoder_, VP8E_SET_CPUUSED, cpu_speed_);
+  }
 
   return GetEncodedPartitions(input_image);
 }
@@ -434,32 +501,27 @@ void VP8EncoderImpl::PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
 
 int VP8EncoderImpl::GetEncodedPartitions(const I420VideoFrame& input_image) {
   vpx_codec_iter_t iter = NULL;
-  int part_idx = 0;
-  encoded_image_._length = 0;
+  const int max_partitions = (1 << token_partitions_) + 1;
+  const vpx_codec_cx_pkt_t* partitions[(1 << VP8_EIGHT_TOKENPARTITION) + 1];
+  int num_partitions = 0;
+  uint32_t length = 0;
+  // libvpx writes the partitions of a frame one after the other into its
+  // output buffer, which stays valid until the next frame is encoded, so
+  // normally the frame is handed on from there.
+  bool contiguous = true;
   encoded_image_._frameType = kDeltaFrame;
-  RTPFragmentationHeader frag_info;
-  frag_info.VerifyAndAllocateFragmentationHeader((1 << token_partitions_) + 1);
   CodecSpecificInfo codec_specific;
 
   const vpx_codec_cx_pkt_t *pkt = NULL;
   while ((pkt = vpx_codec_get_cx_data(encoder_, &iter)) != NULL) {
-    switch (pkt->kind) {
-      case VPX_CODEC_CX_FRAME_PKT: {
-        memcpy(&encoded_image_._buffer[encoded_image_._length],
-               pkt->data.frame.buf,
-               pkt->data.frame.sz);
-        frag_info.fragmentationOffset[part_idx] = encoded_image_._length;
-        frag_info.fragmentationLength[part_idx] =  pkt->data.frame.sz;
-        frag_info.fragmentationPlType[part_idx] = 0;  // not known here
-        frag_info.fragmentationTimeDiff[part_idx] = 0;
-        encoded_image_._length += pkt->data.frame.sz;
-        assert(encoded_image_._length <= encoded_image_._size);
-        ++part_idx;
-        break;
-      }
-      default: {
-        break;
+    if (pkt->kind == VPX_CODEC_CX_FRAME_PKT && num_partitions < max_partitions) {
+      if (num_partitions > 0 &&
+          pkt->data.frame.buf != static_cast<const uint8_t*>(
+              partitions[0]->data.frame.buf) + length) {
+        contiguous = false;
       }
+      partitions[num_partitions++] = pkt;
+      length += pkt->data.frame.sz;
     }
     // End of frame
     if ((pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT) == 0) {
@@ -472,15 +534,51 @@ int VP8EncoderImpl::GetEncodedPartitions(const I420VideoFrame& input_image) {
       break;
     }
   }
-  if (encoded_image_._length > 0) {
-    TRACE_COUNTER1("webrtc", "EncodedFrameSize", encoded_image_._length);
-    encoded_image_._timeStamp = input_image.timestamp();
-    encoded_image_.capture_time_ms_ = input_image.render_time_ms();
-    encoded_image_._encodedHeight = codec_.height;
-    encoded_image_._encodedWidth = codec_.width;
-    encoded_complete_callback_->Encoded(encoded_image_, &codec_specific,
-                                      &frag_info);
+  if (length == 0) {
+    return WEBRTC_VIDEO_CODEC_OK;
   }
+
+  if (contiguous) {
+    encoded_image_._buffer = static_cast<uint8_t*>(
+        partitions[0]->data.frame.buf);
+    encoded_image_._size = length;
+  } else {
+    if (length > encoded_buffer_size_) {
+      delete [] encoded_buffer_;
+      encoded_buffer_size_ = std::max<uint32_t>(
+          length, CalcBufferSize(kI420, codec_.width, codec_.height));
+      encoded_buffer_ = new uint8_t[encoded_buffer_size_];
+    }
+    uint32_t offset = 0;
+    for (int i = 0; i < num_partitions; ++i) {
+      memcpy(&encoded_buffer_[offset], partitions[i]->data.frame.buf,
+             partitions[i]->data.frame.sz);
+      offset += partitions[i]->data.frame.sz;
+    }
+    encoded_image_._buffer = encoded_buffer_;
+    encoded_image_._size = encoded_buffer_size_;
+  }
+  encoded_image_._length = length;
+
+  // The fragmentation header refers to the partitions in place.
+  RTPFragmentationHeader frag_info;
+  frag_info.VerifyAndAllocateFragmentationHeader(num_partitions);
+  uint32_t offset = 0;
+  for (int i = 0; i < num_partitions; ++i) {
+    frag_info.fragmentationOffset[i] = offset;
+    frag_info.fragmentationLength[i] = partitions[i]->data.frame.sz;
+    frag_info.fragmentationPlType[i] = 0;  // not known here
+    frag_info.fragmentationTimeDiff[i] = 0;
+    offset += partitions[i]->data.frame.sz;
+  }
+
+  TRACE_COUNTER1("webrtc", "EncodedFrameSize", encoded_image_._length);
+  encoded_image_._timeStamp = input_image.timestamp();
+  encoded_image_.capture_time_ms_ = input_image.render_time_ms();
+  encoded_image_._encodedHeight = codec_.height;
+  encoded_image_._encodedWidth = codec_.width;
+  encoded_complete_callback_->Encoded(encoded_image_, &codec_specific,
+                                      &frag_info);
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -505,7 +603,11 @@ VP8DecoderImpl::VP8DecoderImpl()
       ref_frame_(NULL),
       propagation_cnt_(-1),
       mfqe_enabled_(false),
-      key_frame_required_(true) {
+      key_frame_required_(true),
+      number_of_cores_(1),
+      decoder_threads_(1),
+      postproc_enabled_(false),
+      avg_decode_time_ms_(0.0f) {
   memset(&codec_, 0, sizeof(codec_));
 }
 
@@ -518,7 +620,7 @@ int VP8DecoderImpl::Reset() {
   if (!inited_) {
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
   }
-  InitDecode(&codec_, 1);
+  InitDecode(&codec_, number_of_cores_);
   propagation_cnt_ = -1;
   mfqe_enabled_ = false;
   return WEBRTC_VIDEO_CODEC_OK;
@@ -538,9 +640,11 @@ int VP8DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   if (inst->codecType == kVideoCodecVP8) {
     feedback_mode_ = inst->codecSpecific.VP8.feedbackModeOn;
   }
+  number_of_cores_ = number_of_cores;
+  decoder_threads_ = NumberOfDecoderThreads(inst->width, inst->height,
+                                            number_of_cores);
   vpx_codec_dec_cfg_t  cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
+  cfg.threads = decoder_threads_;
   cfg.h = cfg.w = 0;  // set after decode
 
   vpx_codec_flags_t flags = 0;
@@ -564,7 +668,10 @@ int VP8DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   // Strength of deblocking filter. Valid range:[0,16]
   ppcfg.deblocking_level = 3;
   vpx_codec_control(decoder_, VP8_SET_POSTPROC, &ppcfg);
+  postproc_enabled_ = true;
 #endif
+  mfqe_enabled_ = false;
+  avg_decode_time_ms_ = 0.0f;
 
   if (&codec_ != inst) {
     // Save VideoCodec instance for later; mainly for duplicating the decoder.
@@ -605,8 +712,24 @@ int VP8DecoderImpl::Decode(const EncodedImage& input_image,
   }
 #endif
 
+  // The number of decoder threads can only be changed by recreating the
+  // decoder, which is done on the first key frame of a new resolution.
+  int width = 0;
+  int height = 0;
+  if (input_image._frameType == kKeyFrame && input_image._completeFrame &&
+      ParseKeyFrameResolution(input_image._buffer, input_image._length,
+                              &width, &height) &&
+      NumberOfDecoderThreads(width, height, number_of_cores_) !=
+          decoder_threads_) {
+    codec_.width = width;
+    codec_.height = height;
+    int ret = InitDecode(&codec_, number_of_cores_);
+    if (ret != WEBRTC_VIDEO_CODEC_OK)
+      return ret;
+  }
+
 #ifndef WEBRTC_ARCH_ARM
-  if (!mfqe_enabled_ && codec_specific_info &&
+  if (postproc_enabled_ && !mfqe_enabled_ && codec_specific_info &&
       codec_specific_info->codecSpecific.VP8.temporalIdx > 0) {
     // Enable MFQE if we are receiving layers.
     // temporalIdx is set in the jitter buffer according to what the RTP
@@ -648,6 +771,7 @@ int VP8DecoderImpl::Decode(const EncodedImage& input_image,
   vpx_codec_iter_t iter = NULL;
   vpx_image_t* img;
   int ret;
+  const int64_t decode_start_ms = TickTime::MillisecondTimestamp();
 
   // Check for missing frames.
   if (missing_frames) {
@@ -713,6 +837,7 @@ int VP8DecoderImpl::Decode(const EncodedImage& input_image,
   }
 
   img = vpx_codec_get_frame(decoder_, &iter);
+  UpdatePostProc(TickTime::MillisecondTimestamp() - decode_start_ms);
   ret = ReturnFrame(img, input_image._timeStamp, input_image.ntp_time_ms_);
   if (ret != 0) {
     // Reset to avoid requesting key frames too often.
@@ -770,6 +895,27 @@ int VP8DecoderImpl::Decode(const EncodedImage& input_image,
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void VP8DecoderImpl::UpdatePostProc(int64_t decode_time_ms) {
+#ifndef WEBRTC_ARCH_ARM
+  if (!postproc_enabled_)
+    return;
+  const float kAlpha = 0.95f;
+  avg_decode_time_ms_ = kAlpha * avg_decode_time_ms_ +
+      (1.0f - kAlpha) * decode_time_ms;
+  const int framerate = codec_.maxFramerate > 0 ? codec_.maxFramerate :
+      kDefaultDecoderFramerate;
+  if (avg_decode_time_ms_ >
+      kMaxDecodeTimeFractionForPostProc * 1000.0f / framerate) {
+    // Postprocessing stays off until the decoder is initialized again.
+    vp8_postproc_cfg_t  ppcfg;
+    ppcfg.post_proc_flag = 0;
+    ppcfg.deblocking_level = 0;
+    vpx_codec_control(decoder_, VP8_SET_POSTPROC, &ppcfg);
+    postproc_enabled_ = false;
+  }
+#endif
+}
+
 int VP8DecoderImpl::DecodePartitions(
     const EncodedImage& input_image,
     const RTPFragmentationHeader* fragmentation) {
@@ -869,7 +1015,7 @@ VideoDecoder* VP8DecoderImpl::Copy() {
   VP8DecoderImpl *copy = new VP8DecoderImpl;
 
   // Initialize the new decoder
-  if (copy->InitDecode(&codec_, 1) != WEBRTC_VIDEO_CODEC_OK) {
+  if (copy->InitDecode(&codec_, number_of_cores_) != WEBRTC_VIDEO_CODEC_OK) {
     delete copy;
     return NULL;
   }
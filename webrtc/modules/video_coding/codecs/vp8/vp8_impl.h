@@ -13,6 +13,7 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_IMPL_H_
 #define WEBRTC_MODULES_VIDEO_CODING_CODECS_VP8_IMPL_H_
 
+#include "webrtc/modules/video_coding/codecs/vp8/cpu_speed_controller.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 
 // VPX forward declaration
@@ -124,7 +125,12 @@ class VP8EncoderImpl : public VP8Encoder {
   //                            percentage of the per frame bandwidth
   uint32_t MaxIntraTarget(uint32_t optimal_buffer_size);
 
+  // Points into the output of libvpx when the partitions of a frame are
+  // contiguous there, or else into |encoded_buffer_|.
   EncodedImage encoded_image_;
+  // Only used when the output of libvpx has to be gathered.
+  uint8_t* encoded_buffer_;
+  uint32_t encoded_buffer_size_;
   EncodedImageCallback* encoded_complete_callback_;
   VideoCodec codec_;
   bool inited_;
@@ -132,6 +138,8 @@ class VP8EncoderImpl : public VP8Encoder {
   uint16_t picture_id_;
   bool feedback_mode_;
   int cpu_speed_;
+  bool adapt_speed_;
+  CpuSpeedController speed_controller_;
   uint32_t rc_max_intra_target_;
   int token_partitions_;
   ReferencePictureSelection* rps_;
@@ -218,6 +226,10 @@ class VP8DecoderImpl : public VP8Decoder {
                   uint32_t timeStamp,
                   int64_t ntp_time_ms);
 
+  // Updates the average decode time and turns postprocessing off if it's
+  // too slow for the frame rate.
+  void UpdatePostProc(int64_t decode_time_ms);
+
   I420VideoFrame decoded_image_;
   DecodedImageCallback* decode_complete_callback_;
   bool inited_;
@@ -230,6 +242,10 @@ class VP8DecoderImpl : public VP8Decoder {
   int propagation_cnt_;
   bool mfqe_enabled_;
   bool key_frame_required_;
+  int number_of_cores_;
+  int decoder_threads_;
+  bool postproc_enabled_;
+  float avg_decode_time_ms_;
 };  // end of VP8Decoder class
 }  // namespace webrtc
 
@@ -269,7 +269,8 @@ public:
     // Add one raw video frame to the encoder. This function does all the necessary
     // processing, then decides what frame type to encode, or if the frame should be
     // dropped. If the frame should be encoded it passes the frame to the encoder
-    // before it returns.
+    // before it returns. Frames with a native handle are only accepted by an
+    // external encoder supporting them.
     //
     // Input:
     //      - videoFrame        : Video frame to encode.
@@ -303,6 +304,18 @@ public:
     // Sent frame counters
     virtual int32_t SentFrameCount(VCMFrameCount& frameCount) const = 0;
 
+    // Informs the frame dropper of how long the oldest packet has waited in
+    // the pacer queue. Data which is queued but not yet sent counts toward the
+    // target bit rate, so frames are dropped before the rate is overshot.
+    //
+    // Input:
+    //      - queue_ms          : The pacer queue delay in ms.
+    virtual void SetPacerQueueDelay(int queue_ms) = 0;
+
+    // Returns the number of frames dropped by the frame dropper to keep to the
+    // target bit rate.
+    virtual uint32_t FramesDroppedByRateControl() const = 0;
+
     /*
     *   Receiver
     */
@@ -419,6 +432,12 @@ public:
     //                     < 0,         on error.
     virtual int32_t Decode(uint16_t maxWaitTimeMs = 200) = 0;
 
+    // Returns the time until Decode() can pass the oldest complete frame in
+    // the jitter buffer to the decoder, i.e. until the frame is due when the
+    // decoder doesn't do the render timing itself. Returns 0 if a frame can
+    // be decoded now and -1 if there is no complete frame.
+    virtual int TimeUntilNextFrameMs() = 0;
+
     // Registers a callback which conveys the size of the render buffer.
     virtual int RegisterRenderBufferSizeCallback(
         VCMRenderBufferSizeCallback* callback) = 0;
@@ -513,6 +532,11 @@ public:
     // NACKed will be counted.
     virtual uint32_t DiscardedPackets() const = 0;
 
+    // Returns the number of frames dropped without being decoded since the
+    // decoder had fallen behind and they would have been rendered late. Only
+    // frames which no other frame depends on are dropped.
+    virtual uint32_t FramesDroppedByTiming() const = 0;
+
 
     // Robustness APIs
 
@@ -241,7 +241,7 @@ bool VCMCodecDataBase::SetSendCodec(
     ptr_encoder_ = new VCMGenericEncoder(*external_encoder_, internal_source_);
     current_enc_is_external_ = true;
   } else {
-    ptr_encoder_ = CreateEncoder(send_codec->codecType);
+    ptr_encoder_ = CreateEncoder(*send_codec);
     current_enc_is_external_ = false;
     if (!ptr_encoder_) {
       return false;
@@ -611,10 +611,12 @@ VCMGenericDecoder* VCMCodecDataBase::CreateAndInitDecoder(
 }
 
 VCMGenericEncoder* VCMCodecDataBase::CreateEncoder(
-  const VideoCodecType type) const {
-  switch (type) {
+  const VideoCodec& send_codec) const {
+  switch (send_codec.codecType) {
 #ifdef VIDEOCODEC_VP8
     case kVideoCodecVP8:
+      if (send_codec.numberOfSimulcastStreams > 1)
+        return new VCMGenericEncoder(*(VP8Encoder::CreateSimulcast()));
       return new VCMGenericEncoder(*(VP8Encoder::Create()));
 #endif
 #ifdef VIDEOCODEC_I420
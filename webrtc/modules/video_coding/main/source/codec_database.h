@@ -161,8 +161,9 @@ class VCMCodecDataBase {
   // Determines whether a new codec has to be created or not.
   // Checks every setting apart from maxFramerate and startBitrate.
   bool RequiresEncoderReset(const VideoCodec& send_codec);
-  // Create an internal encoder given a codec type.
-  VCMGenericEncoder* CreateEncoder(const VideoCodecType type) const;
+  // Create an internal encoder for the codec type and simulcast streams of
+  // |send_codec|.
+  VCMGenericEncoder* CreateEncoder(const VideoCodec& send_codec) const;
 
   void DeleteEncoder();
 
@@ -18,6 +18,16 @@ namespace webrtc
 // The first kIgnoredSampleCount samples will be ignored.
 static const int32_t kIgnoredSampleCount = 5;
 
+// The filter factor of the decode cost filters.
+static const float kDecodeCostAlpha = 0.9f;
+
+VCMDecodeCost::VCMDecodeCost()
+:
+decodeTimeMs(kDecodeCostAlpha),
+sizeBytes(kDecodeCostAlpha)
+{
+}
+
 VCMCodecTimer::VCMCodecTimer()
 :
 _filteredMax(0),
@@ -28,9 +38,19 @@ _history()
     Reset();
 }
 
-int32_t VCMCodecTimer::StopTimer(int64_t startTimeMs, int64_t nowMs)
+int32_t VCMCodecTimer::StopTimer(int64_t startTimeMs,
+                                 int64_t nowMs,
+                                 FrameType frameType,
+                                 uint32_t sizeBytes)
 {
     const int32_t timeDiff = static_cast<int32_t>(nowMs - startTimeMs);
+    if (_ignoredSampleCount >= kIgnoredSampleCount && sizeBytes > 0)
+    {
+        VCMDecodeCost& cost =
+            frameType == kVideoFrameKey ? _keyFrameCost : _deltaFrameCost;
+        cost.decodeTimeMs.Apply(1.0f, static_cast<float>(timeDiff));
+        cost.sizeBytes.Apply(1.0f, static_cast<float>(sizeBytes));
+    }
     MaxFilter(timeDiff, nowMs);
     return timeDiff;
 }
@@ -45,6 +65,10 @@ void VCMCodecTimer::Reset()
         _history[i].shortMax = 0;
         _history[i].timeMs = -1;
     }
+    _keyFrameCost.decodeTimeMs.Reset(kDecodeCostAlpha);
+    _keyFrameCost.sizeBytes.Reset(kDecodeCostAlpha);
+    _deltaFrameCost.decodeTimeMs.Reset(kDecodeCostAlpha);
+    _deltaFrameCost.sizeBytes.Reset(kDecodeCostAlpha);
 }
 
 // Update the max-value filter
@@ -133,4 +157,22 @@ int32_t VCMCodecTimer::RequiredDecodeTimeMs(FrameType /*frameType*/) const
     return _filteredMax;
 }
 
+int32_t VCMCodecTimer::PredictDecodeTimeMs(FrameType frameType,
+                                           uint32_t sizeBytes) const
+{
+    const VCMDecodeCost& cost =
+        frameType == kVideoFrameKey ? _keyFrameCost : _deltaFrameCost;
+    const float meanTimeMs = cost.decodeTimeMs.filtered();
+    const float meanSizeBytes = cost.sizeBytes.filtered();
+    if (meanTimeMs == rtc::ExpFilter::kValueUndefined || meanSizeBytes <= 0)
+    {
+        return _filteredMax;
+    }
+    // Part of the decode time depends on the resolution rather than on the
+    // amount of data, so only half of the mean is scaled with the size.
+    const float predictedMs =
+        meanTimeMs * (0.5f + 0.5f * sizeBytes / meanSizeBytes);
+    return static_cast<int32_t>(predictedMs + 0.5f);
+}
+
 }
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_CODEC_TIMER_H_
 #define WEBRTC_MODULES_VIDEO_CODING_CODEC_TIMER_H_
 
+#include "webrtc/base/exp_filter.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/typedefs.h"
 
@@ -30,13 +31,26 @@ public:
     int64_t     timeMs;
 };
 
+// The filtered decode time and size of the frames of one frame type.
+struct VCMDecodeCost
+{
+    VCMDecodeCost();
+
+    rtc::ExpFilter decodeTimeMs;
+    rtc::ExpFilter sizeBytes;
+};
+
 class VCMCodecTimer
 {
 public:
     VCMCodecTimer();
 
-    // Updates and returns the max filtered decode time.
-    int32_t StopTimer(int64_t startTimeMs, int64_t nowMs);
+    // Updates the max filtered decode time, and the decode cost of
+    // |frameType| frames with a frame of |sizeBytes|. Returns the decode time.
+    int32_t StopTimer(int64_t startTimeMs,
+                      int64_t nowMs,
+                      FrameType frameType,
+                      uint32_t sizeBytes);
 
     // Empty the list of timers.
     void Reset();
@@ -44,6 +58,11 @@ public:
     // Get the required decode time in ms.
     int32_t RequiredDecodeTimeMs(FrameType frameType) const;
 
+    // Predicts the time needed to decode a |frameType| frame of |sizeBytes|
+    // from the frames of the same type decoded so far. Falls back to the max
+    // filtered decode time until such a frame has been decoded.
+    int32_t PredictDecodeTimeMs(FrameType frameType, uint32_t sizeBytes) const;
+
 private:
     void UpdateMaxHistory(int32_t decodeTime, int64_t now);
     void MaxFilter(int32_t newTime, int64_t nowMs);
@@ -54,6 +73,8 @@ private:
     int32_t                     _ignoredSampleCount;
     int32_t                     _shortMax;
     VCMShortMaxSample           _history[MAX_HISTORY_SIZE];
+    VCMDecodeCost               _keyFrameCost;
+    VCMDecodeCost               _deltaFrameCost;
 
 };
 
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/main/source/encoded_buffer_pool.h"
+
+#include <assert.h>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+
+// The smallest class holds most delta frames.
+const int kMinClassBits = 15;
+const int kMaxClassBits = 22;
+const int kNumClasses = kMaxClassBits - kMinClassBits + 1;
+
+// The idle buffers kept per class. Classes larger than this keep none, so
+// that the memory of a key frame is given back once it's decoded.
+const uint32_t kMaxIdleBytesPerClass = 1 << 20;
+
+}  // namespace
+
+// static
+VCMEncodedBufferPool* VCMEncodedBufferPool::Get() {
+  static VCMEncodedBufferPool* const pool =
+      GetStaticInstance<VCMEncodedBufferPool>(kAddRef);
+  return pool;
+}
+
+// static
+VCMEncodedBufferPool* VCMEncodedBufferPool::CreateInstance() {
+  return new VCMEncodedBufferPool();
+}
+
+VCMEncodedBufferPool::VCMEncodedBufferPool()
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      idle_buffers_(kNumClasses) {
+}
+
+VCMEncodedBufferPool::~VCMEncodedBufferPool() {
+  for (size_t i = 0; i < idle_buffers_.size(); ++i) {
+    for (size_t j = 0; j < idle_buffers_[i].size(); ++j)
+      delete [] idle_buffers_[i][j];
+  }
+}
+
+uint8_t* VCMEncodedBufferPool::Allocate(uint32_t min_size, uint32_t* size) {
+  const int size_class = SizeClass(min_size);
+  *size = size_class < 0 ? min_size : ClassSize(size_class);
+  {
+    CriticalSectionScoped cs(crit_.get());
+    ++stats_.allocations;
+    stats_.bytes_in_use += *size;
+    if (size_class >= 0 && !idle_buffers_[size_class].empty()) {
+      uint8_t* buffer = idle_buffers_[size_class].back();
+      idle_buffers_[size_class].pop_back();
+      ++stats_.hits;
+      stats_.bytes_idle -= *size;
+      return buffer;
+    }
+    if (stats_.bytes_in_use + stats_.bytes_idle > stats_.peak_bytes)
+      stats_.peak_bytes = stats_.bytes_in_use + stats_.bytes_idle;
+  }
+  return new uint8_t[*size];
+}
+
+void VCMEncodedBufferPool::Release(uint8_t* buffer, uint32_t size) {
+  if (!buffer)
+    return;
+  const int size_class = SizeClass(size);
+  {
+    CriticalSectionScoped cs(crit_.get());
+    assert(stats_.bytes_in_use >= size);
+    stats_.bytes_in_use -= size;
+    if (size_class >= 0 && ClassSize(size_class) == size &&
+        (idle_buffers_[size_class].size() + 1) * size <=
+            kMaxIdleBytesPerClass) {
+      idle_buffers_[size_class].push_back(buffer);
+      stats_.bytes_idle += size;
+      return;
+    }
+  }
+  delete [] buffer;
+}
+
+VCMEncodedBufferPool::Stats VCMEncodedBufferPool::GetStats() const {
+  CriticalSectionScoped cs(crit_.get());
+  return stats_;
+}
+
+// static
+int VCMEncodedBufferPool::SizeClass(uint32_t size) {
+  if (size > kMaxPooledSize)
+    return -1;
+  int size_class = 0;
+  while (ClassSize(size_class) < size)
+    ++size_class;
+  return size_class;
+}
+
+// static
+uint32_t VCMEncodedBufferPool::ClassSize(int size_class) {
+  return 1u << (kMinClassBits + size_class);
+}
+
+}  // namespace webrtc
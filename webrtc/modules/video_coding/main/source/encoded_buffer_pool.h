@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_ENCODED_BUFFER_POOL_H_
+#define WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_ENCODED_BUFFER_POOL_H_
+
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/static_instance.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+
+// Storage for the data of encoded frames, shared by the jitter buffers and
+// decoders of all receive streams in the process. The buffers come in
+// power-of-two size classes; a released buffer is kept for the next frame of
+// its class as long as the idle buffers of the class stay under a budget, so
+// a large key frame doesn't leave its memory behind in every frame buffer.
+class VCMEncodedBufferPool {
+ public:
+  struct Stats {
+    Stats()
+        : allocations(0),
+          hits(0),
+          bytes_in_use(0),
+          bytes_idle(0),
+          peak_bytes(0) {}
+
+    // Buffers handed out, and how many of those were idle buffers.
+    int64_t allocations;
+    int64_t hits;
+    // Bytes lent out and bytes kept for reuse.
+    uint32_t bytes_in_use;
+    uint32_t bytes_idle;
+    // The most bytes held by the pool at a time, lent out or idle.
+    uint32_t peak_bytes;
+  };
+
+  // Buffers larger than this are not pooled.
+  static const uint32_t kMaxPooledSize = 1 << 22;
+
+  static VCMEncodedBufferPool* Get();
+
+  // Returns a buffer of at least |min_size| bytes and sets |size| to its
+  // actual size, which is what has to be given to Release().
+  uint8_t* Allocate(uint32_t min_size, uint32_t* size);
+  void Release(uint8_t* buffer, uint32_t size);
+
+  Stats GetStats() const;
+
+ private:
+  friend VCMEncodedBufferPool* GetStaticInstance<VCMEncodedBufferPool>(
+      CountOperation count_operation);
+
+  static VCMEncodedBufferPool* CreateInstance();
+
+  VCMEncodedBufferPool();
+  ~VCMEncodedBufferPool();
+
+  // Returns the size class of |size|, or -1 if it's larger than
+  // kMaxPooledSize.
+  static int SizeClass(uint32_t size);
+  static uint32_t ClassSize(int size_class);
+
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  std::vector<std::vector<uint8_t*> > idle_buffers_;
+  Stats stats_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_ENCODED_BUFFER_POOL_H_
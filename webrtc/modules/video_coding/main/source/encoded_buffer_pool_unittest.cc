@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/main/source/encoded_buffer_pool.h"
+#include "webrtc/modules/video_coding/main/source/frame_buffer.h"
+#include "webrtc/modules/video_coding/main/source/packet.h"
+
+namespace webrtc {
+
+// The pool is shared by the whole process, so the tests only look at how the
+// stats change.
+
+TEST(TestEncodedBufferPool, RoundsUpToSizeClass) {
+  VCMEncodedBufferPool* pool = VCMEncodedBufferPool::Get();
+  uint32_t small_size = 0;
+  uint8_t* small_buffer = pool->Allocate(1000, &small_size);
+  EXPECT_EQ(1u << 15, small_size);
+  uint32_t large_size = 0;
+  uint8_t* large_buffer = pool->Allocate(40000, &large_size);
+  EXPECT_EQ(1u << 16, large_size);
+  uint32_t oversized_size = 0;
+  uint8_t* oversized_buffer =
+      pool->Allocate(VCMEncodedBufferPool::kMaxPooledSize + 1,
+                     &oversized_size);
+  EXPECT_EQ(VCMEncodedBufferPool::kMaxPooledSize + 1, oversized_size);
+  pool->Release(small_buffer, small_size);
+  pool->Release(large_buffer, large_size);
+  pool->Release(oversized_buffer, oversized_size);
+}
+
+TEST(TestEncodedBufferPool, ReusesReleasedBuffer) {
+  VCMEncodedBufferPool* pool = VCMEncodedBufferPool::Get();
+  uint32_t size = 0;
+  uint8_t* buffer = pool->Allocate(20000, &size);
+  pool->Release(buffer, size);
+
+  const VCMEncodedBufferPool::Stats before = pool->GetStats();
+  uint32_t reused_size = 0;
+  EXPECT_EQ(buffer, pool->Allocate(size, &reused_size));
+  EXPECT_EQ(size, reused_size);
+  const VCMEncodedBufferPool::Stats after = pool->GetStats();
+  EXPECT_EQ(before.allocations + 1, after.allocations);
+  EXPECT_EQ(before.hits + 1, after.hits);
+  EXPECT_EQ(before.bytes_in_use + size, after.bytes_in_use);
+  EXPECT_EQ(before.bytes_idle - size, after.bytes_idle);
+  pool->Release(buffer, size);
+}
+
+TEST(TestEncodedBufferPool, DoesNotKeepLargeBuffers) {
+  VCMEncodedBufferPool* pool = VCMEncodedBufferPool::Get();
+  const VCMEncodedBufferPool::Stats before = pool->GetStats();
+  uint32_t size = 0;
+  uint8_t* buffer = pool->Allocate(3000000, &size);
+  EXPECT_EQ(1u << 22, size);
+  EXPECT_LE(before.bytes_in_use + before.bytes_idle + size,
+            pool->GetStats().peak_bytes);
+  pool->Release(buffer, size);
+
+  const VCMEncodedBufferPool::Stats after = pool->GetStats();
+  EXPECT_EQ(before.bytes_in_use, after.bytes_in_use);
+  EXPECT_EQ(before.bytes_idle, after.bytes_idle);
+  EXPECT_EQ(before.hits, after.hits);
+}
+
+TEST(TestEncodedBufferPool, FrameBufferReturnsStorageOnReset) {
+  VCMEncodedBufferPool* pool = VCMEncodedBufferPool::Get();
+  const VCMEncodedBufferPool::Stats before = pool->GetStats();
+
+  uint8_t data[1200];
+  memset(data, 0, sizeof(data));
+  VCMPacket packet;
+  packet.frameType = kVideoFrameKey;
+  packet.isFirstPacket = true;
+  packet.markerBit = true;
+  packet.dataPtr = data;
+  packet.sizeBytes = sizeof(data);
+  packet.codec = kVideoCodecVP8;
+  FrameData frame_data;
+  frame_data.rtt_ms = 0;
+  frame_data.rolling_average_packets_per_frame = -1;
+
+  VCMFrameBuffer frame;
+  EXPECT_EQ(kCompleteSession,
+            frame.InsertPacket(packet, 0, kNoErrors, frame_data));
+  EXPECT_LT(before.bytes_in_use, pool->GetStats().bytes_in_use);
+
+  frame.Reset();
+  EXPECT_EQ(before.bytes_in_use, pool->GetStats().bytes_in_use);
+}
+
+}  // namespace webrtc
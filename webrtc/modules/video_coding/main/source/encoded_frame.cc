@@ -9,6 +9,7 @@
  */
 
 #include "webrtc/modules/video_coding/main/interface/video_coding_defines.h"
+#include "webrtc/modules/video_coding/main/source/encoded_buffer_pool.h"
 #include "webrtc/modules/video_coding/main/source/encoded_frame.h"
 #include "webrtc/modules/video_coding/main/source/generic_encoder.h"
 #include "webrtc/modules/video_coding/main/source/jitter_buffer_common.h"
@@ -19,6 +20,7 @@ VCMEncodedFrame::VCMEncodedFrame()
 :
 webrtc::EncodedImage(),
 _renderTimeMs(-1),
+_decodeOnly(false),
 _payloadType(0),
 _missingFrame(false),
 _codec(kVideoCodecUnknown),
@@ -31,6 +33,7 @@ VCMEncodedFrame::VCMEncodedFrame(const webrtc::EncodedImage& rhs)
 :
 webrtc::EncodedImage(rhs),
 _renderTimeMs(-1),
+_decodeOnly(false),
 _payloadType(0),
 _missingFrame(false),
 _codec(kVideoCodecUnknown),
@@ -51,6 +54,7 @@ VCMEncodedFrame::VCMEncodedFrame(const VCMEncodedFrame& rhs)
   :
     webrtc::EncodedImage(rhs),
     _renderTimeMs(rhs._renderTimeMs),
+    _decodeOnly(rhs._decodeOnly),
     _payloadType(rhs._payloadType),
     _missingFrame(rhs._missingFrame),
     _codecSpecificInfo(rhs._codecSpecificInfo),
@@ -78,14 +82,16 @@ void VCMEncodedFrame::Free()
     Reset();
     if (_buffer != NULL)
     {
-        delete [] _buffer;
+        VCMEncodedBufferPool::Get()->Release(_buffer, _size);
         _buffer = NULL;
+        _size = 0;
     }
 }
 
 void VCMEncodedFrame::Reset()
 {
     _renderTimeMs = -1;
+    _decodeOnly = false;
     _timeStamp = 0;
     _payloadType = 0;
     _frameType = kDeltaFrame;
@@ -150,15 +156,17 @@ void VCMEncodedFrame::VerifyAndAllocate(const uint32_t minimumSize)
     if(minimumSize > _size)
     {
         // create buffer of sufficient size
-        uint8_t* newBuffer = new uint8_t[minimumSize];
+        VCMEncodedBufferPool* pool = VCMEncodedBufferPool::Get();
+        uint32_t newSize = 0;
+        uint8_t* newBuffer = pool->Allocate(minimumSize, &newSize);
         if(_buffer)
         {
             // copy old data
             memcpy(newBuffer, _buffer, _size);
-            delete [] _buffer;
+            pool->Release(_buffer, _size);
         }
         _buffer = newBuffer;
-        _size = minimumSize;
+        _size = newSize;
     }
 }
 
@@ -31,13 +31,19 @@ public:
 
     ~VCMEncodedFrame();
     /**
-    *   Delete VideoFrame and resets members to zero
+    *   Delete VideoFrame and resets members to zero, returning the buffer to
+    *   the pool
     */
     void Free();
     /**
     *   Set render time in milliseconds
     */
     void SetRenderTime(const int64_t renderTimeMs) {_renderTimeMs = renderTimeMs;}
+    /**
+    *   Set if the frame is only decoded, as a reference for later frames,
+    *   without rendering it
+    */
+    void SetDecodeOnly(bool decodeOnly) {_decodeOnly = decodeOnly;}
 
     /**
     *   Set the encoded frame size
@@ -66,6 +72,10 @@ public:
     */
     int64_t RenderTimeMs() const {return _renderTimeMs;}
     /**
+    *   True if the decoded frame should not be rendered
+    */
+    bool DecodeOnly() const {return _decodeOnly;}
+    /**
     *   Get frame type
     */
     webrtc::FrameType FrameType() const {return ConvertFrameType(_frameType);}
@@ -101,8 +111,8 @@ protected:
     /**
     * Verifies that current allocated buffer size is larger than or equal to the input size.
     * If the current buffer size is smaller, a new allocation is made and the old buffer data
-    * is copied to the new buffer.
-    * Buffer size is updated to minimumSize.
+    * is copied to the new buffer. The buffers come from VCMEncodedBufferPool.
+    * Buffer size is updated to at least minimumSize.
     */
     void VerifyAndAllocate(const uint32_t minimumSize);
 
@@ -111,6 +121,7 @@ protected:
     void CopyCodecSpecific(const RTPVideoHeader* header);
 
     int64_t                 _renderTimeMs;
+    bool                    _decodeOnly;
     uint8_t                 _payloadType;
     bool                          _missingFrame;
     CodecSpecificInfo             _codecSpecificInfo;
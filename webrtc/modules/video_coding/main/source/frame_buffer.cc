@@ -105,8 +105,8 @@ VCMFrameBuffer::InsertPacket(const VCMPacket& packet,
         }
     }
 
-    uint32_t requiredSizeBytes = Length() + packet.sizeBytes +
-                   (packet.insertStartCode ? kH264StartCodeLengthBytes : 0);
+    uint32_t requiredSizeBytes = Length() +
+                                 VCMSessionInfo::BufferLength(packet);
     if (requiredSizeBytes >= _size) {
         const uint8_t* prevBuffer = _buffer;
         const uint32_t increments = requiredSizeBytes /
@@ -196,7 +196,8 @@ VCMFrameBuffer::Reset() {
     _nackCount = 0;
     _latestPacketTimeMs = -1;
     _state = kStateEmpty;
-    VCMEncodedFrame::Reset();
+    // Hand the buffer back, so that a free frame holds no memory.
+    VCMEncodedFrame::Free();
 }
 
 // Set state of frame
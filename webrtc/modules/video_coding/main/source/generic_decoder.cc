@@ -13,6 +13,8 @@
 #include "webrtc/modules/video_coding/main/source/internal_defines.h"
 #include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
 
 namespace webrtc {
 
@@ -65,12 +67,20 @@ int32_t VCMDecodedFrameCallback::Decoded(I420VideoFrame& decodedImage)
       return WEBRTC_VIDEO_CODEC_OK;
     }
 
+    const int64_t now_ms = _clock->TimeInMilliseconds();
     _timing.StopDecodeTimer(
         decodedImage.timestamp(),
         frameInfo->decodeStartTimeMs,
-        _clock->TimeInMilliseconds());
-
-    if (callback != NULL)
+        now_ms,
+        frameInfo->frameType,
+        frameInfo->sizeBytes);
+    WEBRTC_HISTOGRAM_ADD("WebRTC.Video.DecodeTimeMs",
+                         static_cast<int>(now_ms -
+                                          frameInfo->decodeStartTimeMs));
+
+    // Frames decoded only to catch up are references for the later frames,
+    // and not rendered.
+    if (callback != NULL && !frameInfo->decodeOnly)
     {
         decodedImage.set_render_time_ms(frameInfo->renderTimeMs);
         callback->FrameToRender(decodedImage);
@@ -145,8 +155,13 @@ int32_t VCMGenericDecoder::InitDecode(const VideoCodec* settings,
 int32_t VCMGenericDecoder::Decode(const VCMEncodedFrame& frame,
                                         int64_t nowMs)
 {
+    TRACE_EVENT1("webrtc", "VCMGenericDecoder::Decode",
+                 "timestamp", frame.TimeStamp());
     _frameInfos[_nextFrameInfoIdx].decodeStartTimeMs = nowMs;
     _frameInfos[_nextFrameInfoIdx].renderTimeMs = frame.RenderTimeMs();
+    _frameInfos[_nextFrameInfoIdx].decodeOnly = frame.DecodeOnly();
+    _frameInfos[_nextFrameInfoIdx].frameType = frame.FrameType();
+    _frameInfos[_nextFrameInfoIdx].sizeBytes = frame.Length();
     _callback->Map(frame.TimeStamp(), &_frameInfos[_nextFrameInfoIdx]);
 
     _nextFrameInfoIdx = (_nextFrameInfoIdx + 1) % kDecoderFrameMemoryLength;
@@ -27,7 +27,10 @@ enum { kDecoderFrameMemoryLength = 10 };
 struct VCMFrameInformation
 {
     int64_t     renderTimeMs;
+    bool        decodeOnly;
     int64_t     decodeStartTimeMs;
+    FrameType   frameType;
+    uint32_t    sizeBytes;
     void*             userData;
 };
 
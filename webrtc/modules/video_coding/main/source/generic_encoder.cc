@@ -14,6 +14,9 @@
 #include "webrtc/modules/video_coding/main/source/media_optimization.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
 
 namespace webrtc {
 namespace {
@@ -99,10 +102,18 @@ int32_t
 VCMGenericEncoder::Encode(const I420VideoFrame& inputFrame,
                           const CodecSpecificInfo* codecSpecificInfo,
                           const std::vector<FrameType>& frameTypes) {
+  TRACE_EVENT1("webrtc", "VCMGenericEncoder::Encode",
+               "timestamp", inputFrame.timestamp());
   std::vector<VideoFrameType> video_frame_types(frameTypes.size(),
                                                 kDeltaFrame);
   VCMEncodedFrame::ConvertFrameTypes(frameTypes, &video_frame_types);
-  return _encoder.Encode(inputFrame, codecSpecificInfo, &video_frame_types);
+  const int64_t start_ms = TickTime::MillisecondTimestamp();
+  int32_t ret =
+      _encoder.Encode(inputFrame, codecSpecificInfo, &video_frame_types);
+  WEBRTC_HISTOGRAM_ADD("WebRTC.Video.EncodeTimeMs",
+                       static_cast<int>(TickTime::MillisecondTimestamp() -
+                                        start_ms));
+  return ret;
 }
 
 int32_t
@@ -175,6 +186,12 @@ VCMGenericEncoder::InternalSource() const
     return _internalSource;
 }
 
+bool
+VCMGenericEncoder::SupportsNativeHandle() const
+{
+    return _encoder.SupportsNativeHandle();
+}
+
  /***************************
   * Callback Implementation
   ***************************/
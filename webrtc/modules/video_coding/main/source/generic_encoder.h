@@ -126,6 +126,8 @@ public:
 
     bool InternalSource() const;
 
+    bool SupportsNativeHandle() const;
+
 private:
     VideoEncoder&               _encoder;
     VideoCodecType              _codecType;
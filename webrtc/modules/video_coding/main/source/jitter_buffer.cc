@@ -25,6 +25,7 @@
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
 #include "webrtc/system_wrappers/interface/trace_event.h"
 
 namespace webrtc {
@@ -32,8 +33,6 @@ namespace webrtc {
 // Use this rtt if no value has been reported.
 static const uint32_t kDefaultRtt = 200;
 
-typedef std::pair<uint32_t, VCMFrameBuffer*> FrameListPair;
-
 bool IsKeyFrame(FrameListPair pair) {
   return pair.second->FrameType() == kVideoFrameKey;
 }
@@ -42,20 +41,40 @@ bool HasNonEmptyState(FrameListPair pair) {
   return pair.second->GetState() != kStateEmpty;
 }
 
+class FrameListPairLessThan {
+ public:
+  bool operator() (const FrameListPair& pair, uint32_t timestamp) const {
+    return IsNewerTimestamp(timestamp, pair.first);
+  }
+};
+
+FrameList::FrameList() {
+  frames_.reserve(kMaxNumberOfFrames);
+}
+
 void FrameList::InsertFrame(VCMFrameBuffer* frame) {
-  insert(rbegin().base(), FrameListPair(frame->TimeStamp(), frame));
+  const uint32_t timestamp = frame->TimeStamp();
+  // Frames almost always arrive in timestamp order.
+  if (empty() || IsNewerTimestamp(timestamp, frames_.back().first)) {
+    frames_.push_back(FrameListPair(timestamp, frame));
+    return;
+  }
+  iterator it = LowerBound(timestamp);
+  if (it != end() && it->first == timestamp)
+    return;
+  frames_.insert(it, FrameListPair(timestamp, frame));
 }
 
 VCMFrameBuffer* FrameList::FindFrame(uint32_t timestamp) const {
-  FrameList::const_iterator it = find(timestamp);
-  if (it == end())
+  FrameList::const_iterator it = LowerBound(timestamp);
+  if (it == end() || it->first != timestamp)
     return NULL;
   return it->second;
 }
 
 VCMFrameBuffer* FrameList::PopFrame(uint32_t timestamp) {
-  FrameList::iterator it = find(timestamp);
-  if (it == end())
+  FrameList::iterator it = LowerBound(timestamp);
+  if (it == end() || it->first != timestamp)
     return NULL;
   VCMFrameBuffer* frame = it->second;
   erase(it);
@@ -63,11 +82,21 @@ VCMFrameBuffer* FrameList::PopFrame(uint32_t timestamp) {
 }
 
 VCMFrameBuffer* FrameList::Front() const {
-  return begin()->second;
+  return frames_.front().second;
 }
 
 VCMFrameBuffer* FrameList::Back() const {
-  return rbegin()->second;
+  return frames_.back().second;
+}
+
+FrameList::iterator FrameList::LowerBound(uint32_t timestamp) {
+  return std::lower_bound(frames_.begin(), frames_.end(), timestamp,
+                          FrameListPairLessThan());
+}
+
+FrameList::const_iterator FrameList::LowerBound(uint32_t timestamp) const {
+  return std::lower_bound(frames_.begin(), frames_.end(), timestamp,
+                          FrameListPairLessThan());
 }
 
 int FrameList::RecycleFramesUntilKeyFrame(FrameList::iterator* key_frame_it,
@@ -78,7 +107,7 @@ int FrameList::RecycleFramesUntilKeyFrame(FrameList::iterator* key_frame_it,
     // Throw at least one frame.
     it->second->Reset();
     free_frames->push_back(it->second);
-    erase(it++);
+    it = erase(it);
     ++drop_count;
     if (it != end() && it->second->FrameType() == kVideoFrameKey) {
       *key_frame_it = it;
@@ -89,6 +118,18 @@ int FrameList::RecycleFramesUntilKeyFrame(FrameList::iterator* key_frame_it,
   return drop_count;
 }
 
+int FrameList::RecycleFramesOlderThan(uint32_t timestamp,
+                                      UnorderedFrameList* free_frames) {
+  const iterator first_kept = LowerBound(timestamp);
+  for (iterator it = begin(); it != first_kept; ++it) {
+    it->second->Reset();
+    free_frames->push_back(it->second);
+  }
+  const int drop_count = static_cast<int>(first_kept - begin());
+  frames_.erase(begin(), first_kept);
+  return drop_count;
+}
+
 int FrameList::CleanUpOldOrEmptyFrames(VCMDecodingState* decoding_state,
                                        UnorderedFrameList* free_frames) {
   int drop_count = 0;
@@ -151,7 +192,7 @@ VCMJitterBuffer::VCMJitterBuffer(Clock* clock,
       nack_mode_(kNoNack),
       low_rtt_nack_threshold_ms_(-1),
       high_rtt_nack_threshold_ms_(-1),
-      missing_sequence_numbers_(SequenceNumberLessThan()),
+      missing_sequence_numbers_(),
       nack_seq_nums_(),
       max_nack_list_size_(0),
       max_packet_age_to_nack_(0),
@@ -161,6 +202,7 @@ VCMJitterBuffer::VCMJitterBuffer(Clock* clock,
       frame_counter_(0) {
   memset(frame_buffers_, 0, sizeof(frame_buffers_));
 
+  free_frames_.reserve(kMaxNumberOfFrames);
   for (int i = 0; i < kStartNumberOfFrames; i++) {
     frame_buffers_[i] = new VCMFrameBuffer();
     free_frames_.push_back(frame_buffers_[i]);
@@ -305,7 +347,7 @@ void VCMJitterBuffer::Flush() {
   waiting_for_completion_.timestamp = 0;
   waiting_for_completion_.latest_packet_time = -1;
   first_packet_since_reset_ = true;
-  missing_sequence_numbers_.clear();
+  missing_sequence_numbers_.Clear();
 }
 
 // Get received key and delta frames
@@ -480,6 +522,45 @@ bool VCMJitterBuffer::NextMaybeIncompleteTimestamp(uint32_t* timestamp) {
   return true;
 }
 
+int VCMJitterBuffer::DropFramesUntilLatestKeyFrame(
+    uint32_t* key_frame_timestamp) {
+  CriticalSectionScoped cs(crit_sect_);
+  if (!running_) {
+    return 0;
+  }
+  CleanUpOldOrEmptyFrames();
+  if (decodable_frames_.empty()) {
+    return 0;
+  }
+  // Dropping up to the oldest frame would drop nothing.
+  VCMFrameBuffer* key_frame = NULL;
+  VCMFrameBuffer* oldest_frame = decodable_frames_.Front();
+  for (FrameList::reverse_iterator it = decodable_frames_.rbegin();
+       it != decodable_frames_.rend() && it->second != oldest_frame; ++it) {
+    if (it->second->FrameType() == kVideoFrameKey &&
+        it->second->GetState() == kStateComplete) {
+      key_frame = it->second;
+      break;
+    }
+  }
+  if (key_frame == NULL) {
+    return 0;
+  }
+  *key_frame_timestamp = key_frame->TimeStamp();
+  const int dropped_frames =
+      decodable_frames_.RecycleFramesOlderThan(*key_frame_timestamp,
+                                               &free_frames_) +
+      incomplete_frames_.RecycleFramesOlderThan(*key_frame_timestamp,
+                                                &free_frames_);
+  drop_count_ += dropped_frames;
+  TRACE_EVENT_INSTANT1("webrtc", "JB::DropFramesUntilLatestKeyFrame",
+                       "timestamp", *key_frame_timestamp);
+  // Decode from the key frame on, and stop NACKing the dropped frames.
+  last_decoded_state_.Reset();
+  DropPacketsFromNackList(EstimatedLowSequenceNumber(*key_frame));
+  return dropped_frames;
+}
+
 VCMEncodedFrame* VCMJitterBuffer::ExtractAndSetDecode(uint32_t timestamp) {
   CriticalSectionScoped cs(crit_sect_);
   if (!running_) {
@@ -496,6 +577,12 @@ VCMEncodedFrame* VCMJitterBuffer::ExtractAndSetDecode(uint32_t timestamp) {
       return NULL;
   }
   TRACE_EVENT_ASYNC_STEP0("webrtc", "Video", timestamp, "Extract");
+  if (frame->LatestPacketTimeMs() >= 0) {
+    // Time from the last packet of the frame arriving until it is decoded.
+    WEBRTC_HISTOGRAM_ADD("WebRTC.Video.JitterBufferDelayMs",
+                         static_cast<int>(clock_->TimeInMilliseconds() -
+                                          frame->LatestPacketTimeMs()));
+  }
   // Frame pulled out from jitter buffer, update the jitter estimate.
   const bool retransmitted = (frame->GetNackCount() > 0);
   if (retransmitted) {
@@ -537,6 +624,7 @@ void VCMJitterBuffer::ReleaseFrame(VCMEncodedFrame* frame) {
   CriticalSectionScoped cs(crit_sect_);
   VCMFrameBuffer* frame_buffer = static_cast<VCMFrameBuffer*>(frame);
   if (frame_buffer) {
+    frame_buffer->Reset();
     free_frames_.push_back(frame_buffer);
   }
 }
@@ -814,7 +902,7 @@ void VCMJitterBuffer::FindAndInsertContinuousFrames(
     }
     if (IsContinuousInState(*frame, decoding_state)) {
       decodable_frames_.InsertFrame(frame);
-      incomplete_frames_.erase(it++);
+      it = incomplete_frames_.erase(it);
       decoding_state.SetState(frame);
     } else if (frame->TemporalId() <= 0) {
       break;
@@ -850,7 +938,7 @@ void VCMJitterBuffer::SetNackMode(VCMNackMode mode,
   CriticalSectionScoped cs(crit_sect_);
   nack_mode_ = mode;
   if (mode == kNoNack) {
-    missing_sequence_numbers_.clear();
+    missing_sequence_numbers_.Clear();
   }
   assert(low_rtt_nack_threshold_ms >= -1 && high_rtt_nack_threshold_ms >= -1);
   assert(high_rtt_nack_threshold_ms == -1 ||
@@ -964,12 +1052,8 @@ uint16_t* VCMJitterBuffer::GetNackList(uint16_t* nack_list_size,
       }
     }
   }
-  unsigned int i = 0;
-  SequenceNumberSet::iterator it = missing_sequence_numbers_.begin();
-  for (; it != missing_sequence_numbers_.end(); ++it, ++i) {
-    nack_seq_nums_[i] = *it;
-  }
-  *nack_list_size = i;
+  missing_sequence_numbers_.CopyTo(&nack_seq_nums_[0]);
+  *nack_list_size = missing_sequence_numbers_.size();
   return &nack_seq_nums_[0];
 }
 
@@ -999,10 +1083,11 @@ bool VCMJitterBuffer::UpdateNackList(uint16_t sequence_number) {
   if (IsNewerSequenceNumber(sequence_number,
                             latest_received_sequence_number_)) {
     // Push any missing sequence numbers to the NACK list.
-    for (uint16_t i = latest_received_sequence_number_ + 1;
-         IsNewerSequenceNumber(sequence_number, i); ++i) {
-      missing_sequence_numbers_.insert(missing_sequence_numbers_.end(), i);
-      TRACE_EVENT_INSTANT1("webrtc", "AddNack", "seqnum", i);
+    const uint16_t first_missing = latest_received_sequence_number_ + 1;
+    if (first_missing != sequence_number) {
+      missing_sequence_numbers_.InsertRange(first_missing, sequence_number);
+      TRACE_EVENT_INSTANT2("webrtc", "AddNack", "first_seqnum", first_missing,
+                           "end_seqnum", sequence_number);
     }
     if (TooLargeNackList() && !HandleTooLargeNackList()) {
       LOG(LS_WARNING) << "Requesting key frame due to too large NACK list.";
@@ -1014,7 +1099,7 @@ bool VCMJitterBuffer::UpdateNackList(uint16_t sequence_number) {
       return false;
     }
   } else {
-    missing_sequence_numbers_.erase(sequence_number);
+    missing_sequence_numbers_.Erase(sequence_number);
     TRACE_EVENT_INSTANT1("webrtc", "RemoveNack", "seqnum", sequence_number);
   }
   return true;
@@ -1043,7 +1128,7 @@ bool VCMJitterBuffer::MissingTooOldPacket(
     return false;
   }
   const uint16_t age_of_oldest_missing_packet = latest_sequence_number -
-      *missing_sequence_numbers_.begin();
+      missing_sequence_numbers_.Front();
   // Recycle frames if the NACK list contains too old sequence numbers as
   // the packets may have already been dropped by the sender.
   return age_of_oldest_missing_packet > max_packet_age_to_nack_;
@@ -1052,7 +1137,7 @@ bool VCMJitterBuffer::MissingTooOldPacket(
 bool VCMJitterBuffer::HandleTooOldPackets(uint16_t latest_sequence_number) {
   bool key_frame_found = false;
   const uint16_t age_of_oldest_missing_packet = latest_sequence_number -
-      *missing_sequence_numbers_.begin();
+      missing_sequence_numbers_.Front();
   LOG_F(LS_WARNING) << "NACK list contains too old sequence numbers: "
                     << age_of_oldest_missing_packet << " > "
                     << max_packet_age_to_nack_;
@@ -1066,9 +1151,7 @@ void VCMJitterBuffer::DropPacketsFromNackList(
     uint16_t last_decoded_sequence_number) {
   // Erase all sequence numbers from the NACK list which we won't need any
   // longer.
-  missing_sequence_numbers_.erase(missing_sequence_numbers_.begin(),
-                                  missing_sequence_numbers_.upper_bound(
-                                      last_decoded_sequence_number));
+  missing_sequence_numbers_.EraseUpTo(last_decoded_sequence_number);
 }
 
 int64_t VCMJitterBuffer::LastDecodedTimestamp() const {
@@ -1095,8 +1178,8 @@ VCMFrameBuffer* VCMJitterBuffer::GetEmptyFrame() {
       return NULL;
     }
   }
-  VCMFrameBuffer* frame = free_frames_.front();
-  free_frames_.pop_front();
+  VCMFrameBuffer* frame = free_frames_.back();
+  free_frames_.pop_back();
   return frame;
 }
 
@@ -1139,7 +1222,7 @@ bool VCMJitterBuffer::RecycleFramesUntilKeyFrame() {
     // All frames dropped. Reset the decoding state and clear missing sequence
     // numbers as we're starting fresh.
     last_decoded_state_.Reset();
-    missing_sequence_numbers_.clear();
+    missing_sequence_numbers_.Clear();
   }
   return key_frame_found;
 }
@@ -1197,8 +1280,7 @@ void VCMJitterBuffer::CleanUpOldOrEmptyFrames() {
 
 // Must be called from within |crit_sect_|.
 bool VCMJitterBuffer::IsPacketRetransmitted(const VCMPacket& packet) const {
-  return missing_sequence_numbers_.find(packet.seqNum) !=
-      missing_sequence_numbers_.end();
+  return missing_sequence_numbers_.Contains(packet.seqNum);
 }
 
 // Must be called under the critical section |crit_sect_|. Should never be
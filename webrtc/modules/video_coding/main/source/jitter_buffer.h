@@ -11,9 +11,8 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_JITTER_BUFFER_H_
 #define WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_JITTER_BUFFER_H_
 
-#include <list>
 #include <map>
-#include <set>
+#include <utility>
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
@@ -24,6 +23,7 @@
 #include "webrtc/modules/video_coding/main/source/inter_frame_delay.h"
 #include "webrtc/modules/video_coding/main/source/jitter_buffer_common.h"
 #include "webrtc/modules/video_coding/main/source/jitter_estimator.h"
+#include "webrtc/modules/video_coding/main/source/missing_sequence_numbers.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/typedefs.h"
 
@@ -42,7 +42,8 @@ class VCMFrameBuffer;
 class VCMPacket;
 class VCMEncodedFrame;
 
-typedef std::list<VCMFrameBuffer*> UnorderedFrameList;
+typedef std::vector<VCMFrameBuffer*> UnorderedFrameList;
+typedef std::pair<uint32_t, VCMFrameBuffer*> FrameListPair;
 
 struct VCMJitterSample {
   VCMJitterSample() : timestamp(0), frame_size(0), latest_packet_time(-1) {}
@@ -59,9 +60,30 @@ class TimestampLessThan {
   }
 };
 
-class FrameList
-    : public std::map<uint32_t, VCMFrameBuffer*, TimestampLessThan> {
+// Frames ordered by timestamp. The frames are kept in a flat array which is
+// preallocated for kMaxNumberOfFrames frames, since frames are nearly always
+// inserted at the back and removed from the front. Iterators are invalidated
+// by insertions and removals.
+class FrameList {
  public:
+  typedef std::vector<FrameListPair>::iterator iterator;
+  typedef std::vector<FrameListPair>::const_iterator const_iterator;
+  typedef std::vector<FrameListPair>::reverse_iterator reverse_iterator;
+
+  FrameList();
+
+  iterator begin() { return frames_.begin(); }
+  const_iterator begin() const { return frames_.begin(); }
+  iterator end() { return frames_.end(); }
+  const_iterator end() const { return frames_.end(); }
+  reverse_iterator rbegin() { return frames_.rbegin(); }
+  reverse_iterator rend() { return frames_.rend(); }
+  bool empty() const { return frames_.empty(); }
+  size_t size() const { return frames_.size(); }
+  void clear() { frames_.clear(); }
+  // Returns an iterator to the frame following the erased one.
+  iterator erase(iterator it) { return frames_.erase(it); }
+
   void InsertFrame(VCMFrameBuffer* frame);
   VCMFrameBuffer* FindFrame(uint32_t timestamp) const;
   VCMFrameBuffer* PopFrame(uint32_t timestamp);
@@ -69,9 +91,20 @@ class FrameList
   VCMFrameBuffer* Back() const;
   int RecycleFramesUntilKeyFrame(FrameList::iterator* key_frame_it,
       UnorderedFrameList* free_frames);
+  // Recycles the frames older than |timestamp|. Returns the number of frames
+  // recycled.
+  int RecycleFramesOlderThan(uint32_t timestamp,
+      UnorderedFrameList* free_frames);
   int CleanUpOldOrEmptyFrames(VCMDecodingState* decoding_state,
       UnorderedFrameList* free_frames);
   void Reset(UnorderedFrameList* free_frames);
+
+ private:
+  // Returns the first frame not older than |timestamp|.
+  iterator LowerBound(uint32_t timestamp);
+  const_iterator LowerBound(uint32_t timestamp) const;
+
+  std::vector<FrameListPair> frames_;
 };
 
 class VCMJitterBuffer {
@@ -126,6 +159,13 @@ class VCMJitterBuffer {
   // timestamp is returned. Otherwise, returns false.
   bool NextMaybeIncompleteTimestamp(uint32_t* timestamp);
 
+  // Drops all frames older than the latest complete key frame among the
+  // decodable frames, to catch up with the stream when the oldest frames are
+  // too late to be rendered. The timestamp of the key frame is returned in
+  // |key_frame_timestamp|. Returns the number of frames dropped, 0 if there
+  // is no key frame to jump to.
+  int DropFramesUntilLatestKeyFrame(uint32_t* key_frame_timestamp);
+
   // Extract frame corresponding to input timestamp.
   // Frame will be set to a decoding state.
   VCMEncodedFrame* ExtractAndSetDecode(uint32_t timestamp);
@@ -182,15 +222,6 @@ class VCMJitterBuffer {
   void RenderBufferSize(uint32_t* timestamp_start, uint32_t* timestamp_end);
 
  private:
-  class SequenceNumberLessThan {
-   public:
-    bool operator() (const uint16_t& sequence_number1,
-                     const uint16_t& sequence_number2) const {
-      return IsNewerSequenceNumber(sequence_number2, sequence_number1);
-    }
-  };
-  typedef std::set<uint16_t, SequenceNumberLessThan> SequenceNumberSet;
-
   // Gets the frame assigned to the timestamp of the packet. May recycle
   // existing frames if no free frames are available. Returns an error code if
   // failing, or kNoError on success.
@@ -319,7 +350,7 @@ class VCMJitterBuffer {
   int low_rtt_nack_threshold_ms_;
   int high_rtt_nack_threshold_ms_;
   // Holds the internal NACK list (the missing sequence numbers).
-  SequenceNumberSet missing_sequence_numbers_;
+  MissingSequenceNumbers missing_sequence_numbers_;
   uint16_t latest_received_sequence_number_;
   std::vector<uint16_t> nack_seq_nums_;
   size_t max_nack_list_size_;
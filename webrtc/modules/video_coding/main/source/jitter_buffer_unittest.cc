@@ -1710,6 +1710,36 @@ TEST_F(TestRunningJitterBuffer, KeyDeltaKeyDelta) {
   }
 }
 
+TEST_F(TestRunningJitterBuffer, DropFramesUntilLatestKeyFrame) {
+  InsertFrame(kVideoFrameKey);
+  uint32_t key_frame_timestamp = 0;
+  // The oldest frame is not jumped to.
+  EXPECT_EQ(0, jitter_buffer_->DropFramesUntilLatestKeyFrame(
+      &key_frame_timestamp));
+  EXPECT_TRUE(DecodeCompleteFrame());
+  EXPECT_GE(InsertFrames(3, kVideoFrameDelta), kNoError);
+  EXPECT_EQ(0, jitter_buffer_->DropFramesUntilLatestKeyFrame(
+      &key_frame_timestamp));
+  InsertFrame(kVideoFrameKey);
+  EXPECT_GE(InsertFrames(2, kVideoFrameDelta), kNoError);
+  InsertFrame(kVideoFrameKey);
+  EXPECT_GE(InsertFrames(2, kVideoFrameDelta), kNoError);
+
+  // Drops everything before the second key frame.
+  EXPECT_EQ(6, jitter_buffer_->DropFramesUntilLatestKeyFrame(
+      &key_frame_timestamp));
+  uint32_t timestamp = 0;
+  ASSERT_TRUE(jitter_buffer_->NextCompleteTimestamp(0, &timestamp));
+  EXPECT_EQ(key_frame_timestamp, timestamp);
+  VCMEncodedFrame* frame = jitter_buffer_->ExtractAndSetDecode(timestamp);
+  ASSERT_TRUE(frame != NULL);
+  EXPECT_EQ(kVideoFrameKey, frame->FrameType());
+  jitter_buffer_->ReleaseFrame(frame);
+  EXPECT_TRUE(DecodeCompleteFrame());
+  EXPECT_TRUE(DecodeCompleteFrame());
+  EXPECT_FALSE(DecodeCompleteFrame());
+}
+
 TEST_F(TestRunningJitterBuffer, TwoPacketsNonContinuous) {
   InsertFrame(kVideoFrameKey);
   EXPECT_TRUE(DecodeCompleteFrame());
@@ -35,6 +35,7 @@ _maxPayloadSize(1460),
 _qmRobustness(new VCMQmRobustness()),
 _useUepProtectionK(false),
 _useUepProtectionD(true),
+_fecMaskType(kFecMaskRandom),
 _corrFecCost(1.0),
 _type(kNone),
 _efficiency(0)
@@ -97,9 +98,15 @@ VCMNackFecMethod::ProtectionFactor(const VCMProtectionParameters* parameters)
     // RTT (NACK effectiveness) - adjustment factor is in the range [0,1].
     else if (_highRttNackMs == -1 || parameters->rtt < _highRttNackMs)
     {
-        // TODO(mikhal): Disabling adjustment temporarily.
-        // uint16_t rttIndex = (uint16_t) parameters->rtt;
-        float adjustRtt = 1.0f;// (float)VCMNackFecTable[rttIndex] / 100.0f;
+        // FEC recovers little of a burst of lost packets, while NACK
+        // recovers all of it at the cost of a round trip. So for bursty loss
+        // the FEC is reduced the more the lower the RTT is.
+        float adjustRtt = 1.0f;
+        if (parameters->burstyLoss && parameters->rtt < kHighRttNackMs)
+        {
+            adjustRtt = static_cast<float>(
+                VCMNackFecTable[parameters->rtt]) / 100.0f;
+        }
 
         // Adjust FEC with NACK on (for delta frame only)
         // table depends on RTT relative to rttMax (NACK Threshold)
@@ -517,8 +524,15 @@ VCMFecMethod::ProtectionFactor(const VCMProtectionParameters* parameters)
         codeRateKey = kPacketLossMax - 1;
     }
 
-    _protectionFactorK = codeRateKey;
-    _protectionFactorD = codeRateDelta;
+    // Keep less protection the longer no loss has been reported, rather than
+    // all of it until the loss leaves the max window filter.
+    const float lossFreeFactor = LossFreeFactor(parameters);
+    _protectionFactorK = static_cast<uint8_t>(lossFreeFactor * codeRateKey);
+    _protectionFactorD = static_cast<uint8_t>(lossFreeFactor * codeRateDelta);
+
+    // Consecutive losses are better recovered by the bursty masks, isolated
+    // losses by the random masks.
+    _fecMaskType = parameters->burstyLoss ? kFecMaskBursty : kFecMaskRandom;
 
     // Generally there is a rate mis-match between the FEC cost estimated
     // in mediaOpt and the actual FEC cost sent out in RTP module.
@@ -563,6 +577,20 @@ VCMFecMethod::ProtectionFactor(const VCMProtectionParameters* parameters)
     return true;
 }
 
+float VCMFecMethod::LossFreeFactor(
+    const VCMProtectionParameters* parameters) {
+  const int64_t kMaxLossFreeTimeMs =
+      kLossPrHistorySize * kLossPrShortFilterWinMs;
+  if (parameters->lossFreeTimeMs <= kLossFreeTimeFullProtectionMs) {
+    return 1.0f;
+  }
+  if (parameters->lossFreeTimeMs >= kMaxLossFreeTimeMs) {
+    return 0.0f;
+  }
+  return static_cast<float>(kMaxLossFreeTimeMs - parameters->lossFreeTimeMs) /
+      (kMaxLossFreeTimeMs - kLossFreeTimeFullProtectionMs);
+}
+
 int VCMFecMethod::BitsPerFrame(const VCMProtectionParameters* parameters) {
   // When temporal layers are available FEC will only be applied on the base
   // layer.
@@ -653,6 +681,9 @@ _lastPrUpdateT(0),
 _lossPr255(0.9999f),
 _lossPrHistory(),
 _shortMaxLossPr255(0),
+_lastLossTimeMs(-1),
+_lossFreeTimeMs(-1),
+_burstyLoss(false),
 _packetsPerFrame(0.9999f),
 _packetsPerFrameKey(0.9999f),
 _residualPacketLossFec(0),
@@ -817,6 +848,26 @@ VCMLossProtectionLogic::MaxFilteredLossPr(int64_t nowMs) const
     return maxFound;
 }
 
+bool VCMLossProtectionLogic::BurstyLoss(int64_t nowMs) const {
+  // Too few seconds of history to tell.
+  const int kMinSeconds = kLossPrHistorySize / 2;
+  int seconds = 0;
+  int lossy_seconds = 0;
+  for (int i = 0; i < kLossPrHistorySize; ++i) {
+    if (_lossPrHistory[i].timeMs == -1 ||
+        nowMs - _lossPrHistory[i].timeMs >
+            kLossPrHistorySize * kLossPrShortFilterWinMs) {
+      break;
+    }
+    ++seconds;
+    if (_lossPrHistory[i].lossPr255 > 0) {
+      ++lossy_seconds;
+    }
+  }
+  return seconds >= kMinSeconds && lossy_seconds > 0 &&
+      2 * lossy_seconds <= seconds;
+}
+
 uint8_t VCMLossProtectionLogic::FilteredLoss(
     int64_t nowMs,
     FilterPacketLossMode filter_mode,
@@ -825,6 +876,13 @@ uint8_t VCMLossProtectionLogic::FilteredLoss(
   // Update the max window filter.
   UpdateMaxLossHistory(lossPr255, nowMs);
 
+  // Update the loss pattern.
+  if (lossPr255 > 0) {
+    _lastLossTimeMs = nowMs;
+  }
+  _lossFreeTimeMs = _lastLossTimeMs == -1 ? -1 : nowMs - _lastLossTimeMs;
+  _burstyLoss = BurstyLoss(nowMs);
+
   // Update the recursive average filter.
   _lossPr255.Apply(static_cast<float> (nowMs - _lastPrUpdateT),
                    static_cast<float> (lossPr255));
@@ -913,6 +971,8 @@ VCMLossProtectionLogic::UpdateMethod()
     _currentParameters.codecWidth = _codecWidth;
     _currentParameters.codecHeight = _codecHeight;
     _currentParameters.numLayers = _numLayers;
+    _currentParameters.lossFreeTimeMs = _lossFreeTimeMs;
+    _currentParameters.burstyLoss = _burstyLoss;
     return _selectedMethod->UpdateParameters(&_currentParameters);
 }
 
@@ -943,6 +1003,9 @@ VCMLossProtectionLogic::Reset(int64_t nowMs)
         _lossPrHistory[i].timeMs = -1;
     }
     _shortMaxLossPr255 = 0;
+    _lastLossTimeMs = -1;
+    _lossFreeTimeMs = -1;
+    _burstyLoss = false;
     Release();
 }
 
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 
 #include "webrtc/base/exp_filter.h"
+#include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/video_coding/main/source/internal_defines.h"
 #include "webrtc/modules/video_coding/main/source/qm_select.h"
 #include "webrtc/system_wrappers/interface/trace.h"
@@ -52,7 +53,7 @@ struct VCMProtectionParameters
         packetsPerFrame(0.0f), packetsPerFrameKey(0.0f), frameRate(0.0f),
         keyFrameSize(0.0f), fecRateDelta(0), fecRateKey(0),
         residualPacketLossFec(0.0f), codecWidth(0), codecHeight(0),
-        numLayers(1)
+        numLayers(1), lossFreeTimeMs(-1), burstyLoss(false)
         {}
 
     int                 rtt;
@@ -68,6 +69,11 @@ struct VCMProtectionParameters
     uint16_t      codecWidth;
     uint16_t      codecHeight;
     int                 numLayers;
+    // Time since the last report of packet loss, -1 if no loss was reported.
+    int64_t             lossFreeTimeMs;
+    // True if the loss is reported in only a few of the seconds of the loss
+    // history, i.e. it comes in bursts rather than being spread out.
+    bool                burstyLoss;
 };
 
 
@@ -146,6 +152,9 @@ public:
 
     virtual int MaxFramesFec() const { return 1; }
 
+    // Returns the type of FEC packet mask suited to the loss pattern.
+    virtual FecMaskType RequiredFecMaskType() const { return _fecMaskType; }
+
     // Updates content metrics
     void UpdateContentMetrics(const VideoContentMetrics* contentMetrics);
 
@@ -162,6 +171,7 @@ protected:
     VCMQmRobustness*                     _qmRobustness;
     bool                                 _useUepProtectionK;
     bool                                 _useUepProtectionD;
+    FecMaskType                          _fecMaskType;
     float                                _corrFecCost;
     enum VCMProtectionMethodEnum         _type;
     float                                _efficiency;
@@ -200,6 +210,9 @@ public:
     void UpdateProtectionFactorK(uint8_t protectionFactorK);
     // Compute the bits per frame. Account for temporal layers when applicable.
     int BitsPerFrame(const VCMProtectionParameters* parameters);
+    // Get the factor, in [0, 1], to scale the protection with once no packet
+    // loss has been reported for a while.
+    static float LossFreeFactor(const VCMProtectionParameters* parameters);
 
 protected:
     enum { kUpperLimitFramesFec = 6 };
@@ -213,6 +226,9 @@ protected:
     enum { kMaxBytesPerFrameForFecHigh = 1000 };
     // Max round trip time threshold in ms.
     enum { kMaxRttTurnOffFec = 200 };
+    // Time without reported loss after which the protection starts to be
+    // reduced, reaching zero when the loss leaves the max window filter.
+    enum { kLossFreeTimeFullProtectionMs = 2 * kLossPrShortFilterWinMs };
 };
 
 
@@ -367,6 +383,9 @@ private:
     // Sets the available loss protection methods.
     void UpdateMaxLossHistory(uint8_t lossPr255, int64_t now);
     uint8_t MaxFilteredLossPr(int64_t nowMs) const;
+    // Returns true if loss was reported in at most half of the seconds of the
+    // loss history.
+    bool BurstyLoss(int64_t nowMs) const;
     VCMProtectionMethod* _selectedMethod;
     VCMProtectionParameters _currentParameters;
     uint32_t _rtt;
@@ -382,6 +401,9 @@ private:
     rtc::ExpFilter _lossPr255;
     VCMLossProbabilitySample _lossPrHistory[kLossPrHistorySize];
     uint8_t _shortMaxLossPr255;
+    int64_t _lastLossTimeMs;
+    int64_t _lossFreeTimeMs;
+    bool _burstyLoss;
     rtc::ExpFilter _packetsPerFrame;
     rtc::ExpFilter _packetsPerFrameKey;
     float _residualPacketLossFec;
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/main/source/media_opt_util.h"
+
+namespace webrtc {
+namespace media_optimization {
+
+class TestLossProtectionLogic : public ::testing::Test {
+ protected:
+  TestLossProtectionLogic() : now_ms_(1000), logic_(now_ms_) {}
+
+  virtual void SetUp() {
+    logic_.SetMethod(kFec);
+    logic_.UpdateBitRate(1000.0f);
+    logic_.UpdateFrameRate(30.0f);
+    logic_.UpdateFrameSize(640, 480);
+    logic_.UpdatePacketsPerFrame(4.0f, now_ms_);
+    logic_.UpdatePacketsPerFrameKey(20.0f, now_ms_);
+  }
+
+  // Reports |loss_pr255| and advances the time by a second.
+  void ReportLoss(uint8_t loss_pr255) {
+    logic_.UpdateFilteredLossPr(
+        logic_.FilteredLoss(now_ms_, kMaxFilter, loss_pr255));
+    logic_.UpdateMethod();
+    now_ms_ += kLossPrShortFilterWinMs;
+  }
+
+  uint8_t ProtectionFactorD() {
+    return logic_.SelectedMethod()->RequiredProtectionFactorD();
+  }
+
+  FecMaskType MaskType() {
+    return logic_.SelectedMethod()->RequiredFecMaskType();
+  }
+
+  int64_t now_ms_;
+  VCMLossProtectionLogic logic_;
+};
+
+TEST_F(TestLossProtectionLogic, SpreadOutLossUsesRandomMask) {
+  for (int i = 0; i < kLossPrHistorySize; ++i) {
+    ReportLoss(10);
+  }
+  EXPECT_GT(ProtectionFactorD(), 0);
+  EXPECT_EQ(kFecMaskRandom, MaskType());
+}
+
+TEST_F(TestLossProtectionLogic, BurstyLossUsesBurstyMask) {
+  ReportLoss(50);
+  ReportLoss(50);
+  ReportLoss(0);
+  ReportLoss(0);
+  // Too short a history to tell.
+  EXPECT_EQ(kFecMaskRandom, MaskType());
+  // Loss in two of five seconds.
+  ReportLoss(0);
+  EXPECT_EQ(kFecMaskBursty, MaskType());
+}
+
+TEST_F(TestLossProtectionLogic, ProtectionDecreasesWhileLossFree) {
+  for (int i = 0; i < 3; ++i) {
+    ReportLoss(20);
+  }
+  const uint8_t protection_with_loss = ProtectionFactorD();
+  EXPECT_GT(protection_with_loss, 0);
+
+  // The protection is kept for a couple of seconds without loss...
+  ReportLoss(0);
+  ReportLoss(0);
+  EXPECT_EQ(protection_with_loss, ProtectionFactorD());
+  // ...and then decreases until the loss leaves the max window filter.
+  uint8_t last_protection = protection_with_loss;
+  for (int i = 0; i < kLossPrHistorySize - 3; ++i) {
+    ReportLoss(0);
+    EXPECT_LT(ProtectionFactorD(), last_protection) << i;
+    last_protection = ProtectionFactorD();
+  }
+  ReportLoss(0);
+  EXPECT_EQ(0, ProtectionFactorD());
+}
+
+}  // namespace media_optimization
+}  // namespace webrtc
@@ -15,6 +15,7 @@
 #include "webrtc/modules/video_coding/utility/include/frame_dropper.h"
 #include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
 
 namespace webrtc {
 namespace media_optimization {
@@ -46,11 +47,10 @@ void UpdateProtectionCallback(
   key_fec_params.max_fec_frames = selected_method->MaxFramesFec();
 
   // Set the FEC packet mask type. |kFecMaskBursty| is more effective for
-  // consecutive losses and little/no packet re-ordering. As we currently
-  // do not have feedback data on the degree of correlated losses and packet
-  // re-ordering, we keep default setting to |kFecMaskRandom| for now.
-  delta_fec_params.fec_mask_type = kFecMaskRandom;
-  key_fec_params.fec_mask_type = kFecMaskRandom;
+  // consecutive losses and little/no packet re-ordering; the method picks it
+  // from the pattern of the reported loss.
+  delta_fec_params.fec_mask_type = selected_method->RequiredFecMaskType();
+  key_fec_params.fec_mask_type = selected_method->RequiredFecMaskType();
 
   // TODO(Marco): Pass FEC protection values per layer.
   video_protection_callback->ProtectionRequest(&delta_fec_params,
@@ -104,7 +104,8 @@ MediaOptimization::MediaOptimization(Clock* clock)
       suspension_enabled_(false),
       video_suspended_(false),
       suspension_threshold_bps_(0),
-      suspension_window_bps_(0) {
+      suspension_window_bps_(0),
+      frames_dropped_by_rate_control_(0) {
   memset(send_statistics_, 0, sizeof(send_statistics_));
   memset(incoming_frame_times_, -1, sizeof(incoming_frame_times_));
 }
@@ -456,7 +457,22 @@ bool MediaOptimization::DropFrame() {
   if (video_suspended_) {
     return true;  // Drop all frames when muted.
   }
-  return frame_dropper_->DropFrame();
+  if (!frame_dropper_->DropFrame()) {
+    return false;
+  }
+  WEBRTC_COUNTER_ADD("WebRTC.Video.FramesDroppedByRateControl", 1);
+  ++frames_dropped_by_rate_control_;
+  return true;
+}
+
+void MediaOptimization::SetPacerQueueDelay(int queue_ms) {
+  CriticalSectionScoped lock(crit_sect_.get());
+  frame_dropper_->SetPacerQueueMs(queue_ms);
+}
+
+uint32_t MediaOptimization::FramesDroppedByRateControl() const {
+  CriticalSectionScoped lock(crit_sect_.get());
+  return frames_dropped_by_rate_control_;
 }
 
 void MediaOptimization::UpdateContentData(
@@ -74,6 +74,14 @@ class MediaOptimization {
 
   bool DropFrame();
 
+  // Informs the frame dropper of how long the oldest packet has waited in the
+  // pacer queue, so that it can drop frames before the target rate is
+  // overshot.
+  void SetPacerQueueDelay(int queue_ms);
+
+  // Returns the number of frames dropped to keep to the target bit rate.
+  uint32_t FramesDroppedByRateControl() const;
+
   void UpdateContentData(const VideoContentMetrics* content_metrics);
 
   // Informs Media Optimization of encoding output: Length and frame type.
@@ -174,6 +182,7 @@ class MediaOptimization {
   bool video_suspended_ GUARDED_BY(crit_sect_);
   int suspension_threshold_bps_ GUARDED_BY(crit_sect_);
   int suspension_window_bps_ GUARDED_BY(crit_sect_);
+  uint32_t frames_dropped_by_rate_control_ GUARDED_BY(crit_sect_);
 };
 }  // namespace media_optimization
 }  // namespace webrtc
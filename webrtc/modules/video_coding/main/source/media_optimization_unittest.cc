@@ -114,5 +114,34 @@ TEST_F(TestMediaOptimization, VerifyMuting) {
   }
 }
 
+TEST_F(TestMediaOptimization, DropsFramesWhenPacerQueueBuildsUp) {
+  const int kTargetBitrateBps = 300000;
+  media_opt_.SetTargetRates(kTargetBitrateBps, 0, 100, NULL, NULL);
+  media_opt_.EnableFrameDropper(true);
+  // Frames at the target rate aren't dropped while the pacer keeps up.
+  for (int time = 0; time < 2000; time += frame_time_ms_) {
+    ASSERT_NO_FATAL_FAILURE(AddFrameAndAdvanceTime(kTargetBitrateBps, false));
+  }
+  EXPECT_EQ(0u, media_opt_.FramesDroppedByRateControl());
+
+  // A second of data waiting in the pacer makes the dropper start dropping,
+  // although the encoder is still at the target rate.
+  media_opt_.SetPacerQueueDelay(1000);
+  uint32_t frames_dropped = 0;
+  for (int time = 0; time < 2000; time += frame_time_ms_) {
+    if (media_opt_.DropFrame()) {
+      ++frames_dropped;
+    } else {
+      ASSERT_EQ(VCM_OK, media_opt_.UpdateWithEncodedData(
+          kTargetBitrateBps * frame_time_ms_ / (8 * 1000), next_timestamp_,
+          kVideoFrameDelta));
+    }
+    next_timestamp_ += frame_time_ms_ * kSampleRate / 1000;
+    clock_.AdvanceTimeMilliseconds(frame_time_ms_);
+  }
+  EXPECT_GT(frames_dropped, 0u);
+  EXPECT_EQ(frames_dropped, media_opt_.FramesDroppedByRateControl());
+}
+
 }  // namespace media_optimization
 }  // namespace webrtc
@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/main/source/missing_sequence_numbers.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "webrtc/modules/interface/module_common_types.h"
+
+namespace webrtc {
+
+MissingSequenceNumbers::MissingSequenceNumbers()
+    : size_(0),
+      oldest_(0),
+      newest_(0) {
+  memset(bits_, 0, sizeof(bits_));
+}
+
+uint16_t MissingSequenceNumbers::Front() const {
+  assert(!empty());
+  return oldest_;
+}
+
+void MissingSequenceNumbers::Insert(uint16_t sequence_number) {
+  if (IsSet(sequence_number))
+    return;
+  bits_[sequence_number >> 5] |= 1u << (sequence_number & 31);
+  if (size_ == 0) {
+    oldest_ = sequence_number;
+    newest_ = sequence_number;
+  } else if (IsNewerSequenceNumber(sequence_number, newest_)) {
+    newest_ = sequence_number;
+  } else if (IsNewerSequenceNumber(oldest_, sequence_number)) {
+    oldest_ = sequence_number;
+  }
+  ++size_;
+}
+
+void MissingSequenceNumbers::InsertRange(uint16_t first, uint16_t end) {
+  if (first == end)
+    return;
+  const uint16_t last = end - 1;
+  const bool was_empty = empty();
+  uint16_t seq_num = first;
+  while (true) {
+    // Set the bits from |seq_num| to the end of its word, or to |last|.
+    const uint16_t remaining = last - seq_num;
+    const int bit = seq_num & 31;
+    const int count = remaining < 32 - bit ? remaining + 1 : 32 - bit;
+    const uint32_t mask = (count == 32 ? ~0u : (1u << count) - 1) << bit;
+    uint32_t& word = bits_[seq_num >> 5];
+    for (uint32_t added = mask & ~word; added != 0; added &= added - 1)
+      ++size_;
+    word |= mask;
+    if (remaining < 32 - bit)
+      break;
+    seq_num += count;
+  }
+  if (was_empty) {
+    oldest_ = first;
+    newest_ = last;
+    return;
+  }
+  if (IsNewerSequenceNumber(last, newest_))
+    newest_ = last;
+  if (IsNewerSequenceNumber(oldest_, first))
+    oldest_ = first;
+}
+
+void MissingSequenceNumbers::Erase(uint16_t sequence_number) {
+  if (!IsSet(sequence_number))
+    return;
+  bits_[sequence_number >> 5] &= ~(1u << (sequence_number & 31));
+  --size_;
+  if (size_ == 0)
+    return;
+  if (sequence_number == oldest_) {
+    oldest_ = NextSetBit(oldest_);
+  } else if (sequence_number == newest_) {
+    // Erasing the newest sequence number is rare; scan from the oldest.
+    uint16_t seq_num = oldest_;
+    for (size_t i = 1; i < size_; ++i)
+      seq_num = NextSetBit(seq_num + 1);
+    newest_ = seq_num;
+  }
+}
+
+void MissingSequenceNumbers::EraseUpTo(uint16_t sequence_number) {
+  while (!empty() && !IsNewerSequenceNumber(oldest_, sequence_number))
+    Erase(oldest_);
+}
+
+bool MissingSequenceNumbers::Contains(uint16_t sequence_number) const {
+  return IsSet(sequence_number);
+}
+
+void MissingSequenceNumbers::Clear() {
+  while (!empty())
+    Erase(oldest_);
+}
+
+void MissingSequenceNumbers::CopyTo(uint16_t* sequence_numbers) const {
+  if (empty())
+    return;
+  uint16_t seq_num = oldest_;
+  sequence_numbers[0] = seq_num;
+  for (size_t i = 1; i < size_; ++i) {
+    seq_num = NextSetBit(seq_num + 1);
+    sequence_numbers[i] = seq_num;
+  }
+}
+
+uint16_t MissingSequenceNumbers::NextSetBit(uint16_t sequence_number) const {
+  assert(!empty());
+  uint16_t word_index = sequence_number >> 5;
+  uint32_t word = bits_[word_index] & (~0u << (sequence_number & 31));
+  while (word == 0) {
+    word_index = (word_index + 1) % kNumWords;
+    word = bits_[word_index];
+  }
+  int bit = 0;
+  while (!((word >> bit) & 1))
+    ++bit;
+  return static_cast<uint16_t>((word_index << 5) + bit);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_MISSING_SEQUENCE_NUMBERS_H_
+#define WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_MISSING_SEQUENCE_NUMBERS_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Set of RTP sequence numbers backed by a bitmap covering the whole 16-bit
+// sequence number space, ordered with wrap-around in mind. All sequence numbers
+// in the set must be within half the sequence number space of each other,
+// which holds for the NACK list since old sequence numbers are dropped long
+// before that. Operations only touch the bits between the oldest and the
+// newest sequence number in the set.
+class MissingSequenceNumbers {
+ public:
+  MissingSequenceNumbers();
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // Returns the oldest sequence number in the set. The set must not be empty.
+  uint16_t Front() const;
+
+  // Adds |sequence_number| to the set. This is cheapest when it is newer than
+  // all sequence numbers already in the set.
+  void Insert(uint16_t sequence_number);
+
+  // Adds the sequence numbers from |first| up to, but not including, |end|,
+  // a word of the bitmap at a time.
+  void InsertRange(uint16_t first, uint16_t end);
+
+  // Removes |sequence_number| from the set, if present.
+  void Erase(uint16_t sequence_number);
+
+  // Removes all sequence numbers older than or equal to |sequence_number|.
+  void EraseUpTo(uint16_t sequence_number);
+
+  bool Contains(uint16_t sequence_number) const;
+
+  void Clear();
+
+  // Writes the sequence numbers in the set to |sequence_numbers|, oldest
+  // first. |sequence_numbers| must have room for size() elements.
+  void CopyTo(uint16_t* sequence_numbers) const;
+
+ private:
+  enum { kNumWords = (1 << 16) / 32 };
+
+  bool IsSet(uint16_t sequence_number) const {
+    return (bits_[sequence_number >> 5] >> (sequence_number & 31)) & 1;
+  }
+  // Returns the first sequence number in the set at or after
+  // |sequence_number|. The set must contain such a sequence number.
+  uint16_t NextSetBit(uint16_t sequence_number) const;
+
+  uint32_t bits_[kNumWords];
+  size_t size_;
+  uint16_t oldest_;
+  uint16_t newest_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_MAIN_SOURCE_MISSING_SEQUENCE_NUMBERS_H_
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/main/source/missing_sequence_numbers.h"
+
+namespace webrtc {
+
+TEST(MissingSequenceNumbersTest, InsertAndErase) {
+  MissingSequenceNumbers missing;
+  EXPECT_TRUE(missing.empty());
+  for (uint16_t i = 10; i < 20; ++i)
+    missing.Insert(i);
+  missing.Insert(15);
+  EXPECT_EQ(10u, missing.size());
+  EXPECT_EQ(10, missing.Front());
+  EXPECT_TRUE(missing.Contains(15));
+
+  missing.Erase(15);
+  missing.Erase(15);
+  EXPECT_FALSE(missing.Contains(15));
+  missing.Erase(10);
+  EXPECT_EQ(11, missing.Front());
+  missing.Erase(19);
+  EXPECT_EQ(7u, missing.size());
+
+  uint16_t sequence_numbers[7];
+  missing.CopyTo(sequence_numbers);
+  const uint16_t kExpected[] = {11, 12, 13, 14, 16, 17, 18};
+  for (int i = 0; i < 7; ++i)
+    EXPECT_EQ(kExpected[i], sequence_numbers[i]);
+
+  // Inserting older than the oldest updates the front.
+  missing.Insert(5);
+  EXPECT_EQ(5, missing.Front());
+}
+
+TEST(MissingSequenceNumbersTest, OrderedAcrossWrap) {
+  MissingSequenceNumbers missing;
+  for (uint16_t i = 0xfff0; i != 0x0010; ++i)
+    missing.Insert(i);
+  EXPECT_EQ(32u, missing.size());
+  EXPECT_EQ(0xfff0, missing.Front());
+
+  uint16_t sequence_numbers[32];
+  missing.CopyTo(sequence_numbers);
+  EXPECT_EQ(0xffff, sequence_numbers[15]);
+  EXPECT_EQ(0x0000, sequence_numbers[16]);
+  EXPECT_EQ(0x000f, sequence_numbers[31]);
+
+  missing.EraseUpTo(0x0002);
+  EXPECT_EQ(13u, missing.size());
+  EXPECT_EQ(0x0003, missing.Front());
+  EXPECT_FALSE(missing.Contains(0xffff));
+
+  missing.Clear();
+  EXPECT_TRUE(missing.empty());
+  EXPECT_FALSE(missing.Contains(0x0005));
+}
+
+TEST(MissingSequenceNumbersTest, InsertRange) {
+  MissingSequenceNumbers missing;
+  missing.InsertRange(7, 7);
+  EXPECT_TRUE(missing.empty());
+
+  // A range across words and the wrap, overlapping what is already there.
+  missing.Insert(0xfffe);
+  missing.InsertRange(0xffc0, 0x0050);
+  EXPECT_EQ(0x90u, missing.size());
+  EXPECT_EQ(0xffc0, missing.Front());
+  EXPECT_TRUE(missing.Contains(0x004f));
+  EXPECT_FALSE(missing.Contains(0x0050));
+
+  // Newer ranges move the newest sequence number, so erasing up to the
+  // old newest keeps them.
+  missing.InsertRange(0x0060, 0x0061);
+  missing.EraseUpTo(0x004f);
+  EXPECT_EQ(1u, missing.size());
+  EXPECT_EQ(0x0060, missing.Front());
+
+  // Older ranges move the front.
+  missing.InsertRange(0x0010, 0x0014);
+  EXPECT_EQ(5u, missing.size());
+  uint16_t sequence_numbers[5];
+  missing.CopyTo(sequence_numbers);
+  const uint16_t kExpected[] = {0x0010, 0x0011, 0x0012, 0x0013, 0x0060};
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(kExpected[i], sequence_numbers[i]);
+}
+
+}  // namespace webrtc
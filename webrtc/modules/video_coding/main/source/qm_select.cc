@@ -937,7 +937,9 @@ float VCMQmRobustness::AdjustFecFactor(uint8_t code_rate_delta,
   ComputeMotionNFD();
   ComputeSpatial();
 
-  // TODO(marpan): Set FEC adjustment factor.
+  if (motion_.level == kLow) {
+    adjust_fec = kFecFactorLowMotion;
+  }
 
   // Keep track of previous values of network state:
   // adjustment may be also based on pattern of changes in network state.
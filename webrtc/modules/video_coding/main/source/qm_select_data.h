@@ -190,9 +190,13 @@ const int kMinImageSize = 176 * 144;
 const int kMinFrameRate = 8;
 
 //
-// PARAMETERS FOR FEC ADJUSTMENT: TODO (marpan)
+// PARAMETERS FOR FEC ADJUSTMENT:
 //
 
+// Adjustment of the FEC rate for low motion content, where the lost parts of
+// a frame are well concealed from the previous frame.
+const float kFecFactorLowMotion = 0.7f;
+
 //
 // PARAMETETS FOR SETTING LOW/HIGH STATES OF CONTENT METRICS:
 //
@@ -19,6 +19,7 @@
 #include "webrtc/modules/video_coding/main/source/media_opt_util.h"
 #include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
 #include "webrtc/system_wrappers/interface/trace_event.h"
 
 namespace webrtc {
@@ -36,7 +37,8 @@ VCMReceiver::VCMReceiver(VCMTiming* timing,
       timing_(timing),
       render_wait_event_(event_factory->CreateEvent()),
       state_(kPassive),
-      max_video_delay_ms_(kMaxVideoDelayMs) {}
+      max_video_delay_ms_(kMaxVideoDelayMs),
+      frames_dropped_by_timing_(0) {}
 
 VCMReceiver::~VCMReceiver() {
   render_wait_event_->Set();
@@ -155,6 +157,37 @@ VCMEncodedFrame* VCMReceiver::FrameForDecoding(
     return NULL;
   }
 
+  // When the oldest frame is already past its render time, typically after
+  // a late start or a recovery, catch up with the stream instead of showing
+  // the late frames one by one. The dual decoder follows the frames decoded
+  // here, so neither it nor a primary it is receiving for skips frames.
+  bool decode_only = false;
+  if (next_render_time_ms < now_ms && master_ &&
+      (dual_receiver == NULL || dual_receiver->State() != kReceiving)) {
+    const int dropped_frames =
+        jitter_buffer_.DropFramesUntilLatestKeyFrame(&frame_timestamp);
+    if (dropped_frames > 0) {
+      LOG(LS_INFO) << "Dropped " << dropped_frames << " late frames to jump "
+                   << "to the latest key frame.";
+      WEBRTC_COUNTER_ADD("WebRTC.Video.FramesDroppedByTiming", dropped_frames);
+      {
+        CriticalSectionScoped cs(crit_sect_);
+        frames_dropped_by_timing_ += dropped_frames;
+      }
+      timing_->UpdateCurrentDelay(frame_timestamp);
+      next_render_time_ms = timing_->RenderTimeMs(frame_timestamp, now_ms);
+    }
+    if (next_render_time_ms < now_ms) {
+      // Decode the frame as a reference, but don't render it when a later
+      // one is ready to take its place.
+      uint32_t timestamp_start = 0;
+      uint32_t timestamp_end = 0;
+      jitter_buffer_.RenderBufferSize(&timestamp_start, &timestamp_end);
+      decode_only = timestamp_start == frame_timestamp &&
+                    IsNewerTimestamp(timestamp_end, frame_timestamp);
+    }
+  }
+
   if (!render_timing) {
     // Decode frame as close as possible to the render timestamp.
     const int32_t available_wait_time = max_wait_time_ms -
@@ -180,6 +213,7 @@ VCMEncodedFrame* VCMReceiver::FrameForDecoding(
     return NULL;
   }
   frame->SetRenderTime(next_render_time_ms);
+  frame->SetDecodeOnly(decode_only);
   TRACE_EVENT_ASYNC_STEP1("webrtc", "Video", frame->TimeStamp(),
                           "SetRenderTS", "render_time", next_render_time_ms);
   if (dual_receiver != NULL) {
@@ -197,9 +231,34 @@ VCMEncodedFrame* VCMReceiver::FrameForDecoding(
       timing_->IncomingTimestamp(frame_timestamp, last_packet_time_ms);
     }
   }
+  if (DroppableIfLate(*frame) &&
+      !timing_->FrameDecodedInTime(frame->FrameType(), frame->Length(),
+                                   next_render_time_ms,
+                                   clock_->TimeInMilliseconds())) {
+    // The decoder is behind. No other frame depends on this one, so don't
+    // spend time decoding a frame which would be rendered late.
+    TRACE_EVENT_INSTANT1("webrtc", "VCMReceiver::DropLateFrame",
+                         "timestamp", frame->TimeStamp());
+    WEBRTC_COUNTER_ADD("WebRTC.Video.FramesDroppedByTiming", 1);
+    jitter_buffer_.ReleaseFrame(frame);
+    CriticalSectionScoped cs(crit_sect_);
+    ++frames_dropped_by_timing_;
+    return NULL;
+  }
   return frame;
 }
 
+int VCMReceiver::TimeUntilNextFrameMs(bool render_timing) {
+  uint32_t frame_timestamp = 0;
+  if (!jitter_buffer_.NextCompleteTimestamp(0, &frame_timestamp))
+    return -1;
+  if (render_timing)
+    return 0;
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  return static_cast<int>(timing_->MaxWaitingTime(
+      timing_->RenderTimeMs(frame_timestamp, now_ms), now_ms));
+}
+
 void VCMReceiver::ReleaseFrame(VCMEncodedFrame* frame) {
   jitter_buffer_.ReleaseFrame(frame);
 }
@@ -222,6 +281,11 @@ uint32_t VCMReceiver::DiscardedPackets() const {
   return jitter_buffer_.num_discarded_packets();
 }
 
+uint32_t VCMReceiver::FramesDroppedByTiming() const {
+  CriticalSectionScoped cs(crit_sect_);
+  return frames_dropped_by_timing_;
+}
+
 void VCMReceiver::SetNackMode(VCMNackMode nackMode,
                               int low_rtt_nack_threshold_ms,
                               int high_rtt_nack_threshold_ms) {
@@ -348,4 +412,13 @@ void VCMReceiver::UpdateState(const VCMEncodedFrame& frame) {
     UpdateState(kReceiving);
   }
 }
+
+// static
+bool VCMReceiver::DroppableIfLate(const VCMEncodedFrame& frame) {
+  // Only VP8 signals the frames which no other frame references, e.g. the
+  // frames of the highest temporal layer.
+  const CodecSpecificInfo* codec_specific = frame.CodecSpecific();
+  return codec_specific->codecType == kVideoCodecVP8 &&
+         codec_specific->codecSpecific.VP8.nonReference;
+}
 }  // namespace webrtc
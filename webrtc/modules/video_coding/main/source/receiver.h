@@ -52,10 +52,16 @@ class VCMReceiver {
                                     int64_t& next_render_time_ms,
                                     bool render_timing = true,
                                     VCMReceiver* dual_receiver = NULL);
+  // Returns the time until FrameForDecoding() returns the oldest complete
+  // frame, 0 if it would now, or -1 if there is no complete frame.
+  int TimeUntilNextFrameMs(bool render_timing);
   void ReleaseFrame(VCMEncodedFrame* frame);
   void ReceiveStatistics(uint32_t* bitrate, uint32_t* framerate);
   void ReceivedFrameCount(VCMFrameCount* frame_count) const;
   uint32_t DiscardedPackets() const;
+  // Returns the number of frames dropped because they couldn't be decoded in
+  // time to be rendered.
+  uint32_t FramesDroppedByTiming() const;
 
   // NACK.
   void SetNackMode(VCMNackMode nackMode,
@@ -89,6 +95,9 @@ class VCMReceiver {
   void CopyJitterBufferStateFromReceiver(const VCMReceiver& receiver);
   void UpdateState(VCMReceiverState new_state);
   void UpdateState(const VCMEncodedFrame& frame);
+  // Returns whether |frame| can be dropped without affecting the decoding of
+  // other frames.
+  static bool DroppableIfLate(const VCMEncodedFrame& frame);
   static int32_t GenerateReceiverId();
 
   CriticalSectionWrapper* crit_sect_;
@@ -99,6 +108,7 @@ class VCMReceiver {
   scoped_ptr<EventWrapper> render_wait_event_;
   VCMReceiverState state_;
   int max_video_delay_ms_;
+  uint32_t frames_dropped_by_timing_;
 
   static int32_t receiver_id_counter_;
 };
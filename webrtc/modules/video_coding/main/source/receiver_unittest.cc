@@ -12,6 +12,7 @@
 #include <list>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/video_coding/main/source/encoded_frame.h"
 #include "webrtc/modules/video_coding/main/source/packet.h"
 #include "webrtc/modules/video_coding/main/source/receiver.h"
 #include "webrtc/modules/video_coding/main/source/test/stream_generator.h"
@@ -332,4 +333,95 @@ TEST_F(TestVCMReceiver, NonDecodableDuration_KeyFrameAfterIncompleteFrames) {
                                          &nack_list_length);
   EXPECT_EQ(kNackOk, ret);
 }
+
+TEST_F(TestVCMReceiver, DropsLateNonReferenceFrames) {
+  VCMPacket packet;
+  packet.dataPtr = data_buffer_;
+  packet.sizeBytes = kDataBufferSize;
+  packet.isFirstPacket = true;
+  packet.markerBit = true;
+  packet.completeNALU = kNaluComplete;
+  packet.codec = kVideoCodecVP8;
+  packet.codecSpecificHeader.codec = kRtpVideoVp8;
+  packet.codecSpecificHeader.codecHeader.VP8.InitRTPVideoHeaderVP8();
+
+  packet.frameType = kVideoFrameKey;
+  packet.seqNum = 0;
+  packet.timestamp = 0;
+  EXPECT_GE(receiver_.InsertPacket(packet, kWidth, kHeight), kNoError);
+  clock_->AdvanceTimeMilliseconds(kDefaultFramePeriodMs);
+  EXPECT_TRUE(DecodeNextFrame());
+
+  // A non-reference frame which is too late to be rendered is dropped.
+  packet.frameType = kVideoFrameDelta;
+  packet.codecSpecificHeader.codecHeader.VP8.nonReference = true;
+  packet.seqNum = 1;
+  packet.timestamp = 90 * kDefaultFramePeriodMs;
+  EXPECT_GE(receiver_.InsertPacket(packet, kWidth, kHeight), kNoError);
+  clock_->AdvanceTimeMilliseconds(100);
+  EXPECT_FALSE(DecodeNextFrame());
+  EXPECT_EQ(1u, receiver_.FramesDroppedByTiming());
+
+  // A late frame which other frames depend on is still decoded.
+  packet.codecSpecificHeader.codecHeader.VP8.nonReference = false;
+  packet.seqNum = 2;
+  packet.timestamp = 2 * 90 * kDefaultFramePeriodMs;
+  EXPECT_GE(receiver_.InsertPacket(packet, kWidth, kHeight), kNoError);
+  clock_->AdvanceTimeMilliseconds(100);
+  EXPECT_TRUE(DecodeNextFrame());
+  EXPECT_EQ(1u, receiver_.FramesDroppedByTiming());
+}
+
+TEST_F(TestVCMReceiver, CatchesUpWithLateFrames) {
+  EXPECT_GE(InsertFrame(kVideoFrameKey, true), kNoError);
+  EXPECT_TRUE(DecodeNextFrame());
+
+  // The decoding stalls while a key frame and more frames arrive.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_GE(InsertFrame(kVideoFrameDelta, true), kNoError);
+  }
+  EXPECT_GE(InsertFrame(kVideoFrameKey, true), kNoError);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_GE(InsertFrame(kVideoFrameDelta, true), kNoError);
+  }
+  clock_->AdvanceTimeMilliseconds(500);
+
+  // The late frames before the latest key frame are dropped.
+  int64_t render_time_ms = 0;
+  VCMEncodedFrame* frame = receiver_.FrameForDecoding(0, render_time_ms,
+                                                      false, NULL);
+  ASSERT_TRUE(frame != NULL);
+  EXPECT_EQ(kVideoFrameKey, frame->FrameType());
+  EXPECT_TRUE(frame->DecodeOnly());
+  receiver_.ReleaseFrame(frame);
+  EXPECT_EQ(3u, receiver_.FramesDroppedByTiming());
+
+  // The late frames after it are decoded, and only the latest one rendered.
+  frame = receiver_.FrameForDecoding(0, render_time_ms, false, NULL);
+  ASSERT_TRUE(frame != NULL);
+  EXPECT_TRUE(frame->DecodeOnly());
+  receiver_.ReleaseFrame(frame);
+  frame = receiver_.FrameForDecoding(0, render_time_ms, false, NULL);
+  ASSERT_TRUE(frame != NULL);
+  EXPECT_FALSE(frame->DecodeOnly());
+  receiver_.ReleaseFrame(frame);
+  EXPECT_FALSE(DecodeNextFrame());
+  EXPECT_EQ(3u, receiver_.FramesDroppedByTiming());
+}
+
+TEST_F(TestVCMReceiver, TimeUntilNextFrame) {
+  EXPECT_EQ(-1, receiver_.TimeUntilNextFrameMs(true));
+  EXPECT_GE(InsertFrame(kVideoFrameKey, false), kNoError);
+  EXPECT_EQ(-1, receiver_.TimeUntilNextFrameMs(true));
+  receiver_.Reset();
+  EXPECT_GE(InsertFrame(kVideoFrameKey, true), kNoError);
+  // A decoder doing the render timing gets the frame right away.
+  EXPECT_EQ(0, receiver_.TimeUntilNextFrameMs(true));
+  // Otherwise the frame is due with time.
+  timing_.set_min_playout_delay(100);
+  const int time_ms = receiver_.TimeUntilNextFrameMs(false);
+  EXPECT_GT(time_ms, 10);
+  clock_->AdvanceTimeMilliseconds(10);
+  EXPECT_EQ(time_ms - 10, receiver_.TimeUntilNextFrameMs(false));
+}
 }  // namespace webrtc
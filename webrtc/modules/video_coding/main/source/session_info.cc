@@ -10,6 +10,10 @@
 
 #include "webrtc/modules/video_coding/main/source/session_info.h"
 
+#include <string.h>
+
+#include <vector>
+
 #include "webrtc/modules/video_coding/main/source/packet.h"
 #include "webrtc/system_wrappers/interface/logging.h"
 
@@ -23,9 +27,19 @@ enum {kRttThreshold = 100};  // Not decodable if Rtt is lower than this.
 static const float kLowPacketPercentageThreshold = 0.2f;
 static const float kHighPacketPercentageThreshold = 0.8f;
 
+static const size_t kH264NALHeaderLengthInBytes = 1;
+static const size_t kLengthFieldLength = 2;
+
 uint16_t BufferToUWord16(const uint8_t* dataBuffer) {
   return (dataBuffer[0] << 8) | dataBuffer[1];
 }
+
+// The H.264 header shares its storage with the VP8 header, so the codec must
+// be checked first.
+bool IsH264StapA(const VCMPacket& packet) {
+  return packet.codec == kVideoCodecH264 &&
+         packet.codecSpecificHeader.codecHeader.H264.stap_a;
+}
 }  // namespace
 
 VCMSessionInfo::VCMSessionInfo()
@@ -37,7 +51,8 @@ VCMSessionInfo::VCMSessionInfo()
       empty_seq_num_low_(-1),
       empty_seq_num_high_(-1),
       first_packet_seq_num_(-1),
-      last_packet_seq_num_(-1) {
+      last_packet_seq_num_(-1),
+      packet_data_in_order_(true) {
 }
 
 void VCMSessionInfo::UpdateDataPointers(const uint8_t* old_base_ptr,
@@ -108,6 +123,7 @@ void VCMSessionInfo::Reset() {
   empty_seq_num_high_ = -1;
   first_packet_seq_num_ = -1;
   last_packet_seq_num_ = -1;
+  packet_data_in_order_ = true;
 }
 
 int VCMSessionInfo::SessionLength() const {
@@ -126,11 +142,19 @@ int VCMSessionInfo::InsertBuffer(uint8_t* frame_buffer,
   VCMPacket& packet = *packet_it;
   PacketIterator it;
 
-  // Calculate the offset into the frame buffer for this packet.
+  // The data is appended in the order the packets arrive, so that a packet
+  // which fills a gap doesn't move the data of the packets after it. The
+  // data is put in sequence number order once, by CompactPacketData().
   int offset = 0;
-  for (it = packets_.begin(); it != packet_it; ++it)
-    offset += (*it).sizeBytes;
+  for (it = packets_.begin(); it != packets_.end(); ++it) {
+    if (it != packet_it)
+      offset += (*it).sizeBytes;
+  }
+  PacketIterator next_it = packet_it;
+  if (++next_it != packets_.end())
+    packet_data_in_order_ = false;
 
+  const size_t required_length = BufferLength(packet);
   // Set the data pointer to pointing to the start of this packet in the
   // frame buffer.
   const uint8_t* packet_buffer = packet.dataPtr;
@@ -138,23 +162,15 @@ int VCMSessionInfo::InsertBuffer(uint8_t* frame_buffer,
 
   // We handle H.264 STAP-A packets in a special way as we need to remove the
   // two length bytes between each NAL unit, and potentially add start codes.
-  const size_t kH264NALHeaderLengthInBytes = 1;
-  const size_t kLengthFieldLength = 2;
-  if (packet.codecSpecificHeader.codecHeader.H264.stap_a) {
-    size_t required_length = 0;
+  if (IsH264StapA(packet)) {
+    const uint8_t* const packet_end = packet_buffer + packet.sizeBytes;
     const uint8_t* nalu_ptr = packet_buffer + kH264NALHeaderLengthInBytes;
-    while (nalu_ptr < packet_buffer + packet.sizeBytes) {
-      uint32_t length = BufferToUWord16(nalu_ptr);
-      required_length +=
-          length + (packet.insertStartCode ? kH264StartCodeLengthBytes : 0);
-      nalu_ptr += kLengthFieldLength + length;
-    }
-    ShiftSubsequentPackets(packet_it, required_length);
-    nalu_ptr = packet_buffer + kH264NALHeaderLengthInBytes;
     uint8_t* frame_buffer_ptr = frame_buffer + offset;
-    while (nalu_ptr < packet_buffer + packet.sizeBytes) {
+    while (nalu_ptr + kLengthFieldLength <= packet_end) {
       uint32_t length = BufferToUWord16(nalu_ptr);
       nalu_ptr += kLengthFieldLength;
+      if (length > static_cast<size_t>(packet_end - nalu_ptr))
+        break;
       frame_buffer_ptr += Insert(nalu_ptr,
                                  length,
                                  packet.insertStartCode,
@@ -164,11 +180,6 @@ int VCMSessionInfo::InsertBuffer(uint8_t* frame_buffer,
     packet.sizeBytes = required_length;
     return packet.sizeBytes;
   }
-  ShiftSubsequentPackets(
-      packet_it,
-      packet.sizeBytes +
-          (packet.insertStartCode ? kH264StartCodeLengthBytes : 0));
-
   packet.sizeBytes = Insert(packet_buffer,
                             packet.sizeBytes,
                             packet.insertStartCode,
@@ -176,6 +187,25 @@ int VCMSessionInfo::InsertBuffer(uint8_t* frame_buffer,
   return packet.sizeBytes;
 }
 
+size_t VCMSessionInfo::BufferLength(const VCMPacket& packet) {
+  const size_t start_code_length =
+      packet.insertStartCode ? kH264StartCodeLengthBytes : 0;
+  if (!IsH264StapA(packet))
+    return packet.sizeBytes + start_code_length;
+  size_t required_length = 0;
+  const uint8_t* const packet_end = packet.dataPtr + packet.sizeBytes;
+  const uint8_t* nalu_ptr = packet.dataPtr + kH264NALHeaderLengthInBytes;
+  while (nalu_ptr + kLengthFieldLength <= packet_end) {
+    uint32_t length = BufferToUWord16(nalu_ptr);
+    nalu_ptr += kLengthFieldLength;
+    if (length > static_cast<size_t>(packet_end - nalu_ptr))
+      break;
+    required_length += length + start_code_length;
+    nalu_ptr += length;
+  }
+  return required_length;
+}
+
 size_t VCMSessionInfo::Insert(const uint8_t* buffer,
                               size_t length,
                               bool insert_start_code,
@@ -208,6 +238,33 @@ void VCMSessionInfo::ShiftSubsequentPackets(PacketIterator it,
   memmove(first_packet_ptr + steps_to_shift, first_packet_ptr, shift_length);
 }
 
+void VCMSessionInfo::CompactPacketData() {
+  if (packet_data_in_order_)
+    return;
+  // The data of the packets starts at the beginning of the frame buffer,
+  // which is where the packet with the lowest data pointer is.
+  uint8_t* frame_buffer = NULL;
+  for (PacketIterator it = packets_.begin(); it != packets_.end(); ++it) {
+    if ((*it).dataPtr != NULL &&
+        (frame_buffer == NULL || (*it).dataPtr < frame_buffer)) {
+      frame_buffer = const_cast<uint8_t*>((*it).dataPtr);
+    }
+  }
+  std::vector<uint8_t> data(SessionLength());
+  size_t offset = 0;
+  for (PacketIterator it = packets_.begin(); it != packets_.end(); ++it) {
+    if ((*it).dataPtr == NULL)
+      continue;
+    if ((*it).sizeBytes > 0)
+      memcpy(&data[offset], (*it).dataPtr, (*it).sizeBytes);
+    (*it).dataPtr = frame_buffer + offset;
+    offset += (*it).sizeBytes;
+  }
+  if (offset > 0)
+    memcpy(frame_buffer, &data[0], offset);
+  packet_data_in_order_ = true;
+}
+
 void VCMSessionInfo::UpdateCompleteSession() {
   if (HaveFirstPacket() && HaveLastPacket()) {
     // Do we have all the packets in this session?
@@ -297,6 +354,7 @@ int VCMSessionInfo::BuildVP8FragmentationHeader(
     uint8_t* frame_buffer,
     int frame_buffer_length,
     RTPFragmentationHeader* fragmentation) {
+  CompactPacketData();
   int new_length = 0;
   // Allocate space for max number of partitions
   fragmentation->VerifyAndAllocateFragmentationHeader(kMaxVP8Partitions);
@@ -389,6 +447,7 @@ int VCMSessionInfo::MakeDecodable() {
   if (packets_.empty()) {
     return 0;
   }
+  CompactPacketData();
   PacketIterator it = packets_.begin();
   // Make sure we remove the first NAL unit if it's not decodable.
   if ((*it).completeNALU == kNaluIncomplete ||
@@ -512,6 +571,8 @@ int VCMSessionInfo::InsertPacket(const VCMPacket& packet,
 
   int returnLength = InsertBuffer(frame_buffer, packet_list_it);
   UpdateCompleteSession();
+  if (complete_)
+    CompactPacketData();
   if (decode_error_mode == kWithErrors)
     decodable_ = true;
   else if (decode_error_mode == kSelectiveErrors)
@@ -53,6 +53,11 @@ class VCMSessionInfo {
   bool complete() const;
   bool decodable() const;
 
+  // Returns the number of bytes InsertPacket() writes to the frame buffer for
+  // |packet|. H.264 STAP-A packets are written without their length fields
+  // and with a start code before each NAL unit.
+  static size_t BufferLength(const VCMPacket& packet);
+
   // Builds fragmentation headers for VP8, each fragment being a decodable
   // VP8 partition. Returns the total number of bytes which are decodable. Is
   // used instead of MakeDecodable for VP8.
@@ -121,6 +126,9 @@ class VCMSessionInfo {
                 bool insert_start_code,
                 uint8_t* frame_buffer);
   void ShiftSubsequentPackets(PacketIterator it, int steps_to_shift);
+  // Moves the data of the packets, which is in the order they arrived, into
+  // sequence number order at the start of the frame buffer.
+  void CompactPacketData();
   PacketIterator FindNaluEnd(PacketIterator packet_iter) const;
   // Deletes the data of all packets between |start| and |end|, inclusively.
   // Note that this function doesn't delete the actual packets.
@@ -163,6 +171,9 @@ class VCMSessionInfo {
   // TODO(mikhal): Refactor the list to use a map.
   int first_packet_seq_num_;
   int last_packet_seq_num_;
+  // False once a packet has arrived after one with a higher sequence number,
+  // until CompactPacketData() has run.
+  bool packet_data_in_order_;
 };
 
 }  // namespace webrtc
@@ -226,6 +226,71 @@ TEST_F(TestSessionInfo, NormalOperation) {
   }
 }
 
+TEST_F(TestSessionInfo, H264StapAIsSplitIntoNalUnits) {
+  // Three one byte NAL units, each preceded by its length.
+  const uint8_t kStapA[kPacketBufferSize] = {24, 0, 1, 5, 0, 1, 6, 0, 1, 7};
+  memcpy(packet_buffer_, kStapA, sizeof(kStapA));
+  packet_.codec = kVideoCodecH264;
+  packet_.codecSpecificHeader.codec = kRtpVideoH264;
+  packet_.codecSpecificHeader.codecHeader.H264.stap_a = true;
+  packet_.codecSpecificHeader.codecHeader.H264.single_nalu = true;
+  packet_.insertStartCode = true;
+  packet_.isFirstPacket = true;
+  packet_.markerBit = true;
+
+  // Each NAL unit gets a start code in place of its length field.
+  const size_t kExpectedLength = 3 * (kH264StartCodeLengthBytes + 1);
+  EXPECT_EQ(kExpectedLength, VCMSessionInfo::BufferLength(packet_));
+  EXPECT_EQ(static_cast<int>(kExpectedLength),
+            session_.InsertPacket(packet_, frame_buffer_, kNoErrors,
+                                  frame_data));
+  const uint8_t kExpected[kExpectedLength] = {0, 0, 0, 1, 5,
+                                              0, 0, 0, 1, 6,
+                                              0, 0, 0, 1, 7};
+  EXPECT_EQ(0, memcmp(kExpected, frame_buffer_, kExpectedLength));
+}
+
+TEST_F(TestSessionInfo, Vp8NonReferencePacketIsNotSplit) {
+  // The VP8 header shares its storage with the H.264 header.
+  packet_.codec = kVideoCodecVP8;
+  packet_.codecSpecificHeader.codec = kRtpVideoVp8;
+  packet_.codecSpecificHeader.codecHeader.VP8.InitRTPVideoHeaderVP8();
+  packet_.codecSpecificHeader.codecHeader.VP8.nonReference = true;
+  packet_.isFirstPacket = true;
+  packet_.markerBit = true;
+  FillPacket(0);
+  EXPECT_EQ(static_cast<size_t>(packet_buffer_size()),
+            VCMSessionInfo::BufferLength(packet_));
+  EXPECT_EQ(packet_buffer_size(),
+            session_.InsertPacket(packet_, frame_buffer_, kNoErrors,
+                                  frame_data));
+  VerifyPacket(frame_buffer_, 0);
+}
+
+TEST_F(TestSessionInfo, ReorderedPacketsInOrderWhenComplete) {
+  // Insert the packets of a ten packet frame in reverse order, across the
+  // sequence number wrap.
+  const uint16_t kFirstSeqNum = 0xFFFB;
+  for (int i = 9; i >= 0; --i) {
+    packet_.seqNum = kFirstSeqNum + i;
+    packet_.isFirstPacket = (i == 0);
+    packet_.markerBit = (i == 9);
+    FillPacket(i);
+    ASSERT_EQ(session_.InsertPacket(packet_,
+                                    frame_buffer_,
+                                    kNoErrors,
+                                    frame_data),
+              packet_buffer_size());
+    EXPECT_EQ(i == 0, session_.complete());
+  }
+
+  EXPECT_EQ(10 * packet_buffer_size(), session_.SessionLength());
+  for (int i = 0; i < 10; ++i) {
+    SCOPED_TRACE("Calling VerifyPacket");
+    VerifyPacket(frame_buffer_ + i * packet_buffer_size(), i);
+  }
+}
+
 TEST_F(TestSessionInfo, ErrorsEqualDecodableState) {
   packet_.seqNum = 0xFFFF;
   packet_.isFirstPacket = false;
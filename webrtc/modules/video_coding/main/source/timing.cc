@@ -139,9 +139,12 @@ void VCMTiming::UpdateCurrentDelay(int64_t render_time_ms,
 
 int32_t VCMTiming::StopDecodeTimer(uint32_t time_stamp,
                                    int64_t start_time_ms,
-                                   int64_t now_ms) {
+                                   int64_t now_ms,
+                                   FrameType frame_type,
+                                   uint32_t frame_size_bytes) {
   CriticalSectionScoped cs(crit_sect_);
-  int32_t time_diff_ms = codec_timer_.StopTimer(start_time_ms, now_ms);
+  int32_t time_diff_ms = codec_timer_.StopTimer(start_time_ms, now_ms,
+                                                frame_type, frame_size_bytes);
   assert(time_diff_ms >= 0);
   last_decode_ms_ = time_diff_ms;
   return 0;
@@ -210,6 +213,16 @@ bool VCMTiming::EnoughTimeToDecode(uint32_t available_processing_time_ms)
       max_decode_time_ms > 0;
 }
 
+bool VCMTiming::FrameDecodedInTime(FrameType frame_type,
+                                   uint32_t frame_size_bytes,
+                                   int64_t render_time_ms,
+                                   int64_t now_ms) const {
+  CriticalSectionScoped cs(crit_sect_);
+  const int32_t decode_time_ms =
+      codec_timer_.PredictDecodeTimeMs(frame_type, frame_size_bytes);
+  return now_ms + decode_time_ms + render_delay_ms_ <= render_time_ms;
+}
+
 uint32_t VCMTiming::TargetVideoDelay() const {
   CriticalSectionScoped cs(crit_sect_);
   return TargetDelayInternal();
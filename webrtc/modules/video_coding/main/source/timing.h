@@ -56,10 +56,13 @@ class VCMTiming {
                           int64_t actual_decode_time_ms);
 
   // Stops the decoder timer, should be called when the decoder returns a frame
-  // or when the decoded frame callback is called.
+  // or when the decoded frame callback is called. |frame_type| and
+  // |frame_size_bytes| describe the decoded frame.
   int32_t StopDecodeTimer(uint32_t time_stamp,
                           int64_t start_time_ms,
-                          int64_t now_ms);
+                          int64_t now_ms,
+                          FrameType frame_type,
+                          uint32_t frame_size_bytes);
 
   // Used to report that a frame is passed to decoding. Updates the timestamp
   // filter which is used to map between timestamps and receiver system time.
@@ -81,6 +84,14 @@ class VCMTiming {
   // certain amount of processing time.
   bool EnoughTimeToDecode(uint32_t available_processing_time_ms) const;
 
+  // Returns whether a frame of |frame_type| and |frame_size_bytes| is
+  // predicted to be decoded in time to be rendered at |render_time_ms|, if
+  // its decoding starts at |now_ms|.
+  bool FrameDecodedInTime(FrameType frame_type,
+                          uint32_t frame_size_bytes,
+                          int64_t render_time_ms,
+                          int64_t now_ms) const;
+
   // Return current timing information.
   void GetTimings(int* decode_ms,
                   int* max_decode_ms,
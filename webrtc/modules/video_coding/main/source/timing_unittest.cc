@@ -86,7 +86,7 @@ TEST(ReceiverTiming, Tests) {
     int64_t startTimeMs = clock.TimeInMilliseconds();
     clock.AdvanceTimeMilliseconds(10);
     timing.StopDecodeTimer(timeStamp, startTimeMs,
-                           clock.TimeInMilliseconds());
+                           clock.TimeInMilliseconds(), kVideoFrameDelta, 1000);
     timeStamp += 90000 / 25;
     clock.AdvanceTimeMilliseconds(1000 / 25 - 10);
     timing.IncomingTimestamp(timeStamp, clock.TimeInMilliseconds());
@@ -124,6 +124,36 @@ TEST(ReceiverTiming, Tests) {
   timing.UpdateCurrentDelay(timeStamp);
 }
 
+TEST(ReceiverTiming, PredictsDecodeTimeFromFrameTypeAndSize) {
+  SimulatedClock clock(0);
+  VCMTiming timing(&clock);
+  timing.set_render_delay(0);
+  // The first decoded frames are ignored, and then key frames of 10000 bytes
+  // take 30 ms and delta frames of 1000 bytes take 10 ms to decode.
+  for (int i = 0; i < 20; ++i) {
+    const bool key_frame = i % 2 == 0;
+    int64_t start_time_ms = clock.TimeInMilliseconds();
+    clock.AdvanceTimeMilliseconds(key_frame ? 30 : 10);
+    timing.StopDecodeTimer(0, start_time_ms, clock.TimeInMilliseconds(),
+                           key_frame ? kVideoFrameKey : kVideoFrameDelta,
+                           key_frame ? 10000 : 1000);
+  }
+  const int64_t now_ms = clock.TimeInMilliseconds();
+  EXPECT_TRUE(timing.FrameDecodedInTime(kVideoFrameDelta, 1000, now_ms + 10,
+                                        now_ms));
+  EXPECT_FALSE(timing.FrameDecodedInTime(kVideoFrameDelta, 1000, now_ms + 9,
+                                         now_ms));
+  // A delta frame of twice the size is predicted to take 15 ms.
+  EXPECT_TRUE(timing.FrameDecodedInTime(kVideoFrameDelta, 2000, now_ms + 15,
+                                        now_ms));
+  EXPECT_FALSE(timing.FrameDecodedInTime(kVideoFrameDelta, 2000, now_ms + 14,
+                                         now_ms));
+  EXPECT_TRUE(timing.FrameDecodedInTime(kVideoFrameKey, 10000, now_ms + 30,
+                                        now_ms));
+  EXPECT_FALSE(timing.FrameDecodedInTime(kVideoFrameKey, 10000, now_ms + 29,
+                                         now_ms));
+}
+
 TEST(ReceiverTiming, WrapAround) {
   const int kFramerate = 25;
   SimulatedClock clock(0);
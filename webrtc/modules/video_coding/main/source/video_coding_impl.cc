@@ -201,6 +201,14 @@ class VideoCodingModuleImpl : public VideoCodingModule {
     return sender_->SentFrameCount(&frameCount);
   }
 
+  virtual void SetPacerQueueDelay(int queue_ms) OVERRIDE {
+    sender_->SetPacerQueueDelay(queue_ms);
+  }
+
+  virtual uint32_t FramesDroppedByRateControl() const OVERRIDE {
+    return sender_->FramesDroppedByRateControl();
+  }
+
   virtual int SetSenderNackMode(SenderNackMode mode) OVERRIDE {
     return sender_->SetSenderNackMode(mode);
   }
@@ -286,6 +294,10 @@ class VideoCodingModuleImpl : public VideoCodingModule {
     return receiver_->Decode(maxWaitTimeMs);
   }
 
+  virtual int TimeUntilNextFrameMs() OVERRIDE {
+    return receiver_->TimeUntilNextFrameMs();
+  }
+
   virtual int32_t DecodeDualFrame(uint16_t maxWaitTimeMs) OVERRIDE {
     return receiver_->DecodeDualFrame(maxWaitTimeMs);
   }
@@ -324,6 +336,10 @@ class VideoCodingModuleImpl : public VideoCodingModule {
     return receiver_->DiscardedPackets();
   }
 
+  virtual uint32_t FramesDroppedByTiming() const OVERRIDE {
+    return receiver_->FramesDroppedByTiming();
+  }
+
   virtual int SetReceiverRobustnessMode(ReceiverRobustness robustnessMode,
                                         VCMDecodeErrorMode errorMode) OVERRIDE {
     return receiver_->SetReceiverRobustnessMode(robustnessMode, errorMode);
@@ -93,6 +93,8 @@ class VideoSender {
 
   int32_t IntraFrameRequest(int stream_index);
   int32_t EnableFrameDropper(bool enable);
+  void SetPacerQueueDelay(int queue_ms);
+  uint32_t FramesDroppedByRateControl() const;
 
   int SetSenderNackMode(SenderNackMode mode);
   int SetSenderReferenceSelection(bool enable);
@@ -153,6 +155,7 @@ class VideoReceiver {
   int RegisterRenderBufferSizeCallback(VCMRenderBufferSizeCallback* callback);
 
   int32_t Decode(uint16_t maxWaitTimeMs);
+  int TimeUntilNextFrameMs();
   int32_t DecodeDualFrame(uint16_t maxWaitTimeMs);
   int32_t ResetDecoder();
 
@@ -167,6 +170,7 @@ class VideoReceiver {
   int32_t Delay() const;
   int32_t ReceivedFrameCount(VCMFrameCount* frameCount) const;
   uint32_t DiscardedPackets() const;
+  uint32_t FramesDroppedByTiming() const;
 
   int SetReceiverRobustnessMode(ReceiverRobustness robustnessMode,
                                 VCMDecodeErrorMode errorMode);
@@ -471,6 +471,18 @@ int32_t VideoReceiver::RequestKeyFrame() {
   return VCM_OK;
 }
 
+int VideoReceiver::TimeUntilNextFrameMs() {
+  {
+    CriticalSectionScoped cs(_receiveCritSect);
+    if (!_receiverInited || !_codecDataBase.DecoderRegistered()) {
+      // Decode() wouldn't take a frame.
+      return -1;
+    }
+  }
+  return _receiver.TimeUntilNextFrameMs(
+      _codecDataBase.SupportsRenderScheduling());
+}
+
 int32_t VideoReceiver::DecodeDualFrame(uint16_t maxWaitTimeMs) {
   CriticalSectionScoped cs(_receiveCritSect);
   if (_dualReceiver.State() != kReceiving ||
@@ -715,6 +727,10 @@ uint32_t VideoReceiver::DiscardedPackets() const {
   return _receiver.DiscardedPackets();
 }
 
+uint32_t VideoReceiver::FramesDroppedByTiming() const {
+  return _receiver.FramesDroppedByTiming();
+}
+
 int VideoReceiver::SetReceiverRobustnessMode(
     ReceiverRobustness robustnessMode,
     VCMDecodeErrorMode decode_error_mode) {
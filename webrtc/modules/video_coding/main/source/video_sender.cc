@@ -359,13 +359,19 @@ int32_t VideoSender::AddVideoFrame(const I420VideoFrame& videoFrame,
   if (_nextFrameTypes[0] == kFrameEmpty) {
     return VCM_OK;
   }
+  if (videoFrame.native_handle() != NULL &&
+      !_encoder->SupportsNativeHandle()) {
+    // The frame has no I420 buffers for this encoder to read.
+    return VCM_PARAMETER_ERROR;
+  }
   if (_mediaOpt.DropFrame()) {
     return VCM_OK;
   }
   _mediaOpt.UpdateContentData(contentMetrics);
   int32_t ret =
       _encoder->Encode(videoFrame, codecSpecificInfo, _nextFrameTypes);
-  recorder_->Add(videoFrame);
+  if (videoFrame.native_handle() == NULL)
+    recorder_->Add(videoFrame);
   if (ret < 0) {
     LOG(LS_ERROR) << "Failed to encode frame. Error code: " << ret;
     return ret;
@@ -400,6 +406,14 @@ int32_t VideoSender::EnableFrameDropper(bool enable) {
   return VCM_OK;
 }
 
+void VideoSender::SetPacerQueueDelay(int queue_ms) {
+  _mediaOpt.SetPacerQueueDelay(queue_ms);
+}
+
+uint32_t VideoSender::FramesDroppedByRateControl() const {
+  return _mediaOpt.FramesDroppedByRateControl();
+}
+
 int VideoSender::SetSenderNackMode(SenderNackMode mode) {
   CriticalSectionScoped cs(_sendCritSect);
 
@@ -12,6 +12,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common.h"
+#include "webrtc/common_video/interface/texture_video_frame.h"
 #include "webrtc/modules/video_coding/codecs/interface/mock/mock_video_codec_interface.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8_common_types.h"
 #include "webrtc/modules/video_coding/codecs/vp8/temporal_layers.h"
@@ -32,6 +33,7 @@ using ::testing::ElementsAreArray;
 using ::testing::Field;
 using ::testing::NiceMock;
 using ::testing::Pointee;
+using ::testing::Property;
 using ::testing::Return;
 using ::testing::FloatEq;
 using std::vector;
@@ -166,6 +168,13 @@ class PacketizationCallback : public VCMPacketizationCallback {
   vector<FrameData> frame_data_;
 };
 
+class FakeNativeHandle : public NativeHandle {
+ public:
+  virtual int32_t AddRef() { return 1; }
+  virtual int32_t Release() { return 0; }
+  virtual void* GetHandle() { return NULL; }
+};
+
 class TestVideoSender : public ::testing::Test {
  protected:
   // Note: simulated clock starts at 1 seconds, since parts of webrtc use 0 as
@@ -309,6 +318,22 @@ TEST_F(TestVideoSenderWithMockEncoder, TestIntraRequestsInternalCapture) {
   EXPECT_EQ(-1, sender_->IntraFrameRequest(-1));
 }
 
+TEST_F(TestVideoSenderWithMockEncoder, TextureFramesReachSupportingEncoder) {
+  FakeNativeHandle handle;
+  TextureVideoFrame texture_frame(&handle, kDefaultWidth, kDefaultHeight, 0, 0);
+
+  EXPECT_CALL(encoder_, SupportsNativeHandle()).WillRepeatedly(Return(false));
+  EXPECT_CALL(encoder_, Encode(_, _, _)).Times(0);
+  EXPECT_EQ(VCM_PARAMETER_ERROR,
+            sender_->AddVideoFrame(texture_frame, NULL, NULL));
+
+  EXPECT_CALL(encoder_, SupportsNativeHandle()).WillRepeatedly(Return(true));
+  EXPECT_CALL(encoder_,
+              Encode(Property(&I420VideoFrame::native_handle, &handle), _, _))
+      .Times(1).WillRepeatedly(Return(0));
+  EXPECT_EQ(VCM_OK, sender_->AddVideoFrame(texture_frame, NULL, NULL));
+}
+
 class TestVideoSenderWithVp8 : public TestVideoSender {
  public:
   TestVideoSenderWithVp8()
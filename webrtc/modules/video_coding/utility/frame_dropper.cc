@@ -17,6 +17,7 @@ namespace webrtc
 
 const float kDefaultKeyFrameSizeAvgKBits = 0.9f;
 const float kDefaultKeyFrameRatio = 0.99f;
+const float kDefaultDeltaFrameSizeAvgKBits = 0.9f;
 const float kDefaultDropRatioAlpha = 0.9f;
 const float kDefaultDropRatioMax = 0.96f;
 const float kDefaultMaxTimeToDropFrames = 4.0f;  // In seconds.
@@ -25,6 +26,7 @@ FrameDropper::FrameDropper()
 :
 _keyFrameSizeAvgKbits(kDefaultKeyFrameSizeAvgKBits),
 _keyFrameRatio(kDefaultKeyFrameRatio),
+_deltaFrameSizeAvgKbits(kDefaultDeltaFrameSizeAvgKBits),
 _dropRatio(kDefaultDropRatioAlpha, kDefaultDropRatioMax),
 _enabled(true),
 _max_time_drops(kDefaultMaxTimeToDropFrames)
@@ -36,6 +38,7 @@ FrameDropper::FrameDropper(float max_time_drops)
 :
 _keyFrameSizeAvgKbits(kDefaultKeyFrameSizeAvgKBits),
 _keyFrameRatio(kDefaultKeyFrameRatio),
+_deltaFrameSizeAvgKbits(kDefaultDeltaFrameSizeAvgKBits),
 _dropRatio(kDefaultDropRatioAlpha, kDefaultDropRatioMax),
 _enabled(true),
 _max_time_drops(max_time_drops)
@@ -52,6 +55,9 @@ FrameDropper::Reset()
     _keyFrameCount = 0;
     _accumulator = 0.0f;
     _accumulatorMax = 150.0f; // assume 300 kb/s and 0.5 s window
+    _deltaFrameSizeAvgKbits.Reset(kDefaultDeltaFrameSizeAvgKBits);
+    _targetKbitsPerFrame = 0.0f;
+    _pacerQueueKbits = 0.0f;
     _targetBitRate = 300.0f;
     _incoming_frame_rate = 30;
     _keyFrameSpreadFrames = 0.5f * _incoming_frame_rate;
@@ -118,6 +124,7 @@ FrameDropper::Fill(uint32_t frameSizeBytes, bool deltaFrame)
     {
         // Decrease the keyFrameRatio
         _keyFrameRatio.Apply(1.0, 0.0);
+        _deltaFrameSizeAvgKbits.Apply(1, frameSizeKbits);
     }
     // Change the level of the accumulator (bucket)
     _accumulator += frameSizeKbits;
@@ -158,6 +165,7 @@ FrameDropper::Leak(uint32_t inputFrameRate)
         }
         _keyFrameCount--;
     }
+    _targetKbitsPerFrame = T;
     _accumulator -= T;
     if (_accumulator < 0.0f)
     {
@@ -185,7 +193,10 @@ FrameDropper::FillBucket(float inKbits, float outKbits)
 void
 FrameDropper::UpdateRatio()
 {
-    if (_accumulator > 1.3f * _accumulatorMax)
+    // Compare the level the accumulator is expected to reach, so that the
+    // drop ratio starts increasing before the target rate is overshot.
+    const float level = _accumulator + LookaheadKbits();
+    if (level > 1.3f * _accumulatorMax)
     {
         // Too far above accumulator max, react faster
         _dropRatio.UpdateBase(0.8f);
@@ -195,7 +206,7 @@ FrameDropper::UpdateRatio()
         // Go back to normal reaction
         _dropRatio.UpdateBase(0.9f);
     }
-    if (_accumulator > _accumulatorMax)
+    if (level > _accumulatorMax)
     {
         // We are above accumulator max, and should ideally
         // drop a frame. Increase the dropRatio and drop
@@ -217,7 +228,21 @@ FrameDropper::UpdateRatio()
     {
         _dropRatio.Apply(1.0f, 0.0f);
     }
-    _wasBelowMax = _accumulator < _accumulatorMax;
+    _wasBelowMax = level < _accumulatorMax;
+}
+
+float
+FrameDropper::LookaheadKbits() const
+{
+    // The data in the pacer queue has been produced but not sent yet, and the
+    // next frame is expected to add its overshoot of the per frame target.
+    float lookaheadKbits = _pacerQueueKbits;
+    const float expectedFrameKbits = _deltaFrameSizeAvgKbits.filtered();
+    if (!_fastMode && expectedFrameKbits > _targetKbitsPerFrame)
+    {
+        lookaheadKbits += expectedFrameKbits - _targetKbitsPerFrame;
+    }
+    return lookaheadKbits;
 }
 
 // This function signals when to drop frames to the caller. It makes use of the dropRatio
@@ -347,6 +372,17 @@ FrameDropper::SetRates(float bitRate, float incoming_frame_rate)
     _incoming_frame_rate = incoming_frame_rate;
 }
 
+void
+FrameDropper::SetPacerQueueMs(int queueMs)
+{
+    if (!_enabled || _targetBitRate <= 0.0f || queueMs <= 0)
+    {
+        _pacerQueueKbits = 0.0f;
+        return;
+    }
+    _pacerQueueKbits = _targetBitRate * queueMs / 1000.0f;
+}
+
 float
 FrameDropper::ActualFrameRate(uint32_t inputFrameRate) const
 {
@@ -62,6 +62,15 @@ public:
     //          - bitRate       : The target bit rate
     virtual void SetRates(float bitRate, float incoming_frame_rate);
 
+    // Sets the time the oldest packet has waited in the pacer queue. The data
+    // still queued, and the expected size of the next frame, are counted
+    // ahead of time, so that frames are dropped evenly before the target
+    // rate is overshot rather than in bursts after it.
+    //
+    // Input:
+    //          - queueMs       : The pacer queue delay in ms.
+    virtual void SetPacerQueueMs(int queueMs);
+
     // Return value     : The current average frame rate produced
     //                    if the DropFrame() function is used as
     //                    instruction of when to drop frames.
@@ -71,6 +80,8 @@ private:
     void FillBucket(float inKbits, float outKbits);
     void UpdateRatio();
     void CapAccumulator();
+    // The bits expected to be added to the accumulator before they can leak.
+    float LookaheadKbits() const;
 
     rtc::ExpFilter _keyFrameSizeAvgKbits;
     rtc::ExpFilter _keyFrameRatio;
@@ -78,6 +89,9 @@ private:
     int32_t _keyFrameCount;
     float _accumulator;
     float _accumulatorMax;
+    rtc::ExpFilter _deltaFrameSizeAvgKbits;
+    float _targetKbitsPerFrame;
+    float _pacerQueueKbits;
     float _targetBitRate;
     bool _dropNext;
     rtc::ExpFilter _dropRatio;
@@ -32,6 +32,8 @@ class MockFrameDropper : public FrameDropper {
       void(uint32_t inputFrameRate));
   MOCK_METHOD2(SetRates,
       void(float bitRate, float incoming_frame_rate));
+  MOCK_METHOD1(SetPacerQueueMs,
+      void(int queueMs));
   MOCK_CONST_METHOD1(ActualFrameRate,
       float(uint32_t inputFrameRate));
 };
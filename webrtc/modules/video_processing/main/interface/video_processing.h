@@ -271,6 +271,25 @@ class VideoProcessingModule : public Module {
   Enable content analysis
   */
   virtual void EnableContentAnalysis(bool enable) = 0;
+
+  /**
+  Analyze the content of each frame in horizontal stripes, in parallel on
+  |num_threads| threads including the calling one. The metrics are the same
+  as with one thread, which is the default.
+
+  \return VPM_OK on success, VPM_GENERAL_ERROR if the threads can't be started
+  */
+  virtual int32_t SetContentAnalysisThreads(int num_threads) = 0;
+
+  /**
+  Compute coarser content metrics for less work: only every |row_factor|th of
+  the normally sampled rows is analyzed, and only every |frame_interval|th
+  frame. The defaults are 1 and 2.
+
+  \return VPM_OK on success, a negative value on error (see error codes)
+  */
+  virtual int32_t SetContentAnalysisSubsampling(int row_factor,
+                                                int frame_interval) = 0;
 };
 
 }  // namespace webrtc
@@ -17,13 +17,30 @@
 
 namespace webrtc {
 
+namespace {
+// The number of rows to step for complexity reduction at a frame size.
+int SkipNumForSize(int width, int height) {
+  // use skipNum = 4 for FULLL_HD images
+  if ( (height >=  1080) && (width >= 1920) )
+    return 4;
+  // use skipNum = 2 for 4CIF, WHD
+  if ( (height >=  576) && (width >= 704) )
+    return 2;
+  return 1;
+}
+}  // namespace
+
 VPMContentAnalysis::VPMContentAnalysis(bool runtime_cpu_detection)
     : orig_frame_(NULL),
       prev_frame_(NULL),
       width_(0),
       height_(0),
       skip_num_(1),
+      row_subsampling_(1),
       border_(8),
+      pool_(NULL),
+      spatial_sums_(1),
+      temporal_diff_sums_(1),
       motion_magnitude_(0.0f),
       spatial_pred_err_(0.0f),
       spatial_pred_err_h_(0.0f),
@@ -31,14 +48,14 @@ VPMContentAnalysis::VPMContentAnalysis(bool runtime_cpu_detection)
       first_frame_(true),
       ca_Init_(false),
       content_metrics_(NULL) {
-  ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_C;
-  TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_C;
+  SpatialSumsOfRows = &VPMContentAnalysis::SpatialSums_C;
+  TemporalDiffSumsOfRows = &VPMContentAnalysis::TemporalDiffSums_C;
 
   if (runtime_cpu_detection) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
     if (WebRtc_GetCPUInfo(kSSE2)) {
-      ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_SSE2;
-      TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_SSE2;
+      SpatialSumsOfRows = &VPMContentAnalysis::SpatialSums_SSE2;
+      TemporalDiffSumsOfRows = &VPMContentAnalysis::TemporalDiffSums_SSE2;
     }
 #endif
   }
@@ -63,8 +80,15 @@ VideoContentMetrics* VPMContentAnalysis::ComputeContentMetrics(
   // Only interested in the Y plane.
   orig_frame_ = inputFrame.buffer(kYPlane);
 
+  // Sum up the stripes of the frame, in parallel if there is a pool.
+  if (pool_) {
+    pool_->RunInParallel(this, static_cast<int>(spatial_sums_.size()));
+  } else {
+    Run(0);
+  }
+
   // Compute spatial metrics: 3 spatial prediction errors.
-  (this->*ComputeSpatialMetrics)();
+  ComputeSpatialMetrics();
 
   // Compute motion metrics
   if (first_frame_ == false)
@@ -104,16 +128,7 @@ int32_t VPMContentAnalysis::Initialize(int width, int height) {
 
   // skip parameter: # of skipped rows: for complexity reduction
   //  temporal also currently uses it for column reduction.
-  skip_num_ = 1;
-
-  // use skipNum = 2 for 4CIF, WHD
-  if ( (height_ >=  576) && (width_ >= 704) ) {
-    skip_num_ = 2;
-  }
-  // use skipNum = 4 for FULLL_HD images
-  if ( (height_ >=  1080) && (width_ >= 1920) ) {
-    skip_num_ = 4;
-  }
+  skip_num_ = SkipNumForSize(width_, height_) * row_subsampling_;
 
   if (content_metrics_ != NULL) {
     delete content_metrics_;
@@ -142,22 +157,75 @@ int32_t VPMContentAnalysis::Initialize(int width, int height) {
 }
 
 
+void VPMContentAnalysis::SetThreadPool(ThreadPool* pool) {
+  pool_ = pool;
+  const int num_stripes = pool ? pool->num_threads() + 1 : 1;
+  spatial_sums_.resize(num_stripes);
+  temporal_diff_sums_.resize(num_stripes);
+}
+
+void VPMContentAnalysis::SetRowSubsampling(int factor) {
+  row_subsampling_ = factor > 1 ? factor : 1;
+  skip_num_ = SkipNumForSize(width_, height_) * row_subsampling_;
+}
+
+// Each stripe gets an equal share of the sampled rows.
+void VPMContentAnalysis::Run(int index) {
+  const int num_stripes = static_cast<int>(spatial_sums_.size());
+  const int num_rows = (height_ - 2 * border_ + skip_num_ - 1) / skip_num_;
+  const int first_row = border_ + num_rows * index / num_stripes * skip_num_;
+  const int end_row =
+      border_ + num_rows * (index + 1) / num_stripes * skip_num_;
+
+  spatial_sums_[index] = SpatialSums();
+  (this->*SpatialSumsOfRows)(first_row, end_row, &spatial_sums_[index]);
+  temporal_diff_sums_[index] = TemporalDiffSums();
+  if (first_frame_ == false) {
+    (this->*TemporalDiffSumsOfRows)(first_row, end_row,
+                                    &temporal_diff_sums_[index]);
+  }
+}
+
 // Compute motion metrics: magnitude over non-zero motion vectors,
 //  and size of zero cluster
-int32_t VPMContentAnalysis::ComputeMotionMetrics() {
-  // Motion metrics: only one is derived from normalized
-  //  (MAD) temporal difference
-  (this->*TemporalDiffMetric)();
-  return VPM_OK;
+// Motion metrics: only one is derived from normalized
+//  (MAD) temporal difference
+// Normalize MAD by spatial contrast: images with more contrast
+//  (pixel variance) likely have larger temporal difference
+void VPMContentAnalysis::ComputeMotionMetrics() {
+  uint32_t tempDiffSum = 0;
+  uint32_t pixelSum = 0;
+  uint64_t pixelSqSum = 0;
+  uint32_t num_pixels = 0;
+  for (size_t i = 0; i < temporal_diff_sums_.size(); ++i) {
+    tempDiffSum += temporal_diff_sums_[i].temp_diff_sum;
+    pixelSum += temporal_diff_sums_[i].pixel_sum;
+    pixelSqSum += temporal_diff_sums_[i].pixel_sq_sum;
+    num_pixels += temporal_diff_sums_[i].num_pixels;
+  }
+
+  // Default.
+  motion_magnitude_ = 0.0f;
+
+  if (tempDiffSum == 0) return;
+
+  // Normalize over all pixels.
+  float const tempDiffAvg = (float)tempDiffSum / (float)(num_pixels);
+  float const pixelSumAvg = (float)pixelSum / (float)(num_pixels);
+  float const pixelSqSumAvg = (float)pixelSqSum / (float)(num_pixels);
+  float contrast = pixelSqSumAvg - (pixelSumAvg * pixelSumAvg);
+
+  if (contrast > 0.0) {
+    contrast = sqrt(contrast);
+    motion_magnitude_ = tempDiffAvg/contrast;
+  }
 }
 
 // Normalized temporal difference (MAD): used as a motion level metric
-// Normalize MAD by spatial contrast: images with more contrast
-//  (pixel variance) likely have larger temporal difference
 // To reduce complexity, we compute the metric for a reduced set of points.
-int32_t VPMContentAnalysis::TemporalDiffMetric_C() {
+void VPMContentAnalysis::TemporalDiffSums_C(int first_row, int end_row,
+                                            TemporalDiffSums* sums) const {
   // size of original frame
-  int sizei = height_;
   int sizej = width_;
   uint32_t tempDiffSum = 0;
   uint32_t pixelSum = 0;
@@ -166,7 +234,7 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_C() {
   uint32_t num_pixels = 0;  // Counter for # of pixels.
   const int width_end = ((width_ - 2*border_) & -16) + border_;
 
-  for (int i = border_; i < sizei - border_; i += skip_num_) {
+  for (int i = first_row; i < end_row; i += skip_num_) {
     for (int j = border_; j < width_end; j++) {
       num_pixels += 1;
       int ssn =  i * sizej + j;
@@ -180,22 +248,10 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_C() {
     }
   }
 
-  // Default.
-  motion_magnitude_ = 0.0f;
-
-  if (tempDiffSum == 0) return VPM_OK;
-
-  // Normalize over all pixels.
-  float const tempDiffAvg = (float)tempDiffSum / (float)(num_pixels);
-  float const pixelSumAvg = (float)pixelSum / (float)(num_pixels);
-  float const pixelSqSumAvg = (float)pixelSqSum / (float)(num_pixels);
-  float contrast = pixelSqSumAvg - (pixelSumAvg * pixelSumAvg);
-
-  if (contrast > 0.0) {
-    contrast = sqrt(contrast);
-    motion_magnitude_ = tempDiffAvg/contrast;
-  }
-  return VPM_OK;
+  sums->temp_diff_sum = tempDiffSum;
+  sums->pixel_sum = pixelSum;
+  sums->pixel_sq_sum = pixelSqSum;
+  sums->num_pixels = num_pixels;
 }
 
 // Compute spatial metrics:
@@ -205,8 +261,34 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_C() {
 // The metrics are a simple estimate of the up-sampling prediction error,
 // estimated assuming sub-sampling for decimation (no filtering),
 // and up-sampling back up with simple bilinear interpolation.
-int32_t VPMContentAnalysis::ComputeSpatialMetrics_C() {
-  const int sizei = height_;
+void VPMContentAnalysis::ComputeSpatialMetrics() {
+  uint32_t spatialErrSum = 0;
+  uint32_t spatialErrVSum = 0;
+  uint32_t spatialErrHSum = 0;
+  uint32_t pixelMSA = 0;
+  for (size_t i = 0; i < spatial_sums_.size(); ++i) {
+    spatialErrSum += spatial_sums_[i].spatial_err_sum;
+    spatialErrVSum += spatial_sums_[i].spatial_err_v_sum;
+    spatialErrHSum += spatial_sums_[i].spatial_err_h_sum;
+    pixelMSA += spatial_sums_[i].pixel_msa;
+  }
+
+  // Normalize over all pixels.
+  const float spatialErr = (float)(spatialErrSum >> 2);
+  const float spatialErrH = (float)(spatialErrHSum >> 1);
+  const float spatialErrV = (float)(spatialErrVSum >> 1);
+  const float norm = (float)pixelMSA;
+
+  // 2X2:
+  spatial_pred_err_ = spatialErr / norm;
+  // 1X2:
+  spatial_pred_err_h_ = spatialErrH / norm;
+  // 2X1:
+  spatial_pred_err_v_ = spatialErrV / norm;
+}
+
+void VPMContentAnalysis::SpatialSums_C(int first_row, int end_row,
+                                       SpatialSums* sums) const {
   const int sizej = width_;
 
   // Pixel mean square average: used to normalize the spatial metrics.
@@ -219,7 +301,7 @@ int32_t VPMContentAnalysis::ComputeSpatialMetrics_C() {
   // make sure work section is a multiple of 16
   const int width_end = ((sizej - 2*border_) & -16) + border_;
 
-  for (int i = border_; i < sizei - border_; i += skip_num_) {
+  for (int i = first_row; i < end_row; i += skip_num_) {
     for (int j = border_; j < width_end; j++) {
       int ssn1=  i * sizej + j;
       int ssn2 = (i + 1) * sizej + j; // bottom
@@ -245,19 +327,10 @@ int32_t VPMContentAnalysis::ComputeSpatialMetrics_C() {
     }
   }
 
-  // Normalize over all pixels.
-  const float spatialErr = (float)(spatialErrSum >> 2);
-  const float spatialErrH = (float)(spatialErrHSum >> 1);
-  const float spatialErrV = (float)(spatialErrVSum >> 1);
-  const float norm = (float)pixelMSA;
-
-  // 2X2:
-  spatial_pred_err_ = spatialErr / norm;
-  // 1X2:
-  spatial_pred_err_h_ = spatialErrH / norm;
-  // 2X1:
-  spatial_pred_err_v_ = spatialErrV / norm;
-  return VPM_OK;
+  sums->spatial_err_sum = spatialErrSum;
+  sums->spatial_err_v_sum = spatialErrVSum;
+  sums->spatial_err_h_sum = spatialErrHSum;
+  sums->pixel_msa = pixelMSA;
 }
 
 VideoContentMetrics* VPMContentAnalysis::ContentMetrics() {
@@ -11,19 +11,22 @@
 #ifndef WEBRTC_MODULES_VIDEO_PROCESSING_MAIN_SOURCE_CONTENT_ANALYSIS_H
 #define WEBRTC_MODULES_VIDEO_PROCESSING_MAIN_SOURCE_CONTENT_ANALYSIS_H
 
+#include <vector>
+
 #include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/modules/interface/module_common_types.h"
 #include "webrtc/modules/video_processing/main/interface/video_processing_defines.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
-class VPMContentAnalysis {
+class VPMContentAnalysis : public ParallelTask {
  public:
   // When |runtime_cpu_detection| is true, runtime selection of an optimized
   // code path is allowed.
   explicit VPMContentAnalysis(bool runtime_cpu_detection);
-  ~VPMContentAnalysis();
+  virtual ~VPMContentAnalysis();
 
   // Initialize ContentAnalysis - should be called prior to
   //  extractContentFeature
@@ -42,27 +45,65 @@ class VPMContentAnalysis {
   // Output: 0 if OK, negative value upon error
   int32_t Release();
 
+  // Splits each frame into a stripe for each thread of |pool| and one for the
+  // calling thread, which are analyzed in parallel. NULL analyzes the whole
+  // frame on the calling thread. The metrics don't depend on the number of
+  // stripes.
+  void SetThreadPool(ThreadPool* pool);
+
+  // Only analyzes every |factor|th of the rows that would be sampled for the
+  // frame size. Coarser metrics for less work.
+  void SetRowSubsampling(int factor);
+
+  // Implements ParallelTask. Analyzes stripe |index|.
+  virtual void Run(int index) OVERRIDE;
+
  private:
+  // Sums over a stripe of rows, added up for the whole frame.
+  struct TemporalDiffSums {
+    TemporalDiffSums()
+        : temp_diff_sum(0), pixel_sum(0), pixel_sq_sum(0), num_pixels(0) {}
+    uint32_t temp_diff_sum;
+    uint32_t pixel_sum;
+    uint64_t pixel_sq_sum;
+    uint32_t num_pixels;
+  };
+  struct SpatialSums {
+    SpatialSums()
+        : spatial_err_sum(0), spatial_err_v_sum(0), spatial_err_h_sum(0),
+          pixel_msa(0) {}
+    uint32_t spatial_err_sum;
+    uint32_t spatial_err_v_sum;
+    uint32_t spatial_err_h_sum;
+    uint32_t pixel_msa;
+  };
+
   // return motion metrics
   VideoContentMetrics* ContentMetrics();
 
-  // Normalized temporal difference metric: for motion magnitude
-  typedef int32_t (VPMContentAnalysis::*TemporalDiffMetricFunc)();
-  TemporalDiffMetricFunc TemporalDiffMetric;
-  int32_t TemporalDiffMetric_C();
+  // Normalized temporal difference metric: for motion magnitude. Computed
+  // over the sampled rows in [first_row, end_row).
+  typedef void (VPMContentAnalysis::*TemporalDiffSumsFunc)(
+      int first_row, int end_row, TemporalDiffSums* sums) const;
+  TemporalDiffSumsFunc TemporalDiffSumsOfRows;
+  void TemporalDiffSums_C(int first_row, int end_row,
+                          TemporalDiffSums* sums) const;
 
-  // Motion metric method: call 2 metrics (magnitude and size)
-  int32_t ComputeMotionMetrics();
+  // Motion metric method: derives the magnitude from the sums of all stripes.
+  void ComputeMotionMetrics();
 
   // Spatial metric method: computes the 3 frame-average spatial
   //  prediction errors (1x2,2x1,2x2)
-  typedef int32_t (VPMContentAnalysis::*ComputeSpatialMetricsFunc)();
-  ComputeSpatialMetricsFunc ComputeSpatialMetrics;
-  int32_t ComputeSpatialMetrics_C();
+  typedef void (VPMContentAnalysis::*SpatialSumsFunc)(
+      int first_row, int end_row, SpatialSums* sums) const;
+  SpatialSumsFunc SpatialSumsOfRows;
+  void SpatialSums_C(int first_row, int end_row, SpatialSums* sums) const;
+  void ComputeSpatialMetrics();
 
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-  int32_t ComputeSpatialMetrics_SSE2();
-  int32_t TemporalDiffMetric_SSE2();
+  void SpatialSums_SSE2(int first_row, int end_row, SpatialSums* sums) const;
+  void TemporalDiffSums_SSE2(int first_row, int end_row,
+                             TemporalDiffSums* sums) const;
 #endif
 
   const uint8_t* orig_frame_;
@@ -70,8 +111,14 @@ class VPMContentAnalysis {
   int width_;
   int height_;
   int skip_num_;
+  int row_subsampling_;
   int border_;
 
+  ThreadPool* pool_;
+  // One per stripe.
+  std::vector<SpatialSums> spatial_sums_;
+  std::vector<TemporalDiffSums> temporal_diff_sums_;
+
   // Content Metrics: Stores the local average of the metrics.
   float motion_magnitude_;   // motion class
   float spatial_pred_err_;   // spatial class
@@ -11,14 +11,14 @@
 #include "webrtc/modules/video_processing/main/source/content_analysis.h"
 
 #include <emmintrin.h>
-#include <math.h>
 
 namespace webrtc {
 
-int32_t VPMContentAnalysis::TemporalDiffMetric_SSE2() {
+void VPMContentAnalysis::TemporalDiffSums_SSE2(int first_row, int end_row,
+                                               TemporalDiffSums* sums) const {
   uint32_t num_pixels = 0;       // counter for # of pixels
-  const uint8_t* imgBufO = orig_frame_ + border_*width_ + border_;
-  const uint8_t* imgBufP = prev_frame_ + border_*width_ + border_;
+  const uint8_t* imgBufO = orig_frame_ + first_row*width_ + border_;
+  const uint8_t* imgBufP = prev_frame_ + first_row*width_ + border_;
 
   const int32_t width_end = ((width_ - 2*border_) & -16) + border_;
 
@@ -27,7 +27,7 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_SSE2() {
   __m128i sqsum_64 = _mm_setzero_si128();
   const __m128i z  = _mm_setzero_si128();
 
-  for (uint16_t i = 0; i < (height_ - 2*border_); i += skip_num_) {
+  for (int i = first_row; i < end_row; i += skip_num_) {
     __m128i sqsum_32  = _mm_setzero_si128();
 
     const uint8_t *lineO = imgBufO;
@@ -93,27 +93,15 @@ int32_t VPMContentAnalysis::TemporalDiffMetric_SSE2() {
   const uint64_t pixelSqSum = sqsum_final_64[0] + sqsum_final_64[1];
   const uint32_t tempDiffSum = sad_final_64[0] + sad_final_64[1];
 
-  // Default.
-  motion_magnitude_ = 0.0f;
-
-  if (tempDiffSum == 0) return VPM_OK;
-
-  // Normalize over all pixels.
-  const float tempDiffAvg = (float)tempDiffSum / (float)(num_pixels);
-  const float pixelSumAvg = (float)pixelSum / (float)(num_pixels);
-  const float pixelSqSumAvg = (float)pixelSqSum / (float)(num_pixels);
-  float contrast = pixelSqSumAvg - (pixelSumAvg * pixelSumAvg);
-
-  if (contrast > 0.0) {
-    contrast = sqrt(contrast);
-    motion_magnitude_ = tempDiffAvg/contrast;
-  }
-
-  return VPM_OK;
+  sums->temp_diff_sum = tempDiffSum;
+  sums->pixel_sum = pixelSum;
+  sums->pixel_sq_sum = pixelSqSum;
+  sums->num_pixels = num_pixels;
 }
 
-int32_t VPMContentAnalysis::ComputeSpatialMetrics_SSE2() {
-  const uint8_t* imgBuf = orig_frame_ + border_*width_;
+void VPMContentAnalysis::SpatialSums_SSE2(int first_row, int end_row,
+                                          SpatialSums* sums) const {
+  const uint8_t* imgBuf = orig_frame_ + first_row*width_;
   const int32_t width_end = ((width_ - 2 * border_) & -16) + border_;
 
   __m128i se_32  = _mm_setzero_si128();
@@ -127,7 +115,7 @@ int32_t VPMContentAnalysis::ComputeSpatialMetrics_SSE2() {
   // value is maxed out at 65529 for every row, 65529*1080 = 70777800, which
   // will not roll over a 32 bit accumulator.
   // skip_num_ is also used to reduce the number of rows
-  for (int32_t i = 0; i < (height_ - 2*border_); i += skip_num_) {
+  for (int32_t i = first_row; i < end_row; i += skip_num_) {
     __m128i se_16  = _mm_setzero_si128();
     __m128i sev_16 = _mm_setzero_si128();
     __m128i seh_16 = _mm_setzero_si128();
@@ -243,22 +231,10 @@ int32_t VPMContentAnalysis::ComputeSpatialMetrics_SSE2() {
   const uint32_t spatialErrHSum = seh_64[0] + seh_64[1];
   const uint32_t pixelMSA = msa_64[0] + msa_64[1];
 
-  // Normalize over all pixels.
-  const float spatialErr  = (float)(spatialErrSum >> 2);
-  const float spatialErrH = (float)(spatialErrHSum >> 1);
-  const float spatialErrV = (float)(spatialErrVSum >> 1);
-  const float norm = (float)pixelMSA;
-
-  // 2X2:
-  spatial_pred_err_ = spatialErr / norm;
-
-  // 1X2:
-  spatial_pred_err_h_ = spatialErrH / norm;
-
-  // 2X1:
-  spatial_pred_err_v_ = spatialErrV / norm;
-
-    return VPM_OK;
+  sums->spatial_err_sum = spatialErrSum;
+  sums->spatial_err_v_sum = spatialErrVSum;
+  sums->spatial_err_h_sum = spatialErrHSum;
+  sums->pixel_msa = pixelMSA;
 }
 
 }  // namespace webrtc
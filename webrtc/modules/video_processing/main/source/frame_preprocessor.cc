@@ -17,6 +17,7 @@ VPMFramePreprocessor::VPMFramePreprocessor()
       content_metrics_(NULL),
       resampled_frame_(),
       enable_ca_(false),
+      ca_frame_interval_(kSkipFrameCA),
       frame_cnt_(0) {
   spatial_resampler_ = new VPMSimpleSpatialResampler();
   ca_ = new VPMContentAnalysis(true);
@@ -53,6 +54,32 @@ void VPMFramePreprocessor::EnableContentAnalysis(bool enable) {
   enable_ca_ = enable;
 }
 
+int32_t VPMFramePreprocessor::SetContentAnalysisThreads(int num_threads) {
+  if (num_threads < 1)
+    return VPM_PARAMETER_ERROR;
+  // The analysis must not use the old pool while it is replaced.
+  ca_->SetThreadPool(NULL);
+  ca_pool_.reset();
+  if (num_threads == 1)
+    return VPM_OK;
+  // The calling thread analyzes a stripe too.
+  ca_pool_.reset(ThreadPool::Create("VideoPreprocessing", num_threads - 1,
+                                    kHighPriority));
+  if (!ca_pool_)
+    return VPM_GENERAL_ERROR;
+  ca_->SetThreadPool(ca_pool_.get());
+  return VPM_OK;
+}
+
+int32_t VPMFramePreprocessor::SetContentAnalysisSubsampling(
+    int row_factor, int frame_interval) {
+  if (row_factor < 1 || frame_interval < 1)
+    return VPM_PARAMETER_ERROR;
+  ca_->SetRowSubsampling(row_factor);
+  ca_frame_interval_ = frame_interval;
+  return VPM_OK;
+}
+
 void  VPMFramePreprocessor::SetInputFrameResampleMode(
     VideoFrameResampling resampling_mode) {
   spatial_resampler_->SetInputFrameResampleMode(resampling_mode);
@@ -116,9 +143,9 @@ int32_t VPMFramePreprocessor::PreprocessFrame(const I420VideoFrame& frame,
 
   // Perform content analysis on the frame to be encoded.
   if (enable_ca_) {
-    // Compute new metrics every |kSkipFramesCA| frames, starting with
+    // Compute new metrics every |ca_frame_interval_| frames, starting with
     // the first frame.
-    if (frame_cnt_ % kSkipFrameCA == 0) {
+    if (frame_cnt_ % ca_frame_interval_ == 0) {
       if (*processed_frame == NULL)  {
         content_metrics_ = ca_->ComputeContentMetrics(frame);
       } else {
@@ -18,6 +18,8 @@
 #include "webrtc/modules/video_processing/main/source/content_analysis.h"
 #include "webrtc/modules/video_processing/main/source/spatial_resampler.h"
 #include "webrtc/modules/video_processing/main/source/video_decimator.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -39,6 +41,13 @@ class VPMFramePreprocessor {
   // Enable content analysis.
   void EnableContentAnalysis(bool enable);
 
+  // Analyze each frame in stripes on |num_threads| threads. Kept over Reset().
+  int32_t SetContentAnalysisThreads(int num_threads);
+
+  // Analyze every |row_factor|th sampled row of every |frame_interval|th
+  // frame. Kept over Reset().
+  int32_t SetContentAnalysisSubsampling(int row_factor, int frame_interval);
+
   // Set target resolution: frame rate and dimension.
   int32_t SetTargetResolution(uint32_t width, uint32_t height,
                               uint32_t frame_rate);
@@ -60,7 +69,7 @@ class VPMFramePreprocessor {
 
  private:
   // The content does not change so much every frame, so to reduce complexity
-  // we can compute new content metrics every |kSkipFrameCA| frames.
+  // we can compute new content metrics every |kSkipFrameCA| frames by default.
   enum { kSkipFrameCA = 2 };
 
   int32_t id_;
@@ -69,7 +78,9 @@ class VPMFramePreprocessor {
   VPMSpatialResampler* spatial_resampler_;
   VPMContentAnalysis* ca_;
   VPMVideoDecimator* vd_;
+  scoped_ptr<ThreadPool> ca_pool_;
   bool enable_ca_;
+  int ca_frame_interval_;
   int frame_cnt_;
 
 };
@@ -56,12 +56,13 @@ int32_t VPMSimpleSpatialResampler::ResampleFrame(const I420VideoFrame& inFrame,
     return VPM_OK;
   }
 
-  // Setting scaler
-  // TODO(mikhal/marpan): Should we allow for setting the filter mode in
-  // _scale.Set() with |resampling_mode_|?
+  // Setting scaler. Box filtering is used unless bilinear filtering is asked
+  // for, as point filtering aliases badly when downscaling.
+  const ScaleMethod method =
+      resampling_mode_ == kBiLinear ? kScaleBilinear : kScaleBox;
   int ret_val = 0;
   ret_val = scaler_.Set(inFrame.width(), inFrame.height(),
-                       target_width_, target_height_, kI420, kI420, kScaleBox);
+                       target_width_, target_height_, kI420, kI420, method);
   if (ret_val < 0)
     return ret_val;
 
@@ -202,4 +202,16 @@ void VideoProcessingModuleImpl::EnableContentAnalysis(bool enable) {
   frame_pre_processor_.EnableContentAnalysis(enable);
 }
 
+int32_t VideoProcessingModuleImpl::SetContentAnalysisThreads(int num_threads) {
+  CriticalSectionScoped mutex(&mutex_);
+  return frame_pre_processor_.SetContentAnalysisThreads(num_threads);
+}
+
+int32_t VideoProcessingModuleImpl::SetContentAnalysisSubsampling(
+    int row_factor, int frame_interval) {
+  CriticalSectionScoped mutex(&mutex_);
+  return frame_pre_processor_.SetContentAnalysisSubsampling(row_factor,
+                                                            frame_interval);
+}
+
 }  // namespace webrtc
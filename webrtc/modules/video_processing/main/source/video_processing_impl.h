@@ -67,6 +67,10 @@ class VideoProcessingModuleImpl : public VideoProcessingModule {
                                   I420VideoFrame** processed_frame);
   virtual VideoContentMetrics* ContentMetrics() const;
 
+  virtual int32_t SetContentAnalysisThreads(int num_threads);
+  virtual int32_t SetContentAnalysisSubsampling(int row_factor,
+                                                int frame_interval);
+
  private:
   int32_t  id_;
   CriticalSectionWrapper& mutex_;
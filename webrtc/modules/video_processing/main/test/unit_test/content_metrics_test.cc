@@ -41,4 +41,51 @@ TEST_F(VideoProcessingModuleTest, ContentAnalysis) {
   ASSERT_NE(0, feof(source_file_)) << "Error reading source file";
 }
 
+TEST_F(VideoProcessingModuleTest, ContentAnalysisInStripes) {
+  VPMContentAnalysis ca_serial(true);
+  VPMContentAnalysis ca_striped(true);
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("ContentAnalysis", 2));
+  ASSERT_TRUE(pool.get() != NULL);
+  ca_striped.SetThreadPool(pool.get());
+
+  scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  while (fread(video_buffer.get(), 1, frame_length_, source_file_)
+       == frame_length_) {
+    EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0,
+                               width_, height_,
+                               0, kRotateNone, &video_frame_));
+    VideoContentMetrics* serial = ca_serial.ComputeContentMetrics(video_frame_);
+    VideoContentMetrics* striped =
+        ca_striped.ComputeContentMetrics(video_frame_);
+
+    // The stripes add up to the same integer sums.
+    ASSERT_EQ(serial->spatial_pred_err, striped->spatial_pred_err);
+    ASSERT_EQ(serial->spatial_pred_err_v, striped->spatial_pred_err_v);
+    ASSERT_EQ(serial->spatial_pred_err_h, striped->spatial_pred_err_h);
+    ASSERT_EQ(serial->motion_magnitude, striped->motion_magnitude);
+  }
+  ASSERT_NE(0, feof(source_file_)) << "Error reading source file";
+}
+
+TEST_F(VideoProcessingModuleTest, ContentAnalysisSubsampling) {
+  EXPECT_EQ(VPM_PARAMETER_ERROR, vpm_->SetContentAnalysisThreads(0));
+  EXPECT_EQ(VPM_OK, vpm_->SetContentAnalysisThreads(2));
+  EXPECT_EQ(VPM_PARAMETER_ERROR, vpm_->SetContentAnalysisSubsampling(0, 1));
+  EXPECT_EQ(VPM_PARAMETER_ERROR, vpm_->SetContentAnalysisSubsampling(1, 0));
+  EXPECT_EQ(VPM_OK, vpm_->SetContentAnalysisSubsampling(2, 3));
+  vpm_->EnableContentAnalysis(true);
+  ASSERT_EQ(VPM_OK, vpm_->SetTargetResolution(width_, height_, 30));
+
+  scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  ASSERT_EQ(frame_length_,
+            fread(video_buffer.get(), 1, frame_length_, source_file_));
+  EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0,
+                             width_, height_,
+                             0, kRotateNone, &video_frame_));
+  I420VideoFrame* processed_frame = NULL;
+  ASSERT_EQ(VPM_OK, vpm_->PreprocessFrame(video_frame_, &processed_frame));
+  ASSERT_TRUE(vpm_->ContentMetrics() != NULL);
+  EXPECT_GT(vpm_->ContentMetrics()->spatial_pred_err, 0.0f);
+}
+
 }  // namespace webrtc
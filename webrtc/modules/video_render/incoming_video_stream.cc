@@ -32,15 +32,18 @@
 namespace webrtc {
 
 IncomingVideoStream::IncomingVideoStream(const int32_t module_id,
-                                         const uint32_t stream_id)
+                                         const uint32_t stream_id,
+                                         VideoRenderScheduler* scheduler)
     : module_id_(module_id),
       stream_id_(stream_id),
       stream_critsect_(*CriticalSectionWrapper::CreateCriticalSection()),
       thread_critsect_(*CriticalSectionWrapper::CreateCriticalSection()),
       buffer_critsect_(*CriticalSectionWrapper::CreateCriticalSection()),
+      scheduler_(scheduler),
       incoming_render_thread_(),
       deliver_buffer_event_(*EventWrapper::Create()),
       running_(false),
+      frame_queue_(KFrameQueueSize),
       external_callback_(NULL),
       render_callback_(NULL),
       render_buffers_(*(new VideoRenderFrames)),
@@ -130,10 +133,20 @@ int32_t IncomingVideoStream::RenderFrame(const uint32_t stream_id,
     last_rate_calculation_time_ms_ = now_ms;
   }
 
-  // Insert frame.
-  CriticalSectionScoped csB(&buffer_critsect_);
-  if (render_buffers_.AddFrame(&video_frame) == 1)
-    deliver_buffer_event_.Set();
+  // Insert frame. The render thread is woken up for the first frame it
+  // hasn't seen yet; it takes every queued frame once awake.
+  if (!frame_queue_.Push(&video_frame)) {
+    WEBRTC_TRACE(kTraceWarning, kTraceVideoRenderer, module_id_,
+                 "%s: Render queue full for stream %d", __FUNCTION__,
+                 stream_id_);
+    return -1;
+  }
+  if (frame_queue_.size() == 1) {
+    if (scheduler_)
+      scheduler_->WakeUp();
+    else
+      deliver_buffer_event_.Set();
+  }
 
   return 0;
 }
@@ -208,6 +221,12 @@ int32_t IncomingVideoStream::Start() {
     return 0;
   }
 
+  if (scheduler_) {
+    scheduler_->AddStream(this);
+    running_ = true;
+    return 0;
+  }
+
   CriticalSectionScoped csT(&thread_critsect_);
   assert(incoming_render_thread_ == NULL);
 
@@ -246,6 +265,12 @@ int32_t IncomingVideoStream::Stop() {
     return 0;
   }
 
+  if (scheduler_) {
+    scheduler_->RemoveStream(this);
+    running_ = false;
+    return 0;
+  }
+
   thread_critsect_.Enter();
   if (incoming_render_thread_) {
     ThreadWrapper* thread = incoming_render_thread_;
@@ -272,6 +297,8 @@ int32_t IncomingVideoStream::Stop() {
 int32_t IncomingVideoStream::Reset() {
   CriticalSectionScoped cs_stream(&stream_critsect_);
   CriticalSectionScoped cs_buffer(&buffer_critsect_);
+  while (frame_queue_.Front())
+    frame_queue_.Pop();
   render_buffers_.ReleaseAllFrames();
   return 0;
 }
@@ -298,68 +325,81 @@ bool IncomingVideoStream::IncomingVideoStreamProcess() {
       thread_critsect_.Leave();
       return false;
     }
+    thread_critsect_.Leave();
 
-    I420VideoFrame* frame_to_render = NULL;
+    // Set timer for next frame to render.
+    deliver_buffer_event_.StartTimer(false, RenderDueFrames());
+  }
+  return true;
+}
 
-    // Get a new frame to render and the time for the frame after this one.
-    buffer_critsect_.Enter();
-    frame_to_render = render_buffers_.FrameToRender();
-    uint32_t wait_time = render_buffers_.TimeToNextFrameRelease();
-    buffer_critsect_.Leave();
+bool IncomingVideoStream::HasNewFrames() {
+  return frame_queue_.size() > 0;
+}
 
-    // Set timer for next frame to render.
-    if (wait_time > KEventMaxWaitTimeMs) {
-      wait_time = KEventMaxWaitTimeMs;
-    }
-    deliver_buffer_event_.StartTimer(false, wait_time);
-
-    if (!frame_to_render) {
-      if (render_callback_) {
-        if (last_rendered_frame_.render_time_ms() == 0 &&
-            !start_image_.IsZeroSize()) {
-          // We have not rendered anything and have a start image.
-          temp_frame_.CopyFrame(start_image_);
-          render_callback_->RenderFrame(stream_id_, temp_frame_);
-        } else if (!timeout_image_.IsZeroSize() &&
-                   last_rendered_frame_.render_time_ms() + timeout_time_ <
-                       TickTime::MillisecondTimestamp()) {
-          // Render a timeout image.
-          temp_frame_.CopyFrame(timeout_image_);
-          render_callback_->RenderFrame(stream_id_, temp_frame_);
-        }
-      }
+uint32_t IncomingVideoStream::RenderDueFrames() {
+  thread_critsect_.Enter();
 
-      // No frame.
-      thread_critsect_.Leave();
-      return true;
-    }
+  I420VideoFrame* frame_to_render = NULL;
 
-    // Send frame for rendering.
-    if (external_callback_) {
-      WEBRTC_TRACE(kTraceStream, kTraceVideoRenderer, module_id_,
-                   "%s: executing external renderer callback to deliver frame",
-                   __FUNCTION__, frame_to_render->render_time_ms());
-      external_callback_->RenderFrame(stream_id_, *frame_to_render);
-    } else {
-      if (render_callback_) {
-        WEBRTC_TRACE(kTraceStream, kTraceVideoRenderer, module_id_,
-                     "%s: Render frame, time: ", __FUNCTION__,
-                     frame_to_render->render_time_ms());
-        render_callback_->RenderFrame(stream_id_, *frame_to_render);
+  // Get a new frame to render and the time for the frame after this one.
+  buffer_critsect_.Enter();
+  while (I420VideoFrame* frame = frame_queue_.Front()) {
+    render_buffers_.AddFrame(frame);
+    frame_queue_.Pop();
+  }
+  frame_to_render = render_buffers_.FrameToRender();
+  uint32_t wait_time = render_buffers_.TimeToNextFrameRelease();
+  buffer_critsect_.Leave();
+
+  if (wait_time > KEventMaxWaitTimeMs) {
+    wait_time = KEventMaxWaitTimeMs;
+  }
+
+  if (!frame_to_render) {
+    if (render_callback_) {
+      if (last_rendered_frame_.render_time_ms() == 0 &&
+          !start_image_.IsZeroSize()) {
+        // We have not rendered anything and have a start image.
+        temp_frame_.CopyFrame(start_image_);
+        render_callback_->RenderFrame(stream_id_, temp_frame_);
+      } else if (!timeout_image_.IsZeroSize() &&
+                 last_rendered_frame_.render_time_ms() + timeout_time_ <
+                     TickTime::MillisecondTimestamp()) {
+        // Render a timeout image.
+        temp_frame_.CopyFrame(timeout_image_);
+        render_callback_->RenderFrame(stream_id_, temp_frame_);
       }
     }
 
-    // Release critsect before calling the module user.
+    // No frame.
     thread_critsect_.Leave();
+    return wait_time;
+  }
 
-    // We're done with this frame, delete it.
-    if (frame_to_render) {
-      CriticalSectionScoped cs(&buffer_critsect_);
-      last_rendered_frame_.SwapFrame(frame_to_render);
-      render_buffers_.ReturnFrame(frame_to_render);
+  // Send frame for rendering.
+  if (external_callback_) {
+    WEBRTC_TRACE(kTraceStream, kTraceVideoRenderer, module_id_,
+                 "%s: executing external renderer callback to deliver frame",
+                 __FUNCTION__, frame_to_render->render_time_ms());
+    external_callback_->RenderFrame(stream_id_, *frame_to_render);
+  } else {
+    if (render_callback_) {
+      WEBRTC_TRACE(kTraceStream, kTraceVideoRenderer, module_id_,
+                   "%s: Render frame, time: ", __FUNCTION__,
+                   frame_to_render->render_time_ms());
+      render_callback_->RenderFrame(stream_id_, *frame_to_render);
     }
   }
-  return true;
+
+  // Release critsect before calling the module user.
+  thread_critsect_.Leave();
+
+  // We're done with this frame, delete it.
+  CriticalSectionScoped cs(&buffer_critsect_);
+  last_rendered_frame_.SwapFrame(frame_to_render);
+  render_buffers_.ReturnFrame(frame_to_render);
+  return wait_time;
 }
 
 int32_t IncomingVideoStream::GetLastRenderedFrame(
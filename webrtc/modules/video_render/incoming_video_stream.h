@@ -12,6 +12,8 @@
 #define WEBRTC_MODULES_VIDEO_RENDER_MAIN_SOURCE_INCOMING_VIDEO_STREAM_H_
 
 #include "webrtc/modules/video_render/include/video_render.h"
+#include "webrtc/modules/video_render/render_frame_queue.h"
+#include "webrtc/modules/video_render/video_render_scheduler.h"
 
 namespace webrtc {
 class CriticalSectionWrapper;
@@ -26,10 +28,14 @@ struct VideoMirroring {
   bool mirror_y_axis;
 };
 
-class IncomingVideoStream : public VideoRenderCallback {
+class IncomingVideoStream : public VideoRenderCallback,
+                            public VideoRenderScheduler::Stream {
  public:
+  // The stream is rendered by |scheduler| if given, otherwise on a thread of
+  // its own.
   IncomingVideoStream(const int32_t module_id,
-                      const uint32_t stream_id);
+                      const uint32_t stream_id,
+                      VideoRenderScheduler* scheduler);
   ~IncomingVideoStream();
 
   int32_t ChangeModuleId(const int32_t id);
@@ -69,6 +75,10 @@ class IncomingVideoStream : public VideoRenderCallback {
 
   int32_t SetExpectedRenderDelay(int32_t delay_ms);
 
+  // Implements VideoRenderScheduler::Stream.
+  virtual bool HasNewFrames();
+  virtual uint32_t RenderDueFrames();
+
  protected:
   static bool IncomingVideoStreamThreadFun(void* obj);
   bool IncomingVideoStreamProcess();
@@ -77,6 +87,8 @@ class IncomingVideoStream : public VideoRenderCallback {
   enum { KEventStartupTimeMS = 10 };
   enum { KEventMaxWaitTimeMs = 100 };
   enum { KFrameRatePeriodMs = 1000 };
+  // Frames delivered since the stream was last rendered.
+  enum { KFrameQueueSize = 32 };
 
   int32_t module_id_;
   uint32_t stream_id_;
@@ -84,10 +96,15 @@ class IncomingVideoStream : public VideoRenderCallback {
   CriticalSectionWrapper& stream_critsect_;
   CriticalSectionWrapper& thread_critsect_;
   CriticalSectionWrapper& buffer_critsect_;
+  VideoRenderScheduler* const scheduler_;
   ThreadWrapper* incoming_render_thread_;
   EventWrapper& deliver_buffer_event_;
   bool running_;
 
+  // Handed from RenderFrame() to the render thread without locking. The
+  // render thread only pops frames while holding |buffer_critsect_|.
+  RenderFrameQueue frame_queue_;
+
   VideoRenderCallback* external_callback_;
   VideoRenderCallback* render_callback_;
   VideoRenderFrames& render_buffers_;
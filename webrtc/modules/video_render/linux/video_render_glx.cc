@@ -0,0 +1,556 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#define GL_GLEXT_PROTOTYPES
+
+#include "webrtc/modules/video_render/linux/video_render_glx.h"
+
+#include <GL/glext.h>
+#include <X11/Xutil.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/trace.h"
+
+namespace webrtc {
+
+namespace {
+
+const unsigned int kMonitorFrequency = 60;
+
+const char kVertexShader[] =
+  "attribute vec2 aPosition;\n"
+  "attribute vec2 aTextureCoord;\n"
+  "varying vec2 vTextureCoord;\n"
+  "void main() {\n"
+  "  gl_Position = vec4(aPosition, 0.0, 1.0);\n"
+  "  vTextureCoord = aTextureCoord;\n"
+  "}\n";
+
+// The same YUV to RGB conversion as the Android renderer.
+const char kFragmentShader[] =
+  "uniform sampler2D Ytex;\n"
+  "uniform sampler2D Utex, Vtex;\n"
+  "varying vec2 vTextureCoord;\n"
+  "void main(void) {\n"
+  "  float y = texture2D(Ytex, vTextureCoord).r;\n"
+  "  float u = texture2D(Utex, vTextureCoord).r - 0.5;\n"
+  "  float v = texture2D(Vtex, vTextureCoord).r - 0.5;\n"
+  "  y = 1.1643 * (y - 0.0625);\n"
+  "  gl_FragColor = vec4(y + 1.5958 * v,\n"
+  "                      y - 0.39173 * u - 0.81290 * v,\n"
+  "                      y + 2.017 * u,\n"
+  "                      1.0);\n"
+  "}\n";
+
+// Texture coordinates of the corners, in the order of the vertices drawn by
+// VideoChannelGLX::Draw().
+const GLfloat kTextureCoords[8] = {
+  0, 1,  // Bottom left.
+  1, 1,  // Bottom right.
+  1, 0,  // Top right.
+  0, 0   // Top left.
+};
+
+void InitializeTexture(GLenum unit, GLuint id, int width, int height) {
+  glActiveTexture(unit);
+  glBindTexture(GL_TEXTURE_2D, id);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0,
+               GL_LUMINANCE, GL_UNSIGNED_BYTE, NULL);
+}
+
+// Uploads a plane in a single call; unlike GLES2, desktop GL can skip the
+// stride padding with GL_UNPACK_ROW_LENGTH.
+void UploadPlane(GLenum unit, GLuint id, int width, int height, int stride,
+                 const uint8_t* plane) {
+  glActiveTexture(unit);
+  glBindTexture(GL_TEXTURE_2D, id);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_LUMINANCE,
+                  GL_UNSIGNED_BYTE, plane);
+}
+
+}  // namespace
+
+VideoChannelGLX::VideoChannelGLX(int32_t id, uint32_t zOrder, float left,
+                                 float top, float right, float bottom)
+    : _id(id),
+      _critSect(CriticalSectionWrapper::CreateCriticalSection()),
+      _zOrder(zOrder),
+      _left(left),
+      _top(top),
+      _right(right),
+      _bottom(bottom),
+      _frameUpdated(false),
+      _textureWidth(-1),
+      _textureHeight(-1) {
+  memset(_textureIds, 0, sizeof(_textureIds));
+}
+
+VideoChannelGLX::~VideoChannelGLX() {
+  delete _critSect;
+}
+
+int32_t VideoChannelGLX::RenderFrame(const uint32_t /*streamId*/,
+                                     I420VideoFrame& videoFrame) {
+  CriticalSectionScoped cs(_critSect);
+  // Only the latest frame is drawn when more than one arrives between two
+  // screen updates.
+  if (_frame.CopyFrame(videoFrame) < 0)
+    return -1;
+  _frameUpdated = true;
+  return 0;
+}
+
+void VideoChannelGLX::GetStreamProperties(uint32_t& zOrder, float& left,
+                                          float& top, float& right,
+                                          float& bottom) const {
+  zOrder = _zOrder;
+  left = _left;
+  top = _top;
+  right = _right;
+  bottom = _bottom;
+}
+
+bool VideoChannelGLX::IsUpdated() const {
+  CriticalSectionScoped cs(_critSect);
+  return _frameUpdated;
+}
+
+void VideoChannelGLX::Draw(GLint positionHandle, GLint textureHandle) {
+  {
+    CriticalSectionScoped cs(_critSect);
+    if (_frameUpdated) {
+      if (_textureWidth != _frame.width() ||
+          _textureHeight != _frame.height()) {
+        SetupTextures(_frame.width(), _frame.height());
+      }
+      UpdateTextures();
+      _frameUpdated = false;
+    }
+  }
+  if (_textureWidth <= 0)
+    return;
+
+  for (int i = 0; i < 3; ++i) {
+    glActiveTexture(GL_TEXTURE0 + i);
+    glBindTexture(GL_TEXTURE_2D, _textureIds[i]);
+  }
+  const GLfloat vertices[8] = {
+    _left * 2 - 1, 1 - _bottom * 2,
+    _right * 2 - 1, 1 - _bottom * 2,
+    _right * 2 - 1, 1 - _top * 2,
+    _left * 2 - 1, 1 - _top * 2
+  };
+  glVertexAttribPointer(positionHandle, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+  glVertexAttribPointer(textureHandle, 2, GL_FLOAT, GL_FALSE, 0,
+                        kTextureCoords);
+  glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
+
+void VideoChannelGLX::ReleaseTextures() {
+  if (_textureWidth > 0)
+    glDeleteTextures(3, _textureIds);
+  _textureWidth = -1;
+  _textureHeight = -1;
+}
+
+// Called with |_critSect| held.
+void VideoChannelGLX::SetupTextures(int width, int height) {
+  WEBRTC_TRACE(kTraceDebug, kTraceVideoRenderer, _id,
+               "%s: width %d, height %d", __FUNCTION__, width, height);
+  ReleaseTextures();
+  glGenTextures(3, _textureIds);
+  InitializeTexture(GL_TEXTURE0, _textureIds[0], width, height);
+  InitializeTexture(GL_TEXTURE1, _textureIds[1], (width + 1) / 2,
+                    (height + 1) / 2);
+  InitializeTexture(GL_TEXTURE2, _textureIds[2], (width + 1) / 2,
+                    (height + 1) / 2);
+  _textureWidth = width;
+  _textureHeight = height;
+}
+
+// Called with |_critSect| held.
+void VideoChannelGLX::UpdateTextures() {
+  // |_frame| shares its planes with the delivered frame, so read them through
+  // the const accessors, which don't copy them.
+  const I420VideoFrame& frame = _frame;
+  const int width = frame.width();
+  const int height = frame.height();
+  UploadPlane(GL_TEXTURE0, _textureIds[0], width, height,
+              frame.stride(kYPlane), frame.buffer(kYPlane));
+  UploadPlane(GL_TEXTURE1, _textureIds[1], (width + 1) / 2, (height + 1) / 2,
+              frame.stride(kUPlane), frame.buffer(kUPlane));
+  UploadPlane(GL_TEXTURE2, _textureIds[2], (width + 1) / 2, (height + 1) / 2,
+              frame.stride(kVPlane), frame.buffer(kVPlane));
+}
+
+VideoRenderGLX::VideoRenderGLX(int32_t id, Window window)
+    : _id(id),
+      _critSect(CriticalSectionWrapper::CreateCriticalSection()),
+      _window(window),
+      _windowChanged(false),
+      _display(NULL),
+      _context(NULL),
+      _program(0),
+      _positionHandle(-1),
+      _textureHandle(-1),
+      _screenUpdateThread(NULL),
+      _screenUpdateEvent(EventWrapper::Create()),
+      _stopRendering(false),
+      _contextIsCurrent(false) {
+}
+
+VideoRenderGLX::~VideoRenderGLX() {
+  if (_screenUpdateThread) {
+    {
+      CriticalSectionScoped cs(_critSect);
+      _stopRendering = true;
+    }
+    _screenUpdateEvent->Set();
+    _screenUpdateEvent->StopTimer();
+    if (_screenUpdateThread->Stop()) {
+      delete _screenUpdateThread;
+    } else {
+      // Couldn't stop the thread, leak instead of crash.
+      WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                   "%s: could not stop the render thread", __FUNCTION__);
+      assert(false);
+    }
+    _screenUpdateThread = NULL;
+  } else if (_context) {
+    // Init() failed after creating the program, with the context current on
+    // this thread.
+    if (glXMakeCurrent(_display, _window, _context)) {
+      if (_program)
+        glDeleteProgram(_program);
+      glXMakeCurrent(_display, None, NULL);
+    }
+  }
+
+  for (ChannelMap::iterator it = _channels.begin(); it != _channels.end();
+       ++it) {
+    delete it->second;
+  }
+  for (std::list<VideoChannelGLX*>::iterator it = _deletedChannels.begin();
+       it != _deletedChannels.end(); ++it) {
+    delete *it;
+  }
+  if (_context)
+    glXDestroyContext(_display, _context);
+  if (_display)
+    XCloseDisplay(_display);
+  delete _screenUpdateEvent;
+  delete _critSect;
+}
+
+int32_t VideoRenderGLX::Init() {
+  CriticalSectionScoped cs(_critSect);
+  if (!_window)
+    return -1;
+
+  // The render thread is the only user of the display connection.
+  _display = XOpenDisplay(NULL);
+  if (!_display) {
+    WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                 "%s: could not open the display", __FUNCTION__);
+    return -1;
+  }
+  XWindowAttributes attributes;
+  if (!XGetWindowAttributes(_display, _window, &attributes))
+    return -1;
+
+  // The context is created for the visual of the window, which has to
+  // support double buffered OpenGL rendering.
+  XVisualInfo visualTemplate;
+  visualTemplate.visualid = XVisualIDFromVisual(attributes.visual);
+  int visualCount = 0;
+  XVisualInfo* visual = XGetVisualInfo(_display, VisualIDMask,
+                                       &visualTemplate, &visualCount);
+  if (!visual)
+    return -1;
+  int useGl = 0;
+  int doubleBuffer = 0;
+  glXGetConfig(_display, visual, GLX_USE_GL, &useGl);
+  glXGetConfig(_display, visual, GLX_DOUBLEBUFFER, &doubleBuffer);
+  if (useGl && doubleBuffer)
+    _context = glXCreateContext(_display, visual, NULL, True);
+  XFree(visual);
+  if (!_context) {
+    WEBRTC_TRACE(kTraceInfo, kTraceVideoRenderer, _id,
+                 "%s: the window does not support OpenGL", __FUNCTION__);
+    return -1;
+  }
+
+  if (!glXMakeCurrent(_display, _window, _context))
+    return -1;
+  const char* version =
+      reinterpret_cast<const char*>(glGetString(GL_VERSION));
+  WEBRTC_TRACE(kTraceInfo, kTraceVideoRenderer, _id, "%s: GL version %s",
+               __FUNCTION__, version ? version : "unknown");
+  if (!version || atoi(version) < 2 || CreateProgram() != 0) {
+    // Leaves the context current for the destructor to release the program.
+    return -1;
+  }
+  // The render thread makes the context current again.
+  glXMakeCurrent(_display, None, NULL);
+
+  _screenUpdateThread = ThreadWrapper::CreateThread(ScreenUpdateThreadProc,
+                                                    this, kRealtimePriority,
+                                                    "VideoRenderGLX");
+  unsigned int threadId;
+  if (!_screenUpdateThread || !_screenUpdateThread->Start(threadId)) {
+    delete _screenUpdateThread;
+    _screenUpdateThread = NULL;
+    return -1;
+  }
+  _screenUpdateEvent->StartTimer(true, 1000 / kMonitorFrequency);
+  return 0;
+}
+
+int32_t VideoRenderGLX::ChangeWindow(Window window) {
+  CriticalSectionScoped cs(_critSect);
+  _window = window;
+  _windowChanged = true;
+  return 0;
+}
+
+VideoChannelGLX* VideoRenderGLX::CreateGLXChannel(int32_t streamId,
+                                                  uint32_t zOrder,
+                                                  float left, float top,
+                                                  float right, float bottom) {
+  CriticalSectionScoped cs(_critSect);
+  if ((left > 1 || left < 0) || (top > 1 || top < 0) ||
+      (right > 1 || right < 0) || (bottom > 1 || bottom < 0)) {
+    WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                 "%s: wrong coordinates", __FUNCTION__);
+    return NULL;
+  }
+  ChannelMap::iterator it = _channels.find(streamId);
+  if (it != _channels.end()) {
+    WEBRTC_TRACE(kTraceInfo, kTraceVideoRenderer, _id,
+                 "Render channel already exists for stream id: %d", streamId);
+    return it->second;
+  }
+  VideoChannelGLX* channel =
+      new VideoChannelGLX(streamId, zOrder, left, top, right, bottom);
+  _channels[streamId] = channel;
+  return channel;
+}
+
+int32_t VideoRenderGLX::DeleteGLXChannel(int32_t streamId) {
+  CriticalSectionScoped cs(_critSect);
+  ChannelMap::iterator it = _channels.find(streamId);
+  if (it == _channels.end()) {
+    WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                 "No render channel exists for stream id: %d", streamId);
+    return -1;
+  }
+  _deletedChannels.push_back(it->second);
+  _channels.erase(it);
+  // Clears the stream from the window on the next update.
+  _windowChanged = true;
+  return 0;
+}
+
+int32_t VideoRenderGLX::GetIncomingStreamProperties(int32_t streamId,
+                                                    uint32_t& zOrder,
+                                                    float& left, float& top,
+                                                    float& right,
+                                                    float& bottom) {
+  CriticalSectionScoped cs(_critSect);
+  ChannelMap::iterator it = _channels.find(streamId);
+  if (it == _channels.end()) {
+    WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                 "No render channel exists for stream id: %d", streamId);
+    return -1;
+  }
+  it->second->GetStreamProperties(zOrder, left, top, right, bottom);
+  return 0;
+}
+
+bool VideoRenderGLX::ScreenUpdateThreadProc(void* obj) {
+  return static_cast<VideoRenderGLX*>(obj)->ScreenUpdateProcess();
+}
+
+bool VideoRenderGLX::ScreenUpdateProcess() {
+  _screenUpdateEvent->Wait(100);
+
+  CriticalSectionScoped cs(_critSect);
+  if (_stopRendering) {
+    // The context has to be released by the thread it is current on.
+    ReleaseContext();
+    return false;
+  }
+  if (!_contextIsCurrent || _windowChanged)
+    MakeContextCurrent();
+  if (!_contextIsCurrent)
+    return true;
+
+  for (std::list<VideoChannelGLX*>::iterator it = _deletedChannels.begin();
+       it != _deletedChannels.end(); ++it) {
+    (*it)->ReleaseTextures();
+    delete *it;
+  }
+  _deletedChannels.clear();
+
+  bool updated = _windowChanged;
+  _windowChanged = false;
+  for (ChannelMap::iterator it = _channels.begin();
+       !updated && it != _channels.end(); ++it) {
+    updated = it->second->IsUpdated();
+  }
+  if (updated)
+    DrawChannels();
+  return true;
+}
+
+// Called on the render thread with |_critSect| held.
+void VideoRenderGLX::MakeContextCurrent() {
+  _contextIsCurrent = glXMakeCurrent(_display, _window, _context);
+  if (!_contextIsCurrent) {
+    WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                 "%s: could not make the context current", __FUNCTION__);
+    return;
+  }
+  // Swap at most once per display refresh, if the driver allows to ask.
+  typedef int (*SwapIntervalFunction)(int interval);
+  SwapIntervalFunction swapInterval = reinterpret_cast<SwapIntervalFunction>(
+      glXGetProcAddressARB(
+          reinterpret_cast<const GLubyte*>("glXSwapIntervalSGI")));
+  if (swapInterval)
+    swapInterval(1);
+}
+
+// Called on the render thread with |_critSect| held.
+void VideoRenderGLX::ReleaseContext() {
+  if (!_contextIsCurrent && !glXMakeCurrent(_display, _window, _context))
+    return;
+  for (ChannelMap::iterator it = _channels.begin(); it != _channels.end();
+       ++it) {
+    it->second->ReleaseTextures();
+  }
+  for (std::list<VideoChannelGLX*>::iterator it = _deletedChannels.begin();
+       it != _deletedChannels.end(); ++it) {
+    (*it)->ReleaseTextures();
+  }
+  glDeleteProgram(_program);
+  _program = 0;
+  glXMakeCurrent(_display, None, NULL);
+  _contextIsCurrent = false;
+}
+
+// Called on the render thread with |_critSect| held.
+void VideoRenderGLX::DrawChannels() {
+  Window root;
+  int x, y;
+  unsigned int width, height, borderWidth, depth;
+  if (!XGetGeometry(_display, _window, &root, &x, &y, &width, &height,
+                    &borderWidth, &depth)) {
+    return;
+  }
+  glViewport(0, 0, width, height);
+  glClearColor(0, 0, 0, 1);
+  glClear(GL_COLOR_BUFFER_BIT);
+  glUseProgram(_program);
+
+  // Like the other renderers, the streams with the lowest z-order are drawn
+  // on top.
+  std::multimap<uint32_t, VideoChannelGLX*> zOrderToChannel;
+  for (ChannelMap::iterator it = _channels.begin(); it != _channels.end();
+       ++it) {
+    uint32_t zOrder;
+    float left, top, right, bottom;
+    it->second->GetStreamProperties(zOrder, left, top, right, bottom);
+    zOrderToChannel.insert(std::make_pair(zOrder, it->second));
+  }
+  for (std::multimap<uint32_t, VideoChannelGLX*>::reverse_iterator it =
+           zOrderToChannel.rbegin();
+       it != zOrderToChannel.rend(); ++it) {
+    it->second->Draw(_positionHandle, _textureHandle);
+  }
+  // One swap for all the streams.
+  glXSwapBuffers(_display, _window);
+}
+
+int32_t VideoRenderGLX::CreateProgram() {
+  GLuint vertexShader = LoadShader(GL_VERTEX_SHADER, kVertexShader);
+  GLuint fragmentShader = LoadShader(GL_FRAGMENT_SHADER, kFragmentShader);
+  if (!vertexShader || !fragmentShader) {
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    return -1;
+  }
+  _program = glCreateProgram();
+  glAttachShader(_program, vertexShader);
+  glAttachShader(_program, fragmentShader);
+  glLinkProgram(_program);
+  // The shaders go away with the program.
+  glDeleteShader(vertexShader);
+  glDeleteShader(fragmentShader);
+  GLint linkStatus = GL_FALSE;
+  glGetProgramiv(_program, GL_LINK_STATUS, &linkStatus);
+  if (linkStatus != GL_TRUE) {
+    WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                 "%s: could not link the program", __FUNCTION__);
+    return -1;
+  }
+
+  _positionHandle = glGetAttribLocation(_program, "aPosition");
+  _textureHandle = glGetAttribLocation(_program, "aTextureCoord");
+  if (_positionHandle == -1 || _textureHandle == -1)
+    return -1;
+  glEnableVertexAttribArray(_positionHandle);
+  glEnableVertexAttribArray(_textureHandle);
+
+  glUseProgram(_program);
+  glUniform1i(glGetUniformLocation(_program, "Ytex"), 0);
+  glUniform1i(glGetUniformLocation(_program, "Utex"), 1);
+  glUniform1i(glGetUniformLocation(_program, "Vtex"), 2);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  return 0;
+}
+
+GLuint VideoRenderGLX::LoadShader(GLenum shaderType, const char* source) {
+  GLuint shader = glCreateShader(shaderType);
+  if (!shader)
+    return 0;
+  glShaderSource(shader, 1, &source, NULL);
+  glCompileShader(shader);
+  GLint compiled = 0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled) {
+    GLint infoLength = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLength);
+    if (infoLength > 0) {
+      char* info = static_cast<char*>(malloc(infoLength));
+      if (info) {
+        glGetShaderInfoLog(shader, infoLength, NULL, info);
+        WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                     "%s: could not compile shader %d: %s", __FUNCTION__,
+                     shaderType, info);
+        free(info);
+      }
+    }
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+}  // namespace webrtc
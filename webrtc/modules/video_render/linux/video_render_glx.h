@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_RENDER_LINUX_VIDEO_RENDER_GLX_H_
+#define WEBRTC_MODULES_VIDEO_RENDER_LINUX_VIDEO_RENDER_GLX_H_
+
+#include <X11/Xlib.h>
+#include <GL/gl.h>
+#include <GL/glx.h>
+
+#include <list>
+#include <map>
+
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/modules/video_render/include/video_render_defines.h"
+
+namespace webrtc {
+class CriticalSectionWrapper;
+class EventWrapper;
+class ThreadWrapper;
+
+// A stream drawn by VideoRenderGLX. The frames handed over by the incoming
+// stream are kept until the next screen update, which uploads their planes
+// as textures and converts them to RGB in a shader.
+class VideoChannelGLX : public VideoRenderCallback {
+ public:
+  VideoChannelGLX(int32_t id, uint32_t zOrder, float left, float top,
+                  float right, float bottom);
+  virtual ~VideoChannelGLX();
+
+  // Implements VideoRenderCallback.
+  virtual int32_t RenderFrame(const uint32_t streamId,
+                              I420VideoFrame& videoFrame);
+
+  void GetStreamProperties(uint32_t& zOrder, float& left, float& top,
+                           float& right, float& bottom) const;
+
+  // Returns true if a frame has arrived since the last Draw().
+  bool IsUpdated() const;
+
+  // Uploads the latest frame if it is new, and draws the textures at the
+  // position of the stream. Runs on the render thread with the context
+  // current.
+  void Draw(GLint positionHandle, GLint textureHandle);
+
+  // Releases the textures. Runs on the render thread with the context
+  // current.
+  void ReleaseTextures();
+
+ private:
+  void SetupTextures(int width, int height);
+  void UpdateTextures();
+
+  const int32_t _id;
+  CriticalSectionWrapper* _critSect;
+  const uint32_t _zOrder;
+  const float _left;
+  const float _top;
+  const float _right;
+  const float _bottom;
+
+  I420VideoFrame _frame;
+  bool _frameUpdated;
+
+  GLuint _textureIds[3];  // Texture ids of the Y, U and V planes.
+  int _textureWidth;
+  int _textureHeight;
+};
+
+// Renders the streams of a window with OpenGL. All streams are drawn by one
+// thread, which redraws the window at most once per display refresh and
+// swaps the buffers once for all of them. The timing of every stream is left
+// to its IncomingVideoStream.
+class VideoRenderGLX {
+ public:
+  VideoRenderGLX(int32_t id, Window window);
+  ~VideoRenderGLX();
+
+  // Returns -1 if the display has no OpenGL 2.0 support.
+  int32_t Init();
+  int32_t ChangeWindow(Window window);
+
+  VideoChannelGLX* CreateGLXChannel(int32_t streamId, uint32_t zOrder,
+                                    float left, float top, float right,
+                                    float bottom);
+  int32_t DeleteGLXChannel(int32_t streamId);
+  int32_t GetIncomingStreamProperties(int32_t streamId, uint32_t& zOrder,
+                                      float& left, float& top, float& right,
+                                      float& bottom);
+
+ private:
+  typedef std::map<int32_t, VideoChannelGLX*> ChannelMap;
+
+  static bool ScreenUpdateThreadProc(void* obj);
+  bool ScreenUpdateProcess();
+  void MakeContextCurrent();
+  void ReleaseContext();
+  void DrawChannels();
+  int32_t CreateProgram();
+  GLuint LoadShader(GLenum shaderType, const char* source);
+
+  int32_t _id;
+  CriticalSectionWrapper* _critSect;
+  Window _window;
+  bool _windowChanged;
+  Display* _display;
+  GLXContext _context;
+  GLuint _program;
+  GLint _positionHandle;
+  GLint _textureHandle;
+
+  ThreadWrapper* _screenUpdateThread;
+  EventWrapper* _screenUpdateEvent;
+
+  ChannelMap _channels;
+  // The channels which have gone away, whose textures are released by the
+  // render thread before they are deleted.
+  std::list<VideoChannelGLX*> _deletedChannels;
+  // Set to have the render thread release the context and exit.
+  bool _stopRendering;
+  // Only used by the render thread.
+  bool _contextIsCurrent;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_RENDER_LINUX_VIDEO_RENDER_GLX_H_
@@ -10,6 +10,7 @@
 
 #include "webrtc/modules/video_render/linux/video_render_linux_impl.h"
 
+#include "webrtc/modules/video_render/linux/video_render_glx.h"
 #include "webrtc/modules/video_render/linux/video_x11_render.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
@@ -25,12 +26,13 @@ VideoRenderLinuxImpl::VideoRenderLinuxImpl(
             _id(id),
             _renderLinuxCritsect(
                                  *CriticalSectionWrapper::CreateCriticalSection()),
-            _ptrWindow(window), _ptrX11Render(NULL)
+            _ptrWindow(window), _ptrGLXRender(NULL), _ptrX11Render(NULL)
 {
 }
 
 VideoRenderLinuxImpl::~VideoRenderLinuxImpl()
 {
+    delete _ptrGLXRender;
     if (_ptrX11Render)
         delete _ptrX11Render;
 
@@ -43,6 +45,18 @@ int32_t VideoRenderLinuxImpl::Init()
                  __FUNCTION__);
 
     CriticalSectionScoped cs(&_renderLinuxCritsect);
+    // Prefer converting and drawing the frames with OpenGL, and fall back to
+    // converting them in software for XShm.
+    _ptrGLXRender = new VideoRenderGLX(_id, (Window) _ptrWindow);
+    if (_ptrGLXRender->Init() == 0)
+    {
+        return 0;
+    }
+    WEBRTC_TRACE(kTraceInfo, kTraceVideoRenderer, _id,
+                 "%s: OpenGL is not available, using XShm", __FUNCTION__);
+    delete _ptrGLXRender;
+    _ptrGLXRender = NULL;
+
     _ptrX11Render = new VideoX11Render((Window) _ptrWindow);
     if (!_ptrX11Render)
     {
@@ -77,6 +91,10 @@ int32_t VideoRenderLinuxImpl::ChangeWindow(void* window)
     CriticalSectionScoped cs(&_renderLinuxCritsect);
     _ptrWindow = window;
 
+    if (_ptrGLXRender)
+    {
+        return _ptrGLXRender->ChangeWindow((Window) window);
+    }
     if (_ptrX11Render)
     {
         return _ptrX11Render->ChangeWindow((Window) window);
@@ -98,7 +116,20 @@ VideoRenderCallback* VideoRenderLinuxImpl::AddIncomingRenderStream(
     CriticalSectionScoped cs(&_renderLinuxCritsect);
 
     VideoRenderCallback* renderCallback = NULL;
-    if (_ptrX11Render)
+    if (_ptrGLXRender)
+    {
+        renderCallback = _ptrGLXRender->CreateGLXChannel(streamId, zOrder,
+                                                         left, top, right,
+                                                         bottom);
+        if (!renderCallback)
+        {
+            WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
+                         "Render channel creation failed for stream id: %d",
+                         streamId);
+            return NULL;
+        }
+    }
+    else if (_ptrX11Render)
     {
         VideoX11Channel* renderChannel =
                 _ptrX11Render->CreateX11RenderChannel(streamId, zOrder, left,
@@ -128,6 +159,10 @@ int32_t VideoRenderLinuxImpl::DeleteIncomingRenderStream(
                  __FUNCTION__);
     CriticalSectionScoped cs(&_renderLinuxCritsect);
 
+    if (_ptrGLXRender)
+    {
+        return _ptrGLXRender->DeleteGLXChannel(streamId);
+    }
     if (_ptrX11Render)
     {
         return _ptrX11Render->DeleteX11RenderChannel(streamId);
@@ -147,6 +182,12 @@ int32_t VideoRenderLinuxImpl::GetIncomingRenderStreamProperties(
                  __FUNCTION__);
     CriticalSectionScoped cs(&_renderLinuxCritsect);
 
+    if (_ptrGLXRender)
+    {
+        return _ptrGLXRender->GetIncomingStreamProperties(streamId, zOrder,
+                                                          left, top, right,
+                                                          bottom);
+    }
     if (_ptrX11Render)
     {
         return _ptrX11Render->GetIncomingStreamProperties(streamId, zOrder,
@@ -16,6 +16,7 @@
 namespace webrtc {
 class CriticalSectionWrapper;
 
+class VideoRenderGLX;
 class VideoX11Render;
 
 // Class definitions
@@ -122,6 +123,8 @@ private:
 
     void* _ptrWindow;
 
+    // OpenGL render, used when the window supports it.
+    VideoRenderGLX* _ptrGLXRender;
     // X11 Render
     VideoX11Render* _ptrX11Render;
 };
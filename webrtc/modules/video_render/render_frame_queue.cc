@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_render/render_frame_queue.h"
+
+#include <assert.h>
+
+namespace webrtc {
+
+RenderFrameQueue::RenderFrameQueue(int capacity)
+    : frames_(new scoped_ptr<I420VideoFrame>[capacity]),
+      capacity_(capacity),
+      size_(0),
+      read_pos_(0),
+      write_pos_(0) {
+  assert(capacity > 0);
+}
+
+RenderFrameQueue::~RenderFrameQueue() {}
+
+bool RenderFrameQueue::Push(I420VideoFrame* frame) {
+  // Only the consumer can change the size while we are here, and it can only
+  // decrease it.
+  if (size() >= capacity_)
+    return false;
+  scoped_ptr<I420VideoFrame>& slot = frames_[write_pos_];
+  if (frame->native_handle() != NULL) {
+    slot.reset(frame->CloneFrame());
+  } else {
+    if (!slot || slot->native_handle() != NULL)
+      slot.reset(new I420VideoFrame());
+    slot->SwapFrame(frame);
+  }
+  ++size_;
+  write_pos_ = (write_pos_ + 1) % capacity_;
+  return true;
+}
+
+I420VideoFrame* RenderFrameQueue::Front() {
+  if (size() <= 0)
+    return NULL;
+  return frames_[read_pos_].get();
+}
+
+void RenderFrameQueue::Pop() {
+  if (size() <= 0) {
+    assert(false);
+    return;
+  }
+  // Release textures right away so that they can be reused.
+  if (frames_[read_pos_]->native_handle() != NULL)
+    frames_[read_pos_].reset();
+  read_pos_ = (read_pos_ + 1) % capacity_;
+  --size_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_RENDER_RENDER_FRAME_QUEUE_H_
+#define WEBRTC_MODULES_VIDEO_RENDER_RENDER_FRAME_QUEUE_H_
+
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+// A lock-free FIFO handing frames from the thread delivering them to the
+// thread rendering them, with room for |capacity| frames. It assumes there is
+// one producer thread, calling Push(), and one consumer thread, calling Front()
+// and Pop().
+class RenderFrameQueue {
+ public:
+  explicit RenderFrameQueue(int capacity);
+  ~RenderFrameQueue();
+
+  // Moves |frame| to the back of the queue, leaving |frame| with the buffers
+  // of a previously queued frame. Texture frames are cloned instead. Returns
+  // false, leaving |frame| untouched, if the queue is full.
+  bool Push(I420VideoFrame* frame);
+
+  // Returns the frame at the front of the queue, or NULL if it is empty. The
+  // frame stays valid until the next call to Pop(), and may be swapped with.
+  I420VideoFrame* Front();
+  void Pop();
+
+  int size() { return size_.Value(); }
+  int capacity() const { return capacity_; }
+
+ private:
+  scoped_ptr<scoped_ptr<I420VideoFrame>[]> frames_;
+  const int capacity_;
+
+  // The only state shared by the two threads. Its updates are full barriers,
+  // so a frame is completely written before the consumer can see it, and
+  // completely read before the producer can reuse its slot.
+  Atomic32 size_;
+
+  int read_pos_;  // Only used by the consumer.
+  int write_pos_;  // Only used by the producer.
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_RENDER_RENDER_FRAME_QUEUE_H_
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_render/render_frame_queue.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace webrtc {
+namespace {
+
+const int kCapacity = 3;
+const int kWidth = 16;
+const int kHeight = 8;
+
+void SetFrame(int64_t render_time_ms, I420VideoFrame* frame) {
+  frame->CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+  frame->set_render_time_ms(render_time_ms);
+}
+
+}  // namespace
+
+TEST(RenderFrameQueueTest, KeepsFramesInOrder) {
+  RenderFrameQueue queue(kCapacity);
+  EXPECT_EQ(kCapacity, queue.capacity());
+  EXPECT_EQ(0, queue.size());
+  EXPECT_TRUE(queue.Front() == NULL);
+
+  I420VideoFrame frame;
+  int64_t next_push = 1;
+  int64_t next_pop = 1;
+  for (int i = 0; i < 3 * kCapacity; ++i) {
+    SetFrame(next_push++, &frame);
+    EXPECT_TRUE(queue.Push(&frame));
+    SetFrame(next_push++, &frame);
+    EXPECT_TRUE(queue.Push(&frame));
+    EXPECT_EQ(2, queue.size());
+    while (queue.Front()) {
+      EXPECT_EQ(next_pop++, queue.Front()->render_time_ms());
+      EXPECT_EQ(kWidth, queue.Front()->width());
+      queue.Pop();
+    }
+  }
+  EXPECT_EQ(next_push, next_pop);
+}
+
+TEST(RenderFrameQueueTest, RejectsFramesWhenFull) {
+  RenderFrameQueue queue(kCapacity);
+  I420VideoFrame frame;
+  for (int i = 0; i < kCapacity; ++i) {
+    SetFrame(i, &frame);
+    EXPECT_TRUE(queue.Push(&frame));
+  }
+  SetFrame(kCapacity, &frame);
+  EXPECT_FALSE(queue.Push(&frame));
+  EXPECT_EQ(kCapacity, frame.render_time_ms());
+  EXPECT_EQ(kCapacity, queue.size());
+
+  queue.Pop();
+  EXPECT_TRUE(queue.Push(&frame));
+  EXPECT_EQ(1, queue.Front()->render_time_ms());
+}
+
+TEST(RenderFrameQueueTest, ReusesBuffersOfPoppedFrames) {
+  RenderFrameQueue queue(1);
+  I420VideoFrame frame;
+  SetFrame(1, &frame);
+  const uint8_t* buffer = frame.buffer(kYPlane);
+  EXPECT_TRUE(queue.Push(&frame));
+  EXPECT_EQ(buffer, queue.Front()->buffer(kYPlane));
+  queue.Pop();
+
+  // The next push hands back the buffers of the first frame.
+  SetFrame(2, &frame);
+  EXPECT_TRUE(queue.Push(&frame));
+  EXPECT_EQ(buffer, frame.buffer(kYPlane));
+}
+
+}  // namespace webrtc
@@ -88,12 +88,8 @@ int32_t VideoRenderFrames::AddFrame(I420VideoFrame* new_frame) {
     }
   }
 
-  frame_to_add->CreateEmptyFrame(new_frame->width(), new_frame->height(),
-                                 new_frame->stride(kYPlane),
-                                 new_frame->stride(kUPlane),
-                                 new_frame->stride(kVPlane));
-  // TODO(mflodman) Change this!
-  // Remove const ness. Copying will be costly.
+  // Take over the buffers of |new_frame|. The buffers handed back in return
+  // are sized by the decoder once they get back to it.
   frame_to_add->SwapFrame(new_frame);
   incoming_frames_.push_back(frame_to_add);
 
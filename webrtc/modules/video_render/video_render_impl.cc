@@ -15,6 +15,7 @@
 #include "webrtc/modules/video_render/include/video_render_defines.h"
 #include "webrtc/modules/video_render/incoming_video_stream.h"
 #include "webrtc/modules/video_render/video_render_impl.h"
+#include "webrtc/modules/video_render/video_render_scheduler.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
@@ -86,13 +87,17 @@ void VideoRender::DestroyVideoRender(
     }
 }
 
+// The incoming streams are rendered in step with a 60 Hz display.
+static const int kRenderRefreshIntervalMs = 1000 / 60;
+
 ModuleVideoRenderImpl::ModuleVideoRenderImpl(
                                              const int32_t id,
                                              const VideoRenderType videoRenderType,
                                              void* window,
                                              const bool fullscreen) :
     _id(id), _moduleCrit(*CriticalSectionWrapper::CreateCriticalSection()),
-    _ptrWindow(window), _fullScreen(fullscreen), _ptrRenderer(NULL)
+    _ptrWindow(window), _fullScreen(fullscreen), _ptrRenderer(NULL),
+    _renderScheduler(VideoRenderScheduler::Create(kRenderRefreshIntervalMs))
 {
 
     // Create platform specific renderer
@@ -221,6 +226,8 @@ ModuleVideoRenderImpl::~ModuleVideoRenderImpl()
          ++it) {
       delete it->second;
     }
+    // All streams are stopped, the scheduler isn't used anymore.
+    delete _renderScheduler;
 
     // Delete platform specific renderer
     if (_ptrRenderer)
@@ -453,8 +460,8 @@ ModuleVideoRenderImpl::AddIncomingRenderStream(const uint32_t streamId,
     }
 
     // Create platform independant code
-    IncomingVideoStream* ptrIncomingStream = new IncomingVideoStream(_id,
-                                                                     streamId);
+    IncomingVideoStream* ptrIncomingStream = new IncomingVideoStream(
+        _id, streamId, _renderScheduler);
     if (ptrIncomingStream == NULL)
     {
         WEBRTC_TRACE(kTraceError, kTraceVideoRenderer, _id,
@@ -20,6 +20,7 @@ namespace webrtc {
 class CriticalSectionWrapper;
 class IncomingVideoStream;
 class IVideoRender;
+class VideoRenderScheduler;
 
 // Class definitions
 class ModuleVideoRenderImpl: public VideoRender
@@ -221,6 +222,9 @@ private:
     IVideoRender* _ptrRenderer;
     typedef std::map<uint32_t, IncomingVideoStream*> IncomingVideoStreamMap;
     IncomingVideoStreamMap _streamRenderMap;
+    // Renders all streams on one thread. If NULL, each stream renders on a
+    // thread of its own.
+    VideoRenderScheduler* _renderScheduler;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_render/video_render_scheduler.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+
+// The streams are served at least this often, e.g. to render timeout images.
+static const int64_t kMaxWaitTimeMs = 100;
+// The next pass time while none is posted.
+static const int64_t kNoPassMs = std::numeric_limits<int64_t>::max();
+
+class VideoRenderScheduler::ProcessTask : public QueuedTask {
+ public:
+  explicit ProcessTask(VideoRenderScheduler* scheduler)
+      : scheduler_(scheduler) {}
+
+  virtual void Run() OVERRIDE { scheduler_->Process(); }
+
+ private:
+  VideoRenderScheduler* const scheduler_;
+};
+
+VideoRenderScheduler* VideoRenderScheduler::Create(int refresh_interval_ms) {
+  if (refresh_interval_ms < 0)
+    return NULL;
+  VideoRenderScheduler* scheduler =
+      new VideoRenderScheduler(refresh_interval_ms);
+  if (!scheduler->Start()) {
+    delete scheduler;
+    return NULL;
+  }
+  return scheduler;
+}
+
+VideoRenderScheduler::VideoRenderScheduler(int refresh_interval_ms)
+    : refresh_interval_ms_(refresh_interval_ms),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      pass_crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      next_pass_ms_(kNoPassMs) {}
+
+VideoRenderScheduler::~VideoRenderScheduler() {
+  assert(streams_.empty());
+  ThreadPool* pool = NULL;
+  {
+    CriticalSectionScoped cs(pass_crit_.get());
+    pool = pool_.release();
+  }
+  // Deleted without |pass_crit_| held, as it waits for a running pass. The
+  // passes that have not run are dropped.
+  delete pool;
+}
+
+bool VideoRenderScheduler::Start() {
+  {
+    CriticalSectionScoped cs(pass_crit_.get());
+    pool_.reset(ThreadPool::Create("VideoRenderSchedulerThread", 1,
+                                   kRealtimePriority));
+    if (!pool_)
+      return false;
+  }
+  SchedulePass(kMaxWaitTimeMs);
+  return true;
+}
+
+void VideoRenderScheduler::AddStream(Stream* stream) {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    streams_.push_back(ScheduledStream(stream, 0));
+  }
+  SchedulePass(0);
+}
+
+void VideoRenderScheduler::RemoveStream(Stream* stream) {
+  CriticalSectionScoped cs(crit_.get());
+  for (std::vector<ScheduledStream>::iterator it = streams_.begin();
+       it != streams_.end(); ++it) {
+    if (it->stream == stream) {
+      streams_.erase(it);
+      return;
+    }
+  }
+}
+
+void VideoRenderScheduler::WakeUp() {
+  SchedulePass(0);
+}
+
+void VideoRenderScheduler::Process() {
+  {
+    CriticalSectionScoped cs(pass_crit_.get());
+    // A later pass overtaken by an earlier one leaves |next_pass_ms_| alone.
+    if (next_pass_ms_ <= TickTime::MillisecondTimestamp())
+      next_pass_ms_ = kNoPassMs;
+  }
+  int64_t wait_time_ms = 0;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    const int64_t now_ms = TickTime::MillisecondTimestamp();
+    for (size_t i = 0; i < streams_.size(); ++i) {
+      ScheduledStream& s = streams_[i];
+      if (s.next_time_ms <= now_ms || s.stream->HasNewFrames())
+        s.next_time_ms = now_ms + s.stream->RenderDueFrames();
+    }
+    wait_time_ms = TimeUntilNextWakeUp(TickTime::MillisecondTimestamp());
+  }
+  SchedulePass(wait_time_ms);
+}
+
+void VideoRenderScheduler::SchedulePass(int64_t delay_ms) {
+  CriticalSectionScoped cs(pass_crit_.get());
+  const int64_t run_at_ms = TickTime::MillisecondTimestamp() + delay_ms;
+  if (!pool_ || run_at_ms >= next_pass_ms_)
+    return;
+  next_pass_ms_ = run_at_ms;
+  if (delay_ms == 0) {
+    pool_->PostTask(new ProcessTask(this));
+  } else {
+    pool_->PostDelayedTask(new ProcessTask(this),
+                           static_cast<uint32_t>(delay_ms));
+  }
+}
+
+int64_t VideoRenderScheduler::TimeUntilNextWakeUp(int64_t now_ms) const {
+  int64_t next_time_ms = now_ms + kMaxWaitTimeMs;
+  for (size_t i = 0; i < streams_.size(); ++i)
+    next_time_ms = std::min(next_time_ms, streams_[i].next_time_ms);
+  if (refresh_interval_ms_ > 0) {
+    next_time_ms = (next_time_ms + refresh_interval_ms_ - 1) /
+        refresh_interval_ms_ * refresh_interval_ms_;
+  }
+  return std::max<int64_t>(0, next_time_ms - now_ms);
+}
+
+}  // namespace webrtc
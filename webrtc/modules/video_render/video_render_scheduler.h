@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_RENDER_VIDEO_RENDER_SCHEDULER_H_
+#define WEBRTC_MODULES_VIDEO_RENDER_VIDEO_RENDER_SCHEDULER_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+class ThreadPool;
+
+// VideoRenderScheduler renders all incoming streams of a render module on one
+// thread, instead of one render thread per stream. Each stream is served when
+// its next frame is due or when it has been given new frames. The wake-ups are
+// aligned to the display refresh interval, so that streams with frames due at
+// about the same time are served together.
+class VideoRenderScheduler {
+ public:
+  class Stream {
+   public:
+    // Returns true if frames have been delivered to the stream since it was
+    // last served.
+    virtual bool HasNewFrames() = 0;
+
+    // Renders the frames that are due. Returns the time in ms until the stream
+    // wants to be served again.
+    virtual uint32_t RenderDueFrames() = 0;
+
+   protected:
+    virtual ~Stream() {}
+  };
+
+  // Returns NULL if the render thread fails to start. Wake-ups are aligned to
+  // multiples of |refresh_interval_ms|, unless it is 0.
+  static VideoRenderScheduler* Create(int refresh_interval_ms);
+  ~VideoRenderScheduler();
+
+  void AddStream(Stream* stream);
+
+  // Stops serving |stream|. When this returns, |stream| is not used by the
+  // scheduler anymore.
+  void RemoveStream(Stream* stream);
+
+  // To be called when a stream has been given new frames.
+  void WakeUp();
+
+ private:
+  struct ScheduledStream {
+    ScheduledStream(Stream* stream, int64_t next_time_ms)
+        : stream(stream), next_time_ms(next_time_ms) {}
+    Stream* stream;
+    int64_t next_time_ms;
+  };
+
+  class ProcessTask;
+
+  explicit VideoRenderScheduler(int refresh_interval_ms);
+  bool Start();
+
+  // Serves the streams that are due, and schedules the next pass.
+  void Process();
+  // Posts a pass in |delay_ms| unless an earlier one is posted already.
+  void SchedulePass(int64_t delay_ms);
+  // Returns the time to wait until the next stream is due, aligned to the
+  // refresh interval.
+  int64_t TimeUntilNextWakeUp(int64_t now_ms) const;
+
+  const int refresh_interval_ms_;
+  // Protects |streams_|. Held while serving the streams, so that a stream
+  // can't be removed while it renders.
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  std::vector<ScheduledStream> streams_;
+  // Protects |next_pass_ms_| and |pool_|, and is not held while rendering so
+  // that WakeUp() doesn't wait for a pass.
+  const scoped_ptr<CriticalSectionWrapper> pass_crit_;
+  // The earliest pass that is posted, if any.
+  int64_t next_pass_ms_;
+  // The render thread, which runs the passes.
+  scoped_ptr<ThreadPool> pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoRenderScheduler);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_RENDER_VIDEO_RENDER_SCHEDULER_H_
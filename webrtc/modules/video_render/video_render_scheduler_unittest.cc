@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_render/video_render_scheduler.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+
+namespace webrtc {
+namespace {
+
+const unsigned long kTimeoutMs = 5000;
+
+// Counts how often it is served, and wants to be served again after
+// |interval_ms|.
+class FakeStream : public VideoRenderScheduler::Stream {
+ public:
+  explicit FakeStream(uint32_t interval_ms)
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        served_(EventWrapper::Create()),
+        interval_ms_(interval_ms),
+        new_frames_(false),
+        num_served_(0) {}
+  virtual ~FakeStream() {}
+
+  virtual bool HasNewFrames() OVERRIDE {
+    CriticalSectionScoped cs(crit_.get());
+    return new_frames_;
+  }
+
+  virtual uint32_t RenderDueFrames() OVERRIDE {
+    {
+      CriticalSectionScoped cs(crit_.get());
+      new_frames_ = false;
+      ++num_served_;
+    }
+    served_->Set();
+    return interval_ms_;
+  }
+
+  void DeliverFrame() {
+    CriticalSectionScoped cs(crit_.get());
+    new_frames_ = true;
+  }
+
+  int num_served() {
+    CriticalSectionScoped cs(crit_.get());
+    return num_served_;
+  }
+
+  bool WaitServed() { return served_->Wait(kTimeoutMs) == kEventSignaled; }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<EventWrapper> served_;
+  const uint32_t interval_ms_;
+  bool new_frames_;
+  int num_served_;
+};
+
+}  // namespace
+
+TEST(VideoRenderSchedulerTest, ServesStreamsWhenAdded) {
+  scoped_ptr<VideoRenderScheduler> scheduler(VideoRenderScheduler::Create(0));
+  ASSERT_TRUE(scheduler.get() != NULL);
+  FakeStream stream1(kTimeoutMs);
+  FakeStream stream2(kTimeoutMs);
+  scheduler->AddStream(&stream1);
+  scheduler->AddStream(&stream2);
+  EXPECT_TRUE(stream1.WaitServed());
+  EXPECT_TRUE(stream2.WaitServed());
+  scheduler->RemoveStream(&stream1);
+  scheduler->RemoveStream(&stream2);
+}
+
+TEST(VideoRenderSchedulerTest, ServesStreamWithNewFrames) {
+  scoped_ptr<VideoRenderScheduler> scheduler(
+      VideoRenderScheduler::Create(1000 / 60));
+  ASSERT_TRUE(scheduler.get() != NULL);
+  FakeStream idle_stream(kTimeoutMs);
+  FakeStream stream(kTimeoutMs);
+  scheduler->AddStream(&idle_stream);
+  scheduler->AddStream(&stream);
+  EXPECT_TRUE(idle_stream.WaitServed());
+  EXPECT_TRUE(stream.WaitServed());
+
+  // The streams aren't due for a long time, only new frames get |stream|
+  // served again.
+  stream.DeliverFrame();
+  scheduler->WakeUp();
+  EXPECT_TRUE(stream.WaitServed());
+  EXPECT_EQ(2, stream.num_served());
+  EXPECT_EQ(1, idle_stream.num_served());
+  scheduler->RemoveStream(&idle_stream);
+  scheduler->RemoveStream(&stream);
+}
+
+TEST(VideoRenderSchedulerTest, ServesStreamsWhenDue) {
+  scoped_ptr<VideoRenderScheduler> scheduler(
+      VideoRenderScheduler::Create(1000 / 60));
+  ASSERT_TRUE(scheduler.get() != NULL);
+  FakeStream stream(10);
+  scheduler->AddStream(&stream);
+  for (int i = 0; i < 5; ++i)
+    EXPECT_TRUE(stream.WaitServed());
+  scheduler->RemoveStream(&stream);
+
+  // Not served anymore once removed.
+  const int num_served = stream.num_served();
+  SleepMs(100);
+  EXPECT_EQ(num_served, stream.num_served());
+}
+
+TEST(VideoRenderSchedulerTest, RejectsNegativeRefreshInterval) {
+  EXPECT_TRUE(VideoRenderScheduler::Create(-1) == NULL);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This singleton logs time series for offline processing, like DataLog, but
+// cheap enough to be left on with production traffic. Instead of formatting
+// every cell as text, the cells are stored in fixed-width typed columns and
+// written as binary blocks of rows. Every thread logging to a table buffers
+// its rows in its own Writer, so logging a row takes no locks, and full blocks
+// are written to the file by the shared async file writer thread (see
+// FileWrapper::CreateAsync()).
+//
+// Example:
+//   BinaryDataLog::CreateLog("/tmp/bwe.wdl");
+//   BinaryDataLog::AddTable("bwe");
+//   BinaryDataLog::AddColumn("bwe", "time_ms", BinaryDataLog::kInt64Column);
+//   BinaryDataLog::AddColumn("bwe", "offset", BinaryDataLog::kDoubleColumn);
+//   // On the thread logging the table:
+//   BinaryDataLog::Writer* writer = BinaryDataLog::CreateWriter("bwe");
+//   if (writer) {
+//     writer->InsertCell(0, now_ms);
+//     writer->InsertCell(1, offset);
+//     writer->NextRow();
+//   }
+//   ...
+//   delete writer;
+//   BinaryDataLog::ReturnLog();
+//
+// The columns of a row are addressed by the order they were added in. A log
+// file is converted to one DataLog style CSV file per table with
+// ConvertToCsv(), or with the binary_data_log_to_csv tool.
+//
+// The log file starts with the magic "WDLB" and a 32-bit version, followed by
+// records in host byte order. Each record starts with its 32-bit type and
+// the 32-bit length of the rest of the record. A table record:
+//   uint32 table_id, uint32 name_length, name,
+//   uint32 num_columns, {uint32 type, uint32 name_length, name}...
+// and a block record with |num_rows| rows of a table:
+//   uint32 table_id, uint32 num_rows, uint32 set_cells[num_rows],
+//   column 0 values[num_rows], column 1 values[num_rows], ...
+// where bit i of set_cells tells if column i was set in the row.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_BINARY_DATA_LOG_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_BINARY_DATA_LOG_H_
+
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class BinaryDataLogImpl;
+
+class BinaryDataLog {
+ public:
+  enum ColumnType {
+    kInt32Column = 0,
+    kInt64Column,
+    kFloatColumn,
+    kDoubleColumn,
+  };
+
+  // The maximum number of columns of a table.
+  static const int kMaxColumns = 32;
+  // The number of rows a Writer buffers before writing them to the file.
+  static const int kRowsPerBlock = 512;
+
+  // Buffers the rows of one table logged by one thread. Not thread safe, each
+  // thread logging to a table needs its own Writer. The log is kept alive
+  // until all of its Writers are deleted.
+  class Writer {
+   public:
+    // Writes the buffered rows.
+    ~Writer();
+
+    // Sets the cell of the current row at |column|. Returns -1 if the type
+    // of the value doesn't match the type of the column. Cells not set in a
+    // row are written as NaN in the CSV file.
+    int InsertCell(int column, int32_t value);
+    int InsertCell(int column, int64_t value);
+    int InsertCell(int column, float value);
+    int InsertCell(int column, double value);
+
+    // Ends the current row and starts a new empty one. Writes the buffered
+    // rows to the file when |kRowsPerBlock| rows are buffered.
+    void NextRow();
+
+    // Writes the complete rows buffered so far to the file.
+    void Flush();
+
+   private:
+    friend class BinaryDataLogImpl;
+
+    Writer(BinaryDataLogImpl* log,
+           uint32_t table_id,
+           const std::vector<ColumnType>& column_types);
+
+    template<class T>
+    int Insert(int column, ColumnType type, T value);
+
+    BinaryDataLogImpl* const log_;
+    const std::vector<ColumnType> column_types_;
+    // The offset of the values of each column in |block_|.
+    std::vector<size_t> column_offsets_;
+    // The block record being filled, with room for |kRowsPerBlock| rows.
+    std::vector<uint8_t> block_;
+    int num_rows_;
+    uint32_t set_cells_;
+
+    DISALLOW_COPY_AND_ASSIGN(Writer);
+  };
+
+  // Creates a log writing to the file |file_name|. Calls to this function
+  // after the log has been created only increment the reference counter, and
+  // |file_name| is ignored.
+  static int CreateLog(const std::string& file_name);
+
+  // Decrements the reference counter and deletes the log when the counter
+  // reaches 0 and there are no Writers left. Should be called equal number
+  // of times as successful calls to CreateLog.
+  static void ReturnLog();
+
+  // Adds a new table with the name |table_name|.
+  static int AddTable(const std::string& table_name);
+
+  // Adds a new column, as the last one, to a table. Columns can't be added to
+  // a table once a Writer has been created for it.
+  static int AddColumn(const std::string& table_name,
+                       const std::string& column_name,
+                       ColumnType type);
+
+  // Creates a Writer for a table, owned by the caller. Returns NULL if there
+  // is no log or no such table.
+  static Writer* CreateWriter(const std::string& table_name);
+
+  // Converts the log file |log_file_name| to one CSV file per table, named
+  // |csv_file_prefix| + table name + ".csv", in the format of DataLog.
+  // A truncated record at the end of the file, e.g. from a process that
+  // didn't exit cleanly, is ignored. Returns the number of rows converted, or
+  // -1 if the file can't be read or is not a log file.
+  static int ConvertToCsv(const std::string& log_file_name,
+                          const std::string& csv_file_prefix);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_BINARY_DATA_LOG_H_
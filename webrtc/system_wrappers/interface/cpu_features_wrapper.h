@@ -20,7 +20,10 @@ extern "C" {
 // List of features in x86.
 typedef enum {
   kSSE2,
-  kSSE3
+  kSSE3,
+  kAVX,  // Also requires the OS to save the YMM registers.
+  kFMA,  // FMA3. Only usable together with kAVX.
+  kAVX2  // Also requires the OS to save the YMM registers.
 } CPUFeature;
 
 // List of features in ARM.
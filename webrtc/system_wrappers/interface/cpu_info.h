@@ -19,6 +19,10 @@ class CpuInfo {
  public:
   static uint32_t DetectNumberOfCores();
 
+  // Returns the CPU time, user and system, consumed so far by the calling
+  // thread in microseconds, or -1 if the platform cannot report it.
+  static int64_t ThreadCpuTimeUs();
+
  private:
   CpuInfo() {}
   static uint32_t number_of_cores_;
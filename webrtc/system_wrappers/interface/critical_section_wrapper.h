@@ -23,6 +23,15 @@ class LOCKABLE CriticalSectionWrapper {
   // Factory method, constructor disabled
   static CriticalSectionWrapper* CreateCriticalSection();
 
+  // Creates a critical section that spins for a while before it blocks, for
+  // locks that are held very briefly but are contended between threads. How
+  // long it spins adapts to how long the lock has recently taken to get, and
+  // it never spins on single core machines. In builds with
+  // WEBRTC_LOCK_PROFILING defined, the time spent waiting for the lock is
+  // recorded in the histogram "WebRTC.LockWaitUs.<name>", see metrics.h.
+  static CriticalSectionWrapper* CreateAdaptiveCriticalSection(
+      const char* name);
+
   virtual ~CriticalSectionWrapper() {}
 
   // Tries to grab lock, beginning of a critical section. Will wait for the
@@ -22,10 +22,17 @@
 //   provided.
 //
 // Parameters for the above two functions are described in trace_event.h.
+//
+// When no handlers are set up, events go to a built-in tracer instead. All of
+// its categories start out disabled; they are turned on and off at runtime
+// with EnableInternalTraceCategory(), and the recorded events are read back
+// in the Chrome trace format with DumpInternalTraceEvents().
 
 #ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_EVENT_TRACER_H_
 #define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_EVENT_TRACER_H_
 
+#include <string>
+
 #include "webrtc/common_types.h"
 
 namespace webrtc {
@@ -49,6 +56,22 @@ WEBRTC_DLLEXPORT void SetupEventTracer(
     GetCategoryEnabledPtr get_category_enabled_ptr,
     AddTraceEventPtr add_trace_event_ptr);
 
+// Enables or disables recording of |category| in the built-in tracer. Call
+// sites that have already looked up the category see the change, so this can
+// be used while the events are being traced. Has no effect on the events of
+// handlers set up with SetupEventTracer(). A |category| of "*" applies to
+// all categories, including the ones not yet used.
+WEBRTC_DLLEXPORT void EnableInternalTraceCategory(const char* category,
+                                                  bool enable);
+
+// Returns the events recorded by the built-in tracer as a Chrome trace format
+// JSON object, which can be loaded in about:tracing. Only the most recent
+// events are kept; older ones are overwritten when the buffer is full.
+WEBRTC_DLLEXPORT std::string DumpInternalTraceEvents();
+
+// Discards the events recorded by the built-in tracer.
+WEBRTC_DLLEXPORT void ClearInternalTraceEvents();
+
 // This class defines interface for the event tracing system to call
 // internally. Do not call these methods directly.
 class EventTracer {
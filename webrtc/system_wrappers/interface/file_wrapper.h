@@ -28,6 +28,10 @@ class FileWrapper : public InStream, public OutStream {
 
   // Factory method. Constructor disabled.
   static FileWrapper* Create();
+  // Same as above, but the writes are collected in large buffers and written
+  // by a thread shared by all such files. Flush(), Rewind() and CloseFile()
+  // wait for the pending writes, and Write() waits when too many are pending.
+  static FileWrapper* CreateAsync();
 
   // Returns true if a file has been opened.
   virtual bool Open() const = 0;
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file defines a process-wide registry of named histograms and counters,
+// meant to be cheap enough to update on hot paths.
+//
+// * WEBRTC_HISTOGRAM_ADD(name, sample)
+//   Adds a sample to the histogram |name|. The buckets are log-linear: exact
+//   for samples below 8, and 8 buckets for each power of two above, so a
+//   percentile read back is within 12.5% of the actual value.
+//
+// * WEBRTC_COUNTER_ADD(name, value)
+//   Adds |value| to the counter |name|.
+//
+// Only long-lived literal strings should be given as names; the macros look
+// up the metric once per call site. An update is a single lock-free atomic
+// increment, in one of a few shards picked by the calling thread so that
+// threads rarely write the same cache lines. The shards are merged when the
+// metrics are read with GetHistograms() and GetCounters().
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_METRICS_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_METRICS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/common_types.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+
+namespace webrtc {
+namespace metrics {
+
+// Number of shards the updates are spread over.
+const int kNumShards = 4;
+
+class Histogram {
+ public:
+  // Samples from 0 up to 2^31 - 1; negative samples are counted as 0.
+  enum { kNumBuckets = 8 + 28 * 8 };
+
+  Histogram();
+  ~Histogram();
+
+  void Add(int sample);
+
+  // Merges the shards of |bucket|.
+  int64_t BucketCount(int bucket);
+
+  // Returns the bucket of |sample|, and the smallest sample of |bucket|.
+  static int BucketIndex(int sample);
+  static int BucketMin(int bucket);
+
+ private:
+  Atomic32 counts_[kNumShards][kNumBuckets];
+
+  DISALLOW_COPY_AND_ASSIGN(Histogram);
+};
+
+class Counter {
+ public:
+  Counter();
+  ~Counter();
+
+  void Add(int value);
+  // Merges the shards. Each shard wraps around at 2^31.
+  int64_t Value();
+
+ private:
+  // Each shard is on its own cache line.
+  struct Shard {
+    Atomic32 value;
+    char padding[60];
+  };
+  Shard shards_[kNumShards];
+
+  DISALLOW_COPY_AND_ASSIGN(Counter);
+};
+
+// The samples of a histogram at the time it was read.
+class HistogramSnapshot {
+ public:
+  HistogramSnapshot() : count(0), counts(Histogram::kNumBuckets, 0) {}
+
+  // Returns an upper bound of the sample that |percent| of the samples are
+  // at or below, or -1 if there are no samples.
+  int Percentile(int percent) const;
+
+  std::string name;
+  int64_t count;
+  // The number of samples in each bucket, see Histogram::BucketMin().
+  std::vector<int64_t> counts;
+};
+
+// Returns the metric named |name|, created on first use. Metrics are never
+// deleted, so the returned pointer can be kept.
+Histogram* GetHistogram(const char* name);
+Counter* GetCounter(const char* name);
+
+// Read back all the metrics used so far.
+void GetHistograms(std::vector<HistogramSnapshot>* histograms);
+void GetCounters(std::map<std::string, int64_t>* counters);
+
+}  // namespace metrics
+}  // namespace webrtc
+
+// The metric of a call site is looked up on first use and published with an
+// atomic compare-and-swap, so threads racing on the first use at most look it
+// up more than once, and always get the same metric.
+#define WEBRTC_METRICS_CACHED(type, getter, name, call) \
+    do { \
+      static webrtc::metrics::type* metrics_cached = NULL; \
+      webrtc::metrics::type* metrics_ptr = \
+          rtc::AtomicOps::AcquireLoadPtr(&metrics_cached); \
+      if (!metrics_ptr) { \
+        metrics_ptr = webrtc::metrics::getter(name); \
+        rtc::AtomicOps::CompareAndSwapPtr( \
+            &metrics_cached, static_cast<webrtc::metrics::type*>(NULL), \
+            metrics_ptr); \
+      } \
+      metrics_ptr->call; \
+    } while (0)
+
+#define WEBRTC_HISTOGRAM_ADD(name, sample) \
+    WEBRTC_METRICS_CACHED(Histogram, GetHistogram, name, Add(sample))
+
+#define WEBRTC_COUNTER_ADD(name, value) \
+    WEBRTC_METRICS_CACHED(Counter, GetCounter, name, Add(value))
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_METRICS_H_
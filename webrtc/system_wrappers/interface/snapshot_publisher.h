@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_SNAPSHOT_PUBLISHER_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_SNAPSHOT_PUBLISHER_H_
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+
+namespace webrtc {
+
+// Publishes immutable snapshots of a structure that is read far more often
+// than it changes. Readers neither lock nor allocate; a writer builds a new
+// snapshot and publishes it, and gets the previous one back once no reader
+// uses it anymore.
+//
+// The publisher does not own the snapshots. Calls to Publish() must be
+// serialized by the caller, which typically builds the next snapshot from
+// current() under its own lock.
+//
+// SnapshotPublisher<Table> tables(new Table());
+//
+// void Read() {
+//   SnapshotPublisher<Table>::ScopedReader table(&tables);
+//   table->Find(...);
+// }
+//
+// void Write() {
+//   CriticalSectionScoped cs(crit.get());
+//   delete tables.Publish(new Table(*tables.current(), ...));
+// }
+template <class T>
+class SnapshotPublisher {
+ public:
+  // Holds on to the current snapshot for its lifetime.
+  class ScopedReader {
+   public:
+    explicit ScopedReader(const SnapshotPublisher* publisher)
+        : publisher_(publisher),
+          snapshot_(publisher->Acquire(&slot_)) {}
+    ~ScopedReader() { publisher_->Release(slot_); }
+
+    T* get() const { return snapshot_; }
+    T* operator->() const { return snapshot_; }
+
+   private:
+    const SnapshotPublisher* const publisher_;
+    int slot_;
+    T* const snapshot_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedReader);
+  };
+
+  explicit SnapshotPublisher(T* snapshot) : current_(0) {
+    snapshots_[0] = snapshot;
+    snapshots_[1] = NULL;
+  }
+
+  // Returns the current snapshot, which stays valid until Release() is called
+  // with |*slot|.
+  T* Acquire(int* slot) const {
+    while (true) {
+      *slot = current_.Value();
+      ++readers_[*slot];
+      // A writer that already switched away from |*slot| returns its snapshot
+      // as soon as it sees no readers, so only use it if it is still current.
+      if (current_.Value() == *slot)
+        return snapshots_[*slot];
+      --readers_[*slot];
+    }
+  }
+
+  void Release(int slot) const { --readers_[slot]; }
+
+  // The current snapshot, for the writer.
+  T* current() const { return snapshots_[current_.Value()]; }
+
+  // Makes |snapshot| the current one and returns the previous one once no
+  // reader uses it anymore. Readers that start meanwhile get |snapshot|, so the
+  // wait only lasts as long as the ongoing reads.
+  T* Publish(T* snapshot) {
+    const int slot = current_.Value();
+    const int next = 1 - slot;
+    assert(snapshots_[next] == NULL);
+    snapshots_[next] = snapshot;
+    current_.CompareExchange(next, slot);
+    while (readers_[slot].Value() != 0)
+      SleepMs(0);
+    T* previous = snapshots_[slot];
+    snapshots_[slot] = NULL;
+    return previous;
+  }
+
+ private:
+  // The current snapshot is |snapshots_[current_]|; the other slot is NULL
+  // except while a writer replaces the snapshot. |readers_[i]| counts the
+  // readers that may use |snapshots_[i]|.
+  T* snapshots_[2];
+  mutable Atomic32 current_;
+  mutable Atomic32 readers_[2];
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotPublisher);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_SNAPSHOT_PUBLISHER_H_
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A pool of threads shared by many objects, instead of a thread each, and
+// serial task queues running on top of it.
+//
+// Each thread of the pool has its own queue of tasks. Tasks posted from a
+// thread of the pool go to the queue of that thread, others are spread over
+// the queues in turn. A thread runs the tasks of its own queue oldest first,
+// and when it has none left takes the oldest task from the queue of another
+// thread.
+//
+// Work that the caller splits up and needs back before it goes on, like the
+// stripes of a frame, is run with ThreadPool::RunInParallel() instead of being
+// posted as tasks.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INTERFACE_THREAD_POOL_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INTERFACE_THREAD_POOL_H_
+
+#include <queue>
+#include <vector>
+
+#include "webrtc/common_types.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+
+// A unit of work, deleted once it has run or when it is dropped.
+class QueuedTask {
+ public:
+  virtual ~QueuedTask() {}
+
+  virtual void Run() = 0;
+};
+
+// Work run once for each index of a batch by ThreadPool::RunInParallel().
+class ParallelTask {
+ public:
+  // Called concurrently for different indices.
+  virtual void Run(int index) = 0;
+
+ protected:
+  virtual ~ParallelTask() {}
+};
+
+class ThreadPool {
+ public:
+  // Starts |num_threads| threads, or one per core if |num_threads| is 0, with
+  // |priority| and |role|. Returns NULL if the threads can't be started.
+  static ThreadPool* Create(const char* name,
+                            int num_threads,
+                            ThreadPriority priority = kNormalPriority,
+                            ThreadRole role = kUnspecifiedThreadRole);
+
+  // Stops the threads, after the tasks that are running have returned. The
+  // tasks that have not run are deleted.
+  ~ThreadPool();
+
+  // Takes ownership of |task| and runs it on one of the threads. Tasks may run
+  // concurrently and in any order, use a TaskQueue to run them in order.
+  void PostTask(QueuedTask* task);
+
+  // Same as above, but the task is not run before |delay_ms| have passed.
+  void PostDelayedTask(QueuedTask* task, uint32_t delay_ms);
+
+  // Calls task->Run() for every index in [0, |count|) and returns when all the
+  // calls have returned. The indices are run by the calling thread and up to
+  // |count| - 1 threads of the pool, each taking the next index that hasn't
+  // been run as it gets to it. As the calling thread runs indices instead of
+  // waiting, this can be called from a task of the pool as well. Doesn't take
+  // ownership of |task|.
+  void RunInParallel(ParallelTask* task, int count);
+
+  int num_threads() const { return static_cast<int>(workers_.size()); }
+
+ private:
+  class Worker;
+
+  struct DelayedTask {
+    int64_t run_at_ms;
+    // Tasks due at the same time are run in the order they were posted.
+    uint32_t sequence;
+    QueuedTask* task;
+
+    bool operator<(const DelayedTask& other) const {
+      if (run_at_ms != other.run_at_ms)
+        return run_at_ms > other.run_at_ms;
+      return static_cast<int32_t>(sequence - other.sequence) > 0;
+    }
+  };
+
+  ThreadPool();
+  bool Start(const char* name,
+             int num_threads,
+             ThreadPriority priority,
+             ThreadRole role);
+
+  // Runs or waits for the next task, called repeatedly by the threads.
+  bool Process(Worker* worker);
+  QueuedTask* StealTask(Worker* thief);
+  // Moves the delayed tasks that are due to |worker|. Must be called with
+  // |crit_| held.
+  void TakeDueDelayedTasks(Worker* worker);
+  // Wakes up a thread if any is waiting for a task.
+  void WakeUpIdleThread();
+
+  std::vector<Worker*> workers_;
+  // The worker the next task posted from outside the pool goes to.
+  Atomic32 next_worker_;
+  // Changed whenever a task is posted, so that a thread can tell if it missed
+  // one while looking for tasks.
+  Atomic32 generation_;
+  Atomic32 num_idle_threads_;
+  Atomic32 num_delayed_tasks_;
+  // The low 32 bits of the time the first delayed task is due, so that the
+  // threads can tell without locking when it is.
+  Atomic32 next_delayed_task_ms_;
+
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  const scoped_ptr<ConditionVariableWrapper> wake_up_;
+  std::priority_queue<DelayedTask> delayed_tasks_;
+  uint32_t next_delayed_sequence_;
+  bool stopping_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+// Runs tasks one at a time, in the order they were posted, on the threads of
+// a ThreadPool. Each object that used to have a thread of its own can have one
+// of these instead.
+class TaskQueue {
+ public:
+  // |pool| must outlive the queue.
+  explicit TaskQueue(ThreadPool* pool);
+
+  // Waits for the task that is running, if any, to return, and deletes the
+  // tasks that have not run. Must not be called from a task of this queue.
+  ~TaskQueue();
+
+  // Takes ownership of |task| and runs it after the tasks posted before it.
+  void PostTask(QueuedTask* task);
+
+  // Same as above, but the task is queued after |delay_ms| have passed.
+  void PostDelayedTask(QueuedTask* task, uint32_t delay_ms);
+
+  // Returns true if called from a task of this queue.
+  bool IsCurrent() const;
+
+ private:
+  class Impl;
+
+  // Shared with the tasks posted to the pool, which may outlive this object.
+  Impl* const impl_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskQueue);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INTERFACE_THREAD_POOL_H_
@@ -38,6 +38,38 @@ enum ThreadPriority {
   kRealtimePriority = 5
 };
 
+// What a thread is used for. The scheduling of the threads of each role can
+// be configured with ThreadWrapper::SetRoleConfig(), e.g. to keep the audio
+// device and pacer threads from being preempted by the encoder threads.
+enum ThreadRole {
+  kUnspecifiedThreadRole = 0,
+  kAudioDeviceThreadRole,
+  kPacerThreadRole,
+  kNetworkThreadRole,
+  kEncoderThreadRole,
+  kDecoderThreadRole,
+  kNumThreadRoles
+};
+
+enum ThreadSchedulingPolicy {
+  // Priority from the ThreadPriority the thread was created with.
+  kDefaultSchedulingPolicy = 0,
+  kFifoSchedulingPolicy,
+  kRoundRobinSchedulingPolicy
+};
+
+struct ThreadRoleConfig {
+  ThreadRoleConfig()
+      : policy(kDefaultSchedulingPolicy), priority(0), cpu_mask(0) {}
+
+  ThreadSchedulingPolicy policy;
+  // Real-time priority for the FIFO and round robin policies, clamped to the
+  // range of the system (1 - 99 on Linux).
+  int priority;
+  // Bit n allows the threads to run on CPU n. 0 leaves the affinity as is.
+  uint64_t cpu_mask;
+};
+
 class ThreadWrapper {
  public:
   enum {kThreadMaxNameLength = 64};
@@ -52,10 +84,18 @@ class ThreadWrapper {
   // prio        Thread priority. May require root/admin rights.
   // thread_name  NULL terminated thread name, will be visable in the Windows
   //             debugger.
+  // role        Role whose configuration the thread is scheduled with, if
+  //             any. Only applied on Linux.
   static ThreadWrapper* CreateThread(ThreadRunFunction func,
                                      ThreadObj obj,
                                      ThreadPriority prio = kNormalPriority,
-                                     const char* thread_name = 0);
+                                     const char* thread_name = 0,
+                                     ThreadRole role = kUnspecifiedThreadRole);
+
+  // Sets the scheduling of the threads of |role| started from now on. Not
+  // thread safe, configure the roles at startup before creating any threads.
+  static void SetRoleConfig(ThreadRole role, const ThreadRoleConfig& config);
+  static ThreadRoleConfig GetRoleConfig(ThreadRole role);
 
   // Get the current thread's kernel thread ID.
   static uint32_t GetThreadId();
@@ -70,11 +70,37 @@ class TickTime {
   // Advance the fake clock. Must be called after UseFakeClock.
   static void AdvanceFakeClock(int64_t milliseconds);
 
+  // Makes time run |scale| times faster than the OS clock, so that long
+  // simulations finish sooner. TickTime, Clock::GetRealTimeClock(), event
+  // waits and timers, and SleepMs() all follow the scaled time. Must be called
+  // once, before any threads or timers are started; a scale of 1 is real time.
+  //
+  // This is scaled real time, not a simulated clock: runs aren't
+  // deterministic, and work that takes CPU time, e.g. encoding and decoding,
+  // takes |scale| times longer as seen on the scaled clock. CPU-bound results
+  // such as frame rates and encode times are distorted by that.
+  static void SetTimeScale(int scale);
+  static int time_scale() { return time_scale_; }
+
+  // Returns how far the scaled time has run ahead of the OS clock.
+  static int64_t TimeScaleOffsetMicroseconds();
+
+  // Returns the OS time to wait for |milliseconds| of scaled time to pass.
+  static int64_t ScaledWaitMicroseconds(int64_t milliseconds);
+
+  // The math behind the scaled time, with the state passed in: the scaled
+  // ticks at |os_ticks| when time started to run |scale| times faster at
+  // |origin_ticks|, and the OS time to wait for |milliseconds| of scaled time.
+  static int64_t ScaleTicks(int64_t os_ticks, int64_t origin_ticks, int scale);
+  static int64_t ScaledWaitMicroseconds(int64_t milliseconds, int scale);
+
  private:
   static int64_t QueryOsForTicks();
 
   static bool use_fake_clock_;
   static int64_t fake_ticks_;
+  static int time_scale_;
+  static int64_t time_scale_origin_ticks_;
 
   int64_t ticks_;
 };
@@ -159,6 +185,9 @@ inline TickTime::TickTime(int64_t ticks)
 inline TickTime TickTime::Now() {
   if (use_fake_clock_)
     return TickTime(fake_ticks_);
+  else if (time_scale_ != 1)
+    return TickTime(ScaleTicks(QueryOsForTicks(), time_scale_origin_ticks_,
+                               time_scale_));
   else
     return TickTime(QueryOsForTicks());
 }
@@ -21,6 +21,10 @@
 
 #include "webrtc/typedefs.h"
 
+#if defined(WEBRTC_LOCK_PROFILING)
+#include "webrtc/base/lockprofiler.h"
+#endif
+
 // Reference on memory alignment:
 // http://stackoverflow.com/questions/227897/solve-the-memory-alignment-in-c-interview-question-that-stumped-me
 namespace webrtc {
@@ -57,6 +61,9 @@ void* AlignedMalloc(size_t size, size_t alignment) {
   if (!ValidAlignment(alignment)) {
     return NULL;
   }
+#if defined(WEBRTC_LOCK_PROFILING)
+  rtc::LockProfiler::RecordAllocation(RTC_CALL_SITE(), size);
+#endif
 
   // The memory is aligned towards the lowest address that so only
   // alignment - 1 bytes needs to be allocated.
@@ -0,0 +1,532 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/binary_data_log.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/file_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/stl_util.h"
+
+namespace webrtc {
+namespace {
+
+const uint8_t kMagic[4] = {'W', 'D', 'L', 'B'};
+const uint32_t kVersion = 1;
+
+enum RecordType {
+  kTableRecord = 1,
+  kBlockRecord = 2,
+};
+
+// The record type and length.
+const size_t kRecordHeaderLength = 2 * sizeof(uint32_t);
+// The record header, table id and number of rows.
+const size_t kBlockHeaderLength = kRecordHeaderLength + 2 * sizeof(uint32_t);
+
+size_t ColumnWidth(BinaryDataLog::ColumnType type) {
+  switch (type) {
+    case BinaryDataLog::kInt32Column:
+    case BinaryDataLog::kFloatColumn:
+      return 4;
+    case BinaryDataLog::kInt64Column:
+    case BinaryDataLog::kDoubleColumn:
+      return 8;
+  }
+  return 0;
+}
+
+void WriteUint32(uint32_t value, uint8_t* buffer) {
+  memcpy(buffer, &value, sizeof(value));
+}
+
+uint32_t ReadUint32(const uint8_t* buffer) {
+  uint32_t value;
+  memcpy(&value, buffer, sizeof(value));
+  return value;
+}
+
+void AppendUint32(uint32_t value, std::vector<uint8_t>* buffer) {
+  buffer->resize(buffer->size() + sizeof(value));
+  WriteUint32(value, &(*buffer)[buffer->size() - sizeof(value)]);
+}
+
+void AppendString(const std::string& value, std::vector<uint8_t>* buffer) {
+  AppendUint32(static_cast<uint32_t>(value.size()), buffer);
+  buffer->insert(buffer->end(), value.begin(), value.end());
+}
+
+// Reads the fields of a record, failing instead of reading past its end.
+class RecordReader {
+ public:
+  RecordReader(const uint8_t* data, size_t length)
+      : data_(data), length_(length), position_(0) {}
+
+  bool ReadUint32(uint32_t* value) {
+    if (length_ - position_ < sizeof(*value))
+      return false;
+    *value = webrtc::ReadUint32(data_ + position_);
+    position_ += sizeof(*value);
+    return true;
+  }
+
+  bool ReadString(std::string* value) {
+    uint32_t length;
+    if (!ReadUint32(&length) || length_ - position_ < length)
+      return false;
+    value->assign(reinterpret_cast<const char*>(data_ + position_), length);
+    position_ += length;
+    return true;
+  }
+
+ private:
+  const uint8_t* const data_;
+  const size_t length_;
+  size_t position_;
+};
+
+template<class T>
+void AppendValue(const uint8_t* buffer, std::ostringstream* row) {
+  T value;
+  memcpy(&value, buffer, sizeof(value));
+  *row << value << ",";
+}
+
+// A table being converted to CSV.
+struct CsvTable {
+  std::vector<BinaryDataLog::ColumnType> column_types;
+  scoped_ptr<FileWrapper> file;
+};
+
+// Parses a table record and creates the CSV file of the table, with its
+// header row.
+CsvTable* CreateCsvTable(RecordReader* reader,
+                         const std::string& csv_file_prefix,
+                         uint32_t* table_id) {
+  std::string table_name;
+  uint32_t num_columns;
+  if (!reader->ReadUint32(table_id) || !reader->ReadString(&table_name) ||
+      !reader->ReadUint32(&num_columns) ||
+      num_columns > static_cast<uint32_t>(BinaryDataLog::kMaxColumns)) {
+    return NULL;
+  }
+  scoped_ptr<CsvTable> table(new CsvTable);
+  std::string header;
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    uint32_t type;
+    std::string column_name;
+    if (!reader->ReadUint32(&type) || !reader->ReadString(&column_name) ||
+        type > BinaryDataLog::kDoubleColumn) {
+      return NULL;
+    }
+    table->column_types.push_back(static_cast<BinaryDataLog::ColumnType>(type));
+    header += column_name + ",";
+  }
+  header += "\n";
+
+  table->file.reset(FileWrapper::Create());
+  const std::string file_name = csv_file_prefix + table_name + ".csv";
+  if (table->file->OpenFile(file_name.c_str(), false, false, true) != 0)
+    return NULL;
+  table->file->Write(header.data(), static_cast<int>(header.size()));
+  return table.release();
+}
+
+// Writes the rows of a block record to the CSV file of its table. Returns the
+// number of rows written, or -1 if the record is malformed.
+int WriteCsvRows(const CsvTable& table, const uint8_t* data, size_t length) {
+  RecordReader reader(data, length);
+  uint32_t table_id;
+  uint32_t num_rows;
+  if (!reader.ReadUint32(&table_id) || !reader.ReadUint32(&num_rows) ||
+      num_rows > static_cast<uint32_t>(BinaryDataLog::kRowsPerBlock)) {
+    return -1;
+  }
+  const uint8_t* set_cells = data + 2 * sizeof(uint32_t);
+  std::vector<const uint8_t*> columns;
+  size_t needed_length = 2 * sizeof(uint32_t) + num_rows * sizeof(uint32_t);
+  for (size_t i = 0; i < table.column_types.size(); ++i) {
+    columns.push_back(data + needed_length);
+    needed_length += num_rows * ColumnWidth(table.column_types[i]);
+  }
+  if (needed_length > length)
+    return -1;
+
+  for (uint32_t row = 0; row < num_rows; ++row) {
+    const uint32_t row_set_cells =
+        ReadUint32(set_cells + row * sizeof(uint32_t));
+    std::ostringstream row_string;
+    for (size_t i = 0; i < table.column_types.size(); ++i) {
+      if ((row_set_cells & (1u << i)) == 0) {
+        row_string << "NaN,";
+        continue;
+      }
+      const BinaryDataLog::ColumnType type = table.column_types[i];
+      const uint8_t* value = columns[i] + row * ColumnWidth(type);
+      switch (type) {
+        case BinaryDataLog::kInt32Column:
+          AppendValue<int32_t>(value, &row_string);
+          break;
+        case BinaryDataLog::kInt64Column:
+          AppendValue<int64_t>(value, &row_string);
+          break;
+        case BinaryDataLog::kFloatColumn:
+          AppendValue<float>(value, &row_string);
+          break;
+        case BinaryDataLog::kDoubleColumn:
+          AppendValue<double>(value, &row_string);
+          break;
+      }
+    }
+    row_string << "\n";
+    const std::string row_data = row_string.str();
+    table.file->Write(row_data.data(), static_cast<int>(row_data.size()));
+  }
+  return static_cast<int>(num_rows);
+}
+
+}  // namespace
+
+class BinaryDataLogImpl {
+ public:
+  typedef BinaryDataLog::ColumnType ColumnType;
+
+  static int CreateLog(const std::string& file_name);
+  static BinaryDataLogImpl* StaticInstance() { return instance_; }
+  static void ReturnLog();
+
+  int AddTable(const std::string& table_name);
+  int AddColumn(const std::string& table_name,
+                const std::string& column_name,
+                ColumnType type);
+  BinaryDataLog::Writer* CreateWriter(const std::string& table_name);
+
+  // Called by the Writers, from any thread.
+  void WriteRecord(const uint8_t* data, size_t length) {
+    file_->Write(data, static_cast<int>(length));
+  }
+
+ private:
+  struct Table {
+    Table() : id(0), has_writers(false) {}
+
+    uint32_t id;
+    // The columns are fixed once the table record has been written.
+    bool has_writers;
+    std::vector<std::string> column_names;
+    std::vector<ColumnType> column_types;
+  };
+
+  typedef std::map<std::string, Table> TableMap;
+  typedef scoped_ptr<CriticalSectionWrapper> CritSectScopedPtr;
+
+  BinaryDataLogImpl();
+  ~BinaryDataLogImpl();
+
+  int Init(const std::string& file_name);
+  void WriteTableRecord(const std::string& table_name, const Table& table);
+
+  // Guards |instance_|, and |counter_| and |tables_| of the instance.
+  static CritSectScopedPtr crit_sect_;
+  static BinaryDataLogImpl* instance_;
+  // The references from CreateLog() and from the Writers.
+  int counter_;
+  TableMap tables_;
+  scoped_ptr<FileWrapper> file_;
+};
+
+const int BinaryDataLog::kMaxColumns;
+const int BinaryDataLog::kRowsPerBlock;
+
+BinaryDataLogImpl::CritSectScopedPtr BinaryDataLogImpl::crit_sect_(
+    CriticalSectionWrapper::CreateCriticalSection());
+
+BinaryDataLogImpl* BinaryDataLogImpl::instance_ = NULL;
+
+BinaryDataLogImpl::BinaryDataLogImpl() : counter_(1) {}
+
+BinaryDataLogImpl::~BinaryDataLogImpl() {
+  if (file_.get() != NULL)
+    file_->CloseFile();
+}
+
+int BinaryDataLogImpl::CreateLog(const std::string& file_name) {
+  CriticalSectionScoped synchronize(crit_sect_.get());
+  if (instance_ != NULL) {
+    ++instance_->counter_;
+    return 0;
+  }
+  instance_ = new BinaryDataLogImpl();
+  if (instance_->Init(file_name) != 0) {
+    delete instance_;
+    instance_ = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+int BinaryDataLogImpl::Init(const std::string& file_name) {
+  file_.reset(FileWrapper::CreateAsync());
+  if (file_name.empty() ||
+      file_->OpenFile(file_name.c_str(), false, false, false) != 0) {
+    return -1;
+  }
+  uint8_t header[sizeof(kMagic) + sizeof(kVersion)];
+  memcpy(header, kMagic, sizeof(kMagic));
+  WriteUint32(kVersion, header + sizeof(kMagic));
+  WriteRecord(header, sizeof(header));
+  return 0;
+}
+
+void BinaryDataLogImpl::ReturnLog() {
+  CriticalSectionScoped synchronize(crit_sect_.get());
+  if (instance_ && instance_->counter_ > 1) {
+    --instance_->counter_;
+    return;
+  }
+  delete instance_;
+  instance_ = NULL;
+}
+
+int BinaryDataLogImpl::AddTable(const std::string& table_name) {
+  CriticalSectionScoped synchronize(crit_sect_.get());
+  if (tables_.count(table_name) > 0)
+    return -1;
+  Table& table = tables_[table_name];
+  table.id = static_cast<uint32_t>(tables_.size() - 1);
+  return 0;
+}
+
+int BinaryDataLogImpl::AddColumn(const std::string& table_name,
+                                 const std::string& column_name,
+                                 ColumnType type) {
+  CriticalSectionScoped synchronize(crit_sect_.get());
+  TableMap::iterator it = tables_.find(table_name);
+  if (it == tables_.end())
+    return -1;
+  Table& table = it->second;
+  if (table.has_writers ||
+      table.column_types.size() >=
+          static_cast<size_t>(BinaryDataLog::kMaxColumns)) {
+    return -1;
+  }
+  table.column_names.push_back(column_name);
+  table.column_types.push_back(type);
+  return 0;
+}
+
+BinaryDataLog::Writer* BinaryDataLogImpl::CreateWriter(
+    const std::string& table_name) {
+  CriticalSectionScoped synchronize(crit_sect_.get());
+  TableMap::iterator it = tables_.find(table_name);
+  if (it == tables_.end())
+    return NULL;
+  Table& table = it->second;
+  if (!table.has_writers) {
+    WriteTableRecord(table_name, table);
+    table.has_writers = true;
+  }
+  ++counter_;
+  return new BinaryDataLog::Writer(this, table.id, table.column_types);
+}
+
+void BinaryDataLogImpl::WriteTableRecord(const std::string& table_name,
+                                         const Table& table) {
+  std::vector<uint8_t> record;
+  AppendUint32(kTableRecord, &record);
+  AppendUint32(0, &record);  // Length, set below.
+  AppendUint32(table.id, &record);
+  AppendString(table_name, &record);
+  AppendUint32(static_cast<uint32_t>(table.column_types.size()), &record);
+  for (size_t i = 0; i < table.column_types.size(); ++i) {
+    AppendUint32(table.column_types[i], &record);
+    AppendString(table.column_names[i], &record);
+  }
+  WriteUint32(static_cast<uint32_t>(record.size() - kRecordHeaderLength),
+              &record[sizeof(uint32_t)]);
+  WriteRecord(&record[0], record.size());
+}
+
+BinaryDataLog::Writer::Writer(BinaryDataLogImpl* log,
+                              uint32_t table_id,
+                              const std::vector<ColumnType>& column_types)
+    : log_(log),
+      column_types_(column_types),
+      num_rows_(0),
+      set_cells_(0) {
+  size_t length = kBlockHeaderLength + kRowsPerBlock * sizeof(uint32_t);
+  for (size_t i = 0; i < column_types_.size(); ++i) {
+    column_offsets_.push_back(length);
+    length += kRowsPerBlock * ColumnWidth(column_types_[i]);
+  }
+  block_.resize(length);
+  WriteUint32(kBlockRecord, &block_[0]);
+  WriteUint32(table_id, &block_[kRecordHeaderLength]);
+}
+
+BinaryDataLog::Writer::~Writer() {
+  Flush();
+  BinaryDataLogImpl::ReturnLog();
+}
+
+template<class T>
+int BinaryDataLog::Writer::Insert(int column, ColumnType type, T value) {
+  if (column < 0 || column >= static_cast<int>(column_types_.size()) ||
+      column_types_[column] != type) {
+    return -1;
+  }
+  memcpy(&block_[column_offsets_[column] + num_rows_ * sizeof(value)], &value,
+         sizeof(value));
+  set_cells_ |= 1u << column;
+  return 0;
+}
+
+int BinaryDataLog::Writer::InsertCell(int column, int32_t value) {
+  return Insert(column, kInt32Column, value);
+}
+
+int BinaryDataLog::Writer::InsertCell(int column, int64_t value) {
+  return Insert(column, kInt64Column, value);
+}
+
+int BinaryDataLog::Writer::InsertCell(int column, float value) {
+  return Insert(column, kFloatColumn, value);
+}
+
+int BinaryDataLog::Writer::InsertCell(int column, double value) {
+  return Insert(column, kDoubleColumn, value);
+}
+
+void BinaryDataLog::Writer::NextRow() {
+  WriteUint32(set_cells_,
+              &block_[kBlockHeaderLength + num_rows_ * sizeof(uint32_t)]);
+  set_cells_ = 0;
+  if (++num_rows_ == kRowsPerBlock)
+    Flush();
+}
+
+void BinaryDataLog::Writer::Flush() {
+  if (num_rows_ == 0)
+    return;
+  // A full block is written as is. In a partial one the columns are moved
+  // next to each other first.
+  size_t length = kBlockHeaderLength + num_rows_ * sizeof(uint32_t);
+  for (size_t i = 0; i < column_types_.size(); ++i) {
+    const size_t column_length = num_rows_ * ColumnWidth(column_types_[i]);
+    if (column_offsets_[i] != length)
+      memmove(&block_[length], &block_[column_offsets_[i]], column_length);
+    length += column_length;
+  }
+  WriteUint32(static_cast<uint32_t>(length - kRecordHeaderLength),
+              &block_[sizeof(uint32_t)]);
+  WriteUint32(num_rows_, &block_[kRecordHeaderLength + sizeof(uint32_t)]);
+  log_->WriteRecord(&block_[0], length);
+  num_rows_ = 0;
+}
+
+int BinaryDataLog::CreateLog(const std::string& file_name) {
+  return BinaryDataLogImpl::CreateLog(file_name);
+}
+
+void BinaryDataLog::ReturnLog() {
+  BinaryDataLogImpl::ReturnLog();
+}
+
+int BinaryDataLog::AddTable(const std::string& table_name) {
+  BinaryDataLogImpl* log = BinaryDataLogImpl::StaticInstance();
+  if (log == NULL)
+    return -1;
+  return log->AddTable(table_name);
+}
+
+int BinaryDataLog::AddColumn(const std::string& table_name,
+                             const std::string& column_name,
+                             ColumnType type) {
+  BinaryDataLogImpl* log = BinaryDataLogImpl::StaticInstance();
+  if (log == NULL)
+    return -1;
+  return log->AddColumn(table_name, column_name, type);
+}
+
+BinaryDataLog::Writer* BinaryDataLog::CreateWriter(
+    const std::string& table_name) {
+  BinaryDataLogImpl* log = BinaryDataLogImpl::StaticInstance();
+  if (log == NULL)
+    return NULL;
+  return log->CreateWriter(table_name);
+}
+
+int BinaryDataLog::ConvertToCsv(const std::string& log_file_name,
+                                const std::string& csv_file_prefix) {
+  scoped_ptr<FileWrapper> log_file(FileWrapper::Create());
+  if (log_file->OpenFile(log_file_name.c_str(), true, false, false) != 0)
+    return -1;
+  std::vector<uint8_t> data;
+  const int kChunkSize = 64 * 1024;
+  int bytes_read;
+  do {
+    data.resize(data.size() + kChunkSize);
+    bytes_read = log_file->Read(&data[data.size() - kChunkSize], kChunkSize);
+    data.resize(data.size() - kChunkSize + std::max(bytes_read, 0));
+  } while (bytes_read == kChunkSize);
+
+  const size_t kFileHeaderLength = sizeof(kMagic) + sizeof(kVersion);
+  if (data.size() < kFileHeaderLength ||
+      memcmp(&data[0], kMagic, sizeof(kMagic)) != 0 ||
+      ReadUint32(&data[sizeof(kMagic)]) != kVersion) {
+    return -1;
+  }
+
+  typedef std::map<uint32_t, CsvTable*> CsvTableMap;
+  CsvTableMap tables;
+  STLValueDeleter<CsvTableMap> tables_deleter(&tables);
+  int num_rows = 0;
+  size_t position = kFileHeaderLength;
+  while (data.size() - position >= kRecordHeaderLength) {
+    const uint32_t type = ReadUint32(&data[position]);
+    const uint32_t length = ReadUint32(&data[position + sizeof(uint32_t)]);
+    position += kRecordHeaderLength;
+    if (data.size() - position < length)
+      break;  // Truncated.
+    const uint8_t* record = &data[position];
+    position += length;
+
+    if (type == kTableRecord) {
+      RecordReader reader(record, length);
+      uint32_t table_id;
+      CsvTable* table = CreateCsvTable(&reader, csv_file_prefix, &table_id);
+      if (table == NULL || tables.count(table_id) > 0) {
+        delete table;
+        return -1;
+      }
+      tables[table_id] = table;
+    } else if (type == kBlockRecord) {
+      if (length < sizeof(uint32_t))
+        return -1;
+      CsvTableMap::const_iterator it = tables.find(ReadUint32(record));
+      if (it == tables.end())
+        return -1;
+      const int block_rows = WriteCsvRows(*it->second, record, length);
+      if (block_rows < 0)
+        return -1;
+      num_rows += block_rows;
+    }
+    // Other record types are from newer versions and skipped.
+  }
+  return num_rows;
+}
+
+}  // namespace webrtc
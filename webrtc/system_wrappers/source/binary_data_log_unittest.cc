@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/binary_data_log.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+class BinaryDataLogTest : public ::testing::Test {
+ protected:
+  BinaryDataLogTest()
+      : log_file_name_(test::OutputPath() + "binary_data_log_unittest.wdl"),
+        csv_file_prefix_(test::OutputPath() + "binary_data_log_unittest_") {}
+
+  virtual ~BinaryDataLogTest() {
+    remove(log_file_name_.c_str());
+    remove(CsvFileName("table").c_str());
+  }
+
+  std::string CsvFileName(const std::string& table_name) const {
+    return csv_file_prefix_ + table_name + ".csv";
+  }
+
+  static std::string ReadFile(const std::string& file_name) {
+    std::string data;
+    FILE* file = fopen(file_name.c_str(), "rb");
+    if (file == NULL)
+      return data;
+    char buffer[4096];
+    size_t num_bytes;
+    while ((num_bytes = fread(buffer, 1, sizeof(buffer), file)) > 0)
+      data.append(buffer, num_bytes);
+    fclose(file);
+    return data;
+  }
+
+  // Logs |num_rows| rows of an int32 and a double column to "table".
+  void LogRows(int num_rows) {
+    ASSERT_EQ(0, BinaryDataLog::CreateLog(log_file_name_));
+    ASSERT_EQ(0, BinaryDataLog::AddTable("table"));
+    ASSERT_EQ(0, BinaryDataLog::AddColumn("table", "a",
+                                          BinaryDataLog::kInt32Column));
+    ASSERT_EQ(0, BinaryDataLog::AddColumn("table", "b",
+                                          BinaryDataLog::kDoubleColumn));
+    scoped_ptr<BinaryDataLog::Writer> writer(
+        BinaryDataLog::CreateWriter("table"));
+    ASSERT_TRUE(writer.get() != NULL);
+    for (int i = 0; i < num_rows; ++i) {
+      EXPECT_EQ(0, writer->InsertCell(0, static_cast<int32_t>(i)));
+      EXPECT_EQ(0, writer->InsertCell(1, i + 0.5));
+      writer->NextRow();
+    }
+    writer.reset();
+    BinaryDataLog::ReturnLog();
+  }
+
+  const std::string log_file_name_;
+  const std::string csv_file_prefix_;
+};
+
+TEST_F(BinaryDataLogTest, ConvertsToCsv) {
+  ASSERT_EQ(0, BinaryDataLog::CreateLog(log_file_name_));
+  ASSERT_EQ(0, BinaryDataLog::AddTable("table"));
+  EXPECT_EQ(-1, BinaryDataLog::AddTable("table"));
+  ASSERT_EQ(0, BinaryDataLog::AddColumn("table", "int32",
+                                        BinaryDataLog::kInt32Column));
+  ASSERT_EQ(0, BinaryDataLog::AddColumn("table", "int64",
+                                        BinaryDataLog::kInt64Column));
+  ASSERT_EQ(0, BinaryDataLog::AddColumn("table", "float",
+                                        BinaryDataLog::kFloatColumn));
+  ASSERT_EQ(0, BinaryDataLog::AddColumn("table", "double",
+                                        BinaryDataLog::kDoubleColumn));
+  BinaryDataLog::Writer* writer = BinaryDataLog::CreateWriter("table");
+  ASSERT_TRUE(writer != NULL);
+  // The columns are fixed by the first writer.
+  EXPECT_EQ(-1, BinaryDataLog::AddColumn("table", "late",
+                                         BinaryDataLog::kInt32Column));
+
+  EXPECT_EQ(0, writer->InsertCell(0, static_cast<int32_t>(-7)));
+  EXPECT_EQ(0, writer->InsertCell(1, static_cast<int64_t>(1) << 40));
+  EXPECT_EQ(0, writer->InsertCell(2, 0.25f));
+  EXPECT_EQ(0, writer->InsertCell(3, 12.5));
+  writer->NextRow();
+  // Cells not set are NaN.
+  EXPECT_EQ(0, writer->InsertCell(3, -1.0));
+  writer->NextRow();
+  // The log is kept until the writer is deleted.
+  BinaryDataLog::ReturnLog();
+  delete writer;
+
+  EXPECT_EQ(2, BinaryDataLog::ConvertToCsv(log_file_name_, csv_file_prefix_));
+  EXPECT_EQ("int32,int64,float,double,\n"
+            "-7,1099511627776,0.25,12.5,\n"
+            "NaN,NaN,NaN,-1,\n",
+            ReadFile(CsvFileName("table")));
+}
+
+TEST_F(BinaryDataLogTest, WritesFullAndPartialBlocks) {
+  const int kNumRows = 2 * BinaryDataLog::kRowsPerBlock + 3;
+  LogRows(kNumRows);
+  EXPECT_EQ(kNumRows,
+            BinaryDataLog::ConvertToCsv(log_file_name_, csv_file_prefix_));
+
+  const std::string csv = ReadFile(CsvFileName("table"));
+  std::string expected = "a,b,\n";
+  for (int i = 0; i < kNumRows; ++i) {
+    char row[32];
+    snprintf(row, sizeof(row), "%d,%d.5,\n", i, i);
+    expected += row;
+  }
+  EXPECT_EQ(expected, csv);
+}
+
+TEST_F(BinaryDataLogTest, WritersOfOneTableShareTheFile) {
+  ASSERT_EQ(0, BinaryDataLog::CreateLog(log_file_name_));
+  ASSERT_EQ(0, BinaryDataLog::AddTable("table"));
+  ASSERT_EQ(0, BinaryDataLog::AddColumn("table", "writer",
+                                        BinaryDataLog::kInt32Column));
+  scoped_ptr<BinaryDataLog::Writer> writer1(
+      BinaryDataLog::CreateWriter("table"));
+  scoped_ptr<BinaryDataLog::Writer> writer2(
+      BinaryDataLog::CreateWriter("table"));
+  ASSERT_TRUE(writer1.get() != NULL);
+  ASSERT_TRUE(writer2.get() != NULL);
+  writer1->InsertCell(0, static_cast<int32_t>(1));
+  writer1->NextRow();
+  writer2->InsertCell(0, static_cast<int32_t>(2));
+  writer2->NextRow();
+  writer2->Flush();
+  writer1.reset();
+  writer2.reset();
+  BinaryDataLog::ReturnLog();
+
+  EXPECT_EQ(2, BinaryDataLog::ConvertToCsv(log_file_name_, csv_file_prefix_));
+  EXPECT_EQ("writer,\n2,\n1,\n", ReadFile(CsvFileName("table")));
+}
+
+TEST_F(BinaryDataLogTest, RejectsWrongCells) {
+  ASSERT_EQ(0, BinaryDataLog::CreateLog(log_file_name_));
+  EXPECT_TRUE(BinaryDataLog::CreateWriter("table") == NULL);
+  EXPECT_EQ(-1, BinaryDataLog::AddColumn("table", "a",
+                                         BinaryDataLog::kInt32Column));
+  ASSERT_EQ(0, BinaryDataLog::AddTable("table"));
+  ASSERT_EQ(0, BinaryDataLog::AddColumn("table", "a",
+                                        BinaryDataLog::kInt32Column));
+  scoped_ptr<BinaryDataLog::Writer> writer(
+      BinaryDataLog::CreateWriter("table"));
+  ASSERT_TRUE(writer.get() != NULL);
+  EXPECT_EQ(-1, writer->InsertCell(0, 1.0));
+  EXPECT_EQ(-1, writer->InsertCell(1, static_cast<int32_t>(1)));
+  writer.reset();
+  BinaryDataLog::ReturnLog();
+}
+
+TEST_F(BinaryDataLogTest, NoLog) {
+  EXPECT_EQ(-1, BinaryDataLog::AddTable("table"));
+  EXPECT_TRUE(BinaryDataLog::CreateWriter("table") == NULL);
+  EXPECT_EQ(-1, BinaryDataLog::ConvertToCsv(log_file_name_, csv_file_prefix_));
+}
+
+TEST_F(BinaryDataLogTest, IgnoresTruncatedRecord) {
+  LogRows(BinaryDataLog::kRowsPerBlock + 1);
+  // Cut the last block, of one row, in half.
+  std::string log = ReadFile(log_file_name_);
+  const size_t kLastBlockLength = 4 * sizeof(uint32_t) + sizeof(uint32_t) +
+                                  sizeof(int32_t) + sizeof(double);
+  ASSERT_GT(log.size(), kLastBlockLength);
+  log.resize(log.size() - kLastBlockLength / 2);
+  FILE* file = fopen(log_file_name_.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  fwrite(log.data(), 1, log.size(), file);
+  fclose(file);
+
+  EXPECT_EQ(BinaryDataLog::kRowsPerBlock,
+            BinaryDataLog::ConvertToCsv(log_file_name_, csv_file_prefix_));
+}
+
+TEST_F(BinaryDataLogTest, RejectsOtherFiles) {
+  FILE* file = fopen(log_file_name_.c_str(), "wb");
+  ASSERT_TRUE(file != NULL);
+  fputs("a,b,\n1,2,\n", file);
+  fclose(file);
+  EXPECT_EQ(-1, BinaryDataLog::ConvertToCsv(log_file_name_, csv_file_prefix_));
+}
+
+}  // namespace webrtc
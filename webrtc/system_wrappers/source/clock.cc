@@ -142,7 +142,7 @@ class RealTimeClock : public Clock {
   // Retrieve an NTP absolute timestamp in seconds and fractions of a second.
   virtual void CurrentNtp(uint32_t& seconds,
                           uint32_t& fractions) const OVERRIDE {
-    timeval tv = CurrentTimeVal();
+    timeval tv = ScaledTimeVal();
     double microseconds_in_seconds;
     Adjust(tv, &seconds, &microseconds_in_seconds);
     fractions = static_cast<uint32_t>(
@@ -151,7 +151,7 @@ class RealTimeClock : public Clock {
 
   // Retrieve an NTP absolute timestamp in milliseconds.
   virtual int64_t CurrentNtpInMilliseconds() const OVERRIDE {
-    timeval tv = CurrentTimeVal();
+    timeval tv = ScaledTimeVal();
     uint32_t seconds;
     double microseconds_in_seconds;
     Adjust(tv, &seconds, &microseconds_in_seconds);
@@ -162,6 +162,18 @@ class RealTimeClock : public Clock {
  protected:
   virtual timeval CurrentTimeVal() const = 0;
 
+  // The wall clock time, running as fast as TickTime when it is scaled.
+  timeval ScaledTimeVal() const {
+    timeval tv = CurrentTimeVal();
+    if (TickTime::time_scale() == 1)
+      return tv;
+    const int64_t us = 1000000LL * tv.tv_sec + tv.tv_usec +
+        TickTime::TimeScaleOffsetMicroseconds();
+    tv.tv_sec = static_cast<long>(us / 1000000);
+    tv.tv_usec = static_cast<long>(us % 1000000);
+    return tv;
+  }
+
   static void Adjust(const timeval& tv, uint32_t* adjusted_s,
                      double* adjusted_us_in_s) {
     *adjusted_s = tv.tv_sec + kNtpJan1970;
@@ -11,6 +11,7 @@
 #include "webrtc/system_wrappers/interface/clock.h"
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 
 namespace webrtc {
 
@@ -24,4 +25,30 @@ TEST(ClockTest, NtpTime) {
   EXPECT_GE(milliseconds, Clock::NtpToMs(seconds, fractions));
   EXPECT_NEAR(milliseconds, Clock::NtpToMs(seconds, fractions), 5);
 }
+
+// The scaled time is tested through its math only. Changing the time scale of
+// the process would change the time of every test that runs after this one.
+TEST(ClockTest, ScaledTicks) {
+  const int kTimeScale = 10;
+  const int64_t kOriginTicks = TickTime::MillisecondsToTicks(1000);
+  const int64_t kOsTicks = TickTime::MillisecondsToTicks(1500);
+
+  EXPECT_EQ(kOriginTicks,
+            TickTime::ScaleTicks(kOriginTicks, kOriginTicks, kTimeScale));
+  EXPECT_EQ(TickTime::MillisecondsToTicks(6000),
+            TickTime::ScaleTicks(kOsTicks, kOriginTicks, kTimeScale));
+  EXPECT_EQ(kOsTicks, TickTime::ScaleTicks(kOsTicks, kOriginTicks, 1));
+}
+
+TEST(ClockTest, ScaledWait) {
+  EXPECT_EQ(50000, TickTime::ScaledWaitMicroseconds(500, 10));
+  EXPECT_EQ(500000, TickTime::ScaledWaitMicroseconds(500, 1));
+  // Rounded down to whole microseconds.
+  EXPECT_EQ(333, TickTime::ScaledWaitMicroseconds(1, 3));
+}
+
+TEST(ClockTest, RealTimeIsNotScaledByDefault) {
+  EXPECT_EQ(1, TickTime::time_scale());
+  EXPECT_EQ(0, TickTime::TimeScaleOffsetMicroseconds());
+}
 }  // namespace webrtc
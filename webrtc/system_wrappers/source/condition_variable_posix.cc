@@ -17,6 +17,7 @@
 #include <sys/time.h>
 #endif
 
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/system_wrappers/source/critical_section_posix.h"
 
 namespace webrtc {
@@ -78,12 +79,12 @@ void ConditionVariablePosix::SleepCS(CriticalSectionWrapper& crit_sect) {
 bool ConditionVariablePosix::SleepCS(CriticalSectionWrapper& crit_sect,
                                      unsigned long max_time_inMS) {
   const unsigned long INFINITE =  0xFFFFFFFF;
-  const int MILLISECONDS_PER_SECOND = 1000;
 #ifndef WEBRTC_LINUX
   const int MICROSECONDS_PER_MILLISECOND = 1000;
 #endif
+  const int MICROSECONDS_PER_SECOND = 1000000;
   const int NANOSECONDS_PER_SECOND = 1000000000;
-  const int NANOSECONDS_PER_MILLISECOND  = 1000000;
+  const int NANOSECONDS_PER_MICROSECOND = 1000;
 
   CriticalSectionPosix* cs = reinterpret_cast<CriticalSectionPosix*>(
       &crit_sect);
@@ -103,11 +104,11 @@ bool ConditionVariablePosix::SleepCS(CriticalSectionWrapper& crit_sect,
     ts.tv_nsec = tv.tv_usec * MICROSECONDS_PER_MILLISECOND;
 #endif
 
-    ts.tv_sec += max_time_inMS / MILLISECONDS_PER_SECOND;
-    ts.tv_nsec +=
-        (max_time_inMS
-        - ((max_time_inMS / MILLISECONDS_PER_SECOND) * MILLISECONDS_PER_SECOND))
-        * NANOSECONDS_PER_MILLISECOND;
+    // The wait time is in scaled time.
+    const int64_t max_time_us = TickTime::ScaledWaitMicroseconds(max_time_inMS);
+    ts.tv_sec += max_time_us / MICROSECONDS_PER_SECOND;
+    ts.tv_nsec += (max_time_us % MICROSECONDS_PER_SECOND) *
+        NANOSECONDS_PER_MICROSECOND;
 
     if (ts.tv_nsec >= NANOSECONDS_PER_SECOND) {
       ts.tv_sec += ts.tv_nsec / NANOSECONDS_PER_SECOND;
@@ -13,6 +13,7 @@
 #include "webrtc/system_wrappers/interface/cpu_features_wrapper.h"
 
 #if defined(WEBRTC_ARCH_X86_FAMILY) && defined(_MSC_VER)
+#include <immintrin.h>
 #include <intrin.h>
 #endif
 
@@ -26,25 +27,41 @@ int GetCPUInfoNoASM(CPUFeature feature) {
 
 #if defined(WEBRTC_ARCH_X86_FAMILY)
 #ifndef _MSC_VER
-// Intrinsic for "cpuid".
+// Intrinsics for "cpuid".
 #if defined(__pic__) && defined(__i386__)
-static inline void __cpuid(int cpu_info[4], int info_type) {
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_leaf) {
   __asm__ volatile(
     "mov %%ebx, %%edi\n"
     "cpuid\n"
     "xchg %%edi, %%ebx\n"
     : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type));
+    : "a"(info_type), "c"(sub_leaf));
 }
 #else
-static inline void __cpuid(int cpu_info[4], int info_type) {
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_leaf) {
   __asm__ volatile(
     "cpuid\n"
     : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type));
+    : "a"(info_type), "c"(sub_leaf));
 }
 #endif
+
+static inline void __cpuid(int cpu_info[4], int info_type) {
+  __cpuidex(cpu_info, info_type, 0);
+}
 #endif  // _MSC_VER
+
+// Reads the extended control register |xcr|, which tells which register
+// states the OS saves on context switches.
+static inline uint64_t ReadXCR(uint32_t xcr) {
+#if defined(_MSC_VER)
+  return _xgetbv(xcr);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
 #if defined(WEBRTC_ARCH_X86_FAMILY)
@@ -58,6 +75,25 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  if (feature == kAVX || feature == kFMA) {
+    // AVX needs both CPU support and the OS (OSXSAVE) saving the XMM and YMM
+    // state.
+    const bool avx = (cpu_info[2] & 0x18000000) == 0x18000000 &&
+                     (ReadXCR(0) & 0x6) == 0x6;
+    if (feature == kAVX)
+      return avx;
+    return avx && 0 != (cpu_info[2] & 0x00001000);
+  }
+  if (feature == kAVX2) {
+    if ((cpu_info[2] & 0x18000000) != 0x18000000 || (ReadXCR(0) & 0x6) != 0x6)
+      return 0;
+    // The extended features are in leaf 7, if the CPU has it.
+    __cpuid(cpu_info, 0);
+    if (cpu_info[0] < 7)
+      return 0;
+    __cpuidex(cpu_info, 7, 0);
+    return 0 != (cpu_info[1] & 0x00000020);
+  }
   return 0;
 }
 #else
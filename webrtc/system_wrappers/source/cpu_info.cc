@@ -13,9 +13,11 @@
 #if defined(_WIN32)
 #include <Windows.h>
 #elif defined(WEBRTC_MAC)
+#include <mach/mach.h>
 #include <sys/sysctl.h>
 #include <sys/types.h>
 #else // defined(WEBRTC_LINUX) or defined(WEBRTC_ANDROID)
+#include <time.h>
 #include <unistd.h>
 #endif
 
@@ -61,4 +63,44 @@ uint32_t CpuInfo::DetectNumberOfCores() {
   return number_of_cores_;
 }
 
+int64_t CpuInfo::ThreadCpuTimeUs() {
+#if defined(_WIN32)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time,
+                      &kernel_time, &user_time)) {
+    return -1;
+  }
+  ULARGE_INTEGER kernel, user;
+  kernel.LowPart = kernel_time.dwLowDateTime;
+  kernel.HighPart = kernel_time.dwHighDateTime;
+  user.LowPart = user_time.dwLowDateTime;
+  user.HighPart = user_time.dwHighDateTime;
+  // In units of 100 ns.
+  return static_cast<int64_t>((kernel.QuadPart + user.QuadPart) / 10);
+
+#elif defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    return -1;
+  return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+
+#elif defined(WEBRTC_MAC)
+  mach_port_t thread = mach_thread_self();
+  thread_basic_info_data_t info;
+  mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+  kern_return_t result = thread_info(thread, THREAD_BASIC_INFO,
+                                     reinterpret_cast<thread_info_t>(&info),
+                                     &count);
+  mach_port_deallocate(mach_task_self(), thread);
+  if (result != KERN_SUCCESS)
+    return -1;
+  return (static_cast<int64_t>(info.user_time.seconds) +
+          info.system_time.seconds) * 1000000 +
+         info.user_time.microseconds + info.system_time.microseconds;
+
+#else
+  return -1;
+#endif
+}
+
 }  // namespace webrtc
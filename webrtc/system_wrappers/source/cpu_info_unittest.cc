@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+
+#include <stdio.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+
+namespace webrtc {
+
+TEST(CpuInfoTest, ThreadCpuTimeCountsOnlyBusyTime) {
+  const int kBusyMs = 50;
+  const int64_t start_us = CpuInfo::ThreadCpuTimeUs();
+  if (start_us < 0) {
+    printf("Thread CPU time not supported, skipping.\n");
+    return;
+  }
+  Clock* clock = Clock::GetRealTimeClock();
+  const int64_t busy_start_ms = clock->TimeInMilliseconds();
+  while (clock->TimeInMilliseconds() - busy_start_ms < kBusyMs) {
+  }
+  const int64_t busy_us = CpuInfo::ThreadCpuTimeUs() - start_us;
+  EXPECT_GT(busy_us, kBusyMs * 1000 / 2);
+
+  const int64_t sleep_start_us = CpuInfo::ThreadCpuTimeUs();
+  SleepMs(kBusyMs);
+  EXPECT_LT(CpuInfo::ThreadCpuTimeUs() - sleep_start_us, kBusyMs * 1000 / 2);
+}
+
+}  // namespace webrtc
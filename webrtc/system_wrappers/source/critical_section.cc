@@ -25,4 +25,13 @@ CriticalSectionWrapper* CriticalSectionWrapper::CreateCriticalSection() {
 #endif
 }
 
+CriticalSectionWrapper* CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+    const char* name) {
+#ifdef _WIN32
+  return new CriticalSectionWindows(CriticalSectionWindows::kAdaptiveSpinCount);
+#else
+  return new CriticalSectionAdaptivePosix(name);
+#endif
+}
+
 }  // namespace webrtc
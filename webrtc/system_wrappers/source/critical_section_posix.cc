@@ -16,8 +16,41 @@
 
 #include "webrtc/system_wrappers/source/critical_section_posix.h"
 
+#include <algorithm>
+#include <string>
+
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#if defined(WEBRTC_LOCK_PROFILING)
+#include "webrtc/base/timeutils.h"
+#include "webrtc/system_wrappers/interface/metrics.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#endif
+
 namespace webrtc {
 
+namespace {
+
+// Upper bound of the spins before blocking, about the cost of a context
+// switch.
+const int kMaxAdaptiveSpins = 100;
+
+inline void CpuRelax() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  __asm__ __volatile__("pause");
+#elif defined(WEBRTC_ARCH_ARM_V7)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+#if defined(WEBRTC_LOCK_PROFILING)
+metrics::Histogram* GetWaitHistogram(const char* name) {
+  return metrics::GetHistogram(
+      (std::string("WebRTC.LockWaitUs.") + name).c_str());
+}
+#endif
+
+}  // namespace
+
 CriticalSectionPosix::CriticalSectionPosix() {
   pthread_mutexattr_t attr;
   (void) pthread_mutexattr_init(&attr);
@@ -31,12 +64,79 @@ CriticalSectionPosix::~CriticalSectionPosix() {
 
 void
 CriticalSectionPosix::Enter() {
+#if defined(WEBRTC_LOCK_PROFILING)
+  const void* call_site = RTC_CALL_SITE();
+  if (pthread_mutex_trylock(&mutex_) != 0) {
+    const uint64_t start_us = rtc::TimeMicros();
+    (void) pthread_mutex_lock(&mutex_);
+    rtc::LockProfiler::RecordWait(
+        call_site, static_cast<int64_t>(rtc::TimeMicros() - start_us));
+  }
+  profile_state_.Locked(call_site);
+#else
   (void) pthread_mutex_lock(&mutex_);
+#endif
 }
 
 void
 CriticalSectionPosix::Leave() {
+#if defined(WEBRTC_LOCK_PROFILING)
+  profile_state_.Unlocking();
+#endif
   (void) pthread_mutex_unlock(&mutex_);
 }
 
+CriticalSectionAdaptivePosix::CriticalSectionAdaptivePosix(const char* name)
+    : max_spins_(CpuInfo::DetectNumberOfCores() > 1 ? kMaxAdaptiveSpins : 0),
+      spin_count_(0)
+#if defined(WEBRTC_LOCK_PROFILING)
+      , wait_histogram_(GetWaitHistogram(name))
+#endif
+{
+}
+
+CriticalSectionAdaptivePosix::~CriticalSectionAdaptivePosix() {}
+
+void CriticalSectionAdaptivePosix::Enter() {
+#if defined(WEBRTC_LOCK_PROFILING)
+  const void* call_site = RTC_CALL_SITE();
+  if (pthread_mutex_trylock(&mutex_) != 0) {
+    const uint64_t start_us = rtc::TimeMicros();
+    EnterContended();
+    rtc::LockProfiler::RecordWait(
+        call_site, static_cast<int64_t>(rtc::TimeMicros() - start_us));
+  }
+  profile_state_.Locked(call_site);
+#else
+  if (pthread_mutex_trylock(&mutex_) == 0)
+    return;
+  EnterContended();
+#endif
+}
+
+void CriticalSectionAdaptivePosix::EnterContended() {
+#if defined(WEBRTC_LOCK_PROFILING)
+  const int64_t start_us = TickTime::MicrosecondTimestamp();
+#endif
+  // Reading |spin_count_| without the lock is fine, it is only a hint.
+  const int max_spins = std::min(max_spins_, 2 * spin_count_ + 10);
+  int spins = 0;
+  bool locked = false;
+  while (spins < max_spins) {
+    ++spins;
+    CpuRelax();
+    if (pthread_mutex_trylock(&mutex_) == 0) {
+      locked = true;
+      break;
+    }
+  }
+  if (!locked)
+    (void) pthread_mutex_lock(&mutex_);
+  spin_count_ += (spins - spin_count_) / 8;
+#if defined(WEBRTC_LOCK_PROFILING)
+  wait_histogram_->Add(
+      static_cast<int>(TickTime::MicrosecondTimestamp() - start_us));
+#endif
+}
+
 }  // namespace webrtc
@@ -15,8 +15,16 @@
 
 #include <pthread.h>
 
+#if defined(WEBRTC_LOCK_PROFILING)
+#include "webrtc/base/lockprofiler.h"
+#endif
+
 namespace webrtc {
 
+namespace metrics {
+class Histogram;
+}  // namespace metrics
+
 class CriticalSectionPosix : public CriticalSectionWrapper {
  public:
   CriticalSectionPosix();
@@ -26,11 +34,40 @@ class CriticalSectionPosix : public CriticalSectionWrapper {
   virtual void Enter() OVERRIDE;
   virtual void Leave() OVERRIDE;
 
- private:
+ protected:
   pthread_mutex_t mutex_;
+#if defined(WEBRTC_LOCK_PROFILING)
+  rtc::LockProfileState profile_state_;
+#endif
+
+ private:
   friend class ConditionVariablePosix;
 };
 
+// Spins on the mutex for a while before blocking on it. The number of spins
+// follows how many it has recently taken to get the lock, like glibc's
+// PTHREAD_MUTEX_ADAPTIVE_NP, which can't be used here since that type isn't
+// recursive.
+class CriticalSectionAdaptivePosix : public CriticalSectionPosix {
+ public:
+  explicit CriticalSectionAdaptivePosix(const char* name);
+  virtual ~CriticalSectionAdaptivePosix();
+
+  virtual void Enter() OVERRIDE;
+
+ private:
+  void EnterContended();
+
+  // Zero on single core machines.
+  const int max_spins_;
+  // Moving average of the spins needed to get the lock. Only updated with the
+  // lock held.
+  int spin_count_;
+#if defined(WEBRTC_LOCK_PROFILING)
+  metrics::Histogram* const wait_histogram_;
+#endif
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_SYSTEM_WRAPPERS_SOURCE_CRITICAL_SECTION_POSIX_H_
@@ -137,6 +137,27 @@ TEST_F(CritSectTest, ThreadWakesTwice) NO_THREAD_SAFETY_ANALYSIS {
   delete crit_sect;
 }
 
+TEST_F(CritSectTest, AdaptiveWaitsForOwner) NO_THREAD_SAFETY_ANALYSIS {
+  CriticalSectionWrapper* crit_sect =
+      CriticalSectionWrapper::CreateAdaptiveCriticalSection("Test");
+  ProtectedCount count(crit_sect);
+  ThreadWrapper* thread = ThreadWrapper::CreateThread(
+      &LockUnlockThenStopRunFunction, &count);
+  unsigned int id = 42;
+  crit_sect->Enter();
+  ASSERT_TRUE(thread->Start(id));
+  // Long enough for the thread to give up spinning and block.
+  for (int i = 0; i < 10; i++) {
+    SwitchProcess();
+  }
+  ASSERT_EQ(0, count.Count());
+  crit_sect->Leave();
+  EXPECT_TRUE(WaitForCount(1, &count));
+  EXPECT_TRUE(thread->Stop());
+  delete thread;
+  delete crit_sect;
+}
+
 }  // anonymous namespace
 
 }  // namespace webrtc
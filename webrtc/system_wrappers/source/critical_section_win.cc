@@ -10,23 +10,45 @@
 
 #include "webrtc/system_wrappers/source/critical_section_win.h"
 
+#if defined(WEBRTC_LOCK_PROFILING)
+#include "webrtc/base/timeutils.h"
+#endif
+
 namespace webrtc {
 
 CriticalSectionWindows::CriticalSectionWindows() {
   InitializeCriticalSection(&crit);
 }
 
+CriticalSectionWindows::CriticalSectionWindows(DWORD spin_count) {
+  InitializeCriticalSectionAndSpinCount(&crit, spin_count);
+}
+
 CriticalSectionWindows::~CriticalSectionWindows() {
   DeleteCriticalSection(&crit);
 }
 
 void
 CriticalSectionWindows::Enter() {
+#if defined(WEBRTC_LOCK_PROFILING)
+  const void* call_site = RTC_CALL_SITE();
+  if (TryEnterCriticalSection(&crit) == FALSE) {
+    const uint64_t start_us = rtc::TimeMicros();
+    EnterCriticalSection(&crit);
+    rtc::LockProfiler::RecordWait(
+        call_site, static_cast<int64_t>(rtc::TimeMicros() - start_us));
+  }
+  profile_state_.Locked(call_site);
+#else
   EnterCriticalSection(&crit);
+#endif
 }
 
 void
 CriticalSectionWindows::Leave() {
+#if defined(WEBRTC_LOCK_PROFILING)
+  profile_state_.Unlocking();
+#endif
   LeaveCriticalSection(&crit);
 }
 
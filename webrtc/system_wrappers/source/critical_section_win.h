@@ -15,11 +15,20 @@
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/typedefs.h"
 
+#if defined(WEBRTC_LOCK_PROFILING)
+#include "webrtc/base/lockprofiler.h"
+#endif
+
 namespace webrtc {
 
 class CriticalSectionWindows : public CriticalSectionWrapper {
  public:
+  // The spin count used for adaptive critical sections. Windows adjusts the
+  // spinning below it to how long the lock is held.
+  enum { kAdaptiveSpinCount = 4000 };
+
   CriticalSectionWindows();
+  explicit CriticalSectionWindows(DWORD spin_count);
 
   virtual ~CriticalSectionWindows();
 
@@ -28,6 +37,9 @@ class CriticalSectionWindows : public CriticalSectionWrapper {
 
  private:
   CRITICAL_SECTION crit;
+#if defined(WEBRTC_LOCK_PROFILING)
+  rtc::LockProfileState profile_state_;
+#endif
 
   friend class ConditionVariableEventWin;
   friend class ConditionVariableNativeWin;
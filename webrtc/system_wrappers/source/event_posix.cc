@@ -18,6 +18,8 @@
 #include <sys/time.h>
 #include <unistd.h>
 
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
 namespace webrtc {
 
 const long int E6 = 1000000;
@@ -133,8 +135,10 @@ EventTypeWrapper EventPosix::Wait(unsigned long timeout) {
       gettimeofday(&value, &time_zone);
       TIMEVAL_TO_TIMESPEC(&value, &end_at);
 #endif
-      end_at.tv_sec  += timeout / 1000;
-      end_at.tv_nsec += (timeout - (timeout / 1000) * 1000) * E6;
+      // The timeout is in scaled time.
+      const int64_t timeout_us = TickTime::ScaledWaitMicroseconds(timeout);
+      end_at.tv_sec  += timeout_us / E6;
+      end_at.tv_nsec += (timeout_us % E6) * 1000;
 
       if (end_at.tv_nsec >= E9) {
         end_at.tv_sec++;
@@ -238,9 +242,10 @@ bool EventPosix::Process() {
   }
 
   timespec end_at;
-  unsigned long long time = time_ * ++count_;
-  end_at.tv_sec  = created_at_.tv_sec + time / 1000;
-  end_at.tv_nsec = created_at_.tv_nsec + (time - (time / 1000) * 1000) * E6;
+  const int64_t time_us = TickTime::ScaledWaitMicroseconds(
+      static_cast<int64_t>(time_) * ++count_);
+  end_at.tv_sec  = created_at_.tv_sec + time_us / E6;
+  end_at.tv_nsec = created_at_.tv_nsec + (time_us % E6) * 1000;
 
   if (end_at.tv_nsec >= E9) {
     end_at.tv_sec++;
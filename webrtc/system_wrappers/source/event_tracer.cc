@@ -10,6 +10,25 @@
 
 #include "webrtc/system_wrappers/interface/event_tracer.h"
 
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/static_instance.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
+
+#if defined(_WIN32)
+#define snprintf _snprintf
+#endif
+
 namespace webrtc {
 
 namespace {
@@ -17,21 +36,368 @@ namespace {
 GetCategoryEnabledPtr g_get_category_enabled_ptr = 0;
 AddTraceEventPtr g_add_trace_event_ptr = 0;
 
+// Number of events the built-in tracer keeps, a few MB worth.
+const size_t kMaxInternalTraceEvents = 16384;
+// The trace macros pass at most two arguments.
+const int kMaxTraceArgs = 2;
+
+void AppendJsonString(const char* str, std::string* out) {
+  out->push_back('"');
+  for (; *str; ++str) {
+    const unsigned char c = static_cast<unsigned char>(*str);
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (c < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out->append(escaped);
+    } else {
+      out->push_back(c);
+    }
+  }
+  out->push_back('"');
+}
+
 }  // namespace
 
+// Records the trace events into a fixed size ring buffer, so that a tracer
+// left running keeps the most recent events without growing. Recording takes
+// no lock: a writer claims the next slot with an atomic counter and marks it
+// busy while it fills it in, and an event whose slot is still busy, being
+// read by a dump or filled in by a writer a whole buffer ahead, is dropped.
+// The strings the macros mark for copying are copied into the buffered event;
+// all others are literals and are kept by pointer only. Categories live in a
+// fixed table that is never freed, since the trace macros keep a pointer to
+// their enabled state in a static at each call site.
+class InternalTracer {
+ public:
+  static InternalTracer* Get() {
+    static InternalTracer* const tracer =
+        GetStaticInstance<InternalTracer>(kAddRef);
+    return tracer;
+  }
+
+  const unsigned char* GetCategoryEnabled(const char* name) {
+    CriticalSectionScoped cs(crit_.get());
+    Category* category = GetCategory(name);
+    return category ? &category->enabled : &categories_exhausted_;
+  }
+
+  void EnableCategory(const char* name, bool enable) {
+    CriticalSectionScoped cs(crit_.get());
+    // The buffer is only allocated once there is something to record.
+    if (enable && !slots_) {
+      slots_.reset(new Slot[kMaxInternalTraceEvents]);
+      ++slots_allocated_;
+    }
+    if (strcmp(name, "*") != 0) {
+      Category* category = GetCategory(name);
+      if (category)
+        category->enabled = enable ? 1 : 0;
+      return;
+    }
+    all_enabled_ = enable;
+    for (int i = 0; i < num_categories_.Value(); ++i)
+      categories_[i].enabled = enable ? 1 : 0;
+  }
+
+  void AddTraceEvent(char phase,
+                     const unsigned char* category_enabled,
+                     const char* name,
+                     unsigned long long id,
+                     int num_args,
+                     const char** arg_names,
+                     const unsigned char* arg_types,
+                     const unsigned long long* arg_values,
+                     unsigned char flags) {
+    const Category* category = FindCategory(category_enabled);
+    if (!category || !slots_allocated_.Value())
+      return;  // Looked up while another tracer was set up.
+    const uint32_t sequence = static_cast<uint32_t>(++next_event_) - 1;
+    Slot& slot = slots_[sequence % kMaxInternalTraceEvents];
+    if (!slot.state.CompareExchange(kSlotWriting, kSlotEmpty) &&
+        !slot.state.CompareExchange(kSlotWriting, kSlotReady)) {
+      return;
+    }
+    Event& event = slot.event;
+    event.sequence = sequence;
+    event.timestamp_us = TickTime::MicrosecondTimestamp();
+    event.thread_id = ThreadWrapper::GetThreadId();
+    event.phase = phase;
+    event.flags = flags;
+    event.category = category->name.c_str();
+    event.id = id;
+    if (flags & TRACE_EVENT_FLAG_COPY) {
+      event.copied_name = name;
+      event.name = NULL;
+    } else {
+      event.name = name;
+    }
+    event.num_args = num_args < kMaxTraceArgs ? num_args : kMaxTraceArgs;
+    for (int i = 0; i < event.num_args; ++i) {
+      event.arg_types[i] = arg_types[i];
+      event.arg_values[i] = arg_values[i];
+      if (flags & TRACE_EVENT_FLAG_COPY) {
+        event.copied_arg_names[i] = arg_names[i];
+        event.arg_names[i] = NULL;
+      } else {
+        event.arg_names[i] = arg_names[i];
+      }
+      if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING) {
+        event.copied_strings[i] =
+            reinterpret_cast<const char*>(static_cast<uintptr_t>(
+                arg_values[i]));
+      }
+    }
+    slot.state.CompareExchange(kSlotReady, kSlotWriting);
+  }
+
+  std::string Dump() {
+    std::vector<Event> events;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      if (slots_) {
+        for (size_t i = 0; i < kMaxInternalTraceEvents; ++i) {
+          Slot& slot = slots_[i];
+          if (!slot.state.CompareExchange(kSlotReading, kSlotReady))
+            continue;
+          events.push_back(slot.event);
+          slot.state.CompareExchange(kSlotReady, kSlotReading);
+        }
+      }
+    }
+    // Oldest first: the events furthest behind the next one to be claimed.
+    std::sort(events.begin(), events.end(),
+              EventIsOlder(static_cast<uint32_t>(next_event_.Value())));
+    std::string json = "{\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+      if (i > 0)
+        json.push_back(',');
+      AppendEvent(events[i], &json);
+    }
+    json.append("]}");
+    return json;
+  }
+
+  void Clear() {
+    CriticalSectionScoped cs(crit_.get());
+    if (!slots_)
+      return;
+    for (size_t i = 0; i < kMaxInternalTraceEvents; ++i)
+      slots_[i].state.CompareExchange(kSlotEmpty, kSlotReady);
+  }
+
+ private:
+  friend InternalTracer* GetStaticInstance<InternalTracer>(
+      CountOperation count_operation);
+
+  // The most categories the tracer keeps track of. The call sites of any
+  // further categories get a category that is never enabled.
+  static const int kMaxCategories = 100;
+
+  enum SlotState {
+    kSlotEmpty,
+    kSlotWriting,
+    kSlotReady,
+    kSlotReading
+  };
+
+  struct Category {
+    Category() : enabled(0) {}
+
+    unsigned char enabled;
+    std::string name;
+  };
+
+  struct Event {
+    uint32_t sequence;
+    int64_t timestamp_us;
+    uint32_t thread_id;
+    char phase;
+    unsigned char flags;
+    const char* category;
+    // NULL when the name is held in |copied_name|.
+    const char* name;
+    std::string copied_name;
+    unsigned long long id;
+    int num_args;
+    const char* arg_names[kMaxTraceArgs];
+    std::string copied_arg_names[kMaxTraceArgs];
+    unsigned char arg_types[kMaxTraceArgs];
+    unsigned long long arg_values[kMaxTraceArgs];
+    std::string copied_strings[kMaxTraceArgs];
+  };
+
+  struct Slot {
+    Atomic32 state;
+    Event event;
+  };
+
+  class EventIsOlder {
+   public:
+    explicit EventIsOlder(uint32_t next_sequence)
+        : next_sequence_(next_sequence) {}
+
+    bool operator()(const Event& a, const Event& b) const {
+      return next_sequence_ - a.sequence > next_sequence_ - b.sequence;
+    }
+
+   private:
+    uint32_t next_sequence_;
+  };
+
+  static InternalTracer* CreateInstance() { return new InternalTracer(); }
+
+  InternalTracer()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        categories_exhausted_(0),
+        all_enabled_(false) {}
+  ~InternalTracer() {}
+
+  // Must be called with |crit_| held. Returns NULL once the table is full.
+  Category* GetCategory(const char* name) {
+    const int num_categories = num_categories_.Value();
+    for (int i = 0; i < num_categories; ++i) {
+      if (categories_[i].name == name)
+        return &categories_[i];
+    }
+    if (num_categories == kMaxCategories)
+      return NULL;
+    Category* category = &categories_[num_categories];
+    category->enabled = all_enabled_ ? 1 : 0;
+    category->name = name;
+    // Publishes the category to FindCategory().
+    ++num_categories_;
+    return category;
+  }
+
+  // Returns the category whose enabled state is at |category_enabled|, or
+  // NULL if it isn't one of ours.
+  const Category* FindCategory(const unsigned char* category_enabled) {
+    const uintptr_t offset = reinterpret_cast<uintptr_t>(category_enabled) -
+                             reinterpret_cast<uintptr_t>(&categories_[0]);
+    const size_t index = offset / sizeof(Category);
+    if (index >= static_cast<size_t>(num_categories_.Value()) ||
+        &categories_[index].enabled != category_enabled) {
+      return NULL;
+    }
+    return &categories_[index];
+  }
+
+  static void AppendEvent(const Event& event, std::string* json) {
+    char buffer[64];
+    json->append("{\"name\":");
+    AppendJsonString(event.name ? event.name : event.copied_name.c_str(),
+                     json);
+    json->append(",\"cat\":");
+    AppendJsonString(event.category, json);
+    snprintf(buffer, sizeof(buffer), ",\"ph\":\"%c\",\"ts\":%lld,\"pid\":1",
+             event.phase, static_cast<long long>(event.timestamp_us));
+    json->append(buffer);
+    snprintf(buffer, sizeof(buffer), ",\"tid\":%u", event.thread_id);
+    json->append(buffer);
+    if (event.flags & TRACE_EVENT_FLAG_HAS_ID) {
+      snprintf(buffer, sizeof(buffer), ",\"id\":\"0x%llx\"", event.id);
+      json->append(buffer);
+    }
+    if (event.phase == TRACE_EVENT_PHASE_INSTANT)
+      json->append(",\"s\":\"t\"");
+    json->append(",\"args\":{");
+    for (int i = 0; i < event.num_args; ++i) {
+      if (i > 0)
+        json->push_back(',');
+      AppendJsonString(event.arg_names[i] ? event.arg_names[i]
+                                          : event.copied_arg_names[i].c_str(),
+                       json);
+      json->push_back(':');
+      AppendArgValue(event, i, json);
+    }
+    json->append("}}");
+  }
+
+  static void AppendArgValue(const Event& event, int i, std::string* json) {
+    trace_event_internal::TraceValueUnion value;
+    value.as_uint = event.arg_values[i];
+    char buffer[32];
+    switch (event.arg_types[i]) {
+      case TRACE_VALUE_TYPE_BOOL:
+        json->append(value.as_bool ? "true" : "false");
+        return;
+      case TRACE_VALUE_TYPE_UINT:
+        snprintf(buffer, sizeof(buffer), "%llu", value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        snprintf(buffer, sizeof(buffer), "%lld", value.as_int);
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        // JSON has no NaN or infinities; they are written as strings, the
+        // way Chrome's tracer writes them.
+        if (value.as_double != value.as_double) {
+          json->append("\"NaN\"");
+          return;
+        }
+        if (value.as_double == std::numeric_limits<double>::infinity() ||
+            value.as_double == -std::numeric_limits<double>::infinity()) {
+          json->append(value.as_double < 0 ? "\"-Infinity\"" : "\"Infinity\"");
+          return;
+        }
+        snprintf(buffer, sizeof(buffer), "%.17g", value.as_double);
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        snprintf(buffer, sizeof(buffer), "\"%p\"", value.as_pointer);
+        break;
+      case TRACE_VALUE_TYPE_STRING:
+        AppendJsonString(value.as_string ? value.as_string : "", json);
+        return;
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        AppendJsonString(event.copied_strings[i].c_str(), json);
+        return;
+      default:
+        json->append("null");
+        return;
+    }
+    json->append(buffer);
+  }
+
+  // Guards the category table and the buffer allocation against each other,
+  // and serializes the dumps. Recording events doesn't take it.
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  Category categories_[kMaxCategories];
+  Atomic32 num_categories_;
+  // Handed out once |categories_| is full, and never enabled.
+  unsigned char categories_exhausted_;
+  bool all_enabled_;
+  scoped_ptr<Slot[]> slots_;
+  // Set once |slots_| is allocated; it is never freed.
+  Atomic32 slots_allocated_;
+  Atomic32 next_event_;
+};
+
 void SetupEventTracer(GetCategoryEnabledPtr get_category_enabled_ptr,
                       AddTraceEventPtr add_trace_event_ptr) {
   g_get_category_enabled_ptr = get_category_enabled_ptr;
   g_add_trace_event_ptr = add_trace_event_ptr;
 }
 
+void EnableInternalTraceCategory(const char* category, bool enable) {
+  InternalTracer::Get()->EnableCategory(category, enable);
+}
+
+std::string DumpInternalTraceEvents() {
+  return InternalTracer::Get()->Dump();
+}
+
+void ClearInternalTraceEvents() {
+  InternalTracer::Get()->Clear();
+}
+
 // static
 const unsigned char* EventTracer::GetCategoryEnabled(const char* name) {
   if (g_get_category_enabled_ptr)
     return g_get_category_enabled_ptr(name);
 
-  // A string with null terminator means category is disabled.
-  return reinterpret_cast<const unsigned char*>("\0");
+  return InternalTracer::Get()->GetCategoryEnabled(name);
 }
 
 // static
@@ -54,7 +420,17 @@ void EventTracer::AddTraceEvent(char phase,
                           arg_types,
                           arg_values,
                           flags);
+    return;
   }
+  InternalTracer::Get()->AddTraceEvent(phase,
+                                       category_enabled,
+                                       name,
+                                       id,
+                                       num_args,
+                                       arg_names,
+                                       arg_types,
+                                       arg_values,
+                                       flags);
 }
 
 }  // namespace webrtc
@@ -10,8 +10,12 @@
 
 #include "webrtc/system_wrappers/interface/event_tracer.h"
 
+#include <string>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
 #include "webrtc/system_wrappers/interface/static_instance.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace_event.h"
 
 namespace {
@@ -62,21 +66,131 @@ static void AddTraceEventHandler(char phase,
 
 namespace webrtc {
 
-TEST(EventTracerTest, EventTracerDisabled) {
+// Each test starts with the built-in tracer, with all of its categories
+// disabled and its events cleared, and leaves it that way.
+class EventTracerTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { ResetTracer(); }
+  virtual void TearDown() { ResetTracer(); }
+
+  static void ResetTracer() {
+    SetupEventTracer(NULL, NULL);
+    EnableInternalTraceCategory("*", false);
+    ClearInternalTraceEvents();
+    TestStatistics::Get()->Reset();
+  }
+
+  static int CountOf(const std::string& str, const std::string& json) {
+    int count = 0;
+    for (size_t pos = json.find(str); pos != std::string::npos;
+         pos = json.find(str, pos + str.size())) {
+      ++count;
+    }
+    return count;
+  }
+};
+
+TEST_F(EventTracerTest, EventTracerDisabled) {
   {
     TRACE_EVENT0("test", "EventTracerDisabled");
   }
   EXPECT_FALSE(TestStatistics::Get()->Count());
-  TestStatistics::Get()->Reset();
 }
 
-TEST(EventTracerTest, ScopedTraceEvent) {
+TEST_F(EventTracerTest, InternalTracerDisabledByDefault) {
+  TRACE_EVENT_INSTANT0("internal_test", "InternalTracerDisabledByDefault");
+  EXPECT_EQ("{\"traceEvents\":[]}", DumpInternalTraceEvents());
+}
+
+TEST_F(EventTracerTest, InternalTracerRecordsEnabledCategories) {
+  EnableInternalTraceCategory("internal_test", true);
+  {
+    TRACE_EVENT1("internal_test", "Scoped", "value", 42);
+  }
+  TRACE_EVENT_INSTANT0("internal_other", "OtherCategory");
+  EnableInternalTraceCategory("internal_test", false);
+  TRACE_EVENT_INSTANT0("internal_test", "AfterDisable");
+
+  const std::string json = DumpInternalTraceEvents();
+  EXPECT_NE(std::string::npos, json.find(
+      "{\"name\":\"Scoped\",\"cat\":\"internal_test\",\"ph\":\"B\""));
+  EXPECT_NE(std::string::npos, json.find("\"args\":{\"value\":42}"));
+  EXPECT_NE(std::string::npos, json.find(
+      "{\"name\":\"Scoped\",\"cat\":\"internal_test\",\"ph\":\"E\""));
+  EXPECT_EQ(std::string::npos, json.find("OtherCategory"));
+  EXPECT_EQ(std::string::npos, json.find("AfterDisable"));
+}
+
+TEST_F(EventTracerTest, InternalTracerCopiesStrings) {
+  EnableInternalTraceCategory("*", true);
+  std::string name = "Copied";
+  std::string value = "a \"quoted\" value";
+  TRACE_EVENT_COPY_INSTANT1("internal_copy", name.c_str(), "str",
+                            TRACE_STR_COPY(value.c_str()));
+  name = "Changed";
+  value = "changed";
+
+  const std::string json = DumpInternalTraceEvents();
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"Copied\""));
+  EXPECT_NE(std::string::npos,
+            json.find("\"str\":\"a \\\"quoted\\\" value\""));
+}
+
+TEST_F(EventTracerTest, InternalTracerWritesNonFiniteDoublesAsStrings) {
+  EnableInternalTraceCategory("internal_test", true);
+  const double zero = 0.0;
+  TRACE_EVENT_INSTANT2("internal_test", "Doubles", "nan", zero / zero,
+                       "inf", 1.0 / zero);
+  TRACE_EVENT_INSTANT2("internal_test", "Doubles", "minus_inf", -1.0 / zero,
+                       "half", 0.5);
+
+  const std::string json = DumpInternalTraceEvents();
+  EXPECT_NE(std::string::npos,
+            json.find("\"args\":{\"nan\":\"NaN\",\"inf\":\"Infinity\"}"));
+  EXPECT_NE(std::string::npos,
+            json.find("\"args\":{\"minus_inf\":\"-Infinity\",\"half\":0.5}"));
+}
+
+TEST_F(EventTracerTest, InternalTracerKeepsMostRecentEvents) {
+  EnableInternalTraceCategory("internal_test", true);
+  for (int i = 0; i < 100000; ++i)
+    TRACE_EVENT_INSTANT1("internal_test", "Event", "i", i);
+
+  const std::string json = DumpInternalTraceEvents();
+  EXPECT_EQ(std::string::npos, json.find("\"i\":0}"));
+  EXPECT_NE(std::string::npos, json.find("\"i\":99999}"));
+  // Oldest first.
+  EXPECT_LT(json.find("\"i\":99998}"), json.find("\"i\":99999}"));
+}
+
+static bool TraceEvents(void* /* obj */) {
+  for (int i = 0; i < 1000; ++i)
+    TRACE_EVENT_INSTANT0("internal_test", "Threaded");
+  return false;
+}
+
+TEST_F(EventTracerTest, InternalTracerRecordsFromManyThreads) {
+  static const int kNumThreads = 4;
+  EnableInternalTraceCategory("internal_test", true);
+  scoped_ptr<ThreadWrapper> threads[kNumThreads];
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i].reset(ThreadWrapper::CreateThread(&TraceEvents, NULL));
+    unsigned int id;
+    ASSERT_TRUE(threads[i]->Start(id));
+  }
+  for (int i = 0; i < kNumThreads; ++i)
+    EXPECT_TRUE(threads[i]->Stop());
+
+  EXPECT_EQ(kNumThreads * 1000,
+            CountOf("\"name\":\"Threaded\"", DumpInternalTraceEvents()));
+}
+
+TEST_F(EventTracerTest, ScopedTraceEvent) {
   SetupEventTracer(&GetCategoryEnabledHandler, &AddTraceEventHandler);
   {
     TRACE_EVENT0("test", "ScopedTraceEvent");
   }
   EXPECT_EQ(2, TestStatistics::Get()->Count());
-  TestStatistics::Get()->Reset();
 }
 
 }  // namespace webrtc
@@ -12,6 +12,8 @@
 
 #include "Mmsystem.h"
 
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
 namespace webrtc {
 
 EventWindows::EventWindows()
@@ -36,8 +38,17 @@ bool EventWindows::Reset() {
   return ResetEvent(event_) == 1;
 }
 
+// Returns the OS time in ms for |time| ms of scaled time. The OS waits are in
+// whole ms, so the scaled time can't run arbitrarily fast.
+static unsigned long ScaledWaitMs(unsigned long time) {
+  if (TickTime::time_scale() == 1 || time == INFINITE)
+    return time;
+  return static_cast<unsigned long>(
+      (TickTime::ScaledWaitMicroseconds(time) + 999) / 1000);
+}
+
 EventTypeWrapper EventWindows::Wait(unsigned long max_time) {
-  unsigned long res = WaitForSingleObject(event_, max_time);
+  unsigned long res = WaitForSingleObject(event_, ScaledWaitMs(max_time));
   switch (res) {
     case WAIT_OBJECT_0:
       return kEventSignaled;
@@ -54,11 +65,12 @@ bool EventWindows::StartTimer(bool periodic, unsigned long time) {
     timerID_ = NULL;
   }
 
+  const unsigned long os_time = ScaledWaitMs(time);
   if (periodic) {
-    timerID_ = timeSetEvent(time, 0, (LPTIMECALLBACK)HANDLE(event_), 0,
+    timerID_ = timeSetEvent(os_time, 0, (LPTIMECALLBACK)HANDLE(event_), 0,
                             TIME_PERIODIC | TIME_CALLBACK_EVENT_PULSE);
   } else {
-    timerID_ = timeSetEvent(time, 0, (LPTIMECALLBACK)HANDLE(event_), 0,
+    timerID_ = timeSetEvent(os_time, 0, (LPTIMECALLBACK)HANDLE(event_), 0,
                             TIME_ONESHOT | TIME_CALLBACK_EVENT_SET);
   }
 
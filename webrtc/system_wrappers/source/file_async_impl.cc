@@ -0,0 +1,284 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/source/file_async_impl.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/system_wrappers/interface/aligned_malloc.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/static_instance.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+#include "webrtc/system_wrappers/source/file_impl.h"
+
+namespace webrtc {
+
+namespace {
+
+// Page aligned, so that the kernel can copy the buffers a page at a time.
+const size_t kBufferAlignment = 4096;
+// The buffers kept for reuse by each file.
+const size_t kMaxFreeBuffers = 2;
+const int kMaxTextLength = 1024;
+const unsigned long kStallWaitMs = 100;
+
+// The thread shared by all the async files. It is started with the first file
+// and stopped when the last one is destroyed.
+class WriterThread {
+ public:
+  static ThreadPool* AddRef() {
+    return GetStaticInstance<WriterThread>(kAddRef)->pool_.get();
+  }
+  static void Release() { GetStaticInstance<WriterThread>(kRelease); }
+
+ private:
+  friend WriterThread* GetStaticInstance<WriterThread>(
+      CountOperation count_operation);
+
+  static WriterThread* CreateInstance() { return new WriterThread(); }
+
+  WriterThread() : pool_(ThreadPool::Create("FileWriter", 1)) {}
+  ~WriterThread() {}
+
+  const scoped_ptr<ThreadPool> pool_;
+};
+
+}  // namespace
+
+FileWrapper* FileWrapper::CreateAsync() {
+  return new FileAsyncImpl();
+}
+
+class FileAsyncImpl::WriteTask : public QueuedTask {
+ public:
+  WriteTask(FileAsyncImpl* file, char* buffer, int length)
+      : file_(file), buffer_(buffer), length_(length) {}
+  // Dropped tasks still own their buffer.
+  virtual ~WriteTask() { AlignedFree(buffer_); }
+
+  virtual void Run() OVERRIDE {
+    file_->WriteBuffer(buffer_, length_);
+    buffer_ = NULL;
+  }
+
+ private:
+  FileAsyncImpl* const file_;
+  char* buffer_;
+  const int length_;
+};
+
+class FileAsyncImpl::FlushTask : public QueuedTask {
+ public:
+  FlushTask(FileWrapper* file, EventWrapper* done, int* result)
+      : file_(file), done_(done), result_(result) {}
+
+  virtual void Run() OVERRIDE {
+    *result_ = file_->Flush();
+    done_->Set();
+  }
+
+ private:
+  FileWrapper* const file_;
+  EventWrapper* const done_;
+  int* const result_;
+};
+
+FileAsyncImpl::FileAsyncImpl()
+    : file_(new FileWrapperImpl()),
+      writer_thread_(WriterThread::AddRef()),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      buffer_written_(EventWrapper::Create()),
+      buffer_(NULL),
+      buffer_length_(0),
+      pending_bytes_(0),
+      num_stalls_(0),
+      read_only_(false),
+      max_size_in_bytes_(0),
+      size_in_bytes_(0) {
+  // Without the thread, the writes are done directly.
+  if (writer_thread_)
+    queue_.reset(new TaskQueue(writer_thread_));
+}
+
+FileAsyncImpl::~FileAsyncImpl() {
+  CloseFile();
+  queue_.reset();
+  WriterThread::Release();
+  for (size_t i = 0; i < free_buffers_.size(); ++i)
+    AlignedFree(free_buffers_[i]);
+}
+
+int FileAsyncImpl::FileName(char* file_name_utf8, size_t size) const {
+  return file_->FileName(file_name_utf8, size);
+}
+
+bool FileAsyncImpl::Open() const {
+  return file_->Open();
+}
+
+int FileAsyncImpl::OpenFile(const char* file_name_utf8, bool read_only,
+                            bool loop, bool text) {
+  WaitForWrites();
+  CriticalSectionScoped cs(crit_.get());
+  read_only_ = read_only;
+  size_in_bytes_ = 0;
+  return file_->OpenFile(file_name_utf8, read_only, loop, text);
+}
+
+int FileAsyncImpl::OpenFromFileHandle(FILE* handle, bool manage_file,
+                                      bool read_only, bool loop) {
+  WaitForWrites();
+  CriticalSectionScoped cs(crit_.get());
+  read_only_ = read_only;
+  size_in_bytes_ = 0;
+  return file_->OpenFromFileHandle(handle, manage_file, read_only, loop);
+}
+
+int FileAsyncImpl::CloseFile() {
+  WaitForWrites();
+  CriticalSectionScoped cs(crit_.get());
+  size_in_bytes_ = 0;
+  return file_->CloseFile();
+}
+
+int FileAsyncImpl::SetMaxFileSize(size_t bytes) {
+  CriticalSectionScoped cs(crit_.get());
+  max_size_in_bytes_ = bytes;
+  return 0;
+}
+
+int FileAsyncImpl::Flush() {
+  return WaitForWrites();
+}
+
+int FileAsyncImpl::Read(void* buf, int length) {
+  return file_->Read(buf, length);
+}
+
+bool FileAsyncImpl::Write(const void* buf, int length) {
+  if (!queue_)
+    return file_->Write(buf, length);
+  if (buf == NULL || length < 0)
+    return false;
+
+  {
+    CriticalSectionScoped cs(crit_.get());
+    if (read_only_ || !file_->Open())
+      return false;
+
+    // Check if it's time to stop writing.
+    if (max_size_in_bytes_ > 0 &&
+        (size_in_bytes_ + length) > max_size_in_bytes_) {
+      QueueBuffer();
+      return false;
+    }
+    size_in_bytes_ += length;
+
+    const char* data = static_cast<const char*>(buf);
+    while (length > 0) {
+      if (buffer_ == NULL) {
+        if (!free_buffers_.empty()) {
+          buffer_ = free_buffers_.back();
+          free_buffers_.pop_back();
+        } else {
+          buffer_ = AlignedMalloc<char>(kBufferSize, kBufferAlignment);
+        }
+        buffer_length_ = 0;
+      }
+      const int num_bytes = std::min(length, kBufferSize - buffer_length_);
+      memcpy(buffer_ + buffer_length_, data, num_bytes);
+      buffer_length_ += num_bytes;
+      data += num_bytes;
+      length -= num_bytes;
+      if (buffer_length_ == kBufferSize)
+        QueueBuffer();
+    }
+  }
+
+  // Don't let the buffers pile up if the disk can't keep up.
+  if (pending_bytes_.Value() > kMaxPendingBytes) {
+    ++num_stalls_;
+    while (pending_bytes_.Value() > kMaxPendingBytes)
+      buffer_written_->Wait(kStallWaitMs);
+  }
+  return true;
+}
+
+int FileAsyncImpl::WriteText(const char* format, ...) {
+  if (format == NULL)
+    return -1;
+
+  char text[kMaxTextLength];
+  va_list args;
+  va_start(args, format);
+#ifdef _WIN32
+  int num_chars = _vsnprintf(text, kMaxTextLength, format, args);
+#else
+  int num_chars = vsnprintf(text, kMaxTextLength, format, args);
+#endif
+  va_end(args);
+
+  // Longer texts are not written rather than cut.
+  if (num_chars < 0 || num_chars >= kMaxTextLength)
+    return -1;
+  return Write(text, num_chars) ? num_chars : -1;
+}
+
+int FileAsyncImpl::Rewind() {
+  WaitForWrites();
+  CriticalSectionScoped cs(crit_.get());
+  size_in_bytes_ = 0;
+  return file_->Rewind();
+}
+
+void FileAsyncImpl::QueueBuffer() {
+  if (buffer_ == NULL)
+    return;
+  pending_bytes_ += buffer_length_;
+  queue_->PostTask(new WriteTask(this, buffer_, buffer_length_));
+  buffer_ = NULL;
+  buffer_length_ = 0;
+}
+
+int FileAsyncImpl::WaitForWrites() {
+  if (!queue_)
+    return file_->Flush();
+
+  scoped_ptr<EventWrapper> done(EventWrapper::Create());
+  int result = -1;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    QueueBuffer();
+    queue_->PostTask(new FlushTask(file_.get(), done.get(), &result));
+  }
+  done->Wait(WEBRTC_EVENT_INFINITE);
+  return result;
+}
+
+void FileAsyncImpl::WriteBuffer(char* buffer, int length) {
+  // On failure the file is closed, and later writes fail.
+  file_->Write(buffer, length);
+  {
+    CriticalSectionScoped cs(crit_.get());
+    if (free_buffers_.size() < kMaxFreeBuffers)
+      free_buffers_.push_back(buffer);
+    else
+      AlignedFree(buffer);
+  }
+  pending_bytes_ -= length;
+  buffer_written_->Set();
+}
+
+}  // namespace webrtc
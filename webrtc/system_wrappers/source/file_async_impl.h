@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_FILE_ASYNC_IMPL_H_
+#define WEBRTC_SYSTEM_WRAPPERS_SOURCE_FILE_ASYNC_IMPL_H_
+
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/atomic32.h"
+#include "webrtc/system_wrappers/interface/file_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+
+namespace webrtc {
+
+class CriticalSectionWrapper;
+class EventWrapper;
+class TaskQueue;
+class ThreadPool;
+
+// Collects the writes in large buffers that are written to the file by a
+// thread shared by all the async files, so that the threads recording media
+// don't wait for the disk. Reading is done directly.
+class FileAsyncImpl : public FileWrapper {
+ public:
+  // The size of the buffers handed to the writer thread.
+  static const int kBufferSize = 256 * 1024;
+  // When this many bytes are waiting to be written, Write() waits for the
+  // writer thread to catch up.
+  static const int kMaxPendingBytes = 16 * 1024 * 1024;
+
+  FileAsyncImpl();
+  virtual ~FileAsyncImpl();
+
+  virtual int FileName(char* file_name_utf8,
+                       size_t size) const OVERRIDE;
+
+  virtual bool Open() const OVERRIDE;
+
+  virtual int OpenFile(const char* file_name_utf8,
+                       bool read_only,
+                       bool loop = false,
+                       bool text = false) OVERRIDE;
+
+  virtual int OpenFromFileHandle(FILE* handle,
+                                 bool manage_file,
+                                 bool read_only,
+                                 bool loop = false) OVERRIDE;
+
+  virtual int CloseFile() OVERRIDE;
+  virtual int SetMaxFileSize(size_t bytes) OVERRIDE;
+  virtual int Flush() OVERRIDE;
+
+  virtual int Read(void* buf, int length) OVERRIDE;
+  virtual bool Write(const void* buf, int length) OVERRIDE;
+  virtual int WriteText(const char* format, ...) OVERRIDE;
+  virtual int Rewind() OVERRIDE;
+
+  // The number of times Write() has waited for the writer thread.
+  int num_stalls() const { return num_stalls_.Value(); }
+
+ private:
+  class WriteTask;
+  class FlushTask;
+
+  // Hands the current buffer, if any, to the writer thread. Must be called
+  // with |crit_| held.
+  void QueueBuffer();
+  // Waits until everything written so far is in the file, and returns the
+  // result of flushing the file.
+  int WaitForWrites();
+  // Called on the writer thread.
+  void WriteBuffer(char* buffer, int length);
+
+  const scoped_ptr<FileWrapper> file_;
+  ThreadPool* const writer_thread_;
+  scoped_ptr<TaskQueue> queue_;
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  const scoped_ptr<EventWrapper> buffer_written_;
+
+  char* buffer_;
+  int buffer_length_;
+  // Buffers the writer thread is done with, to be reused.
+  std::vector<char*> free_buffers_;
+  Atomic32 pending_bytes_;
+  mutable Atomic32 num_stalls_;
+
+  bool read_only_;
+  size_t max_size_in_bytes_;
+  size_t size_in_bytes_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_SOURCE_FILE_ASYNC_IMPL_H_
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/source/file_async_impl.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+class FileAsyncImplTest : public ::testing::Test {
+ protected:
+  FileAsyncImplTest()
+      : file_name_(test::OutputPath() + "file_async_impl_unittest.dat") {}
+  virtual ~FileAsyncImplTest() { remove(file_name_.c_str()); }
+
+  std::vector<char> ReadBack() {
+    std::vector<char> data;
+    scoped_ptr<FileWrapper> file(FileWrapper::Create());
+    EXPECT_EQ(0, file->OpenFile(file_name_.c_str(), true));
+    char buffer[4096];
+    int num_bytes;
+    while ((num_bytes = file->Read(buffer, sizeof(buffer))) > 0)
+      data.insert(data.end(), buffer, buffer + num_bytes);
+    return data;
+  }
+
+  const std::string file_name_;
+};
+
+TEST_F(FileAsyncImplTest, WritesAllBytesInOrder) {
+  // Several buffers' worth, in writes that don't line up with the buffers.
+  std::vector<char> expected;
+  {
+    FileAsyncImpl file;
+    ASSERT_EQ(0, file.OpenFile(file_name_.c_str(), false));
+    char packet[1000];
+    for (int i = 0; i < 1000; ++i) {
+      for (size_t j = 0; j < sizeof(packet); ++j)
+        packet[j] = static_cast<char>(i + j);
+      ASSERT_TRUE(file.Write(packet, sizeof(packet)));
+      expected.insert(expected.end(), packet, packet + sizeof(packet));
+    }
+    EXPECT_EQ(0, file.CloseFile());
+    EXPECT_FALSE(file.Open());
+  }
+  EXPECT_TRUE(expected == ReadBack());
+}
+
+TEST_F(FileAsyncImplTest, FlushWritesPendingBytes) {
+  FileAsyncImpl file;
+  ASSERT_EQ(0, file.OpenFile(file_name_.c_str(), false));
+  EXPECT_EQ(5, file.WriteText("%d%s", 123, "ab"));
+  EXPECT_EQ(0, file.Flush());
+  std::vector<char> data = ReadBack();
+  EXPECT_EQ("123ab", std::string(data.begin(), data.end()));
+}
+
+TEST_F(FileAsyncImplTest, RewindOverwritesStart) {
+  {
+    FileAsyncImpl file;
+    ASSERT_EQ(0, file.OpenFile(file_name_.c_str(), false));
+    EXPECT_TRUE(file.Write("header body", 11));
+    EXPECT_EQ(0, file.Rewind());
+    EXPECT_TRUE(file.Write("HEADER", 6));
+  }
+  std::vector<char> data = ReadBack();
+  EXPECT_EQ("HEADER body", std::string(data.begin(), data.end()));
+}
+
+TEST_F(FileAsyncImplTest, StopsWritingAtMaxFileSize) {
+  {
+    FileAsyncImpl file;
+    ASSERT_EQ(0, file.OpenFile(file_name_.c_str(), false));
+    EXPECT_EQ(0, file.SetMaxFileSize(10));
+    EXPECT_TRUE(file.Write("12345", 5));
+    EXPECT_TRUE(file.Write("67890", 5));
+    EXPECT_FALSE(file.Write("x", 1));
+  }
+  EXPECT_EQ(10u, ReadBack().size());
+}
+
+TEST_F(FileAsyncImplTest, FailsWhenNotOpenForWriting) {
+  FileAsyncImpl file;
+  EXPECT_FALSE(file.Write("x", 1));
+  {
+    FileAsyncImpl writer;
+    ASSERT_EQ(0, writer.OpenFile(file_name_.c_str(), false));
+  }
+  ASSERT_EQ(0, file.OpenFile(file_name_.c_str(), true));
+  EXPECT_FALSE(file.Write("x", 1));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/metrics.h"
+
+#include <assert.h>
+
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/static_instance.h"
+
+namespace webrtc {
+namespace metrics {
+
+namespace {
+
+// Samples below this are counted exactly. Above it, each power of two is
+// split into this many buckets.
+const int kLinearBuckets = 8;
+const int kLinearBits = 3;
+
+// Picks the shard for the calling thread. Threads run on different stacks,
+// so a hash of the address of a local tells them apart without a system
+// call. The stacks are usually aligned far apart, hence the hash.
+int CurrentShard() {
+  int local;
+  const uint32_t page =
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&local) >> 12);
+  return static_cast<int>(((page * 2654435761u) >> 24) % kNumShards);
+}
+
+}  // namespace
+
+Histogram::Histogram() {}
+
+Histogram::~Histogram() {}
+
+void Histogram::Add(int sample) {
+  ++counts_[CurrentShard()][BucketIndex(sample)];
+}
+
+int64_t Histogram::BucketCount(int bucket) {
+  assert(bucket >= 0 && bucket < kNumBuckets);
+  int64_t count = 0;
+  for (int i = 0; i < kNumShards; ++i)
+    count += static_cast<uint32_t>(counts_[i][bucket].Value());
+  return count;
+}
+
+// static
+int Histogram::BucketIndex(int sample) {
+  if (sample < kLinearBuckets)
+    return sample < 0 ? 0 : sample;
+  int exponent = kLinearBits;
+  while ((sample >> (exponent + 1)) != 0)
+    ++exponent;
+  const int sub_bucket = (sample >> (exponent - kLinearBits)) &
+      (kLinearBuckets - 1);
+  return kLinearBuckets + (exponent - kLinearBits) * kLinearBuckets +
+      sub_bucket;
+}
+
+// static
+int Histogram::BucketMin(int bucket) {
+  if (bucket < kLinearBuckets)
+    return bucket;
+  const int shift = (bucket - kLinearBuckets) / kLinearBuckets;
+  const int sub_bucket = (bucket - kLinearBuckets) % kLinearBuckets;
+  return (kLinearBuckets + sub_bucket) << shift;
+}
+
+Counter::Counter() {}
+
+Counter::~Counter() {}
+
+void Counter::Add(int value) {
+  shards_[CurrentShard()].value += value;
+}
+
+int64_t Counter::Value() {
+  int64_t value = 0;
+  for (int i = 0; i < kNumShards; ++i)
+    value += shards_[i].value.Value();
+  return value;
+}
+
+int HistogramSnapshot::Percentile(int percent) const {
+  if (count == 0)
+    return -1;
+  // The number of samples at or below the percentile, rounded up.
+  const int64_t target = (count * percent + 99) / 100;
+  int64_t seen = 0;
+  for (int i = 0; i < Histogram::kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= target && seen > 0) {
+      return i + 1 < Histogram::kNumBuckets ?
+          Histogram::BucketMin(i + 1) - 1 : 0x7fffffff;
+    }
+  }
+  return 0x7fffffff;
+}
+
+// Owns the metrics, which are created on first use and then kept for the
+// life of the process. The lock is only taken to look up and read back the
+// metrics, never to update them.
+class Registry {
+ public:
+  // The references are never released, so the registry is kept for the life
+  // of the process. The macros only get here once per call site.
+  static Registry* Get() { return GetStaticInstance<Registry>(kAddRef); }
+
+  Histogram* GetHistogram(const char* name) {
+    CriticalSectionScoped cs(crit_.get());
+    Histogram*& histogram = histograms_[name];
+    if (!histogram)
+      histogram = new Histogram();
+    return histogram;
+  }
+
+  Counter* GetCounter(const char* name) {
+    CriticalSectionScoped cs(crit_.get());
+    Counter*& counter = counters_[name];
+    if (!counter)
+      counter = new Counter();
+    return counter;
+  }
+
+  void GetHistograms(std::vector<HistogramSnapshot>* snapshots) {
+    CriticalSectionScoped cs(crit_.get());
+    snapshots->clear();
+    snapshots->reserve(histograms_.size());
+    for (std::map<std::string, Histogram*>::const_iterator it =
+             histograms_.begin();
+         it != histograms_.end(); ++it) {
+      snapshots->push_back(HistogramSnapshot());
+      HistogramSnapshot& snapshot = snapshots->back();
+      snapshot.name = it->first;
+      for (int i = 0; i < Histogram::kNumBuckets; ++i) {
+        snapshot.counts[i] = it->second->BucketCount(i);
+        snapshot.count += snapshot.counts[i];
+      }
+    }
+  }
+
+  void GetCounters(std::map<std::string, int64_t>* values) {
+    CriticalSectionScoped cs(crit_.get());
+    values->clear();
+    for (std::map<std::string, Counter*>::const_iterator it =
+             counters_.begin();
+         it != counters_.end(); ++it) {
+      (*values)[it->first] = it->second->Value();
+    }
+  }
+
+ private:
+  friend Registry* GetStaticInstance<Registry>(CountOperation count_operation);
+
+  static Registry* CreateInstance() { return new Registry(); }
+
+  Registry() : crit_(CriticalSectionWrapper::CreateCriticalSection()) {}
+  ~Registry() {}
+
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  std::map<std::string, Histogram*> histograms_;
+  std::map<std::string, Counter*> counters_;
+};
+
+Histogram* GetHistogram(const char* name) {
+  return Registry::Get()->GetHistogram(name);
+}
+
+Counter* GetCounter(const char* name) {
+  return Registry::Get()->GetCounter(name);
+}
+
+void GetHistograms(std::vector<HistogramSnapshot>* histograms) {
+  Registry::Get()->GetHistograms(histograms);
+}
+
+void GetCounters(std::map<std::string, int64_t>* counters) {
+  Registry::Get()->GetCounters(counters);
+}
+
+}  // namespace metrics
+}  // namespace webrtc
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/metrics.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+namespace metrics {
+namespace {
+
+const HistogramSnapshot* FindHistogram(
+    const std::vector<HistogramSnapshot>& histograms,
+    const std::string& name) {
+  for (size_t i = 0; i < histograms.size(); ++i) {
+    if (histograms[i].name == name)
+      return &histograms[i];
+  }
+  return NULL;
+}
+
+bool AddSamples(void* obj) {
+  for (int i = 0; i < 1000; ++i) {
+    WEBRTC_HISTOGRAM_ADD("Test.Threads", i);
+    WEBRTC_COUNTER_ADD("Test.ThreadsCounter", 1);
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(MetricsTest, BucketsAreLogLinear) {
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(i, Histogram::BucketIndex(i));
+    EXPECT_EQ(i, Histogram::BucketMin(i));
+  }
+  EXPECT_EQ(0, Histogram::BucketIndex(-5));
+  EXPECT_EQ(8, Histogram::BucketIndex(8));
+  EXPECT_EQ(15, Histogram::BucketIndex(15));
+  EXPECT_EQ(16, Histogram::BucketIndex(16));
+  EXPECT_EQ(16, Histogram::BucketIndex(17));
+  EXPECT_EQ(Histogram::kNumBuckets - 1,
+            Histogram::BucketIndex(0x7fffffff));
+  for (int bucket = 1; bucket < Histogram::kNumBuckets; ++bucket) {
+    const int min = Histogram::BucketMin(bucket);
+    EXPECT_EQ(bucket, Histogram::BucketIndex(min));
+    EXPECT_EQ(bucket - 1, Histogram::BucketIndex(min - 1));
+  }
+}
+
+TEST(MetricsTest, ReadsBackPercentiles) {
+  std::vector<HistogramSnapshot> histograms;
+  GetHistograms(&histograms);
+  EXPECT_TRUE(FindHistogram(histograms, "Test.Percentiles") == NULL);
+
+  for (int i = 1; i <= 1000; ++i)
+    WEBRTC_HISTOGRAM_ADD("Test.Percentiles", i);
+
+  GetHistograms(&histograms);
+  const HistogramSnapshot* histogram =
+      FindHistogram(histograms, "Test.Percentiles");
+  ASSERT_TRUE(histogram != NULL);
+  EXPECT_EQ(1000, histogram->count);
+  EXPECT_EQ(1, histogram->Percentile(0));
+  // Within the 12.5% bucket resolution.
+  EXPECT_GE(histogram->Percentile(50), 500);
+  EXPECT_LE(histogram->Percentile(50), 500 * 9 / 8);
+  EXPECT_GE(histogram->Percentile(99), 990);
+  EXPECT_LE(histogram->Percentile(99), 990 * 9 / 8);
+}
+
+TEST(MetricsTest, MergesUpdatesFromAllThreads) {
+  const int kNumThreads = 4;
+  scoped_ptr<ThreadWrapper> threads[kNumThreads];
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i].reset(ThreadWrapper::CreateThread(&AddSamples, NULL));
+    unsigned int id = 0;
+    ASSERT_TRUE(threads[i]->Start(id));
+  }
+  for (int i = 0; i < kNumThreads; ++i)
+    EXPECT_TRUE(threads[i]->Stop());
+
+  std::vector<HistogramSnapshot> histograms;
+  GetHistograms(&histograms);
+  const HistogramSnapshot* histogram =
+      FindHistogram(histograms, "Test.Threads");
+  ASSERT_TRUE(histogram != NULL);
+  EXPECT_EQ(kNumThreads * 1000, histogram->count);
+
+  std::map<std::string, int64_t> counters;
+  GetCounters(&counters);
+  EXPECT_EQ(kNumThreads * 1000, counters["Test.ThreadsCounter"]);
+}
+
+}  // namespace metrics
+}  // namespace webrtc
@@ -19,16 +19,20 @@
 #include <time.h>
 #endif
 
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
 namespace webrtc {
 
 void SleepMs(int msecs) {
+  // |msecs| is in scaled time.
+  const int64_t usecs = TickTime::ScaledWaitMicroseconds(msecs);
 #ifdef _WIN32
-  Sleep(msecs);
+  Sleep(static_cast<DWORD>((usecs + 999) / 1000));
 #else
   struct timespec short_wait;
   struct timespec remainder;
-  short_wait.tv_sec = msecs / 1000;
-  short_wait.tv_nsec = (msecs % 1000) * 1000 * 1000;
+  short_wait.tv_sec = static_cast<time_t>(usecs / 1000000);
+  short_wait.tv_nsec = static_cast<long>(usecs % 1000000) * 1000;
   nanosleep(&short_wait, &remainder);
 #endif
 }
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/snapshot_publisher.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumReaders = 3;
+const int kNumPublishes = 1000;
+
+// Consistent as long as |negated| is -|value|.
+struct Snapshot {
+  explicit Snapshot(int value) : value(value), negated(-value) {}
+  int value;
+  int negated;
+};
+
+typedef SnapshotPublisher<Snapshot> Publisher;
+
+struct PublishState {
+  explicit PublishState(Publisher* publisher)
+      : publisher(publisher), previous(NULL) {}
+  Publisher* publisher;
+  Snapshot* previous;
+  Atomic32 done;
+};
+
+bool PublishOnce(void* obj) {
+  PublishState* state = static_cast<PublishState*>(obj);
+  state->previous = state->publisher->Publish(new Snapshot(2));
+  ++state->done;
+  return false;
+}
+
+struct ReadState {
+  explicit ReadState(const Publisher* publisher) : publisher(publisher) {}
+  const Publisher* publisher;
+  Atomic32 num_reads;
+  Atomic32 num_inconsistent;
+};
+
+bool ReadSnapshot(void* obj) {
+  ReadState* state = static_cast<ReadState*>(obj);
+  {
+    Publisher::ScopedReader snapshot(state->publisher);
+    const int value = snapshot->value;
+    SleepMs(0);
+    if (snapshot->value != value || snapshot->negated != -value)
+      ++state->num_inconsistent;
+  }
+  ++state->num_reads;
+  return true;
+}
+
+}  // namespace
+
+TEST(SnapshotPublisherTest, ReadersGetCurrentSnapshot) {
+  Snapshot first(1);
+  Snapshot second(2);
+  Publisher publisher(&first);
+  EXPECT_EQ(&first, publisher.current());
+  {
+    Publisher::ScopedReader snapshot(&publisher);
+    EXPECT_EQ(&first, snapshot.get());
+  }
+  EXPECT_EQ(&first, publisher.Publish(&second));
+  EXPECT_EQ(&second, publisher.current());
+  Publisher::ScopedReader snapshot(&publisher);
+  EXPECT_EQ(2, snapshot->value);
+}
+
+TEST(SnapshotPublisherTest, PublishWaitsForReadersOfPreviousSnapshot) {
+  Snapshot first(1);
+  Publisher publisher(&first);
+  PublishState state(&publisher);
+  scoped_ptr<ThreadWrapper> thread(
+      ThreadWrapper::CreateThread(&PublishOnce, &state));
+  {
+    Publisher::ScopedReader snapshot(&publisher);
+    unsigned int id = 0;
+    ASSERT_TRUE(thread->Start(id));
+    while (publisher.current() == &first)
+      SleepMs(1);
+    // Readers that start now get the new snapshot, but the writer still
+    // waits for this one.
+    Publisher::ScopedReader next(&publisher);
+    EXPECT_EQ(2, next->value);
+    SleepMs(50);
+    EXPECT_EQ(0, state.done.Value());
+    EXPECT_EQ(1, snapshot->value);
+  }
+  EXPECT_TRUE(thread->Stop());
+  EXPECT_EQ(1, state.done.Value());
+  EXPECT_EQ(&first, state.previous);
+  delete publisher.current();
+}
+
+TEST(SnapshotPublisherTest, ReadersNeverSeeReturnedSnapshots) {
+  Publisher publisher(new Snapshot(0));
+  ReadState state(&publisher);
+  scoped_ptr<ThreadWrapper> threads[kNumReaders];
+  for (int i = 0; i < kNumReaders; ++i) {
+    threads[i].reset(ThreadWrapper::CreateThread(&ReadSnapshot, &state));
+    unsigned int id = 0;
+    ASSERT_TRUE(threads[i]->Start(id));
+  }
+  for (int i = 1; i <= kNumPublishes; ++i) {
+    Snapshot* previous = publisher.Publish(new Snapshot(i));
+    // Make a reader that still used it inconsistent.
+    previous->negated = previous->value;
+    delete previous;
+    if (i % 100 == 0)
+      SleepMs(1);
+  }
+  for (int i = 0; i < kNumReaders; ++i)
+    EXPECT_TRUE(threads[i]->Stop());
+  EXPECT_GT(state.num_reads.Value(), 0);
+  EXPECT_EQ(0, state.num_inconsistent.Value());
+  EXPECT_EQ(kNumPublishes, publisher.current()->value);
+  delete publisher.current();
+}
+
+}  // namespace webrtc
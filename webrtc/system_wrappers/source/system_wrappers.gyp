@@ -28,6 +28,7 @@
         '../interface/aligned_malloc.h',
         '../interface/atomic32.h',
         '../interface/clock.h',
+        '../interface/binary_data_log.h',
         '../interface/compile_assert.h',
         '../interface/condition_variable_wrapper.h',
         '../interface/cpu_info.h',
@@ -43,6 +44,7 @@
         '../interface/fix_interlocked_exchange_pointer_win.h',
         '../interface/logcat_trace_context.h',
         '../interface/logging.h',
+        '../interface/metrics.h',
         '../interface/ref_count.h',
         '../interface/rtp_to_ntp.h',
         '../interface/rw_lock_wrapper.h',
@@ -50,11 +52,13 @@
         '../interface/scoped_refptr.h',
         '../interface/scoped_vector.h',
         '../interface/sleep.h',
+        '../interface/snapshot_publisher.h',
         '../interface/sort.h',
         '../interface/static_instance.h',
         '../interface/stl_util.h',
         '../interface/stringize_macros.h',
         '../interface/thread_annotations.h',
+        '../interface/thread_pool.h',
         '../interface/thread_wrapper.h',
         '../interface/tick_util.h',
         '../interface/timestamp_extrapolator.h',
@@ -65,6 +69,7 @@
         'atomic32_mac.cc',
         'atomic32_posix.cc',
         'atomic32_win.cc',
+        'binary_data_log.cc',
         'clock.cc',
         'condition_variable.cc',
         'condition_variable_posix.cc',
@@ -89,10 +94,13 @@
         'event_tracer.cc',
         'event_win.cc',
         'event_win.h',
+        'file_async_impl.cc',
+        'file_async_impl.h',
         'file_impl.cc',
         'file_impl.h',
         'logcat_trace_context.cc',
         'logging.cc',
+        'metrics.cc',
         'rtp_to_ntp.cc',
         'rw_lock.cc',
         'rw_lock_generic.cc',
@@ -106,6 +114,7 @@
         'sort.cc',
         'tick_util.cc',
         'thread.cc',
+        'thread_pool.cc',
         'thread_posix.cc',
         'thread_posix.h',
         'thread_win.cc',
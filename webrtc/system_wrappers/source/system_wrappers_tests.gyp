@@ -19,11 +19,15 @@
       ],
       'sources': [
         'aligned_malloc_unittest.cc',
+        'binary_data_log_unittest.cc',
         'clock_unittest.cc',
         'condition_variable_unittest.cc',
+        'cpu_info_unittest.cc',
         'critical_section_unittest.cc',
         'event_tracer_unittest.cc',
+        'file_async_impl_unittest.cc',
         'logging_unittest.cc',
+        'metrics_unittest.cc',
         'data_log_unittest.cc',
         'data_log_unittest_disabled.cc',
         'data_log_helpers_unittest.cc',
@@ -31,8 +35,10 @@
         'data_log_c_helpers_unittest.h',
         'rtp_to_ntp_unittest.cc',
         'scoped_vector_unittest.cc',
+        'snapshot_publisher_unittest.cc',
         'stringize_macros_unittest.cc',
         'stl_util_unittest.cc',
+        'thread_pool_unittest.cc',
         'thread_unittest.cc',
         'thread_posix_unittest.cc',
       ],
@@ -10,6 +10,8 @@
 
 #include "webrtc/system_wrappers/interface/thread_wrapper.h"
 
+#include <assert.h>
+
 #if defined(_WIN32)
 #include "webrtc/system_wrappers/source/thread_win.h"
 #else
@@ -17,17 +19,32 @@
 #endif
 
 namespace webrtc {
+namespace {
+ThreadRoleConfig g_role_configs[kNumThreadRoles];
+}  // namespace
 
 ThreadWrapper* ThreadWrapper::CreateThread(ThreadRunFunction func,
                                            ThreadObj obj, ThreadPriority prio,
-                                           const char* thread_name) {
+                                           const char* thread_name,
+                                           ThreadRole role) {
 #if defined(_WIN32)
   return new ThreadWindows(func, obj, prio, thread_name);
 #else
-  return ThreadPosix::Create(func, obj, prio, thread_name);
+  return ThreadPosix::Create(func, obj, prio, thread_name, role);
 #endif
 }
 
+void ThreadWrapper::SetRoleConfig(ThreadRole role,
+                                  const ThreadRoleConfig& config) {
+  assert(role >= 0 && role < kNumThreadRoles);
+  g_role_configs[role] = config;
+}
+
+ThreadRoleConfig ThreadWrapper::GetRoleConfig(ThreadRole role) {
+  assert(role >= 0 && role < kNumThreadRoles);
+  return g_role_configs[role];
+}
+
 bool ThreadWrapper::SetAffinity(const int* processor_numbers,
                                 const unsigned int amount_of_processors) {
   return false;
@@ -0,0 +1,551 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <deque>
+
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/ref_count.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+
+namespace {
+
+// The number of tasks a TaskQueue runs before it lets the tasks of other
+// queues run.
+const int kMaxTasksPerRun = 16;
+
+// Atomic32 has no store. The writers hold a lock, so the exchange succeeds
+// the first time.
+void StoreAtomic(Atomic32* atomic, int32_t value) {
+  int32_t old_value;
+  do {
+    old_value = atomic->Value();
+  } while (!atomic->CompareExchange(value, old_value));
+}
+
+// The state of a RunInParallel() call. It is shared with the tasks posted to
+// the pool, which may only run after the call has returned.
+class ParallelRun {
+ public:
+  virtual int32_t AddRef() = 0;
+  virtual int32_t Release() = 0;
+
+  ParallelRun(ParallelTask* task, int count)
+      : task_(task), count_(count), done_(EventWrapper::Create()) {}
+
+  // Runs the indices that are left, if any. |task_| is only used for an
+  // index taken before all have been run, while the call is still waiting.
+  void RunIndices() {
+    for (int index = ++next_index_ - 1; index < count_;
+         index = ++next_index_ - 1) {
+      task_->Run(index);
+      if (++num_done_ == count_)
+        done_->Set();
+    }
+  }
+
+  void WaitUntilDone() {
+    if (num_done_.Value() < count_)
+      done_->Wait(WEBRTC_EVENT_INFINITE);
+  }
+
+ protected:
+  virtual ~ParallelRun() {}
+
+ private:
+  ParallelTask* const task_;
+  const int count_;
+  Atomic32 next_index_;
+  Atomic32 num_done_;
+  const scoped_ptr<EventWrapper> done_;
+};
+
+class RunIndicesTask : public QueuedTask {
+ public:
+  explicit RunIndicesTask(ParallelRun* run) : run_(run) { run_->AddRef(); }
+  virtual ~RunIndicesTask() { run_->Release(); }
+
+  virtual void Run() OVERRIDE { run_->RunIndices(); }
+
+ private:
+  ParallelRun* const run_;
+};
+
+}  // namespace
+
+class ThreadPool::Worker {
+ public:
+  explicit Worker(ThreadPool* pool)
+      : pool_(pool),
+        crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        thread_id_(0) {}
+
+  ~Worker() {
+    while (!tasks_.empty()) {
+      delete tasks_.front();
+      tasks_.pop_front();
+    }
+  }
+
+  bool Start(const char* name, ThreadPriority priority, ThreadRole role) {
+    thread_.reset(ThreadWrapper::CreateThread(&Worker::ThreadFunc, this,
+                                              priority, name, role));
+    unsigned int id = 0;
+    return thread_.get() && thread_->Start(id);
+  }
+
+  void SetNotAlive() {
+    if (thread_.get())
+      thread_->SetNotAlive();
+  }
+
+  void Stop() {
+    if (thread_.get())
+      thread_->Stop();
+  }
+
+  bool IsCurrent() {
+    return static_cast<uint32_t>(thread_id_.Value()) ==
+        ThreadWrapper::GetThreadId();
+  }
+
+  void PushTask(QueuedTask* task) {
+    CriticalSectionScoped cs(crit_.get());
+    tasks_.push_back(task);
+  }
+
+  // Tasks are taken oldest first, also by their own thread, so that a task
+  // queue posting its continuation goes back behind the tasks of the others.
+  QueuedTask* PopOldestTask() {
+    CriticalSectionScoped cs(crit_.get());
+    if (tasks_.empty())
+      return NULL;
+    QueuedTask* task = tasks_.front();
+    tasks_.pop_front();
+    return task;
+  }
+
+ private:
+  static bool ThreadFunc(void* obj) {
+    Worker* worker = static_cast<Worker*>(obj);
+    if (worker->thread_id_.Value() == 0) {
+      worker->thread_id_.CompareExchange(
+          static_cast<int32_t>(ThreadWrapper::GetThreadId()), 0);
+    }
+    return worker->pool_->Process(worker);
+  }
+
+  ThreadPool* const pool_;
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<ThreadWrapper> thread_;
+  std::deque<QueuedTask*> tasks_;
+  // Set by the thread when it starts.
+  Atomic32 thread_id_;
+};
+
+ThreadPool* ThreadPool::Create(const char* name,
+                               int num_threads,
+                               ThreadPriority priority,
+                               ThreadRole role) {
+  ThreadPool* pool = new ThreadPool();
+  if (!pool->Start(name, num_threads, priority, role)) {
+    delete pool;
+    return NULL;
+  }
+  return pool;
+}
+
+ThreadPool::ThreadPool()
+    : next_worker_(0),
+      generation_(0),
+      num_idle_threads_(0),
+      num_delayed_tasks_(0),
+      next_delayed_task_ms_(0),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      wake_up_(ConditionVariableWrapper::CreateConditionVariable()),
+      next_delayed_sequence_(0),
+      stopping_(false) {}
+
+ThreadPool::~ThreadPool() {
+  for (size_t i = 0; i < workers_.size(); ++i)
+    workers_[i]->SetNotAlive();
+  {
+    CriticalSectionScoped cs(crit_.get());
+    stopping_ = true;
+    wake_up_->WakeAll();
+  }
+  for (size_t i = 0; i < workers_.size(); ++i)
+    workers_[i]->Stop();
+  for (size_t i = 0; i < workers_.size(); ++i)
+    delete workers_[i];
+  while (!delayed_tasks_.empty()) {
+    delete delayed_tasks_.top().task;
+    delayed_tasks_.pop();
+  }
+}
+
+bool ThreadPool::Start(const char* name,
+                       int num_threads,
+                       ThreadPriority priority,
+                       ThreadRole role) {
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(CpuInfo::DetectNumberOfCores());
+  if (num_threads <= 0)
+    num_threads = 1;
+  // All the workers are created before any thread starts, since they look at
+  // each other's queues.
+  for (int i = 0; i < num_threads; ++i)
+    workers_.push_back(new Worker(this));
+  for (int i = 0; i < num_threads; ++i) {
+    if (!workers_[i]->Start(name, priority, role))
+      return false;
+  }
+  return true;
+}
+
+void ThreadPool::PostTask(QueuedTask* task) {
+  Worker* worker = NULL;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->IsCurrent()) {
+      worker = workers_[i];
+      break;
+    }
+  }
+  if (!worker) {
+    const uint32_t index = static_cast<uint32_t>(++next_worker_);
+    worker = workers_[index % workers_.size()];
+  }
+  worker->PushTask(task);
+  ++generation_;
+  WakeUpIdleThread();
+}
+
+void ThreadPool::PostDelayedTask(QueuedTask* task, uint32_t delay_ms) {
+  CriticalSectionScoped cs(crit_.get());
+  DelayedTask delayed_task;
+  delayed_task.run_at_ms = TickTime::MillisecondTimestamp() + delay_ms;
+  delayed_task.sequence = next_delayed_sequence_++;
+  delayed_task.task = task;
+  delayed_tasks_.push(delayed_task);
+  StoreAtomic(&next_delayed_task_ms_,
+              static_cast<int32_t>(delayed_tasks_.top().run_at_ms));
+  ++num_delayed_tasks_;
+  // A waiting thread may need to wake up sooner than it planned to.
+  ++generation_;
+  wake_up_->Wake();
+}
+
+void ThreadPool::RunInParallel(ParallelTask* task, int count) {
+  if (count <= 0)
+    return;
+  ParallelRun* run = new RefCountImpl<ParallelRun>(task, count);
+  run->AddRef();
+  const int num_helpers = std::min(count - 1, num_threads());
+  for (int i = 0; i < num_helpers; ++i)
+    PostTask(new RunIndicesTask(run));
+  run->RunIndices();
+  run->WaitUntilDone();
+  run->Release();
+}
+
+bool ThreadPool::Process(Worker* worker) {
+  if (num_delayed_tasks_.Value() > 0) {
+    const int32_t now_ms =
+        static_cast<int32_t>(TickTime::MillisecondTimestamp());
+    if (now_ms - next_delayed_task_ms_.Value() >= 0) {
+      CriticalSectionScoped cs(crit_.get());
+      TakeDueDelayedTasks(worker);
+    }
+  }
+
+  const int32_t generation = generation_.Value();
+  QueuedTask* task = worker->PopOldestTask();
+  if (!task)
+    task = StealTask(worker);
+  if (task) {
+    task->Run();
+    delete task;
+    return true;
+  }
+
+  CriticalSectionScoped cs(crit_.get());
+  if (stopping_)
+    return false;
+  // Counted as idle before checking for missed tasks, so that a task posted
+  // from now on wakes this thread up.
+  ++num_idle_threads_;
+  if (generation_.Value() == generation) {
+    if (delayed_tasks_.empty()) {
+      wake_up_->SleepCS(*crit_);
+    } else {
+      const int64_t wait_ms =
+          delayed_tasks_.top().run_at_ms - TickTime::MillisecondTimestamp();
+      if (wait_ms > 0)
+        wake_up_->SleepCS(*crit_, static_cast<unsigned long>(wait_ms));
+    }
+  }
+  --num_idle_threads_;
+  return !stopping_;
+}
+
+QueuedTask* ThreadPool::StealTask(Worker* thief) {
+  size_t index = 0;
+  while (workers_[index] != thief)
+    ++index;
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    QueuedTask* task =
+        workers_[(index + i) % workers_.size()]->PopOldestTask();
+    if (task)
+      return task;
+  }
+  return NULL;
+}
+
+void ThreadPool::TakeDueDelayedTasks(Worker* worker) {
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  bool took_task = false;
+  while (!delayed_tasks_.empty() && delayed_tasks_.top().run_at_ms <= now_ms) {
+    worker->PushTask(delayed_tasks_.top().task);
+    delayed_tasks_.pop();
+    --num_delayed_tasks_;
+    took_task = true;
+  }
+  if (!delayed_tasks_.empty()) {
+    StoreAtomic(&next_delayed_task_ms_,
+                static_cast<int32_t>(delayed_tasks_.top().run_at_ms));
+  }
+  if (took_task) {
+    // Let the other threads share the tasks.
+    ++generation_;
+    if (num_idle_threads_.Value() > 0)
+      wake_up_->Wake();
+  }
+}
+
+void ThreadPool::WakeUpIdleThread() {
+  if (num_idle_threads_.Value() == 0)
+    return;
+  CriticalSectionScoped cs(crit_.get());
+  wake_up_->Wake();
+}
+
+class TaskQueue::Impl {
+ public:
+  virtual int32_t AddRef() = 0;
+  virtual int32_t Release() = 0;
+
+  static Impl* Create(ThreadPool* pool) {
+    Impl* impl = new RefCountImpl<Impl>(pool);
+    impl->AddRef();
+    return impl;
+  }
+
+  void PostTask(QueuedTask* task) {
+    bool schedule = false;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      if (!stopped_) {
+        tasks_.push_back(task);
+        task = NULL;
+        schedule = !scheduled_;
+        scheduled_ = true;
+      }
+    }
+    delete task;
+    if (schedule)
+      pool_->PostTask(new RunTasksTask(this));
+  }
+
+  void PostDelayedTask(QueuedTask* task, uint32_t delay_ms) {
+    {
+      CriticalSectionScoped cs(crit_.get());
+      if (stopped_) {
+        delete task;
+        return;
+      }
+      DelayedTask delayed_task;
+      delayed_task.run_at_ms = TickTime::MillisecondTimestamp() + delay_ms;
+      delayed_task.sequence = next_delayed_sequence_++;
+      delayed_task.task = task;
+      delayed_tasks_.push(delayed_task);
+    }
+    // The pool computes its own due time after this one, so the task is due
+    // by the time the pool runs QueueDueTasksTask.
+    pool_->PostDelayedTask(new QueueDueTasksTask(this), delay_ms);
+  }
+
+  // Drops the tasks that have not run and waits for the one that is running.
+  void Stop() {
+    std::deque<QueuedTask*> tasks;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      assert(running_thread_id_ != ThreadWrapper::GetThreadId());
+      stopped_ = true;
+      tasks_.swap(tasks);
+      while (!delayed_tasks_.empty()) {
+        tasks.push_back(delayed_tasks_.top().task);
+        delayed_tasks_.pop();
+      }
+      while (running_thread_id_ != 0)
+        task_done_->SleepCS(*crit_);
+    }
+    // Deleted without the lock held, the destructors may post tasks.
+    while (!tasks.empty()) {
+      delete tasks.front();
+      tasks.pop_front();
+    }
+  }
+
+  bool IsCurrent() const {
+    CriticalSectionScoped cs(crit_.get());
+    return running_thread_id_ == ThreadWrapper::GetThreadId();
+  }
+
+ protected:
+  explicit Impl(ThreadPool* pool)
+      : pool_(pool),
+        crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        task_done_(ConditionVariableWrapper::CreateConditionVariable()),
+        next_delayed_sequence_(0),
+        scheduled_(false),
+        stopped_(false),
+        running_thread_id_(0) {}
+  virtual ~Impl() {}
+
+ private:
+  struct DelayedTask {
+    int64_t run_at_ms;
+    uint32_t sequence;
+    QueuedTask* task;
+
+    bool operator<(const DelayedTask& other) const {
+      if (run_at_ms != other.run_at_ms)
+        return run_at_ms > other.run_at_ms;
+      return static_cast<int32_t>(sequence - other.sequence) > 0;
+    }
+  };
+
+  // Posted to the pool to run the tasks of the queue.
+  class RunTasksTask : public QueuedTask {
+   public:
+    explicit RunTasksTask(Impl* impl) : impl_(impl) { impl_->AddRef(); }
+    virtual ~RunTasksTask() { impl_->Release(); }
+
+    virtual void Run() OVERRIDE { impl_->RunTasks(); }
+
+   private:
+    Impl* const impl_;
+  };
+
+  // Posted to the pool to queue the delayed tasks that are due.
+  class QueueDueTasksTask : public QueuedTask {
+   public:
+    explicit QueueDueTasksTask(Impl* impl) : impl_(impl) { impl_->AddRef(); }
+    virtual ~QueueDueTasksTask() { impl_->Release(); }
+
+    virtual void Run() OVERRIDE { impl_->QueueDueTasks(); }
+
+   private:
+    Impl* const impl_;
+  };
+
+  void RunTasks() {
+    for (int i = 0; i < kMaxTasksPerRun; ++i) {
+      QueuedTask* task = NULL;
+      {
+        CriticalSectionScoped cs(crit_.get());
+        if (stopped_ || tasks_.empty()) {
+          scheduled_ = false;
+          return;
+        }
+        task = tasks_.front();
+        tasks_.pop_front();
+        running_thread_id_ = ThreadWrapper::GetThreadId();
+      }
+      task->Run();
+      delete task;
+      {
+        CriticalSectionScoped cs(crit_.get());
+        running_thread_id_ = 0;
+        if (stopped_) {
+          task_done_->WakeAll();
+          return;
+        }
+      }
+    }
+    // Still scheduled; continue after the tasks that are waiting in the pool.
+    pool_->PostTask(new RunTasksTask(this));
+  }
+
+  void QueueDueTasks() {
+    const int64_t now_ms = TickTime::MillisecondTimestamp();
+    bool schedule = false;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      if (stopped_)
+        return;
+      while (!delayed_tasks_.empty() &&
+             delayed_tasks_.top().run_at_ms <= now_ms) {
+        tasks_.push_back(delayed_tasks_.top().task);
+        delayed_tasks_.pop();
+      }
+      if (!tasks_.empty() && !scheduled_) {
+        schedule = true;
+        scheduled_ = true;
+      }
+    }
+    if (schedule)
+      RunTasks();
+  }
+
+  ThreadPool* const pool_;
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  // Signaled when a task returns after the queue has been stopped.
+  const scoped_ptr<ConditionVariableWrapper> task_done_;
+  std::deque<QueuedTask*> tasks_;
+  std::priority_queue<DelayedTask> delayed_tasks_;
+  uint32_t next_delayed_sequence_;
+  // True while a RunTasksTask is posted or running.
+  bool scheduled_;
+  bool stopped_;
+  // The thread running a task of the queue, or 0.
+  uint32_t running_thread_id_;
+};
+
+TaskQueue::TaskQueue(ThreadPool* pool) : impl_(Impl::Create(pool)) {}
+
+TaskQueue::~TaskQueue() {
+  impl_->Stop();
+  impl_->Release();
+}
+
+void TaskQueue::PostTask(QueuedTask* task) {
+  impl_->PostTask(task);
+}
+
+void TaskQueue::PostDelayedTask(QueuedTask* task, uint32_t delay_ms) {
+  impl_->PostDelayedTask(task, delay_ms);
+}
+
+bool TaskQueue::IsCurrent() const {
+  return impl_->IsCurrent();
+}
+
+}  // namespace webrtc
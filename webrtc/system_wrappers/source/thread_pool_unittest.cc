@@ -0,0 +1,346 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumThreads = 4;
+const unsigned long kTimeoutMs = 10000;
+const int kNumIndices = 100;
+
+// Records the order the tasks run in, and signals |done| once |num_tasks|
+// have run.
+class TaskLog {
+ public:
+  explicit TaskLog(int num_tasks)
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        done_(EventWrapper::Create()),
+        num_tasks_(num_tasks) {}
+
+  void Add(int id) {
+    CriticalSectionScoped cs(crit_.get());
+    ids_.push_back(id);
+    if (static_cast<int>(ids_.size()) == num_tasks_)
+      done_->Set();
+  }
+
+  bool Wait() { return done_->Wait(kTimeoutMs) == kEventSignaled; }
+
+  std::vector<int> ids() {
+    CriticalSectionScoped cs(crit_.get());
+    return ids_;
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  scoped_ptr<EventWrapper> done_;
+  const int num_tasks_;
+  std::vector<int> ids_;
+};
+
+class LogTask : public QueuedTask {
+ public:
+  LogTask(TaskLog* log, int id) : log_(log), id_(id) {}
+
+  virtual void Run() OVERRIDE { log_->Add(id_); }
+
+ private:
+  TaskLog* const log_;
+  const int id_;
+};
+
+// Checks that no other task of the same queue runs at the same time.
+class SerialTask : public QueuedTask {
+ public:
+  SerialTask(TaskQueue* queue, Atomic32* running, TaskLog* log, int id)
+      : queue_(queue), running_(running), log_(log), id_(id) {}
+
+  virtual void Run() OVERRIDE {
+    EXPECT_TRUE(queue_->IsCurrent());
+    EXPECT_EQ(1, ++(*running_));
+    log_->Add(id_);
+    --(*running_);
+  }
+
+ private:
+  TaskQueue* const queue_;
+  Atomic32* const running_;
+  TaskLog* const log_;
+  const int id_;
+};
+
+class CountingTask : public QueuedTask {
+ public:
+  CountingTask(Atomic32* num_run, Atomic32* num_deleted)
+      : num_run_(num_run), num_deleted_(num_deleted) {}
+  virtual ~CountingTask() { ++(*num_deleted_); }
+
+  virtual void Run() OVERRIDE { ++(*num_run_); }
+
+ private:
+  Atomic32* const num_run_;
+  Atomic32* const num_deleted_;
+};
+
+// Keeps the queue busy for a while after it has started.
+class SlowTask : public QueuedTask {
+ public:
+  SlowTask(EventWrapper* started, Atomic32* num_run)
+      : started_(started), num_run_(num_run) {}
+
+  virtual void Run() OVERRIDE {
+    started_->Set();
+    scoped_ptr<EventWrapper> never_set(EventWrapper::Create());
+    never_set->Wait(100);
+    ++(*num_run_);
+  }
+
+ private:
+  EventWrapper* const started_;
+  Atomic32* const num_run_;
+};
+
+// Posts |task| to |queue| when it runs.
+class PostingTask : public QueuedTask {
+ public:
+  PostingTask(TaskQueue* queue, QueuedTask* task)
+      : queue_(queue), task_(task) {}
+  virtual ~PostingTask() { delete task_; }
+
+  virtual void Run() OVERRIDE {
+    queue_->PostTask(task_);
+    task_ = NULL;
+  }
+
+ private:
+  TaskQueue* const queue_;
+  QueuedTask* task_;
+};
+
+// Keeps its thread busy until |release| is set.
+class BlockingTask : public QueuedTask {
+ public:
+  explicit BlockingTask(EventWrapper* release) : release_(release) {}
+
+  virtual void Run() OVERRIDE { release_->Wait(kTimeoutMs); }
+
+ private:
+  EventWrapper* const release_;
+};
+
+// Counts the runs of each index.
+class IndexCountingTask : public ParallelTask {
+ public:
+  virtual void Run(int index) OVERRIDE {
+    ASSERT_GE(index, 0);
+    ASSERT_LT(index, kNumIndices);
+    ++num_runs_[index];
+  }
+
+  int num_runs(int index) { return num_runs_[index].Value(); }
+
+ private:
+  Atomic32 num_runs_[kNumIndices];
+};
+
+// Runs |task| in parallel on |pool| from a task of the pool.
+class RunInParallelTask : public QueuedTask {
+ public:
+  RunInParallelTask(ThreadPool* pool, ParallelTask* task, EventWrapper* done)
+      : pool_(pool), task_(task), done_(done) {}
+
+  virtual void Run() OVERRIDE {
+    pool_->RunInParallel(task_, kNumIndices);
+    done_->Set();
+  }
+
+ private:
+  ThreadPool* const pool_;
+  ParallelTask* const task_;
+  EventWrapper* const done_;
+};
+
+}  // namespace
+
+TEST(ThreadPoolTest, RunsAllTasks) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", kNumThreads));
+  ASSERT_TRUE(pool.get() != NULL);
+  EXPECT_EQ(kNumThreads, pool->num_threads());
+  const int kNumTasks = 1000;
+  TaskLog log(kNumTasks);
+  for (int i = 0; i < kNumTasks; ++i)
+    pool->PostTask(new LogTask(&log, i));
+  EXPECT_TRUE(log.Wait());
+}
+
+TEST(ThreadPoolTest, RunsDelayedTasksWhenDue) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", kNumThreads));
+  ASSERT_TRUE(pool.get() != NULL);
+  TaskLog log(2);
+  const int64_t start_ms = TickTime::MillisecondTimestamp();
+  pool->PostDelayedTask(new LogTask(&log, 2), 100);
+  pool->PostDelayedTask(new LogTask(&log, 1), 50);
+  EXPECT_TRUE(log.Wait());
+  EXPECT_GE(TickTime::MillisecondTimestamp() - start_ms, 100);
+  std::vector<int> ids = log.ids();
+  ASSERT_EQ(2u, ids.size());
+  EXPECT_EQ(1, ids[0]);
+  EXPECT_EQ(2, ids[1]);
+}
+
+TEST(ThreadPoolTest, DeletesTasksNotRun) {
+  Atomic32 num_run(0);
+  Atomic32 num_deleted(0);
+  {
+    scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", 1));
+    ASSERT_TRUE(pool.get() != NULL);
+    pool->PostDelayedTask(new CountingTask(&num_run, &num_deleted), 100000);
+  }
+  EXPECT_EQ(0, num_run.Value());
+  EXPECT_EQ(1, num_deleted.Value());
+}
+
+TEST(ThreadPoolTest, RunsEveryIndexInParallelOnce) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", kNumThreads));
+  ASSERT_TRUE(pool.get() != NULL);
+  IndexCountingTask task;
+  pool->RunInParallel(&task, kNumIndices);
+  for (int i = 0; i < kNumIndices; ++i)
+    EXPECT_EQ(1, task.num_runs(i)) << "Index " << i;
+}
+
+TEST(ThreadPoolTest, RunsInParallelOnCallingThreadWhenPoolIsBusy) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", 1));
+  ASSERT_TRUE(pool.get() != NULL);
+  scoped_ptr<EventWrapper> release(EventWrapper::Create());
+  pool->PostTask(new BlockingTask(release.get()));
+  IndexCountingTask task;
+  pool->RunInParallel(&task, kNumIndices);
+  for (int i = 0; i < kNumIndices; ++i)
+    EXPECT_EQ(1, task.num_runs(i)) << "Index " << i;
+  release->Set();
+}
+
+TEST(ThreadPoolTest, RunsInParallelFromTaskOfPool) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", 1));
+  ASSERT_TRUE(pool.get() != NULL);
+  scoped_ptr<EventWrapper> done(EventWrapper::Create());
+  IndexCountingTask task;
+  pool->PostTask(new RunInParallelTask(pool.get(), &task, done.get()));
+  ASSERT_EQ(kEventSignaled, done->Wait(kTimeoutMs));
+  for (int i = 0; i < kNumIndices; ++i)
+    EXPECT_EQ(1, task.num_runs(i)) << "Index " << i;
+}
+
+TEST(TaskQueueTest, RunsTasksInOrder) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", kNumThreads));
+  ASSERT_TRUE(pool.get() != NULL);
+  const int kNumQueues = 8;
+  const int kNumTasks = 200;
+  TaskLog* logs[kNumQueues];
+  TaskQueue* queues[kNumQueues];
+  Atomic32 running[kNumQueues];
+  for (int i = 0; i < kNumQueues; ++i) {
+    logs[i] = new TaskLog(kNumTasks);
+    queues[i] = new TaskQueue(pool.get());
+  }
+  for (int j = 0; j < kNumTasks; ++j) {
+    for (int i = 0; i < kNumQueues; ++i)
+      queues[i]->PostTask(new SerialTask(queues[i], &running[i], logs[i], j));
+  }
+  for (int i = 0; i < kNumQueues; ++i) {
+    EXPECT_TRUE(logs[i]->Wait());
+    EXPECT_FALSE(queues[i]->IsCurrent());
+    std::vector<int> ids = logs[i]->ids();
+    ASSERT_EQ(static_cast<size_t>(kNumTasks), ids.size());
+    for (int j = 0; j < kNumTasks; ++j)
+      EXPECT_EQ(j, ids[j]);
+  }
+  for (int i = 0; i < kNumQueues; ++i) {
+    delete queues[i];
+    delete logs[i];
+  }
+}
+
+TEST(TaskQueueTest, RunsDelayedTasksInOrder) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", kNumThreads));
+  ASSERT_TRUE(pool.get() != NULL);
+  TaskQueue queue(pool.get());
+  TaskLog log(4);
+  queue.PostDelayedTask(new LogTask(&log, 3), 20);
+  queue.PostDelayedTask(new LogTask(&log, 4), 20);
+  queue.PostTask(new LogTask(&log, 1));
+  queue.PostDelayedTask(new LogTask(&log, 2), 10);
+  EXPECT_TRUE(log.Wait());
+  std::vector<int> ids = log.ids();
+  ASSERT_EQ(4u, ids.size());
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(i + 1, ids[i]);
+}
+
+TEST(TaskQueueTest, BusyQueueLetsOtherQueuesRun) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", 1));
+  ASSERT_TRUE(pool.get() != NULL);
+  scoped_ptr<EventWrapper> release(EventWrapper::Create());
+  const int kNumBusyTasks = 100;
+  const int kOtherTaskId = -1;
+  TaskLog log(kNumBusyTasks + 1);
+  TaskQueue busy_queue(pool.get());
+  TaskQueue other_queue(pool.get());
+  // All the tasks of the busy queue are posted before the thread gets to them,
+  // and the other queue gets its task while the busy one is running.
+  pool->PostTask(new BlockingTask(release.get()));
+  busy_queue.PostTask(
+      new PostingTask(&other_queue, new LogTask(&log, kOtherTaskId)));
+  for (int i = 0; i < kNumBusyTasks; ++i)
+    busy_queue.PostTask(new LogTask(&log, i));
+  release->Set();
+  EXPECT_TRUE(log.Wait());
+  std::vector<int> ids = log.ids();
+  ASSERT_EQ(static_cast<size_t>(kNumBusyTasks + 1), ids.size());
+  // The other queue runs after the first batch of the busy one, not after all
+  // of its tasks.
+  size_t other_index = 0;
+  while (other_index < ids.size() && ids[other_index] != kOtherTaskId)
+    ++other_index;
+  EXPECT_LT(other_index, ids.size() / 2);
+}
+
+TEST(TaskQueueTest, DeletesTasksNotRun) {
+  scoped_ptr<ThreadPool> pool(ThreadPool::Create("TestPool", 1));
+  ASSERT_TRUE(pool.get() != NULL);
+  scoped_ptr<EventWrapper> started(EventWrapper::Create());
+  Atomic32 num_slow_run(0);
+  Atomic32 num_run(0);
+  Atomic32 num_deleted(0);
+  {
+    TaskQueue queue(pool.get());
+    queue.PostTask(new SlowTask(started.get(), &num_slow_run));
+    queue.PostTask(new CountingTask(&num_run, &num_deleted));
+    queue.PostDelayedTask(new CountingTask(&num_run, &num_deleted), 100000);
+    ASSERT_EQ(kEventSignaled, started->Wait(kTimeoutMs));
+  }
+  // The running task was waited for, the others were dropped.
+  EXPECT_EQ(1, num_slow_run.Value());
+  EXPECT_EQ(0, num_run.Value());
+  EXPECT_EQ(2, num_deleted.Value());
+}
+
+}  // namespace webrtc
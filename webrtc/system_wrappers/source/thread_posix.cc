@@ -61,6 +61,7 @@
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 
 namespace webrtc {
@@ -99,8 +100,9 @@ extern "C"
 
 ThreadWrapper* ThreadPosix::Create(ThreadRunFunction func, ThreadObj obj,
                                    ThreadPriority prio,
-                                   const char* thread_name) {
-  ThreadPosix* ptr = new ThreadPosix(func, obj, prio, thread_name);
+                                   const char* thread_name,
+                                   ThreadRole role) {
+  ThreadPosix* ptr = new ThreadPosix(func, obj, prio, thread_name, role);
   if (!ptr) {
     return NULL;
   }
@@ -113,13 +115,15 @@ ThreadWrapper* ThreadPosix::Create(ThreadRunFunction func, ThreadObj obj,
 }
 
 ThreadPosix::ThreadPosix(ThreadRunFunction func, ThreadObj obj,
-                         ThreadPriority prio, const char* thread_name)
+                         ThreadPriority prio, const char* thread_name,
+                         ThreadRole role)
     : run_function_(func),
       obj_(obj),
       crit_state_(CriticalSectionWrapper::CreateCriticalSection()),
       alive_(false),
       dead_(true),
       prio_(prio),
+      role_(role),
       event_(EventWrapper::Create()),
       name_(),
       set_thread_name_(false),
@@ -178,11 +182,17 @@ bool ThreadPosix::Start(unsigned int& thread_id)
   int result = pthread_attr_setdetachstate(&attr_, PTHREAD_CREATE_DETACHED);
   // Set the stack stack size to 1M.
   result |= pthread_attr_setstacksize(&attr_, 1024 * 1024);
+  const ThreadRoleConfig role_config = GetRoleConfig(role_);
 #ifdef WEBRTC_THREAD_RR
-  const int policy = SCHED_RR;
+  int policy = SCHED_RR;
 #else
-  const int policy = SCHED_FIFO;
+  int policy = SCHED_FIFO;
 #endif
+  if (role_config.policy == kFifoSchedulingPolicy) {
+    policy = SCHED_FIFO;
+  } else if (role_config.policy == kRoundRobinSchedulingPolicy) {
+    policy = SCHED_RR;
+  }
   event_->Reset();
   // If pthread_create was successful, a thread was created and is running.
   // Don't return false if it was successful since if there are any other
@@ -210,6 +220,10 @@ bool ThreadPosix::Start(unsigned int& thread_id)
 #if HAS_THREAD_ID
   thread_id = static_cast<unsigned int>(thread_);
 #endif
+  if (role_config.cpu_mask != 0 && !SetAffinityMask(role_config.cpu_mask)) {
+    WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
+                 "unable to set thread affinity");
+  }
   sched_param param;
 
   const int min_prio = sched_get_priority_min(policy);
@@ -220,11 +234,16 @@ bool ThreadPosix::Start(unsigned int& thread_id)
                  "unable to retreive min or max priority for threads");
     return true;
   }
-  if (max_prio - min_prio <= 2) {
+  if (role_config.policy != kDefaultSchedulingPolicy) {
+    // The role asks for an explicit real-time priority.
+    param.sched_priority = std::min(std::max(role_config.priority, min_prio),
+                                    max_prio);
+  } else if (max_prio - min_prio <= 2) {
     // There is no room for setting priorities with any granularity.
     return true;
+  } else {
+    param.sched_priority = ConvertToSystemPriority(prio_, min_prio, max_prio);
   }
-  param.sched_priority = ConvertToSystemPriority(prio_, min_prio, max_prio);
   result = pthread_setschedparam(thread_, policy, &param);
   if (result == EINVAL) {
     WEBRTC_TRACE(kTraceError, kTraceUtility, -1,
@@ -267,6 +286,17 @@ bool ThreadPosix::SetAffinity(const int* processor_numbers,
   return true;
 }
 
+bool ThreadPosix::SetAffinityMask(uint64_t cpu_mask) {
+  int processor_numbers[64];
+  unsigned int amount_of_processors = 0;
+  for (int processor = 0; processor < 64; ++processor) {
+    if (cpu_mask & (static_cast<uint64_t>(1) << processor)) {
+      processor_numbers[amount_of_processors++] = processor;
+    }
+  }
+  return SetAffinity(processor_numbers, amount_of_processors);
+}
+
 #else
 // NOTE: On Mac OS X, use the Thread affinity API in
 // /usr/include/mach/thread_policy.h: thread_policy_set and mach_thread_self()
@@ -274,6 +304,10 @@ bool ThreadPosix::SetAffinity(const int* processor_numbers,
 bool ThreadPosix::SetAffinity(const int* , const unsigned int) {
   return false;
 }
+
+bool ThreadPosix::SetAffinityMask(uint64_t) {
+  return false;
+}
 #endif
 
 void ThreadPosix::SetNotAlive() {
@@ -290,8 +324,10 @@ bool ThreadPosix::Stop() {
   }
 
   // TODO(hellner) why not use an event here?
-  // Wait up to 10 seconds for the thread to terminate
-  for (int i = 0; i < 1000 && !dead; ++i) {
+  // Wait up to 10 seconds for the thread to terminate, in real time also
+  // when the time is scaled.
+  const int max_sleeps = 1000 * TickTime::time_scale();
+  for (int i = 0; i < max_sleeps && !dead; ++i) {
     SleepMs(10);
     {
       CriticalSectionScoped cs(crit_state_);
@@ -26,10 +26,12 @@ int ConvertToSystemPriority(ThreadPriority priority, int min_prio,
 class ThreadPosix : public ThreadWrapper {
  public:
   static ThreadWrapper* Create(ThreadRunFunction func, ThreadObj obj,
-                               ThreadPriority prio, const char* thread_name);
+                               ThreadPriority prio, const char* thread_name,
+                               ThreadRole role = kUnspecifiedThreadRole);
 
   ThreadPosix(ThreadRunFunction func, ThreadObj obj, ThreadPriority prio,
-              const char* thread_name);
+              const char* thread_name,
+              ThreadRole role = kUnspecifiedThreadRole);
   virtual ~ThreadPosix();
 
   // From ThreadWrapper.
@@ -44,6 +46,8 @@ class ThreadPosix : public ThreadWrapper {
 
  private:
   int Construct();
+  // Pins the thread to the CPUs of |cpu_mask|, see ThreadRoleConfig.
+  bool SetAffinityMask(uint64_t cpu_mask);
 
  private:
   ThreadRunFunction   run_function_;
@@ -54,6 +58,7 @@ class ThreadPosix : public ThreadWrapper {
   bool                    alive_;
   bool                    dead_;
   ThreadPriority          prio_;
+  ThreadRole              role_;
   EventWrapper*           event_;
 
   // Zero-terminated thread name string.
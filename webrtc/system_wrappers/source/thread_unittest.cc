@@ -53,4 +53,30 @@ TEST(ThreadTest, RunFunctionIsCalled) {
   delete thread;
 }
 
+TEST(ThreadTest, RoleConfig) {
+  ThreadRoleConfig config;
+  config.policy = kRoundRobinSchedulingPolicy;
+  config.priority = 10;
+  config.cpu_mask = 1;
+  ThreadWrapper::SetRoleConfig(kPacerThreadRole, config);
+  EXPECT_EQ(kRoundRobinSchedulingPolicy,
+            ThreadWrapper::GetRoleConfig(kPacerThreadRole).policy);
+  EXPECT_EQ(10, ThreadWrapper::GetRoleConfig(kPacerThreadRole).priority);
+  EXPECT_EQ(1u, ThreadWrapper::GetRoleConfig(kPacerThreadRole).cpu_mask);
+  EXPECT_EQ(kDefaultSchedulingPolicy,
+            ThreadWrapper::GetRoleConfig(kEncoderThreadRole).policy);
+
+  // The thread runs even if the process may not use real-time scheduling.
+  bool flag = false;
+  ThreadWrapper* thread = ThreadWrapper::CreateThread(
+      &SetFlagRunFunction, &flag, kNormalPriority, "Pacer", kPacerThreadRole);
+  unsigned int id = 42;
+  ASSERT_TRUE(thread->Start(id));
+  EXPECT_TRUE(thread->Stop());
+  EXPECT_TRUE(flag);
+  delete thread;
+
+  ThreadWrapper::SetRoleConfig(kPacerThreadRole, ThreadRoleConfig());
+}
+
 }  // namespace webrtc
@@ -16,6 +16,8 @@ namespace webrtc {
 
 bool TickTime::use_fake_clock_ = false;
 int64_t TickTime::fake_ticks_ = 0;
+int TickTime::time_scale_ = 1;
+int64_t TickTime::time_scale_origin_ticks_ = 0;
 
 void TickTime::UseFakeClock(int64_t start_millisecond) {
   use_fake_clock_ = true;
@@ -27,6 +29,35 @@ void TickTime::AdvanceFakeClock(int64_t milliseconds) {
   fake_ticks_ += MillisecondsToTicks(milliseconds);
 }
 
+void TickTime::SetTimeScale(int scale) {
+  assert(scale >= 1);
+  time_scale_origin_ticks_ = QueryOsForTicks();
+  time_scale_ = scale;
+}
+
+int64_t TickTime::TimeScaleOffsetMicroseconds() {
+  if (time_scale_ == 1)
+    return 0;
+  const int64_t os_ticks = QueryOsForTicks();
+  const int64_t scaled_ticks =
+      ScaleTicks(os_ticks, time_scale_origin_ticks_, time_scale_);
+  return (TickTime(scaled_ticks) - TickTime(os_ticks)).Microseconds();
+}
+
+int64_t TickTime::ScaledWaitMicroseconds(int64_t milliseconds) {
+  return ScaledWaitMicroseconds(milliseconds, time_scale_);
+}
+
+int64_t TickTime::ScaleTicks(int64_t os_ticks,
+                             int64_t origin_ticks,
+                             int scale) {
+  return origin_ticks + (os_ticks - origin_ticks) * scale;
+}
+
+int64_t TickTime::ScaledWaitMicroseconds(int64_t milliseconds, int scale) {
+  return milliseconds * 1000 / scale;
+}
+
 int64_t TickTime::QueryOsForTicks() {
   TickTime result;
 #if _WIN32
@@ -73,24 +73,18 @@ TraceImpl::TraceImpl()
       thread_(*ThreadWrapper::CreateThread(TraceImpl::Run, this,
                                            kHighestPriority, "Trace")),
       event_(*EventWrapper::Create()),
-      critsect_array_(CriticalSectionWrapper::CreateCriticalSection()),
-      next_free_idx_(),
-      level_(),
-      length_(),
-      message_queue_(),
-      active_queue_(0) {
-  next_free_idx_[0] = 0;
-  next_free_idx_[1] = 0;
+      queue_(new QueuedMessage[WEBRTC_TRACE_MAX_QUEUE]),
+      enqueue_pos_(0),
+      dequeue_pos_(0),
+      pending_messages_(0),
+      dropped_messages_(0) {
+  // The record for position n is free for writing when its sequence is n.
+  for (int n = 0; n < WEBRTC_TRACE_MAX_QUEUE; ++n) {
+    queue_[n].sequence += n;
+  }
 
   unsigned int tid = 0;
   thread_.Start(tid);
-
-  for (int m = 0; m < WEBRTC_TRACE_NUM_ARRAY; ++m) {
-    for (int n = 0; n < WEBRTC_TRACE_MAX_QUEUE; ++n) {
-      message_queue_[m][n] = new
-      char[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
-    }
-  }
 }
 
 bool TraceImpl::StopThread() {
@@ -121,13 +115,7 @@ TraceImpl::~TraceImpl() {
   delete &trace_file_;
   delete &thread_;
   delete critsect_interface_;
-  delete critsect_array_;
-
-  for (int m = 0; m < WEBRTC_TRACE_NUM_ARRAY; ++m) {
-    for (int n = 0; n < WEBRTC_TRACE_MAX_QUEUE; ++n) {
-      delete [] message_queue_[m][n];
-    }
-  }
+  delete [] queue_;
 }
 
 int32_t TraceImpl::AddThreadId(char* trace_message) const {
@@ -409,7 +397,7 @@ int32_t TraceImpl::AddMessage(
   return length + 1;
 }
 
-void TraceImpl::AddMessageToList(
+bool TraceImpl::AddMessageToList(
     const char trace_message[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
     const uint16_t length,
     const TraceLevel level) {
@@ -418,52 +406,45 @@ void TraceImpl::AddMessageToList(
   if (callback_) {
     callback_->Print(level, trace_message, length);
   }
-  return;
+  return true;
 #endif
 
-  CriticalSectionScoped lock(critsect_array_);
-
-  if (next_free_idx_[active_queue_] >= WEBRTC_TRACE_MAX_QUEUE) {
-    if (!trace_file_.Open() && !callback_) {
-      // Keep at least the last 1/4 of old messages when not logging.
-      // TODO(hellner): isn't this redundant. The user will make it known
-      //                when to start logging. Why keep messages before
-      //                that?
-      for (int n = 0; n < WEBRTC_TRACE_MAX_QUEUE / 4; ++n) {
-        const int last_quarter_offset = (3 * WEBRTC_TRACE_MAX_QUEUE / 4);
-        memcpy(message_queue_[active_queue_][n],
-               message_queue_[active_queue_][n + last_quarter_offset],
-               WEBRTC_TRACE_MAX_MESSAGE_SIZE);
+  // Claim the record at the enqueue position, unless the worker thread has
+  // not yet read the message last written to it. The positions are compared
+  // as differences so that they can wrap around.
+  QueuedMessage* record = NULL;
+  uint32_t pos = static_cast<uint32_t>(enqueue_pos_.Value());
+  while (true) {
+    record = &queue_[pos & (WEBRTC_TRACE_MAX_QUEUE - 1)];
+    const int32_t diff = static_cast<int32_t>(
+        static_cast<uint32_t>(record->sequence.Value()) - pos);
+    if (diff == 0) {
+      if (enqueue_pos_.CompareExchange(static_cast<int32_t>(pos + 1),
+                                       static_cast<int32_t>(pos))) {
+        break;
       }
-      next_free_idx_[active_queue_] = WEBRTC_TRACE_MAX_QUEUE / 4;
-    } else {
-      // More messages are being written than there is room for in the
-      // buffer. Drop any new messages.
-      // TODO(hellner): its probably better to drop old messages instead
-      //                of new ones. One step further: if this happens
-      //                it's due to writing faster than what can be
-      //                processed. Maybe modify the filter at this point.
-      //                E.g. turn of STREAM.
-      return;
+    } else if (diff < 0) {
+      // More messages are being written than the worker thread can keep up
+      // with. Rather than blocking the caller, drop the message.
+      ++dropped_messages_;
+      return false;
     }
+    // Another writer claimed this position first.
+    pos = static_cast<uint32_t>(enqueue_pos_.Value());
   }
 
-  uint16_t idx = next_free_idx_[active_queue_];
-  next_free_idx_[active_queue_]++;
-
-  level_[active_queue_][idx] = level;
-  length_[active_queue_][idx] = length;
-  memcpy(message_queue_[active_queue_][idx], trace_message, length);
-
-  if (next_free_idx_[active_queue_] == WEBRTC_TRACE_MAX_QUEUE - 1) {
-    // Logging more messages than can be worked off. Log a warning.
-    const char warning_msg[] = "WARNING MISSING TRACE MESSAGES\n";
-    level_[active_queue_][next_free_idx_[active_queue_]] = kTraceWarning;
-    length_[active_queue_][next_free_idx_[active_queue_]] = strlen(warning_msg);
-    memcpy(message_queue_[active_queue_][next_free_idx_[active_queue_]],
-           warning_msg, strlen(warning_msg));
-    next_free_idx_[active_queue_]++;
+  record->level = level;
+  record->length = length;
+  memcpy(record->message, trace_message, length);
+  // Hand the record over to the worker thread.
+  record->sequence += 1;
+
+  // Only wake up the worker thread for the first message since it last
+  // started reading.
+  if (++pending_messages_ == 1) {
+    event_.Set();
   }
+  return true;
 }
 
 bool TraceImpl::Run(void* obj) {
@@ -472,14 +453,7 @@ bool TraceImpl::Run(void* obj) {
 
 bool TraceImpl::Process() {
   if (event_.Wait(1000) == kEventSignaled) {
-    // This slightly odd construction is to avoid locking |critsect_interface_|
-    // while calling WriteToFile() since it's locked inside the function.
-    critsect_interface_->Enter();
-    bool write_to_file = trace_file_.Open() || callback_;
-    critsect_interface_->Leave();
-    if (write_to_file) {
-      WriteToFile();
-    }
+    WriteToFile();
   } else {
     CriticalSectionScoped lock(critsect_interface_);
     trace_file_.Flush();
@@ -488,88 +462,105 @@ bool TraceImpl::Process() {
 }
 
 void TraceImpl::WriteToFile() {
-  uint8_t local_queue_active = 0;
-  uint16_t local_next_free_idx = 0;
-
-  // There are two buffers. One for reading (for writing to file) and one for
-  // writing (for storing new messages). Let new messages be posted to the
-  // unused buffer so that the current buffer can be flushed safely.
-  {
-    CriticalSectionScoped lock(critsect_array_);
-    local_next_free_idx = next_free_idx_[active_queue_];
-    next_free_idx_[active_queue_] = 0;
-    local_queue_active = active_queue_;
-    if (active_queue_ == 0) {
-      active_queue_ = 1;
-    } else {
-      active_queue_ = 0;
+  // Reset the count before reading so that a message queued after this point
+  // either is read below or signals the event again.
+  int32_t pending = pending_messages_.Value();
+  while (!pending_messages_.CompareExchange(0, pending)) {
+    pending = pending_messages_.Value();
+  }
+
+  CriticalSectionScoped lock(critsect_interface_);
+  const bool write = trace_file_.Open() || callback_;
+
+  while (true) {
+    QueuedMessage* record =
+        &queue_[dequeue_pos_ & (WEBRTC_TRACE_MAX_QUEUE - 1)];
+    const int32_t diff = static_cast<int32_t>(
+        static_cast<uint32_t>(record->sequence.Value()) - (dequeue_pos_ + 1));
+    if (diff < 0) {
+      break;  // Nothing more has been written.
     }
+    if (write) {
+      if (callback_) {
+        callback_->Print(record->level, record->message, record->length);
+      }
+      WriteMessageToFile(record->message, record->length);
+    }
+    // Hand the record back to the writers, for the position one lap ahead.
+    record->sequence += WEBRTC_TRACE_MAX_QUEUE - 1;
+    ++dequeue_pos_;
   }
-  if (local_next_free_idx == 0) {
+
+  const int32_t dropped = dropped_messages_.Value();
+  if (dropped > 0) {
+    dropped_messages_ -= dropped;
+    char warning_msg[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
+    const int length = sprintf(warning_msg,
+                               "WARNING %d TRACE MESSAGES DROPPED", dropped);
+    if (write && length > 0) {
+      // Length with NULL termination, like the queued messages.
+      if (callback_) {
+        callback_->Print(kTraceWarning, warning_msg, length + 1);
+      }
+      WriteMessageToFile(warning_msg, static_cast<uint16_t>(length + 1));
+    }
+  }
+}
+
+void TraceImpl::WriteMessageToFile(char* trace_message,
+                                   const uint16_t length) {
+  if (!trace_file_.Open()) {
     return;
   }
+  if (row_count_text_ > WEBRTC_TRACE_MAX_FILE_SIZE) {
+    // wrap file
+    row_count_text_ = 0;
+    trace_file_.Flush();
 
-  CriticalSectionScoped lock(critsect_interface_);
+    if (file_count_text_ == 0) {
+      trace_file_.Rewind();
+    } else {
+      char old_file_name[FileWrapper::kMaxFileNameSize];
+      char new_file_name[FileWrapper::kMaxFileNameSize];
 
-  for (uint16_t idx = 0; idx < local_next_free_idx; ++idx) {
-    TraceLevel local_level = level_[local_queue_active][idx];
-    if (callback_) {
-      callback_->Print(local_level, message_queue_[local_queue_active][idx],
-                       length_[local_queue_active][idx]);
-    }
-    if (trace_file_.Open()) {
-      if (row_count_text_ > WEBRTC_TRACE_MAX_FILE_SIZE) {
-        // wrap file
-        row_count_text_ = 0;
-        trace_file_.Flush();
-
-        if (file_count_text_ == 0) {
-          trace_file_.Rewind();
-        } else {
-          char old_file_name[FileWrapper::kMaxFileNameSize];
-          char new_file_name[FileWrapper::kMaxFileNameSize];
-
-          // get current name
-          trace_file_.FileName(old_file_name,
-                               FileWrapper::kMaxFileNameSize);
-          trace_file_.CloseFile();
-
-          file_count_text_++;
-
-          UpdateFileName(old_file_name, new_file_name, file_count_text_);
-
-          if (trace_file_.OpenFile(new_file_name, false, false,
-                                   true) == -1) {
-            return;
-          }
-        }
-      }
-      if (row_count_text_ ==  0) {
-        char message[WEBRTC_TRACE_MAX_MESSAGE_SIZE + 1];
-        int32_t length = AddDateTimeInfo(message);
-        if (length != -1) {
-          message[length] = 0;
-          message[length - 1] = '\n';
-          trace_file_.Write(message, length);
-          row_count_text_++;
-        }
-        length = AddBuildInfo(message);
-        if (length != -1) {
-          message[length + 1] = 0;
-          message[length] = '\n';
-          message[length - 1] = '\n';
-          trace_file_.Write(message, length + 1);
-          row_count_text_++;
-          row_count_text_++;
-        }
+      // get current name
+      trace_file_.FileName(old_file_name,
+                           FileWrapper::kMaxFileNameSize);
+      trace_file_.CloseFile();
+
+      file_count_text_++;
+
+      UpdateFileName(old_file_name, new_file_name, file_count_text_);
+
+      if (trace_file_.OpenFile(new_file_name, false, false,
+                               true) == -1) {
+        return;
       }
-      uint16_t length = length_[local_queue_active][idx];
-      message_queue_[local_queue_active][idx][length] = 0;
-      message_queue_[local_queue_active][idx][length - 1] = '\n';
-      trace_file_.Write(message_queue_[local_queue_active][idx], length);
+    }
+  }
+  if (row_count_text_ ==  0) {
+    char message[WEBRTC_TRACE_MAX_MESSAGE_SIZE + 1];
+    int32_t length = AddDateTimeInfo(message);
+    if (length != -1) {
+      message[length] = 0;
+      message[length - 1] = '\n';
+      trace_file_.Write(message, length);
+      row_count_text_++;
+    }
+    length = AddBuildInfo(message);
+    if (length != -1) {
+      message[length + 1] = 0;
+      message[length] = '\n';
+      message[length - 1] = '\n';
+      trace_file_.Write(message, length + 1);
+      row_count_text_++;
       row_count_text_++;
     }
   }
+  trace_message[length] = 0;
+  trace_message[length - 1] = '\n';
+  trace_file_.Write(trace_message, length);
+  row_count_text_++;
 }
 
 void TraceImpl::AddImpl(const TraceLevel level, const TraceModule module,
@@ -616,9 +607,6 @@ void TraceImpl::AddImpl(const TraceLevel level, const TraceModule module,
     }
     ack_len += len;
     AddMessageToList(trace_message, (uint16_t)ack_len, level);
-
-    // Make sure that messages are written as soon as possible.
-    event_.Set();
   }
 }
 
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_IMPL_H_
 #define WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_IMPL_H_
 
+#include "webrtc/system_wrappers/interface/atomic32.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/file_wrapper.h"
@@ -24,17 +25,16 @@ namespace webrtc {
 // TODO(hellner) the buffer should be close to how much the system can write to
 //               file. Increasing the buffer will not solve anything. Sooner or
 //               later the buffer is going to fill up anyways.
+// The queue size must be a power of two.
 #if defined(WEBRTC_IOS)
-#define WEBRTC_TRACE_MAX_QUEUE  2000
+#define WEBRTC_TRACE_MAX_QUEUE  2048
 #else
-#define WEBRTC_TRACE_MAX_QUEUE  8000
+#define WEBRTC_TRACE_MAX_QUEUE  8192
 #endif
-#define WEBRTC_TRACE_NUM_ARRAY 2
 #define WEBRTC_TRACE_MAX_MESSAGE_SIZE 256
-// Total buffer size is WEBRTC_TRACE_NUM_ARRAY (number of buffer partitions) *
-// WEBRTC_TRACE_MAX_QUEUE (number of lines per buffer partition) *
+// Total buffer size is WEBRTC_TRACE_MAX_QUEUE (number of lines) *
 // WEBRTC_TRACE_MAX_MESSAGE_SIZE (number of 1 byte charachters per line) =
-// 1 or 4 Mbyte.
+// 0.5 or 2 Mbyte.
 
 #define WEBRTC_TRACE_MAX_FILE_SIZE 100*1000
 // Number of rows that may be written to file. On average 110 bytes per row (max
@@ -90,7 +90,9 @@ class TraceImpl : public Trace {
                      const char msg[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
                      const uint16_t written_so_far) const;
 
-  void AddMessageToList(
+  // Queues a message for the worker thread without blocking. Returns false,
+  // and counts the message as dropped, if the queue is full.
+  bool AddMessageToList(
     const char trace_message[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
     const uint16_t length,
     const TraceLevel level);
@@ -106,6 +108,16 @@ class TraceImpl : public Trace {
     const uint32_t new_count) const;
 
   void WriteToFile();
+  void WriteMessageToFile(char* trace_message, const uint16_t length);
+
+  // A queued message. |sequence| tells the writers and the reader whose turn
+  // it is to use the record, see AddMessageToList().
+  struct QueuedMessage {
+    Atomic32 sequence;
+    TraceLevel level;
+    uint16_t length;
+    char message[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
+  };
 
   CriticalSectionWrapper* critsect_interface_;
   TraceCallback* callback_;
@@ -116,13 +128,17 @@ class TraceImpl : public Trace {
   ThreadWrapper& thread_;
   EventWrapper& event_;
 
-  // critsect_array_ protects active_queue_.
-  CriticalSectionWrapper* critsect_array_;
-  uint16_t next_free_idx_[WEBRTC_TRACE_NUM_ARRAY];
-  TraceLevel level_[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-  uint16_t length_[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-  char* message_queue_[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-  uint8_t active_queue_;
+  // Bounded queue with any number of writers and the worker thread as its
+  // only reader. The positions only ever increase; the record used for a
+  // position is the position modulo the queue size.
+  QueuedMessage* queue_;
+  Atomic32 enqueue_pos_;
+  // Only used by the worker thread.
+  uint32_t dequeue_pos_;
+  // Messages queued since the worker thread was last signaled.
+  Atomic32 pending_messages_;
+  // Messages dropped since the last time this was reported in the trace.
+  Atomic32 dropped_messages_;
 };
 
 }  // namespace webrtc
@@ -23,6 +23,7 @@ namespace webrtc {
 
 const double kPi = 3.14159265;
 const int kDefaultProcessIntervalMs = 30;
+const size_t kMaxFreePackets = 1000;
 
 static int GaussianRandom(int mean_delay_ms, int standard_deviation_ms) {
   // Creating a Normal distribution variable from two independent uniform
@@ -38,60 +39,95 @@ static bool UniformLoss(int loss_percent) {
   return outcome < loss_percent;
 }
 
+static double UniformRandom() {
+  return rand() / (RAND_MAX + 1.0);  // NOLINT
+}
+
 class NetworkPacket {
  public:
-  NetworkPacket(const uint8_t* data, size_t length, int64_t send_time,
-      int64_t arrival_time)
-      : data_(NULL),
-        data_length_(length),
-        send_time_(send_time),
-        arrival_time_(arrival_time) {
-    data_ = new uint8_t[length];
-    memcpy(data_, data, length);
-  }
-  ~NetworkPacket() {
-    delete [] data_;
+  NetworkPacket()
+      : data_length_(0),
+        send_time_(0),
+        transmit_time_(0),
+        arrival_time_(0),
+        id_(0) {}
+
+  // Reuses the packet, keeping the storage of an earlier packet if it is
+  // large enough.
+  void Set(const uint8_t* data, size_t length, int64_t send_time,
+           int64_t transmit_time, uint64_t id) {
+    if (data_.size() < length)
+      data_.resize(length);
+    memcpy(&data_[0], data, length);
+    data_length_ = length;
+    send_time_ = send_time;
+    transmit_time_ = transmit_time;
+    arrival_time_ = send_time;
+    id_ = id;
   }
 
-  uint8_t* data() const { return data_; }
+  const uint8_t* data() const { return &data_[0]; }
   size_t data_length() const { return data_length_; }
   int64_t send_time() const { return send_time_; }
+  int64_t transmit_time() const { return transmit_time_; }
   int64_t arrival_time() const { return arrival_time_; }
+  uint64_t id() const { return id_; }
+  void set_arrival_time(int64_t arrival_time) { arrival_time_ = arrival_time; }
   void IncrementArrivalTime(int64_t extra_delay) {
     arrival_time_+= extra_delay;
   }
 
  private:
-  // The packet data.
-  uint8_t* data_;
-  // Length of data_.
+  // The packet data, possibly longer than the packet.
+  std::vector<uint8_t> data_;
+  // Length of the packet in data_.
   size_t data_length_;
   // The time the packet was sent out on the network.
-  const int64_t send_time_;
+  int64_t send_time_;
+  // The time it takes to put the packet on the link.
+  int64_t transmit_time_;
   // The time the packet should arrive at the reciver.
   int64_t arrival_time_;
+  // Increases with the send order.
+  uint64_t id_;
 };
 
+bool FakeNetworkPipe::ArrivesLater::operator()(const NetworkPacket* a,
+                                               const NetworkPacket* b) const {
+  if (a->arrival_time() != b->arrival_time())
+    return a->arrival_time() > b->arrival_time();
+  return a->id() > b->id();
+}
+
 FakeNetworkPipe::FakeNetworkPipe(
     const FakeNetworkPipe::Config& config)
     : lock_(CriticalSectionWrapper::CreateCriticalSection()),
       packet_receiver_(NULL),
+      link_free_time_(0),
+      last_arrival_time_(0),
+      next_packet_id_(0),
       config_(config),
+      config_time_(TickTime::MillisecondTimestamp()),
+      bursting_(false),
       dropped_packets_(0),
       sent_packets_(0),
-      total_packet_delay_(0),
-      next_process_time_(TickTime::MillisecondTimestamp()) {
+      total_packet_delay_(0) {
 }
 
 FakeNetworkPipe::~FakeNetworkPipe() {
-  while (!capacity_link_.empty()) {
-    delete capacity_link_.front();
-    capacity_link_.pop();
+  for (std::map<uint32_t, Flow>::iterator it = flows_.begin();
+       it != flows_.end(); ++it) {
+    while (!it->second.packets.empty()) {
+      delete it->second.packets.front();
+      it->second.packets.pop_front();
+    }
   }
   while (!delay_link_.empty()) {
-    delete delay_link_.front();
+    delete delay_link_.top();
     delay_link_.pop();
   }
+  for (size_t i = 0; i < free_packets_.size(); ++i)
+    delete free_packets_[i];
 }
 
 void FakeNetworkPipe::SetReceiver(PacketReceiver* receiver) {
@@ -100,39 +136,52 @@ void FakeNetworkPipe::SetReceiver(PacketReceiver* receiver) {
 
 void FakeNetworkPipe::SetConfig(const FakeNetworkPipe::Config& config) {
   CriticalSectionScoped crit(lock_.get());
-  config_ = config;  // Shallow copy of the struct.
+  config_ = config;
+  config_time_ = TickTime::MillisecondTimestamp();
 }
 
 void FakeNetworkPipe::SendPacket(const uint8_t* data, size_t data_length) {
+  SendPacket(data, data_length, 0);
+}
+
+void FakeNetworkPipe::SendPacket(const uint8_t* data, size_t data_length,
+                                 uint32_t flow_id) {
   // A NULL packet_receiver_ means that this pipe will terminate the flow of
   // packets.
   if (packet_receiver_ == NULL)
     return;
   CriticalSectionScoped crit(lock_.get());
+  int64_t time_now = TickTime::MillisecondTimestamp();
+
+  // Catch up with the link, so that this packet isn't transmitted before it
+  // was sent.
+  TransmitPackets(time_now);
+
+  Flow* flow = &flows_[flow_id];
+  // The packet being transmitted still takes room in the queue.
+  size_t queue_length = flow->packets.size();
+  if (flow->transmit_end_time > time_now)
+    ++queue_length;
   if (config_.queue_length_packets > 0 &&
-      capacity_link_.size() >= config_.queue_length_packets) {
+      queue_length >= config_.queue_length_packets) {
     // Too many packet on the link, drop this one.
     ++dropped_packets_;
     return;
   }
 
-  int64_t time_now = TickTime::MillisecondTimestamp();
-
-  // Delay introduced by the link capacity.
+  // Delay introduced by the link capacity, set by the capacity when the
+  // packet is sent.
   int64_t capacity_delay_ms = 0;
-  if (config_.link_capacity_kbps > 0)
-    capacity_delay_ms = data_length / (config_.link_capacity_kbps / 8);
-  int64_t network_start_time = time_now;
-
-  // Check if there already are packets on the link and change network start
-  // time if there is.
-  if (capacity_link_.size() > 0)
-    network_start_time = capacity_link_.back()->arrival_time();
+  int capacity_kbps = LinkCapacityKbps(time_now);
+  if (capacity_kbps > 0)
+    capacity_delay_ms = 8 * static_cast<int64_t>(data_length) / capacity_kbps;
 
-  int64_t arrival_time = network_start_time + capacity_delay_ms;
-  NetworkPacket* packet = new NetworkPacket(data, data_length, time_now,
-                                            arrival_time);
-  capacity_link_.push(packet);
+  if (active_flows_.empty() && link_free_time_ < time_now)
+    link_free_time_ = time_now;
+  if (flow->packets.empty())
+    active_flows_.push_back(flow);
+  flow->packets.push_back(
+      AllocatePacket(data, data_length, time_now, capacity_delay_ms));
 }
 
 float FakeNetworkPipe::PercentageLoss() {
@@ -154,44 +203,17 @@ int FakeNetworkPipe::AverageDelay() {
 
 void FakeNetworkPipe::Process() {
   int64_t time_now = TickTime::MillisecondTimestamp();
-  std::queue<NetworkPacket*> packets_to_deliver;
+  std::vector<NetworkPacket*> packets_to_deliver;
   {
     CriticalSectionScoped crit(lock_.get());
-    // Check the capacity link first.
-    while (capacity_link_.size() > 0 &&
-           time_now >= capacity_link_.front()->arrival_time()) {
-      // Time to get this packet.
-      NetworkPacket* packet = capacity_link_.front();
-      capacity_link_.pop();
-
-      // Packets are randomly dropped after being affected by the bottleneck.
-      if (UniformLoss(config_.loss_percent)) {
-        delete packet;
-        continue;
-      }
-
-      // Add extra delay and jitter, but make sure the arrival time is not
-      // earlier than the last packet in the queue.
-      int extra_delay = GaussianRandom(config_.queue_delay_ms,
-                                       config_.delay_standard_deviation_ms);
-      if (delay_link_.size() > 0 &&
-          packet->arrival_time() + extra_delay <
-          delay_link_.back()->arrival_time()) {
-        extra_delay = delay_link_.back()->arrival_time() -
-            packet->arrival_time();
-      }
-      packet->IncrementArrivalTime(extra_delay);
-      if (packet->arrival_time() < next_process_time_)
-        next_process_time_ = packet->arrival_time();
-      delay_link_.push(packet);
-    }
+    TransmitPackets(time_now);
 
     // Check the extra delay queue.
-    while (delay_link_.size() > 0 &&
-           time_now >= delay_link_.front()->arrival_time()) {
+    while (!delay_link_.empty() &&
+           time_now >= delay_link_.top()->arrival_time()) {
       // Deliver this packet.
-      NetworkPacket* packet = delay_link_.front();
-      packets_to_deliver.push(packet);
+      NetworkPacket* packet = delay_link_.top();
+      packets_to_deliver.push_back(packet);
       delay_link_.pop();
       // |time_now| might be later than when the packet should have arrived, due
       // to NetworkProcess being called too late. For stats, use the time it
@@ -200,20 +222,116 @@ void FakeNetworkPipe::Process() {
     }
     sent_packets_ += packets_to_deliver.size();
   }
-  while (!packets_to_deliver.empty()) {
-    NetworkPacket* packet = packets_to_deliver.front();
-    packets_to_deliver.pop();
-    packet_receiver_->DeliverPacket(packet->data(), packet->data_length());
-    delete packet;
+  for (size_t i = 0; i < packets_to_deliver.size(); ++i) {
+    packet_receiver_->DeliverPacket(packets_to_deliver[i]->data(),
+                                    packets_to_deliver[i]->data_length());
   }
+  if (packets_to_deliver.empty())
+    return;
+  CriticalSectionScoped crit(lock_.get());
+  for (size_t i = 0; i < packets_to_deliver.size(); ++i)
+    FreePacket(packets_to_deliver[i]);
 }
 
 int FakeNetworkPipe::TimeUntilNextProcess() const {
   CriticalSectionScoped crit(lock_.get());
-  if (capacity_link_.size() == 0 || delay_link_.size() == 0)
+  if (active_flows_.empty() && delay_link_.empty())
     return kDefaultProcessIntervalMs;
-  return std::max(static_cast<int>(next_process_time_ -
+  int64_t next_process_time = link_free_time_;
+  if (!delay_link_.empty() &&
+      (active_flows_.empty() ||
+       delay_link_.top()->arrival_time() < next_process_time)) {
+    next_process_time = delay_link_.top()->arrival_time();
+  }
+  return std::max(static_cast<int>(next_process_time -
       TickTime::MillisecondTimestamp()), 0);
 }
 
+void FakeNetworkPipe::TransmitPackets(int64_t time_now) {
+  // All the waiting packets were sent before |link_free_time_|, so the link
+  // can take the next one as soon as it's free.
+  while (!active_flows_.empty() && link_free_time_ <= time_now) {
+    Flow* flow = active_flows_.front();
+    active_flows_.pop_front();
+    NetworkPacket* packet = flow->packets.front();
+    flow->packets.pop_front();
+    if (!flow->packets.empty())
+      active_flows_.push_back(flow);
+
+    link_free_time_ += packet->transmit_time();
+    flow->transmit_end_time = link_free_time_;
+    packet->set_arrival_time(link_free_time_);
+
+    // Packets are randomly dropped after being affected by the bottleneck.
+    if (LosePacket()) {
+      FreePacket(packet);
+      continue;
+    }
+
+    // Add extra delay and jitter. Unless reordering is allowed, make sure the
+    // arrival time is not earlier than the last packet sent before it.
+    int extra_delay = GaussianRandom(config_.queue_delay_ms,
+                                     config_.delay_standard_deviation_ms);
+    packet->IncrementArrivalTime(extra_delay);
+    if (!config_.allow_reordering) {
+      if (packet->arrival_time() < last_arrival_time_)
+        packet->set_arrival_time(last_arrival_time_);
+      last_arrival_time_ = packet->arrival_time();
+    }
+    delay_link_.push(packet);
+  }
+}
+
+bool FakeNetworkPipe::LosePacket() {
+  if (config_.avg_burst_loss_length <= 1 || config_.loss_percent >= 100)
+    return UniformLoss(config_.loss_percent);
+  if (config_.loss_percent <= 0)
+    return false;
+
+  // Gilbert-Elliott model, losing all the packets in the bad state. A burst
+  // ends with probability 1 / |avg_burst_loss_length|, and starts often enough
+  // to lose |loss_percent| of the packets.
+  const double loss_rate = config_.loss_percent / 100.0;
+  const double prob_burst_end = 1.0 / config_.avg_burst_loss_length;
+  const double prob_burst_start =
+      prob_burst_end * loss_rate / (1.0 - loss_rate);
+  if (bursting_)
+    bursting_ = UniformRandom() >= prob_burst_end;
+  else
+    bursting_ = UniformRandom() < prob_burst_start;
+  return bursting_;
+}
+
+int FakeNetworkPipe::LinkCapacityKbps(int64_t time_now) const {
+  if (config_.capacity_trace_kbps.empty() ||
+      config_.capacity_trace_interval_ms <= 0) {
+    return config_.link_capacity_kbps;
+  }
+  const int64_t step = (time_now - config_time_) /
+                       config_.capacity_trace_interval_ms;
+  return config_.capacity_trace_kbps[step % config_.capacity_trace_kbps.size()];
+}
+
+NetworkPacket* FakeNetworkPipe::AllocatePacket(const uint8_t* data,
+                                               size_t length,
+                                               int64_t send_time,
+                                               int64_t transmit_time) {
+  NetworkPacket* packet;
+  if (free_packets_.empty()) {
+    packet = new NetworkPacket();
+  } else {
+    packet = free_packets_.back();
+    free_packets_.pop_back();
+  }
+  packet->Set(data, length, send_time, transmit_time, next_packet_id_++);
+  return packet;
+}
+
+void FakeNetworkPipe::FreePacket(NetworkPacket* packet) {
+  if (free_packets_.size() < kMaxFreePackets)
+    free_packets_.push_back(packet);
+  else
+    delete packet;
+}
+
 }  // namespace webrtc
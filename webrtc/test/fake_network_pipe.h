@@ -11,7 +11,10 @@
 #ifndef WEBRTC_TEST_FAKE_NETWORK_PIPE_H_
 #define WEBRTC_TEST_FAKE_NETWORK_PIPE_H_
 
+#include <deque>
+#include <map>
 #include <queue>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
@@ -27,8 +30,10 @@ class PacketReceiver;
 // Class faking a network link. This is a simple and naive solution just faking
 // capacity and adding an extra transport delay in addition to the capacity
 // introduced delay.
-
-// TODO(mflodman) Add random and bursty packet loss.
+//
+// Packets can be sent on separate flows, each with its own queue. The flows
+// share the link capacity and are served round robin, so that a flow sending
+// bursts doesn't delay the packets of the other flows more than its share.
 class FakeNetworkPipe {
  public:
   struct Config {
@@ -37,9 +42,12 @@ class FakeNetworkPipe {
           queue_delay_ms(0),
           delay_standard_deviation_ms(0),
           link_capacity_kbps(0),
-          loss_percent(0) {
+          loss_percent(0),
+          avg_burst_loss_length(0),
+          allow_reordering(false),
+          capacity_trace_interval_ms(0) {
     }
-    // Queue length in number of packets.
+    // Queue length in number of packets, per flow.
     size_t queue_length_packets;
     // Delay in addition to capacity induced delay.
     int queue_delay_ms;
@@ -49,6 +57,18 @@ class FakeNetworkPipe {
     int link_capacity_kbps;
     // Random packet loss.
     int loss_percent;
+    // Average number of packets lost in a row. If larger than 1, the losses
+    // come in bursts following a Gilbert-Elliott model, still averaging
+    // |loss_percent|.
+    int avg_burst_loss_length;
+    // If true, the extra delay of each packet is independent of the packets
+    // before it, so packets can be reordered.
+    bool allow_reordering;
+    // If not empty, the link capacity steps through these values, looping,
+    // every |capacity_trace_interval_ms| instead of using
+    // |link_capacity_kbps|. The trace starts when the config is set.
+    std::vector<int> capacity_trace_kbps;
+    int capacity_trace_interval_ms;
   };
 
   explicit FakeNetworkPipe(const FakeNetworkPipe::Config& config);
@@ -60,8 +80,11 @@ class FakeNetworkPipe {
   // Sets a new configuration. This won't affect packets already in the pipe.
   void SetConfig(const FakeNetworkPipe::Config& config);
 
-  // Sends a new packet to the link.
+  // Sends a new packet to the link, on flow 0.
   void SendPacket(const uint8_t* packet, size_t packet_length);
+  // Sends a new packet to the link on its own flow, e.g. one per SSRC.
+  void SendPacket(const uint8_t* packet, size_t packet_length,
+                  uint32_t flow_id);
 
   // Processes the network queues and trigger PacketReceiver::IncomingPacket for
   // packets ready to be delivered.
@@ -75,21 +98,56 @@ class FakeNetworkPipe {
   size_t sent_packets() { return sent_packets_; }
 
  private:
+  struct Flow {
+    Flow() : transmit_end_time(0) {}
+
+    std::deque<NetworkPacket*> packets;
+    // When the last packet taken from this flow has been transmitted.
+    int64_t transmit_end_time;
+  };
+
+  // Orders the delay link by arrival time, and by send order for packets
+  // arriving at the same time.
+  struct ArrivesLater {
+    bool operator()(const NetworkPacket* a, const NetworkPacket* b) const;
+  };
+
+  // Moves the packets whose transmission starts at or before |time_now| from
+  // the flows to the delay link.
+  void TransmitPackets(int64_t time_now);
+  bool LosePacket();
+  int LinkCapacityKbps(int64_t time_now) const;
+
+  NetworkPacket* AllocatePacket(const uint8_t* data, size_t length,
+                                int64_t send_time, int64_t transmit_time);
+  void FreePacket(NetworkPacket* packet);
+
   scoped_ptr<CriticalSectionWrapper> lock_;
   PacketReceiver* packet_receiver_;
-  std::queue<NetworkPacket*> capacity_link_;
-  std::queue<NetworkPacket*> delay_link_;
+  std::map<uint32_t, Flow> flows_;
+  // The flows with packets waiting, in round robin order.
+  std::deque<Flow*> active_flows_;
+  // When the link is done transmitting the packets taken from the flows.
+  int64_t link_free_time_;
+  // Without reordering, no packet arrives before this time.
+  int64_t last_arrival_time_;
+  std::priority_queue<NetworkPacket*, std::vector<NetworkPacket*>, ArrivesLater>
+      delay_link_;
+  // Packets kept for reuse, so that sending doesn't allocate.
+  std::vector<NetworkPacket*> free_packets_;
+  uint64_t next_packet_id_;
 
   // Link configuration.
   Config config_;
+  int64_t config_time_;
+  // True while losing a burst of packets.
+  bool bursting_;
 
   // Statistics.
   size_t dropped_packets_;
   size_t sent_packets_;
   int total_packet_delay_;
 
-  int64_t next_process_time_;
-
   DISALLOW_COPY_AND_ASSIGN(FakeNetworkPipe);
 };
 
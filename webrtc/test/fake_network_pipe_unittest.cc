@@ -8,6 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdlib.h>
+
+#include <vector>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -36,6 +40,22 @@ class MockReceiver : public PacketReceiver {
   MOCK_METHOD2(DeliverPacket, DeliveryStatus(const uint8_t*, size_t));
 };
 
+// Records the first two bytes of the delivered packets, used as sequence
+// numbers.
+class SequenceRecorder : public PacketReceiver {
+ public:
+  virtual DeliveryStatus DeliverPacket(const uint8_t* packet,
+                                       size_t length) OVERRIDE {
+    sequence_numbers_.push_back(packet[0] << 8 | packet[1]);
+    return DELIVERY_OK;
+  }
+
+  const std::vector<int>& sequence_numbers() const { return sequence_numbers_; }
+
+ private:
+  std::vector<int> sequence_numbers_;
+};
+
 class FakeNetworkPipeTest : public ::testing::Test {
  protected:
   virtual void SetUp() {
@@ -53,6 +73,17 @@ class FakeNetworkPipeTest : public ::testing::Test {
     }
   }
 
+  void SendSequencedPackets(FakeNetworkPipe* pipe, int first_sequence_number,
+                            int number_packets, int packet_size,
+                            uint32_t flow_id) {
+    std::vector<uint8_t> packet(packet_size);
+    for (int i = 0; i < number_packets; ++i) {
+      packet[0] = static_cast<uint8_t>((first_sequence_number + i) >> 8);
+      packet[1] = static_cast<uint8_t>(first_sequence_number + i);
+      pipe->SendPacket(&packet[0], packet_size, flow_id);
+    }
+  }
+
   int PacketTimeMs(int capacity_kbps, int kPacketSize) const {
     return 8 * kPacketSize / capacity_kbps;
   }
@@ -303,4 +334,131 @@ TEST_F(FakeNetworkPipeTest, ChangingCapacityWithPacketsInPipeTest) {
   EXPECT_CALL(*receiver_, DeliverPacket(_, _)).Times(0);
   pipe->Process();
 }
+
+// Verify that a flow sending a burst doesn't hold back the packets of another
+// flow sharing the link.
+TEST_F(FakeNetworkPipeTest, FlowsShareCapacityTest) {
+  FakeNetworkPipe::Config config;
+  config.link_capacity_kbps = 80;
+  scoped_ptr<FakeNetworkPipe> pipe(new FakeNetworkPipe(config));
+  SequenceRecorder recorder;
+  pipe->SetReceiver(&recorder);
+
+  const int kPacketSize = 1000;
+  const int kPacketTimeMs = PacketTimeMs(config.link_capacity_kbps,
+                                         kPacketSize);
+  SendSequencedPackets(pipe.get(), 0, 10, kPacketSize, 1);
+  SendSequencedPackets(pipe.get(), 100, 1, kPacketSize, 2);
+
+  // The packet of the second flow takes turns with the burst, instead of
+  // waiting for all of it.
+  TickTime::AdvanceFakeClock(3 * kPacketTimeMs);
+  pipe->Process();
+  ASSERT_EQ(3u, recorder.sequence_numbers().size());
+  EXPECT_EQ(0, recorder.sequence_numbers()[0]);
+  EXPECT_EQ(1, recorder.sequence_numbers()[1]);
+  EXPECT_EQ(100, recorder.sequence_numbers()[2]);
+
+  TickTime::AdvanceFakeClock(8 * kPacketTimeMs);
+  pipe->Process();
+  EXPECT_EQ(11u, recorder.sequence_numbers().size());
+}
+
+// Verify that bursty loss keeps the average loss, and loses packets in bursts
+// of about the configured length.
+TEST_F(FakeNetworkPipeTest, BurstLossTest) {
+  FakeNetworkPipe::Config config;
+  config.loss_percent = 10;
+  config.avg_burst_loss_length = 5;
+  scoped_ptr<FakeNetworkPipe> pipe(new FakeNetworkPipe(config));
+  SequenceRecorder recorder;
+  pipe->SetReceiver(&recorder);
+
+  // The pipe draws its losses from rand().
+  srand(42);
+  const int kNumPackets = 10000;
+  SendSequencedPackets(pipe.get(), 0, kNumPackets, 100, 0);
+  pipe->Process();
+
+  const std::vector<int>& received = recorder.sequence_numbers();
+  const int lost_packets = kNumPackets - static_cast<int>(received.size());
+  int bursts = 0;
+  int expected_sequence_number = 0;
+  for (size_t i = 0; i < received.size(); ++i) {
+    if (received[i] != expected_sequence_number)
+      ++bursts;
+    expected_sequence_number = received[i] + 1;
+  }
+  if (expected_sequence_number != kNumPackets)
+    ++bursts;
+  ASSERT_GT(bursts, 0);
+  // With these settings the number of lost packets has a standard deviation
+  // of about 85 and the average burst length of about 0.32, so the bounds
+  // are about six standard deviations wide.
+  EXPECT_NEAR(kNumPackets * config.loss_percent / 100, lost_packets,
+              kNumPackets / 20);
+  EXPECT_NEAR(config.avg_burst_loss_length,
+              static_cast<double>(lost_packets) / bursts, 2.0);
+}
+
+// Verify that jitter only reorders packets when allowed to.
+TEST_F(FakeNetworkPipeTest, ReorderingTest) {
+  FakeNetworkPipe::Config config;
+  config.queue_delay_ms = 100;
+  config.delay_standard_deviation_ms = 50;
+  const int kNumPackets = 100;
+  for (int allow_reordering = 0; allow_reordering <= 1; ++allow_reordering) {
+    config.allow_reordering = allow_reordering != 0;
+    scoped_ptr<FakeNetworkPipe> pipe(new FakeNetworkPipe(config));
+    SequenceRecorder recorder;
+    pipe->SetReceiver(&recorder);
+
+    for (int i = 0; i < kNumPackets; ++i) {
+      SendSequencedPackets(pipe.get(), i, 1, 100, 0);
+      TickTime::AdvanceFakeClock(1);
+    }
+    TickTime::AdvanceFakeClock(1000);
+    pipe->Process();
+
+    const std::vector<int>& received = recorder.sequence_numbers();
+    ASSERT_EQ(static_cast<size_t>(kNumPackets), received.size());
+    int reordered_packets = 0;
+    for (size_t i = 1; i < received.size(); ++i) {
+      if (received[i] < received[i - 1])
+        ++reordered_packets;
+    }
+    if (config.allow_reordering)
+      EXPECT_GT(reordered_packets, 0);
+    else
+      EXPECT_EQ(0, reordered_packets);
+  }
+}
+
+// Verify that the link capacity follows the capacity trace.
+TEST_F(FakeNetworkPipeTest, CapacityTraceTest) {
+  FakeNetworkPipe::Config config;
+  config.capacity_trace_kbps.push_back(80);
+  config.capacity_trace_kbps.push_back(160);
+  config.capacity_trace_interval_ms = 1000;
+  scoped_ptr<FakeNetworkPipe> pipe(new FakeNetworkPipe(config));
+  pipe->SetReceiver(receiver_.get());
+
+  const int kPacketSize = 1000;
+  for (int i = 0; i < 3; ++i) {
+    const int capacity_kbps = config.capacity_trace_kbps[i % 2];
+    const int packet_time_ms = PacketTimeMs(capacity_kbps, kPacketSize);
+    SendPackets(pipe.get(), 1, kPacketSize);
+
+    TickTime::AdvanceFakeClock(packet_time_ms - 1);
+    EXPECT_CALL(*receiver_, DeliverPacket(_, _)).Times(0);
+    pipe->Process();
+
+    TickTime::AdvanceFakeClock(1);
+    EXPECT_CALL(*receiver_, DeliverPacket(_, _)).Times(1);
+    pipe->Process();
+
+    TickTime::AdvanceFakeClock(config.capacity_trace_interval_ms -
+                               packet_time_ms);
+  }
+}
 }  // namespace webrtc
@@ -14,6 +14,9 @@
 #include <string.h>
 
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/test/testsupport/mapped_file.h"
 
 namespace webrtc {
 namespace test {
@@ -100,8 +103,74 @@ class YuvFileGenerator : public FrameGenerator {
   uint8_t* frame_buffer_;
   I420VideoFrame frame_;
 };
+
+class YuvClipGenerator : public FrameGenerator {
+ public:
+  YuvClipGenerator(const YuvClip* clip, int fps, Clock* clock)
+      : clip_(clip), fps_(fps), clock_(clock), start_time_ms_(-1) {
+    assert(clip);
+    assert(fps > 0);
+    assert(clock);
+  }
+
+  virtual I420VideoFrame* NextFrame() OVERRIDE {
+    int64_t now_ms = clock_->TimeInMilliseconds();
+    if (start_time_ms_ == -1)
+      start_time_ms_ = now_ms;
+    // Round to the nearest frame, so that a tick which is a little early
+    // doesn't repeat the previous frame.
+    int64_t index = ((now_ms - start_time_ms_) * fps_ + 500) / 1000;
+    // Shares the pixel data of the clip.
+    frame_.CopyFrame(
+        clip_->frame(static_cast<size_t>(index % clip_->num_frames())));
+    return &frame_;
+  }
+
+ private:
+  const YuvClip* const clip_;
+  const int fps_;
+  Clock* const clock_;
+  int64_t start_time_ms_;
+  I420VideoFrame frame_;
+};
 }  // namespace
 
+YuvClip::YuvClip() {}
+
+YuvClip::~YuvClip() {}
+
+YuvClip* YuvClip::Create(const char* file, size_t width, size_t height) {
+  assert(width > 0);
+  assert(height > 0);
+  MappedFile mapped_file;
+  if (!mapped_file.Open(file))
+    return NULL;
+
+  const int w = static_cast<int>(width);
+  const int h = static_cast<int>(height);
+  const int half_width = (w + 1) / 2;
+  const int size_y = w * h;
+  const int size_uv = half_width * ((h + 1) / 2);
+  const size_t frame_size = static_cast<size_t>(size_y + 2 * size_uv);
+
+  scoped_ptr<YuvClip> clip(new YuvClip());
+  for (size_t offset = 0; offset + frame_size <= mapped_file.size();
+       offset += frame_size) {
+    const uint8_t* buffer_y = mapped_file.data() + offset;
+    const uint8_t* buffer_u = buffer_y + size_y;
+    const uint8_t* buffer_v = buffer_u + size_uv;
+    I420VideoFrame* frame = new I420VideoFrame();
+    clip->frames_.push_back(frame);
+    if (frame->CreateFrame(size_y, buffer_y, size_uv, buffer_u, size_uv,
+                           buffer_v, w, h, w, half_width, half_width) != 0) {
+      return NULL;
+    }
+  }
+  if (clip->frames_.empty())
+    return NULL;
+  return clip.release();
+}
+
 FrameGenerator* FrameGenerator::Create(size_t width, size_t height) {
   return new ChromaGenerator(width, height);
 }
@@ -114,5 +183,11 @@ FrameGenerator* FrameGenerator::CreateFromYuvFile(const char* file,
   return new YuvFileGenerator(file_handle, width, height);
 }
 
+FrameGenerator* FrameGenerator::CreateFromYuvClip(const YuvClip* clip,
+                                                  int fps,
+                                                  Clock* clock) {
+  return new YuvClipGenerator(clip, fps, clock);
+}
+
 }  // namespace test
 }  // namespace webrtc
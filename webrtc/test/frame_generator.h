@@ -10,12 +10,36 @@
 #ifndef WEBRTC_COMMON_VIDEO_TEST_FRAME_GENERATOR_H_
 #define WEBRTC_COMMON_VIDEO_TEST_FRAME_GENERATOR_H_
 
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
+class Clock;
+
 namespace test {
 
+// A clip of I420 frames read once from a memory-mapped file. The frames
+// generated from a clip share its pixel data, so any number of streams can
+// play one clip without reading, converting or copying a frame.
+class YuvClip {
+ public:
+  // Returns NULL if |file| holds no complete |width| x |height| frame.
+  static YuvClip* Create(const char* file, size_t width, size_t height);
+  ~YuvClip();
+
+  size_t num_frames() const { return frames_.size(); }
+  const I420VideoFrame& frame(size_t index) const { return *frames_[index]; }
+
+ private:
+  YuvClip();
+
+  ScopedVector<I420VideoFrame> frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(YuvClip);
+};
+
 class FrameGenerator {
  public:
   FrameGenerator() {}
@@ -28,6 +52,12 @@ class FrameGenerator {
   static FrameGenerator* CreateFromYuvFile(const char* file,
                                            size_t width,
                                            size_t height);
+  // Plays |clip| at |fps| frames per second of |clock|, starting with the
+  // first frame at the first NextFrame(). Frames are skipped or repeated to
+  // keep the clip in step with the clock. |clip| must outlive the generator.
+  static FrameGenerator* CreateFromYuvClip(const YuvClip* clip,
+                                           int fps,
+                                           Clock* clock);
 };
 }  // namespace test
 }  // namespace webrtc
@@ -57,6 +57,24 @@ FrameGeneratorCapturer* FrameGeneratorCapturer::CreateFromYuvFile(
   return capturer;
 }
 
+FrameGeneratorCapturer* FrameGeneratorCapturer::CreateFromYuvClip(
+    VideoSendStreamInput* input,
+    const YuvClip* clip,
+    int target_fps,
+    Clock* clock) {
+  FrameGeneratorCapturer* capturer = new FrameGeneratorCapturer(
+      clock,
+      input,
+      FrameGenerator::CreateFromYuvClip(clip, target_fps, clock),
+      target_fps);
+  if (!capturer->Init()) {
+    delete capturer;
+    return NULL;
+  }
+
+  return capturer;
+}
+
 FrameGeneratorCapturer::FrameGeneratorCapturer(Clock* clock,
                                                VideoSendStreamInput* input,
                                                FrameGenerator* frame_generator,
@@ -23,6 +23,7 @@ class ThreadWrapper;
 namespace test {
 
 class FrameGenerator;
+class YuvClip;
 
 class FrameGeneratorCapturer : public VideoCapturer {
  public:
@@ -38,6 +39,12 @@ class FrameGeneratorCapturer : public VideoCapturer {
                                                    size_t height,
                                                    int target_fps,
                                                    Clock* clock);
+
+  // Plays |clip| by reference, see FrameGenerator::CreateFromYuvClip().
+  static FrameGeneratorCapturer* CreateFromYuvClip(VideoSendStreamInput* input,
+                                                   const YuvClip* clip,
+                                                   int target_fps,
+                                                   Clock* clock);
   virtual ~FrameGeneratorCapturer();
 
   virtual void Start() OVERRIDE;
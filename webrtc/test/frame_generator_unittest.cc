@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/test/frame_generator.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+namespace test {
+
+static const int kWidth = 4;
+static const int kHeight = 4;
+static const int kFrameSize = kWidth * kHeight * 3 / 2;
+static const int kNumFrames = 3;
+static const int kFps = 10;
+
+class YuvClipTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    file_name_ = TempFilename(OutputPath(), "yuv_clip_test");
+    FILE* file = fopen(file_name_.c_str(), "wb");
+    ASSERT_TRUE(file != NULL);
+    // Every frame is filled with its index, followed by half a frame which
+    // is to be ignored.
+    uint8_t buffer[kFrameSize];
+    for (int i = 0; i < kNumFrames; ++i) {
+      memset(buffer, i, kFrameSize);
+      fwrite(buffer, 1, kFrameSize, file);
+    }
+    fwrite(buffer, 1, kFrameSize / 2, file);
+    fclose(file);
+  }
+
+  virtual void TearDown() { remove(file_name_.c_str()); }
+
+  std::string file_name_;
+};
+
+TEST_F(YuvClipTest, ReadsCompleteFrames) {
+  scoped_ptr<YuvClip> clip(YuvClip::Create(file_name_.c_str(), kWidth,
+                                           kHeight));
+  ASSERT_TRUE(clip.get() != NULL);
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), clip->num_frames());
+  for (int i = 0; i < kNumFrames; ++i) {
+    const I420VideoFrame& frame = clip->frame(i);
+    EXPECT_EQ(kWidth, frame.width());
+    EXPECT_EQ(kHeight, frame.height());
+    EXPECT_EQ(i, frame.buffer(kYPlane)[0]);
+    EXPECT_EQ(i, frame.buffer(kVPlane)[kWidth * kHeight / 4 - 1]);
+  }
+}
+
+TEST_F(YuvClipTest, CreateFailsWithoutFrames) {
+  EXPECT_TRUE(YuvClip::Create(file_name_.c_str(), 640, 480) == NULL);
+  EXPECT_TRUE(YuvClip::Create("no_such_file.yuv", kWidth, kHeight) == NULL);
+}
+
+TEST_F(YuvClipTest, GeneratorFollowsClockAndSharesPixels) {
+  scoped_ptr<YuvClip> clip(YuvClip::Create(file_name_.c_str(), kWidth,
+                                           kHeight));
+  ASSERT_TRUE(clip.get() != NULL);
+  SimulatedClock clock(1000);
+  scoped_ptr<FrameGenerator> generator(
+      FrameGenerator::CreateFromYuvClip(clip.get(), kFps, &clock));
+
+  const I420VideoFrame* frame = generator->NextFrame();
+  EXPECT_EQ(clip->frame(0).buffer(kYPlane), frame->buffer(kYPlane));
+  clock.AdvanceTimeMilliseconds(1000 / kFps);
+  frame = generator->NextFrame();
+  EXPECT_EQ(clip->frame(1).buffer(kYPlane), frame->buffer(kYPlane));
+  // A late tick skips a frame, and the clip wraps around.
+  clock.AdvanceTimeMilliseconds(2 * 1000 / kFps);
+  frame = generator->NextFrame();
+  EXPECT_EQ(clip->frame(0).buffer(kUPlane), frame->buffer(kUPlane));
+  // A tick which is a little early doesn't repeat the frame.
+  clock.AdvanceTimeMilliseconds(1000 / kFps - 10);
+  frame = generator->NextFrame();
+  EXPECT_EQ(clip->frame(1).buffer(kVPlane), frame->buffer(kVPlane));
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,217 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+#
+# Use of this source code is governed by a BSD-style license
+# that can be found in the LICENSE file in the root of the source
+# tree. An additional intellectual property rights grant can be found
+# in the file PATENTS.  All contributing project authors may
+# be found in the AUTHORS file in the root of the source tree.
+
+
+"""Script to run the tests of a perf test binary in parallel.
+
+The tests are run one per process, like third_party/gtest-parallel does for
+unit tests. The CPUs are split into disjoint sets, one per shard, and each
+shard runs its tests one at a time pinned to its CPUs with taskset on Linux,
+so that tests running at the same time don't compete for the same cores.
+
+Tests matching --exclusive_filter (e.g. tests using real devices or fixed
+ports) are run after the others, one at a time, on all CPUs.
+
+The perf results (RESULT lines) of all tests are printed together at the end,
+in test order, in the format tools/perf and the perf bots read. They are also
+written to --output if given.
+
+Example:
+  run_perf_tests.py --cpus_per_shard=4 out/Release/webrtc_perf_tests
+"""
+
+import fnmatch
+import multiprocessing
+import optparse
+import os
+import subprocess
+import sys
+import threading
+import time
+
+try:
+  import Queue as queue
+except ImportError:
+  import queue
+
+
+def _ParseArgs():
+  """Registers the command-line options."""
+  usage = 'usage: %prog [options] executable [-- test arguments]'
+  parser = optparse.OptionParser(usage=usage)
+  parser.add_option('--cpus_per_shard', type='int', default=2,
+                    help=('Number of CPUs each shard is pinned to. '
+                          'Default: %default'))
+  parser.add_option('--shards', type='int', default=0,
+                    help=('Number of shards. Default: as many as there are '
+                          'CPU sets of --cpus_per_shard CPUs.'))
+  parser.add_option('--gtest_filter', type='string', default='',
+                    help='Filter for the tests to run.')
+  parser.add_option('--exclusive_filter', type='string', default='',
+                    help=('Colon-separated gtest patterns of tests that must '
+                          'not run at the same time as any other test.'))
+  parser.add_option('--output', type='string', default='',
+                    help='File to write the merged perf results to.')
+  options, args = parser.parse_args()
+  if not args:
+    parser.error('The test executable is missing.')
+  if options.cpus_per_shard < 1:
+    parser.error('--cpus_per_shard must be at least 1.')
+  return options, args[0], args[1:]
+
+
+def _AvailableCpus():
+  """Returns the CPUs this process may run on."""
+  if hasattr(os, 'sched_getaffinity'):
+    return sorted(os.sched_getaffinity(0))
+  return range(multiprocessing.cpu_count())
+
+
+def _PinnedCommand(command, cpus):
+  """Returns |command| pinned to |cpus|, if the platform supports it.
+
+  taskset sets the affinity before executing the test, so no code has to run
+  in the forked child, which is not safe while the other shards' threads run.
+  """
+  if not sys.platform.startswith('linux'):
+    return command
+  return ['taskset', '-c', ','.join(str(cpu) for cpu in cpus)] + command
+
+
+def _CpuSets(cpus, cpus_per_shard, shards):
+  """Splits |cpus| into disjoint sets of |cpus_per_shard| CPUs."""
+  num_sets = max(1, len(cpus) // cpus_per_shard)
+  if shards > 0:
+    num_sets = min(num_sets, shards)
+  return [cpus[i * cpus_per_shard:(i + 1) * cpus_per_shard]
+          for i in range(num_sets)]
+
+
+def _ListTests(binary, gtest_filter, test_args):
+  """Returns the tests of |binary| that match |gtest_filter|."""
+  command = [binary, '--gtest_list_tests'] + test_args
+  if gtest_filter:
+    command.append('--gtest_filter=' + gtest_filter)
+  test_list = subprocess.Popen(command, stdout=subprocess.PIPE,
+                               universal_newlines=True).communicate()[0]
+  tests = []
+  test_case = ''
+  for line in test_list.split('\n'):
+    if not line.strip():
+      continue
+    if line[0] != ' ':
+      test_case = line.split()[0]
+      continue
+    test = test_case + line.split()[0]
+    if 'DISABLED_' not in test:
+      tests.append(test)
+  return tests
+
+
+def _MatchesFilter(test, patterns):
+  return any(fnmatch.fnmatchcase(test, pattern)
+             for pattern in patterns.split(':') if pattern)
+
+
+class _TestRun(object):
+  def __init__(self, test):
+    self.test = test
+    self.exit_code = None
+    self.output = []
+    self.time_ms = 0
+
+
+def _RunTest(binary, test_args, run, cpus):
+  command = _PinnedCommand([binary, '--gtest_filter=' + run.test] + test_args,
+                           cpus)
+  begin = time.time()
+  process = subprocess.Popen(command, stdout=subprocess.PIPE,
+                             stderr=subprocess.STDOUT,
+                             universal_newlines=True)
+  run.output = process.communicate()[0].splitlines()
+  run.exit_code = process.returncode
+  run.time_ms = int(1000 * (time.time() - begin))
+
+
+def _RunShards(binary, test_args, runs, cpu_sets, log):
+  """Runs |runs| on |cpu_sets|, one test per CPU set at a time."""
+  run_queue = queue.Queue()
+  for run in runs:
+    run_queue.put(run)
+
+  def Shard(cpus):
+    while True:
+      try:
+        run = run_queue.get_nowait()
+      except queue.Empty:
+        return
+      _RunTest(binary, test_args, run, cpus)
+      log(run, cpus)
+
+  threads = [threading.Thread(target=Shard, args=(cpus,))
+             for cpus in cpu_sets]
+  for thread in threads:
+    thread.start()
+  for thread in threads:
+    thread.join()
+
+
+def main():
+  options, binary, test_args = _ParseArgs()
+
+  cpus = _AvailableCpus()
+  cpu_sets = _CpuSets(cpus, options.cpus_per_shard, options.shards)
+  tests = _ListTests(binary, options.gtest_filter, test_args)
+  runs = [_TestRun(test) for test in tests]
+  parallel_runs = [run for run in runs
+                   if not _MatchesFilter(run.test, options.exclusive_filter)]
+  exclusive_runs = [run for run in runs
+                    if _MatchesFilter(run.test, options.exclusive_filter)]
+
+  print_lock = threading.Lock()
+  finished = [0]
+  def Log(run, cpus):
+    with print_lock:
+      finished[0] += 1
+      cpu_list = ','.join(str(cpu) for cpu in cpus)
+      sys.stdout.write('[%d/%d] %s (%d ms, CPUs %s)%s\n' % (
+          finished[0], len(runs), run.test, run.time_ms, cpu_list,
+          '' if run.exit_code == 0 else ' FAILED'))
+      if run.exit_code != 0:
+        sys.stdout.write('\n'.join(run.output) + '\n')
+      sys.stdout.flush()
+
+  sys.stdout.write('Running %d tests on %d shards of %d CPUs, and %d tests '
+                   'alone.\n' % (len(parallel_runs), len(cpu_sets),
+                                 len(cpu_sets[0]), len(exclusive_runs)))
+  _RunShards(binary, test_args, parallel_runs, cpu_sets, Log)
+  _RunShards(binary, test_args, exclusive_runs, [cpus], Log)
+
+  # Merge the results, in test order.
+  results = []
+  for run in runs:
+    results += [line for line in run.output
+                if line.lstrip('*').startswith('RESULT ')]
+  sys.stdout.write('\n'.join(results) + '\n')
+  if options.output:
+    with open(options.output, 'w') as output:
+      output.write('\n'.join(results) + '\n')
+
+  failures = [run.test for run in runs if run.exit_code != 0]
+  if failures:
+    sys.stdout.write('FAILED TESTS (%d/%d):\n' % (len(failures), len(runs)))
+    for test in failures:
+      sys.stdout.write('  %s\n' % test)
+    return 1
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
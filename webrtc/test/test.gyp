@@ -49,6 +49,7 @@
         'frame_generator.h',
       ],
       'dependencies': [
+        'test_support',
         '<(webrtc_root)/common_video/common_video.gyp:common_video',
       ],
     },
@@ -84,6 +85,7 @@
         'field_trial',
         '<(DEPTH)/testing/gtest.gyp:gtest',
         '<(DEPTH)/third_party/gflags/gflags.gyp:gflags',
+        '<(webrtc_root)/system_wrappers/source/system_wrappers.gyp:system_wrappers',
       ],
     },
     {
@@ -99,12 +101,15 @@
         'testsupport/android/root_path_android_chromium.cc',
         'testsupport/fileutils.cc',
         'testsupport/fileutils.h',
+        'testsupport/frame_pair_pool.h',
         'testsupport/frame_reader.cc',
         'testsupport/frame_reader.h',
         'testsupport/frame_writer.cc',
         'testsupport/frame_writer.h',
         'testsupport/gtest_prod_util.h',
         'testsupport/gtest_disable.h',
+        'testsupport/mapped_file.cc',
+        'testsupport/mapped_file.h',
         'testsupport/mock/mock_frame_reader.h',
         'testsupport/mock/mock_frame_writer.h',
         'testsupport/packet_reader.cc',
@@ -171,6 +176,7 @@
       'type': '<(gtest_target_type)',
       'dependencies': [
         'channel_transport',
+        'frame_generator',
         'test_support_main',
         '<(DEPTH)/testing/gmock.gyp:gmock',
         '<(DEPTH)/testing/gtest.gyp:gtest',
@@ -179,6 +185,7 @@
         'channel_transport/udp_transport_unittest.cc',
         'channel_transport/udp_socket_manager_unittest.cc',
         'channel_transport/udp_socket_wrapper_unittest.cc',
+        'frame_generator_unittest.cc',
         'testsupport/unittest_utils.h',
         'testsupport/fileutils_unittest.cc',
         'testsupport/frame_reader_unittest.cc',
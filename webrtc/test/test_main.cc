@@ -10,6 +10,8 @@
 
 #include "gflags/gflags.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/lockprofiler.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/test/field_trial.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
@@ -17,6 +19,10 @@ DEFINE_string(force_fieldtrials, "",
     "Field trials control experimental feature code which can be forced. "
     "E.g. running with --force_fieldtrials=WebRTC-FooFeature/Enable/"
     " will assign the group Enable to field trial WebRTC-FooFeature.");
+DEFINE_int32(time_scale, 1,
+    "Runs time this many times faster than real time, so that long tests "
+    "such as ramp-up tests finish sooner. Only use this with tests whose work "
+    "takes little real time, e.g. those using the fake encoder and decoder.");
 
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -28,5 +34,11 @@ int main(int argc, char* argv[]) {
 
   webrtc::test::SetExecutablePath(argv[0]);
   webrtc::test::InitFieldTrialsFromString(FLAGS_force_fieldtrials);
-  return RUN_ALL_TESTS();
+  if (FLAGS_time_scale > 1)
+    webrtc::TickTime::SetTimeScale(FLAGS_time_scale);
+  const int result = RUN_ALL_TESTS();
+#if defined(WEBRTC_LOCK_PROFILING)
+  rtc::LockProfiler::PrintReport(stdout, 20);
+#endif
+  return result;
 }
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_TEST_TESTSUPPORT_FRAME_PAIR_POOL_H_
+#define WEBRTC_TEST_TESTSUPPORT_FRAME_PAIR_POOL_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+
+namespace webrtc {
+namespace test {
+
+// Buffers for the reference and test frames being compared on a thread pool.
+// The frames are read by the calling thread, which takes a free pair, fills it
+// and posts a task that returns it once done. A few pairs per thread let the
+// reading run ahead of the comparisons while bounding the frames in memory, so
+// that files of any length can be compared.
+//
+// |Pair| is constructed from the size of a frame in bytes.
+template <class Pair>
+class FramePairPool {
+ public:
+  FramePairPool(int num_threads, size_t frame_size)
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        pair_returned_(ConditionVariableWrapper::CreateConditionVariable()) {
+    for (int i = 0; i < num_threads * kPairsPerThread; ++i) {
+      pairs_.push_back(new Pair(frame_size));
+      free_pairs_.push_back(pairs_.back());
+    }
+  }
+
+  // Waits for a pair not being compared.
+  Pair* Take() {
+    CriticalSectionScoped cs(crit_.get());
+    while (free_pairs_.empty())
+      pair_returned_->SleepCS(*crit_);
+    Pair* pair = free_pairs_.back();
+    free_pairs_.pop_back();
+    return pair;
+  }
+
+  void Return(Pair* pair) {
+    CriticalSectionScoped cs(crit_.get());
+    free_pairs_.push_back(pair);
+    pair_returned_->WakeAll();
+  }
+
+  // Waits for all pairs to be returned.
+  void WaitForAll() {
+    CriticalSectionScoped cs(crit_.get());
+    while (free_pairs_.size() < pairs_.size())
+      pair_returned_->SleepCS(*crit_);
+  }
+
+ private:
+  static const int kPairsPerThread = 2;
+
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  const scoped_ptr<ConditionVariableWrapper> pair_returned_;
+  ScopedVector<Pair> pairs_;
+  std::vector<Pair*> free_pairs_;
+
+  DISALLOW_COPY_AND_ASSIGN(FramePairPool);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_TEST_TESTSUPPORT_FRAME_PAIR_POOL_H_
@@ -11,17 +11,26 @@
 #include "webrtc/test/testsupport/frame_reader.h"
 
 #include <assert.h>
+#include <string.h>
+
+#include <algorithm>
 
 #include "webrtc/test/testsupport/fileutils.h"
 
 namespace webrtc {
 namespace test {
 
+namespace {
+// How far ahead of the frames being read the system is asked to read.
+const size_t kReadAheadBytes = 4 * 1024 * 1024;
+}  // namespace
+
 FrameReaderImpl::FrameReaderImpl(std::string input_filename,
                                  size_t frame_length_in_bytes)
     : input_filename_(input_filename),
       frame_length_in_bytes_(frame_length_in_bytes),
-      input_file_(NULL) {
+      read_offset_(0),
+      read_ahead_offset_(0) {
 }
 
 FrameReaderImpl::~FrameReaderImpl() {
@@ -34,52 +43,65 @@ bool FrameReaderImpl::Init() {
             frame_length_in_bytes_);
     return false;
   }
-  input_file_ = fopen(input_filename_.c_str(), "rb");
-  if (input_file_ == NULL) {
-    fprintf(stderr, "Couldn't open input file for reading: %s\n",
-            input_filename_.c_str());
+  if (!input_file_.Open(input_filename_)) {
+    if (GetFileSize(input_filename_) <= 0u) {
+      fprintf(stderr, "Found empty file: %s\n", input_filename_.c_str());
+    } else {
+      fprintf(stderr, "Couldn't open input file for reading: %s\n",
+              input_filename_.c_str());
+    }
     return false;
   }
   // Calculate total number of frames.
-  size_t source_file_size = GetFileSize(input_filename_);
-  if (source_file_size <= 0u) {
-    fprintf(stderr, "Found empty file: %s\n", input_filename_.c_str());
-    return false;
-  }
-  number_of_frames_ = static_cast<int>(source_file_size /
+  number_of_frames_ = static_cast<int>(input_file_.size() /
                                        frame_length_in_bytes_);
+  read_offset_ = 0;
+  read_ahead_offset_ = 0;
+  ReadAhead();
   return true;
 }
 
 void FrameReaderImpl::Close() {
-  if (input_file_ != NULL) {
-    fclose(input_file_);
-    input_file_ = NULL;
-  }
+  input_file_.Close();
 }
 
 bool FrameReaderImpl::ReadFrame(uint8_t* source_buffer) {
   assert(source_buffer);
-  if (input_file_ == NULL) {
+  if (!input_file_.is_open()) {
     fprintf(stderr, "FrameReader is not initialized (input file is NULL)\n");
     return false;
   }
-  size_t nbr_read = fread(source_buffer, 1, frame_length_in_bytes_,
-                          input_file_);
-  if (nbr_read != static_cast<unsigned int>(frame_length_in_bytes_) &&
-      ferror(input_file_)) {
-    fprintf(stderr, "Error reading from input file: %s\n",
-            input_filename_.c_str());
-    return false;
-  }
-  if (feof(input_file_) != 0) {
-    return false;  // No more frames to process.
+  // A partial last frame is copied as well, but counts as no frame.
+  const size_t length = std::min(frame_length_in_bytes_,
+                                 input_file_.size() - read_offset_);
+  memcpy(source_buffer, input_file_.data() + read_offset_, length);
+  read_offset_ += length;
+  ReadAhead();
+  return length == frame_length_in_bytes_;
+}
+
+const uint8_t* FrameReaderImpl::NextFrame() {
+  if (!input_file_.is_open()) {
+    fprintf(stderr, "FrameReader is not initialized (input file is NULL)\n");
+    return NULL;
   }
-  return true;
+  if (input_file_.size() - read_offset_ < frame_length_in_bytes_)
+    return NULL;  // No more frames to process.
+  const uint8_t* frame = input_file_.data() + read_offset_;
+  read_offset_ += frame_length_in_bytes_;
+  ReadAhead();
+  return frame;
 }
 
 size_t FrameReaderImpl::FrameLength() { return frame_length_in_bytes_; }
 int FrameReaderImpl::NumberOfFrames() { return number_of_frames_; }
 
+void FrameReaderImpl::ReadAhead() {
+  if (read_offset_ + kReadAheadBytes / 2 <= read_ahead_offset_)
+    return;
+  input_file_.WillRead(read_ahead_offset_, kReadAheadBytes);
+  read_ahead_offset_ += kReadAheadBytes;
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -15,6 +15,7 @@
 
 #include <string>
 
+#include "webrtc/test/testsupport/mapped_file.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -36,6 +37,10 @@ class FrameReader {
   // read the last frame (in the previous call).
   virtual bool ReadFrame(uint8_t* source_buffer) = 0;
 
+  // Returns the next frame without copying it, or NULL if there are no more
+  // frames. The frame stays valid until the reader is closed.
+  virtual const uint8_t* NextFrame() = 0;
+
   // Closes the input file if open. Essentially makes this class impossible
   // to use anymore. Will also be invoked by the destructor.
   virtual void Close() = 0;
@@ -46,6 +51,8 @@ class FrameReader {
   virtual int NumberOfFrames() = 0;
 };
 
+// Maps the input file into memory, so that the frames are read straight from
+// the page cache.
 class FrameReaderImpl : public FrameReader {
  public:
   // Creates a file handler. The input file is assumed to exist and be readable.
@@ -57,15 +64,24 @@ class FrameReaderImpl : public FrameReader {
   virtual ~FrameReaderImpl();
   virtual bool Init() OVERRIDE;
   virtual bool ReadFrame(uint8_t* source_buffer) OVERRIDE;
+  virtual const uint8_t* NextFrame() OVERRIDE;
   virtual void Close() OVERRIDE;
   virtual size_t FrameLength() OVERRIDE;
   virtual int NumberOfFrames() OVERRIDE;
 
  private:
+  // Asks the system to read ahead of |read_offset_| when it gets close to
+  // the data already asked for.
+  void ReadAhead();
+
   std::string input_filename_;
   size_t frame_length_in_bytes_;
   int number_of_frames_;
-  FILE* input_file_;
+  MappedFile input_file_;
+  // The offset of the next frame in |input_file_|.
+  size_t read_offset_;
+  // The offset up to which the system has been asked to read ahead.
+  size_t read_ahead_offset_;
 };
 
 }  // namespace test
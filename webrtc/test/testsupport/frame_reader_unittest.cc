@@ -62,10 +62,24 @@ TEST_F(FrameReaderTest, ReadFrame) {
   ASSERT_EQ(kInputFileContents[2], buffer[2]);
 }
 
+TEST_F(FrameReaderTest, NextFrame) {
+  FrameReaderImpl frame_reader(kInputFilename, 1);
+  ASSERT_TRUE(frame_reader.Init());
+  for (size_t i = 0; i < kInputFileContents.size(); ++i) {
+    const uint8_t* frame = frame_reader.NextFrame();
+    ASSERT_TRUE(frame != NULL);
+    ASSERT_EQ(kInputFileContents[i], frame[0]);
+  }
+  ASSERT_TRUE(frame_reader.NextFrame() == NULL);  // No more frames to read.
+  // Too short for a frame.
+  ASSERT_TRUE(frame_reader_->NextFrame() == NULL);
+}
+
 TEST_F(FrameReaderTest, ReadFrameUninitialized) {
   uint8_t buffer[3];
   FrameReaderImpl file_reader(kInputFilename, kFrameLength);
   ASSERT_FALSE(file_reader.ReadFrame(buffer));
+  ASSERT_TRUE(file_reader.NextFrame() == NULL);
 }
 
 }  // namespace test
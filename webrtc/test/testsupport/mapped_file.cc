@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/test/testsupport/mapped_file.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace webrtc {
+namespace test {
+
+MappedFile::MappedFile()
+    : data_(NULL),
+      size_(0)
+#if defined(_WIN32)
+      , file_(INVALID_HANDLE_VALUE),
+      mapping_(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+#if defined(_WIN32)
+bool MappedFile::Open(const std::string& file_name) {
+  Close();
+  file_ = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file_ == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+    Close();
+    return false;
+  }
+  mapping_ = CreateFileMapping(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping_ == NULL) {
+    Close();
+    return false;
+  }
+  data_ = static_cast<uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0,
+                                              0));
+  if (data_ == NULL) {
+    Close();
+    return false;
+  }
+  size_ = static_cast<size_t>(size.QuadPart);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_ != NULL)
+    UnmapViewOfFile(data_);
+  if (mapping_ != NULL)
+    CloseHandle(mapping_);
+  if (file_ != INVALID_HANDLE_VALUE)
+    CloseHandle(file_);
+  data_ = NULL;
+  size_ = 0;
+  mapping_ = NULL;
+  file_ = INVALID_HANDLE_VALUE;
+}
+
+void MappedFile::WillRead(size_t offset, size_t length) {
+  // FILE_FLAG_SEQUENTIAL_SCAN already reads ahead.
+}
+#else
+bool MappedFile::Open(const std::string& file_name) {
+  Close();
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void* data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+  data_ = static_cast<uint8_t*>(data);
+  size_ = static_cast<size_t>(file_stat.st_size);
+  madvise(data_, size_, MADV_SEQUENTIAL);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_ != NULL)
+    munmap(data_, size_);
+  data_ = NULL;
+  size_ = 0;
+}
+
+void MappedFile::WillRead(size_t offset, size_t length) {
+  if (offset >= size_)
+    return;
+  if (length > size_ - offset)
+    length = size_ - offset;
+  // madvise() takes page aligned addresses.
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const size_t start = offset - offset % page_size;
+  madvise(data_ + start, offset + length - start, MADV_WILLNEED);
+}
+#endif
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_TEST_TESTSUPPORT_MAPPED_FILE_H_
+#define WEBRTC_TEST_TESTSUPPORT_MAPPED_FILE_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace test {
+
+// Maps a whole file read-only into memory, so that large resource files can
+// be read straight from the page cache instead of being copied with fread.
+class MappedFile {
+ public:
+  MappedFile();
+  ~MappedFile();
+
+  // Maps |file_name|, unmapping any file mapped before. Returns false if the
+  // file can't be opened or is empty.
+  bool Open(const std::string& file_name);
+  void Close();
+
+  bool is_open() const { return data_ != NULL; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // Hints that |length| bytes from |offset| will be read soon, so that the
+  // system can read them ahead. The file is read sequentially by default.
+  void WillRead(size_t offset, size_t length);
+
+ private:
+  uint8_t* data_;
+  size_t size_;
+#if defined(_WIN32)
+  void* file_;
+  void* mapping_;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_TEST_TESTSUPPORT_MAPPED_FILE_H_
@@ -17,6 +17,9 @@
 
 #include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+#include "webrtc/test/testsupport/frame_pair_pool.h"
 
 namespace webrtc {
 namespace test {
@@ -32,25 +35,91 @@ static bool LessForFrameResultValue(const FrameResult& s1,
 
 enum VideoMetricsType { kPSNR, kSSIM, kBoth };
 
-// Calculates metrics for a frame and adds statistics to the result for it.
+// Calculates a metric for a frame into its preallocated result.
 void CalculateFrame(VideoMetricsType video_metrics_type,
                     const I420VideoFrame* ref,
                     const I420VideoFrame* test,
                     int frame_number,
-                    QualityMetricsResult* result) {
-  FrameResult frame_result = {0, 0};
-  frame_result.frame_number = frame_number;
+                    FrameResult* frame_result) {
+  frame_result->frame_number = frame_number;
   switch (video_metrics_type) {
     case kPSNR:
-      frame_result.value = I420PSNR(ref, test);
+      frame_result->value = I420PSNR(ref, test);
       break;
     case kSSIM:
-      frame_result.value = I420SSIM(ref, test);
+      frame_result->value = I420SSIM(ref, test);
       break;
     default:
       assert(false);
   }
-  result->frames.push_back(frame_result);
+}
+
+// A reference and test frame, read from the files by the calling thread and
+// compared on a thread pool thread.
+struct FramePair {
+  explicit FramePair(size_t frame_length)
+      : ref_buffer(new uint8_t[frame_length]),
+        test_buffer(new uint8_t[frame_length]),
+        frame_number(-1) {}
+
+  scoped_ptr<uint8_t[]> ref_buffer;
+  scoped_ptr<uint8_t[]> test_buffer;
+  I420VideoFrame ref_frame;
+  I420VideoFrame test_frame;
+  int frame_number;
+};
+
+typedef FramePairPool<FramePair> FramePairs;
+
+class CalculateFrameTask : public QueuedTask {
+ public:
+  CalculateFrameTask(VideoMetricsType video_metrics_type,
+                     int width,
+                     int height,
+                     FramePairs* pool,
+                     FramePair* pair,
+                     FrameResult* psnr_result,
+                     FrameResult* ssim_result)
+      : video_metrics_type_(video_metrics_type),
+        width_(width),
+        height_(height),
+        pool_(pool),
+        pair_(pair),
+        psnr_result_(psnr_result),
+        ssim_result_(ssim_result) {}
+
+  virtual void Run() OVERRIDE {
+    // Converting from buffer to plane representation.
+    ConvertToI420(kI420, pair_->ref_buffer.get(), 0, 0, width_, height_, 0,
+                  kRotateNone, &pair_->ref_frame);
+    ConvertToI420(kI420, pair_->test_buffer.get(), 0, 0, width_, height_, 0,
+                  kRotateNone, &pair_->test_frame);
+    if (video_metrics_type_ != kSSIM) {
+      CalculateFrame(kPSNR, &pair_->ref_frame, &pair_->test_frame,
+                     pair_->frame_number, psnr_result_);
+    }
+    if (video_metrics_type_ != kPSNR) {
+      CalculateFrame(kSSIM, &pair_->ref_frame, &pair_->test_frame,
+                     pair_->frame_number, ssim_result_);
+    }
+    pool_->Return(pair_);
+  }
+
+ private:
+  const VideoMetricsType video_metrics_type_;
+  const int width_;
+  const int height_;
+  FramePairs* const pool_;
+  FramePair* const pair_;
+  FrameResult* const psnr_result_;
+  FrameResult* const ssim_result_;
+};
+
+static size_t FileSize(FILE* fp) {
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  rewind(fp);
+  return size > 0 ? static_cast<size_t>(size) : 0;
 }
 
 // Calculates average, min and max values for the supplied struct, if non-NULL.
@@ -105,48 +174,64 @@ int CalculateMetrics(VideoMetricsType video_metrics_type,
     fclose(ref_fp);
     return -2;
   }
-  int frame_number = 0;
 
-  // Read reference and test frames.
+  // The frames are read here, one pair at a time, and compared on one thread
+  // per core. The results are preallocated from the file sizes so that the
+  // threads can fill them in without locking.
   const size_t frame_length = 3 * width * height >> 1;
-  I420VideoFrame ref_frame;
-  I420VideoFrame test_frame;
-  scoped_ptr<uint8_t[]> ref_buffer(new uint8_t[frame_length]);
-  scoped_ptr<uint8_t[]> test_buffer(new uint8_t[frame_length]);
+  const size_t max_frames =
+      std::min(FileSize(ref_fp), FileSize(test_fp)) / frame_length;
+  const size_t first_psnr_frame = psnr_result ? psnr_result->frames.size() : 0;
+  const size_t first_ssim_frame = ssim_result ? ssim_result->frames.size() : 0;
+  const FrameResult empty_result = {0, 0};
+  if (psnr_result != NULL)
+    psnr_result->frames.resize(first_psnr_frame + max_frames, empty_result);
+  if (ssim_result != NULL)
+    ssim_result->frames.resize(first_ssim_frame + max_frames, empty_result);
+
+  scoped_ptr<ThreadPool> thread_pool(ThreadPool::Create("VideoMetrics", 0));
+  const int num_threads = thread_pool ? thread_pool->num_threads() : 1;
+  FramePairs pairs(num_threads, frame_length);
 
   // Set decoded image parameters.
   int half_width = (width + 1) / 2;
-  ref_frame.CreateEmptyFrame(width, height, width, half_width, half_width);
-  test_frame.CreateEmptyFrame(width, height, width, half_width, half_width);
-
-  size_t ref_bytes = fread(ref_buffer.get(), 1, frame_length, ref_fp);
-  size_t test_bytes = fread(test_buffer.get(), 1, frame_length, test_fp);
-  while (ref_bytes == frame_length && test_bytes == frame_length) {
-    // Converting from buffer to plane representation.
-    ConvertToI420(kI420, ref_buffer.get(), 0, 0, width, height, 0,
-                  kRotateNone, &ref_frame);
-    ConvertToI420(kI420, test_buffer.get(), 0, 0, width, height, 0,
-                  kRotateNone, &test_frame);
-    switch (video_metrics_type) {
-      case kPSNR:
-        CalculateFrame(kPSNR, &ref_frame, &test_frame, frame_number,
-                       psnr_result);
-        break;
-      case kSSIM:
-        CalculateFrame(kSSIM, &ref_frame, &test_frame, frame_number,
-                       ssim_result);
-        break;
-      case kBoth:
-        CalculateFrame(kPSNR, &ref_frame, &test_frame, frame_number,
-                       psnr_result);
-        CalculateFrame(kSSIM, &ref_frame, &test_frame, frame_number,
-                       ssim_result);
-        break;
+  int frame_number = 0;
+  while (static_cast<size_t>(frame_number) < max_frames) {
+    FramePair* pair = pairs.Take();
+    size_t ref_bytes = fread(pair->ref_buffer.get(), 1, frame_length, ref_fp);
+    size_t test_bytes =
+        fread(pair->test_buffer.get(), 1, frame_length, test_fp);
+    if (ref_bytes != frame_length || test_bytes != frame_length) {
+      pairs.Return(pair);
+      break;
+    }
+    if (pair->ref_frame.IsZeroSize()) {
+      pair->ref_frame.CreateEmptyFrame(width, height, width, half_width,
+                                       half_width);
+      pair->test_frame.CreateEmptyFrame(width, height, width, half_width,
+                                        half_width);
+    }
+    pair->frame_number = frame_number;
+    CalculateFrameTask* task = new CalculateFrameTask(
+        video_metrics_type, width, height, &pairs, pair,
+        psnr_result ? &psnr_result->frames[first_psnr_frame + frame_number]
+                    : NULL,
+        ssim_result ? &ssim_result->frames[first_ssim_frame + frame_number]
+                    : NULL);
+    if (thread_pool) {
+      thread_pool->PostTask(task);
+    } else {
+      task->Run();
+      delete task;
     }
     frame_number++;
-    ref_bytes = fread(ref_buffer.get(), 1, frame_length, ref_fp);
-    test_bytes = fread(test_buffer.get(), 1, frame_length, test_fp);
   }
+  pairs.WaitForAll();
+  if (psnr_result != NULL)
+    psnr_result->frames.resize(first_psnr_frame + frame_number);
+  if (ssim_result != NULL)
+    ssim_result->frames.resize(first_ssim_frame + frame_number);
+
   int return_code = 0;
   if (frame_number == 0) {
     fprintf(stderr, "Tried to measure video metrics from empty files "
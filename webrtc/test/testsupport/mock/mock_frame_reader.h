@@ -22,6 +22,7 @@ class MockFrameReader : public FrameReader {
  public:
   MOCK_METHOD0(Init, bool());
   MOCK_METHOD1(ReadFrame, bool(uint8_t* source_buffer));
+  MOCK_METHOD0(NextFrame, const uint8_t*());
   MOCK_METHOD0(Close, void());
   MOCK_METHOD0(FrameLength, size_t());
   MOCK_METHOD0(NumberOfFrames, int());
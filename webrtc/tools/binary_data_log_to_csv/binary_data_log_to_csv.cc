@@ -0,0 +1,35 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <string>
+
+#include "webrtc/system_wrappers/interface/binary_data_log.h"
+
+// A command-line tool converting a BinaryDataLog file to one CSV file per
+// table, in the format of DataLog.
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr,
+            "Converts a binary data log to one CSV file per table, named "
+            "<prefix><table>.csv.\n"
+            "Usage: %s <log file> [<prefix>]\n", argv[0]);
+    return 1;
+  }
+  const std::string prefix = argc == 3 ? argv[2] : "";
+  const int num_rows = webrtc::BinaryDataLog::ConvertToCsv(argv[1], prefix);
+  if (num_rows < 0) {
+    fprintf(stderr, "Cannot convert %s.\n", argv[1]);
+    return 1;
+  }
+  printf("Converted %d rows.\n", num_rows);
+  return 0;
+}
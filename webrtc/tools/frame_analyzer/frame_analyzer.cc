@@ -37,7 +37,7 @@
  * Usage:
  * frame_analyzer --label=<test_label> --reference_file=<name_of_file>
  * --test_file=<name_of_file> --stats_file=<name_of_file> --width=<frame_width>
- * --height=<frame_height>
+ * --height=<frame_height> [--csv_file=<name_of_file>]
  */
 int main(int argc, char** argv) {
   std::string program_name = argv[0];
@@ -55,7 +55,9 @@ int main(int argc, char** argv) {
       "  - reference_file(string): The reference YUV file to compare against."
       " Default: ref.yuv\n"
       "  - test_file(string): The test YUV file to run the analysis for."
-      " Default: test_file.yuv\n";
+      " Default: test_file.yuv\n"
+      "  - csv_file(string): If set, the file to write the PSNR and SSIM of"
+      " every frame to, as CSV. Default: none\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -69,6 +71,7 @@ int main(int argc, char** argv) {
   parser.SetFlag("stats_file", "stats.txt");
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
+  parser.SetFlag("csv_file", "");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -96,4 +99,16 @@ int main(int argc, char** argv) {
   webrtc::test::PrintAnalysisResults(label, &results);
   webrtc::test::PrintMaxRepeatedAndSkippedFrames(label,
                                                  parser.GetFlag("stats_file"));
+
+  std::string csv_file_name = parser.GetFlag("csv_file");
+  if (!csv_file_name.empty()) {
+    FILE* csv_file = fopen(csv_file_name.c_str(), "w");
+    if (csv_file == NULL) {
+      fprintf(stderr, "Error: couldn't open %s for writing!\n",
+              csv_file_name.c_str());
+      return -1;
+    }
+    webrtc::test::PrintAnalysisResultsCsv(csv_file, &results);
+    fclose(csv_file);
+  }
 }
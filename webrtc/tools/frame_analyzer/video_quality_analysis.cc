@@ -15,6 +15,11 @@
 #include <stdlib.h>
 
 #include <string>
+#include <utility>
+
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+#include "webrtc/test/testsupport/frame_pair_pool.h"
 
 #define STATS_LINE_LENGTH 32
 #define Y4M_FILE_HEADER_MAX_SIZE 200
@@ -211,6 +216,107 @@ double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
   return result;
 }
 
+namespace {
+
+// Reads frames from a file that is kept open, at the same offsets as
+// ExtractFrameFromYuvFile() and ExtractFrameFromY4mFile().
+class VideoFile {
+ public:
+  VideoFile(const char* file_name, int width, int height, bool y4m)
+      : file_(fopen(file_name, "rb")),
+        file_name_(file_name),
+        frame_size_(GetI420FrameSize(width, height)),
+        first_frame_offset_(0) {
+    if (file_ == NULL) {
+      fprintf(stderr, "Couldn't open input file for reading: %s\n", file_name);
+      return;
+    }
+    if (y4m) {
+      // Skip the file header before the first frame. The other frames are
+      // read at multiples of the frame size, like ExtractFrameFromY4mFile().
+      char header[Y4M_FILE_HEADER_MAX_SIZE + 1];
+      size_t bytes_read = fread(header, 1, Y4M_FILE_HEADER_MAX_SIZE, file_);
+      header[bytes_read] = '\0';
+      std::size_t found = std::string(header).find(Y4M_FRAME_DELIMITER);
+      if (found == std::string::npos) {
+        fprintf(stdout, "Corrupted Y4M header, could not find \"FRAME\" in "
+                "%s\n", file_name);
+        fclose(file_);
+        file_ = NULL;
+        return;
+      }
+      first_frame_offset_ = static_cast<long>(found);
+      frame_header_size_ = Y4M_FRAME_HEADER_SIZE;
+    } else {
+      frame_header_size_ = 0;
+    }
+  }
+
+  ~VideoFile() {
+    if (file_ != NULL)
+      fclose(file_);
+  }
+
+  bool ReadFrame(int frame_number, uint8* frame) {
+    if (file_ == NULL)
+      return false;
+    long offset = static_cast<long>(frame_number) * frame_size_;
+    if (frame_header_size_ > 0 && frame_number == 0)
+      offset = first_frame_offset_;
+    fseek(file_, offset + frame_header_size_, SEEK_SET);
+    size_t bytes_read = fread(frame, 1, frame_size_, file_);
+    if (bytes_read != static_cast<size_t>(frame_size_) && ferror(file_)) {
+      fprintf(stdout, "Error while reading frame no %d from file %s\n",
+              frame_number, file_name_.c_str());
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  FILE* file_;
+  const std::string file_name_;
+  const int frame_size_;
+  long first_frame_offset_;
+  int frame_header_size_;
+};
+
+struct FramePair {
+  explicit FramePair(size_t frame_size)
+      : reference(new uint8[frame_size]),
+        test(new uint8[frame_size]),
+        result(NULL) {}
+
+  scoped_ptr<uint8[]> reference;
+  scoped_ptr<uint8[]> test;
+  AnalysisResult* result;
+};
+
+typedef FramePairPool<FramePair> FramePairs;
+
+class AnalyzeFrameTask : public QueuedTask {
+ public:
+  AnalyzeFrameTask(FramePairs* pool, FramePair* pair, int width,
+                   int height)
+      : pool_(pool), pair_(pair), width_(width), height_(height) {}
+
+  virtual void Run() OVERRIDE {
+    pair_->result->psnr_value = CalculateMetrics(
+        kPSNR, pair_->reference.get(), pair_->test.get(), width_, height_);
+    pair_->result->ssim_value = CalculateMetrics(
+        kSSIM, pair_->reference.get(), pair_->test.get(), width_, height_);
+    pool_->Return(pair_);
+  }
+
+ private:
+  FramePairs* const pool_;
+  FramePair* const pair_;
+  const int width_;
+  const int height_;
+};
+
+}  // namespace
+
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
                  ResultsContainer* results) {
@@ -220,15 +326,18 @@ void RunAnalysis(const char* reference_file_name, const char* test_file_name,
     y4m_mode = true;
   }
 
-  int size = GetI420FrameSize(width, height);
   FILE* stats_file = fopen(stats_file_name, "r");
+  if (stats_file == NULL) {
+    fprintf(stderr, "Couldn't open stats file for reading: %s\n",
+            stats_file_name);
+    return;
+  }
 
   // String buffer for the lines in the stats file.
   char line[STATS_LINE_LENGTH];
 
-  // Allocate buffers for test and reference frames.
-  uint8* test_frame = new uint8[size];
-  uint8* reference_frame = new uint8[size];
+  // The frames to analyze, as (test frame, reference frame) pairs.
+  std::vector<std::pair<int, int> > frame_numbers;
   int previous_frame_number = -1;
 
   // While there are entries in the stats file.
@@ -246,37 +355,38 @@ void RunAnalysis(const char* reference_file_name, const char* test_file_name,
     assert(extracted_test_frame != -1);
     assert(decoded_frame_number != -1);
 
-    ExtractFrameFromYuvFile(test_file_name, width, height, extracted_test_frame,
-                            test_frame);
-    if (y4m_mode) {
-      ExtractFrameFromY4mFile(reference_file_name, width, height,
-                              decoded_frame_number, reference_frame);
-    } else {
-      ExtractFrameFromYuvFile(reference_file_name, width, height,
-                              decoded_frame_number, reference_frame);
-    }
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = CalculateMetrics(kPSNR, reference_frame, test_frame,
-                                          width, height);
-    double result_ssim = CalculateMetrics(kSSIM, reference_frame, test_frame,
-                                          width, height);
-
+    frame_numbers.push_back(
+        std::make_pair(extracted_test_frame, decoded_frame_number));
     previous_frame_number = decoded_frame_number;
-
-    // Fill in the result struct.
-    AnalysisResult result;
-    result.frame_number = decoded_frame_number;
-    result.psnr_value = result_psnr;
-    result.ssim_value = result_ssim;
-
-    results->frames.push_back(result);
   }
-
-  // Cleanup.
   fclose(stats_file);
-  delete[] test_frame;
-  delete[] reference_frame;
+
+  // The frames are read here in order, and analyzed in parallel on one thread
+  // per core.
+  const size_t first_result = results->frames.size();
+  results->frames.resize(first_result + frame_numbers.size());
+  VideoFile test_file(test_file_name, width, height, false);
+  VideoFile reference_file(reference_file_name, width, height, y4m_mode);
+  scoped_ptr<ThreadPool> thread_pool(ThreadPool::Create("FrameAnalyzer", 0));
+  const int num_threads = thread_pool ? thread_pool->num_threads() : 1;
+  FramePairs pairs(num_threads, GetI420FrameSize(width, height));
+
+  for (size_t i = 0; i < frame_numbers.size(); ++i) {
+    FramePair* pair = pairs.Take();
+    test_file.ReadFrame(frame_numbers[i].first, pair->test.get());
+    reference_file.ReadFrame(frame_numbers[i].second, pair->reference.get());
+    pair->result = &results->frames[first_result + i];
+    pair->result->frame_number = frame_numbers[i].second;
+
+    AnalyzeFrameTask* task = new AnalyzeFrameTask(&pairs, pair, width, height);
+    if (thread_pool) {
+      thread_pool->PostTask(task);
+    } else {
+      task->Run();
+      delete task;
+    }
+  }
+  pairs.WaitForAll();
 }
 
 void PrintMaxRepeatedAndSkippedFrames(const std::string& label,
@@ -360,5 +470,14 @@ void PrintAnalysisResults(FILE* output, const std::string& label,
   }
 }
 
+void PrintAnalysisResultsCsv(FILE* output, ResultsContainer* results) {
+  fprintf(output, "frame_number,psnr,ssim\n");
+  std::vector<AnalysisResult>::const_iterator iter;
+  for (iter = results->frames.begin(); iter != results->frames.end(); ++iter) {
+    fprintf(output, "%d,%f,%f\n", iter->frame_number, iter->psnr_value,
+            iter->ssim_value);
+  }
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -50,6 +50,7 @@ enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 // tools/barcode_tools/barcode_decoder.py. This script decodes the barcodes
 // integrated in every video and generates the stats file. If three was some
 // problem with the decoding there would be 'Barcode error' instead of yyyy.
+// The frames are read one at a time and analyzed on one thread per core.
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
                  ResultsContainer* results);
@@ -71,6 +72,10 @@ void PrintAnalysisResults(const std::string& label, ResultsContainer* results);
 void PrintAnalysisResults(FILE* output, const std::string& label,
                           ResultsContainer* results);
 
+// Prints the result from the analysis as CSV, one line per frame after a
+// "frame_number,psnr,ssim" header line.
+void PrintAnalysisResultsCsv(FILE* output, ResultsContainer* results);
+
 // Calculates max repeated and skipped frames and prints them to stdout in a
 // format that is compatible with Chromium performance numbers.
 void PrintMaxRepeatedAndSkippedFrames(const std::string& label,
@@ -11,6 +11,8 @@
 // This test doesn't actually verify the output since it's just printed
 // to stdout by void functions, but it's still useful as it executes the code.
 
+#include <stdio.h>
+
 #include <fstream>
 #include <string>
 
@@ -86,6 +88,56 @@ TEST_F(VideoQualityAnalysisTest, PrintMaxRepeatedAndSkippedFramesNormalFile) {
   PrintMaxRepeatedAndSkippedFrames(logfile_, "NormalStatsFile", stats_filename);
 }
 
+TEST_F(VideoQualityAnalysisTest, RunAnalysisKeepsStatsFileOrder) {
+  const int kWidth = 16;
+  const int kHeight = 16;
+  const int kNumFrames = 20;
+  const int frame_size = GetI420FrameSize(kWidth, kHeight);
+  std::string reference_filename = OutputPath() + "run-analysis-ref.yuv";
+  std::string test_filename = OutputPath() + "run-analysis-test.yuv";
+  std::string stats_filename = OutputPath() + "run-analysis-stats.txt";
+
+  // The test video is the reference video in reverse, with every odd frame
+  // distorted.
+  std::ofstream reference_file(reference_filename.c_str(), std::ios::binary);
+  std::ofstream test_file(test_filename.c_str(), std::ios::binary);
+  std::ofstream stats_file(stats_filename.c_str());
+  for (int i = 0; i < kNumFrames; ++i) {
+    std::string reference_frame(frame_size, static_cast<char>(10 * i));
+    std::string test_frame(frame_size,
+                           static_cast<char>(10 * (kNumFrames - 1 - i)));
+    if (i % 2 == 1)
+      test_frame[0] ^= 0x40;
+    reference_file << reference_frame;
+    test_file << test_frame;
+    char line[32];
+    sprintf(line, "frame_%04d %04d\n", i, kNumFrames - 1 - i);
+    stats_file << line;
+  }
+  reference_file.close();
+  test_file.close();
+  stats_file.close();
+
+  ResultsContainer results;
+  RunAnalysis(reference_filename.c_str(), test_filename.c_str(),
+              stats_filename.c_str(), kWidth, kHeight, &results);
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), results.frames.size());
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(kNumFrames - 1 - i, results.frames[i].frame_number);
+    if (i % 2 == 0) {
+      EXPECT_EQ(48.0, results.frames[i].psnr_value);
+    } else {
+      EXPECT_LT(results.frames[i].psnr_value, 48.0);
+      EXPECT_LT(results.frames[i].ssim_value, 1.0);
+    }
+  }
+  PrintAnalysisResultsCsv(logfile_, &results);
+
+  remove(reference_filename.c_str());
+  remove(test_filename.c_str());
+  remove(stats_filename.c_str());
+}
+
 
 }  // namespace test
 }  // namespace webrtc
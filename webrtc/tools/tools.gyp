@@ -16,6 +16,7 @@
       'type': 'static_library',
       'dependencies': [
         '<(DEPTH)/third_party/libyuv/libyuv.gyp:libyuv',
+        '<(webrtc_root)/system_wrappers/source/system_wrappers.gyp:system_wrappers',
       ],
       'export_dependent_settings': [
         '<(DEPTH)/third_party/libyuv/libyuv.gyp:libyuv',
@@ -97,6 +98,16 @@
         'force_mic_volume_max/force_mic_volume_max.cc',
       ],
     }, # force_mic_volume_max
+    {
+      'target_name': 'binary_data_log_to_csv',
+      'type': 'executable',
+      'dependencies': [
+        '<(webrtc_root)/system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'sources': [
+        'binary_data_log_to_csv/binary_data_log_to_csv.cc',
+      ],
+    }, # binary_data_log_to_csv
   ],
   'conditions': [
     ['include_tests==1', {
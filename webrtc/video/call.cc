@@ -11,6 +11,7 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -19,8 +20,8 @@
 #include "webrtc/config.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
-#include "webrtc/system_wrappers/interface/rw_lock_wrapper.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/snapshot_publisher.h"
 #include "webrtc/system_wrappers/interface/thread_annotations.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 #include "webrtc/video/video_receive_stream.h"
@@ -94,17 +95,61 @@ class Call : public webrtc::Call, public PacketReceiver {
                                        size_t length) OVERRIDE;
 
  private:
+  // An immutable hash table from SSRC to the streams using it. Changes to the
+  // streams publish a new table, so delivery never takes a lock.
+  class SsrcTable {
+   public:
+    SsrcTable(const std::map<uint32_t, VideoReceiveStream*>& receive_ssrcs,
+              const std::map<uint32_t, VideoSendStream*>& send_ssrcs);
+
+    // NULL if no stream uses |ssrc|.
+    VideoReceiveStream* FindReceiveStream(uint32_t ssrc) const;
+    VideoSendStream* FindSendStream(uint32_t ssrc) const;
+
+    const std::vector<VideoReceiveStream*>& receive_streams() const {
+      return receive_streams_;
+    }
+    const std::vector<VideoSendStream*>& send_streams() const {
+      return send_streams_;
+    }
+
+   private:
+    struct Entry {
+      Entry() : ssrc(0), receive_stream(NULL), send_stream(NULL) {}
+      uint32_t ssrc;
+      VideoReceiveStream* receive_stream;
+      VideoSendStream* send_stream;
+    };
+
+    // Index of the entry of |ssrc|, or of the empty entry where it would be
+    // inserted.
+    uint32_t Probe(uint32_t ssrc) const;
+
+    // Open addressing with linear probing, at most half full.
+    std::vector<Entry> entries_;
+    uint32_t mask_;
+    std::vector<VideoReceiveStream*> receive_streams_;
+    std::vector<VideoSendStream*> send_streams_;
+
+    DISALLOW_COPY_AND_ASSIGN(SsrcTable);
+  };
+
   DeliveryStatus DeliverRtcp(const uint8_t* packet, size_t length);
   DeliveryStatus DeliverRtp(const uint8_t* packet, size_t length);
 
+  // Publishes a table built from |receive_ssrcs_| and |send_ssrcs_| and
+  // deletes the previous one once no delivery uses it anymore. After this,
+  // streams removed from the maps may be deleted.
+  void PublishSsrcTable() EXCLUSIVE_LOCKS_REQUIRED(streams_crit_);
+
   Call::Config config_;
 
+  // Serializes the changes to the streams.
+  scoped_ptr<CriticalSectionWrapper> streams_crit_;
   std::map<uint32_t, VideoReceiveStream*> receive_ssrcs_
-      GUARDED_BY(receive_lock_);
-  scoped_ptr<RWLockWrapper> receive_lock_;
-
-  std::map<uint32_t, VideoSendStream*> send_ssrcs_ GUARDED_BY(send_lock_);
-  scoped_ptr<RWLockWrapper> send_lock_;
+      GUARDED_BY(streams_crit_);
+  std::map<uint32_t, VideoSendStream*> send_ssrcs_ GUARDED_BY(streams_crit_);
+  SnapshotPublisher<SsrcTable> ssrc_tables_;
 
   scoped_ptr<CpuOveruseObserverProxy> overuse_observer_proxy_;
 
@@ -135,8 +180,8 @@ const int kDefaultVideoStreamBitrateBps = 300000;
 
 Call::Call(webrtc::VideoEngine* video_engine, const Call::Config& config)
     : config_(config),
-      receive_lock_(RWLockWrapper::CreateRWLock()),
-      send_lock_(RWLockWrapper::CreateRWLock()),
+      streams_crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      ssrc_tables_(new SsrcTable(receive_ssrcs_, send_ssrcs_)),
       video_engine_(video_engine),
       base_channel_id_(-1) {
   assert(video_engine != NULL);
@@ -163,6 +208,7 @@ Call::Call(webrtc::VideoEngine* video_engine, const Call::Config& config)
 }
 
 Call::~Call() {
+  delete ssrc_tables_.current();
   base_->DeleteChannel(base_channel_id_);
   base_->Release();
   codec_->Release();
@@ -192,11 +238,12 @@ VideoSendStream* Call::CreateVideoSendStream(
       config_.start_bitrate_bps != -1 ? config_.start_bitrate_bps
                                       : kDefaultVideoStreamBitrateBps);
 
-  WriteLockScoped write_lock(*send_lock_);
+  CriticalSectionScoped lock(streams_crit_.get());
   for (size_t i = 0; i < config.rtp.ssrcs.size(); ++i) {
     assert(send_ssrcs_.find(config.rtp.ssrcs[i]) == send_ssrcs_.end());
     send_ssrcs_[config.rtp.ssrcs[i]] = send_stream;
   }
+  PublishSsrcTable();
   return send_stream;
 }
 
@@ -207,7 +254,7 @@ void Call::DestroyVideoSendStream(webrtc::VideoSendStream* send_stream) {
 
   VideoSendStream* send_stream_impl = NULL;
   {
-    WriteLockScoped write_lock(*send_lock_);
+    CriticalSectionScoped lock(streams_crit_.get());
     std::map<uint32_t, VideoSendStream*>::iterator it = send_ssrcs_.begin();
     while (it != send_ssrcs_.end()) {
       if (it->second == static_cast<VideoSendStream*>(send_stream)) {
@@ -217,6 +264,7 @@ void Call::DestroyVideoSendStream(webrtc::VideoSendStream* send_stream) {
         ++it;
       }
     }
+    PublishSsrcTable();
   }
 
   VideoSendStream::RtpStateMap rtp_state = send_stream_impl->GetRtpStates();
@@ -240,7 +288,7 @@ VideoReceiveStream* Call::CreateVideoReceiveStream(
                              config_.voice_engine,
                              base_channel_id_);
 
-  WriteLockScoped write_lock(*receive_lock_);
+  CriticalSectionScoped lock(streams_crit_.get());
   assert(receive_ssrcs_.find(config.rtp.remote_ssrc) == receive_ssrcs_.end());
   receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
   // TODO(pbos): Configure different RTX payloads per receive payload.
@@ -248,6 +296,7 @@ VideoReceiveStream* Call::CreateVideoReceiveStream(
       config.rtp.rtx.begin();
   if (it != config.rtp.rtx.end())
     receive_ssrcs_[it->second.ssrc] = receive_stream;
+  PublishSsrcTable();
 
   return receive_stream;
 }
@@ -258,7 +307,7 @@ void Call::DestroyVideoReceiveStream(
 
   VideoReceiveStream* receive_stream_impl = NULL;
   {
-    WriteLockScoped write_lock(*receive_lock_);
+    CriticalSectionScoped lock(streams_crit_.get());
     // Remove all ssrcs pointing to a receive stream. As RTX retransmits on a
     // separate SSRC there can be either one or two.
     std::map<uint32_t, VideoReceiveStream*>::iterator it =
@@ -273,6 +322,7 @@ void Call::DestroyVideoReceiveStream(
         ++it;
       }
     }
+    PublishSsrcTable();
   }
 
   assert(receive_stream_impl != NULL);
@@ -289,31 +339,183 @@ uint32_t Call::ReceiveBitrateEstimate() {
   return 0;
 }
 
+namespace {
+const size_t kMaxRtcpSsrcs = 32;
+
+enum {
+  kRtcpSr = 200,
+  kRtcpRr = 201,
+  kRtcpBye = 203,
+  kRtcpRtpfb = 205,
+  kRtcpPsfb = 206
+};
+
+uint32_t ReadSsrc(const uint8_t* ptr) {
+  return ptr[0] << 24 | ptr[1] << 16 | ptr[2] << 8 | ptr[3];
+}
+
+// Collects the SSRCs of the compound RTCP |packet| that identify the streams
+// it is for: the senders of all packets, the sources of the report blocks and
+// BYEs and the media sources of feedback messages. Returns the number of
+// SSRCs written to |ssrcs|, at most kMaxRtcpSsrcs.
+size_t ParseRtcpSsrcs(const uint8_t* packet, size_t length, uint32_t* ssrcs) {
+  size_t num_ssrcs = 0;
+  size_t offset = 0;
+  while (offset + 8 <= length && num_ssrcs < kMaxRtcpSsrcs) {
+    const uint8_t* header = &packet[offset];
+    const size_t packet_length =
+        ((static_cast<size_t>(header[2]) << 8 | header[3]) + 1) * 4;
+    if (packet_length > length - offset)
+      break;
+    const size_t count = header[0] & 0x1f;
+    ssrcs[num_ssrcs++] = ReadSsrc(&header[4]);
+    size_t first = 0;
+    size_t stride = 0;
+    switch (header[1]) {
+      case kRtcpSr:
+        first = 28;
+        stride = 24;
+        break;
+      case kRtcpRr:
+        first = 8;
+        stride = 24;
+        break;
+      case kRtcpBye:
+        first = 8;
+        stride = 4;
+        break;
+      case kRtcpRtpfb:
+      case kRtcpPsfb:
+        // One media source.
+        if (packet_length >= 12 && num_ssrcs < kMaxRtcpSsrcs)
+          ssrcs[num_ssrcs++] = ReadSsrc(&header[8]);
+        break;
+    }
+    if (stride > 0) {
+      // The BYE sender is the first of its |count| sources.
+      const size_t num_sources = header[1] == kRtcpBye && count > 0
+                                     ? count - 1 : count;
+      for (size_t i = 0; i < num_sources && num_ssrcs < kMaxRtcpSsrcs; ++i) {
+        const size_t source_offset = first + i * stride;
+        if (source_offset + 4 > packet_length)
+          break;
+        ssrcs[num_ssrcs++] = ReadSsrc(&header[source_offset]);
+      }
+    }
+    offset += packet_length;
+  }
+  return num_ssrcs;
+}
+
+template <typename T>
+bool Contains(T* const* items, size_t num_items, T* item) {
+  return std::find(items, items + num_items, item) != items + num_items;
+}
+}  // namespace
+
+Call::SsrcTable::SsrcTable(
+    const std::map<uint32_t, VideoReceiveStream*>& receive_ssrcs,
+    const std::map<uint32_t, VideoSendStream*>& send_ssrcs) {
+  size_t size = 8;
+  while (size < 2 * (receive_ssrcs.size() + send_ssrcs.size()))
+    size *= 2;
+  entries_.resize(size);
+  mask_ = static_cast<uint32_t>(size - 1);
+
+  for (std::map<uint32_t, VideoReceiveStream*>::const_iterator it =
+           receive_ssrcs.begin();
+       it != receive_ssrcs.end();
+       ++it) {
+    Entry* entry = &entries_[Probe(it->first)];
+    entry->ssrc = it->first;
+    entry->receive_stream = it->second;
+    if (std::find(receive_streams_.begin(), receive_streams_.end(),
+                  it->second) == receive_streams_.end()) {
+      receive_streams_.push_back(it->second);
+    }
+  }
+  for (std::map<uint32_t, VideoSendStream*>::const_iterator it =
+           send_ssrcs.begin();
+       it != send_ssrcs.end();
+       ++it) {
+    Entry* entry = &entries_[Probe(it->first)];
+    entry->ssrc = it->first;
+    entry->send_stream = it->second;
+    if (std::find(send_streams_.begin(), send_streams_.end(), it->second) ==
+        send_streams_.end()) {
+      send_streams_.push_back(it->second);
+    }
+  }
+}
+
+uint32_t Call::SsrcTable::Probe(uint32_t ssrc) const {
+  // SSRCs are random, so their lower bits hash well enough.
+  uint32_t i = ssrc & mask_;
+  while ((entries_[i].receive_stream != NULL ||
+          entries_[i].send_stream != NULL) &&
+         entries_[i].ssrc != ssrc) {
+    i = (i + 1) & mask_;
+  }
+  return i;
+}
+
+VideoReceiveStream* Call::SsrcTable::FindReceiveStream(uint32_t ssrc) const {
+  // An empty entry has no streams.
+  return entries_[Probe(ssrc)].receive_stream;
+}
+
+VideoSendStream* Call::SsrcTable::FindSendStream(uint32_t ssrc) const {
+  return entries_[Probe(ssrc)].send_stream;
+}
+
+void Call::PublishSsrcTable() {
+  delete ssrc_tables_.Publish(new SsrcTable(receive_ssrcs_, send_ssrcs_));
+}
+
 PacketReceiver::DeliveryStatus Call::DeliverRtcp(const uint8_t* packet,
-                                                       size_t length) {
-  // TODO(pbos): Figure out what channel needs it actually.
-  //             Do NOT broadcast! Also make sure it's a valid packet.
-  //             Return DELIVERY_UNKNOWN_SSRC if it can be determined that
-  //             there's no receiver of the packet.
-  bool rtcp_delivered = false;
-  {
-    ReadLockScoped read_lock(*receive_lock_);
-    for (std::map<uint32_t, VideoReceiveStream*>::iterator it =
-             receive_ssrcs_.begin();
-         it != receive_ssrcs_.end();
-         ++it) {
-      if (it->second->DeliverRtcp(packet, length))
-        rtcp_delivered = true;
+                                                 size_t length) {
+  // TODO(pbos): Make sure it's a valid packet.
+  uint32_t ssrcs[kMaxRtcpSsrcs];
+  const size_t num_ssrcs = ParseRtcpSsrcs(packet, length, ssrcs);
+
+  SnapshotPublisher<SsrcTable>::ScopedReader table(&ssrc_tables_);
+  // Deliver the packet once to each stream any of its SSRCs belongs to.
+  VideoReceiveStream* receive_streams[kMaxRtcpSsrcs];
+  size_t num_receive_streams = 0;
+  VideoSendStream* send_streams[kMaxRtcpSsrcs];
+  size_t num_send_streams = 0;
+  for (size_t i = 0; i < num_ssrcs; ++i) {
+    VideoReceiveStream* receive_stream = table->FindReceiveStream(ssrcs[i]);
+    if (receive_stream != NULL &&
+        !Contains(receive_streams, num_receive_streams, receive_stream)) {
+      receive_streams[num_receive_streams++] = receive_stream;
+    }
+    VideoSendStream* send_stream = table->FindSendStream(ssrcs[i]);
+    if (send_stream != NULL &&
+        !Contains(send_streams, num_send_streams, send_stream)) {
+      send_streams[num_send_streams++] = send_stream;
     }
   }
 
-  {
-    ReadLockScoped read_lock(*send_lock_);
-    for (std::map<uint32_t, VideoSendStream*>::iterator it =
-             send_ssrcs_.begin();
-         it != send_ssrcs_.end();
-         ++it) {
-      if (it->second->DeliverRtcp(packet, length))
+  bool rtcp_delivered = false;
+  if (num_receive_streams == 0 && num_send_streams == 0) {
+    // None of the SSRCs is known, e.g. for feedback that only lists the media
+    // sources in its FCI. Let all streams decide.
+    for (size_t i = 0; i < table->receive_streams().size(); ++i) {
+      if (table->receive_streams()[i]->DeliverRtcp(packet, length))
+        rtcp_delivered = true;
+    }
+    for (size_t i = 0; i < table->send_streams().size(); ++i) {
+      if (table->send_streams()[i]->DeliverRtcp(packet, length))
+        rtcp_delivered = true;
+    }
+  } else {
+    for (size_t i = 0; i < num_receive_streams; ++i) {
+      if (receive_streams[i]->DeliverRtcp(packet, length))
+        rtcp_delivered = true;
+    }
+    for (size_t i = 0; i < num_send_streams; ++i) {
+      if (send_streams[i]->DeliverRtcp(packet, length))
         rtcp_delivered = true;
     }
   }
@@ -326,18 +528,14 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(const uint8_t* packet,
   if (length < 12)
     return DELIVERY_PACKET_ERROR;
 
-  const uint8_t* ptr = &packet[8];
-  uint32_t ssrc = ptr[0] << 24 | ptr[1] << 16 | ptr[2] << 8 | ptr[3] ;
-
-  ReadLockScoped read_lock(*receive_lock_);
-  std::map<uint32_t, VideoReceiveStream*>::iterator it =
-      receive_ssrcs_.find(ssrc);
+  const uint32_t ssrc = ReadSsrc(&packet[8]);
 
-  if (it == receive_ssrcs_.end())
+  SnapshotPublisher<SsrcTable>::ScopedReader table(&ssrc_tables_);
+  VideoReceiveStream* receive_stream = table->FindReceiveStream(ssrc);
+  if (receive_stream == NULL)
     return DELIVERY_UNKNOWN_SSRC;
-
-  return it->second->DeliverRtp(packet, length) ? DELIVERY_OK
-                                                : DELIVERY_PACKET_ERROR;
+  return receive_stream->DeliverRtp(packet, length) ? DELIVERY_OK
+                                                    : DELIVERY_PACKET_ERROR;
 }
 
 PacketReceiver::DeliveryStatus Call::DeliverPacket(const uint8_t* packet,
@@ -26,6 +26,7 @@ ReceiveStatisticsProxy::ReceiveStatisticsProxy(uint32_t ssrc,
       codec_(codec),
       rtp_rtcp_(rtp_rtcp),
       crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      stats_version_(1),
       // 1000ms window, scale 1000 for ms to s.
       decode_fps_estimator_(1000, 1000),
       renders_fps_estimator_(1000, 1000) {
@@ -40,15 +41,33 @@ VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
     CriticalSectionScoped lock(crit_.get());
     stats = stats_;
   }
-  stats.c_name = GetCName();
-  codec_->GetReceiveSideDelay(channel_, &stats.avg_delay_ms);
-  stats.discarded_packets = codec_->GetDiscardedPackets(channel_);
-  codec_->GetReceiveCodecStastistics(
-      channel_, stats.key_frames, stats.delta_frames);
-
+  GetChannelStats(&stats);
   return stats;
 }
 
+bool ReceiveStatisticsProxy::GetStatsIfChanged(
+    uint32_t* stats_version,
+    VideoReceiveStream::Stats* stats) const {
+  {
+    CriticalSectionScoped lock(crit_.get());
+    if (*stats_version == stats_version_)
+      return false;
+    *stats = stats_;
+    *stats_version = stats_version_;
+  }
+  GetChannelStats(stats);
+  return true;
+}
+
+void ReceiveStatisticsProxy::GetChannelStats(
+    VideoReceiveStream::Stats* stats) const {
+  stats->c_name = GetCName();
+  codec_->GetReceiveSideDelay(channel_, &stats->avg_delay_ms);
+  stats->discarded_packets = codec_->GetDiscardedPackets(channel_);
+  codec_->GetReceiveCodecStastistics(
+      channel_, stats->key_frames, stats->delta_frames);
+}
+
 std::string ReceiveStatisticsProxy::GetCName() const {
   char rtcp_cname[ViERTP_RTCP::KMaxRTCPCNameLength];
   if (rtp_rtcp_->GetRemoteRTCPCName(channel_, rtcp_cname) != 0)
@@ -62,6 +81,25 @@ void ReceiveStatisticsProxy::IncomingRate(const int video_channel,
   CriticalSectionScoped lock(crit_.get());
   stats_.network_frame_rate = framerate;
   stats_.bitrate_bps = bitrate;
+  ++stats_version_;
+}
+
+void ReceiveStatisticsProxy::DecoderTiming(int decode_ms,
+                                           int max_decode_ms,
+                                           int current_delay_ms,
+                                           int target_delay_ms,
+                                           int jitter_buffer_ms,
+                                           int min_playout_delay_ms,
+                                           int render_delay_ms) {
+  CriticalSectionScoped lock(crit_.get());
+  stats_.decode_ms = decode_ms;
+  stats_.max_decode_ms = max_decode_ms;
+  stats_.current_delay_ms = current_delay_ms;
+  stats_.target_delay_ms = target_delay_ms;
+  stats_.jitter_buffer_ms = jitter_buffer_ms;
+  stats_.min_playout_delay_ms = min_playout_delay_ms;
+  stats_.render_delay_ms = render_delay_ms;
+  ++stats_version_;
 }
 
 void ReceiveStatisticsProxy::StatisticsUpdated(
@@ -70,6 +108,7 @@ void ReceiveStatisticsProxy::StatisticsUpdated(
   CriticalSectionScoped lock(crit_.get());
 
   stats_.rtcp_stats = statistics;
+  ++stats_version_;
 }
 
 void ReceiveStatisticsProxy::DataCountersUpdated(
@@ -78,6 +117,7 @@ void ReceiveStatisticsProxy::DataCountersUpdated(
   CriticalSectionScoped lock(crit_.get());
 
   stats_.rtp_stats = counters;
+  ++stats_version_;
 }
 
 void ReceiveStatisticsProxy::OnDecodedFrame() {
@@ -86,14 +126,21 @@ void ReceiveStatisticsProxy::OnDecodedFrame() {
   CriticalSectionScoped lock(crit_.get());
   decode_fps_estimator_.Update(1, now);
   stats_.decode_frame_rate = decode_fps_estimator_.Rate(now);
+  ++stats_version_;
 }
 
-void ReceiveStatisticsProxy::OnRenderedFrame() {
+void ReceiveStatisticsProxy::OnRenderedFrame(int64_t ntp_time_ms) {
   uint64_t now = clock_->TimeInMilliseconds();
+  int64_t now_ntp_ms = clock_->CurrentNtpInMilliseconds();
 
   CriticalSectionScoped lock(crit_.get());
   renders_fps_estimator_.Update(1, now);
   stats_.render_frame_rate = renders_fps_estimator_.Rate(now);
+  if (ntp_time_ms > 0) {
+    stats_.capture_to_render_delay_ms.Add(
+        static_cast<int>(now_ntp_ms - ntp_time_ms));
+  }
+  ++stats_version_;
 }
 
 }  // namespace internal
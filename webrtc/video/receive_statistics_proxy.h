@@ -44,8 +44,17 @@ class ReceiveStatisticsProxy : public ViEDecoderObserver,
 
   VideoReceiveStream::Stats GetStats() const;
 
+  // Returns false, leaving |stats| as is, if no stats have been reported since
+  // |*stats_version|. Otherwise gets them and updates |*stats_version|. The
+  // stats read from the channel only change as packets come in, so they are
+  // refreshed along with the reported ones.
+  bool GetStatsIfChanged(uint32_t* stats_version,
+                         VideoReceiveStream::Stats* stats) const;
+
   void OnDecodedFrame();
-  void OnRenderedFrame();
+  // |ntp_time_ms| is the capture time of the frame in the local NTP time, or
+  // 0 if not yet known.
+  void OnRenderedFrame(int64_t ntp_time_ms);
 
   // Overrides ViEDecoderObserver.
   virtual void IncomingCodecChanged(const int video_channel,
@@ -59,7 +68,7 @@ class ReceiveStatisticsProxy : public ViEDecoderObserver,
                              int target_delay_ms,
                              int jitter_buffer_ms,
                              int min_playout_delay_ms,
-                             int render_delay_ms) OVERRIDE {}
+                             int render_delay_ms) OVERRIDE;
   virtual void RequestNewKeyFrame(const int video_channel) OVERRIDE {}
 
   // Overrides RtcpStatisticsBallback.
@@ -72,6 +81,8 @@ class ReceiveStatisticsProxy : public ViEDecoderObserver,
 
  private:
   std::string GetCName() const;
+  // Fills in the stats read from the channel rather than reported to us.
+  void GetChannelStats(VideoReceiveStream::Stats* stats) const;
 
   const int channel_;
   Clock* const clock_;
@@ -80,6 +91,8 @@ class ReceiveStatisticsProxy : public ViEDecoderObserver,
 
   scoped_ptr<CriticalSectionWrapper> crit_;
   VideoReceiveStream::Stats stats_ GUARDED_BY(crit_);
+  // Increased with every update of |stats_|.
+  uint32_t stats_version_ GUARDED_BY(crit_);
   RateStatistics decode_fps_estimator_ GUARDED_BY(crit_);
   RateStatistics renders_fps_estimator_ GUARDED_BY(crit_);
 };
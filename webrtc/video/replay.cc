@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Replays the video packets of an rtpdump file into a VideoReceiveStream with
+// the real decoders, for profiling the receive side offline. The file is
+// loaded into memory first so that replaying isn't limited by disk reads.
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "gflags/gflags.h"
+#include "webrtc/call.h"
+#include "webrtc/frame_callback.h"
+#include "webrtc/modules/audio_coding/neteq/tools/packet.h"
+#include "webrtc/modules/audio_coding/neteq/tools/rtp_file_source.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/test/encoder_settings.h"
+#include "webrtc/test/null_transport.h"
+#include "webrtc/video_renderer.h"
+
+namespace webrtc {
+namespace flags {
+
+DEFINE_string(input_file, "", "rtpdump file to replay.");
+std::string InputFile() { return static_cast<std::string>(FLAGS_input_file); }
+
+DEFINE_int32(ssrc, 0, "SSRC of the video stream. 0 uses the first SSRC found.");
+uint32_t Ssrc() { return static_cast<uint32_t>(FLAGS_ssrc); }
+
+DEFINE_string(codec, "VP8", "Name of the video codec of the stream.");
+std::string Codec() { return static_cast<std::string>(FLAGS_codec); }
+
+DEFINE_int32(payload_type, 100, "Payload type of the video stream.");
+int PayloadType() { return static_cast<int>(FLAGS_payload_type); }
+
+DEFINE_int32(abs_send_time_id, 0,
+             "RTP header extension ID of abs-send-time. 0 if not used.");
+int AbsSendTimeId() { return static_cast<int>(FLAGS_abs_send_time_id); }
+
+DEFINE_int32(transmission_offset_id, 0,
+             "RTP header extension ID of toffset. 0 if not used.");
+int TransmissionOffsetId() {
+  return static_cast<int>(FLAGS_transmission_offset_id);
+}
+
+DEFINE_double(speed, 0,
+              "Replay speed relative to the arrival times in the file. 0 "
+              "replays as fast as possible.");
+double Speed() { return FLAGS_speed; }
+
+DEFINE_int32(drain_ms, 1000,
+             "Time to wait for the last frames to be decoded after the last "
+             "packet.");
+int DrainMs() { return static_cast<int>(FLAGS_drain_ms); }
+}  // namespace flags
+
+static const uint32_t kReceiverLocalSsrc = 0x123456;
+
+// Counts the frames assembled by the jitter buffer and the frames decoded.
+class FrameCounter : public EncodedFrameObserver, public VideoRenderer {
+ public:
+  FrameCounter()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        assembled_frames_(0),
+        decoded_frames_(0) {}
+
+  virtual void EncodedFrameCallback(const EncodedFrame& encoded_frame)
+      OVERRIDE {
+    CriticalSectionScoped lock(crit_.get());
+    ++assembled_frames_;
+  }
+
+  virtual void RenderFrame(const I420VideoFrame& video_frame,
+                           int time_to_render_ms) OVERRIDE {
+    CriticalSectionScoped lock(crit_.get());
+    ++decoded_frames_;
+  }
+
+  int assembled_frames() const {
+    CriticalSectionScoped lock(crit_.get());
+    return assembled_frames_;
+  }
+
+  int decoded_frames() const {
+    CriticalSectionScoped lock(crit_.get());
+    return decoded_frames_;
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  int assembled_frames_;
+  int decoded_frames_;
+};
+
+static bool LoadPackets(ScopedVector<test::Packet>* packets) {
+  scoped_ptr<test::RtpFileSource> source(
+      test::RtpFileSource::Create(flags::InputFile()));
+  if (!source) {
+    fprintf(stderr, "Cannot open %s.\n", flags::InputFile().c_str());
+    return false;
+  }
+  if (flags::AbsSendTimeId() != 0) {
+    source->RegisterRtpHeaderExtension(kRtpExtensionAbsoluteSendTime,
+                                       flags::AbsSendTimeId());
+  }
+  if (flags::TransmissionOffsetId() != 0) {
+    source->RegisterRtpHeaderExtension(kRtpExtensionTransmissionTimeOffset,
+                                       flags::TransmissionOffsetId());
+  }
+  while (test::Packet* packet = source->NextPacket()) {
+    // Only full packets from the video stream can be decoded.
+    if (packet->payload_length_bytes() == 0 ||
+        packet->header().payloadType != flags::PayloadType()) {
+      delete packet;
+      continue;
+    }
+    packets->push_back(packet);
+  }
+  return true;
+}
+
+void Replay() {
+  ScopedVector<test::Packet> packets;
+  if (!LoadPackets(&packets))
+    return;
+  if (packets.empty()) {
+    fprintf(stderr, "No packets with payload type %d.\n",
+            flags::PayloadType());
+    return;
+  }
+  const uint32_t ssrc =
+      flags::Ssrc() != 0 ? flags::Ssrc() : packets[0]->header().ssrc;
+
+  test::NullTransport transport;
+  scoped_ptr<Call> call(Call::Create(Call::Config(&transport)));
+
+  FrameCounter counter;
+  VideoReceiveStream::Config receive_config;
+  receive_config.rtp.remote_ssrc = ssrc;
+  receive_config.rtp.local_ssrc = kReceiverLocalSsrc;
+  if (flags::AbsSendTimeId() != 0) {
+    receive_config.rtp.extensions.push_back(
+        RtpExtension(RtpExtension::kAbsSendTime, flags::AbsSendTimeId()));
+  }
+  if (flags::TransmissionOffsetId() != 0) {
+    receive_config.rtp.extensions.push_back(RtpExtension(
+        RtpExtension::kTOffset, flags::TransmissionOffsetId()));
+  }
+  receive_config.renderer = &counter;
+  receive_config.pre_decode_callback = &counter;
+  VideoSendStream::Config::EncoderSettings encoder_settings;
+  encoder_settings.payload_name = flags::Codec();
+  encoder_settings.payload_type = flags::PayloadType();
+  receive_config.codecs.push_back(
+      test::CreateDecoderVideoCodec(encoder_settings));
+
+  VideoReceiveStream* receive_stream =
+      call->CreateVideoReceiveStream(receive_config);
+  receive_stream->Start();
+
+  Clock* clock = Clock::GetRealTimeClock();
+  const int64_t start_ms = clock->TimeInMilliseconds();
+  const double first_packet_ms = packets[0]->time_ms();
+  int num_packets = 0;
+  size_t num_bytes = 0;
+  int num_unknown_ssrc = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    const test::Packet& packet = *packets[i];
+    if (packet.header().ssrc != ssrc)
+      continue;
+    if (flags::Speed() > 0) {
+      const int64_t send_time_ms = start_ms + static_cast<int64_t>(
+          (packet.time_ms() - first_packet_ms) / flags::Speed());
+      const int64_t wait_ms = send_time_ms - clock->TimeInMilliseconds();
+      if (wait_ms > 0)
+        SleepMs(static_cast<int>(wait_ms));
+    }
+    // The header precedes the payload in the memory of the packet.
+    const uint8_t* rtp_packet =
+        packet.payload() - packet.header().headerLength;
+    if (call->Receiver()->DeliverPacket(rtp_packet,
+                                        packet.packet_length_bytes()) ==
+        PacketReceiver::DELIVERY_UNKNOWN_SSRC) {
+      ++num_unknown_ssrc;
+    }
+    ++num_packets;
+    num_bytes += packet.packet_length_bytes();
+  }
+  const int64_t feed_ms = clock->TimeInMilliseconds() - start_ms;
+
+  // Wait until decoding stops making progress.
+  int decoded_frames = counter.decoded_frames();
+  for (int waited_ms = 0; waited_ms < flags::DrainMs(); waited_ms += 100) {
+    SleepMs(100);
+    if (counter.decoded_frames() == decoded_frames)
+      break;
+    decoded_frames = counter.decoded_frames();
+  }
+  const int64_t elapsed_ms =
+      std::max<int64_t>(clock->TimeInMilliseconds() - start_ms, 1);
+  const VideoReceiveStream::Stats stats = receive_stream->GetStats();
+
+  receive_stream->Stop();
+  call->DestroyVideoReceiveStream(receive_stream);
+
+  const double elapsed_s = elapsed_ms / 1000.0;
+  printf("Replayed %d packets (%d with unknown SSRC), %.1f kB, in %d ms.\n",
+         num_packets, num_unknown_ssrc,
+         num_bytes / 1000.0, static_cast<int>(feed_ms));
+  printf("Packet throughput: %.0f packets/s, %.0f kbps.\n",
+         num_packets / elapsed_s, num_bytes * 8 / 1000.0 / elapsed_s);
+  printf("Assembled frames: %d, %.1f fps.\n", counter.assembled_frames(),
+         counter.assembled_frames() / elapsed_s);
+  printf("Decoded frames: %d, %.1f fps.\n", counter.decoded_frames(),
+         counter.decoded_frames() / elapsed_s);
+  printf("Decode time: %d ms average, %d ms max.\n", stats.decode_ms,
+         stats.max_decode_ms);
+}
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  if (webrtc::flags::InputFile().empty()) {
+    fprintf(stderr, "Usage: %s --input_file=<rtpdump file>\n", argv[0]);
+    return 1;
+  }
+  webrtc::Replay();
+  return 0;
+}
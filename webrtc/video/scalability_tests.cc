@@ -0,0 +1,475 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "webrtc/call.h"
+#include "webrtc/modules/rtp_rtcp/interface/rtp_header_parser.h"
+#include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/scoped_vector.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_annotations.h"
+#include "webrtc/test/direct_transport.h"
+#include "webrtc/test/encoder_settings.h"
+#include "webrtc/test/fake_audio_device.h"
+#include "webrtc/test/fake_decoder.h"
+#include "webrtc/test/fake_encoder.h"
+#include "webrtc/test/frame_generator_capturer.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/video/transport_adapter.h"
+#include "webrtc/voice_engine/include/voe_base.h"
+#include "webrtc/voice_engine/include/voe_codec.h"
+#include "webrtc/voice_engine/include/voe_network.h"
+#include "webrtc/voice_engine/include/voe_rtp_rtcp.h"
+
+namespace webrtc {
+
+static const int kScalabilityTestWarmupMs = 2000;
+static const int kScalabilityTestDurationMs = 10000;
+
+static const uint32_t kFirstVideoSsrc = 0x10000;
+static const uint32_t kFirstReceiverSsrc = 0x20000;
+static const uint32_t kFirstAudioSsrc = 0x30000;
+static const uint8_t kVp8PayloadType = 124;
+static const uint8_t kFakePayloadType = 125;
+
+struct ScalabilityTestParams {
+  const char* test_label;
+  size_t num_streams;
+  bool use_vp8;
+  bool with_audio;
+};
+
+// Resource usage of the whole process. Fields that can't be read on this
+// platform are -1.
+struct ProcessUsage {
+  int64_t cpu_time_us;
+  int num_threads;
+  int rss_kb;
+};
+
+static ProcessUsage GetProcessUsage() {
+  ProcessUsage usage = {-1, -1, -1};
+#if defined(WEBRTC_POSIX)
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) == 0) {
+    usage.cpu_time_us =
+        (rusage.ru_utime.tv_sec + rusage.ru_stime.tv_sec) * 1000000LL +
+        rusage.ru_utime.tv_usec + rusage.ru_stime.tv_usec;
+  }
+#endif
+#if defined(WEBRTC_LINUX)
+  FILE* status = fopen("/proc/self/status", "r");
+  if (status != NULL) {
+    char line[256];
+    while (fgets(line, sizeof(line), status) != NULL) {
+      sscanf(line, "Threads: %d", &usage.num_threads);
+      sscanf(line, "VmRSS: %d kB", &usage.rss_kb);
+    }
+    fclose(status);
+  }
+#endif
+  return usage;
+}
+
+// Measures the delay of the frames of one stream, from when they are captured
+// until they are rendered.
+class StreamLatencyObserver : public VideoSendStreamInput,
+                              public VideoRenderer {
+ public:
+  StreamLatencyObserver()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        input_(NULL),
+        first_frame_timestamp_(0),
+        has_first_frame_(false),
+        rtp_timestamp_delta_(0),
+        has_rtp_timestamp_delta_(false) {}
+
+  void SetInput(VideoSendStreamInput* input) { input_ = input; }
+
+  virtual void SwapFrame(I420VideoFrame* video_frame) OVERRIDE {
+    {
+      CriticalSectionScoped lock(crit_.get());
+      // The send stream derives the RTP timestamp from the render time.
+      uint32_t timestamp =
+          90 * static_cast<uint32_t>(video_frame->render_time_ms());
+      if (!has_first_frame_) {
+        first_frame_timestamp_ = timestamp;
+        has_first_frame_ = true;
+      }
+      capture_times_[timestamp] = video_frame->render_time_ms();
+    }
+    input_->SwapFrame(video_frame);
+  }
+
+  // Called for every RTP packet of this stream that is sent.
+  void OnRtpPacketSent(uint32_t rtp_timestamp) {
+    CriticalSectionScoped lock(crit_.get());
+    if (has_rtp_timestamp_delta_ || !has_first_frame_)
+      return;
+    rtp_timestamp_delta_ = rtp_timestamp - first_frame_timestamp_;
+    has_rtp_timestamp_delta_ = true;
+  }
+
+  virtual void RenderFrame(const I420VideoFrame& video_frame,
+                           int time_to_render_ms) OVERRIDE {
+    int64_t render_time_ms =
+        Clock::GetRealTimeClock()->CurrentNtpInMilliseconds();
+    CriticalSectionScoped lock(crit_.get());
+    if (!has_rtp_timestamp_delta_)
+      return;
+    std::map<uint32_t, int64_t>::iterator it =
+        capture_times_.find(video_frame.timestamp() - rtp_timestamp_delta_);
+    if (it == capture_times_.end())
+      return;
+    delays_ms_.push_back(render_time_ms - it->second);
+    capture_times_.erase(capture_times_.begin(), ++it);
+  }
+
+  void ResetDelays() {
+    CriticalSectionScoped lock(crit_.get());
+    delays_ms_.clear();
+  }
+
+  void AppendDelays(std::vector<int64_t>* delays_ms) {
+    CriticalSectionScoped lock(crit_.get());
+    delays_ms->insert(delays_ms->end(), delays_ms_.begin(), delays_ms_.end());
+  }
+
+ private:
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  VideoSendStreamInput* input_;
+  std::map<uint32_t, int64_t> capture_times_ GUARDED_BY(crit_);
+  uint32_t first_frame_timestamp_ GUARDED_BY(crit_);
+  bool has_first_frame_ GUARDED_BY(crit_);
+  uint32_t rtp_timestamp_delta_ GUARDED_BY(crit_);
+  bool has_rtp_timestamp_delta_ GUARDED_BY(crit_);
+  std::vector<int64_t> delays_ms_ GUARDED_BY(crit_);
+};
+
+// Carries the video of all the streams to the receiving call, and tells the
+// observer of each stream when its packets are sent.
+class VideoSendTransport : public test::DirectTransport {
+ public:
+  explicit VideoSendTransport(
+      const ScopedVector<StreamLatencyObserver>* observers)
+      : observers_(observers), parser_(RtpHeaderParser::Create()) {}
+
+  virtual bool SendRtp(const uint8_t* packet, size_t length) OVERRIDE {
+    RTPHeader header;
+    if (parser_->Parse(packet, length, &header) &&
+        header.ssrc - kFirstVideoSsrc < observers_->size()) {
+      (*observers_)[header.ssrc - kFirstVideoSsrc]->OnRtpPacketSent(
+          header.timestamp);
+    }
+    return test::DirectTransport::SendRtp(packet, length);
+  }
+
+ private:
+  const ScopedVector<StreamLatencyObserver>* const observers_;
+  const scoped_ptr<RtpHeaderParser> parser_;
+};
+
+// Delivers the audio packets of every channel back to the same channel.
+class AudioLoopbackReceiver : public PacketReceiver {
+ public:
+  explicit AudioLoopbackReceiver(VoENetwork* voe_network)
+      : voe_network_(voe_network), parser_(RtpHeaderParser::Create()) {}
+
+  void AddChannel(uint32_t ssrc, int channel) { channels_[ssrc] = channel; }
+
+  virtual DeliveryStatus DeliverPacket(const uint8_t* packet,
+                                       size_t length) OVERRIDE {
+    // RTCP packets start with the SSRC of their sender, RTP packets have it
+    // at offset 8.
+    const bool is_rtcp = parser_->IsRtcp(packet, static_cast<int>(length));
+    const size_t ssrc_offset = is_rtcp ? 4 : 8;
+    if (length < ssrc_offset + 4)
+      return DELIVERY_PACKET_ERROR;
+    const uint32_t ssrc = (packet[ssrc_offset] << 24) |
+                          (packet[ssrc_offset + 1] << 16) |
+                          (packet[ssrc_offset + 2] << 8) |
+                          packet[ssrc_offset + 3];
+    std::map<uint32_t, int>::const_iterator it = channels_.find(ssrc);
+    if (it == channels_.end())
+      return DELIVERY_UNKNOWN_SSRC;
+    int ret;
+    if (is_rtcp) {
+      ret = voe_network_->ReceivedRTCPPacket(
+          it->second, packet, static_cast<unsigned int>(length));
+    } else {
+      ret = voe_network_->ReceivedRTPPacket(
+          it->second, packet, static_cast<unsigned int>(length),
+          PacketTime());
+    }
+    return ret == 0 ? DELIVERY_OK : DELIVERY_PACKET_ERROR;
+  }
+
+ private:
+  VoENetwork* const voe_network_;
+  const scoped_ptr<RtpHeaderParser> parser_;
+  std::map<uint32_t, int> channels_;
+};
+
+class ScalabilityTest : public ::testing::Test {
+ protected:
+  void RunTest(const ScalabilityTestParams& params);
+
+  void PrintResult(const char* measurement,
+                   const ScalabilityTestParams& params,
+                   double value,
+                   const char* units) {
+    char value_string[32];
+    snprintf(value_string, sizeof(value_string), "%.2f", value);
+    webrtc::test::PrintResult(
+        measurement, "", params.test_label, value_string, units, false);
+  }
+};
+
+void ScalabilityTest::RunTest(const ScalabilityTestParams& params) {
+  Clock* clock = Clock::GetRealTimeClock();
+  const ProcessUsage usage_before_streams = GetProcessUsage();
+
+  ScopedVector<StreamLatencyObserver> observers;
+  for (size_t i = 0; i < params.num_streams; ++i)
+    observers.push_back(new StreamLatencyObserver());
+
+  VideoSendTransport send_transport(&observers);
+  test::DirectTransport receive_transport;
+  scoped_ptr<Call> sender_call(Call::Create(Call::Config(&send_transport)));
+  scoped_ptr<Call> receiver_call(
+      Call::Create(Call::Config(&receive_transport)));
+  send_transport.SetReceiver(receiver_call->Receiver());
+  receive_transport.SetReceiver(sender_call->Receiver());
+
+  ScopedVector<VideoEncoder> encoders;
+  ScopedVector<test::FakeDecoder> decoders;
+  ScopedVector<test::FrameGeneratorCapturer> capturers;
+  std::vector<VideoSendStream*> send_streams;
+  std::vector<VideoReceiveStream*> receive_streams;
+  for (size_t i = 0; i < params.num_streams; ++i) {
+    VideoSendStream::Config send_config;
+    if (params.use_vp8) {
+      encoders.push_back(VP8Encoder::Create());
+      send_config.encoder_settings.payload_name = "VP8";
+      send_config.encoder_settings.payload_type = kVp8PayloadType;
+    } else {
+      encoders.push_back(new test::FakeEncoder(clock));
+      send_config.encoder_settings.payload_name = "FAKE";
+      send_config.encoder_settings.payload_type = kFakePayloadType;
+    }
+    send_config.encoder_settings.encoder = encoders.back();
+    send_config.rtp.ssrcs.push_back(kFirstVideoSsrc + i);
+    std::vector<VideoStream> video_streams = test::CreateVideoStreams(1);
+    send_streams.push_back(
+        sender_call->CreateVideoSendStream(send_config, video_streams, NULL));
+    observers[i]->SetInput(send_streams.back()->Input());
+
+    VideoReceiveStream::Config receive_config;
+    receive_config.codecs.push_back(
+        test::CreateDecoderVideoCodec(send_config.encoder_settings));
+    receive_config.rtp.local_ssrc = kFirstReceiverSsrc + i;
+    receive_config.rtp.remote_ssrc = kFirstVideoSsrc + i;
+    receive_config.renderer = observers[i];
+    if (!params.use_vp8) {
+      decoders.push_back(new test::FakeDecoder());
+      receive_config.external_decoders.resize(1);
+      receive_config.external_decoders[0].payload_type = kFakePayloadType;
+      receive_config.external_decoders[0].decoder = decoders.back();
+    }
+    receive_streams.push_back(
+        receiver_call->CreateVideoReceiveStream(receive_config));
+
+    capturers.push_back(
+        test::FrameGeneratorCapturer::Create(observers[i],
+                                             video_streams[0].width,
+                                             video_streams[0].height,
+                                             video_streams[0].max_framerate,
+                                             clock));
+  }
+
+  // Every stream gets an audio channel that plays out what it sends, with all
+  // the channels sharing one transport.
+  VoiceEngine* voice_engine = NULL;
+  VoEBase* voe_base = NULL;
+  VoECodec* voe_codec = NULL;
+  VoENetwork* voe_network = NULL;
+  VoERTP_RTCP* voe_rtp_rtcp = NULL;
+  scoped_ptr<test::FakeAudioDevice> fake_audio_device;
+  scoped_ptr<AudioLoopbackReceiver> audio_receiver;
+  test::DirectTransport audio_transport;
+  ScopedVector<internal::TransportAdapter> audio_transport_adapters;
+  std::vector<int> audio_channels;
+  if (params.with_audio) {
+    voice_engine = VoiceEngine::Create();
+    voe_base = VoEBase::GetInterface(voice_engine);
+    voe_codec = VoECodec::GetInterface(voice_engine);
+    voe_network = VoENetwork::GetInterface(voice_engine);
+    voe_rtp_rtcp = VoERTP_RTCP::GetInterface(voice_engine);
+    const std::string audio_filename =
+        test::ResourcePath("voice_engine/audio_long16", "pcm");
+    ASSERT_STRNE("", audio_filename.c_str());
+    fake_audio_device.reset(new test::FakeAudioDevice(clock, audio_filename));
+    EXPECT_EQ(0, voe_base->Init(fake_audio_device.get(), NULL));
+    audio_receiver.reset(new AudioLoopbackReceiver(voe_network));
+    audio_transport.SetReceiver(audio_receiver.get());
+
+    CodecInst isac = {103, "ISAC", 16000, 480, 1, 32000};
+    for (size_t i = 0; i < params.num_streams; ++i) {
+      int channel = voe_base->CreateChannel();
+      ASSERT_NE(-1, channel);
+      audio_channels.push_back(channel);
+      EXPECT_EQ(0, voe_codec->SetSendCodec(channel, isac));
+      EXPECT_EQ(0, voe_rtp_rtcp->SetLocalSSRC(channel, kFirstAudioSsrc + i));
+      audio_receiver->AddChannel(kFirstAudioSsrc + i, channel);
+      audio_transport_adapters.push_back(
+          new internal::TransportAdapter(&audio_transport));
+      audio_transport_adapters.back()->Enable();
+      EXPECT_EQ(0, voe_network->RegisterExternalTransport(
+                       channel, *audio_transport_adapters.back()));
+    }
+  }
+
+  for (size_t i = 0; i < params.num_streams; ++i) {
+    send_streams[i]->Start();
+    receive_streams[i]->Start();
+    capturers[i]->Start();
+  }
+  if (params.with_audio) {
+    fake_audio_device->Start();
+    for (size_t i = 0; i < audio_channels.size(); ++i) {
+      EXPECT_EQ(0, voe_base->StartPlayout(audio_channels[i]));
+      EXPECT_EQ(0, voe_base->StartReceive(audio_channels[i]));
+      EXPECT_EQ(0, voe_base->StartSend(audio_channels[i]));
+    }
+  }
+
+  // Leave out the delays and CPU of starting up.
+  SleepMs(kScalabilityTestWarmupMs);
+  for (size_t i = 0; i < observers.size(); ++i)
+    observers[i]->ResetDelays();
+  const ProcessUsage usage_before = GetProcessUsage();
+  SleepMs(kScalabilityTestDurationMs);
+  const ProcessUsage usage_after = GetProcessUsage();
+
+  std::vector<int64_t> delays_ms;
+  for (size_t i = 0; i < observers.size(); ++i)
+    observers[i]->AppendDelays(&delays_ms);
+
+  if (params.with_audio) {
+    for (size_t i = 0; i < audio_channels.size(); ++i) {
+      EXPECT_EQ(0, voe_base->StopSend(audio_channels[i]));
+      EXPECT_EQ(0, voe_base->StopReceive(audio_channels[i]));
+      EXPECT_EQ(0, voe_base->StopPlayout(audio_channels[i]));
+    }
+    fake_audio_device->Stop();
+  }
+  for (size_t i = 0; i < params.num_streams; ++i) {
+    capturers[i]->Stop();
+    receive_streams[i]->Stop();
+    send_streams[i]->Stop();
+  }
+  send_transport.StopSending();
+  receive_transport.StopSending();
+  audio_transport.StopSending();
+
+  if (params.with_audio) {
+    for (size_t i = 0; i < audio_channels.size(); ++i) {
+      voe_network->DeRegisterExternalTransport(audio_channels[i]);
+      voe_base->DeleteChannel(audio_channels[i]);
+    }
+    voe_base->Terminate();
+    voe_base->Release();
+    voe_codec->Release();
+    voe_network->Release();
+    voe_rtp_rtcp->Release();
+    VoiceEngine::Delete(voice_engine);
+  }
+  for (size_t i = 0; i < params.num_streams; ++i) {
+    sender_call->DestroyVideoSendStream(send_streams[i]);
+    receiver_call->DestroyVideoReceiveStream(receive_streams[i]);
+  }
+
+  const double num_streams = static_cast<double>(params.num_streams);
+  const double duration_secs = kScalabilityTestDurationMs / 1000.0;
+  ASSERT_FALSE(delays_ms.empty()) << "No frames were rendered.";
+  PrintResult("rendered_fps_per_stream", params,
+              delays_ms.size() / duration_secs / num_streams, " fps");
+  std::sort(delays_ms.begin(), delays_ms.end());
+  PrintResult("end_to_end_delay_p50", params,
+              delays_ms[delays_ms.size() / 2], " ms");
+  PrintResult("end_to_end_delay_p99", params,
+              delays_ms[delays_ms.size() * 99 / 100], " ms");
+
+  if (usage_after.cpu_time_us >= 0) {
+    // In percent of one core.
+    const double cpu_usage =
+        (usage_after.cpu_time_us - usage_before.cpu_time_us) /
+        (duration_secs * 10000.0);
+    PrintResult("cpu_usage_per_stream", params, cpu_usage / num_streams, " %");
+  }
+  if (usage_after.num_threads >= 0) {
+    PrintResult("num_threads", params, usage_after.num_threads, " threads");
+    PrintResult("threads_per_stream", params,
+                (usage_after.num_threads - usage_before_streams.num_threads) /
+                    num_streams,
+                " threads");
+  }
+  if (usage_after.rss_kb >= 0) {
+    PrintResult("memory_per_stream", params,
+                (usage_after.rss_kb - usage_before_streams.rss_kb) /
+                    num_streams,
+                " kB");
+  }
+}
+
+TEST_F(ScalabilityTest, FakeCodecOneStream) {
+  ScalabilityTestParams params = {"fake_codec_1_stream", 1, false, true};
+  RunTest(params);
+}
+
+TEST_F(ScalabilityTest, FakeCodecFourStreams) {
+  ScalabilityTestParams params = {"fake_codec_4_streams", 4, false, true};
+  RunTest(params);
+}
+
+TEST_F(ScalabilityTest, FakeCodecSixteenStreams) {
+  ScalabilityTestParams params = {"fake_codec_16_streams", 16, false, true};
+  RunTest(params);
+}
+
+TEST_F(ScalabilityTest, FakeCodecSixteenVideoOnlyStreams) {
+  ScalabilityTestParams params = {
+      "fake_codec_16_video_only_streams", 16, false, false};
+  RunTest(params);
+}
+
+TEST_F(ScalabilityTest, Vp8FourStreams) {
+  ScalabilityTestParams params = {"vp8_4_streams", 4, true, true};
+  RunTest(params);
+}
+
+}  // namespace webrtc
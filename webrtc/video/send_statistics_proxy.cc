@@ -19,7 +19,8 @@ namespace webrtc {
 SendStatisticsProxy::SendStatisticsProxy(
     const VideoSendStream::Config& config)
     : config_(config),
-      crit_(CriticalSectionWrapper::CreateCriticalSection()) {
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      stats_version_(1) {
 }
 
 SendStatisticsProxy::~SendStatisticsProxy() {}
@@ -29,17 +30,20 @@ void SendStatisticsProxy::OutgoingRate(const int video_channel,
                                        const unsigned int bitrate) {
   CriticalSectionScoped lock(crit_.get());
   stats_.encode_frame_rate = framerate;
+  ++stats_version_;
 }
 
 void SendStatisticsProxy::SuspendChange(int video_channel, bool is_suspended) {
   CriticalSectionScoped lock(crit_.get());
   stats_.suspended = is_suspended;
+  ++stats_version_;
 }
 
 void SendStatisticsProxy::CapturedFrameRate(const int capture_id,
                                             const unsigned char frame_rate) {
   CriticalSectionScoped lock(crit_.get());
   stats_.input_frame_rate = frame_rate;
+  ++stats_version_;
 }
 
 VideoSendStream::Stats SendStatisticsProxy::GetStats() const {
@@ -47,6 +51,17 @@ VideoSendStream::Stats SendStatisticsProxy::GetStats() const {
   return stats_;
 }
 
+bool SendStatisticsProxy::GetStatsIfChanged(
+    uint32_t* stats_version,
+    VideoSendStream::Stats* stats) const {
+  CriticalSectionScoped lock(crit_.get());
+  if (*stats_version == stats_version_)
+    return false;
+  *stats = stats_;
+  *stats_version = stats_version_;
+  return true;
+}
+
 StreamStats* SendStatisticsProxy::GetStatsEntry(uint32_t ssrc) {
   std::map<uint32_t, StreamStats>::iterator it = stats_.substreams.find(ssrc);
   if (it != stats_.substreams.end())
@@ -67,6 +82,7 @@ void SendStatisticsProxy::StatisticsUpdated(const RtcpStatistics& statistics,
     return;
 
   stats->rtcp_stats = statistics;
+  ++stats_version_;
 }
 
 void SendStatisticsProxy::DataCountersUpdated(
@@ -78,6 +94,7 @@ void SendStatisticsProxy::DataCountersUpdated(
     return;
 
   stats->rtp_stats = counters;
+  ++stats_version_;
 }
 
 void SendStatisticsProxy::Notify(const BitrateStatistics& bitrate,
@@ -88,6 +105,7 @@ void SendStatisticsProxy::Notify(const BitrateStatistics& bitrate,
     return;
 
   stats->bitrate_bps = bitrate.bitrate_bps;
+  ++stats_version_;
 }
 
 void SendStatisticsProxy::FrameCountUpdated(FrameType frame_type,
@@ -110,6 +128,7 @@ void SendStatisticsProxy::FrameCountUpdated(FrameType frame_type,
     case kAudioFrameCN:
       break;
   }
+  ++stats_version_;
 }
 
 void SendStatisticsProxy::SendSideDelayUpdated(int avg_delay_ms,
@@ -121,6 +140,7 @@ void SendStatisticsProxy::SendSideDelayUpdated(int avg_delay_ms,
     return;
   stats->avg_delay_ms = avg_delay_ms;
   stats->max_delay_ms = max_delay_ms;
+  ++stats_version_;
 }
 
 }  // namespace webrtc
@@ -37,6 +37,11 @@ class SendStatisticsProxy : public RtcpStatisticsCallback,
 
   VideoSendStream::Stats GetStats() const;
 
+  // Returns false, leaving |stats| as is, if the stats haven't changed since
+  // |*stats_version|. Otherwise copies them and updates |*stats_version|.
+  bool GetStatsIfChanged(uint32_t* stats_version,
+                         VideoSendStream::Stats* stats) const;
+
  protected:
   // From RtcpStatisticsCallback.
   virtual void StatisticsUpdated(const RtcpStatistics& statistics,
@@ -80,6 +85,8 @@ class SendStatisticsProxy : public RtcpStatisticsCallback,
   const VideoSendStream::Config config_;
   scoped_ptr<CriticalSectionWrapper> crit_;
   VideoSendStream::Stats stats_ GUARDED_BY(crit_);
+  // Increased with every update of |stats_|.
+  uint32_t stats_version_ GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
@@ -134,6 +134,19 @@ TEST_F(SendStatisticsProxyTest, Suspended) {
   EXPECT_FALSE(statistics_proxy_->GetStats().suspended);
 }
 
+TEST_F(SendStatisticsProxyTest, StatsIfChanged) {
+  uint32_t stats_version = 0;
+  VideoSendStream::Stats stats;
+  EXPECT_TRUE(statistics_proxy_->GetStatsIfChanged(&stats_version, &stats));
+  EXPECT_FALSE(statistics_proxy_->GetStatsIfChanged(&stats_version, &stats));
+
+  ViEEncoderObserver* encoder_observer = statistics_proxy_.get();
+  encoder_observer->OutgoingRate(0, 29, 0);
+  EXPECT_TRUE(statistics_proxy_->GetStatsIfChanged(&stats_version, &stats));
+  EXPECT_EQ(29, stats.encode_frame_rate);
+  EXPECT_FALSE(statistics_proxy_->GetStatsIfChanged(&stats_version, &stats));
+}
+
 TEST_F(SendStatisticsProxyTest, FrameCounts) {
   FrameCountObserver* observer = statistics_proxy_.get();
   for (std::vector<uint32_t>::const_iterator it = config_.rtp.ssrcs.begin();
@@ -232,6 +232,11 @@ VideoReceiveStream::Stats VideoReceiveStream::GetStats() const {
   return stats_proxy_->GetStats();
 }
 
+bool VideoReceiveStream::GetStatsIfChanged(uint32_t* stats_version,
+                                           Stats* stats) const {
+  return stats_proxy_->GetStatsIfChanged(stats_version, stats);
+}
+
 void VideoReceiveStream::GetCurrentReceiveCodec(VideoCodec* receive_codec) {
   // TODO(pbos): Implement
 }
@@ -260,7 +265,7 @@ int32_t VideoReceiveStream::RenderFrame(const uint32_t stream_id,
         video_frame,
         video_frame.render_time_ms() - clock_->TimeInMilliseconds());
 
-  stats_proxy_->OnRenderedFrame();
+  stats_proxy_->OnRenderedFrame(video_frame.ntp_time_ms());
 
   return 0;
 }
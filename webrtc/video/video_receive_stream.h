@@ -52,6 +52,8 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   virtual void Start() OVERRIDE;
   virtual void Stop() OVERRIDE;
   virtual Stats GetStats() const OVERRIDE;
+  virtual bool GetStatsIfChanged(uint32_t* stats_version,
+                                 Stats* stats) const OVERRIDE;
 
   virtual void GetCurrentReceiveCodec(VideoCodec* receive_codec) OVERRIDE;
 
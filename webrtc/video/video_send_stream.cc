@@ -397,7 +397,29 @@ bool VideoSendStream::DeliverRtcp(const uint8_t* packet, size_t length) {
 }
 
 VideoSendStream::Stats VideoSendStream::GetStats() const {
-  return stats_proxy_.GetStats();
+  Stats stats = stats_proxy_.GetStats();
+  GetEncoderLoadStats(&stats);
+  return stats;
+}
+
+bool VideoSendStream::GetStatsIfChanged(uint32_t* stats_version,
+                                        Stats* stats) const {
+  // The encoder load is only refreshed along with the reported stats.
+  if (!stats_proxy_.GetStatsIfChanged(stats_version, stats))
+    return false;
+  GetEncoderLoadStats(stats);
+  return true;
+}
+
+void VideoSendStream::GetEncoderLoadStats(Stats* stats) const {
+  stats->frames_dropped_by_rate_control =
+      codec_->GetFramesDroppedByRateControl(channel_);
+  CpuOveruseMetrics metrics;
+  if (video_engine_base_->GetCpuOveruseMetrics(channel_, &metrics) != 0)
+    return;
+  stats->avg_encode_time_ms = metrics.avg_encode_time_ms;
+  stats->encode_usage_percent = metrics.encode_usage_percent;
+  stats->capture_queue_delay_ms_per_s = metrics.capture_queue_delay_ms_per_s;
 }
 
 void VideoSendStream::ConfigureSsrcs() {
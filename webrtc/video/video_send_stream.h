@@ -59,6 +59,8 @@ class VideoSendStream : public webrtc::VideoSendStream,
                                        const void* encoder_settings) OVERRIDE;
 
   virtual Stats GetStats() const OVERRIDE;
+  virtual bool GetStatsIfChanged(uint32_t* stats_version,
+                                 Stats* stats) const OVERRIDE;
 
   bool DeliverRtcp(const uint8_t* packet, size_t length);
 
@@ -73,6 +75,9 @@ class VideoSendStream : public webrtc::VideoSendStream,
 
  private:
   void ConfigureSsrcs();
+  // Fills in the encoder load and rate control drops, which are measured by
+  // the channel rather than reported to |stats_proxy_|.
+  void GetEncoderLoadStats(Stats* stats) const;
   TransportAdapter transport_adapter_;
   EncodedFrameCallbackAdapter encoded_frame_proxy_;
   const VideoSendStream::Config config_;
@@ -33,6 +33,7 @@ class RtcpObserver : public RtcpRttStats {
   }
 
   virtual uint32_t LastProcessedRtt() const {
+    // Doesn't take the lock of |owner_|.
     return owner_->last_processed_rtt_ms();
   }
 
@@ -78,21 +79,27 @@ int32_t CallStats::Process() {
       max_rtt = it->rtt;
   }
 
-  // If there is a valid rtt, update all observers.
+  // If there is a valid rtt, update all observers not within their threshold
+  // of the last rtt they got.
   if (max_rtt > 0) {
-    for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
+    for (std::list<ObserverInfo>::iterator it = observers_.begin();
          it != observers_.end(); ++it) {
-      (*it)->OnRttUpdate(max_rtt);
+      const uint32_t rtt_change = max_rtt > it->last_rtt_ms ?
+          max_rtt - it->last_rtt_ms : it->last_rtt_ms - max_rtt;
+      if (it->last_rtt_ms != 0 && rtt_change < it->rtt_threshold_ms)
+        continue;
+      it->observer->OnRttUpdate(max_rtt);
+      it->last_rtt_ms = max_rtt;
     }
   }
-  last_processed_rtt_ms_ = max_rtt;
+  last_processed_rtt_ms_.CompareExchange(
+      static_cast<int32_t>(max_rtt), last_processed_rtt_ms_.Value());
   last_process_time_ = time_now;
   return 0;
 }
 
 uint32_t CallStats::last_processed_rtt_ms() const {
-  CriticalSectionScoped cs(crit_.get());
-  return last_processed_rtt_ms_;
+  return static_cast<uint32_t>(last_processed_rtt_ms_.Value());
 }
 
 RtcpRttStats* CallStats::rtcp_rtt_stats() const {
@@ -100,20 +107,25 @@ RtcpRttStats* CallStats::rtcp_rtt_stats() const {
 }
 
 void CallStats::RegisterStatsObserver(CallStatsObserver* observer) {
+  RegisterStatsObserver(observer, 0);
+}
+
+void CallStats::RegisterStatsObserver(CallStatsObserver* observer,
+                                      uint32_t rtt_threshold_ms) {
   CriticalSectionScoped cs(crit_.get());
-  for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
+  for (std::list<ObserverInfo>::iterator it = observers_.begin();
        it != observers_.end(); ++it) {
-    if (*it == observer)
+    if (it->observer == observer)
       return;
   }
-  observers_.push_back(observer);
+  observers_.push_back(ObserverInfo(observer, rtt_threshold_ms));
 }
 
 void CallStats::DeregisterStatsObserver(CallStatsObserver* observer) {
   CriticalSectionScoped cs(crit_.get());
-  for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
+  for (std::list<ObserverInfo>::iterator it = observers_.begin();
        it != observers_.end(); ++it) {
-    if (*it == observer) {
+    if (it->observer == observer) {
       observers_.erase(it);
       return;
     }
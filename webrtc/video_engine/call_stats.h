@@ -15,6 +15,7 @@
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/interface/module.h"
+#include "webrtc/system_wrappers/interface/atomic32.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
 
 namespace webrtc {
@@ -41,6 +42,11 @@ class CallStats : public Module {
 
   // Registers/deregisters a new observer to receive statistics updates.
   void RegisterStatsObserver(CallStatsObserver* observer);
+  // Registers an observer that is only updated when the RTT differs at least
+  // |rtt_threshold_ms| from the last RTT reported to it. A threshold of zero
+  // updates the observer on every processed RTT, as the call above.
+  void RegisterStatsObserver(CallStatsObserver* observer,
+                             uint32_t rtt_threshold_ms);
   void DeregisterStatsObserver(CallStatsObserver* observer);
 
  protected:
@@ -57,20 +63,32 @@ class CallStats : public Module {
     const int64_t time;
   };
 
-  // Protecting all members.
+  // Helper struct keeping track of an observer and the last RTT sent to it.
+  struct ObserverInfo {
+    ObserverInfo(CallStatsObserver* stats_observer, uint32_t threshold_ms)
+        : observer(stats_observer),
+          rtt_threshold_ms(threshold_ms),
+          last_rtt_ms(0) {}
+    CallStatsObserver* const observer;
+    uint32_t rtt_threshold_ms;
+    uint32_t last_rtt_ms;
+  };
+
+  // Protecting all members, except |last_processed_rtt_ms_|.
   scoped_ptr<CriticalSectionWrapper> crit_;
   // Observer receiving statistics updates.
   scoped_ptr<RtcpRttStats> rtcp_rtt_stats_;
   // The last time 'Process' resulted in statistic update.
   int64_t last_process_time_;
   // The last RTT in the statistics update (zero if there is no valid estimate).
-  uint32_t last_processed_rtt_ms_;
+  // Atomic, since it's polled by every RTCP module sharing this instance.
+  mutable Atomic32 last_processed_rtt_ms_;
 
   // All Rtt reports within valid time interval, oldest first.
   std::list<RttTime> reports_;
 
   // Observers getting stats reports.
-  std::list<CallStatsObserver*> observers_;
+  std::list<ObserverInfo> observers_;
 
   DISALLOW_COPY_AND_ASSIGN(CallStats);
 };
@@ -185,4 +185,52 @@ TEST_F(CallStatsTest, ChangeRtt) {
   call_stats_->DeregisterStatsObserver(&stats_observer);
 }
 
+// Verify an observer with a threshold only gets rtt changes beyond it, while
+// an observer without one gets every update.
+TEST_F(CallStatsTest, RttThreshold) {
+  const uint32_t kThresholdMs = 20;
+  // Advance the clock this long to time out the last reported rtt.
+  const int kRttTimeoutMs = 1500 + 10;
+  MockStatsObserver threshold_observer;
+  call_stats_->RegisterStatsObserver(&threshold_observer, kThresholdMs);
+  MockStatsObserver stats_observer;
+  call_stats_->RegisterStatsObserver(&stats_observer);
+  RtcpRttStats* rtcp_rtt_stats = call_stats_->rtcp_rtt_stats();
+
+  // The first valid rtt is always reported.
+  const uint32_t first_rtt = 100;
+  TickTime::AdvanceFakeClock(1000);
+  rtcp_rtt_stats->OnRttUpdate(first_rtt);
+  EXPECT_CALL(threshold_observer, OnRttUpdate(first_rtt))
+      .Times(1);
+  EXPECT_CALL(stats_observer, OnRttUpdate(first_rtt))
+      .Times(1);
+  call_stats_->Process();
+
+  // A change below the threshold is only reported to the other observer.
+  const uint32_t small_rtt_change = first_rtt + kThresholdMs - 1;
+  TickTime::AdvanceFakeClock(kRttTimeoutMs);
+  rtcp_rtt_stats->OnRttUpdate(small_rtt_change);
+  EXPECT_CALL(threshold_observer, OnRttUpdate(_))
+      .Times(0);
+  EXPECT_CALL(stats_observer, OnRttUpdate(small_rtt_change))
+      .Times(1);
+  call_stats_->Process();
+  EXPECT_EQ(small_rtt_change, rtcp_rtt_stats->LastProcessedRtt());
+
+  // A decrease of the threshold, compared to the last reported rtt, is
+  // reported.
+  const uint32_t low_rtt = first_rtt - kThresholdMs;
+  TickTime::AdvanceFakeClock(kRttTimeoutMs);
+  rtcp_rtt_stats->OnRttUpdate(low_rtt);
+  EXPECT_CALL(threshold_observer, OnRttUpdate(low_rtt))
+      .Times(1);
+  EXPECT_CALL(stats_observer, OnRttUpdate(low_rtt))
+      .Times(1);
+  call_stats_->Process();
+
+  call_stats_->DeregisterStatsObserver(&threshold_observer);
+  call_stats_->DeregisterStatsObserver(&stats_observer);
+}
+
 }  // namespace webrtc
@@ -30,6 +30,9 @@ class EncoderStateFeedbackObserver : public  RtcpIntraFrameObserver {
   virtual void OnReceivedIntraFrameRequest(uint32_t ssrc) {
     owner_->OnReceivedIntraFrameRequest(ssrc);
   }
+  virtual void OnReceivedPictureLoss(uint32_t ssrc) {
+    owner_->OnReceivedPictureLoss(ssrc);
+  }
   virtual void OnReceivedSLI(uint32_t ssrc, uint8_t picture_id) {
     owner_->OnReceivedSLI(ssrc, picture_id);
   }
@@ -89,6 +92,15 @@ void EncoderStateFeedback::OnReceivedIntraFrameRequest(uint32_t ssrc) {
   it->second->OnReceivedIntraFrameRequest(ssrc);
 }
 
+void EncoderStateFeedback::OnReceivedPictureLoss(uint32_t ssrc) {
+  CriticalSectionScoped lock(crit_.get());
+  SsrcEncoderMap::iterator it = encoders_.find(ssrc);
+  if (it == encoders_.end())
+    return;
+
+  it->second->OnReceivedPictureLoss(ssrc);
+}
+
 void EncoderStateFeedback::OnReceivedSLI(uint32_t ssrc, uint8_t picture_id) {
   CriticalSectionScoped lock(crit_.get());
   SsrcEncoderMap::iterator it = encoders_.find(ssrc);
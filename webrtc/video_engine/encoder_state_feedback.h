@@ -47,6 +47,7 @@ class EncoderStateFeedback {
  protected:
   // Called by EncoderStateFeedbackObserver when a new key frame is requested.
   void OnReceivedIntraFrameRequest(uint32_t ssrc);
+  void OnReceivedPictureLoss(uint32_t ssrc);
   void OnReceivedSLI(uint32_t ssrc, uint8_t picture_id);
   void OnReceivedRPSI(uint32_t ssrc, uint64_t picture_id);
   void OnLocalSsrcChanged(uint32_t old_ssrc, uint32_t new_ssrc);
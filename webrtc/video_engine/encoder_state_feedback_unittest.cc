@@ -33,6 +33,8 @@ class MockVieEncoder : public ViEEncoder {
 
   MOCK_METHOD1(OnReceivedIntraFrameRequest,
                void(uint32_t));
+  MOCK_METHOD1(OnReceivedPictureLoss,
+               void(uint32_t));
   MOCK_METHOD2(OnReceivedSLI,
                void(uint32_t ssrc, uint8_t picture_id));
   MOCK_METHOD2(OnReceivedRPSI,
@@ -63,6 +65,11 @@ TEST_F(VieKeyRequestTest, CreateAndTriggerRequests) {
   encoder_state_feedback_->GetRtcpIntraFrameObserver()->
       OnReceivedIntraFrameRequest(ssrc);
 
+  EXPECT_CALL(encoder, OnReceivedPictureLoss(ssrc))
+      .Times(1);
+  encoder_state_feedback_->GetRtcpIntraFrameObserver()->
+      OnReceivedPictureLoss(ssrc);
+
   const uint8_t sli_picture_id = 3;
   EXPECT_CALL(encoder, OnReceivedSLI(ssrc, sli_picture_id))
       .Times(1);
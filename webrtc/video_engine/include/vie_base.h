@@ -53,6 +53,8 @@ struct CpuOveruseOptions {
         high_encode_usage_threshold_percent(90),
         low_encode_time_rsd_threshold(-1),
         high_encode_time_rsd_threshold(-1),
+        use_encode_cpu_time(false),
+        max_capture_delay_ms(-1),
         frame_timeout_interval_ms(1500),
         min_frame_samples(120),
         min_process_count(3),
@@ -72,6 +74,13 @@ struct CpuOveruseOptions {
   int high_encode_time_rsd_threshold;  // Additional threshold for triggering
                                        // overuse (used in addition to
                                        // threshold above if configured).
+  bool use_encode_cpu_time;  // Base the encode usage on the CPU time of the
+                             // encoding thread rather than on the wall time,
+                             // if the platform can measure it.
+  // Latency bound on the time from capture until a frame is handed to the
+  // encoders. Frames that have waited longer are dropped, and an average delay
+  // above the bound triggers overuse. -1 disables the bound.
+  int max_capture_delay_ms;
   // General settings.
   int frame_timeout_interval_ms;  // The maximum allowed interval between two
                                   // frames before resetting estimations.
@@ -94,6 +103,8 @@ struct CpuOveruseOptions {
         o.high_encode_usage_threshold_percent &&
         low_encode_time_rsd_threshold == o.low_encode_time_rsd_threshold &&
         high_encode_time_rsd_threshold == o.high_encode_time_rsd_threshold &&
+        use_encode_cpu_time == o.use_encode_cpu_time &&
+        max_capture_delay_ms == o.max_capture_delay_ms &&
         frame_timeout_interval_ms == o.frame_timeout_interval_ms &&
         min_frame_samples == o.min_frame_samples &&
         min_process_count == o.min_process_count &&
@@ -107,7 +118,10 @@ struct CpuOveruseMetrics {
         avg_encode_time_ms(-1),
         encode_usage_percent(-1),
         encode_rsd(-1),
-        capture_queue_delay_ms_per_s(-1) {}
+        encode_cpu_usage_percent(-1),
+        capture_queue_delay_ms_per_s(-1),
+        avg_capture_delay_ms(-1),
+        dropped_frames(0) {}
 
   int capture_jitter_ms;  // The current estimated jitter in ms based on
                           // incoming captured frames.
@@ -115,10 +129,19 @@ struct CpuOveruseMetrics {
   int encode_usage_percent; // The average encode time divided by the average
                             // time difference between incoming captured frames.
   int encode_rsd;           // The relative std dev of encode time of frames.
+  int encode_cpu_usage_percent;  // The average CPU time spent by the encoding
+                                 // thread per frame divided by the average
+                                 // time difference between incoming captured
+                                 // frames. -1 if not measurable.
   int capture_queue_delay_ms_per_s;  // The current time delay between an
                                      // incoming captured frame until the frame
                                      // is being processed. The delay is
                                      // expressed in ms delay per second.
+  int avg_capture_delay_ms;  // The average time from capture until a frame is
+                             // handed to the encoders. -1 if not measured.
+  int dropped_frames;  // The number of captured frames dropped because a newer
+                       // frame arrived or max_capture_delay_ms was exceeded
+                       // before they could be delivered.
 };
 
 class WEBRTC_DLLEXPORT VideoEngine {
@@ -152,6 +152,11 @@ class WEBRTC_DLLEXPORT ViECodec {
   // arrived too late.
   virtual unsigned int GetDiscardedPackets(const int video_channel) const = 0;
 
+  // Gets the number of frames the encoder rate control dropped to keep to the
+  // target bitrate, including frames dropped ahead of an expected overshoot.
+  virtual unsigned int GetFramesDroppedByRateControl(
+      const int video_channel) const = 0;
+
   // Enables key frame request callback in ViEDecoderObserver.
   virtual int SetKeyFrameRequestCallbackStatus(const int video_channel,
                                                const bool enable) = 0;
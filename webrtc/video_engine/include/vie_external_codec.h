@@ -25,6 +25,9 @@ class WEBRTC_DLLEXPORT ViEExternalCodec {
 
   virtual int Release() = 0;
 
+  // Captured texture frames are delivered to |encoder| as they are, without
+  // preprocessing, if VideoEncoder::SupportsNativeHandle() returns true.
+  // Otherwise they are dropped.
   virtual int RegisterExternalSendCodec(const int video_channel,
                                         const unsigned char pl_type,
                                         VideoEncoder* encoder,
@@ -17,6 +17,7 @@
 #define WEBRTC_VIDEO_ENGINE_INCLUDE_VIE_IMAGE_PROCESS_H_
 
 #include "webrtc/common_types.h"
+#include "webrtc/video_engine/include/vie_capture.h"
 
 namespace webrtc {
 
@@ -30,14 +31,41 @@ class VideoEngine;
 // with the corresponding deregister function.
 class WEBRTC_DLLEXPORT ViEEffectFilter {
  public:
-  // This method is called with an I420 video frame allowing the user to
-  // modify the video frame.
+  // This method is called with a copy of an I420 video frame, unless the
+  // filter transforms frames in place.
   virtual int Transform(int size,
                         unsigned char* frame_buffer,
                         int64_t ntp_time_ms,
                         unsigned int timestamp,
                         unsigned int width,
                         unsigned int height) = 0;
+
+  // Returns true if TransformFrame() is to be called instead of Transform(),
+  // which saves copying every frame for the filter.
+  virtual bool TransformsInPlace() const { return false; }
+
+  // Returns the size of the frames TransformFrame() produces from frames of
+  // |width| x |height|. The default keeps the size.
+  virtual void GetOutputSize(unsigned int width,
+                             unsigned int height,
+                             unsigned int* output_width,
+                             unsigned int* output_height) const {
+    *output_width = width;
+    *output_height = height;
+  }
+
+  // This method is called with the planes of the video frame itself. If the
+  // filter keeps the frame size, |output_frame| is NULL and the filter
+  // modifies |frame| in place. Otherwise the filter writes the result to
+  // |output_frame|, allocated with the size given by GetOutputSize(), which
+  // replaces the frame if 0 is returned.
+  virtual int TransformFrame(ViEVideoFrameI420* frame,
+                             ViEVideoFrameI420* output_frame,
+                             int64_t ntp_time_ms,
+                             unsigned int timestamp) {
+    return -1;
+  }
+
  protected:
   ViEEffectFilter() {}
   virtual ~ViEEffectFilter() {}
@@ -20,6 +20,7 @@
 
 namespace webrtc {
 
+class I420VideoFrame;
 class VideoEngine;
 class VideoRender;
 class VideoRenderCallback;
@@ -51,6 +52,14 @@ class ExternalRenderer {
   // with NULL |buffer| and non-NULL |handle|.
   virtual bool IsTextureSupported() = 0;
 
+  // Called instead of DeliverFrame() for I420 frames, to hand over the planes
+  // of the decoded frame without packing them into one buffer. The planes are
+  // only valid during the call. Returns -1 if not implemented, in which case
+  // DeliverFrame() is called.
+  virtual int DeliverI420Frame(const I420VideoFrame& video_frame) {
+    return -1;
+  }
+
  protected:
   virtual ~ExternalRenderer() {}
 };
@@ -231,6 +231,10 @@ class WEBRTC_DLLEXPORT ViERTP_RTCP {
   // Target delay should be set to zero for real-time mode.
   virtual int SetSenderBufferingMode(int video_channel,
                                      int target_delay_ms) = 0;
+  // Sets the number of sent packets kept for retransmission when buffered
+  // mode is off, which is kSendSidePacketHistorySize by default. A shorter
+  // history saves memory but can't answer NACKs for older packets.
+  virtual int SetSendSideHistorySize(int video_channel, int num_packets) = 0;
   // Sets receive side support for delayed video buffering. Target delay should
   // be set to zero for real-time mode.
   virtual int SetReceiverBufferingMode(int video_channel,
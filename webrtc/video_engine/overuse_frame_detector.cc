@@ -33,6 +33,8 @@ const int64_t kProcessIntervalMs = 5000;
 const float kWeightFactor = 0.997f;
 // Weight factor to apply to the average.
 const float kWeightFactorMean = 0.98f;
+// Weight factor to apply to the capture delay, per kSampleDiffMs.
+const float kWeightFactorCaptureDelay = 0.9f;
 
 // Delay between consecutive rampups. (Used for quick recovery.)
 const int kQuickRampUpDelayMs = 10 * 1000;
@@ -389,7 +391,11 @@ OveruseFrameDetector::OveruseFrameDetector(Clock* clock)
       encode_time_(new EncodeTimeAvg()),
       encode_rsd_(new EncodeTimeRsd(clock)),
       encode_usage_(new EncodeUsage()),
-      capture_queue_delay_(new CaptureQueueDelay()) {
+      encode_cpu_usage_(new EncodeUsage()),
+      has_encode_cpu_time_(false),
+      capture_queue_delay_(new CaptureQueueDelay()),
+      last_delivery_time_ms_(0),
+      capture_delay_ms_(new rtc::ExpFilter(kWeightFactorCaptureDelay)) {
 }
 
 OveruseFrameDetector::~OveruseFrameDetector() {
@@ -409,6 +415,7 @@ void OveruseFrameDetector::SetOptions(const CpuOveruseOptions& options) {
   options_ = options;
   capture_deltas_.SetOptions(options);
   encode_usage_->SetOptions(options);
+  encode_cpu_usage_->SetOptions(options);
   encode_rsd_->SetOptions(options);
   ResetAll(num_pixels_);
 }
@@ -424,8 +431,13 @@ void OveruseFrameDetector::GetCpuOveruseMetrics(
   metrics->capture_jitter_ms = static_cast<int>(capture_deltas_.StdDev() + 0.5);
   metrics->avg_encode_time_ms = encode_time_->Value();
   metrics->encode_rsd = encode_rsd_->Value();
-  metrics->encode_usage_percent = encode_usage_->Value();
+  metrics->encode_usage_percent = EncodeUsagePercent();
+  metrics->encode_cpu_usage_percent =
+      has_encode_cpu_time_ ? encode_cpu_usage_->Value() : -1;
   metrics->capture_queue_delay_ms_per_s = capture_queue_delay_->Value();
+  metrics->avg_capture_delay_ms =
+      capture_delay_ms_->filtered() == rtc::ExpFilter::kValueUndefined ?
+      -1 : static_cast<int>(capture_delay_ms_->filtered() + 0.5);
 }
 
 int32_t OveruseFrameDetector::TimeUntilNextProcess() {
@@ -451,8 +463,11 @@ void OveruseFrameDetector::ResetAll(int num_pixels) {
   num_pixels_ = num_pixels;
   capture_deltas_.Reset();
   encode_usage_->Reset();
+  encode_cpu_usage_->Reset();
   encode_rsd_->Reset();
   capture_queue_delay_->ClearFrames();
+  capture_delay_ms_->Reset(kWeightFactorCaptureDelay);
+  last_delivery_time_ms_ = 0;
   last_capture_time_ = 0;
   num_process_times_ = 0;
 }
@@ -468,6 +483,7 @@ void OveruseFrameDetector::FrameCaptured(int width, int height) {
   if (last_capture_time_ != 0) {
     capture_deltas_.AddSample(now - last_capture_time_);
     encode_usage_->AddSample(now - last_capture_time_);
+    encode_cpu_usage_->AddSample(now - last_capture_time_);
   }
   last_capture_time_ = now;
 
@@ -479,7 +495,22 @@ void OveruseFrameDetector::FrameProcessingStarted() {
   capture_queue_delay_->FrameProcessingStarted(clock_->TimeInMilliseconds());
 }
 
+void OveruseFrameDetector::FrameDelivered(int capture_delay_ms) {
+  CriticalSectionScoped cs(crit_.get());
+  int64_t now = clock_->TimeInMilliseconds();
+  float exp = 1.0f;
+  if (last_delivery_time_ms_ != 0)
+    exp = std::min((now - last_delivery_time_ms_) / kSampleDiffMs, kMaxExp);
+  capture_delay_ms_->Apply(exp, capture_delay_ms);
+  last_delivery_time_ms_ = now;
+}
+
 void OveruseFrameDetector::FrameEncoded(int encode_time_ms) {
+  FrameEncoded(encode_time_ms, -1);
+}
+
+void OveruseFrameDetector::FrameEncoded(int encode_time_ms,
+                                        int encode_cpu_time_ms) {
   CriticalSectionScoped cs(crit_.get());
   int64_t time = clock_->TimeInMilliseconds();
   if (last_encode_sample_ms_ != 0) {
@@ -487,6 +518,10 @@ void OveruseFrameDetector::FrameEncoded(int encode_time_ms) {
     encode_time_->AddEncodeSample(encode_time_ms, diff_ms);
     encode_usage_->AddEncodeSample(encode_time_ms, diff_ms);
     encode_rsd_->AddEncodeSample(encode_time_ms);
+    if (encode_cpu_time_ms >= 0) {
+      encode_cpu_usage_->AddEncodeSample(encode_cpu_time_ms, diff_ms);
+      has_encode_cpu_time_ = true;
+    }
   }
   last_encode_sample_ms_ = time;
 }
@@ -549,12 +584,25 @@ int32_t OveruseFrameDetector::Process() {
   LOG(LS_VERBOSE) << " Frame stats: capture avg: " << capture_deltas_.Mean()
                   << " capture stddev " << capture_deltas_.StdDev()
                   << " encode usage " << encode_usage_->Value()
+                  << " encode cpu usage " << encode_cpu_usage_->Value()
                   << " encode rsd " << encode_rsd_->Value()
                   << " overuse detections " << num_overuse_detections_
                   << " rampup delay " << rampup_delay;
   return 0;
 }
 
+int OveruseFrameDetector::EncodeUsagePercent() const {
+  if (options_.use_encode_cpu_time && has_encode_cpu_time_)
+    return encode_cpu_usage_->Value();
+  return encode_usage_->Value();
+}
+
+bool OveruseFrameDetector::CaptureDelayAboveBound() const {
+  return options_.max_capture_delay_ms > 0 &&
+      capture_delay_ms_->filtered() != rtc::ExpFilter::kValueUndefined &&
+      capture_delay_ms_->filtered() > options_.max_capture_delay_ms;
+}
+
 bool OveruseFrameDetector::IsOverusing() {
   bool overusing = false;
   if (options_.enable_capture_jitter_method) {
@@ -562,7 +610,7 @@ bool OveruseFrameDetector::IsOverusing() {
         options_.high_capture_jitter_threshold_ms;
   } else if (options_.enable_encode_usage_method) {
     bool encode_usage_overuse =
-        encode_usage_->Value() >= options_.high_encode_usage_threshold_percent;
+        EncodeUsagePercent() >= options_.high_encode_usage_threshold_percent;
     bool encode_rsd_overuse = false;
     if (options_.high_encode_time_rsd_threshold > 0) {
       encode_rsd_overuse =
@@ -570,6 +618,7 @@ bool OveruseFrameDetector::IsOverusing() {
     }
     overusing = encode_usage_overuse || encode_rsd_overuse;
   }
+  overusing = overusing || CaptureDelayAboveBound();
 
   if (overusing) {
     ++checks_above_threshold_;
@@ -590,7 +639,7 @@ bool OveruseFrameDetector::IsUnderusing(int64_t time_now) {
         options_.low_capture_jitter_threshold_ms;
   } else if (options_.enable_encode_usage_method) {
     bool encode_usage_underuse =
-        encode_usage_->Value() < options_.low_encode_usage_threshold_percent;
+        EncodeUsagePercent() < options_.low_encode_usage_threshold_percent;
     bool encode_rsd_underuse = true;
     if (options_.low_encode_time_rsd_threshold > 0) {
       encode_rsd_underuse =
@@ -598,6 +647,6 @@ bool OveruseFrameDetector::IsUnderusing(int64_t time_now) {
     }
     underusing = encode_usage_underuse && encode_rsd_underuse;
   }
-  return underusing;
+  return underusing && !CaptureDelayAboveBound();
 }
 }  // namespace webrtc
@@ -66,9 +66,17 @@ class OveruseFrameDetector : public Module {
   // Called when the processing of a captured frame is started.
   void FrameProcessingStarted();
 
+  // Called when a captured frame is handed to the encoders, |capture_delay_ms|
+  // after it was captured.
+  void FrameDelivered(int capture_delay_ms);
+
   // Called for each encoded frame.
   void FrameEncoded(int encode_time_ms);
 
+  // As above, with the CPU time the encoding thread spent on the frame, or -1
+  // if it could not be measured.
+  void FrameEncoded(int encode_time_ms, int encode_cpu_time_ms);
+
   // Accessors.
 
   // Returns CpuOveruseMetrics where
@@ -76,7 +84,12 @@ class OveruseFrameDetector : public Module {
   // avg_encode_time_ms: Running average of reported encode time
   //                     (FrameEncoded()). Only used for stats.
   // encode_usage_percent: The average encode time divided by the average time
-  //                       difference between incoming captured frames.
+  //                       difference between incoming captured frames, or
+  //                       encode_cpu_usage_percent if use_encode_cpu_time is
+  //                       set and the CPU time is measurable.
+  // encode_cpu_usage_percent: The average encode CPU time divided by the
+  //                           average time difference between incoming
+  //                           captured frames.
   // capture_queue_delay_ms_per_s: The current time delay between an incoming
   //                               captured frame (FrameCaptured()) until the
   //                               frame is being processed
@@ -85,6 +98,9 @@ class OveruseFrameDetector : public Module {
   //                               been processed, the old frame is skipped).
   //                               The delay is expressed in ms delay per sec.
   //                               Only used for stats.
+  // avg_capture_delay_ms: Running average of the delay reported by
+  //                       FrameDelivered(). Triggers overuse when above
+  //                       max_capture_delay_ms, if set.
   void GetCpuOveruseMetrics(CpuOveruseMetrics* metrics) const;
 
   int CaptureQueueDelayMsPerS() const;
@@ -99,6 +115,10 @@ class OveruseFrameDetector : public Module {
   class EncodeUsage;
   class CaptureQueueDelay;
 
+  // The encode usage the overuse decisions are based on.
+  int EncodeUsagePercent() const;
+
+  bool CaptureDelayAboveBound() const;
   bool IsOverusing();
   bool IsUnderusing(int64_t time_now);
 
@@ -137,9 +157,15 @@ class OveruseFrameDetector : public Module {
   scoped_ptr<EncodeTimeAvg> encode_time_;
   scoped_ptr<EncodeTimeRsd> encode_rsd_;
   scoped_ptr<EncodeUsage> encode_usage_;
+  // Fed with the CPU time of the encoding thread, see use_encode_cpu_time.
+  scoped_ptr<EncodeUsage> encode_cpu_usage_;
+  bool has_encode_cpu_time_;
 
   scoped_ptr<CaptureQueueDelay> capture_queue_delay_;
 
+  int64_t last_delivery_time_ms_;
+  scoped_ptr<rtc::ExpFilter> capture_delay_ms_;
+
   DISALLOW_COPY_AND_ASSIGN(OveruseFrameDetector);
 };
 
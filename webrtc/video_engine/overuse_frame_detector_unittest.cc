@@ -95,6 +95,18 @@ class OveruseFrameDetectorTest : public ::testing::Test {
     }
   }
 
+  void InsertAndEncodeFramesWithCpuTime(int num_frames,
+                                        int interval_ms,
+                                        int encode_ms,
+                                        int encode_cpu_ms) {
+    while (num_frames-- > 0) {
+      overuse_detector_->FrameCaptured(kWidth, kHeight);
+      clock_->AdvanceTimeMilliseconds(encode_ms);
+      overuse_detector_->FrameEncoded(encode_ms, encode_cpu_ms);
+      clock_->AdvanceTimeMilliseconds(interval_ms - encode_ms);
+    }
+  }
+
   void TriggerOveruse(int num_times) {
     for (int i = 0; i < num_times; ++i) {
       InsertFramesWithInterval(200, kFrameInterval33ms, kWidth, kHeight);
@@ -154,6 +166,26 @@ class OveruseFrameDetectorTest : public ::testing::Test {
     return metrics.encode_usage_percent;
   }
 
+  int EncodeCpuUsagePercent() {
+    CpuOveruseMetrics metrics;
+    overuse_detector_->GetCpuOveruseMetrics(&metrics);
+    return metrics.encode_cpu_usage_percent;
+  }
+
+  int AvgCaptureDelayMs() {
+    CpuOveruseMetrics metrics;
+    overuse_detector_->GetCpuOveruseMetrics(&metrics);
+    return metrics.avg_capture_delay_ms;
+  }
+
+  void InsertAndDeliverFramesWithDelay(int num_frames, int capture_delay_ms) {
+    while (num_frames-- > 0) {
+      overuse_detector_->FrameCaptured(kWidth, kHeight);
+      overuse_detector_->FrameDelivered(capture_delay_ms);
+      clock_->AdvanceTimeMilliseconds(kFrameInterval33ms);
+    }
+  }
+
   int EncodeRsd() {
     CpuOveruseMetrics metrics;
     overuse_detector_->GetCpuOveruseMetrics(&metrics);
@@ -346,6 +378,43 @@ TEST_F(OveruseFrameDetectorTest, CaptureQueueDelayNoMatchingCapturedFrame) {
   EXPECT_EQ(overuse_detector_->CaptureQueueDelayMsPerS(), 100);
 }
 
+TEST_F(OveruseFrameDetectorTest, CaptureDelay) {
+  EXPECT_EQ(-1, AvgCaptureDelayMs());
+  InsertAndDeliverFramesWithDelay(1, 40);
+  EXPECT_EQ(40, AvgCaptureDelayMs());
+  InsertAndDeliverFramesWithDelay(100, 10);
+  EXPECT_EQ(10, AvgCaptureDelayMs());
+}
+
+TEST_F(OveruseFrameDetectorTest, CaptureDelayResetAtResolutionSwitch) {
+  InsertAndDeliverFramesWithDelay(1, 40);
+  overuse_detector_->FrameCaptured(kWidth, kHeight + 1);
+  EXPECT_EQ(-1, AvgCaptureDelayMs());
+}
+
+// max_capture_delay_ms > 0;
+// AvgCaptureDelayMs() > max_capture_delay_ms => overuse, for either method.
+TEST_F(OveruseFrameDetectorTest, OveruseAndRecoverWithCaptureDelay) {
+  options_.max_capture_delay_ms = 100;
+  overuse_detector_->SetOptions(options_);
+  EXPECT_CALL(*(observer_.get()), OveruseDetected()).Times(1);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i) {
+    InsertAndDeliverFramesWithDelay(200, 150);
+    overuse_detector_->Process();
+  }
+  EXPECT_CALL(*(observer_.get()), NormalUsage()).Times(testing::AtLeast(1));
+  InsertAndDeliverFramesWithDelay(900, 20);
+  overuse_detector_->Process();
+}
+
+TEST_F(OveruseFrameDetectorTest, NoOveruseWithCaptureDelayBoundDisabled) {
+  EXPECT_CALL(*(observer_.get()), OveruseDetected()).Times(0);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i) {
+    InsertAndDeliverFramesWithDelay(200, 150);
+    overuse_detector_->Process();
+  }
+}
+
 TEST_F(OveruseFrameDetectorTest, EncodedFrame) {
   const int kInitialAvgEncodeTimeInMs = 5;
   EXPECT_EQ(kInitialAvgEncodeTimeInMs, AvgEncodeTimeMs());
@@ -414,6 +483,63 @@ TEST_F(OveruseFrameDetectorTest,
   TriggerNormalUsageWithEncodeTime();
 }
 
+TEST_F(OveruseFrameDetectorTest, NoEncodeCpuUsageWithoutCpuTime) {
+  InsertAndEncodeFramesWithInterval(
+      1000, kFrameInterval33ms, kWidth, kHeight, 5);
+  EXPECT_EQ(-1, EncodeCpuUsagePercent());
+  InsertAndEncodeFramesWithCpuTime(1000, kFrameInterval33ms, 5, -1);
+  EXPECT_EQ(-1, EncodeCpuUsagePercent());
+}
+
+TEST_F(OveruseFrameDetectorTest, EncodeCpuUsage) {
+  const int kEncodeTimeMs = 20;
+  const int kEncodeCpuTimeMs = 5;
+  InsertAndEncodeFramesWithCpuTime(
+      1000, kFrameInterval33ms, kEncodeTimeMs, kEncodeCpuTimeMs);
+  EXPECT_EQ(kEncodeCpuTimeMs * 100 / kFrameInterval33ms,
+            EncodeCpuUsagePercent());
+  EXPECT_NEAR(kEncodeTimeMs * 100 / kFrameInterval33ms,
+              EncodeUsagePercent(), 1);
+
+  options_.use_encode_cpu_time = true;
+  overuse_detector_->SetOptions(options_);
+  InsertAndEncodeFramesWithCpuTime(
+      1000, kFrameInterval33ms, kEncodeTimeMs, kEncodeCpuTimeMs);
+  EXPECT_EQ(kEncodeCpuTimeMs * 100 / kFrameInterval33ms, EncodeUsagePercent());
+}
+
+// use_encode_cpu_time = true;
+// An encoder thread that is mostly waiting for the CPU, e.g. because of other
+// calls in the same process, is not overusing.
+TEST_F(OveruseFrameDetectorTest, NoOveruseWithLowEncodeCpuTime) {
+  const int kEncodeTimeMs = 32;
+  const int kEncodeCpuTimeMs = 5;
+  options_.enable_capture_jitter_method = false;
+  options_.enable_encode_usage_method = true;
+  options_.use_encode_cpu_time = true;
+  overuse_detector_->SetOptions(options_);
+  EXPECT_CALL(*(observer_.get()), OveruseDetected()).Times(0);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i) {
+    InsertAndEncodeFramesWithCpuTime(
+        1000, kFrameInterval33ms, kEncodeTimeMs, kEncodeCpuTimeMs);
+    overuse_detector_->Process();
+  }
+}
+
+TEST_F(OveruseFrameDetectorTest, OveruseWithHighEncodeCpuTime) {
+  const int kEncodeTimeMs = 32;
+  options_.enable_capture_jitter_method = false;
+  options_.enable_encode_usage_method = true;
+  options_.use_encode_cpu_time = true;
+  overuse_detector_->SetOptions(options_);
+  EXPECT_CALL(*(observer_.get()), OveruseDetected()).Times(1);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i) {
+    InsertAndEncodeFramesWithCpuTime(
+        1000, kFrameInterval33ms, kEncodeTimeMs, kEncodeTimeMs);
+    overuse_detector_->Process();
+  }
+}
+
 TEST_F(OveruseFrameDetectorTest, EncodeRsdResetAfterChangingThreshold) {
   EXPECT_EQ(InitialEncodeRsd(), EncodeRsd());
   options_.high_encode_time_rsd_threshold = 100;
@@ -158,6 +158,7 @@ int ViEBaseImpl::CreateChannel(int& video_channel) {  // NOLINT
 
 int ViEBaseImpl::CreateChannel(int& video_channel,  // NOLINT
                                const Config* config) {
+  shared_data_.StartModuleProcessThread();
   if (shared_data_.channel_manager()->CreateChannel(&video_channel,
                                                     config) == -1) {
     video_channel = -1;
@@ -361,6 +362,7 @@ int ViEBaseImpl::CreateChannel(int& video_channel,  // NOLINT
     return -1;
   }
 
+  shared_data_.StartModuleProcessThread();
   if (shared_data_.channel_manager()->CreateChannel(&video_channel,
                                                     original_channel,
                                                     sender) == -1) {
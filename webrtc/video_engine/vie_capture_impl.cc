@@ -81,6 +81,7 @@ int ViECaptureImpl::AllocateCaptureDevice(
   const unsigned int unique_idUTF8Length,
   int& capture_id) {
   LOG(LS_INFO) << "AllocateCaptureDevice " << unique_idUTF8;
+  shared_data_->StartModuleProcessThread();
   const int32_t result =
       shared_data_->input_manager()->CreateCaptureDevice(
           unique_idUTF8,
@@ -95,6 +96,7 @@ int ViECaptureImpl::AllocateCaptureDevice(
 
 int ViECaptureImpl::AllocateExternalCaptureDevice(
   int& capture_id, ViEExternalCapture*& external_capture) {
+  shared_data_->StartModuleProcessThread();
   const int32_t result =
       shared_data_->input_manager()->CreateExternalCaptureDevice(
           external_capture, capture_id);
@@ -109,6 +111,7 @@ int ViECaptureImpl::AllocateExternalCaptureDevice(
 
 int ViECaptureImpl::AllocateCaptureDevice(
     VideoCaptureModule& capture_module, int& capture_id) {  // NOLINT
+  shared_data_->StartModuleProcessThread();
   int32_t result = shared_data_->input_manager()->CreateCaptureDevice(
       &capture_module, capture_id);
   if (result != 0) {
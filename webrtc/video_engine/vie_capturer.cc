@@ -18,6 +18,7 @@
 #include "webrtc/modules/video_processing/main/interface/video_processing.h"
 #include "webrtc/modules/video_render/include/video_render_defines.h"
 #include "webrtc/system_wrappers/interface/clock.h"
+#include "webrtc/system_wrappers/interface/cpu_info.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
@@ -26,6 +27,7 @@
 #include "webrtc/video_engine/include/vie_image_process.h"
 #include "webrtc/video_engine/overuse_frame_detector.h"
 #include "webrtc/video_engine/vie_defines.h"
+#include "webrtc/video_engine/vie_effect_filter.h"
 #include "webrtc/video_engine/vie_encoder.h"
 
 namespace webrtc {
@@ -49,6 +51,8 @@ ViECapturer::ViECapturer(int capture_id,
                                                    "ViECaptureThread")),
       capture_event_(*EventWrapper::Create()),
       deliver_event_(*EventWrapper::Create()),
+      dropped_frames_(0),
+      max_capture_delay_ms_(-1),
       effect_filter_(NULL),
       image_proc_module_(NULL),
       image_proc_module_ref_counter_(0),
@@ -247,10 +251,14 @@ void ViECapturer::RegisterCpuOveruseObserver(CpuOveruseObserver* observer) {
 
 void ViECapturer::SetCpuOveruseOptions(const CpuOveruseOptions& options) {
   overuse_detector_->SetOptions(options);
+  CriticalSectionScoped cs(capture_cs_.get());
+  max_capture_delay_ms_ = options.max_capture_delay_ms;
 }
 
 void ViECapturer::GetCpuOveruseMetrics(CpuOveruseMetrics* metrics) const {
   overuse_detector_->GetCpuOveruseMetrics(metrics);
+  CriticalSectionScoped cs(capture_cs_.get());
+  metrics->dropped_frames = dropped_frames_;
 }
 
 int32_t ViECapturer::SetCaptureDelay(int32_t delay_ms) {
@@ -346,6 +354,11 @@ void ViECapturer::OnIncomingCapturedFrame(const int32_t capture_id,
   TRACE_EVENT_ASYNC_BEGIN1("webrtc", "Video", video_frame.render_time_ms(),
                            "render_time", video_frame.render_time_ms());
 
+  // Drop the previous frame if it hasn't been delivered yet.
+  if (captured_frame_ != NULL && (captured_frame_->native_handle() != NULL ||
+                                  !captured_frame_->IsZeroSize())) {
+    ++dropped_frames_;
+  }
   if (video_frame.native_handle() != NULL) {
     captured_frame_.reset(video_frame.CloneFrame());
   } else {
@@ -453,9 +466,17 @@ bool ViECapturer::ViECaptureProcess() {
   if (capture_event_.Wait(kThreadWaitTimeMs) == kEventSignaled) {
     overuse_detector_->FrameProcessingStarted();
     int64_t encode_start_time = -1;
+    int64_t encode_start_cpu_time_us = -1;
     deliver_cs_->Enter();
     if (SwapCapturedAndDeliverFrameIfAvailable()) {
       encode_start_time = Clock::GetRealTimeClock()->TimeInMilliseconds();
+      encode_start_cpu_time_us = CpuInfo::ThreadCpuTimeUs();
+      // The render time is the capture time, see OnIncomingCapturedFrame().
+      int64_t capture_delay_ms =
+          encode_start_time - deliver_frame_->render_time_ms();
+      if (capture_delay_ms >= 0) {
+        overuse_detector_->FrameDelivered(static_cast<int>(capture_delay_ms));
+      }
       DeliverI420Frame(deliver_frame_.get());
       if (deliver_frame_->native_handle() != NULL)
         deliver_frame_.reset();  // Release the texture so it can be reused.
@@ -468,10 +489,17 @@ bool ViECapturer::ViECaptureProcess() {
         reported_brightness_level_ = current_brightness_level_;
       }
     }
-    // Update the overuse detector with the duration.
+    // Update the overuse detector with the duration and with the CPU time
+    // this thread, and thereby this capturer's encoders, spent on the frame.
     if (encode_start_time != -1) {
+      int encode_cpu_time_ms = -1;
+      if (encode_start_cpu_time_us != -1) {
+        encode_cpu_time_ms = static_cast<int>(
+            (CpuInfo::ThreadCpuTimeUs() - encode_start_cpu_time_us) / 1000);
+      }
       overuse_detector_->FrameEncoded(
-          Clock::GetRealTimeClock()->TimeInMilliseconds() - encode_start_time);
+          Clock::GetRealTimeClock()->TimeInMilliseconds() - encode_start_time,
+          encode_cpu_time_ms);
     }
   }
   // We're done!
@@ -515,17 +543,7 @@ void ViECapturer::DeliverI420Frame(I420VideoFrame* video_frame) {
     }
   }
   if (effect_filter_) {
-    unsigned int length = CalcBufferSize(kI420,
-                                         video_frame->width(),
-                                         video_frame->height());
-    scoped_ptr<uint8_t[]> video_buffer(new uint8_t[length]);
-    ExtractBuffer(*video_frame, length, video_buffer.get());
-    effect_filter_->Transform(length,
-                              video_buffer.get(),
-                              video_frame->ntp_time_ms(),
-                              video_frame->timestamp(),
-                              video_frame->width(),
-                              video_frame->height());
+    ApplyEffectFilter(effect_filter_, video_frame, &effect_output_frame_);
   }
   // Deliver the captured frame to all observers (channels, renderer or file).
   ViEFrameProviderBase::DeliverFrame(video_frame);
@@ -598,6 +616,20 @@ bool ViECapturer::SwapCapturedAndDeliverFrameIfAvailable() {
   if (captured_frame_ == NULL)
     return false;
 
+  if (max_capture_delay_ms_ > 0 && (captured_frame_->native_handle() != NULL ||
+                                    !captured_frame_->IsZeroSize())) {
+    int64_t capture_delay_ms = Clock::GetRealTimeClock()->TimeInMilliseconds() -
+        captured_frame_->render_time_ms();
+    if (capture_delay_ms > max_capture_delay_ms_) {
+      ++dropped_frames_;
+      if (captured_frame_->native_handle() != NULL)
+        captured_frame_.reset();  // Release the texture so it can be reused.
+      else
+        captured_frame_->ResetSize();
+      return false;
+    }
+  }
+
   if (captured_frame_->native_handle() != NULL) {
     deliver_frame_.reset(captured_frame_.release());
     return true;
@@ -149,6 +149,9 @@ class ViECapturer
   void DeliverCodedFrame(VideoFrame* video_frame);
 
  private:
+  // Moves the captured frame to |deliver_frame_|. Returns false if there is no
+  // frame, or if it has waited longer than |max_capture_delay_ms_| and was
+  // dropped.
   bool SwapCapturedAndDeliverFrameIfAvailable();
 
   // Never take capture_cs_ before deliver_cs_!
@@ -170,9 +173,15 @@ class ViECapturer
 
   scoped_ptr<I420VideoFrame> captured_frame_;
   scoped_ptr<I420VideoFrame> deliver_frame_;
+  // Only the newest captured frame is delivered. Counts the frames replaced
+  // before delivery and the frames older than |max_capture_delay_ms_|.
+  int dropped_frames_ GUARDED_BY(capture_cs_.get());
+  int max_capture_delay_ms_ GUARDED_BY(capture_cs_.get());
 
   // Image processing.
   ViEEffectFilter* effect_filter_;
+  // The output of an effect filter changing the frame size.
+  I420VideoFrame effect_output_frame_;
   VideoProcessingModule* image_proc_module_;
   int image_proc_module_ref_counter_;
   VideoProcessingModule::FrameStats* deflicker_frame_stats_;
@@ -21,6 +21,7 @@
 #include "webrtc/common_video/interface/texture_video_frame.h"
 #include "webrtc/modules/utility/interface/mock/mock_process_thread.h"
 #include "webrtc/modules/video_capture/include/mock/mock_video_capture.h"
+#include "webrtc/system_wrappers/interface/clock.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/ref_count.h"
@@ -95,8 +96,11 @@ class ViECapturerTest : public ::testing::Test {
   }
 
   void AddOutputFrame(I420VideoFrame* frame) {
-    if (frame->native_handle() == NULL)
-      output_frame_ybuffers_.push_back(frame->buffer(kYPlane));
+    // Read the plane through the const accessor. The non-const one would copy
+    // the plane, which is shared with the copy of the input frame.
+    const I420VideoFrame& output_frame = *frame;
+    if (output_frame.native_handle() == NULL)
+      output_frame_ybuffers_.push_back(output_frame.buffer(kYPlane));
     // Clone the frames because ViECapturer owns the frames.
     output_frames_.push_back(frame->CloneFrame());
     output_frame_event_->Set();
@@ -126,7 +130,7 @@ class ViECapturerTest : public ::testing::Test {
 
   // The pointers of Y plane buffers of output frames. This is used to verify
   // the frame are swapped and not copied.
-  std::vector<uint8_t*> output_frame_ybuffers_;
+  std::vector<const uint8_t*> output_frame_ybuffers_;
 };
 
 TEST_F(ViECapturerTest, TestTextureFrames) {
@@ -145,10 +149,11 @@ TEST_F(ViECapturerTest, TestTextureFrames) {
 TEST_F(ViECapturerTest, TestI420Frames) {
   const int kNumFrame = 4;
   ScopedVector<I420VideoFrame> copied_input_frames;
-  std::vector<uint8_t*> ybuffer_pointers;
+  std::vector<const uint8_t*> ybuffer_pointers;
   for (int i = 0; i < kNumFrame; ++i) {
     input_frames_.push_back(CreateI420VideoFrame(static_cast<uint8_t>(i + 1)));
-    ybuffer_pointers.push_back(input_frames_[i]->buffer(kYPlane));
+    const I420VideoFrame& input_frame = *input_frames_[i];
+    ybuffer_pointers.push_back(input_frame.buffer(kYPlane));
     // Copy input frames because the buffer data will be swapped.
     copied_input_frames.push_back(input_frames_[i]->CloneFrame());
     AddInputFrame(input_frames_[i]);
@@ -195,6 +200,33 @@ TEST_F(ViECapturerTest, TestTextureFrameAfterI420Frame) {
   EXPECT_TRUE(EqualFramesVector(input_frames_, output_frames_));
 }
 
+TEST_F(ViECapturerTest, DropsFramesAboveMaxCaptureDelay) {
+  CpuOveruseOptions options;
+  options.max_capture_delay_ms = 200;
+  vie_capturer_->SetCpuOveruseOptions(options);
+
+  // Captured a second ago.
+  Clock* clock = Clock::GetRealTimeClock();
+  input_frames_.push_back(CreateI420VideoFrame(1));
+  input_frames_[0]->set_render_time_ms(clock->TimeInMilliseconds() - 1000);
+  AddInputFrame(input_frames_[0]);
+  EXPECT_EQ(kEventTimeout, output_frame_event_->Wait(FRAME_TIMEOUT_MS / 5));
+  EXPECT_TRUE(output_frames_.empty());
+
+  input_frames_.push_back(CreateI420VideoFrame(2));
+  input_frames_[1]->set_render_time_ms(clock->TimeInMilliseconds());
+  AddInputFrame(input_frames_[1]);
+  WaitOutputFrame();
+  ASSERT_EQ(1u, output_frames_.size());
+  EXPECT_EQ(2u, output_frames_[0]->timestamp());
+
+  CpuOveruseMetrics metrics;
+  vie_capturer_->GetCpuOveruseMetrics(&metrics);
+  EXPECT_EQ(1, metrics.dropped_frames);
+  EXPECT_GE(metrics.avg_capture_delay_ms, 0);
+  EXPECT_LT(metrics.avg_capture_delay_ms, 1000);
+}
+
 bool EqualFrames(const I420VideoFrame& frame1,
                  const I420VideoFrame& frame2) {
   if (frame1.native_handle() != NULL || frame2.native_handle() != NULL)
@@ -33,6 +33,7 @@
 #include "webrtc/video_engine/include/vie_rtp_rtcp.h"
 #include "webrtc/frame_callback.h"
 #include "webrtc/video_engine/vie_defines.h"
+#include "webrtc/video_engine/vie_effect_filter.h"
 
 namespace webrtc {
 
@@ -73,7 +74,8 @@ ViEChannel::ViEChannel(int32_t channel_id,
       engine_id_(engine_id),
       number_of_cores_(number_of_cores),
       num_socket_threads_(kViESocketThreads),
-      callback_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      callback_cs_(
+          CriticalSectionWrapper::CreateAdaptiveCriticalSection("ViEChannel")),
       rtp_rtcp_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       default_rtp_rtcp_(default_rtp_rtcp),
       vcm_(VideoCodingModule::Create()),
@@ -97,11 +99,15 @@ ViEChannel::ViEChannel(int32_t channel_id,
       decoder_reset_(true),
       wait_for_key_frame_(false),
       decode_thread_(NULL),
+      decode_pool_(NULL),
+      decoding_on_pool_(false),
       effect_filter_(NULL),
       color_enhancement_(false),
       mtu_(0),
       sender_(sender),
       nack_history_size_sender_(kSendSidePacketHistorySize),
+      send_side_history_size_(kSendSidePacketHistorySize),
+      sender_target_delay_ms_(0),
       max_nack_reordering_threshold_(kMaxPacketAgeToNack),
       pre_render_callback_(NULL) {
   RtpRtcp::Configuration configuration;
@@ -126,15 +132,18 @@ ViEChannel::ViEChannel(int32_t channel_id,
 }
 
 int32_t ViEChannel::Init() {
-  if (module_process_thread_.RegisterModule(
-      vie_receiver_.GetReceiveStatistics()) != 0) {
+  // All modules of a channel are registered with the same affinity so that
+  // they are processed on the same worker thread.
+  if (module_process_thread_.RegisterModuleWithAffinity(
+      vie_receiver_.GetReceiveStatistics(), channel_id_) != 0) {
     return -1;
   }
   // RTP/RTCP initialization.
   if (rtp_rtcp_->SetSendingMediaStatus(false) != 0) {
     return -1;
   }
-  if (module_process_thread_.RegisterModule(rtp_rtcp_.get()) != 0) {
+  if (module_process_thread_.RegisterModuleWithAffinity(rtp_rtcp_.get(),
+                                                        channel_id_) != 0) {
     return -1;
   }
   rtp_rtcp_->SetKeyFrameRequestMethod(kKeyFrameReqFirRtp);
@@ -155,7 +164,8 @@ int32_t ViEChannel::Init() {
   vcm_->RegisterReceiveStatisticsCallback(this);
   vcm_->RegisterDecoderTimingCallback(this);
   vcm_->SetRenderDelay(kViEDefaultRenderDelayMs);
-  if (module_process_thread_.RegisterModule(vcm_) != 0) {
+  if (module_process_thread_.RegisterModuleWithAffinity(vcm_,
+                                                        channel_id_) != 0) {
     return -1;
   }
 #ifdef VIDEOCODEC_VP8
@@ -178,6 +188,8 @@ int32_t ViEChannel::Init() {
 }
 
 ViEChannel::~ViEChannel() {
+  // Stops the FEC thread of the receiver, which inserts into |vcm_|.
+  vie_receiver_.StopReceive();
   // Make sure we don't get more callbacks from the RTP module.
   module_process_thread_.DeRegisterModule(vie_receiver_.GetReceiveStatistics());
   module_process_thread_.DeRegisterModule(rtp_rtcp_.get());
@@ -195,9 +207,7 @@ ViEChannel::~ViEChannel() {
     delete *it;
     removed_rtp_rtcp_.erase(it);
   }
-  if (decode_thread_) {
-    StopDecodeThread();
-  }
+  StopDecodeThread();
   // Release modules.
   VideoCodingModule::Destroy(vcm_);
 }
@@ -289,7 +299,7 @@ int32_t ViEChannel::SetSendCodec(const VideoCodec& video_codec,
       simulcast_rtp_rtcp_.push_back(rtp_rtcp);
 
       // Silently ignore error.
-      module_process_thread_.RegisterModule(rtp_rtcp);
+      module_process_thread_.RegisterModuleWithAffinity(rtp_rtcp, channel_id_);
     }
 
     // Remove last in list if we have too many.
@@ -632,22 +642,56 @@ int ViEChannel::SetSenderBufferingMode(int target_delay_ms) {
     LOG(LS_ERROR) << "Invalid send buffer value.";
     return -1;
   }
-  if (target_delay_ms == 0) {
-    // Real-time mode.
-    nack_history_size_sender_ = kSendSidePacketHistorySize;
-  } else {
-    nack_history_size_sender_ = GetRequiredNackListSize(target_delay_ms);
-    // Don't allow a number lower than the default value.
-    if (nack_history_size_sender_ < kSendSidePacketHistorySize) {
-      nack_history_size_sender_ = kSendSidePacketHistorySize;
-    }
-  }
+  sender_target_delay_ms_ = target_delay_ms;
+  UpdateNackHistorySizeSender();
   if (rtp_rtcp_->SetStorePacketsStatus(true, nack_history_size_sender_) != 0) {
     return -1;
   }
   return 0;
 }
 
+int ViEChannel::SetSendSideHistorySize(int num_packets) {
+  if (num_packets <= 0 ||
+      num_packets > GetRequiredNackListSize(kMaxTargetDelayMs)) {
+    LOG(LS_ERROR) << "Invalid send side history size.";
+    return -1;
+  }
+  send_side_history_size_ = num_packets;
+  int old_history_size = nack_history_size_sender_;
+  UpdateNackHistorySizeSender();
+  if (nack_history_size_sender_ == old_history_size)
+    return 0;
+
+  // Only the modules which already keep a history are resized; the others
+  // pick up the new size when NACK or pacing turns storing on.
+  if (rtp_rtcp_->StorePackets() &&
+      rtp_rtcp_->SetStorePacketsStatus(true, nack_history_size_sender_) != 0) {
+    return -1;
+  }
+  CriticalSectionScoped cs(rtp_rtcp_cs_.get());
+  for (std::list<RtpRtcp*>::iterator it = simulcast_rtp_rtcp_.begin();
+       it != simulcast_rtp_rtcp_.end(); ++it) {
+    RtpRtcp* rtp_rtcp = *it;
+    if (rtp_rtcp->StorePackets())
+      rtp_rtcp->SetStorePacketsStatus(true, nack_history_size_sender_);
+  }
+  return 0;
+}
+
+void ViEChannel::UpdateNackHistorySizeSender() {
+  if (sender_target_delay_ms_ == 0) {
+    // Real-time mode.
+    nack_history_size_sender_ = send_side_history_size_;
+  } else {
+    nack_history_size_sender_ =
+        GetRequiredNackListSize(sender_target_delay_ms_);
+    // Don't allow a number lower than the real-time history.
+    if (nack_history_size_sender_ < send_side_history_size_) {
+      nack_history_size_sender_ = send_side_history_size_;
+    }
+  }
+}
+
 int ViEChannel::SetReceiverBufferingMode(int target_delay_ms) {
   if ((target_delay_ms < 0) || (target_delay_ms > kMaxTargetDelayMs)) {
     LOG(LS_ERROR) << "Invalid receive buffer delay value.";
@@ -1417,17 +1461,7 @@ int32_t ViEChannel::FrameToRender(
     if (pre_render_callback_ != NULL)
       pre_render_callback_->FrameCallback(&video_frame);
     if (effect_filter_) {
-      unsigned int length = CalcBufferSize(kI420,
-                                           video_frame.width(),
-                                           video_frame.height());
-      scoped_ptr<uint8_t[]> video_buffer(new uint8_t[length]);
-      ExtractBuffer(video_frame, length, video_buffer.get());
-      effect_filter_->Transform(length,
-                                video_buffer.get(),
-                                video_frame.ntp_time_ms(),
-                                video_frame.timestamp(),
-                                video_frame.width(),
-                                video_frame.height());
+      ApplyEffectFilter(effect_filter_, &video_frame, &effect_output_frame_);
     }
     if (color_enhancement_) {
       VideoProcessingModule::ColorEnhancement(&video_frame);
@@ -1511,6 +1545,14 @@ bool ViEChannel::ChannelDecodeProcess() {
   return true;
 }
 
+bool ViEChannel::DecodeNextFrame() {
+  return vcm_->Decode(0) == VCM_OK;
+}
+
+int ViEChannel::TimeUntilNextFrameMs() {
+  return vcm_->TimeUntilNextFrameMs();
+}
+
 void ViEChannel::OnRttUpdate(uint32_t rtt) {
   vcm_->SetReceiveChannelParameters(rtt);
 }
@@ -1569,15 +1611,30 @@ RtpRtcp* ViEChannel::CreateRtpRtcpModule() {
   return RtpRtcp::CreateRtpRtcp(configuration);
 }
 
+void ViEChannel::SetDecodePool(ViEDecodePool* decode_pool) {
+  assert(!decode_thread_ && !decoding_on_pool_);
+  decode_pool_ = decode_pool;
+}
+
+void ViEChannel::SetFecThreadPool(ThreadPool* fec_pool) {
+  vie_receiver_.SetFecThreadPool(fec_pool);
+}
+
 int32_t ViEChannel::StartDecodeThread() {
   // Start the decode thread
-  if (decode_thread_) {
+  if (decode_thread_ || decoding_on_pool_) {
     // Already started.
     return 0;
   }
+  if (decode_pool_) {
+    vie_receiver_.SetDecodeWakeUp(decode_pool_->AddDecoder(this));
+    decoding_on_pool_ = true;
+    return 0;
+  }
   decode_thread_ = ThreadWrapper::CreateThread(ChannelDecodeThreadFunction,
                                                    this, kHighestPriority,
-                                                   "DecodingThread");
+                                                   "DecodingThread",
+                                                   kDecoderThreadRole);
   if (!decode_thread_) {
     return -1;
   }
@@ -1593,6 +1650,12 @@ int32_t ViEChannel::StartDecodeThread() {
 }
 
 int32_t ViEChannel::StopDecodeThread() {
+  if (decoding_on_pool_) {
+    vie_receiver_.SetDecodeWakeUp(NULL);
+    decode_pool_->RemoveDecoder(this);
+    decoding_on_pool_ = false;
+    return 0;
+  }
   if (!decode_thread_) {
     return 0;
   }
@@ -1611,7 +1674,7 @@ int32_t ViEChannel::SetVoiceChannel(int32_t ve_channel_id,
                                           VoEVideoSync* ve_sync_interface) {
   if (ve_sync_interface) {
     // Register lip sync
-    module_process_thread_.RegisterModule(&vie_sync_);
+    module_process_thread_.RegisterModuleWithAffinity(&vie_sync_, channel_id_);
   } else {
     module_process_thread_.DeRegisterModule(&vie_sync_);
   }
@@ -13,6 +13,7 @@
 
 #include <list>
 
+#include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 #include "webrtc/modules/video_coding/main/interface/video_coding_defines.h"
@@ -22,6 +23,7 @@
 #include "webrtc/typedefs.h"
 #include "webrtc/video_engine/include/vie_network.h"
 #include "webrtc/video_engine/include/vie_rtp_rtcp.h"
+#include "webrtc/video_engine/vie_decode_pool.h"
 #include "webrtc/video_engine/vie_defines.h"
 #include "webrtc/video_engine/vie_frame_provider_base.h"
 #include "webrtc/video_engine/vie_receiver.h"
@@ -40,6 +42,7 @@ class PacedSender;
 class ProcessThread;
 class RtcpRttStats;
 class RtpRtcp;
+class ThreadPool;
 class ThreadWrapper;
 class ViEDecoderObserver;
 class ViEEffectFilter;
@@ -58,6 +61,7 @@ class ViEChannel
       public VCMPacketRequestCallback,
       public RtcpFeedback,
       public RtpFeedback,
+      public ViEDecodePool::Decoder,
       public ViEFrameProviderBase {
  public:
   friend class ChannelStatsObserver;
@@ -78,6 +82,14 @@ class ViEChannel
 
   int32_t Init();
 
+  // Decodes on |decode_pool| instead of a decode thread of its own. Must be
+  // set before receiving is started.
+  void SetDecodePool(ViEDecodePool* decode_pool);
+
+  // Recovers FEC on a TaskQueue of |fec_pool| instead of on the network
+  // thread. Must be set before receiving is started.
+  void SetFecThreadPool(ThreadPool* fec_pool);
+
   // Sets the encoder to use for the channel. |new_stream| indicates the encoder
   // type has changed and we should start a new RTP stream.
   int32_t SetSendCodec(const VideoCodec& video_codec, bool new_stream = true);
@@ -118,6 +130,7 @@ class ViEChannel
                                  const unsigned char payload_typeRED,
                                  const unsigned char payload_typeFEC);
   int SetSenderBufferingMode(int target_delay_ms);
+  int SetSendSideHistorySize(int num_packets);
   int SetReceiverBufferingMode(int target_delay_ms);
   int32_t SetKeyFrameRequestMethod(const KeyFrameRequestMethod method);
   bool EnableRemb(bool enable);
@@ -344,6 +357,10 @@ class ViEChannel
                           VoEVideoSync* ve_sync_interface);
   int32_t VoiceChannel();
 
+  // Implements ViEDecodePool::Decoder.
+  virtual bool DecodeNextFrame();
+  virtual int TimeUntilNextFrameMs();
+
   // Implements ViEFrameProviderBase.
   virtual int FrameCallbackChanged() {return -1;}
 
@@ -381,6 +398,9 @@ class ViEChannel
                             const unsigned char payload_typeFEC);
   // Compute NACK list parameters for the buffering mode.
   int GetRequiredNackListSize(int target_delay_ms);
+  // Sets |nack_history_size_sender_| from the real-time history size and the
+  // sender buffering delay.
+  void UpdateNackHistorySizeSender();
   void SetRtxSendStatus(bool enable);
 
   // ViEChannel exposes methods that allow to modify observers and callbacks
@@ -488,8 +508,12 @@ class ViEChannel
   VideoCodec receive_codec_;
   bool wait_for_key_frame_;
   ThreadWrapper* decode_thread_;
+  ViEDecodePool* decode_pool_;
+  bool decoding_on_pool_;
 
   ViEEffectFilter* effect_filter_;
+  // The output of an effect filter changing the frame size.
+  I420VideoFrame effect_output_frame_;
   bool color_enhancement_;
 
   // User set MTU, -1 if not set.
@@ -497,6 +521,9 @@ class ViEChannel
   const bool sender_;
 
   int nack_history_size_sender_;
+  // The history kept in real-time mode, and the floor of buffered mode.
+  int send_side_history_size_;
+  int sender_target_delay_ms_;
   int max_nack_reordering_threshold_;
   I420FrameCallback* pre_render_callback_;
 };
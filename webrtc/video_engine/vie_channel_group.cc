@@ -157,9 +157,6 @@ ChannelGroup::ChannelGroup(int engine_id,
                            ProcessThread* process_thread,
                            const Config* config)
     : remb_(new VieRemb()),
-      bitrate_controller_(
-          BitrateController::CreateBitrateController(Clock::GetRealTimeClock(),
-                                                     true)),
       call_stats_(new CallStats()),
       encoder_state_feedback_(new EncoderStateFeedback()),
       config_(config),
@@ -171,6 +168,21 @@ ChannelGroup::ChannelGroup(int engine_id,
   }
   assert(config_);  // Must have a valid config pointer here.
 
+  bitrate_controller_.reset(BitrateController::CreateBitrateController(
+      Clock::GetRealTimeClock(), true));
+  const CachedBitrateEstimate& cached_estimate =
+      config_->Get<CachedBitrateEstimate>();
+  if (cached_estimate.cache) {
+    bitrate_controller_->SetEstimateCache(cached_estimate.cache,
+                                          cached_estimate.key);
+  }
+  const SharedBitrateAllocation& shared_allocation =
+      config_->Get<SharedBitrateAllocation>();
+  if (shared_allocation.allocator) {
+    bitrate_controller_->SetSharedBitrateAllocator(shared_allocation.allocator,
+                                                   shared_allocation.priority);
+  }
+
   remote_bitrate_estimator_.reset(
       new WrappingBitrateEstimator(engine_id,
                                    remb_.get(),
@@ -12,13 +12,16 @@
 
 #include "webrtc/common.h"
 #include "webrtc/engine_configurations.h"
+#include "webrtc/experiments.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp.h"
 #include "webrtc/modules/utility/interface/process_thread.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
 #include "webrtc/video_engine/call_stats.h"
 #include "webrtc/video_engine/encoder_state_feedback.h"
 #include "webrtc/video_engine/vie_channel.h"
+#include "webrtc/video_engine/vie_decode_pool.h"
 #include "webrtc/video_engine/vie_defines.h"
 #include "webrtc/video_engine/vie_encoder.h"
 #include "webrtc/video_engine/vie_remb.h"
@@ -38,7 +41,12 @@ ViEChannelManager::ViEChannelManager(
       voice_sync_interface_(NULL),
       voice_engine_(NULL),
       module_process_thread_(NULL),
-      engine_config_(config) {
+      engine_config_(config),
+      decode_pool_(ViEDecodePool::Create(
+          config.Get<VideoDecodeThreads>().num_threads)) {
+  int num_fec_threads = config.Get<FecRecoveryThreads>().num_threads;
+  if (num_fec_threads > 0)
+    fec_pool_.reset(ThreadPool::Create("ViEFecRecovery", num_fec_threads));
   for (int idx = 0; idx < free_channel_ids_size_; idx++) {
     free_channel_ids_[idx] = true;
   }
@@ -446,6 +454,8 @@ bool ViEChannelManager::CreateChannelObject(
                                            paced_sender,
                                            send_rtp_rtcp_module,
                                            sender);
+  vie_channel->SetDecodePool(decode_pool_.get());
+  vie_channel->SetFecThreadPool(fec_pool_.get());
   if (vie_channel->Init() != 0) {
     delete vie_channel;
     return false;
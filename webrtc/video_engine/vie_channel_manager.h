@@ -29,7 +29,9 @@ class Config;
 class CriticalSectionWrapper;
 class ProcessThread;
 class RtcpRttStats;
+class ThreadPool;
 class ViEChannel;
+class ViEDecodePool;
 class ViEEncoder;
 class VoEVideoSync;
 class VoiceEngine;
@@ -145,6 +147,12 @@ class ViEChannelManager: private ViEManagerBase {
   VoiceEngine* voice_engine_;
   ProcessThread* module_process_thread_;
   const Config& engine_config_;
+  // Shared by the receiving channels, NULL if each channel decodes on a thread
+  // of its own.
+  scoped_ptr<ViEDecodePool> decode_pool_;
+  // Shared by the receiving channels for FEC recovery, NULL if it's done on
+  // the network thread.
+  scoped_ptr<ThreadPool> fec_pool_;
 };
 
 class ViEChannelManagerScoped: private ViEManagerScopedBase {
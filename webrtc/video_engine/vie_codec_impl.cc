@@ -426,6 +426,17 @@ unsigned int ViECodecImpl::GetDiscardedPackets(const int video_channel) const {
   return vie_channel->DiscardedPackets();
 }
 
+unsigned int ViECodecImpl::GetFramesDroppedByRateControl(
+    const int video_channel) const {
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEEncoder* vie_encoder = cs.Encoder(video_channel);
+  if (!vie_encoder) {
+    shared_data_->SetLastError(kViECodecInvalidChannelId);
+    return static_cast<unsigned int>(-1);
+  }
+  return vie_encoder->FramesDroppedByRateControl();
+}
+
 int ViECodecImpl::SetKeyFrameRequestCallbackStatus(const int video_channel,
                                                    const bool enable) {
   LOG(LS_INFO) << "SetKeyFrameRequestCallbackStatus for " << video_channel
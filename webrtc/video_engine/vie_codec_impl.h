@@ -54,6 +54,8 @@ class ViECodecImpl
   virtual int GetCodecTargetBitrate(const int video_channel,
                                     unsigned int* bitrate) const;
   virtual unsigned int GetDiscardedPackets(const int video_channel) const;
+  virtual unsigned int GetFramesDroppedByRateControl(
+      const int video_channel) const;
   virtual int SetKeyFrameRequestCallbackStatus(const int video_channel,
                                                const bool enable);
   virtual int SetSignalKeyPacketLossStatus(const int video_channel,
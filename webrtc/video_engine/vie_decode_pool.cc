@@ -0,0 +1,230 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/vie_decode_pool.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "webrtc/system_wrappers/interface/condition_variable_wrapper.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+
+namespace {
+
+// The next pass time while none is posted.
+const int64_t kNoPassMs = std::numeric_limits<int64_t>::max();
+
+}  // namespace
+
+ViEDecodePool* ViEDecodePool::Create(int num_threads) {
+  if (num_threads < 1)
+    return NULL;
+  ViEDecodePool* pool = new ViEDecodePool(num_threads);
+  if (!pool->Init()) {
+    delete pool;
+    return NULL;
+  }
+  return pool;
+}
+
+ViEDecodePool::ViEDecodePool(int num_threads)
+    : crit_(CriticalSectionWrapper::CreateCriticalSection()) {
+  assert(num_threads > 0);
+  for (int i = 0; i < num_threads; ++i)
+    workers_.push_back(new Worker(i));
+}
+
+ViEDecodePool::~ViEDecodePool() {
+  for (size_t i = 0; i < workers_.size(); ++i)
+    delete workers_[i];
+}
+
+bool ViEDecodePool::Init() {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (!workers_[i]->Start()) {
+      LOG(LS_ERROR) << "Could not start decode thread " << i << ".";
+      return false;
+    }
+  }
+  return true;
+}
+
+ViEDecodePool::WakeUp* ViEDecodePool::AddDecoder(Decoder* decoder) {
+  CriticalSectionScoped cs(crit_.get());
+  Worker* least_loaded = workers_[0];
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    if (workers_[i]->num_decoders() < least_loaded->num_decoders())
+      least_loaded = workers_[i];
+  }
+  least_loaded->AddDecoder(decoder);
+  return least_loaded;
+}
+
+void ViEDecodePool::RemoveDecoder(Decoder* decoder) {
+  // Not under |crit_|, so that waiting for |decoder| doesn't hold up adding
+  // or removing other decoders.
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->RemoveDecoder(decoder))
+      return;
+  }
+}
+
+int ViEDecodePool::num_threads() const {
+  return static_cast<int>(workers_.size());
+}
+
+class ViEDecodePool::Worker::ProcessTask : public QueuedTask {
+ public:
+  explicit ProcessTask(Worker* worker) : worker_(worker) {}
+
+  virtual void Run() OVERRIDE { worker_->Process(); }
+
+ private:
+  Worker* const worker_;
+};
+
+ViEDecodePool::Worker::Worker(int index)
+    : index_(index),
+      crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      decode_done_(ConditionVariableWrapper::CreateConditionVariable()),
+      decoding_(NULL),
+      next_pass_ms_(kNoPassMs) {}
+
+ViEDecodePool::Worker::~Worker() {
+  Stop();
+}
+
+bool ViEDecodePool::Worker::Start() {
+  char name[32];
+  snprintf(name, sizeof(name), "DecodingThread%d", index_);
+  CriticalSectionScoped cs(crit_.get());
+  pool_.reset(ThreadPool::Create(name, 1, kHighestPriority,
+                                 kDecoderThreadRole));
+  return pool_.get() != NULL;
+}
+
+void ViEDecodePool::Worker::Stop() {
+  ThreadPool* pool = NULL;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    pool = pool_.release();
+  }
+  // Deleted without |crit_| held, as it waits for a running pass.
+  delete pool;
+}
+
+void ViEDecodePool::Worker::AddDecoder(Decoder* decoder) {
+  CriticalSectionScoped cs(crit_.get());
+  decoders_.push_back(decoder);
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  SchedulePass(now_ms, now_ms);
+}
+
+bool ViEDecodePool::Worker::RemoveDecoder(Decoder* decoder) {
+  CriticalSectionScoped cs(crit_.get());
+  std::vector<Decoder*>::iterator it =
+      std::find(decoders_.begin(), decoders_.end(), decoder);
+  if (it == decoders_.end())
+    return false;
+  decoders_.erase(it);
+  // The worker thread checks |decoders_| before it uses a decoder again, so
+  // only a frame being decoded needs to be waited for.
+  while (decoding_ == decoder)
+    decode_done_->SleepCS(*crit_);
+  return true;
+}
+
+int ViEDecodePool::Worker::num_decoders() const {
+  CriticalSectionScoped cs(crit_.get());
+  return static_cast<int>(decoders_.size());
+}
+
+void ViEDecodePool::Worker::Set() {
+  CriticalSectionScoped cs(crit_.get());
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  SchedulePass(now_ms, now_ms);
+}
+
+void ViEDecodePool::Worker::Process() {
+  {
+    CriticalSectionScoped cs(crit_.get());
+    // A later pass overtaken by an earlier one leaves |next_pass_ms_| alone.
+    if (next_pass_ms_ <= TickTime::MillisecondTimestamp())
+      next_pass_ms_ = kNoPassMs;
+    decoders_to_process_ = decoders_;
+  }
+  // Decode one frame per decoder and round, so that a decoder with a backlog
+  // doesn't hold up the others.
+  bool decoded = true;
+  while (decoded) {
+    decoded = false;
+    for (size_t i = 0; i < decoders_to_process_.size(); ++i) {
+      if (!BeginDecode(decoders_to_process_[i]))
+        continue;
+      if (decoders_to_process_[i]->DecodeNextFrame())
+        decoded = true;
+      EndDecode();
+    }
+  }
+  // Run again when a buffered frame becomes ready with time, when the decoder
+  // waits for its render time. New data posts a pass through Set().
+  int wait_time_ms = -1;
+  for (size_t i = 0; i < decoders_to_process_.size(); ++i) {
+    if (!BeginDecode(decoders_to_process_[i]))
+      continue;
+    const int time_ms = decoders_to_process_[i]->TimeUntilNextFrameMs();
+    EndDecode();
+    if (time_ms >= 0 && (wait_time_ms < 0 || time_ms < wait_time_ms))
+      wait_time_ms = time_ms;
+  }
+  if (wait_time_ms < 0)
+    return;
+  CriticalSectionScoped cs(crit_.get());
+  const int64_t now_ms = TickTime::MillisecondTimestamp();
+  SchedulePass(now_ms, now_ms + wait_time_ms);
+}
+
+void ViEDecodePool::Worker::SchedulePass(int64_t now_ms, int64_t run_at_ms) {
+  if (!pool_ || run_at_ms >= next_pass_ms_)
+    return;
+  next_pass_ms_ = run_at_ms;
+  if (run_at_ms <= now_ms) {
+    pool_->PostTask(new ProcessTask(this));
+  } else {
+    pool_->PostDelayedTask(new ProcessTask(this),
+                           static_cast<uint32_t>(run_at_ms - now_ms));
+  }
+}
+
+bool ViEDecodePool::Worker::BeginDecode(Decoder* decoder) {
+  CriticalSectionScoped cs(crit_.get());
+  if (std::find(decoders_.begin(), decoders_.end(), decoder) ==
+      decoders_.end()) {
+    return false;
+  }
+  decoding_ = decoder;
+  return true;
+}
+
+void ViEDecodePool::Worker::EndDecode() {
+  CriticalSectionScoped cs(crit_.get());
+  decoding_ = NULL;
+  decode_done_->WakeAll();
+}
+
+}  // namespace webrtc
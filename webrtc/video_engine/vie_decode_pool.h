@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_ENGINE_VIE_DECODE_POOL_H_
+#define WEBRTC_VIDEO_ENGINE_VIE_DECODE_POOL_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class ConditionVariableWrapper;
+class CriticalSectionWrapper;
+class ThreadPool;
+
+// ViEDecodePool decodes the receiving channels of an engine on a fixed number
+// of threads, instead of one decode thread per channel. Every decoder is
+// served by one worker for as long as it is added, so its frames are decoded
+// in order on the same thread.
+class ViEDecodePool {
+ public:
+  class Decoder {
+   public:
+    // Decodes the next frame if one is ready, without waiting for one.
+    // Returns true if a frame was decoded.
+    virtual bool DecodeNextFrame() = 0;
+
+    // Returns the time until a buffered frame is ready to be decoded, 0 if
+    // one is ready now, or -1 if no frame will become ready without new data.
+    virtual int TimeUntilNextFrameMs() = 0;
+
+   protected:
+    virtual ~Decoder() {}
+  };
+
+  // Makes the worker of a decoder look for frames to decode.
+  class WakeUp {
+   public:
+    virtual void Set() = 0;
+
+   protected:
+    virtual ~WakeUp() {}
+  };
+
+  // Returns NULL if |num_threads| is less than one or a thread fails to start.
+  static ViEDecodePool* Create(int num_threads);
+  ~ViEDecodePool();
+
+  // Starts decoding |decoder| on the least loaded worker. The returned wake-up
+  // is to be set whenever new data may have made a frame ready, e.g. when a
+  // packet has been inserted. It is owned by the pool and stays valid for the
+  // lifetime of the pool.
+  WakeUp* AddDecoder(Decoder* decoder);
+
+  // Stops decoding |decoder|. When this returns, |decoder| is not used by the
+  // pool anymore. Waits for a frame of |decoder| being decoded, but not for
+  // other decoders.
+  void RemoveDecoder(Decoder* decoder);
+
+  int num_threads() const;
+
+ private:
+  // Runs its decoding passes as tasks on a ThreadPool of one thread.
+  class Worker : public WakeUp {
+   public:
+    explicit Worker(int index);
+    virtual ~Worker();
+
+    bool Start();
+    void Stop();
+
+    void AddDecoder(Decoder* decoder);
+    // Returns false if |decoder| is not served by this worker.
+    bool RemoveDecoder(Decoder* decoder);
+    int num_decoders() const;
+
+    // Implements WakeUp.
+    virtual void Set() OVERRIDE;
+
+   private:
+    class ProcessTask;
+
+    // Decodes the frames that are ready, and schedules the next pass for when
+    // a buffered frame becomes ready.
+    void Process();
+    // Posts a pass at |run_at_ms| unless an earlier one is posted already.
+    // Must be called with |crit_| held.
+    void SchedulePass(int64_t now_ms, int64_t run_at_ms);
+    // Marks |decoder| as being used by the worker thread, unless it has been
+    // removed. Returns false if it has.
+    bool BeginDecode(Decoder* decoder);
+    void EndDecode();
+
+    const int index_;
+    // Protects |decoders_|, |decoding_|, |pool_| and |next_pass_ms_|.
+    const scoped_ptr<CriticalSectionWrapper> crit_;
+    // Signaled when the worker thread stops using |decoding_|.
+    const scoped_ptr<ConditionVariableWrapper> decode_done_;
+    std::vector<Decoder*> decoders_;
+    // The decoder used by the worker thread, or NULL.
+    Decoder* decoding_;
+    // A copy of |decoders_| only used on the worker thread, which is checked
+    // against |decoders_| before every use of a decoder.
+    std::vector<Decoder*> decoders_to_process_;
+    // Set while the worker is started.
+    scoped_ptr<ThreadPool> pool_;
+    // The earliest pass that is posted, if any.
+    int64_t next_pass_ms_;
+
+    DISALLOW_COPY_AND_ASSIGN(Worker);
+  };
+
+  explicit ViEDecodePool(int num_threads);
+  bool Init();
+
+  // Makes adding a decoder to the least loaded worker atomic.
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  // Fixed at construction, so used without |crit_|.
+  std::vector<Worker*> workers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ViEDecodePool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_VIE_DECODE_POOL_H_
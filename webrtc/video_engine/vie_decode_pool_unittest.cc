@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/vie_decode_pool.h"
+
+#include <algorithm>
+#include <set>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/event_wrapper.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/sleep.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/system_wrappers/interface/tick_util.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumThreads = 2;
+const int kNumDecoders = 4;
+const int kNumFrames = 50;
+const int kWaitTimeMs = 10000;
+
+// Decodes the frames given to it and records the thread they are decoded on.
+class FakeDecoder : public ViEDecodePool::Decoder {
+ public:
+  FakeDecoder()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        drained_(EventWrapper::Create()),
+        decode_started_(EventWrapper::Create()),
+        num_pending_(0),
+        num_decoded_(0),
+        thread_id_(0),
+        moved_thread_(false),
+        ready_time_ms_(0),
+        decode_time_ms_(0) {}
+  virtual ~FakeDecoder() {}
+
+  virtual bool DecodeNextFrame() {
+    int decode_time_ms = 0;
+    {
+      CriticalSectionScoped cs(crit_.get());
+      if (num_pending_ == 0 ||
+          TickTime::MillisecondTimestamp() < ready_time_ms_) {
+        return false;
+      }
+      decode_time_ms = decode_time_ms_;
+    }
+    decode_started_->Set();
+    if (decode_time_ms > 0)
+      SleepMs(decode_time_ms);
+    CriticalSectionScoped cs(crit_.get());
+    const uint32_t thread_id = ThreadWrapper::GetThreadId();
+    if (num_decoded_ > 0 && thread_id != thread_id_)
+      moved_thread_ = true;
+    thread_id_ = thread_id;
+    ++num_decoded_;
+    if (--num_pending_ == 0)
+      drained_->Set();
+    return true;
+  }
+
+  virtual int TimeUntilNextFrameMs() {
+    CriticalSectionScoped cs(crit_.get());
+    if (num_pending_ == 0)
+      return -1;
+    return std::max(static_cast<int>(ready_time_ms_ -
+                                     TickTime::MillisecondTimestamp()), 0);
+  }
+
+  void AddFrames(int num_frames) {
+    CriticalSectionScoped cs(crit_.get());
+    num_pending_ += num_frames;
+  }
+
+  // Adds a frame which can't be decoded until |delay_ms| from now.
+  void AddDelayedFrame(int delay_ms) {
+    CriticalSectionScoped cs(crit_.get());
+    ++num_pending_;
+    ready_time_ms_ = TickTime::MillisecondTimestamp() + delay_ms;
+  }
+
+  void set_decode_time_ms(int decode_time_ms) {
+    CriticalSectionScoped cs(crit_.get());
+    decode_time_ms_ = decode_time_ms;
+  }
+
+  bool WaitForDecodeStarted() {
+    return decode_started_->Wait(kWaitTimeMs) == kEventSignaled;
+  }
+
+  bool WaitForDrained() {
+    return drained_->Wait(kWaitTimeMs) == kEventSignaled;
+  }
+
+  int num_decoded() const {
+    CriticalSectionScoped cs(crit_.get());
+    return num_decoded_;
+  }
+
+  uint32_t thread_id() const {
+    CriticalSectionScoped cs(crit_.get());
+    return thread_id_;
+  }
+
+  bool moved_thread() const {
+    CriticalSectionScoped cs(crit_.get());
+    return moved_thread_;
+  }
+
+ private:
+  const scoped_ptr<CriticalSectionWrapper> crit_;
+  const scoped_ptr<EventWrapper> drained_;
+  const scoped_ptr<EventWrapper> decode_started_;
+  int num_pending_;
+  int num_decoded_;
+  uint32_t thread_id_;
+  bool moved_thread_;
+  int64_t ready_time_ms_;
+  int decode_time_ms_;
+};
+
+}  // namespace
+
+TEST(ViEDecodePoolTest, DecodesEveryDecoderOnOneWorker) {
+  scoped_ptr<ViEDecodePool> pool(ViEDecodePool::Create(kNumThreads));
+  ASSERT_TRUE(pool.get() != NULL);
+  EXPECT_EQ(kNumThreads, pool->num_threads());
+
+  FakeDecoder decoders[kNumDecoders];
+  ViEDecodePool::WakeUp* wake_ups[kNumDecoders];
+  for (int i = 0; i < kNumDecoders; ++i) {
+    wake_ups[i] = pool->AddDecoder(&decoders[i]);
+    ASSERT_TRUE(wake_ups[i] != NULL);
+  }
+  for (int j = 0; j < kNumFrames; ++j) {
+    for (int i = 0; i < kNumDecoders; ++i) {
+      decoders[i].AddFrames(1);
+      wake_ups[i]->Set();
+    }
+  }
+
+  std::set<uint32_t> thread_ids;
+  for (int i = 0; i < kNumDecoders; ++i) {
+    // A decoder may have been drained before all frames were added.
+    while (decoders[i].num_decoded() < kNumFrames)
+      ASSERT_TRUE(decoders[i].WaitForDrained());
+    EXPECT_EQ(kNumFrames, decoders[i].num_decoded());
+    EXPECT_FALSE(decoders[i].moved_thread());
+    EXPECT_NE(ThreadWrapper::GetThreadId(), decoders[i].thread_id());
+    thread_ids.insert(decoders[i].thread_id());
+  }
+  EXPECT_EQ(static_cast<size_t>(kNumThreads), thread_ids.size());
+
+  for (int i = 0; i < kNumDecoders; ++i)
+    pool->RemoveDecoder(&decoders[i]);
+}
+
+TEST(ViEDecodePoolTest, DoesNotUseRemovedDecoder) {
+  EXPECT_TRUE(ViEDecodePool::Create(0) == NULL);
+  scoped_ptr<ViEDecodePool> pool(ViEDecodePool::Create(1));
+  ASSERT_TRUE(pool.get() != NULL);
+
+  FakeDecoder decoder;
+  ViEDecodePool::WakeUp* wake_up = pool->AddDecoder(&decoder);
+  decoder.AddFrames(1);
+  wake_up->Set();
+  ASSERT_TRUE(decoder.WaitForDrained());
+
+  pool->RemoveDecoder(&decoder);
+  decoder.AddFrames(1);
+  wake_up->Set();
+  // Give the worker time for a couple of rounds.
+  SleepMs(50);
+  EXPECT_EQ(1, decoder.num_decoded());
+}
+
+TEST(ViEDecodePoolTest, WaitsForDecodeWhenRemovingDecoder) {
+  scoped_ptr<ViEDecodePool> pool(ViEDecodePool::Create(1));
+  ASSERT_TRUE(pool.get() != NULL);
+
+  FakeDecoder decoder;
+  decoder.set_decode_time_ms(50);
+  ViEDecodePool::WakeUp* wake_up = pool->AddDecoder(&decoder);
+  decoder.AddFrames(1);
+  wake_up->Set();
+  ASSERT_TRUE(decoder.WaitForDecodeStarted());
+  pool->RemoveDecoder(&decoder);
+  EXPECT_EQ(1, decoder.num_decoded());
+}
+
+TEST(ViEDecodePoolTest, DecodesFrameReadyWithTimeWithoutWakeUp) {
+  scoped_ptr<ViEDecodePool> pool(ViEDecodePool::Create(1));
+  ASSERT_TRUE(pool.get() != NULL);
+
+  FakeDecoder decoder;
+  ViEDecodePool::WakeUp* wake_up = pool->AddDecoder(&decoder);
+  decoder.AddDelayedFrame(30);
+  // Only the frame arrival wakes the worker up, not the time it is ready.
+  wake_up->Set();
+  ASSERT_TRUE(decoder.WaitForDrained());
+  EXPECT_EQ(1, decoder.num_decoded());
+  pool->RemoveDecoder(&decoder);
+}
+
+}  // namespace webrtc
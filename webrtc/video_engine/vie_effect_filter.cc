@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/vie_effect_filter.h"
+
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/video_engine/include/vie_image_process.h"
+
+namespace webrtc {
+
+namespace {
+
+// Points |planes| at the planes of |frame|. Taking the non-const buffers gives
+// the frame its own pixel data if it is shared with another frame, which is
+// only needed for a frame that is written to.
+void GetPlanes(I420VideoFrame* frame, bool writable,
+               ViEVideoFrameI420* planes) {
+  const I420VideoFrame* const_frame = frame;
+  planes->y_plane = writable ? frame->buffer(kYPlane) :
+      const_cast<uint8_t*>(const_frame->buffer(kYPlane));
+  planes->u_plane = writable ? frame->buffer(kUPlane) :
+      const_cast<uint8_t*>(const_frame->buffer(kUPlane));
+  planes->v_plane = writable ? frame->buffer(kVPlane) :
+      const_cast<uint8_t*>(const_frame->buffer(kVPlane));
+  planes->y_pitch = frame->stride(kYPlane);
+  planes->u_pitch = frame->stride(kUPlane);
+  planes->v_pitch = frame->stride(kVPlane);
+  planes->width = static_cast<unsigned short>(frame->width());
+  planes->height = static_cast<unsigned short>(frame->height());
+}
+
+}  // namespace
+
+int ApplyEffectFilter(ViEEffectFilter* filter,
+                      I420VideoFrame* video_frame,
+                      I420VideoFrame* output_frame) {
+  const unsigned int width = video_frame->width();
+  const unsigned int height = video_frame->height();
+  if (!filter->TransformsInPlace()) {
+    unsigned int length = CalcBufferSize(kI420, width, height);
+    scoped_ptr<uint8_t[]> video_buffer(new uint8_t[length]);
+    ExtractBuffer(*video_frame, length, video_buffer.get());
+    return filter->Transform(length,
+                             video_buffer.get(),
+                             video_frame->ntp_time_ms(),
+                             video_frame->timestamp(),
+                             width,
+                             height);
+  }
+
+  unsigned int output_width = width;
+  unsigned int output_height = height;
+  filter->GetOutputSize(width, height, &output_width, &output_height);
+  const bool in_place = output_width == width && output_height == height;
+  ViEVideoFrameI420 frame;
+  GetPlanes(video_frame, in_place, &frame);
+  if (in_place) {
+    return filter->TransformFrame(&frame,
+                                  NULL,
+                                  video_frame->ntp_time_ms(),
+                                  video_frame->timestamp());
+  }
+
+  const int half_width = (output_width + 1) / 2;
+  if (output_frame->CreateEmptyFrame(output_width, output_height,
+                                     output_width, half_width,
+                                     half_width) != 0) {
+    return -1;
+  }
+  ViEVideoFrameI420 output;
+  GetPlanes(output_frame, true, &output);
+  const int ret = filter->TransformFrame(&frame,
+                                         &output,
+                                         video_frame->ntp_time_ms(),
+                                         video_frame->timestamp());
+  if (ret != 0)
+    return ret;
+  output_frame->set_timestamp(video_frame->timestamp());
+  output_frame->set_ntp_time_ms(video_frame->ntp_time_ms());
+  output_frame->set_render_time_ms(video_frame->render_time_ms());
+  video_frame->SwapFrame(output_frame);
+  return 0;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,30 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_ENGINE_VIE_EFFECT_FILTER_H_
+#define WEBRTC_VIDEO_ENGINE_VIE_EFFECT_FILTER_H_
+
+namespace webrtc {
+
+class I420VideoFrame;
+class ViEEffectFilter;
+
+// Runs |filter| on |video_frame|, as done on the capture, send and render
+// paths. A filter transforming frames in place gets the planes of
+// |video_frame|. If it changes the frame size, it writes to |output_frame|,
+// which is swapped with |video_frame| afterwards so its buffers are reused for
+// the following frames. Other filters get a copy of the frame.
+int ApplyEffectFilter(ViEEffectFilter* filter,
+                      I420VideoFrame* video_frame,
+                      I420VideoFrame* output_frame);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENGINE_VIE_EFFECT_FILTER_H_
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2014 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video_engine/vie_effect_filter.h"
+
+#include <string.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_video/interface/i420_video_frame.h"
+#include "webrtc/video_engine/include/vie_image_process.h"
+
+namespace webrtc {
+namespace {
+
+const int kWidth = 16;
+const int kHeight = 8;
+const uint32_t kTimestamp = 90000;
+const int64_t kNtpTimeMs = 12345;
+const int64_t kRenderTimeMs = 678;
+
+// Sets every pixel of the frames it gets, in place or on a copy, to |value|.
+// Frames are halved in size if |downscale| is set.
+class FillFilter : public ViEEffectFilter {
+ public:
+  FillFilter(bool in_place, bool downscale, uint8_t value)
+      : in_place_(in_place),
+        downscale_(downscale),
+        value_(value),
+        num_transforms_(0),
+        num_frame_transforms_(0) {}
+  virtual ~FillFilter() {}
+
+  virtual int Transform(int size,
+                        unsigned char* frame_buffer,
+                        int64_t ntp_time_ms,
+                        unsigned int timestamp,
+                        unsigned int width,
+                        unsigned int height) {
+    ++num_transforms_;
+    memset(frame_buffer, value_, size);
+    return 0;
+  }
+
+  virtual bool TransformsInPlace() const { return in_place_; }
+
+  virtual void GetOutputSize(unsigned int width,
+                             unsigned int height,
+                             unsigned int* output_width,
+                             unsigned int* output_height) const {
+    *output_width = downscale_ ? width / 2 : width;
+    *output_height = downscale_ ? height / 2 : height;
+  }
+
+  virtual int TransformFrame(ViEVideoFrameI420* frame,
+                             ViEVideoFrameI420* output_frame,
+                             int64_t ntp_time_ms,
+                             unsigned int timestamp) {
+    ++num_frame_transforms_;
+    EXPECT_EQ(kNtpTimeMs, ntp_time_ms);
+    EXPECT_EQ(kTimestamp, timestamp);
+    ViEVideoFrameI420* out = output_frame ? output_frame : frame;
+    const int half_height = (out->height + 1) / 2;
+    memset(out->y_plane, value_, out->y_pitch * out->height);
+    memset(out->u_plane, value_, out->u_pitch * half_height);
+    memset(out->v_plane, value_, out->v_pitch * half_height);
+    return 0;
+  }
+
+  int num_transforms() const { return num_transforms_; }
+  int num_frame_transforms() const { return num_frame_transforms_; }
+
+ private:
+  const bool in_place_;
+  const bool downscale_;
+  const uint8_t value_;
+  int num_transforms_;
+  int num_frame_transforms_;
+};
+
+void CreateFrame(uint8_t value, I420VideoFrame* frame) {
+  const int half_width = (kWidth + 1) / 2;
+  ASSERT_EQ(0, frame->CreateEmptyFrame(kWidth, kHeight, kWidth, half_width,
+                                       half_width));
+  memset(frame->buffer(kYPlane), value, frame->allocated_size(kYPlane));
+  memset(frame->buffer(kUPlane), value, frame->allocated_size(kUPlane));
+  memset(frame->buffer(kVPlane), value, frame->allocated_size(kVPlane));
+  frame->set_timestamp(kTimestamp);
+  frame->set_ntp_time_ms(kNtpTimeMs);
+  frame->set_render_time_ms(kRenderTimeMs);
+}
+
+const I420VideoFrame& AsConst(const I420VideoFrame& frame) { return frame; }
+
+}  // namespace
+
+TEST(ViEEffectFilterTest, TransformsCopyOfFrame) {
+  FillFilter filter(false, false, 1);
+  I420VideoFrame frame;
+  I420VideoFrame output_frame;
+  CreateFrame(0, &frame);
+  EXPECT_EQ(0, ApplyEffectFilter(&filter, &frame, &output_frame));
+  EXPECT_EQ(1, filter.num_transforms());
+  EXPECT_EQ(0, filter.num_frame_transforms());
+  EXPECT_EQ(0, AsConst(frame).buffer(kYPlane)[0]);
+}
+
+TEST(ViEEffectFilterTest, TransformsFrameInPlace) {
+  FillFilter filter(true, false, 1);
+  I420VideoFrame frame;
+  I420VideoFrame output_frame;
+  CreateFrame(0, &frame);
+  const uint8_t* y_plane = AsConst(frame).buffer(kYPlane);
+  EXPECT_EQ(0, ApplyEffectFilter(&filter, &frame, &output_frame));
+  EXPECT_EQ(0, filter.num_transforms());
+  EXPECT_EQ(1, filter.num_frame_transforms());
+  EXPECT_EQ(y_plane, AsConst(frame).buffer(kYPlane));
+  EXPECT_EQ(1, AsConst(frame).buffer(kYPlane)[0]);
+  EXPECT_EQ(1, AsConst(frame).buffer(kVPlane)[0]);
+  EXPECT_TRUE(output_frame.IsZeroSize());
+}
+
+TEST(ViEEffectFilterTest, DoesNotModifySharedPixels) {
+  FillFilter filter(true, false, 1);
+  I420VideoFrame frame;
+  I420VideoFrame copy;
+  I420VideoFrame output_frame;
+  CreateFrame(0, &frame);
+  ASSERT_EQ(0, copy.CopyFrame(frame));
+  EXPECT_EQ(0, ApplyEffectFilter(&filter, &copy, &output_frame));
+  EXPECT_EQ(1, AsConst(copy).buffer(kYPlane)[0]);
+  EXPECT_EQ(0, AsConst(frame).buffer(kYPlane)[0]);
+}
+
+TEST(ViEEffectFilterTest, ReplacesFrameChangingSize) {
+  FillFilter filter(true, true, 1);
+  I420VideoFrame frame;
+  I420VideoFrame output_frame;
+  CreateFrame(0, &frame);
+  EXPECT_EQ(0, ApplyEffectFilter(&filter, &frame, &output_frame));
+  EXPECT_EQ(1, filter.num_frame_transforms());
+  EXPECT_EQ(kWidth / 2, frame.width());
+  EXPECT_EQ(kHeight / 2, frame.height());
+  EXPECT_EQ(kTimestamp, frame.timestamp());
+  EXPECT_EQ(kNtpTimeMs, frame.ntp_time_ms());
+  EXPECT_EQ(kRenderTimeMs, frame.render_time_ms());
+  EXPECT_EQ(1, AsConst(frame).buffer(kYPlane)[0]);
+  // The input frame is kept for the output of the next frame.
+  EXPECT_EQ(kWidth, output_frame.width());
+  EXPECT_EQ(0, AsConst(output_frame).buffer(kYPlane)[0]);
+}
+
+}  // namespace webrtc
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 
+#include "webrtc/common.h"
 #include "webrtc/common_video/interface/video_image.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/pacing/include/paced_sender.h"
@@ -30,8 +31,10 @@
 #include "webrtc/system_wrappers/interface/trace_event.h"
 #include "webrtc/video_engine/include/vie_codec.h"
 #include "webrtc/video_engine/include/vie_image_process.h"
+#include "webrtc/experiments.h"
 #include "webrtc/frame_callback.h"
 #include "webrtc/video_engine/vie_defines.h"
+#include "webrtc/video_engine/vie_effect_filter.h"
 
 namespace webrtc {
 
@@ -152,6 +155,9 @@ ViEEncoder::ViEEncoder(int32_t engine_id,
     picture_id_sli_(0),
     has_received_rpsi_(false),
     picture_id_rpsi_(0),
+    picture_loss_recovery_(false),
+    has_received_pli_(false),
+    key_frame_replay_max_age_ms_(config.Get<KeyFrameReplay>().max_age_ms),
     qm_callback_(NULL),
     video_suspended_(false),
     pre_encode_callback_(NULL) {
@@ -165,6 +171,9 @@ ViEEncoder::ViEEncoder(int32_t engine_id,
   paced_sender_.reset(
       new PacedSender(Clock::GetRealTimeClock(), pacing_callback_.get(),
                       PacedSender::kDefaultInitialPaceKbps, 0));
+  // Probe the path at call start, so that a receiver using the absolute send
+  // time can estimate its capacity right away.
+  paced_sender_->SetProbingEnabled(true);
 }
 
 bool ViEEncoder::Init() {
@@ -176,9 +185,12 @@ bool ViEEncoder::Init() {
   // Enable/disable content analysis: off by default for now.
   vpm_.EnableContentAnalysis(false);
 
-  if (module_process_thread_.RegisterModule(&vcm_) != 0 ||
-      module_process_thread_.RegisterModule(default_rtp_rtcp_.get()) != 0 ||
-      module_process_thread_.RegisterModule(paced_sender_.get()) != 0) {
+  if (module_process_thread_.RegisterModuleWithAffinity(&vcm_,
+                                                        channel_id_) != 0 ||
+      module_process_thread_.RegisterModuleWithAffinity(default_rtp_rtcp_.get(),
+                                                        channel_id_) != 0 ||
+      module_process_thread_.RegisterModuleWithAffinity(paced_sender_.get(),
+                                                        channel_id_) != 0) {
     return false;
   }
   if (qm_callback_) {
@@ -194,6 +206,10 @@ bool ViEEncoder::Init() {
   {
     CriticalSectionScoped cs(data_cs_.get());
     send_padding_ = video_codec.numberOfSimulcastStreams > 1;
+    picture_loss_recovery_ = video_codec.codecType == kVideoCodecVP8 &&
+        video_codec.codecSpecific.VP8.feedbackModeOn &&
+        video_codec.numberOfSimulcastStreams <= 1;
+    has_received_pli_ = false;
   }
   if (vcm_.RegisterSendCodec(&video_codec, number_of_cores_,
                              default_rtp_rtcp_->MaxDataPayloadLength()) != 0) {
@@ -508,21 +524,13 @@ void ViEEncoder::DeliverFrame(int id,
   }
 
   I420VideoFrame* decimated_frame = NULL;
-  // TODO(wuchengli): support texture frames.
+  // Texture frames are neither filtered nor preprocessed. They go to the
+  // encoder as captured, which has to support them.
   if (video_frame->native_handle() == NULL) {
     {
       CriticalSectionScoped cs(callback_cs_.get());
       if (effect_filter_) {
-        unsigned int length =
-            CalcBufferSize(kI420, video_frame->width(), video_frame->height());
-        scoped_ptr<uint8_t[]> video_buffer(new uint8_t[length]);
-        ExtractBuffer(*video_frame, length, video_buffer.get());
-        effect_filter_->Transform(length,
-                                  video_buffer.get(),
-                                  video_frame->ntp_time_ms(),
-                                  video_frame->timestamp(),
-                                  video_frame->width(),
-                                  video_frame->height());
+        ApplyEffectFilter(effect_filter_, video_frame, &effect_output_frame_);
       }
     }
 
@@ -547,10 +555,8 @@ void ViEEncoder::DeliverFrame(int id,
       pre_encode_callback_->FrameCallback(decimated_frame);
   }
 
-  if (video_frame->native_handle() != NULL) {
-    // TODO(wuchengli): add texture support. http://crbug.com/362437
-    return;
-  }
+  // Let the frame dropper account for the data still waiting to be sent.
+  vcm_.SetPacerQueueDelay(paced_sender_->QueueInMs());
 
 #ifdef VIDEOCODEC_VP8
   if (vcm_.SendCodec() == webrtc::kVideoCodecVP8) {
@@ -566,12 +572,30 @@ void ViEEncoder::DeliverFrame(int id,
           picture_id_rpsi_;
       codec_specific_info.codecSpecific.VP8.pictureIdSLI  =
           picture_id_sli_;
+      codec_specific_info.codecSpecific.VP8.hasReceivedPLI =
+          has_received_pli_;
       has_received_sli_ = false;
       has_received_rpsi_ = false;
+      has_received_pli_ = false;
     }
 
-    vcm_.AddVideoFrame(*decimated_frame, vpm_.ContentMetrics(),
-                       &codec_specific_info);
+    if (vcm_.AddVideoFrame(*decimated_frame, vpm_.ContentMetrics(),
+                           &codec_specific_info) < 0) {
+      // The frame never reached the encoder, e.g. a texture frame it cannot
+      // read. Keep the feedback for the next frame, unless newer feedback
+      // has arrived meanwhile.
+      CriticalSectionScoped cs(data_cs_.get());
+      const CodecSpecificInfoVP8& vp8 = codec_specific_info.codecSpecific.VP8;
+      if (vp8.hasReceivedSLI && !has_received_sli_) {
+        has_received_sli_ = true;
+        picture_id_sli_ = vp8.pictureIdSLI;
+      }
+      if (vp8.hasReceivedRPSI && !has_received_rpsi_) {
+        has_received_rpsi_ = true;
+        picture_id_rpsi_ = vp8.pictureIdRPSI;
+      }
+      has_received_pli_ = has_received_pli_ || vp8.hasReceivedPLI;
+    }
     return;
   }
 #endif
@@ -616,6 +640,10 @@ int32_t ViEEncoder::PacerQueuingDelayMs() const {
   return paced_sender_->QueueInMs();
 }
 
+uint32_t ViEEncoder::FramesDroppedByRateControl() const {
+  return vcm_.FramesDroppedByRateControl();
+}
+
 int ViEEncoder::CodecTargetBitrate(uint32_t* bitrate) const {
   if (vcm_.Bitrate(bitrate) != 0)
     return -1;
@@ -767,6 +795,7 @@ void ViEEncoder::OnReceivedIntraFrameRequest(uint32_t ssrc) {
   TRACE_EVENT0("webrtc", "OnKeyFrameRequest");
 
   int idx = 0;
+  bool replay_key_frame = false;
   {
     CriticalSectionScoped cs(data_cs_.get());
     std::map<unsigned int, int>::iterator stream_it = ssrc_streams_.find(ssrc);
@@ -787,11 +816,36 @@ void ViEEncoder::OnReceivedIntraFrameRequest(uint32_t ssrc) {
     }
     time_last_intra_request_ms_[ssrc] = now;
     idx = stream_it->second;
+    replay_key_frame =
+        key_frame_replay_max_age_ms_ > 0 && ssrc_streams_.size() == 1;
+  }
+  // Resending the last key frame spares the encoder and the other receivers
+  // a new one.
+  if (replay_key_frame &&
+      default_rtp_rtcp_->ResendLastKeyFrame(key_frame_replay_max_age_ms_) >=
+          0) {
+    return;
   }
   // Release the critsect before triggering key frame.
   vcm_.IntraFrameRequest(idx);
 }
 
+void ViEEncoder::OnReceivedPictureLoss(uint32_t ssrc) {
+  {
+    CriticalSectionScoped cs(data_cs_.get());
+    if (picture_loss_recovery_ &&
+        ssrc_streams_.find(ssrc) != ssrc_streams_.end()) {
+      // Let the encoder refresh from an acknowledged reference, it falls back
+      // to a key frame if there is none. This is cheaper than replaying or
+      // encoding a key frame, and not throttled.
+      TRACE_EVENT0("webrtc", "OnPictureLoss");
+      has_received_pli_ = true;
+      return;
+    }
+  }
+  OnReceivedIntraFrameRequest(ssrc);
+}
+
 void ViEEncoder::OnLocalSsrcChanged(uint32_t old_ssrc, uint32_t new_ssrc) {
   CriticalSectionScoped cs(data_cs_.get());
   std::map<unsigned int, int>::iterator it = ssrc_streams_.find(old_ssrc);
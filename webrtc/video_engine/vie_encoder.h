@@ -15,6 +15,7 @@
 #include <map>
 
 #include "webrtc/common_types.h"
+#include "webrtc/common_video/interface/i420_video_frame.h"
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
 #include "webrtc/modules/rtp_rtcp/interface/rtp_rtcp_defines.h"
 #include "webrtc/modules/video_coding/main/interface/video_coding_defines.h"
@@ -111,6 +112,7 @@ class ViEEncoder
                               uint32_t* num_delta_frames);
 
   int PacerQueuingDelayMs() const;
+  uint32_t FramesDroppedByRateControl() const;
 
   int CodecTargetBitrate(uint32_t* bitrate) const;
   // Loss protection.
@@ -146,6 +148,7 @@ class ViEEncoder
 
   // Implements RtcpIntraFrameObserver.
   virtual void OnReceivedIntraFrameRequest(uint32_t ssrc);
+  virtual void OnReceivedPictureLoss(uint32_t ssrc);
   virtual void OnReceivedSLI(uint32_t ssrc, uint8_t picture_id);
   virtual void OnReceivedRPSI(uint32_t ssrc, uint64_t picture_id);
   virtual void OnLocalSsrcChanged(uint32_t old_ssrc, uint32_t new_ssrc);
@@ -221,12 +224,22 @@ class ViEEncoder
 
   ViEEncoderObserver* codec_observer_ GUARDED_BY(callback_cs_);
   ViEEffectFilter* effect_filter_ GUARDED_BY(callback_cs_);
+  // The output of an effect filter changing the frame size.
+  I420VideoFrame effect_output_frame_ GUARDED_BY(callback_cs_);
   ProcessThread& module_process_thread_;
 
   bool has_received_sli_ GUARDED_BY(data_cs_);
   uint8_t picture_id_sli_ GUARDED_BY(data_cs_);
   bool has_received_rpsi_ GUARDED_BY(data_cs_);
   uint64_t picture_id_rpsi_ GUARDED_BY(data_cs_);
+  // True if the VP8 encoder is in feedback mode, in which case picture losses
+  // are passed on to the encoder, which can recover from them without a key
+  // frame.
+  bool picture_loss_recovery_ GUARDED_BY(data_cs_);
+  bool has_received_pli_ GUARDED_BY(data_cs_);
+  // Oldest key frame resent instead of encoding a new one, zero if key frames
+  // aren't resent.
+  const int key_frame_replay_max_age_ms_;
   std::map<unsigned int, int> ssrc_streams_ GUARDED_BY(data_cs_);
 
   // Quality modes callback
@@ -64,7 +64,8 @@ void ViEFrameProviderBase::DeliverFrame(
         if (video_frame->native_handle() != NULL) {
           (*it)->DeliverFrame(id_, video_frame, num_csrcs, CSRC);
         } else {
-          // Make a copy of the frame for all callbacks.
+          // Make a copy of the frame for all callbacks. The copy shares the
+          // pixel data, which is only copied if a callback modifies it.
           if (!extra_frame_.get()) {
             extra_frame_.reset(new I420VideoFrame());
           }
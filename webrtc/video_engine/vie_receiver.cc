@@ -24,12 +24,36 @@
 #include "webrtc/modules/video_coding/main/interface/video_coding.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
 #include "webrtc/system_wrappers/interface/tick_util.h"
 #include "webrtc/system_wrappers/interface/timestamp_extrapolator.h"
 #include "webrtc/system_wrappers/interface/trace.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
 
 namespace webrtc {
 
+// Bounds the memory of the packet pool. A burst of RED packets larger than this
+// is only reached if the FEC queue falls far behind, and is partly dropped.
+static const int kMaxPooledPackets = 128;
+
+// Handles a RED packet on the FEC task queue. A task that is dropped, when the
+// queue is stopped, only returns its packet to the pool.
+class ViEReceiver::RedPacketTask : public QueuedTask {
+ public:
+  RedPacketTask(ViEReceiver* receiver, PooledPacket* packet)
+      : receiver_(receiver), packet_(packet) {}
+  virtual ~RedPacketTask() { receiver_->ReleasePacket(packet_); }
+
+  virtual void Run() OVERRIDE {
+    receiver_->ProcessRedPacket(packet_->header, packet_->packet,
+                                packet_->packet_length);
+  }
+
+ private:
+  ViEReceiver* const receiver_;
+  PooledPacket* const packet_;
+};
+
 ViEReceiver::ViEReceiver(const int32_t channel_id,
                          VideoCodingModule* module_vcm,
                          RemoteBitrateEstimator* remote_bitrate_estimator,
@@ -50,17 +74,24 @@ ViEReceiver::ViEReceiver(const int32_t channel_id,
       ntp_estimator_(new RemoteNtpTimeEstimator(Clock::GetRealTimeClock())),
       rtp_dump_(NULL),
       receiving_(false),
-      restored_packet_in_use_(false),
-      receiving_ast_enabled_(false) {
+      receiving_ast_enabled_(false),
+      decode_wake_up_(NULL),
+      fec_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      fec_recovery_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      fec_pool_(NULL),
+      num_pooled_packets_(0) {
   assert(remote_bitrate_estimator);
 }
 
 ViEReceiver::~ViEReceiver() {
+  StopReceive();
   if (rtp_dump_) {
     rtp_dump_->Stop();
     RtpDump::DestroyRtpDump(rtp_dump_);
     rtp_dump_ = NULL;
   }
+  for (size_t i = 0; i < free_packets_.size(); ++i)
+    delete free_packets_[i];
 }
 
 bool ViEReceiver::SetReceiveCodec(const VideoCodec& video_codec) {
@@ -183,6 +214,10 @@ int32_t ViEReceiver::OnReceivedPayloadData(
     // Check this...
     return -1;
   }
+  CriticalSectionScoped cs(receive_cs_.get());
+  if (decode_wake_up_) {
+    decode_wake_up_->Set();
+  }
   return 0;
 }
 
@@ -210,6 +245,8 @@ void ViEReceiver::ReceivedBWEPacket(
 int ViEReceiver::InsertRTPPacket(const uint8_t* rtp_packet,
                                  int rtp_packet_length,
                                  const PacketTime& packet_time) {
+  TRACE_EVENT1("webrtc_rtp", "ViEReceiver::InsertRTPPacket",
+               "length", rtp_packet_length);
   {
     CriticalSectionScoped cs(receive_cs_.get());
     if (!receiving_) {
@@ -235,9 +272,16 @@ int ViEReceiver::InsertRTPPacket(const uint8_t* rtp_packet,
 
   remote_bitrate_estimator_->IncomingPacket(arrival_time_ms,
                                             payload_length, header);
+  if (header.extension.hasTransportSequenceNumber && rtp_rtcp_) {
+    rtp_rtcp_->IncomingTransportSequenceNumber(
+        header.extension.transportSequenceNumber, arrival_time_ms);
+  }
   header.payload_type_frequency = kVideoPayloadTypeFrequency;
 
-  bool in_order = IsPacketInOrder(header);
+  // Look up the stream's statistician once for the whole packet.
+  StreamStatistician* statistician =
+      rtp_receive_statistics_->GetStatistician(header.ssrc);
+  bool in_order = IsPacketInOrder(statistician, header);
   rtp_payload_registry_->SetIncomingPayloadType(header);
   int ret = ReceivePacket(rtp_packet, rtp_packet_length, header, in_order)
       ? 0
@@ -245,8 +289,13 @@ int ViEReceiver::InsertRTPPacket(const uint8_t* rtp_packet,
   // Update receive statistics after ReceivePacket.
   // Receive statistics will be reset if the payload type changes (make sure
   // that the first packet is included in the stats).
-  rtp_receive_statistics_->IncomingPacket(
-      header, rtp_packet_length, IsPacketRetransmitted(header, in_order));
+  bool retransmitted = IsPacketRetransmitted(statistician, header, in_order);
+  if (!statistician) {
+    statistician =
+        rtp_receive_statistics_->GetOrCreateStatistician(header.ssrc);
+  }
+  rtp_receive_statistics_->IncomingPacket(statistician, header,
+                                          rtp_packet_length, retransmitted);
   return ret;
 }
 
@@ -273,45 +322,117 @@ bool ViEReceiver::ParseAndHandleEncapsulatingHeader(const uint8_t* packet,
                                                     int packet_length,
                                                     const RTPHeader& header) {
   if (rtp_payload_registry_->IsRed(header)) {
-    int8_t ulpfec_pt = rtp_payload_registry_->ulpfec_payload_type();
-    if (packet[header.headerLength] == ulpfec_pt)
-      rtp_receive_statistics_->FecPacketReceived(header.ssrc);
-    if (fec_receiver_->AddReceivedRedPacket(
-            header, packet, packet_length, ulpfec_pt) != 0) {
+    if (!IsFecQueueRunning())
+      return ProcessRedPacket(header, packet, packet_length);
+    if (packet_length > kViEMaxMtu)
+      return false;
+    PooledPacket* red_packet = AcquirePacket();
+    if (!red_packet) {
+      LOG(LS_WARNING) << "FEC queue is behind, dropping RED packet.";
       return false;
     }
-    return fec_receiver_->ProcessReceivedFec() == 0;
+    memcpy(red_packet->buffer, packet, packet_length);
+    red_packet->header = header;
+    red_packet->packet = red_packet->buffer;
+    red_packet->packet_length = packet_length;
+    QueueRedPacket(red_packet);
+    return true;
   } else if (rtp_payload_registry_->IsRtx(header)) {
     if (header.headerLength + header.paddingLength == packet_length) {
       // This is an empty packet and should be silently dropped before trying to
       // parse the RTX header.
       return true;
     }
-    // Remove the RTX header and parse the original RTP header.
+    // Remove the RTX header and restore the original RTP header.
     if (packet_length < header.headerLength)
       return false;
-    if (packet_length > static_cast<int>(sizeof(restored_packet_)))
+    if (packet_length > kViEMaxMtu)
       return false;
-    CriticalSectionScoped cs(receive_cs_.get());
-    if (restored_packet_in_use_) {
-      LOG(LS_WARNING) << "Multiple RTX headers detected, dropping packet.";
+    PooledPacket* restored = AcquirePacket();
+    if (!restored) {
+      LOG(LS_WARNING) << "FEC queue is behind, dropping RTX packet.";
       return false;
     }
-    uint8_t* restored_packet_ptr = restored_packet_;
-    if (!rtp_payload_registry_->RestoreOriginalPacket(
-        &restored_packet_ptr, packet, &packet_length, rtp_receiver_->SSRC(),
-        header)) {
+    memcpy(restored->buffer, packet, packet_length);
+    restored->packet = restored->buffer;
+    restored->packet_length = packet_length;
+    if (!rtp_payload_registry_->RestoreOriginalPacketInPlace(
+        &restored->packet, &restored->packet_length, rtp_receiver_->SSRC(),
+        header, &restored->header)) {
       LOG(LS_WARNING) << "Incoming RTX packet: Invalid RTP header";
+      ReleasePacket(restored);
       return false;
     }
-    restored_packet_in_use_ = true;
-    bool ret = OnRecoveredPacket(restored_packet_ptr, packet_length);
-    restored_packet_in_use_ = false;
+    restored->header.payload_type_frequency = kVideoPayloadTypeFrequency;
+    if (rtp_payload_registry_->IsRtx(restored->header)) {
+      LOG(LS_WARNING) << "Multiple RTX headers detected, dropping packet.";
+      ReleasePacket(restored);
+      return false;
+    }
+    if (rtp_payload_registry_->IsRed(restored->header)) {
+      // The restored packet is already in a pooled buffer, queue it as is.
+      QueueRedPacket(restored);
+      return true;
+    }
+    bool ret = ReceivePacket(restored->packet, restored->packet_length,
+                             restored->header, false);
+    ReleasePacket(restored);
     return ret;
   }
   return false;
 }
 
+ViEReceiver::PooledPacket* ViEReceiver::AcquirePacket() {
+  CriticalSectionScoped cs(fec_cs_.get());
+  if (!free_packets_.empty()) {
+    PooledPacket* packet = free_packets_.back();
+    free_packets_.pop_back();
+    return packet;
+  }
+  if (num_pooled_packets_ >= kMaxPooledPackets)
+    return NULL;
+  ++num_pooled_packets_;
+  return new PooledPacket;
+}
+
+void ViEReceiver::ReleasePacket(PooledPacket* packet) {
+  CriticalSectionScoped cs(fec_cs_.get());
+  free_packets_.push_back(packet);
+}
+
+bool ViEReceiver::IsFecQueueRunning() const {
+  CriticalSectionScoped cs(fec_cs_.get());
+  return fec_queue_.get() != NULL;
+}
+
+void ViEReceiver::QueueRedPacket(PooledPacket* packet) {
+  {
+    CriticalSectionScoped cs(fec_cs_.get());
+    if (fec_queue_) {
+      fec_queue_->PostTask(new RedPacketTask(this, packet));
+      return;
+    }
+  }
+  ProcessRedPacket(packet->header, packet->packet, packet->packet_length);
+  ReleasePacket(packet);
+}
+
+bool ViEReceiver::ProcessRedPacket(const RTPHeader& header,
+                                   const uint8_t* packet,
+                                   int packet_length) {
+  int8_t ulpfec_pt = rtp_payload_registry_->ulpfec_payload_type();
+  if (packet[header.headerLength] == ulpfec_pt)
+    rtp_receive_statistics_->FecPacketReceived(header.ssrc);
+  // Recovered and unwrapped media packets are delivered through
+  // OnRecoveredPacket, so on this thread.
+  CriticalSectionScoped cs(fec_recovery_cs_.get());
+  if (fec_receiver_->AddReceivedRedPacket(
+          header, packet, packet_length, ulpfec_pt) != 0) {
+    return false;
+  }
+  return fec_receiver_->ProcessReceivedFec() == 0;
+}
+
 int ViEReceiver::InsertRTCPPacket(const uint8_t* rtcp_packet,
                                   int rtcp_packet_length) {
   {
@@ -342,14 +463,39 @@ int ViEReceiver::InsertRTCPPacket(const uint8_t* rtcp_packet,
   return 0;
 }
 
+void ViEReceiver::SetFecThreadPool(ThreadPool* fec_pool) {
+  CriticalSectionScoped cs(fec_cs_.get());
+  assert(!fec_queue_);
+  fec_pool_ = fec_pool;
+}
+
 void ViEReceiver::StartReceive() {
+  {
+    CriticalSectionScoped cs(fec_cs_.get());
+    if (fec_pool_ && !fec_queue_)
+      fec_queue_.reset(new TaskQueue(fec_pool_));
+  }
   CriticalSectionScoped cs(receive_cs_.get());
   receiving_ = true;
 }
 
 void ViEReceiver::StopReceive() {
+  {
+    CriticalSectionScoped cs(receive_cs_.get());
+    receiving_ = false;
+  }
+  // Deleted without holding |fec_cs_| or |receive_cs_|, which the running task
+  // may need. The tasks that haven't run return their packets to the pool.
+  scoped_ptr<TaskQueue> fec_queue;
+  {
+    CriticalSectionScoped cs(fec_cs_.get());
+    fec_queue.reset(fec_queue_.release());
+  }
+}
+
+void ViEReceiver::SetDecodeWakeUp(ViEDecodePool::WakeUp* decode_wake_up) {
   CriticalSectionScoped cs(receive_cs_.get());
-  receiving_ = false;
+  decode_wake_up_ = decode_wake_up;
 }
 
 int ViEReceiver::StartRTPDump(const char file_nameUTF8[1024]) {
@@ -394,21 +540,20 @@ ReceiveStatistics* ViEReceiver::GetReceiveStatistics() const {
   return rtp_receive_statistics_.get();
 }
 
-bool ViEReceiver::IsPacketInOrder(const RTPHeader& header) const {
-  StreamStatistician* statistician =
-      rtp_receive_statistics_->GetStatistician(header.ssrc);
+bool ViEReceiver::IsPacketInOrder(const StreamStatistician* statistician,
+                                  const RTPHeader& header) const {
   if (!statistician)
     return false;
   return statistician->IsPacketInOrder(header.sequenceNumber);
 }
 
-bool ViEReceiver::IsPacketRetransmitted(const RTPHeader& header,
-                                        bool in_order) const {
+bool ViEReceiver::IsPacketRetransmitted(
+    const StreamStatistician* statistician,
+    const RTPHeader& header,
+    bool in_order) const {
   // Retransmissions are handled separately if RTX is enabled.
   if (rtp_payload_registry_->RtxEnabled())
     return false;
-  StreamStatistician* statistician =
-      rtp_receive_statistics_->GetStatistician(header.ssrc);
   if (!statistician)
     return false;
   // Check if this is a retransmission.
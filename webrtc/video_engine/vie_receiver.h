@@ -12,6 +12,7 @@
 #define WEBRTC_VIDEO_ENGINE_VIE_RECEIVER_H_
 
 #include <list>
+#include <vector>
 
 #include "webrtc/engine_configurations.h"
 #include "webrtc/modules/rtp_rtcp/interface/receive_statistics.h"
@@ -19,6 +20,7 @@
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
 #include "webrtc/typedefs.h"
 #include "webrtc/video_engine/include/vie_network.h"
+#include "webrtc/video_engine/vie_decode_pool.h"
 #include "webrtc/video_engine/vie_defines.h"
 
 namespace webrtc {
@@ -33,6 +35,8 @@ class RtpHeaderParser;
 class RTPPayloadRegistry;
 class RtpReceiver;
 class RtpRtcp;
+class TaskQueue;
+class ThreadPool;
 class VideoCodingModule;
 struct ReceiveBandwidthEstimatorStats;
 
@@ -62,9 +66,18 @@ class ViEReceiver : public RtpData {
   bool SetReceiveTimestampOffsetStatus(bool enable, int id);
   bool SetReceiveAbsoluteSendTimeStatus(bool enable, int id);
 
+  // Handles the RED packets, and thereby the FEC recovery, on a TaskQueue of
+  // |fec_pool| while receiving, instead of on the network thread. Must be set
+  // before receiving is started, NULL to handle them on the network thread.
+  void SetFecThreadPool(ThreadPool* fec_pool);
+
   void StartReceive();
   void StopReceive();
 
+  // Sets the wake-up to set when a packet has been inserted into the VCM,
+  // used when the channel is decoded on a ViEDecodePool. NULL to not set any.
+  void SetDecodeWakeUp(ViEDecodePool::WakeUp* decode_wake_up);
+
   int StartRTPDump(const char file_nameUTF8[1024]);
   int StopRTPDump();
 
@@ -89,6 +102,19 @@ class ViEReceiver : public RtpData {
   void ReceivedBWEPacket(int64_t arrival_time_ms, int payload_size,
                          const RTPHeader& header);
  private:
+  class RedPacketTask;
+
+  // A packet buffer from the pool of the receiver. Holds a RED packet while it
+  // waits for the FEC task queue, or an RTX packet while it's restored.
+  struct PooledPacket {
+    RTPHeader header;
+    // Points into |buffer|, where the packet may not start when an RTX packet
+    // has been restored in place.
+    uint8_t* packet;
+    int packet_length;
+    uint8_t buffer[kViEMaxMtu];
+  };
+
   int InsertRTPPacket(const uint8_t* rtp_packet, int rtp_packet_length,
                       const PacketTime& packet_time);
   bool ReceivePacket(const uint8_t* packet,
@@ -96,13 +122,28 @@ class ViEReceiver : public RtpData {
                      const RTPHeader& header,
                      bool in_order);
   // Parses and handles for instance RTX and RED headers.
-  // This function assumes that it's being called from only one thread.
   bool ParseAndHandleEncapsulatingHeader(const uint8_t* packet,
                                          int packet_length,
                                          const RTPHeader& header);
+  // Returns NULL if all buffers of the pool are in use.
+  PooledPacket* AcquirePacket();
+  void ReleasePacket(PooledPacket* packet);
+  // Returns true if RED packets are handled on the FEC task queue.
+  bool IsFecQueueRunning() const;
+  // Hands the RED packet in |packet| over to the FEC task queue, or handles and
+  // releases it right away if the queue has been stopped.
+  void QueueRedPacket(PooledPacket* packet);
+  bool ProcessRedPacket(const RTPHeader& header,
+                        const uint8_t* packet,
+                        int packet_length);
   int InsertRTCPPacket(const uint8_t* rtcp_packet, int rtcp_packet_length);
-  bool IsPacketInOrder(const RTPHeader& header) const;
-  bool IsPacketRetransmitted(const RTPHeader& header, bool in_order) const;
+  // |statistician| is the statistician of the stream of |header|, or NULL if
+  // there is none yet.
+  bool IsPacketInOrder(const StreamStatistician* statistician,
+                       const RTPHeader& header) const;
+  bool IsPacketRetransmitted(const StreamStatistician* statistician,
+                             const RTPHeader& header,
+                             bool in_order) const;
 
   scoped_ptr<CriticalSectionWrapper> receive_cs_;
   scoped_ptr<RtpHeaderParser> rtp_header_parser_;
@@ -119,9 +160,18 @@ class ViEReceiver : public RtpData {
 
   RtpDump* rtp_dump_;
   bool receiving_;
-  uint8_t restored_packet_[kViEMaxMtu];
-  bool restored_packet_in_use_;
   bool receiving_ast_enabled_;
+  ViEDecodePool::WakeUp* decode_wake_up_;
+
+  // Protects the packet pool and |fec_queue_|.
+  scoped_ptr<CriticalSectionWrapper> fec_cs_;
+  // Held while |fec_receiver_| is used, which happens on the network thread
+  // when a packet comes in as the queue is stopped.
+  scoped_ptr<CriticalSectionWrapper> fec_recovery_cs_;
+  ThreadPool* fec_pool_;
+  scoped_ptr<TaskQueue> fec_queue_;
+  std::vector<PooledPacket*> free_packets_;
+  int num_pooled_packets_;
 };
 
 }  // namespace webrt
@@ -13,6 +13,7 @@
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_render/include/video_render.h"
 #include "webrtc/modules/video_render/include/video_render_defines.h"
+#include "webrtc/system_wrappers/interface/trace_event.h"
 #include "webrtc/video_engine/vie_render_manager.h"
 
 namespace webrtc {
@@ -139,6 +140,8 @@ void ViERenderer::DeliverFrame(int id,
                                I420VideoFrame* video_frame,
                                int num_csrcs,
                                const uint32_t CSRC[kRtpCsrcSize]) {
+  TRACE_EVENT1("webrtc", "ViERenderer::DeliverFrame",
+               "timestamp", video_frame->timestamp());
   render_callback_->RenderFrame(render_id_, *video_frame);
 }
 
@@ -190,6 +193,14 @@ int32_t ViEExternalRendererImpl::RenderFrame(
     return 0;
   }
 
+  NotifyFrameSizeChange(stream_id, video_frame);
+
+  // Renderers which take the planes as they are don't need a copy.
+  if (external_renderer_format_ == kVideoI420 &&
+      external_renderer_->DeliverI420Frame(video_frame) >= 0) {
+    return 0;
+  }
+
   VideoFrame* out_frame = converted_frame_.get();
 
   // Convert to requested format.
@@ -239,8 +250,6 @@ int32_t ViEExternalRendererImpl::RenderFrame(
       break;
   }
 
-  NotifyFrameSizeChange(stream_id, video_frame);
-
   if (out_frame) {
     external_renderer_->DeliverFrame(out_frame->Buffer(),
                                      out_frame->Length(),
@@ -496,6 +496,23 @@ int ViERTP_RTCPImpl::SetSenderBufferingMode(int video_channel,
   return 0;
 }
 
+int ViERTP_RTCPImpl::SetSendSideHistorySize(int video_channel,
+                                            int num_packets) {
+  LOG_F(LS_INFO) << "channel: " << video_channel
+                 << " num_packets: " << num_packets;
+  ViEChannelManagerScoped cs(*(shared_data_->channel_manager()));
+  ViEChannel* vie_channel = cs.Channel(video_channel);
+  if (!vie_channel) {
+    shared_data_->SetLastError(kViERtpRtcpInvalidChannelId);
+    return -1;
+  }
+  if (vie_channel->SetSendSideHistorySize(num_packets) != 0) {
+    shared_data_->SetLastError(kViERtpRtcpUnknownError);
+    return -1;
+  }
+  return 0;
+}
+
 int ViERTP_RTCPImpl::SetReceiverBufferingMode(int video_channel,
                                               int target_delay_ms) {
   LOG_F(LS_INFO) << "channel: " << video_channel
@@ -74,6 +74,7 @@ class ViERTP_RTCPImpl
                                      const unsigned char payload_typeFEC);
   virtual int SetSenderBufferingMode(int video_channel,
                                      int target_delay_ms);
+  virtual int SetSendSideHistorySize(int video_channel, int num_packets);
   virtual int SetReceiverBufferingMode(int video_channel,
                                        int target_delay_ms);
   virtual int SetKeyFrameRequestMethod(const int video_channel,
@@ -8,8 +8,12 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "webrtc/common.h"
+#include "webrtc/experiments.h"
 #include "webrtc/modules/utility/interface/process_thread.h"
 #include "webrtc/system_wrappers/interface/cpu_info.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/interface/logging.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 #include "webrtc/video_engine/vie_channel_manager.h"
 #include "webrtc/video_engine/vie_defines.h"
@@ -24,12 +28,15 @@ ViESharedData::ViESharedData(const Config& config)
       channel_manager_(new ViEChannelManager(0, number_cores_, config)),
       input_manager_(new ViEInputManager(0, config)),
       render_manager_(new ViERenderManager(0)),
-      module_process_thread_(ProcessThread::CreateProcessThread()),
+      module_process_thread_(ProcessThread::CreateProcessThread(
+          config.Get<ProcessThreadWorkers>().num_workers, kPacerThreadRole)),
+      module_process_thread_crit_(
+          CriticalSectionWrapper::CreateCriticalSection()),
+      module_process_thread_started_(false),
       last_error_(0) {
   Trace::CreateTrace();
   channel_manager_->SetModuleProcessThread(module_process_thread_);
   input_manager_->SetModuleProcessThread(module_process_thread_);
-  module_process_thread_->Start();
 }
 
 ViESharedData::~ViESharedData() {
@@ -53,6 +60,17 @@ int ViESharedData::LastErrorInternal() const {
   return error;
 }
 
+void ViESharedData::StartModuleProcessThread() {
+  CriticalSectionScoped cs(module_process_thread_crit_.get());
+  if (module_process_thread_started_)
+    return;
+  if (module_process_thread_->Start() != 0) {
+    LOG_F(LS_ERROR) << "Could not start the module process thread.";
+    return;
+  }
+  module_process_thread_started_ = true;
+}
+
 int ViESharedData::NumberOfCores() const {
   return number_cores_;
 }
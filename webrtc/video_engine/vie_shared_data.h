@@ -22,6 +22,7 @@ namespace webrtc {
 
 class Config;
 class CpuOveruseObserver;
+class CriticalSectionWrapper;
 class ProcessThread;
 class ViEChannelManager;
 class ViEInputManager;
@@ -36,6 +37,11 @@ class ViESharedData {
   int LastErrorInternal() const;
   int NumberOfCores() const;
 
+  // Starts the module process thread unless it runs already. It is started
+  // with the first channel or capture device rather than with the engine, so
+  // that an engine which is never used for video runs no thread.
+  void StartModuleProcessThread();
+
   // TODO(mflodman) Remove all calls to 'instance_id()'.
   int instance_id() { return 0;}
   ViEChannelManager* channel_manager() { return channel_manager_.get(); }
@@ -52,6 +58,8 @@ class ViESharedData {
   scoped_ptr<ViEInputManager> input_manager_;
   scoped_ptr<ViERenderManager> render_manager_;
   ProcessThread* module_process_thread_;
+  scoped_ptr<CriticalSectionWrapper> module_process_thread_crit_;
+  bool module_process_thread_started_;
   mutable int last_error_;
 
   std::map<int, CpuOveruseObserver*> overuse_observers_;
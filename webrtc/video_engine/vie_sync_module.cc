@@ -24,8 +24,11 @@ namespace webrtc {
 
 enum { kSyncInterval = 1000};
 
+// Updates |stream| with the latest received RTP timestamp and RTCP SR.
+// |new_rtcp_sr| is set to true if the SR wasn't already in the RTCP list.
 int UpdateMeasurements(StreamSynchronization::Measurements* stream,
-                       const RtpRtcp& rtp_rtcp, const RtpReceiver& receiver) {
+                       const RtpRtcp& rtp_rtcp, const RtpReceiver& receiver,
+                       bool* new_rtcp_sr) {
   if (!receiver.Timestamp(&stream->latest_timestamp))
     return -1;
   if (!receiver.LastReceivedTimeMs(&stream->latest_receive_time_ms))
@@ -42,9 +45,8 @@ int UpdateMeasurements(StreamSynchronization::Measurements* stream,
     return -1;
   }
 
-  bool new_rtcp_sr = false;
   if (!UpdateRtcpList(
-      ntp_secs, ntp_frac, rtp_timestamp, &stream->rtcp, &new_rtcp_sr)) {
+      ntp_secs, ntp_frac, rtp_timestamp, &stream->rtcp, new_rtcp_sr)) {
     return -1;
   }
 
@@ -61,7 +63,10 @@ ViESyncModule::ViESyncModule(VideoCodingModule* vcm,
       voe_channel_id_(-1),
       voe_sync_interface_(NULL),
       last_sync_time_(TickTime::Now()),
-      sync_() {
+      sync_(),
+      delays_in_sync_(false),
+      last_audio_delay_ms_(0),
+      last_video_delay_ms_(0) {
 }
 
 ViESyncModule::~ViESyncModule() {
@@ -77,6 +82,7 @@ int ViESyncModule::ConfigureSync(int voe_channel_id,
   video_receiver_ = video_receiver;
   video_rtp_rtcp_ = video_rtcp_module;
   sync_.reset(new StreamSynchronization(voe_channel_id, vie_channel_->Id()));
+  delays_in_sync_ = false;
 
   if (!voe_sync_interface) {
     voe_channel_id_ = -1;
@@ -102,14 +108,14 @@ int32_t ViESyncModule::Process() {
   CriticalSectionScoped cs(data_cs_.get());
   last_sync_time_ = TickTime::Now();
 
-  const int current_video_delay_ms = vcm_->Delay();
-
   if (voe_channel_id_ == -1) {
     return 0;
   }
   assert(video_rtp_rtcp_ && voe_sync_interface_);
   assert(sync_.get());
 
+  const int current_video_delay_ms = vcm_->Delay();
+
   int audio_jitter_buffer_delay_ms = 0;
   int playout_buffer_delay_ms = 0;
   if (voe_sync_interface_->GetDelayEstimate(voe_channel_id_,
@@ -129,16 +135,28 @@ int32_t ViESyncModule::Process() {
   assert(voice_rtp_rtcp);
   assert(voice_receiver);
 
+  bool new_video_rtcp_sr = false;
   if (UpdateMeasurements(&video_measurement_, *video_rtp_rtcp_,
-                         *video_receiver_) != 0) {
+                         *video_receiver_, &new_video_rtcp_sr) != 0) {
     return 0;
   }
 
+  bool new_audio_rtcp_sr = false;
   if (UpdateMeasurements(&audio_measurement_, *voice_rtp_rtcp,
-                         *voice_receiver) != 0) {
+                         *voice_receiver, &new_audio_rtcp_sr) != 0) {
     return 0;
   }
 
+  // The RTP to NTP mapping only moves with a new RTCP SR. Without one, and
+  // with both playout delays where the last update left them, the targets
+  // already set are still valid.
+  if (delays_in_sync_ && !new_video_rtcp_sr && !new_audio_rtcp_sr &&
+      current_audio_delay_ms == last_audio_delay_ms_ &&
+      current_video_delay_ms == last_video_delay_ms_) {
+    return 0;
+  }
+  delays_in_sync_ = false;
+
   int relative_delay_ms;
   // Calculate how much later or earlier the audio stream is compared to video.
   if (!sync_->ComputeRelativeDelay(audio_measurement_, video_measurement_,
@@ -165,6 +183,10 @@ int32_t ViESyncModule::Process() {
     LOG(LS_ERROR) << "Error setting voice delay.";
   }
   vcm_->SetMinimumPlayoutDelay(target_video_delay_ms);
+
+  delays_in_sync_ = true;
+  last_audio_delay_ms_ = current_audio_delay_ms;
+  last_video_delay_ms_ = current_video_delay_ms;
   return 0;
 }
 
@@ -175,6 +197,7 @@ int ViESyncModule::SetTargetBufferingDelay(int target_delay_ms) {
     return -1;
   }
   sync_->SetTargetBufferingDelay(target_delay_ms);
+  delays_in_sync_ = false;
   // Setting initial playout delay to voice engine (video engine is updated via
   // the VCM interface).
   voe_sync_interface_->SetInitialPlayoutDelay(voe_channel_id_,
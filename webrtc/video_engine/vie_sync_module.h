@@ -60,6 +60,11 @@ class ViESyncModule : public Module {
   scoped_ptr<StreamSynchronization> sync_;
   StreamSynchronization::Measurements audio_measurement_;
   StreamSynchronization::Measurements video_measurement_;
+  // True while the targets set by the last Process() still apply, i.e. no new
+  // RTCP SR has been received and the current delays are unchanged.
+  bool delays_in_sync_;
+  int last_audio_delay_ms_;
+  int last_video_delay_ms_;
 };
 
 }  // namespace webrtc
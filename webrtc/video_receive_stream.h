@@ -62,7 +62,14 @@ class VideoReceiveStream {
           render_frame_rate(0),
           avg_delay_ms(0),
           discarded_packets(0),
-          ssrc(0) {}
+          ssrc(0),
+          decode_ms(0),
+          max_decode_ms(0),
+          current_delay_ms(0),
+          target_delay_ms(0),
+          jitter_buffer_ms(0),
+          min_playout_delay_ms(0),
+          render_delay_ms(0) {}
 
     int network_frame_rate;
     int decode_frame_rate;
@@ -71,6 +78,22 @@ class VideoReceiveStream {
     uint32_t discarded_packets;
     uint32_t ssrc;
     std::string c_name;
+
+    // The latest receive-side delays of the frame timing, in ms: the
+    // expected decode time, the jitter buffer delay and the render delay make
+    // up the target delay, which the current delay converges to.
+    int decode_ms;
+    int max_decode_ms;
+    int current_delay_ms;
+    int target_delay_ms;
+    int jitter_buffer_ms;
+    int min_playout_delay_ms;
+    int render_delay_ms;
+
+    // Delay from capture on the sender to render here, for each frame
+    // rendered after the capture time could be estimated from RTCP sender
+    // reports.
+    DelayHistogram capture_to_render_delay_ms;
   };
 
   struct Config {
@@ -175,6 +198,12 @@ class VideoReceiveStream {
   virtual void Stop() = 0;
   virtual Stats GetStats() const = 0;
 
+  // Like GetStats(), but only fills in |stats| if the stats have changed since
+  // the call that returned |*stats_version|, and returns false otherwise. Pass
+  // 0 the first time. Lets callers polling many streams skip the idle ones.
+  virtual bool GetStatsIfChanged(uint32_t* stats_version,
+                                 Stats* stats) const = 0;
+
   // TODO(mflodman) Replace this with callback.
   virtual void GetCurrentReceiveCodec(VideoCodec* receive_codec) = 0;
 
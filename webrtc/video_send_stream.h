@@ -41,10 +41,21 @@ class VideoSendStream {
     Stats()
         : input_frame_rate(0),
           encode_frame_rate(0),
-          suspended(false) {}
+          suspended(false),
+          avg_encode_time_ms(-1),
+          encode_usage_percent(-1),
+          capture_queue_delay_ms_per_s(-1),
+          frames_dropped_by_rate_control(0) {}
     int input_frame_rate;
     int encode_frame_rate;
     bool suspended;
+    // Encoder load, -1 until measured. The capture-to-send delay of each
+    // substream is in |substreams|.
+    int avg_encode_time_ms;
+    int encode_usage_percent;
+    int capture_queue_delay_ms_per_s;
+    // Frames dropped by the encoder rate control to keep to the target rate.
+    uint32_t frames_dropped_by_rate_control;
     std::map<uint32_t, StreamStats> substreams;
   };
 
@@ -158,6 +169,12 @@ class VideoSendStream {
 
   virtual Stats GetStats() const = 0;
 
+  // Like GetStats(), but only fills in |stats| if the stats have changed since
+  // the call that returned |*stats_version|, and returns false otherwise. Pass
+  // 0 the first time. Lets callers polling many streams skip the idle ones.
+  virtual bool GetStatsIfChanged(uint32_t* stats_version,
+                                 Stats* stats) const = 0;
+
  protected:
   virtual ~VideoSendStream() {}
 };
@@ -957,10 +957,6 @@ Channel::Channel(int32_t channelId,
     statistics_proxy_.reset(new StatisticsProxy(_rtpRtcpModule->SSRC()));
     rtp_receive_statistics_->RegisterRtcpStatisticsCallback(
         statistics_proxy_.get());
-
-    Config audioproc_config;
-    audioproc_config.Set<ExperimentalAgc>(new ExperimentalAgc(false));
-    rx_audioproc_.reset(AudioProcessing::Create(audioproc_config));
 }
 
 Channel::~Channel()
@@ -1204,16 +1200,37 @@ Channel::Init()
 #endif
     }
 
-    if (rx_audioproc_->noise_suppression()->set_level(kDefaultNsMode) != 0) {
+    return 0;
+}
+
+AudioProcessing* Channel::RxAudioProcessing()
+{
+    if (rx_audioproc_.get())
+    {
+        return rx_audioproc_.get();
+    }
+
+    Config audioproc_config;
+    audioproc_config.Set<ExperimentalAgc>(new ExperimentalAgc(false));
+    scoped_ptr<AudioProcessing> audioproc(
+        AudioProcessing::Create(audioproc_config));
+    if (!audioproc.get())
+    {
+        _engineStatisticsPtr->SetLastError(
+            VE_NO_MEMORY, kTraceError,
+            "RxAudioProcessing() failed to create the far end APM");
+        return NULL;
+    }
+    if (audioproc->noise_suppression()->set_level(kDefaultNsMode) != 0) {
       LOG_FERR1(LS_ERROR, noise_suppression()->set_level, kDefaultNsMode);
-      return -1;
+      return NULL;
     }
-    if (rx_audioproc_->gain_control()->set_mode(kDefaultRxAgcMode) != 0) {
+    if (audioproc->gain_control()->set_mode(kDefaultRxAgcMode) != 0) {
       LOG_FERR1(LS_ERROR, gain_control()->set_mode, kDefaultRxAgcMode);
-      return -1;
+      return NULL;
     }
-
-    return 0;
+    rx_audioproc_.reset(audioproc.release());
+    return rx_audioproc_.get();
 }
 
 int32_t
@@ -1817,9 +1834,17 @@ int32_t Channel::ReceivedRTPPacket(const int8_t* data, int32_t length,
       rtp_payload_registry_->GetPayloadTypeFrequency(header.payloadType);
   if (header.payload_type_frequency < 0)
     return -1;
-  bool in_order = IsPacketInOrder(header);
-  rtp_receive_statistics_->IncomingPacket(header, length,
-      IsPacketRetransmitted(header, in_order));
+  // Look up the stream's statistician once for the whole packet.
+  StreamStatistician* statistician =
+      rtp_receive_statistics_->GetStatistician(header.ssrc);
+  bool in_order = IsPacketInOrder(statistician, header);
+  bool retransmitted = IsPacketRetransmitted(statistician, header, in_order);
+  if (!statistician) {
+    statistician =
+        rtp_receive_statistics_->GetOrCreateStatistician(header.ssrc);
+  }
+  rtp_receive_statistics_->IncomingPacket(statistician, header, length,
+                                          retransmitted);
   rtp_payload_registry_->SetIncomingPayloadType(header);
 
   // Forward any packets to ViE bandwidth estimator, if enabled.
@@ -1866,7 +1891,7 @@ bool Channel::HandleEncapsulation(const uint8_t* packet,
   if (!rtp_payload_registry_->IsRtx(header))
     return false;
 
-  // Remove the RTX header and parse the original RTP header.
+  // Remove the RTX header and restore the original RTP header.
   if (packet_length < header.headerLength)
     return false;
   if (packet_length > kVoiceEngineMaxIpPacketSizeBytes)
@@ -1877,34 +1902,39 @@ bool Channel::HandleEncapsulation(const uint8_t* packet,
     return false;
   }
   uint8_t* restored_packet_ptr = restored_packet_;
+  RTPHeader restored_header;
   if (!rtp_payload_registry_->RestoreOriginalPacket(
       &restored_packet_ptr, packet, &packet_length, rtp_receiver_->SSRC(),
-      header)) {
+      header, &restored_header)) {
     WEBRTC_TRACE(webrtc::kTraceDebug, webrtc::kTraceVoice, _channelId,
                  "Incoming RTX packet: invalid RTP header");
     return false;
   }
+  restored_header.payload_type_frequency =
+      rtp_payload_registry_->GetPayloadTypeFrequency(
+          restored_header.payloadType);
+  if (restored_header.payload_type_frequency < 0)
+    return false;
   restored_packet_in_use_ = true;
-  bool ret = OnRecoveredPacket(restored_packet_ptr, packet_length);
+  bool ret = ReceivePacket(restored_packet_ptr, packet_length,
+                           restored_header, false);
   restored_packet_in_use_ = false;
   return ret;
 }
 
-bool Channel::IsPacketInOrder(const RTPHeader& header) const {
-  StreamStatistician* statistician =
-      rtp_receive_statistics_->GetStatistician(header.ssrc);
+bool Channel::IsPacketInOrder(const StreamStatistician* statistician,
+                              const RTPHeader& header) const {
   if (!statistician)
     return false;
   return statistician->IsPacketInOrder(header.sequenceNumber);
 }
 
-bool Channel::IsPacketRetransmitted(const RTPHeader& header,
+bool Channel::IsPacketRetransmitted(const StreamStatistician* statistician,
+                                    const RTPHeader& header,
                                     bool in_order) const {
   // Retransmissions are handled separately if RTX is enabled.
   if (rtp_payload_registry_->RtxEnabled())
     return false;
-  StreamStatistician* statistician =
-      rtp_receive_statistics_->GetStatistician(header.ssrc);
   if (!statistician)
     return false;
   // Check if this is a retransmission.
@@ -2806,13 +2836,19 @@ Channel::SetRxAgcStatus(bool enable, AgcModes mode)
                  "Channel::SetRxAgcStatus(enable=%d, mode=%d)",
                  (int)enable, (int)mode);
 
+    AudioProcessing* rx_audioproc = RxAudioProcessing();
+    if (!rx_audioproc)
+    {
+        return -1;
+    }
+
     GainControl::Mode agcMode = kDefaultRxAgcMode;
     switch (mode)
     {
         case kAgcDefault:
             break;
         case kAgcUnchanged:
-            agcMode = rx_audioproc_->gain_control()->mode();
+            agcMode = rx_audioproc->gain_control()->mode();
             break;
         case kAgcFixedDigital:
             agcMode = GainControl::kFixedDigital;
@@ -2827,14 +2863,14 @@ Channel::SetRxAgcStatus(bool enable, AgcModes mode)
             return -1;
     }
 
-    if (rx_audioproc_->gain_control()->set_mode(agcMode) != 0)
+    if (rx_audioproc->gain_control()->set_mode(agcMode) != 0)
     {
         _engineStatisticsPtr->SetLastError(
             VE_APM_ERROR, kTraceError,
             "SetRxAgcStatus() failed to set Agc mode");
         return -1;
     }
-    if (rx_audioproc_->gain_control()->Enable(enable) != 0)
+    if (rx_audioproc->gain_control()->Enable(enable) != 0)
     {
         _engineStatisticsPtr->SetLastError(
             VE_APM_ERROR, kTraceError,
@@ -2854,9 +2890,15 @@ Channel::GetRxAgcStatus(bool& enabled, AgcModes& mode)
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,_channelId),
                      "Channel::GetRxAgcStatus(enable=?, mode=?)");
 
-    bool enable = rx_audioproc_->gain_control()->is_enabled();
+    AudioProcessing* rx_audioproc = RxAudioProcessing();
+    if (!rx_audioproc)
+    {
+        return -1;
+    }
+
+    bool enable = rx_audioproc->gain_control()->is_enabled();
     GainControl::Mode agcMode =
-        rx_audioproc_->gain_control()->mode();
+        rx_audioproc->gain_control()->mode();
 
     enabled = enable;
 
@@ -2884,7 +2926,13 @@ Channel::SetRxAgcConfig(AgcConfig config)
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::SetRxAgcConfig()");
 
-    if (rx_audioproc_->gain_control()->set_target_level_dbfs(
+    AudioProcessing* rx_audioproc = RxAudioProcessing();
+    if (!rx_audioproc)
+    {
+        return -1;
+    }
+
+    if (rx_audioproc->gain_control()->set_target_level_dbfs(
         config.targetLeveldBOv) != 0)
     {
         _engineStatisticsPtr->SetLastError(
@@ -2893,7 +2941,7 @@ Channel::SetRxAgcConfig(AgcConfig config)
             "(or envelope) of the Agc");
         return -1;
     }
-    if (rx_audioproc_->gain_control()->set_compression_gain_db(
+    if (rx_audioproc->gain_control()->set_compression_gain_db(
         config.digitalCompressionGaindB) != 0)
     {
         _engineStatisticsPtr->SetLastError(
@@ -2902,7 +2950,7 @@ Channel::SetRxAgcConfig(AgcConfig config)
             " digital compression stage may apply");
         return -1;
     }
-    if (rx_audioproc_->gain_control()->enable_limiter(
+    if (rx_audioproc->gain_control()->enable_limiter(
         config.limiterEnable) != 0)
     {
         _engineStatisticsPtr->SetLastError(
@@ -2920,12 +2968,18 @@ Channel::GetRxAgcConfig(AgcConfig& config)
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::GetRxAgcConfig(config=%?)");
 
+    AudioProcessing* rx_audioproc = RxAudioProcessing();
+    if (!rx_audioproc)
+    {
+        return -1;
+    }
+
     config.targetLeveldBOv =
-        rx_audioproc_->gain_control()->target_level_dbfs();
+        rx_audioproc->gain_control()->target_level_dbfs();
     config.digitalCompressionGaindB =
-        rx_audioproc_->gain_control()->compression_gain_db();
+        rx_audioproc->gain_control()->compression_gain_db();
     config.limiterEnable =
-        rx_audioproc_->gain_control()->is_limiter_enabled();
+        rx_audioproc->gain_control()->is_limiter_enabled();
 
     WEBRTC_TRACE(kTraceStateInfo, kTraceVoice,
                VoEId(_instanceId,_channelId), "GetRxAgcConfig() => "
@@ -2949,6 +3003,12 @@ Channel::SetRxNsStatus(bool enable, NsModes mode)
                  "Channel::SetRxNsStatus(enable=%d, mode=%d)",
                  (int)enable, (int)mode);
 
+    AudioProcessing* rx_audioproc = RxAudioProcessing();
+    if (!rx_audioproc)
+    {
+        return -1;
+    }
+
     NoiseSuppression::Level nsLevel = kDefaultNsMode;
     switch (mode)
     {
@@ -2956,7 +3016,7 @@ Channel::SetRxNsStatus(bool enable, NsModes mode)
         case kNsDefault:
             break;
         case kNsUnchanged:
-            nsLevel = rx_audioproc_->noise_suppression()->level();
+            nsLevel = rx_audioproc->noise_suppression()->level();
             break;
         case kNsConference:
             nsLevel = NoiseSuppression::kHigh;
@@ -2975,7 +3035,7 @@ Channel::SetRxNsStatus(bool enable, NsModes mode)
             break;
     }
 
-    if (rx_audioproc_->noise_suppression()->set_level(nsLevel)
+    if (rx_audioproc->noise_suppression()->set_level(nsLevel)
         != 0)
     {
         _engineStatisticsPtr->SetLastError(
@@ -2983,7 +3043,7 @@ Channel::SetRxNsStatus(bool enable, NsModes mode)
             "SetRxNsStatus() failed to set NS level");
         return -1;
     }
-    if (rx_audioproc_->noise_suppression()->Enable(enable) != 0)
+    if (rx_audioproc->noise_suppression()->Enable(enable) != 0)
     {
         _engineStatisticsPtr->SetLastError(
             VE_APM_ERROR, kTraceError,
@@ -3003,10 +3063,16 @@ Channel::GetRxNsStatus(bool& enabled, NsModes& mode)
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,_channelId),
                  "Channel::GetRxNsStatus(enable=?, mode=?)");
 
+    AudioProcessing* rx_audioproc = RxAudioProcessing();
+    if (!rx_audioproc)
+    {
+        return -1;
+    }
+
     bool enable =
-        rx_audioproc_->noise_suppression()->is_enabled();
+        rx_audioproc->noise_suppression()->is_enabled();
     NoiseSuppression::Level ncLevel =
-        rx_audioproc_->noise_suppression()->level();
+        rx_audioproc->noise_suppression()->level();
 
     enabled = enable;
 
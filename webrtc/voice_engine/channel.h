@@ -55,6 +55,7 @@ class RTPPayloadRegistry;
 class RtpReceiver;
 class RTPReceiverAudio;
 class RtpRtcp;
+class StreamStatistician;
 class TelephoneEventHandler;
 class ViENetwork;
 class VoEMediaProcess;
@@ -490,9 +491,17 @@ private:
     bool HandleEncapsulation(const uint8_t* packet,
                              int packet_length,
                              const RTPHeader& header);
-    bool IsPacketInOrder(const RTPHeader& header) const;
-    bool IsPacketRetransmitted(const RTPHeader& header, bool in_order) const;
+    // |statistician| is the statistician of the stream of |header|, or NULL
+    // if there is none yet.
+    bool IsPacketInOrder(const StreamStatistician* statistician,
+                         const RTPHeader& header) const;
+    bool IsPacketRetransmitted(const StreamStatistician* statistician,
+                               const RTPHeader& header,
+                               bool in_order) const;
     int ResendPackets(const uint16_t* sequence_numbers, int length);
+    // Returns the far end APM, which is only created once the Rx AGC or NS
+    // API is used, since most channels never process what they play out.
+    AudioProcessing* RxAudioProcessing();
     int InsertInbandDtmfTone();
     int32_t MixOrReplaceAudioWithFile(int mixingFrequency);
     int32_t MixAudioWithFile(AudioFrame& audioFrame, int mixingFrequency);
@@ -11,6 +11,8 @@
 #include "webrtc/common.h"
 #include "webrtc/voice_engine/channel_manager.h"
 
+#include <algorithm>
+
 #include "webrtc/voice_engine/channel.h"
 
 namespace webrtc {
@@ -45,12 +47,38 @@ ChannelOwner& ChannelOwner::operator=(const ChannelOwner& other) {
 ChannelOwner::ChannelRef::ChannelRef(class Channel* channel)
     : channel(channel), ref_count(1) {}
 
+ChannelManager::ChannelList::ChannelList() : ref_count_(1) {}
+
+ChannelManager::ChannelList::~ChannelList() {}
+
+void ChannelManager::ChannelList::AddRef() {
+  ++ref_count_;
+}
+
+void ChannelManager::ChannelList::Release() {
+  if (--ref_count_ == 0)
+    delete this;
+}
+
+int ChannelManager::ChannelList::Find(int32_t channel_id) const {
+  std::vector<int32_t>::const_iterator it =
+      std::lower_bound(ids.begin(), ids.end(), channel_id);
+  if (it == ids.end() || *it != channel_id)
+    return -1;
+  return static_cast<int>(it - ids.begin());
+}
+
 ChannelManager::ChannelManager(uint32_t instance_id, const Config& config)
     : instance_id_(instance_id),
       last_channel_id_(-1),
       lock_(CriticalSectionWrapper::CreateCriticalSection()),
+      channels_(new ChannelList()),
       config_(config) {}
 
+ChannelManager::~ChannelManager() {
+  channels_.current()->Release();
+}
+
 ChannelOwner ChannelManager::CreateChannel() {
   return CreateChannelInternal(config_);
 }
@@ -63,79 +91,116 @@ ChannelOwner ChannelManager::CreateChannelInternal(const Config& config) {
   Channel* channel;
   Channel::CreateChannel(channel, ++last_channel_id_, instance_id_, config);
   ChannelOwner channel_owner(channel);
+  const int32_t channel_id = channel->ChannelId();
 
-  CriticalSectionScoped crit(lock_.get());
+  ChannelList* previous;
+  {
+    CriticalSectionScoped crit(lock_.get());
 
-  channels_.push_back(channel_owner);
+    const ChannelList* current = channels_.current();
+    ChannelList* channels = new ChannelList();
+    // Channel ids are handed out in order, but concurrent creators may get
+    // here out of order.
+    size_t pos = std::upper_bound(current->ids.begin(), current->ids.end(),
+                                  channel_id) - current->ids.begin();
+    channels->ids.reserve(current->ids.size() + 1);
+    channels->ids.assign(current->ids.begin(), current->ids.begin() + pos);
+    channels->ids.push_back(channel_id);
+    channels->ids.insert(channels->ids.end(), current->ids.begin() + pos,
+                         current->ids.end());
+    channels->channels.reserve(current->channels.size() + 1);
+    channels->channels.assign(current->channels.begin(),
+                              current->channels.begin() + pos);
+    channels->channels.push_back(channel_owner);
+    channels->channels.insert(channels->channels.end(),
+                              current->channels.begin() + pos,
+                              current->channels.end());
+    previous = channels_.Publish(channels);
+  }
+  previous->Release();
 
   return channel_owner;
 }
 
-ChannelOwner ChannelManager::GetChannel(int32_t channel_id) {
-  CriticalSectionScoped crit(lock_.get());
+ChannelManager::ChannelList* ChannelManager::AcquireChannels() const {
+  SnapshotPublisher<ChannelList>::ScopedReader channels(&channels_);
+  channels->AddRef();
+  return channels.get();
+}
 
-  for (size_t i = 0; i < channels_.size(); ++i) {
-    if (channels_[i].channel()->ChannelId() == channel_id)
-      return channels_[i];
-  }
-  return ChannelOwner(NULL);
+ChannelOwner ChannelManager::GetChannel(int32_t channel_id) {
+  ChannelList* channels = AcquireChannels();
+  int index = channels->Find(channel_id);
+  ChannelOwner channel_owner =
+      index >= 0 ? channels->channels[index] : ChannelOwner(NULL);
+  channels->Release();
+  return channel_owner;
 }
 
 void ChannelManager::GetAllChannels(std::vector<ChannelOwner>* channels) {
-  CriticalSectionScoped crit(lock_.get());
-
-  *channels = channels_;
+  ChannelList* current = AcquireChannels();
+  *channels = current->channels;
+  current->Release();
 }
 
 void ChannelManager::DestroyChannel(int32_t channel_id) {
   assert(channel_id >= 0);
-  // Holds a reference to a channel, this is used so that we never delete
-  // Channels while holding a lock, but rather when the method returns.
-  ChannelOwner reference(NULL);
+  // Holds a reference to the previous list, which holds a reference to the
+  // channel. This is used so that we never delete Channels while holding a
+  // lock, but rather when the method returns.
+  ChannelList* previous = NULL;
   {
     CriticalSectionScoped crit(lock_.get());
 
-    for (std::vector<ChannelOwner>::iterator it = channels_.begin();
-         it != channels_.end();
-         ++it) {
-      if (it->channel()->ChannelId() == channel_id) {
-        reference = *it;
-        channels_.erase(it);
-        break;
-      }
-    }
+    const ChannelList* current = channels_.current();
+    int index = current->Find(channel_id);
+    if (index < 0)
+      return;
+    ChannelList* channels = new ChannelList();
+    channels->ids = current->ids;
+    channels->ids.erase(channels->ids.begin() + index);
+    channels->channels = current->channels;
+    channels->channels.erase(channels->channels.begin() + index);
+    previous = channels_.Publish(channels);
   }
+  previous->Release();
 }
 
 void ChannelManager::DestroyAllChannels() {
   // Holds references so that Channels are not destroyed while holding this
   // lock, but rather when the method returns.
-  std::vector<ChannelOwner> references;
+  ChannelList* previous;
   {
     CriticalSectionScoped crit(lock_.get());
-    references = channels_;
-    channels_.clear();
+    previous = channels_.Publish(new ChannelList());
   }
+  previous->Release();
 }
 
 size_t ChannelManager::NumOfChannels() const {
-  CriticalSectionScoped crit(lock_.get());
-  return channels_.size();
+  ChannelList* channels = AcquireChannels();
+  size_t num_channels = channels->channels.size();
+  channels->Release();
+  return num_channels;
 }
 
 ChannelManager::Iterator::Iterator(ChannelManager* channel_manager)
-    : iterator_pos_(0) {
-  channel_manager->GetAllChannels(&channels_);
+    : iterator_pos_(0),
+      channels_(channel_manager->AcquireChannels()) {
+}
+
+ChannelManager::Iterator::~Iterator() {
+  channels_->Release();
 }
 
 Channel* ChannelManager::Iterator::GetChannel() {
-  if (iterator_pos_ < channels_.size())
-    return channels_[iterator_pos_].channel();
+  if (iterator_pos_ < channels_->channels.size())
+    return channels_->channels[iterator_pos_].channel();
   return NULL;
 }
 
 bool ChannelManager::Iterator::IsValid() {
-  return iterator_pos_ < channels_.size();
+  return iterator_pos_ < channels_->channels.size();
 }
 
 void ChannelManager::Iterator::Increment() {
@@ -17,6 +17,7 @@
 #include "webrtc/system_wrappers/interface/atomic32.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/snapshot_publisher.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -68,17 +69,22 @@ class ChannelOwner {
 };
 
 class ChannelManager {
+ private:
+  class ChannelList;
+
  public:
   ChannelManager(uint32_t instance_id, const Config& config);
+  ~ChannelManager();
 
-  // Upon construction of an Iterator it will grab a copy of the channel list of
-  // the ChannelManager. The iteration will then occur over this state, not the
-  // current one of the ChannelManager. As the Iterator holds its own references
-  // to the Channels, they will remain valid even if they are removed from the
-  // ChannelManager.
+  // Upon construction of an Iterator it will grab a reference to the current
+  // channel list of the ChannelManager. The iteration will then occur over this
+  // state, not the current one of the ChannelManager. As the list holds its own
+  // references to the Channels, they will remain valid even if they are removed
+  // from the ChannelManager. Neither takes a lock nor allocates.
   class Iterator {
    public:
     explicit Iterator(ChannelManager* channel_manager);
+    ~Iterator();
 
     Channel* GetChannel();
     bool IsValid();
@@ -87,7 +93,7 @@ class ChannelManager {
 
    private:
     size_t iterator_pos_;
-    std::vector<ChannelOwner> channels_;
+    ChannelList* channels_;
 
     DISALLOW_COPY_AND_ASSIGN(Iterator);
   };
@@ -101,7 +107,8 @@ class ChannelManager {
   ChannelOwner CreateChannel(const Config& external_config);
 
   // ChannelOwner.channel() will be NULL if channel_id is invalid or no longer
-  // exists. This should be checked with ChannelOwner::IsValid().
+  // exists. This should be checked with ChannelOwner::IsValid(). Does not take
+  // a lock.
   ChannelOwner GetChannel(int32_t channel_id);
   void GetAllChannels(std::vector<ChannelOwner>* channels);
 
@@ -111,15 +118,46 @@ class ChannelManager {
   size_t NumOfChannels() const;
 
  private:
+  // An immutable snapshot of the channels, sorted by id. Changes to the
+  // channels publish a new snapshot, so readers never need |lock_|.
+  class ChannelList {
+   public:
+    ChannelList();
+
+    void AddRef();
+    void Release();
+
+    // Index of |channel_id| in |channels|, or -1.
+    int Find(int32_t channel_id) const;
+
+    // Ids of |channels|, for binary search.
+    std::vector<int32_t> ids;
+    std::vector<ChannelOwner> channels;
+
+   private:
+    ~ChannelList();
+
+    Atomic32 ref_count_;
+
+    DISALLOW_COPY_AND_ASSIGN(ChannelList);
+  };
+
   // Create a channel given a configuration, |config|.
   ChannelOwner CreateChannelInternal(const Config& config);
 
+  // Returns a reference to the current list, to be released by the caller.
+  ChannelList* AcquireChannels() const;
+
   uint32_t instance_id_;
 
   Atomic32 last_channel_id_;
 
+  // Serializes the writers.
   scoped_ptr<CriticalSectionWrapper> lock_;
-  std::vector<ChannelOwner> channels_;
+  // Readers only use the current list to take a reference to it, so a writer
+  // gets the previous list back right away. The publisher holds a reference
+  // to the current list.
+  SnapshotPublisher<ChannelList> channels_;
 
   const Config& config_;
 
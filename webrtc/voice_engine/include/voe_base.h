@@ -45,6 +45,16 @@ class Config;
 
 const int kVoEDefault = -1;
 
+// Use to encode the sending channels in parallel on the audio device thread
+// and a pool of |num_threads| threads, instead of one after the other on the
+// device thread. The device thread returns once all of them are encoded. Must
+// be provided through VoiceEngine::Create(const Config&).
+struct ParallelEncoding {
+  ParallelEncoding() : num_threads(0) {}
+  explicit ParallelEncoding(int num_threads) : num_threads(num_threads) {}
+  int num_threads;
+};
+
 // VoiceEngineObserver
 class WEBRTC_DLLEXPORT VoiceEngineObserver
 {
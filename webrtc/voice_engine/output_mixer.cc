@@ -138,6 +138,9 @@ OutputMixer::OutputMixer(uint32_t instanceId) :
                      "OutputMixer::OutputMixer() failed to register mixer"
                      "callbacks");
     }
+    // The channels deliver the output of NetEq at its own rate, such that the
+    // channels sharing a rate are resampled once, by the mixer.
+    _mixerModule.SetNativeRateMixing(true);
 
     _dtmfGenerator.Init();
 }
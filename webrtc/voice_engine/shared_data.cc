@@ -10,6 +10,7 @@
 
 #include "webrtc/voice_engine/shared_data.h"
 
+#include "webrtc/common.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/trace.h"
@@ -43,6 +44,8 @@ SharedData::SharedData(const Config& config) :
         _transmitMixerPtr->SetEngineInformation(*_moduleProcessThreadPtr,
                                                 _engineStatistics,
                                                 _channelManager);
+        _transmitMixerPtr->SetEncoderThreads(
+            config.Get<ParallelEncoding>().num_threads);
     }
     _audioDeviceLayer = AudioDeviceModule::kPlatformDefaultAudio;
 }
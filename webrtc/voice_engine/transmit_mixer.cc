@@ -14,6 +14,7 @@
 #include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/event_wrapper.h"
 #include "webrtc/system_wrappers/interface/logging.h"
+#include "webrtc/system_wrappers/interface/thread_pool.h"
 #include "webrtc/system_wrappers/interface/trace.h"
 #include "webrtc/voice_engine/channel.h"
 #include "webrtc/voice_engine/channel_manager.h"
@@ -27,6 +28,22 @@
 namespace webrtc {
 namespace voe {
 
+namespace {
+
+// Encodes and sends the current frame of each of the channels.
+class EncodeChannelsTask : public ParallelTask {
+ public:
+  explicit EncodeChannelsTask(const std::vector<Channel*>& channels)
+      : channels_(channels) {}
+
+  virtual void Run(int index) OVERRIDE { channels_[index]->EncodeAndSend(); }
+
+ private:
+  const std::vector<Channel*>& channels_;
+};
+
+}  // namespace
+
 // TODO(ajm): The thread safety of this is dubious...
 void
 TransmitMixer::OnPeriodicProcess()
@@ -301,6 +318,19 @@ TransmitMixer::SetAudioProcessingModule(AudioProcessing* audioProcessingModule)
     return 0;
 }
 
+void TransmitMixer::SetEncoderThreads(int num_threads) {
+  encoder_pool_.reset();
+  if (num_threads > 0) {
+    encoder_pool_.reset(ThreadPool::Create("VoiceEncoder", num_threads,
+                                           kRealtimePriority,
+                                           kEncoderThreadRole));
+    if (!encoder_pool_) {
+      LOG(LS_WARNING) << "Failed to start " << num_threads
+                      << " encoder threads; encoding on the device thread";
+    }
+  }
+}
+
 void TransmitMixer::GetSendCodecInfo(int* max_sample_rate, int* max_channels) {
   *max_sample_rate = 8000;
   *max_channels = 1;
@@ -452,25 +482,50 @@ TransmitMixer::EncodeAndSend()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::EncodeAndSend()");
 
-    for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
-         it.Increment())
+    // |it| keeps the channels alive until the pool is done with them.
+    std::vector<Channel*> sending_channels;
+    ChannelManager::Iterator it(_channelManagerPtr);
+    for (; it.IsValid(); it.Increment())
     {
         Channel* channelPtr = it.GetChannel();
         if (channelPtr->Sending())
         {
-            channelPtr->EncodeAndSend();
+            if (encoder_pool_)
+                sending_channels.push_back(channelPtr);
+            else
+                channelPtr->EncodeAndSend();
         }
     }
+    if (!sending_channels.empty())
+    {
+        EncodeChannelsTask task(sending_channels);
+        encoder_pool_->RunInParallel(
+            &task, static_cast<int>(sending_channels.size()));
+    }
     return 0;
 }
 
 void TransmitMixer::EncodeAndSend(const int voe_channels[],
                                   int number_of_voe_channels) {
+  // Keeps the channels alive until the pool is done with them.
+  std::vector<ChannelOwner> owners;
+  std::vector<Channel*> sending_channels;
   for (int i = 0; i < number_of_voe_channels; ++i) {
     voe::ChannelOwner ch = _channelManagerPtr->GetChannel(voe_channels[i]);
     voe::Channel* channel_ptr = ch.channel();
-    if (channel_ptr && channel_ptr->Sending())
-      channel_ptr->EncodeAndSend();
+    if (channel_ptr && channel_ptr->Sending()) {
+      if (encoder_pool_) {
+        owners.push_back(ch);
+        sending_channels.push_back(channel_ptr);
+      } else {
+        channel_ptr->EncodeAndSend();
+      }
+    }
+  }
+  if (!sending_channels.empty()) {
+    EncodeChannelsTask task(sending_channels);
+    encoder_pool_->RunInParallel(&task,
+                                 static_cast<int>(sending_channels.size()));
   }
 }
 
@@ -27,6 +27,7 @@ namespace webrtc {
 
 class AudioProcessing;
 class ProcessThread;
+class ThreadPool;
 class VoEExternalMedia;
 class VoEMediaProcess;
 
@@ -50,6 +51,11 @@ public:
     int32_t SetAudioProcessingModule(
         AudioProcessing* audioProcessingModule);
 
+    // Makes EncodeAndSend() encode the channels in parallel on the calling
+    // thread and a pool of |num_threads| threads. Zero encodes them on the
+    // calling thread only.
+    void SetEncoderThreads(int num_threads);
+
     int32_t PrepareDemux(const void* audioSamples,
                          uint32_t nSamples,
                          uint8_t  nChannels,
@@ -230,6 +236,7 @@ private:
     bool stereo_codec_;
     bool swap_stereo_channels_;
     scoped_ptr<int16_t[]> mono_buffer_;
+    scoped_ptr<ThreadPool> encoder_pool_;
 };
 
 }  // namespace voe
@@ -10,10 +10,18 @@
 
 #include "webrtc/voice_engine/include/voe_base.h"
 
+#include <math.h>
+
+#include <set>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common.h"
 #include "webrtc/modules/audio_device/include/fake_audio_device.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/system_wrappers/interface/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/interface/scoped_ptr.h"
+#include "webrtc/system_wrappers/interface/thread_wrapper.h"
+#include "webrtc/voice_engine/include/voe_network.h"
 
 namespace webrtc {
 
@@ -47,4 +55,99 @@ TEST_F(VoEBaseTest, AudioProcessingCreatedAfterInit) {
   EXPECT_TRUE(base_->audio_processing() != NULL);
 }
 
+namespace {
+
+// Counts the packets of one channel and records the threads they are sent on.
+class ThreadRecordingTransport : public Transport {
+ public:
+  ThreadRecordingTransport()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        num_packets_(0) {}
+
+  virtual int SendPacket(int channel, const void* data, int len) OVERRIDE {
+    CriticalSectionScoped cs(crit_.get());
+    ++num_packets_;
+    thread_ids_.insert(ThreadWrapper::GetThreadId());
+    return len;
+  }
+
+  virtual int SendRTCPPacket(int channel, const void* data, int len) OVERRIDE {
+    return len;
+  }
+
+  int num_packets() {
+    CriticalSectionScoped cs(crit_.get());
+    return num_packets_;
+  }
+
+  std::set<uint32_t> thread_ids() {
+    CriticalSectionScoped cs(crit_.get());
+    return thread_ids_;
+  }
+
+ private:
+  scoped_ptr<CriticalSectionWrapper> crit_;
+  int num_packets_;
+  std::set<uint32_t> thread_ids_;
+};
+
+}  // namespace
+
+TEST(VoEBaseParallelEncodingTest, EncodesAllChannelsBeforeReturning) {
+  const int kNumChannels = 3;
+  const int kSampleRateHz = 16000;
+  const int kSamplesPer10Ms = kSampleRateHz / 100;
+  Config config;
+  config.Set<ParallelEncoding>(new ParallelEncoding(2));
+  VoiceEngine* voe = VoiceEngine::Create(config);
+  VoEBase* base = VoEBase::GetInterface(voe);
+  VoENetwork* network = VoENetwork::GetInterface(voe);
+  FakeAudioDeviceModule adm;
+  ASSERT_EQ(0, base->Init(&adm));
+  ASSERT_TRUE(base->audio_transport() != NULL);
+
+  ThreadRecordingTransport transports[kNumChannels];
+  int channels[kNumChannels];
+  for (int i = 0; i < kNumChannels; ++i) {
+    channels[i] = base->CreateChannel();
+    ASSERT_NE(-1, channels[i]);
+    EXPECT_EQ(0, network->RegisterExternalTransport(channels[i],
+                                                    transports[i]));
+    EXPECT_EQ(0, base->StartSend(channels[i]));
+  }
+
+  int16_t audio[kSamplesPer10Ms];
+  for (int frame = 0; frame < 20; ++frame) {
+    for (int k = 0; k < kSamplesPer10Ms; ++k) {
+      audio[k] = static_cast<int16_t>(
+          8000 * sin(2 * M_PI * 440 * (frame * kSamplesPer10Ms + k) /
+                     kSampleRateHz));
+    }
+    uint32_t new_mic_level = 0;
+    base->audio_transport()->RecordedDataIsAvailable(
+        audio, kSamplesPer10Ms, sizeof(*audio), 1, kSampleRateHz, 0, 0, 0,
+        false, new_mic_level);
+  }
+
+  // All the packets were sent by the time RecordedDataIsAvailable() returned,
+  // from the calling thread and the threads of the pool.
+  std::set<uint32_t> thread_ids;
+  for (int i = 0; i < kNumChannels; ++i) {
+    EXPECT_GT(transports[i].num_packets(), 0);
+    std::set<uint32_t> channel_thread_ids = transports[i].thread_ids();
+    thread_ids.insert(channel_thread_ids.begin(), channel_thread_ids.end());
+  }
+  EXPECT_LE(thread_ids.size(), 3u);
+
+  for (int i = 0; i < kNumChannels; ++i) {
+    EXPECT_EQ(0, base->StopSend(channels[i]));
+    EXPECT_EQ(0, network->DeRegisterExternalTransport(channels[i]));
+    EXPECT_EQ(0, base->DeleteChannel(channels[i]));
+  }
+  EXPECT_EQ(0, base->Terminate());
+  network->Release();
+  base->Release();
+  VoiceEngine::Delete(voe);
+}
+
 }  // namespace webrtc